@@ -26,6 +26,7 @@
 #include "IO/SystemPaths.h"
 #include "Model/GameFactory.h"
 #include "PreferenceManager.h"
+#include "StartupTimeline.h"
 #include "TrenchBroomApp.h"
 #include "View/MapDocument.h"
 #include "View/MapDocumentCommandFacade.h"
@@ -35,6 +36,9 @@ extern void qt_set_sequence_auto_mnemonic(bool b);
 
 int main(int argc, char* argv[])
 {
+  // Start the startup timeline as early as possible
+  TrenchBroom::StartupTimeline::instance();
+
   // Set OpenGL defaults
   // Needs to be done here before QApplication is created
   // (see: https://doc.qt.io/qt-5/qsurfaceformat.html#setDefaultFormat)
@@ -69,6 +73,7 @@ int main(int argc, char* argv[])
   qputenv("QT_OPENGL_BUGLIST", ":/opengl_buglist.json");
 
   // parse portable arg out manually at first to ensure it's set before any settings load
+  auto batch = false;
   if (argc > 1)
   {
     for (int i = 1; i < argc; i++)
@@ -79,13 +84,29 @@ int main(int argc, char* argv[])
         QSettings::setPath(
           QSettings::IniFormat, QSettings::UserScope, QString("./config"));
       }
+      else if (strcmp(argv[i], "--batch") == 0)
+      {
+        batch = true;
+      }
     }
   }
 
+  if (batch)
+  {
+    // batch mode must run on machines without a display, so don't create any windows
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    TrenchBroom::View::setCrashReportGUIEnbled(false);
+  }
+
   // PreferenceManager is destroyed by TrenchBroomApp::~TrenchBroomApp()
   TrenchBroom::PreferenceManager::createInstance<TrenchBroom::AppPreferenceManager>();
   TrenchBroom::View::TrenchBroomApp app(argc, argv);
 
+  if (batch)
+  {
+    return app.runBatch();
+  }
+
   app.parseCommandLineAndShowFrame();
   return app.exec();
 }
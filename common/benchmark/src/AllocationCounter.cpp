@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace TrenchBroom
+{
+namespace
+{
+std::atomic<size_t> allocationCount{0};
+std::atomic<size_t> allocatedBytes{0};
+std::atomic<size_t> liveBytes{0};
+std::atomic<size_t> peakLiveBytes{0};
+std::atomic<bool> countingEnabled{false};
+
+// every block is prefixed with its size so that operator delete can count the live bytes
+constexpr auto HeaderSize = alignof(std::max_align_t);
+static_assert(HeaderSize >= sizeof(size_t));
+
+void* allocate(const size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+  const auto live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+  auto peak = peakLiveBytes.load(std::memory_order_relaxed);
+  while (live > peak
+         && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+  {
+  }
+
+  if (auto* block = static_cast<unsigned char*>(std::malloc(HeaderSize + size)))
+  {
+    *reinterpret_cast<size_t*>(block) = size;
+    return block + HeaderSize;
+  }
+  throw std::bad_alloc{};
+}
+
+void deallocate(void* ptr)
+{
+  if (ptr)
+  {
+    auto* block = static_cast<unsigned char*>(ptr) - HeaderSize;
+    liveBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+  }
+}
+} // namespace
+
+AllocationSnapshot beginAllocationCount()
+{
+  const auto live = liveBytes.load(std::memory_order_relaxed);
+  peakLiveBytes.store(live, std::memory_order_relaxed);
+  return {
+    allocationCount.load(std::memory_order_relaxed),
+    allocatedBytes.load(std::memory_order_relaxed),
+    live};
+}
+
+AllocationStats endAllocationCount(const AllocationSnapshot& snapshot)
+{
+  // the peak can be lower than the initial live bytes if memory was freed concurrently
+  const auto peak = peakLiveBytes.load(std::memory_order_relaxed);
+  return {
+    allocationCount.load(std::memory_order_relaxed) - snapshot.count,
+    allocatedBytes.load(std::memory_order_relaxed) - snapshot.bytes,
+    peak - std::min(peak, snapshot.liveBytes)};
+}
+
+bool allocationCountingEnabled()
+{
+  return countingEnabled.load(std::memory_order_relaxed);
+}
+
+void setAllocationCountingEnabled(const bool enabled)
+{
+  countingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+} // namespace TrenchBroom
+
+// The other non-aligned forms of operator new and operator delete forward to these
+// by default.
+void* operator new(const std::size_t size)
+{
+  return TrenchBroom::allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  TrenchBroom::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  TrenchBroom::deallocate(ptr);
+}
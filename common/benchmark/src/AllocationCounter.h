@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace TrenchBroom
+{
+
+/**
+ * The allocations made while running a benchmark section.
+ */
+struct AllocationStats
+{
+  size_t count = 0;
+  size_t bytes = 0;
+  // the maximum number of bytes allocated by the section that were live at the same time
+  size_t peakBytes = 0;
+};
+
+/**
+ * The state of the allocation counters at the start of a benchmark section.
+ */
+struct AllocationSnapshot
+{
+  size_t count = 0;
+  size_t bytes = 0;
+  size_t liveBytes = 0;
+};
+
+/**
+ * Starts counting the allocations of a benchmark section. The peak of the live bytes is
+ * reset, so sections must not overlap.
+ *
+ * The calls to the global operator new and operator delete are counted over all threads.
+ * The global allocation functions are replaced in AllocationCounter.cpp, so this only
+ * works in the benchmark executable.
+ */
+AllocationSnapshot beginAllocationCount();
+
+/**
+ * Returns the allocations made since the given snapshot was taken.
+ */
+AllocationStats endAllocationCount(const AllocationSnapshot& snapshot);
+
+/**
+ * Whether timeLambda reports the allocations of every benchmark section. Enabled with the
+ * --count-allocations command line option.
+ */
+bool allocationCountingEnabled();
+void setAllocationCountingEnabled(bool enabled);
+
+} // namespace TrenchBroom
@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Assets/Palette.h"
+#include "Assets/TextureBuffer.h"
+#include "BenchmarkUtils.h"
+#include "Color.h"
+#include "Error.h"
+#include "IO/Reader.h"
+
+#include "kdl/result.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom::Assets
+{
+namespace
+{
+constexpr size_t TextureSize = 256;
+constexpr size_t NumTextures = 256;
+
+Palette makeRandomPalette(std::mt19937& rng)
+{
+  auto data = std::vector<unsigned char>(768);
+  for (auto& c : data)
+  {
+    c = static_cast<unsigned char>(rng());
+  }
+  return makePalette(data, PaletteColorFormat::Rgb).value();
+}
+
+void runPaletteBenchmark(const PaletteTransparency transparency, const std::string& name)
+{
+  auto rng = std::mt19937{0};
+  const auto palette = makeRandomPalette(rng);
+
+  // mimic the runs of similar indices found in real textures
+  const auto pixelCount = TextureSize * TextureSize;
+  auto indices = std::vector<char>(pixelCount);
+  for (size_t i = 0; i < pixelCount; ++i)
+  {
+    indices[i] = static_cast<char>((i / 7) % 64 + (rng() % 4 == 0 ? rng() % 192 : 0));
+  }
+
+  auto buffer = TextureBuffer{4 * pixelCount};
+  auto averageColor = Color{};
+  timeLambdaWithThroughput(
+    [&]() {
+      for (size_t i = 0; i < NumTextures; ++i)
+      {
+        auto reader = IO::Reader::from(indices.data(), indices.data() + indices.size());
+        palette.indexedToRgba(reader, pixelCount, buffer, transparency, averageColor);
+      }
+    },
+    "convert " + std::to_string(NumTextures) + " indexed textures (" + name + ")",
+    NumTextures * pixelCount,
+    0);
+
+  CHECK(averageColor.a() == 1.0f);
+}
+} // namespace
+
+TEST_CASE("PaletteBenchmark.indexedToRgba")
+{
+  runPaletteBenchmark(PaletteTransparency::Opaque, "opaque");
+  runPaletteBenchmark(PaletteTransparency::Index255Transparent, "index 255 transparent");
+}
+
+} // namespace TrenchBroom::Assets
@@ -0,0 +1,357 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkResults.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QSysInfo>
+
+#include "Error.h"
+#include "IO/DiskIO.h"
+#include "View/GetVersion.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace TrenchBroom
+{
+namespace
+{
+
+std::vector<BenchmarkResult>& results()
+{
+  static auto results = std::vector<BenchmarkResult>{};
+  return results;
+}
+
+BenchmarkResult& findOrAddResult(const std::string& name)
+{
+  auto& results_ = results();
+  const auto it = std::find_if(results_.begin(), results_.end(), [&](const auto& r) {
+    return r.name == name;
+  });
+  if (it != results_.end())
+  {
+    return *it;
+  }
+  return results_.emplace_back(BenchmarkResult{name, {}, std::nullopt});
+}
+
+double variance(const BenchmarkResult& result)
+{
+  const auto m = mean(result);
+  auto sum = 0.0;
+  for (const auto sample : result.samples)
+  {
+    sum += (sample - m) * (sample - m);
+  }
+  return sum / static_cast<double>(result.samples.size() - 1);
+}
+
+/**
+ * Returns the critical value of Student's t distribution for a one-sided test at the 5%
+ * level with the given degrees of freedom.
+ */
+double criticalT(const double degreesOfFreedom)
+{
+  static const auto table = std::array<double, 30>{
+    6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+    1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+    1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697,
+  };
+
+  // rounding down is conservative because the critical value decreases with the
+  // degrees of freedom
+  const auto df = static_cast<size_t>(std::max(1.0, std::floor(degreesOfFreedom)));
+  return df <= table.size() ? table[df - 1] : 1.645;
+}
+
+/**
+ * Performs Welch's t-test and returns whether the current mean is significantly greater
+ * or less than the baseline mean, depending on the sign of the difference.
+ */
+bool isSignificant(const BenchmarkResult& baseline, const BenchmarkResult& current)
+{
+  const auto nb = static_cast<double>(baseline.samples.size());
+  const auto nc = static_cast<double>(current.samples.size());
+  const auto vb = variance(baseline) / nb;
+  const auto vc = variance(current) / nc;
+
+  const auto difference = std::abs(mean(current) - mean(baseline));
+  if (vb + vc == 0.0)
+  {
+    return difference > 0.0;
+  }
+
+  const auto t = difference / std::sqrt(vb + vc);
+  const auto df = (vb + vc) * (vb + vc) / (vb * vb / (nb - 1.0) + vc * vc / (nc - 1.0));
+  return t > criticalT(df);
+}
+
+QString compilerName()
+{
+#if defined(__clang__)
+  return QStringLiteral("Clang " __clang_version__);
+#elif defined(__GNUC__)
+  return QStringLiteral("GCC " __VERSION__);
+#elif defined(_MSC_VER)
+  return QStringLiteral("MSVC %1").arg(_MSC_VER);
+#else
+  return QStringLiteral("unknown");
+#endif
+}
+
+QJsonObject metadata()
+{
+  return QJsonObject{
+    {"version", View::getBuildVersion()},
+    {"buildId", View::getBuildIdStr()},
+    {"buildType", View::getBuildType()},
+    {"compiler", compilerName()},
+    {"os", QSysInfo::prettyProductName()},
+    {"kernel", QSysInfo::kernelType() + " " + QSysInfo::kernelVersion()},
+    {"architecture", QSysInfo::currentCpuArchitecture()},
+    {"hostName", QSysInfo::machineHostName()},
+    {"hardwareThreads", static_cast<int>(std::thread::hardware_concurrency())},
+    {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+  };
+}
+
+QJsonObject toJson(const BenchmarkResult& result)
+{
+  auto samples = QJsonArray{};
+  for (const auto sample : result.samples)
+  {
+    samples.append(sample);
+  }
+
+  auto json = QJsonObject{
+    {"name", QString::fromStdString(result.name)},
+    {"samples", samples},
+  };
+  if (result.allocations)
+  {
+    json["allocations"] = QJsonObject{
+      {"count", static_cast<qint64>(result.allocations->count)},
+      {"bytes", static_cast<qint64>(result.allocations->bytes)},
+      {"peakBytes", static_cast<qint64>(result.allocations->peakBytes)},
+    };
+  }
+  return json;
+}
+
+BenchmarkResult fromJson(const QJsonObject& json)
+{
+  auto result = BenchmarkResult{json["name"].toString().toStdString(), {}, std::nullopt};
+  for (const auto& sample : json["samples"].toArray())
+  {
+    result.samples.push_back(sample.toDouble());
+  }
+  if (json["allocations"].isObject())
+  {
+    const auto allocations = json["allocations"].toObject();
+    result.allocations = AllocationStats{
+      static_cast<size_t>(allocations["count"].toDouble()),
+      static_cast<size_t>(allocations["bytes"].toDouble()),
+      // missing in results written before peak tracking was added
+      static_cast<size_t>(allocations["peakBytes"].toDouble()),
+    };
+  }
+  return result;
+}
+
+} // namespace
+
+double mean(const BenchmarkResult& result)
+{
+  auto sum = 0.0;
+  for (const auto sample : result.samples)
+  {
+    sum += sample;
+  }
+  return result.samples.empty() ? 0.0
+                                : sum / static_cast<double>(result.samples.size());
+}
+
+void recordBenchmarkTime(const std::string& name, const double elapsedSeconds)
+{
+  findOrAddResult(name).samples.push_back(elapsedSeconds * 1000.0);
+}
+
+void recordBenchmarkAllocations(const std::string& name, const AllocationStats& stats)
+{
+  findOrAddResult(name).allocations = stats;
+}
+
+const std::vector<BenchmarkResult>& recordedBenchmarkResults()
+{
+  return results();
+}
+
+Result<void> writeBenchmarkResults(
+  const std::filesystem::path& path, const std::vector<BenchmarkResult>& results)
+{
+  auto benchmarks = QJsonArray{};
+  for (const auto& result : results)
+  {
+    benchmarks.append(toJson(result));
+  }
+
+  const auto document = QJsonDocument{QJsonObject{
+    {"metadata", metadata()},
+    {"benchmarks", benchmarks},
+  }};
+
+  return IO::Disk::withOutputStream(path, [&](auto& stream) {
+    stream << document.toJson(QJsonDocument::Indented).toStdString();
+  });
+}
+
+Result<std::vector<BenchmarkResult>> readBenchmarkResults(
+  const std::filesystem::path& path)
+{
+  return IO::Disk::withInputStream(
+           path,
+           [](auto& stream) {
+             return std::string{std::istreambuf_iterator<char>{stream}, {}};
+           })
+    .and_then([&](const auto& contents) -> Result<std::vector<BenchmarkResult>> {
+      auto error = QJsonParseError{};
+      const auto document =
+        QJsonDocument::fromJson(QByteArray::fromStdString(contents), &error);
+      if (error.error != QJsonParseError::NoError || !document.isObject())
+      {
+        return Error{
+          "Could not parse benchmark results '" + path.string()
+          + "': " + error.errorString().toStdString()};
+      }
+
+      auto results = std::vector<BenchmarkResult>{};
+      for (const auto& benchmark : document.object()["benchmarks"].toArray())
+      {
+        results.push_back(fromJson(benchmark.toObject()));
+      }
+      return results;
+    });
+}
+
+std::ostream& operator<<(std::ostream& lhs, const BenchmarkChange rhs)
+{
+  switch (rhs)
+  {
+  case BenchmarkChange::Unchanged:
+    lhs << "unchanged";
+    break;
+  case BenchmarkChange::Improvement:
+    lhs << "improvement";
+    break;
+  case BenchmarkChange::Regression:
+    lhs << "REGRESSION";
+    break;
+  case BenchmarkChange::Inconclusive:
+    lhs << "inconclusive";
+    break;
+  case BenchmarkChange::New:
+    lhs << "new";
+    break;
+  }
+  return lhs;
+}
+
+std::vector<BenchmarkComparison> compareBenchmarkResults(
+  const std::vector<BenchmarkResult>& baseline,
+  const std::vector<BenchmarkResult>& current,
+  const double threshold)
+{
+  return kdl::vec_transform(current, [&](const auto& currentResult) {
+    const auto it =
+      std::find_if(baseline.begin(), baseline.end(), [&](const auto& baselineResult) {
+        return baselineResult.name == currentResult.name;
+      });
+
+    const auto currentMean = mean(currentResult);
+    if (it == baseline.end() || it->samples.empty())
+    {
+      return BenchmarkComparison{
+        currentResult.name, 0.0, currentMean, 0.0, BenchmarkChange::New};
+    }
+
+    const auto baselineMean = mean(*it);
+    const auto relativeChange =
+      baselineMean > 0.0 ? (currentMean - baselineMean) / baselineMean : 0.0;
+
+    const auto change = [&]() {
+      if (std::abs(relativeChange) <= threshold)
+      {
+        return BenchmarkChange::Unchanged;
+      }
+      if (it->samples.size() < 2 || currentResult.samples.size() < 2)
+      {
+        return BenchmarkChange::Inconclusive;
+      }
+      if (!isSignificant(*it, currentResult))
+      {
+        return BenchmarkChange::Unchanged;
+      }
+      return relativeChange > 0.0 ? BenchmarkChange::Regression
+                                  : BenchmarkChange::Improvement;
+    }();
+
+    return BenchmarkComparison{
+      currentResult.name, baselineMean, currentMean, relativeChange, change};
+  });
+}
+
+std::string formatBenchmarkComparisons(
+  const std::vector<BenchmarkComparison>& comparisons)
+{
+  auto str = std::stringstream{};
+  str << std::fixed << std::setprecision(3);
+  for (const auto& comparison : comparisons)
+  {
+    str << comparison.name << ": ";
+    if (comparison.change == BenchmarkChange::New)
+    {
+      str << comparison.currentMean << "ms (" << comparison.change << ")\n";
+    }
+    else
+    {
+      str << comparison.baselineMean << "ms -> " << comparison.currentMean << "ms ("
+          << std::showpos << std::setprecision(1) << comparison.relativeChange * 100.0
+          << std::noshowpos << std::setprecision(3) << "%, " << comparison.change
+          << ")\n";
+    }
+  }
+  return str.str();
+}
+
+} // namespace TrenchBroom
@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "AllocationCounter.h"
+#include "Result.h"
+
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+
+/**
+ * The measurements of a single benchmark, identified by the message passed to
+ * timeLambda. Every repetition of the benchmark run adds a sample.
+ */
+struct BenchmarkResult
+{
+  std::string name;
+  // in milliseconds
+  std::vector<double> samples;
+  // of the last sample, if the benchmark counts allocations
+  std::optional<AllocationStats> allocations;
+};
+
+double mean(const BenchmarkResult& result);
+
+/**
+ * Adds a sample to the benchmark with the given name. Called by timeLambda.
+ */
+void recordBenchmarkTime(const std::string& name, double elapsedSeconds);
+
+/**
+ * Records the allocations of the benchmark with the given name. Called by timeLambda if
+ * allocation counting is enabled.
+ */
+void recordBenchmarkAllocations(const std::string& name, const AllocationStats& stats);
+
+/**
+ * Returns the results recorded so far, in the order in which the benchmarks first ran.
+ */
+const std::vector<BenchmarkResult>& recordedBenchmarkResults();
+
+/**
+ * Writes the given results to a JSON file together with metadata about the machine and
+ * the build.
+ */
+Result<void> writeBenchmarkResults(
+  const std::filesystem::path& path, const std::vector<BenchmarkResult>& results);
+
+/**
+ * Reads the results from a JSON file written by writeBenchmarkResults.
+ */
+Result<std::vector<BenchmarkResult>> readBenchmarkResults(
+  const std::filesystem::path& path);
+
+enum class BenchmarkChange
+{
+  Unchanged,
+  Improvement,
+  Regression,
+  // there are too few samples to decide whether the difference is significant
+  Inconclusive,
+  // the benchmark is not in the baseline
+  New,
+};
+
+std::ostream& operator<<(std::ostream& lhs, BenchmarkChange rhs);
+
+struct BenchmarkComparison
+{
+  std::string name;
+  double baselineMean = 0.0;
+  double currentMean = 0.0;
+  // relative to the baseline, e.g. 0.1 if the current mean is 10% slower
+  double relativeChange = 0.0;
+  BenchmarkChange change = BenchmarkChange::Unchanged;
+};
+
+/**
+ * Compares the current results against the given baseline.
+ *
+ * A benchmark counts as a regression or an improvement if its mean changed by more than
+ * the given relative threshold and the difference is significant according to a
+ * one-sided Welch's t-test at the 5% level. This requires at least two samples on both
+ * sides, so the benchmarks should be run with several repetitions.
+ */
+std::vector<BenchmarkComparison> compareBenchmarkResults(
+  const std::vector<BenchmarkResult>& baseline,
+  const std::vector<BenchmarkResult>& current,
+  double threshold);
+
+/**
+ * Returns a table of the given comparisons for printing to the console.
+ */
+std::string formatBenchmarkComparisons(
+  const std::vector<BenchmarkComparison>& comparisons);
+
+} // namespace TrenchBroom
@@ -19,8 +19,13 @@
 
 #pragma once
 
+#include "AllocationCounter.h"
+#include "BenchmarkResults.h"
+
 #include <chrono>
+#include <cstdio>
 #include <string>
+#include <utility>
 
 #ifdef __GNUC__
 #define TB_NOINLINE __attribute__((noinline))
@@ -29,15 +34,81 @@
 #endif
 
 // the noinline is so you can see the timeLambda when profiling
+// returns the elapsed time in seconds and records it in the benchmark results
+// if countAllocations is true, the allocations made by the lambda are printed and
+// recorded as well, see --count-allocations
 template <class L>
-TB_NOINLINE static void timeLambda(L&& lambda, const std::string& message)
+TB_NOINLINE static double timeLambda(
+  L&& lambda,
+  const std::string& message,
+  const bool countAllocations = TrenchBroom::allocationCountingEnabled())
 {
+  const auto snapshot = countAllocations ? TrenchBroom::beginAllocationCount()
+                                         : TrenchBroom::AllocationSnapshot{};
   const auto start = std::chrono::high_resolution_clock::now();
   lambda();
   const auto end = std::chrono::high_resolution_clock::now();
+  const auto allocations = countAllocations
+                             ? TrenchBroom::endAllocationCount(snapshot)
+                             : TrenchBroom::AllocationStats{};
+
+  const auto elapsed = std::chrono::duration<double>(end - start).count();
+  printf("Time elapsed for '%s': %fms\n", message.c_str(), elapsed * 1000.0);
+  TrenchBroom::recordBenchmarkTime(message, elapsed);
+
+  if (countAllocations)
+  {
+    printf(
+      "  allocations: %zu (%.2f MB), peak: %.2f MB\n",
+      allocations.count,
+      static_cast<double>(allocations.bytes) / (1024.0 * 1024.0),
+      static_cast<double>(allocations.peakBytes) / (1024.0 * 1024.0));
+    TrenchBroom::recordBenchmarkAllocations(message, allocations);
+  }
+  return elapsed;
+}
+
+/**
+ * Prints the throughput in MB/s and brushes/s for a task that took the given number of
+ * seconds. If the number of bytes or brushes is 0, the corresponding value is omitted.
+ */
+[[maybe_unused]] static void printThroughput(
+  const double elapsed, const size_t bytes, const size_t brushes)
+{
+  if (elapsed > 0.0)
+  {
+    if (bytes > 0)
+    {
+      printf(
+        "  throughput: %.2f MB/s\n",
+        static_cast<double>(bytes) / elapsed / (1024.0 * 1024.0));
+    }
+    if (brushes > 0)
+    {
+      printf("  throughput: %.0f brushes/s\n", static_cast<double>(brushes) / elapsed);
+    }
+  }
+}
 
-  printf(
-    "Time elapsed for '%s': %fms\n",
-    message.c_str(),
-    std::chrono::duration<double>(end - start).count() * 1000.0);
+/**
+ * Like timeLambda, but additionally prints the throughput using printThroughput.
+ */
+template <class L>
+TB_NOINLINE static double timeLambdaWithThroughput(
+  L&& lambda, const std::string& message, const size_t bytes, const size_t brushes)
+{
+  const auto elapsed = timeLambda(std::forward<L>(lambda), message);
+  printThroughput(elapsed, bytes, brushes);
+  return elapsed;
+}
+
+/**
+ * Like timeLambda, but always prints the number of allocations made while running the
+ * task, the number of bytes they requested and the peak number of live bytes.
+ */
+template <class L>
+TB_NOINLINE static double timeLambdaWithAllocations(
+  L&& lambda, const std::string& message)
+{
+  return timeLambda(std::forward<L>(lambda), message, true);
 }
@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+#include "EL/EvaluationContext.h"
+#include "EL/Expression.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+#include "IO/ELParser.h"
+
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom::EL
+{
+namespace
+{
+constexpr size_t NumEvaluations = 100000;
+
+// typical model definitions found in FGD files
+const auto ModelExpressions = std::vector<std::string>{
+  R"(":progs/player.mdl")",
+  R"({ "path": ":progs/armor.mdl", "skin": 1 })",
+  R"({{ spawnflags & 1 -> ":maps/b_batt1.bsp", ":maps/b_batt0.bsp" }})",
+  R"({{
+    spawnflags == 2 -> { "path": ":progs/armor.mdl", "skin": 2 },
+    spawnflags == 1 -> { "path": ":progs/armor.mdl", "skin": 1 },
+                       { "path": ":progs/armor.mdl" }
+  }})",
+  R"({ "path": model, "skin": skin, "frame": frame, "scale": scale })",
+  R"({ "path": ":progs/bolt.mdl", "frame": (spawnflags & 6) / 2, "scale": scale * 2 })",
+};
+
+VariableTable makeVariables()
+{
+  auto variables = VariableTable{};
+  variables.declare("spawnflags", Value{1});
+  variables.declare("model", Value{"models/props/crate_large.mdl"});
+  variables.declare("skin", Value{"2"});
+  variables.declare("frame", Value{"7"});
+  variables.declare("scale", Value{"1.5"});
+  return variables;
+}
+} // namespace
+
+TEST_CASE("ELBenchmark.parseModelExpressions")
+{
+  auto count = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumEvaluations / ModelExpressions.size(); ++i)
+      {
+        for (const auto& str : ModelExpressions)
+        {
+          count += IO::ELParser::parseStrict(str).line();
+        }
+      }
+    },
+    "parse " + std::to_string(NumEvaluations) + " model expressions");
+
+  CHECK(count > 0u);
+}
+
+TEST_CASE("ELBenchmark.evaluateModelExpressions")
+{
+  const auto variables = makeVariables();
+  const auto context = EvaluationContext{variables};
+
+  auto expressions = std::vector<Expression>{};
+  for (const auto& str : ModelExpressions)
+  {
+    expressions.push_back(IO::ELParser::parseStrict(str).optimize());
+  }
+
+  auto count = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumEvaluations / expressions.size(); ++i)
+      {
+        for (const auto& expression : expressions)
+        {
+          count += expression.evaluate(context).length();
+        }
+      }
+    },
+    "evaluate " + std::to_string(NumEvaluations) + " model expressions");
+
+  CHECK(count > 0u);
+}
+} // namespace TrenchBroom::EL
@@ -0,0 +1,278 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "IO/NodeWriter.h"
+#include "IO/StandardMapParser.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
+#include "Model/NodeQueries.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/string_format.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+const auto WorldBounds = vm::bbox3{8192.0};
+constexpr size_t NumTextures = 256;
+constexpr size_t BrushesPerEntity = 100;
+
+/**
+ * A parser that discards everything it parses. Used to measure the cost of tokenizing and
+ * parsing a map without creating any nodes.
+ */
+class NullMapParser : public StandardMapParser
+{
+public:
+  explicit NullMapParser(const std::string_view str)
+    : StandardMapParser{str, Model::MapFormat::Standard, Model::MapFormat::Standard}
+  {
+  }
+
+  void parse(ParserStatus& status) { parseEntities(status); }
+
+private:
+  void onBeginEntity(size_t, std::vector<Model::EntityProperty>, ParserStatus&) override
+  {
+  }
+  void onEndEntity(size_t, size_t, ParserStatus&) override {}
+  void onBeginBrush(size_t, ParserStatus&) override {}
+  void onEndBrush(size_t, size_t, ParserStatus&) override {}
+  void onStandardBrushFace(
+    size_t,
+    Model::MapFormat,
+    const vm::vec3&,
+    const vm::vec3&,
+    const vm::vec3&,
+    const Model::BrushFaceAttributes&,
+    ParserStatus&) override
+  {
+  }
+  void onValveBrushFace(
+    size_t,
+    Model::MapFormat,
+    const vm::vec3&,
+    const vm::vec3&,
+    const vm::vec3&,
+    const Model::BrushFaceAttributes&,
+    const vm::vec3&,
+    const vm::vec3&,
+    ParserStatus&) override
+  {
+  }
+  void onPatch(
+    size_t,
+    size_t,
+    Model::MapFormat,
+    size_t,
+    size_t,
+    std::vector<vm::vec<FloatType, 5>>,
+    std::string,
+    ParserStatus&) override
+  {
+  }
+};
+
+/**
+ * Generates a world containing the given number of cubes arranged in a grid. Every
+ * `BrushesPerEntity` brushes, a point entity is added so that the map contains a
+ * realistic mix of entities and brushes.
+ */
+std::unique_ptr<Model::WorldNode> makeWorld(const size_t brushCount)
+{
+  auto world = std::make_unique<Model::WorldNode>(
+    Model::EntityPropertyConfig{}, Model::Entity{}, Model::MapFormat::Standard);
+  world->disableNodeTreeUpdates();
+
+  const auto builder = Model::BrushBuilder{Model::MapFormat::Standard, WorldBounds};
+  const auto gridSize =
+    static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(brushCount))));
+  const auto cellSize = 32.0;
+  const auto offset = static_cast<double>(gridSize) * cellSize / 2.0;
+
+  auto* layer = world->defaultLayer();
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto x = static_cast<double>(i % gridSize) * cellSize - offset;
+    const auto y = static_cast<double>((i / gridSize) % gridSize) * cellSize - offset;
+    const auto z = static_cast<double>(i / (gridSize * gridSize)) * cellSize - offset;
+    const auto min = vm::vec3{x, y, z};
+    const auto textureName = "texture_" + std::to_string(i % NumTextures);
+
+    const auto bounds = vm::bbox3{min, min + vm::vec3::fill(cellSize / 2.0)};
+    auto brush = builder.createCuboid(bounds, textureName).value();
+    layer->addChild(new Model::BrushNode{std::move(brush)});
+
+    if (i % BrushesPerEntity == 0)
+    {
+      layer->addChild(new Model::EntityNode{Model::Entity{
+        {},
+        {{Model::EntityPropertyKeys::Classname, "light"},
+         {Model::EntityPropertyKeys::Origin, kdl::str_to_string(min)},
+         {"light", "300"}}}});
+    }
+  }
+
+  world->rebuildNodeTree();
+  world->enableNodeTreeUpdates();
+  return world;
+}
+
+std::string writeMap(const Model::WorldNode& world)
+{
+  auto stream = std::stringstream{};
+  auto writer = NodeWriter{world, stream};
+  writer.writeMap();
+  return stream.str();
+}
+
+std::vector<Model::BrushNode*> collectBrushNodes(Model::WorldNode& world)
+{
+  return Model::filterBrushNodes(Model::collectDescendants(
+    std::vector<Model::Node*>{&world}, [](const Model::BrushNode*) { return true; }));
+}
+
+void runMapLoadingBenchmark(const size_t brushCount)
+{
+  const auto suffix = " (" + std::to_string(brushCount) + " brushes)";
+
+  auto mapString = std::string{};
+  {
+    const auto generatedWorld = makeWorld(brushCount);
+    mapString = writeMap(*generatedWorld);
+  }
+  const auto bytes = mapString.size();
+
+  timeLambdaWithThroughput(
+    [&]() {
+      auto tokenizer = QuakeMapTokenizer{mapString};
+      auto tokenCount = size_t(0);
+      while (!tokenizer.nextToken().hasType(QuakeMapToken::Eof))
+      {
+        ++tokenCount;
+      }
+      CHECK(tokenCount > 0u);
+    },
+    "tokenize" + suffix,
+    bytes,
+    brushCount);
+
+  timeLambdaWithThroughput(
+    [&]() {
+      auto status = TestParserStatus{};
+      auto parser = NullMapParser{mapString};
+      parser.parse(status);
+    },
+    "parse" + suffix,
+    bytes,
+    brushCount);
+
+  auto world = std::unique_ptr<Model::WorldNode>{};
+  timeLambdaWithThroughput(
+    [&]() {
+      auto status = TestParserStatus{};
+      auto reader = WorldReader{mapString, Model::MapFormat::Standard, {}};
+      world = reader.read(WorldBounds, status);
+    },
+    "read world (parse and create nodes)" + suffix,
+    bytes,
+    brushCount);
+
+  REQUIRE(world != nullptr);
+
+  const auto brushNodes = collectBrushNodes(*world);
+  CHECK(brushNodes.size() == brushCount);
+
+  auto brushFaces = kdl::vec_transform(
+    brushNodes, [](const auto* brushNode) { return brushNode->brush().faces(); });
+  auto createdBrushes = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (auto& faces : brushFaces)
+      {
+        if (Model::Brush::create(WorldBounds, std::move(faces)).is_success())
+        {
+          ++createdBrushes;
+        }
+      }
+    },
+    "create brush geometry" + suffix,
+    0,
+    brushCount);
+  CHECK(createdBrushes == brushCount);
+
+  timeLambdaWithThroughput(
+    [&]() {
+      world->disableNodeTreeUpdates();
+      world->rebuildNodeTree();
+      world->enableNodeTreeUpdates();
+    },
+    "rebuild node tree" + suffix,
+    0,
+    brushCount);
+
+  auto writtenBytes = size_t(0);
+  const auto elapsed = timeLambda(
+    [&]() { writtenBytes = writeMap(*world).size(); }, "serialize map" + suffix);
+  printThroughput(elapsed, writtenBytes, brushCount);
+}
+} // namespace
+
+TEST_CASE("MapLoadingBenchmark.load100kBrushes")
+{
+  runMapLoadingBenchmark(100'000);
+}
+
+TEST_CASE("MapLoadingBenchmark.load500kBrushes", "[.][large]")
+{
+  runMapLoadingBenchmark(500'000);
+}
+
+TEST_CASE("MapLoadingBenchmark.load1MBrushes", "[.][large]")
+{
+  runMapLoadingBenchmark(1'000'000);
+}
+
+} // namespace TrenchBroom::IO
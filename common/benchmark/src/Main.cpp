@@ -17,8 +17,119 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
-// Hack to reuse the same main() function as the test suite
+// Hack to reuse the preference manager of the test suite
 // clang-format off
 #include "../../test/src/TestPreferenceManager.cpp"
-#include "../../test/src/RunAllTests.cpp"
 // clang-format on
+
+#define CATCH_CONFIG_RUNNER
+
+#include "AllocationCounter.h"
+#include "BenchmarkResults.h"
+#include "Ensure.h"
+#include "Error.h"
+#include "TrenchBroomApp.h"
+
+#include "kdl/result.h"
+
+#include <algorithm>
+#include <clocale>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "../../test/src/Catch2.h"
+
+namespace
+{
+struct BenchmarkOptions
+{
+  std::string outputPath;
+  std::string baselinePath;
+  size_t repetitions = 1;
+  double threshold = 0.05;
+  bool countAllocations = false;
+};
+
+int compareWithBaseline(const BenchmarkOptions& options)
+{
+  using namespace TrenchBroom;
+
+  return readBenchmarkResults(options.baselinePath)
+    .transform([&](const auto& baseline) {
+      const auto comparisons = compareBenchmarkResults(
+        baseline, recordedBenchmarkResults(), options.threshold);
+      std::cout << "\nComparison with baseline '" << options.baselinePath << "':\n"
+                << formatBenchmarkComparisons(comparisons);
+
+      const auto regression =
+        std::any_of(comparisons.begin(), comparisons.end(), [](const auto& c) {
+          return c.change == BenchmarkChange::Regression;
+        });
+      return regression ? 1 : 0;
+    })
+    .transform_error([](const auto& e) {
+      std::cerr << e.msg << "\n";
+      return 1;
+    })
+    .value();
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  TrenchBroom::PreferenceManager::createInstance<TrenchBroom::TestPreferenceManager>();
+  TrenchBroom::View::TrenchBroomApp app(argc, argv);
+
+  TrenchBroom::View::setCrashReportGUIEnbled(false);
+
+  ensure(qApp == &app, "invalid app instance");
+
+  // set the locale to US so that we can parse floats attribute
+  std::setlocale(LC_NUMERIC, "C");
+
+  auto session = Catch::Session{};
+  auto options = BenchmarkOptions{};
+
+  using namespace Catch::clara;
+  session.cli(
+    session.cli()
+    | Opt(options.outputPath, "path")["--results-file"](
+      "write the benchmark results and metadata to a JSON file")
+    | Opt(options.baselinePath, "path")["--baseline-file"](
+      "compare the benchmark results against a JSON file written by --results-file")
+    | Opt(options.repetitions, "count")["--repetitions"](
+      "number of times to run the benchmarks, each run adds a sample")
+    | Opt(options.threshold, "fraction")["--regression-threshold"](
+      "relative change of the mean below which a benchmark counts as unchanged")
+    | Opt(options.countAllocations)["--count-allocations"](
+      "report the allocations of every benchmark section"));
+
+  if (const auto result = session.applyCommandLine(argc, argv); result != 0)
+  {
+    return result;
+  }
+
+  TrenchBroom::setAllocationCountingEnabled(options.countAllocations);
+
+  for (size_t i = 0; i < options.repetitions; ++i)
+  {
+    if (const auto result = session.run(); result != 0)
+    {
+      return result;
+    }
+  }
+
+  if (!options.outputPath.empty())
+  {
+    const auto written = TrenchBroom::writeBenchmarkResults(
+      options.outputPath, TrenchBroom::recordedBenchmarkResults());
+    written.if_error([](const auto& e) { std::cerr << e.msg << "\n"; });
+    if (written.is_error())
+    {
+      return 1;
+    }
+  }
+
+  return options.baselinePath.empty() ? 0 : compareWithBaseline(options);
+}
@@ -0,0 +1,223 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+#include "SampleBrushes.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr size_t MaxBrushPairs = 5000;
+const auto TextureName = std::string{"texture"};
+} // namespace
+
+TEST_CASE("BrushBenchmark.createBrush")
+{
+  const auto& brushes = loadSampleBrushes();
+  REQUIRE(!brushes.empty());
+  const auto brushCount = brushes.size();
+  const auto suffix = " (" + std::to_string(brushCount) + " sample brushes)";
+
+  auto brushFaces =
+    kdl::vec_transform(brushes, [](const auto& brush) { return brush.faces(); });
+  auto createdBrushes = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (auto& faces : brushFaces)
+      {
+        if (Brush::create(SampleWorldBounds, std::move(faces)).is_success())
+        {
+          ++createdBrushes;
+        }
+      }
+    },
+    "create brushes from faces" + suffix,
+    0,
+    brushCount);
+  CHECK(createdBrushes == brushCount);
+
+  const auto builder = BrushBuilder{MapFormat::Standard, SampleWorldBounds};
+
+  auto cuboids = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (const auto& brush : brushes)
+      {
+        if (builder.createCuboid(brush.bounds(), TextureName).is_success())
+        {
+          ++cuboids;
+        }
+      }
+    },
+    "create cuboids from bounds" + suffix,
+    0,
+    brushCount);
+  CHECK(cuboids == brushCount);
+
+  const auto vertexPositions = kdl::vec_transform(
+    brushes, [](const auto& brush) { return brush.vertexPositions(); });
+  auto brushesFromPoints = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (const auto& positions : vertexPositions)
+      {
+        if (builder.createBrush(positions, TextureName).is_success())
+        {
+          ++brushesFromPoints;
+        }
+      }
+    },
+    "create brushes from vertices" + suffix,
+    0,
+    brushCount);
+  CHECK(brushesFromPoints > 0u);
+}
+
+TEST_CASE("BrushBenchmark.moveVertices")
+{
+  const auto& brushes = loadSampleBrushes();
+  REQUIRE(!brushes.empty());
+  const auto suffix = " (" + std::to_string(brushes.size()) + " sample brushes)";
+
+  // move the topmost vertex of every brush up, which is valid for most brushes
+  const auto topVertices = kdl::vec_transform(brushes, [](const auto& brush) {
+    const auto positions = brush.vertexPositions();
+    return std::vector<vm::vec3>{*std::max_element(
+      std::begin(positions), std::end(positions), [](const auto& lhs, const auto& rhs) {
+        return lhs.z() < rhs.z();
+      })};
+  });
+  const auto delta = vm::vec3{0, 0, 16};
+
+  auto movableBrushes = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (size_t i = 0; i < brushes.size(); ++i)
+      {
+        if (brushes[i].canMoveVertices(SampleWorldBounds, topVertices[i], delta))
+        {
+          ++movableBrushes;
+        }
+      }
+    },
+    "check vertex moves" + suffix,
+    0,
+    brushes.size());
+  CHECK(movableBrushes > 0u);
+
+  auto copies = brushes;
+  auto movedBrushes = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (size_t i = 0; i < copies.size(); ++i)
+      {
+        if (copies[i].moveVertices(SampleWorldBounds, topVertices[i], delta).is_success())
+        {
+          ++movedBrushes;
+        }
+      }
+    },
+    "move vertices" + suffix,
+    0,
+    brushes.size());
+  CHECK(movedBrushes > 0u);
+}
+
+TEST_CASE("BrushBenchmark.csg")
+{
+  const auto& brushes = loadSampleBrushes();
+  const auto pairs = findIntersectingBrushes(brushes, MaxBrushPairs);
+  REQUIRE(!pairs.empty());
+  const auto suffix = " (" + std::to_string(pairs.size()) + " pairs of sample brushes)";
+
+  auto fragments = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (const auto& [lhs, rhs] : pairs)
+      {
+        fragments +=
+          brushes[lhs]
+            .subtract(MapFormat::Standard, SampleWorldBounds, TextureName, brushes[rhs])
+            .size();
+      }
+    },
+    "subtract" + suffix,
+    0,
+    pairs.size());
+  CHECK(fragments > 0u);
+
+  auto intersections = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (const auto& [lhs, rhs] : pairs)
+      {
+        auto copy = brushes[lhs];
+        if (copy.intersect(SampleWorldBounds, brushes[rhs]).is_success())
+        {
+          ++intersections;
+        }
+      }
+    },
+    "intersect" + suffix,
+    0,
+    pairs.size());
+  CHECK(intersections > 0u);
+
+  const auto builder = BrushBuilder{MapFormat::Standard, SampleWorldBounds};
+  auto merged = size_t(0);
+  timeLambdaWithThroughput(
+    [&]() {
+      for (const auto& [lhs, rhs] : pairs)
+      {
+        const auto points =
+          kdl::vec_concat(brushes[lhs].vertexPositions(), brushes[rhs].vertexPositions());
+        if (builder.createBrush(points, TextureName).is_success())
+        {
+          ++merged;
+        }
+      }
+    },
+    "convex merge" + suffix,
+    0,
+    pairs.size());
+  CHECK(merged > 0u);
+}
+
+} // namespace Model
+} // namespace TrenchBroom
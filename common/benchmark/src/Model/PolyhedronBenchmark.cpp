@@ -0,0 +1,203 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+#include "FloatType.h"
+#include "Model/Brush.h"
+#include "Model/Polyhedron.h"
+#include "Model/Polyhedron3.h"
+#include "Model/Polyhedron_Instantiation.h"
+#include "SampleBrushes.h"
+
+#include "kdl/vector_utils.h"
+
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr size_t NumRepetitions = 10;
+constexpr size_t MaxBrushPairs = 5000;
+
+/**
+ * Returns the given number of random points within a cube. Most of these points are
+ * inside of their convex hull.
+ */
+std::vector<vm::vec3> makePointsInCube(const size_t count, std::mt19937& rng)
+{
+  auto dist = std::uniform_real_distribution<FloatType>{-256.0, 256.0};
+
+  auto result = std::vector<vm::vec3>{};
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    result.push_back(vm::round(vm::vec3{dist(rng), dist(rng), dist(rng)}));
+  }
+  return result;
+}
+
+/**
+ * Returns the given number of random points on a sphere. Most of these points are
+ * vertices of their convex hull.
+ */
+std::vector<vm::vec3> makePointsOnSphere(const size_t count, std::mt19937& rng)
+{
+  auto dist = std::normal_distribution<FloatType>{};
+
+  auto result = std::vector<vm::vec3>{};
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto direction = vm::normalize(vm::vec3{dist(rng), dist(rng), dist(rng)});
+    result.push_back(vm::round(direction * 256.0));
+  }
+  return result;
+}
+
+template <typename MakePoints>
+void benchmarkConvexHull(
+  const size_t pointCount, const MakePoints& makePoints, const std::string& shape)
+{
+  auto rng = std::mt19937{static_cast<std::mt19937::result_type>(pointCount)};
+
+  auto pointSets = std::vector<std::vector<vm::vec3>>{};
+  pointSets.reserve(NumRepetitions);
+  for (size_t i = 0; i < NumRepetitions; ++i)
+  {
+    pointSets.push_back(makePoints(pointCount, rng));
+  }
+
+  auto vertexCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& points : pointSets)
+      {
+        const auto polyhedron = Polyhedron3{points};
+        vertexCount += polyhedron.vertexCount();
+      }
+    },
+    "Build " + std::to_string(NumRepetitions) + " convex hulls of "
+      + std::to_string(pointCount) + " points " + shape);
+
+  CHECK(vertexCount > 0u);
+}
+} // namespace
+
+TEST_CASE("PolyhedronBenchmark.convexHull")
+{
+  for (const size_t pointCount : {8u, 64u, 512u, 4096u})
+  {
+    benchmarkConvexHull(pointCount, makePointsInCube, "in a cube");
+    benchmarkConvexHull(pointCount, makePointsOnSphere, "on a sphere");
+  }
+}
+
+TEST_CASE("PolyhedronBenchmark.sampleMap")
+{
+  const auto& brushes = loadSampleBrushes();
+  REQUIRE(!brushes.empty());
+
+  const auto vertexPositions = kdl::vec_transform(
+    brushes, [](const auto& brush) { return brush.vertexPositions(); });
+
+  auto polyhedra = std::vector<Polyhedron3>{};
+  timeLambda(
+    [&]() {
+      polyhedra.reserve(vertexPositions.size());
+      for (const auto& positions : vertexPositions)
+      {
+        polyhedra.emplace_back(positions);
+      }
+    },
+    "Build " + std::to_string(brushes.size()) + " sample brush polyhedra");
+  CHECK(polyhedra.size() == brushes.size());
+
+  auto clipped = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& polyhedron : polyhedra)
+      {
+        const auto center = polyhedron.bounds().center();
+        const auto plane = vm::plane3{center, vm::normalize(vm::vec3{1, 2, 3})};
+
+        auto copy = polyhedron;
+        if (copy.clip(plane).success())
+        {
+          ++clipped;
+        }
+      }
+    },
+    "Clip " + std::to_string(polyhedra.size()) + " sample brush polyhedra");
+  CHECK(clipped > 0u);
+
+  const auto pairs = findIntersectingBrushes(brushes, MaxBrushPairs);
+  REQUIRE(!pairs.empty());
+  const auto pairCount = std::to_string(pairs.size());
+
+  auto intersections = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& [lhs, rhs] : pairs)
+      {
+        if (!polyhedra[lhs].intersect(polyhedra[rhs]).empty())
+        {
+          ++intersections;
+        }
+      }
+    },
+    "Intersect " + pairCount + " pairs of sample brush polyhedra");
+  CHECK(intersections > 0u);
+
+  auto fragments = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& [lhs, rhs] : pairs)
+      {
+        fragments += polyhedra[lhs].subtract(polyhedra[rhs]).size();
+      }
+    },
+    "Subtract " + pairCount + " pairs of sample brush polyhedra");
+  CHECK(fragments > 0u);
+
+  auto mergedVertices = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& [lhs, rhs] : pairs)
+      {
+        const auto merged =
+          Polyhedron3{kdl::vec_concat(vertexPositions[lhs], vertexPositions[rhs])};
+        mergedVertices += merged.vertexCount();
+      }
+    },
+    "Merge " + pairCount + " pairs of sample brush polyhedra");
+  CHECK(mergedVertices > 0u);
+}
+
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SampleBrushes.h"
+
+#include "Error.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
+#include "Model/NodeQueries.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr size_t MaxLookahead = 64;
+
+std::vector<Brush> doLoadSampleBrushes()
+{
+  const auto mapPath =
+    std::filesystem::current_path() / "fixture/benchmark/AABBTree/ne_ruins.map";
+
+  return IO::Disk::mapFile(mapPath)
+    .transform([](auto file) {
+      auto status = IO::TestParserStatus{};
+      auto fileReader = file->reader().buffer();
+      auto worldReader =
+        IO::WorldReader{fileReader.stringView(), MapFormat::Standard, {}};
+      const auto world = worldReader.read(SampleWorldBounds, status);
+
+      const auto brushNodes = filterBrushNodes(collectDescendants(
+        std::vector<Node*>{world.get()}, [](const BrushNode*) { return true; }));
+      return kdl::vec_transform(
+        brushNodes, [](const auto* brushNode) { return brushNode->brush(); });
+    })
+    .value();
+}
+} // namespace
+
+const std::vector<Brush>& loadSampleBrushes()
+{
+  static const auto brushes = doLoadSampleBrushes();
+  return brushes;
+}
+
+std::vector<std::pair<size_t, size_t>> findIntersectingBrushes(
+  const std::vector<Brush>& brushes, const size_t maxPairs)
+{
+  // sweep along the X axis and only look at a few brushes ahead, this is good enough to
+  // find neighbouring brushes
+  auto indices = std::vector<size_t>(brushes.size());
+  std::iota(std::begin(indices), std::end(indices), 0u);
+  std::sort(std::begin(indices), std::end(indices), [&](const auto lhs, const auto rhs) {
+    return brushes[lhs].bounds().min.x() < brushes[rhs].bounds().min.x();
+  });
+
+  auto result = std::vector<std::pair<size_t, size_t>>{};
+  for (size_t i = 0; i < indices.size() && result.size() < maxPairs; ++i)
+  {
+    const auto& bounds = brushes[indices[i]].bounds();
+    const auto end = std::min(indices.size(), i + 1u + MaxLookahead);
+    for (size_t j = i + 1u; j < end; ++j)
+    {
+      if (bounds.intersects(brushes[indices[j]].bounds()))
+      {
+        result.emplace_back(indices[i], indices[j]);
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace Model
+} // namespace TrenchBroom
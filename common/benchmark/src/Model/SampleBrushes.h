@@ -0,0 +1,53 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Model/Brush.h"
+
+#include "vm/bbox.h"
+
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+/**
+ * The world bounds used to load the sample map.
+ */
+const auto SampleWorldBounds = vm::bbox3{8192.0};
+
+/**
+ * Loads the brushes of the sample map from the benchmark fixtures. The brushes of this
+ * map are a realistic mix of large structural brushes, trims and detail brushes.
+ */
+const std::vector<Brush>& loadSampleBrushes();
+
+/**
+ * Returns pairs of indices of the given brushes whose bounds intersect such as the
+ * brushes which overlap or touch in a map. At most the given number of pairs is returned.
+ * Every brush appears as the first element of at most one pair.
+ */
+std::vector<std::pair<size_t, size_t>> findIntersectingBrushes(
+  const std::vector<Brush>& brushes, size_t maxPairs);
+
+} // namespace Model
+} // namespace TrenchBroom
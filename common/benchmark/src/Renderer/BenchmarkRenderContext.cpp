@@ -0,0 +1,60 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRenderContext.h"
+
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include "vm/vec.h"
+
+namespace TrenchBroom::Renderer
+{
+namespace
+{
+std::unique_ptr<Camera> createCamera(const RenderMode renderMode)
+{
+  const auto viewport = Camera::Viewport{0, 0, 1920, 1080};
+  const auto position = vm::vec3f::zero();
+  const auto direction = vm::vec3f::pos_x();
+  const auto up = vm::vec3f::pos_z();
+
+  if (renderMode == RenderMode::Render3D)
+  {
+    return std::make_unique<PerspectiveCamera>(
+      90.0f, 1.0f, 8192.0f, viewport, position, direction, up);
+  }
+  return std::make_unique<OrthographicCamera>(
+    1.0f, 8192.0f, viewport, position, direction, up);
+}
+} // namespace
+
+BenchmarkRenderContext::BenchmarkRenderContext(const RenderMode renderMode)
+  : m_camera{createCamera(renderMode)}
+  , m_vboManager{&m_shaderManager}
+  , m_renderMode{renderMode}
+{
+}
+
+Camera& BenchmarkRenderContext::camera()
+{
+  return *m_camera;
+}
+
+} // namespace TrenchBroom::Renderer
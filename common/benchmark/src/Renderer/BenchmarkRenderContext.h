@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Renderer/Camera.h"
+#include "Renderer/FontManager.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/VboManager.h"
+
+#include <memory>
+
+namespace TrenchBroom::Renderer
+{
+
+/**
+ * Lets renderers generate their vertices without a GL context.
+ *
+ * Renderers do most of their work on the CPU when they are asked to render into a
+ * render batch. Uploading the vertices and drawing them is deferred until the batch is
+ * rendered. render() discards the batch instead, so only the CPU side is measured.
+ */
+class BenchmarkRenderContext
+{
+private:
+  std::unique_ptr<Camera> m_camera;
+  FontManager m_fontManager;
+  ShaderManager m_shaderManager;
+  VboManager m_vboManager;
+  RenderMode m_renderMode;
+
+public:
+  /**
+   * Creates a 1920x1080 viewport with a perspective camera for 3D and an orthographic
+   * camera for 2D. The camera is located at the origin and looks along the X axis.
+   */
+  explicit BenchmarkRenderContext(RenderMode renderMode = RenderMode::Render3D);
+
+  Camera& camera();
+
+  template <typename F>
+  void render(const F& f)
+  {
+    auto renderContext =
+      RenderContext{m_renderMode, *m_camera, m_fontManager, m_shaderManager};
+    auto renderBatch = RenderBatch{m_vboManager};
+    f(renderContext, renderBatch);
+  }
+};
+
+} // namespace TrenchBroom::Renderer
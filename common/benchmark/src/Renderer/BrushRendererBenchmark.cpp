@@ -129,6 +129,24 @@ TEST_CASE("BrushRendererBenchmark.benchBrushRenderer")
     },
     "validate after removing one brush");
 
+  // Partial invalidation: invalidate every 100th brush, e.g. after changing a texture
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i + 1 < brushes.size(); i += 100)
+      {
+        r.invalidateBrush(brushes[i]);
+      }
+    },
+    "invalidate every 100th brush");
+  timeLambda(
+    [&]() {
+      if (!r.valid())
+      {
+        r.validate();
+      }
+    },
+    "validate after invalidating every 100th brush");
+
   // Large change: keep every second brush
   timeLambda(
     [&]() {
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityModelManager.h"
+#include "BenchmarkRenderContext.h"
+#include "BenchmarkUtils.h"
+#include "Logger.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/EntityRenderer.h"
+#include "Renderer/GL.h"
+
+#include "kdl/string_utils.h"
+
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom::Renderer
+{
+namespace
+{
+constexpr size_t NumEntities = 10'000;
+constexpr size_t NumClassnames = 64;
+
+/**
+ * Creates point entities in a grid in front of the camera of BenchmarkRenderContext,
+ * close enough for their classnames and angles to be rendered.
+ */
+std::vector<Model::Node*> createEntities()
+{
+  auto result = std::vector<Model::Node*>{};
+  result.reserve(NumEntities);
+  for (size_t i = 0; i < NumEntities; ++i)
+  {
+    const auto x = 64 + (i % 10) * 40;
+    const auto y = static_cast<int>((i / 10) % 40) * 16 - 320;
+    const auto z = static_cast<int>(i / 400) * 16 - 200;
+
+    result.push_back(new Model::EntityNode{Model::Entity{
+      {},
+      {
+        {"classname", "info_benchmark_" + std::to_string(i % NumClassnames)},
+        {"origin", kdl::str_to_string(x, " ", y, " ", z)},
+        {"angle", std::to_string(i % 360)},
+      }}});
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("EntityRendererBenchmark")
+{
+  auto logger = NullLogger{};
+  auto entityModelManager = Assets::EntityModelManager{GL_NEAREST, GL_NEAREST, logger};
+  const auto editorContext = Model::EditorContext{};
+
+  auto world = Model::WorldNode{{}, {}, Model::MapFormat::Standard};
+  const auto entityNodes = createEntities();
+  world.defaultLayer()->addChildren(entityNodes);
+
+  auto renderer = EntityRenderer{logger, entityModelManager, editorContext};
+  renderer.setShowOverlays(true);
+  renderer.setShowAngles(true);
+
+  auto context = BenchmarkRenderContext{};
+  const auto render = [&]() {
+    context.render([&](auto& renderContext, auto& renderBatch) {
+      renderer.render(renderContext, renderBatch);
+    });
+  };
+
+  const auto suffix = " (" + std::to_string(NumEntities) + " entities)";
+
+  // adding an entity looks up its model, but the entities have no definitions and thus
+  // no models because the model files would have to be loaded from a game
+  timeLambdaWithAllocations(
+    [&]() {
+      for (const auto* node : entityNodes)
+      {
+        renderer.addEntity(static_cast<const Model::EntityNode*>(node));
+      }
+    },
+    "add entities to EntityRenderer" + suffix);
+
+  // the first render validates the bounds of all entities
+  timeLambdaWithAllocations(render, "render after adding entities" + suffix);
+
+  // the classnames and angles are generated in every frame
+  timeLambdaWithAllocations(render, "render without changes" + suffix);
+
+  renderer.invalidateEntity(static_cast<const Model::EntityNode*>(entityNodes.front()));
+  timeLambdaWithAllocations(render, "render after invalidating one entity" + suffix);
+
+  renderer.clear();
+}
+
+} // namespace TrenchBroom::Renderer
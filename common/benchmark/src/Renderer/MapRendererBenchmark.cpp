@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../View/BenchmarkDocument.h"
+#include "BenchmarkRenderContext.h"
+#include "BenchmarkUtils.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Renderer/EntityLinkRenderer.h"
+#include "Renderer/MapRenderer.h"
+#include "View/MapDocument.h"
+
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/vec.h"
+
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom::Renderer
+{
+namespace
+{
+constexpr size_t NumBrushes = 20'000;
+constexpr size_t NumEntities = 5'000;
+
+/**
+ * Creates a chain of point entities in which every entity targets the next one.
+ */
+std::vector<Model::Node*> createEntityChain()
+{
+  auto result = std::vector<Model::Node*>{};
+  result.reserve(NumEntities);
+  for (size_t i = 0; i < NumEntities; ++i)
+  {
+    const auto x = static_cast<int>(i % 64) * 32;
+    const auto y = static_cast<int>(i / 64) * 32;
+    result.push_back(new Model::EntityNode{Model::Entity{
+      {},
+      {
+        {"classname", "info_benchmark"},
+        {"origin", kdl::str_to_string(x, " ", y, " -64")},
+        {"targetname", "t" + std::to_string(i)},
+        {"target", "t" + std::to_string(i + 1)},
+      }}});
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("MapRendererBenchmark")
+{
+  auto benchmarkDocument = View::createBenchmarkDocument();
+  auto& document = benchmarkDocument.document;
+
+  auto mapRenderer = MapRenderer{document};
+  auto context = BenchmarkRenderContext{};
+  const auto render = [&]() {
+    context.render([&](auto& renderContext, auto& renderBatch) {
+      mapRenderer.render(renderContext, renderBatch);
+    });
+  };
+
+  const auto brushNodes = View::createBrushGrid(*document, NumBrushes);
+  const auto entityNodes = createEntityChain();
+  document->addNodes({{document->parentForNodes(), brushNodes}});
+  document->addNodes({{document->parentForNodes(), entityNodes}});
+
+  const auto suffix = " (" + std::to_string(NumBrushes) + " brushes, "
+                      + std::to_string(NumEntities) + " entities)";
+
+  timeLambdaWithAllocations(render, "render after adding nodes" + suffix);
+
+  // selecting moves nodes from the default renderer to the selection renderer
+  const auto halfOfBrushes =
+    std::vector<Model::Node*>{brushNodes.begin(), brushNodes.begin() + NumBrushes / 2};
+  document->selectNodes(halfOfBrushes);
+  timeLambdaWithAllocations(
+    render, "render after selecting half of the brushes" + suffix);
+
+  document->deselectAll();
+  timeLambdaWithAllocations(render, "render after deselecting all brushes" + suffix);
+
+  // the default entity link mode only shows the links of selected entities
+  document->selectNodes(entityNodes);
+  render();
+
+  auto entityLinkRenderer = EntityLinkRenderer{document};
+  timeLambdaWithAllocations(
+    [&]() { entityLinkRenderer.validate(); },
+    "generate links of " + std::to_string(NumEntities) + " selected entities");
+
+  // changing a single brush invalidates only that brush in the vertex caches
+  document->deselectAll();
+  render();
+  document->selectNodes({brushNodes.front()});
+  document->translateObjects(vm::vec3{16, 0, 0});
+  timeLambdaWithAllocations(render, "render after moving one brush" + suffix);
+}
+
+} // namespace TrenchBroom::Renderer
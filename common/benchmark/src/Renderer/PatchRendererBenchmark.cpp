@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRenderContext.h"
+#include "BenchmarkUtils.h"
+#include "Model/BezierPatch.h"
+#include "Model/EditorContext.h"
+#include "Model/PatchNode.h"
+#include "Renderer/PatchRenderer.h"
+
+#include "kdl/vector_utils.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom::Renderer
+{
+namespace
+{
+constexpr size_t NumPatches = 2'000;
+constexpr size_t NumControlPoints = 9;
+
+/**
+ * Returns a wavy patch whose control points span 256 units and whose origin is at the
+ * given position.
+ */
+Model::BezierPatch makePatch(const vm::vec3& origin)
+{
+  auto points = std::vector<Model::BezierPatch::Point>{};
+  points.reserve(NumControlPoints * NumControlPoints);
+  for (size_t row = 0; row < NumControlPoints; ++row)
+  {
+    for (size_t col = 0; col < NumControlPoints; ++col)
+    {
+      const auto x = static_cast<FloatType>(col) * 32.0;
+      const auto y = static_cast<FloatType>(row) * 32.0;
+      const auto z = 32.0 * std::sin(x / 64.0) * std::cos(y / 64.0);
+      const auto u = static_cast<FloatType>(col) / (NumControlPoints - 1);
+      const auto v = static_cast<FloatType>(row) / (NumControlPoints - 1);
+      points.push_back(Model::BezierPatch::Point{
+        origin.x() + x, origin.y() + y, origin.z() + z, u, v});
+    }
+  }
+  return Model::BezierPatch{NumControlPoints, NumControlPoints, std::move(points), ""};
+}
+
+/**
+ * Creates patches in a row that extends from the camera of BenchmarkRenderContext along
+ * the X axis so that their levels of detail vary.
+ */
+std::vector<Model::PatchNode*> createPatches()
+{
+  auto result = std::vector<Model::PatchNode*>{};
+  result.reserve(NumPatches);
+  for (size_t i = 0; i < NumPatches; ++i)
+  {
+    const auto origin = vm::vec3{
+      64.0 + static_cast<FloatType>(i / 10) * 32.0,
+      static_cast<FloatType>(i % 10) * 288.0 - 1440.0,
+      -128.0};
+    result.push_back(new Model::PatchNode{makePatch(origin)});
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("PatchRendererBenchmark")
+{
+  const auto suffix = " (" + std::to_string(NumPatches) + " patches)";
+
+  // creating a patch node tessellates the patch
+  auto patchNodes = std::vector<Model::PatchNode*>{};
+  timeLambdaWithAllocations(
+    [&]() { patchNodes = createPatches(); }, "tessellate patches" + suffix);
+
+  const auto editorContext = Model::EditorContext{};
+  auto renderer = PatchRenderer{editorContext};
+  for (const auto* patchNode : patchNodes)
+  {
+    renderer.addPatch(patchNode);
+  }
+
+  auto context3D = BenchmarkRenderContext{RenderMode::Render3D};
+  const auto render3D = [&]() {
+    context3D.render([&](auto& renderContext, auto& renderBatch) {
+      renderer.render(renderContext, renderBatch);
+    });
+  };
+
+  timeLambdaWithAllocations(render3D, "build levels of detail" + suffix);
+  timeLambdaWithAllocations(render3D, "render 3D without changes" + suffix);
+
+  context3D.camera().moveTo(vm::vec3f{1024, 0, 0});
+  timeLambdaWithAllocations(render3D, "rebuild levels of detail after moving" + suffix);
+
+  auto context2D = BenchmarkRenderContext{RenderMode::Render2D};
+  timeLambdaWithAllocations(
+    [&]() {
+      context2D.render([&](auto& renderContext, auto& renderBatch) {
+        renderer.render(renderContext, renderBatch);
+      });
+    },
+    "build full detail" + suffix);
+
+  renderer.clear();
+  kdl::vec_clear_and_delete(patchNodes);
+}
+
+} // namespace TrenchBroom::Renderer
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRenderContext.h"
+#include "BenchmarkUtils.h"
+#include "Renderer/RenderService.h"
+
+#include "vm/vec.h"
+
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom::Renderer
+{
+namespace
+{
+constexpr size_t NumLabels = 5'000;
+
+struct Label
+{
+  std::string text;
+  vm::vec3f position;
+};
+
+/**
+ * Creates labels in a grid in front of the camera of BenchmarkRenderContext, close
+ * enough to be rendered.
+ */
+std::vector<Label> createLabels()
+{
+  auto result = std::vector<Label>{};
+  result.reserve(NumLabels);
+  for (size_t i = 0; i < NumLabels; ++i)
+  {
+    result.push_back(Label{
+      "label_" + std::to_string(i),
+      vm::vec3f{
+        static_cast<float>(128 + (i % 10) * 48),
+        static_cast<float>((i / 10) % 50) * 12.0f - 300.0f,
+        static_cast<float>(i / 500) * 16.0f - 80.0f}});
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("TextRendererBenchmark")
+{
+  const auto labels = createLabels();
+  auto context = BenchmarkRenderContext{};
+
+  // load the font so that it isn't included in the measurement
+  context.render([&](auto& renderContext, auto& renderBatch) {
+    auto renderService = RenderService{renderContext, renderBatch};
+    renderService.renderString(labels.front().text, labels.front().position);
+  });
+
+  timeLambdaWithAllocations(
+    [&]() {
+      context.render([&](auto& renderContext, auto& renderBatch) {
+        auto renderService = RenderService{renderContext, renderBatch};
+        for (const auto& label : labels)
+        {
+          renderService.renderString(label.text, label.position);
+        }
+      });
+    },
+    "render " + std::to_string(NumLabels) + " labels");
+}
+
+} // namespace TrenchBroom::Renderer
@@ -0,0 +1,114 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkDocument.h"
+
+#include "Error.h"
+#include "Logger.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/GameConfig.h"
+#include "Model/GameImpl.h"
+#include "Model/MapFormat.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include "kdl/result.h"
+
+#include "vm/vec.h"
+
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+
+namespace TrenchBroom::View
+{
+namespace
+{
+Model::GameConfig makeGameConfig()
+{
+  return Model::GameConfig{
+    "Benchmark",
+    {},
+    {},
+    false,
+    {Model::MapFormatConfig{"Standard", {}}},
+    Model::FileSystemConfig{{}, Model::PackageFormatConfig{{}, "idpak"}},
+    Model::TextureConfig{{"textures"}, {".D"}, {}, "wad", {}, {}},
+    Model::EntityConfig{{}, Color{0.6f, 0.6f, 0.6f, 1.0f}, {}, false},
+    Model::FaceAttribsConfig{},
+    {},
+    std::nullopt,
+    {}};
+}
+} // namespace
+
+BenchmarkDocument::~BenchmarkDocument() = default;
+
+BenchmarkDocument createBenchmarkDocument()
+{
+  auto logger = NullLogger{};
+  auto gameConfig = std::make_unique<Model::GameConfig>(makeGameConfig());
+  auto game =
+    std::make_shared<Model::GameImpl>(*gameConfig, std::filesystem::path{}, logger);
+
+  auto document = MapDocumentCommandFacade::newMapDocument();
+  document->newDocument(Model::MapFormat::Standard, BenchmarkWorldBounds, game)
+    .transform_error([](auto e) { throw std::runtime_error{e.msg}; });
+
+  return {std::move(gameConfig), std::move(game), std::move(document)};
+}
+
+size_t brushGridSize(const size_t brushCount)
+{
+  return static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(brushCount))));
+}
+
+vm::bbox3 brushGridBounds(const size_t brushCount)
+{
+  const auto extent =
+    static_cast<FloatType>(brushGridSize(brushCount)) * BrushGridSpacing;
+  return vm::bbox3{vm::vec3::zero(), vm::vec3::fill(extent)};
+}
+
+std::vector<Model::Node*> createBrushGrid(
+  const MapDocument& document, const size_t brushCount)
+{
+  const auto builder =
+    Model::BrushBuilder{Model::MapFormat::Standard, BenchmarkWorldBounds};
+  const auto size = brushGridSize(brushCount);
+
+  auto nodes = std::vector<Model::Node*>{};
+  nodes.reserve(brushCount);
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto min =
+      vm::vec3{
+        static_cast<FloatType>(i % size),
+        static_cast<FloatType>((i / size) % size),
+        static_cast<FloatType>(i / (size * size))}
+      * BrushGridSpacing;
+    const auto bounds = vm::bbox3{min, min + vm::vec3::fill(BrushGridCubeSize)};
+    nodes.push_back(new Model::BrushNode{
+      builder.createCuboid(bounds, document.currentTextureName()).value()});
+  }
+  return nodes;
+}
+
+} // namespace TrenchBroom::View
@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+
+#include "vm/bbox.h"
+
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class Game;
+struct GameConfig;
+class Node;
+} // namespace Model
+
+namespace View
+{
+class MapDocument;
+
+const auto BenchmarkWorldBounds = vm::bbox3{8192.0};
+
+// the size of the cubes created by createBrushGrid and the distance between their origins
+constexpr auto BrushGridCubeSize = FloatType(32);
+constexpr auto BrushGridSpacing = FloatType(64);
+
+/**
+ * A headless document for a game with a minimal configuration that needs no game files.
+ */
+struct BenchmarkDocument
+{
+  // the members are destroyed in reverse order, so the config outlives the game, which
+  // keeps a reference to it
+  std::unique_ptr<Model::GameConfig> gameConfig;
+  std::shared_ptr<Model::Game> game;
+  std::shared_ptr<MapDocument> document;
+
+  ~BenchmarkDocument();
+};
+
+BenchmarkDocument createBenchmarkDocument();
+
+/**
+ * Returns the size of the cubic grid that holds the given number of brushes.
+ */
+size_t brushGridSize(size_t brushCount);
+
+/**
+ * Returns the bounds of the cubic grid that holds the given number of brushes.
+ */
+vm::bbox3 brushGridBounds(size_t brushCount);
+
+/**
+ * Creates the given number of cubes, arranged in a cubic grid starting at the origin.
+ */
+std::vector<Model::Node*> createBrushGrid(const MapDocument& document, size_t brushCount);
+
+} // namespace View
+} // namespace TrenchBroom
@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkDocument.h"
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushNode.h"
+#include "Model/GroupNode.h"
+#include "Model/MapFormat.h"
+#include "View/MapDocument.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <string>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom::View
+{
+TEST_CASE("MapDocumentBenchmark")
+{
+  const auto brushCount = GENERATE(values<size_t>({10000, 100000}));
+  const auto suffix = " (" + std::to_string(brushCount) + " brushes)";
+
+  auto benchmarkDocument = createBenchmarkDocument();
+  auto& document = benchmarkDocument.document;
+
+  document->addNodes(
+    {{document->parentForNodes(), createBrushGrid(*document, brushCount)}});
+  document->selectAllNodes();
+  REQUIRE(document->selectedNodes().brushCount() == brushCount);
+
+  const auto center = brushGridBounds(brushCount).center();
+
+  timeLambdaWithAllocations(
+    [&]() { CHECK(document->translateObjects(vm::vec3{16, 0, 0})); },
+    "translate" + suffix);
+
+  timeLambdaWithAllocations(
+    [&]() {
+      CHECK(document->rotateObjects(center, vm::vec3::pos_z(), vm::Cd::half_pi()));
+    },
+    "rotate" + suffix);
+
+  timeLambdaWithAllocations(
+    [&]() {
+      CHECK(document->setFaceAttributes(Model::BrushFaceAttributes{"benchmark"}));
+    },
+    "setFaceAttributes" + suffix);
+
+  timeLambdaWithAllocations([&]() { document->undoCommand(); }, "undo" + suffix);
+  timeLambdaWithAllocations([&]() { document->redoCommand(); }, "redo" + suffix);
+
+  // subtract a slab that cuts through the bottom layer of the grid
+  document->deselectAll();
+  auto bounds = brushGridBounds(brushCount).expand(BrushGridSpacing);
+  bounds.min[2] = BrushGridCubeSize / 2;
+  bounds.max[2] = BrushGridCubeSize + BrushGridCubeSize / 2;
+  const auto builder =
+    Model::BrushBuilder{Model::MapFormat::Standard, BenchmarkWorldBounds};
+  auto* slab = new Model::BrushNode{builder.createCuboid(bounds, "slab").value()};
+  document->addNodes({{document->parentForNodes(), {slab}}});
+  document->selectNodes({slab});
+
+  timeLambdaWithAllocations(
+    [&]() { CHECK(document->csgSubtract()); }, "csgSubtract" + suffix);
+
+  document->selectAllNodes();
+  auto* groupNode = static_cast<Model::GroupNode*>(nullptr);
+  timeLambdaWithAllocations(
+    [&]() { groupNode = document->groupSelection("group"); },
+    "groupSelection" + suffix);
+  REQUIRE(groupNode != nullptr);
+
+  timeLambdaWithAllocations(
+    [&]() { CHECK(document->createLinkedDuplicate() != nullptr); },
+    "createLinkedDuplicate" + suffix);
+
+  // changing a single brush of a linked group updates every brush of its duplicate
+  document->deselectAll();
+  document->openGroup(groupNode);
+  document->selectNodes({groupNode->children().front()});
+
+  timeLambdaWithAllocations(
+    [&]() { CHECK(document->translateObjects(vm::vec3{0, 0, 16})); },
+    "updateLinkedGroups" + suffix);
+
+  document->closeGroup();
+}
+
+} // namespace TrenchBroom::View
@@ -0,0 +1,139 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BenchmarkUtils.h"
+
+#include "kdl/compact_trie.h"
+
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace kdl
+{
+namespace
+{
+constexpr size_t NumEntries = 1000000;
+constexpr size_t NumKeys = 100000;
+constexpr size_t NumQueries = 100000;
+
+const auto Prefixes = std::vector<std::string>{
+  "light_",
+  "func_door_",
+  "trigger_multiple_",
+  "info_player_",
+  "monster_",
+  "item_",
+  "weapon_",
+  "path_corner_",
+};
+
+/**
+ * Creates keys that resemble the target names in a large map: a handful of common
+ * prefixes followed by a number. Every key is used by NumEntries / NumKeys values.
+ */
+std::vector<std::pair<std::string, size_t>> makeEntries()
+{
+  auto entries = std::vector<std::pair<std::string, size_t>>{};
+  entries.reserve(NumEntries);
+  for (size_t i = 0; i < NumEntries; ++i)
+  {
+    const auto k = (i * 7919) % NumKeys;
+    entries.emplace_back(Prefixes[k % Prefixes.size()] + std::to_string(k), i);
+  }
+  return entries;
+}
+
+std::vector<std::pair<std::string_view, size_t>> makeEntryViews(
+  const std::vector<std::pair<std::string, size_t>>& entries)
+{
+  auto views = std::vector<std::pair<std::string_view, size_t>>{};
+  views.reserve(entries.size());
+  for (const auto& [key, value] : entries)
+  {
+    views.emplace_back(key, value);
+  }
+  return views;
+}
+} // namespace
+
+TEST_CASE("CompactTrieBenchmark")
+{
+  const auto entries = makeEntries();
+
+  auto trie = compact_trie<size_t>{};
+  timeLambda(
+    [&]() {
+      for (const auto& [key, value] : entries)
+      {
+        trie.insert(key, value);
+      }
+    },
+    "insert " + std::to_string(NumEntries) + " entries");
+
+  auto bulkTrie = compact_trie<size_t>{};
+  timeLambda(
+    [&]() { bulkTrie.insert_all(makeEntryViews(entries)); },
+    "bulk insert " + std::to_string(NumEntries) + " entries");
+
+  auto matches = std::vector<size_t>{};
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumQueries; ++i)
+      {
+        trie.find_matches(entries[i].first, std::back_inserter(matches));
+      }
+    },
+    "find " + std::to_string(NumQueries) + " exact keys");
+  CHECK(matches.size() == NumQueries * NumEntries / NumKeys);
+
+  matches.clear();
+  timeLambda(
+    [&]() {
+      for (const auto& prefix : Prefixes)
+      {
+        trie.find_matches(prefix + "*", std::back_inserter(matches));
+        trie.find_matches(prefix + "1%%", std::back_inserter(matches));
+        trie.find_matches(prefix + "?2*", std::back_inserter(matches));
+      }
+    },
+    "find " + std::to_string(3 * Prefixes.size()) + " wildcard patterns");
+  CHECK(matches.size() > NumEntries);
+
+  auto removed = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& [key, value] : entries)
+      {
+        removed += trie.remove(key, value) ? 1 : 0;
+      }
+    },
+    "remove " + std::to_string(NumEntries) + " entries");
+  CHECK(removed == NumEntries);
+
+  auto keys = std::vector<std::string>{};
+  trie.get_keys(std::back_inserter(keys));
+  CHECK(keys.empty());
+}
+
+} // namespace kdl
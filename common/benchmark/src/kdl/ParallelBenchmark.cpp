@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+
+#include "kdl/parallel.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace kdl
+{
+namespace
+{
+constexpr size_t NumElements = 2000000;
+
+std::vector<vm::bbox3d> makeBounds()
+{
+  auto result = std::vector<vm::bbox3d>{};
+  result.reserve(NumElements);
+  for (size_t i = 0; i < NumElements; ++i)
+  {
+    const auto x = double((i * 7919) % 8192);
+    const auto y = double((i * 104729) % 8192);
+    const auto z = double((i * 1299709) % 8192);
+    result.emplace_back(vm::vec3d{x, y, z}, vm::vec3d{x + 64.0, y + 64.0, z + 64.0});
+  }
+  return result;
+}
+
+std::vector<std::string> makeNames()
+{
+  auto result = std::vector<std::string>{};
+  result.reserve(NumElements);
+  for (size_t i = 0; i < NumElements; ++i)
+  {
+    result.push_back("texture_" + std::to_string((i * 7919) % NumElements));
+  }
+  return result;
+}
+
+// stands in for a predicate that inspects a node, e.g. a visibility check
+bool expensivePredicate(const vm::bbox3d& bounds)
+{
+  auto sum = 0.0;
+  for (size_t i = 0; i < 64; ++i)
+  {
+    sum += bounds.min.x() * double(i) - bounds.max.y();
+  }
+  return sum > 0.0;
+}
+} // namespace
+
+TEST_CASE("ParallelBenchmark.reduce")
+{
+  const auto bounds = makeBounds();
+  const auto merge = [](const vm::bbox3d& lhs, const vm::bbox3d& rhs) {
+    return vm::merge(lhs, rhs);
+  };
+
+  auto serialResult = vm::bbox3d{};
+  timeLambda(
+    [&]() {
+      serialResult = bounds.front();
+      for (const auto& b : bounds)
+      {
+        serialResult = merge(serialResult, b);
+      }
+    },
+    "serial reduce of " + std::to_string(NumElements) + " bounds");
+
+  auto parallelResult = vm::bbox3d{};
+  timeLambda(
+    [&]() {
+      parallelResult = parallel_reduce(
+        bounds.size(),
+        bounds.front(),
+        [&](const size_t i) { return bounds[i]; },
+        merge);
+    },
+    "parallel reduce of " + std::to_string(NumElements) + " bounds");
+
+  CHECK(parallelResult == serialResult);
+}
+
+TEST_CASE("ParallelBenchmark.sort")
+{
+  const auto names = makeNames();
+
+  auto serialResult = names;
+  timeLambda(
+    [&]() { std::stable_sort(serialResult.begin(), serialResult.end()); },
+    "serial sort of " + std::to_string(NumElements) + " names");
+
+  auto parallelResult = names;
+  timeLambda(
+    [&]() { parallel_sort(parallelResult.begin(), parallelResult.end()); },
+    "parallel sort of " + std::to_string(NumElements) + " names");
+
+  CHECK(parallelResult == serialResult);
+}
+
+TEST_CASE("ParallelBenchmark.partition")
+{
+  const auto bounds = makeBounds();
+
+  auto serialResult = bounds;
+  timeLambda(
+    [&]() {
+      std::stable_partition(
+        serialResult.begin(), serialResult.end(), expensivePredicate);
+    },
+    "serial partition of " + std::to_string(NumElements) + " bounds");
+
+  auto parallelResult = bounds;
+  timeLambda(
+    [&]() {
+      parallel_partition(
+        parallelResult.begin(), parallelResult.end(), expensivePredicate);
+    },
+    "parallel partition of " + std::to_string(NumElements) + " bounds");
+
+  CHECK(parallelResult == serialResult);
+}
+
+} // namespace kdl
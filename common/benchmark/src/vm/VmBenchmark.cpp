@@ -0,0 +1,176 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+
+namespace vm
+{
+namespace
+{
+/**
+ * The operations are applied to a small working set many times, so that the benchmark
+ * measures the arithmetic and not the memory bandwidth. Every repetition consumes the
+ * results of the previous one, which keeps the compiler from hoisting the work out of
+ * the repetition loop.
+ */
+constexpr size_t NumValues = 1024;
+constexpr size_t NumRepetitions = 10000;
+
+template <typename T>
+std::vector<vec<T, 3>> makePoints()
+{
+  auto result = std::vector<vec<T, 3>>{};
+  result.reserve(NumValues);
+  for (size_t i = 0; i < NumValues; ++i)
+  {
+    result.emplace_back(T(i % 97), T(i % 89), T(i % 83));
+  }
+  return result;
+}
+
+template <typename T>
+void benchmarkVecAndMat(const std::string& typeName)
+{
+  const auto rotation = rotation_matrix(T(0.1), T(0.2), T(0.3));
+  const auto axis = normalize(vec<T, 3>{1, 2, 3});
+  const auto plane = vm::plane<T, 3>{vec<T, 3>{1, 2, 3}, axis};
+  const auto label = [&](const std::string& operation) {
+    return std::to_string(NumRepetitions * NumValues) + " " + operation + " (" + typeName
+           + ")";
+  };
+
+  auto points = makePoints<T>();
+  auto sum = T(0);
+  timeLambda(
+    [&]() {
+      for (size_t r = 0; r < NumRepetitions; ++r)
+      {
+        for (size_t i = 1; i < NumValues; ++i)
+        {
+          sum += dot(points[i], points[i - 1u]);
+        }
+        points[0] = points[0] + vec<T, 3>::one();
+      }
+    },
+    label("dot"));
+
+  timeLambda(
+    [&]() {
+      for (size_t r = 0; r < NumRepetitions; ++r)
+      {
+        for (auto& point : points)
+        {
+          point = cross(point, axis);
+        }
+      }
+    },
+    label("cross"));
+
+  points = makePoints<T>();
+  timeLambda(
+    [&]() {
+      for (size_t r = 0; r < NumRepetitions; ++r)
+      {
+        for (const auto& point : points)
+        {
+          sum += plane.point_distance(point);
+        }
+        points[0] = points[0] + vec<T, 3>::one();
+      }
+    },
+    label("point distance"));
+
+  timeLambda(
+    [&]() {
+      for (size_t r = 0; r < NumRepetitions; ++r)
+      {
+        for (auto& point : points)
+        {
+          point = rotation * point;
+        }
+      }
+    },
+    label("mat4x4 * vec3"));
+
+  timeLambda(
+    [&]() {
+      for (size_t r = 0; r < NumRepetitions; ++r)
+      {
+        transform_points(rotation, points.begin(), points.end());
+      }
+    },
+    label("transform_points"));
+
+  auto homogeneousPoints = std::vector<vec<T, 4>>{};
+  homogeneousPoints.reserve(NumValues);
+  for (const auto& point : points)
+  {
+    homogeneousPoints.push_back(to_homogeneous_coords(point));
+  }
+  timeLambda(
+    [&]() {
+      for (size_t r = 0; r < NumRepetitions; ++r)
+      {
+        for (auto& point : homogeneousPoints)
+        {
+          point = rotation * point;
+        }
+      }
+    },
+    label("mat4x4 * vec4"));
+
+  auto matrices = std::vector<mat<T, 4, 4>>(NumValues / 4u, rotation);
+  timeLambda(
+    [&]() {
+      for (size_t r = 0; r < NumRepetitions; ++r)
+      {
+        for (auto& matrix : matrices)
+        {
+          matrix = rotation * matrix;
+        }
+      }
+    },
+    std::to_string(NumRepetitions * NumValues / 4u) + " mat4x4 * mat4x4 (" + typeName
+      + ")");
+
+  // use the results so that the computations are not optimized away
+  CHECK(sum != T(0));
+  CHECK(points[1] != vec<T, 3>{});
+  CHECK(homogeneousPoints[1] != vec<T, 4>{});
+  CHECK(matrices[1] != mat<T, 4, 4>{});
+}
+} // namespace
+
+TEST_CASE("VmBenchmark")
+{
+  benchmarkVecAndMat<float>("float");
+  benchmarkVecAndMat<double>("double");
+}
+
+} // namespace vm
@@ -17,14 +17,139 @@ You should have received a copy of the GNU General Public License
 along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cstddef>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #pragma once
 
 namespace TrenchBroom::Assets
 {
 
+/**
+ * Defers the usage count changes of assets of type T while it is alive.
+ *
+ * Bulk operations such as cloning many brushes in parallel create and destroy a lot of
+ * asset references, and most of them refer to the same few assets. Instead of changing
+ * the atomic usage counts of these assets from every thread, the changes are collected
+ * while a batch is active, and they are applied to the assets when the batch is
+ * destroyed.
+ *
+ * A batch is only active on the threads that take part in the operation that created
+ * it. It is activated on the creating thread by its constructor, and every task that the
+ * operation runs on another thread must activate it by calling activate(). Usage count
+ * changes made by other threads are applied immediately. If a batch is already active on
+ * a thread, activating another batch on that thread has no effect.
+ *
+ * All activations must have ended before the batch is destroyed. While the batch is
+ * active, the usage counts of the assets are not up to date.
+ *
+ * T must provide a function adjustUsageCount(std::ptrdiff_t).
+ */
+template <typename T>
+class AssetUsageCountBatch
+{
+private:
+  using Deltas = std::unordered_map<T*, std::ptrdiff_t>;
+
+public:
+  /**
+   * Activates a batch on the current thread while it is alive. The changes recorded on
+   * this thread are handed to the batch when the activation ends.
+   */
+  class Activation
+  {
+  private:
+    AssetUsageCountBatch* m_batch = nullptr;
+    Deltas m_deltas;
+
+  public:
+    explicit Activation(AssetUsageCountBatch& batch)
+    {
+      if (!t_active)
+      {
+        m_batch = &batch;
+        t_active = this;
+      }
+    }
+
+    ~Activation()
+    {
+      if (m_batch)
+      {
+        t_active = nullptr;
+
+        const auto lock = std::lock_guard{m_batch->m_mutex};
+        for (const auto& [asset, delta] : m_deltas)
+        {
+          m_batch->m_deltas[asset] += delta;
+        }
+      }
+    }
+
+    Activation(const Activation&) = delete;
+    Activation(Activation&&) = delete;
+    Activation& operator=(const Activation&) = delete;
+    Activation& operator=(Activation&&) = delete;
+
+    friend class AssetUsageCountBatch;
+  };
+
+private:
+  inline static thread_local Activation* t_active = nullptr;
+
+  std::mutex m_mutex;
+  Deltas m_deltas;
+  std::optional<Activation> m_activation;
+
+public:
+  AssetUsageCountBatch() { m_activation.emplace(*this); }
+
+  ~AssetUsageCountBatch()
+  {
+    m_activation.reset();
+
+    for (const auto& [asset, delta] : m_deltas)
+    {
+      if (delta != 0)
+      {
+        asset->adjustUsageCount(delta);
+      }
+    }
+  }
+
+  AssetUsageCountBatch(const AssetUsageCountBatch&) = delete;
+  AssetUsageCountBatch(AssetUsageCountBatch&&) = delete;
+  AssetUsageCountBatch& operator=(const AssetUsageCountBatch&) = delete;
+  AssetUsageCountBatch& operator=(AssetUsageCountBatch&&) = delete;
+
+  /**
+   * Activates this batch on the current thread. Must be called by every task that the
+   * operation which created this batch runs on another thread.
+   */
+  Activation activate() { return Activation{*this}; }
+
+  /**
+   * Records the given usage count change if a batch is active on the current thread.
+   * Returns false if no batch is active, in which case the caller must change the usage
+   * count of the asset itself.
+   */
+  static bool defer(T* asset, const std::ptrdiff_t delta)
+  {
+    if (!t_active)
+    {
+      return false;
+    }
+
+    t_active->m_deltas[asset] += delta;
+    return true;
+  }
+};
+
 template <typename T>
 class AssetReference
 {
@@ -35,7 +160,7 @@ public:
   explicit AssetReference(T* asset = nullptr)
     : m_asset{asset}
   {
-    if (m_asset)
+    if (m_asset && !AssetUsageCountBatch<T>::defer(m_asset, 1))
     {
       m_asset->incUsageCount();
     }
@@ -53,7 +178,7 @@ public:
 
   ~AssetReference()
   {
-    if (m_asset)
+    if (m_asset && !AssetUsageCountBatch<T>::defer(m_asset, -1))
     {
       m_asset->decUsageCount();
     }
@@ -19,7 +19,7 @@
 
 #include "DecalDefinition.h"
 
-#include "EL/EvaluationContext.h"
+#include "EL/CachedExpression.h"
 #include "EL/Expressions.h"
 #include "EL/Types.h"
 #include "EL/Value.h"
@@ -69,16 +69,19 @@ kdl_reflect_impl(DecalSpecification);
 
 DecalDefinition::DecalDefinition()
   : m_expression{EL::LiteralExpression{EL::Value::Undefined}, 0, 0}
+  , m_cachedExpression{std::make_shared<EL::CachedExpression>(m_expression)}
 {
 }
 
 DecalDefinition::DecalDefinition(const size_t line, const size_t column)
   : m_expression{EL::LiteralExpression{EL::Value::Undefined}, line, column}
+  , m_cachedExpression{std::make_shared<EL::CachedExpression>(m_expression)}
 {
 }
 
 DecalDefinition::DecalDefinition(EL::Expression expression)
   : m_expression{std::move(expression)}
+  , m_cachedExpression{std::make_shared<EL::CachedExpression>(m_expression)}
 {
 }
 
@@ -89,12 +92,18 @@ void DecalDefinition::append(const DecalDefinition& other)
 
   auto cases = std::vector<EL::Expression>{std::move(m_expression), other.m_expression};
   m_expression = EL::Expression{EL::SwitchExpression{std::move(cases)}, line, column};
+  m_cachedExpression = std::make_shared<EL::CachedExpression>(m_expression);
+}
+
+const EL::Expression& DecalDefinition::expression() const
+{
+  return m_expression;
 }
 
 DecalSpecification DecalDefinition::decalSpecification(
   const EL::VariableStore& variableStore) const
 {
-  return convertToDecal(m_expression.evaluate(EL::EvaluationContext{variableStore}));
+  return convertToDecal(m_cachedExpression->evaluate(variableStore));
 }
 
 DecalSpecification DecalDefinition::defaultDecalSpecification() const
@@ -26,6 +26,7 @@
 #include "vm/vec.h"
 
 #include <iosfwd>
+#include <memory>
 
 namespace TrenchBroom::Assets
 {
@@ -47,6 +48,9 @@ class DecalDefinition
 private:
   EL::Expression m_expression;
 
+  // caches the results of evaluating m_expression, shared by all copies
+  std::shared_ptr<const EL::CachedExpression> m_cachedExpression;
+
 public:
   DecalDefinition();
   DecalDefinition(size_t line, size_t column);
@@ -54,6 +58,8 @@ public:
 
   void append(const DecalDefinition& other);
 
+  const EL::Expression& expression() const;
+
   /**
    * Evaluates the decal expresion, using the given variable store to interpolate
    * variables.
@@ -31,6 +31,7 @@
 #include "kdl/result.h"
 #include "kdl/vector_utils.h"
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -43,10 +44,11 @@ EntityDefinitionManager::~EntityDefinitionManager()
 
 Result<void> EntityDefinitionManager::loadDefinitions(
   const std::filesystem::path& path,
+  const std::optional<std::filesystem::path>& cacheDirectory,
   const IO::EntityDefinitionLoader& loader,
   IO::ParserStatus& status)
 {
-  return loader.loadEntityDefinitions(status, path)
+  return loader.loadEntityDefinitions(status, path, cacheDirectory)
     .transform(
       [&](auto entityDefinitions) { setDefinitions(std::move(entityDefinitions)); });
 }
@@ -97,6 +99,13 @@ std::vector<EntityDefinition*> EntityDefinitionManager::definitions() const
     m_definitions, [](const auto& definition) { return definition.get(); });
 }
 
+std::vector<EntityDefinition*> EntityDefinitionManager::findDefinitions(
+  const std::string_view filterText) const
+{
+  return kdl::vec_transform(
+    m_nameIndex.find(filterText), [&](const auto i) { return m_definitions[i].get(); });
+}
+
 const std::vector<EntityDefinitionGroup>& EntityDefinitionManager::groups() const
 {
   return m_groups;
@@ -132,15 +141,20 @@ void EntityDefinitionManager::updateCache()
 {
   clearCache();
 
+  m_cache.reserve(m_definitions.size());
   for (auto& definition : m_definitions)
   {
     m_cache[definition->name()] = definition.get();
   }
+
+  m_nameIndex = TrigramIndex{kdl::vec_transform(
+    m_definitions, [](const auto& d) { return std::string_view{d->name()}; })};
 }
 
 void EntityDefinitionManager::clearCache()
 {
   m_cache.clear();
+  m_nameIndex = TrigramIndex{};
 }
 
 void EntityDefinitionManager::clearGroups()
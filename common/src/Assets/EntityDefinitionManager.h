@@ -19,11 +19,14 @@
 
 #pragma once
 
+#include "Assets/TrigramIndex.h"
 #include "Result.h"
 
 #include <filesystem>
-#include <map>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 
@@ -48,16 +51,19 @@ enum class EntityDefinitionType;
 class EntityDefinitionManager
 {
 private:
-  using Cache = std::map<std::string, EntityDefinition*>;
+  using Cache = std::unordered_map<std::string, EntityDefinition*>;
   std::vector<std::unique_ptr<EntityDefinition>> m_definitions;
   std::vector<EntityDefinitionGroup> m_groups;
   Cache m_cache;
+  // indexes the names of m_definitions
+  TrigramIndex m_nameIndex;
 
 public:
   ~EntityDefinitionManager();
 
   Result<void> loadDefinitions(
     const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory,
     const IO::EntityDefinitionLoader& loader,
     IO::ParserStatus& status);
   void setDefinitions(std::vector<std::unique_ptr<EntityDefinition>> newDefinitions);
@@ -69,6 +75,12 @@ public:
     EntityDefinitionType type, EntityDefinitionSortOrder order) const;
   std::vector<EntityDefinition*> definitions() const;
 
+  /**
+   * Returns the definitions whose names contain each of the space separated parts of the
+   * given filter text, ignoring case.
+   */
+  std::vector<EntityDefinition*> findDefinitions(std::string_view filterText) const;
+
   const std::vector<EntityDefinitionGroup>& groups() const;
 
 private:
@@ -19,19 +19,24 @@
 
 #include "EntityModel.h"
 
+#include "Assets/SkinCache.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
+#include "Assets/TriangleBvh.h"
+#include "Exceptions.h"
 #include "Renderer/IndexRangeMap.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/TexturedIndexRangeMap.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
-#include "octree.h"
 
 #include "kdl/vector_utils.h"
 
 #include "vm/bbox.h"
 #include "vm/forward.h"
-#include "vm/intersection.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
 #include <string>
 
 namespace TrenchBroom
@@ -76,7 +81,6 @@ EntityModelLoadedFrame::EntityModelLoadedFrame(
   , m_bounds{bounds}
   , m_pitchType{pitchType}
   , m_orientation{orientation}
-  , m_spacialTree{std::make_unique<SpacialTree>(16.0f)}
 {
 }
 
@@ -109,19 +113,18 @@ Orientation EntityModelLoadedFrame::orientation() const
 
 float EntityModelLoadedFrame::intersect(const vm::ray3f& ray) const
 {
-  auto closestDistance = vm::nan<float>();
-
-  const auto candidates = m_spacialTree->find_intersectors(ray);
-  for (const TriNum triNum : candidates)
+  if (!m_spacialTree)
   {
-    const vm::vec3f& p1 = m_tris[triNum * 3 + 0];
-    const vm::vec3f& p2 = m_tris[triNum * 3 + 1];
-    const vm::vec3f& p3 = m_tris[triNum * 3 + 2];
-    closestDistance =
-      vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
+    m_spacialTree = std::make_unique<TriangleBvh>(m_tris);
   }
+  return m_spacialTree->intersect(ray);
+}
 
-  return closestDistance;
+size_t EntityModelLoadedFrame::memoryUsage() const
+{
+  return sizeof(EntityModelLoadedFrame) + m_name.capacity()
+         + m_tris.capacity() * sizeof(vm::vec3f)
+         + (m_spacialTree ? m_spacialTree->memoryUsage() : 0);
 }
 
 void EntityModelLoadedFrame::addToSpacialTree(
@@ -130,6 +133,8 @@ void EntityModelLoadedFrame::addToSpacialTree(
   const size_t index,
   const size_t count)
 {
+  m_spacialTree.reset();
+
   switch (primType)
   {
   case Renderer::PrimType::Points:
@@ -142,19 +147,12 @@ void EntityModelLoadedFrame::addToSpacialTree(
     m_tris.reserve(m_tris.size() + count);
     for (size_t i = 0; i < count; i += 3)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
       const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
       const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const size_t triIndex = m_tris.size() / 3u;
       m_tris.push_back(p1);
       m_tris.push_back(p2);
       m_tris.push_back(p3);
-      m_spacialTree->insert(bounds.bounds(), triIndex);
     }
     break;
   }
@@ -166,18 +164,11 @@ void EntityModelLoadedFrame::addToSpacialTree(
     const auto& p1 = Renderer::getVertexComponent<0>(vertices[index]);
     for (size_t i = 1; i < count - 1; ++i)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i]);
       const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const size_t triIndex = m_tris.size() / 3u;
       m_tris.push_back(p1);
       m_tris.push_back(p2);
       m_tris.push_back(p3);
-      m_spacialTree->insert(bounds.bounds(), triIndex);
     }
     break;
   }
@@ -188,15 +179,9 @@ void EntityModelLoadedFrame::addToSpacialTree(
     m_tris.reserve(m_tris.size() + (count - 2) * 3);
     for (size_t i = 0; i < count - 2; ++i)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
       const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
       const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const size_t triIndex = m_tris.size() / 3u;
       if (i % 2 == 0)
       {
         m_tris.push_back(p1);
@@ -209,7 +194,6 @@ void EntityModelLoadedFrame::addToSpacialTree(
         m_tris.push_back(p3);
         m_tris.push_back(p2);
       }
-      m_spacialTree->insert(bounds.bounds(), triIndex);
     }
     break;
   }
@@ -254,6 +238,8 @@ public:
   Orientation orientation() const override { return Orientation::Oriented; }
 
   float intersect(const vm::ray3f& /* ray */) const override { return vm::nan<float>(); }
+
+  size_t memoryUsage() const override { return sizeof(EntityModelUnloadedFrame); }
 };
 
 // EntityModel::Mesh
@@ -292,6 +278,15 @@ public:
     return doBuildRenderer(skin, vertexArray);
   }
 
+  /**
+   * Returns an estimate of the memory used by this mesh in bytes. The index ranges are
+   * not counted since they are small compared to the vertices.
+   */
+  size_t memoryUsage() const
+  {
+    return sizeof(EntityModelMesh) + m_vertices.capacity() * sizeof(EntityModelVertex);
+  }
+
 private:
   /**
    * Creates and returns the actual mesh renderer
@@ -393,7 +388,6 @@ private:
 EntityModelSurface::EntityModelSurface(std::string name, const size_t frameCount)
   : m_name{std::move(name)}
   , m_meshes{frameCount}
-  , m_skins{std::make_unique<TextureCollection>()}
 {
 }
 
@@ -406,12 +400,20 @@ const std::string& EntityModelSurface::name() const
 
 void EntityModelSurface::prepare(const int minFilter, const int magFilter)
 {
-  m_skins->prepare(minFilter, magFilter);
+  // skins are small, so they are uploaded all at once; shared skins which were already
+  // prepared by another surface are skipped
+  for (auto& skin : m_skins)
+  {
+    skin->prepare(minFilter, magFilter, false, std::numeric_limits<size_t>::max());
+  }
 }
 
 void EntityModelSurface::setTextureMode(const int minFilter, const int magFilter)
 {
-  m_skins->setTextureMode(minFilter, magFilter);
+  for (auto& skin : m_skins)
+  {
+    skin->setTextureMode(minFilter, magFilter);
+  }
 }
 
 void EntityModelSurface::addIndexedMesh(
@@ -436,7 +438,17 @@ void EntityModelSurface::addTexturedMesh(
 
 void EntityModelSurface::setSkins(std::vector<Texture> skins)
 {
-  m_skins = std::make_unique<TextureCollection>(std::move(skins));
+  m_skins = kdl::vec_transform(std::move(skins), [](auto skin) {
+    return makeSharedSkin(std::move(skin));
+  });
+}
+
+void EntityModelSurface::setSkins(std::vector<std::shared_ptr<TextureCollection>> skins)
+{
+  assert(std::all_of(skins.begin(), skins.end(), [](const auto& skin) {
+    return skin->textureCount() == 1;
+  }));
+  m_skins = std::move(skins);
 }
 
 size_t EntityModelSurface::frameCount() const
@@ -446,17 +458,20 @@ size_t EntityModelSurface::frameCount() const
 
 size_t EntityModelSurface::skinCount() const
 {
-  return m_skins->textureCount();
+  return m_skins.size();
 }
 
 const Texture* EntityModelSurface::skin(const std::string& name) const
 {
-  return m_skins->textureByName(name);
+  const auto it = std::find_if(m_skins.begin(), m_skins.end(), [&](const auto& skin) {
+    return skin->textureByIndex(0)->name() == name;
+  });
+  return it != m_skins.end() ? (*it)->textureByIndex(0) : nullptr;
 }
 
 const Texture* EntityModelSurface::skin(const size_t index) const
 {
-  return m_skins->textureByIndex(index);
+  return index < m_skins.size() ? m_skins[index]->textureByIndex(0) : nullptr;
 }
 
 std::unique_ptr<Renderer::TexturedIndexRangeRenderer> EntityModelSurface::buildRenderer(
@@ -476,6 +491,26 @@ std::unique_ptr<Renderer::TexturedIndexRangeRenderer> EntityModelSurface::buildR
   }
 }
 
+size_t EntityModelSurface::memoryUsage() const
+{
+  auto result = sizeof(EntityModelSurface) + m_name.capacity()
+                + m_meshes.capacity() * sizeof(std::unique_ptr<EntityModelMesh>);
+  for (const auto& mesh : m_meshes)
+  {
+    if (mesh)
+    {
+      result += mesh->memoryUsage();
+    }
+  }
+  for (const auto& skin : m_skins)
+  {
+    const auto* texture = skin->textureByIndex(0);
+    result += (texture->cpuMemoryUsage() + texture->videoMemoryUsage())
+              / size_t(skin.use_count());
+  }
+  return result;
+}
+
 // EntityModel
 
 EntityModel::EntityModel(
@@ -661,5 +696,19 @@ const EntityModelSurface* EntityModel::surface(const std::string& name) const
   }
   return nullptr;
 }
+
+size_t EntityModel::memoryUsage() const
+{
+  auto result = sizeof(EntityModel) + m_name.capacity();
+  for (const auto& frame : m_frames)
+  {
+    result += frame->memoryUsage();
+  }
+  for (const auto& surface : m_surfaces)
+  {
+    result += surface->memoryUsage();
+  }
+  return result;
+}
 } // namespace Assets
 } // namespace TrenchBroom
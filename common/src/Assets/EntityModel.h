@@ -30,9 +30,6 @@
 
 namespace TrenchBroom
 {
-template <typename T, typename U>
-class octree;
-
 namespace Renderer
 {
 enum class PrimType;
@@ -44,6 +41,7 @@ namespace Assets
 {
 class Texture;
 class TextureCollection;
+class TriangleBvh;
 
 enum class PitchType
 {
@@ -149,6 +147,12 @@ public:
    * intersect this frame
    */
   virtual float intersect(const vm::ray3f& ray) const = 0;
+
+  /**
+   * Returns an estimate of the memory used by this frame in bytes, including the data
+   * used for hit testing.
+   */
+  virtual size_t memoryUsage() const = 0;
 };
 
 /**
@@ -162,11 +166,9 @@ private:
   PitchType m_pitchType;
   Orientation m_orientation;
 
-  // For hit testing
+  // For hit testing, the hierarchy is built when the frame is first hit tested
   std::vector<vm::vec3f> m_tris;
-  using TriNum = size_t;
-  using SpacialTree = octree<float, TriNum>;
-  std::unique_ptr<SpacialTree> m_spacialTree;
+  mutable std::unique_ptr<TriangleBvh> m_spacialTree;
 
 public:
   /**
@@ -193,9 +195,10 @@ public:
   PitchType pitchType() const override;
   Orientation orientation() const override;
   float intersect(const vm::ray3f& ray) const override;
+  size_t memoryUsage() const override;
 
   /**
-   * Adds the given primitives to the spacial tree for this frame.
+   * Adds the given primitives to the triangles used for hit testing this frame.
    *
    * @param vertices the vertices
    * @param primType the primitive type
@@ -227,7 +230,9 @@ class EntityModelSurface
 private:
   std::string m_name;
   std::vector<std::unique_ptr<EntityModelMesh>> m_meshes;
-  std::unique_ptr<TextureCollection> m_skins;
+  // every skin is stored in a collection of its own so that it can be shared with the
+  // surfaces of other models, see SkinCache
+  std::vector<std::shared_ptr<TextureCollection>> m_skins;
 
 public:
   /**
@@ -295,6 +300,14 @@ public:
    */
   void setSkins(std::vector<Texture> skins);
 
+  /**
+   * Sets the given shared skins to this surface. Each of the given collections must
+   * contain exactly one texture.
+   *
+   * @param skins the skins to set
+   */
+  void setSkins(std::vector<std::shared_ptr<TextureCollection>> skins);
+
   /**
    * Returns the number of frame meshes in this surface, should match the model's frame
    * count.
@@ -328,6 +341,13 @@ public:
 
   std::unique_ptr<Renderer::TexturedIndexRangeRenderer> buildRenderer(
     size_t skinIndex, size_t frameIndex);
+
+  /**
+   * Returns an estimate of the memory used by this surface in bytes, including the pixel
+   * data and the video memory of its skins. Skins that are shared with other surfaces
+   * are divided evenly among them.
+   */
+  size_t memoryUsage() const;
 };
 
 /**
@@ -491,6 +511,12 @@ public:
    * @return the surface with the given name or null if no such surface was found
    */
   const EntityModelSurface* surface(const std::string& name) const;
+
+  /**
+   * Returns an estimate of the memory used by this model in bytes, see
+   * EntityModelSurface::memoryUsage().
+   */
+  size_t memoryUsage() const;
 };
 } // namespace Assets
 } // namespace TrenchBroom
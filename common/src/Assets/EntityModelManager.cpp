@@ -28,6 +28,13 @@
 #include "Model/EntityNode.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 
+#include "kdl/thread_pool.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+
 namespace TrenchBroom
 {
 namespace Assets
@@ -49,14 +56,21 @@ EntityModelManager::~EntityModelManager()
 
 void EntityModelManager::clear()
 {
+  // the pending loads refer to the loader, which might be destroyed after clearing
+  waitForPendingModels();
+  m_pendingModels.clear();
+
   m_renderers.clear();
   m_models.clear();
+  m_skinCache.clear();
   m_rendererMismatches.clear();
   m_modelMismatches.clear();
 
   m_unpreparedModels.clear();
   m_unpreparedRenderers.clear();
 
+  m_lastUse.clear();
+
   // Remove logging because it might fail when the document is already destroyed.
 }
 
@@ -73,10 +87,16 @@ void EntityModelManager::setLoader(const IO::EntityModelLoader* loader)
   m_loader = loader;
 }
 
+void EntityModelManager::setModelCacheDirectory(
+  std::optional<std::filesystem::path> cacheDirectory)
+{
+  m_modelCacheDirectory = std::move(cacheDirectory);
+}
+
 Renderer::TexturedRenderer* EntityModelManager::renderer(
   const Assets::ModelSpecification& spec) const
 {
-  auto* entityModel = safeGetModel(spec.path);
+  auto* entityModel = model(spec);
 
   if (entityModel == nullptr)
   {
@@ -118,7 +138,7 @@ Renderer::TexturedRenderer* EntityModelManager::renderer(
 const EntityModelFrame* EntityModelManager::frame(
   const Assets::ModelSpecification& spec) const
 {
-  auto* model = this->safeGetModel(spec.path);
+  auto* model = this->model(spec);
   if (model == nullptr)
   {
     return nullptr;
@@ -137,62 +157,188 @@ const EntityModelFrame* EntityModelManager::frame(
   }
 }
 
-EntityModel* EntityModelManager::model(const std::filesystem::path& path) const
+bool EntityModelManager::hasPendingModels() const
+{
+  return !m_pendingModels.empty();
+}
+
+std::vector<std::filesystem::path> EntityModelManager::processLoadedModels()
 {
-  if (path.empty())
+  using namespace std::chrono_literals;
+
+  auto result = std::vector<std::filesystem::path>{};
+
+  auto it = std::begin(m_pendingModels);
+  while (it != std::end(m_pendingModels))
   {
-    return nullptr;
+    if (it->second.wait_for(0s) != std::future_status::ready)
+    {
+      ++it;
+      continue;
+    }
+
+    const auto& path = it->first;
+    auto loadedModel = it->second.get();
+
+    for (const auto& [level, message] : loadedModel.messages)
+    {
+      m_logger.log(level, message);
+    }
+
+    if (loadedModel.error)
+    {
+      m_logger.error() << *loadedModel.error;
+      m_modelMismatches.insert(path);
+    }
+    else if (loadedModel.model == nullptr)
+    {
+      m_modelMismatches.insert(path);
+    }
+    else
+    {
+      auto* model = loadedModel.model.get();
+      m_models.emplace(path, std::move(loadedModel.model));
+      m_unpreparedModels.push_back(model);
+
+      m_logger.debug() << "Loaded entity model " << path;
+    }
+
+    result.push_back(path);
+    it = m_pendingModels.erase(it);
   }
 
-  auto it = m_models.find(path);
-  if (it != std::end(m_models))
+  return result;
+}
+
+void EntityModelManager::waitForPendingModels() const
+{
+  for (const auto& [path, pendingModel] : m_pendingModels)
   {
-    return it->second.get();
+    pendingModel.wait();
   }
+}
 
-  if (m_modelMismatches.count(path) > 0)
+size_t EntityModelManager::memoryUsage() const
+{
+  auto result = size_t(0);
+  for (const auto& [path, model] : m_models)
   {
-    return nullptr;
+    if (model)
+    {
+      result += model->memoryUsage();
+    }
   }
+  return result;
+}
 
-  try
+std::vector<std::filesystem::path> EntityModelManager::evictModels(
+  const size_t memoryLimit, const kdl::vector_set<std::filesystem::path>& retainedPaths)
+{
+  auto result = std::vector<std::filesystem::path>{};
+
+  auto usage = memoryUsage();
+  if (usage > memoryLimit)
   {
-    const auto [pos, success] = m_models.emplace(path, loadModel(path));
-    assert(success);
-    unused(success);
+    auto candidates = std::vector<std::tuple<size_t, std::filesystem::path>>{};
+    for (const auto& [path, model] : m_models)
+    {
+      const auto lastUse = m_lastUse[path];
+      if (lastUse <= m_lastEviction && retainedPaths.count(path) == 0)
+      {
+        candidates.emplace_back(lastUse, path);
+      }
+    }
+    std::sort(std::begin(candidates), std::end(candidates));
 
-    auto* model = pos->second.get();
-    m_unpreparedModels.push_back(model);
+    for (const auto& [lastUse, path] : candidates)
+    {
+      if (usage <= memoryLimit)
+      {
+        break;
+      }
 
-    m_logger.debug() << "Loaded entity model " << path;
+      const auto it = m_models.find(path);
+      usage -= it->second->memoryUsage();
+      evictModel(it);
+      result.push_back(path);
 
-    return model;
-  }
-  catch (const GameException& e)
-  {
-    m_logger.error() << e.what();
-    m_modelMismatches.insert(path);
-    throw;
+      m_logger.debug() << "Evicted entity model " << path;
+    }
   }
+
+  m_lastEviction = m_useCount;
+  return result;
 }
 
-EntityModel* EntityModelManager::safeGetModel(const std::filesystem::path& path) const
+EntityModel* EntityModelManager::model(const ModelSpecification& spec) const
 {
-  try
+  if (spec.path.empty())
+  {
+    return nullptr;
+  }
+
+  auto it = m_models.find(spec.path);
+  if (it != std::end(m_models))
   {
-    return model(path);
+    m_lastUse[spec.path] = ++m_useCount;
+    return it->second.get();
   }
-  catch (const GameException&)
+
+  if (m_modelMismatches.count(spec.path) == 0 && m_pendingModels.count(spec.path) == 0)
   {
-    return nullptr;
+    m_lastUse[spec.path] = ++m_useCount;
+    loadModel(spec);
   }
+
+  return nullptr;
 }
 
-std::unique_ptr<EntityModel> EntityModelManager::loadModel(
-  const std::filesystem::path& path) const
+void EntityModelManager::loadModel(const ModelSpecification& spec) const
 {
   ensure(m_loader != nullptr, "loader is null");
-  return m_loader->initializeModel(path, m_logger);
+
+  auto promise = std::make_shared<std::promise<LoadedModel>>();
+  m_pendingModels.emplace(spec.path, promise->get_future());
+
+  // the frame that was requested first is loaded along with the model because it is
+  // almost always needed right away; the remaining frames are loaded on demand
+  kdl::default_thread_pool().submit(
+    [loader = m_loader,
+     cacheDirectory = m_modelCacheDirectory,
+     skinCache = &m_skinCache,
+     spec,
+     promise]() {
+      auto logger = CollectingLogger{};
+      auto result = LoadedModel{};
+
+      try
+      {
+        result.model =
+          loader->initializeModel(spec.path, cacheDirectory, skinCache, logger);
+        if (
+          result.model != nullptr && spec.frameIndex < result.model->frameCount()
+          && !result.model->frame(spec.frameIndex)->loaded())
+        {
+          try
+          {
+            loader->loadFrame(spec.path, spec.frameIndex, *result.model, logger);
+          }
+          catch (const GameException& e)
+          {
+            logger.error() << "Could not load entity model frame " << spec << ": "
+                           << e.what();
+          }
+        }
+      }
+      catch (const GameException& e)
+      {
+        result.model.reset();
+        result.error = e.what();
+      }
+
+      result.messages = logger.takeMessages();
+      promise->set_value(std::move(result));
+    });
 }
 
 void EntityModelManager::loadFrame(
@@ -203,13 +349,37 @@ void EntityModelManager::loadFrame(
     ensure(m_loader != nullptr, "loader is null");
     m_loader->loadFrame(spec.path, spec.frameIndex, model, m_logger);
   }
-  catch (const Exception& e)
+  catch (const GameException& e)
   {
-    // FIXME: be specific about which exceptions to catch here
     m_logger.error() << "Could not load entity model frame " << spec << ": " << e.what();
   }
 }
 
+void EntityModelManager::evictModel(const ModelCache::iterator it)
+{
+  const auto& path = it->first;
+  auto* model = it->second.get();
+
+  auto rendererIt = std::begin(m_renderers);
+  while (rendererIt != std::end(m_renderers))
+  {
+    if (rendererIt->first.path == path)
+    {
+      m_unpreparedRenderers =
+        kdl::vec_erase(std::move(m_unpreparedRenderers), rendererIt->second.get());
+      rendererIt = m_renderers.erase(rendererIt);
+    }
+    else
+    {
+      ++rendererIt;
+    }
+  }
+
+  m_unpreparedModels = kdl::vec_erase(std::move(m_unpreparedModels), model);
+  m_lastUse.erase(path);
+  m_models.erase(it);
+}
+
 void EntityModelManager::prepare(Renderer::VboManager& vboManager)
 {
   resetTextureMode();
@@ -19,11 +19,17 @@
 
 #pragma once
 
+#include "Assets/SkinCache.h"
+#include "CollectingLogger.h"
+
 #include "kdl/vector_set.h"
 
 #include <filesystem>
+#include <future>
 #include <map>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace TrenchBroom
@@ -53,13 +59,40 @@ class EntityModelFrame;
 struct ModelSpecification;
 enum class Orientation;
 
+/**
+ * Loads entity models and creates their renderers on demand.
+ *
+ * Models are loaded asynchronously by the worker threads of the default thread pool.
+ * While a model is being loaded, renderer() and frame() return null, so that the entity
+ * is rendered using its bounds as a placeholder. Models that have finished loading are
+ * taken over by calling processLoadedModels() on the main thread, and their textures and
+ * renderers are prepared by calling prepare() on the thread that owns the OpenGL
+ * context.
+ *
+ * Skins that are loaded from files are shared between all models that use them, and
+ * they are only released when the manager is cleared.
+ *
+ * The manager records when each model was last requested. Models that have not been
+ * requested recently can be evicted together with their renderers by calling
+ * evictModels() to keep the memory usage within a budget. An evicted model is loaded
+ * again transparently when it is requested the next time.
+ */
 class EntityModelManager
 {
 private:
+  struct LoadedModel
+  {
+    std::unique_ptr<EntityModel> model;
+    std::vector<CollectingLogger::Message> messages;
+    std::optional<std::string> error;
+  };
+
   using ModelCache = std::map<std::filesystem::path, std::unique_ptr<EntityModel>>;
   using ModelMismatches = kdl::vector_set<std::filesystem::path>;
   using ModelList = std::vector<EntityModel*>;
 
+  using PendingModels = std::map<std::filesystem::path, std::future<LoadedModel>>;
+
   using RendererCache =
     std::map<ModelSpecification, std::unique_ptr<Renderer::TexturedRenderer>>;
   using RendererMismatches = kdl::vector_set<ModelSpecification>;
@@ -71,15 +104,22 @@ private:
   int m_minFilter;
   int m_magFilter;
   bool m_resetTextureMode;
+  std::optional<std::filesystem::path> m_modelCacheDirectory;
 
   mutable ModelCache m_models;
   mutable ModelMismatches m_modelMismatches;
+  mutable PendingModels m_pendingModels;
+  mutable SkinCache m_skinCache;
   mutable RendererCache m_renderers;
   mutable RendererMismatches m_rendererMismatches;
 
   mutable ModelList m_unpreparedModels;
   mutable RendererList m_unpreparedRenderers;
 
+  mutable std::map<std::filesystem::path, size_t> m_lastUse;
+  mutable size_t m_useCount = 0;
+  size_t m_lastEviction = 0;
+
 public:
   EntityModelManager(int magFilter, int minFilter, Logger& logger);
   ~EntityModelManager();
@@ -88,15 +128,66 @@ public:
 
   void setTextureMode(int minFilter, int magFilter);
   void setLoader(const IO::EntityModelLoader* loader);
+
+  /**
+   * Sets the directory in which converted models are cached, or disables the cache if no
+   * directory is given. Only affects models which are loaded afterwards.
+   */
+  void setModelCacheDirectory(std::optional<std::filesystem::path> cacheDirectory);
+
   Renderer::TexturedRenderer* renderer(const ModelSpecification& spec) const;
 
   const EntityModelFrame* frame(const ModelSpecification& spec) const;
 
+  /**
+   * Indicates whether any models are still being loaded.
+   */
+  bool hasPendingModels() const;
+
+  /**
+   * Takes over the models that have finished loading and logs the messages that were
+   * emitted while loading them. Models that could not be loaded are remembered as
+   * mismatches.
+   *
+   * @return the paths of the models that have finished loading, including the paths of
+   * the models that could not be loaded
+   */
+  std::vector<std::filesystem::path> processLoadedModels();
+
+  /**
+   * Blocks until every model that is currently being loaded has finished loading. The
+   * loaded models are not taken over until processLoadedModels() is called.
+   *
+   * Must be called before the file system used by the loader is changed.
+   */
+  void waitForPendingModels() const;
+
+  /**
+   * Returns an estimate of the memory used by the loaded models in bytes, see
+   * EntityModel::memoryUsage().
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Evicts the least recently used models and their renderers until the memory usage
+   * does not exceed the given limit anymore.
+   *
+   * The caller must ensure that no pointers to the frames and renderers of the evicted
+   * models are retained. The models with the given paths are never evicted, and neither
+   * are models that were requested since the previous call to this function, because
+   * the pointers handed out for them may still be in use. Therefore, the memory usage
+   * can remain above the limit.
+   *
+   * @return the paths of the evicted models
+   */
+  std::vector<std::filesystem::path> evictModels(
+    size_t memoryLimit, const kdl::vector_set<std::filesystem::path>& retainedPaths);
+
 private:
-  EntityModel* model(const std::filesystem::path& path) const;
-  EntityModel* safeGetModel(const std::filesystem::path& path) const;
-  std::unique_ptr<EntityModel> loadModel(const std::filesystem::path& path) const;
+  EntityModel* model(const ModelSpecification& spec) const;
+  void loadModel(const ModelSpecification& spec) const;
   void loadFrame(const ModelSpecification& spec, EntityModel& model) const;
+  void evictModel(ModelCache::iterator it);
 
 public:
   void prepare(Renderer::VboManager& vboManager);
@@ -19,6 +19,7 @@
 
 #include "ModelDefinition.h"
 
+#include "EL/CachedExpression.h"
 #include "EL/ELExceptions.h"
 #include "EL/EvaluationContext.h"
 #include "EL/Expressions.h"
@@ -60,16 +61,19 @@ kdl_reflect_impl(ModelSpecification);
 
 ModelDefinition::ModelDefinition()
   : m_expression{EL::LiteralExpression{EL::Value::Undefined}, 0, 0}
+  , m_cachedExpression{std::make_shared<EL::CachedExpression>(m_expression)}
 {
 }
 
 ModelDefinition::ModelDefinition(const size_t line, const size_t column)
   : m_expression{EL::LiteralExpression{EL::Value::Undefined}, line, column}
+  , m_cachedExpression{std::make_shared<EL::CachedExpression>(m_expression)}
 {
 }
 
 ModelDefinition::ModelDefinition(EL::Expression expression)
   : m_expression{std::move(expression)}
+  , m_cachedExpression{std::make_shared<EL::CachedExpression>(m_expression)}
 {
 }
 
@@ -80,6 +84,12 @@ void ModelDefinition::append(ModelDefinition other)
 
   auto cases = std::vector{std::move(m_expression), std::move(other.m_expression)};
   m_expression = EL::Expression{EL::SwitchExpression{std::move(cases)}, line, column};
+  m_cachedExpression = std::make_shared<EL::CachedExpression>(m_expression);
+}
+
+const EL::Expression& ModelDefinition::expression() const
+{
+  return m_expression;
 }
 
 static std::filesystem::path path(const EL::Value& value)
@@ -128,8 +138,7 @@ static ModelSpecification convertToModel(const EL::Value& value)
 ModelSpecification ModelDefinition::modelSpecification(
   const EL::VariableStore& variableStore) const
 {
-  const auto context = EL::EvaluationContext{variableStore};
-  return convertToModel(m_expression.evaluate(context));
+  return convertToModel(m_cachedExpression->evaluate(variableStore));
 }
 
 ModelSpecification ModelDefinition::defaultModelSpecification() const
@@ -192,8 +201,7 @@ vm::vec3 ModelDefinition::scale(
   const EL::VariableStore& variableStore,
   const std::optional<EL::Expression>& defaultScaleExpression) const
 {
-  const auto context = EL::EvaluationContext{variableStore};
-  const auto value = m_expression.evaluate(context);
+  const auto value = m_cachedExpression->evaluate(variableStore);
 
   switch (value.type())
   {
@@ -214,6 +222,7 @@ vm::vec3 ModelDefinition::scale(
 
   if (defaultScaleExpression)
   {
+    const auto context = EL::EvaluationContext{variableStore};
     if (const auto scale = convertToScale(defaultScaleExpression->evaluate(context)))
     {
       return *scale;
@@ -28,6 +28,7 @@
 
 #include <filesystem>
 #include <iosfwd>
+#include <memory>
 #include <optional>
 
 namespace TrenchBroom
@@ -61,6 +62,9 @@ class ModelDefinition
 private:
   EL::Expression m_expression;
 
+  // caches the results of evaluating m_expression, shared by all copies
+  std::shared_ptr<const EL::CachedExpression> m_cachedExpression;
+
 public:
   ModelDefinition();
   ModelDefinition(size_t line, size_t column);
@@ -69,6 +73,8 @@ public:
 
   void append(ModelDefinition other);
 
+  const EL::Expression& expression() const;
+
   /**
    * Evaluates the model expresion, using the given variable store to interpolate
    * variables.
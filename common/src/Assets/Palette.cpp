@@ -32,6 +32,9 @@
 #include "kdl/result.h"
 #include "kdl/string_format.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <ostream>
 #include <string>
@@ -71,47 +74,57 @@ bool Palette::indexedToRgba(
 {
   ensure(rgbaImage.size() == 4 * pixelCount, "incorrect destination buffer size");
 
-  const unsigned char* paletteData = (transparency == PaletteTransparency::Opaque)
-                                       ? m_data->opaqueData.data()
-                                       : m_data->index255TransparentData.data();
+  const auto& paletteData = (transparency == PaletteTransparency::Opaque)
+                              ? m_data->opaqueData
+                              : m_data->index255TransparentData;
 
-  // Write rgba pixels
+  // Copy the palette into a table with one entry per possible index so that the lookup
+  // below never reads past the end of a short palette. Missing entries are transparent
+  // black.
+  auto table = std::array<uint32_t, 256>{};
+  std::memcpy(
+    table.data(), paletteData.data(), std::min(paletteData.size(), sizeof(table)));
+
+  // Read all indices at once into the last quarter of the destination buffer. Converting
+  // them front to back in place is safe because pixel i is written to bytes [4i, 4i+4),
+  // which never overlap the indices of pixels i+1 and later.
   auto* const rgbaData = rgbaImage.data();
+  auto* const indices = rgbaData + 3 * pixelCount;
+  reader.read(indices, pixelCount);
+
+  // Write rgba pixels and count how often each index occurs, so that the average color
+  // and the transparency can be computed per palette entry instead of per pixel
+  auto histogram = std::array<uint32_t, 256>{};
   for (size_t i = 0; i < pixelCount; ++i)
   {
-    const int index = reader.readInt<unsigned char>();
-
-    std::memcpy(rgbaData + (i * 4), &paletteData[index * 4], 4);
+    const auto index = indices[i];
+    std::memcpy(rgbaData + (i * 4), &table[index], 4);
+    ++histogram[index];
   }
 
-  // Check average color
-  uint32_t colorSum[3] = {0, 0, 0};
-  for (size_t i = 0; i < pixelCount; ++i)
+  uint64_t colorSum[3] = {0, 0, 0};
+  unsigned char andAlpha = 0xFF;
+  for (size_t i = 0; i < histogram.size(); ++i)
   {
-    colorSum[0] += uint32_t(rgbaData[(i * 4) + 0]);
-    colorSum[1] += uint32_t(rgbaData[(i * 4) + 1]);
-    colorSum[2] += uint32_t(rgbaData[(i * 4) + 2]);
+    if (histogram[i] > 0)
+    {
+      const auto* color = reinterpret_cast<const unsigned char*>(&table[i]);
+      colorSum[0] += uint64_t(histogram[i]) * color[0];
+      colorSum[1] += uint64_t(histogram[i]) * color[1];
+      colorSum[2] += uint64_t(histogram[i]) * color[2];
+      andAlpha = static_cast<unsigned char>(andAlpha & color[3]);
+    }
   }
+
   averageColor = Color{
     float(colorSum[0]) / (255.0f * float(pixelCount)),
     float(colorSum[1]) / (255.0f * float(pixelCount)),
     float(colorSum[2]) / (255.0f * float(pixelCount)),
     1.0f};
 
-  // Check for transparency
-  auto hasTransparency = false;
-  if (transparency == PaletteTransparency::Index255Transparent)
-  {
-    // Take the bitwise AND of the alpha channel of all pixels
-    unsigned char andAlpha = 0xFF;
-    for (size_t i = 0; i < pixelCount; ++i)
-    {
-      andAlpha = static_cast<unsigned char>(andAlpha & rgbaData[4 * i + 3]);
-    }
-    hasTransparency = (andAlpha != 0xFF);
-  }
-
-  return hasTransparency;
+  // Only index 255 is transparent, so check the bitwise AND of the alpha channel of all
+  // pixels
+  return transparency == PaletteTransparency::Index255Transparent && andAlpha != 0xFF;
 }
 
 bool operator==(const Palette& lhs, const Palette& rhs)
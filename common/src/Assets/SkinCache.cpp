@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "SkinCache.h"
+
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+
+#include <vector>
+
+namespace TrenchBroom::Assets
+{
+
+std::shared_ptr<TextureCollection> makeSharedSkin(Texture texture)
+{
+  auto textures = std::vector<Texture>{};
+  textures.push_back(std::move(texture));
+  return std::make_shared<TextureCollection>(std::move(textures));
+}
+
+SkinCache::SkinCache() = default;
+
+SkinCache::~SkinCache() = default;
+
+std::shared_ptr<TextureCollection> SkinCache::skin(
+  const std::filesystem::path& path, const LoadSkin& loadSkin)
+{
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (const auto it = m_skins.find(path); it != m_skins.end())
+    {
+      return it->second;
+    }
+  }
+
+  // decoding a skin is slow, so it must not block other threads
+  auto skin = makeSharedSkin(loadSkin());
+
+  const auto lock = std::lock_guard{m_mutex};
+  return m_skins.emplace(path, std::move(skin)).first->second;
+}
+
+size_t SkinCache::skinCount() const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return m_skins.size();
+}
+
+size_t SkinCache::purge()
+{
+  const auto lock = std::lock_guard{m_mutex};
+
+  auto count = size_t(0);
+  for (auto it = m_skins.begin(); it != m_skins.end();)
+  {
+    if (it->second.use_count() == 1)
+    {
+      it = m_skins.erase(it);
+      ++count;
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  return count;
+}
+
+void SkinCache::clear()
+{
+  const auto lock = std::lock_guard{m_mutex};
+  m_skins.clear();
+}
+
+} // namespace TrenchBroom::Assets
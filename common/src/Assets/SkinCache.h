@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace TrenchBroom::Assets
+{
+class Texture;
+class TextureCollection;
+
+/**
+ * Wraps the given texture in a collection of its own so that it can be shared between
+ * the surfaces of several entity models.
+ */
+std::shared_ptr<TextureCollection> makeSharedSkin(Texture texture);
+
+/**
+ * Shares the skins of entity models which are loaded from the same file, so that each
+ * skin is decoded and uploaded only once. Every skin is stored in a texture collection
+ * of its own, and the surfaces of the models that use it keep a reference to it.
+ *
+ * Skins are looked up by the path they were requested with, so a path must always be
+ * loaded as the same kind of skin.
+ *
+ * The cache can be used concurrently by several threads. It keeps a reference to every
+ * skin it contains, so that a skin is only released once the cache is cleared or
+ * purged. This ensures that the OpenGL textures of a skin are deleted on the thread that
+ * clears the cache and never on a thread that is loading a model.
+ */
+class SkinCache
+{
+public:
+  using LoadSkin = std::function<Texture()>;
+
+private:
+  mutable std::mutex m_mutex;
+  std::map<std::filesystem::path, std::shared_ptr<TextureCollection>> m_skins;
+
+public:
+  SkinCache();
+  ~SkinCache();
+
+  /**
+   * Returns the skin that was loaded from the given path. If the cache does not contain
+   * such a skin, it is loaded by calling the given function and added to the cache.
+   *
+   * The cache is not locked while the skin is loaded. If two threads load the same skin
+   * at the same time, the skin that is added first is returned to both of them.
+   */
+  std::shared_ptr<TextureCollection> skin(
+    const std::filesystem::path& path, const LoadSkin& loadSkin);
+
+  /**
+   * Returns the number of skins in this cache.
+   */
+  size_t skinCount() const;
+
+  /**
+   * Releases the skins that are not used by any model anymore.
+   *
+   * @return the number of released skins
+   */
+  size_t purge();
+
+  /**
+   * Releases all skins in this cache. Models that are still using a skin keep it alive.
+   */
+  void clear();
+};
+
+} // namespace TrenchBroom::Assets
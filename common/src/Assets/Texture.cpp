@@ -21,6 +21,7 @@
 
 #include "Assets/TextureBuffer.h"
 #include "Assets/TextureCollection.h"
+#include "Assets/TextureThumbnail.h"
 #include "Macros.h"
 #include "Renderer/GL.h"
 
@@ -32,6 +33,7 @@
 #include <algorithm> // for std::max
 #include <cassert>
 #include <ostream>
+#include <utility>
 
 namespace TrenchBroom::Assets
 {
@@ -219,7 +221,12 @@ Texture::Texture(Texture&& other)
   , m_culling{std::move(other.m_culling)}
   , m_blendFunc{std::move(other.m_blendFunc)}
   , m_textureId{std::move(other.m_textureId)}
+  , m_videoMemoryUsage{other.m_videoMemoryUsage}
   , m_buffers{std::move(other.m_buffers)}
+  , m_load{std::move(other.m_load)}
+  , m_requested{other.m_requested}
+  , m_thumbnailRequested{other.m_thumbnailRequested}
+  , m_thumbnailId{other.m_thumbnailId}
   , m_gameData{std::move(other.m_gameData)}
 {
 }
@@ -240,7 +247,12 @@ Texture& Texture::operator=(Texture&& other)
   m_culling = std::move(other.m_culling);
   m_blendFunc = std::move(other.m_blendFunc);
   m_textureId = std::move(other.m_textureId);
+  m_videoMemoryUsage = other.m_videoMemoryUsage;
   m_buffers = std::move(other.m_buffers);
+  m_load = std::move(other.m_load);
+  m_requested = other.m_requested;
+  m_thumbnailRequested = other.m_thumbnailRequested;
+  m_thumbnailId = other.m_thumbnailId;
   m_gameData = std::move(other.m_gameData);
   return *this;
 }
@@ -354,6 +366,12 @@ void Texture::decUsageCount()
   unused(previous);
 }
 
+void Texture::adjustUsageCount(const std::ptrdiff_t delta)
+{
+  // unsigned arithmetic wraps around, so this also works for negative deltas
+  m_usageCount += static_cast<size_t>(delta);
+}
+
 bool Texture::overridden() const
 {
   return m_overridden;
@@ -364,20 +382,149 @@ void Texture::setOverridden(const bool overridden)
   m_overridden = overridden;
 }
 
+void Texture::replace(Texture other)
+{
+  const auto usageCount = this->usageCount();
+  const auto overridden = m_overridden;
+  const auto requested = m_requested;
+
+  *this = std::move(other);
+
+  m_usageCount = usageCount;
+  m_overridden = overridden;
+  m_requested = requested;
+}
+
+void Texture::setLoader(LoadFunc load)
+{
+  m_load = std::move(load);
+}
+
+bool Texture::loaded() const
+{
+  return !m_load;
+}
+
+Texture::LoadFunc Texture::loader() const
+{
+  return m_load;
+}
+
+void Texture::load()
+{
+  if (m_load)
+  {
+    auto texture = std::exchange(m_load, LoadFunc{})();
+    m_width = texture.m_width;
+    m_height = texture.m_height;
+    m_averageColor = texture.m_averageColor;
+    m_format = texture.m_format;
+    m_type = texture.m_type;
+    m_buffers = std::move(texture.m_buffers);
+    m_gameData = std::move(texture.m_gameData);
+  }
+}
+
+void Texture::request() const
+{
+  m_requested = true;
+}
+
+bool Texture::requested() const
+{
+  return m_requested || usageCount() > 0;
+}
+
 bool Texture::isPrepared() const
 {
   return m_textureId != 0;
 }
 
-void Texture::prepare(const GLuint textureId, const int minFilter, const int magFilter)
+void Texture::requestThumbnail() const
+{
+  m_thumbnailRequested = true;
+}
+
+bool Texture::thumbnailRequested() const
+{
+  return m_thumbnailRequested;
+}
+
+bool Texture::isThumbnailPrepared() const
+{
+  return m_thumbnailId != 0;
+}
+
+void Texture::prepareThumbnail(
+  const GLuint thumbnailId,
+  const TextureThumbnail& thumbnail,
+  const int minFilter,
+  const int magFilter)
+{
+  assert(thumbnailId > 0);
+  assert(m_thumbnailId == 0);
+
+  // masked textures are always filtered with GL_NEAREST, see prepare()
+  const auto masked = thumbnail.type == TextureType::Masked;
+  const auto thumbnailMinFilter = masked ? GL_NEAREST : minFilter;
+  const auto thumbnailMagFilter = masked ? GL_NEAREST : magFilter;
+
+  glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
+  glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
+  glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+  glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+  glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+  glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+  glAssert(glBindTexture(GL_TEXTURE_2D, thumbnailId));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, thumbnailMinFilter));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, thumbnailMagFilter));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+
+  // a thumbnail has a single mip level, which keeps it complete for mipmap filters
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+
+  glAssert(glTexImage2D(
+    GL_TEXTURE_2D,
+    0,
+    GL_RGBA,
+    static_cast<GLsizei>(thumbnail.width),
+    static_cast<GLsizei>(thumbnail.height),
+    0,
+    thumbnail.format,
+    GL_UNSIGNED_BYTE,
+    reinterpret_cast<const GLvoid*>(thumbnail.buffer.data())));
+  glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+
+  m_thumbnailId = thumbnailId;
+  m_videoMemoryUsage += thumbnail.width * thumbnail.height * 4u;
+}
+
+void Texture::prepare(
+  const GLuint textureId, const int minFilter, const int magFilter, const bool compress)
 {
   assert(textureId > 0);
   assert(m_textureId == 0);
+  assert(loaded());
 
   if (!m_buffers.empty())
   {
     const auto compressed = isCompressedFormat(m_format);
 
+    // S3TC only allows dimensions which are multiples of the block size
+    const auto internalFormat =
+      compress && GLEW_EXT_texture_compression_s3tc && m_width % 4 == 0
+          && m_height % 4 == 0
+        ? GLint(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+        : GLint(GL_RGBA);
+
+    // glGenerateMipmap does not support compressed formats
+    const auto generateMipmaps = m_type != TextureType::Masked && m_buffers.size() == 1
+                                 && !compressed && internalFormat == GLint(GL_RGBA)
+                                 && (GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object);
+
     glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
     glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
     glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
@@ -401,8 +548,10 @@ void Texture::prepare(const GLuint textureId, const int minFilter, const int mag
     }
     else if (m_buffers.size() == 1)
     {
-      // generate mipmaps if we don't have any
-      glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+      // generate mipmaps if we don't have any, preferably with glGenerateMipmap after
+      // the upload; with GL_GENERATE_MIPMAP, some drivers build them on the CPU
+      glAssert(glTexParameteri(
+        GL_TEXTURE_2D, GL_GENERATE_MIPMAP, generateMipmaps ? GL_FALSE : GL_TRUE));
     }
     else
     {
@@ -412,6 +561,7 @@ void Texture::prepare(const GLuint textureId, const int minFilter, const int mag
 
     // Upload only the first mipmap for masked textures.
     const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
+    auto videoMemoryUsage = size_t(0);
 
     for (size_t j = 0; j < mipmapsToUpload; ++j)
     {
@@ -437,7 +587,7 @@ void Texture::prepare(const GLuint textureId, const int minFilter, const int mag
         glAssert(glTexImage2D(
           GL_TEXTURE_2D,
           static_cast<GLint>(j),
-          GL_RGBA,
+          internalFormat,
           static_cast<GLsizei>(mipSize.x()),
           static_cast<GLsizei>(mipSize.y()),
           0,
@@ -445,13 +595,56 @@ void Texture::prepare(const GLuint textureId, const int minFilter, const int mag
           GL_UNSIGNED_BYTE,
           data));
       }
+
+      if (compressed)
+      {
+        videoMemoryUsage += m_buffers[j].size();
+      }
+      else if (internalFormat == GLint(GL_RGBA))
+      {
+        videoMemoryUsage += mipSize.x() * mipSize.y() * 4u;
+      }
+      else
+      {
+        // DXT5 stores a block of 4x4 pixels in 16 bytes
+        videoMemoryUsage += (mipSize.x() + 3u) / 4u * ((mipSize.y() + 3u) / 4u) * 16u;
+      }
     }
 
-    m_buffers.clear();
+    if (m_type != TextureType::Masked && m_buffers.size() == 1)
+    {
+      // the generated mipmaps add another third
+      videoMemoryUsage += videoMemoryUsage / 3u;
+    }
+    m_videoMemoryUsage += videoMemoryUsage;
+
+    if (generateMipmaps)
+    {
+      glAssert(glGenerateMipmap(GL_TEXTURE_2D));
+    }
+
+    // the pixel data is only needed for uploading, so release it including the storage
+    // of the buffer list itself
+    m_buffers = BufferList{};
     m_textureId = textureId;
   }
 }
 
+size_t Texture::cpuMemoryUsage() const
+{
+  auto result = size_t(0);
+  for (const auto& buffer : m_buffers)
+  {
+    result += buffer.size();
+  }
+  return result;
+}
+
+size_t Texture::videoMemoryUsage() const
+{
+  return m_videoMemoryUsage;
+}
+
 void Texture::setMode(const int minFilter, const int magFilter)
 {
   if (isPrepared())
@@ -472,6 +665,12 @@ void Texture::setMode(const int minFilter, const int magFilter)
   }
 }
 
+bool Texture::changesRenderState() const
+{
+  return (m_culling != TextureCulling::Default && m_culling != TextureCulling::Back)
+         || m_blendFunc.enable != TextureBlendFunc::Enable::UseDefault;
+}
+
 void Texture::activate() const
 {
   if (isPrepared())
@@ -539,6 +738,22 @@ void Texture::deactivate() const
   }
 }
 
+void Texture::activateThumbnail() const
+{
+  if (isThumbnailPrepared())
+  {
+    glAssert(glBindTexture(GL_TEXTURE_2D, m_thumbnailId));
+  }
+}
+
+void Texture::deactivateThumbnail() const
+{
+  if (isThumbnailPrepared())
+  {
+    glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+  }
+}
+
 const Texture::BufferList& Texture::buffersIfUnprepared() const
 {
   return m_buffers;
@@ -28,7 +28,9 @@
 #include "vm/forward.h"
 
 #include <atomic>
+#include <cstddef>
 #include <filesystem>
+#include <functional>
 #include <set>
 #include <string>
 #include <variant>
@@ -36,6 +38,7 @@
 
 namespace TrenchBroom::Assets
 {
+struct TextureThumbnail;
 
 enum class TextureType
 {
@@ -101,6 +104,13 @@ std::ostream& operator<<(std::ostream& lhs, const GameData& rhs);
 
 class Texture
 {
+public:
+  /**
+   * Decodes the pixel data of a texture that is loaded on demand. Returns a texture with
+   * the decoded pixel data.
+   */
+  using LoadFunc = std::function<Texture()>;
+
 private:
   using Buffer = TextureBuffer;
   using BufferList = std::vector<Buffer>;
@@ -132,7 +142,19 @@ private:
   TextureBlendFunc m_blendFunc;
 
   mutable GLuint m_textureId;
+  // an estimate of the video memory used by this texture and its thumbnail
+  size_t m_videoMemoryUsage{0};
+
+  // the decoded pixel data, released once it has been uploaded by prepare()
   mutable BufferList m_buffers;
+  // decodes the pixel data if it is loaded on demand, reset once it has been called
+  LoadFunc m_load;
+  mutable bool m_requested{false};
+
+  // the texture browser shows a thumbnail of a texture that is loaded on demand until it
+  // is used, see TextureCollection::prepare
+  mutable bool m_thumbnailRequested{false};
+  GLuint m_thumbnailId{0};
 
   GameData m_gameData;
 
@@ -225,16 +247,103 @@ public:
   size_t usageCount() const;
   void incUsageCount();
   void decUsageCount();
+  void adjustUsageCount(std::ptrdiff_t delta);
   bool overridden() const;
   void setOverridden(bool overridden);
 
+  /**
+   * Replaces the contents of this texture with the contents of the given texture, e.g.
+   * because its file was modified. The usage count of this texture and whether it is
+   * overridden or requested are kept, so that references to this texture stay valid.
+   */
+  void replace(Texture other);
+
+  /**
+   * Defers decoding the pixel data of this texture until load() is called. Until then,
+   * this texture only knows its name and its dimensions.
+   */
+  void setLoader(LoadFunc load);
+
+  /**
+   * Indicates whether the pixel data of this texture has been decoded.
+   */
+  bool loaded() const;
+
+  /**
+   * Returns the function that decodes the pixel data of this texture, or an empty
+   * function if it has been loaded already. The returned function can be called on any
+   * thread.
+   */
+  LoadFunc loader() const;
+
+  /**
+   * Decodes the pixel data of this texture if its loading was deferred. Afterwards, this
+   * texture has the format, type, average color and game data of the decoded texture.
+   */
+  void load();
+
+  /**
+   * Requests that this texture is loaded and uploaded even if it is not used, e.g.
+   * because it is shown in the texture browser.
+   */
+  void request() const;
+
+  /**
+   * Indicates whether this texture is used or was requested.
+   */
+  bool requested() const;
+
   bool isPrepared() const;
-  void prepare(GLuint textureId, int minFilter, int magFilter);
+
+  /**
+   * Requests a thumbnail of this texture, e.g. because the texture browser shows it. Only
+   * textures which are loaded on demand and have not been loaded yet get a thumbnail, all
+   * other textures are uploaded in full anyway.
+   */
+  void requestThumbnail() const;
+  bool thumbnailRequested() const;
+  bool isThumbnailPrepared() const;
+
+  /**
+   * Uploads the given thumbnail of this texture to the given texture object.
+   */
+  void prepareThumbnail(
+    GLuint thumbnailId, const TextureThumbnail& thumbnail, int minFilter, int magFilter);
+
+  /**
+   * Uploads this texture to the given texture object. If compress is true and this
+   * texture is not compressed already, the driver is asked to compress it to DXT5 on
+   * upload, which reduces its video memory footprint to a quarter.
+   */
+  void prepare(GLuint textureId, int minFilter, int magFilter, bool compress);
+
+  /**
+   * Returns the size of the pixel data that is held in main memory until this texture is
+   * uploaded.
+   */
+  size_t cpuMemoryUsage() const;
+
+  /**
+   * Returns an estimate of the video memory used by this texture and its thumbnail,
+   * including generated mipmaps. The driver may allocate more than that.
+   */
+  size_t videoMemoryUsage() const;
+
   void setMode(int minFilter, int magFilter);
 
+  /**
+   * Indicates whether activating this texture changes any OpenGL state other than the
+   * texture binding, i.e. the face culling mode or the blend function. If it doesn't,
+   * the texture need not be deactivated before another texture is activated.
+   */
+  bool changesRenderState() const;
+
   void activate() const;
   void deactivate() const;
 
+  void activateThumbnail() const;
+  void deactivateThumbnail() const;
+
 public: // exposed for tests only
   /**
    * Returns the texture data in the format returned by format().
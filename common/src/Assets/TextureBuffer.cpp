@@ -24,7 +24,7 @@
 #include "vm/vec.h"
 
 #include <FreeImage.h>
-#include <algorithm> // for std::max
+#include <algorithm> // for std::max, std::equal
 
 namespace TrenchBroom
 {
@@ -60,6 +60,17 @@ size_t TextureBuffer::size() const
   return m_size;
 }
 
+bool operator==(const TextureBuffer& lhs, const TextureBuffer& rhs)
+{
+  return lhs.m_size == rhs.m_size
+         && std::equal(lhs.data(), lhs.data() + lhs.m_size, rhs.data());
+}
+
+bool operator!=(const TextureBuffer& lhs, const TextureBuffer& rhs)
+{
+  return !(lhs == rhs);
+}
+
 vm::vec2s sizeAtMipLevel(const size_t width, const size_t height, const size_t level)
 {
   assert(width > 0);
@@ -44,6 +44,9 @@ public:
   unsigned char* data();
 
   size_t size() const;
+
+  friend bool operator==(const TextureBuffer& lhs, const TextureBuffer& rhs);
+  friend bool operator!=(const TextureBuffer& lhs, const TextureBuffer& rhs);
 };
 using TextureBufferList = std::vector<TextureBuffer>;
 
@@ -22,13 +22,18 @@
 #include "Ensure.h"
 
 #include "kdl/reflection_impl.h"
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
+#include <chrono>
+#include <exception>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom::Assets
 {
+using namespace std::chrono_literals;
 
 kdl_reflect_impl(TextureCollection);
 
@@ -36,6 +41,7 @@ TextureCollection::TextureCollection() = default;
 
 TextureCollection::TextureCollection(std::vector<Texture> textures)
   : m_textures{std::move(textures)}
+  , m_preparedTextures(m_textures.size(), false)
 {
 }
 
@@ -49,11 +55,26 @@ TextureCollection::TextureCollection(
   : m_path{std::move(path)}
   , m_textures{std::move(textures)}
   , m_loaded{true}
+  , m_preparedTextures(m_textures.size(), false)
 {
 }
 
 TextureCollection::~TextureCollection()
 {
+  // the loaders of the textures may refer to the game file system
+  for (const auto& [index, pendingThumbnail] : m_pendingThumbnails)
+  {
+    pendingThumbnail.wait();
+  }
+
+  if (!m_thumbnailIds.empty())
+  {
+    glAssert(glDeleteTextures(
+      static_cast<GLsizei>(m_thumbnailIds.size()),
+      static_cast<GLuint*>(&m_thumbnailIds.front())));
+    m_thumbnailIds.clear();
+  }
+
   if (!m_textureIds.empty())
   {
     glAssert(glDeleteTextures(
@@ -116,25 +137,60 @@ Texture* TextureCollection::textureByName(const std::string& name)
 
 bool TextureCollection::prepared() const
 {
-  return !m_textureIds.empty();
+  if (!m_pendingThumbnails.empty())
+  {
+    return false;
+  }
+
+  if (m_preparedCount == textureCount())
+  {
+    return true;
+  }
+
+  for (size_t i = 0; i < textureCount(); ++i)
+  {
+    if (isPending(i) || isThumbnailPending(i))
+    {
+      return false;
+    }
+  }
+  return true;
 }
 
-void TextureCollection::prepare(const int minFilter, const int magFilter)
+size_t TextureCollection::prepare(
+  const int minFilter, const int magFilter, const bool compress, const size_t maxBytes)
 {
-  assert(!prepared());
+  if (prepared())
+  {
+    return 0;
+  }
 
-  m_textureIds.resize(textureCount());
-  if (textureCount() != 0u)
+  if (m_textureIds.empty())
   {
+    m_textureIds.resize(textureCount());
     glAssert(glGenTextures(
       static_cast<GLsizei>(textureCount()), static_cast<GLuint*>(&m_textureIds.front())));
+  }
 
-    for (size_t i = 0; i < textureCount(); ++i)
+  auto uploadedBytes = prepareThumbnails(minFilter, magFilter, maxBytes);
+  for (size_t i = 0; i < textureCount() && uploadedBytes <= maxBytes; ++i)
+  {
+    if (isPending(i))
     {
       auto& texture = m_textures[i];
-      texture.prepare(m_textureIds[i], minFilter, magFilter);
+      texture.load();
+      for (const auto& buffer : texture.buffersIfUnprepared())
+      {
+        uploadedBytes += buffer.size();
+      }
+
+      texture.prepare(m_textureIds[i], minFilter, magFilter, compress);
+      m_preparedTextures[i] = true;
+      ++m_preparedCount;
     }
   }
+
+  return uploadedBytes;
 }
 
 void TextureCollection::setTextureMode(const int minFilter, const int magFilter)
@@ -145,4 +201,94 @@ void TextureCollection::setTextureMode(const int minFilter, const int magFilter)
   }
 }
 
+void TextureCollection::replaceTexture(const size_t index, Texture texture)
+{
+  ensure(index < m_textures.size(), "index is in range");
+
+  if (const auto it = m_pendingThumbnails.find(index); it != m_pendingThumbnails.end())
+  {
+    it->second.wait();
+    m_pendingThumbnails.erase(it);
+  }
+
+  m_textures[index].replace(std::move(texture));
+  if (m_preparedTextures[index])
+  {
+    m_preparedTextures[index] = false;
+    --m_preparedCount;
+  }
+}
+
+bool TextureCollection::isPending(const size_t index) const
+{
+  const auto& texture = m_textures[index];
+  return !m_preparedTextures[index] && (texture.loaded() || texture.requested());
+}
+
+bool TextureCollection::isThumbnailPending(const size_t index) const
+{
+  const auto& texture = m_textures[index];
+  return !m_preparedTextures[index] && !texture.loaded() && !texture.requested()
+         && texture.thumbnailRequested() && !texture.isThumbnailPrepared()
+         && m_pendingThumbnails.count(index) == 0;
+}
+
+size_t TextureCollection::prepareThumbnails(
+  const int minFilter, const int magFilter, const size_t maxBytes)
+{
+  for (size_t i = 0; i < textureCount(); ++i)
+  {
+    if (isThumbnailPending(i))
+    {
+      auto promise = std::make_shared<std::promise<std::optional<TextureThumbnail>>>();
+      m_pendingThumbnails.emplace(i, promise->get_future());
+
+      kdl::default_thread_pool().submit([load = m_textures[i].loader(), promise]() {
+        try
+        {
+          promise->set_value(makeTextureThumbnail(load()));
+        }
+        catch (const std::exception&)
+        {
+          promise->set_value(std::nullopt);
+        }
+      });
+    }
+  }
+
+  auto uploadedBytes = size_t(0);
+  auto it = m_pendingThumbnails.begin();
+  while (it != m_pendingThumbnails.end() && uploadedBytes <= maxBytes)
+  {
+    if (it->second.wait_for(0s) != std::future_status::ready)
+    {
+      ++it;
+      continue;
+    }
+
+    auto& texture = m_textures[it->first];
+    if (auto thumbnail = it->second.get())
+    {
+      if (!texture.isPrepared())
+      {
+        auto thumbnailId = GLuint(0);
+        glAssert(glGenTextures(1, &thumbnailId));
+        m_thumbnailIds.push_back(thumbnailId);
+
+        texture.prepareThumbnail(thumbnailId, *thumbnail, minFilter, magFilter);
+        uploadedBytes += thumbnail->buffer.size();
+      }
+    }
+    else
+    {
+      // show the entire texture instead
+      texture.request();
+    }
+
+    it = m_pendingThumbnails.erase(it);
+  }
+
+  return uploadedBytes;
+}
+
 } // namespace TrenchBroom::Assets
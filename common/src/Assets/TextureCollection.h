@@ -20,11 +20,15 @@
 #pragma once
 
 #include "Assets/Texture.h"
+#include "Assets/TextureThumbnail.h"
 #include "Renderer/GL.h"
 
 #include "kdl/reflection_decl.h"
 
 #include <filesystem>
+#include <future>
+#include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -35,12 +39,19 @@ class TextureCollection
 {
 private:
   using TextureIdList = std::vector<GLuint>;
+  using PendingThumbnails =
+    std::map<size_t, std::future<std::optional<TextureThumbnail>>>;
 
   std::filesystem::path m_path;
   std::vector<Texture> m_textures;
 
   bool m_loaded{false};
   TextureIdList m_textureIds;
+  std::vector<bool> m_preparedTextures;
+  size_t m_preparedCount{0};
+
+  TextureIdList m_thumbnailIds;
+  PendingThumbnails m_pendingThumbnails;
 
   friend class Texture;
 
@@ -73,9 +84,42 @@ public:
   const Texture* textureByName(const std::string& name) const;
   Texture* textureByName(const std::string& name);
 
+  /**
+   * Indicates whether all textures have been uploaded, except for textures which are
+   * loaded on demand and have not been requested yet, and whether the thumbnails of all
+   * such textures which were requested have been uploaded.
+   */
   bool prepared() const;
-  void prepare(int minFilter, int magFilter);
+
+  /**
+   * Uploads the textures that have not been uploaded yet in order, stopping as soon as
+   * more than the given number of bytes have been uploaded. At least one texture is
+   * uploaded unless all textures are prepared already. Textures which are loaded on
+   * demand are decoded and uploaded once they are requested. See Texture::prepare for
+   * the meaning of compress.
+   *
+   * Requesting a thumbnail of a texture which is loaded on demand decodes the texture on
+   * a worker thread of the default thread pool, and only the thumbnail is uploaded and
+   * counted against the given number of bytes once it is ready. The decoded texture is
+   * discarded.
+   *
+   * @return the number of uploaded bytes
+   */
+  size_t prepare(int minFilter, int magFilter, bool compress, size_t maxBytes);
+
+  /**
+   * Replaces the texture at the given index with the given texture, see
+   * Texture::replace. The texture is uploaded again by the next call to prepare, reusing
+   * its texture object.
+   */
+  void replaceTexture(size_t index, Texture texture);
+
   void setTextureMode(int minFilter, int magFilter);
+
+private:
+  bool isPending(size_t index) const;
+  bool isThumbnailPending(size_t index) const;
+  size_t prepareThumbnails(int minFilter, int magFilter, size_t maxBytes);
 };
 
 } // namespace TrenchBroom::Assets
@@ -23,24 +23,42 @@
 #include "Assets/TextureCollection.h"
 #include "Error.h"
 #include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/FileSystem.h"
 #include "IO/LoadTextureCollection.h"
+#include "IO/PathInfo.h"
 #include "Logger.h"
 
 #include "kdl/map_utils.h"
+#include "kdl/parallel.h"
 #include "kdl/result.h"
 #include "kdl/string_format.h"
+#include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
 #include <algorithm>
 #include <chrono>
 #include <iterator>
 #include <string>
+#include <system_error>
 #include <vector>
 
 namespace TrenchBroom
 {
 namespace Assets
 {
+namespace
+{
+
+std::optional<std::filesystem::file_time_type> lastWriteTime(
+  const std::filesystem::path& path)
+{
+  auto error = std::error_code{};
+  const auto writeTime = std::filesystem::last_write_time(path, error);
+  return !error ? std::optional{writeTime} : std::nullopt;
+}
+
+} // namespace
 
 TextureManager::TextureManager(int magFilter, int minFilter, Logger& logger)
   : m_logger{logger}
@@ -64,6 +82,92 @@ void TextureManager::reload(
     });
 }
 
+std::vector<std::filesystem::path> TextureManager::textureDirectories() const
+{
+  auto result = kdl::vector_set<std::filesystem::path>{};
+  for (const auto& [path, textureFiles] : m_textureFiles)
+  {
+    result.insert(textureFiles.directory);
+  }
+  return result.release_data();
+}
+
+std::optional<size_t> TextureManager::reloadModifiedTextures(
+  const std::filesystem::path& directory,
+  const IO::FileSystem& fs,
+  const Model::TextureConfig& textureConfig)
+{
+  auto count = size_t{0};
+  for (auto& collection : m_collections)
+  {
+    const auto it = m_textureFiles.find(collection.path());
+    if (it == m_textureFiles.end() || it->second.directory != directory)
+    {
+      continue;
+    }
+
+    auto& writeTimes = it->second.writeTimes;
+    auto& textures = collection.textures();
+
+    const auto texturePaths = IO::findTextures(collection.path(), fs, textureConfig);
+    if (
+      texturePaths.is_error()
+      || kdl::vector_set<std::filesystem::path>(texturePaths.value())
+           != kdl::vector_set<std::filesystem::path>(kdl::vec_transform(
+             textures, [](const auto& texture) { return texture.relativePath(); })))
+    {
+      return std::nullopt;
+    }
+
+    auto modifiedIndices = std::vector<size_t>{};
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+      if (writeTimes[i] && lastWriteTime(textures[i].absolutePath()) != writeTimes[i])
+      {
+        modifiedIndices.push_back(i);
+      }
+    }
+
+    if (modifiedIndices.empty())
+    {
+      continue;
+    }
+
+    auto modifiedTextures =
+      IO::loadTextures(
+        kdl::vec_transform(
+          modifiedIndices, [&](const auto i) { return textures[i].relativePath(); }),
+        fs,
+        textureConfig)
+        .transform_error([&](const auto& e) {
+          m_logger.error() << "Could not reload textures in '" << collection.path()
+                           << "': " << e.msg;
+          return std::vector<Texture>{};
+        })
+        .value();
+    if (modifiedTextures.size() != modifiedIndices.size())
+    {
+      return std::nullopt;
+    }
+
+    for (size_t j = 0; j < modifiedIndices.size(); ++j)
+    {
+      const auto i = modifiedIndices[j];
+      m_logger.info() << "Reloaded texture '" << textures[i].name() << "'";
+      collection.replaceTexture(i, std::move(modifiedTextures[j]));
+      writeTimes[i] = lastWriteTime(textures[i].absolutePath());
+    }
+    count += modifiedIndices.size();
+  }
+
+  if (count > 0)
+  {
+    // the names of the replaced textures are new strings
+    updateTextures();
+  }
+  return count;
+}
+
 void TextureManager::setTextureCollections(std::vector<TextureCollection> collections)
 {
   for (auto& collection : collections)
@@ -79,8 +183,32 @@ void TextureManager::setTextureCollections(
   const Model::TextureConfig& textureConfig)
 {
   auto collections = std::move(m_collections);
+  auto textureFiles = std::move(m_textureFiles);
   clear();
 
+  // remember where the textures of a collection were loaded from so that they can be
+  // reloaded if their files are modified
+  const auto recordTextureFiles = [&](const auto& collection) {
+    if (const auto it = textureFiles.find(collection.path()); it != textureFiles.end())
+    {
+      m_textureFiles.insert(textureFiles.extract(it));
+      return;
+    }
+
+    fs.makeAbsolute(collection.path())
+      .transform([&](auto directory) {
+        if (IO::Disk::pathInfo(directory) == IO::PathInfo::Directory)
+        {
+          m_textureFiles[collection.path()] = TextureFiles{
+            std::move(directory),
+            kdl::vec_transform(collection.textures(), [](const auto& texture) {
+              return lastWriteTime(texture.absolutePath());
+            })};
+        }
+      })
+      .transform_error([](auto) {});
+  };
+
   for (const auto& path : paths)
   {
     const auto it =
@@ -90,7 +218,13 @@ void TextureManager::setTextureCollections(
 
     if (it == collections.end() || !it->loaded())
     {
-      IO::loadTextureCollection(path, fs, textureConfig, m_logger)
+      IO::loadTextureCollection(
+        path,
+        fs,
+        textureConfig,
+        m_textureCacheDirectory,
+        m_loadTexturesOnDemand,
+        m_logger)
         .transform_error([&](const auto& error) {
           if (it == collections.end())
           {
@@ -104,11 +238,14 @@ void TextureManager::setTextureCollections(
           {
             m_logger.info() << "Loaded texture collection '" << path << "'";
           }
+          textureFiles.erase(path);
+          recordTextureFiles(collection);
           addTextureCollection(std::move(collection));
         });
     }
     else
     {
+      recordTextureFiles(*it);
       addTextureCollection(std::move(*it));
     }
 
@@ -124,24 +261,19 @@ void TextureManager::setTextureCollections(
 
 void TextureManager::addTextureCollection(Assets::TextureCollection collection)
 {
-  const auto index = m_collections.size();
   m_collections.push_back(std::move(collection));
-
-  if (m_collections[index].loaded() && !m_collections[index].prepared())
-  {
-    m_toPrepare.push_back(index);
-  }
-
-  m_logger.debug() << "Added texture collection " << m_collections[index].path();
+  m_logger.debug() << "Added texture collection " << m_collections.back().path();
 }
 
 void TextureManager::clear()
 {
   m_collections.clear();
+  m_textureFiles.clear();
 
-  m_toPrepare.clear();
   m_texturesByName.clear();
   m_textures.clear();
+  m_allTextures.clear();
+  m_textureNameIndex = TrigramIndex{};
 
   // Remove logging because it might fail when the document is already destroyed.
 }
@@ -153,6 +285,22 @@ void TextureManager::setTextureMode(const int minFilter, const int magFilter)
   m_resetTextureMode = true;
 }
 
+void TextureManager::setCompressTextures(const bool compressTextures)
+{
+  m_compressTextures = compressTextures;
+}
+
+void TextureManager::setTextureCacheDirectory(
+  std::optional<std::filesystem::path> cacheDirectory)
+{
+  m_textureCacheDirectory = std::move(cacheDirectory);
+}
+
+void TextureManager::setLoadTexturesOnDemand(const bool loadTexturesOnDemand)
+{
+  m_loadTexturesOnDemand = loadTexturesOnDemand;
+}
+
 void TextureManager::commitChanges()
 {
   resetTextureMode();
@@ -160,22 +308,63 @@ void TextureManager::commitChanges()
   m_toRemove.clear();
 }
 
-const Texture* TextureManager::texture(const std::string& name) const
+bool TextureManager::hasPendingUploads() const
+{
+  return std::any_of(m_collections.begin(), m_collections.end(), [](const auto& c) {
+    return c.loaded() && !c.prepared();
+  });
+}
+
+const Texture* TextureManager::texture(const std::string_view name) const
 {
-  auto it = m_texturesByName.find(kdl::str_to_lower(name));
+  auto it = m_texturesByName.find(name);
   return it != m_texturesByName.end() ? it->second : nullptr;
 }
 
-Texture* TextureManager::texture(const std::string& name)
+Texture* TextureManager::texture(const std::string_view name)
 {
   return const_cast<Texture*>(const_cast<const TextureManager*>(this)->texture(name));
 }
 
+std::vector<Texture*> TextureManager::resolveTextures(
+  const std::vector<std::string_view>& names, const bool parallel) const
+{
+  auto result = std::vector<Texture*>(names.size(), nullptr);
+  const auto resolve = [&](const size_t i) {
+    if (auto it = m_texturesByName.find(names[i]); it != m_texturesByName.end())
+    {
+      result[i] = it->second;
+    }
+  };
+
+  if (parallel)
+  {
+    kdl::parallel_for(names.size(), resolve);
+  }
+  else
+  {
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      resolve(i);
+    }
+  }
+
+  return result;
+}
+
 const std::vector<const Texture*>& TextureManager::textures() const
 {
   return m_textures;
 }
 
+std::vector<const Texture*> TextureManager::findTextures(
+  const std::string_view filterText) const
+{
+  return kdl::vec_transform(m_textureNameIndex.find(filterText), [&](const auto i) {
+    return m_allTextures[i];
+  });
+}
+
 const std::vector<TextureCollection>& TextureManager::collections() const
 {
   return m_collections;
@@ -195,42 +384,89 @@ void TextureManager::resetTextureMode()
 
 void TextureManager::prepare()
 {
-  for (const auto index : m_toPrepare)
+  // textures which are loaded on demand become pending whenever they are first used, so
+  // every collection must be checked
+  auto remainingBytes = MaxUploadBytesPerCommit;
+  for (auto& collection : m_collections)
   {
-    auto& collection = m_collections[index];
-    collection.prepare(m_minFilter, m_magFilter);
+    if (remainingBytes == 0)
+    {
+      break;
+    }
+
+    if (collection.loaded())
+    {
+      const auto uploadedBytes =
+        collection.prepare(m_minFilter, m_magFilter, m_compressTextures, remainingBytes);
+      remainingBytes -= std::min(uploadedBytes, remainingBytes);
+    }
   }
-  m_toPrepare.clear();
 }
 
 void TextureManager::updateTextures()
 {
   m_texturesByName.clear();
   m_textures.clear();
+  m_allTextures.clear();
 
   for (auto& collection : m_collections)
   {
     for (auto& texture : collection.textures())
     {
-      const auto key = kdl::str_to_lower(texture.name());
       texture.setOverridden(false);
+      m_allTextures.push_back(&texture);
 
-      auto mIt = m_texturesByName.find(key);
+      auto mIt = m_texturesByName.find(texture.name());
       if (mIt != m_texturesByName.end())
       {
         mIt->second->setOverridden(true);
-        mIt->second = &texture;
-      }
-      else
-      {
-        m_texturesByName.insert(std::make_pair(key, &texture));
+        // the key refers to the name of the overridden texture
+        m_texturesByName.erase(mIt);
       }
+      m_texturesByName.emplace(texture.name(), &texture);
     }
   }
 
+  m_textureNameIndex = TrigramIndex{kdl::vec_transform(
+    m_allTextures, [](const auto* t) { return std::string_view{t->name()}; })};
+
   m_textures = kdl::vec_transform(kdl::map_values(m_texturesByName), [](auto* t) {
     return const_cast<const Texture*>(t);
   });
+
+  // sort by the lower case names, like std::string does
+  const auto toLower = [](const char c) {
+    return static_cast<unsigned char>(kdl::str_to_lower(c));
+  };
+  std::sort(m_textures.begin(), m_textures.end(), [&](const auto* lhs, const auto* rhs) {
+    const auto& l = lhs->name();
+    const auto& r = rhs->name();
+    return std::lexicographical_compare(
+      l.begin(), l.end(), r.begin(), r.end(), [&](const auto lc, const auto rc) {
+        return toLower(lc) < toLower(rc);
+      });
+  });
+}
+
+size_t TextureManager::TextureNameHash::operator()(const std::string_view name) const
+{
+  // FNV-1a over the lower case characters, must be consistent with TextureNameEqual
+  auto hash = uint64_t(14695981039346656037ull);
+  for (const auto c : name)
+  {
+    hash ^= uint64_t(static_cast<unsigned char>(kdl::str_to_lower(c)));
+    hash *= uint64_t(1099511628211ull);
+  }
+  return size_t(hash);
+}
+
+bool TextureManager::TextureNameEqual::operator()(
+  const std::string_view lhs, const std::string_view rhs) const
+{
+  return std::equal(
+    lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto l, const auto r) {
+      return kdl::str_to_lower(l) == kdl::str_to_lower(r);
+    });
 }
 } // namespace Assets
 } // namespace TrenchBroom
@@ -20,10 +20,13 @@
 #pragma once
 
 #include "Assets/TextureCollection.h"
+#include "Assets/TrigramIndex.h"
 
 #include <filesystem>
 #include <map>
-#include <string>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom
@@ -47,20 +50,63 @@ class TextureCollection;
 
 class TextureManager
 {
+public:
+  /**
+   * The number of texture bytes uploaded by each call to commitChanges. Texture uploads
+   * are spread over several frames so that loading large collections doesn't block the
+   * UI.
+   */
+  static constexpr size_t MaxUploadBytesPerCommit = 8 * 1024 * 1024;
+
 private:
   Logger& m_logger;
 
   std::vector<TextureCollection> m_collections;
 
-  std::vector<size_t> m_toPrepare;
   std::vector<TextureCollection> m_toRemove;
 
-  std::map<std::string, Texture*> m_texturesByName;
+  /**
+   * The texture files of a collection that was loaded from a directory on disk.
+   */
+  struct TextureFiles
+  {
+    std::filesystem::path directory;
+    // the modification time of the file of each texture when it was loaded, by index
+    std::vector<std::optional<std::filesystem::file_time_type>> writeTimes;
+  };
+
+  // by collection path, see reloadModifiedTextures
+  std::map<std::filesystem::path, TextureFiles> m_textureFiles;
+
+  struct TextureNameHash
+  {
+    size_t operator()(std::string_view name) const;
+  };
+
+  struct TextureNameEqual
+  {
+    bool operator()(std::string_view lhs, std::string_view rhs) const;
+  };
+
+  /**
+   * Maps texture names to textures, ignoring case. The keys refer to the names of the
+   * textures, so looking up a texture does not allocate.
+   */
+  std::unordered_map<std::string_view, Texture*, TextureNameHash, TextureNameEqual>
+    m_texturesByName;
   std::vector<const Texture*> m_textures;
 
+  // the textures of all collections including overridden ones, indexed by
+  // m_textureNameIndex
+  std::vector<const Texture*> m_allTextures;
+  TrigramIndex m_textureNameIndex;
+
   int m_minFilter;
   int m_magFilter;
   bool m_resetTextureMode{false};
+  bool m_compressTextures{false};
+  bool m_loadTexturesOnDemand{false};
+  std::optional<std::filesystem::path> m_textureCacheDirectory;
 
 public:
   TextureManager(int magFilter, int minFilter, Logger& logger);
@@ -68,6 +114,26 @@ public:
 
   void reload(const IO::FileSystem& fs, const Model::TextureConfig& textureConfig);
 
+  /**
+   * Returns the absolute paths of the directories on disk from which texture collections
+   * were loaded. Watching these directories is enough to detect modified textures.
+   */
+  std::vector<std::filesystem::path> textureDirectories() const;
+
+  /**
+   * Reloads the textures in the given directory whose files were modified since they
+   * were loaded. The modified textures are replaced in place, so references to them stay
+   * valid, and only they are decoded and uploaded again.
+   *
+   * Returns the number of reloaded textures, or nothing if files were added to or removed
+   * from the directory or if a texture could not be reloaded. The texture collections
+   * must then be reloaded entirely.
+   */
+  std::optional<size_t> reloadModifiedTextures(
+    const std::filesystem::path& directory,
+    const IO::FileSystem& fs,
+    const Model::TextureConfig& textureConfig);
+
   // for testing
   void setTextureCollections(std::vector<TextureCollection> collections);
 
@@ -83,12 +149,56 @@ public:
   void clear();
 
   void setTextureMode(int minFilter, int magFilter);
+
+  /**
+   * Sets whether uncompressed textures are compressed when they are uploaded. Only
+   * affects textures which have not been uploaded yet.
+   */
+  void setCompressTextures(bool compressTextures);
+
+  /**
+   * Sets the directory in which decoded texture collections are cached, or disables the
+   * cache if no directory is given. Only affects collections which are loaded afterwards.
+   */
+  void setTextureCacheDirectory(std::optional<std::filesystem::path> cacheDirectory);
+
+  /**
+   * Sets whether the pixel data of textures is only decoded and uploaded once a texture
+   * is used by the map or requested by the texture browser. Only affects collections
+   * which are loaded afterwards.
+   */
+  void setLoadTexturesOnDemand(bool loadTexturesOnDemand);
   void commitChanges();
 
-  const Texture* texture(const std::string& name) const;
-  Texture* texture(const std::string& name);
+  /**
+   * Indicates whether some textures have not been uploaded by commitChanges yet. Views
+   * should keep rendering until this returns false.
+   */
+  bool hasPendingUploads() const;
+
+  const Texture* texture(std::string_view name) const;
+  Texture* texture(std::string_view name);
+
+  /**
+   * Looks up the textures with the given names. The returned vector contains, at the
+   * index of each name, the texture with that name or nullptr if there is no such
+   * texture.
+   *
+   * If parallel is true, the lookups are distributed over the thread pool. This only
+   * pays off for many names, e.g. the texture names of all faces of a map.
+   */
+  std::vector<Texture*> resolveTextures(
+    const std::vector<std::string_view>& names, bool parallel) const;
 
   const std::vector<const Texture*>& textures() const;
+
+  /**
+   * Returns the textures whose names contain each of the space separated parts of the
+   * given filter text, ignoring case. The result includes overridden textures and is
+   * ordered like the textures of the collections.
+   */
+  std::vector<const Texture*> findTextures(std::string_view filterText) const;
+
   const std::vector<TextureCollection>& collections() const;
 
 private:
@@ -0,0 +1,65 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureThumbnail.h"
+
+#include "Assets/Texture.h"
+
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace TrenchBroom::Assets
+{
+
+std::optional<TextureThumbnail> makeTextureThumbnail(const Texture& texture)
+{
+  const auto& buffers = texture.buffersIfUnprepared();
+  if (buffers.empty() || isCompressedFormat(texture.format()))
+  {
+    return std::nullopt;
+  }
+
+  auto level = size_t(0);
+  while (level + 1 < buffers.size())
+  {
+    const auto nextSize = sizeAtMipLevel(texture.width(), texture.height(), level + 1);
+    if (std::max(nextSize.x(), nextSize.y()) < TextureThumbnail::MinSize)
+    {
+      break;
+    }
+    ++level;
+  }
+
+  const auto size = sizeAtMipLevel(texture.width(), texture.height(), level);
+  const auto numBytes = size.x() * size.y() * bytesPerPixelForFormat(texture.format());
+  if (buffers[level].size() < numBytes)
+  {
+    return std::nullopt;
+  }
+
+  auto buffer = TextureBuffer{numBytes};
+  std::memcpy(buffer.data(), buffers[level].data(), numBytes);
+
+  return TextureThumbnail{
+    size.x(), size.y(), texture.format(), texture.type(), std::move(buffer)};
+}
+
+} // namespace TrenchBroom::Assets
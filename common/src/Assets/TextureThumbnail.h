@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Assets/TextureBuffer.h"
+#include "Renderer/GL.h"
+
+#include <cstddef>
+#include <optional>
+
+namespace TrenchBroom::Assets
+{
+class Texture;
+enum class TextureType;
+
+/**
+ * A single mip level of a texture which is loaded on demand. The texture browser shows
+ * it until the texture is used, so that browsing a texture collection does not decode
+ * and upload every texture in full.
+ */
+struct TextureThumbnail
+{
+  /**
+   * The minimum size of the larger dimension of a thumbnail. Thumbnails of textures that
+   * are smaller than this have the size of the texture.
+   */
+  static constexpr size_t MinSize = 128;
+
+  size_t width;
+  size_t height;
+  GLenum format;
+  TextureType type;
+  TextureBuffer buffer;
+};
+
+/**
+ * Creates a thumbnail from the smallest mip level of the given texture whose larger
+ * dimension is at least TextureThumbnail::MinSize, or from its first mip level if the
+ * texture is smaller. This is thread safe since it only reads the pixel data of the
+ * given texture.
+ *
+ * Returns nothing if the texture has no pixel data or if it is compressed.
+ */
+std::optional<TextureThumbnail> makeTextureThumbnail(const Texture& texture);
+
+} // namespace TrenchBroom::Assets
@@ -0,0 +1,364 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TriangleBvh.h"
+
+#include "vm/constants.h"
+#include "vm/scalar.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define TB_TRIANGLE_BVH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace TrenchBroom::Assets
+{
+namespace
+{
+constexpr auto Epsilon = vm::constants<float>::almost_zero();
+
+/**
+ * Returns the distance from the ray's origin to the entry point of the given box, or
+ * nothing if the ray misses the box. The distance is negative if the origin is inside the
+ * box.
+ */
+std::optional<float> intersectRayBounds(
+  const vm::vec3f& origin, const vm::vec3f& invDirection, const vm::bbox3f& bounds)
+{
+  auto entry = -std::numeric_limits<float>::infinity();
+  auto exit = std::numeric_limits<float>::infinity();
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (std::isinf(invDirection[i]))
+    {
+      // the ray is parallel to the slab
+      if (origin[i] < bounds.min[i] || origin[i] > bounds.max[i])
+      {
+        return std::nullopt;
+      }
+    }
+    else
+    {
+      const auto t1 = (bounds.min[i] - origin[i]) * invDirection[i];
+      const auto t2 = (bounds.max[i] - origin[i]) * invDirection[i];
+      entry = std::max(entry, std::min(t1, t2));
+      exit = std::min(exit, std::max(t1, t2));
+    }
+  }
+
+  if (entry > exit || exit < 0.0f)
+  {
+    return std::nullopt;
+  }
+  return entry;
+}
+
+#ifndef TB_TRIANGLE_BVH_SSE2
+/**
+ * Same as vm::intersect_ray_triangle, but for a triangle given by its first vertex and
+ * its edges.
+ */
+float intersectRayTriangle(
+  const vm::vec3f& o,
+  const vm::vec3f& d,
+  const vm::vec3f& v0,
+  const vm::vec3f& e1,
+  const vm::vec3f& e2)
+{
+  const auto p = vm::cross(d, e2);
+  const auto a = vm::dot(p, e1);
+  if (vm::is_zero(a, Epsilon))
+  {
+    return vm::nan<float>();
+  }
+
+  const auto t = o - v0;
+  const auto q = vm::cross(t, e1);
+  const auto u = vm::dot(q, e2) / a;
+  const auto v = vm::dot(p, t) / a;
+  const auto w = vm::dot(q, d) / a;
+  if (u < -Epsilon || v < -Epsilon || w < -Epsilon || v + w - 1.0f > Epsilon)
+  {
+    return vm::nan<float>();
+  }
+  return u;
+}
+#endif
+
+} // namespace
+
+TriangleBvh::TriangleBvh(const std::vector<vm::vec3f>& triangles)
+{
+  assert(triangles.size() % 3 == 0);
+  const auto triangleCount = triangles.size() / 3;
+  if (triangleCount == 0)
+  {
+    return;
+  }
+
+  auto triangleBounds = std::vector<vm::bbox3f>{};
+  triangleBounds.reserve(triangleCount);
+  for (size_t i = 0; i < triangleCount; ++i)
+  {
+    auto builder = vm::bbox3f::builder{};
+    builder.add(triangles[3 * i + 0]);
+    builder.add(triangles[3 * i + 1]);
+    builder.add(triangles[3 * i + 2]);
+    // account for the tolerance of the ray triangle test
+    triangleBounds.push_back(builder.bounds().expand(Epsilon));
+  }
+
+  auto triangleIndices = std::vector<size_t>(triangleCount);
+  for (size_t i = 0; i < triangleCount; ++i)
+  {
+    triangleIndices[i] = i;
+  }
+
+  const auto packetCount = (triangleCount + PacketSize - 1) / PacketSize;
+  m_packets.reserve(packetCount);
+  m_nodes.reserve(2 * packetCount);
+  build(triangleIndices, 0, triangleCount, triangles, triangleBounds);
+}
+
+size_t TriangleBvh::build(
+  std::vector<size_t>& triangleIndices,
+  const size_t begin,
+  const size_t end,
+  const std::vector<vm::vec3f>& triangles,
+  const std::vector<vm::bbox3f>& triangleBounds)
+{
+  assert(begin < end);
+
+  auto builder = vm::bbox3f::builder{};
+  for (size_t i = begin; i < end; ++i)
+  {
+    builder.add(triangleBounds[triangleIndices[i]]);
+  }
+
+  const auto nodeIndex = m_nodes.size();
+  if (end - begin <= PacketSize)
+  {
+    auto packet = Packet{};
+    for (size_t lane = 0; lane < end - begin; ++lane)
+    {
+      const auto triangleIndex = triangleIndices[begin + lane];
+      const auto& p1 = triangles[3 * triangleIndex + 0];
+      const auto e1 = triangles[3 * triangleIndex + 1] - p1;
+      const auto e2 = triangles[3 * triangleIndex + 2] - p1;
+      for (size_t i = 0; i < 3; ++i)
+      {
+        packet.v0[i][lane] = p1[i];
+        packet.e1[i][lane] = e1[i];
+        packet.e2[i][lane] = e2[i];
+      }
+    }
+
+    m_nodes.push_back(Node{builder.bounds(), uint32_t(m_packets.size()), true});
+    m_packets.push_back(packet);
+    return nodeIndex;
+  }
+
+  // split at the median of the triangle centers along the longest axis
+  auto centers = vm::bbox3f::builder{};
+  for (size_t i = begin; i < end; ++i)
+  {
+    centers.add(triangleBounds[triangleIndices[i]].center());
+  }
+  const auto axis = vm::find_max_component(centers.bounds().size());
+  const auto mid = begin + (end - begin) / 2;
+  std::nth_element(
+    std::next(triangleIndices.begin(), long(begin)),
+    std::next(triangleIndices.begin(), long(mid)),
+    std::next(triangleIndices.begin(), long(end)),
+    [&](const auto lhs, const auto rhs) {
+      return triangleBounds[lhs].center()[axis] < triangleBounds[rhs].center()[axis];
+    });
+
+  m_nodes.push_back(Node{builder.bounds(), 0, false});
+  build(triangleIndices, begin, mid, triangles, triangleBounds);
+  const auto secondChild = build(triangleIndices, mid, end, triangles, triangleBounds);
+  m_nodes[nodeIndex].index = uint32_t(secondChild);
+
+  return nodeIndex;
+}
+
+float TriangleBvh::intersect(const vm::ray3f& ray) const
+{
+  if (m_nodes.empty())
+  {
+    return vm::nan<float>();
+  }
+
+  const auto& o = ray.origin;
+  const auto& d = ray.direction;
+  const auto invDirection = vm::vec3f{1.0f / d.x(), 1.0f / d.y(), 1.0f / d.z()};
+
+#ifdef TB_TRIANGLE_BVH_SSE2
+  const auto ox = _mm_set1_ps(o.x());
+  const auto oy = _mm_set1_ps(o.y());
+  const auto oz = _mm_set1_ps(o.z());
+  const auto dx = _mm_set1_ps(d.x());
+  const auto dy = _mm_set1_ps(d.y());
+  const auto dz = _mm_set1_ps(d.z());
+  const auto epsilon = _mm_set1_ps(Epsilon);
+  const auto minusEpsilon = _mm_set1_ps(-Epsilon);
+  const auto one = _mm_set1_ps(1.0f);
+  const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  const auto infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+#endif
+
+  // see vm::intersect_ray_triangle
+  const auto intersectPacket = [&](const Packet& packet) {
+#ifdef TB_TRIANGLE_BVH_SSE2
+    const auto load = [](const float* f) { return _mm_load_ps(f); };
+    const auto e1x = load(packet.e1[0]), e1y = load(packet.e1[1]),
+               e1z = load(packet.e1[2]);
+    const auto e2x = load(packet.e2[0]), e2y = load(packet.e2[1]),
+               e2z = load(packet.e2[2]);
+
+    const auto px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    const auto py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    const auto pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    const auto a = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(px, e1x), _mm_mul_ps(py, e1y)), _mm_mul_ps(pz, e1z));
+
+    const auto tx = _mm_sub_ps(ox, load(packet.v0[0]));
+    const auto ty = _mm_sub_ps(oy, load(packet.v0[1]));
+    const auto tz = _mm_sub_ps(oz, load(packet.v0[2]));
+    const auto qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    const auto qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    const auto qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+
+    const auto u = _mm_div_ps(
+      _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(qx, e2x), _mm_mul_ps(qy, e2y)), _mm_mul_ps(qz, e2z)),
+      a);
+    const auto v = _mm_div_ps(
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, tx), _mm_mul_ps(py, ty)), _mm_mul_ps(pz, tz)),
+      a);
+    const auto w = _mm_div_ps(
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, dx), _mm_mul_ps(qy, dy)), _mm_mul_ps(qz, dz)),
+      a);
+
+    // the degenerate triangles in unused slots fail the first test
+    auto hit = _mm_cmpgt_ps(_mm_and_ps(a, absMask), epsilon);
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(u, minusEpsilon));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(v, minusEpsilon));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(w, minusEpsilon));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_sub_ps(_mm_add_ps(v, w), one), epsilon));
+
+    const auto distances = _mm_or_ps(_mm_and_ps(hit, u), _mm_andnot_ps(hit, infinity));
+    alignas(16) float result[PacketSize];
+    _mm_store_ps(result, distances);
+    return std::min({result[0], result[1], result[2], result[3]});
+#else
+    auto result = std::numeric_limits<float>::infinity();
+    for (size_t lane = 0; lane < PacketSize; ++lane)
+    {
+      const auto distance = intersectRayTriangle(
+        o,
+        d,
+        {packet.v0[0][lane], packet.v0[1][lane], packet.v0[2][lane]},
+        {packet.e1[0][lane], packet.e1[1][lane], packet.e1[2][lane]},
+        {packet.e2[0][lane], packet.e2[1][lane], packet.e2[2][lane]});
+      if (!vm::is_nan(distance))
+      {
+        result = std::min(result, distance);
+      }
+    }
+    return result;
+#endif
+  };
+
+  auto closestDistance = std::numeric_limits<float>::infinity();
+
+  // nodes to visit along with their entry distances
+  auto stack = std::vector<std::pair<size_t, float>>{};
+  stack.reserve(64);
+  if (const auto entry = intersectRayBounds(o, invDirection, m_nodes.front().bounds))
+  {
+    stack.emplace_back(0, *entry);
+  }
+
+  while (!stack.empty())
+  {
+    const auto [nodeIndex, entry] = stack.back();
+    stack.pop_back();
+
+    if (entry > closestDistance)
+    {
+      continue;
+    }
+
+    const auto& node = m_nodes[nodeIndex];
+    if (node.leaf)
+    {
+      closestDistance = std::min(closestDistance, intersectPacket(m_packets[node.index]));
+      continue;
+    }
+
+    const auto firstChild = nodeIndex + 1;
+    const auto secondChild = size_t(node.index);
+    const auto firstEntry =
+      intersectRayBounds(o, invDirection, m_nodes[firstChild].bounds);
+    const auto secondEntry =
+      intersectRayBounds(o, invDirection, m_nodes[secondChild].bounds);
+
+    // push the farther child first so that the nearer child is visited first
+    if (firstEntry && secondEntry)
+    {
+      if (*firstEntry < *secondEntry)
+      {
+        stack.emplace_back(secondChild, *secondEntry);
+        stack.emplace_back(firstChild, *firstEntry);
+      }
+      else
+      {
+        stack.emplace_back(firstChild, *firstEntry);
+        stack.emplace_back(secondChild, *secondEntry);
+      }
+    }
+    else if (firstEntry)
+    {
+      stack.emplace_back(firstChild, *firstEntry);
+    }
+    else if (secondEntry)
+    {
+      stack.emplace_back(secondChild, *secondEntry);
+    }
+  }
+
+  return closestDistance != std::numeric_limits<float>::infinity() ? closestDistance
+                                                                   : vm::nan<float>();
+}
+
+size_t TriangleBvh::memoryUsage() const
+{
+  return m_nodes.capacity() * sizeof(Node) + m_packets.capacity() * sizeof(Packet);
+}
+
+} // namespace TrenchBroom::Assets
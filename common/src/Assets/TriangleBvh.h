@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/bbox.h"
+#include "vm/forward.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace TrenchBroom::Assets
+{
+
+/**
+ * A bounding volume hierarchy over a triangle soup, used to find the closest triangle hit
+ * by a ray.
+ *
+ * The triangles are stored in packets of up to four triangles in the leaves of the
+ * hierarchy so that a ray can be tested against all triangles of a leaf at once using
+ * SSE if it is available. The hierarchy is traversed front to back and subtrees that are
+ * farther away than the closest hit found so far are skipped.
+ */
+class TriangleBvh
+{
+private:
+  static constexpr size_t PacketSize = 4;
+
+  /**
+   * The triangles of a leaf in structure of arrays layout. Each triangle is stored as its
+   * first vertex and the two edges starting at that vertex. Unused slots contain
+   * degenerate triangles which are never hit.
+   */
+  struct alignas(16) Packet
+  {
+    float v0[3][PacketSize];
+    float e1[3][PacketSize];
+    float e2[3][PacketSize];
+  };
+
+  /**
+   * A leaf refers to one packet. An inner node's first child follows it directly, and its
+   * second child is stored at the given index.
+   */
+  struct Node
+  {
+    vm::bbox3f bounds;
+    uint32_t index;
+    bool leaf;
+  };
+
+  std::vector<Node> m_nodes;
+  std::vector<Packet> m_packets;
+
+public:
+  /**
+   * Builds a hierarchy over the given triangles. Every three consecutive vertices form a
+   * triangle.
+   */
+  explicit TriangleBvh(const std::vector<vm::vec3f>& triangles);
+
+  /**
+   * Returns the distance from the ray's origin to the closest triangle hit by the given
+   * ray, or NaN if the ray does not hit any triangle. The triangles are hit from both
+   * sides.
+   */
+  float intersect(const vm::ray3f& ray) const;
+
+  size_t memoryUsage() const;
+
+private:
+  size_t build(
+    std::vector<size_t>& triangleIndices,
+    size_t begin,
+    size_t end,
+    const std::vector<vm::vec3f>& triangles,
+    const std::vector<vm::bbox3f>& triangleBounds);
+};
+
+} // namespace TrenchBroom::Assets
@@ -0,0 +1,166 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TrigramIndex.h"
+
+#include "kdl/string_format.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace TrenchBroom::Assets
+{
+namespace
+{
+constexpr auto MaxGramLength = size_t(3);
+
+/**
+ * Packs the given substring of at most three characters into a key. The length is
+ * stored in the highest byte so that substrings of different lengths do not collide.
+ */
+uint32_t gramKey(const std::string_view gram)
+{
+  auto key = uint32_t(gram.size()) << 24;
+  for (size_t i = 0; i < gram.size(); ++i)
+  {
+    key |= uint32_t(static_cast<unsigned char>(gram[i])) << (8 * (2 - i));
+  }
+  return key;
+}
+
+/**
+ * Returns the keys of the substrings that a name must contain in order to contain the
+ * given lower case pattern.
+ */
+std::vector<uint32_t> patternGramKeys(const std::string_view pattern)
+{
+  if (pattern.size() <= MaxGramLength)
+  {
+    return {gramKey(pattern)};
+  }
+
+  auto result = std::vector<uint32_t>{};
+  result.reserve(pattern.size() - MaxGramLength + 1);
+  for (size_t i = 0; i + MaxGramLength <= pattern.size(); ++i)
+  {
+    result.push_back(gramKey(pattern.substr(i, MaxGramLength)));
+  }
+  return result;
+}
+} // namespace
+
+TrigramIndex::TrigramIndex() = default;
+
+TrigramIndex::TrigramIndex(const std::vector<std::string_view>& names)
+{
+  m_names.reserve(names.size());
+  for (uint32_t i = 0; i < uint32_t(names.size()); ++i)
+  {
+    const auto name = std::string_view{m_names.emplace_back(kdl::str_to_lower(names[i]))};
+    for (size_t start = 0; start < name.size(); ++start)
+    {
+      for (size_t length = 1; length <= MaxGramLength && start + length <= name.size();
+           ++length)
+      {
+        // names are added in order, so the lists stay sorted and a name that contains
+        // a substring several times is only recorded once
+        auto& indices = m_namesByGram[gramKey(name.substr(start, length))];
+        if (indices.empty() || indices.back() != i)
+        {
+          indices.push_back(i);
+        }
+      }
+    }
+  }
+}
+
+size_t TrigramIndex::size() const
+{
+  return m_names.size();
+}
+
+std::vector<size_t> TrigramIndex::find(const std::string_view filterText) const
+{
+  const auto patterns = kdl::vec_transform(
+    kdl::str_split(filterText, " "),
+    [](const auto& pattern) { return kdl::str_to_lower(pattern); });
+
+  if (patterns.empty())
+  {
+    auto result = std::vector<size_t>(m_names.size());
+    std::iota(result.begin(), result.end(), size_t(0));
+    return result;
+  }
+
+  auto candidateLists = std::vector<const std::vector<uint32_t>*>{};
+  for (const auto& pattern : patterns)
+  {
+    for (const auto key : patternGramKeys(pattern))
+    {
+      const auto it = m_namesByGram.find(key);
+      if (it == m_namesByGram.end())
+      {
+        return {};
+      }
+      candidateLists.push_back(&it->second);
+    }
+  }
+
+  // start with the shortest list to keep the intersections small
+  std::sort(
+    candidateLists.begin(), candidateLists.end(), [](const auto* lhs, const auto* rhs) {
+      return lhs->size() < rhs->size();
+    });
+
+  auto candidates = *candidateLists.front();
+  auto intersection = std::vector<uint32_t>{};
+  for (auto it = std::next(candidateLists.begin());
+       it != candidateLists.end() && !candidates.empty();
+       ++it)
+  {
+    intersection.clear();
+    std::set_intersection(
+      candidates.begin(),
+      candidates.end(),
+      (*it)->begin(),
+      (*it)->end(),
+      std::back_inserter(intersection));
+    std::swap(candidates, intersection);
+  }
+
+  // a name that contains all substrings of a pattern does not necessarily contain the
+  // pattern itself
+  auto result = std::vector<size_t>{};
+  for (const auto index : candidates)
+  {
+    const auto& name = m_names[index];
+    if (std::all_of(patterns.begin(), patterns.end(), [&](const auto& pattern) {
+          return name.find(pattern) != std::string::npos;
+        }))
+    {
+      result.push_back(index);
+    }
+  }
+  return result;
+}
+
+} // namespace TrenchBroom::Assets
@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom::Assets
+{
+
+/**
+ * An index over a list of names that finds the names containing a filter text without
+ * comparing the text to every name.
+ *
+ * For every name, the index records which substrings of up to three characters it
+ * contains. A filter text is looked up by intersecting the lists of the names that
+ * contain its substrings, and only the remaining candidates are compared to the text.
+ * The cost of a lookup is therefore bounded by the number of names that share the rarest
+ * substring of the text rather than by the number of names.
+ *
+ * Names and filter texts are compared without case sensitivity.
+ */
+class TrigramIndex
+{
+private:
+  std::vector<std::string> m_names;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> m_namesByGram;
+
+public:
+  TrigramIndex();
+  explicit TrigramIndex(const std::vector<std::string_view>& names);
+
+  size_t size() const;
+
+  /**
+   * Returns the indices of the names which contain each of the space separated parts of
+   * the given filter text, in ascending order. Returns the indices of all names if the
+   * filter text is empty.
+   */
+  std::vector<size_t> find(std::string_view filterText) const;
+};
+
+} // namespace TrenchBroom::Assets
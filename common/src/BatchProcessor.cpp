@@ -0,0 +1,438 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BatchProcessor.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+
+#include "Assets/EntityDefinition.h"
+#include "Assets/EntityDefinitionFileSpec.h"
+#include "Assets/EntityDefinitionGroup.h"
+#include "Assets/EntityDefinitionManager.h"
+#include "Error.h"
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/ExportOptions.h"
+#include "IO/File.h"
+#include "IO/PathQt.h"
+#include "IO/SimpleParserStatus.h"
+#include "IO/SystemPaths.h"
+#include "IO/WorldReader.h"
+#include "Logger.h"
+#include "Model/DefaultValidators.h"
+#include "Model/EntityNode.h"
+#include "Model/Game.h"
+#include "Model/GameFactory.h"
+#include "Model/GroupNode.h"
+#include "Model/Issue.h"
+#include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
+#include "Model/Validator.h"
+#include "Model/WorldNode.h"
+#include "Profiler.h"
+
+#include "kdl/overload.h"
+#include "kdl/parallel.h"
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <map>
+
+namespace TrenchBroom
+{
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+Result<std::unique_ptr<Model::WorldNode>> readWorld(
+  const BatchJob& job, const BatchOptions& options, IO::ParserStatus& status)
+{
+  return IO::Disk::mapFile(job.path).transform([&](auto file) {
+    auto fileReader = file->reader().buffer();
+    const auto str = fileReader.stringView();
+    const auto entityPropertyConfig = job.game->entityPropertyConfig();
+
+    if (options.targetFormat && job.formats.size() == 1)
+    {
+      // the brush faces are converted while they are read
+      auto reader = IO::WorldReader{
+        str, job.formats.front(), *options.targetFormat, entityPropertyConfig};
+      return reader.read(options.worldBounds, status);
+    }
+
+    auto world = IO::WorldReader::tryRead(
+      str, job.formats, options.worldBounds, entityPropertyConfig, status);
+    if (options.targetFormat && *options.targetFormat != world->mapFormat())
+    {
+      // now that the format of the map is known, it is read again to convert it
+      auto reader = IO::WorldReader{
+        str, world->mapFormat(), *options.targetFormat, entityPropertyConfig};
+      world = reader.read(options.worldBounds, status);
+    }
+    return world;
+  });
+}
+
+void setEntityDefinitions(
+  Model::WorldNode& world, const Assets::EntityDefinitionManager& manager)
+{
+  world.accept(kdl::overload(
+    [&](auto&& thisLambda, Model::WorldNode* worldNode) {
+      worldNode->setDefinition(manager.definition(worldNode));
+      worldNode->visitChildren(thisLambda);
+    },
+    [](auto&& thisLambda, Model::LayerNode* layerNode) {
+      layerNode->visitChildren(thisLambda);
+    },
+    [](auto&& thisLambda, Model::GroupNode* groupNode) {
+      groupNode->visitChildren(thisLambda);
+    },
+    [&](Model::EntityNode* entityNode) {
+      entityNode->setDefinition(manager.definition(entityNode));
+    },
+    [](Model::BrushNode*) {},
+    [](Model::PatchNode*) {}));
+}
+
+void loadEntityDefinitions(
+  const BatchJob& job,
+  const BatchOptions& options,
+  Model::WorldNode& world,
+  Assets::EntityDefinitionManager& manager,
+  Logger& logger)
+{
+  try
+  {
+    const auto spec = job.game->extractEntityDefinitionFile(world.entity());
+    const auto path = job.game->findEntityDefinitionFile(spec, job.searchPaths);
+    auto status = IO::SimpleParserStatus{logger};
+
+    manager.loadDefinitions(
+      path, options.entityDefinitionCacheDirectory, *job.game, status)
+      .transform([&]() { setEntityDefinitions(world, manager); })
+      .transform_error([&](auto e) {
+        logger.error() << "Could not load entity definition file '" << spec.path()
+                       << "': " << e.msg;
+      });
+  }
+  catch (const Exception& e)
+  {
+    logger.error() << "Could not load entity definition file: " << e.what();
+  }
+}
+
+std::vector<BatchIssue> validateWorld(Model::WorldNode& world)
+{
+  const auto validators = world.registeredValidators();
+  Model::validateIssues({&world}, validators);
+
+  auto nodes = world.allDescendants();
+  nodes.push_back(&world);
+
+  const auto issueTypeName = [&](const Model::IssueType type) {
+    const auto it = std::find_if(
+      validators.begin(), validators.end(), [&](const auto* validator) {
+        return validator->type() == type;
+      });
+    return it != validators.end() ? (*it)->description() : std::string{};
+  };
+
+  auto issues = std::vector<BatchIssue>{};
+  for (auto* node : nodes)
+  {
+    for (const auto* issue : node->issues(validators))
+    {
+      if (!issue->hidden())
+      {
+        issues.push_back(BatchIssue{
+          issueTypeName(issue->type()), issue->description(), issue->lineNumber()});
+      }
+    }
+  }
+
+  std::stable_sort(issues.begin(), issues.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.lineNumber < rhs.lineNumber;
+  });
+  return issues;
+}
+
+void writeConvertedMap(
+  const BatchJob& job,
+  const BatchOptions& options,
+  Model::WorldNode& world,
+  BatchResult& result)
+{
+  if (options.outputDirectory.empty())
+  {
+    result.errors.push_back("An output directory is required to convert maps");
+    return;
+  }
+
+  const auto path = options.outputDirectory / job.path.filename();
+  auto error = std::error_code{};
+  if (std::filesystem::equivalent(path, job.path, error))
+  {
+    result.errors.push_back("Refusing to overwrite the map with the converted map");
+    return;
+  }
+
+  job.game->writeMap(world, path)
+    .transform([&]() { result.outputPaths.push_back(path); })
+    .transform_error([&](const auto& e) {
+      result.errors.push_back("Could not write converted map: " + e.msg);
+    });
+}
+
+void exportObj(
+  const BatchJob& job,
+  const BatchOptions& options,
+  Model::WorldNode& world,
+  BatchResult& result)
+{
+  const auto directory =
+    options.outputDirectory.empty() ? job.path.parent_path() : options.outputDirectory;
+  auto path = directory / job.path.filename();
+  path.replace_extension(".obj");
+
+  const auto exportOptions =
+    IO::ObjExportOptions{path, IO::ObjMtlPathMode::RelativeToExportPath};
+  job.game->exportMap(world, exportOptions)
+    .transform([&]() {
+      result.outputPaths.push_back(path);
+      result.outputPaths.push_back(std::filesystem::path{path}.replace_extension(".mtl"));
+    })
+    .transform_error([&](const auto& e) {
+      result.errors.push_back("Could not export OBJ file: " + e.msg);
+    });
+}
+
+QString toQString(const LogLevel level)
+{
+  switch (level)
+  {
+  case LogLevel::Debug:
+    return "debug";
+  case LogLevel::Info:
+    return "info";
+  case LogLevel::Warn:
+    return "warning";
+  case LogLevel::Error:
+    return "error";
+    switchDefault();
+  }
+}
+
+QJsonObject toJson(const BatchResult& result)
+{
+  auto issues = QJsonArray{};
+  for (const auto& issue : result.issues)
+  {
+    issues.append(QJsonObject{
+      {"type", QString::fromStdString(issue.type)},
+      {"description", QString::fromStdString(issue.description)},
+      {"line", static_cast<qint64>(issue.lineNumber)},
+    });
+  }
+
+  auto outputs = QJsonArray{};
+  for (const auto& path : result.outputPaths)
+  {
+    outputs.append(IO::pathAsQString(path));
+  }
+
+  auto errors = QJsonArray{};
+  for (const auto& error : result.errors)
+  {
+    errors.append(QString::fromStdString(error));
+  }
+
+  auto messages = QJsonArray{};
+  for (const auto& [level, message] : result.messages)
+  {
+    if (level != LogLevel::Debug)
+    {
+      messages.append(QJsonObject{
+        {"level", toQString(level)},
+        {"message", QString::fromStdString(message)},
+      });
+    }
+  }
+
+  return QJsonObject{
+    {"path", IO::pathAsQString(result.path)},
+    {"game", QString::fromStdString(result.gameName)},
+    {"format", QString::fromStdString(Model::formatName(result.format))},
+    {"succeeded", result.succeeded()},
+    {"durationMs", static_cast<qint64>(result.duration.count())},
+    {"issues", issues},
+    {"outputs", outputs},
+    {"errors", errors},
+    {"messages", messages},
+  };
+}
+
+} // namespace
+
+bool BatchResult::succeeded() const
+{
+  return errors.empty();
+}
+
+std::vector<BatchJob> createBatchJobs(
+  Model::GameFactory& gameFactory,
+  const std::vector<std::filesystem::path>& paths,
+  const std::optional<std::string>& defaultGameName,
+  Logger& logger)
+{
+  auto games = std::map<std::string, std::shared_ptr<Model::Game>>{};
+  const auto appDirectory = IO::SystemPaths::appDirectory();
+
+  return kdl::vec_transform(paths, [&](const auto& path) {
+    auto job = BatchJob{path, nullptr, {}, {}, std::nullopt};
+    gameFactory.detectGame(path)
+      .transform([&](auto detected) {
+        auto [gameName, format] = std::move(detected);
+        if (gameName.empty() && defaultGameName)
+        {
+          gameName = *defaultGameName;
+        }
+        if (gameName.empty())
+        {
+          job.error = "Could not detect the game of the map";
+          return;
+        }
+
+        try
+        {
+          auto& game = games[gameName];
+          if (!game)
+          {
+            game = gameFactory.createGame(gameName, logger);
+          }
+          job.game = game;
+          job.formats =
+            format != Model::MapFormat::Unknown
+              ? std::vector<Model::MapFormat>{format}
+              : kdl::vec_transform(gameFactory.fileFormats(gameName), [](const auto& f) {
+                  return Model::formatFromName(f);
+                });
+
+          // see MapDocument::externalSearchPaths
+          job.searchPaths = {path.parent_path(), game->gamePath(), appDirectory};
+        }
+        catch (const Exception& e)
+        {
+          job.error = std::string{"Could not create game: "} + e.what();
+        }
+      })
+      .transform_error([&](const auto& e) { job.error = e.msg; });
+    return job;
+  });
+}
+
+BatchResult processMap(const BatchJob& job, const BatchOptions& options)
+{
+  const auto zone = ProfilerZone{"processMap"};
+  const auto start = Clock::now();
+
+  auto result = BatchResult{};
+  result.path = job.path;
+
+  if (job.error)
+  {
+    result.errors.push_back(*job.error);
+    return result;
+  }
+
+  result.gameName = job.game->gameName();
+
+  auto logger = CollectingLogger{};
+  auto status = IO::SimpleParserStatus{logger};
+
+  // declared before the world so that the definitions outlive the nodes that use them
+  auto entityDefinitionManager = Assets::EntityDefinitionManager{};
+
+  try
+  {
+    readWorld(job, options, status)
+      .transform([&](auto world) {
+        result.format = world->mapFormat();
+
+        if (options.validate)
+        {
+          loadEntityDefinitions(job, options, *world, entityDefinitionManager, logger);
+          Model::registerDefaultValidators(*world, job.game, options.worldBounds);
+          result.issues = validateWorld(*world);
+        }
+        if (options.targetFormat)
+        {
+          writeConvertedMap(job, options, *world, result);
+        }
+        if (options.exportObj)
+        {
+          exportObj(job, options, *world, result);
+        }
+      })
+      .transform_error([&](const auto& e) { result.errors.push_back(e.msg); });
+  }
+  catch (const std::exception& e)
+  {
+    result.errors.push_back(e.what());
+  }
+
+  result.messages = logger.takeMessages();
+  result.duration =
+    std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+  return result;
+}
+
+std::vector<BatchResult> processMaps(
+  const std::vector<BatchJob>& jobs, const BatchOptions& options)
+{
+  return kdl::vec_parallel_transform(
+    jobs, [&](const auto& job) { return processMap(job, options); });
+}
+
+std::string batchReport(const std::vector<BatchResult>& results)
+{
+  auto maps = QJsonArray{};
+  auto failedCount = qint64(0);
+  auto issueCount = qint64(0);
+  for (const auto& result : results)
+  {
+    maps.append(toJson(result));
+    failedCount += result.succeeded() ? 0 : 1;
+    issueCount += static_cast<qint64>(result.issues.size());
+  }
+
+  const auto document = QJsonDocument{QJsonObject{
+    {"mapCount", static_cast<qint64>(results.size())},
+    {"failedMapCount", failedCount},
+    {"issueCount", issueCount},
+    {"maps", maps},
+  }};
+  return document.toJson(QJsonDocument::Indented).toStdString();
+}
+
+} // namespace TrenchBroom
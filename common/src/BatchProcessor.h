@@ -0,0 +1,157 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "CollectingLogger.h"
+#include "FloatType.h"
+#include "Model/MapFormat.h"
+
+#include "vm/bbox.h"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+class Logger;
+
+namespace Model
+{
+class Game;
+class GameFactory;
+} // namespace Model
+
+struct BatchOptions
+{
+  /**
+   * Run the validators of the issue browser and report the issues they find.
+   */
+  bool validate = false;
+
+  /**
+   * Convert the maps to this format and write them to the output directory. The format
+   * must be compatible with the format of every map, e.g. Standard and Valve.
+   */
+  std::optional<Model::MapFormat> targetFormat;
+
+  /**
+   * Export the maps as OBJ files to the output directory.
+   */
+  bool exportObj = false;
+
+  /**
+   * The directory to write the converted maps and the exported files to. If empty, the
+   * exported files are written next to the maps, and maps cannot be converted.
+   */
+  std::filesystem::path outputDirectory;
+
+  vm::bbox3 worldBounds = vm::bbox3{-32768.0, 32768.0};
+
+  /**
+   * The directory to cache parsed entity definitions in, if any. The maps are processed
+   * on worker threads, which cannot read the preferences.
+   */
+  std::optional<std::filesystem::path> entityDefinitionCacheDirectory;
+};
+
+/**
+ * A map to process together with the game it belongs to.
+ */
+struct BatchJob
+{
+  std::filesystem::path path;
+  std::shared_ptr<Model::Game> game;
+
+  /**
+   * The formats to try when reading the map, in order. Contains only the format given in
+   * the map file if there is one.
+   */
+  std::vector<Model::MapFormat> formats;
+
+  /**
+   * The paths to search for the entity definition file of the map.
+   */
+  std::vector<std::filesystem::path> searchPaths;
+
+  /**
+   * Set if the job could not be created, e.g. if the game of the map is unknown.
+   */
+  std::optional<std::string> error;
+};
+
+struct BatchIssue
+{
+  // the description of the validator that found the issue
+  std::string type;
+  std::string description;
+  size_t lineNumber;
+};
+
+struct BatchResult
+{
+  std::filesystem::path path;
+  std::string gameName;
+  Model::MapFormat format = Model::MapFormat::Unknown;
+  std::vector<BatchIssue> issues;
+  std::vector<std::filesystem::path> outputPaths;
+  std::vector<std::string> errors;
+  std::vector<CollectingLogger::Message> messages;
+  std::chrono::milliseconds duration = std::chrono::milliseconds{0};
+
+  bool succeeded() const;
+};
+
+/**
+ * Detects the game and the format of each of the given maps. Maps without a game comment
+ * are assigned the given default game, if any.
+ *
+ * Must be called on the main thread because the games read the preferences when they are
+ * created. Each game is only created once and shared by all of its maps.
+ */
+std::vector<BatchJob> createBatchJobs(
+  Model::GameFactory& gameFactory,
+  const std::vector<std::filesystem::path>& paths,
+  const std::optional<std::string>& defaultGameName,
+  Logger& logger);
+
+/**
+ * Processes a single map: reads it, loads its entity definitions and then validates,
+ * converts and exports it as requested by the given options. Does not access the
+ * preferences, the GUI or any OpenGL state, so it can be called from any thread.
+ */
+BatchResult processMap(const BatchJob& job, const BatchOptions& options);
+
+/**
+ * Processes the given maps in parallel on the worker threads of the default thread pool.
+ * The results are returned in the order of the given jobs.
+ */
+std::vector<BatchResult> processMaps(
+  const std::vector<BatchJob>& jobs, const BatchOptions& options);
+
+/**
+ * Returns a JSON document describing the given results.
+ */
+std::string batchReport(const std::vector<BatchResult>& results);
+
+} // namespace TrenchBroom
@@ -0,0 +1,43 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CollectingLogger.h"
+
+#include <QString>
+
+namespace TrenchBroom
+{
+
+std::vector<CollectingLogger::Message> CollectingLogger::takeMessages()
+{
+  return std::move(m_messages);
+}
+
+void CollectingLogger::doLog(const LogLevel level, const std::string& message)
+{
+  m_messages.emplace_back(level, message);
+}
+
+void CollectingLogger::doLog(const LogLevel level, const QString& message)
+{
+  doLog(level, message.toStdString());
+}
+
+} // namespace TrenchBroom
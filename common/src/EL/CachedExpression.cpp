@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CachedExpression.h"
+
+#include "EL/EvaluationContext.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+
+namespace TrenchBroom::EL
+{
+
+CachedExpression::CachedExpression(Expression expression)
+  : m_expression{std::move(expression)}
+  , m_variables{m_expression.variables()}
+{
+}
+
+const Expression& CachedExpression::expression() const
+{
+  return m_expression;
+}
+
+const std::vector<std::string>& CachedExpression::variables() const
+{
+  return m_variables;
+}
+
+Value CachedExpression::evaluate(const VariableStore& variableStore) const
+{
+  auto values = std::map<std::string, Value>{};
+  auto key = std::vector<std::string>{};
+  key.reserve(m_variables.size());
+
+  auto cacheable = true;
+  for (const auto& name : m_variables)
+  {
+    auto value = variableStore.value(name);
+    if (value.type() == ValueType::String)
+    {
+      key.push_back(value.stringValue());
+    }
+    else
+    {
+      cacheable = false;
+    }
+    values.emplace(name, std::move(value));
+  }
+
+  if (cacheable)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (const auto it = m_results.find(key); it != m_results.end())
+    {
+      return it->second;
+    }
+  }
+
+  const auto context = EvaluationContext{VariableTable{std::move(values)}};
+  auto result = m_expression.evaluate(context);
+
+  if (cacheable)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (m_results.size() >= MaxCachedResults)
+    {
+      m_results.clear();
+    }
+    m_results.emplace(std::move(key), result);
+  }
+
+  return result;
+}
+
+size_t CachedExpression::cachedResultCount() const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return m_results.size();
+}
+
+} // namespace TrenchBroom::EL
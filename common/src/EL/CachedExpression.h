@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "EL/EL_Forward.h"
+#include "EL/Expression.h"
+#include "Macros.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom::EL
+{
+
+/**
+ * Evaluates an expression and caches its results by the values of the variables that it
+ * references. The referenced variables are determined once when the cache is created,
+ * so evaluating the expression only requires looking up these variables.
+ *
+ * A result is only cached if every referenced variable has a string value, which is
+ * always the case for entity properties. The results can be shared by many entities,
+ * e.g. all entities of a class whose model depends only on their spawnflags.
+ *
+ * Can be used by several threads at the same time.
+ */
+class CachedExpression
+{
+public:
+  /**
+   * The cached results are discarded once the cache contains this many results.
+   */
+  static constexpr size_t MaxCachedResults = 1024;
+
+private:
+  Expression m_expression;
+  std::vector<std::string> m_variables;
+
+  mutable std::mutex m_mutex;
+  mutable std::map<std::vector<std::string>, Value> m_results;
+
+public:
+  explicit CachedExpression(Expression expression);
+
+  const Expression& expression() const;
+
+  /**
+   * Returns the names of the variables referenced by the expression.
+   */
+  const std::vector<std::string>& variables() const;
+
+  /**
+   * Evaluates the expression using the values of the referenced variables in the given
+   * store, or returns the cached result if the expression was already evaluated with
+   * the same values.
+   *
+   * @throws EL::Exception if the expression could not be evaluated
+   */
+  Value evaluate(const VariableStore& variableStore) const;
+
+  size_t cachedResultCount() const;
+
+  deleteCopyAndMove(CachedExpression);
+};
+
+} // namespace TrenchBroom::EL
@@ -27,6 +27,7 @@ class Value;
 enum class ValueType;
 
 class Expression;
+class CachedExpression;
 
 class EvaluationContext;
 
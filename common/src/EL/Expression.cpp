@@ -24,6 +24,8 @@
 #include "Ensure.h"
 #include "Macros.h"
 
+#include "kdl/vector_utils.h"
+
 #include <sstream>
 
 namespace TrenchBroom
@@ -102,7 +104,10 @@ Expression::Expression(
 
 Value Expression::evaluate(const EvaluationContext& context) const
 {
-  return Value{m_expression->evaluate(context), *this};
+  // set the expression in place to avoid moving the value
+  auto value = m_expression->evaluate(context);
+  value.m_expression = *this;
+  return value;
 }
 
 Expression Expression::optimize() const
@@ -110,6 +115,13 @@ Expression Expression::optimize() const
   return Expression{m_expression->optimize(), m_line, m_column};
 }
 
+std::vector<std::string> Expression::variables() const
+{
+  auto result = std::vector<std::string>{};
+  m_expression->appendVariables(result);
+  return kdl::vec_sort_and_remove_duplicates(std::move(result));
+}
+
 size_t Expression::line() const
 {
   return m_line;
@@ -120,6 +132,11 @@ size_t Expression::column() const
   return m_column;
 }
 
+const ExpressionImpl& Expression::impl() const
+{
+  return *m_expression;
+}
+
 std::string Expression::asString() const
 {
   auto str = std::stringstream{};
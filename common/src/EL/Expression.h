@@ -25,6 +25,7 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -65,9 +66,20 @@ public:
   Value evaluate(const EvaluationContext& context) const;
   Expression optimize() const;
 
+  /**
+   * Returns the names of the variables referenced by this expression, sorted and without
+   * duplicates.
+   */
+  std::vector<std::string> variables() const;
+
   size_t line() const;
   size_t column() const;
 
+  /**
+   * Returns the root node of this expression.
+   */
+  const ExpressionImpl& impl() const;
+
   std::string asString() const;
 
   friend bool operator==(const Expression& lhs, const Expression& rhs);
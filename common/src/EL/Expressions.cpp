@@ -39,6 +39,14 @@ namespace EL
 {
 ExpressionImpl::~ExpressionImpl() = default;
 
+static void appendExpressionVariables(
+  const Expression& expression, std::vector<std::string>& variables)
+{
+  const auto expressionVariables = expression.variables();
+  variables.insert(
+    variables.end(), expressionVariables.begin(), expressionVariables.end());
+}
+
 size_t ExpressionImpl::precedence() const
 {
   return 13u;
@@ -100,11 +108,20 @@ LiteralExpression::LiteralExpression(Value value)
 {
 }
 
+const Value& LiteralExpression::value() const
+{
+  return m_value;
+}
+
 Value LiteralExpression::evaluate(const EvaluationContext&) const
 {
   return m_value;
 }
 
+void LiteralExpression::appendVariables(std::vector<std::string>& /* variables */) const
+{
+}
+
 std::unique_ptr<ExpressionImpl> LiteralExpression::optimize() const
 {
   return std::make_unique<LiteralExpression>(m_value);
@@ -130,11 +147,21 @@ VariableExpression::VariableExpression(std::string variableName)
 {
 }
 
+const std::string& VariableExpression::variableName() const
+{
+  return m_variableName;
+}
+
 Value VariableExpression::evaluate(const EvaluationContext& context) const
 {
   return context.variableValue(m_variableName);
 }
 
+void VariableExpression::appendVariables(std::vector<std::string>& variables) const
+{
+  variables.push_back(m_variableName);
+}
+
 std::unique_ptr<ExpressionImpl> VariableExpression::optimize() const
 {
   return std::make_unique<VariableExpression>(m_variableName);
@@ -160,6 +187,11 @@ ArrayExpression::ArrayExpression(std::vector<Expression> elements)
 {
 }
 
+const std::vector<Expression>& ArrayExpression::elements() const
+{
+  return m_elements;
+}
+
 Value ArrayExpression::evaluate(const EvaluationContext& context) const
 {
   auto array = ArrayType{};
@@ -188,6 +220,14 @@ Value ArrayExpression::evaluate(const EvaluationContext& context) const
   return Value{std::move(array)};
 }
 
+void ArrayExpression::appendVariables(std::vector<std::string>& variables) const
+{
+  for (const auto& element : m_elements)
+  {
+    appendExpressionVariables(element, variables);
+  }
+}
+
 std::unique_ptr<ExpressionImpl> ArrayExpression::optimize() const
 {
   auto optimizedExpressions = kdl::vec_transform(
@@ -243,6 +283,11 @@ MapExpression::MapExpression(std::map<std::string, Expression> elements)
 {
 }
 
+const std::map<std::string, Expression>& MapExpression::elements() const
+{
+  return m_elements;
+}
+
 Value MapExpression::evaluate(const EvaluationContext& context) const
 {
   auto map = MapType{};
@@ -254,6 +299,14 @@ Value MapExpression::evaluate(const EvaluationContext& context) const
   return Value{std::move(map)};
 }
 
+void MapExpression::appendVariables(std::vector<std::string>& variables) const
+{
+  for (const auto& [key, element] : m_elements)
+  {
+    appendExpressionVariables(element, variables);
+  }
+}
+
 std::unique_ptr<ExpressionImpl> MapExpression::optimize() const
 {
   auto optimizedExpressions = std::map<std::string, Expression>{};
@@ -312,6 +365,16 @@ UnaryExpression::UnaryExpression(const UnaryOperator i_operator, Expression oper
 {
 }
 
+UnaryOperator UnaryExpression::unaryOperator() const
+{
+  return m_operator;
+}
+
+const Expression& UnaryExpression::operand() const
+{
+  return m_operand;
+}
+
 static Value evaluateUnaryPlus(const Value& v)
 {
   switch (v.type())
@@ -430,6 +493,11 @@ Value UnaryExpression::evaluate(const EvaluationContext& context) const
   return evaluateUnaryExpression(m_operator, m_operand.evaluate(context));
 }
 
+void UnaryExpression::appendVariables(std::vector<std::string>& variables) const
+{
+  appendExpressionVariables(m_operand, variables);
+}
+
 std::unique_ptr<ExpressionImpl> UnaryExpression::optimize() const
 {
   auto optimizedOperand = m_operand.optimize();
@@ -484,6 +552,21 @@ BinaryExpression::BinaryExpression(
 {
 }
 
+BinaryOperator BinaryExpression::binaryOperator() const
+{
+  return m_operator;
+}
+
+const Expression& BinaryExpression::leftOperand() const
+{
+  return m_leftOperand;
+}
+
+const Expression& BinaryExpression::rightOperand() const
+{
+  return m_rightOperand;
+}
+
 Expression BinaryExpression::createAutoRangeWithRightOperand(
   Expression rightOperand, const size_t line, const size_t column)
 {
@@ -517,6 +600,12 @@ static std::optional<Value> tryEvaluateAlgebraicOperator(
     return Value::Undefined;
   }
 
+  // avoid the conversions in the common case
+  if (lhs.hasType(ValueType::Number) && rhs.hasType(ValueType::Number))
+  {
+    return Value{eval(lhs, rhs)};
+  }
+
   if (
     lhs.hasType(ValueType::Boolean, ValueType::Number)
     && rhs.hasType(ValueType::Boolean, ValueType::Number))
@@ -738,6 +827,11 @@ static std::optional<Value> tryEvaluateBitwiseOperator(
     return Value::Undefined;
   }
 
+  if (lhs.hasType(ValueType::Number) && rhs.hasType(ValueType::Number))
+  {
+    return Value{eval(lhs, rhs)};
+  }
+
   if (lhs.convertibleTo(ValueType::Number) && rhs.convertibleTo(ValueType::Number))
   {
     return Value{
@@ -847,10 +941,16 @@ static int compareAsBooleans(const Value& lhs, const Value& rhs)
   }
 }
 
+static NumberType toNumber(const Value& value)
+{
+  return value.hasType(ValueType::Number)
+           ? value.numberValue()
+           : value.convertTo(ValueType::Number).numberValue();
+}
+
 static int compareAsNumbers(const Value& lhs, const Value& rhs)
 {
-  const NumberType diff = lhs.convertTo(ValueType::Number).numberValue()
-                          - rhs.convertTo(ValueType::Number).numberValue();
+  const NumberType diff = toNumber(lhs) - toNumber(rhs);
   if (diff < 0.0)
   {
     return -1;
@@ -1117,6 +1217,12 @@ Value BinaryExpression::evaluate(const EvaluationContext& context) const
     [&] { return m_rightOperand.evaluate(context); });
 }
 
+void BinaryExpression::appendVariables(std::vector<std::string>& variables) const
+{
+  appendExpressionVariables(m_leftOperand, variables);
+  appendExpressionVariables(m_rightOperand, variables);
+}
+
 std::unique_ptr<ExpressionImpl> BinaryExpression::optimize() const
 {
   auto optimizedLeftOperand = std::optional<Expression>{};
@@ -1278,6 +1384,16 @@ SubscriptExpression::SubscriptExpression(Expression leftOperand, Expression righ
 {
 }
 
+const Expression& SubscriptExpression::leftOperand() const
+{
+  return m_leftOperand;
+}
+
+const Expression& SubscriptExpression::rightOperand() const
+{
+  return m_rightOperand;
+}
+
 Value SubscriptExpression::evaluate(const EvaluationContext& context) const
 {
   const auto leftValue = m_leftOperand.evaluate(context);
@@ -1289,6 +1405,12 @@ Value SubscriptExpression::evaluate(const EvaluationContext& context) const
   return leftValue[rightValue];
 }
 
+void SubscriptExpression::appendVariables(std::vector<std::string>& variables) const
+{
+  appendExpressionVariables(m_leftOperand, variables);
+  appendExpressionVariables(m_rightOperand, variables);
+}
+
 std::unique_ptr<ExpressionImpl> SubscriptExpression::optimize() const
 {
   auto optimizedLeftOperand = m_leftOperand.optimize();
@@ -1335,6 +1457,11 @@ SwitchExpression::SwitchExpression(std::vector<Expression> cases)
 {
 }
 
+const std::vector<Expression>& SwitchExpression::cases() const
+{
+  return m_cases;
+}
+
 Value SwitchExpression::evaluate(const EvaluationContext& context) const
 {
   for (const auto& case_ : m_cases)
@@ -1347,6 +1474,14 @@ Value SwitchExpression::evaluate(const EvaluationContext& context) const
   return Value::Undefined;
 }
 
+void SwitchExpression::appendVariables(std::vector<std::string>& variables) const
+{
+  for (const auto& case_ : m_cases)
+  {
+    appendExpressionVariables(case_, variables);
+  }
+}
+
 std::unique_ptr<ExpressionImpl> SwitchExpression::optimize() const
 {
   if (m_cases.empty())
@@ -40,6 +40,12 @@ public:
   virtual Value evaluate(const EvaluationContext& context) const = 0;
   virtual std::unique_ptr<ExpressionImpl> optimize() const = 0;
 
+  /**
+   * Appends the names of the variables referenced by this expression to the given
+   * vector. The names may contain duplicates.
+   */
+  virtual void appendVariables(std::vector<std::string>& variables) const = 0;
+
   virtual size_t precedence() const;
 
   virtual bool operator==(const ExpressionImpl& rhs) const = 0;
@@ -68,8 +74,11 @@ private:
 public:
   LiteralExpression(Value value);
 
+  const Value& value() const;
+
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariables(std::vector<std::string>& variables) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const LiteralExpression& rhs) const override;
@@ -86,8 +95,11 @@ private:
 public:
   VariableExpression(std::string variableName);
 
+  const std::string& variableName() const;
+
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariables(std::vector<std::string>& variables) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const VariableExpression& rhs) const override;
@@ -104,8 +116,11 @@ private:
 public:
   ArrayExpression(std::vector<Expression> elements);
 
+  const std::vector<Expression>& elements() const;
+
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariables(std::vector<std::string>& variables) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const ArrayExpression& rhs) const override;
@@ -122,8 +137,11 @@ private:
 public:
   MapExpression(std::map<std::string, Expression> elements);
 
+  const std::map<std::string, Expression>& elements() const;
+
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariables(std::vector<std::string>& variables) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const MapExpression& rhs) const override;
@@ -150,8 +168,12 @@ private:
 public:
   UnaryExpression(UnaryOperator i_operator, Expression operand);
 
+  UnaryOperator unaryOperator() const;
+  const Expression& operand() const;
+
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariables(std::vector<std::string>& variables) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const UnaryExpression& rhs) const override;
@@ -197,6 +219,10 @@ private:
 public:
   BinaryExpression(
     BinaryOperator i_operator, Expression leftOperand, Expression rightOperand);
+
+  BinaryOperator binaryOperator() const;
+  const Expression& leftOperand() const;
+  const Expression& rightOperand() const;
   static Expression createAutoRangeWithRightOperand(
     Expression rightOperand, size_t line, size_t column);
   static Expression createAutoRangeWithLeftOperand(
@@ -204,6 +230,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariables(std::vector<std::string>& variables) const override;
 
   size_t precedence() const override;
 
@@ -226,8 +253,12 @@ private:
 public:
   SubscriptExpression(Expression leftOperand, Expression rightOperand);
 
+  const Expression& leftOperand() const;
+  const Expression& rightOperand() const;
+
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariables(std::vector<std::string>& variables) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const SubscriptExpression& rhs) const override;
@@ -244,8 +275,11 @@ private:
 public:
   SwitchExpression(std::vector<Expression> cases);
 
+  const std::vector<Expression>& cases() const;
+
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariables(std::vector<std::string>& variables) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const SwitchExpression& rhs) const override;
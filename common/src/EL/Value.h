@@ -52,19 +52,26 @@ public:
   static const UndefinedType Value;
 };
 
+/**
+ * Values are created and copied a lot during expression evaluation. To avoid a heap
+ * allocation for every value, booleans, numbers, null, undefined and strings that fit
+ * into the small string buffer are stored inline. Longer strings, arrays, maps and
+ * ranges are immutable and shared between copies.
+ */
 class Value
 {
 private:
-  using VariantType = std::variant<
+  using StorageType = std::variant<
     BooleanType,
     StringType,
+    std::shared_ptr<const StringType>,
     NumberType,
-    ArrayType,
-    MapType,
-    RangeType,
+    std::shared_ptr<const ArrayType>,
+    std::shared_ptr<const MapType>,
+    std::shared_ptr<const RangeType>,
     NullType,
     UndefinedType>;
-  std::shared_ptr<VariantType> m_value;
+  StorageType m_value;
   std::optional<Expression> m_expression;
 
 public:
@@ -142,6 +149,16 @@ public:
   friend bool operator!=(const Value& lhs, const Value& rhs);
 
   friend std::ostream& operator<<(std::ostream& lhs, const Value& rhs);
+
+private:
+  friend class Expression;
+
+  /**
+   * Calls the given visitor with a reference to the stored boolean, string, number,
+   * array, map, range, null or undefined value, regardless of how it is stored.
+   */
+  template <typename Visitor>
+  decltype(auto) visit(Visitor&& visitor) const;
 };
 } // namespace EL
 } // namespace TrenchBroom
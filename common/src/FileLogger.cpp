@@ -48,6 +48,17 @@ FileLogger::FileLogger(const std::filesystem::path& filePath)
   : m_stream{openLogFile(filePath)}
 {
   ensure(m_stream, "log file could not be opened");
+  m_writer = std::thread{[&]() { writeMessages(); }};
+}
+
+FileLogger::~FileLogger()
+{
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_stopped = true;
+  }
+  m_condition.notify_all();
+  m_writer.join();
 }
 
 FileLogger& FileLogger::instance()
@@ -56,17 +67,65 @@ FileLogger& FileLogger::instance()
   return Instance;
 }
 
+void FileLogger::flush()
+{
+  // the crash handler may run on the writer thread
+  if (std::this_thread::get_id() == m_writer.get_id())
+  {
+    return;
+  }
+
+  auto lock = std::unique_lock{m_mutex};
+  m_condition.wait(lock, [&]() { return m_pendingMessages.empty() && !m_writing; });
+}
+
 void FileLogger::doLog(const LogLevel /* level */, const std::string& message)
 {
-  assert(m_stream);
-  if (m_stream)
   {
-    m_stream << message << std::endl;
+    const auto lock = std::lock_guard{m_mutex};
+    m_pendingMessages.push_back(message);
   }
+  m_condition.notify_all();
 }
 
 void FileLogger::doLog(const LogLevel level, const QString& message)
 {
   log(level, message.toStdString());
 }
+
+void FileLogger::writeMessages()
+{
+  auto messages = std::vector<std::string>{};
+
+  auto lock = std::unique_lock{m_mutex};
+  while (true)
+  {
+    m_condition.wait(lock, [&]() { return !m_pendingMessages.empty() || m_stopped; });
+    if (m_pendingMessages.empty())
+    {
+      // stopped and all messages were written
+      return;
+    }
+
+    // write the messages in bulk without holding the lock, and flush only once
+    std::swap(messages, m_pendingMessages);
+    m_writing = true;
+    lock.unlock();
+
+    assert(m_stream);
+    if (m_stream)
+    {
+      for (const auto& message : messages)
+      {
+        m_stream << message << "\n";
+      }
+      m_stream.flush();
+    }
+    messages.clear();
+
+    lock.lock();
+    m_writing = false;
+    m_condition.notify_all();
+  }
+}
 } // namespace TrenchBroom
@@ -22,29 +22,55 @@
 #include "Logger.h"
 #include "Macros.h"
 
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 class QString;
 
 namespace TrenchBroom
 {
 
+/**
+ * Writes log messages to a file.
+ *
+ * Logging only appends the message to a queue, the messages are written by a background
+ * thread. This keeps the callers from blocking on file I/O when many messages are logged,
+ * e.g. when loading a broken map.
+ */
 class FileLogger : public Logger
 {
 private:
   std::ofstream m_stream;
 
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::vector<std::string> m_pendingMessages;
+  bool m_writing{false};
+  bool m_stopped{false};
+  std::thread m_writer;
+
 public:
   explicit FileLogger(const std::filesystem::path& filePath);
+  ~FileLogger() override;
 
   static FileLogger& instance();
 
+  /**
+   * Blocks until all messages that were logged so far have been written to the file.
+   */
+  void flush();
+
 private:
   void doLog(LogLevel level, const std::string& message) override;
   void doLog(LogLevel level, const QString& message) override;
 
+  void writeMessages();
+
   deleteCopyAndMove(FileLogger);
 };
 } // namespace TrenchBroom
@@ -20,6 +20,7 @@
 #include "AseParser.h"
 
 #include "Assets/EntityModel.h"
+#include "Assets/SkinCache.h"
 #include "Assets/Texture.h"
 #include "IO/FileSystem.h"
 #include "IO/ReadFreeImageTexture.h"
@@ -123,10 +124,15 @@ Tokenizer<unsigned int>::Token AseTokenizer::emitToken()
   return Token{AseToken::Eof, nullptr, nullptr, length(), line(), column()};
 }
 
-AseParser::AseParser(std::string name, const std::string_view str, const FileSystem& fs)
+AseParser::AseParser(
+  std::string name,
+  const std::string_view str,
+  const FileSystem& fs,
+  Assets::SkinCache* skinCache)
   : m_name{std::move(name)}
   , m_tokenizer{str}
   , m_fs{fs}
+  , m_skinCache{skinCache}
 {
 }
 
@@ -666,14 +672,14 @@ std::unique_ptr<Assets::EntityModel> AseParser::buildModel(
   auto& surface = model->addSurface(m_name);
 
   // Load the textures
-  auto textures = std::vector<Assets::Texture>{};
+  auto textures = std::vector<std::shared_ptr<Assets::TextureCollection>>{};
   textures.reserve(scene.materialPaths.size());
   for (const auto& path : scene.materialPaths)
   {
     textures.push_back(loadTexture(logger, path));
   }
 
-  textures.push_back(loadDefaultTexture(m_fs, "", logger));
+  textures.push_back(Assets::makeSharedSkin(loadDefaultTexture(m_fs, "", logger)));
   surface.setSkins(std::move(textures));
 
   // Count vertices and build bounds
@@ -764,11 +770,11 @@ bool AseParser::checkIndices(Logger& logger, const MeshFace& face, const Mesh& m
   return true;
 }
 
-Assets::Texture AseParser::loadTexture(
+std::shared_ptr<Assets::TextureCollection> AseParser::loadTexture(
   Logger& logger, const std::filesystem::path& path) const
 {
   const auto actualPath = fixTexturePath(logger, path);
-  return loadShader(actualPath, m_fs, logger);
+  return loadShader(actualPath, m_fs, m_skinCache, logger);
 }
 
 std::filesystem::path AseParser::fixTexturePath(
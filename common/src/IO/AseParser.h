@@ -28,6 +28,7 @@
 #include <array>
 #include <filesystem>
 #include <functional>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -39,7 +40,8 @@ class Logger;
 namespace Assets
 {
 class EntityModel;
-class Texture;
+class SkinCache;
+class TextureCollection;
 } // namespace Assets
 
 namespace IO
@@ -114,6 +116,7 @@ private:
   std::string m_name;
   AseTokenizer m_tokenizer;
   const FileSystem& m_fs;
+  Assets::SkinCache* m_skinCache;
 
 public:
   /**
@@ -122,8 +125,13 @@ public:
    * @param name the name of the model
    * @param str the text to parse
    * @param fs the file system used to load texture files
+   * @param skinCache the cache used to share textures with other models, if any
    */
-  AseParser(std::string name, std::string_view str, const FileSystem& fs);
+  AseParser(
+    std::string name,
+    std::string_view str,
+    const FileSystem& fs,
+    Assets::SkinCache* skinCache = nullptr);
 
   static bool canParse(const std::filesystem::path& path);
 
@@ -186,7 +194,8 @@ private: // model construction
     Logger& logger, const Scene& scene) const;
   bool checkIndices(Logger& logger, const MeshFace& face, const Mesh& mesh) const;
 
-  Assets::Texture loadTexture(Logger& logger, const std::filesystem::path& path) const;
+  std::shared_ptr<Assets::TextureCollection> loadTexture(
+    Logger& logger, const std::filesystem::path& path) const;
   std::filesystem::path fixTexturePath(Logger& logger, std::filesystem::path path) const;
 };
 } // namespace IO
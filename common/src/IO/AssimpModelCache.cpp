@@ -0,0 +1,333 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AssimpModelCache.h"
+
+#include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/File.h"
+#include "IO/FileSystem.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Macros.h"
+
+#include "kdl/reflection_impl.h"
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox_io.h"
+#include "vm/vec.h"
+#include "vm/vec_io.h"
+
+#include <fmt/format.h>
+
+#include <ostream>
+#include <type_traits>
+
+namespace TrenchBroom::IO
+{
+
+kdl_reflect_impl(AssimpSkinData);
+
+std::ostream& operator<<(std::ostream& lhs, const AssimpSkinData::Source& rhs)
+{
+  switch (rhs)
+  {
+  case AssimpSkinData::Source::File:
+    lhs << "File";
+    break;
+  case AssimpSkinData::Source::Embedded:
+    lhs << "Embedded";
+    break;
+  case AssimpSkinData::Source::CompressedEmbedded:
+    lhs << "CompressedEmbedded";
+    break;
+  case AssimpSkinData::Source::Fallback:
+    lhs << "Fallback";
+    break;
+    switchDefault();
+  }
+  return lhs;
+}
+
+kdl_reflect_impl(AssimpSurfaceData);
+
+kdl_reflect_impl(AssimpMeshData);
+
+kdl_reflect_impl(AssimpFrameData);
+
+kdl_reflect_impl(AssimpModelData);
+
+namespace
+{
+constexpr auto Magic = std::string_view{"TBAC"};
+
+// must be incremented whenever the format of the cache changes
+constexpr auto Version = uint32_t(1);
+
+void writeSkin(CacheWriter& writer, const AssimpSkinData& skin)
+{
+  writer.write(skin.source);
+  writer.writeString(skin.name);
+  writer.writeSize(skin.width);
+  writer.writeSize(skin.height);
+  writer.writeString(std::string_view{
+    reinterpret_cast<const char*>(skin.data.data()), skin.data.size()});
+}
+
+void writeSurface(CacheWriter& writer, const AssimpSurfaceData& surface)
+{
+  writer.writeString(surface.name);
+  writer.writeSize(surface.skins.size());
+  for (const auto& skin : surface.skins)
+  {
+    writeSkin(writer, skin);
+  }
+}
+
+void writeFrame(CacheWriter& writer, const std::optional<AssimpFrameData>& frame)
+{
+  writer.write(uint8_t(frame ? 1 : 0));
+  if (frame)
+  {
+    writer.writeVec(frame->bounds.min);
+    writer.writeVec(frame->bounds.max);
+    writer.writeSize(frame->meshes.size());
+    for (const auto& mesh : frame->meshes)
+    {
+      writer.writeSize(mesh.surfaceIndex);
+      writer.writeSize(mesh.vertices.size());
+      for (const auto& vertex : mesh.vertices)
+      {
+        writer.writeVec(Renderer::getVertexComponent<0>(vertex));
+        writer.writeVec(Renderer::getVertexComponent<1>(vertex));
+      }
+    }
+  }
+}
+
+AssimpSkinData readSkin(Reader& reader)
+{
+  const auto source = read<std::underlying_type_t<AssimpSkinData::Source>>(reader);
+  if (source > uint8_t(AssimpSkinData::Source::Fallback))
+  {
+    throw ReaderException{"Invalid skin source " + std::to_string(source)};
+  }
+
+  auto name = readString(reader);
+  const auto width = readSize(reader);
+  const auto height = readSize(reader);
+
+  auto data = std::vector<unsigned char>(readCount(reader, 1));
+  reader.read(data.data(), data.size());
+
+  // embedded textures consist of four byte BGRA texels
+  if (
+    static_cast<AssimpSkinData::Source>(source) == AssimpSkinData::Source::Embedded
+    && data.size() != width * height * 4)
+  {
+    throw ReaderException{"Invalid embedded texture size"};
+  }
+
+  return {
+    static_cast<AssimpSkinData::Source>(source),
+    std::move(name),
+    width,
+    height,
+    std::move(data)};
+}
+
+AssimpSurfaceData readSurface(Reader& reader)
+{
+  auto name = readString(reader);
+
+  auto skins = std::vector<AssimpSkinData>{};
+  const auto skinCount = readCount(reader, 25);
+  skins.reserve(skinCount);
+  for (size_t i = 0; i < skinCount; ++i)
+  {
+    skins.push_back(readSkin(reader));
+  }
+
+  return {std::move(name), std::move(skins)};
+}
+
+std::optional<AssimpFrameData> readFrame(Reader& reader, const size_t surfaceCount)
+{
+  if (!reader.readBool<uint8_t>())
+  {
+    return std::nullopt;
+  }
+
+  const auto min = reader.readVec<float, 3>();
+  const auto max = reader.readVec<float, 3>();
+
+  auto meshes = std::vector<AssimpMeshData>{};
+  const auto meshCount = readCount(reader, 16);
+  meshes.reserve(meshCount);
+  for (size_t i = 0; i < meshCount; ++i)
+  {
+    const auto surfaceIndex = readSize(reader);
+    if (surfaceIndex >= surfaceCount)
+    {
+      throw ReaderException{"Invalid surface index " + std::to_string(surfaceIndex)};
+    }
+
+    const auto vertexCount = readCount(reader, 5 * sizeof(float));
+    if (vertexCount % 3 != 0)
+    {
+      throw ReaderException{"Invalid vertex count " + std::to_string(vertexCount)};
+    }
+
+    auto vertices = std::vector<Assets::EntityModelVertex>{};
+    vertices.reserve(vertexCount);
+    for (size_t j = 0; j < vertexCount; ++j)
+    {
+      const auto position = reader.readVec<float, 3>();
+      const auto uv = reader.readVec<float, 2>();
+      vertices.emplace_back(position, uv);
+    }
+
+    meshes.push_back({surfaceIndex, std::move(vertices)});
+  }
+
+  return AssimpFrameData{vm::bbox3f{min, max}, std::move(meshes)};
+}
+
+/**
+ * Identifies the current contents of the file at the given path.
+ */
+Result<std::string> fileStamp(const std::filesystem::path& path, const FileSystem& fs)
+{
+  return fs.openFile(path).transform([&](auto file) {
+    const auto reader = file->reader().buffer();
+    return fmt::format(
+      "{} {} {:016x}", path.u8string(), file->size(), kdl::str_hash(reader.stringView()));
+  });
+}
+
+Result<std::string> dependencyStamps(
+  const std::vector<std::filesystem::path>& dependencies, const FileSystem& fs)
+{
+  return kdl::fold_results(kdl::vec_transform(
+                             dependencies,
+                             [&](const auto& path) { return fileStamp(path, fs); }))
+    .transform([](const auto& stamps) { return kdl::str_join(stamps, "\n"); });
+}
+} // namespace
+
+std::filesystem::path assimpModelCachePath(
+  const std::filesystem::path& cacheDirectory, const std::filesystem::path& modelPath)
+{
+  return cacheDirectory
+         / fmt::format("{:016x}.tbac", kdl::str_hash(modelPath.u8string()));
+}
+
+Result<std::string> assimpModelCacheKey(
+  const std::filesystem::path& modelPath,
+  const FileSystem& fs,
+  const unsigned int importFlags)
+{
+  return fileStamp(modelPath, fs).transform([&](const auto& stamp) {
+    return fmt::format("{} {:08x}", stamp, importFlags);
+  });
+}
+
+Result<void> writeAssimpModelCache(
+  const AssimpModelData& modelData,
+  const std::string_view key,
+  const FileSystem& fs,
+  std::ostream& stream)
+{
+  return dependencyStamps(modelData.dependencies, fs).transform([&](const auto& stamps) {
+    auto writer = CacheWriter{stream};
+    writer.writeHeader(Magic, Version);
+    writer.writeString(key);
+
+    writer.writeSize(modelData.dependencies.size());
+    for (const auto& path : modelData.dependencies)
+    {
+      writer.writeString(path.u8string());
+    }
+    writer.writeString(stamps);
+
+    writer.writeSize(modelData.surfaces.size());
+    for (const auto& surface : modelData.surfaces)
+    {
+      writeSurface(writer, surface);
+    }
+
+    writer.writeSize(modelData.frames.size());
+    for (const auto& frame : modelData.frames)
+    {
+      writeFrame(writer, frame);
+    }
+  });
+}
+
+Result<AssimpModelData> readAssimpModelCache(
+  Reader reader, const std::string_view key, const FileSystem& fs)
+{
+  return readCacheHeader(reader, Magic, Version, key, "Assimp model cache")
+    .and_then([&]() -> Result<AssimpModelData> {
+      try
+      {
+        auto dependencies = std::vector<std::filesystem::path>{};
+        const auto dependencyCount = readCount(reader, 8);
+        dependencies.reserve(dependencyCount);
+        for (size_t i = 0; i < dependencyCount; ++i)
+        {
+          dependencies.push_back(std::filesystem::u8path(readString(reader)));
+        }
+
+        const auto stamps = readString(reader);
+        if (dependencyStamps(dependencies, fs).value_or("") != stamps)
+        {
+          return Error{"Outdated Assimp model cache"};
+        }
+
+        auto surfaces = std::vector<AssimpSurfaceData>{};
+        const auto surfaceCount = readCount(reader, 16);
+        surfaces.reserve(surfaceCount);
+        for (size_t i = 0; i < surfaceCount; ++i)
+        {
+          surfaces.push_back(readSurface(reader));
+        }
+
+        auto frames = std::vector<std::optional<AssimpFrameData>>{};
+        const auto frameCount = readCount(reader, 1);
+        frames.reserve(frameCount);
+        for (size_t i = 0; i < frameCount; ++i)
+        {
+          frames.push_back(readFrame(reader, surfaceCount));
+        }
+
+        return AssimpModelData{
+          std::move(surfaces), std::move(frames), std::move(dependencies)};
+      }
+      catch (const ReaderException& e)
+      {
+        return Error{"Malformed Assimp model cache: " + std::string{e.what()}};
+      }
+    });
+}
+
+} // namespace TrenchBroom::IO
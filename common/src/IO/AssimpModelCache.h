@@ -0,0 +1,164 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Assets/EntityModel_Forward.h"
+#include "Result.h"
+
+#include "kdl/reflection_decl.h"
+
+#include "vm/bbox.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom::IO
+{
+class FileSystem;
+class Reader;
+
+/**
+ * Describes where the texture of a skin of a model imported by Assimp comes from. The
+ * texture itself is not converted, it is loaded from this description whenever the model
+ * is loaded.
+ */
+struct AssimpSkinData
+{
+  enum class Source : uint8_t
+  {
+    /** The texture is loaded from the file at the path given by name. */
+    File,
+    /** The texture is embedded in the model as uncompressed BGRA texels. */
+    Embedded,
+    /** The texture is embedded in the model as a compressed image file. */
+    CompressedEmbedded,
+    /** The material has no texture, and name is the name of the material. */
+    Fallback,
+  };
+
+  Source source;
+  std::string name;
+  size_t width = 0;
+  size_t height = 0;
+  std::vector<unsigned char> data;
+
+  kdl_reflect_decl(AssimpSkinData, source, name, width, height, data);
+};
+
+std::ostream& operator<<(std::ostream& lhs, const AssimpSkinData::Source& rhs);
+
+struct AssimpSurfaceData
+{
+  std::string name;
+  std::vector<AssimpSkinData> skins;
+
+  kdl_reflect_decl(AssimpSurfaceData, name, skins);
+};
+
+/**
+ * The triangles of a surface in a frame. Every three consecutive vertices form a
+ * triangle.
+ */
+struct AssimpMeshData
+{
+  size_t surfaceIndex;
+  std::vector<Assets::EntityModelVertex> vertices;
+
+  kdl_reflect_decl(AssimpMeshData, surfaceIndex, vertices);
+};
+
+struct AssimpFrameData
+{
+  vm::bbox3f bounds;
+  std::vector<AssimpMeshData> meshes;
+
+  kdl_reflect_decl(AssimpFrameData, bounds, meshes);
+};
+
+/**
+ * The result of converting a scene imported by Assimp. A frame is empty if the scene
+ * has no vertices for it.
+ */
+struct AssimpModelData
+{
+  std::vector<AssimpSurfaceData> surfaces;
+  std::vector<std::optional<AssimpFrameData>> frames;
+
+  /**
+   * The paths of the files other than the model file itself that were read when
+   * importing the scene, e.g. material libraries.
+   */
+  std::vector<std::filesystem::path> dependencies;
+
+  kdl_reflect_decl(AssimpModelData, surfaces, frames, dependencies);
+};
+
+/**
+ * An Assimp model cache is a binary file that stores the converted surfaces and frames of
+ * a model imported by Assimp, so that loading the model again skips the import.
+ *
+ * A cache is identified by a key which is computed from the contents of the model file
+ * and the import settings. Additionally, the cache records the contents of the other
+ * files read by the importer, and it is only used if none of them have changed.
+ */
+
+/**
+ * Returns the path of the cache file for the model at the given path in the given cache
+ * directory.
+ */
+std::filesystem::path assimpModelCachePath(
+  const std::filesystem::path& cacheDirectory, const std::filesystem::path& modelPath);
+
+/**
+ * Computes the key of a cache for the model at the given path when imported with the
+ * given Assimp post processing flags.
+ *
+ * Returns an error if the model file cannot be opened.
+ */
+Result<std::string> assimpModelCacheKey(
+  const std::filesystem::path& modelPath, const FileSystem& fs, unsigned int importFlags);
+
+/**
+ * Writes the given model data to the given stream, which must be opened in binary mode.
+ * The dependencies of the model data are read from the given file system.
+ *
+ * Returns an error if a dependency cannot be opened.
+ */
+Result<void> writeAssimpModelCache(
+  const AssimpModelData& modelData,
+  std::string_view key,
+  const FileSystem& fs,
+  std::ostream& stream);
+
+/**
+ * Reads model data from the given reader. Returns an error if the cache is malformed, if
+ * its key does not match the given key, or if one of the recorded dependencies has
+ * changed in the given file system.
+ */
+Result<AssimpModelData> readAssimpModelCache(
+  Reader reader, std::string_view key, const FileSystem& fs);
+
+} // namespace TrenchBroom::IO
@@ -23,15 +23,19 @@
 
 #include "Assets/EntityModel.h"
 #include "Assets/Texture.h"
+#include "IO/AssimpModelCache.h"
+#include "IO/CacheIO.h"
+#include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/FileSystem.h"
 #include "IO/PathInfo.h"
 #include "IO/ReadFreeImageTexture.h"
 #include "IO/ResourceUtils.h"
 #include "Logger.h"
+#include "Macros.h"
 #include "Model/BrushFaceAttributes.h"
 #include "ReaderException.h"
-#include "Renderer/IndexRangeMapBuilder.h"
+#include "Renderer/IndexRangeMap.h"
 #include "Renderer/PrimType.h"
 
 #include "kdl/path_utils.h"
@@ -48,6 +52,8 @@
 #include <assimp/types.h>
 #include <fmt/format.h>
 
+#include <cassert>
+#include <cstring>
 #include <optional>
 #include <string_view>
 #include <utility>
@@ -58,6 +64,10 @@ namespace TrenchBroom::IO
 namespace
 {
 
+constexpr auto AssimpFlags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices
+                             | aiProcess_FlipWindingOrder | aiProcess_SortByPType
+                             | aiProcess_FlipUVs;
+
 class AssimpIOStream : public Assimp::IOStream
 {
   friend class AssimpIOSystem;
@@ -127,10 +137,16 @@ class AssimpIOSystem : public Assimp::IOSystem
 {
 private:
   const FileSystem& m_fs;
+  std::vector<std::filesystem::path>* m_openedPaths;
 
 public:
-  explicit AssimpIOSystem(const FileSystem& fs)
+  /**
+   * If openedPaths is not null, the paths of all files opened by Assimp are added to it.
+   */
+  explicit AssimpIOSystem(
+    const FileSystem& fs, std::vector<std::filesystem::path>* openedPaths = nullptr)
     : m_fs{fs}
+    , m_openedPaths{openedPaths}
   {
   }
 
@@ -153,6 +169,11 @@ public:
       throw ParserException{"Assimp attempted to open a file not for reading."};
     }
 
+    if (m_openedPaths)
+    {
+      m_openedPaths->emplace_back(path);
+    }
+
     return m_fs.openFile(path)
       .transform(
         [](auto file) { return std::make_unique<AssimpIOStream>(std::move(file)); })
@@ -204,10 +225,15 @@ Assets::Texture loadTextureFromFileSystem(
 }
 
 Assets::Texture loadUncompressedEmbeddedTexture(
-  std::string name, const aiTexel& data, const size_t width, const size_t height)
+  std::string name,
+  const std::vector<unsigned char>& data,
+  const size_t width,
+  const size_t height)
 {
-  auto buffer = Assets::TextureBuffer{width * height * sizeof(aiTexel)};
-  std::memcpy(buffer.data(), &data, width * height * sizeof(aiTexel));
+  assert(data.size() == width * height * sizeof(aiTexel));
+
+  auto buffer = Assets::TextureBuffer{data.size()};
+  std::memcpy(buffer.data(), data.data(), data.size());
 
   const auto averageColor = getAverageColor(buffer, GL_BGRA);
   return {
@@ -222,51 +248,79 @@ Assets::Texture loadUncompressedEmbeddedTexture(
 
 Assets::Texture loadCompressedEmbeddedTexture(
   std::string name,
-  const aiTexel& data,
-  const size_t size,
+  const std::vector<unsigned char>& data,
   const FileSystem& fs,
   Logger& logger)
 {
-  return readFreeImageTextureFromMemory(
-           std::move(name), reinterpret_cast<const uint8_t*>(&data), size)
+  return readFreeImageTextureFromMemory(std::move(name), data.data(), data.size())
     .or_else(makeReadTextureErrorHandler(fs, logger))
     .value();
 }
 
-Assets::Texture loadTexture(
-  const aiTexture* texture,
-  const std::filesystem::path& texturePath,
+Assets::Texture loadSkin(
+  const AssimpSkinData& skin,
   const std::filesystem::path& modelPath,
   const FileSystem& fs,
   Logger& logger)
+{
+  switch (skin.source)
+  {
+  case AssimpSkinData::Source::File:
+    return loadTextureFromFileSystem(std::filesystem::u8path(skin.name), fs, logger);
+  case AssimpSkinData::Source::Embedded:
+    return loadUncompressedEmbeddedTexture(skin.name, skin.data, skin.width, skin.height);
+  case AssimpSkinData::Source::CompressedEmbedded:
+    return loadCompressedEmbeddedTexture(skin.name, skin.data, fs, logger);
+  case AssimpSkinData::Source::Fallback:
+    logger.error(fmt::format(
+      "No diffuse textures found for material {} of model '{}', loading fallback texture",
+      skin.name,
+      modelPath.string()));
+    return loadFallbackOrDefaultTexture(fs, skin.name, logger);
+    switchDefault();
+  }
+}
+
+AssimpSkinData getSkin(
+  const aiTexture* texture,
+  const std::filesystem::path& texturePath,
+  const std::filesystem::path& modelPath)
 {
   if (!texture)
   {
     // The texture is not embedded. Load it using the file system.
     const auto filePath = modelPath.parent_path() / texturePath;
-    return loadTextureFromFileSystem(filePath, fs, logger);
+    return {AssimpSkinData::Source::File, filePath.u8string(), 0, 0, {}};
   }
 
+  const auto* data = reinterpret_cast<const unsigned char*>(texture->pcData);
   if (texture->mHeight != 0)
   {
     // The texture is uncompressed, load it directly.
-    return loadUncompressedEmbeddedTexture(
-      texture->mFilename.C_Str(), *texture->pcData, texture->mWidth, texture->mHeight);
+    const auto size = size_t(texture->mWidth) * texture->mHeight * sizeof(aiTexel);
+    return {
+      AssimpSkinData::Source::Embedded,
+      texture->mFilename.C_Str(),
+      texture->mWidth,
+      texture->mHeight,
+      std::vector<unsigned char>(data, data + size)};
   }
 
   // The texture is embedded, but compressed. Let FreeImage load it from memory.
-  return loadCompressedEmbeddedTexture(
-    texture->mFilename.C_Str(), *texture->pcData, texture->mWidth, fs, logger);
+  return {
+    AssimpSkinData::Source::CompressedEmbedded,
+    texture->mFilename.C_Str(),
+    0,
+    0,
+    std::vector<unsigned char>(data, data + texture->mWidth)};
 }
 
-std::vector<Assets::Texture> loadTexturesForMaterial(
+std::vector<AssimpSkinData> getSkinsForMaterial(
   const aiScene& scene,
   const size_t materialIndex,
-  const std::filesystem::path& modelPath,
-  const FileSystem& fs,
-  Logger& logger)
+  const std::filesystem::path& modelPath)
 {
-  auto textures = std::vector<Assets::Texture>{};
+  auto skins = std::vector<AssimpSkinData>{};
 
   // Is there even a single diffuse texture? If not, fail and load fallback material.
   const auto textureCount =
@@ -281,32 +335,36 @@ std::vector<Assets::Texture> loadTexturesForMaterial(
 
       const auto texturePath = std::filesystem::path{path.C_Str()};
       const auto* texture = scene.GetEmbeddedTexture(path.C_Str());
-      textures.push_back(loadTexture(texture, texturePath, modelPath, fs, logger));
+      skins.push_back(getSkin(texture, texturePath, modelPath));
     }
   }
   else
   {
-    logger.error(fmt::format(
-      "No diffuse textures found for material {} of model '{}', loading fallback texture",
-      materialIndex,
-      modelPath.string()));
-
     // Materials aren't guaranteed to have a name.
     const auto materialName = scene.mMaterials[materialIndex]->GetName() != aiString{""}
                                 ? scene.mMaterials[materialIndex]->GetName().C_Str()
                                 : "nr. " + std::to_string(materialIndex + 1);
-    textures.push_back(loadFallbackOrDefaultTexture(fs, materialName, logger));
+    skins.push_back({AssimpSkinData::Source::Fallback, materialName, 0, 0, {}});
   }
 
-  return textures;
+  return skins;
 }
 
-struct AssimpComputedMeshData
+std::vector<AssimpSurfaceData> getSurfaces(
+  const aiScene& scene, const std::filesystem::path& modelPath)
 {
-  size_t m_meshIndex;
-  std::vector<Assets::EntityModelVertex> m_vertices;
-  Assets::EntityModelIndices m_indices;
-};
+  // an assimp mesh will only ever have one material, but a material can have multiple
+  // alternatives (this is how assimp handles skins)
+  auto surfaces = std::vector<AssimpSurfaceData>{};
+  surfaces.reserve(scene.mNumMeshes);
+  for (size_t i = 0; i < scene.mNumMeshes; ++i)
+  {
+    const auto& mesh = *scene.mMeshes[i];
+    surfaces.push_back(
+      {mesh.mName.data, getSkinsForMaterial(scene, mesh.mMaterialIndex, modelPath)});
+  }
+  return surfaces;
+}
 
 struct AssimpBoneInformation
 {
@@ -688,11 +746,8 @@ aiMatrix4x4 getAxisTransform(const aiScene& scene)
   return aiMatrix4x4{};
 }
 
-Result<void> loadSceneFrame(
-  const aiScene& scene,
-  const size_t frameIndex,
-  Assets::EntityModel& model,
-  const std::string& name)
+std::optional<AssimpFrameData> convertSceneFrame(
+  const aiScene& scene, const size_t frameIndex)
 {
   // load the animation information for the current "frame" (animation)
   const auto boneTransforms =
@@ -713,7 +768,7 @@ Result<void> loadSceneFrame(
 
   // store the mesh data in a list so we can compute the bounding box before creating the
   // frame
-  auto meshData = std::vector<AssimpComputedMeshData>{};
+  auto meshData = std::vector<AssimpMeshData>{};
   auto bounds = vm::bbox3f::builder{};
 
   for (const auto& mesh : meshes)
@@ -730,12 +785,9 @@ Result<void> loadSceneFrame(
 
       // build the mesh faces as triangles
       const auto numTriangles = mesh.m_mesh->mNumFaces;
-      const auto numIndices = numTriangles * 3;
 
-      auto size = Renderer::IndexRangeMap::Size{};
-      size.inc(Renderer::PrimType::Triangles, numTriangles);
-      auto builder =
-        Renderer::IndexRangeMapBuilder<Assets::EntityModelVertex::Type>{numIndices, size};
+      auto triangles = std::vector<Assets::EntityModelVertex>{};
+      triangles.reserve(numTriangles * 3);
 
       for (unsigned int i = 0; i < numTriangles; ++i)
       {
@@ -744,44 +796,188 @@ Result<void> loadSceneFrame(
         // ignore anything that's not a triangle
         if (face.mNumIndices == 3)
         {
-          builder.addTriangle(
-            vertices[face.mIndices[0]],
-            vertices[face.mIndices[1]],
-            vertices[face.mIndices[2]]);
+          triangles.push_back(vertices[face.mIndices[0]]);
+          triangles.push_back(vertices[face.mIndices[1]]);
+          triangles.push_back(vertices[face.mIndices[2]]);
         }
       }
 
-      meshData.push_back({*meshIndex, builder.vertices(), builder.indices()});
+      meshData.push_back({*meshIndex, std::move(triangles)});
     }
   }
 
   if (!bounds.initialized())
   {
     // passing empty bounds as bbox crashes the program, don't let it happen
-    return Error{"Model has no vertices. (So no valid bounding box.)"};
+    return std::nullopt;
   }
 
+  return AssimpFrameData{bounds.bounds(), std::move(meshData)};
+}
+
+/**
+ * Imports the model at the given path. If dependencies is not null, the paths of the
+ * files that were read by Assimp, except for the model file itself, are added to it.
+ */
+const aiScene& importScene(
+  Assimp::Importer& importer,
+  const std::filesystem::path& path,
+  const FileSystem& fs,
+  std::vector<std::filesystem::path>* dependencies = nullptr)
+{
+  auto openedPaths = std::vector<std::filesystem::path>{};
+  importer.SetIOHandler(new AssimpIOSystem{fs, dependencies ? &openedPaths : nullptr});
+
+  const auto* scene = importer.ReadFile(path.string(), AssimpFlags);
+  if (!scene)
+  {
+    throw ParserException{fmt::format(
+      "Assimp couldn't import model from '{}': {}",
+      path.string(),
+      importer.GetErrorString())};
+  }
+
+  if (dependencies)
+  {
+    openedPaths = kdl::vec_erase(std::move(openedPaths), path);
+    *dependencies = kdl::vec_sort_and_remove_duplicates(std::move(openedPaths));
+  }
+
+  return *scene;
+}
+
+size_t getFrameCount(const aiScene& scene)
+{
+  // create a frame for each animation in the scene
+  // if we have no animations, always load 1 frame for the reference model
+  return std::max(scene.mNumAnimations, 1u);
+}
+
+AssimpModelData convertScene(const aiScene& scene, const std::filesystem::path& path)
+{
+  auto frames = std::vector<std::optional<AssimpFrameData>>{};
+  const auto frameCount = getFrameCount(scene);
+  frames.reserve(frameCount);
+  for (size_t i = 0; i < frameCount; ++i)
+  {
+    frames.push_back(convertSceneFrame(scene, i));
+  }
+
+  return {getSurfaces(scene, path), std::move(frames), {}};
+}
+
+std::unique_ptr<Assets::EntityModel> createModel(
+  const std::filesystem::path& path,
+  const std::vector<AssimpSurfaceData>& surfaces,
+  const size_t frameCount,
+  const FileSystem& fs,
+  Logger& logger)
+{
+  auto model = std::make_unique<Assets::EntityModel>(
+    path.string(), Assets::PitchType::Normal, Assets::Orientation::Oriented);
+
+  for (size_t i = 0; i < frameCount; ++i)
+  {
+    model->addFrame();
+  }
+
+  // create a surface for each mesh in the scene and assign the skins/materials to it
+  for (const auto& surfaceData : surfaces)
+  {
+    auto& surface = model->addSurface(surfaceData.name);
+    surface.setSkins(kdl::vec_transform(surfaceData.skins, [&](const auto& skin) {
+      return loadSkin(skin, path, fs, logger);
+    }));
+  }
+
+  return model;
+}
+
+void buildFrame(
+  Assets::EntityModel& model,
+  const size_t frameIndex,
+  const AssimpFrameData& frameData,
+  const std::string& name)
+{
   // we've processed the model, now we can create the frame and bind the meshes to it
-  const auto frameBounds = bounds.bounds();
-  auto& frame = model.loadFrame(frameIndex, name, frameBounds);
+  auto& frame = model.loadFrame(frameIndex, name, frameData.bounds);
 
-  for (const auto& data : meshData)
+  for (const auto& mesh : frameData.meshes)
   {
-    auto& surface = model.surface(data.m_meshIndex);
-    surface.addIndexedMesh(frame, data.m_vertices, data.m_indices);
+    auto& surface = model.surface(mesh.surfaceIndex);
+    auto indices = mesh.vertices.empty()
+                     ? Assets::EntityModelIndices{}
+                     : Assets::EntityModelIndices{
+                       Renderer::PrimType::Triangles, 0, mesh.vertices.size()};
+    surface.addIndexedMesh(frame, mesh.vertices, std::move(indices));
   }
+}
 
-  return Result<void>{};
+/**
+ * Reads the converted model from its cache if the cache is up to date. Otherwise, the
+ * model is imported and converted, and the cache is written.
+ */
+AssimpModelData loadModelData(
+  const std::filesystem::path& path,
+  const FileSystem& fs,
+  const std::filesystem::path& cacheDirectory,
+  Logger& logger)
+{
+  const auto cachePath = assimpModelCachePath(cacheDirectory, path);
+  const auto cacheKey = assimpModelCacheKey(path, fs, AssimpFlags).value_or("");
+  if (!cacheKey.empty() && Disk::pathInfo(cachePath) == PathInfo::File)
+  {
+    if (
+      auto cachedData =
+        Disk::mapFile(cachePath)
+          .and_then([&](auto cacheFile) {
+            return readAssimpModelCache(cacheFile->reader(), cacheKey, fs);
+          })
+          .transform([](auto modelData) { return std::optional{std::move(modelData)}; })
+          .transform_error([&](auto e) -> std::optional<AssimpModelData> {
+            logger.debug() << "Could not load model cache " << cachePath << ": "
+                           << e.msg;
+            return std::nullopt;
+          })
+          .value())
+    {
+      logger.debug() << "Loaded model '" << path.string() << "' from cache "
+                     << cachePath;
+      return std::move(*cachedData);
+    }
+  }
+
+  auto importer = Assimp::Importer{};
+  auto dependencies = std::vector<std::filesystem::path>{};
+  auto modelData = convertScene(importScene(importer, path, fs, &dependencies), path);
+  modelData.dependencies = std::move(dependencies);
+
+  if (!cacheKey.empty())
+  {
+    writeCacheFile(
+      cachePath,
+      [&](auto& stream) {
+        return writeAssimpModelCache(modelData, cacheKey, fs, stream);
+      })
+      .transform_error([&](auto e) {
+        logger.warn() << "Could not write model cache " << cachePath << ": " << e.msg;
+      });
+  }
+
+  return modelData;
 }
 
 } // namespace
 
-AssimpParser::AssimpParser(std::filesystem::path path, const FileSystem& fs)
+AssimpParser::AssimpParser(
+  std::filesystem::path path,
+  const FileSystem& fs,
+  std::optional<std::filesystem::path> cacheDirectory)
   : m_path{std::move(path)}
   , m_fs{fs}
+  , m_cacheDirectory{std::move(cacheDirectory)}
 {
 }
-
 bool AssimpParser::canParse(const std::filesystem::path& path)
 {
   // clang-format off
@@ -807,83 +1003,54 @@ bool AssimpParser::canParse(const std::filesystem::path& path)
 std::unique_ptr<Assets::EntityModel> AssimpParser::doInitializeModel(
   TrenchBroom::Logger& logger)
 {
-  constexpr auto assimpFlags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices
-                               | aiProcess_FlipWindingOrder | aiProcess_SortByPType
-                               | aiProcess_FlipUVs;
-
-  const auto modelPath = m_path.string();
-
-  // Import the file as an Assimp scene and populate our vectors.
-  auto importer = Assimp::Importer{};
-  importer.SetIOHandler(new AssimpIOSystem{m_fs});
-
-  const auto* scene = importer.ReadFile(modelPath, assimpFlags);
-  if (!scene)
-  {
-    throw ParserException{fmt::format(
-      "Assimp couldn't import model from '{}': {}",
-      m_path.string(),
-      importer.GetErrorString())};
-  }
-
-  // Create model.
-  auto model = std::make_unique<Assets::EntityModel>(
-    modelPath, Assets::PitchType::Normal, Assets::Orientation::Oriented);
-
-  // create a frame for each animation in the scene
-  // if we have no animations, always load 1 frame for the reference model
-  const auto numSequences = std::max(scene->mNumAnimations, 1u);
-  for (size_t i = 0; i < numSequences; ++i)
+  if (m_cacheDirectory)
   {
-    model->addFrame();
-  }
-
-  // create a surface for each mesh in the scene and assign the skins/materials to it
-  const auto numMeshes = scene->mNumMeshes;
-  for (size_t i = 0; i < numMeshes; ++i)
-  {
-    const auto& mesh = scene->mMeshes[i];
-
-    auto& surface = model->addSurface(scene->mMeshes[i]->mName.data);
+    // the cache contains all frames, so they are loaded right away
+    const auto modelData = loadModelData(m_path, m_fs, *m_cacheDirectory, logger);
+    auto model =
+      createModel(m_path, modelData.surfaces, modelData.frames.size(), m_fs, logger);
 
-    // an assimp mesh will only ever have one material, but a material can have multiple
-    // alternatives (this is how assimp handles skins)
+    for (size_t i = 0; i < modelData.frames.size(); ++i)
+    {
+      if (modelData.frames[i])
+      {
+        buildFrame(*model, i, *modelData.frames[i], m_path.string());
+      }
+      else
+      {
+        logger.error() << "Assimp couldn't import frame " << i << " of model '"
+                       << m_path.string() << "': Model has no vertices.";
+      }
+    }
 
-    // load skins for this surface
-    surface.setSkins(
-      {loadTexturesForMaterial(*scene, mesh->mMaterialIndex, m_path, m_fs, logger)});
+    return model;
   }
 
-  return model;
+  // Import the file as an Assimp scene and populate our vectors.
+  auto importer = Assimp::Importer{};
+  const auto& scene = importScene(importer, m_path, m_fs);
+  return createModel(
+    m_path, getSurfaces(scene, m_path), getFrameCount(scene), m_fs, logger);
 }
 
 void AssimpParser::doLoadFrame(
   size_t frameIndex, Assets::EntityModel& model, Logger& /* logger */)
 {
-  constexpr auto assimpFlags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices
-                               | aiProcess_FlipWindingOrder | aiProcess_SortByPType
-                               | aiProcess_FlipUVs;
-
-  const auto modelPath = m_path.string();
-
   // Import the file as an Assimp scene and populate our vectors.
   auto importer = Assimp::Importer{};
-  importer.SetIOHandler(new AssimpIOSystem{m_fs});
+  const auto& scene = importScene(importer, m_path, m_fs);
 
-  const auto* scene = importer.ReadFile(modelPath, assimpFlags);
-  if (!scene)
+  // load the requested frame
+  const auto frameData = convertSceneFrame(scene, frameIndex);
+  if (!frameData)
   {
     throw ParserException{fmt::format(
-      "Assimp couldn't import model from '{}': {}",
-      m_path.string(),
-      importer.GetErrorString())};
+      "Assimp couldn't import model from '{}': Model has no vertices. (So no valid "
+      "bounding box.)",
+      m_path.string())};
   }
 
-  // load the requested frame
-  loadSceneFrame(*scene, frameIndex, model, modelPath).transform_error([&](auto e) {
-    throw ParserException{
-      fmt::format("Assimp couldn't import model from '{}': {}", m_path.string(), e.msg)};
-  });
+  buildFrame(model, frameIndex, *frameData, m_path.string());
 }
 
 } // namespace TrenchBroom::IO
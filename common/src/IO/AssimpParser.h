@@ -27,6 +27,7 @@
 #include <assimp/matrix4x4.h>
 
 #include <filesystem>
+#include <optional>
 
 struct aiNode;
 struct aiScene;
@@ -53,9 +54,19 @@ class AssimpParser : public EntityModelParser
 private:
   std::filesystem::path m_path;
   const FileSystem& m_fs;
+  std::optional<std::filesystem::path> m_cacheDirectory;
 
 public:
-  AssimpParser(std::filesystem::path path, const FileSystem& fs);
+  /**
+   * If a cache directory is given, the converted model is read from an Assimp model cache
+   * in that directory if it is up to date, and the cache is written after importing the
+   * model otherwise. Since the cache contains all frames, they are loaded when the model
+   * is initialized.
+   */
+  AssimpParser(
+    std::filesystem::path path,
+    const FileSystem& fs,
+    std::optional<std::filesystem::path> cacheDirectory = std::nullopt);
 
   static bool canParse(const std::filesystem::path& path);
 
@@ -0,0 +1,216 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BinaryNodeSerializer.h"
+
+#include "Color.h"
+#include "Model/BezierPatch.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/PatchNode.h"
+
+#include "vm/vec.h"
+
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace BinaryNodeFormat
+{
+
+std::optional<Model::MapFormat> readHeader(const std::string_view data)
+{
+  if (data.size() < headerSize() || data.substr(0, Magic.size()) != Magic)
+  {
+    return std::nullopt;
+  }
+
+  auto version = std::uint32_t(0);
+  auto format = std::uint32_t(0);
+  std::memcpy(&version, data.data() + Magic.size(), sizeof(version));
+  std::memcpy(&format, data.data() + Magic.size() + sizeof(version), sizeof(format));
+
+  if (
+    version != Version || format == std::uint32_t(Model::MapFormat::Unknown)
+    || format > std::uint32_t(Model::MapFormat::Quake3))
+  {
+    return std::nullopt;
+  }
+
+  return static_cast<Model::MapFormat>(format);
+}
+
+size_t headerSize()
+{
+  return Magic.size() + 2 * sizeof(std::uint32_t);
+}
+
+} // namespace BinaryNodeFormat
+
+namespace
+{
+template <typename T>
+void write(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write(std::ostream& stream, const BinaryNodeFormat::Tag tag)
+{
+  write(stream, static_cast<std::uint8_t>(tag));
+}
+
+void write(std::ostream& stream, const std::string& str)
+{
+  write(stream, static_cast<std::uint32_t>(str.size()));
+  stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+template <typename T, size_t S>
+void write(std::ostream& stream, const vm::vec<T, S>& vec)
+{
+  for (size_t i = 0; i < S; ++i)
+  {
+    write(stream, vec[i]);
+  }
+}
+} // namespace
+
+BinaryNodeSerializer::BinaryNodeSerializer(
+  const Model::MapFormat format, std::ostream& stream)
+  : m_format{format}
+  , m_stream{stream}
+{
+}
+
+void BinaryNodeSerializer::doBeginFile(const std::vector<const Model::Node*>&)
+{
+  m_stream.write(BinaryNodeFormat::Magic.data(), BinaryNodeFormat::Magic.size());
+  write(m_stream, BinaryNodeFormat::Version);
+  write(m_stream, static_cast<std::uint32_t>(m_format));
+}
+
+void BinaryNodeSerializer::doEndFile()
+{
+  write(m_stream, BinaryNodeFormat::Tag::End);
+}
+
+void BinaryNodeSerializer::doBeginEntity(const Model::Node*)
+{
+  write(m_stream, BinaryNodeFormat::Tag::BeginEntity);
+}
+
+void BinaryNodeSerializer::doEndEntity(const Model::Node*)
+{
+  write(m_stream, BinaryNodeFormat::Tag::EndEntity);
+}
+
+void BinaryNodeSerializer::doEntityProperty(const Model::EntityProperty& property)
+{
+  write(m_stream, BinaryNodeFormat::Tag::EntityProperty);
+  write(m_stream, property.key());
+  write(m_stream, property.value());
+}
+
+void BinaryNodeSerializer::doBrush(const Model::BrushNode* brushNode)
+{
+  const auto& faces = brushNode->brush().faces();
+
+  write(m_stream, BinaryNodeFormat::Tag::Brush);
+  write(m_stream, static_cast<std::uint32_t>(faces.size()));
+  for (const auto& face : faces)
+  {
+    writeFace(face);
+  }
+}
+
+void BinaryNodeSerializer::doBrushFace(const Model::BrushFace& face)
+{
+  write(m_stream, BinaryNodeFormat::Tag::BrushFace);
+  writeFace(face);
+}
+
+void BinaryNodeSerializer::doPatch(const Model::PatchNode* patchNode)
+{
+  const auto& patch = patchNode->patch();
+
+  write(m_stream, BinaryNodeFormat::Tag::Patch);
+  write(m_stream, static_cast<std::uint32_t>(patch.pointRowCount()));
+  write(m_stream, static_cast<std::uint32_t>(patch.pointColumnCount()));
+  write(m_stream, patch.textureName());
+  for (const auto& point : patch.controlPoints())
+  {
+    write(m_stream, point);
+  }
+}
+
+void BinaryNodeSerializer::writeFace(const Model::BrushFace& face)
+{
+  const auto& attributes = face.attributes();
+
+  for (const auto& point : face.points())
+  {
+    write(m_stream, point);
+  }
+
+  write(m_stream, attributes.textureName());
+  write(m_stream, attributes.offset());
+  write(m_stream, attributes.rotation());
+  write(m_stream, attributes.scale());
+
+  if (Model::isParallelTexCoordSystem(m_format))
+  {
+    write(m_stream, face.textureXAxis());
+    write(m_stream, face.textureYAxis());
+  }
+
+  auto flags = std::uint8_t(0);
+  if (attributes.hasSurfaceAttributes())
+  {
+    flags |= BinaryNodeFormat::HasSurfaceAttributes;
+  }
+  if (attributes.hasColor())
+  {
+    flags |= BinaryNodeFormat::HasColor;
+  }
+  write(m_stream, flags);
+
+  if (attributes.hasSurfaceAttributes())
+  {
+    write(m_stream, static_cast<std::int32_t>(face.resolvedSurfaceContents()));
+    write(m_stream, static_cast<std::int32_t>(face.resolvedSurfaceFlags()));
+    write(m_stream, face.resolvedSurfaceValue());
+  }
+  if (attributes.hasColor())
+  {
+    const auto color = face.resolvedColor();
+    write(m_stream, color.r());
+    write(m_stream, color.g());
+    write(m_stream, color.b());
+    write(m_stream, color.a());
+  }
+}
+
+} // namespace IO
+} // namespace TrenchBroom
@@ -0,0 +1,114 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/NodeSerializer.h"
+#include "Model/MapFormat.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class BrushNode;
+class BrushFace;
+class EntityProperty;
+class Node;
+class PatchNode;
+} // namespace Model
+
+namespace IO
+{
+/**
+ * The binary node format is used to transfer nodes between TrenchBroom instances via the
+ * clipboard. It stores the same information as the map file format, but numbers are
+ * stored in their native binary representation, so no precision is lost and writing and
+ * reading the data does not require formatting or tokenizing.
+ *
+ * The data starts with a header consisting of the magic string, the format version and
+ * the map format of the nodes. It is followed by a sequence of records, each of which
+ * starts with a tag. The data uses the native byte order since it never leaves the
+ * machine it was written on.
+ */
+namespace BinaryNodeFormat
+{
+constexpr auto Magic = std::string_view{"TBNODES\n"};
+constexpr std::uint32_t Version = 1;
+
+enum class Tag : std::uint8_t
+{
+  BeginEntity = 1,
+  EntityProperty = 2,
+  EndEntity = 3,
+  Brush = 4,
+  BrushFace = 5,
+  Patch = 6,
+  End = 7,
+};
+
+enum FaceFlags : std::uint8_t
+{
+  HasSurfaceAttributes = 1 << 0,
+  HasColor = 1 << 1,
+};
+
+/**
+ * Returns the map format of the given binary data, or nullopt if the given data does not
+ * start with a valid header.
+ */
+std::optional<Model::MapFormat> readHeader(std::string_view data);
+
+/**
+ * Returns the size of the header in bytes.
+ */
+size_t headerSize();
+} // namespace BinaryNodeFormat
+
+class BinaryNodeSerializer : public NodeSerializer
+{
+private:
+  Model::MapFormat m_format;
+  std::ostream& m_stream;
+
+public:
+  BinaryNodeSerializer(Model::MapFormat format, std::ostream& stream);
+
+private:
+  void doBeginFile(const std::vector<const Model::Node*>& rootNodes) override;
+  void doEndFile() override;
+
+  void doBeginEntity(const Model::Node* node) override;
+  void doEndEntity(const Model::Node* node) override;
+  void doEntityProperty(const Model::EntityProperty& property) override;
+  void doBrush(const Model::BrushNode* brushNode) override;
+  void doBrushFace(const Model::BrushFace& face) override;
+
+  void doPatch(const Model::PatchNode* patchNode) override;
+
+private:
+  void writeFace(const Model::BrushFace& face);
+};
+} // namespace IO
+} // namespace TrenchBroom
@@ -0,0 +1,145 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CacheIO.h"
+
+#include "IO/ReaderException.h"
+
+#include <fmt/format.h>
+
+#include <random>
+
+namespace TrenchBroom::IO
+{
+
+CacheWriter::CacheWriter(std::ostream& stream)
+  : m_stream{stream}
+{
+}
+
+void CacheWriter::writeHeader(const std::string_view magic, const uint32_t version)
+{
+  m_stream.write(magic.data(), std::streamsize(magic.size()));
+  write(version);
+}
+
+void CacheWriter::writeSize(const size_t value)
+{
+  write(uint64_t(value));
+}
+
+void CacheWriter::writeBool(const bool value)
+{
+  write(uint8_t(value ? 1 : 0));
+}
+
+void CacheWriter::writeBytes(const void* data, const size_t size)
+{
+  m_stream.write(reinterpret_cast<const char*>(data), std::streamsize(size));
+}
+
+void CacheWriter::writeString(const std::string_view str)
+{
+  writeSize(str.size());
+  writeBytes(str.data(), str.size());
+}
+
+Result<void> readCacheHeader(
+  Reader& reader,
+  const std::string_view magic,
+  const uint32_t version,
+  const std::string_view cacheName)
+{
+  try
+  {
+    if (reader.readString(magic.size()) != magic)
+    {
+      return Error{fmt::format("Not a valid {}", cacheName)};
+    }
+    if (read<uint32_t>(reader) != version)
+    {
+      return Error{fmt::format("Unsupported {} version", cacheName)};
+    }
+    return kdl::void_success;
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{fmt::format("Malformed {}: {}", cacheName, e.what())};
+  }
+}
+
+Result<void> readCacheHeader(
+  Reader& reader,
+  const std::string_view magic,
+  const uint32_t version,
+  const std::string_view key,
+  const std::string_view cacheName)
+{
+  return readCacheHeader(reader, magic, version, cacheName)
+    .and_then([&]() -> Result<void> {
+      try
+      {
+        if (readString(reader) != key)
+        {
+          return Error{fmt::format("Outdated {}", cacheName)};
+        }
+        return kdl::void_success;
+      }
+      catch (const ReaderException& e)
+      {
+        return Error{fmt::format("Malformed {}: {}", cacheName, e.what())};
+      }
+    });
+}
+
+size_t readSize(Reader& reader)
+{
+  return reader.readSize<uint64_t>();
+}
+
+size_t readCount(Reader& reader, const size_t minElementSize)
+{
+  const auto count = readSize(reader);
+  if (!reader.canRead(count * minElementSize))
+  {
+    throw ReaderException{"Invalid element count " + std::to_string(count)};
+  }
+  return count;
+}
+
+bool readBool(Reader& reader)
+{
+  return reader.readBool<uint8_t>();
+}
+
+std::string readString(Reader& reader)
+{
+  return reader.readString(readCount(reader, 1));
+}
+
+std::filesystem::path temporaryCachePath(const std::filesystem::path& path)
+{
+  // several threads or processes may write the same cache at once
+  thread_local auto random = std::mt19937_64{std::random_device{}()};
+  return path.parent_path()
+         / std::filesystem::u8path(
+           fmt::format("{}.{:016x}.tmp", path.filename().u8string(), random()));
+}
+
+} // namespace TrenchBroom::IO
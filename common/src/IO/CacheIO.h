@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Error.h"
+#include "IO/DiskIO.h"
+#include "IO/Reader.h"
+#include "Result.h"
+
+#include "kdl/result.h"
+
+#include "vm/vec.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace TrenchBroom::IO
+{
+
+/**
+ * Writes the binary data of a cache file. Every cache file starts with a header that
+ * consists of a magic string and a version, followed by the contents of the cache.
+ *
+ * Values are written in the native byte order, since a cache is only read on the machine
+ * where it was written.
+ */
+class CacheWriter
+{
+private:
+  std::ostream& m_stream;
+
+public:
+  explicit CacheWriter(std::ostream& stream);
+
+  void writeHeader(std::string_view magic, uint32_t version);
+
+  template <typename T>
+  void write(const T value)
+  {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+    m_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void writeSize(size_t value);
+  void writeBool(bool value);
+  void writeBytes(const void* data, size_t size);
+  void writeString(std::string_view str);
+
+  template <typename T, size_t S>
+  void writeVec(const vm::vec<T, S>& vec)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      write(vec[i]);
+    }
+  }
+
+  template <typename T, typename F>
+  void writeOptional(const std::optional<T>& value, const F& writeValue)
+  {
+    writeBool(value.has_value());
+    if (value)
+    {
+      writeValue(*value);
+    }
+  }
+};
+
+/**
+ * Reads the header of a cache file. Returns an error if the header is malformed or if its
+ * magic string or version do not match the given ones. The given cache name is used in
+ * the error messages.
+ */
+Result<void> readCacheHeader(
+  Reader& reader, std::string_view magic, uint32_t version, std::string_view cacheName);
+
+/**
+ * Reads the header of a cache file, followed by the key of the cache. Returns an error if
+ * the header cannot be read or if the key does not match the given key.
+ */
+Result<void> readCacheHeader(
+  Reader& reader,
+  std::string_view magic,
+  uint32_t version,
+  std::string_view key,
+  std::string_view cacheName);
+
+/*
+ * The following functions read the values written by CacheWriter. They throw a
+ * ReaderException if the cache is malformed.
+ */
+
+template <typename T>
+T read(Reader& reader)
+{
+  static_assert(std::is_arithmetic_v<T>);
+  return reader.read<T, T>();
+}
+
+size_t readSize(Reader& reader);
+
+/**
+ * Reads a number of elements and checks that the remaining data is large enough to
+ * contain them, so that a malformed cache cannot cause huge allocations.
+ */
+size_t readCount(Reader& reader, size_t minElementSize);
+
+bool readBool(Reader& reader);
+std::string readString(Reader& reader);
+
+template <typename F>
+auto readOptional(Reader& reader, const F& readValue)
+{
+  using T = decltype(readValue());
+  return readBool(reader) ? std::optional<T>{readValue()} : std::optional<T>{};
+}
+
+/**
+ * Returns a path for a temporary file next to the given cache file.
+ */
+std::filesystem::path temporaryCachePath(const std::filesystem::path& path);
+
+/**
+ * Writes a cache file by passing a binary output stream to the given function, which
+ * may return a Result<void>. The parent directory of the file is created if necessary.
+ *
+ * The cache is written to a temporary file which then replaces the file at the given
+ * path, so that a partially written cache file is never read.
+ */
+template <typename F>
+Result<void> writeCacheFile(const std::filesystem::path& path, const F& writeCache)
+{
+  const auto tempPath = temporaryCachePath(path);
+  return Disk::createDirectory(path.parent_path())
+    .and_then([&](auto) {
+      return Disk::withOutputStream(
+        tempPath,
+        std::ios_base::out | std::ios_base::trunc | std::ios_base::binary,
+        [&](std::ofstream& stream) -> Result<void> {
+          if constexpr (kdl::is_result_v<decltype(writeCache(stream))>)
+          {
+            if (auto result = writeCache(stream); result.is_error())
+            {
+              return result;
+            }
+          }
+          else
+          {
+            writeCache(stream);
+          }
+
+          stream.flush();
+          if (!stream)
+          {
+            return Error{"Could not write '" + tempPath.string() + "'"};
+          }
+          return kdl::void_success;
+        });
+    })
+    .and_then([&]() { return Disk::moveFile(tempPath, path); })
+    .or_else([&](auto e) {
+      // a missing temporary file is not an error
+      Disk::deleteFile(tempPath).value_or(false);
+      return Result<void>{std::move(e)};
+    });
+}
+
+} // namespace TrenchBroom::IO
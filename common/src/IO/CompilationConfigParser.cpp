@@ -125,10 +125,14 @@ Model::CompilationExportMap CompilationConfigParser::parseExportTask(
   const EL::Value& value) const
 {
   expectStructure(
-    value, "[ {'type': 'String', 'target': 'String'}, { 'enabled': 'Boolean' } ]");
+    value,
+    "[ {'type': 'String', 'target': 'String'}, { 'enabled': 'Boolean', 'concurrent': "
+    "'Boolean' } ]");
 
   const auto enabled = value.contains("enabled") ? value["enabled"].booleanValue() : true;
-  return {enabled, value["target"].stringValue()};
+  const auto concurrent =
+    value.contains("concurrent") ? value["concurrent"].booleanValue() : false;
+  return {enabled, value["target"].stringValue(), concurrent};
 }
 
 Model::CompilationCopyFiles CompilationConfigParser::parseCopyTask(
@@ -137,10 +141,13 @@ Model::CompilationCopyFiles CompilationConfigParser::parseCopyTask(
   expectStructure(
     value,
     "[ {'type': 'String', 'source': 'String', 'target': 'String'}, { 'enabled': "
-    "'Boolean' } ]");
+    "'Boolean', 'concurrent': 'Boolean' } ]");
 
   const auto enabled = value.contains("enabled") ? value["enabled"].booleanValue() : true;
-  return {enabled, value["source"].stringValue(), value["target"].stringValue()};
+  const auto concurrent =
+    value.contains("concurrent") ? value["concurrent"].booleanValue() : false;
+  return {
+    enabled, value["source"].stringValue(), value["target"].stringValue(), concurrent};
 }
 
 Model::CompilationRenameFile CompilationConfigParser::parseRenameTask(
@@ -149,20 +156,27 @@ Model::CompilationRenameFile CompilationConfigParser::parseRenameTask(
   expectStructure(
     value,
     "[ {'type': 'String', 'source': 'String', 'target': 'String'}, { 'enabled': "
-    "'Boolean' } ]");
+    "'Boolean', 'concurrent': 'Boolean' } ]");
 
   const auto enabled = value.contains("enabled") ? value["enabled"].booleanValue() : true;
-  return {enabled, value["source"].stringValue(), value["target"].stringValue()};
+  const auto concurrent =
+    value.contains("concurrent") ? value["concurrent"].booleanValue() : false;
+  return {
+    enabled, value["source"].stringValue(), value["target"].stringValue(), concurrent};
 }
 
 Model::CompilationDeleteFiles CompilationConfigParser::parseDeleteTask(
   const EL::Value& value) const
 {
   expectStructure(
-    value, "[ {'type': 'String', 'target': 'String'}, { 'enabled': 'Boolean' } ]");
+    value,
+    "[ {'type': 'String', 'target': 'String'}, { 'enabled': 'Boolean', 'concurrent': "
+    "'Boolean' } ]");
 
   const auto enabled = value.contains("enabled") ? value["enabled"].booleanValue() : true;
-  return {enabled, value["target"].stringValue()};
+  const auto concurrent =
+    value.contains("concurrent") ? value["concurrent"].booleanValue() : false;
+  return {enabled, value["target"].stringValue(), concurrent};
 }
 
 Model::CompilationRunTool CompilationConfigParser::parseToolTask(
@@ -171,9 +185,11 @@ Model::CompilationRunTool CompilationConfigParser::parseToolTask(
   expectStructure(
     value,
     "[ {'type': 'String', 'tool': 'String', 'parameters': 'String'}, { 'enabled': "
-    "'Boolean', 'treatNonZeroResultCodeAsError': 'Boolean' } ]");
+    "'Boolean', 'treatNonZeroResultCodeAsError': 'Boolean', 'concurrent': 'Boolean' } ]");
 
   const auto enabled = value.contains("enabled") ? value["enabled"].booleanValue() : true;
+  const auto concurrent =
+    value.contains("concurrent") ? value["concurrent"].booleanValue() : false;
   const auto treatNonZeroResultCodeAsError =
     value.contains("treatNonZeroResultCodeAsError")
       ? value["treatNonZeroResultCodeAsError"].booleanValue()
@@ -183,7 +199,8 @@ Model::CompilationRunTool CompilationConfigParser::parseToolTask(
     enabled,
     value["tool"].stringValue(),
     value["parameters"].stringValue(),
-    treatNonZeroResultCodeAsError};
+    treatNonZeroResultCodeAsError,
+    concurrent};
 }
 } // namespace IO
 } // namespace TrenchBroom
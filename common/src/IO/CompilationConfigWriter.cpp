@@ -80,6 +80,10 @@ EL::Value CompilationConfigWriter::writeTasks(
           {
             map["enabled"] = EL::Value{false};
           }
+          if (exportMap.concurrent)
+          {
+            map["concurrent"] = EL::Value{true};
+          }
           map["type"] = EL::Value{"export"};
           map["target"] = EL::Value{exportMap.targetSpec};
           return EL::Value{std::move(map)};
@@ -90,6 +94,10 @@ EL::Value CompilationConfigWriter::writeTasks(
           {
             map["enabled"] = EL::Value{false};
           }
+          if (copyFiles.concurrent)
+          {
+            map["concurrent"] = EL::Value{true};
+          }
           map["type"] = EL::Value{"copy"};
           map["source"] = EL::Value{copyFiles.sourceSpec};
           map["target"] = EL::Value{copyFiles.targetSpec};
@@ -101,6 +109,10 @@ EL::Value CompilationConfigWriter::writeTasks(
           {
             map["enabled"] = EL::Value{false};
           }
+          if (renameFile.concurrent)
+          {
+            map["concurrent"] = EL::Value{true};
+          }
           map["type"] = EL::Value{"rename"};
           map["source"] = EL::Value{renameFile.sourceSpec};
           map["target"] = EL::Value{renameFile.targetSpec};
@@ -112,6 +124,10 @@ EL::Value CompilationConfigWriter::writeTasks(
           {
             map["enabled"] = EL::Value{false};
           }
+          if (deleteFiles.concurrent)
+          {
+            map["concurrent"] = EL::Value{true};
+          }
           map["type"] = EL::Value{"delete"};
           map["target"] = EL::Value{deleteFiles.targetSpec};
           return EL::Value{std::move(map)};
@@ -122,6 +138,10 @@ EL::Value CompilationConfigWriter::writeTasks(
           {
             map["enabled"] = EL::Value{false};
           }
+          if (runTool.concurrent)
+          {
+            map["concurrent"] = EL::Value{true};
+          }
           if (runTool.treatNonZeroResultCodeAsError)
           {
             map["treatNonZeroResultCodeAsError"] = EL::Value{true};
@@ -33,6 +33,7 @@
 
 #include <memory>
 #include <string>
+#include <system_error>
 
 namespace TrenchBroom::IO
 {
@@ -84,6 +85,142 @@ Result<std::shared_ptr<File>> DiskFileSystem::doOpenFile(
   });
 }
 
+CachedDiskFileSystem::CachedDiskFileSystem(const std::filesystem::path& root)
+  : DiskFileSystem{root}
+{
+}
+
+PathInfo CachedDiskFileSystem::pathInfo(const std::filesystem::path& path) const
+{
+  if (path.is_absolute())
+  {
+    return DiskFileSystem::pathInfo(path);
+  }
+
+  const auto resolved = resolve(path);
+  return resolved ? std::get<1>(*resolved) : PathInfo::Unknown;
+}
+
+void CachedDiskFileSystem::refresh()
+{
+  const auto lock = std::lock_guard{m_mutex};
+  m_directories.clear();
+}
+
+Result<std::vector<std::filesystem::path>> CachedDiskFileSystem::doFind(
+  const std::filesystem::path& path, const TraversalMode traversalMode) const
+{
+  const auto resolved = resolve(path);
+  if (!resolved || std::get<1>(*resolved) != PathInfo::Directory)
+  {
+    return Error{"Failed to open '" + (m_root / path).string() + "'"};
+  }
+
+  auto result = std::vector<std::filesystem::path>{};
+  findEntries(std::get<0>(*resolved), traversalMode, result);
+  return result;
+}
+
+Result<std::shared_ptr<File>> CachedDiskFileSystem::doOpenFile(
+  const std::filesystem::path& path) const
+{
+  const auto resolved = resolve(path);
+  return DiskFileSystem::doOpenFile(resolved ? std::get<0>(*resolved) : path);
+}
+
+std::optional<std::tuple<std::filesystem::path, PathInfo>> CachedDiskFileSystem::
+  resolve(const std::filesystem::path& path) const
+{
+  if (!directory({}))
+  {
+    return std::nullopt;
+  }
+
+  auto result = std::filesystem::path{};
+  auto pathInfo = PathInfo::Directory;
+  for (const auto& name : path.lexically_normal())
+  {
+    if (name.empty() || name == ".")
+    {
+      continue;
+    }
+
+    const auto entries = pathInfo == PathInfo::Directory && name != ".."
+                           ? directory(result)
+                           : std::shared_ptr<const Directory>{};
+    if (!entries)
+    {
+      return std::nullopt;
+    }
+
+    const auto it = entries->find(kdl::path_to_lower(name));
+    if (it == entries->end())
+    {
+      return std::nullopt;
+    }
+
+    result = result / it->second.name;
+    pathInfo = it->second.pathInfo;
+  }
+
+  return std::tuple{std::move(result), pathInfo};
+}
+
+std::shared_ptr<const CachedDiskFileSystem::Directory> CachedDiskFileSystem::directory(
+  const std::filesystem::path& path) const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  if (const auto it = m_directories.find(path); it != m_directories.end())
+  {
+    return it->second;
+  }
+
+  auto error = std::error_code{};
+  auto it = std::filesystem::directory_iterator{Disk::fixPath(m_root / path), error};
+  auto result = std::shared_ptr<Directory>{};
+  if (!error)
+  {
+    result = std::make_shared<Directory>();
+    for (; !error && it != std::filesystem::directory_iterator{}; it.increment(error))
+    {
+      auto entryError = std::error_code{};
+      const auto pathInfo = it->is_directory(entryError)      ? PathInfo::Directory
+                            : it->is_regular_file(entryError) ? PathInfo::File
+                                                              : PathInfo::Unknown;
+      const auto name = it->path().filename();
+      result->emplace(kdl::path_to_lower(name), DirectoryEntry{name, pathInfo});
+    }
+  }
+
+  m_directories[path] = result;
+  return result;
+}
+
+void CachedDiskFileSystem::findEntries(
+  const std::filesystem::path& path,
+  const TraversalMode traversalMode,
+  std::vector<std::filesystem::path>& result) const
+{
+  if (const auto entries = directory(path))
+  {
+    for (const auto& [key, entry] : *entries)
+    {
+      auto entryPath = path / entry.name;
+      if (
+        traversalMode == TraversalMode::Recursive
+        && entry.pathInfo == PathInfo::Directory)
+      {
+        result.push_back(entryPath);
+        findEntries(entryPath, traversalMode, result);
+      }
+      else
+      {
+        result.push_back(std::move(entryPath));
+      }
+    }
+  }
+}
+
 WritableDiskFileSystem::WritableDiskFileSystem(const std::filesystem::path& root)
   : DiskFileSystem{root}
 {
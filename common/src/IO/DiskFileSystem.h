@@ -23,8 +23,12 @@
 #include "Result.h"
 
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <tuple>
 
 namespace TrenchBroom::IO
 {
@@ -50,6 +54,60 @@ protected:
     const std::filesystem::path& path) const override;
 };
 
+/**
+ * A disk file system that caches the contents of every directory it reads, so that
+ * repeated lookups and searches are answered without accessing the disk. This matters
+ * when the same game directories are searched for textures, shaders and models, and
+ * especially if they are on a network drive.
+ *
+ * Changes on disk only become visible after calling refresh.
+ */
+class CachedDiskFileSystem : public DiskFileSystem
+{
+private:
+  struct DirectoryEntry
+  {
+    std::filesystem::path name;
+    PathInfo pathInfo;
+  };
+
+  // by lower case name
+  using Directory = std::map<std::filesystem::path, DirectoryEntry>;
+
+  mutable std::mutex m_mutex;
+  // by path relative to the root, null if the directory could not be read
+  mutable std::map<std::filesystem::path, std::shared_ptr<const Directory>> m_directories;
+
+public:
+  explicit CachedDiskFileSystem(const std::filesystem::path& root);
+
+  PathInfo pathInfo(const std::filesystem::path& path) const override;
+
+  /**
+   * Discards the cached directory contents.
+   */
+  void refresh();
+
+protected:
+  Result<std::vector<std::filesystem::path>> doFind(
+    const std::filesystem::path& path, TraversalMode traversalMode) const override;
+  Result<std::shared_ptr<File>> doOpenFile(
+    const std::filesystem::path& path) const override;
+
+private:
+  /**
+   * Returns the given path with the case of the names on disk and its path info, or
+   * nothing if the path does not exist.
+   */
+  std::optional<std::tuple<std::filesystem::path, PathInfo>> resolve(
+    const std::filesystem::path& path) const;
+  std::shared_ptr<const Directory> directory(const std::filesystem::path& path) const;
+  void findEntries(
+    const std::filesystem::path& path,
+    TraversalMode traversalMode,
+    std::vector<std::filesystem::path>& result) const;
+};
+
 #ifdef _MSC_VER
 // MSVC complains about the fact that this class inherits some (pure virtual) method
 // declarations several times from different base classes, even though there is only one
@@ -151,6 +151,18 @@ Result<std::shared_ptr<CFile>> openFile(const std::filesystem::path& path)
   return createCFile(fixedPath);
 }
 
+Result<std::shared_ptr<MappedFile>> mapFile(const std::filesystem::path& path)
+{
+  const auto fixedPath = fixPath(path);
+  if (pathInfo(fixedPath) != PathInfo::File)
+  {
+    return Error{
+      "Failed to open '" + fixedPath.string() + "': path does not denote a file"};
+  }
+
+  return createMappedFile(fixedPath);
+}
+
 Result<bool> createDirectory(const std::filesystem::path& path)
 {
   const auto fixedPath = fixPath(path);
@@ -35,6 +35,7 @@ namespace TrenchBroom::IO
 {
 enum class TraversalMode;
 class CFile;
+class MappedFile;
 class File;
 enum class PathInfo;
 
@@ -53,6 +54,12 @@ Result<std::vector<std::filesystem::path>> find(
 
 Result<std::shared_ptr<CFile>> openFile(const std::filesystem::path& path);
 
+/**
+ * Opens the file at the given path and maps its contents into memory. Use this instead of
+ * openFile if the entire file is to be read into a buffer.
+ */
+Result<std::shared_ptr<MappedFile>> mapFile(const std::filesystem::path& path);
+
 template <typename Stream, typename F>
 auto withStream(
   const std::filesystem::path& path, const std::ios::openmode mode, const F& function)
@@ -20,6 +20,7 @@
 #include "DkmParser.h"
 
 #include "Assets/EntityModel.h"
+#include "Assets/Palette.h"
 #include "Assets/Texture.h"
 #include "Error.h"
 #include "Exceptions.h"
@@ -240,10 +241,15 @@ DkmParser::DkmMesh::DkmMesh(const int i_vertexCount)
 {
 }
 
-DkmParser::DkmParser(const std::string& name, const Reader& reader, const FileSystem& fs)
+DkmParser::DkmParser(
+  const std::string& name,
+  const Reader& reader,
+  const FileSystem& fs,
+  Assets::SkinCache* skinCache)
   : m_name(name)
   , m_reader(reader)
   , m_fs(fs)
+  , m_skinCache(skinCache)
 {
 }
 
@@ -445,13 +451,13 @@ void DkmParser::loadSkins(
   const DkmParser::DkmSkinList& skins,
   Logger& logger)
 {
-  std::vector<Assets::Texture> textures;
+  std::vector<std::shared_ptr<Assets::TextureCollection>> textures;
   textures.reserve(skins.size());
 
   for (const auto& skin : skins)
   {
     const auto skinPath = findSkin(skin);
-    textures.push_back(loadSkin(skinPath, m_fs, logger));
+    textures.push_back(loadSkin(skinPath, m_fs, std::nullopt, m_skinCache, logger));
   }
 
   surface.setSkins(std::move(textures));
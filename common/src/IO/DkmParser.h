@@ -31,6 +31,11 @@
 
 namespace TrenchBroom
 {
+namespace Assets
+{
+class SkinCache;
+}
+
 namespace IO
 {
 class FileSystem;
@@ -99,9 +104,14 @@ private:
   std::string m_name;
   const Reader& m_reader;
   const FileSystem& m_fs;
+  Assets::SkinCache* m_skinCache;
 
 public:
-  DkmParser(const std::string& name, const Reader& reader, const FileSystem& fs);
+  DkmParser(
+    const std::string& name,
+    const Reader& reader,
+    const FileSystem& fs,
+    Assets::SkinCache* skinCache = nullptr);
 
   static bool canParse(const std::filesystem::path& path, Reader reader);
 
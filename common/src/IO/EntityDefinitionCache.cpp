@@ -0,0 +1,767 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityDefinitionCache.h"
+
+#include "Assets/DecalDefinition.h"
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "Assets/PropertyDefinition.h"
+#include "Color.h"
+#include "EL/Expression.h"
+#include "EL/Expressions.h"
+#include "EL/Value.h"
+#include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/File.h"
+#include "IO/FileSystem.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <ostream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+constexpr auto Magic = std::string_view{"TBED"};
+
+// must be incremented whenever the format of the cache changes
+constexpr auto Version = uint32_t(1);
+
+// limits the recursion when reading a malformed cache
+constexpr auto MaxExpressionDepth = size_t(256);
+
+enum class ExpressionTag : uint8_t
+{
+  Literal,
+  Variable,
+  Array,
+  Map,
+  Unary,
+  Binary,
+  Subscript,
+  Switch,
+};
+
+enum class PropertyDefinitionTag : uint8_t
+{
+  /** A property definition without a default value, e.g. a target source property. */
+  Plain,
+  String,
+  Unknown,
+  Boolean,
+  Integer,
+  Float,
+  Choice,
+  Flags,
+};
+
+void writeValue(CacheWriter& writer, const EL::Value& value)
+{
+  writer.write(value.type());
+  switch (value.type())
+  {
+  case EL::ValueType::Boolean:
+    writer.writeBool(value.booleanValue());
+    break;
+  case EL::ValueType::String:
+    writer.writeString(value.stringValue());
+    break;
+  case EL::ValueType::Number:
+    writer.write(value.numberValue());
+    break;
+  case EL::ValueType::Array:
+    writer.writeSize(value.arrayValue().size());
+    for (const auto& element : value.arrayValue())
+    {
+      writeValue(writer, element);
+    }
+    break;
+  case EL::ValueType::Map:
+    writer.writeSize(value.mapValue().size());
+    for (const auto& [key, element] : value.mapValue())
+    {
+      writer.writeString(key);
+      writeValue(writer, element);
+    }
+    break;
+  case EL::ValueType::Range:
+    writer.writeSize(value.rangeValue().size());
+    for (const auto index : value.rangeValue())
+    {
+      writer.write(int64_t(index));
+    }
+    break;
+  case EL::ValueType::Null:
+  case EL::ValueType::Undefined:
+    break;
+  }
+}
+
+void writeExpression(CacheWriter& writer, const EL::Expression& expression)
+{
+  writer.writeSize(expression.line());
+  writer.writeSize(expression.column());
+
+  const auto& impl = expression.impl();
+  if (const auto* literal = dynamic_cast<const EL::LiteralExpression*>(&impl))
+  {
+    writer.write(ExpressionTag::Literal);
+    writeValue(writer, literal->value());
+  }
+  else if (const auto* variable = dynamic_cast<const EL::VariableExpression*>(&impl))
+  {
+    writer.write(ExpressionTag::Variable);
+    writer.writeString(variable->variableName());
+  }
+  else if (const auto* array = dynamic_cast<const EL::ArrayExpression*>(&impl))
+  {
+    writer.write(ExpressionTag::Array);
+    writer.writeSize(array->elements().size());
+    for (const auto& element : array->elements())
+    {
+      writeExpression(writer, element);
+    }
+  }
+  else if (const auto* map = dynamic_cast<const EL::MapExpression*>(&impl))
+  {
+    writer.write(ExpressionTag::Map);
+    writer.writeSize(map->elements().size());
+    for (const auto& [key, element] : map->elements())
+    {
+      writer.writeString(key);
+      writeExpression(writer, element);
+    }
+  }
+  else if (const auto* unary = dynamic_cast<const EL::UnaryExpression*>(&impl))
+  {
+    writer.write(ExpressionTag::Unary);
+    writer.write(unary->unaryOperator());
+    writeExpression(writer, unary->operand());
+  }
+  else if (const auto* binary = dynamic_cast<const EL::BinaryExpression*>(&impl))
+  {
+    writer.write(ExpressionTag::Binary);
+    writer.write(binary->binaryOperator());
+    writeExpression(writer, binary->leftOperand());
+    writeExpression(writer, binary->rightOperand());
+  }
+  else if (const auto* subscript = dynamic_cast<const EL::SubscriptExpression*>(&impl))
+  {
+    writer.write(ExpressionTag::Subscript);
+    writeExpression(writer, subscript->leftOperand());
+    writeExpression(writer, subscript->rightOperand());
+  }
+  else if (const auto* switch_ = dynamic_cast<const EL::SwitchExpression*>(&impl))
+  {
+    writer.write(ExpressionTag::Switch);
+    writer.writeSize(switch_->cases().size());
+    for (const auto& case_ : switch_->cases())
+    {
+      writeExpression(writer, case_);
+    }
+  }
+}
+
+template <typename T>
+void writeDefaultValue(
+  CacheWriter& writer, const Assets::PropertyDefinitionWithDefaultValue<T>& definition)
+{
+  writer.writeBool(definition.hasDefaultValue());
+  if (definition.hasDefaultValue())
+  {
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+      writer.writeString(definition.defaultValue());
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+      writer.writeBool(definition.defaultValue());
+    }
+    else if constexpr (std::is_same_v<T, int>)
+    {
+      writer.write(int32_t(definition.defaultValue()));
+    }
+    else
+    {
+      writer.write(definition.defaultValue());
+    }
+  }
+}
+
+void writePropertyDefinition(
+  CacheWriter& writer, const Assets::PropertyDefinition& definition)
+{
+  const auto writeCommon = [&](const auto tag) {
+    writer.write(tag);
+    writer.writeString(definition.key());
+    writer.writeString(definition.shortDescription());
+    writer.writeString(definition.longDescription());
+    writer.writeBool(definition.readOnly());
+  };
+
+  if (const auto* unknownDefinition =
+        dynamic_cast<const Assets::UnknownPropertyDefinition*>(&definition))
+  {
+    writeCommon(PropertyDefinitionTag::Unknown);
+    writeDefaultValue(writer, *unknownDefinition);
+  }
+  else if (
+    const auto* stringDefinition =
+      dynamic_cast<const Assets::StringPropertyDefinition*>(&definition))
+  {
+    writeCommon(PropertyDefinitionTag::String);
+    writeDefaultValue(writer, *stringDefinition);
+  }
+  else if (
+    const auto* booleanDefinition =
+      dynamic_cast<const Assets::BooleanPropertyDefinition*>(&definition))
+  {
+    writeCommon(PropertyDefinitionTag::Boolean);
+    writeDefaultValue(writer, *booleanDefinition);
+  }
+  else if (
+    const auto* integerDefinition =
+      dynamic_cast<const Assets::IntegerPropertyDefinition*>(&definition))
+  {
+    writeCommon(PropertyDefinitionTag::Integer);
+    writeDefaultValue(writer, *integerDefinition);
+  }
+  else if (
+    const auto* floatDefinition =
+      dynamic_cast<const Assets::FloatPropertyDefinition*>(&definition))
+  {
+    writeCommon(PropertyDefinitionTag::Float);
+    writeDefaultValue(writer, *floatDefinition);
+  }
+  else if (
+    const auto* choiceDefinition =
+      dynamic_cast<const Assets::ChoicePropertyDefinition*>(&definition))
+  {
+    writeCommon(PropertyDefinitionTag::Choice);
+    writeDefaultValue(writer, *choiceDefinition);
+    writer.writeSize(choiceDefinition->options().size());
+    for (const auto& option : choiceDefinition->options())
+    {
+      writer.writeString(option.value());
+      writer.writeString(option.description());
+    }
+  }
+  else if (
+    const auto* flagsDefinition =
+      dynamic_cast<const Assets::FlagsPropertyDefinition*>(&definition))
+  {
+    writeCommon(PropertyDefinitionTag::Flags);
+    writer.writeSize(flagsDefinition->options().size());
+    for (const auto& option : flagsDefinition->options())
+    {
+      writer.write(int32_t(option.value()));
+      writer.writeString(option.shortDescription());
+      writer.writeString(option.longDescription());
+      writer.writeBool(option.isDefault());
+    }
+  }
+  else
+  {
+    writeCommon(PropertyDefinitionTag::Plain);
+    writer.write(definition.type());
+  }
+}
+
+void writeEntityDefinition(
+  CacheWriter& writer,
+  const Assets::EntityDefinition& definition,
+  const std::unordered_map<const Assets::PropertyDefinition*, size_t>& propertyIndices)
+{
+  writer.write(definition.type());
+  writer.writeString(definition.name());
+  writer.writeVec(definition.color());
+  writer.writeString(definition.description());
+
+  writer.writeSize(definition.propertyDefinitions().size());
+  for (const auto& propertyDefinition : definition.propertyDefinitions())
+  {
+    writer.writeSize(propertyIndices.at(propertyDefinition.get()));
+  }
+
+  if (
+    const auto* pointDefinition =
+      dynamic_cast<const Assets::PointEntityDefinition*>(&definition))
+  {
+    writer.writeVec(pointDefinition->bounds().min);
+    writer.writeVec(pointDefinition->bounds().max);
+    writeExpression(writer, pointDefinition->modelDefinition().expression());
+    writeExpression(writer, pointDefinition->decalDefinition().expression());
+  }
+}
+
+/**
+ * Reads an enum value and checks that it is not greater than the given last value.
+ */
+template <typename E>
+E readEnum(Reader& reader, const E last)
+{
+  using U = std::underlying_type_t<E>;
+
+  const auto value = reader.read<U, U>();
+  if (value > U(last))
+  {
+    throw ReaderException{"Invalid enum value " + std::to_string(value)};
+  }
+  return static_cast<E>(value);
+}
+
+EL::Value readValue(Reader& reader, const size_t depth)
+{
+  if (depth > MaxExpressionDepth)
+  {
+    throw ReaderException{"Value is nested too deeply"};
+  }
+
+  switch (readEnum(reader, EL::ValueType::Undefined))
+  {
+  case EL::ValueType::Boolean:
+    return EL::Value{reader.readBool<uint8_t>()};
+  case EL::ValueType::String:
+    return EL::Value{readString(reader)};
+  case EL::ValueType::Number:
+    return EL::Value{read<EL::NumberType>(reader)};
+  case EL::ValueType::Array: {
+    auto array = EL::ArrayType{};
+    const auto count = readCount(reader, 1);
+    array.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      array.push_back(readValue(reader, depth + 1));
+    }
+    return EL::Value{std::move(array)};
+  }
+  case EL::ValueType::Map: {
+    auto map = EL::MapType{};
+    const auto count = readCount(reader, 9);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto key = readString(reader);
+      map.emplace(std::move(key), readValue(reader, depth + 1));
+    }
+    return EL::Value{std::move(map)};
+  }
+  case EL::ValueType::Range: {
+    auto range = EL::RangeType{};
+    const auto count = readCount(reader, sizeof(int64_t));
+    range.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      range.push_back(static_cast<long>(read<int64_t>(reader)));
+    }
+    return EL::Value{std::move(range)};
+  }
+  case EL::ValueType::Null:
+    return EL::Value::Null;
+  case EL::ValueType::Undefined:
+    return EL::Value::Undefined;
+  }
+  throw ReaderException{"Invalid value type"};
+}
+
+EL::Expression readExpression(Reader& reader, const size_t depth)
+{
+  if (depth > MaxExpressionDepth)
+  {
+    throw ReaderException{"Expression is nested too deeply"};
+  }
+
+  const auto line = readSize(reader);
+  const auto column = readSize(reader);
+
+  switch (readEnum(reader, ExpressionTag::Switch))
+  {
+  case ExpressionTag::Literal:
+    return EL::Expression{
+      EL::LiteralExpression{readValue(reader, depth + 1)}, line, column};
+  case ExpressionTag::Variable:
+    return EL::Expression{EL::VariableExpression{readString(reader)}, line, column};
+  case ExpressionTag::Array: {
+    auto elements = std::vector<EL::Expression>{};
+    const auto count = readCount(reader, 17);
+    elements.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      elements.push_back(readExpression(reader, depth + 1));
+    }
+    return EL::Expression{EL::ArrayExpression{std::move(elements)}, line, column};
+  }
+  case ExpressionTag::Map: {
+    auto elements = std::map<std::string, EL::Expression>{};
+    const auto count = readCount(reader, 25);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto key = readString(reader);
+      elements.emplace(std::move(key), readExpression(reader, depth + 1));
+    }
+    return EL::Expression{EL::MapExpression{std::move(elements)}, line, column};
+  }
+  case ExpressionTag::Unary: {
+    const auto operator_ = readEnum(reader, EL::UnaryOperator::Group);
+    auto operand = readExpression(reader, depth + 1);
+    return EL::Expression{
+      EL::UnaryExpression{operator_, std::move(operand)}, line, column};
+  }
+  case ExpressionTag::Binary: {
+    const auto operator_ = readEnum(reader, EL::BinaryOperator::Case);
+    auto leftOperand = readExpression(reader, depth + 1);
+    auto rightOperand = readExpression(reader, depth + 1);
+    return EL::Expression{
+      EL::BinaryExpression{operator_, std::move(leftOperand), std::move(rightOperand)},
+      line,
+      column};
+  }
+  case ExpressionTag::Subscript: {
+    auto leftOperand = readExpression(reader, depth + 1);
+    auto rightOperand = readExpression(reader, depth + 1);
+    return EL::Expression{
+      EL::SubscriptExpression{std::move(leftOperand), std::move(rightOperand)},
+      line,
+      column};
+  }
+  case ExpressionTag::Switch: {
+    auto cases = std::vector<EL::Expression>{};
+    const auto count = readCount(reader, 17);
+    cases.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      cases.push_back(readExpression(reader, depth + 1));
+    }
+    return EL::Expression{EL::SwitchExpression{std::move(cases)}, line, column};
+  }
+  }
+  throw ReaderException{"Invalid expression type"};
+}
+
+template <typename T>
+std::optional<T> readDefaultValue(Reader& reader)
+{
+  if (!reader.readBool<uint8_t>())
+  {
+    return std::nullopt;
+  }
+
+  if constexpr (std::is_same_v<T, std::string>)
+  {
+    return readString(reader);
+  }
+  else if constexpr (std::is_same_v<T, bool>)
+  {
+    return reader.readBool<uint8_t>();
+  }
+  else if constexpr (std::is_same_v<T, int>)
+  {
+    return reader.readInt<int32_t>();
+  }
+  else
+  {
+    return read<T>(reader);
+  }
+}
+
+std::shared_ptr<Assets::PropertyDefinition> readPropertyDefinition(Reader& reader)
+{
+  const auto tag = readEnum(reader, PropertyDefinitionTag::Flags);
+  auto key = readString(reader);
+  auto shortDescription = readString(reader);
+  auto longDescription = readString(reader);
+  const auto readOnly = reader.readBool<uint8_t>();
+
+  switch (tag)
+  {
+  case PropertyDefinitionTag::Plain:
+    return std::make_shared<Assets::PropertyDefinition>(
+      std::move(key),
+      readEnum(reader, Assets::PropertyDefinitionType::FlagsProperty),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly);
+  case PropertyDefinitionTag::String:
+    return std::make_shared<Assets::StringPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readDefaultValue<std::string>(reader));
+  case PropertyDefinitionTag::Unknown:
+    return std::make_shared<Assets::UnknownPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readDefaultValue<std::string>(reader));
+  case PropertyDefinitionTag::Boolean:
+    return std::make_shared<Assets::BooleanPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readDefaultValue<bool>(reader));
+  case PropertyDefinitionTag::Integer:
+    return std::make_shared<Assets::IntegerPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readDefaultValue<int>(reader));
+  case PropertyDefinitionTag::Float:
+    return std::make_shared<Assets::FloatPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readDefaultValue<float>(reader));
+  case PropertyDefinitionTag::Choice: {
+    auto defaultValue = readDefaultValue<std::string>(reader);
+    auto options = Assets::ChoicePropertyOption::List{};
+    const auto count = readCount(reader, 16);
+    options.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto value = readString(reader);
+      auto description = readString(reader);
+      options.emplace_back(std::move(value), std::move(description));
+    }
+    return std::make_shared<Assets::ChoicePropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      std::move(options),
+      readOnly,
+      std::move(defaultValue));
+  }
+  case PropertyDefinitionTag::Flags: {
+    auto definition = std::make_shared<Assets::FlagsPropertyDefinition>(std::move(key));
+    const auto count = readCount(reader, 21);
+    for (size_t i = 0; i < count; ++i)
+    {
+      const auto value = reader.readInt<int32_t>();
+      auto optionShortDescription = readString(reader);
+      auto optionLongDescription = readString(reader);
+      const auto isDefault = reader.readBool<uint8_t>();
+      definition->addOption(
+        value,
+        std::move(optionShortDescription),
+        std::move(optionLongDescription),
+        isDefault);
+    }
+    return definition;
+  }
+  }
+  throw ReaderException{"Invalid property definition type"};
+}
+
+std::unique_ptr<Assets::EntityDefinition> readEntityDefinition(
+  Reader& reader,
+  const std::vector<std::shared_ptr<Assets::PropertyDefinition>>& propertyDefinitions)
+{
+  const auto type = readEnum(reader, Assets::EntityDefinitionType::BrushEntity);
+  auto name = readString(reader);
+  const auto color = Color{reader.readVec<float, 4>()};
+  auto description = readString(reader);
+
+  auto entityPropertyDefinitions =
+    std::vector<std::shared_ptr<Assets::PropertyDefinition>>{};
+  const auto count = readCount(reader, 8);
+  entityPropertyDefinitions.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto index = readSize(reader);
+    if (index >= propertyDefinitions.size())
+    {
+      throw ReaderException{"Invalid property definition index " + std::to_string(index)};
+    }
+    entityPropertyDefinitions.push_back(propertyDefinitions[index]);
+  }
+
+  if (type == Assets::EntityDefinitionType::PointEntity)
+  {
+    const auto min = reader.readVec<FloatType, 3>();
+    const auto max = reader.readVec<FloatType, 3>();
+    auto modelExpression = readExpression(reader, 0);
+    auto decalExpression = readExpression(reader, 0);
+    return std::make_unique<Assets::PointEntityDefinition>(
+      std::move(name),
+      color,
+      vm::bbox3{min, max},
+      std::move(description),
+      std::move(entityPropertyDefinitions),
+      Assets::ModelDefinition{std::move(modelExpression)},
+      Assets::DecalDefinition{std::move(decalExpression)});
+  }
+
+  return std::make_unique<Assets::BrushEntityDefinition>(
+    std::move(name),
+    color,
+    std::move(description),
+    std::move(entityPropertyDefinitions));
+}
+
+/**
+ * Identifies the current contents of the file at the given path.
+ */
+Result<std::string> fileStamp(const std::filesystem::path& path, const FileSystem& fs)
+{
+  return fs.openFile(path).transform([&](auto file) {
+    const auto reader = file->reader().buffer();
+    return fmt::format(
+      "{} {} {:016x}", path.u8string(), file->size(), kdl::str_hash(reader.stringView()));
+  });
+}
+
+Result<std::string> dependencyStamps(
+  const std::vector<std::filesystem::path>& dependencies, const FileSystem& fs)
+{
+  return kdl::fold_results(kdl::vec_transform(
+                             dependencies,
+                             [&](const auto& path) { return fileStamp(path, fs); }))
+    .transform([](const auto& stamps) { return kdl::str_join(stamps, "\n"); });
+}
+} // namespace
+
+std::filesystem::path entityDefinitionCachePath(
+  const std::filesystem::path& cacheDirectory, const std::filesystem::path& path)
+{
+  return cacheDirectory / fmt::format("{:016x}.tbed", kdl::str_hash(path.u8string()));
+}
+
+Result<std::string> entityDefinitionCacheKey(
+  const std::filesystem::path& path, const FileSystem& fs, const Color& defaultColor)
+{
+  return fileStamp(path, fs).transform([&](const auto& stamp) {
+    return fmt::format("{} {}", stamp, defaultColor.toString());
+  });
+}
+
+Result<void> writeEntityDefinitionCache(
+  const std::vector<std::unique_ptr<Assets::EntityDefinition>>& definitions,
+  const std::vector<std::filesystem::path>& dependencies,
+  const std::string_view key,
+  const FileSystem& fs,
+  std::ostream& stream)
+{
+  return dependencyStamps(dependencies, fs).transform([&](const auto& stamps) {
+    auto writer = CacheWriter{stream};
+    writer.writeHeader(Magic, Version);
+    writer.writeString(key);
+
+    writer.writeSize(dependencies.size());
+    for (const auto& path : dependencies)
+    {
+      writer.writeString(path.u8string());
+    }
+    writer.writeString(stamps);
+
+    // property definitions are shared between entity definitions that inherit them from
+    // the same base class, so every property definition is only written once
+    auto propertyDefinitions = std::vector<const Assets::PropertyDefinition*>{};
+    auto propertyIndices =
+      std::unordered_map<const Assets::PropertyDefinition*, size_t>{};
+    for (const auto& definition : definitions)
+    {
+      for (const auto& propertyDefinition : definition->propertyDefinitions())
+      {
+        if (propertyIndices.emplace(propertyDefinition.get(), propertyDefinitions.size())
+              .second)
+        {
+          propertyDefinitions.push_back(propertyDefinition.get());
+        }
+      }
+    }
+
+    writer.writeSize(propertyDefinitions.size());
+    for (const auto* propertyDefinition : propertyDefinitions)
+    {
+      writePropertyDefinition(writer, *propertyDefinition);
+    }
+
+    writer.writeSize(definitions.size());
+    for (const auto& definition : definitions)
+    {
+      writeEntityDefinition(writer, *definition, propertyIndices);
+    }
+  });
+}
+
+Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> readEntityDefinitionCache(
+  Reader reader, const std::string_view key, const FileSystem& fs)
+{
+  return readCacheHeader(reader, Magic, Version, key, "entity definition cache")
+    .and_then([&]() -> Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> {
+      try
+      {
+        auto dependencies = std::vector<std::filesystem::path>{};
+        const auto dependencyCount = readCount(reader, 8);
+        dependencies.reserve(dependencyCount);
+        for (size_t i = 0; i < dependencyCount; ++i)
+        {
+          dependencies.push_back(std::filesystem::u8path(readString(reader)));
+        }
+
+        const auto stamps = readString(reader);
+        if (dependencyStamps(dependencies, fs).value_or("") != stamps)
+        {
+          return Error{"Outdated entity definition cache"};
+        }
+
+        auto propertyDefinitions =
+          std::vector<std::shared_ptr<Assets::PropertyDefinition>>{};
+        const auto propertyDefinitionCount = readCount(reader, 26);
+        propertyDefinitions.reserve(propertyDefinitionCount);
+        for (size_t i = 0; i < propertyDefinitionCount; ++i)
+        {
+          propertyDefinitions.push_back(readPropertyDefinition(reader));
+        }
+
+        auto definitions = std::vector<std::unique_ptr<Assets::EntityDefinition>>{};
+        const auto definitionCount = readCount(reader, 33);
+        definitions.reserve(definitionCount);
+        for (size_t i = 0; i < definitionCount; ++i)
+        {
+          definitions.push_back(readEntityDefinition(reader, propertyDefinitions));
+        }
+
+        return definitions;
+      }
+      catch (const ReaderException& e)
+      {
+        return Error{"Malformed entity definition cache: " + std::string{e.what()}};
+      }
+    });
+}
+
+} // namespace TrenchBroom::IO
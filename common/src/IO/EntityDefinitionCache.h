@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom
+{
+class Color;
+}
+
+namespace TrenchBroom::Assets
+{
+class EntityDefinition;
+}
+
+namespace TrenchBroom::IO
+{
+class FileSystem;
+class Reader;
+
+/**
+ * An entity definition cache is a binary file that stores the entity definitions parsed
+ * from an entity definition file, so that loading the file again skips parsing it and
+ * the files it includes.
+ *
+ * A cache is identified by a key which is computed from the contents of the definition
+ * file and the default entity color. Additionally, the cache records the contents of the
+ * included files, and it is only used if none of them have changed.
+ *
+ * Warnings that were reported when the definition file was parsed are not stored in the
+ * cache.
+ */
+
+/**
+ * Returns the path of the cache file for the entity definition file at the given path in
+ * the given cache directory.
+ */
+std::filesystem::path entityDefinitionCachePath(
+  const std::filesystem::path& cacheDirectory, const std::filesystem::path& path);
+
+/**
+ * Computes the key of a cache for the entity definition file at the given path when
+ * parsed with the given default entity color.
+ *
+ * Returns an error if the definition file cannot be opened.
+ */
+Result<std::string> entityDefinitionCacheKey(
+  const std::filesystem::path& path, const FileSystem& fs, const Color& defaultColor);
+
+/**
+ * Writes the given entity definitions to the given stream, which must be opened in
+ * binary mode. The given dependencies are the paths of the files included by the
+ * definition file, they are read from the given file system.
+ *
+ * Returns an error if a dependency cannot be opened.
+ */
+Result<void> writeEntityDefinitionCache(
+  const std::vector<std::unique_ptr<Assets::EntityDefinition>>& definitions,
+  const std::vector<std::filesystem::path>& dependencies,
+  std::string_view key,
+  const FileSystem& fs,
+  std::ostream& stream);
+
+/**
+ * Reads entity definitions from the given reader. Returns an error if the cache is
+ * malformed, if its key does not match the given key, or if one of the recorded
+ * dependencies has changed in the given file system.
+ */
+Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> readEntityDefinitionCache(
+  Reader reader, std::string_view key, const FileSystem& fs);
+
+} // namespace TrenchBroom::IO
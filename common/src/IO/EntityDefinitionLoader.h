@@ -23,6 +23,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom::Assets
@@ -38,8 +39,15 @@ class EntityDefinitionLoader
 {
 public:
   virtual ~EntityDefinitionLoader();
+
+  /**
+   * Loads the entity definitions from the given file. If a cache directory is given, the
+   * parsed definitions are cached there. This function may be called on a worker thread.
+   */
   virtual Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>>
   loadEntityDefinitions(
-    ParserStatus& status, const std::filesystem::path& path) const = 0;
+    ParserStatus& status,
+    const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory) const = 0;
 };
 } // namespace TrenchBroom::IO
@@ -27,10 +27,15 @@
 #include "Macros.h"
 #include "Model/EntityProperties.h"
 
+#include "kdl/parallel.h"
 #include "kdl/vector_utils.h"
 
+#include <optional>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <variant>
+#include <vector>
 
 namespace TrenchBroom::IO
 {
@@ -214,6 +219,50 @@ static void inheritFromAndRecurse(
   visited.erase(superClass.name);
 }
 
+/**
+ * Selects the super class to inherit from among the given classes, which all have the
+ * same name. See findSuperClassesAndInheritFrom for the rules that are used to resolve
+ * ambiguities.
+ *
+ * @param inheritingClassType the type of the class that induces the inheritance hierarchy
+ * @param potentialSuperClasses the classes to select from
+ * @return the selected super class, or null if no class matches
+ */
+static const EntityDefinitionClassInfo* selectSuperClass(
+  const EntityDefinitionClassType inheritingClassType,
+  const std::vector<const EntityDefinitionClassInfo*>& potentialSuperClasses)
+{
+  if (potentialSuperClasses.size() == 1u)
+  {
+    return potentialSuperClasses.front();
+  }
+  else if (potentialSuperClasses.size() > 1u)
+  {
+    // find a super class with the same class type as the inheriting class
+    for (const auto* potentialSuperClass : potentialSuperClasses)
+    {
+      if (potentialSuperClass->type == inheritingClassType)
+      {
+        return potentialSuperClass;
+      }
+    }
+
+    if (inheritingClassType != EntityDefinitionClassType::BaseClass)
+    {
+      // find a super class of type BaseClass
+      for (const auto* potentialSuperClass : potentialSuperClasses)
+      {
+        if (potentialSuperClass->type == EntityDefinitionClassType::BaseClass)
+        {
+          return potentialSuperClass;
+        }
+      }
+    }
+  }
+
+  return nullptr;
+}
+
 /**
  * Find the super classes to inherit from, and process each of them by callling
  * `inheritFromAndRecurse`.
@@ -258,42 +307,10 @@ static void findSuperClassesAndInheritFrom(
   const F& findClassInfos,
   std::unordered_set<std::string>& visited)
 {
-  const auto selectSuperClass =
-    [&](const auto& potentialSuperClasses) -> const EntityDefinitionClassInfo* {
-    if (potentialSuperClasses.size() == 1u)
-    {
-      return potentialSuperClasses.front();
-    }
-    else if (potentialSuperClasses.size() > 1u)
-    {
-      // find a super class with the same class type as the inheriting class
-      for (const auto* potentialSuperClass : potentialSuperClasses)
-      {
-        if (potentialSuperClass->type == inheritingClass.type)
-        {
-          return potentialSuperClass;
-        }
-      }
-
-      if (inheritingClass.type != EntityDefinitionClassType::BaseClass)
-      {
-        // find a super class of type BaseClass
-        for (const auto* potentialSuperClass : potentialSuperClasses)
-        {
-          if (potentialSuperClass->type == EntityDefinitionClassType::BaseClass)
-          {
-            return potentialSuperClass;
-          }
-        }
-      }
-    }
-
-    return nullptr;
-  };
-
   for (const auto& nextSuperClassName : classWithSuperClasses.superClasses)
   {
-    const auto* nextSuperClass = selectSuperClass(findClassInfos(nextSuperClassName));
+    const auto* nextSuperClass =
+      selectSuperClass(inheritingClass.type, findClassInfos(nextSuperClassName));
     if (nextSuperClass == nullptr)
     {
       status.error(
@@ -383,36 +400,244 @@ static std::vector<EntityDefinitionClassInfo> filterRedundantClasses(
   return result;
 }
 
+namespace
+{
+struct ResolutionError
+{
+  size_t line;
+  size_t column;
+  std::string message;
+};
+
+/**
+ * A step of the depth first traversal of the inheritance hierarchy induced by a class.
+ * This is either the index of a super class to inherit from or an error if no matching
+ * super class was found.
+ */
+using InheritanceStep = std::variant<size_t, ResolutionError>;
+
+/**
+ * Computes the steps of the depth first traversal of the inheritance hierarchy for every
+ * class that is reachable from a class of the given type. Applying these steps in order
+ * is equivalent to calling findSuperClassesAndInheritFrom for the class.
+ *
+ * The steps of a class are computed only once by concatenating the steps of its super
+ * classes, so the inheritance hierarchy is not walked again for every class that shares
+ * a super class. A class is processed once the steps of all of its super classes are
+ * known, and the classes that become ready at the same time are processed in parallel.
+ *
+ * Since the super classes are selected depending on the type of the class that induces
+ * the hierarchy, the steps are only valid for classes of the given type.
+ *
+ * @return the steps for every class in the given vector, or nothing if the class is not
+ * reachable or if its hierarchy contains a cycle
+ */
+template <typename F>
+std::vector<std::optional<std::vector<InheritanceStep>>> computeInheritanceSteps(
+  const std::vector<EntityDefinitionClassInfo>& classInfos,
+  const EntityDefinitionClassType inheritingClassType,
+  const F& findClassInfos)
+{
+  const auto classCount = classInfos.size();
+
+  // select the direct super classes of all reachable classes
+  auto superClasses = std::vector<std::optional<std::vector<std::optional<size_t>>>>(
+    classCount);
+  auto stack = std::vector<size_t>{};
+  for (size_t i = 0; i < classCount; ++i)
+  {
+    if (classInfos[i].type == inheritingClassType)
+    {
+      stack.push_back(i);
+    }
+  }
+
+  while (!stack.empty())
+  {
+    const auto i = stack.back();
+    stack.pop_back();
+
+    if (!superClasses[i])
+    {
+      auto& superClassesOfClass = superClasses[i].emplace();
+      for (const auto& superClassName : classInfos[i].superClasses)
+      {
+        if (
+          const auto* superClass =
+            selectSuperClass(inheritingClassType, findClassInfos(superClassName)))
+        {
+          const auto superClassIndex = size_t(superClass - classInfos.data());
+          superClassesOfClass.push_back(superClassIndex);
+          stack.push_back(superClassIndex);
+        }
+        else
+        {
+          superClassesOfClass.push_back(std::nullopt);
+        }
+      }
+    }
+  }
+
+  auto pendingSuperClassCounts = std::vector<size_t>(classCount, 0);
+  auto subClasses = std::vector<std::vector<size_t>>(classCount);
+  auto readyClasses = std::vector<size_t>{};
+  for (size_t i = 0; i < classCount; ++i)
+  {
+    if (superClasses[i])
+    {
+      for (const auto& superClass : *superClasses[i])
+      {
+        if (superClass)
+        {
+          ++pendingSuperClassCounts[i];
+          subClasses[*superClass].push_back(i);
+        }
+      }
+      if (pendingSuperClassCounts[i] == 0)
+      {
+        readyClasses.push_back(i);
+      }
+    }
+  }
+
+  // classes that are part of a cycle never become ready
+  auto result = std::vector<std::optional<std::vector<InheritanceStep>>>(classCount);
+  while (!readyClasses.empty())
+  {
+    kdl::parallel_for(readyClasses.size(), [&](const size_t readyIndex) {
+      const auto i = readyClasses[readyIndex];
+      const auto& classInfo = classInfos[i];
+
+      auto steps = std::vector<InheritanceStep>{};
+      for (size_t j = 0; j < classInfo.superClasses.size(); ++j)
+      {
+        if (const auto superClass = (*superClasses[i])[j])
+        {
+          const auto& superClassSteps = *result[*superClass];
+          steps.emplace_back(*superClass);
+          steps.insert(
+            std::end(steps), std::begin(superClassSteps), std::end(superClassSteps));
+        }
+        else
+        {
+          steps.emplace_back(ResolutionError{
+            classInfo.line,
+            classInfo.column,
+            "No matching super class found for '" + classInfo.superClasses[j] + "'"});
+        }
+      }
+      result[i] = std::move(steps);
+    });
+
+    auto nextReadyClasses = std::vector<size_t>{};
+    for (const auto i : readyClasses)
+    {
+      for (const auto subClass : subClasses[i])
+      {
+        if (--pendingSuperClassCounts[subClass] == 0)
+        {
+          nextReadyClasses.push_back(subClass);
+        }
+      }
+    }
+    readyClasses = std::move(nextReadyClasses);
+  }
+
+  return result;
+}
+} // namespace
+
 /**
  * Resolves the inheritance for every class that is not of type BaseClass in the given
  * vector and returns a vector of copies where the inherited attributes are added to the
  * inheriting classes.
  *
+ * The inheritance hierarchies are memoized by computeInheritanceSteps and the inherited
+ * attributes are added to the classes in parallel. Errors are reported in the order of
+ * the classes. Classes whose hierarchy contains a cycle are resolved by walking their
+ * hierarchy, which reports the cycle.
+ *
  * Exposed for testing.
  */
 std::vector<EntityDefinitionClassInfo> resolveInheritance(
   ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos)
 {
   const auto filteredClassInfos = filterRedundantClasses(status, classInfos);
+
+  auto classInfosByName =
+    std::unordered_map<std::string, std::vector<const EntityDefinitionClassInfo*>>{};
+  for (const auto& classInfo : filteredClassInfos)
+  {
+    classInfosByName[classInfo.name].push_back(&classInfo);
+  }
+
   const auto findClassInfos =
     [&](const auto& name) -> std::vector<const EntityDefinitionClassInfo*> {
-    std::vector<const EntityDefinitionClassInfo*> result;
-    for (const auto& classInfo : filteredClassInfos)
+    const auto it = classInfosByName.find(name);
+    return it != std::end(classInfosByName)
+             ? it->second
+             : std::vector<const EntityDefinitionClassInfo*>{};
+  };
+
+  const auto pointClassSteps = computeInheritanceSteps(
+    filteredClassInfos, EntityDefinitionClassType::PointClass, findClassInfos);
+  const auto brushClassSteps = computeInheritanceSteps(
+    filteredClassInfos, EntityDefinitionClassType::BrushClass, findClassInfos);
+  const auto inheritanceSteps = [&](const size_t i) -> const auto& {
+    return filteredClassInfos[i].type == EntityDefinitionClassType::PointClass
+             ? pointClassSteps[i]
+             : brushClassSteps[i];
+  };
+
+  auto inheritingClassIndices = std::vector<size_t>{};
+  for (size_t i = 0; i < filteredClassInfos.size(); ++i)
+  {
+    if (filteredClassInfos[i].type != EntityDefinitionClassType::BaseClass)
     {
-      if (classInfo.name == name)
+      inheritingClassIndices.push_back(i);
+    }
+  }
+
+  auto resolvedClassInfos = kdl::vec_parallel_transform(
+    inheritingClassIndices,
+    [&](const size_t i) -> std::optional<EntityDefinitionClassInfo> {
+      const auto& steps = inheritanceSteps(i);
+      if (!steps)
       {
-        result.push_back(&classInfo);
+        return std::nullopt;
       }
-    }
-    return result;
-  };
+
+      auto classInfo = filteredClassInfos[i];
+      for (const auto& step : *steps)
+      {
+        if (const auto* superClass = std::get_if<size_t>(&step))
+        {
+          inheritAttributes(classInfo, filteredClassInfos[*superClass]);
+        }
+      }
+      return classInfo;
+    });
 
   std::vector<EntityDefinitionClassInfo> result;
-  for (const auto& classInfo : filteredClassInfos)
+  result.reserve(inheritingClassIndices.size());
+  for (size_t j = 0; j < inheritingClassIndices.size(); ++j)
   {
-    if (classInfo.type != EntityDefinitionClassType::BaseClass)
+    const auto i = inheritingClassIndices[j];
+    if (auto& resolvedClassInfo = resolvedClassInfos[j])
+    {
+      for (const auto& step : *inheritanceSteps(i))
+      {
+        if (const auto* error = std::get_if<ResolutionError>(&step))
+        {
+          status.error(error->line, error->column, error->message);
+        }
+      }
+      result.push_back(std::move(*resolvedClassInfo));
+    }
+    else
     {
-      result.push_back(resolveInheritance(status, classInfo, findClassInfos));
+      result.push_back(
+        resolveInheritance(status, filteredClassInfos[i], findClassInfos));
     }
   }
   return result;
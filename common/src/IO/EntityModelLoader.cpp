@@ -30,7 +30,16 @@ EntityModelLoader::~EntityModelLoader() = default;
 std::unique_ptr<Assets::EntityModel> EntityModelLoader::initializeModel(
   const std::filesystem::path& path, Logger& logger) const
 {
-  return doInitializeModel(path, logger);
+  return initializeModel(path, std::nullopt, nullptr, logger);
+}
+
+std::unique_ptr<Assets::EntityModel> EntityModelLoader::initializeModel(
+  const std::filesystem::path& path,
+  const std::optional<std::filesystem::path>& cacheDirectory,
+  Assets::SkinCache* skinCache,
+  Logger& logger) const
+{
+  return doInitializeModel(path, cacheDirectory, skinCache, logger);
 }
 
 void EntityModelLoader::loadFrame(
@@ -21,6 +21,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 
 namespace TrenchBroom
 {
@@ -29,7 +30,8 @@ class Logger;
 namespace Assets
 {
 class EntityModel;
-}
+class SkinCache;
+} // namespace Assets
 
 namespace IO
 {
@@ -40,6 +42,19 @@ public:
   virtual ~EntityModelLoader();
   std::unique_ptr<Assets::EntityModel> initializeModel(
     const std::filesystem::path& path, Logger& logger) const;
+
+  /**
+   * Initializes the model at the given path. If a cache directory is given, models that
+   * are expensive to convert may be cached in it. If a skin cache is given, skins that
+   * are loaded from files are shared with other models that use the same files.
+   *
+   * Throws a GameException if the model cannot be loaded, and so does loadFrame.
+   */
+  std::unique_ptr<Assets::EntityModel> initializeModel(
+    const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory,
+    Assets::SkinCache* skinCache,
+    Logger& logger) const;
   void loadFrame(
     const std::filesystem::path& path,
     size_t frameIndex,
@@ -48,7 +63,10 @@ public:
 
 private:
   virtual std::unique_ptr<Assets::EntityModel> doInitializeModel(
-    const std::filesystem::path& path, Logger& logger) const = 0;
+    const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory,
+    Assets::SkinCache* skinCache,
+    Logger& logger) const = 0;
   virtual void doLoadFrame(
     const std::filesystem::path& path,
     size_t frameIndex,
@@ -172,6 +172,11 @@ FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor)
 
 FgdParser::~FgdParser() = default;
 
+const std::vector<std::filesystem::path>& FgdParser::includedFiles() const
+{
+  return m_includedFiles;
+}
+
 FgdParser::TokenNameMap FgdParser::tokenNames() const
 {
   using namespace FgdToken;
@@ -1085,6 +1090,8 @@ std::vector<EntityDefinitionClassInfo> FgdParser::handleInclude(
     m_tokenizer.line(), fmt::format("Parsing included file '{}'", path.string()));
 
   const auto filePath = currentRoot() / path;
+  m_includedFiles.push_back(filePath);
+
   return m_fs->openFile(filePath)
     .transform([&](auto file) {
       status.debug(
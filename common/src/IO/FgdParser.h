@@ -79,6 +79,7 @@ private:
   using Token = FgdTokenizer::Token;
 
   std::vector<std::filesystem::path> m_paths;
+  std::vector<std::filesystem::path> m_includedFiles;
   std::unique_ptr<FileSystem> m_fs;
 
   FgdTokenizer m_tokenizer;
@@ -92,6 +93,12 @@ public:
 
   ~FgdParser() override;
 
+  /**
+   * Returns the paths of the files that the parser attempted to include, relative to the
+   * directory of the parsed file. Files that could not be opened are included.
+   */
+  const std::vector<std::filesystem::path>& includedFiles() const;
+
 private:
   class PushIncludePath;
   void pushIncludePath(std::filesystem::path path);
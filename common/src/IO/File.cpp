@@ -26,6 +26,21 @@
 #include <cstdio>
 #include <cstring>
 
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace TrenchBroom::IO
 {
 
@@ -195,6 +210,167 @@ Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path& path)
   });
 }
 
+namespace
+{
+struct MappedRegion
+{
+  const char* begin;
+  size_t size;
+};
+
+#ifdef _WIN32
+Result<MappedRegion> mapPath(const std::filesystem::path& path)
+{
+  auto file = kdl::resource{
+    CreateFileW(
+      path.wstring().c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr),
+    [](auto handle) {
+      if (handle != INVALID_HANDLE_VALUE)
+      {
+        CloseHandle(handle);
+      }
+    }};
+  if (*file == INVALID_HANDLE_VALUE)
+  {
+    return Error{"Cannot open file " + path.string()};
+  }
+
+  auto fileSize = LARGE_INTEGER{};
+  if (!GetFileSizeEx(*file, &fileSize))
+  {
+    return Error{"Cannot determine size of file " + path.string()};
+  }
+
+  const auto size = static_cast<size_t>(fileSize.QuadPart);
+  if (size == 0)
+  {
+    // empty files cannot be mapped
+    return MappedRegion{nullptr, 0};
+  }
+
+  // the view keeps the mapping alive, so the handles can be closed after mapping
+  auto mapping = kdl::resource{
+    CreateFileMappingW(*file, nullptr, PAGE_READONLY, 0, 0, nullptr),
+    [](auto handle) {
+      if (handle)
+      {
+        CloseHandle(handle);
+      }
+    }};
+  if (!*mapping)
+  {
+    return Error{"Cannot map file " + path.string()};
+  }
+
+  const auto* begin =
+    static_cast<const char*>(MapViewOfFile(*mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!begin)
+  {
+    return Error{"Cannot map file " + path.string()};
+  }
+
+  return MappedRegion{begin, size};
+}
+
+void unmap(const char* begin, size_t)
+{
+  UnmapViewOfFile(begin);
+}
+#else
+Result<MappedRegion> mapPath(const std::filesystem::path& path)
+{
+  auto file = kdl::resource{open(path.u8string().c_str(), O_RDONLY), [](auto fd) {
+                              if (fd >= 0)
+                              {
+                                close(fd);
+                              }
+                            }};
+  if (*file < 0)
+  {
+    return Error{"Cannot open file " + path.string()};
+  }
+
+  struct stat fileStat;
+  if (fstat(*file, &fileStat) != 0)
+  {
+    return Error{"Cannot determine size of file " + path.string()};
+  }
+
+  const auto size = static_cast<size_t>(fileStat.st_size);
+  if (size == 0)
+  {
+    // empty files cannot be mapped
+    return MappedRegion{nullptr, 0};
+  }
+
+  // the mapping remains valid after the file descriptor is closed
+  auto* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, *file, 0);
+  if (addr == MAP_FAILED)
+  {
+    return Error{"Cannot map file " + path.string() + ": " + std::strerror(errno)};
+  }
+
+  // the file is usually read from start to finish
+  madvise(addr, size, MADV_SEQUENTIAL);
+
+  return MappedRegion{static_cast<const char*>(addr), size};
+}
+
+void unmap(const char* begin, const size_t size)
+{
+  munmap(const_cast<char*>(begin), size);
+}
+#endif
+} // namespace
+
+MappedFile::MappedFile(const char* begin, const size_t size)
+  : m_begin{begin}
+  , m_size{size}
+{
+}
+
+MappedFile::~MappedFile()
+{
+  if (m_begin)
+  {
+    unmap(m_begin, m_size);
+  }
+}
+
+Reader MappedFile::reader() const
+{
+  return Reader::from(begin(), end());
+}
+
+size_t MappedFile::size() const
+{
+  return m_size;
+}
+
+const char* MappedFile::begin() const
+{
+  return m_begin;
+}
+
+const char* MappedFile::end() const
+{
+  return m_begin + m_size;
+}
+
+Result<std::shared_ptr<MappedFile>> createMappedFile(const std::filesystem::path& path)
+{
+  return mapPath(path).transform([](const auto& region) {
+    // NOLINTNEXTLINE
+    return std::shared_ptr<MappedFile>{new MappedFile{region.begin, region.size}};
+  });
+}
+
 FileView::FileView(std::shared_ptr<File> file, const size_t offset, const size_t length)
   : m_file{std::move(file)}
   , m_offset{offset}
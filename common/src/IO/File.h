@@ -126,6 +126,50 @@ private:
 
 Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path& path);
 
+/**
+ * A file that is backed by a physical file on the disk which is mapped into memory. The
+ * mapping is created when the file is opened and released in the destructor.
+ *
+ * Since the contents of the file are accessed directly through the mapping, readers of
+ * this file and any buffers or string views obtained from them do not copy the file
+ * contents. They must not outlive the file.
+ */
+class MappedFile : public File
+{
+private:
+  const char* m_begin;
+  size_t m_size;
+
+  /**
+   * Creates a new file with the given mapped memory region and size in bytes.
+   */
+  MappedFile(const char* begin, size_t size);
+
+public:
+  friend Result<std::shared_ptr<MappedFile>> createMappedFile(
+    const std::filesystem::path& path);
+
+  ~MappedFile() override;
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  Reader reader() const override;
+  size_t size() const override;
+
+  /**
+   * Returns the beginning of the mapped memory region.
+   */
+  const char* begin() const;
+
+  /**
+   * Returns the end of the mapped memory region.
+   */
+  const char* end() const;
+};
+
+Result<std::shared_ptr<MappedFile>> createMappedFile(const std::filesystem::path& path);
+
 /**
  * A file that is backed by a portion of a physical file.
  */
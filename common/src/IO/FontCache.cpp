@@ -0,0 +1,164 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FontCache.h"
+
+#include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Renderer/FontDescriptor.h"
+#include "Renderer/FontGlyph.h"
+#include "Renderer/FontTexture.h"
+#include "Renderer/TextureFont.h"
+
+#include "kdl/result.h"
+#include "kdl/string_utils.h"
+
+#include <fmt/format.h>
+
+#include <cassert>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+constexpr auto Magic = std::string_view{"TBFC"};
+
+// must be incremented whenever the format of the cache changes
+constexpr auto Version = uint32_t(1);
+
+constexpr auto MaxTextureSize = size_t(16384);
+
+Renderer::FontGlyph readGlyph(Reader& reader, const size_t textureSize)
+{
+  const auto x = reader.readSize<uint32_t>();
+  const auto y = reader.readSize<uint32_t>();
+  const auto width = reader.readSize<uint32_t>();
+  const auto height = reader.readSize<uint32_t>();
+  const auto advance = reader.readSize<uint32_t>();
+  if (x + width > textureSize || y + height > textureSize)
+  {
+    throw ReaderException{"Invalid glyph bounds"};
+  }
+  return Renderer::FontGlyph{x, y, width, height, advance};
+}
+
+} // namespace
+
+std::filesystem::path fontCachePath(
+  const std::filesystem::path& cacheDirectory,
+  const Renderer::FontDescriptor& fontDescriptor)
+{
+  const auto id = fmt::format(
+    "{} {} {} {}",
+    fontDescriptor.path().u8string(),
+    fontDescriptor.size(),
+    int(fontDescriptor.minChar()),
+    int(fontDescriptor.charCount()));
+  return cacheDirectory / fmt::format("{:016x}.tbfc", kdl::str_hash(id));
+}
+
+std::string fontCacheKey(
+  const std::string_view fontData, const Renderer::FontDescriptor& fontDescriptor)
+{
+  return fmt::format(
+    "{:016x} {} {} {} {}",
+    kdl::str_hash(fontData),
+    fontData.size(),
+    fontDescriptor.size(),
+    int(fontDescriptor.minChar()),
+    int(fontDescriptor.charCount()));
+}
+
+void writeFontCache(
+  const Renderer::TextureFont& font, const std::string_view key, std::ostream& stream)
+{
+  const auto& texture = font.texture();
+  assert(texture.buffer() != nullptr);
+
+  auto writer = CacheWriter{stream};
+  writer.writeHeader(Magic, Version);
+  writer.writeString(key);
+
+  writer.write(int32_t(font.ascend()));
+  writer.write(int32_t(font.descend()));
+  writer.write(int32_t(font.lineHeight()));
+  writer.write(uint8_t(font.firstChar()));
+  writer.write(uint8_t(font.charCount()));
+
+  writer.writeSize(texture.size());
+  writer.writeBytes(texture.buffer(), texture.size() * texture.size());
+
+  for (const auto& glyph : font.glyphs())
+  {
+    writer.write(uint32_t(glyph.x()));
+    writer.write(uint32_t(glyph.y()));
+    writer.write(uint32_t(glyph.width()));
+    writer.write(uint32_t(glyph.height()));
+    writer.write(uint32_t(glyph.advance()));
+  }
+}
+
+Result<std::unique_ptr<Renderer::TextureFont>> readFontCache(
+  Reader reader, const std::string_view key)
+{
+  return readCacheHeader(reader, Magic, Version, key, "font cache")
+    .and_then([&]() -> Result<std::unique_ptr<Renderer::TextureFont>> {
+      try
+      {
+        const auto ascend = int(read<int32_t>(reader));
+        const auto descend = int(read<int32_t>(reader));
+        const auto lineHeight = int(read<int32_t>(reader));
+        const auto firstChar = read<uint8_t>(reader);
+        const auto charCount = read<uint8_t>(reader);
+
+        const auto textureSize = readSize(reader);
+        if (textureSize == 0 || textureSize > MaxTextureSize)
+        {
+          throw ReaderException{"Invalid texture size " + std::to_string(textureSize)};
+        }
+
+        auto buffer = std::vector<char>(textureSize * textureSize);
+        reader.read(buffer.data(), buffer.size());
+        auto texture =
+          std::make_unique<Renderer::FontTexture>(textureSize, buffer.data());
+
+        auto glyphs = std::vector<Renderer::FontGlyph>{};
+        glyphs.reserve(charCount);
+        for (size_t i = 0; i < charCount; ++i)
+        {
+          glyphs.push_back(readGlyph(reader, textureSize));
+        }
+
+        return std::make_unique<Renderer::TextureFont>(
+          std::move(texture), glyphs, ascend, descend, lineHeight, firstChar, charCount);
+      }
+      catch (const ReaderException& e)
+      {
+        return Error{"Malformed font cache: " + std::string{e.what()}};
+      }
+    });
+}
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace TrenchBroom::Renderer
+{
+class FontDescriptor;
+class TextureFont;
+} // namespace TrenchBroom::Renderer
+
+namespace TrenchBroom::IO
+{
+class Reader;
+
+/**
+ * A font cache is a binary file that stores the glyph atlas and the metrics of a texture
+ * font. Reading a font from its cache skips rasterizing its glyphs.
+ *
+ * A cache is identified by a key which is computed from the contents of the font file,
+ * the font size and the character range. A cache is only read if its key matches the key
+ * of the font to create.
+ */
+
+/**
+ * Returns the path of the cache file for the given font in the given cache directory.
+ */
+std::filesystem::path fontCachePath(
+  const std::filesystem::path& cacheDirectory,
+  const Renderer::FontDescriptor& fontDescriptor);
+
+/**
+ * Computes the key of a cache for the given font, whose font file has the given
+ * contents.
+ */
+std::string fontCacheKey(
+  std::string_view fontData, const Renderer::FontDescriptor& fontDescriptor);
+
+/**
+ * Writes the given font to the given stream, which must be opened in binary mode. The
+ * font's texture must not have been uploaded yet.
+ */
+void writeFontCache(
+  const Renderer::TextureFont& font, std::string_view key, std::ostream& stream);
+
+/**
+ * Reads a font from the given reader. Returns an error if the cache is malformed or if
+ * its key does not match the given key.
+ */
+Result<std::unique_ptr<Renderer::TextureFont>> readFontCache(
+  Reader reader, std::string_view key);
+
+} // namespace TrenchBroom::IO
@@ -609,21 +609,7 @@ GameConfigParser::GameConfigParser(
 
 Model::GameConfig GameConfigParser::parse()
 {
-  using Model::GameConfig;
-
-  const auto root = parseConfigFile().evaluate(EL::EvaluationContext());
-  expectType(root, EL::ValueType::Map);
-
-  const auto& version = root["version"];
-  checkVersion(version);
-  m_version = version.integerValue();
-
-  expectStructure(
-    root,
-    R"([
-      {'version': 'Number', 'name': 'String', 'fileformats': 'Array', 'filesystem': 'Map', 'textures': 'Map', 'entities': 'Map'},
-      {'icon': 'String', 'experimental': 'Boolean', 'faceattribs': 'Map', 'tags': 'Map', 'softMapBounds': 'String'}
-    ])");
+  const auto root = parseRoot();
 
   auto mapFormatConfigs = parseMapFormatConfigs(root["fileformats"]);
   auto fileSystemConfig = parseFileSystemConfig(root["filesystem"]);
@@ -650,6 +636,51 @@ Model::GameConfig GameConfigParser::parse()
   };
 }
 
+Model::GameConfigHeader GameConfigParser::parseHeader()
+{
+  const auto root = parseRoot();
+
+  return {
+    root["name"].stringValue(),
+    m_path,
+    std::filesystem::path{root["icon"].stringValue()},
+    root["experimental"].booleanValue(),
+    parseMapFormatConfigs(root["fileformats"]),
+  };
+}
+
+EL::Value GameConfigParser::parseRoot()
+{
+  auto root = parseConfigFile().evaluate(EL::EvaluationContext());
+  expectType(root, EL::ValueType::Map);
+
+  const auto& version = root["version"];
+  checkVersion(version);
+  m_version = version.integerValue();
+
+  expectStructure(
+    root,
+    R"([
+      {
+        'version': 'Number',
+        'name': 'String',
+        'fileformats': 'Array',
+        'filesystem': 'Map',
+        'textures': 'Map',
+        'entities': 'Map'
+      },
+      {
+        'icon': 'String',
+        'experimental': 'Boolean',
+        'faceattribs': 'Map',
+        'tags': 'Map',
+        'softMapBounds': 'String'
+      }
+    ])");
+
+  return root;
+}
+
 std::optional<vm::bbox3> parseSoftMapBoundsString(const std::string& string)
 {
   if (const auto v = vm::parse<double, 6u>(string))
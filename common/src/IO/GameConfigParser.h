@@ -50,7 +50,17 @@ public:
 
   Model::GameConfig parse();
 
+  /**
+   * Parses only the name, icon, experimental flag and file formats of the game
+   * configuration. The top level structure of the configuration is validated, but its
+   * other sections are not parsed.
+   */
+  Model::GameConfigHeader parseHeader();
+
   deleteCopyAndMove(GameConfigParser);
+
+private:
+  EL::Value parseRoot();
 };
 
 std::optional<vm::bbox3> parseSoftMapBoundsString(const std::string& string);
@@ -0,0 +1,313 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Gzip.h"
+
+#include "kdl/string_compare.h"
+
+#include <miniz/miniz.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+// see RFC 1952
+constexpr auto HeaderSize = size_t{10};
+constexpr auto TrailerSize = size_t{8};
+
+constexpr auto FlagHeaderCrc = 0x02;
+constexpr auto FlagExtra = 0x04;
+constexpr auto FlagName = 0x08;
+constexpr auto FlagComment = 0x10;
+
+uint32_t readUint32(const std::string_view data, const size_t offset)
+{
+  auto result = uint32_t{0};
+  for (size_t i = 0; i < 4; ++i)
+  {
+    result |= uint32_t(static_cast<unsigned char>(data[offset + i])) << (8 * i);
+  }
+  return result;
+}
+
+void writeUint32(std::ostream& stream, const uint32_t value)
+{
+  for (size_t i = 0; i < 4; ++i)
+  {
+    stream.put(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+/**
+ * Returns the offset of the compressed data, or nothing if the header is malformed.
+ */
+std::optional<size_t> skipHeader(const std::string_view data)
+{
+  const auto flags = static_cast<unsigned char>(data[3]);
+  auto offset = HeaderSize;
+
+  const auto skipString = [&]() {
+    const auto end = data.find('\0', offset);
+    offset = end != std::string_view::npos ? end + 1 : data.size();
+  };
+
+  if (flags & FlagExtra)
+  {
+    if (offset + 2 > data.size())
+    {
+      return std::nullopt;
+    }
+    const auto length = size_t(static_cast<unsigned char>(data[offset]))
+                        | size_t(static_cast<unsigned char>(data[offset + 1])) << 8;
+    offset += 2 + length;
+  }
+  if (flags & FlagName)
+  {
+    skipString();
+  }
+  if (flags & FlagComment)
+  {
+    skipString();
+  }
+  if (flags & FlagHeaderCrc)
+  {
+    offset += 2;
+  }
+
+  if (offset + TrailerSize > data.size())
+  {
+    return std::nullopt;
+  }
+  return offset;
+}
+
+} // namespace
+
+bool isGzipPath(const std::filesystem::path& path)
+{
+  return kdl::ci::str_is_equal(path.extension().string(), ".gz");
+}
+
+bool isGzipped(const std::string_view data)
+{
+  return data.size() >= 3 && static_cast<unsigned char>(data[0]) == 0x1f
+         && static_cast<unsigned char>(data[1]) == 0x8b && data[2] == MZ_DEFLATED;
+}
+
+Result<std::string> gunzip(const std::string_view data)
+{
+  if (!isGzipped(data) || data.size() < HeaderSize + TrailerSize)
+  {
+    return Error{"Invalid gzip header"};
+  }
+
+  const auto offset = skipHeader(data);
+  if (!offset)
+  {
+    return Error{"Invalid gzip header"};
+  }
+
+  const auto expectedCrc = readUint32(data, data.size() - TrailerSize);
+  const auto expectedSize = readUint32(data, data.size() - 4);
+
+  auto stream = mz_stream{};
+  if (mz_inflateInit2(&stream, -MZ_DEFAULT_WINDOW_BITS) != MZ_OK)
+  {
+    return Error{"Could not initialize decompression"};
+  }
+
+  stream.next_in = reinterpret_cast<const unsigned char*>(data.data() + *offset);
+  stream.avail_in = static_cast<unsigned int>(data.size() - TrailerSize - *offset);
+
+  // the size in the trailer is only a hint because it is stored modulo 2^32
+  auto result = std::string{};
+  result.resize(std::max(size_t(expectedSize), size_t(1)));
+
+  auto decompressedSize = size_t{0};
+  auto status = MZ_OK;
+  while (status != MZ_STREAM_END)
+  {
+    if (decompressedSize == result.size())
+    {
+      result.resize(result.size() * 2);
+    }
+
+    stream.next_out = reinterpret_cast<unsigned char*>(result.data() + decompressedSize);
+    stream.avail_out = static_cast<unsigned int>(result.size() - decompressedSize);
+    status = mz_inflate(&stream, MZ_NO_FLUSH);
+    decompressedSize = result.size() - stream.avail_out;
+
+    if (status != MZ_OK && status != MZ_STREAM_END)
+    {
+      mz_inflateEnd(&stream);
+      return Error{
+        status == MZ_BUF_ERROR ? "Truncated gzip data" : "Invalid gzip data"};
+    }
+  }
+  mz_inflateEnd(&stream);
+  result.resize(decompressedSize);
+
+  const auto crc = mz_crc32(
+    MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(result.data()), result.size());
+  if (
+    uint32_t(crc) != expectedCrc || uint32_t(result.size() & 0xffffffff) != expectedSize)
+  {
+    return Error{"Gzip checksum mismatch"};
+  }
+
+  return result;
+}
+
+GzipStreamBuffer::GzipStreamBuffer(std::ostream& target)
+  : m_target{target}
+  , m_stream{std::make_unique<mz_stream>()}
+  , m_chunks{std::vector<char>(ChunkSize), std::vector<char>(ChunkSize)}
+  , m_output(ChunkSize)
+  , m_crc{MZ_CRC32_INIT}
+{
+  if (
+    mz_deflateInit2(
+      m_stream.get(),
+      MZ_DEFAULT_LEVEL,
+      MZ_DEFLATED,
+      -MZ_DEFAULT_WINDOW_BITS,
+      9,
+      MZ_DEFAULT_STRATEGY)
+    != MZ_OK)
+  {
+    m_error = Error{"Could not initialize compression"};
+  }
+
+  // magic number, compression method, no flags, no modification time, no extra flags,
+  // unknown operating system
+  static const char header[HeaderSize] = {
+    '\x1f', '\x8b', '\x08', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xff'};
+  m_target.write(header, HeaderSize);
+
+  auto& chunk = m_chunks[m_currentChunk];
+  setp(chunk.data(), chunk.data() + chunk.size());
+}
+
+GzipStreamBuffer::~GzipStreamBuffer()
+{
+  if (m_pendingChunk.valid())
+  {
+    m_pendingChunk.wait();
+  }
+  mz_deflateEnd(m_stream.get());
+}
+
+Result<void> GzipStreamBuffer::finish()
+{
+  assert(!m_finished);
+  m_finished = true;
+
+  return waitForPendingChunk()
+    .and_then([&]() {
+      return compress(pbase(), size_t(pptr() - pbase()), MZ_FINISH);
+    })
+    .and_then([&]() -> Result<void> {
+      setp(nullptr, nullptr);
+
+      writeUint32(m_target, uint32_t(m_crc));
+      writeUint32(m_target, m_size);
+      if (!m_target)
+      {
+        return Error{"Could not write compressed data"};
+      }
+      return kdl::void_success;
+    });
+}
+
+GzipStreamBuffer::int_type GzipStreamBuffer::overflow(const int_type c)
+{
+  if (m_finished || !waitForPendingChunk().is_success())
+  {
+    return traits_type::eof();
+  }
+
+  // compress the full chunk in the background while the other chunk is filled
+  const auto* data = pbase();
+  const auto size = size_t(pptr() - pbase());
+  m_pendingChunk = std::async(std::launch::async, [this, data, size]() {
+    return compress(data, size, MZ_NO_FLUSH);
+  });
+
+  m_currentChunk = 1u - m_currentChunk;
+  auto& chunk = m_chunks[m_currentChunk];
+  setp(chunk.data(), chunk.data() + chunk.size());
+
+  if (!traits_type::eq_int_type(c, traits_type::eof()))
+  {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+Result<void> GzipStreamBuffer::waitForPendingChunk()
+{
+  if (m_pendingChunk.valid())
+  {
+    m_pendingChunk.get().transform_error([&](auto e) { m_error = std::move(e); });
+  }
+  if (m_error)
+  {
+    return *m_error;
+  }
+  return kdl::void_success;
+}
+
+Result<void> GzipStreamBuffer::compress(
+  const char* data, const size_t size, const int flush)
+{
+  m_crc = mz_crc32(m_crc, reinterpret_cast<const unsigned char*>(data), size);
+  m_size += uint32_t(size & 0xffffffff);
+
+  m_stream->next_in = reinterpret_cast<const unsigned char*>(data);
+  m_stream->avail_in = static_cast<unsigned int>(size);
+
+  do
+  {
+    m_stream->next_out = m_output.data();
+    m_stream->avail_out = static_cast<unsigned int>(m_output.size());
+
+    const auto status = mz_deflate(m_stream.get(), flush);
+    if (status != MZ_OK && status != MZ_STREAM_END && status != MZ_BUF_ERROR)
+    {
+      return Error{"Could not compress data"};
+    }
+
+    const auto compressedSize = m_output.size() - m_stream->avail_out;
+    m_target.write(
+      reinterpret_cast<const char*>(m_output.data()),
+      static_cast<std::streamsize>(compressedSize));
+    if (!m_target)
+    {
+      return Error{"Could not write compressed data"};
+    }
+  } while (m_stream->avail_out == 0);
+
+  return kdl::void_success;
+}
+
+} // namespace TrenchBroom::IO
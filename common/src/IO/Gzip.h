@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Error.h"
+#include "Result.h"
+
+#include "kdl/result.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct mz_stream_s;
+
+namespace TrenchBroom::IO
+{
+
+/**
+ * Returns whether the file at the given path should be written with gzip compression,
+ * which is the case if its extension is .gz.
+ */
+bool isGzipPath(const std::filesystem::path& path);
+
+/**
+ * Returns whether the given data starts with the gzip magic number.
+ */
+bool isGzipped(std::string_view data);
+
+/**
+ * Decompresses the given gzip data. Returns an error if the data is malformed, truncated
+ * or if its checksum does not match.
+ */
+Result<std::string> gunzip(std::string_view data);
+
+/**
+ * A stream buffer that compresses everything written to it in gzip format and writes
+ * the compressed data to a target stream.
+ *
+ * The data is collected in chunks. A full chunk is compressed on a background thread
+ * while the next chunk is being filled, so that compression overlaps with producing the
+ * data. Call finish after writing all data to compress the remaining data and to write
+ * the gzip trailer.
+ */
+class GzipStreamBuffer : public std::streambuf
+{
+private:
+  static constexpr size_t ChunkSize = 1u << 20;
+
+  std::ostream& m_target;
+  std::unique_ptr<mz_stream_s> m_stream;
+  std::vector<char> m_chunks[2];
+  size_t m_currentChunk = 0;
+  std::vector<unsigned char> m_output;
+  std::future<Result<void>> m_pendingChunk;
+  unsigned long m_crc;
+  uint32_t m_size = 0;
+  bool m_finished = false;
+  std::optional<Error> m_error;
+
+public:
+  /**
+   * Creates a stream buffer that writes to the given stream, which must be opened in
+   * binary mode.
+   */
+  explicit GzipStreamBuffer(std::ostream& target);
+  ~GzipStreamBuffer() override;
+
+  /**
+   * Compresses any remaining data and writes the gzip trailer. Returns an error if the
+   * data could not be compressed or written.
+   */
+  Result<void> finish();
+
+protected:
+  int_type overflow(int_type c) override;
+
+private:
+  Result<void> waitForPendingChunk();
+  Result<void> compress(const char* data, size_t size, int flush);
+};
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,639 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImageDecoder.h"
+
+#include "IO/TextureUtils.h"
+#include "Macros.h"
+
+#include <miniz/miniz.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+
+uint32_t readUint32BE(const uint8_t* data)
+{
+  return uint32_t(data[0]) << 24 | uint32_t(data[1]) << 16 | uint32_t(data[2]) << 8
+         | uint32_t(data[3]);
+}
+
+uint16_t readUint16BE(const uint8_t* data)
+{
+  return uint16_t(data[0] << 8 | data[1]);
+}
+
+uint16_t readUint16LE(const uint8_t* data)
+{
+  return uint16_t(data[0] | data[1] << 8);
+}
+
+std::optional<DecodedImage> createImage(const size_t width, const size_t height)
+{
+  if (!checkTextureDimensions(width, height))
+  {
+    return std::nullopt;
+  }
+  return DecodedImage{width, height, Assets::TextureBuffer{width * height * 4}, false};
+}
+
+// see https://www.w3.org/TR/png/
+
+constexpr auto PngSignature =
+  std::array<uint8_t, 8>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+enum class PngColorType : uint8_t
+{
+  Grayscale = 0,
+  TrueColor = 2,
+  Indexed = 3,
+  GrayscaleAlpha = 4,
+  TrueColorAlpha = 6,
+};
+
+struct PngHeader
+{
+  size_t width;
+  size_t height;
+  size_t bitDepth;
+  PngColorType colorType;
+};
+
+/**
+ * The chunks of a PNG image that are needed to decode it. The data pointers refer into
+ * the image data.
+ */
+struct PngChunks
+{
+  PngHeader header;
+  std::vector<std::array<uint8_t, 4>> palette;
+  // the alpha values of the palette entries or the transparent color
+  const uint8_t* transparency = nullptr;
+  size_t transparencySize = 0;
+  // the concatenation of the image data chunks forms one zlib stream
+  std::vector<std::pair<const uint8_t*, size_t>> imageData;
+};
+
+std::optional<PngHeader> parsePngHeader(const uint8_t* data, const size_t size)
+{
+  if (size != 13)
+  {
+    return std::nullopt;
+  }
+
+  const auto header = PngHeader{
+    readUint32BE(data),
+    readUint32BE(data + 4),
+    data[8],
+    PngColorType(data[9]),
+  };
+  const auto compression = data[10];
+  const auto filter = data[11];
+  const auto interlace = data[12];
+
+  // 16 bit images and interlaced images are left to FreeImage
+  if (compression != 0 || filter != 0 || interlace != 0)
+  {
+    return std::nullopt;
+  }
+
+  switch (header.colorType)
+  {
+  case PngColorType::Grayscale:
+  case PngColorType::Indexed:
+    if (
+      header.bitDepth != 1 && header.bitDepth != 2 && header.bitDepth != 4
+      && header.bitDepth != 8)
+    {
+      return std::nullopt;
+    }
+    break;
+  case PngColorType::TrueColor:
+  case PngColorType::GrayscaleAlpha:
+  case PngColorType::TrueColorAlpha:
+    if (header.bitDepth != 8)
+    {
+      return std::nullopt;
+    }
+    break;
+  default:
+    return std::nullopt;
+  }
+
+  return header;
+}
+
+std::optional<PngChunks> parsePngChunks(const uint8_t* begin, const size_t size)
+{
+  if (
+    size < PngSignature.size()
+    || !std::equal(PngSignature.begin(), PngSignature.end(), begin))
+  {
+    return std::nullopt;
+  }
+
+  auto result = PngChunks{};
+  auto hasHeader = false;
+
+  auto offset = PngSignature.size();
+  while (offset + 12 <= size)
+  {
+    const auto* chunk = begin + offset;
+    const auto length = size_t(readUint32BE(chunk));
+    if (length > size - offset - 12)
+    {
+      return std::nullopt;
+    }
+
+    const auto* type = chunk + 4;
+    const auto* data = chunk + 8;
+    const auto crc = readUint32BE(data + length);
+    if (uint32_t(mz_crc32(MZ_CRC32_INIT, type, length + 4)) != crc)
+    {
+      return std::nullopt;
+    }
+    offset += length + 12;
+
+    const auto isType = [&](const char* name) { return std::memcmp(type, name, 4) == 0; };
+    if (isType("IHDR"))
+    {
+      const auto header = parsePngHeader(data, length);
+      if (!header)
+      {
+        return std::nullopt;
+      }
+      result.header = *header;
+      hasHeader = true;
+    }
+    else if (!hasHeader)
+    {
+      // the header must be the first chunk
+      return std::nullopt;
+    }
+    else if (isType("PLTE"))
+    {
+      if (length % 3 != 0 || length / 3 > 256)
+      {
+        return std::nullopt;
+      }
+      for (size_t i = 0; i < length; i += 3)
+      {
+        result.palette.push_back({data[i], data[i + 1], data[i + 2], 0xff});
+      }
+    }
+    else if (isType("tRNS"))
+    {
+      result.transparency = data;
+      result.transparencySize = length;
+    }
+    else if (isType("IDAT"))
+    {
+      result.imageData.emplace_back(data, length);
+    }
+    else if (isType("IEND"))
+    {
+      break;
+    }
+    else if ((type[0] & 0x20) == 0)
+    {
+      // an unknown chunk that is critical for displaying the image
+      return std::nullopt;
+    }
+  }
+
+  if (!hasHeader || result.imageData.empty())
+  {
+    return std::nullopt;
+  }
+
+  if (result.header.colorType == PngColorType::Indexed)
+  {
+    if (result.palette.empty())
+    {
+      return std::nullopt;
+    }
+    for (size_t i = 0; i < std::min(result.transparencySize, result.palette.size()); ++i)
+    {
+      result.palette[i][3] = result.transparency[i];
+    }
+  }
+
+  return result;
+}
+
+size_t pngChannelCount(const PngColorType colorType)
+{
+  switch (colorType)
+  {
+  case PngColorType::Grayscale:
+  case PngColorType::Indexed:
+    return 1;
+  case PngColorType::GrayscaleAlpha:
+    return 2;
+  case PngColorType::TrueColor:
+    return 3;
+  case PngColorType::TrueColorAlpha:
+    return 4;
+    switchDefault();
+  }
+}
+
+uint8_t paethPredictor(const uint8_t a, const uint8_t b, const uint8_t c)
+{
+  const auto p = int(a) + int(b) - int(c);
+  const auto pa = std::abs(p - int(a));
+  const auto pb = std::abs(p - int(b));
+  const auto pc = std::abs(p - int(c));
+  return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+/**
+ * Reverses the filter of the given scanline in place. The previous scanline has already
+ * been unfiltered and is all zeros for the first scanline.
+ */
+bool unfilterScanline(
+  const uint8_t filter,
+  uint8_t* row,
+  const uint8_t* previousRow,
+  const size_t rowSize,
+  const size_t bytesPerPixel)
+{
+  switch (filter)
+  {
+  case 0:
+    return true;
+  case 1:
+    for (size_t i = bytesPerPixel; i < rowSize; ++i)
+    {
+      row[i] = uint8_t(row[i] + row[i - bytesPerPixel]);
+    }
+    return true;
+  case 2:
+    for (size_t i = 0; i < rowSize; ++i)
+    {
+      row[i] = uint8_t(row[i] + previousRow[i]);
+    }
+    return true;
+  case 3:
+    for (size_t i = 0; i < rowSize; ++i)
+    {
+      const auto left = i >= bytesPerPixel ? row[i - bytesPerPixel] : 0;
+      row[i] = uint8_t(row[i] + (left + previousRow[i]) / 2);
+    }
+    return true;
+  case 4:
+    for (size_t i = 0; i < rowSize; ++i)
+    {
+      const auto left = i >= bytesPerPixel ? row[i - bytesPerPixel] : uint8_t(0);
+      const auto upperLeft =
+        i >= bytesPerPixel ? previousRow[i - bytesPerPixel] : uint8_t(0);
+      row[i] = uint8_t(row[i] + paethPredictor(left, previousRow[i], upperLeft));
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * Converts an unfiltered scanline to RGBA. Returns whether any of the pixels is not
+ * fully opaque, or nothing if the scanline refers to a missing palette entry.
+ */
+std::optional<bool> convertScanline(
+  const PngChunks& chunks, const uint8_t* row, uint8_t* out)
+{
+  const auto& header = chunks.header;
+  const auto width = header.width;
+  auto masked = false;
+
+  switch (header.colorType)
+  {
+  case PngColorType::Grayscale:
+  case PngColorType::Indexed: {
+    const auto bitDepth = header.bitDepth;
+    const auto mask = uint8_t((1u << bitDepth) - 1u);
+    const auto scale = uint8_t(255u / mask);
+    // the transparent gray value is stored as a 16 bit value
+    const auto transparentGray = chunks.transparencySize >= 2
+                                   ? std::optional{readUint16BE(chunks.transparency)}
+                                   : std::nullopt;
+
+    for (size_t x = 0; x < width; ++x)
+    {
+      const auto bit = x * bitDepth;
+      const auto shift = 8u - bitDepth - bit % 8u;
+      const auto value = uint8_t((row[bit / 8u] >> shift) & mask);
+
+      if (header.colorType == PngColorType::Indexed)
+      {
+        if (value >= chunks.palette.size())
+        {
+          return std::nullopt;
+        }
+        std::memcpy(out, chunks.palette[value].data(), 4);
+      }
+      else
+      {
+        const auto transparent = transparentGray == value;
+        out[0] = out[1] = out[2] = uint8_t(value * scale);
+        out[3] = transparent ? 0 : 0xff;
+      }
+      masked |= out[3] != 0xff;
+      out += 4;
+    }
+    break;
+  }
+  case PngColorType::GrayscaleAlpha:
+    for (size_t x = 0; x < width; ++x)
+    {
+      out[0] = out[1] = out[2] = row[0];
+      out[3] = row[1];
+      masked |= out[3] != 0xff;
+      row += 2;
+      out += 4;
+    }
+    break;
+  case PngColorType::TrueColor: {
+    // the transparent color is stored as three 16 bit values
+    const auto transparentColor =
+      chunks.transparencySize >= 6
+        ? std::optional{std::array<uint16_t, 3>{
+          readUint16BE(chunks.transparency),
+          readUint16BE(chunks.transparency + 2),
+          readUint16BE(chunks.transparency + 4)}}
+        : std::nullopt;
+
+    for (size_t x = 0; x < width; ++x)
+    {
+      const auto transparent =
+        transparentColor == std::array<uint16_t, 3>{row[0], row[1], row[2]};
+      out[0] = row[0];
+      out[1] = row[1];
+      out[2] = row[2];
+      out[3] = transparent ? 0 : 0xff;
+      masked |= transparent;
+      row += 3;
+      out += 4;
+    }
+    break;
+  }
+  case PngColorType::TrueColorAlpha:
+    std::memcpy(out, row, width * 4);
+    for (size_t x = 0; x < width; ++x)
+    {
+      masked |= row[x * 4 + 3] != 0xff;
+    }
+    break;
+  }
+
+  return masked;
+}
+
+/**
+ * Inflates the scanlines one at a time, so that only the current and the previous
+ * scanline are kept in memory, and writes them to the given image.
+ */
+bool decodePngScanlines(const PngChunks& chunks, mz_stream& stream, DecodedImage& image)
+{
+  const auto& header = chunks.header;
+  const auto bitsPerPixel = pngChannelCount(header.colorType) * header.bitDepth;
+  const auto bytesPerPixel = std::max(bitsPerPixel / 8u, size_t(1));
+  const auto rowSize = (header.width * bitsPerPixel + 7u) / 8u;
+
+  // every scanline is preceded by its filter type
+  auto scanline = std::vector<uint8_t>(rowSize + 1u);
+  auto previousRow = std::vector<uint8_t>(rowSize, 0);
+  auto* row = scanline.data() + 1;
+
+  auto nextChunk = chunks.imageData.begin();
+  for (size_t y = 0; y < header.height; ++y)
+  {
+    stream.next_out = scanline.data();
+    stream.avail_out = static_cast<unsigned int>(scanline.size());
+
+    while (stream.avail_out > 0)
+    {
+      if (stream.avail_in == 0)
+      {
+        if (nextChunk == chunks.imageData.end())
+        {
+          return false;
+        }
+        stream.next_in = nextChunk->first;
+        stream.avail_in = static_cast<unsigned int>(nextChunk->second);
+        ++nextChunk;
+      }
+
+      const auto status = mz_inflate(&stream, MZ_NO_FLUSH);
+      if (status != MZ_OK && !(status == MZ_STREAM_END && stream.avail_out == 0))
+      {
+        return false;
+      }
+    }
+
+    if (!unfilterScanline(scanline[0], row, previousRow.data(), rowSize, bytesPerPixel))
+    {
+      return false;
+    }
+
+    const auto masked =
+      convertScanline(chunks, row, image.buffer.data() + y * header.width * 4u);
+    if (!masked)
+    {
+      return false;
+    }
+
+    image.masked |= *masked;
+    std::copy(row, row + rowSize, previousRow.begin());
+  }
+
+  return true;
+}
+
+} // namespace
+
+std::optional<DecodedImage> decodePng(const uint8_t* begin, const size_t size)
+{
+  const auto chunks = parsePngChunks(begin, size);
+  if (!chunks)
+  {
+    return std::nullopt;
+  }
+
+  auto image = createImage(chunks->header.width, chunks->header.height);
+  if (!image)
+  {
+    return std::nullopt;
+  }
+
+  auto stream = mz_stream{};
+  if (mz_inflateInit(&stream) != MZ_OK)
+  {
+    return std::nullopt;
+  }
+
+  const auto success = decodePngScanlines(*chunks, stream, *image);
+  mz_inflateEnd(&stream);
+
+  return success ? std::move(image) : std::nullopt;
+}
+
+std::optional<DecodedImage> decodeTga(const uint8_t* begin, const size_t size)
+{
+  // see http://www.paulbourke.net/dataformats/tga/
+  constexpr auto HeaderSize = size_t(18);
+  if (size < HeaderSize)
+  {
+    return std::nullopt;
+  }
+
+  const auto idLength = size_t(begin[0]);
+  const auto colorMapType = begin[1];
+  const auto imageType = begin[2];
+  const auto width = size_t(readUint16LE(begin + 12));
+  const auto height = size_t(readUint16LE(begin + 14));
+  const auto pixelDepth = size_t(begin[16]);
+  const auto descriptor = begin[17];
+
+  const auto grayscale = imageType == 3 || imageType == 11;
+  const auto compressed = imageType == 10 || imageType == 11;
+
+  // color mapped images, 16 bit images and right to left images are left to FreeImage
+  if (
+    colorMapType != 0 || (imageType != 2 && imageType != 3 && !compressed)
+    || (grayscale && pixelDepth != 8)
+    || (!grayscale && pixelDepth != 24 && pixelDepth != 32) || (descriptor & 0x10) != 0)
+  {
+    return std::nullopt;
+  }
+
+  auto image = createImage(width, height);
+  if (!image)
+  {
+    return std::nullopt;
+  }
+
+  const auto bytesPerPixel = pixelDepth / 8u;
+  const auto topToBottom = (descriptor & 0x20) != 0;
+
+  const auto* data = begin + HeaderSize + idLength;
+  const auto* end = begin + size;
+  if (data > end)
+  {
+    return std::nullopt;
+  }
+
+  // writes the given BGR(A) or grayscale pixel to the next position in the image
+  auto* out = image->buffer.data();
+  auto pixelIndex = size_t(0);
+  const auto pixelCount = width * height;
+  const auto writePixel = [&](const uint8_t* pixel) {
+    const auto x = pixelIndex % width;
+    const auto y = topToBottom ? pixelIndex / width : height - 1u - pixelIndex / width;
+    auto* dest = out + (y * width + x) * 4u;
+
+    if (grayscale)
+    {
+      dest[0] = dest[1] = dest[2] = pixel[0];
+      dest[3] = 0xff;
+    }
+    else
+    {
+      dest[0] = pixel[2];
+      dest[1] = pixel[1];
+      dest[2] = pixel[0];
+      dest[3] = bytesPerPixel == 4 ? pixel[3] : uint8_t(0xff);
+    }
+    image->masked |= dest[3] != 0xff;
+    ++pixelIndex;
+  };
+
+  if (!compressed)
+  {
+    if (size_t(end - data) < pixelCount * bytesPerPixel)
+    {
+      return std::nullopt;
+    }
+    while (pixelIndex < pixelCount)
+    {
+      writePixel(data);
+      data += bytesPerPixel;
+    }
+    return image;
+  }
+
+  // run length encoded packets may span several rows
+  while (pixelIndex < pixelCount)
+  {
+    if (data == end)
+    {
+      return std::nullopt;
+    }
+
+    const auto packet = *data++;
+    const auto count = std::min(size_t(packet & 0x7f) + 1u, pixelCount - pixelIndex);
+    if (packet & 0x80)
+    {
+      if (size_t(end - data) < bytesPerPixel)
+      {
+        return std::nullopt;
+      }
+      for (size_t i = 0; i < count; ++i)
+      {
+        writePixel(data);
+      }
+      data += bytesPerPixel;
+    }
+    else
+    {
+      if (size_t(end - data) < count * bytesPerPixel)
+      {
+        return std::nullopt;
+      }
+      for (size_t i = 0; i < count; ++i)
+      {
+        writePixel(data);
+        data += bytesPerPixel;
+      }
+    }
+  }
+
+  return image;
+}
+
+std::optional<DecodedImage> decodeImage(const uint8_t* begin, const size_t size)
+{
+  // TGA files have no signature, so PNG must be checked first
+  if (
+    size >= PngSignature.size()
+    && std::equal(PngSignature.begin(), PngSignature.end(), begin))
+  {
+    return decodePng(begin, size);
+  }
+  return decodeTga(begin, size);
+}
+
+} // namespace TrenchBroom::IO
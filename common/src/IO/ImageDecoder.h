@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Assets/TextureBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace TrenchBroom::IO
+{
+
+/**
+ * An image that was decoded into a single GL_RGBA buffer with the top row first.
+ */
+struct DecodedImage
+{
+  size_t width;
+  size_t height;
+  Assets::TextureBuffer buffer;
+  // whether any pixel has an alpha value below 255
+  bool masked;
+};
+
+/**
+ * Decodes a non-interlaced PNG image with 8 bits per channel, or with up to 8 bits per
+ * pixel for grayscale and palette images. The scanlines are inflated and unfiltered one
+ * at a time and written straight into the result buffer.
+ *
+ * Returns nothing if the data is not such an image or if it is malformed.
+ */
+std::optional<DecodedImage> decodePng(const uint8_t* begin, size_t size);
+
+/**
+ * Decodes an uncompressed or RLE compressed true color TGA image with 24 or 32 bits per
+ * pixel or a grayscale TGA image with 8 bits per pixel.
+ *
+ * Returns nothing if the data is not such an image or if it is malformed.
+ */
+std::optional<DecodedImage> decodeTga(const uint8_t* begin, size_t size);
+
+/**
+ * Decodes the given image data if it is a PNG or TGA image supported by decodePng or
+ * decodeTga. Other images must be loaded with FreeImage.
+ */
+std::optional<DecodedImage> decodeImage(const uint8_t* begin, size_t size);
+
+} // namespace TrenchBroom::IO
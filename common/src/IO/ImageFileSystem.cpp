@@ -241,6 +241,34 @@ void doFindImpl(
 }
 } // namespace
 
+namespace
+{
+void visitEntriesImpl(
+  const ImageDirectoryEntry& directoryEntry,
+  const std::filesystem::path& directoryPath,
+  const std::function<void(const std::filesystem::path&, PathInfo)>& visitor)
+{
+  for (const auto& childEntry : directoryEntry.entries)
+  {
+    const auto childPath = directoryPath / getName(childEntry);
+    std::visit(
+      kdl::overload(
+        [&](const ImageDirectoryEntry& childDirectoryEntry) {
+          visitor(childPath, PathInfo::Directory);
+          visitEntriesImpl(childDirectoryEntry, childPath, visitor);
+        },
+        [&](const ImageFileEntry&) { visitor(childPath, PathInfo::File); }),
+      childEntry);
+  }
+}
+} // namespace
+
+void ImageFileSystemBase::visitEntries(
+  const std::function<void(const std::filesystem::path&, PathInfo)>& visitor) const
+{
+  visitEntriesImpl(std::get<ImageDirectoryEntry>(m_root), {}, visitor);
+}
+
 Result<std::vector<std::filesystem::path>> ImageFileSystemBase::doFind(
   const std::filesystem::path& path, const TraversalMode traversalMode) const
 {
@@ -36,6 +36,7 @@ namespace TrenchBroom::IO
 {
 class CFile;
 class File;
+enum class PathInfo;
 
 using GetImageFile = std::function<Result<std::shared_ptr<File>>()>;
 
@@ -72,6 +73,13 @@ public:
    */
   Result<void> reload();
 
+  /**
+   * Calls the given function for every file and directory in this file system. The paths
+   * are relative to the root of this file system.
+   */
+  void visitEntries(
+    const std::function<void(const std::filesystem::path&, PathInfo)>& visitor) const;
+
 protected:
   void addFile(const std::filesystem::path& path, GetImageFile getFile);
 
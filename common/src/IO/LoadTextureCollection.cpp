@@ -24,6 +24,8 @@
 #include "Assets/TextureManager.h"
 #include "Ensure.h"
 #include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/FileSystem.h"
 #include "IO/PathInfo.h"
@@ -35,6 +37,7 @@
 #include "IO/ReadQuake3ShaderTexture.h"
 #include "IO/ReadWalTexture.h"
 #include "IO/ResourceUtils.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureUtils.h"
 #include "IO/TraversalMode.h"
 #include "Logger.h"
@@ -49,6 +52,9 @@
 #include "kdl/string_format.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -158,6 +164,134 @@ Result<ReadTextureFunc> makeReadTextureFunc(
     });
 }
 
+/**
+ * Creates a texture which only knows the dimensions read from the header of the given
+ * mip texture file, and which decodes the pixel data once it is loaded. Returns nothing
+ * if the given file is not a mip texture or if its header is invalid.
+ */
+std::optional<Assets::Texture> readTextureOnDemand(
+  std::shared_ptr<File> file,
+  const std::filesystem::path& path,
+  const ReadTextureFunc& readTexture)
+{
+  const auto extension = kdl::str_to_lower(path.extension().string());
+  if (extension != ".d" && extension != ".c")
+  {
+    return std::nullopt;
+  }
+
+  auto reader = file->reader();
+  const auto size = readMipTextureSize(reader);
+  if (!size)
+  {
+    return std::nullopt;
+  }
+
+  auto name = path.stem().string();
+  const auto masked = !name.empty() && name.front() == '{';
+  auto texture = Assets::Texture{
+    name, size->x(), size->y(), GL_RGBA, Assets::Texture::selectTextureType(masked)};
+  texture.setLoader(
+    [file = std::move(file), path, readTexture, name = std::move(name), size = *size]() {
+      // a texture that cannot be decoded is shown like a missing texture
+      return readTexture(*file, path)
+        .transform_error([&](auto) { return Assets::Texture{name, size.x(), size.y()}; })
+        .value();
+    });
+  return texture;
+}
+
+Result<Assets::TextureCollection> readTextureCollection(
+  const std::filesystem::path& path,
+  std::vector<std::filesystem::path> texturePaths,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig,
+  const bool loadOnDemand)
+{
+  return makeReadTextureFunc(gameFS, textureConfig)
+    .and_then([&](const auto& readTexture) {
+      auto nullLogger = NullLogger{};
+      return kdl::fold_results(
+               kdl::vec_parallel_transform(
+                 std::move(texturePaths),
+                 [&](const auto texturePath) {
+                   return gameFS.openFile(texturePath)
+                     .and_then([&](const auto& file) {
+                       if (loadOnDemand)
+                       {
+                         if (
+                           auto texture =
+                             readTextureOnDemand(file, texturePath, readTexture))
+                         {
+                           return Result<Assets::Texture, ReadTextureError>{
+                             std::move(*texture)};
+                         }
+                       }
+                       return readTexture(*file, texturePath);
+                     })
+                     .transform([&](auto texture) {
+                       gameFS.makeAbsolute(texturePath)
+                         .transform([&](auto absPath) {
+                           texture.setAbsolutePath(std::move(absPath));
+                         })
+                         .or_else([](auto) { return kdl::void_success; });
+                       texture.setRelativePath(texturePath);
+                       return texture;
+                     })
+                     .or_else(makeReadTextureErrorHandler(gameFS, nullLogger));
+                 }))
+        .transform([&](auto textures) {
+          return Assets::TextureCollection{path, std::move(textures)};
+        });
+    });
+}
+
+Result<Assets::TextureCollection> loadCachedTextureCollection(
+  const std::filesystem::path& path,
+  std::vector<std::filesystem::path> texturePaths,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig,
+  const std::filesystem::path& cacheDirectory,
+  const std::string& cacheKey,
+  Logger& logger)
+{
+  const auto cachePath = textureCachePath(cacheDirectory, path);
+  if (Disk::pathInfo(cachePath) == PathInfo::File)
+  {
+    if (
+      auto cachedCollection =
+        Disk::mapFile(cachePath)
+          .and_then([&](auto cacheFile) {
+            return readTextureCache(cacheFile->reader(), cacheKey);
+          })
+          .transform([](auto collection) { return std::optional{std::move(collection)}; })
+          .transform_error([&](auto e) -> std::optional<Assets::TextureCollection> {
+            logger.debug() << "Could not load texture cache " << cachePath << ": "
+                           << e.msg;
+            return std::nullopt;
+          })
+          .value())
+    {
+      logger.debug() << "Loaded texture collection '" << path.string()
+                     << "' from cache " << cachePath;
+      return std::move(*cachedCollection);
+    }
+  }
+
+  return readTextureCollection(
+           path, std::move(texturePaths), gameFS, textureConfig, false)
+    .transform([&](auto collection) {
+      writeCacheFile(
+        cachePath,
+        [&](auto& stream) { writeTextureCache(collection, cacheKey, stream); })
+        .transform_error([&](auto e) {
+          logger.warn() << "Could not write texture cache " << cachePath << ": "
+                        << e.msg;
+        });
+      return collection;
+    });
+}
+
 } // namespace
 
 Result<std::vector<std::filesystem::path>> findTextureCollections(
@@ -174,18 +308,11 @@ Result<std::vector<std::filesystem::path>> findTextureCollections(
     });
 }
 
-Result<Assets::TextureCollection> loadTextureCollection(
+Result<std::vector<std::filesystem::path>> findTextures(
   const std::filesystem::path& path,
   const FileSystem& gameFS,
-  const Model::TextureConfig& textureConfig,
-  Logger&)
+  const Model::TextureConfig& textureConfig)
 {
-  if (gameFS.pathInfo(path) != PathInfo::Directory)
-  {
-    return Error{
-      "Could not load texture collection '" + path.string() + "': not a directory"};
-  }
-
   const auto pathMatcher = !textureConfig.extensions.empty()
                              ? makeExtensionPathMatcher(textureConfig.extensions)
                              : matchAnyPath;
@@ -195,32 +322,77 @@ Result<Assets::TextureCollection> loadTextureCollection(
       return kdl::vec_filter(std::move(texturePaths), [&](const auto& texturePath) {
         return !shouldExclude(texturePath.stem().string(), textureConfig.excludes);
       });
-    })
-    .join(makeReadTextureFunc(gameFS, textureConfig))
-    .and_then([&](auto texturePaths, const auto& readTexture) {
-      auto nullLogger = NullLogger{};
-      return kdl::fold_results(
-               kdl::vec_parallel_transform(
-                 std::move(texturePaths),
-                 [&](const auto texturePath) {
-                   return gameFS.openFile(texturePath)
-                     .and_then([&](const auto& file) {
-                       return readTexture(*file, texturePath)
-                         .transform([&](auto texture) {
-                           gameFS.makeAbsolute(texturePath)
-                             .transform([&](auto absPath) {
-                               texture.setAbsolutePath(std::move(absPath));
-                             })
-                             .or_else([](auto) { return kdl::void_success; });
-                           texture.setRelativePath(texturePath);
-                           return texture;
-                         });
-                     })
-                     .or_else(makeReadTextureErrorHandler(gameFS, nullLogger));
-                 }))
-        .transform([&](auto textures) {
-          return Assets::TextureCollection{path, std::move(textures)};
-        });
+    });
+}
+
+Result<std::vector<Assets::Texture>> loadTextures(
+  std::vector<std::filesystem::path> texturePaths,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig)
+{
+  return readTextureCollection({}, std::move(texturePaths), gameFS, textureConfig, false)
+    .transform([](auto collection) { return std::move(collection.textures()); });
+}
+
+Result<Assets::TextureCollection> loadTextureCollection(
+  const std::filesystem::path& path,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig,
+  Logger& logger)
+{
+  return loadTextureCollection(path, gameFS, textureConfig, std::nullopt, false, logger);
+}
+
+Result<Assets::TextureCollection> loadTextureCollection(
+  const std::filesystem::path& path,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig,
+  const std::optional<std::filesystem::path>& cacheDirectory,
+  const bool loadOnDemand,
+  Logger& logger)
+{
+  if (gameFS.pathInfo(path) != PathInfo::Directory)
+  {
+    return Error{
+      "Could not load texture collection '" + path.string() + "': not a directory"};
+  }
+
+  return findTextures(path, gameFS, textureConfig)
+    .and_then([&](auto texturePaths) {
+      // Quake 3 shaders refer to other files, so they cannot be cached
+      if (
+        !cacheDirectory || loadOnDemand
+        || std::any_of(texturePaths.begin(), texturePaths.end(), [](const auto& p) {
+             return p.extension().empty();
+           }))
+      {
+        return readTextureCollection(
+          path, std::move(texturePaths), gameFS, textureConfig, loadOnDemand);
+      }
+
+      const auto cacheKey =
+        textureCacheKey(path, texturePaths, gameFS, textureConfig)
+          .transform([](auto key) { return std::optional{std::move(key)}; })
+          .transform_error([&](auto e) -> std::optional<std::string> {
+            logger.debug() << "Could not compute texture cache key for '"
+                           << path.string() << "': " << e.msg;
+            return std::nullopt;
+          })
+          .value();
+      if (!cacheKey)
+      {
+        return readTextureCollection(
+          path, std::move(texturePaths), gameFS, textureConfig, loadOnDemand);
+      }
+
+      return loadCachedTextureCollection(
+        path,
+        std::move(texturePaths),
+        gameFS,
+        textureConfig,
+        *cacheDirectory,
+        *cacheKey,
+        logger);
     });
 }
 
@@ -23,6 +23,7 @@
 
 #include <filesystem>
 #include <iosfwd>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -33,8 +34,9 @@ class Logger;
 
 namespace TrenchBroom::Assets
 {
+class Texture;
 class TextureCollection;
-}
+} // namespace TrenchBroom::Assets
 
 namespace TrenchBroom::Model
 {
@@ -48,10 +50,47 @@ class FileSystem;
 Result<std::vector<std::filesystem::path>> findTextureCollections(
   const FileSystem& gameFS, const Model::TextureConfig& textureConfig);
 
+/**
+ * Returns the paths of the textures in the texture collection at the given path.
+ */
+Result<std::vector<std::filesystem::path>> findTextures(
+  const std::filesystem::path& path,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig);
+
+/**
+ * Loads and decodes the textures at the given paths, bypassing the texture cache. A
+ * texture that cannot be read is replaced by a placeholder texture, see
+ * loadTextureCollection.
+ */
+Result<std::vector<Assets::Texture>> loadTextures(
+  std::vector<std::filesystem::path> texturePaths,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig);
+
+Result<Assets::TextureCollection> loadTextureCollection(
+  const std::filesystem::path& path,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig,
+  Logger& logger);
+
+/**
+ * Loads the texture collection at the given path. If a cache directory is given, the
+ * decoded textures are read from a texture cache in that directory if it is up to date,
+ * and the cache is written after decoding the textures otherwise. Failing to read or
+ * write the cache is not an error.
+ *
+ * If loadOnDemand is true, only the names and dimensions of Quake and Half-Life mip
+ * textures are read, and their pixel data is decoded once they are used, see
+ * Assets::Texture::setLoader. Such collections are not cached. Textures in other
+ * formats are always decoded immediately.
+ */
 Result<Assets::TextureCollection> loadTextureCollection(
   const std::filesystem::path& path,
   const FileSystem& gameFS,
   const Model::TextureConfig& textureConfig,
+  const std::optional<std::filesystem::path>& cacheDirectory,
+  bool loadOnDemand,
   Logger& logger);
 
 } // namespace TrenchBroom::IO
@@ -0,0 +1,612 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Color.h"
+#include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/Layer.h"
+#include "Model/LayerNode.h"
+#include "Model/LockState.h"
+#include "Model/MapFormat.h"
+#include "Model/PatchNode.h"
+#include "Model/Polyhedron.h"
+#include "Model/VisibilityState.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+#include "kdl/string_utils.h"
+
+#include "vm/mat.h"
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+constexpr auto Magic = std::string_view{"TBMC"};
+
+// must be incremented whenever the format of the cache changes
+constexpr auto Version = uint32_t(1);
+
+enum class NodeType : uint8_t
+{
+  Layer,
+  Group,
+  Entity,
+  Brush,
+  Patch,
+};
+
+void writeProperties(CacheWriter& writer, const Model::Entity& entity)
+{
+  writer.writeSize(entity.properties().size());
+  for (const auto& property : entity.properties())
+  {
+    writer.writeString(property.key());
+    writer.writeString(property.value());
+  }
+
+  writer.writeSize(entity.protectedProperties().size());
+  for (const auto& key : entity.protectedProperties())
+  {
+    writer.writeString(key);
+  }
+}
+
+void writeLayer(CacheWriter& writer, const Model::LayerNode& layerNode)
+{
+  const auto& layer = layerNode.layer();
+  writer.writeString(layer.name());
+  writer.write(uint8_t(layer.defaultLayer() ? 1 : 0));
+  writer.writeOptional(
+    layer.hasSortIndex() ? std::optional<int>{layer.sortIndex()} : std::nullopt,
+    [&](const int sortIndex) { writer.write(int32_t(sortIndex)); });
+  writer.writeOptional(
+    layer.color(), [&](const Color& color) { writer.writeVec(color); });
+  writer.write(uint8_t(layer.omitFromExport() ? 1 : 0));
+  writer.writeOptional(
+    layerNode.persistentId(), [&](const auto id) { writer.writeSize(id); });
+  writer.write(layerNode.lockState());
+  writer.write(layerNode.visibilityState());
+}
+
+void writeGroup(CacheWriter& writer, const Model::GroupNode& groupNode)
+{
+  const auto& group = groupNode.group();
+  writer.writeString(group.name());
+  for (size_t i = 0; i < 4; ++i)
+  {
+    writer.writeVec(group.transformation()[i]);
+  }
+  writer.writeString(groupNode.linkId());
+  writer.writeOptional(
+    groupNode.persistentId(), [&](const auto id) { writer.writeSize(id); });
+}
+
+void writeFaceAttributes(
+  CacheWriter& writer, const Model::BrushFaceAttributes& attributes)
+{
+  writer.writeString(attributes.textureName());
+  writer.writeVec(attributes.offset());
+  writer.writeVec(attributes.scale());
+  writer.write(attributes.rotation());
+  writer.writeOptional(
+    attributes.surfaceContents(), [&](const int value) { writer.write(int32_t(value)); });
+  writer.writeOptional(
+    attributes.surfaceFlags(), [&](const int value) { writer.write(int32_t(value)); });
+  writer.writeOptional(
+    attributes.surfaceValue(), [&](const float value) { writer.write(value); });
+  writer.writeOptional(
+    attributes.color(), [&](const Color& color) { writer.writeVec(color); });
+}
+
+void writeBrush(
+  CacheWriter& writer, const Model::Brush& brush, const Model::MapFormat mapFormat)
+{
+  const auto parallel = Model::isParallelTexCoordSystem(mapFormat);
+
+  writer.writeSize(brush.faceCount());
+  for (const auto& face : brush.faces())
+  {
+    writer.writeSize(face.lineNumber());
+    for (const auto& point : face.points())
+    {
+      writer.writeVec(point);
+    }
+    writeFaceAttributes(writer, face.attributes());
+    if (parallel)
+    {
+      writer.writeVec(face.textureXAxis());
+      writer.writeVec(face.textureYAxis());
+    }
+  }
+
+  // the vertices in the order of the geometry
+  auto vertexIndices = std::unordered_map<const Model::BrushVertex*, size_t>{};
+  writer.writeSize(brush.vertexCount());
+  for (const auto* vertex : brush.vertices())
+  {
+    vertexIndices.emplace(vertex, vertexIndices.size());
+    writer.writeVec(vertex->position());
+  }
+
+  // the face geometries in the order of the faces
+  for (const auto& face : brush.faces())
+  {
+    const auto* faceGeometry = face.geometry();
+    writer.writeVec(faceGeometry->plane().normal);
+    writer.write(faceGeometry->plane().distance);
+    writer.writeSize(faceGeometry->boundary().size());
+    for (const auto* halfEdge : faceGeometry->boundary())
+    {
+      writer.writeSize(vertexIndices[halfEdge->origin()]);
+    }
+  }
+}
+
+void writePatch(CacheWriter& writer, const Model::BezierPatch& patch)
+{
+  writer.writeSize(patch.pointRowCount());
+  writer.writeSize(patch.pointColumnCount());
+  for (const auto& point : patch.controlPoints())
+  {
+    writer.writeVec(point);
+  }
+  writer.writeString(patch.textureName());
+}
+
+void writeNode(
+  CacheWriter& writer, const Model::Node& node, const Model::MapFormat mapFormat)
+{
+  node.accept(kdl::overload(
+    [](const Model::WorldNode*) {},
+    [&](const Model::LayerNode* layerNode) {
+      writer.write(NodeType::Layer);
+      writeLayer(writer, *layerNode);
+    },
+    [&](const Model::GroupNode* groupNode) {
+      writer.write(NodeType::Group);
+      writeGroup(writer, *groupNode);
+    },
+    [&](const Model::EntityNode* entityNode) {
+      writer.write(NodeType::Entity);
+      writeProperties(writer, entityNode->entity());
+    },
+    [&](const Model::BrushNode* brushNode) {
+      writer.write(NodeType::Brush);
+      writeBrush(writer, brushNode->brush(), mapFormat);
+    },
+    [&](const Model::PatchNode* patchNode) {
+      writer.write(NodeType::Patch);
+      writePatch(writer, patchNode->patch());
+    }));
+
+  writer.writeSize(node.lineNumber());
+  writer.writeSize(node.lineCount());
+
+  writer.writeSize(node.childCount());
+  for (const auto* child : node.children())
+  {
+    writeNode(writer, *child, mapFormat);
+  }
+}
+
+template <typename T, size_t S>
+vm::vec<T, S> readVec(Reader& reader)
+{
+  return reader.readVec<T, S>();
+}
+
+template <typename E>
+E readState(Reader& reader, std::initializer_list<E> validValues)
+{
+  const auto value = static_cast<E>(read<std::underlying_type_t<E>>(reader));
+  if (std::find(validValues.begin(), validValues.end(), value) == validValues.end())
+  {
+    throw ReaderException{"Invalid state"};
+  }
+  return value;
+}
+
+Model::Entity readEntity(
+  Reader& reader, const Model::EntityPropertyConfig& entityPropertyConfig)
+{
+  auto properties = std::vector<Model::EntityProperty>{};
+  const auto propertyCount = readCount(reader, 16);
+  properties.reserve(propertyCount);
+  for (size_t i = 0; i < propertyCount; ++i)
+  {
+    auto key = readString(reader);
+    auto value = readString(reader);
+    properties.emplace_back(std::move(key), std::move(value));
+  }
+
+  auto protectedProperties = std::vector<std::string>{};
+  const auto protectedPropertyCount = readCount(reader, 8);
+  protectedProperties.reserve(protectedPropertyCount);
+  for (size_t i = 0; i < protectedPropertyCount; ++i)
+  {
+    protectedProperties.push_back(readString(reader));
+  }
+
+  auto entity = Model::Entity{entityPropertyConfig, std::move(properties)};
+  entity.setProtectedProperties(std::move(protectedProperties));
+  return entity;
+}
+
+struct LayerInfo
+{
+  Model::Layer layer;
+  std::optional<Model::IdType> persistentId;
+  Model::LockState lockState;
+  Model::VisibilityState visibilityState;
+};
+
+LayerInfo readLayer(Reader& reader)
+{
+  auto name = readString(reader);
+  const auto defaultLayer = readBool(reader);
+
+  auto layer = Model::Layer{std::move(name), defaultLayer};
+  if (const auto sortIndex =
+        readOptional(reader, [&]() { return read<int32_t>(reader); }))
+  {
+    layer.setSortIndex(*sortIndex);
+  }
+  if (const auto color =
+        readOptional(reader, [&]() { return readVec<float, 4>(reader); }))
+  {
+    layer.setColor(Color{*color});
+  }
+  layer.setOmitFromExport(readBool(reader));
+
+  const auto persistentId = readOptional(reader, [&]() { return readSize(reader); });
+  const auto lockState = readState(
+    reader,
+    {Model::LockState::Inherited, Model::LockState::Locked, Model::LockState::Unlocked});
+  const auto visibilityState = readState(
+    reader,
+    {Model::VisibilityState::Inherited,
+     Model::VisibilityState::Hidden,
+     Model::VisibilityState::Shown});
+
+  return {std::move(layer), persistentId, lockState, visibilityState};
+}
+
+std::unique_ptr<Model::GroupNode> readGroup(Reader& reader)
+{
+  auto group = Model::Group{readString(reader)};
+
+  auto transformation = vm::mat4x4{};
+  for (size_t i = 0; i < 4; ++i)
+  {
+    transformation[i] = readVec<FloatType, 4>(reader);
+  }
+  group.setTransformation(transformation);
+
+  auto groupNode = std::make_unique<Model::GroupNode>(std::move(group));
+  groupNode->setLinkId(readString(reader));
+  if (const auto persistentId = readOptional(reader, [&]() { return readSize(reader); }))
+  {
+    groupNode->setPersistentId(*persistentId);
+  }
+  return groupNode;
+}
+
+Model::BrushFaceAttributes readFaceAttributes(Reader& reader)
+{
+  auto attributes = Model::BrushFaceAttributes{readString(reader)};
+  attributes.setOffset(readVec<float, 2>(reader));
+  attributes.setScale(readVec<float, 2>(reader));
+  attributes.setRotation(read<float>(reader));
+  attributes.setSurfaceContents(
+    readOptional(reader, [&]() { return int(read<int32_t>(reader)); }));
+  attributes.setSurfaceFlags(
+    readOptional(reader, [&]() { return int(read<int32_t>(reader)); }));
+  attributes.setSurfaceValue(readOptional(reader, [&]() { return read<float>(reader); }));
+  attributes.setColor(
+    readOptional(reader, [&]() { return Color{readVec<float, 4>(reader)}; }));
+  return attributes;
+}
+
+Model::Brush readBrush(Reader& reader, const Model::MapFormat mapFormat)
+{
+  const auto parallel = Model::isParallelTexCoordSystem(mapFormat);
+
+  auto faces = std::vector<Model::BrushFace>{};
+  const auto faceCount = readCount(reader, 80);
+  faces.reserve(faceCount);
+  for (size_t i = 0; i < faceCount; ++i)
+  {
+    const auto line = readSize(reader);
+    const auto point0 = readVec<FloatType, 3>(reader);
+    const auto point1 = readVec<FloatType, 3>(reader);
+    const auto point2 = readVec<FloatType, 3>(reader);
+    const auto attributes = readFaceAttributes(reader);
+
+    auto face = Result<Model::BrushFace>{Error{}};
+    if (parallel)
+    {
+      const auto xAxis = readVec<FloatType, 3>(reader);
+      const auto yAxis = readVec<FloatType, 3>(reader);
+      face = Model::BrushFace::createFromValve(
+        point0, point1, point2, attributes, xAxis, yAxis, mapFormat);
+    }
+    else
+    {
+      face = Model::BrushFace::createFromStandard(
+        point0, point1, point2, attributes, mapFormat);
+    }
+
+    faces.push_back(std::move(face).if_error([](const auto& e) {
+      throw ReaderException{e.msg};
+    }).value());
+    faces.back().setFilePosition(line, 1u);
+  }
+
+  auto positions = std::vector<vm::vec3>{};
+  const auto vertexCount = readCount(reader, 24);
+  positions.reserve(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i)
+  {
+    positions.push_back(readVec<FloatType, 3>(reader));
+  }
+
+  auto facePlanes = std::vector<vm::plane3>{};
+  auto faceVertexIndices = std::vector<std::vector<size_t>>{};
+  facePlanes.reserve(faceCount);
+  faceVertexIndices.reserve(faceCount);
+  for (size_t i = 0; i < faceCount; ++i)
+  {
+    const auto normal = readVec<FloatType, 3>(reader);
+    const auto distance = read<FloatType>(reader);
+    facePlanes.emplace_back(distance, normal);
+
+    auto& indices = faceVertexIndices.emplace_back();
+    const auto indexCount = readCount(reader, 8);
+    indices.reserve(indexCount);
+    for (size_t j = 0; j < indexCount; ++j)
+    {
+      indices.push_back(readSize(reader));
+    }
+  }
+
+  auto geometry =
+    Model::BrushGeometry::fromFaces(positions, faceVertexIndices, facePlanes);
+  if (!geometry)
+  {
+    throw ReaderException{"Invalid brush geometry"};
+  }
+
+  return Model::Brush::createFromGeometry(
+           std::move(faces), std::make_unique<Model::BrushGeometry>(std::move(*geometry)))
+    .if_error([](const auto& e) { throw ReaderException{e.msg}; })
+    .value();
+}
+
+Model::BezierPatch readPatch(Reader& reader)
+{
+  const auto rowCount = readSize(reader);
+  const auto columnCount = readSize(reader);
+
+  auto controlPoints = std::vector<Model::BezierPatch::Point>{};
+  const auto controlPointCount = rowCount * columnCount;
+  if (!reader.canRead(controlPointCount * 40))
+  {
+    throw ReaderException{"Invalid patch size"};
+  }
+  controlPoints.reserve(controlPointCount);
+  for (size_t i = 0; i < controlPointCount; ++i)
+  {
+    controlPoints.push_back(readVec<FloatType, 5>(reader));
+  }
+
+  return Model::BezierPatch{
+    rowCount, columnCount, std::move(controlPoints), readString(reader)};
+}
+
+/**
+ * Reads a node and its children and adds it to the given parent node.
+ */
+void readNode(
+  Reader& reader,
+  Model::WorldNode& worldNode,
+  Model::Node& parentNode,
+  const Model::EntityPropertyConfig& entityPropertyConfig)
+{
+  const auto nodeType = read<std::underlying_type_t<NodeType>>(reader);
+
+  auto node = std::unique_ptr<Model::Node>{};
+  auto* childParent = static_cast<Model::Node*>(nullptr);
+  switch (static_cast<NodeType>(nodeType))
+  {
+  case NodeType::Layer: {
+    auto layerInfo = readLayer(reader);
+    auto* layerNode = worldNode.defaultLayer();
+    if (layerInfo.layer.defaultLayer())
+    {
+      layerNode->setLayer(std::move(layerInfo.layer));
+    }
+    else
+    {
+      node = std::make_unique<Model::LayerNode>(std::move(layerInfo.layer));
+      layerNode = static_cast<Model::LayerNode*>(node.get());
+    }
+    childParent = layerNode;
+
+    if (layerInfo.persistentId)
+    {
+      layerNode->setPersistentId(*layerInfo.persistentId);
+    }
+    layerNode->setLockState(layerInfo.lockState);
+    layerNode->setVisibilityState(layerInfo.visibilityState);
+    break;
+  }
+  case NodeType::Group:
+    node = readGroup(reader);
+    break;
+  case NodeType::Entity:
+    node = std::make_unique<Model::EntityNode>(readEntity(reader, entityPropertyConfig));
+    break;
+  case NodeType::Brush:
+    node = std::make_unique<Model::BrushNode>(readBrush(reader, worldNode.mapFormat()));
+    break;
+  case NodeType::Patch:
+    node = std::make_unique<Model::PatchNode>(readPatch(reader));
+    break;
+  default:
+    throw ReaderException{"Invalid node type " + std::to_string(nodeType)};
+  }
+
+  if (!childParent)
+  {
+    childParent = node.get();
+  }
+
+  const auto lineNumber = readSize(reader);
+  const auto lineCount = readSize(reader);
+  childParent->setFilePosition(lineNumber, lineCount);
+
+  if (node)
+  {
+    if (!parentNode.canAddChild(node.get()))
+    {
+      throw ReaderException{"Invalid node hierarchy"};
+    }
+    parentNode.addChild(node.release());
+  }
+
+  const auto childCount = readCount(reader, 1);
+  for (size_t i = 0; i < childCount; ++i)
+  {
+    readNode(reader, worldNode, *childParent, entityPropertyConfig);
+  }
+}
+} // namespace
+
+std::filesystem::path mapCachePath(const std::filesystem::path& mapPath)
+{
+  auto cachePath = mapPath;
+  cachePath += ".tbcache";
+  return cachePath;
+}
+
+std::string mapCacheKey(
+  const std::string_view mapContents,
+  const Model::MapFormat mapFormat,
+  const vm::bbox3& worldBounds)
+{
+  return fmt::format(
+    "{:016x} {} {} {} {} {} {} {} {}",
+    kdl::str_hash(mapContents),
+    mapContents.size(),
+    Model::formatName(mapFormat),
+    worldBounds.min.x(),
+    worldBounds.min.y(),
+    worldBounds.min.z(),
+    worldBounds.max.x(),
+    worldBounds.max.y(),
+    worldBounds.max.z());
+}
+
+void writeMapCache(
+  const Model::WorldNode& worldNode, const std::string_view key, std::ostream& stream)
+{
+  auto writer = CacheWriter{stream};
+  writer.writeHeader(Magic, Version);
+  writer.writeString(key);
+
+  writer.writeString(Model::formatName(worldNode.mapFormat()));
+  writeProperties(writer, worldNode.entity());
+  writer.writeSize(worldNode.lineNumber());
+  writer.writeSize(worldNode.lineCount());
+
+  writer.writeSize(worldNode.childCount());
+  for (const auto* child : worldNode.children())
+  {
+    writeNode(writer, *child, worldNode.mapFormat());
+  }
+}
+
+Result<std::unique_ptr<Model::WorldNode>> readMapCache(
+  Reader reader,
+  const std::string_view key,
+  const Model::EntityPropertyConfig& entityPropertyConfig)
+{
+  return readCacheHeader(reader, Magic, Version, key, "map cache")
+    .and_then([&]() -> Result<std::unique_ptr<Model::WorldNode>> {
+      try
+      {
+        const auto mapFormat = Model::formatFromName(readString(reader));
+        if (mapFormat == Model::MapFormat::Unknown)
+        {
+          return Error{"Unknown map format"};
+        }
+
+        auto worldNode = std::make_unique<Model::WorldNode>(
+          entityPropertyConfig, readEntity(reader, entityPropertyConfig), mapFormat);
+        worldNode->disableNodeTreeUpdates();
+
+        const auto lineNumber = readSize(reader);
+        const auto lineCount = readSize(reader);
+        worldNode->setFilePosition(lineNumber, lineCount);
+
+        const auto childCount = readCount(reader, 1);
+        for (size_t i = 0; i < childCount; ++i)
+        {
+          readNode(reader, *worldNode, *worldNode, entityPropertyConfig);
+        }
+
+        worldNode->rebuildNodeTree();
+        worldNode->enableNodeTreeUpdates();
+        return worldNode;
+      }
+      catch (const ReaderException& e)
+      {
+        return Error{"Malformed map cache: " + std::string{e.what()}};
+      }
+    });
+}
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+#include "Result.h"
+
+#include "vm/bbox.h"
+
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace TrenchBroom::Model
+{
+struct EntityPropertyConfig;
+enum class MapFormat;
+class WorldNode;
+} // namespace TrenchBroom::Model
+
+namespace TrenchBroom::IO
+{
+class Reader;
+
+/**
+ * A map cache is a binary file that stores the node tree of a loaded map, including the
+ * face attributes and the geometry of every brush. Reading a map from its cache skips
+ * parsing the map file and computing the brush geometry.
+ *
+ * A cache is identified by a key which is computed from the contents of the map file and
+ * from the settings that affect how the map is loaded. A cache is only read if its key
+ * matches the key of the map file.
+ */
+
+/**
+ * Returns the path of the cache file for the map file at the given path. The cache file
+ * is stored next to the map file.
+ */
+std::filesystem::path mapCachePath(const std::filesystem::path& mapPath);
+
+/**
+ * Computes the key of a cache for the given map file contents.
+ */
+std::string mapCacheKey(
+  std::string_view mapContents,
+  Model::MapFormat mapFormat,
+  const vm::bbox3& worldBounds);
+
+/**
+ * Writes the given world to the given stream, which must be opened in binary mode.
+ */
+void writeMapCache(
+  const Model::WorldNode& worldNode, std::string_view key, std::ostream& stream);
+
+/**
+ * Reads a world from the given reader. Returns an error if the cache is malformed or if
+ * its key does not match the given key.
+ */
+Result<std::unique_ptr<Model::WorldNode>> readMapCache(
+  Reader reader,
+  std::string_view key,
+  const Model::EntityPropertyConfig& entityPropertyConfig);
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,305 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapDelta.h"
+
+#include "Error.h"
+
+#include "kdl/result.h"
+#include "kdl/string_compare.h"
+#include "kdl/string_format.h"
+#include "kdl/string_utils.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+constexpr auto Magic = std::string_view{"TBDELTA"};
+
+// must be incremented whenever the format of the delta changes
+constexpr auto Version = size_t(1);
+
+/**
+ * Splits the given map file contents at the comment lines that MapFileSerializer writes
+ * before every entity and brush, and after every closing brace, so that the last brush of
+ * an entity does not include the closing brace of the entity. The returned units cover
+ * the entire string.
+ */
+std::vector<std::string_view> splitUnits(const std::string_view str)
+{
+  auto result = std::vector<std::string_view>{};
+
+  auto unitStart = size_t(0);
+  auto lineStart = size_t(0);
+  while (lineStart < str.size())
+  {
+    const auto line = str.substr(lineStart);
+    if (
+      lineStart > unitStart
+      && (kdl::cs::str_is_prefix(line, "// entity ")
+          || kdl::cs::str_is_prefix(line, "// brush ")))
+    {
+      result.push_back(str.substr(unitStart, lineStart - unitStart));
+      unitStart = lineStart;
+    }
+
+    const auto lineEnd = str.find('\n', lineStart);
+    if (lineEnd == std::string_view::npos)
+    {
+      break;
+    }
+
+    const auto isClosingBrace = line.substr(0, lineEnd - lineStart) == "}";
+    lineStart = lineEnd + 1;
+
+    if (isClosingBrace)
+    {
+      result.push_back(str.substr(unitStart, lineStart - unitStart));
+      unitStart = lineStart;
+    }
+  }
+
+  if (unitStart < str.size())
+  {
+    result.push_back(str.substr(unitStart));
+  }
+
+  return result;
+}
+
+struct Operation
+{
+  enum class Type
+  {
+    Copy,
+    Insert,
+  };
+
+  Type type;
+  // the offset into the base for Copy, and into the map for Insert
+  size_t offset;
+  size_t length;
+};
+
+void addOperation(
+  std::vector<Operation>& operations,
+  const Operation::Type type,
+  const size_t offset,
+  const size_t length)
+{
+  if (
+    !operations.empty() && operations.back().type == type
+    && operations.back().offset + operations.back().length == offset)
+  {
+    operations.back().length += length;
+  }
+  else
+  {
+    operations.push_back({type, offset, length});
+  }
+}
+
+std::optional<std::string_view> readLine(std::string_view& str)
+{
+  const auto lineEnd = str.find('\n');
+  if (lineEnd == std::string_view::npos)
+  {
+    return std::nullopt;
+  }
+
+  const auto line = str.substr(0, lineEnd);
+  str.remove_prefix(lineEnd + 1);
+  return line;
+}
+
+std::optional<std::vector<size_t>> parseSizes(const std::vector<std::string>& tokens)
+{
+  auto result = std::vector<size_t>{};
+  for (const auto& token : tokens)
+  {
+    if (!kdl::str_is_numeric(token))
+    {
+      return std::nullopt;
+    }
+
+    const auto value = kdl::str_to_size(token);
+    if (!value)
+    {
+      return std::nullopt;
+    }
+    result.push_back(*value);
+  }
+  return result;
+}
+
+} // namespace
+
+std::string makeMapDelta(const std::string_view base, const std::string_view map)
+{
+  // index the units of the base, and the units without their comment lines, which
+  // contain a number that changes when an entity or a brush is added or removed
+  auto unitOffsets = std::unordered_map<std::string_view, size_t>{};
+  auto bodyOffsets = std::unordered_map<std::string_view, size_t>{};
+  for (const auto unit : splitUnits(base))
+  {
+    const auto offset = size_t(unit.data() - base.data());
+    unitOffsets.emplace(unit, offset);
+
+    const auto firstLineEnd = unit.find('\n');
+    if (firstLineEnd != std::string_view::npos && firstLineEnd + 1 < unit.size())
+    {
+      bodyOffsets.emplace(unit.substr(firstLineEnd + 1), offset + firstLineEnd + 1);
+    }
+  }
+
+  auto operations = std::vector<Operation>{};
+  for (const auto unit : splitUnits(map))
+  {
+    const auto offset = size_t(unit.data() - map.data());
+    if (const auto iUnit = unitOffsets.find(unit); iUnit != unitOffsets.end())
+    {
+      addOperation(operations, Operation::Type::Copy, iUnit->second, unit.size());
+      continue;
+    }
+
+    const auto firstLineEnd = unit.find('\n');
+    if (firstLineEnd != std::string_view::npos && firstLineEnd + 1 < unit.size())
+    {
+      const auto body = unit.substr(firstLineEnd + 1);
+      if (const auto iBody = bodyOffsets.find(body); iBody != bodyOffsets.end())
+      {
+        addOperation(operations, Operation::Type::Insert, offset, firstLineEnd + 1);
+        addOperation(operations, Operation::Type::Copy, iBody->second, body.size());
+        continue;
+      }
+    }
+
+    addOperation(operations, Operation::Type::Insert, offset, unit.size());
+  }
+
+  auto result = fmt::format(
+    "{} {} {} {:016x} {}\n",
+    Magic,
+    Version,
+    base.size(),
+    kdl::str_hash(base),
+    map.size());
+
+  for (const auto& operation : operations)
+  {
+    switch (operation.type)
+    {
+    case Operation::Type::Copy:
+      result += fmt::format("c {} {}\n", operation.offset, operation.length);
+      break;
+    case Operation::Type::Insert:
+      result += fmt::format("i {}\n", operation.length);
+      result += map.substr(operation.offset, operation.length);
+      break;
+    }
+  }
+
+  return result;
+}
+
+Result<std::string> applyMapDelta(const std::string_view base, std::string_view delta)
+{
+  const auto header = readLine(delta);
+  if (!header)
+  {
+    return Error{"Invalid map delta header"};
+  }
+
+  const auto headerTokens = kdl::str_split(*header, " ");
+  if (headerTokens.size() != 5 || headerTokens[0] != Magic)
+  {
+    return Error{"Invalid map delta header"};
+  }
+  if (headerTokens[1] != kdl::str_to_string(Version))
+  {
+    return Error{"Unsupported map delta version " + headerTokens[1]};
+  }
+  if (
+    headerTokens[2] != kdl::str_to_string(base.size())
+    || headerTokens[3] != fmt::format("{:016x}", kdl::str_hash(base)))
+  {
+    return Error{"Map delta does not match its base"};
+  }
+
+  const auto mapSize = kdl::str_to_size(headerTokens[4]);
+  if (!mapSize)
+  {
+    return Error{"Invalid map delta header"};
+  }
+
+  auto result = std::string{};
+  result.reserve(std::min(*mapSize, base.size() + delta.size()));
+
+  while (!delta.empty())
+  {
+    const auto line = readLine(delta);
+    if (!line || line->empty())
+    {
+      return Error{"Invalid map delta operation"};
+    }
+
+    const auto type = line->front();
+    const auto arguments = parseSizes(kdl::str_split(line->substr(1), " "));
+    if (type == 'c' && arguments && arguments->size() == 2)
+    {
+      const auto offset = (*arguments)[0];
+      const auto length = (*arguments)[1];
+      if (offset > base.size() || length > base.size() - offset)
+      {
+        return Error{"Invalid map delta copy operation"};
+      }
+      result += base.substr(offset, length);
+    }
+    else if (type == 'i' && arguments && arguments->size() == 1)
+    {
+      const auto length = (*arguments)[0];
+      if (length > delta.size())
+      {
+        return Error{"Invalid map delta insert operation"};
+      }
+      result += delta.substr(0, length);
+      delta.remove_prefix(length);
+    }
+    else
+    {
+      return Error{"Invalid map delta operation"};
+    }
+  }
+
+  if (result.size() != *mapSize)
+  {
+    return Error{"Map delta is incomplete"};
+  }
+
+  return result;
+}
+
+} // namespace TrenchBroom::IO
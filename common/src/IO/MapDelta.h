@@ -0,0 +1,51 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <string>
+#include <string_view>
+
+namespace TrenchBroom::IO
+{
+
+/**
+ * Encodes the given map file contents as a delta against the given base map file
+ * contents.
+ *
+ * Both files are compared in units of the entities and brushes written by
+ * MapFileSerializer. Every unit of the given map that also occurs in the base is encoded
+ * as a reference to the base, and adjacent references are merged. Only the text of units
+ * that have changed is stored in the delta, so the delta is small if only a few entities
+ * and brushes have changed.
+ */
+std::string makeMapDelta(std::string_view base, std::string_view map);
+
+/**
+ * Rebuilds the map file contents from the given base and a delta that was created by
+ * makeMapDelta.
+ *
+ * Returns an error if the delta is malformed or if it was not made against the given
+ * base.
+ */
+Result<std::string> applyMapDelta(std::string_view base, std::string_view delta);
+
+} // namespace TrenchBroom::IO
@@ -39,9 +39,9 @@
 
 #include <fmt/format.h>
 
-#include <iterator> // for std::ostreambuf_iterator
+#include <iterator> // for std::back_inserter
 #include <memory>
-#include <sstream>
+#include <ostream>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -53,26 +53,27 @@ namespace IO
 class QuakeFileSerializer : public MapFileSerializer
 {
 public:
-  explicit QuakeFileSerializer(std::ostream& stream)
-    : MapFileSerializer(stream)
+  QuakeFileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : MapFileSerializer(format, stream)
   {
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override
+  void doWriteBrushFace(
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeTextureInfo(stream, face);
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    writeFacePoints(buffer, face);
+    writeTextureInfo(buffer, face);
+    fmt::format_to(std::back_inserter(buffer), "\n");
   }
 
 protected:
-  void writeFacePoints(std::ostream& stream, const Model::BrushFace& face) const
+  void writeFacePoints(fmt::memory_buffer& buffer, const Model::BrushFace& face) const
   {
     const Model::BrushFace::Points& points = face.points();
 
     fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
+      std::back_inserter(buffer),
       "( {} {} {} ) ( {} {} {} ) ( {} {} {} )",
       points[0].x(),
       points[0].y(),
@@ -96,14 +97,14 @@ protected:
     return "\"" + kdl::str_escape(textureName, "\"") + "\"";
   }
 
-  void writeTextureInfo(std::ostream& stream, const Model::BrushFace& face) const
+  void writeTextureInfo(fmt::memory_buffer& buffer, const Model::BrushFace& face) const
   {
     const std::string& textureName = face.attributes().textureName().empty()
                                        ? Model::BrushFaceAttributes::NoTextureName
                                        : face.attributes().textureName();
 
     fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
+      std::back_inserter(buffer),
       " {} {} {} {} {} {}",
       shouldQuoteTextureName(textureName) ? quoteTextureName(textureName) : textureName,
       face.attributes().xOffset(),
@@ -113,7 +114,8 @@ protected:
       face.attributes().yScale());
   }
 
-  void writeValveTextureInfo(std::ostream& stream, const Model::BrushFace& face) const
+  void writeValveTextureInfo(
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const
   {
     const std::string& textureName = face.attributes().textureName().empty()
                                        ? Model::BrushFaceAttributes::NoTextureName
@@ -122,7 +124,7 @@ protected:
     const vm::vec3 yAxis = face.textureYAxis();
 
     fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
+      std::back_inserter(buffer),
       " {} [ {} {} {} {} ] [ {} {} {} {} ] {} {} {}",
       shouldQuoteTextureName(textureName) ? quoteTextureName(textureName) : textureName,
 
@@ -145,30 +147,32 @@ protected:
 class Quake2FileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit Quake2FileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  Quake2FileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : QuakeFileSerializer(format, stream)
   {
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override
+  void doWriteBrushFace(
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeTextureInfo(stream, face);
+    writeFacePoints(buffer, face);
+    writeTextureInfo(buffer, face);
 
     if (face.attributes().hasSurfaceAttributes())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(buffer, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    fmt::format_to(std::back_inserter(buffer), "\n");
   }
 
 protected:
-  void writeSurfaceAttributes(std::ostream& stream, const Model::BrushFace& face) const
+  void writeSurfaceAttributes(
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const
   {
     fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
+      std::back_inserter(buffer),
       " {} {} {}",
       face.resolvedSurfaceContents(),
       face.resolvedSurfaceFlags(),
@@ -179,23 +183,24 @@ protected:
 class Quake2ValveFileSerializer : public Quake2FileSerializer
 {
 public:
-  explicit Quake2ValveFileSerializer(std::ostream& stream)
-    : Quake2FileSerializer(stream)
+  Quake2ValveFileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : Quake2FileSerializer(format, stream)
   {
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override
+  void doWriteBrushFace(
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeValveTextureInfo(stream, face);
+    writeFacePoints(buffer, face);
+    writeValveTextureInfo(buffer, face);
 
     if (face.attributes().hasSurfaceAttributes())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(buffer, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    fmt::format_to(std::back_inserter(buffer), "\n");
   }
 };
 
@@ -205,35 +210,36 @@ private:
   std::string SurfaceColorFormat;
 
 public:
-  explicit DaikatanaFileSerializer(std::ostream& stream)
-    : Quake2FileSerializer(stream)
+  DaikatanaFileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : Quake2FileSerializer(format, stream)
     , SurfaceColorFormat(" %d %d %d")
   {
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override
+  void doWriteBrushFace(
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeTextureInfo(stream, face);
+    writeFacePoints(buffer, face);
+    writeTextureInfo(buffer, face);
 
     if (face.attributes().hasSurfaceAttributes() || face.attributes().hasColor())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(buffer, face);
     }
     if (face.attributes().hasColor())
     {
-      writeSurfaceColor(stream, face);
+      writeSurfaceColor(buffer, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    fmt::format_to(std::back_inserter(buffer), "\n");
   }
 
 protected:
-  void writeSurfaceColor(std::ostream& stream, const Model::BrushFace& face) const
+  void writeSurfaceColor(fmt::memory_buffer& buffer, const Model::BrushFace& face) const
   {
     fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
+      std::back_inserter(buffer),
       " {} {} {}",
       static_cast<int>(face.resolvedColor().r()),
       static_cast<int>(face.resolvedColor().g()),
@@ -244,35 +250,37 @@ protected:
 class Hexen2FileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit Hexen2FileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  Hexen2FileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : QuakeFileSerializer(format, stream)
   {
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override
+  void doWriteBrushFace(
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeTextureInfo(stream, face);
+    writeFacePoints(buffer, face);
+    writeTextureInfo(buffer, face);
     fmt::format_to(
-      std::ostreambuf_iterator<char>(stream), " 0\n"); // extra value written here
+      std::back_inserter(buffer), " 0\n"); // extra value written here
   }
 };
 
 class ValveFileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit ValveFileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  ValveFileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : QuakeFileSerializer(format, stream)
   {
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const Model::BrushFace& face) const override
+  void doWriteBrushFace(
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeValveTextureInfo(stream, face);
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    writeFacePoints(buffer, face);
+    writeValveTextureInfo(buffer, face);
+    fmt::format_to(std::back_inserter(buffer), "\n");
   }
 };
 
@@ -282,29 +290,31 @@ std::unique_ptr<NodeSerializer> MapFileSerializer::create(
   switch (format)
   {
   case Model::MapFormat::Standard:
-    return std::make_unique<QuakeFileSerializer>(stream);
+    return std::make_unique<QuakeFileSerializer>(format, stream);
   case Model::MapFormat::Quake2:
     // TODO 2427: Implement Quake3 serializers and use them
   case Model::MapFormat::Quake3:
   case Model::MapFormat::Quake3_Legacy:
-    return std::make_unique<Quake2FileSerializer>(stream);
+    return std::make_unique<Quake2FileSerializer>(format, stream);
   case Model::MapFormat::Quake2_Valve:
   case Model::MapFormat::Quake3_Valve:
-    return std::make_unique<Quake2ValveFileSerializer>(stream);
+    return std::make_unique<Quake2ValveFileSerializer>(format, stream);
   case Model::MapFormat::Daikatana:
-    return std::make_unique<DaikatanaFileSerializer>(stream);
+    return std::make_unique<DaikatanaFileSerializer>(format, stream);
   case Model::MapFormat::Valve:
-    return std::make_unique<ValveFileSerializer>(stream);
+    return std::make_unique<ValveFileSerializer>(format, stream);
   case Model::MapFormat::Hexen2:
-    return std::make_unique<Hexen2FileSerializer>(stream);
+    return std::make_unique<Hexen2FileSerializer>(format, stream);
   case Model::MapFormat::Unknown:
     throw FileFormatException("Unknown map file format");
     switchDefault();
   }
 }
 
-MapFileSerializer::MapFileSerializer(std::ostream& stream)
+MapFileSerializer::MapFileSerializer(
+  const Model::MapFormat format, std::ostream& stream)
   : m_line(1)
+  , m_format(format)
   , m_stream(stream)
 {
 }
@@ -318,6 +328,18 @@ void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootN
     nodesToSerialize;
   nodesToSerialize.reserve(rootNodes.size());
 
+  // nodes that have not changed since they were last serialized are not serialized again
+  const auto collectNode = [&](const auto* node) {
+    if (const auto* serializedNode = node->serializedNode(m_format))
+    {
+      m_nodeToPrecomputedString.emplace(node, serializedNode);
+    }
+    else
+    {
+      nodesToSerialize.push_back(node);
+    }
+  };
+
   Model::Node::visitAll(
     rootNodes,
     kdl::overload(
@@ -333,11 +355,11 @@ void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootN
       [](auto&& thisLambda, const Model::EntityNode* entity) {
         entity->visitChildren(thisLambda);
       },
-      [&](const Model::BrushNode* brush) { nodesToSerialize.push_back(brush); },
-      [&](const Model::PatchNode* patchNode) { nodesToSerialize.push_back(patchNode); }));
+      [&](const Model::BrushNode* brush) { collectNode(brush); },
+      [&](const Model::PatchNode* patchNode) { collectNode(patchNode); }));
 
-  // serialize brushes to strings in parallel
-  using Entry = std::pair<const Model::Node*, PrecomputedString>;
+  // serialize changed brushes to strings in parallel
+  using Entry = std::pair<const Model::Node*, Model::SerializedNode>;
   std::vector<Entry> result =
     kdl::vec_parallel_transform(std::move(nodesToSerialize), [&](const auto& node) {
       return std::visit(
@@ -351,35 +373,40 @@ void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootN
         node);
     });
 
-  // move strings into a map
-  for (auto& entry : result)
+  // move strings into the nodes so that they can be reused by the next save
+  for (auto& [node, serializedNode] : result)
   {
-    m_nodeToPrecomputedString.insert(std::move(entry));
+    node->setSerializedNode(std::move(serializedNode));
+    m_nodeToPrecomputedString[node] = node->serializedNode(m_format);
   }
 }
 
-void MapFileSerializer::doEndFile() {}
+void MapFileSerializer::doEndFile()
+{
+  flushBuffer(true);
+}
 
 void MapFileSerializer::doBeginEntity(const Model::Node* /* node */)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// entity {}\n", entityNo());
+  fmt::format_to(std::back_inserter(m_buffer), "// entity {}\n", entityNo());
   ++m_line;
   m_startLineStack.push_back(m_line);
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+  fmt::format_to(std::back_inserter(m_buffer), "{{\n");
   ++m_line;
 }
 
 void MapFileSerializer::doEndEntity(const Model::Node* node)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+  fmt::format_to(std::back_inserter(m_buffer), "}}\n");
   ++m_line;
   setFilePosition(node);
+  flushBuffer(false);
 }
 
 void MapFileSerializer::doEntityProperty(const Model::EntityProperty& attribute)
 {
   fmt::format_to(
-    std::ostreambuf_iterator<char>(m_stream),
+    std::back_inserter(m_buffer),
     "\"{}\" \"{}\"\n",
     escapeEntityProperties(attribute.key()),
     escapeEntityProperties(attribute.value()));
@@ -388,10 +415,10 @@ void MapFileSerializer::doEntityProperty(const Model::EntityProperty& attribute)
 
 void MapFileSerializer::doBrush(const Model::BrushNode* brush)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+  fmt::format_to(std::back_inserter(m_buffer), "// brush {}\n", brushNo());
   ++m_line;
   m_startLineStack.push_back(m_line);
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+  fmt::format_to(std::back_inserter(m_buffer), "{{\n");
   ++m_line;
 
   // write pre-serialized brush faces
@@ -399,26 +426,28 @@ void MapFileSerializer::doBrush(const Model::BrushNode* brush)
   ensure(
     it != std::end(m_nodeToPrecomputedString),
     "attempted to serialize a brush which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
+  const auto& precomputedString = *it->second;
+  const auto& string = precomputedString.string;
+  m_buffer.append(string.data(), string.data() + string.size());
   m_line += precomputedString.lineCount;
 
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+  fmt::format_to(std::back_inserter(m_buffer), "}}\n");
   ++m_line;
   setFilePosition(brush);
+  flushBuffer(false);
 }
 
 void MapFileSerializer::doBrushFace(const Model::BrushFace& face)
 {
   const size_t lines = 1u;
-  doWriteBrushFace(m_stream, face);
+  doWriteBrushFace(m_buffer, face);
   face.setFilePosition(m_line, lines);
   m_line += lines;
 }
 
 void MapFileSerializer::doPatch(const Model::PatchNode* patchNode)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+  fmt::format_to(std::back_inserter(m_buffer), "// brush {}\n", brushNo());
   ++m_line;
   m_startLineStack.push_back(m_line);
 
@@ -427,11 +456,22 @@ void MapFileSerializer::doPatch(const Model::PatchNode* patchNode)
   ensure(
     it != std::end(m_nodeToPrecomputedString),
     "attempted to serialize a patch which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
+  const auto& precomputedString = *it->second;
+  const auto& string = precomputedString.string;
+  m_buffer.append(string.data(), string.data() + string.size());
   m_line += precomputedString.lineCount;
 
   setFilePosition(patchNode);
+  flushBuffer(false);
+}
+
+void MapFileSerializer::flushBuffer(const bool force)
+{
+  if (force || m_buffer.size() >= FlushThreshold)
+  {
+    m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+  }
 }
 
 void MapFileSerializer::setFilePosition(const Model::Node* node)
@@ -451,48 +491,48 @@ size_t MapFileSerializer::startLine()
 /**
  * Threadsafe
  */
-MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
+Model::SerializedNode MapFileSerializer::writeBrushFaces(
   const Model::Brush& brush) const
 {
-  std::stringstream stream;
+  fmt::memory_buffer buffer;
   for (const Model::BrushFace& face : brush.faces())
   {
-    doWriteBrushFace(stream, face);
+    doWriteBrushFace(buffer, face);
   }
-  return PrecomputedString{stream.str(), brush.faces().size()};
+  return Model::SerializedNode{m_format, fmt::to_string(buffer), brush.faces().size()};
 }
 
-MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
+Model::SerializedNode MapFileSerializer::writePatch(
   const Model::BezierPatch& patch) const
 {
   size_t lineCount = 0u;
-  std::stringstream stream;
+  fmt::memory_buffer buffer;
 
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "{{\n");
+  fmt::format_to(std::back_inserter(buffer), "{{\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "patchDef2\n");
+  fmt::format_to(std::back_inserter(buffer), "patchDef2\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "{{\n");
+  fmt::format_to(std::back_inserter(buffer), "{{\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "{}\n", patch.textureName());
+  fmt::format_to(std::back_inserter(buffer), "{}\n", patch.textureName());
   ++lineCount;
   fmt::format_to(
-    std::ostreambuf_iterator<char>(stream),
+    std::back_inserter(buffer),
     "( {} {} 0 0 0 )\n",
     patch.pointRowCount(),
     patch.pointColumnCount());
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "(\n");
+  fmt::format_to(std::back_inserter(buffer), "(\n");
   ++lineCount;
 
   for (size_t row = 0u; row < patch.pointRowCount(); ++row)
   {
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "( ");
+    fmt::format_to(std::back_inserter(buffer), "( ");
     for (size_t col = 0u; col < patch.pointColumnCount(); ++col)
     {
       const auto& p = patch.controlPoint(row, col);
       fmt::format_to(
-        std::ostreambuf_iterator<char>(stream),
+        std::back_inserter(buffer),
         "( {} {} {} {} {} ) ",
         p[0],
         p[1],
@@ -500,18 +540,18 @@ MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
         p[3],
         p[4]);
     }
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), ")\n");
+    fmt::format_to(std::back_inserter(buffer), ")\n");
     ++lineCount;
   }
 
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), ")\n");
+  fmt::format_to(std::back_inserter(buffer), ")\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n");
+  fmt::format_to(std::back_inserter(buffer), "}}\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n");
+  fmt::format_to(std::back_inserter(buffer), "}}\n");
   ++lineCount;
 
-  return PrecomputedString{stream.str(), lineCount};
+  return Model::SerializedNode{m_format, fmt::to_string(buffer), lineCount};
 }
 } // namespace IO
 } // namespace TrenchBroom
@@ -21,6 +21,9 @@
 
 #include "IO/NodeSerializer.h"
 #include "Model/MapFormat.h"
+#include "Model/Node.h"
+
+#include <fmt/format.h>
 
 #include <iosfwd>
 #include <memory>
@@ -47,21 +50,26 @@ private:
   using LineStack = std::vector<size_t>;
   LineStack m_startLineStack;
   size_t m_line;
+  Model::MapFormat m_format;
   std::ostream& m_stream;
 
-  struct PrecomputedString
-  {
-    std::string string;
-    size_t lineCount;
-  };
-  std::unordered_map<const Model::Node*, PrecomputedString> m_nodeToPrecomputedString;
+  /**
+   * Formatting directly into the stream is slow because every character passes through
+   * the stream buffer, so the output is collected here and written to the stream in
+   * large chunks.
+   */
+  fmt::memory_buffer m_buffer;
+  static constexpr size_t FlushThreshold = 1u << 20;
+
+  std::unordered_map<const Model::Node*, const Model::SerializedNode*>
+    m_nodeToPrecomputedString;
 
 public:
   static std::unique_ptr<NodeSerializer> create(
     Model::MapFormat format, std::ostream& stream);
 
 protected:
-  explicit MapFileSerializer(std::ostream& stream);
+  MapFileSerializer(Model::MapFormat format, std::ostream& stream);
 
 private:
   void doBeginFile(const std::vector<const Model::Node*>& rootNodes) override;
@@ -78,12 +86,13 @@ private:
 private:
   void setFilePosition(const Model::Node* node);
   size_t startLine();
+  void flushBuffer(bool force);
 
 private: // threadsafe
   virtual void doWriteBrushFace(
-    std::ostream& stream, const Model::BrushFace& face) const = 0;
-  PrecomputedString writeBrushFaces(const Model::Brush& brush) const;
-  PrecomputedString writePatch(const Model::BezierPatch& patch) const;
+    fmt::memory_buffer& buffer, const Model::BrushFace& face) const = 0;
+  Model::SerializedNode writeBrushFaces(const Model::Brush& brush) const;
+  Model::SerializedNode writePatch(const Model::BezierPatch& patch) const;
 };
 } // namespace IO
 } // namespace TrenchBroom
@@ -19,8 +19,14 @@
 
 #include "MapReader.h"
 
+#include "Color.h"
 #include "Error.h"
+#include "Exceptions.h"
+#include "IO/BinaryNodeSerializer.h"
 #include "IO/ParserStatus.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Logger.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
 #include "Model/Entity.h"
@@ -33,6 +39,7 @@
 #include "Model/PatchNode.h"
 #include "Model/VisibilityState.h"
 #include "Model/WorldNode.h"
+#include "Profiler.h"
 #include "Uuid.h"
 
 #include "kdl/parallel.h"
@@ -40,12 +47,17 @@
 #include "kdl/result_fold.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/mat.h"
 #include "vm/mat_io.h"
 
 #include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -56,26 +68,881 @@
 namespace TrenchBroom::IO
 {
 
+/**
+ * Builds the geometry of parsed brushes on the default thread pool while the parser
+ * continues.
+ *
+ * Completed brushes are collected into batches. When a batch is full, it is handed to the
+ * thread pool. To bound the number of batches waiting for a worker, the parsing thread
+ * builds a batch itself if too many batches are pending. The results are stored in a per
+ * batch vector and are written back to the object infos (in file order) by finish().
+ */
+class MapReader::BrushGeometryPipeline
+{
+private:
+  static constexpr size_t BatchSize = 256;
+
+  struct Batch
+  {
+    std::vector<size_t> objectInfoIndices;
+    std::vector<std::vector<Model::BrushFace>> faces;
+    std::vector<Result<Model::Brush>> brushes;
+  };
+
+  vm::bbox3 m_worldBounds;
+  size_t m_maxPendingBatches;
+
+  std::vector<std::shared_ptr<Batch>> m_batches;
+  std::shared_ptr<Batch> m_currentBatch;
+
+  std::mutex m_mutex;
+  std::condition_variable m_batchDone;
+  size_t m_pendingBatches = 0;
+  std::exception_ptr m_exception;
+
+public:
+  explicit BrushGeometryPipeline(const vm::bbox3& worldBounds)
+    : m_worldBounds{worldBounds}
+    , m_maxPendingBatches{2 * kdl::default_thread_pool().size()}
+  {
+  }
+
+  ~BrushGeometryPipeline() { waitForPendingBatches(); }
+
+  BrushGeometryPipeline(const BrushGeometryPipeline&) = delete;
+  BrushGeometryPipeline& operator=(const BrushGeometryPipeline&) = delete;
+
+  /**
+   * Adds the faces of the brush with the given object info index to the current batch.
+   * If the batch is full, it is submitted to the thread pool.
+   */
+  void add(const size_t objectInfoIndex, std::vector<Model::BrushFace> faces)
+  {
+    if (!m_currentBatch)
+    {
+      m_currentBatch = std::make_shared<Batch>();
+      m_currentBatch->objectInfoIndices.reserve(BatchSize);
+      m_currentBatch->faces.reserve(BatchSize);
+    }
+
+    m_currentBatch->objectInfoIndices.push_back(objectInfoIndex);
+    m_currentBatch->faces.push_back(std::move(faces));
+
+    if (m_currentBatch->faces.size() == BatchSize)
+    {
+      submit(std::move(m_currentBatch));
+    }
+  }
+
+  /**
+   * Waits until all batches have been built and stores the built brushes in the
+   * corresponding object infos. The faces of the last, incomplete batch are returned to
+   * their object infos without building them.
+   */
+  void finish(std::vector<ObjectInfo>& objectInfos)
+  {
+    if (m_currentBatch)
+    {
+      for (size_t i = 0; i < m_currentBatch->faces.size(); ++i)
+      {
+        auto& brushInfo =
+          std::get<BrushInfo>(objectInfos[m_currentBatch->objectInfoIndices[i]]);
+        brushInfo.faces = std::move(m_currentBatch->faces[i]);
+      }
+      m_currentBatch.reset();
+    }
+
+    waitForPendingBatches();
+    if (m_exception)
+    {
+      std::rethrow_exception(m_exception);
+    }
+
+    for (auto& batch : m_batches)
+    {
+      for (size_t i = 0; i < batch->brushes.size(); ++i)
+      {
+        auto& brushInfo = std::get<BrushInfo>(objectInfos[batch->objectInfoIndices[i]]);
+        brushInfo.brush = std::move(batch->brushes[i]);
+      }
+    }
+    m_batches.clear();
+  }
+
+private:
+  void submit(std::shared_ptr<Batch> batch)
+  {
+    m_batches.push_back(batch);
+
+    {
+      auto lock = std::unique_lock{m_mutex};
+      if (m_pendingBatches >= m_maxPendingBatches)
+      {
+        lock.unlock();
+        build(*batch);
+        return;
+      }
+      ++m_pendingBatches;
+    }
+
+    kdl::default_thread_pool().submit([this, batch = std::move(batch)]() {
+      auto exception = std::exception_ptr{};
+      try
+      {
+        build(*batch);
+      }
+      catch (...)
+      {
+        exception = std::current_exception();
+      }
+
+      // notify while holding the lock so that the pipeline cannot be destroyed before
+      // this task stops accessing it
+      auto lock = std::unique_lock{m_mutex};
+      if (exception && !m_exception)
+      {
+        m_exception = exception;
+      }
+      --m_pendingBatches;
+      m_batchDone.notify_all();
+    });
+  }
+
+  void build(Batch& batch) const
+  {
+    const auto zone = ProfilerZone{"MapReader::buildBrushes"};
+    batch.brushes.reserve(batch.faces.size());
+    for (auto& faces : batch.faces)
+    {
+      batch.brushes.push_back(Model::Brush::create(m_worldBounds, std::move(faces)));
+    }
+    batch.faces.clear();
+  }
+
+  void waitForPendingBatches()
+  {
+    auto lock = std::unique_lock{m_mutex};
+    m_batchDone.wait(lock, [&]() { return m_pendingBatches == 0; });
+  }
+};
+
+/**
+ * Parses a single chunk of a map for readEntitiesInChunks. The chunk is parsed into its
+ * own object infos, and the geometry of its brushes is built right away, so that the
+ * chunks can be processed independently of each other.
+ */
+class MapReader::ChunkReader : public MapReader
+{
+public:
+  enum class Type
+  {
+    /** The chunk contains one or more complete entities. */
+    Entities,
+    /** The chunk contains brushes and patches that belong to an enclosing entity. */
+    Brushes,
+  };
+
+  ChunkReader(
+    const std::string_view str,
+    const Model::MapFormat sourceMapFormat,
+    const Model::MapFormat targetMapFormat,
+    Model::EntityPropertyConfig entityPropertyConfig,
+    const size_t line,
+    const size_t column)
+    : MapReader{
+      str,
+      sourceMapFormat,
+      targetMapFormat,
+      std::move(entityPropertyConfig),
+      line,
+      column}
+  {
+  }
+
+  /**
+   * Parses the chunk and returns the recorded object infos.
+   *
+   * @throws ParserException if parsing fails
+   */
+  std::vector<ObjectInfo> read(
+    const Type type, const vm::bbox3& worldBounds, ParserStatus& status)
+  {
+    switch (type)
+    {
+    case Type::Entities:
+      parseEntities(status);
+      break;
+    case Type::Brushes:
+      parseBrushesOrPatches(status);
+      break;
+    }
+
+    for (auto& objectInfo : m_objectInfos)
+    {
+      if (auto* brushInfo = std::get_if<BrushInfo>(&objectInfo))
+      {
+        brushInfo->brush = Model::Brush::create(worldBounds, std::move(brushInfo->faces));
+      }
+    }
+
+    return std::move(m_objectInfos);
+  }
+
+private: // the nodes are created by the reader that owns the chunks
+  Model::Node* onWorldNode(std::unique_ptr<Model::WorldNode>, ParserStatus&) override
+  {
+    return nullptr;
+  }
+  void onLayerNode(std::unique_ptr<Model::Node>, ParserStatus&) override {}
+  void onNode(Model::Node*, std::unique_ptr<Model::Node>, ParserStatus&) override {}
+};
+
 MapReader::MapReader(
   std::string_view str,
   const Model::MapFormat sourceMapFormat,
   const Model::MapFormat targetMapFormat,
-  Model::EntityPropertyConfig entityPropertyConfig)
-  : StandardMapParser{std::move(str), sourceMapFormat, targetMapFormat}
+  Model::EntityPropertyConfig entityPropertyConfig,
+  const size_t line,
+  const size_t column)
+  : StandardMapParser{str, sourceMapFormat, targetMapFormat, line, column}
+  , m_str{str}
   , m_entityPropertyConfig{std::move(entityPropertyConfig)}
 {
 }
 
+MapReader::~MapReader() = default;
+
 void MapReader::readEntities(const vm::bbox3& worldBounds, ParserStatus& status)
 {
+  const auto zone = ProfilerZone{"MapReader::readEntities"};
+  m_worldBounds = worldBounds;
+  m_brushGeometryPipeline = std::make_unique<BrushGeometryPipeline>(worldBounds);
+  {
+    const auto parseZone = ProfilerZone{"MapReader::parseEntities"};
+    parseEntities(status);
+  }
+  createNodes(status);
+}
+
+namespace
+{
+std::string readBinaryString(Reader& reader)
+{
+  const auto size = reader.readSize<std::uint32_t>();
+  return reader.readString(size);
+}
+
+vm::vec3 readBinaryVec3(Reader& reader)
+{
+  return reader.readVec<double, 3, FloatType>();
+}
+
+Model::BrushFaceAttributes readBinaryFaceAttributes(Reader& reader)
+{
+  auto attribs = Model::BrushFaceAttributes{readBinaryString(reader)};
+  attribs.setXOffset(reader.readFloat<float>());
+  attribs.setYOffset(reader.readFloat<float>());
+  attribs.setRotation(reader.readFloat<float>());
+  attribs.setXScale(reader.readFloat<float>());
+  attribs.setYScale(reader.readFloat<float>());
+  return attribs;
+}
+
+void readBinaryFaceFlags(Reader& reader, Model::BrushFaceAttributes& attribs)
+{
+  const auto flags = reader.readUnsignedChar<std::uint8_t>();
+  if (flags & BinaryNodeFormat::HasSurfaceAttributes)
+  {
+    attribs.setSurfaceContents(reader.readInt<std::int32_t>());
+    attribs.setSurfaceFlags(reader.readInt<std::int32_t>());
+    attribs.setSurfaceValue(reader.readFloat<float>());
+  }
+  if (flags & BinaryNodeFormat::HasColor)
+  {
+    const auto r = reader.readFloat<float>();
+    const auto g = reader.readFloat<float>();
+    const auto b = reader.readFloat<float>();
+    const auto a = reader.readFloat<float>();
+    attribs.setColor(Color{r, g, b, a});
+  }
+}
+} // namespace
+
+void MapReader::readBinaryEntities(const vm::bbox3& worldBounds, ParserStatus& status)
+{
+  const auto zone = ProfilerZone{"MapReader::readBinaryEntities"};
+  if (BinaryNodeFormat::readHeader(m_str) != m_sourceMapFormat)
+  {
+    throw ParserException{"Invalid binary node data header"};
+  }
+
+  m_worldBounds = worldBounds;
+  m_brushGeometryPipeline = std::make_unique<BrushGeometryPipeline>(worldBounds);
+
+  // the binary data has no lines, so we use the record number instead
+  auto record = size_t(0);
+  try
+  {
+    auto reader = Reader::from(m_str.data(), m_str.data() + m_str.size());
+    reader.seekFromBegin(BinaryNodeFormat::headerSize());
+
+    const auto readTag = [&]() {
+      return static_cast<BinaryNodeFormat::Tag>(reader.readUnsignedChar<std::uint8_t>());
+    };
+
+    const auto readFace = [&]() {
+      const auto p1 = readBinaryVec3(reader);
+      const auto p2 = readBinaryVec3(reader);
+      const auto p3 = readBinaryVec3(reader);
+      auto attribs = readBinaryFaceAttributes(reader);
+      if (Model::isParallelTexCoordSystem(m_sourceMapFormat))
+      {
+        const auto texAxisX = readBinaryVec3(reader);
+        const auto texAxisY = readBinaryVec3(reader);
+        readBinaryFaceFlags(reader, attribs);
+        onValveBrushFace(
+          record, m_targetMapFormat, p1, p2, p3, attribs, texAxisX, texAxisY, status);
+      }
+      else
+      {
+        readBinaryFaceFlags(reader, attribs);
+        onStandardBrushFace(record, m_targetMapFormat, p1, p2, p3, attribs, status);
+      }
+    };
+
+    auto entityStart = std::optional<size_t>{};
+    auto tag = readTag();
+    while (tag != BinaryNodeFormat::Tag::End)
+    {
+      ++record;
+      auto nextTag = std::optional<BinaryNodeFormat::Tag>{};
+      switch (tag)
+      {
+      case BinaryNodeFormat::Tag::BeginEntity: {
+        if (entityStart)
+        {
+          throw ParserException{record, "Unexpected entity"};
+        }
+        entityStart = record;
+
+        // the properties follow immediately
+        auto properties = std::vector<Model::EntityProperty>{};
+        nextTag = readTag();
+        while (nextTag == BinaryNodeFormat::Tag::EntityProperty)
+        {
+          auto key = readBinaryString(reader);
+          auto value = readBinaryString(reader);
+          properties.emplace_back(std::move(key), std::move(value));
+          nextTag = readTag();
+        }
+        onBeginEntity(record, std::move(properties), status);
+        break;
+      }
+      case BinaryNodeFormat::Tag::EndEntity:
+        if (!entityStart)
+        {
+          throw ParserException{record, "Unexpected end of entity"};
+        }
+        onEndEntity(*entityStart, record - *entityStart + 1, status);
+        entityStart = std::nullopt;
+        break;
+      case BinaryNodeFormat::Tag::Brush: {
+        if (!entityStart)
+        {
+          throw ParserException{record, "Brush outside of entity"};
+        }
+        onBeginBrush(record, status);
+        const auto faceCount = reader.readSize<std::uint32_t>();
+        for (size_t i = 0; i < faceCount; ++i)
+        {
+          readFace();
+        }
+        onEndBrush(record, 1, status);
+        break;
+      }
+      case BinaryNodeFormat::Tag::Patch: {
+        if (!entityStart)
+        {
+          throw ParserException{record, "Patch outside of entity"};
+        }
+        const auto rowCount = reader.readSize<std::uint32_t>();
+        const auto columnCount = reader.readSize<std::uint32_t>();
+        auto textureName = readBinaryString(reader);
+        auto controlPoints = std::vector<vm::vec<FloatType, 5>>{};
+        controlPoints.reserve(rowCount * columnCount);
+        for (size_t i = 0; i < rowCount * columnCount; ++i)
+        {
+          controlPoints.push_back(reader.readVec<double, 5, FloatType>());
+        }
+        onPatch(
+          record,
+          1,
+          m_targetMapFormat,
+          rowCount,
+          columnCount,
+          std::move(controlPoints),
+          std::move(textureName),
+          status);
+        break;
+      }
+      default:
+        throw ParserException{record, "Unexpected binary node record"};
+      }
+
+      tag = nextTag ? *nextTag : readTag();
+    }
+
+    if (entityStart)
+    {
+      throw ParserException{record, "Unterminated entity"};
+    }
+  }
+  catch (const ReaderException& e)
+  {
+    throw ParserException{record, e.what()};
+  }
+
+  createNodes(status);
+}
+
+namespace
+{
+struct TextPosition
+{
+  size_t offset;
+  size_t line;
+  size_t column;
+};
+
+/** A brush or patch, i.e., a block that is nested directly within an entity. */
+struct BlockRange
+{
+  TextPosition begin;
+  TextPosition end;
+};
+
+struct EntityRange
+{
+  TextPosition begin;
+  TextPosition end;
+  size_t closingLine;
+  std::vector<BlockRange> blocks;
+};
+
+bool isBlank(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Finds the top level entities and the blocks nested directly within them by counting
+ * the braces in the given string. Braces in quoted strings and comments are ignored, and
+ * a brace only counts if it is a token on its own so that texture names such as "{water"
+ * are not mistaken for braces.
+ *
+ * This scan does not validate the input. If the braces are unbalanced, an empty optional
+ * is returned.
+ */
+std::optional<std::vector<EntityRange>> scanEntities(
+  const std::string_view str, const size_t line, const size_t column)
+{
+  auto result = std::vector<EntityRange>{};
+  auto pos = TextPosition{0, line, column};
+  auto depth = size_t(0);
+
+  const auto lookAhead = [&](const size_t offset) {
+    return pos.offset + offset < str.size() ? str[pos.offset + offset] : '\0';
+  };
+
+  // advances like the tokenizer does so that the line and column numbers match
+  const auto advance = [&]() {
+    const auto c = str[pos.offset++];
+    if (c == '\n' || (c == '\r' && lookAhead(0) != '\n'))
+    {
+      ++pos.line;
+      pos.column = 1;
+    }
+    else
+    {
+      ++pos.column;
+    }
+  };
+
+  const auto skipLine = [&]() {
+    while (pos.offset < str.size() && str[pos.offset] != '\n' && str[pos.offset] != '\r')
+    {
+      advance();
+    }
+  };
+
+  const auto isStandalone = [&]() {
+    const auto next = lookAhead(1);
+    return next == '\0' || isBlank(next);
+  };
+
+  while (pos.offset < str.size())
+  {
+    switch (str[pos.offset])
+    {
+    case '"':
+      advance();
+      while (pos.offset < str.size() && str[pos.offset] != '"')
+      {
+        if (
+          str[pos.offset] == '\\' && lookAhead(1) == '"' && lookAhead(2) != '\n'
+          && lookAhead(2) != '}')
+        {
+          advance();
+        }
+        advance();
+      }
+      if (pos.offset == str.size())
+      {
+        return std::nullopt;
+      }
+      advance();
+      break;
+    case '/':
+      if (lookAhead(1) == '/')
+      {
+        skipLine();
+      }
+      else
+      {
+        advance();
+      }
+      break;
+    case ';':
+      skipLine();
+      break;
+    case '{':
+      if (!isStandalone())
+      {
+        skipLine();
+        break;
+      }
+      if (depth == 0)
+      {
+        result.push_back(EntityRange{pos, pos, 0, {}});
+      }
+      else if (depth == 1)
+      {
+        result.back().blocks.push_back(BlockRange{pos, pos});
+      }
+      ++depth;
+      advance();
+      break;
+    case '}':
+      if (!isStandalone())
+      {
+        skipLine();
+        break;
+      }
+      if (depth == 0)
+      {
+        return std::nullopt;
+      }
+      --depth;
+      if (depth == 0)
+      {
+        result.back().closingLine = pos.line;
+      }
+      advance();
+      if (depth == 0)
+      {
+        result.back().end = pos;
+      }
+      else if (depth == 1)
+      {
+        result.back().blocks.back().end = pos;
+      }
+      break;
+    default:
+      if (isBlank(str[pos.offset]))
+      {
+        advance();
+      }
+      else
+      {
+        // skip the remainder of the token
+        while (pos.offset < str.size() && !isBlank(str[pos.offset]))
+        {
+          advance();
+        }
+      }
+      break;
+    }
+  }
+
+  if (depth != 0)
+  {
+    return std::nullopt;
+  }
+
+  return result;
+}
+
+/**
+ * A part of a map that can be parsed independently.
+ *
+ * If an entity is too large, it is split into a header, which contains only its
+ * properties and is parsed as an entity, and chunks of brushes and patches, which are
+ * parsed on their own and added to the entity created from the header.
+ */
+struct MapChunk
+{
+  enum class Type
+  {
+    Entities,
+    EntityHeader,
+    Brushes,
+  };
+
+  Type type;
+  std::string_view str;
+  size_t line;
+  size_t column;
+
+  // only set for entity headers, since the closing brace is not part of the header
+  std::string ownedStr = {};
+  size_t closingLine = 0;
+
+  std::string_view text() const { return type == Type::EntityHeader ? ownedStr : str; }
+};
+
+/**
+ * Checks whether the given string contains nothing but whitespace and comments.
+ */
+bool containsOnlyComments(const std::string_view str)
+{
+  try
+  {
+    auto tokenizer = QuakeMapTokenizer{str};
+    return tokenizer.nextToken(QuakeMapToken::Comment).hasType(QuakeMapToken::Eof);
+  }
+  catch (const ParserException&)
+  {
+    return false;
+  }
+}
+
+/**
+ * Splits the given string into chunks of at least the given size. Returns an empty
+ * optional if the string cannot be split.
+ */
+std::optional<std::vector<MapChunk>> makeChunks(
+  const std::string_view str,
+  const size_t line,
+  const size_t column,
+  const size_t chunkSize)
+{
+  const auto entities = scanEntities(str, line, column);
+  if (!entities)
+  {
+    return std::nullopt;
+  }
+
+  auto chunks = std::vector<MapChunk>{};
+  auto chunkBegin = TextPosition{0, line, column};
+
+  const auto addEntitiesChunk = [&](const TextPosition& end) {
+    if (end.offset > chunkBegin.offset)
+    {
+      chunks.push_back(MapChunk{
+        MapChunk::Type::Entities,
+        str.substr(chunkBegin.offset, end.offset - chunkBegin.offset),
+        chunkBegin.line,
+        chunkBegin.column});
+    }
+    chunkBegin = end;
+  };
+
+  for (const auto& entity : *entities)
+  {
+    const auto& blocks = entity.blocks;
+    if (entity.end.offset - entity.begin.offset <= chunkSize || blocks.empty())
+    {
+      if (entity.end.offset - chunkBegin.offset >= chunkSize)
+      {
+        addEntitiesChunk(entity.end);
+      }
+      continue;
+    }
+
+    // the text after the last block must not contain anything but comments since it is
+    // not parsed as part of the entity
+    const auto tailBegin = blocks.back().end.offset;
+    if (!containsOnlyComments(str.substr(tailBegin, entity.end.offset - 1 - tailBegin)))
+    {
+      return std::nullopt;
+    }
+
+    addEntitiesChunk(entity.begin);
+
+    const auto headerLength = blocks.front().begin.offset - entity.begin.offset;
+    chunks.push_back(MapChunk{
+      MapChunk::Type::EntityHeader,
+      {},
+      entity.begin.line,
+      entity.begin.column,
+      std::string{str.substr(entity.begin.offset, headerLength)} + "}",
+      entity.closingLine});
+
+    auto blocksBegin = blocks.front().begin;
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+      const auto isLast = i + 1 == blocks.size();
+      if (isLast || blocks[i].end.offset - blocksBegin.offset >= chunkSize)
+      {
+        // the text between two chunks of blocks is added to the first chunk
+        const auto blocksEnd = isLast ? blocks[i].end : blocks[i + 1].begin;
+        chunks.push_back(MapChunk{
+          MapChunk::Type::Brushes,
+          str.substr(blocksBegin.offset, blocksEnd.offset - blocksBegin.offset),
+          blocksBegin.line,
+          blocksBegin.column});
+        blocksBegin = blocksEnd;
+      }
+    }
+
+    chunkBegin = entity.end;
+  }
+
+  addEntitiesChunk(TextPosition{str.size(), 0, 0});
+  return chunks;
+}
+
+Logger& nullLogger()
+{
+  static auto logger = NullLogger{};
+  return logger;
+}
+
+/**
+ * The status used to parse a chunk. Since the messages of the chunks could not be
+ * reported in file order, they are not reported at all. Instead, the status records
+ * whether any message was logged so that the map can be read again without chunks.
+ */
+class ChunkParserStatus : public ParserStatus
+{
+private:
+  bool m_hasMessages = false;
+
+public:
+  ChunkParserStatus()
+    : ParserStatus{nullLogger(), ""}
+  {
+  }
+
+  bool hasMessages() const { return m_hasMessages; }
+
+private:
+  void doProgress(double) override {}
+  void doLog(LogLevel, const std::string&) override { m_hasMessages = true; }
+};
+} // namespace
+
+void MapReader::readEntitiesInChunks(
+  const vm::bbox3& worldBounds, ParserStatus& status, const size_t chunkSize)
+{
+  const auto zone = ProfilerZone{"MapReader::readEntitiesInChunks"};
+  const auto chunks = m_str.size() / 2 > chunkSize
+                        ? makeChunks(m_str, 1, 1, chunkSize)
+                        : std::optional<std::vector<MapChunk>>{};
+  if (!chunks || chunks->size() < 2)
+  {
+    readEntities(worldBounds, status);
+    return;
+  }
+
+  auto chunkResults = kdl::vec_parallel_transform(
+    *chunks, [&](const MapChunk& chunk) -> std::optional<std::vector<ObjectInfo>> {
+      const auto chunkZone = ProfilerZone{"MapReader::readChunk"};
+      try
+      {
+        auto chunkStatus = ChunkParserStatus{};
+        auto reader = ChunkReader{
+          chunk.text(),
+          m_sourceMapFormat,
+          m_targetMapFormat,
+          m_entityPropertyConfig,
+          chunk.line,
+          chunk.column};
+        auto objectInfos = reader.read(
+          chunk.type == MapChunk::Type::Brushes ? ChunkReader::Type::Brushes
+                                                : ChunkReader::Type::Entities,
+          worldBounds,
+          chunkStatus);
+        if (chunkStatus.hasMessages())
+        {
+          return std::nullopt;
+        }
+        return objectInfos;
+      }
+      catch (const ParserException&)
+      {
+        return std::nullopt;
+      }
+    });
+
+  // merge the object infos in file order
+  auto entityIndex = std::optional<size_t>{};
+  for (size_t i = 0; i < chunks->size(); ++i)
+  {
+    const auto& chunk = (*chunks)[i];
+    auto& chunkResult = chunkResults[i];
+
+    const auto isValidHeader = [&]() {
+      return chunkResult->size() == 1
+             && std::holds_alternative<EntityInfo>(chunkResult->front());
+    };
+
+    if (!chunkResult || (chunk.type == MapChunk::Type::EntityHeader && !isValidHeader()))
+    {
+      // read the map again so that any messages are reported in file order
+      m_objectInfos.clear();
+      readEntities(worldBounds, status);
+      return;
+    }
+
+    const auto baseIndex = m_objectInfos.size();
+    for (auto& objectInfo : *chunkResult)
+    {
+      std::visit(
+        kdl::overload(
+          [&](EntityInfo& entityInfo) {
+            if (chunk.type == MapChunk::Type::EntityHeader)
+            {
+              entityInfo.lineCount = chunk.closingLine - entityInfo.startLine;
+              entityIndex = baseIndex;
+            }
+          },
+          [&](auto& brushOrPatchInfo) {
+            if (chunk.type == MapChunk::Type::Brushes)
+            {
+              brushOrPatchInfo.parentIndex = entityIndex;
+            }
+            else if (brushOrPatchInfo.parentIndex)
+            {
+              *brushOrPatchInfo.parentIndex += baseIndex;
+            }
+          }),
+        objectInfo);
+
+      m_objectInfos.push_back(std::move(objectInfo));
+    }
+
+    status.progress(double(i + 1) / double(chunks->size()));
+  }
+
   m_worldBounds = worldBounds;
-  parseEntities(status);
   createNodes(status);
 }
 
 void MapReader::readBrushes(const vm::bbox3& worldBounds, ParserStatus& status)
 {
   m_worldBounds = worldBounds;
+  m_brushGeometryPipeline = std::make_unique<BrushGeometryPipeline>(worldBounds);
   parseBrushesOrPatches(status);
   createNodes(status);
 }
@@ -123,6 +990,11 @@ void MapReader::onEndBrush(
   auto& brush = std::get<BrushInfo>(m_objectInfos.back());
   brush.startLine = startLine;
   brush.lineCount = lineCount;
+
+  if (m_brushGeometryPipeline)
+  {
+    m_brushGeometryPipeline->add(m_objectInfos.size() - 1, std::move(brush.faces));
+  }
 }
 
 void MapReader::onStandardBrushFace(
@@ -575,7 +1447,10 @@ CreateNodeResult createNodeFromEntityInfo(
 CreateNodeResult createBrushNode(
   MapReader::BrushInfo brushInfo, const vm::bbox3& worldBounds)
 {
-  return Model::Brush::create(worldBounds, std::move(brushInfo.faces))
+  auto brushResult = brushInfo.brush
+                       ? std::move(*brushInfo.brush)
+                       : Model::Brush::create(worldBounds, std::move(brushInfo.faces));
+  return std::move(brushResult)
     .transform([&](auto brush) {
       auto brushNode = std::make_unique<Model::BrushNode>(std::move(brush));
       brushNode->setFilePosition(brushInfo.startLine, brushInfo.lineCount);
@@ -916,6 +1791,14 @@ std::unordered_map<Model::Node*, Model::Node*> buildNodeToParentMap(
  */
 void MapReader::createNodes(ParserStatus& status)
 {
+  const auto zone = ProfilerZone{"MapReader::createNodes"};
+  // collect the brushes that were built while parsing
+  if (m_brushGeometryPipeline)
+  {
+    m_brushGeometryPipeline->finish(m_objectInfos);
+    m_brushGeometryPipeline.reset();
+  }
+
   // create nodes from the recorded object infos
   auto nodeInfos = createNodesFromObjectInfos(
     m_entityPropertyConfig,
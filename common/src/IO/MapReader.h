@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Error.h"
 #include "FloatType.h"
 #include "IO/StandardMapParser.h"
 #include "Model/BezierPatch.h"
@@ -26,12 +27,14 @@
 #include "Model/BrushFace.h"
 #include "Model/EntityProperties.h"
 #include "Model/IdType.h"
+#include "Result.h"
 
 #include "kdl/result.h"
 
 #include "vm/bbox.h"
 #include "vm/forward.h"
 
+#include <memory>
 #include <optional>
 #include <string_view>
 #include <variant>
@@ -65,7 +68,8 @@ class ParserStatus;
  * The flow of control is:
  *
  * 1. MapParser callbacks get called with the raw data, which we just store
- * (m_objectInfos).
+ * (m_objectInfos). While parsing continues, the geometry of completed brushes is built
+ * in batches on worker threads (see BrushGeometryPipeline).
  * 2. Convert the raw data to nodes in parallel (createNodes) and record any additional
  * information necessary to restore the parent / child relationships.
  * 3. Validate the created nodes.
@@ -88,6 +92,8 @@ public: // only public so that helper methods can see these declarations
     size_t startLine;
     size_t lineCount;
     std::optional<size_t> parentIndex;
+    // set if the brush was already built from its faces while parsing
+    std::optional<Result<Model::Brush>> brush = std::nullopt;
   };
 
   struct PatchInfo
@@ -104,12 +110,17 @@ public: // only public so that helper methods can see these declarations
   using ObjectInfo = std::variant<EntityInfo, BrushInfo, PatchInfo>;
 
 private:
+  class BrushGeometryPipeline;
+  class ChunkReader;
+
+  std::string_view m_str;
   Model::EntityPropertyConfig m_entityPropertyConfig;
   vm::bbox3 m_worldBounds;
 
 private: // data populated in response to MapParser callbacks
   std::vector<ObjectInfo> m_objectInfos;
   std::optional<size_t> m_currentEntityInfo;
+  std::unique_ptr<BrushGeometryPipeline> m_brushGeometryPipeline;
 
 protected:
   /**
@@ -121,19 +132,49 @@ protected:
    * @param targetMapFormat the format to convert the created objects to
    * @param entityPropertyConfig the entity property config to use
    * if orphaned
+   * @param line the line number of the beginning of the given string
+   * @param column the column number of the beginning of the given string
    */
   MapReader(
     std::string_view str,
     Model::MapFormat sourceMapFormat,
     Model::MapFormat targetMapFormat,
-    Model::EntityPropertyConfig entityPropertyConfig);
+    Model::EntityPropertyConfig entityPropertyConfig,
+    size_t line = 1,
+    size_t column = 1);
+
+public:
+  ~MapReader() override;
 
+protected:
   /**
    * Attempts to parse as one or more entities.
    *
    * @throws ParserException if parsing fails
    */
   void readEntities(const vm::bbox3& worldBounds, ParserStatus& status);
+  /**
+   * Like readEntities, but splits the input into chunks of approximately the given size
+   * and parses the chunks in parallel. The input is split at the boundaries of top level
+   * entities, and entities that are larger than a chunk are split further at the
+   * boundaries of their brushes and patches. The parsed objects are merged in file order
+   * and keep their original line numbers.
+   *
+   * If the input is too small or cannot be split, or if any chunk fails to parse, the
+   * input is read by readEntities instead, so that errors are reported exactly as if the
+   * input had been parsed sequentially.
+   *
+   * @throws ParserException if parsing fails
+   */
+  void readEntitiesInChunks(
+    const vm::bbox3& worldBounds, ParserStatus& status, size_t chunkSize);
+  /**
+   * Reads entities from data in the binary node format, see BinaryNodeSerializer. The
+   * data must have been written in this reader's source map format.
+   *
+   * @throws ParserException if the data is malformed
+   */
+  void readBinaryEntities(const vm::bbox3& worldBounds, ParserStatus& status);
   /**
    * Attempts to parse as one or more brushes without any enclosing entity.
    *
@@ -236,11 +236,13 @@ Md2Parser::Md2Parser(
   const std::string& name,
   const Reader& reader,
   const Assets::Palette& palette,
-  const FileSystem& fs)
+  const FileSystem& fs,
+  Assets::SkinCache* skinCache)
   : m_name(name)
   , m_reader(reader)
   , m_palette(palette)
   , m_fs(fs)
+  , m_skinCache(skinCache)
 {
 }
 
@@ -399,12 +401,12 @@ Md2Parser::Md2MeshList Md2Parser::parseMeshes(
 void Md2Parser::loadSkins(
   Assets::EntityModelSurface& surface, const Md2SkinList& skins, Logger& logger)
 {
-  std::vector<Assets::Texture> textures;
+  std::vector<std::shared_ptr<Assets::TextureCollection>> textures;
   textures.reserve(skins.size());
 
   for (const auto& skin : skins)
   {
-    textures.push_back(loadSkin(skin, m_fs, m_palette, logger));
+    textures.push_back(loadSkin(skin, m_fs, m_palette, m_skinCache, logger));
   }
 
   surface.setSkins(std::move(textures));
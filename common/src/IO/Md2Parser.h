@@ -34,7 +34,8 @@ namespace TrenchBroom
 namespace Assets
 {
 class Palette;
-}
+class SkinCache;
+} // namespace Assets
 
 namespace IO
 {
@@ -103,13 +104,15 @@ private:
   const Reader& m_reader;
   const Assets::Palette& m_palette;
   const FileSystem& m_fs;
+  Assets::SkinCache* m_skinCache;
 
 public:
   Md2Parser(
     const std::string& name,
     const Reader& reader,
     const Assets::Palette& palette,
-    const FileSystem& fs);
+    const FileSystem& fs,
+    Assets::SkinCache* skinCache = nullptr);
 
   static bool canParse(const std::filesystem::path& path, Reader reader);
 
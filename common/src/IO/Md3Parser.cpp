@@ -56,10 +56,15 @@ static const size_t VertexLength = 4 * sizeof(int16_t);
 static const float VertexScale = 1.0f / 64.0f;
 } // namespace Md3Layout
 
-Md3Parser::Md3Parser(const std::string& name, const Reader& reader, const FileSystem& fs)
+Md3Parser::Md3Parser(
+  const std::string& name,
+  const Reader& reader,
+  const FileSystem& fs,
+  Assets::SkinCache* skinCache)
   : m_name(name)
   , m_reader(reader)
   , m_fs(fs)
+  , m_skinCache(skinCache)
 {
 }
 
@@ -337,7 +342,7 @@ void Md3Parser::loadSurfaceSkins(
   const std::vector<std::filesystem::path>& shaders,
   Logger& logger)
 {
-  std::vector<Assets::Texture> textures;
+  std::vector<std::shared_ptr<Assets::TextureCollection>> textures;
   textures.reserve(shaders.size());
 
   for (const auto& shader : shaders)
@@ -348,11 +353,11 @@ void Md3Parser::loadSurfaceSkins(
   surface.setSkins(std::move(textures));
 }
 
-Assets::Texture Md3Parser::loadShader(
+std::shared_ptr<Assets::TextureCollection> Md3Parser::loadShader(
   Logger& logger, const std::filesystem::path& path) const
 {
   const auto shaderPath = kdl::path_remove_extension(path);
-  return IO::loadShader(shaderPath, m_fs, logger);
+  return IO::loadShader(shaderPath, m_fs, m_skinCache, logger);
 }
 
 void Md3Parser::buildFrameSurface(
@@ -33,8 +33,9 @@ namespace TrenchBroom
 {
 namespace Assets
 {
-class Texture;
-}
+class SkinCache;
+class TextureCollection;
+} // namespace Assets
 
 namespace IO
 {
@@ -47,6 +48,7 @@ private:
   std::string m_name;
   const Reader& m_reader;
   const FileSystem& m_fs;
+  Assets::SkinCache* m_skinCache;
 
 private:
   struct Md3Triangle
@@ -55,7 +57,11 @@ private:
   };
 
 public:
-  Md3Parser(const std::string& name, const Reader& reader, const FileSystem& fs);
+  Md3Parser(
+    const std::string& name,
+    const Reader& reader,
+    const FileSystem& fs,
+    Assets::SkinCache* skinCache = nullptr);
 
   static bool canParse(const std::filesystem::path& path, Reader reader);
 
@@ -87,7 +93,8 @@ private:
     Assets::EntityModelSurface& surface,
     const std::vector<std::filesystem::path>& shaders,
     Logger& logger);
-  Assets::Texture loadShader(Logger& logger, const std::filesystem::path& path) const;
+  std::shared_ptr<Assets::TextureCollection> loadShader(
+    Logger& logger, const std::filesystem::path& path) const;
 
   void buildFrameSurface(
     Assets::EntityModelLoadedFrame& frame,
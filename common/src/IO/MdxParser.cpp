@@ -20,6 +20,7 @@
 #include "MdxParser.h"
 
 #include "Assets/EntityModel.h"
+#include "Assets/Palette.h"
 #include "Assets/Texture.h"
 #include "Exceptions.h"
 #include "IO/Reader.h"
@@ -231,10 +232,15 @@ MdxParser::MdxMesh::MdxMesh(const int i_vertexCount)
 {
 }
 
-MdxParser::MdxParser(const std::string& name, const Reader& reader, const FileSystem& fs)
+MdxParser::MdxParser(
+  const std::string& name,
+  const Reader& reader,
+  const FileSystem& fs,
+  Assets::SkinCache* skinCache)
   : m_name(name)
   , m_reader(reader)
   , m_fs(fs)
+  , m_skinCache(skinCache)
 {
 }
 
@@ -402,13 +408,13 @@ MdxParser::MdxMeshList MdxParser::parseMeshes(
 void MdxParser::loadSkins(
   Assets::EntityModelSurface& surface, const MdxSkinList& skins, Logger& logger)
 {
-  std::vector<Assets::Texture> textures;
+  std::vector<std::shared_ptr<Assets::TextureCollection>> textures;
   textures.reserve(skins.size());
 
   for (const auto& skin : skins)
   {
     const auto path = std::filesystem::path{skin}.relative_path();
-    textures.push_back(loadSkin(path, m_fs, logger));
+    textures.push_back(loadSkin(path, m_fs, std::nullopt, m_skinCache, logger));
   }
 
   surface.setSkins(std::move(textures));
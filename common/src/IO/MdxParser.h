@@ -33,6 +33,11 @@ namespace TrenchBroom
 {
 class Logger;
 
+namespace Assets
+{
+class SkinCache;
+}
+
 namespace IO
 {
 class FileSystem;
@@ -100,9 +105,14 @@ private:
   std::string m_name;
   const Reader& m_reader;
   const FileSystem& m_fs;
+  Assets::SkinCache* m_skinCache;
 
 public:
-  MdxParser(const std::string& name, const Reader& reader, const FileSystem& fs);
+  MdxParser(
+    const std::string& name,
+    const Reader& reader,
+    const FileSystem& fs,
+    Assets::SkinCache* skinCache = nullptr);
 
   static bool canParse(const std::filesystem::path& path, Reader reader);
 
@@ -20,6 +20,7 @@
 #include "NodeReader.h"
 
 #include "Error.h"
+#include "IO/BinaryNodeSerializer.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushNode.h"
 #include "Model/Entity.h"
@@ -79,6 +80,36 @@ std::vector<Model::Node*> NodeReader::read(
   return {};
 }
 
+std::vector<Model::Node*> NodeReader::readBinary(
+  const std::string& data,
+  const Model::MapFormat mapFormat,
+  const vm::bbox3& worldBounds,
+  const Model::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status)
+{
+  if (BinaryNodeFormat::readHeader(data) != mapFormat)
+  {
+    return {};
+  }
+
+  auto reader = NodeReader{data, mapFormat, mapFormat, entityPropertyConfig};
+  try
+  {
+    reader.readBinaryEntities(worldBounds, status);
+    for (const auto& error : Model::initializeLinkIds(reader.m_nodes))
+    {
+      status.error("Could not restore linked groups: " + error.msg);
+    }
+    return reader.m_nodes;
+  }
+  catch (const ParserException& e)
+  {
+    status.info(std::string{"Couldn't read binary node data: "} + e.what());
+    kdl::vec_clear_and_delete(reader.m_nodes);
+  }
+  return {};
+}
+
 /**
  * Attempts to parse the string as one or more entities (in the given source format), and
  * if that fails, as one or more brushes.
@@ -100,7 +131,7 @@ std::vector<Model::Node*> NodeReader::readAsFormat(
     auto reader = NodeReader{str, sourceMapFormat, targetMapFormat, entityPropertyConfig};
     try
     {
-      reader.readEntities(worldBounds, status);
+      reader.readEntitiesInChunks(worldBounds, status, DefaultChunkSize);
       status.info(
         "Parsed successfully as " + Model::formatName(sourceMapFormat) + " entities");
       return reader.m_nodes;
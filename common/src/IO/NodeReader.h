@@ -40,6 +40,12 @@ private:
   std::vector<Model::Node*> m_nodes;
 
 public:
+  /**
+   * Strings larger than twice this size, e.g. large clipboard contents, are split into
+   * chunks of this size, which are parsed in parallel.
+   */
+  static constexpr size_t DefaultChunkSize = 1024 * 1024;
+
   /**
    * Creates a new parser where the given string is expected to be formatted in the given
    * source map format, and the created objects are converted to the given target format.
@@ -62,6 +68,18 @@ public:
     const Model::EntityPropertyConfig& entityPropertyConfig,
     ParserStatus& status);
 
+  /**
+   * Reads nodes from data in the binary node format, see BinaryNodeSerializer. Returns
+   * an empty vector if the data is malformed or was written in a map format other than
+   * the given one.
+   */
+  static std::vector<Model::Node*> readBinary(
+    const std::string& data,
+    Model::MapFormat mapFormat,
+    const vm::bbox3& worldBounds,
+    const Model::EntityPropertyConfig& entityPropertyConfig,
+    ParserStatus& status);
+
 private:
   static std::vector<Model::Node*> readAsFormat(
     Model::MapFormat sourceMapFormat,
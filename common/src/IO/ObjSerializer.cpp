@@ -29,10 +29,14 @@
 #include "Model/Polyhedron.h"
 
 #include "kdl/overload.h"
+#include "kdl/parallel.h"
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <utility>
 
 namespace TrenchBroom
@@ -102,31 +106,16 @@ ObjSerializer::ObjSerializer(
   ensure(m_mtlStream.good(), "mtl stream is good");
 }
 
-void ObjSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {}
+void ObjSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */)
+{
+  m_objStream << "mtllib " << m_mtlFilename << "\n";
+}
 
 static void writeMtlFile(
   std::ostream& str,
-  const std::vector<ObjSerializer::Object>& objects,
+  const std::map<std::string, const Assets::Texture*>& usedTextures,
   const IO::ObjExportOptions& options)
 {
-  auto usedTextures = std::map<std::string, const Assets::Texture*>{};
-
-  for (const auto& object : objects)
-  {
-    std::visit(
-      kdl::overload(
-        [&](const ObjSerializer::BrushObject& brushObject) {
-          for (const auto& face : brushObject.faces)
-          {
-            usedTextures[face.textureName] = face.texture;
-          }
-        },
-        [&](const ObjSerializer::PatchObject& patchObject) {
-          usedTextures[patchObject.textureName] = patchObject.texture;
-        }),
-      object);
-  }
-
   const auto basePath = options.exportPath.parent_path();
   for (const auto& [textureName, texture] : usedTextures)
   {
@@ -190,104 +179,90 @@ static void writeNormals(std::ostream& str, const std::vector<vm::vec3>& normals
   }
 }
 
-static void writeObjFile(
-  std::ostream& str,
-  const std::string mtlFilename,
-  const std::vector<vm::vec3>& vertices,
-  const std::vector<vm::vec2f>& texCoords,
-  const std::vector<vm::vec3>& normals,
-  const std::vector<ObjSerializer::Object>& objects)
+static void writeChunk(std::ostream& str, const ObjSerializer::Chunk& chunk)
 {
-
-  str << "mtllib " << mtlFilename << "\n";
-  writeVertices(str, vertices);
+  writeVertices(str, chunk.vertices);
   str << "\n";
-  writeTexCoords(str, texCoords);
+  writeTexCoords(str, chunk.texCoords);
   str << "\n";
-  writeNormals(str, normals);
+  writeNormals(str, chunk.normals);
   str << "\n";
 
-  for (const auto& object : objects)
+  for (const auto& object : chunk.objects)
   {
     str << object;
     str << "\n";
   }
 }
 
-void ObjSerializer::doEndFile()
+static ObjSerializer::BrushObject makeBrushObject(
+  const Model::BrushNode& brushNode,
+  const size_t entityNo,
+  const size_t brushNo,
+  ObjSerializer::IndexMap<vm::vec3>& vertices,
+  ObjSerializer::IndexMap<vm::vec2f>& texCoords,
+  ObjSerializer::IndexMap<vm::vec3>& normals)
 {
-  writeMtlFile(m_mtlStream, m_objects, m_options);
-  writeObjFile(
-    m_objStream,
-    m_mtlFilename,
-    m_vertices.list(),
-    m_texCoords.list(),
-    m_normals.list(),
-    m_objects);
-}
-
-void ObjSerializer::doBeginEntity(const Model::Node* /* node */) {}
-void ObjSerializer::doEndEntity(const Model::Node* /* node */) {}
-void ObjSerializer::doEntityProperty(const Model::EntityProperty& /* property */) {}
+  const auto& brush = brushNode.brush();
 
-void ObjSerializer::doBrush(const Model::BrushNode* brush)
-{
-  m_currentBrush = BrushObject{entityNo(), brushNo(), {}};
-  m_currentBrush->faces.reserve(brush->brush().faceCount());
+  auto brushObject = ObjSerializer::BrushObject{entityNo, brushNo, {}};
+  brushObject.faces.reserve(brush.faceCount());
 
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
+  auto positions = std::vector<vm::vec3>{};
+  auto faceTexCoords = std::vector<vm::vec2f>{};
 
-  for (const Model::BrushFace& face : brush->brush().faces())
+  for (const Model::BrushFace& face : brush.faces())
   {
-    doBrushFace(face);
-  }
-
-  m_objects.push_back(std::move(*m_currentBrush));
-  m_currentBrush = std::nullopt;
-}
+    positions.clear();
+    faceTexCoords.clear();
+    for (const Model::BrushVertex* vertex : face.vertices())
+    {
+      positions.push_back(vertex->position());
+    }
+    face.textureCoords(positions, faceTexCoords);
 
-void ObjSerializer::doBrushFace(const Model::BrushFace& face)
-{
-  const vm::vec3& normal = face.boundary().normal;
-  const size_t normalIndex = m_normals.index(normal);
+    const size_t normalIndex = normals.index(face.boundary().normal);
 
-  auto indexedVertices = std::vector<IndexedVertex>{};
-  indexedVertices.reserve(face.vertexCount());
+    auto indexedVertices = std::vector<ObjSerializer::IndexedVertex>{};
+    indexedVertices.reserve(positions.size());
 
-  for (const Model::BrushVertex* vertex : face.vertices())
-  {
-    const vm::vec3& position = vertex->position();
-    const vm::vec2f texCoords = face.textureCoords(position);
+    for (size_t i = 0u; i < positions.size(); ++i)
+    {
+      const size_t vertexIndex = vertices.index(positions[i]);
+      const size_t texCoordsIndex = texCoords.index(faceTexCoords[i]);
 
-    const size_t vertexIndex = m_vertices.index(position);
-    const size_t texCoordsIndex = m_texCoords.index(texCoords);
+      indexedVertices.push_back(
+        ObjSerializer::IndexedVertex{vertexIndex, texCoordsIndex, normalIndex});
+    }
 
-    indexedVertices.push_back(IndexedVertex{vertexIndex, texCoordsIndex, normalIndex});
+    brushObject.faces.push_back(ObjSerializer::BrushFace{
+      std::move(indexedVertices), face.attributes().textureName(), face.texture()});
   }
 
-  m_currentBrush->faces.push_back(BrushFace{
-    std::move(indexedVertices), face.attributes().textureName(), face.texture()});
+  return brushObject;
 }
 
-void ObjSerializer::doPatch(const Model::PatchNode* patchNode)
+static ObjSerializer::PatchObject makePatchObject(
+  const Model::PatchNode& patchNode,
+  const size_t entityNo,
+  const size_t patchNo,
+  ObjSerializer::IndexMap<vm::vec3>& vertices,
+  ObjSerializer::IndexMap<vm::vec2f>& texCoords,
+  ObjSerializer::IndexMap<vm::vec3>& normals)
 {
-  const auto& patch = patchNode->patch();
-  auto patchObject =
-    PatchObject{entityNo(), brushNo(), {}, patch.textureName(), patch.texture()};
+  const auto& patch = patchNode.patch();
+  auto patchObject = ObjSerializer::PatchObject{
+    entityNo, patchNo, {}, patch.textureName(), patch.texture()};
 
-  const auto& patchGrid = patchNode->grid();
+  const auto& patchGrid = patchNode.grid();
   patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
 
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
-
   const auto makeIndexedVertex = [&](const auto& p) {
-    const size_t positionIndex = m_vertices.index(p.position);
-    const size_t texCoordsIndex = m_texCoords.index(vm::vec2f{p.texCoords});
-    const size_t normalIndex = m_normals.index(p.normal);
+    const size_t positionIndex = vertices.index(p.position);
+    const size_t texCoordsIndex = texCoords.index(vm::vec2f{p.texCoords});
+    const size_t normalIndex = normals.index(p.normal);
 
-    return IndexedVertex{positionIndex, texCoordsIndex, normalIndex};
+    return ObjSerializer::IndexedVertex{positionIndex, texCoordsIndex, normalIndex};
   };
 
   for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
@@ -295,7 +270,7 @@ void ObjSerializer::doPatch(const Model::PatchNode* patchNode)
     for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
     {
       // counter clockwise order
-      patchObject.quads.push_back(PatchQuad{{
+      patchObject.quads.push_back(ObjSerializer::PatchQuad{{
         makeIndexedVertex(patchGrid.point(row, col)),
         makeIndexedVertex(patchGrid.point(row + 1u, col)),
         makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
@@ -304,7 +279,173 @@ void ObjSerializer::doPatch(const Model::PatchNode* patchNode)
     }
   }
 
-  m_objects.push_back(std::move(patchObject));
+  return patchObject;
+}
+
+static ObjSerializer::Chunk makeChunk(
+  const std::vector<ObjSerializer::PendingNode>& nodes)
+{
+  auto vertices = ObjSerializer::IndexMap<vm::vec3>{};
+  auto texCoords = ObjSerializer::IndexMap<vm::vec2f>{};
+  auto normals = ObjSerializer::IndexMap<vm::vec3>{};
+
+  auto objects = std::vector<ObjSerializer::Object>{};
+  objects.reserve(nodes.size());
+
+  for (const auto& pendingNode : nodes)
+  {
+    // Vertex positions inserted from now on should get new indices
+    vertices.clearIndices();
+
+    std::visit(
+      kdl::overload(
+        [&](const Model::BrushNode* brushNode) {
+          objects.emplace_back(makeBrushObject(
+            *brushNode,
+            pendingNode.entityNo,
+            pendingNode.brushNo,
+            vertices,
+            texCoords,
+            normals));
+        },
+        [&](const Model::PatchNode* patchNode) {
+          objects.emplace_back(makePatchObject(
+            *patchNode,
+            pendingNode.entityNo,
+            pendingNode.brushNo,
+            vertices,
+            texCoords,
+            normals));
+        }),
+      pendingNode.node);
+  }
+
+  return ObjSerializer::Chunk{
+    vertices.list(), texCoords.list(), normals.list(), std::move(objects)};
+}
+
+static void offsetIndices(
+  ObjSerializer::IndexedVertex& vertex, const ObjSerializer::IndexedVertex& offset)
+{
+  vertex.vertex += offset.vertex;
+  vertex.texCoords += offset.texCoords;
+  vertex.normal += offset.normal;
+}
+
+static void offsetIndices(
+  ObjSerializer::Chunk& chunk, const ObjSerializer::IndexedVertex& offset)
+{
+  for (auto& object : chunk.objects)
+  {
+    std::visit(
+      kdl::overload(
+        [&](ObjSerializer::BrushObject& brushObject) {
+          for (auto& face : brushObject.faces)
+          {
+            for (auto& vertex : face.verts)
+            {
+              offsetIndices(vertex, offset);
+            }
+          }
+        },
+        [&](ObjSerializer::PatchObject& patchObject) {
+          for (auto& quad : patchObject.quads)
+          {
+            for (auto& vertex : quad.verts)
+            {
+              offsetIndices(vertex, offset);
+            }
+          }
+        }),
+      object);
+  }
+}
+
+void ObjSerializer::writePendingNodes()
+{
+  auto chunkNodes = std::vector<std::vector<PendingNode>>{};
+  for (size_t i = 0u; i < m_pendingNodes.size(); i += NodesPerChunk)
+  {
+    const auto count = std::min(NodesPerChunk, m_pendingNodes.size() - i);
+    const auto first = std::next(m_pendingNodes.begin(), std::ptrdiff_t(i));
+    chunkNodes.emplace_back(first, std::next(first, std::ptrdiff_t(count)));
+  }
+  m_pendingNodes.clear();
+
+  auto chunks = kdl::vec_parallel_transform(
+    std::move(chunkNodes), [](const auto& nodes) { return makeChunk(nodes); });
+
+  // The indices of each chunk are offset by the number of elements written before it.
+  // This is the only step that must be done in order.
+  auto offsets = std::vector<IndexedVertex>{};
+  offsets.reserve(chunks.size());
+  for (const auto& chunk : chunks)
+  {
+    offsets.push_back(m_indexOffsets);
+    m_indexOffsets.vertex += chunk.vertices.size();
+    m_indexOffsets.texCoords += chunk.texCoords.size();
+    m_indexOffsets.normal += chunk.normals.size();
+
+    for (const auto& object : chunk.objects)
+    {
+      std::visit(
+        kdl::overload(
+          [&](const BrushObject& brushObject) {
+            for (const auto& face : brushObject.faces)
+            {
+              m_usedTextures[face.textureName] = face.texture;
+            }
+          },
+          [&](const PatchObject& patchObject) {
+            m_usedTextures[patchObject.textureName] = patchObject.texture;
+          }),
+        object);
+    }
+  }
+
+  auto chunkStrs = std::vector<std::string>(chunks.size());
+  kdl::parallel_for(chunks.size(), [&](const size_t i) {
+    offsetIndices(chunks[i], offsets[i]);
+
+    auto str = std::ostringstream{};
+    writeChunk(str, chunks[i]);
+    chunkStrs[i] = str.str();
+  });
+
+  for (const auto& chunkStr : chunkStrs)
+  {
+    m_objStream << chunkStr;
+  }
+}
+
+void ObjSerializer::doEndFile()
+{
+  writePendingNodes();
+  writeMtlFile(m_mtlStream, m_usedTextures, m_options);
+}
+
+void ObjSerializer::doBeginEntity(const Model::Node* /* node */) {}
+void ObjSerializer::doEndEntity(const Model::Node* /* node */) {}
+void ObjSerializer::doEntityProperty(const Model::EntityProperty& /* property */) {}
+
+void ObjSerializer::doBrush(const Model::BrushNode* brushNode)
+{
+  m_pendingNodes.push_back(PendingNode{brushNode, entityNo(), brushNo()});
+  if (m_pendingNodes.size() == NodesPerChunk * ChunksPerBatch)
+  {
+    writePendingNodes();
+  }
+}
+
+void ObjSerializer::doBrushFace(const Model::BrushFace& /* face */) {}
+
+void ObjSerializer::doPatch(const Model::PatchNode* patchNode)
+{
+  m_pendingNodes.push_back(PendingNode{patchNode, entityNo(), brushNo()});
+  if (m_pendingNodes.size() == NodesPerChunk * ChunksPerBatch)
+  {
+    writePendingNodes();
+  }
 }
 } // namespace IO
 } // namespace TrenchBroom
@@ -28,7 +28,6 @@
 #include <array>
 #include <iosfwd>
 #include <map>
-#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
@@ -46,6 +45,7 @@ class BrushNode;
 class BrushFace;
 class EntityProperty;
 class Node;
+class PatchNode;
 } // namespace Model
 
 namespace IO
@@ -118,6 +118,41 @@ public:
 
   using Object = std::variant<BrushObject, PatchObject>;
 
+  /**
+   * A brush or patch whose geometry has not been written yet.
+   */
+  struct PendingNode
+  {
+    std::variant<const Model::BrushNode*, const Model::PatchNode*> node;
+    size_t entityNo;
+    size_t brushNo;
+  };
+
+  /**
+   * The geometry of a range of consecutive nodes. The indices of its faces refer to its
+   * own vertices, texture coordinates and normals, which are only deduplicated within
+   * the chunk. When the chunk is written, its indices are offset by the number of
+   * elements written before it.
+   */
+  struct Chunk
+  {
+    std::vector<vm::vec3> vertices;
+    std::vector<vm::vec2f> texCoords;
+    std::vector<vm::vec3> normals;
+    std::vector<Object> objects;
+  };
+
+  /**
+   * The number of nodes in a chunk.
+   */
+  static constexpr size_t NodesPerChunk = 64;
+
+  /**
+   * The number of chunks that are built in parallel and then written together. This
+   * bounds the amount of geometry that is kept in memory.
+   */
+  static constexpr size_t ChunksPerBatch = 64;
+
   friend std::ostream& operator<<(std::ostream& str, const IndexedVertex& vertex);
   friend std::ostream& operator<<(std::ostream& str, const BrushFace& face);
   friend std::ostream& operator<<(std::ostream& str, const BrushObject& object);
@@ -131,12 +166,9 @@ private:
   std::string m_mtlFilename;
   ObjExportOptions m_options;
 
-  IndexMap<vm::vec3> m_vertices;
-  IndexMap<vm::vec2f> m_texCoords;
-  IndexMap<vm::vec3> m_normals;
-
-  std::optional<BrushObject> m_currentBrush;
-  std::vector<Object> m_objects;
+  std::vector<PendingNode> m_pendingNodes;
+  IndexedVertex m_indexOffsets{0, 0, 0};
+  std::map<std::string, const Assets::Texture*> m_usedTextures;
 
 public:
   ObjSerializer(
@@ -157,6 +189,8 @@ private:
   void doBrushFace(const Model::BrushFace& face) override;
 
   void doPatch(const Model::PatchNode* patchNode) override;
+
+  void writePendingNodes();
 };
 } // namespace IO
 } // namespace TrenchBroom
@@ -0,0 +1,178 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Quake3ShaderCache.h"
+
+#include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include "kdl/result.h"
+#include "kdl/string_utils.h"
+
+#include <fmt/format.h>
+
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+constexpr auto Magic = std::string_view{"TBSC"};
+
+// must be incremented whenever the format of the cache changes
+constexpr auto Version = uint32_t(1);
+
+void writePath(CacheWriter& writer, const std::filesystem::path& path)
+{
+  writer.writeString(path.u8string());
+}
+
+void writeShader(CacheWriter& writer, const Assets::Quake3Shader& shader)
+{
+  writePath(writer, shader.shaderPath);
+  writePath(writer, shader.editorImage);
+  writePath(writer, shader.lightImage);
+  writer.write(shader.culling);
+
+  writer.writeSize(shader.surfaceParms.size());
+  for (const auto& surfaceParm : shader.surfaceParms)
+  {
+    writer.writeString(surfaceParm);
+  }
+
+  writer.writeSize(shader.stages.size());
+  for (const auto& stage : shader.stages)
+  {
+    writePath(writer, stage.map);
+    writer.writeString(stage.blendFunc.srcFactor);
+    writer.writeString(stage.blendFunc.destFactor);
+  }
+}
+
+std::filesystem::path readPath(Reader& reader)
+{
+  return std::filesystem::u8path(readString(reader));
+}
+
+Assets::Quake3Shader::Culling readCulling(Reader& reader)
+{
+  using U = std::underlying_type_t<Assets::Quake3Shader::Culling>;
+
+  const auto value = reader.read<U, U>();
+  if (value > U(Assets::Quake3Shader::Culling::None))
+  {
+    throw ReaderException{"Invalid culling value " + std::to_string(value)};
+  }
+  return static_cast<Assets::Quake3Shader::Culling>(value);
+}
+
+Assets::Quake3Shader readShader(Reader& reader)
+{
+  auto shader = Assets::Quake3Shader{};
+  shader.shaderPath = readPath(reader);
+  shader.editorImage = readPath(reader);
+  shader.lightImage = readPath(reader);
+  shader.culling = readCulling(reader);
+
+  const auto surfaceParmCount = readCount(reader, 8);
+  for (size_t i = 0; i < surfaceParmCount; ++i)
+  {
+    shader.surfaceParms.insert(readString(reader));
+  }
+
+  const auto stageCount = readCount(reader, 24);
+  shader.stages.reserve(stageCount);
+  for (size_t i = 0; i < stageCount; ++i)
+  {
+    auto& stage = shader.addStage();
+    stage.map = readPath(reader);
+    stage.blendFunc.srcFactor = readString(reader);
+    stage.blendFunc.destFactor = readString(reader);
+  }
+
+  return shader;
+}
+} // namespace
+
+std::filesystem::path quake3ShaderCachePath(
+  const std::filesystem::path& cacheDirectory, const std::filesystem::path& gamePath)
+{
+  return cacheDirectory / fmt::format("{:016x}.tbsc", kdl::str_hash(gamePath.u8string()));
+}
+
+uint64_t quake3ShaderScriptHash(const std::string_view contents)
+{
+  return kdl::str_hash(contents);
+}
+
+void writeQuake3ShaderCache(const Quake3ShaderCache& cache, std::ostream& stream)
+{
+  auto writer = CacheWriter{stream};
+  writer.writeHeader(Magic, Version);
+
+  writer.writeSize(cache.size());
+  for (const auto& [path, script] : cache)
+  {
+    writePath(writer, path);
+    writer.write(script.hash);
+    writer.writeSize(script.shaders.size());
+    for (const auto& shader : script.shaders)
+    {
+      writeShader(writer, shader);
+    }
+  }
+}
+
+Result<Quake3ShaderCache> readQuake3ShaderCache(Reader reader)
+{
+  return readCacheHeader(reader, Magic, Version, "shader cache")
+    .and_then([&]() -> Result<Quake3ShaderCache> {
+      try
+      {
+        auto cache = Quake3ShaderCache{};
+        const auto scriptCount = readCount(reader, 24);
+        for (size_t i = 0; i < scriptCount; ++i)
+        {
+          auto path = readPath(reader);
+          auto script = CachedShaderScript{read<uint64_t>(reader), {}};
+
+          const auto shaderCount = readCount(reader, 41);
+          script.shaders.reserve(shaderCount);
+          for (size_t j = 0; j < shaderCount; ++j)
+          {
+            script.shaders.push_back(readShader(reader));
+          }
+
+          cache.emplace(std::move(path), std::move(script));
+        }
+
+        return cache;
+      }
+      catch (const ReaderException& e)
+      {
+        return Error{"Malformed shader cache: " + std::string{e.what()}};
+      }
+    });
+}
+
+} // namespace TrenchBroom::IO
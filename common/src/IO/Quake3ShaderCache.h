@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Assets/Quake3Shader.h"
+#include "Result.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <map>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom::IO
+{
+class Reader;
+
+/**
+ * A shader cache is a binary file that stores the shaders parsed from the shader scripts
+ * of a game, so that loading the game again only parses the scripts that have changed.
+ *
+ * Every script is stored with a hash of its contents. A script is only taken from the
+ * cache if its contents still have the same hash.
+ */
+
+/**
+ * The shaders parsed from a shader script.
+ */
+struct CachedShaderScript
+{
+  uint64_t hash;
+  std::vector<Assets::Quake3Shader> shaders;
+};
+
+/**
+ * Maps the paths of shader scripts to their cached shaders.
+ */
+using Quake3ShaderCache = std::map<std::filesystem::path, CachedShaderScript>;
+
+/**
+ * Returns the path of the cache file for the game at the given path in the given cache
+ * directory.
+ */
+std::filesystem::path quake3ShaderCachePath(
+  const std::filesystem::path& cacheDirectory, const std::filesystem::path& gamePath);
+
+/**
+ * Computes the hash of the given shader script contents.
+ */
+uint64_t quake3ShaderScriptHash(std::string_view contents);
+
+/**
+ * Writes the given cache to the given stream, which must be opened in binary mode.
+ */
+void writeQuake3ShaderCache(const Quake3ShaderCache& cache, std::ostream& stream);
+
+/**
+ * Reads a shader cache using the given reader.
+ *
+ * Returns an error if the cache is malformed or was written by an incompatible version.
+ */
+Result<Quake3ShaderCache> readQuake3ShaderCache(Reader reader);
+
+} // namespace TrenchBroom::IO
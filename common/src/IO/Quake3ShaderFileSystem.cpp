@@ -20,14 +20,19 @@
 #include "Quake3ShaderFileSystem.h"
 
 #include "Assets/Quake3Shader.h"
+#include "CollectingLogger.h"
 #include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/PathInfo.h"
+#include "IO/Quake3ShaderCache.h"
 #include "IO/Quake3ShaderParser.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/TraversalMode.h"
 #include "Logger.h"
 
+#include "kdl/parallel.h"
 #include "kdl/path_utils.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
@@ -39,14 +44,57 @@
 
 namespace TrenchBroom::IO
 {
+namespace
+{
+/**
+ * A shader script loaded on a worker thread. The messages that were logged while the
+ * script was parsed are logged on the calling thread once all scripts are loaded.
+ */
+struct LoadedShaderScript
+{
+  std::filesystem::path path;
+  CachedShaderScript script;
+  std::vector<CollectingLogger::Message> messages;
+  bool cached;
+};
+
+Quake3ShaderCache readCache(const std::filesystem::path& cachePath, Logger& logger)
+{
+  if (Disk::pathInfo(cachePath) != PathInfo::File)
+  {
+    return {};
+  }
+
+  return Disk::mapFile(cachePath)
+    .and_then([](auto cacheFile) { return readQuake3ShaderCache(cacheFile->reader()); })
+    .transform_error([&](auto e) {
+      logger.debug() << "Could not load shader cache " << cachePath << ": " << e.msg;
+      return Quake3ShaderCache{};
+    })
+    .value();
+}
+
+void writeCache(
+  const std::filesystem::path& cachePath, const Quake3ShaderCache& cache, Logger& logger)
+{
+  writeCacheFile(
+    cachePath, [&](auto& stream) { writeQuake3ShaderCache(cache, stream); })
+    .transform_error([&](auto e) {
+      logger.warn() << "Could not write shader cache " << cachePath << ": " << e.msg;
+    });
+}
+} // namespace
+
 Quake3ShaderFileSystem::Quake3ShaderFileSystem(
   const FileSystem& fs,
   std::filesystem::path shaderSearchPath,
   std::vector<std::filesystem::path> textureSearchPaths,
-  Logger& logger)
+  Logger& logger,
+  std::optional<std::filesystem::path> cachePath)
   : m_fs{fs}
   , m_shaderSearchPath{std::move(shaderSearchPath)}
   , m_textureSearchPaths{std::move(textureSearchPaths)}
+  , m_cachePath{std::move(cachePath)}
   , m_logger{logger}
 {
 }
@@ -63,29 +111,72 @@ Result<std::vector<Assets::Quake3Shader>> Quake3ShaderFileSystem::loadShaders()
     return std::vector<Assets::Quake3Shader>{};
   }
 
-  const auto loadShaderFile = [&](const auto& path) {
+  const auto cache =
+    m_cachePath ? readCache(*m_cachePath, m_logger) : Quake3ShaderCache{};
+
+  const auto loadShaderScript = [&](const auto& path) {
     return m_fs.openFile(path).transform([&](auto file) {
       auto bufferedReader = file->reader().buffer();
+      const auto contents = bufferedReader.stringView();
+      const auto hash = quake3ShaderScriptHash(contents);
+
+      if (const auto it = cache.find(path); it != cache.end() && it->second.hash == hash)
+      {
+        return LoadedShaderScript{path, it->second, {}, true};
+      }
+
+      auto logger = CollectingLogger{};
+      auto shaders = std::vector<Assets::Quake3Shader>{};
       try
       {
-        auto parser = Quake3ShaderParser{bufferedReader.stringView()};
-        auto status = SimpleParserStatus{m_logger, path.string()};
-        return parser.parse(status);
+        auto parser = Quake3ShaderParser{contents};
+        auto status = SimpleParserStatus{logger, path.string()};
+        shaders = parser.parse(status);
       }
       catch (const ParserException& e)
       {
-        m_logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
-        return std::vector<Assets::Quake3Shader>{};
+        logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
       }
+      return LoadedShaderScript{
+        path, CachedShaderScript{hash, std::move(shaders)}, logger.takeMessages(), false};
     });
   };
 
   return m_fs
     .find(m_shaderSearchPath, TraversalMode::Flat, makeExtensionPathMatcher({".shader"}))
     .and_then([&](auto paths) {
-      return kdl::fold_results(kdl::vec_transform(paths, loadShaderFile));
+      return kdl::fold_results(
+        kdl::vec_parallel_transform(std::move(paths), loadShaderScript));
     })
-    .transform([&](auto nestedShaders) {
+    .transform([&](auto loadedScripts) {
+      // scripts that caused warnings are not cached so that the warnings are logged
+      // every time the shaders are loaded
+      auto newCache = Quake3ShaderCache{};
+      auto cacheChanged = false;
+
+      auto nestedShaders = std::vector<std::vector<Assets::Quake3Shader>>{};
+      nestedShaders.reserve(loadedScripts.size());
+      for (auto& loadedScript : loadedScripts)
+      {
+        for (const auto& [level, message] : loadedScript.messages)
+        {
+          m_logger.log(level, message);
+        }
+
+        if (m_cachePath && (loadedScript.cached || loadedScript.messages.empty()))
+        {
+          newCache.emplace(loadedScript.path, loadedScript.script);
+          cacheChanged = cacheChanged || !loadedScript.cached;
+        }
+
+        nestedShaders.push_back(std::move(loadedScript.script.shaders));
+      }
+
+      if (m_cachePath && (cacheChanged || newCache.size() != cache.size()))
+      {
+        writeCache(*m_cachePath, newCache, m_logger);
+      }
+
       auto allShaders = kdl::vec_flatten(std::move(nestedShaders));
       m_logger.info() << "Loaded " << allShaders.size() << " shaders";
       return allShaders;
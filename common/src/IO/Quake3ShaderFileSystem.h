@@ -23,6 +23,7 @@
 #include "Result.h"
 
 #include <filesystem>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom
@@ -51,6 +52,7 @@ private:
   const FileSystem& m_fs;
   std::filesystem::path m_shaderSearchPath;
   std::vector<std::filesystem::path> m_textureSearchPaths;
+  std::optional<std::filesystem::path> m_cachePath;
   Logger& m_logger;
 
 public:
@@ -61,17 +63,23 @@ public:
    * any texture found that does not have a corresponding shader will have a shader
    * generated for it.
    *
+   * The shader scripts are parsed in parallel. If a cache path is given, the parsed
+   * shaders are stored in a cache file at that path, and scripts which have not changed
+   * since the cache was written are not parsed again.
+   *
    * @param fs the filesystem to use when searching for shaders and linking image
    * resources
    * @param shaderSearchPath the path at which to search for shader scripts
    * @param textureSearchPaths the paths at which to search for texture images
    * @param logger the logger to use
+   * @param cachePath the path of the shader cache file, if any
    */
   Quake3ShaderFileSystem(
     const FileSystem& fs,
     std::filesystem::path shaderSearchPath,
     std::vector<std::filesystem::path> textureSearchPaths,
-    Logger& logger);
+    Logger& logger,
+    std::optional<std::filesystem::path> cachePath = std::nullopt);
 
 private:
   Result<void> doReadDirectory() override;
@@ -23,6 +23,7 @@
 #include "Assets/TextureBuffer.h"
 #include "Ensure.h"
 #include "FreeImage.h"
+#include "IO/ImageDecoder.h"
 #include "IO/ImageLoaderImpl.h"
 #include "IO/Reader.h"
 
@@ -103,6 +104,26 @@ Result<Assets::Texture, ReadTextureError> readFreeImageTextureFromMemory(
 {
   try
   {
+    // the common formats are decoded directly into the texture buffer, which saves
+    // several passes over the image and its copies in FreeImage
+    if (auto image = decodeImage(begin, size))
+    {
+      auto buffers = Assets::TextureBufferList{};
+      buffers.push_back(std::move(image->buffer));
+
+      const auto textureType = Assets::Texture::selectTextureType(image->masked);
+      const auto averageColor = getAverageColor(buffers.at(0), GL_RGBA);
+
+      return Assets::Texture{
+        std::move(name),
+        image->width,
+        image->height,
+        averageColor,
+        std::move(buffers),
+        GL_RGBA,
+        textureType};
+    }
+
     InitFreeImage::initialize();
 
     auto imageMemory = kdl::resource{
@@ -152,6 +152,25 @@ std::string readMipTextureName(Reader& reader)
   }
 }
 
+std::optional<vm::vec2s> readMipTextureSize(Reader& reader)
+{
+  try
+  {
+    auto headerReader = reader.buffer();
+    headerReader.seekFromBegin(MipLayout::TextureNameLength);
+
+    const auto width = headerReader.readSize<int32_t>();
+    const auto height = headerReader.readSize<int32_t>();
+    return checkTextureDimensions(width, height)
+             ? std::optional{vm::vec2s{width, height}}
+             : std::nullopt;
+  }
+  catch (const ReaderException&)
+  {
+    return std::nullopt;
+  }
+}
+
 Result<Assets::Texture, ReadTextureError> readIdMipTexture(
   std::string name, Reader& reader, const Assets::Palette& palette)
 {
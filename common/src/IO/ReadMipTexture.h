@@ -22,6 +22,9 @@
 #include "IO/TextureUtils.h"
 #include "Result.h"
 
+#include "vm/vec.h"
+
+#include <optional>
 #include <string>
 
 namespace TrenchBroom::Assets
@@ -35,6 +38,12 @@ class Reader;
 
 std::string readMipTextureName(Reader& reader);
 
+/**
+ * Reads the dimensions of a mip texture from its header without decoding it. Returns
+ * nothing if the header is truncated or if the dimensions are invalid.
+ */
+std::optional<vm::vec2s> readMipTextureSize(Reader& reader);
+
 Result<Assets::Texture, ReadTextureError> readIdMipTexture(
   std::string name, Reader& reader, const Assets::Palette& palette);
 
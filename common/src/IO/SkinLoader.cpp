@@ -20,7 +20,9 @@
 #include "SkinLoader.h"
 
 #include "Assets/Palette.h"
+#include "Assets/SkinCache.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
 #include "Ensure.h"
 #include "Error.h"
 #include "Exceptions.h"
@@ -87,5 +89,28 @@ Assets::Texture loadShader(
     })
     .value();
 }
+
+std::shared_ptr<Assets::TextureCollection> loadSkin(
+  const std::filesystem::path& path,
+  const FileSystem& fs,
+  const std::optional<Assets::Palette>& palette,
+  Assets::SkinCache* skinCache,
+  Logger& logger)
+{
+  const auto doLoadSkin = [&]() { return loadSkin(path, fs, palette, logger); };
+  return skinCache ? skinCache->skin(path, doLoadSkin)
+                   : Assets::makeSharedSkin(doLoadSkin());
+}
+
+std::shared_ptr<Assets::TextureCollection> loadShader(
+  const std::filesystem::path& path,
+  const FileSystem& fs,
+  Assets::SkinCache* skinCache,
+  Logger& logger)
+{
+  const auto doLoadShader = [&]() { return loadShader(path, fs, logger); };
+  return skinCache ? skinCache->skin(path, doLoadShader)
+                   : Assets::makeSharedSkin(doLoadShader());
+}
 } // namespace IO
 } // namespace TrenchBroom
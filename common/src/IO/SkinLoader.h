@@ -30,7 +30,9 @@ class Logger;
 namespace Assets
 {
 class Palette;
+class SkinCache;
 class Texture;
+class TextureCollection;
 } // namespace Assets
 
 namespace IO
@@ -48,5 +50,26 @@ Assets::Texture loadSkin(
 
 Assets::Texture loadShader(
   const std::filesystem::path& path, const FileSystem& fs, Logger& logger);
+
+/**
+ * Loads the skin at the given path, or returns the skin that was previously loaded from
+ * the same path if a skin cache is given.
+ */
+std::shared_ptr<Assets::TextureCollection> loadSkin(
+  const std::filesystem::path& path,
+  const FileSystem& fs,
+  const std::optional<Assets::Palette>& palette,
+  Assets::SkinCache* skinCache,
+  Logger& logger);
+
+/**
+ * Loads the shader at the given path, or returns the shader that was previously loaded
+ * from the same path if a skin cache is given.
+ */
+std::shared_ptr<Assets::TextureCollection> loadShader(
+  const std::filesystem::path& path,
+  const FileSystem& fs,
+  Assets::SkinCache* skinCache,
+  Logger& logger);
 } // namespace IO
 } // namespace TrenchBroom
@@ -29,9 +29,19 @@
 #include "vm/plane.h"
 #include "vm/vec.h"
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define TB_STANDARD_MAP_PARSER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 namespace TrenchBroom
 {
 namespace IO
@@ -42,8 +52,9 @@ const std::string& QuakeMapTokenizer::NumberDelim()
   return numberDelim;
 }
 
-QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str)
-  : Tokenizer(std::move(str), "\"", '\\')
+QuakeMapTokenizer::QuakeMapTokenizer(
+  std::string_view str, const size_t line, const size_t column)
+  : Tokenizer(std::move(str), "\"", '\\', line, column)
   , m_skipEol(true)
 {
 }
@@ -154,14 +165,243 @@ QuakeMapTokenizer::Token QuakeMapTokenizer::emitToken()
   return Token(QuakeMapToken::Eof, nullptr, nullptr, length(), line(), column());
 }
 
+std::vector<Model::EntityProperty> readWorldspawnProperties(const std::string_view str)
+{
+  auto tokenizer = QuakeMapTokenizer{str};
+
+  auto properties = std::vector<Model::EntityProperty>{};
+  try
+  {
+    auto token = tokenizer.nextToken();
+    while (token.type() == QuakeMapToken::Comment)
+    {
+      token = tokenizer.nextToken();
+    }
+    if (token.type() != QuakeMapToken::OBrace)
+    {
+      return {};
+    }
+
+    // the properties precede the first brush or patch
+    token = tokenizer.nextToken();
+    while (
+      !token.hasType(QuakeMapToken::OBrace | QuakeMapToken::CBrace | QuakeMapToken::Eof))
+    {
+      if (token.type() == QuakeMapToken::String)
+      {
+        auto key = token.data();
+        token = tokenizer.nextToken();
+        if (token.type() != QuakeMapToken::String)
+        {
+          return {};
+        }
+        properties.emplace_back(std::move(key), token.data());
+      }
+      else if (token.type() != QuakeMapToken::Comment)
+      {
+        return {};
+      }
+      token = tokenizer.nextToken();
+    }
+  }
+  catch (const ParserException&)
+  {
+    return {};
+  }
+  return properties;
+}
+
+namespace
+{
+bool isDigit(const char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+#ifdef TB_STANDARD_MAP_PARSER_SSE2
+size_t countTrailingZeros(const unsigned int mask)
+{
+  assert(mask != 0);
+#ifdef _MSC_VER
+  auto index = 0ul;
+  _BitScanForward(&index, mask);
+  return static_cast<size_t>(index);
+#else
+  return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+/**
+ * Returns the number of consecutive decimal digits at the beginning of the given range.
+ * Tests 16 characters at once if SSE2 is available.
+ */
+size_t countDigits(const char* begin, const char* end)
+{
+  const auto* cur = begin;
+#ifdef TB_STANDARD_MAP_PARSER_SSE2
+  const auto zero = _mm_set1_epi8('0');
+  const auto nine = _mm_set1_epi8(9);
+  while (end - cur >= 16)
+  {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+    // a character c is a digit iff the unsigned byte c - '0' is at most 9
+    const auto shifted = _mm_sub_epi8(chunk, zero);
+    const auto digits = _mm_cmpeq_epi8(_mm_min_epu8(shifted, nine), shifted);
+    const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(digits));
+    if (mask != 0xFFFFu)
+    {
+      return static_cast<size_t>(cur - begin) + countTrailingZeros(~mask);
+    }
+    cur += 16;
+  }
+#endif
+  while (cur < end && isDigit(*cur))
+  {
+    ++cur;
+  }
+  return static_cast<size_t>(cur - begin);
+}
+
+struct ScannedNumber
+{
+  double value;
+  const char* end;
+};
+
+/**
+ * Scans a number of the form [+-]?[0-9]*(\.[0-9]*)? with at least one digit at the
+ * beginning of the given range.
+ *
+ * The number is only converted if it has at most 15 digits. Then its digits and the
+ * power of ten by which they must be divided are exactly representable as doubles, and
+ * dividing them yields the correctly rounded result, which is what str_to_double would
+ * return. Returns nullopt if the number does not meet these criteria or if it has an
+ * exponent.
+ */
+std::optional<ScannedNumber> scanNumber(const char* cur, const char* end)
+{
+  static constexpr auto MaxDigits = size_t(15);
+  static constexpr auto PowersOfTen = std::array<double, MaxDigits + 1>{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+  auto negative = false;
+  if (cur < end && (*cur == '-' || *cur == '+'))
+  {
+    negative = *cur == '-';
+    ++cur;
+  }
+
+  auto mantissa = std::uint64_t(0);
+  auto digitCount = size_t(0);
+  const auto accumulate = [&](const char* first, const size_t count) {
+    for (size_t i = 0; i < count; ++i)
+    {
+      mantissa = mantissa * 10u + static_cast<std::uint64_t>(first[i] - '0');
+    }
+    digitCount += count;
+  };
+
+  const auto integerDigits = countDigits(cur, end);
+  if (integerDigits > MaxDigits)
+  {
+    return std::nullopt;
+  }
+  accumulate(cur, integerDigits);
+  cur += integerDigits;
+
+  auto fractionDigits = size_t(0);
+  if (cur < end && *cur == '.')
+  {
+    ++cur;
+    fractionDigits = countDigits(cur, end);
+    if (digitCount + fractionDigits > MaxDigits)
+    {
+      return std::nullopt;
+    }
+    accumulate(cur, fractionDigits);
+    cur += fractionDigits;
+  }
+
+  if (digitCount == 0)
+  {
+    return std::nullopt;
+  }
+  if (cur < end && (*cur == 'e' || *cur == 'E'))
+  {
+    return std::nullopt;
+  }
+
+  const auto value = static_cast<double>(mantissa) / PowersOfTen[fractionDigits];
+  return ScannedNumber{negative ? -value : value, cur};
+}
+
+bool isBlank(const char c)
+{
+  return c == ' ' || c == '\t';
+}
+
+const char* skipBlanks(const char* cur, const char* end)
+{
+  while (cur < end && isBlank(*cur))
+  {
+    ++cur;
+  }
+  return cur;
+}
+
+/**
+ * Scans a point of the form ( x y z ) where the parentheses and numbers are separated
+ * by spaces or tabs.
+ */
+std::optional<std::tuple<vm::vec3, const char*>> scanPoint(
+  const char* cur, const char* end)
+{
+  if (cur == end || *cur != '(')
+  {
+    return std::nullopt;
+  }
+  ++cur;
+
+  auto point = vm::vec3{};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    cur = skipBlanks(cur, end);
+    const auto number = scanNumber(cur, end);
+    if (!number)
+    {
+      return std::nullopt;
+    }
+
+    // numbers must be delimited by whitespace or a closing parenthesis
+    cur = number->end;
+    if (cur == end || (!isBlank(*cur) && *cur != ')'))
+    {
+      return std::nullopt;
+    }
+    point[i] = static_cast<FloatType>(number->value);
+  }
+
+  cur = skipBlanks(cur, end);
+  if (cur == end || *cur != ')')
+  {
+    return std::nullopt;
+  }
+
+  return std::make_tuple(point, cur + 1);
+}
+} // namespace
+
 const std::string StandardMapParser::BrushPrimitiveId = "brushDef";
 const std::string StandardMapParser::PatchId = "patchDef2";
 
 StandardMapParser::StandardMapParser(
   std::string_view str,
   const Model::MapFormat sourceMapFormat,
-  const Model::MapFormat targetMapFormat)
-  : m_tokenizer(QuakeMapTokenizer(std::move(str)))
+  const Model::MapFormat targetMapFormat,
+  const size_t line,
+  const size_t column)
+  : m_tokenizer(QuakeMapTokenizer(std::move(str), line, column))
   , m_sourceMapFormat(sourceMapFormat)
   , m_targetMapFormat(targetMapFormat)
 {
@@ -707,6 +947,12 @@ void StandardMapParser::parsePatch(ParserStatus& status, const size_t startLine)
 std::tuple<vm::vec3, vm::vec3, vm::vec3> StandardMapParser::parseFacePoints(
   ParserStatus& /* status */)
 {
+  if (const auto points = scanFacePoints())
+  {
+    const auto& [p1, p2, p3] = *points;
+    return std::make_tuple(correct(p1), correct(p2), correct(p3));
+  }
+
   const auto p1 =
     correct(parseFloatVector(QuakeMapToken::OParenthesis, QuakeMapToken::CParenthesis));
   const auto p2 =
@@ -717,6 +963,57 @@ std::tuple<vm::vec3, vm::vec3, vm::vec3> StandardMapParser::parseFacePoints(
   return std::make_tuple(p1, p2, p3);
 }
 
+/**
+ * Fast path for the face points, which make up most of a map file. Scans the points
+ * directly from the source without creating tokens. If the points are not formatted in
+ * the usual way, e.g. if they contain comments, line breaks or numbers in scientific
+ * notation, then this function returns nullopt without changing the tokenizer state, and
+ * the caller falls back to the tokenizer.
+ */
+std::optional<std::tuple<vm::vec3, vm::vec3, vm::vec3>> StandardMapParser::
+  scanFacePoints()
+{
+  auto state = m_tokenizer.snapshot();
+  const auto* end = m_tokenizer.snapshotStateAndSource().end;
+
+  // skip the whitespace preceding the first point, keeping track of the line
+  auto* cur = state.cur;
+  while (cur < end && (isBlank(*cur) || *cur == '\n' || *cur == '\r'))
+  {
+    if (*cur == '\n' || (*cur == '\r' && (cur + 1 == end || *(cur + 1) != '\n')))
+    {
+      ++state.line;
+      state.column = 1;
+    }
+    else
+    {
+      ++state.column;
+    }
+    ++cur;
+  }
+
+  auto points = std::array<vm::vec3, 3>{};
+  const auto* first = cur;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    cur = skipBlanks(cur, end);
+    auto point = scanPoint(cur, end);
+    if (!point)
+    {
+      return std::nullopt;
+    }
+    std::tie(points[i], cur) = *point;
+  }
+
+  // the points do not contain any line breaks
+  state.column += static_cast<size_t>(cur - first);
+  state.cur = cur;
+  state.escaped = false;
+  m_tokenizer.restore(state);
+
+  return std::make_tuple(points[0], points[1], points[2]);
+}
+
 std::string StandardMapParser::parseTextureName(ParserStatus& /* status */)
 {
   const auto [textureName, wasQuoted] =
@@ -752,7 +1049,8 @@ std::tuple<vm::vec3, vm::vec3> StandardMapParser::parsePrimitiveTextureAxes(
 
 float StandardMapParser::parseFloat()
 {
-  return expect(QuakeMapToken::Number, m_tokenizer.nextToken()).toFloat<float>();
+  return static_cast<float>(
+    toDouble(expect(QuakeMapToken::Number, m_tokenizer.nextToken())));
 }
 
 int StandardMapParser::parseInteger()
@@ -760,6 +1058,16 @@ int StandardMapParser::parseInteger()
   return expect(QuakeMapToken::Integer, m_tokenizer.nextToken()).toInteger<int>();
 }
 
+double StandardMapParser::toDouble(const Token& token)
+{
+  if (const auto number = scanNumber(token.begin(), token.end());
+      number && number->end == token.end())
+  {
+    return number->value;
+  }
+  return token.toFloat<double>();
+}
+
 StandardMapParser::TokenNameMap StandardMapParser::tokenNames() const
 {
   using namespace QuakeMapToken;
@@ -29,6 +29,7 @@
 
 #include "vm/forward.h"
 
+#include <optional>
 #include <string_view>
 #include <tuple>
 #include <vector>
@@ -64,7 +65,7 @@ private:
   bool m_skipEol;
 
 public:
-  explicit QuakeMapTokenizer(std::string_view str);
+  explicit QuakeMapTokenizer(std::string_view str, size_t line = 1, size_t column = 1);
 
   void setSkipEol(bool skipEol);
 
@@ -72,6 +73,13 @@ private:
   Token emitToken() override;
 };
 
+/**
+ * Reads the properties of the first entity of the given map string, which is the
+ * worldspawn entity, without parsing its brushes and patches or any other entities.
+ * Returns an empty vector if the first entity is malformed.
+ */
+std::vector<Model::EntityProperty> readWorldspawnProperties(std::string_view str);
+
 class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type>
 {
 private:
@@ -95,11 +103,15 @@ public:
    * @param str the string to parse
    * @param sourceMapFormat the expected format of the given string
    * @param targetMapFormat the format to convert the created objects to
+   * @param line the line number of the beginning of the given string
+   * @param column the column number of the beginning of the given string
    */
   StandardMapParser(
     std::string_view str,
     Model::MapFormat sourceMapFormat,
-    Model::MapFormat targetMapFormat);
+    Model::MapFormat targetMapFormat,
+    size_t line = 1,
+    size_t column = 1);
 
   ~StandardMapParser() override;
 
@@ -133,6 +145,7 @@ private:
   void parsePatch(ParserStatus& status, size_t startLine);
 
   std::tuple<vm::vec3, vm::vec3, vm::vec3> parseFacePoints(ParserStatus& status);
+  std::optional<std::tuple<vm::vec3, vm::vec3, vm::vec3>> scanFacePoints();
   std::string parseTextureName(ParserStatus& status);
   std::tuple<vm::vec3, float, vm::vec3, float> parseValveTextureAxes(
     ParserStatus& status);
@@ -145,7 +158,8 @@ private:
     vm::vec<T, S> vec;
     for (size_t i = 0; i < S; i++)
     {
-      vec[i] = expect(QuakeMapToken::Number, m_tokenizer.nextToken()).toFloat<T>();
+      vec[i] =
+        static_cast<T>(toDouble(expect(QuakeMapToken::Number, m_tokenizer.nextToken())));
     }
     expect(c, m_tokenizer.nextToken());
     return vec;
@@ -154,6 +168,12 @@ private:
   float parseFloat();
   int parseInteger();
 
+  /**
+   * Converts the given number token to a double. Simple decimal numbers are converted
+   * without creating a temporary string.
+   */
+  static double toDouble(const Token& token);
+
 private: // implement Parser interface
   TokenNameMap tokenNames() const override;
 };
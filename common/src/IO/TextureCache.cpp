@@ -0,0 +1,310 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileSystem.h"
+#include "IO/PathInfo.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Model/GameConfig.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <system_error>
+#include <type_traits>
+
+namespace TrenchBroom::IO
+{
+namespace
+{
+constexpr auto Magic = std::string_view{"TBTC"};
+
+// must be incremented whenever the format of the cache changes
+constexpr auto Version = uint32_t(1);
+
+enum class GameDataType : uint8_t
+{
+  None,
+  Q2,
+};
+
+void writeBuffer(CacheWriter& writer, const Assets::TextureBuffer& buffer)
+{
+  writer.writeSize(buffer.size());
+  writer.writeBytes(buffer.data(), buffer.size());
+}
+
+void writeTexture(CacheWriter& writer, const Assets::Texture& texture)
+{
+  writer.writeString(texture.name());
+  writer.writeString(texture.absolutePath().u8string());
+  writer.writeString(texture.relativePath().u8string());
+  writer.writeSize(texture.width());
+  writer.writeSize(texture.height());
+  for (size_t i = 0; i < 4; ++i)
+  {
+    writer.write(texture.averageColor()[i]);
+  }
+  writer.write(uint32_t(texture.format()));
+  writer.write(uint8_t(texture.masked() ? 1 : 0));
+
+  std::visit(
+    kdl::overload(
+      [&](const std::monostate&) { writer.write(GameDataType::None); },
+      [&](const Assets::Q2Data& q2Data) {
+        writer.write(GameDataType::Q2);
+        writer.write(int32_t(q2Data.flags));
+        writer.write(int32_t(q2Data.contents));
+        writer.write(int32_t(q2Data.value));
+      }),
+    texture.gameData());
+
+  const auto& buffers = texture.buffersIfUnprepared();
+  writer.writeSize(buffers.size());
+  for (const auto& buffer : buffers)
+  {
+    writeBuffer(writer, buffer);
+  }
+}
+
+GLenum readFormat(Reader& reader)
+{
+  const auto format = GLenum(read<uint32_t>(reader));
+  switch (format)
+  {
+  case GL_RGB:
+  case GL_BGR:
+  case GL_RGBA:
+  case GL_BGRA:
+  case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    return format;
+  default:
+    throw ReaderException{"Invalid texture format " + std::to_string(format)};
+  }
+}
+
+Assets::GameData readGameData(Reader& reader)
+{
+  const auto type = read<std::underlying_type_t<GameDataType>>(reader);
+  switch (static_cast<GameDataType>(type))
+  {
+  case GameDataType::None:
+    return std::monostate{};
+  case GameDataType::Q2: {
+    const auto flags = int(read<int32_t>(reader));
+    const auto contents = int(read<int32_t>(reader));
+    const auto value = int(read<int32_t>(reader));
+    return Assets::Q2Data{flags, contents, value};
+  }
+  default:
+    throw ReaderException{"Invalid game data type " + std::to_string(type)};
+  }
+}
+
+/**
+ * Returns the minimum number of bytes of the given mip level. Mirrors the assertions in
+ * the constructor of Assets::Texture.
+ */
+size_t minMipSize(
+  const size_t width, const size_t height, const GLenum format, const size_t level)
+{
+  const auto mipSize = Assets::sizeAtMipLevel(width, height, level);
+  return Assets::isCompressedFormat(format)
+           ? Assets::blockSizeForFormat(format) * std::max(size_t(1), mipSize.x() / 4)
+               * std::max(size_t(1), mipSize.y() / 4)
+           : Assets::bytesPerPixelForFormat(format) * mipSize.x() * mipSize.y();
+}
+
+Assets::Texture readTexture(Reader& reader)
+{
+  auto name = readString(reader);
+  auto absolutePath = std::filesystem::u8path(readString(reader));
+  auto relativePath = std::filesystem::u8path(readString(reader));
+
+  const auto width = readSize(reader);
+  const auto height = readSize(reader);
+  if (width == 0 || height == 0)
+  {
+    throw ReaderException{"Invalid texture size"};
+  }
+
+  const auto averageColor = reader.readVec<float, 4>();
+  const auto format = readFormat(reader);
+  const auto masked = reader.readBool<uint8_t>();
+  auto gameData = readGameData(reader);
+
+  auto buffers = Assets::TextureBufferList{};
+  const auto bufferCount = readCount(reader, 8);
+  buffers.reserve(bufferCount);
+  for (size_t level = 0; level < bufferCount; ++level)
+  {
+    const auto size = readCount(reader, 1);
+    if (size < minMipSize(width, height, format, level))
+    {
+      throw ReaderException{"Invalid mip level size"};
+    }
+
+    auto& buffer = buffers.emplace_back(size);
+    reader.read(buffer.data(), size);
+  }
+
+  auto texture = Assets::Texture{
+    std::move(name),
+    width,
+    height,
+    Color{averageColor},
+    std::move(buffers),
+    format,
+    Assets::Texture::selectTextureType(masked),
+    std::move(gameData)};
+  texture.setAbsolutePath(std::move(absolutePath));
+  texture.setRelativePath(std::move(relativePath));
+  return texture;
+}
+
+/**
+ * Identifies the current version of the file at the given path.
+ */
+Result<std::string> fileStamp(
+  const std::filesystem::path& path, const FileSystem& gameFS)
+{
+  const auto absPath = gameFS.makeAbsolute(path).value_or(std::filesystem::path{});
+  if (!absPath.empty() && Disk::pathInfo(absPath) == PathInfo::File)
+  {
+    auto sizeError = std::error_code{};
+    auto timeError = std::error_code{};
+    const auto size = std::filesystem::file_size(absPath, sizeError);
+    const auto time = std::filesystem::last_write_time(absPath, timeError);
+    if (!sizeError && !timeError)
+    {
+      return fmt::format(
+        "{} {} {}", path.u8string(), size, time.time_since_epoch().count());
+    }
+  }
+
+  return gameFS.openFile(path).transform([&](auto file) {
+    const auto reader = file->reader().buffer();
+    return fmt::format(
+      "{} {} {:016x}", path.u8string(), file->size(), kdl::str_hash(reader.stringView()));
+  });
+}
+} // namespace
+
+std::filesystem::path textureCachePath(
+  const std::filesystem::path& cacheDirectory,
+  const std::filesystem::path& collectionPath)
+{
+  return cacheDirectory
+         / fmt::format("{:016x}.tbtc", kdl::str_hash(collectionPath.u8string()));
+}
+
+Result<std::string> textureCacheKey(
+  const std::filesystem::path& collectionPath,
+  const std::vector<std::filesystem::path>& texturePaths,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig)
+{
+  // a missing palette is not an error, the textures are decoded without it
+  const auto paletteStamp =
+    !textureConfig.palette.empty()
+      ? fileStamp(textureConfig.palette, gameFS).value_or("missing palette")
+      : "no palette";
+
+  return kdl::fold_results(kdl::vec_transform(
+                             texturePaths,
+                             [&](const auto& texturePath) {
+                               return fileStamp(texturePath, gameFS);
+                             }))
+    .transform([&](const auto& textureStamps) {
+      const auto stamps = fmt::format(
+        "{}\n{}\n{}\n{}",
+        collectionPath.u8string(),
+        textureConfig.root.u8string(),
+        paletteStamp,
+        kdl::str_join(textureStamps, "\n"));
+      return fmt::format("{:016x} {}", kdl::str_hash(stamps), texturePaths.size());
+    });
+}
+
+void writeTextureCache(
+  const Assets::TextureCollection& textureCollection,
+  const std::string_view key,
+  std::ostream& stream)
+{
+  auto writer = CacheWriter{stream};
+  writer.writeHeader(Magic, Version);
+  writer.writeString(key);
+
+  writer.writeString(textureCollection.path().u8string());
+  writer.writeSize(textureCollection.textureCount());
+  for (const auto& texture : textureCollection.textures())
+  {
+    writeTexture(writer, texture);
+  }
+}
+
+Result<Assets::TextureCollection> readTextureCache(
+  Reader reader, const std::string_view key)
+{
+  return readCacheHeader(reader, Magic, Version, key, "texture cache")
+    .and_then([&]() -> Result<Assets::TextureCollection> {
+      try
+      {
+        auto path = std::filesystem::u8path(readString(reader));
+
+        auto textures = std::vector<Assets::Texture>{};
+        const auto textureCount = readCount(reader, 64);
+        textures.reserve(textureCount);
+        for (size_t i = 0; i < textureCount; ++i)
+        {
+          textures.push_back(readTexture(reader));
+        }
+
+        return Assets::TextureCollection{std::move(path), std::move(textures)};
+      }
+      catch (const ReaderException& e)
+      {
+        return Error{"Malformed texture cache: " + std::string{e.what()}};
+      }
+    });
+}
+
+} // namespace TrenchBroom::IO
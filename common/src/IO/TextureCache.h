@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <filesystem>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom::Assets
+{
+class TextureCollection;
+}
+
+namespace TrenchBroom::Model
+{
+struct TextureConfig;
+}
+
+namespace TrenchBroom::IO
+{
+class FileSystem;
+class Reader;
+
+/**
+ * A texture cache is a binary file that stores the decoded pixel data and the mip levels
+ * of all textures of a texture collection. Reading a collection from its cache skips
+ * decoding the texture files and applying the palette.
+ *
+ * A cache is identified by a key which is computed from the paths, sizes and
+ * modification times of the texture files and the palette. A cache is only read if its
+ * key matches the key of the texture collection.
+ */
+
+/**
+ * Returns the path of the cache file for the texture collection at the given path in
+ * the given cache directory. Collections of different games at the same path share a
+ * cache file, which is rewritten whenever its key does not match.
+ */
+std::filesystem::path textureCachePath(
+  const std::filesystem::path& cacheDirectory,
+  const std::filesystem::path& collectionPath);
+
+/**
+ * Computes the key of a cache for the texture collection at the given path which
+ * consists of the given texture files.
+ *
+ * Files that are stored directly on disk are identified by their sizes and modification
+ * times. Files in archives cannot be stat'ed, so they are identified by their sizes and
+ * the hashes of their contents instead.
+ *
+ * Returns an error if a texture file cannot be opened.
+ */
+Result<std::string> textureCacheKey(
+  const std::filesystem::path& collectionPath,
+  const std::vector<std::filesystem::path>& texturePaths,
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig);
+
+/**
+ * Writes the given texture collection to the given stream, which must be opened in
+ * binary mode. The textures must not have been prepared yet.
+ */
+void writeTextureCache(
+  const Assets::TextureCollection& textureCollection,
+  std::string_view key,
+  std::ostream& stream);
+
+/**
+ * Reads a texture collection from the given reader. Returns an error if the cache is
+ * malformed or if its key does not match the given key.
+ */
+Result<Assets::TextureCollection> readTextureCache(Reader reader, std::string_view key);
+
+} // namespace TrenchBroom::IO
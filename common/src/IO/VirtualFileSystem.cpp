@@ -21,15 +21,18 @@
 
 #include "Error.h"
 #include "IO/File.h"
+#include "IO/ImageFileSystem.h"
 #include "IO/PathInfo.h"
 
 #include "kdl/path_utils.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
+#include "kdl/string_format.h"
 #include "kdl/vector_utils.h"
 
 #include <optional>
 #include <unordered_map>
+#include <utility>
 
 namespace TrenchBroom::IO
 {
@@ -56,6 +59,27 @@ std::filesystem::path suffix(
   return kdl::path_clip(path, kdl::path_length(mountPoint.path));
 }
 
+/**
+ * Returns the key of the given path in the index, which joins its lower case components
+ * with slashes.
+ */
+std::string indexKey(const std::filesystem::path& path)
+{
+  auto result = std::string{};
+  for (const auto& component : path)
+  {
+    if (const auto str = component.generic_u8string(); !str.empty() && str != ".")
+    {
+      if (!result.empty())
+      {
+        result += '/';
+      }
+      result += str;
+    }
+  }
+  return kdl::str_to_lower(result);
+}
+
 } // namespace
 
 VirtualMountPointId::VirtualMountPointId()
@@ -76,19 +100,12 @@ bool operator!=(const VirtualMountPointId& lhs, const VirtualMountPointId& rhs)
 Result<std::filesystem::path> VirtualFileSystem::makeAbsolute(
   const std::filesystem::path& path) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto [mountPoint, pathInfo] = resolve(path); mountPoint)
   {
-    const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
+    const auto& fs = *mountPoint->mountedFileSystem;
+    if (auto absPath = fs.makeAbsolute(suffix(*mountPoint, path)); absPath.is_success())
     {
-      const auto pathSuffix = suffix(mountPoint, path);
-      const auto absPath = mountPoint.mountedFileSystem->makeAbsolute(pathSuffix);
-      if (
-        absPath.is_success()
-        && mountPoint.mountedFileSystem->pathInfo(pathSuffix) != PathInfo::Unknown)
-      {
-        return absPath;
-      }
+      return absPath;
     }
   }
 
@@ -97,18 +114,9 @@ Result<std::filesystem::path> VirtualFileSystem::makeAbsolute(
 
 PathInfo VirtualFileSystem::pathInfo(const std::filesystem::path& path) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto [mountPoint, pathInfo] = resolve(path); mountPoint)
   {
-    const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
-    {
-      const auto pathSuffix = suffix(mountPoint, path);
-      if (const auto pathInfo = mountPoint.mountedFileSystem->pathInfo(pathSuffix);
-          pathInfo != PathInfo::Unknown)
-      {
-        return pathInfo;
-      }
-    }
+    return pathInfo;
   }
 
   return std::any_of(
@@ -122,12 +130,16 @@ PathInfo VirtualFileSystem::pathInfo(const std::filesystem::path& path) const
            : PathInfo::Unknown;
 }
 
-
 VirtualMountPointId VirtualFileSystem::mount(
   const std::filesystem::path& path, std::unique_ptr<FileSystem> fs)
 {
   const auto id = VirtualMountPointId{};
-  m_mountPoints.push_back({id, path, std::move(fs)});
+  const auto indexed = dynamic_cast<const ImageFileSystemBase*>(fs.get()) != nullptr;
+  m_mountPoints.push_back({id, path, std::move(fs), indexed});
+  if (indexed)
+  {
+    addToIndex(m_mountPoints.back());
+  }
   return id;
 }
 
@@ -139,15 +151,34 @@ bool VirtualFileSystem::unmount(const VirtualMountPointId& id)
         [&](const auto& mountPoint) { return mountPoint.id == id; });
       it != m_mountPoints.end())
   {
+    const auto indexed = it->indexed;
     m_mountPoints.erase(it);
+    if (indexed)
+    {
+      removeFromIndex(id.m_id);
+    }
     return true;
   }
   return false;
 }
 
-void VirtualFileSystem::unmountAll()
+std::vector<VirtualMountPoint> VirtualFileSystem::unmountAll()
 {
-  m_mountPoints.clear();
+  m_index.clear();
+  return std::exchange(m_mountPoints, {});
+}
+
+void VirtualFileSystem::reindex(const VirtualMountPointId& id)
+{
+  if (const auto it = std::find_if(
+        m_mountPoints.begin(),
+        m_mountPoints.end(),
+        [&](const auto& mountPoint) { return mountPoint.id == id; });
+      it != m_mountPoints.end() && it->indexed)
+  {
+    removeFromIndex(id.m_id);
+    addToIndex(*it);
+  }
 }
 
 Result<std::vector<std::filesystem::path>> VirtualFileSystem::doFind(
@@ -228,20 +259,106 @@ Result<std::vector<std::filesystem::path>> VirtualFileSystem::doFind(
 Result<std::shared_ptr<File>> VirtualFileSystem::doOpenFile(
   const std::filesystem::path& path) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto [mountPoint, pathInfo] = resolve(path); mountPoint)
+  {
+    return mountPoint->mountedFileSystem->openFile(suffix(*mountPoint, path));
+  }
+
+  return Error{"'" + path.string() + "' not found"};
+}
+
+std::tuple<const VirtualMountPoint*, PathInfo> VirtualFileSystem::resolve(
+  const std::filesystem::path& path) const
+{
+  const auto indexIt = m_index.find(indexKey(path));
+  const auto indexedMountPointId =
+    indexIt != m_index.end() ? indexIt->second.mountPointId : size_t(0);
+
+  // Mount point ids increase in mount order, so only the file systems that are not
+  // indexed and were mounted after the indexed one can override the index.
+  for (auto it = m_mountPoints.rbegin();
+       it != m_mountPoints.rend() && it->id.m_id > indexedMountPointId;
+       ++it)
   {
     const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
+    if (!mountPoint.indexed && matches(mountPoint, path))
     {
-      const auto pathSuffix = suffix(mountPoint, path);
-      if (mountPoint.mountedFileSystem->pathInfo(pathSuffix) != PathInfo::Unknown)
+      if (const auto pathInfo = mountPoint.mountedFileSystem->pathInfo(
+            suffix(mountPoint, path));
+          pathInfo != PathInfo::Unknown)
       {
-        return mountPoint.mountedFileSystem->openFile(pathSuffix);
+        return {&mountPoint, pathInfo};
       }
     }
   }
 
-  return Error{"'" + path.string() + "' not found"};
+  if (indexIt != m_index.end())
+  {
+    const auto it = std::find_if(
+      m_mountPoints.begin(), m_mountPoints.end(), [&](const auto& mountPoint) {
+        return mountPoint.id.m_id == indexedMountPointId;
+      });
+    assert(it != m_mountPoints.end());
+    return {&*it, indexIt->second.pathInfo};
+  }
+
+  return {nullptr, PathInfo::Unknown};
+}
+
+void VirtualFileSystem::addToIndex(const VirtualMountPoint& mountPoint)
+{
+  const auto& imageFs =
+    dynamic_cast<const ImageFileSystemBase&>(*mountPoint.mountedFileSystem);
+  const auto mountPointId = mountPoint.id.m_id;
+
+  const auto addEntry = [&](const std::filesystem::path& path, const PathInfo pathInfo) {
+    auto& entry = m_index[indexKey(path)];
+    if (entry.mountPointId < mountPointId)
+    {
+      entry = IndexEntry{mountPointId, pathInfo};
+    }
+  };
+
+  addEntry(mountPoint.path, PathInfo::Directory);
+  imageFs.visitEntries([&](const auto& path, const auto pathInfo) {
+    addEntry(mountPoint.path / path, pathInfo);
+  });
+}
+
+void VirtualFileSystem::removeFromIndex(const size_t mountPointId)
+{
+  for (auto it = m_index.begin(); it != m_index.end();)
+  {
+    auto& [key, entry] = *it;
+    if (entry.mountPointId != mountPointId)
+    {
+      ++it;
+      continue;
+    }
+
+    // fall back to the next indexed file system that contains the path
+    entry = IndexEntry{};
+    const auto path = std::filesystem::path{key};
+    for (auto mountPointIt = m_mountPoints.rbegin(); mountPointIt != m_mountPoints.rend();
+         ++mountPointIt)
+    {
+      const auto& mountPoint = *mountPointIt;
+      if (
+        mountPoint.indexed && mountPoint.id.m_id != mountPointId
+        && matches(mountPoint, path))
+      {
+        if (const auto pathInfo =
+              mountPoint.mountedFileSystem->pathInfo(suffix(mountPoint, path));
+            pathInfo != PathInfo::Unknown)
+        {
+          entry = IndexEntry{mountPoint.id.m_id, pathInfo};
+          break;
+        }
+      }
+    }
+
+    it = entry.mountPointId != 0 ? std::next(it) : m_index.erase(it);
+  }
 }
 
 WritableVirtualFileSystem::WritableVirtualFileSystem(
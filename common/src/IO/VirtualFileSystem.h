@@ -20,10 +20,14 @@
 #pragma once
 
 #include "IO/FileSystem.h"
+#include "IO/PathInfo.h"
 #include "Result.h"
 
 #include <filesystem>
 #include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom::IO
@@ -48,12 +52,30 @@ struct VirtualMountPoint
   VirtualMountPointId id;
   std::filesystem::path path;
   std::unique_ptr<FileSystem> mountedFileSystem;
+  bool indexed;
 };
 
+/**
+ * Combines several file systems, each mounted at a path. If several of them contain the
+ * same path, the file system that was mounted last takes precedence.
+ *
+ * The contents of image file systems such as pak, pk3 and wad files are recorded in a
+ * case insensitive index when they are mounted, so that looking up a path does not have
+ * to query every mounted file system. Other file systems, such as disk file systems, can
+ * change at any time and are still queried for every lookup, but there are usually only a
+ * few of them.
+ */
 class VirtualFileSystem : public FileSystem
 {
 private:
+  struct IndexEntry
+  {
+    size_t mountPointId = 0;
+    PathInfo pathInfo = PathInfo::Unknown;
+  };
+
   std::vector<VirtualMountPoint> m_mountPoints;
+  std::unordered_map<std::string, IndexEntry> m_index;
 
 public:
   Result<std::filesystem::path> makeAbsolute(
@@ -63,13 +85,35 @@ public:
   VirtualMountPointId mount(
     const std::filesystem::path& path, std::unique_ptr<FileSystem> fs);
   bool unmount(const VirtualMountPointId& id);
-  void unmountAll();
+
+  /**
+   * Unmounts all file systems and returns their mount points, so that the caller can
+   * reuse the unmounted file systems.
+   */
+  std::vector<VirtualMountPoint> unmountAll();
+
+  /**
+   * Updates the index after the contents of the file system mounted with the given id
+   * have changed. Does nothing if that file system is not indexed.
+   */
+  void reindex(const VirtualMountPointId& id);
 
 protected:
   Result<std::vector<std::filesystem::path>> doFind(
     const std::filesystem::path& path, TraversalMode traversalMode) const override;
   Result<std::shared_ptr<File>> doOpenFile(
     const std::filesystem::path& path) const override;
+
+private:
+  /**
+   * Returns the mount point whose file system provides the given path together with the
+   * path info, or a null pointer if no file system contains the path.
+   */
+  std::tuple<const VirtualMountPoint*, PathInfo> resolve(
+    const std::filesystem::path& path) const;
+
+  void addToIndex(const VirtualMountPoint& mountPoint);
+  void removeFromIndex(size_t mountPointId);
 };
 
 class WritableVirtualFileSystem : public WritableFileSystem
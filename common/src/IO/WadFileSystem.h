@@ -29,6 +29,14 @@ namespace TrenchBroom::IO
 class FileSystem;
 class OwningBufferFile;
 
+/**
+ * A file system backed by a wad file. The wad file is read into memory with a single read
+ * when the file system is created and its entries are views into that buffer.
+ *
+ * Like pak files, wad files are not memory mapped, because users edit them in external
+ * tools while they are loaded, and a mapped file can neither be replaced on Windows nor
+ * safely be overwritten in place on other platforms.
+ */
 class WadFileSystem : public ImageFileSystem<OwningBufferFile>
 {
 public:
@@ -22,6 +22,7 @@
 #include "Color.h"
 #include "Error.h"
 #include "IO/ParserStatus.h"
+#include "Macros.h"
 #include "Model/BrushNode.h"
 #include "Model/Entity.h"
 #include "Model/EntityProperties.h"
@@ -40,7 +41,9 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <cassert>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -59,6 +62,127 @@ std::string formatParserExceptions(
   }
   return result.str();
 }
+
+bool isBlank(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+std::string_view trim(std::string_view str)
+{
+  while (!str.empty() && isBlank(str.front()))
+  {
+    str.remove_prefix(1);
+  }
+  while (!str.empty() && isBlank(str.back()))
+  {
+    str.remove_suffix(1);
+  }
+  return str;
+}
+
+/**
+ * Returns the number of whitespace separated tokens in the given string, ignoring any
+ * trailing comment.
+ */
+size_t countTokens(std::string_view str)
+{
+  auto count = size_t{0};
+  while (!(str = trim(str)).empty() && str.substr(0, 2) != "//")
+  {
+    const auto end = std::find_if(str.begin(), str.end(), isBlank);
+    str.remove_prefix(size_t(end - str.begin()));
+    ++count;
+  }
+  return count;
+}
+
+/**
+ * The syntax of a brush face line, which is all that distinguishes most map formats.
+ */
+struct FaceSyntax
+{
+  bool valve = false;
+  // after the texture name, or after the texture axes for the Valve formats
+  size_t valueCount = 0;
+};
+
+/**
+ * Returns the syntax of the given line if it is a brush face.
+ */
+std::optional<FaceSyntax> parseFaceSyntax(std::string_view line)
+{
+  // a face starts with three points
+  for (size_t i = 0; i < 3; ++i)
+  {
+    line = trim(line);
+    const auto close = line.find(')');
+    if (line.empty() || line.front() != '(' || close == std::string_view::npos)
+    {
+      return std::nullopt;
+    }
+    line.remove_prefix(close + 1);
+  }
+
+  // skip the texture name, which may be quoted
+  line = trim(line);
+  if (line.empty())
+  {
+    return std::nullopt;
+  }
+  if (line.front() == '"')
+  {
+    auto i = size_t{1};
+    while (i < line.size() && line[i] != '"')
+    {
+      i += line[i] == '\\' ? 2 : 1;
+    }
+    line.remove_prefix(std::min(i + 1, line.size()));
+  }
+  else
+  {
+    const auto end = std::find_if(line.begin(), line.end(), isBlank);
+    line.remove_prefix(size_t(end - line.begin()));
+  }
+
+  if (const auto axesEnd = line.rfind(']'); axesEnd != std::string_view::npos)
+  {
+    return FaceSyntax{true, countTokens(line.substr(axesEnd + 1))};
+  }
+  return FaceSyntax{false, countTokens(line)};
+}
+
+bool isCompatible(const Model::MapFormat format, const FaceSyntax& syntax)
+{
+  const auto count = syntax.valueCount;
+  switch (format)
+  {
+  case Model::MapFormat::Standard:
+    return !syntax.valve && count == 5;
+  case Model::MapFormat::Hexen2:
+    return !syntax.valve && count == 6;
+  case Model::MapFormat::Quake2:
+  case Model::MapFormat::Quake3_Legacy:
+  case Model::MapFormat::Quake3:
+    return !syntax.valve && (count == 5 || count == 8);
+  case Model::MapFormat::Daikatana:
+    return !syntax.valve && (count == 5 || count == 8 || count == 11);
+  case Model::MapFormat::Valve:
+    return syntax.valve && count == 3;
+  case Model::MapFormat::Quake2_Valve:
+  case Model::MapFormat::Quake3_Valve:
+    return syntax.valve && (count == 3 || count == 6);
+  case Model::MapFormat::Unknown:
+    return false;
+    switchDefault();
+  }
+}
+
+bool supportsPatches(const Model::MapFormat format)
+{
+  return format == Model::MapFormat::Quake3 || format == Model::MapFormat::Quake3_Legacy
+         || format == Model::MapFormat::Quake3_Valve;
+}
 } // namespace
 
 WorldReaderException::WorldReaderException() = default;
@@ -73,13 +197,67 @@ WorldReader::WorldReader(
   std::string_view str,
   const Model::MapFormat sourceAndTargetMapFormat,
   const Model::EntityPropertyConfig& entityPropertyConfig)
-  : MapReader{std::move(str), sourceAndTargetMapFormat, sourceAndTargetMapFormat, entityPropertyConfig}
+  : WorldReader{
+      std::move(str),
+      sourceAndTargetMapFormat,
+      sourceAndTargetMapFormat,
+      entityPropertyConfig}
+{
+}
+
+WorldReader::WorldReader(
+  std::string_view str,
+  const Model::MapFormat sourceMapFormat,
+  const Model::MapFormat targetMapFormat,
+  const Model::EntityPropertyConfig& entityPropertyConfig)
+  : MapReader{std::move(str), sourceMapFormat, targetMapFormat, entityPropertyConfig}
   , m_worldNode{std::make_unique<Model::WorldNode>(
-      entityPropertyConfig, Model::Entity{}, sourceAndTargetMapFormat)}
+      entityPropertyConfig, Model::Entity{}, targetMapFormat)}
 {
   m_worldNode->disableNodeTreeUpdates();
 }
 
+Model::MapFormat WorldReader::detectFormat(
+  std::string_view str, const std::vector<Model::MapFormat>& candidates)
+{
+  const auto findCandidate = [&](const auto& predicate) {
+    const auto it = std::find_if(candidates.begin(), candidates.end(), predicate);
+    return it != candidates.end() ? *it : Model::MapFormat::Unknown;
+  };
+
+  auto hasPatches = false;
+  auto inPatch = false;
+  while (!str.empty())
+  {
+    const auto lineEnd = std::min(str.find('\n'), str.size());
+    const auto line = trim(str.substr(0, lineEnd));
+    str.remove_prefix(std::min(lineEnd + 1, str.size()));
+
+    if (inPatch)
+    {
+      // the control points of a patch look like brush faces
+      inPatch = line != "}";
+    }
+    else if (line == "brushDef")
+    {
+      return findCandidate(
+        [](const auto format) { return format == Model::MapFormat::Quake3; });
+    }
+    else if (line == "patchDef2")
+    {
+      hasPatches = inPatch = true;
+    }
+    else if (const auto syntax = parseFaceSyntax(line))
+    {
+      return findCandidate([&](const auto format) {
+        return isCompatible(format, *syntax) && (!hasPatches || supportsPatches(format));
+      });
+    }
+  }
+
+  return hasPatches ? findCandidate(supportsPatches) : Model::MapFormat::Unknown;
+}
+
 std::unique_ptr<Model::WorldNode> WorldReader::tryRead(
   std::string_view str,
   const std::vector<Model::MapFormat>& mapFormatsToTry,
@@ -89,7 +267,18 @@ std::unique_ptr<Model::WorldNode> WorldReader::tryRead(
 {
   auto parserExceptions = std::vector<std::tuple<Model::MapFormat, std::string>>{};
 
-  for (const auto mapFormat : mapFormatsToTry)
+  // try the detected format first so that the map is usually parsed only once
+  auto mapFormats = mapFormatsToTry;
+  const auto detectedFormat = detectFormat(str, mapFormats);
+  if (detectedFormat != Model::MapFormat::Unknown)
+  {
+    mapFormats.erase(
+      std::remove(mapFormats.begin(), mapFormats.end(), detectedFormat),
+      mapFormats.end());
+    mapFormats.insert(mapFormats.begin(), detectedFormat);
+  }
+
+  for (const auto mapFormat : mapFormats)
   {
     if (mapFormat == Model::MapFormat::Unknown)
     {
@@ -182,9 +371,9 @@ void setLinkIds(Model::WorldNode& worldNode, ParserStatus& status)
 } // namespace
 
 std::unique_ptr<Model::WorldNode> WorldReader::read(
-  const vm::bbox3& worldBounds, ParserStatus& status)
+  const vm::bbox3& worldBounds, ParserStatus& status, const size_t chunkSize)
 {
-  readEntities(worldBounds, status);
+  readEntitiesInChunks(worldBounds, status, chunkSize);
   sanitizeLayerSortIndicies(*m_worldNode, status);
   setLinkIds(*m_worldNode, status);
   m_worldNode->rebuildNodeTree();
@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -53,20 +54,55 @@ class WorldReader : public MapReader
   std::unique_ptr<Model::WorldNode> m_worldNode;
 
 public:
+  /**
+   * Maps larger than twice this size are split into chunks of this size, which are
+   * parsed in parallel.
+   */
+  static constexpr size_t DefaultChunkSize = 1024 * 1024;
+
   WorldReader(
     std::string_view str,
     Model::MapFormat sourceAndTargetMapFormat,
     const Model::EntityPropertyConfig& entityPropertyConfig);
 
+  /**
+   * Creates a reader that converts the brush faces from the source format to the target
+   * format while reading them. The target format must be one of the formats that are
+   * compatible with the source format, see Model::compatibleFormats.
+   */
+  WorldReader(
+    std::string_view str,
+    Model::MapFormat sourceMapFormat,
+    Model::MapFormat targetMapFormat,
+    const Model::EntityPropertyConfig& entityPropertyConfig);
+
+  /**
+   * Reads the world. If the map is large enough, it is split into chunks of roughly the
+   * given size which are parsed in parallel, see MapReader::readEntitiesInChunks.
+   *
+   * @throws ParserException if parsing fails
+   */
   std::unique_ptr<Model::WorldNode> read(
-    const vm::bbox3& worldBounds, ParserStatus& status);
+    const vm::bbox3& worldBounds,
+    ParserStatus& status,
+    size_t chunkSize = DefaultChunkSize);
+
+  /**
+   * Guesses which of the given candidate formats the given map is in by inspecting the
+   * first brush in the map. Only the lines up to the first brush face are scanned.
+   * Returns the first candidate that is compatible with that face, or
+   * Model::MapFormat::Unknown if the map has no brushes or if no candidate matches.
+   */
+  static Model::MapFormat detectFormat(
+    std::string_view str, const std::vector<Model::MapFormat>& candidates);
 
   /**
-   * Try to parse the given string as the given map formats, in order.
+   * Try to parse the given string as the given map formats. The format returned by
+   * detectFormat is tried first, and the remaining formats are tried in order.
    * Returns the world if parsing is successful, otherwise throws an exception.
    *
    * @param str the string to parse
-   * @param mapFormatsToTry formats to try, in order
+   * @param mapFormatsToTry formats to try
    * @param worldBounds world bounds
    * @param status status
    * @return the world node
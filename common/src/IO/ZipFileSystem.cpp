@@ -22,9 +22,15 @@
 #include "Error.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/File.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
 
+#include "kdl/resource.h"
 #include "kdl/result.h"
 
+#include <miniz/miniz.h>
+
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -55,53 +61,140 @@ std::string filename(mz_zip_archive& archive, const mz_uint fileIndex)
 
   return result;
 }
-} // namespace
 
-ZipFileSystem::~ZipFileSystem()
+/**
+ * The information from the central directory that is needed to extract an entry.
+ */
+struct ZipEntry
+{
+  mz_uint64 localHeaderOffset;
+  mz_uint64 compressedSize;
+  mz_uint64 uncompressedSize;
+  mz_uint32 crc32;
+  mz_uint16 method;
+  bool encrypted;
+};
+
+constexpr auto LocalHeaderSignature = uint32_t(0x04034b50);
+constexpr auto LocalHeaderSize = size_t(30);
+
+/**
+ * Extracts the given entry without using the archive, so that it can be called from
+ * several threads at once. The file serializes the individual reads.
+ */
+Result<std::shared_ptr<File>> extractEntry(const CFile& file, const ZipEntry& entry)
 {
-  mz_zip_reader_end(&m_archive);
+  if (entry.encrypted)
+  {
+    return Error{"encrypted entries are not supported"};
+  }
+
+  try
+  {
+    auto reader = file.reader();
+
+    // the local header is followed by the file name and an extra field, whose lengths may
+    // differ from those in the central directory
+    reader.seekFromBegin(size_t(entry.localHeaderOffset));
+    if (reader.readUnsignedInt<uint32_t>() != LocalHeaderSignature)
+    {
+      return Error{"invalid local header"};
+    }
+    reader.seekFromBegin(size_t(entry.localHeaderOffset) + 26);
+    const auto nameLength = reader.readSize<uint16_t>();
+    const auto extraLength = reader.readSize<uint16_t>();
+    const auto dataOffset =
+      size_t(entry.localHeaderOffset) + LocalHeaderSize + nameLength + extraLength;
+
+    const auto uncompressedSize = size_t(entry.uncompressedSize);
+    auto data = std::make_unique<char[]>(uncompressedSize);
+
+    if (entry.method == 0)
+    {
+      if (entry.compressedSize != entry.uncompressedSize)
+      {
+        return Error{"invalid size of stored entry"};
+      }
+      reader.seekFromBegin(dataOffset);
+      reader.read(data.get(), uncompressedSize);
+    }
+    else if (entry.method == MZ_DEFLATED)
+    {
+      const auto compressed =
+        reader.subReaderFromBegin(dataOffset, size_t(entry.compressedSize)).buffer();
+      const auto inflatedSize = tinfl_decompress_mem_to_mem(
+        data.get(), uncompressedSize, compressed.begin(), compressed.size(), 0);
+      if (inflatedSize != uncompressedSize)
+      {
+        return Error{"tinfl_decompress_mem_to_mem failed"};
+      }
+    }
+    else
+    {
+      return Error{"unsupported compression method " + std::to_string(entry.method)};
+    }
+
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.get());
+    if (mz_crc32(MZ_CRC32_INIT, bytes, uncompressedSize) != entry.crc32)
+    {
+      return Error{"CRC mismatch"};
+    }
+
+    return std::static_pointer_cast<File>(
+      std::make_shared<OwningBufferFile>(std::move(data), uncompressedSize));
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
 }
 
+} // namespace
+
 Result<void> ZipFileSystem::doReadDirectory()
 {
-  mz_zip_zero_struct(&m_archive);
+  auto archive = mz_zip_archive{};
+  mz_zip_zero_struct(&archive);
 
-  if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE)
+  if (mz_zip_reader_init_cfile(&archive, m_file->file(), m_file->size(), 0) != MZ_TRUE)
   {
     return Error{"Error calling mz_zip_reader_init_cfile"};
   }
 
-  const auto numFiles = mz_zip_reader_get_num_files(&m_archive);
+  // the archive is only needed to read the central directory
+  auto archiveGuard = kdl::resource{&archive, mz_zip_reader_end};
+
+  const auto numFiles = mz_zip_reader_get_num_files(&archive);
   for (mz_uint i = 0; i < numFiles; ++i)
   {
-    if (!mz_zip_reader_is_file_a_directory(&m_archive, i))
+    if (!mz_zip_reader_is_file_a_directory(&archive, i))
     {
-      const auto path = std::filesystem::path{filename(m_archive, i)};
-      addFile(path, [=]() -> Result<std::shared_ptr<File>> {
-        auto loadFileGoard = std::lock_guard{m_mutex};
-
-        auto stat = mz_zip_archive_file_stat{};
-        if (!mz_zip_reader_file_stat(&m_archive, i, &stat))
-        {
-          return Error{"mz_zip_reader_file_stat failed for " + path.string()};
-        }
-
-        const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
-        auto data = std::make_unique<char[]>(uncompressedSize);
-        auto* begin = data.get();
-
-        if (!mz_zip_reader_extract_to_mem(&m_archive, i, begin, uncompressedSize, 0))
-        {
-          return Error{"mz_zip_reader_extract_to_mem failed for " + path.string()};
-        }
-
-        return std::static_pointer_cast<File>(
-          std::make_shared<OwningBufferFile>(std::move(data), uncompressedSize));
+      const auto path = std::filesystem::path{filename(archive, i)};
+
+      auto stat = mz_zip_archive_file_stat{};
+      if (!mz_zip_reader_file_stat(&archive, i, &stat))
+      {
+        return Error{"mz_zip_reader_file_stat failed for " + path.string()};
+      }
+
+      const auto entry = ZipEntry{
+        stat.m_local_header_ofs,
+        stat.m_comp_size,
+        stat.m_uncomp_size,
+        stat.m_crc32,
+        stat.m_method,
+        stat.m_is_encrypted != 0};
+
+      addFile(path, [file = m_file, entry, path]() {
+        return extractEntry(*file, entry).or_else([&](auto e) {
+          return Result<std::shared_ptr<File>>{
+            Error{"Could not extract " + path.string() + ": " + e.msg}};
+        });
       });
     }
   }
 
-  const auto err = mz_zip_get_last_error(&m_archive);
+  const auto err = mz_zip_get_last_error(&archive);
   if (err != MZ_ZIP_NO_ERROR)
   {
     return Error{
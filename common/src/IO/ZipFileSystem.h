@@ -22,23 +22,22 @@
 #include "IO/ImageFileSystem.h"
 #include "Result.h"
 
-#include <miniz/miniz.h>
-
-#include <mutex>
-
 namespace TrenchBroom::IO
 {
 class CFile;
 
+/**
+ * A file system backed by a zip archive such as a pk3 file.
+ *
+ * The central directory is read once when the file system is loaded. Afterwards, every
+ * entry is extracted independently using the offsets and sizes recorded in the central
+ * directory, so several threads can open files concurrently. Only reading the compressed
+ * data from the archive is serialized; decompression runs in parallel.
+ */
 class ZipFileSystem : public ImageFileSystem<CFile>
 {
-private:
-  mz_zip_archive m_archive;
-  std::mutex m_mutex;
-
 public:
   using ImageFileSystem::ImageFileSystem;
-  ~ZipFileSystem() override;
 
 private:
   Result<void> doReadDirectory() override;
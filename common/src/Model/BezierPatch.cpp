@@ -172,6 +172,12 @@ void BezierPatch::transform(const vm::mat4x4& transformation)
   m_bounds = builder.bounds();
 }
 
+size_t BezierPatch::memoryUsage() const
+{
+  return sizeof(BezierPatch) + m_controlPoints.capacity() * sizeof(Point)
+         + m_textureName.capacity();
+}
+
 using SurfaceControlPoints = std::array<std::array<BezierPatch::Point, 3u>, 3u>;
 static SurfaceControlPoints collectSurfaceControlPoints(
   const std::vector<BezierPatch::Point>& controlPoints,
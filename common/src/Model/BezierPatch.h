@@ -99,6 +99,11 @@ public: // control points:
 
   void transform(const vm::mat4x4& transformation);
 
+  /**
+   * Returns an estimate of the memory used by this patch in bytes.
+   */
+  size_t memoryUsage() const;
+
   std::vector<Point> evaluate(size_t subdivisionsPerSurface) const;
 };
 
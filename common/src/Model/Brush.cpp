@@ -44,7 +44,10 @@
 #include "vm/vec.h"
 #include "vm/vec_ext.h"
 
+#include <algorithm>
+#include <array>
 #include <iterator>
+#include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -55,33 +58,46 @@ namespace TrenchBroom::Model
 
 kdl_reflect_impl(Brush);
 
-class Brush::CopyCallback : public BrushGeometry::CopyCallback
+struct Brush::CompactTopology
 {
-public:
-  void faceWasCopied(
-    const BrushFaceGeometry* original, BrushFaceGeometry* copy) const override
-  {
-    copy->setPayload(original->payload());
-  }
+  /**
+   * The boundary of face i is given by the vertex indices in the range
+   * [faceOffsets[i], faceOffsets[i + 1]).
+   */
+  std::vector<size_t> faceVertexIndices;
+  std::vector<size_t> faceOffsets;
+};
+
+struct Brush::CompactGeometry
+{
+  vm::bbox3 bounds;
+  std::vector<vm::vec3> vertexPositions;
+  std::vector<vm::plane3> facePlanes;
+
+  /**
+   * Transformations that do not flip the geometry keep its topology, so transformed
+   * copies of a compact geometry share it.
+   */
+  std::shared_ptr<const CompactTopology> topology;
 };
 
 Brush::Brush() {}
 
+// The copied faces are linked to the shared geometry. Its face payloads are valid for the
+// copy because the faces are copied in order.
 Brush::Brush(const Brush& other)
   : m_faces{other.m_faces}
-  , m_geometry{
-      other.m_geometry
-        ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback())
-        : nullptr}
+  , m_geometry{other.m_geometry}
+  , m_compactGeometry{other.m_compactGeometry}
 {
+  // copying a face does not copy its link to the geometry
   if (m_geometry)
   {
     for (BrushFaceGeometry* faceGeometry : m_geometry->faces())
     {
       if (const auto faceIndex = faceGeometry->payload())
       {
-        BrushFace& face = m_faces[*faceIndex];
-        face.setGeometry(faceGeometry);
+        m_faces[*faceIndex].setGeometry(faceGeometry);
       }
     }
   }
@@ -112,6 +128,30 @@ Result<Brush> Brush::create(const vm::bbox3& worldBounds, std::vector<BrushFace>
   });
 }
 
+Result<Brush> Brush::createFromGeometry(
+  std::vector<BrushFace> faces, std::unique_ptr<BrushGeometry> geometry)
+{
+  if (geometry->faceCount() != faces.size())
+  {
+    return Error{"Brush geometry does not match brush faces"};
+  }
+
+  auto brush = Brush{std::move(faces)};
+  brush.m_geometry = std::move(geometry);
+
+  auto faceIndex = size_t(0);
+  for (BrushFaceGeometry* faceGeometry : brush.m_geometry->faces())
+  {
+    brush.m_faces[faceIndex].setGeometry(faceGeometry);
+    faceGeometry->setPayload(faceIndex);
+    ++faceIndex;
+  }
+
+  assert(brush.checkFaceLinks());
+
+  return brush;
+}
+
 Result<void> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds)
 {
   // First, add all faces to the brush geometry
@@ -161,6 +201,7 @@ Result<void> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds)
 
   m_faces = std::move(remainingFaces);
   m_geometry = std::move(geometry);
+  m_compactGeometry.reset();
 
   assert(checkFaceLinks());
 
@@ -169,10 +210,134 @@ Result<void> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds)
 
 const vm::bbox3& Brush::bounds() const
 {
+  if (m_compactGeometry)
+  {
+    return m_compactGeometry->bounds;
+  }
+
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->bounds();
 }
 
+void Brush::compactGeometry()
+{
+  // compacting a shared geometry would not release it, but only add the compact form
+  if (
+    !m_geometry || m_geometry.use_count() > 1
+    || m_geometry->faceCount() != m_faces.size())
+  {
+    return;
+  }
+
+  auto compact = createCompactGeometry();
+  for (auto& face : m_faces)
+  {
+    face.setGeometry(nullptr);
+  }
+
+  m_geometry.reset();
+  m_compactGeometry = std::make_shared<const CompactGeometry>(std::move(compact));
+}
+
+bool Brush::hasCompactGeometry() const
+{
+  return m_compactGeometry != nullptr;
+}
+
+bool Brush::sharesGeometryWith(const Brush& other) const
+{
+  return (m_geometry && m_geometry == other.m_geometry)
+         || (m_compactGeometry && m_compactGeometry == other.m_compactGeometry);
+}
+
+Brush Brush::compactCopy() const
+{
+  expandGeometry();
+
+  // the copied faces are not linked to any geometry
+  auto result = Brush{m_faces};
+  result.m_compactGeometry =
+    std::make_shared<const CompactGeometry>(createCompactGeometry());
+  return result;
+}
+
+Brush::CompactGeometry Brush::createCompactGeometry() const
+{
+  ensure(m_geometry != nullptr, "geometry is null");
+
+  auto compact = CompactGeometry{};
+  auto topology = CompactTopology{};
+  compact.bounds = m_geometry->bounds();
+  compact.vertexPositions.reserve(m_geometry->vertexCount());
+  compact.facePlanes.reserve(m_faces.size());
+  topology.faceVertexIndices.reserve(2u * m_geometry->edgeCount());
+  topology.faceOffsets.reserve(m_faces.size() + 1u);
+
+  auto vertexIndices = std::unordered_map<const BrushVertex*, size_t>{};
+  for (const auto* vertex : m_geometry->vertices())
+  {
+    vertexIndices.emplace(vertex, compact.vertexPositions.size());
+    compact.vertexPositions.push_back(vertex->position());
+  }
+
+  for (const auto& face : m_faces)
+  {
+    const auto* faceGeometry = face.geometry();
+    ensure(faceGeometry != nullptr, "face geometry is null");
+
+    compact.facePlanes.push_back(faceGeometry->plane());
+    topology.faceOffsets.push_back(topology.faceVertexIndices.size());
+    for (const auto* halfEdge : faceGeometry->boundary())
+    {
+      topology.faceVertexIndices.push_back(vertexIndices[halfEdge->origin()]);
+    }
+  }
+  topology.faceOffsets.push_back(topology.faceVertexIndices.size());
+  compact.topology = std::make_shared<const CompactTopology>(std::move(topology));
+
+  return compact;
+}
+
+void Brush::expandGeometry() const
+{
+  if (!m_compactGeometry)
+  {
+    return;
+  }
+
+  const auto& compact = *m_compactGeometry;
+  const auto& topology = *compact.topology;
+
+  auto faceVertexIndices = std::vector<std::vector<size_t>>{};
+  faceVertexIndices.reserve(compact.facePlanes.size());
+  for (size_t i = 0u; i < compact.facePlanes.size(); ++i)
+  {
+    faceVertexIndices.emplace_back(
+      std::next(topology.faceVertexIndices.begin(), long(topology.faceOffsets[i])),
+      std::next(topology.faceVertexIndices.begin(), long(topology.faceOffsets[i + 1u])));
+  }
+
+  auto geometry = BrushGeometry::fromFaces(
+    compact.vertexPositions, faceVertexIndices, compact.facePlanes);
+  ensure(geometry.has_value(), "compact geometry is valid");
+
+  m_geometry = std::make_shared<BrushGeometry>(std::move(*geometry));
+  m_compactGeometry.reset();
+
+  // the faces only store a link to their geometry, which does not affect the value of
+  // this brush
+  auto& faces = const_cast<std::vector<BrushFace>&>(m_faces);
+  auto faceIndex = size_t(0);
+  for (BrushFaceGeometry* faceGeometry : m_geometry->faces())
+  {
+    faces[faceIndex].setGeometry(faceGeometry);
+    faceGeometry->setPayload(faceIndex);
+    ++faceIndex;
+  }
+
+  assert(checkFaceLinks());
+}
+
 std::optional<size_t> Brush::findFace(const std::string& textureName) const
 {
   return kdl::vec_index_of(m_faces, [&](const BrushFace& face) {
@@ -197,6 +362,7 @@ std::optional<size_t> Brush::findFace(const vm::plane3& boundary) const
 std::optional<size_t> Brush::findFace(
   const vm::polygon3& vertices, const FloatType epsilon) const
 {
+  expandGeometry();
   return kdl::vec_index_of(
     m_faces, [&](const BrushFace& face) { return face.hasVertices(vertices, epsilon); });
 }
@@ -216,12 +382,14 @@ std::optional<size_t> Brush::findFace(
 
 const BrushFace& Brush::face(const size_t index) const
 {
+  expandGeometry();
   assert(index < faceCount());
   return m_faces[index];
 }
 
 BrushFace& Brush::face(const size_t index)
 {
+  expandGeometry();
   assert(index < faceCount());
   return m_faces[index];
 }
@@ -233,22 +401,26 @@ size_t Brush::faceCount() const
 
 const std::vector<BrushFace>& Brush::faces() const
 {
+  expandGeometry();
   return m_faces;
 }
 
 std::vector<BrushFace>& Brush::faces()
 {
+  expandGeometry();
   return m_faces;
 }
 
 bool Brush::closed() const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->closed();
 }
 
 bool Brush::fullySpecified() const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
 
   for (auto* current : m_geometry->faces())
@@ -263,6 +435,7 @@ bool Brush::fullySpecified() const
 
 void Brush::cloneFaceAttributesFrom(const Brush& brush)
 {
+  expandGeometry();
   for (auto& destination : m_faces)
   {
     if (const auto sourceIndex = brush.findFace(destination.boundary()))
@@ -321,6 +494,7 @@ static const BrushFace* findBestMatchingFace(
 
 void Brush::cloneFaceAttributesFrom(const std::vector<const Brush*>& brushes)
 {
+  expandGeometry();
   auto candidates = std::vector<const BrushFace*>{};
   for (const auto* candidateBrush : brushes)
   {
@@ -348,6 +522,7 @@ void Brush::cloneFaceAttributesFrom(const std::vector<const Brush*>& brushes)
 
 void Brush::cloneInvertedFaceAttributesFrom(const Brush& brush)
 {
+  expandGeometry();
   for (auto& destination : m_faces)
   {
     if (const auto sourceIndex = brush.findFace(destination.boundary().flip()))
@@ -368,6 +543,7 @@ void Brush::cloneInvertedFaceAttributesFrom(const Brush& brush)
 
 Result<void> Brush::clip(const vm::bbox3& worldBounds, BrushFace face)
 {
+  expandGeometry();
   m_faces.push_back(std::move(face));
   return updateGeometryFromFaces(worldBounds);
 }
@@ -379,6 +555,7 @@ Result<void> Brush::moveBoundary(
   const bool lockTexture)
 {
   assert(faceIndex < faceCount());
+  expandGeometry();
 
   return m_faces[faceIndex]
     .transform(vm::translation_matrix(delta), lockTexture)
@@ -388,6 +565,7 @@ Result<void> Brush::moveBoundary(
 Result<void> Brush::expand(
   const vm::bbox3& worldBounds, const FloatType delta, const bool lockTexture)
 {
+  expandGeometry();
   for (auto& face : m_faces)
   {
     const vm::vec3 moveAmount = face.boundary().normal * delta;
@@ -402,30 +580,43 @@ Result<void> Brush::expand(
 
 size_t Brush::vertexCount() const
 {
+  if (m_compactGeometry)
+  {
+    return m_compactGeometry->vertexPositions.size();
+  }
+
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->vertexCount();
 }
 
 const Brush::VertexList& Brush::vertices() const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->vertices();
 }
 
 const std::vector<vm::vec3> Brush::vertexPositions() const
 {
+  if (m_compactGeometry)
+  {
+    return m_compactGeometry->vertexPositions;
+  }
+
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->vertexPositions();
 }
 
 bool Brush::hasVertex(const vm::vec3& position, const FloatType epsilon) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->findVertexByPosition(position, epsilon) != nullptr;
 }
 
 vm::vec3 Brush::findClosestVertexPosition(const vm::vec3& position) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->findClosestVertex(position)->position();
 }
@@ -433,6 +624,7 @@ vm::vec3 Brush::findClosestVertexPosition(const vm::vec3& position) const
 std::vector<vm::vec3> Brush::findClosestVertexPositions(
   const std::vector<vm::vec3>& positions) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
 
   std::vector<vm::vec3> result;
@@ -453,6 +645,7 @@ std::vector<vm::vec3> Brush::findClosestVertexPositions(
 std::vector<vm::segment3> Brush::findClosestEdgePositions(
   const std::vector<vm::segment3>& positions) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
 
   std::vector<vm::segment3> result;
@@ -475,6 +668,7 @@ std::vector<vm::segment3> Brush::findClosestEdgePositions(
 std::vector<vm::polygon3> Brush::findClosestFacePositions(
   const std::vector<vm::polygon3>& positions) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
 
   std::vector<vm::polygon3> result;
@@ -495,24 +689,28 @@ std::vector<vm::polygon3> Brush::findClosestFacePositions(
 
 bool Brush::hasEdge(const vm::segment3& edge, const FloatType epsilon) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->findEdgeByPositions(edge.start(), edge.end(), epsilon) != nullptr;
 }
 
 bool Brush::hasFace(const vm::polygon3& face, const FloatType epsilon) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->hasFace(face.vertices(), epsilon);
 }
 
 size_t Brush::edgeCount() const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->edgeCount();
 }
 
 const Brush::EdgeList& Brush::edges() const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->edges();
 }
@@ -555,12 +753,28 @@ std::vector<const BrushFace*> Brush::incidentFaces(const BrushVertex* vertex) co
   return result;
 }
 
+Brush::VertexMove::VertexMove(
+  std::vector<vm::vec3> i_vertexPositions,
+  const vm::vec3& i_delta,
+  std::unique_ptr<BrushGeometry> i_geometry)
+  : vertexPositions{std::move(i_vertexPositions)}
+  , delta{i_delta}
+  , geometry{std::move(i_geometry)}
+{
+}
+
+Brush::VertexMove::~VertexMove() = default;
+
+Brush::VertexMove::VertexMove(VertexMove&& other) noexcept = default;
+
+Brush::VertexMove& Brush::VertexMove::operator=(VertexMove&& other) noexcept = default;
+
 bool Brush::canMoveVertices(
   const vm::bbox3& worldBounds,
   const std::vector<vm::vec3>& vertices,
   const vm::vec3& delta) const
 {
-  return doCanMoveVertices(worldBounds, vertices, delta, true).success;
+  return prepareMoveVertices(worldBounds, vertices, delta).is_success();
 }
 
 Result<void> Brush::moveVertices(
@@ -569,11 +783,22 @@ Result<void> Brush::moveVertices(
   const vm::vec3& delta,
   const bool uvLock)
 {
-  return doMoveVertices(worldBounds, vertexPositions, delta, uvLock);
+  return prepareMoveVertices(worldBounds, vertexPositions, delta)
+    .and_then(
+      [&](const auto& move) { return applyVertexMove(worldBounds, move, uvLock); });
+}
+
+Result<Brush::VertexMove> Brush::prepareMoveVertices(
+  const vm::bbox3& worldBounds,
+  const std::vector<vm::vec3>& vertexPositions,
+  const vm::vec3& delta) const
+{
+  return doPrepareMoveVertices(worldBounds, vertexPositions, delta, true);
 }
 
 bool Brush::canAddVertex(const vm::bbox3& worldBounds, const vm::vec3& position) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   if (!worldBounds.contains(position))
   {
@@ -587,6 +812,8 @@ bool Brush::canAddVertex(const vm::bbox3& worldBounds, const vm::vec3& position)
 
 Result<void> Brush::addVertex(const vm::bbox3& worldBounds, const vm::vec3& position)
 {
+  expandGeometry();
+  ensure(m_geometry != nullptr, "geometry is null");
   assert(canAddVertex(worldBounds, position));
 
   BrushGeometry newGeometry(
@@ -616,6 +843,7 @@ static BrushGeometry removeVerticesFromGeometry(
 bool Brush::canRemoveVertices(
   const vm::bbox3& /* worldBounds */, const std::vector<vm::vec3>& vertexPositions) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   ensure(!vertexPositions.empty(), "no vertex positions");
 
@@ -625,6 +853,7 @@ bool Brush::canRemoveVertices(
 Result<void> Brush::removeVertices(
   const vm::bbox3& worldBounds, const std::vector<vm::vec3>& vertexPositions)
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   ensure(!vertexPositions.empty(), "no vertex positions");
   assert(canRemoveVertices(worldBounds, vertexPositions));
@@ -652,6 +881,7 @@ static BrushGeometry snappedGeometry(
 bool Brush::canSnapVertices(
   const vm::bbox3& /* worldBounds */, const FloatType snapToF) const
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
   return snappedGeometry(*m_geometry, snapToF).polyhedron();
 }
@@ -659,6 +889,7 @@ bool Brush::canSnapVertices(
 Result<void> Brush::snapVertices(
   const vm::bbox3& worldBounds, const FloatType snapToF, const bool uvLock)
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
 
   const BrushGeometry newGeometry = snappedGeometry(*m_geometry, snapToF);
@@ -683,30 +914,7 @@ bool Brush::canMoveEdges(
   const std::vector<vm::segment3>& edgePositions,
   const vm::vec3& delta) const
 {
-  ensure(m_geometry != nullptr, "geometry is null");
-  ensure(!edgePositions.empty(), "no edge positions");
-
-  std::vector<vm::vec3> vertexPositions;
-  vm::segment3::get_vertices(
-    std::begin(edgePositions),
-    std::end(edgePositions),
-    std::back_inserter(vertexPositions));
-  const auto result = doCanMoveVertices(worldBounds, vertexPositions, delta, false);
-
-  if (!result.success)
-  {
-    return false;
-  }
-
-  for (const auto& edge : edgePositions)
-  {
-    if (!result.geometry->hasEdge(edge.start() + delta, edge.end() + delta))
-    {
-      return false;
-    }
-  }
-
-  return true;
+  return prepareMoveEdges(worldBounds, edgePositions, delta).is_success();
 }
 
 Result<void> Brush::moveEdges(
@@ -715,14 +923,35 @@ Result<void> Brush::moveEdges(
   const vm::vec3& delta,
   const bool uvLock)
 {
-  assert(canMoveEdges(worldBounds, edgePositions, delta));
+  return prepareMoveEdges(worldBounds, edgePositions, delta)
+    .and_then(
+      [&](const auto& move) { return applyVertexMove(worldBounds, move, uvLock); });
+}
+
+Result<Brush::VertexMove> Brush::prepareMoveEdges(
+  const vm::bbox3& worldBounds,
+  const std::vector<vm::segment3>& edgePositions,
+  const vm::vec3& delta) const
+{
+  ensure(!edgePositions.empty(), "no edge positions");
 
   std::vector<vm::vec3> vertexPositions;
   vm::segment3::get_vertices(
     std::begin(edgePositions),
     std::end(edgePositions),
     std::back_inserter(vertexPositions));
-  return doMoveVertices(worldBounds, vertexPositions, delta, uvLock);
+
+  return doPrepareMoveVertices(worldBounds, vertexPositions, delta, false)
+    .and_then([&](auto move) -> Result<VertexMove> {
+      for (const auto& edge : edgePositions)
+      {
+        if (!move.geometry->hasEdge(edge.start() + delta, edge.end() + delta))
+        {
+          return Error{"Moved edges would not be preserved"};
+        }
+      }
+      return move;
+    });
 }
 
 bool Brush::canMoveFaces(
@@ -730,30 +959,7 @@ bool Brush::canMoveFaces(
   const std::vector<vm::polygon3>& facePositions,
   const vm::vec3& delta) const
 {
-  ensure(m_geometry != nullptr, "geometry is null");
-  ensure(!facePositions.empty(), "no face positions");
-
-  std::vector<vm::vec3> vertexPositions;
-  vm::polygon3::get_vertices(
-    std::begin(facePositions),
-    std::end(facePositions),
-    std::back_inserter(vertexPositions));
-  const auto result = doCanMoveVertices(worldBounds, vertexPositions, delta, false);
-
-  if (!result.success)
-  {
-    return false;
-  }
-
-  for (const auto& face : facePositions)
-  {
-    if (!result.geometry->hasFace(face.vertices() + delta))
-    {
-      return false;
-    }
-  }
-
-  return true;
+  return prepareMoveFaces(worldBounds, facePositions, delta).is_success();
 }
 
 Result<void> Brush::moveFaces(
@@ -762,31 +968,35 @@ Result<void> Brush::moveFaces(
   const vm::vec3& delta,
   const bool uvLock)
 {
-  assert(canMoveFaces(worldBounds, facePositions, delta));
+  return prepareMoveFaces(worldBounds, facePositions, delta)
+    .and_then(
+      [&](const auto& move) { return applyVertexMove(worldBounds, move, uvLock); });
+}
+
+Result<Brush::VertexMove> Brush::prepareMoveFaces(
+  const vm::bbox3& worldBounds,
+  const std::vector<vm::polygon3>& facePositions,
+  const vm::vec3& delta) const
+{
+  ensure(!facePositions.empty(), "no face positions");
 
   std::vector<vm::vec3> vertexPositions;
   vm::polygon3::get_vertices(
     std::begin(facePositions),
     std::end(facePositions),
     std::back_inserter(vertexPositions));
-  return doMoveVertices(worldBounds, vertexPositions, delta, uvLock);
-}
 
-Brush::CanMoveVerticesResult::CanMoveVerticesResult(const bool s, BrushGeometry&& g)
-  : success(s)
-  , geometry(std::make_unique<BrushGeometry>(std::move(g)))
-{
-}
-
-Brush::CanMoveVerticesResult Brush::CanMoveVerticesResult::rejectVertexMove()
-{
-  return CanMoveVerticesResult(false, BrushGeometry());
-}
-
-Brush::CanMoveVerticesResult Brush::CanMoveVerticesResult::acceptVertexMove(
-  BrushGeometry&& result)
-{
-  return CanMoveVerticesResult(true, std::move(result));
+  return doPrepareMoveVertices(worldBounds, vertexPositions, delta, false)
+    .and_then([&](auto move) -> Result<VertexMove> {
+      for (const auto& face : facePositions)
+      {
+        if (!move.geometry->hasFace(face.vertices() + delta))
+        {
+          return Error{"Moved faces would not be preserved"};
+        }
+      }
+      return move;
+    });
 }
 
 /*
@@ -820,16 +1030,39 @@ Brush::CanMoveVerticesResult Brush::CanMoveVerticesResult::acceptVertexMove(
  If `allowVertexRemoval` is true, vertices can be moved inside a remaining polyhedron.
 
  */
-Brush::CanMoveVerticesResult Brush::doCanMoveVertices(
+Result<Brush::VertexMove> Brush::doPrepareMoveVertices(
   const vm::bbox3& worldBounds,
   const std::vector<vm::vec3>& vertexPositions,
   vm::vec3 delta,
   const bool allowVertexRemoval) const
 {
+  expandGeometry();
+  ensure(m_geometry != nullptr, "geometry is null");
+
+  // delta may be inverted below, but the move must record the original delta
+  const auto moveDelta = delta;
+  const auto acceptVertexMove = [&](BrushGeometry&& geometry) -> Result<VertexMove> {
+    return VertexMove{
+      vertexPositions, moveDelta, std::make_unique<BrushGeometry>(std::move(geometry))};
+  };
+
   // Should never occur, takes care of the first row.
   if (vertexPositions.empty() || vm::is_zero(delta, vm::C::almost_zero()))
   {
-    return CanMoveVerticesResult::rejectVertexMove();
+    return Error{"Nothing to move"};
+  }
+
+  // Moves that keep the topology of the brush, such as moving a face along its normal,
+  // are valid if the result remains within the world bounds. These are common while
+  // dragging, and checking them is much cheaper than building the hulls below.
+  auto movedGeometry = *m_geometry;
+  if (movedGeometry.moveVerticesKeepingTopology(vertexPositions, delta))
+  {
+    if (!worldBounds.contains(movedGeometry.bounds()))
+    {
+      return Error{"Brush would exceed the world bounds"};
+    }
+    return acceptVertexMove(std::move(movedGeometry));
   }
 
   const auto vertexSet =
@@ -868,13 +1101,13 @@ Brush::CanMoveVerticesResult Brush::doCanMoveVertices(
   // Will the result go out of world bounds?
   if (!worldBounds.contains(result.bounds()))
   {
-    return CanMoveVerticesResult::rejectVertexMove();
+    return Error{"Brush would exceed the world bounds"};
   }
 
   // Special case, takes care of the first column.
   if (moving.vertexCount() == vertexCount())
   {
-    return CanMoveVerticesResult::acceptVertexMove(std::move(result));
+    return acceptVertexMove(std::move(result));
   }
 
   // Will vertices be removed?
@@ -885,7 +1118,7 @@ Brush::CanMoveVerticesResult Brush::doCanMoveVertices(
     {
       if (!result.hasVertex(movingVertex + delta))
       {
-        return CanMoveVerticesResult::rejectVertexMove();
+        return Error{"Moved vertices would be removed"};
       }
     }
   }
@@ -893,13 +1126,13 @@ Brush::CanMoveVerticesResult Brush::doCanMoveVertices(
   // Will the brush become invalid?
   if (!result.polyhedron())
   {
-    return CanMoveVerticesResult::rejectVertexMove();
+    return Error{"Brush would become invalid"};
   }
 
   // One of the remaining two ok cases?
   if ((moving.point() && remaining.polygon()) || (moving.edge() && remaining.edge()))
   {
-    return CanMoveVerticesResult::acceptVertexMove(std::move(result));
+    return acceptVertexMove(std::move(result));
   }
 
   // Invert if necessary.
@@ -930,42 +1163,25 @@ Brush::CanMoveVerticesResult Brush::doCanMoveVertices(
         const auto distance = face->intersectWithRay(ray, vm::side::back);
         if (!vm::is_nan(distance))
         {
-          return CanMoveVerticesResult::rejectVertexMove();
+          return Error{"Moved vertices would travel through the brush"};
         }
       }
     }
   }
 
-  return CanMoveVerticesResult::acceptVertexMove(std::move(result));
+  return acceptVertexMove(std::move(result));
 }
 
-Result<void> Brush::doMoveVertices(
-  const vm::bbox3& worldBounds,
-  const std::vector<vm::vec3>& vertexPositions,
-  const vm::vec3& delta,
-  const bool uvLock)
+Result<void> Brush::applyVertexMove(
+  const vm::bbox3& worldBounds, const VertexMove& move, const bool uvLock)
 {
+  expandGeometry();
   ensure(m_geometry != nullptr, "geometry is null");
-  ensure(!vertexPositions.empty(), "no vertex positions");
-  assert(canMoveVertices(worldBounds, vertexPositions, delta));
+  ensure(move.geometry != nullptr, "geometry is null");
 
-  std::vector<vm::vec3> newVertices;
-  newVertices.reserve(vertexCount());
-
-  for (const auto* vertex : m_geometry->vertices())
-  {
-    const auto& position = vertex->position();
-    if (kdl::vec_contains(vertexPositions, position))
-    {
-      newVertices.push_back(position + delta);
-    }
-    else
-    {
-      newVertices.push_back(position);
-    }
-  }
-
-  BrushGeometry newGeometry(newVertices);
+  const auto& vertexPositions = move.vertexPositions;
+  const auto& delta = move.delta;
+  const auto& newGeometry = *move.geometry;
 
   using VecMap = std::map<vm::vec3, vm::vec3>;
   VecMap vertexMapping;
@@ -1139,6 +1355,7 @@ std::vector<Result<Brush>> Brush::subtract(
   const std::string& defaultTextureName,
   const std::vector<const Brush*>& subtrahends) const
 {
+  expandGeometry();
   auto result = std::vector<BrushGeometry>{*m_geometry};
 
   for (const auto* subtrahend : subtrahends)
@@ -1147,6 +1364,7 @@ std::vector<Result<Brush>> Brush::subtract(
 
     for (const BrushGeometry& fragment : result)
     {
+      subtrahend->expandGeometry();
       auto subFragments = fragment.subtract(*subtrahend->m_geometry);
       nextResults = kdl::vec_concat(std::move(nextResults), std::move(subFragments));
     }
@@ -1171,13 +1389,84 @@ std::vector<Result<Brush>> Brush::subtract(
 
 Result<void> Brush::intersect(const vm::bbox3& worldBounds, const Brush& brush)
 {
+  expandGeometry();
   m_faces = kdl::vec_concat(std::move(m_faces), brush.faces());
   return updateGeometryFromFaces(worldBounds);
 }
 
+/**
+ * Returns the given transformation with its linear part snapped to a signed permutation
+ * matrix if it is close to one, i.e., if the transformation only consists of 90 degree
+ * rotations, flips and a translation. Otherwise, returns nullopt.
+ */
+static std::optional<vm::mat4x4> snapAxisAlignedTransformation(
+  const vm::mat4x4& transformation)
+{
+  if (
+    transformation[0][3] != 0.0 || transformation[1][3] != 0.0
+    || transformation[2][3] != 0.0 || transformation[3][3] != 1.0)
+  {
+    return std::nullopt;
+  }
+
+  constexpr auto epsilon = vm::constants<FloatType>::almost_zero();
+
+  auto result = transformation;
+  auto rows = std::array<bool, 3>{false, false, false};
+  for (size_t c = 0u; c < 3u; ++c)
+  {
+    auto nonZeroCount = size_t(0);
+    for (size_t r = 0u; r < 3u; ++r)
+    {
+      auto& value = result[c][r];
+      if (vm::abs(value) < epsilon)
+      {
+        value = 0.0;
+      }
+      else if (vm::abs(vm::abs(value) - 1.0) < epsilon && !rows[r])
+      {
+        value = value < 0.0 ? -1.0 : 1.0;
+        rows[r] = true;
+        ++nonZeroCount;
+      }
+      else
+      {
+        return std::nullopt;
+      }
+    }
+
+    if (nonZeroCount != 1u)
+    {
+      return std::nullopt;
+    }
+  }
+
+  return result;
+}
+
 Result<void> Brush::transform(
   const vm::bbox3& worldBounds, const vm::mat4x4& transformation, const bool lockTextures)
 {
+  return transform(
+    worldBounds, TexCoordSystemTransformation{transformation}, lockTextures);
+}
+
+Result<void> Brush::transform(
+  const vm::bbox3& worldBounds,
+  const TexCoordSystemTransformation& transformation,
+  const bool lockTextures)
+{
+  // the faces need their geometry to be transformed, but if the geometry is compact, its
+  // topology can be reused for the transformed geometry
+  auto originalCompactGeometry = m_compactGeometry;
+  expandGeometry();
+
+  const auto axisAlignedTransformation =
+    snapAxisAlignedTransformation(transformation.transformation);
+  const auto transformGeometryInPlace =
+    axisAlignedTransformation
+    && worldBounds.contains(bounds().transform(*axisAlignedTransformation));
+
   for (auto& face : m_faces)
   {
     if (!face.transform(transformation, lockTextures).is_success())
@@ -1186,9 +1475,59 @@ Result<void> Brush::transform(
     }
   }
 
+  if (transformGeometryInPlace)
+  {
+    transformGeometry(*axisAlignedTransformation, std::move(originalCompactGeometry));
+    return kdl::void_success;
+  }
+
   return updateGeometryFromFaces(worldBounds);
 }
 
+void Brush::transformGeometry(
+  const vm::mat4x4& transformation,
+  std::shared_ptr<const CompactGeometry> originalCompactGeometry)
+{
+  auto compact =
+    originalCompactGeometry ? *originalCompactGeometry : createCompactGeometry();
+  vm::transform_points(
+    transformation, compact.vertexPositions.begin(), compact.vertexPositions.end());
+  for (auto& position : compact.vertexPositions)
+  {
+    position = vm::correct(position);
+  }
+  compact.bounds =
+    vm::bbox3::merge_all(compact.vertexPositions.begin(), compact.vertexPositions.end());
+
+  for (size_t i = 0u; i < m_faces.size(); ++i)
+  {
+    compact.facePlanes[i] = m_faces[i].boundary();
+  }
+
+  // a flip inverts the orientation of the faces
+  if (vm::compute_determinant(vm::strip_translation(transformation)) < 0.0)
+  {
+    auto topology = *compact.topology;
+    for (size_t i = 0u; i < m_faces.size(); ++i)
+    {
+      const auto begin = topology.faceVertexIndices.begin();
+      std::reverse(
+        std::next(begin, long(topology.faceOffsets[i])),
+        std::next(begin, long(topology.faceOffsets[i + 1u])));
+    }
+    compact.topology = std::make_shared<const CompactTopology>(std::move(topology));
+  }
+
+  // the transformed geometry is only expanded when it is needed
+  for (auto& face : m_faces)
+  {
+    face.setGeometry(nullptr);
+  }
+
+  m_geometry.reset();
+  m_compactGeometry = std::make_shared<const CompactGeometry>(std::move(compact));
+}
+
 bool Brush::contains(const vm::bbox3& bounds) const
 {
   if (!this->bounds().contains(bounds))
@@ -1209,6 +1548,8 @@ bool Brush::contains(const vm::bbox3& bounds) const
 
 bool Brush::contains(const Brush& brush) const
 {
+  expandGeometry();
+  brush.expandGeometry();
   return m_geometry->contains(*brush.m_geometry);
 }
 
@@ -1219,6 +1560,8 @@ bool Brush::intersects(const vm::bbox3& bounds) const
 
 bool Brush::intersects(const Brush& brush) const
 {
+  expandGeometry();
+  brush.expandGeometry();
   return m_geometry->intersects(*brush.m_geometry);
 }
 
@@ -1261,7 +1604,7 @@ Result<Brush> Brush::createBrush(
 Brush Brush::convertToParaxial() const
 {
   Brush result(*this);
-  for (auto& face : result.m_faces)
+  for (auto& face : result.faces())
   {
     face.convertToParaxial();
   }
@@ -1271,13 +1614,57 @@ Brush Brush::convertToParaxial() const
 Brush Brush::convertToParallel() const
 {
   Brush result(*this);
-  for (auto& face : result.m_faces)
+  for (auto& face : result.faces())
   {
     face.convertToParallel();
   }
   return result;
 }
 
+size_t Brush::memoryUsage() const
+{
+  return sizeof(Brush) + faceMemoryUsage() + geometryMemoryUsage();
+}
+
+size_t Brush::faceMemoryUsage() const
+{
+  auto result = m_faces.capacity() * sizeof(BrushFace);
+  for (const auto& face : m_faces)
+  {
+    result += face.attributes().textureName().capacity();
+  }
+  return result;
+}
+
+size_t Brush::geometryMemoryUsage() const
+{
+  auto result = size_t(0);
+  if (m_geometry)
+  {
+    const auto geometryUsage = sizeof(BrushGeometry)
+                               + m_geometry->vertexCount() * sizeof(BrushVertex)
+                               + m_geometry->edgeCount() * sizeof(BrushEdge)
+                               + m_geometry->edgeCount() * 2u * sizeof(BrushHalfEdge)
+                               + m_geometry->faceCount() * sizeof(BrushFaceGeometry);
+    result += geometryUsage / size_t(m_geometry.use_count());
+  }
+  else if (m_compactGeometry)
+  {
+    const auto geometryUsage =
+      sizeof(CompactGeometry)
+      + m_compactGeometry->vertexPositions.capacity() * sizeof(vm::vec3)
+      + m_compactGeometry->facePlanes.capacity() * sizeof(vm::plane3);
+    result += geometryUsage / size_t(m_compactGeometry.use_count());
+
+    const auto& topology = m_compactGeometry->topology;
+    const auto topologyUsage = sizeof(CompactTopology)
+                               + topology->faceVertexIndices.capacity() * sizeof(size_t)
+                               + topology->faceOffsets.capacity() * sizeof(size_t);
+    result += topologyUsage / size_t(topology.use_count());
+  }
+  return result;
+}
+
 bool Brush::checkFaceLinks() const
 {
   if (faceCount() != m_geometry->faceCount())
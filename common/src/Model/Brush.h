@@ -27,6 +27,7 @@
 #include "kdl/reflection_decl.h"
 
 #include "vm/forward.h"
+#include "vm/vec.h"
 
 #include <memory>
 #include <optional>
@@ -39,11 +40,13 @@ template <typename P>
 class PolyhedronMatcher;
 
 enum class MapFormat;
+struct TexCoordSystemTransformation;
 
 class Brush
 {
 private:
-  class CopyCallback;
+  struct CompactTopology;
+  struct CompactGeometry;
 
   /**
    * Epsilon value to use when finding a vertex after applying a vertex operation
@@ -56,7 +59,19 @@ public:
 
 private:
   std::vector<BrushFace> m_faces;
-  std::unique_ptr<BrushGeometry> m_geometry;
+
+  /**
+   * At most one of these is set. The geometry is compacted by compactGeometry and
+   * transform and expanded again on demand by const member functions, hence these are
+   * mutable.
+   *
+   * Copies of a brush share its geometry, so copying a brush to change only its face
+   * attributes does not copy the geometry. A geometry is never modified once it has been
+   * assigned to a brush. Every operation that changes the geometry of a brush replaces it
+   * with a new one.
+   */
+  mutable std::shared_ptr<BrushGeometry> m_geometry;
+  mutable std::shared_ptr<const CompactGeometry> m_compactGeometry;
 
   kdl_reflect_decl(Brush, m_faces);
 
@@ -73,6 +88,16 @@ public:
 
   static Result<Brush> create(const vm::bbox3& worldBounds, std::vector<BrushFace> faces);
 
+  /**
+   * Creates a brush from the given faces and a geometry that was previously computed
+   * for them, e.g. by a call to create. The faces of the geometry must correspond to the
+   * given faces in order.
+   *
+   * Returns an error if the number of faces does not match.
+   */
+  static Result<Brush> createFromGeometry(
+    std::vector<BrushFace> faces, std::unique_ptr<BrushGeometry> geometry);
+
 private:
   explicit Brush(std::vector<BrushFace> faces);
 
@@ -81,6 +106,39 @@ private:
 public:
   const vm::bbox3& bounds() const;
 
+  /**
+   * Replaces the half edge geometry of this brush with a flat form that only stores the
+   * vertex positions and the vertex indices of each face. This reduces the memory used by
+   * brushes that are kept around without being used, e.g. in the undo history.
+   *
+   * The half edge geometry is rebuilt when it is needed again, e.g. when the faces of
+   * this brush are accessed, so compacting a brush does not change its behavior. Since
+   * the geometry is rebuilt by const member functions, a compacted brush must not be
+   * accessed by multiple threads concurrently.
+   */
+  void compactGeometry();
+  bool hasCompactGeometry() const;
+
+  /**
+   * Indicates whether this brush shares its geometry with the given brush.
+   */
+  bool sharesGeometryWith(const Brush& other) const;
+
+  /**
+   * Returns a copy of this brush whose geometry is compacted, even if the geometry of
+   * this brush is shared with other brushes.
+   *
+   * Transforming a brush with compact geometry keeps its geometry compact, and the
+   * transformed brush shares the topology of the compact geometry with the original. This
+   * is useful if many transformed copies of a brush are created, such as when updating
+   * linked groups, because the copies only materialize their geometry when it is needed.
+   */
+  Brush compactCopy() const;
+
+private:
+  CompactGeometry createCompactGeometry() const;
+  void expandGeometry() const;
+
 public: // face management:
   std::optional<size_t> findFace(const std::string& textureName) const;
   std::optional<size_t> findFace(const vm::vec3& normal) const;
@@ -166,6 +224,30 @@ public:
 
   std::vector<const BrushFace*> incidentFaces(const BrushVertex* vertex) const;
 
+  /**
+   * A vertex, edge or face move that was validated by one of the prepareMove* functions,
+   * together with the geometry that results from it. Applying it with applyVertexMove
+   * doesn't have to compute the geometry again.
+   *
+   * A prepared move is only valid for the brush that prepared it and only as long as that
+   * brush is not modified.
+   */
+  struct VertexMove
+  {
+    std::vector<vm::vec3> vertexPositions;
+    vm::vec3 delta;
+    std::unique_ptr<BrushGeometry> geometry;
+
+    VertexMove(
+      std::vector<vm::vec3> vertexPositions,
+      const vm::vec3& delta,
+      std::unique_ptr<BrushGeometry> geometry);
+    ~VertexMove();
+
+    VertexMove(VertexMove&& other) noexcept;
+    VertexMove& operator=(VertexMove&& other) noexcept;
+  };
+
   // vertex operations
   bool canMoveVertices(
     const vm::bbox3& worldBounds,
@@ -177,6 +259,21 @@ public:
     const vm::vec3& delta,
     bool uvLock = false);
 
+  /**
+   * Checks whether the given vertices can be moved by the given delta and returns the
+   * resulting move, or an error that describes why the move is not possible.
+   */
+  Result<VertexMove> prepareMoveVertices(
+    const vm::bbox3& worldBounds,
+    const std::vector<vm::vec3>& vertexPositions,
+    const vm::vec3& delta) const;
+
+  /**
+   * Applies a move that was prepared by this brush, see VertexMove.
+   */
+  Result<void> applyVertexMove(
+    const vm::bbox3& worldBounds, const VertexMove& move, bool uvLock = false);
+
   bool canAddVertex(const vm::bbox3& worldBounds, const vm::vec3& position) const;
   Result<void> addVertex(const vm::bbox3& worldBounds, const vm::vec3& position);
 
@@ -200,6 +297,14 @@ public:
     const vm::vec3& delta,
     bool uvLock = false);
 
+  /**
+   * Like prepareMoveVertices, but the given edges must be preserved by the move.
+   */
+  Result<VertexMove> prepareMoveEdges(
+    const vm::bbox3& worldBounds,
+    const std::vector<vm::segment3>& edgePositions,
+    const vm::vec3& delta) const;
+
   // face operations
   bool canMoveFaces(
     const vm::bbox3& worldBounds,
@@ -211,31 +316,20 @@ public:
     const vm::vec3& delta,
     bool uvLock = false);
 
-private:
-  struct CanMoveVerticesResult
-  {
-  public:
-    bool success;
-    std::unique_ptr<BrushGeometry> geometry;
-
-  private:
-    CanMoveVerticesResult(bool s, BrushGeometry&& g);
-
-  public:
-    static CanMoveVerticesResult rejectVertexMove();
-    static CanMoveVerticesResult acceptVertexMove(BrushGeometry&& result);
-  };
+  /**
+   * Like prepareMoveVertices, but the given faces must be preserved by the move.
+   */
+  Result<VertexMove> prepareMoveFaces(
+    const vm::bbox3& worldBounds,
+    const std::vector<vm::polygon3>& facePositions,
+    const vm::vec3& delta) const;
 
-  CanMoveVerticesResult doCanMoveVertices(
+private:
+  Result<VertexMove> doPrepareMoveVertices(
     const vm::bbox3& worldBounds,
     const std::vector<vm::vec3>& vertexPositions,
     vm::vec3 delta,
     bool allowVertexRemoval) const;
-  Result<void> doMoveVertices(
-    const vm::bbox3& worldBounds,
-    const std::vector<vm::vec3>& vertexPositions,
-    const vm::vec3& delta,
-    bool lockTexture);
   /**
    * Tries to find 3 vertices in `left` and `right` that are related according to the
    * PolyhedronMatcher, and generates an affine transform for them which can then be used
@@ -319,6 +413,10 @@ public:
   /**
    * Applies the given transformation to this brush.
    *
+   * If the transformation only consists of 90 degree rotations, flips and a translation,
+   * the vertices of the brush geometry are transformed directly. Otherwise, the geometry
+   * is rebuilt from the transformed faces.
+   *
    * If the brush becomes invalid, an error is returned.
    *
    * @param worldBounds the world bounds
@@ -329,6 +427,20 @@ public:
   Result<void> transform(
     const vm::bbox3& worldBounds, const vm::mat4x4& transformation, bool lockTextures);
 
+  /**
+   * Applies the given transformation to this brush. Use this overload to share the values
+   * derived from the transformation when transforming many brushes with it.
+   */
+  Result<void> transform(
+    const vm::bbox3& worldBounds,
+    const TexCoordSystemTransformation& transformation,
+    bool lockTextures);
+
+private:
+  void transformGeometry(
+    const vm::mat4x4& transformation,
+    std::shared_ptr<const CompactGeometry> originalCompactGeometry);
+
 public:
   bool contains(const vm::bbox3& bounds) const;
   bool contains(const Brush& brush) const;
@@ -359,6 +471,25 @@ public: // texture format conversion
   Brush convertToParaxial() const;
   Brush convertToParallel() const;
 
+public:
+  /**
+   * Returns an estimate of the memory used by this brush in bytes. A geometry that is
+   * shared with other brushes is divided evenly among them.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns an estimate of the memory used by the faces of this brush and their
+   * attributes in bytes.
+   */
+  size_t faceMemoryUsage() const;
+
+  /**
+   * Returns an estimate of the memory used by the geometry of this brush in bytes, see
+   * memoryUsage().
+   */
+  size_t geometryMemoryUsage() const;
+
 private:
   bool checkFaceLinks() const;
 };
@@ -48,6 +48,7 @@
 #include "vm/vec.h"
 #include "vm/vec_io.h"
 
+#include <functional>
 #include <sstream>
 #include <string>
 
@@ -71,7 +72,7 @@ BrushFace::BrushFace(const BrushFace& other)
   , m_boundary(other.m_boundary)
   , m_attributes(other.m_attributes)
   , m_textureReference(other.m_textureReference)
-  , m_texCoordSystem(other.m_texCoordSystem ? other.m_texCoordSystem->clone() : nullptr)
+  , m_texCoordSystem(other.m_texCoordSystem)
   , m_geometry(nullptr)
   , m_lineNumber(other.m_lineNumber)
   , m_lineCount(other.m_lineCount)
@@ -135,14 +136,13 @@ Result<BrushFace> BrushFace::create(
              point1,
              point2,
              attributes,
-             std::make_unique<ParallelTexCoordSystem>(point0, point1, point2, attributes))
+             ParallelTexCoordSystem{point0, point1, point2, attributes})
            : BrushFace::create(
              point0,
              point1,
              point2,
              attributes,
-             std::make_unique<ParaxialTexCoordSystem>(
-               point0, point1, point2, attributes));
+             ParaxialTexCoordSystem{point0, point1, point2, attributes});
 }
 
 Result<BrushFace> BrushFace::createFromStandard(
@@ -154,24 +154,21 @@ Result<BrushFace> BrushFace::createFromStandard(
 {
   assert(mapFormat != MapFormat::Unknown);
 
-  std::unique_ptr<TexCoordSystem> texCoordSystem;
-  BrushFaceAttributes attribs("");
-
   if (Model::isParallelTexCoordSystem(mapFormat))
   {
     // Convert paraxial to parallel
-    std::tie(texCoordSystem, attribs) =
+    auto [texCoordSystem, attribs] =
       ParallelTexCoordSystem::fromParaxial(point0, point1, point2, inputAttribs);
-  }
-  else
-  {
-    // Pass through paraxial
-    texCoordSystem =
-      std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, inputAttribs);
-    attribs = inputAttribs;
+    return BrushFace::create(point0, point1, point2, attribs, std::move(texCoordSystem));
   }
 
-  return BrushFace::create(point0, point1, point2, attribs, std::move(texCoordSystem));
+  // Pass through paraxial
+  return BrushFace::create(
+    point0,
+    point1,
+    point2,
+    inputAttribs,
+    ParaxialTexCoordSystem{point0, point1, point2, inputAttribs});
 }
 
 Result<BrushFace> BrushFace::createFromValve(
@@ -185,22 +182,16 @@ Result<BrushFace> BrushFace::createFromValve(
 {
   assert(mapFormat != MapFormat::Unknown);
 
-  std::unique_ptr<TexCoordSystem> texCoordSystem;
-  BrushFaceAttributes attribs("");
-
   if (Model::isParallelTexCoordSystem(mapFormat))
   {
     // Pass through parallel
-    texCoordSystem = std::make_unique<ParallelTexCoordSystem>(texAxisX, texAxisY);
-    attribs = inputAttribs;
-  }
-  else
-  {
-    // Convert parallel to paraxial
-    std::tie(texCoordSystem, attribs) = ParaxialTexCoordSystem::fromParallel(
-      point1, point2, point3, inputAttribs, texAxisX, texAxisY);
+    return BrushFace::create(
+      point1, point2, point3, inputAttribs, ParallelTexCoordSystem{texAxisX, texAxisY});
   }
 
+  // Convert parallel to paraxial
+  auto [texCoordSystem, attribs] = ParaxialTexCoordSystem::fromParallel(
+    point1, point2, point3, inputAttribs, texAxisX, texAxisY);
   return BrushFace::create(point1, point2, point3, attribs, std::move(texCoordSystem));
 }
 
@@ -209,7 +200,7 @@ Result<BrushFace> BrushFace::create(
   const vm::vec3& point1,
   const vm::vec3& point2,
   const BrushFaceAttributes& attributes,
-  std::unique_ptr<TexCoordSystem> texCoordSystem)
+  TexCoordSystemVariant texCoordSystem)
 {
   Points points = {{vm::correct(point0), vm::correct(point1), vm::correct(point2)}};
   const auto [result, plane] = vm::from_points(points[0], points[1], points[2]);
@@ -227,7 +218,7 @@ BrushFace::BrushFace(
   const BrushFace::Points& points,
   const vm::plane3& boundary,
   const BrushFaceAttributes& attributes,
-  std::unique_ptr<TexCoordSystem> texCoordSystem)
+  TexCoordSystemVariant texCoordSystem)
   : m_points(points)
   , m_boundary(boundary)
   , m_attributes(attributes)
@@ -238,7 +229,6 @@ BrushFace::BrushFace(
   , m_selected(false)
   , m_markedToRenderFace(false)
 {
-  ensure(m_texCoordSystem != nullptr, "texCoordSystem is null");
 }
 
 void BrushFace::sortFaces(std::vector<BrushFace>& faces)
@@ -271,13 +261,13 @@ void BrushFace::sortFaces(std::vector<BrushFace>& faces)
 
 std::unique_ptr<TexCoordSystemSnapshot> BrushFace::takeTexCoordSystemSnapshot() const
 {
-  return m_texCoordSystem->takeSnapshot();
+  return texCoordSystem().takeSnapshot();
 }
 
 void BrushFace::restoreTexCoordSystemSnapshot(
   const TexCoordSystemSnapshot& coordSystemSnapshot)
 {
-  coordSystemSnapshot.restore(*m_texCoordSystem);
+  coordSystemSnapshot.restore(mutableTexCoordSystem());
 }
 
 void BrushFace::copyTexCoordSystemFromFace(
@@ -291,14 +281,14 @@ void BrushFace::copyTexCoordSystemFromFace(
   const auto seam = vm::intersect_plane_plane(sourceFacePlane, m_boundary);
   const auto refPoint = vm::project_point(seam, center());
 
-  coordSystemSnapshot.restore(*m_texCoordSystem);
+  coordSystemSnapshot.restore(mutableTexCoordSystem());
 
   // Get the texcoords at the refPoint using the source face's attributes and tex coord
   // system
   const auto desriedCoords =
-    m_texCoordSystem->getTexCoords(refPoint, attributes, vm::vec2f::one());
+    texCoordSystem().getTexCoords(refPoint, attributes, vm::vec2f::one());
 
-  m_texCoordSystem->updateNormal(
+  mutableTexCoordSystem().updateNormal(
     sourceFacePlane.normal, m_boundary.normal, m_attributes, wrapStyle);
 
   // Adjust the offset on this face so that the texture coordinates at the refPoint stay
@@ -306,7 +296,7 @@ void BrushFace::copyTexCoordSystemFromFace(
   if (!vm::is_zero(seam.direction, vm::C::almost_zero()))
   {
     const auto currentCoords =
-      m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+      texCoordSystem().getTexCoords(refPoint, m_attributes, vm::vec2f::one());
     const auto offsetChange = desriedCoords - currentCoords;
     m_attributes.setOffset(correct(modOffset(m_attributes.offset() + offsetChange), 4));
   }
@@ -423,7 +413,8 @@ void BrushFace::setAttributes(const BrushFaceAttributes& attributes)
 {
   const float oldRotation = m_attributes.rotation();
   m_attributes = attributes;
-  m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
+  mutableTexCoordSystem().setRotation(
+    m_boundary.normal, oldRotation, m_attributes.rotation());
 }
 
 bool BrushFace::setAttributes(const BrushFace& other)
@@ -496,15 +487,21 @@ Color BrushFace::resolvedColor() const
 
 void BrushFace::resetTexCoordSystemCache()
 {
-  if (m_texCoordSystem != nullptr)
-  {
-    m_texCoordSystem->resetCache(m_points[0], m_points[1], m_points[2], m_attributes);
-  }
+  mutableTexCoordSystem().resetCache(m_points[0], m_points[1], m_points[2], m_attributes);
 }
 
 const TexCoordSystem& BrushFace::texCoordSystem() const
 {
-  return *m_texCoordSystem;
+  return std::visit(
+    [](const auto& texCoordSystem) -> const TexCoordSystem& { return texCoordSystem; },
+    m_texCoordSystem);
+}
+
+TexCoordSystem& BrushFace::mutableTexCoordSystem()
+{
+  return std::visit(
+    [](auto& texCoordSystem) -> TexCoordSystem& { return texCoordSystem; },
+    m_texCoordSystem);
 }
 
 const Assets::Texture* BrushFace::texture() const
@@ -542,58 +539,70 @@ bool BrushFace::setTexture(Assets::Texture* texture)
 
 vm::vec3 BrushFace::textureXAxis() const
 {
-  return m_texCoordSystem->xAxis();
+  return texCoordSystem().xAxis();
 }
 
 vm::vec3 BrushFace::textureYAxis() const
 {
-  return m_texCoordSystem->yAxis();
+  return texCoordSystem().yAxis();
 }
 
 void BrushFace::resetTextureAxes()
 {
-  m_texCoordSystem->resetTextureAxes(m_boundary.normal);
+  mutableTexCoordSystem().resetTextureAxes(m_boundary.normal);
 }
 
 void BrushFace::resetTextureAxesToParaxial()
 {
-  m_texCoordSystem->resetTextureAxesToParaxial(m_boundary.normal, 0.0f);
+  mutableTexCoordSystem().resetTextureAxesToParaxial(m_boundary.normal, 0.0f);
 }
 
 void BrushFace::convertToParaxial()
 {
-  auto [newTexCoordSystem, newAttributes] =
-    m_texCoordSystem->toParaxial(m_points[0], m_points[1], m_points[2], m_attributes);
+  if (const auto* parallel = std::get_if<ParallelTexCoordSystem>(&m_texCoordSystem))
+  {
+    auto [newTexCoordSystem, newAttributes] = ParaxialTexCoordSystem::fromParallel(
+      m_points[0],
+      m_points[1],
+      m_points[2],
+      m_attributes,
+      parallel->xAxis(),
+      parallel->yAxis());
 
-  m_attributes = newAttributes;
-  m_texCoordSystem = std::move(newTexCoordSystem);
+    m_attributes = newAttributes;
+    m_texCoordSystem = std::move(newTexCoordSystem);
+  }
 }
 
 void BrushFace::convertToParallel()
 {
-  auto [newTexCoordSystem, newAttributes] =
-    m_texCoordSystem->toParallel(m_points[0], m_points[1], m_points[2], m_attributes);
+  if (std::holds_alternative<ParaxialTexCoordSystem>(m_texCoordSystem))
+  {
+    auto [newTexCoordSystem, newAttributes] = ParallelTexCoordSystem::fromParaxial(
+      m_points[0], m_points[1], m_points[2], m_attributes);
 
-  m_attributes = newAttributes;
-  m_texCoordSystem = std::move(newTexCoordSystem);
+    m_attributes = newAttributes;
+    m_texCoordSystem = std::move(newTexCoordSystem);
+  }
 }
 
 void BrushFace::moveTexture(
   const vm::vec3& up, const vm::vec3& right, const vm::vec2f& offset)
 {
-  m_texCoordSystem->moveTexture(m_boundary.normal, up, right, offset, m_attributes);
+  texCoordSystem().moveTexture(m_boundary.normal, up, right, offset, m_attributes);
 }
 
 void BrushFace::rotateTexture(const float angle)
 {
   const float oldRotation = m_attributes.rotation();
-  m_texCoordSystem->rotateTexture(m_boundary.normal, angle, m_attributes);
-  m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
+  texCoordSystem().rotateTexture(m_boundary.normal, angle, m_attributes);
+  mutableTexCoordSystem().setRotation(
+    m_boundary.normal, oldRotation, m_attributes.rotation());
 }
 
 void BrushFace::shearTexture(const vm::vec2f& factors)
 {
-  m_texCoordSystem->shearTexture(m_boundary.normal, factors);
+  mutableTexCoordSystem().shearTexture(m_boundary.normal, factors);
 }
 
 void BrushFace::flipTexture(
@@ -602,7 +611,7 @@ void BrushFace::flipTexture(
   const vm::direction cameraRelativeFlipDirection)
 {
   const vm::mat4x4 texToWorld =
-    m_texCoordSystem->fromMatrix(vm::vec2f::zero(), vm::vec2f::one());
+    texCoordSystem().fromMatrix(vm::vec2f::zero(), vm::vec2f::one());
 
   const vm::vec3 texUAxisInWorld =
     vm::normalize((texToWorld * vm::vec4d(1, 0, 0, 0)).xyz());
@@ -643,17 +652,20 @@ void BrushFace::flipTexture(
 }
 
 Result<void> BrushFace::transform(const vm::mat4x4& transform, const bool lockTexture)
+{
+  return this->transform(TexCoordSystemTransformation{transform}, lockTexture);
+}
+
+Result<void> BrushFace::transform(
+  const TexCoordSystemTransformation& transform, const bool lockTexture)
 {
   using std::swap;
 
   const vm::vec3 invariant = m_geometry != nullptr ? center() : m_boundary.anchor();
   const vm::plane3 oldBoundary = m_boundary;
 
-  m_boundary = m_boundary.transform(transform);
-  for (size_t i = 0; i < 3; ++i)
-  {
-    m_points[i] = transform * m_points[i];
-  }
+  m_boundary = m_boundary.transform(transform.transformation);
+  m_points = transform.transformation * m_points;
 
   if (
     dot(cross(m_points[2] - m_points[0], m_points[1] - m_points[0]), m_boundary.normal)
@@ -663,7 +675,7 @@ Result<void> BrushFace::transform(const vm::mat4x4& transform, const bool lockTe
   }
 
   return setPoints(m_points[0], m_points[1], m_points[2]).transform([&]() {
-    m_texCoordSystem->transform(
+    mutableTexCoordSystem().transform(
       oldBoundary,
       m_boundary,
       transform,
@@ -703,15 +715,15 @@ Result<void> BrushFace::updatePointsFromVertices()
         // Get the texcoords at the refPoint using the old face's attribs and tex coord
         // system
         const auto desriedCoords =
-          m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+          texCoordSystem().getTexCoords(refPoint, m_attributes, vm::vec2f::one());
 
-        m_texCoordSystem->updateNormal(
+        mutableTexCoordSystem().updateNormal(
           oldPlane.normal, m_boundary.normal, m_attributes, WrapStyle::Projection);
 
         // Adjust the offset on this face so that the texture coordinates at the refPoint
         // stay the same
         const auto currentCoords =
-          m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+          texCoordSystem().getTexCoords(refPoint, m_attributes, vm::vec2f::one());
         const auto offsetChange = desriedCoords - currentCoords;
         m_attributes.setOffset(
           correct(modOffset(m_attributes.offset() + offsetChange), 4));
@@ -722,7 +734,7 @@ Result<void> BrushFace::updatePointsFromVertices()
 vm::mat4x4 BrushFace::projectToBoundaryMatrix() const
 {
   const auto texZAxis =
-    m_texCoordSystem->fromMatrix(vm::vec2f::zero(), vm::vec2f::one()) * vm::vec3::pos_z();
+    texCoordSystem().fromMatrix(vm::vec2f::zero(), vm::vec2f::one()) * vm::vec3::pos_z();
   const auto worldToPlaneMatrix =
     vm::plane_projection_matrix(m_boundary.distance, m_boundary.normal, texZAxis);
   const auto [invertible, planeToWorldMatrix] = vm::invert(worldToPlaneMatrix);
@@ -736,11 +748,11 @@ vm::mat4x4 BrushFace::toTexCoordSystemMatrix(
 {
   if (project)
   {
-    return vm::mat4x4::zero_out<2>() * m_texCoordSystem->toMatrix(offset, scale);
+    return vm::mat4x4::zero_out<2>() * texCoordSystem().toMatrix(offset, scale);
   }
   else
   {
-    return m_texCoordSystem->toMatrix(offset, scale);
+    return texCoordSystem().toMatrix(offset, scale);
   }
 }
 
@@ -749,18 +761,18 @@ vm::mat4x4 BrushFace::fromTexCoordSystemMatrix(
 {
   if (project)
   {
-    return projectToBoundaryMatrix() * m_texCoordSystem->fromMatrix(offset, scale);
+    return projectToBoundaryMatrix() * texCoordSystem().fromMatrix(offset, scale);
   }
   else
   {
-    return m_texCoordSystem->fromMatrix(offset, scale);
+    return texCoordSystem().fromMatrix(offset, scale);
   }
 }
 
 float BrushFace::measureTextureAngle(
   const vm::vec2f& center, const vm::vec2f& point) const
 {
-  return m_texCoordSystem->measureAngle(m_attributes.rotation(), center, point);
+  return texCoordSystem().measureAngle(m_attributes.rotation(), center, point);
 }
 
 size_t BrushFace::vertexCount() const
@@ -839,7 +851,13 @@ void BrushFace::deselect()
 
 vm::vec2f BrushFace::textureCoords(const vm::vec3& point) const
 {
-  return m_texCoordSystem->getTexCoords(point, m_attributes, textureSize());
+  return texCoordSystem().getTexCoords(point, m_attributes, textureSize());
+}
+
+void BrushFace::textureCoords(
+  const std::vector<vm::vec3>& points, std::vector<vm::vec2f>& texCoords) const
+{
+  texCoordSystem().getTexCoords(points, m_attributes, textureSize(), texCoords);
 }
 
 FloatType BrushFace::intersectWithRay(const vm::ray3& ray) const
@@ -909,4 +927,21 @@ void BrushFace::doAcceptTagVisitor(ConstTagVisitor& visitor) const
 {
   visitor.visit(*this);
 }
+
+size_t BrushFace::doGetTagInputHash(const TagMatcherInput::Type input) const
+{
+  switch (input)
+  {
+  case TagMatcherInput::TextureName:
+    return std::hash<std::string>{}(m_attributes.textureName());
+  case TagMatcherInput::Texture:
+    return std::hash<const Assets::Texture*>{}(texture());
+  case TagMatcherInput::ContentFlags:
+    return std::hash<int>{}(resolvedSurfaceContents());
+  case TagMatcherInput::SurfaceFlags:
+    return std::hash<int>{}(resolvedSurfaceFlags());
+  default:
+    return 0;
+  }
+}
 } // namespace TrenchBroom::Model
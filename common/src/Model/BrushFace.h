@@ -24,6 +24,8 @@
 #include "Macros.h"
 #include "Model/BrushFaceAttributes.h"
 #include "Model/BrushGeometry.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
 #include "Model/Tag.h" // BrushFace inherits from Taggable
 #include "Result.h"
 
@@ -37,6 +39,7 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom::Assets
@@ -46,8 +49,6 @@ class Texture;
 
 namespace TrenchBroom::Model
 {
-class TexCoordSystem;
-class TexCoordSystemSnapshot;
 enum class WrapStyle;
 enum class MapFormat;
 
@@ -66,6 +67,12 @@ public:
    */
   using Points = std::array<vm::vec3, 3u>;
 
+  /**
+   * The texture coordinate system is stored inline to avoid an allocation per face.
+   */
+  using TexCoordSystemVariant =
+    std::variant<ParaxialTexCoordSystem, ParallelTexCoordSystem>;
+
 private:
   /**
    * For use in VertexList transformation below.
@@ -93,7 +100,7 @@ private:
   BrushFaceAttributes m_attributes;
 
   Assets::AssetReference<Assets::Texture> m_textureReference;
-  std::unique_ptr<TexCoordSystem> m_texCoordSystem;
+  TexCoordSystemVariant m_texCoordSystem;
   BrushFaceGeometry* m_geometry;
 
   mutable size_t m_lineNumber;
@@ -169,13 +176,13 @@ public:
     const vm::vec3& point1,
     const vm::vec3& point2,
     const BrushFaceAttributes& attributes,
-    std::unique_ptr<TexCoordSystem> texCoordSystem);
+    TexCoordSystemVariant texCoordSystem);
 
   BrushFace(
     const BrushFace::Points& points,
     const vm::plane3& boundary,
     const BrushFaceAttributes& attributes,
-    std::unique_ptr<TexCoordSystem> texCoordSystem);
+    TexCoordSystemVariant texCoordSystem);
 
   static void sortFaces(std::vector<BrushFace>& faces);
 
@@ -208,6 +215,11 @@ public:
   void resetTexCoordSystemCache();
   const TexCoordSystem& texCoordSystem() const;
 
+private:
+  TexCoordSystem& mutableTexCoordSystem();
+
+public:
+
   const Assets::Texture* texture() const;
   vm::vec2f textureSize() const;
   vm::vec2f modOffset(const vm::vec2f& offset) const;
@@ -231,6 +243,7 @@ public:
     vm::direction cameraRelativeFlipDirection);
 
   Result<void> transform(const vm::mat4x4& transform, bool lockTexture);
+  Result<void> transform(const TexCoordSystemTransformation& transform, bool lockTexture);
   void invert();
 
   Result<void> updatePointsFromVertices();
@@ -264,6 +277,13 @@ public:
 
   vm::vec2f textureCoords(const vm::vec3& point) const;
 
+  /**
+   * Computes the texture coordinates of the given points and appends them to the given
+   * vector. Prefer this over calling textureCoords for each vertex of a face.
+   */
+  void textureCoords(
+    const std::vector<vm::vec3>& points, std::vector<vm::vec2f>& texCoords) const;
+
   FloatType intersectWithRay(const vm::ray3& ray) const;
 
 private:
@@ -284,6 +304,7 @@ public: // brush renderer
 private: // implement Taggable interface
   void doAcceptTagVisitor(TagVisitor& visitor) override;
   void doAcceptTagVisitor(ConstTagVisitor& visitor) const override;
+  size_t doGetTagInputHash(TagMatcherInput::Type input) const override;
 };
 
 } // namespace TrenchBroom::Model
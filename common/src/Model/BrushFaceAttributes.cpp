@@ -173,13 +173,14 @@ bool BrushFaceAttributes::valid() const
 
 bool BrushFaceAttributes::setTextureName(const std::string& textureName)
 {
-  if (textureName == m_textureName)
+  auto internedTextureName = kdl::interned_string{textureName};
+  if (internedTextureName == m_textureName)
   {
     return false;
   }
   else
   {
-    m_textureName = textureName;
+    m_textureName = internedTextureName;
     return true;
   }
 }
@@ -21,6 +21,7 @@
 
 #include "Color.h"
 
+#include "kdl/interned_string.h"
 #include "kdl/reflection_decl.h"
 
 #include "vm/forward.h"
@@ -45,7 +46,8 @@ public:
   static const std::string NoTextureName;
 
 private:
-  std::string m_textureName;
+  // many faces share a texture name, so it is stored only once
+  kdl::interned_string m_textureName;
 
   vm::vec2f m_offset;
   vm::vec2f m_scale;
@@ -26,6 +26,7 @@
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceHandle.h"
+#include "Model/ContentHasher.h"
 #include "Model/BrushGeometry.h"
 #include "Model/EditorContext.h"
 #include "Model/EntityNode.h"
@@ -58,9 +59,11 @@
 #include "vm/vec_ext.h"
 
 #include <algorithm> // for std::remove
+#include <functional>
 #include <iterator>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
@@ -71,7 +74,7 @@ const HitType::Type BrushNode::BrushHitType = HitType::freeType();
 
 BrushNode::BrushNode(Brush brush)
   : m_brushRendererBrushCache(std::make_unique<Renderer::BrushRendererBrushCache>())
-  , m_brush(std::move(brush))
+  , m_brush(std::make_shared<Brush>(std::move(brush)))
 {
   clearSelectedFaces();
 }
@@ -106,6 +109,14 @@ EntityNodeBase* BrushNode::entity()
 
 const Brush& BrushNode::brush() const
 {
+  return *m_brush;
+}
+
+std::shared_ptr<const Brush> BrushNode::sharedBrush() const
+{
+  // expand a compacted geometry now because a compacted brush must not be accessed by
+  // multiple threads
+  m_brush->faces();
   return m_brush;
 }
 
@@ -114,14 +125,16 @@ Brush BrushNode::setBrush(Brush brush)
   const auto nodeChange = NotifyNodeChange{*this};
   const auto boundsChange = NotifyPhysicalBoundsChange{*this};
 
-  using std::swap;
-  swap(m_brush, brush);
+  removeTexturesFromIndex();
 
+  auto oldBrush = std::exchange(m_brush, std::make_shared<Brush>(std::move(brush)));
+
+  addTexturesToIndex();
   updateSelectedFaceCount();
   invalidateIssues();
   invalidateVertexCache();
 
-  return brush;
+  return oldBrush.use_count() == 1 ? std::move(*oldBrush) : *oldBrush;
 }
 
 bool BrushNode::hasSelectedFaces() const
@@ -131,27 +144,33 @@ bool BrushNode::hasSelectedFaces() const
 
 void BrushNode::selectFace(const size_t faceIndex)
 {
-  m_brush.face(faceIndex).select();
+  mutableBrush().face(faceIndex).select();
   ++m_selectedFaceCount;
 }
 
 void BrushNode::deselectFace(const size_t faceIndex)
 {
-  m_brush.face(faceIndex).deselect();
+  mutableBrush().face(faceIndex).deselect();
   --m_selectedFaceCount;
 }
 
 void BrushNode::updateFaceTags(const size_t faceIndex, TagManager& tagManager)
 {
-  m_brush.face(faceIndex).updateTags(tagManager);
+  mutableBrush().face(faceIndex).updateTags(tagManager);
 }
 
 void BrushNode::setFaceTexture(const size_t faceIndex, Assets::Texture* texture)
 {
-  m_brush.face(faceIndex).setTexture(texture);
+  auto& face = mutableBrush().face(faceIndex);
+  removeTextureFromIndex(this, face.texture());
+  face.setTexture(texture);
+  addTextureToIndex(this, face.texture());
 
   invalidateIssues();
   invalidateVertexCache();
+  // the resolved surface attributes depend on the texture
+  invalidateSerializedNode();
+  invalidateContentHash();
 }
 
 static bool containsPatch(const Brush& brush, const PatchGrid& grid)
@@ -177,10 +196,10 @@ bool BrushNode::contains(const Node* node) const
   return node->accept(kdl::overload(
     [](const WorldNode*) { return false; },
     [](const LayerNode*) { return false; },
-    [&](const GroupNode* group) { return m_brush.contains(group->logicalBounds()); },
-    [&](const EntityNode* entity) { return m_brush.contains(entity->logicalBounds()); },
-    [&](const BrushNode* brush) { return m_brush.contains(brush->brush()); },
-    [&](const PatchNode* patch) { return containsPatch(m_brush, patch->grid()); }));
+    [&](const GroupNode* group) { return m_brush->contains(group->logicalBounds()); },
+    [&](const EntityNode* entity) { return m_brush->contains(entity->logicalBounds()); },
+    [&](const BrushNode* brush) { return m_brush->contains(brush->brush()); },
+    [&](const PatchNode* patch) { return containsPatch(*m_brush, patch->grid()); }));
 }
 
 static bool faceIntersectsEdge(
@@ -251,15 +270,17 @@ bool BrushNode::intersects(const Node* node) const
   return node->accept(kdl::overload(
     [](const WorldNode*) { return false; },
     [](const LayerNode*) { return false; },
-    [&](const GroupNode* group) { return m_brush.intersects(group->logicalBounds()); },
-    [&](const EntityNode* entity) { return m_brush.intersects(entity->logicalBounds()); },
-    [&](const BrushNode* brush) { return m_brush.intersects(brush->brush()); },
-    [&](const PatchNode* patch) { return intersectsPatch(m_brush, patch->grid()); }));
+    [&](const GroupNode* group) { return m_brush->intersects(group->logicalBounds()); },
+    [&](const EntityNode* entity) {
+      return m_brush->intersects(entity->logicalBounds());
+    },
+    [&](const BrushNode* brush) { return m_brush->intersects(brush->brush()); },
+    [&](const PatchNode* patch) { return intersectsPatch(*m_brush, patch->grid()); }));
 }
 
 void BrushNode::clearSelectedFaces()
 {
-  for (BrushFace& face : m_brush.faces())
+  for (BrushFace& face : mutableBrush().faces())
   {
     if (face.selected())
     {
@@ -272,7 +293,7 @@ void BrushNode::clearSelectedFaces()
 void BrushNode::updateSelectedFaceCount()
 {
   m_selectedFaceCount = 0u;
-  for (const BrushFace& face : m_brush.faces())
+  for (const BrushFace& face : m_brush->faces())
   {
     if (face.selected())
     {
@@ -281,6 +302,33 @@ void BrushNode::updateSelectedFaceCount()
   }
 }
 
+Brush& BrushNode::mutableBrush()
+{
+  if (m_brush.use_count() > 1)
+  {
+    m_brush = std::make_shared<Brush>(*m_brush);
+    // the vertex cache refers to the faces of the previous brush
+    invalidateVertexCache();
+  }
+  return *m_brush;
+}
+
+void BrushNode::addTexturesToIndex()
+{
+  for (const auto& face : m_brush->faces())
+  {
+    addTextureToIndex(this, face.texture());
+  }
+}
+
+void BrushNode::removeTexturesFromIndex()
+{
+  for (const auto& face : m_brush->faces())
+  {
+    removeTextureFromIndex(this, face.texture());
+  }
+}
+
 const std::string& BrushNode::doGetName() const
 {
   static const std::string name("brush");
@@ -289,7 +337,7 @@ const std::string& BrushNode::doGetName() const
 
 const vm::bbox3& BrushNode::doGetLogicalBounds() const
 {
-  return m_brush.bounds();
+  return m_brush->bounds();
 }
 
 const vm::bbox3& BrushNode::doGetPhysicalBounds() const
@@ -302,7 +350,7 @@ FloatType BrushNode::doGetProjectedArea(const vm::axis::type axis) const
   const auto normal = vm::vec3::axis(axis);
 
   auto result = static_cast<FloatType>(0);
-  for (const auto& face : m_brush.faces())
+  for (const auto& face : m_brush->faces())
   {
     // only consider one side of the brush -- doesn't matter which one!
     if (vm::dot(face.boundary().normal, normal) > 0.0)
@@ -317,7 +365,7 @@ FloatType BrushNode::doGetProjectedArea(const vm::axis::type axis) const
 Node* BrushNode::doClone(
   const vm::bbox3& /* worldBounds */, const SetLinkId setLinkIds) const
 {
-  auto result = std::make_unique<BrushNode>(m_brush);
+  auto result = std::make_unique<BrushNode>(*m_brush);
   result->cloneLinkId(*this, setLinkIds);
   cloneAttributes(result.get());
   return result.release();
@@ -348,6 +396,52 @@ bool BrushNode::doSelectable() const
   return true;
 }
 
+std::uint64_t BrushNode::doGetContentHash() const
+{
+  auto hasher = ContentHasher{};
+  hasher.add(std::uint64_t(m_brush->faceCount()));
+  for (const auto& face : m_brush->faces())
+  {
+    const auto& attributes = face.attributes();
+    for (const auto& point : face.points())
+    {
+      hasher.add(point);
+    }
+    hasher.add(attributes.textureName())
+      .add(attributes.offset())
+      .add(attributes.rotation())
+      .add(attributes.scale())
+      .add(face.textureXAxis())
+      .add(face.textureYAxis());
+
+    // the resolved attributes depend on the texture
+    hasher.add(attributes.hasSurfaceAttributes());
+    if (attributes.hasSurfaceAttributes())
+    {
+      hasher.add(face.resolvedSurfaceContents())
+        .add(face.resolvedSurfaceFlags())
+        .add(face.resolvedSurfaceValue());
+    }
+    hasher.add(attributes.hasColor());
+    if (attributes.hasColor())
+    {
+      hasher.add(face.resolvedColor());
+    }
+  }
+  hasher.add(linkId());
+  return hasher.hash();
+}
+
+void BrushNode::doAncestorWillChange()
+{
+  removeTexturesFromIndex();
+}
+
+void BrushNode::doAncestorDidChange()
+{
+  addTexturesToIndex();
+}
+
 void BrushNode::doAccept(NodeVisitor& visitor)
 {
   visitor.visit(this);
@@ -376,7 +470,7 @@ void BrushNode::doPick(
 
 void BrushNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result)
 {
-  if (m_brush.containsPoint(point))
+  if (m_brush->containsPoint(point))
   {
     result.push_back(this);
   }
@@ -387,14 +481,15 @@ std::optional<std::tuple<FloatType, size_t>> BrushNode::findFaceHit(
 {
   if (!vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds())))
   {
-    for (size_t i = 0u; i < m_brush.faceCount(); ++i)
+    // since brushes are convex, the ray hits the face through which it enters the brush
+    const auto& faces = m_brush->faces();
+    const auto [distance, face] = vm::intersect_ray_convex_polyhedron(
+      ray, faces.begin(), faces.end(), [](const auto& f) -> const vm::plane3& {
+        return f.boundary();
+      });
+    if (!vm::is_nan(distance))
     {
-      const auto& face = m_brush.face(i);
-      const auto distance = face.intersectWithRay(ray);
-      if (!vm::is_nan(distance))
-      {
-        return std::make_tuple(distance, i);
-      }
+      return std::make_tuple(distance, size_t(std::distance(faces.begin(), face)));
     }
   }
   return std::nullopt;
@@ -415,6 +510,11 @@ GroupNode* BrushNode::doGetContainingGroup()
   return findContainingGroup(this);
 }
 
+void BrushNode::doLinkIdDidChange()
+{
+  invalidateContentHash();
+}
+
 void BrushNode::invalidateVertexCache()
 {
   m_brushRendererBrushCache->invalidateVertexCache();
@@ -428,7 +528,7 @@ Renderer::BrushRendererBrushCache& BrushNode::brushRendererBrushCache() const
 void BrushNode::initializeTags(TagManager& tagManager)
 {
   Taggable::initializeTags(tagManager);
-  for (auto& face : m_brush.faces())
+  for (auto& face : mutableBrush().faces())
   {
     face.initializeTags(tagManager);
   }
@@ -436,7 +536,7 @@ void BrushNode::initializeTags(TagManager& tagManager)
 
 void BrushNode::clearTags()
 {
-  for (auto& face : m_brush.faces())
+  for (auto& face : mutableBrush().faces())
   {
     face.clearTags();
   }
@@ -445,7 +545,7 @@ void BrushNode::clearTags()
 
 void BrushNode::updateTags(TagManager& tagManager)
 {
-  for (auto& face : m_brush.faces())
+  for (auto& face : mutableBrush().faces())
   {
     face.updateTags(tagManager);
   }
@@ -458,7 +558,7 @@ bool BrushNode::allFacesHaveAnyTagInMask(TagType::Type tagMask) const
   // when a face changes.
 
   TagType::Type sharedFaceTags = TagType::AnyType; // set all bits to 1
-  for (const auto& face : m_brush.faces())
+  for (const auto& face : m_brush->faces())
   {
     sharedFaceTags &= face.tagMask();
   }
@@ -467,7 +567,7 @@ bool BrushNode::allFacesHaveAnyTagInMask(TagType::Type tagMask) const
 
 bool BrushNode::anyFaceHasAnyTag() const
 {
-  for (const auto& face : m_brush.faces())
+  for (const auto& face : m_brush->faces())
   {
     if (face.hasAnyTag())
     {
@@ -482,7 +582,7 @@ bool BrushNode::anyFacesHaveAnyTagInMask(TagType::Type tagMask) const
   // Possible optimization: Store the shared face tag mask in the brush and updated it
   // when a face changes.
 
-  for (const auto& face : m_brush.faces())
+  for (const auto& face : m_brush->faces())
   {
     if (face.hasTag(tagMask))
     {
@@ -502,6 +602,18 @@ void BrushNode::doAcceptTagVisitor(ConstTagVisitor& visitor) const
   visitor.visit(*this);
 }
 
+size_t BrushNode::doGetTagInputHash(const TagMatcherInput::Type input) const
+{
+  if (input == TagMatcherInput::Classname)
+  {
+    if (const auto* entityNode = entity())
+    {
+      return std::hash<std::string>{}(entityNode->entity().classname());
+    }
+  }
+  return 0;
+}
+
 bool operator==(const BrushNode& lhs, const BrushNode& rhs)
 {
   return lhs.brush() == rhs.brush();
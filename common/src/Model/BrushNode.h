@@ -69,7 +69,9 @@ public:
 private:
   mutable std::unique_ptr<Renderer::BrushRendererBrushCache>
     m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
-  Brush m_brush;               // must be destroyed before the brush renderer cache
+  // must be destroyed before the brush renderer cache; shared with snapshots and copied
+  // before it is modified if it is shared
+  std::shared_ptr<Brush> m_brush;
   size_t m_selectedFaceCount = 0u;
 
 public:
@@ -81,6 +83,13 @@ public:
   const EntityNodeBase* entity() const;
 
   const Brush& brush() const;
+
+  /**
+   * Returns the brush of this node for sharing it with a snapshot. The shared brush is
+   * never modified by this node.
+   */
+  std::shared_ptr<const Brush> sharedBrush() const;
+
   Brush setBrush(Brush brush);
 
   bool hasSelectedFaces() const;
@@ -97,6 +106,10 @@ public:
 private:
   void clearSelectedFaces();
   void updateSelectedFaceCount();
+  Brush& mutableBrush();
+
+  void addTexturesToIndex();
+  void removeTexturesFromIndex();
 
 private: // implement Node interface
   const std::string& doGetName() const override;
@@ -115,6 +128,11 @@ private: // implement Node interface
 
   bool doSelectable() const override;
 
+  std::uint64_t doGetContentHash() const override;
+
+  void doAncestorWillChange() override;
+  void doAncestorDidChange() override;
+
   void doAccept(NodeVisitor& visitor) override;
   void doAccept(ConstNodeVisitor& visitor) const override;
 
@@ -130,6 +148,7 @@ private: // implement Object interface
   Node* doGetContainer() override;
   LayerNode* doGetContainingLayer() override;
   GroupNode* doGetContainingGroup() override;
+  void doLinkIdDidChange() override;
 
 public: // renderer cache
   /**
@@ -170,6 +189,7 @@ public:
 private:
   void doAcceptTagVisitor(TagVisitor& visitor) override;
   void doAcceptTagVisitor(ConstTagVisitor& visitor) const override;
+  size_t doGetTagInputHash(TagMatcherInput::Type input) const override;
 
 private:
   deleteCopyAndMove(BrushNode);
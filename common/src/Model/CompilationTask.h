@@ -34,8 +34,9 @@ struct CompilationExportMap
 {
   bool enabled;
   std::string targetSpec;
+  bool concurrent = false;
 
-  kdl_reflect_decl(CompilationExportMap, enabled, targetSpec);
+  kdl_reflect_decl(CompilationExportMap, enabled, targetSpec, concurrent);
 };
 
 struct CompilationCopyFiles
@@ -43,8 +44,9 @@ struct CompilationCopyFiles
   bool enabled;
   std::string sourceSpec;
   std::string targetSpec;
+  bool concurrent = false;
 
-  kdl_reflect_decl(CompilationCopyFiles, enabled, sourceSpec, targetSpec);
+  kdl_reflect_decl(CompilationCopyFiles, enabled, sourceSpec, targetSpec, concurrent);
 };
 
 struct CompilationRenameFile
@@ -52,16 +54,18 @@ struct CompilationRenameFile
   bool enabled;
   std::string sourceSpec;
   std::string targetSpec;
+  bool concurrent = false;
 
-  kdl_reflect_decl(CompilationRenameFile, enabled, sourceSpec, targetSpec);
+  kdl_reflect_decl(CompilationRenameFile, enabled, sourceSpec, targetSpec, concurrent);
 };
 
 struct CompilationDeleteFiles
 {
   bool enabled;
   std::string targetSpec;
+  bool concurrent = false;
 
-  kdl_reflect_decl(CompilationDeleteFiles, enabled, targetSpec);
+  kdl_reflect_decl(CompilationDeleteFiles, enabled, targetSpec, concurrent);
 };
 
 struct CompilationRunTool
@@ -70,11 +74,23 @@ struct CompilationRunTool
   std::string toolSpec;
   std::string parameterSpec;
   bool treatNonZeroResultCodeAsError;
+  bool concurrent = false;
 
   kdl_reflect_decl(
-    CompilationRunTool, enabled, toolSpec, parameterSpec, treatNonZeroResultCodeAsError);
+    CompilationRunTool,
+    enabled,
+    toolSpec,
+    parameterSpec,
+    treatNonZeroResultCodeAsError,
+    concurrent);
 };
 
+/**
+ * A compilation task waits for the preceding task to finish before it starts, unless it
+ * is marked as concurrent. Consecutive concurrent tasks are started together with the
+ * preceding task, and the next task that is not concurrent waits until all of them are
+ * finished.
+ */
 using CompilationTask = std::variant<
   CompilationExportMap,
   CompilationCopyFiles,
@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ContentHasher.h"
+
+#include <cstring>
+
+namespace TrenchBroom::Model
+{
+
+ContentHasher& ContentHasher::add(const float value)
+{
+  auto bits = std::uint32_t(0);
+  std::memcpy(&bits, &value, sizeof(bits));
+  addBytes(bits, sizeof(bits));
+  return *this;
+}
+
+ContentHasher& ContentHasher::add(const double value)
+{
+  auto bits = std::uint64_t(0);
+  std::memcpy(&bits, &value, sizeof(bits));
+  addBytes(bits, sizeof(bits));
+  return *this;
+}
+
+ContentHasher& ContentHasher::add(const std::string_view str)
+{
+  add(std::uint64_t(str.size()));
+  for (const auto c : str)
+  {
+    addBytes(static_cast<unsigned char>(c), 1);
+  }
+  return *this;
+}
+
+std::uint64_t ContentHasher::hash() const
+{
+  return m_hash;
+}
+
+void ContentHasher::addBytes(std::uint64_t bits, const std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    m_hash ^= bits & 0xffu;
+    m_hash *= 1099511628211ull;
+    bits >>= 8;
+  }
+}
+
+} // namespace TrenchBroom::Model
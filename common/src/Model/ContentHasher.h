@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/vec.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace TrenchBroom::Model
+{
+
+/**
+ * Computes a 64 bit FNV-1a hash of a sequence of values. Numbers are hashed by their
+ * little endian binary representation and strings are prefixed with their length, so
+ * the result does not depend on the platform and can be stored in files.
+ */
+class ContentHasher
+{
+private:
+  std::uint64_t m_hash = 14695981039346656037ull;
+
+public:
+  template <typename T>
+  std::enable_if_t<std::is_integral_v<T>, ContentHasher&> add(const T value)
+  {
+    addBytes(static_cast<std::uint64_t>(value), sizeof(T));
+    return *this;
+  }
+
+  ContentHasher& add(float value);
+  ContentHasher& add(double value);
+  ContentHasher& add(std::string_view str);
+
+  ContentHasher& add(const char* str) { return add(std::string_view{str}); }
+
+  template <typename T, std::size_t S>
+  ContentHasher& add(const vm::vec<T, S>& vec)
+  {
+    for (std::size_t i = 0; i < S; ++i)
+    {
+      add(vec[i]);
+    }
+    return *this;
+  }
+
+  template <typename T>
+  ContentHasher& add(const std::optional<T>& value)
+  {
+    add(value.has_value());
+    if (value)
+    {
+      add(*value);
+    }
+    return *this;
+  }
+
+  std::uint64_t hash() const;
+
+private:
+  void addBytes(std::uint64_t bits, std::size_t count);
+};
+
+} // namespace TrenchBroom::Model
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DefaultValidators.h"
+
+#include "Model/EmptyBrushEntityValidator.h"
+#include "Model/EmptyGroupValidator.h"
+#include "Model/EmptyPropertyKeyValidator.h"
+#include "Model/EmptyPropertyValueValidator.h"
+#include "Model/Game.h"
+#include "Model/InvalidTextureScaleValidator.h"
+#include "Model/LinkSourceValidator.h"
+#include "Model/LinkTargetValidator.h"
+#include "Model/LongPropertyKeyValidator.h"
+#include "Model/LongPropertyValueValidator.h"
+#include "Model/MissingClassnameValidator.h"
+#include "Model/MissingDefinitionValidator.h"
+#include "Model/MissingModValidator.h"
+#include "Model/MixedBrushContentsValidator.h"
+#include "Model/NonIntegerVerticesValidator.h"
+#include "Model/PointEntityWithBrushesValidator.h"
+#include "Model/PropertyKeyWithDoubleQuotationMarksValidator.h"
+#include "Model/PropertyValueWithDoubleQuotationMarksValidator.h"
+#include "Model/SoftMapBoundsValidator.h"
+#include "Model/WorldBoundsValidator.h"
+#include "Model/WorldNode.h"
+
+namespace TrenchBroom::Model
+{
+
+void registerDefaultValidators(
+  WorldNode& world, std::shared_ptr<Game> game, const vm::bbox3& worldBounds)
+{
+  world.registerValidator(std::make_unique<MissingClassnameValidator>());
+  world.registerValidator(std::make_unique<MissingDefinitionValidator>());
+  world.registerValidator(std::make_unique<MissingModValidator>(game));
+  world.registerValidator(std::make_unique<EmptyGroupValidator>());
+  world.registerValidator(std::make_unique<EmptyBrushEntityValidator>());
+  world.registerValidator(std::make_unique<PointEntityWithBrushesValidator>());
+  world.registerValidator(std::make_unique<LinkSourceValidator>());
+  world.registerValidator(std::make_unique<LinkTargetValidator>());
+  world.registerValidator(std::make_unique<NonIntegerVerticesValidator>());
+  world.registerValidator(std::make_unique<MixedBrushContentsValidator>());
+  world.registerValidator(std::make_unique<WorldBoundsValidator>(worldBounds));
+  world.registerValidator(std::make_unique<SoftMapBoundsValidator>(game, world));
+  world.registerValidator(std::make_unique<EmptyPropertyKeyValidator>());
+  world.registerValidator(std::make_unique<EmptyPropertyValueValidator>());
+  world.registerValidator(
+    std::make_unique<LongPropertyKeyValidator>(game->maxPropertyLength()));
+  world.registerValidator(
+    std::make_unique<LongPropertyValueValidator>(game->maxPropertyLength()));
+  world.registerValidator(
+    std::make_unique<PropertyKeyWithDoubleQuotationMarksValidator>());
+  world.registerValidator(
+    std::make_unique<PropertyValueWithDoubleQuotationMarksValidator>());
+  world.registerValidator(std::make_unique<InvalidTextureScaleValidator>());
+}
+
+} // namespace TrenchBroom::Model
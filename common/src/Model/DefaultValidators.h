@@ -0,0 +1,39 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+
+#include "vm/bbox.h"
+
+#include <memory>
+
+namespace TrenchBroom::Model
+{
+class Game;
+class WorldNode;
+
+/**
+ * Registers the validators that check the maps of the given game with the given world.
+ */
+void registerDefaultValidators(
+  WorldNode& world, std::shared_ptr<Game> game, const vm::bbox3& worldBounds);
+
+} // namespace TrenchBroom::Model
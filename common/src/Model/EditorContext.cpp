@@ -34,10 +34,24 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 
+#include <atomic>
+
 namespace TrenchBroom
 {
 namespace Model
 {
+namespace
+{
+// every flag is followed by a flag that indicates whether its value is cached
+constexpr uint8_t VisibleFlag = 1u << 0;
+constexpr uint8_t EditableFlag = 1u << 2;
+constexpr uint8_t SelectableFlag = 1u << 4;
+
+// shared by all editor contexts so that a node's cache can't be mistaken as valid for
+// another editor context
+std::atomic<size_t> nextGeneration = 1;
+} // namespace
+
 EditorContext::EditorContext()
 {
   reset();
@@ -49,6 +63,7 @@ void EditorContext::reset()
   m_hiddenEntityDefinitions.reset();
   m_blockSelection = false;
   m_currentGroup = nullptr;
+  invalidateCachedState();
 }
 
 TagType::Type EditorContext::hiddenTags() const
@@ -61,6 +76,7 @@ void EditorContext::setHiddenTags(const TagType::Type hiddenTags)
   if (hiddenTags != m_hiddenTags)
   {
     m_hiddenTags = hiddenTags;
+    invalidateCachedState();
     editorContextDidChangeNotifier();
   }
 }
@@ -83,6 +99,7 @@ void EditorContext::setEntityDefinitionHidden(
   if (definition != nullptr && entityDefinitionHidden(definition) != hidden)
   {
     m_hiddenEntityDefinitions[definition->index()] = hidden;
+    invalidateCachedState();
     editorContextDidChangeNotifier();
   }
 }
@@ -101,6 +118,11 @@ void EditorContext::setBlockSelection(const bool blockSelection)
   }
 }
 
+void EditorContext::invalidateCachedState()
+{
+  m_generation = nextGeneration++;
+}
+
 Model::GroupNode* EditorContext::currentGroup() const
 {
   return m_currentGroup;
@@ -117,6 +139,7 @@ void EditorContext::pushGroup(Model::GroupNode* groupNode)
   }
   m_currentGroup = groupNode;
   m_currentGroup->open();
+  invalidateCachedState();
 }
 
 void EditorContext::popGroup()
@@ -128,6 +151,7 @@ void EditorContext::popGroup()
   {
     m_currentGroup->open();
   }
+  invalidateCachedState();
 }
 
 bool EditorContext::visible(const Model::Node* node) const
@@ -152,6 +176,32 @@ bool EditorContext::visible(const Model::LayerNode* layerNode) const
 }
 
 bool EditorContext::visible(const Model::GroupNode* groupNode) const
+{
+  return cached(groupNode, VisibleFlag, [&]() { return computeVisible(groupNode); });
+}
+
+bool EditorContext::visible(const Model::EntityNode* entityNode) const
+{
+  return cached(entityNode, VisibleFlag, [&]() { return computeVisible(entityNode); });
+}
+
+bool EditorContext::visible(const Model::BrushNode* brushNode) const
+{
+  return cached(brushNode, VisibleFlag, [&]() { return computeVisible(brushNode); });
+}
+
+bool EditorContext::visible(
+  const Model::BrushNode* brushNode, const Model::BrushFace& face) const
+{
+  return visible(brushNode) && !face.hasTag(m_hiddenTags);
+}
+
+bool EditorContext::visible(const Model::PatchNode* patchNode) const
+{
+  return cached(patchNode, VisibleFlag, [&]() { return computeVisible(patchNode); });
+}
+
+bool EditorContext::computeVisible(const Model::GroupNode* groupNode) const
 {
   if (groupNode->selected())
   {
@@ -164,7 +214,7 @@ bool EditorContext::visible(const Model::GroupNode* groupNode) const
   return groupNode->visible();
 }
 
-bool EditorContext::visible(const Model::EntityNode* entityNode) const
+bool EditorContext::computeVisible(const Model::EntityNode* entityNode) const
 {
   if (entityNode->selected())
   {
@@ -198,7 +248,7 @@ bool EditorContext::visible(const Model::EntityNode* entityNode) const
   return true;
 }
 
-bool EditorContext::visible(const Model::BrushNode* brushNode) const
+bool EditorContext::computeVisible(const Model::BrushNode* brushNode) const
 {
   if (brushNode->selected())
   {
@@ -228,13 +278,7 @@ bool EditorContext::visible(const Model::BrushNode* brushNode) const
   return brushNode->visible();
 }
 
-bool EditorContext::visible(
-  const Model::BrushNode* brushNode, const Model::BrushFace& face) const
-{
-  return visible(brushNode) && !face.hasTag(m_hiddenTags);
-}
-
-bool EditorContext::visible(const Model::PatchNode* patchNode) const
+bool EditorContext::computeVisible(const Model::PatchNode* patchNode) const
 {
   if (patchNode->selected())
   {
@@ -259,7 +303,7 @@ bool EditorContext::anyChildVisible(const Model::Node* node) const
 
 bool EditorContext::editable(const Model::Node* node) const
 {
-  return node->editable();
+  return cached(node, EditableFlag, [&]() { return node->editable(); });
 }
 
 bool EditorContext::editable(
@@ -291,19 +335,25 @@ bool EditorContext::selectable(const Model::LayerNode*) const
 
 bool EditorContext::selectable(const Model::GroupNode* groupNode) const
 {
-  return visible(groupNode) && editable(groupNode) && !groupNode->opened()
-         && inOpenGroup(groupNode);
+  return cached(groupNode, SelectableFlag, [&]() {
+    return visible(groupNode) && editable(groupNode) && !groupNode->opened()
+           && inOpenGroup(groupNode);
+  });
 }
 
 bool EditorContext::selectable(const Model::EntityNode* entityNode) const
 {
-  return visible(entityNode) && editable(entityNode) && !entityNode->hasChildren()
-         && inOpenGroup(entityNode);
+  return cached(entityNode, SelectableFlag, [&]() {
+    return visible(entityNode) && editable(entityNode) && !entityNode->hasChildren()
+           && inOpenGroup(entityNode);
+  });
 }
 
 bool EditorContext::selectable(const Model::BrushNode* brushNode) const
 {
-  return visible(brushNode) && editable(brushNode) && inOpenGroup(brushNode);
+  return cached(brushNode, SelectableFlag, [&]() {
+    return visible(brushNode) && editable(brushNode) && inOpenGroup(brushNode);
+  });
 }
 
 bool EditorContext::selectable(
@@ -314,7 +364,9 @@ bool EditorContext::selectable(
 
 bool EditorContext::selectable(const Model::PatchNode* patchNode) const
 {
-  return visible(patchNode) && editable(patchNode) && inOpenGroup(patchNode);
+  return cached(patchNode, SelectableFlag, [&]() {
+    return visible(patchNode) && editable(patchNode) && inOpenGroup(patchNode);
+  });
 }
 
 bool EditorContext::canChangeSelection() const
@@ -326,5 +378,28 @@ bool EditorContext::inOpenGroup(const Model::Object* object) const
 {
   return object->containingGroupOpened();
 }
+
+template <typename F>
+bool EditorContext::cached(
+  const Model::Node* node, const uint8_t flag, const F& compute) const
+{
+  const auto cachedFlag = uint8_t(flag << 1);
+
+  auto& cache = node->editorContextCache();
+  if (cache.generation != m_generation)
+  {
+    cache.generation = m_generation;
+    cache.flags = 0;
+  }
+
+  if ((cache.flags & cachedFlag) == 0)
+  {
+    const auto value = compute();
+    cache.flags |= cachedFlag | (value ? flag : uint8_t(0));
+    return value;
+  }
+
+  return (cache.flags & flag) != 0;
+}
 } // namespace Model
 } // namespace TrenchBroom
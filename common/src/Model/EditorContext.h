@@ -24,6 +24,9 @@
 
 #include "kdl/bitset.h"
 
+#include <cstddef>
+#include <cstdint>
+
 namespace TrenchBroom
 {
 namespace Assets
@@ -44,6 +47,15 @@ class Object;
 class PatchNode;
 class WorldNode;
 
+/**
+ * Decides which nodes are visible, editable and selectable.
+ *
+ * The results for nodes are cached in the nodes themselves and remain valid until the
+ * cached state is invalidated. This happens automatically when the settings of this
+ * editor context change, but the owner of this editor context must call
+ * invalidateCachedState whenever the nodes change in a way that could affect their
+ * visibility, editability or selectability.
+ */
 class EditorContext
 {
 private:
@@ -54,6 +66,8 @@ private:
 
   Model::GroupNode* m_currentGroup;
 
+  size_t m_generation;
+
 public:
   Notifier<> editorContextDidChangeNotifier;
 
@@ -72,6 +86,11 @@ public:
   bool blockSelection() const;
   void setBlockSelection(bool blockSelection);
 
+  /**
+   * Discards the cached visibility, editability and selectability of all nodes.
+   */
+  void invalidateCachedState();
+
 public:
   Model::GroupNode* currentGroup() const;
   void pushGroup(Model::GroupNode* groupNode);
@@ -88,6 +107,10 @@ public:
   bool visible(const Model::PatchNode* patchNode) const;
 
 private:
+  bool computeVisible(const Model::GroupNode* groupNode) const;
+  bool computeVisible(const Model::EntityNode* entityNode) const;
+  bool computeVisible(const Model::BrushNode* brushNode) const;
+  bool computeVisible(const Model::PatchNode* patchNode) const;
   bool anyChildVisible(const Model::Node* node) const;
 
 public:
@@ -106,6 +129,10 @@ public:
   bool canChangeSelection() const;
   bool inOpenGroup(const Model::Object* object) const;
 
+private:
+  template <typename F>
+  bool cached(const Model::Node* node, uint8_t flag, const F& compute) const;
+
 private:
   EditorContext(const EditorContext&);
   EditorContext& operator=(const EditorContext&);
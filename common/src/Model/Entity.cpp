@@ -106,6 +106,20 @@ Entity& Entity::operator=(Entity&& other) = default;
 
 Entity::~Entity() = default;
 
+size_t Entity::memoryUsage() const
+{
+  auto result = sizeof(Entity) + m_properties.capacity() * sizeof(EntityProperty);
+  for (const auto& property : m_properties)
+  {
+    // interned keys and values are shared with other entities
+    if (!property.hasInternedValue())
+    {
+      result += property.value().capacity();
+    }
+  }
+  return result;
+}
+
 void Entity::setProperties(
   const EntityPropertyConfig& propertyConfig, std::vector<EntityProperty> properties)
 {
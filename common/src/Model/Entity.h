@@ -134,6 +134,11 @@ public:
 
   ~Entity();
 
+  /**
+   * Returns an estimate of the memory used by this entity in bytes.
+   */
+  size_t memoryUsage() const;
+
 public: // property management
   const std::vector<EntityProperty>& properties() const;
   void setProperties(
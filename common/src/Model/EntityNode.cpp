@@ -22,6 +22,7 @@
 #include "Assets/EntityDefinition.h"
 #include "Assets/EntityModel.h"
 #include "Model/BrushNode.h"
+#include "Model/ContentHasher.h"
 #include "Model/EditorContext.h"
 #include "Model/EntityPropertiesVariableStore.h"
 #include "Model/LinkedGroupUtils.h"
@@ -73,8 +74,8 @@ const vm::bbox3& EntityNode::modelBounds() const
 
 void EntityNode::setModelFrame(const Assets::EntityModelFrame* modelFrame)
 {
-  m_entity.setModel(entityPropertyConfig(), modelFrame);
-  nodePhysicalBoundsDidChange();
+  mutableEntity().setModel(entityPropertyConfig(), modelFrame);
+  nodePhysicalBoundsDidChange(cachedBounds());
 }
 
 const vm::bbox3& EntityNode::doGetLogicalBounds() const
@@ -108,7 +109,7 @@ FloatType EntityNode::doGetProjectedArea(const vm::axis::type axis) const
 Node* EntityNode::doClone(
   const vm::bbox3& /* worldBounds */, const SetLinkId setLinkIds) const
 {
-  auto result = std::make_unique<EntityNode>(m_entity);
+  auto result = std::make_unique<EntityNode>(entity());
   result->cloneLinkId(*this, setLinkIds);
   cloneAttributes(result.get());
   return result.release();
@@ -142,14 +143,14 @@ bool EntityNode::doShouldAddToSpacialIndex() const
 
 void EntityNode::doChildWasAdded(Node* /* node */)
 {
-  m_entity.setPointEntity(entityPropertyConfig(), !hasChildren());
-  nodePhysicalBoundsDidChange();
+  mutableEntity().setPointEntity(entityPropertyConfig(), !hasChildren());
+  nodePhysicalBoundsDidChange(cachedBounds());
 }
 
 void EntityNode::doChildWasRemoved(Node* /* node */)
 {
-  m_entity.setPointEntity(entityPropertyConfig(), !hasChildren());
-  nodePhysicalBoundsDidChange();
+  mutableEntity().setPointEntity(entityPropertyConfig(), !hasChildren());
+  nodePhysicalBoundsDidChange(cachedBounds());
 }
 
 void EntityNode::doNodePhysicalBoundsDidChange()
@@ -157,10 +158,28 @@ void EntityNode::doNodePhysicalBoundsDidChange()
   invalidateBounds();
 }
 
-void EntityNode::doChildPhysicalBoundsDidChange()
+void EntityNode::doChildPhysicalBoundsDidChange(
+  Node* node, const std::optional<NodeBounds>& oldChildBounds)
 {
-  invalidateBounds();
-  nodePhysicalBoundsDidChange();
+  const auto oldBounds = cachedBounds();
+  auto newBounds = oldBounds;
+  if (
+    newBounds && oldChildBounds
+    && updateChildBounds(*newBounds, *node, *oldChildBounds))
+  {
+    // only notify the parent if the union of the child bounds has changed
+    if (newBounds != oldBounds)
+    {
+      m_cachedBounds->logicalBounds = newBounds->logicalBounds;
+      m_cachedBounds->physicalBounds = newBounds->physicalBounds;
+      propagatePhysicalBoundsChange(oldBounds);
+    }
+  }
+  else
+  {
+    invalidateBounds();
+    propagatePhysicalBoundsChange(oldBounds);
+  }
 }
 
 bool EntityNode::doSelectable() const
@@ -168,6 +187,14 @@ bool EntityNode::doSelectable() const
   return !hasChildren();
 }
 
+std::uint64_t EntityNode::doGetContentHash() const
+{
+  auto hasher = ContentHasher{};
+  addEntityToHash(hasher);
+  hasher.add(linkId());
+  return hasher.hash();
+}
+
 void EntityNode::doPick(
   const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult)
 {
@@ -186,15 +213,15 @@ void EntityNode::doPick(
     }
 
     // only if the bbox hit test failed do we hit test the model
-    if (m_entity.model() != nullptr)
+    if (entity().model() != nullptr)
     {
       // we transform the ray into the model's space
-      const auto transform = m_entity.modelTransformation();
+      const auto transform = entity().modelTransformation();
       const auto [invertible, inverse] = vm::invert(transform);
       if (invertible)
       {
         const auto transformedRay = vm::ray3f{ray.transform(inverse)};
-        const auto distance = m_entity.model()->intersect(transformedRay);
+        const auto distance = entity().model()->intersect(transformedRay);
         if (!vm::is_nan(distance))
         {
           // transform back to world space
@@ -252,7 +279,7 @@ std::vector<Node*> EntityNode::nodesRequiredForViewSelection()
 
 void EntityNode::doPropertiesDidChange(const vm::bbox3& /* oldBounds */)
 {
-  nodePhysicalBoundsDidChange();
+  nodePhysicalBoundsDidChange(cachedBounds());
 }
 
 vm::vec3 EntityNode::doGetLinkSourceAnchor() const
@@ -280,6 +307,18 @@ GroupNode* EntityNode::doGetContainingGroup()
   return findContainingGroup(this);
 }
 
+void EntityNode::doLinkIdDidChange()
+{
+  invalidateContentHash();
+}
+
+std::optional<NodeBounds> EntityNode::cachedBounds() const
+{
+  return m_cachedBounds ? std::optional{NodeBounds{
+           m_cachedBounds->logicalBounds, m_cachedBounds->physicalBounds}}
+                        : std::nullopt;
+}
+
 void EntityNode::invalidateBounds()
 {
   m_cachedBounds = std::nullopt;
@@ -294,15 +333,15 @@ void EntityNode::validateBounds() const
 
   m_cachedBounds = CachedBounds{};
 
-  const auto hasModel = m_entity.model() != nullptr;
+  const auto hasModel = entity().model() != nullptr;
   if (hasModel)
   {
     m_cachedBounds->modelBounds =
-      vm::bbox3(m_entity.model()->bounds()).transform(m_entity.modelTransformation());
+      vm::bbox3(entity().model()->bounds()).transform(entity().modelTransformation());
   }
   else
   {
-    m_cachedBounds->modelBounds = DefaultBounds.transform(m_entity.modelTransformation());
+    m_cachedBounds->modelBounds = DefaultBounds.transform(entity().modelTransformation());
   }
 
   if (hasChildren())
@@ -313,10 +352,10 @@ void EntityNode::validateBounds() const
   else
   {
     const auto* definition =
-      dynamic_cast<const Assets::PointEntityDefinition*>(m_entity.definition());
+      dynamic_cast<const Assets::PointEntityDefinition*>(entity().definition());
     const auto definitionBounds = definition ? definition->bounds() : DefaultBounds;
 
-    m_cachedBounds->logicalBounds = definitionBounds.translate(m_entity.origin());
+    m_cachedBounds->logicalBounds = definitionBounds.translate(entity().origin());
     if (hasModel)
     {
       m_cachedBounds->physicalBounds =
@@ -90,10 +90,13 @@ private: // implement Node interface
   void doChildWasRemoved(Node* node) override;
 
   void doNodePhysicalBoundsDidChange() override;
-  void doChildPhysicalBoundsDidChange() override;
+  void doChildPhysicalBoundsDidChange(
+    Node* node, const std::optional<NodeBounds>& oldChildBounds) override;
 
   bool doSelectable() const override;
 
+  std::uint64_t doGetContentHash() const override;
+
   void doPick(
     const EditorContext& editorContext,
     const vm::ray3& ray,
@@ -114,8 +117,10 @@ private: // implement Object interface
   Node* doGetContainer() override;
   LayerNode* doGetContainingLayer() override;
   GroupNode* doGetContainingGroup() override;
+  void doLinkIdDidChange() override;
 
 private:
+  std::optional<NodeBounds> cachedBounds() const;
   void invalidateBounds();
   void validateBounds() const;
 
@@ -21,12 +21,17 @@
 
 #include "Assets/EntityDefinition.h"
 #include "Assets/PropertyDefinition.h"
+#include "Model/ContentHasher.h"
 
 #include "kdl/collection_utils.h"
 #include "kdl/invoke.h"
+#include "kdl/parallel.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom::Model
@@ -53,6 +58,18 @@ const auto* select(const std::vector<T*> ts, const Eq& eq = Eq{})
   }
   return result;
 }
+
+/**
+ * Returns pointers to the given properties, sorted by key and value. Sorting pointers
+ * avoids copying the properties.
+ */
+std::vector<const EntityProperty*> sortProperties(
+  const std::vector<EntityProperty>& properties)
+{
+  return kdl::vec_sort(
+    kdl::vec_transform(properties, [](const auto& property) { return &property; }),
+    [](const auto* lhs, const auto* rhs) { return *lhs < *rhs; });
+}
 } // namespace
 
 const Assets::EntityDefinition* selectEntityDefinition(
@@ -91,13 +108,42 @@ std::string selectPropertyValue(
 }
 
 EntityNodeBase::EntityNodeBase(Entity entity)
-  : m_entity{std::move(entity)}
+  : m_entity{std::make_shared<Entity>(std::move(entity))}
+{
+}
+
+void EntityNodeBase::addEntityToHash(ContentHasher& hasher) const
 {
+  hasher.add(std::uint64_t(m_entity->properties().size()));
+  for (const auto& property : m_entity->properties())
+  {
+    hasher.add(property.key()).add(property.value());
+  }
+
+  hasher.add(std::uint64_t(m_entity->protectedProperties().size()));
+  for (const auto& key : m_entity->protectedProperties())
+  {
+    hasher.add(key);
+  }
+}
+
+Entity& EntityNodeBase::mutableEntity()
+{
+  if (m_entity.use_count() > 1)
+  {
+    m_entity = std::make_shared<Entity>(*m_entity);
+  }
+  return *m_entity;
 }
 
 EntityNodeBase::~EntityNodeBase() = default;
 
 const Entity& EntityNodeBase::entity() const
+{
+  return *m_entity;
+}
+
+std::shared_ptr<const Entity> EntityNodeBase::sharedEntity() const
 {
   return m_entity;
 }
@@ -106,20 +152,52 @@ Entity EntityNodeBase::setEntity(Entity entity)
 {
   const auto notifyChange = NotifyPropertyChange{*this};
 
-  auto oldEntity = std::exchange(m_entity, std::move(entity));
-  updateIndexAndLinks(oldEntity.properties());
-  return oldEntity;
+  auto oldEntity = std::exchange(m_entity, std::make_shared<Entity>(std::move(entity)));
+  updateIndexAndLinks(oldEntity->properties());
+  return oldEntity.use_count() == 1 ? std::move(*oldEntity) : *oldEntity;
 }
 
 void EntityNodeBase::setDefinition(Assets::EntityDefinition* definition)
 {
-  if (m_entity.definition() == definition)
+  if (m_entity->definition() == definition)
   {
     return;
   }
 
   const auto notifyChange = NotifyPropertyChange{*this};
-  m_entity.setDefinition(entityPropertyConfig(), definition);
+  mutableEntity().setDefinition(entityPropertyConfig(), definition);
+}
+
+void EntityNodeBase::setDefinitions(
+  const std::vector<std::tuple<EntityNodeBase*, Assets::EntityDefinition*>>&
+    nodesAndDefinitions)
+{
+  // every node must only be changed once because the nodes are changed in parallel
+  auto changedNodes = std::unordered_set<EntityNodeBase*>{};
+  const auto changedNodesAndDefinitions =
+    kdl::vec_filter(nodesAndDefinitions, [&](const auto& nodeAndDefinition) {
+      const auto& [node, definition] = nodeAndDefinition;
+      return node->entity().definition() != definition
+             && changedNodes.insert(node).second;
+    });
+
+  auto notifyChanges = std::vector<std::unique_ptr<NotifyPropertyChange>>{};
+  notifyChanges.reserve(changedNodesAndDefinitions.size());
+  for (const auto& [node, definition] : changedNodesAndDefinitions)
+  {
+    notifyChanges.push_back(std::make_unique<NotifyPropertyChange>(*node));
+  }
+
+  kdl::parallel_for(changedNodesAndDefinitions.size(), [&](const size_t i) {
+    const auto& [node, definition] = changedNodesAndDefinitions[i];
+    node->mutableEntity().setDefinition(node->entityPropertyConfig(), definition);
+  });
+
+  // notifies the nodes in order
+  for (auto& notifyChange : notifyChanges)
+  {
+    notifyChange.reset();
+  }
 }
 
 EntityNodeBase::NotifyPropertyChange::NotifyPropertyChange(EntityNodeBase& node)
@@ -144,40 +222,42 @@ void EntityNodeBase::propertiesDidChange(const vm::bbox3& oldPhysicalBounds)
 
 void EntityNodeBase::updateIndexAndLinks(const std::vector<EntityProperty>& oldProperties)
 {
-  const auto oldSorted = kdl::vec_sort(oldProperties);
-  const auto newSorted = kdl::vec_sort(m_entity.properties());
+  const auto oldSorted = sortProperties(oldProperties);
+  const auto newSorted = sortProperties(m_entity->properties());
 
   updatePropertyIndex(oldSorted, newSorted);
   updateLinks(oldSorted, newSorted);
 }
 
 void EntityNodeBase::updatePropertyIndex(
-  const std::vector<EntityProperty>& oldProperties,
-  const std::vector<EntityProperty>& newProperties)
+  const std::vector<const EntityProperty*>& oldProperties,
+  const std::vector<const EntityProperty*>& newProperties)
 {
   auto oldIt = std::begin(oldProperties);
   auto oldEnd = std::end(oldProperties);
   auto newIt = std::begin(newProperties);
   auto newEnd = std::end(newProperties);
 
+  // only properties whose key or value changed touch the index, and the key index is left
+  // alone if only the value of a property changed
   while (oldIt != oldEnd && newIt != newEnd)
   {
-    const auto& oldProp = *oldIt;
-    const auto& newProp = *newIt;
+    const auto& oldProp = **oldIt;
+    const auto& newProp = **newIt;
 
-    if (oldProp < newProp)
+    if (oldProp.key() < newProp.key())
     {
       removePropertyFromIndex(oldProp.key(), oldProp.value());
       ++oldIt;
     }
-    else if (oldProp > newProp)
+    else if (oldProp.key() > newProp.key())
     {
       addPropertyToIndex(newProp.key(), newProp.value());
       ++newIt;
     }
     else
     {
-      updatePropertyIndex(oldProp.key(), oldProp.value(), newProp.key(), newProp.value());
+      updatePropertyIndex(oldProp.value(), newProp.value());
       ++oldIt;
       ++newIt;
     }
@@ -185,22 +265,22 @@ void EntityNodeBase::updatePropertyIndex(
 
   while (oldIt != oldEnd)
   {
-    const auto& oldProp = *oldIt;
+    const auto& oldProp = **oldIt;
     removePropertyFromIndex(oldProp.key(), oldProp.value());
     ++oldIt;
   }
 
   while (newIt != newEnd)
   {
-    const auto& newProp = *newIt;
+    const auto& newProp = **newIt;
     addPropertyToIndex(newProp.key(), newProp.value());
     ++newIt;
   }
 }
 
 void EntityNodeBase::updateLinks(
-  const std::vector<EntityProperty>& oldProperties,
-  const std::vector<EntityProperty>& newProperties)
+  const std::vector<const EntityProperty*>& oldProperties,
+  const std::vector<const EntityProperty*>& newProperties)
 {
   auto oldIt = std::begin(oldProperties);
   auto oldEnd = std::end(oldProperties);
@@ -209,8 +289,8 @@ void EntityNodeBase::updateLinks(
 
   while (oldIt != oldEnd && newIt != newEnd)
   {
-    const auto& oldProp = *oldIt;
-    const auto& newProp = *newIt;
+    const auto& oldProp = **oldIt;
+    const auto& newProp = **newIt;
 
     if (oldProp.key() < newProp.key())
     {
@@ -232,14 +312,14 @@ void EntityNodeBase::updateLinks(
 
   while (oldIt != oldEnd)
   {
-    const auto& oldProp = *oldIt;
+    const auto& oldProp = **oldIt;
     removeLinks(oldProp.key(), oldProp.value());
     ++oldIt;
   }
 
   while (newIt != newEnd)
   {
-    const auto& newProp = *newIt;
+    const auto& newProp = **newIt;
     addLinks(newProp.key(), newProp.value());
     ++newIt;
   }
@@ -247,7 +327,7 @@ void EntityNodeBase::updateLinks(
 
 void EntityNodeBase::addPropertiesToIndex()
 {
-  for (const auto& property : m_entity.properties())
+  for (const auto& property : m_entity->properties())
   {
     addPropertyToIndex(property.key(), property.value());
   }
@@ -255,7 +335,7 @@ void EntityNodeBase::addPropertiesToIndex()
 
 void EntityNodeBase::removePropertiesFromIndex()
 {
-  for (const auto& property : m_entity.properties())
+  for (const auto& property : m_entity->properties())
   {
     removePropertyFromIndex(property.key(), property.value());
   }
@@ -273,17 +353,12 @@ void EntityNodeBase::removePropertyFromIndex(
 }
 
 void EntityNodeBase::updatePropertyIndex(
-  const std::string& oldKey,
-  const std::string& oldValue,
-  const std::string& newKey,
-  const std::string& newValue)
+  const std::string& oldValue, const std::string& newValue)
 {
-  if (oldKey == newKey && oldValue == newValue)
+  if (oldValue != newValue)
   {
-    return;
+    updateValueInIndex(this, oldValue, newValue);
   }
-  removeFromIndex(this, oldKey, oldValue);
-  addToIndex(this, newKey, newValue);
 }
 
 const std::vector<EntityNodeBase*>& EntityNodeBase::linkSources() const
@@ -319,43 +394,45 @@ vm::vec3 EntityNodeBase::linkTargetAnchor() const
 bool EntityNodeBase::hasMissingSources() const
 {
   return m_linkSources.empty() && m_killSources.empty()
-         && m_entity.hasProperty(EntityPropertyKeys::Targetname);
+         && m_entity->hasProperty(EntityPropertyKeys::Targetname);
 }
 
 std::vector<std::string> EntityNodeBase::findMissingLinkTargets() const
 {
   auto result = std::vector<std::string>{};
-  findMissingTargets(EntityPropertyKeys::Target, result);
+  findMissingTargets(EntityPropertyKeys::Target, m_linkTargets, result);
   return result;
 }
 
 std::vector<std::string> EntityNodeBase::findMissingKillTargets() const
 {
   auto result = std::vector<std::string>{};
-  findMissingTargets(EntityPropertyKeys::Killtarget, result);
+  findMissingTargets(EntityPropertyKeys::Killtarget, m_killTargets, result);
   return result;
 }
 
 void EntityNodeBase::findMissingTargets(
-  const std::string& prefix, std::vector<std::string>& result) const
+  const std::string& prefix,
+  const std::vector<EntityNodeBase*>& targets,
+  std::vector<std::string>& result) const
 {
-  for (const auto& property : m_entity.numberedProperties(prefix))
+  // the targets are kept up to date with the target properties, so a target is missing
+  // exactly if none of them has a matching targetname
+  for (const auto& property : m_entity->numberedProperties(prefix))
   {
     const auto& targetname = property.value();
-    if (targetname.empty())
+    const auto hasTarget =
+      !targetname.empty()
+      && std::any_of(targets.begin(), targets.end(), [&](const auto* target) {
+           const auto* targetTargetname =
+             target->entity().property(EntityPropertyKeys::Targetname);
+           return targetTargetname && *targetTargetname == targetname;
+         });
+
+    if (!hasTarget)
     {
       result.push_back(property.key());
     }
-    else
-    {
-      auto linkTargets = std::vector<EntityNodeBase*>{};
-      findEntityNodesWithProperty(
-        EntityPropertyKeys::Targetname, targetname, linkTargets);
-      if (linkTargets.empty())
-      {
-        result.push_back(property.key());
-      }
-    }
   }
 }
 
@@ -492,7 +569,7 @@ void EntityNodeBase::addAllLinkSources(const std::string& targetname)
 
 void EntityNodeBase::addAllLinkTargets()
 {
-  for (const auto& property : m_entity.numberedProperties(EntityPropertyKeys::Target))
+  for (const auto& property : m_entity->numberedProperties(EntityPropertyKeys::Target))
   {
     const auto& targetname = property.value();
     if (!targetname.empty())
@@ -518,7 +595,8 @@ void EntityNodeBase::addAllKillSources(const std::string& targetname)
 
 void EntityNodeBase::addAllKillTargets()
 {
-  for (const auto& property : m_entity.numberedProperties(EntityPropertyKeys::Killtarget))
+  for (const auto& property :
+       m_entity->numberedProperties(EntityPropertyKeys::Killtarget))
   {
     const std::string& targetname = property.value();
     if (!targetname.empty())
@@ -628,7 +706,7 @@ void EntityNodeBase::addAllLinks()
   addAllLinkTargets();
   addAllKillTargets();
 
-  const auto* targetname = m_entity.property(EntityPropertyKeys::Targetname);
+  const auto* targetname = m_entity->property(EntityPropertyKeys::Targetname);
   if (targetname && !targetname->empty())
   {
     addAllLinkSources(*targetname);
@@ -697,11 +775,14 @@ void EntityNodeBase::removeKillSource(EntityNodeBase* node)
   invalidateIssues();
 }
 
-EntityNodeBase::EntityNodeBase() = default;
+EntityNodeBase::EntityNodeBase()
+  : m_entity{std::make_shared<Entity>()}
+{
+}
 
 const std::string& EntityNodeBase::doGetName() const
 {
-  return m_entity.classname();
+  return m_entity->classname();
 }
 
 void EntityNodeBase::removeKillTarget(EntityNodeBase* node)
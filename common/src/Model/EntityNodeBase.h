@@ -25,7 +25,9 @@
 
 #include "vm/bbox.h"
 
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom::Assets
@@ -36,6 +38,7 @@ class EntityDefinition;
 
 namespace TrenchBroom::Model
 {
+class ContentHasher;
 
 const Assets::EntityDefinition* selectEntityDefinition(
   const std::vector<EntityNodeBase*>& nodes);
@@ -48,11 +51,13 @@ std::string selectPropertyValue(
 
 class EntityNodeBase : public Node
 {
+private:
+  // shared with snapshots and copied before it is modified if it is shared
+  std::shared_ptr<Entity> m_entity;
+
 protected:
   explicit EntityNodeBase(Entity entity);
 
-  Entity m_entity;
-
   std::vector<EntityNodeBase*> m_linkSources;
   std::vector<EntityNodeBase*> m_linkTargets;
   std::vector<EntityNodeBase*> m_killSources;
@@ -63,11 +68,28 @@ public:
 
 public: // entity access
   const Entity& entity() const;
+
+  /**
+   * Returns the entity of this node for sharing it with a snapshot. The shared entity is
+   * never modified by this node.
+   */
+  std::shared_ptr<const Entity> sharedEntity() const;
+
   Entity setEntity(Entity entity);
 
 public: // definition
   void setDefinition(Assets::EntityDefinition* definition);
 
+  /**
+   * Sets the definitions of the given nodes. This is equivalent to calling setDefinition
+   * for each node, but the properties that the entities cache and that depend on their
+   * definitions are updated in parallel. The nodes and their ancestors are notified about
+   * the changes sequentially.
+   */
+  static void setDefinitions(
+    const std::vector<std::tuple<EntityNodeBase*, Assets::EntityDefinition*>>&
+      nodesAndDefinitions);
+
 private: // property management internals
   class NotifyPropertyChange
   {
@@ -87,11 +109,11 @@ private: // property management internals
 private: // bulk update after property changes
   void updateIndexAndLinks(const std::vector<EntityProperty>& newProperties);
   void updatePropertyIndex(
-    const std::vector<EntityProperty>& oldProperties,
-    const std::vector<EntityProperty>& newProperties);
+    const std::vector<const EntityProperty*>& oldProperties,
+    const std::vector<const EntityProperty*>& newProperties);
   void updateLinks(
-    const std::vector<EntityProperty>& oldProperties,
-    const std::vector<EntityProperty>& newProperties);
+    const std::vector<const EntityProperty*>& oldProperties,
+    const std::vector<const EntityProperty*>& newProperties);
 
 private: // search index management
   void addPropertiesToIndex();
@@ -99,11 +121,7 @@ private: // search index management
 
   void addPropertyToIndex(const std::string& key, const std::string& value);
   void removePropertyFromIndex(const std::string& key, const std::string& value);
-  void updatePropertyIndex(
-    const std::string& oldKey,
-    const std::string& oldValue,
-    const std::string& newKey,
-    const std::string& newValue);
+  void updatePropertyIndex(const std::string& oldValue, const std::string& newValue);
 
 public: // link management
   const std::vector<EntityNodeBase*>& linkSources() const;
@@ -120,7 +138,9 @@ public: // link management
 
 private: // link management internals
   void findMissingTargets(
-    const std::string& prefix, std::vector<std::string>& result) const;
+    const std::string& prefix,
+    const std::vector<EntityNodeBase*>& targets,
+    std::vector<std::string>& result) const;
 
   void addLinks(const std::string& name, const std::string& value);
   void removeLinks(const std::string& name, const std::string& value);
@@ -167,6 +187,17 @@ private: // link management internals
 protected:
   EntityNodeBase();
 
+  /**
+   * Adds the properties of this node's entity to the given hasher.
+   */
+  void addEntityToHash(ContentHasher& hasher) const;
+
+  /**
+   * Returns this node's entity for modification, copying it first if it is shared with a
+   * snapshot. The caller must notify about the change.
+   */
+  Entity& mutableEntity();
+
 private: // implemenation of node interface
   const std::string& doGetName() const override;
   void doAncestorWillChange() override;
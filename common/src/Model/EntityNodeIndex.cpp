@@ -30,6 +30,7 @@
 #include <iterator>
 #include <list>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace TrenchBroom
@@ -142,20 +143,29 @@ void EntityNodeIndex::removeEntityNode(EntityNodeBase* node)
 void EntityNodeIndex::addProperty(
   EntityNodeBase* node, const std::string& key, const std::string& value)
 {
-  m_keyIndex->insert(key, node);
-  m_valueIndex->insert(value, node);
+  m_pendingKeyUpdates.insertions.emplace_back(key, node);
+  m_pendingValueUpdates.insertions.emplace_back(value, node);
 }
 
 void EntityNodeIndex::removeProperty(
   EntityNodeBase* node, const std::string& key, const std::string& value)
 {
-  m_keyIndex->remove(key, node);
-  m_valueIndex->remove(value, node);
+  m_pendingKeyUpdates.removals.emplace_back(key, node);
+  m_pendingValueUpdates.removals.emplace_back(value, node);
+}
+
+void EntityNodeIndex::updatePropertyValue(
+  EntityNodeBase* node, const std::string& oldValue, const std::string& newValue)
+{
+  m_pendingValueUpdates.removals.emplace_back(oldValue, node);
+  m_pendingValueUpdates.insertions.emplace_back(newValue, node);
 }
 
 std::vector<EntityNodeBase*> EntityNodeIndex::findEntityNodes(
   const EntityNodeIndexQuery& keyQuery, const std::string& value) const
 {
+  applyPendingUpdates();
+
   // first, find Nodes which have `value` as the value for any key
   std::vector<EntityNodeBase*> result;
   m_valueIndex->find_matches(value, std::back_inserter(result));
@@ -180,8 +190,19 @@ std::vector<EntityNodeBase*> EntityNodeIndex::findEntityNodes(
   return result;
 }
 
+std::vector<EntityNodeBase*> EntityNodeIndex::findEntityNodes(
+  const EntityNodeIndexQuery& keyQuery) const
+{
+  applyPendingUpdates();
+
+  const auto result = keyQuery.execute(*m_keyIndex);
+  return std::vector<EntityNodeBase*>(result.begin(), result.end());
+}
+
 std::vector<std::string> EntityNodeIndex::allKeys() const
 {
+  applyPendingUpdates();
+
   std::vector<std::string> result;
   m_keyIndex->get_keys(std::back_inserter(result));
   return result;
@@ -190,6 +211,8 @@ std::vector<std::string> EntityNodeIndex::allKeys() const
 std::vector<std::string> EntityNodeIndex::allValuesForKeys(
   const EntityNodeIndexQuery& keyQuery) const
 {
+  applyPendingUpdates();
+
   std::vector<std::string> result;
 
   const std::set<EntityNodeBase*> nameResult = keyQuery.execute(*m_keyIndex);
@@ -204,5 +227,30 @@ std::vector<std::string> EntityNodeIndex::allValuesForKeys(
 
   return result;
 }
+
+namespace
+{
+std::vector<std::pair<std::string_view, EntityNodeBase*>> toEntries(
+  const std::vector<std::pair<std::string, EntityNodeBase*>>& updates)
+{
+  return kdl::vec_transform(updates, [](const auto& update) {
+    return std::pair<std::string_view, EntityNodeBase*>{update.first, update.second};
+  });
+}
+} // namespace
+
+void EntityNodeIndex::applyPendingUpdates() const
+{
+  const auto apply = [](auto& index, auto& updates) {
+    // insert first so that the values removed by the same batch are always found
+    index.insert_all(toEntries(updates.insertions));
+    index.remove_all(toEntries(updates.removals));
+    updates.insertions.clear();
+    updates.removals.clear();
+  };
+
+  apply(*m_keyIndex, m_pendingKeyUpdates);
+  apply(*m_valueIndex, m_pendingValueUpdates);
+}
 } // namespace Model
 } // namespace TrenchBroom
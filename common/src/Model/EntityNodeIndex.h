@@ -24,6 +24,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
@@ -64,12 +65,29 @@ private:
   explicit EntityNodeIndexQuery(Type type, const std::string& pattern = "");
 };
 
+/**
+ * Indexes entity nodes by the keys and values of their properties.
+ *
+ * Changes to the index are not applied to the tries immediately. They are collected and
+ * applied in bulk before the index is queried next, so that a command which changes the
+ * properties of many entities descends the tries only once for every distinct key or
+ * value.
+ */
 class EntityNodeIndex
 {
 private:
+  struct PendingUpdates
+  {
+    std::vector<std::pair<std::string, EntityNodeBase*>> insertions;
+    std::vector<std::pair<std::string, EntityNodeBase*>> removals;
+  };
+
   std::unique_ptr<EntityNodeStringIndex> m_keyIndex;
   std::unique_ptr<EntityNodeStringIndex> m_valueIndex;
 
+  mutable PendingUpdates m_pendingKeyUpdates;
+  mutable PendingUpdates m_pendingValueUpdates;
+
 public:
   EntityNodeIndex();
   ~EntityNodeIndex();
@@ -82,10 +100,27 @@ public:
   void removeProperty(
     EntityNodeBase* node, const std::string& key, const std::string& value);
 
+  /**
+   * Replaces the value of a property of the given node whose key did not change. Only the
+   * value index is updated.
+   */
+  void updatePropertyValue(
+    EntityNodeBase* node, const std::string& oldValue, const std::string& newValue);
+
   std::vector<EntityNodeBase*> findEntityNodes(
     const EntityNodeIndexQuery& keyQuery, const std::string& value) const;
+
+  /**
+   * Returns the nodes that have a property whose key matches the given query, regardless
+   * of its value.
+   */
+  std::vector<EntityNodeBase*> findEntityNodes(
+    const EntityNodeIndexQuery& keyQuery) const;
   std::vector<std::string> allKeys() const;
   std::vector<std::string> allValuesForKeys(const EntityNodeIndexQuery& keyQuery) const;
+
+private:
+  void applyPendingUpdates() const;
 };
 } // namespace Model
 } // namespace TrenchBroom
@@ -25,6 +25,7 @@
 #include "kdl/string_compare.h"
 #include "kdl/vector_set.h"
 
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -91,11 +92,67 @@ bool isNumberedProperty(std::string_view prefix, std::string_view key)
   return kdl::cs::str_matches_glob(key, pattern);
 }
 
+bool isInternedPropertyValue(const std::string_view key)
+{
+  return key == EntityPropertyKeys::Classname || key == EntityPropertyKeys::Target
+         || key == EntityPropertyKeys::Targetname || key == EntityPropertyKeys::Killtarget
+         || key == EntityPropertyKeys::Layer || key == EntityPropertyKeys::Group
+         || key == EntityPropertyKeys::LinkId;
+}
+
+EntityPropertyValue::EntityPropertyValue() = default;
+
+EntityPropertyValue::EntityPropertyValue(std::string value, const bool interned)
+{
+  if (interned)
+  {
+    m_value = kdl::interned_string{value};
+  }
+  else
+  {
+    m_value = std::move(value);
+  }
+}
+
+const std::string& EntityPropertyValue::str() const
+{
+  return std::visit(
+    [](const auto& value) -> const std::string& { return value; }, m_value);
+}
+
+bool EntityPropertyValue::interned() const
+{
+  return std::holds_alternative<kdl::interned_string>(m_value);
+}
+
+bool operator==(const EntityPropertyValue& lhs, const EntityPropertyValue& rhs)
+{
+  return lhs.interned() && rhs.interned()
+           ? std::get<kdl::interned_string>(lhs.m_value)
+               == std::get<kdl::interned_string>(rhs.m_value)
+           : lhs.str() == rhs.str();
+}
+
+bool operator!=(const EntityPropertyValue& lhs, const EntityPropertyValue& rhs)
+{
+  return !(lhs == rhs);
+}
+
+bool operator<(const EntityPropertyValue& lhs, const EntityPropertyValue& rhs)
+{
+  return lhs.str() < rhs.str();
+}
+
+std::ostream& operator<<(std::ostream& lhs, const EntityPropertyValue& rhs)
+{
+  return lhs << rhs.str();
+}
+
 EntityProperty::EntityProperty() = default;
 
 EntityProperty::EntityProperty(std::string key, std::string value)
-  : m_key{std::move(key)}
-  , m_value{std::move(value)}
+  : m_key{key}
+  , m_value{std::move(value), isInternedPropertyValue(key)}
 {
 }
 
@@ -108,17 +165,22 @@ const std::string& EntityProperty::key() const
 
 const std::string& EntityProperty::value() const
 {
-  return m_value;
+  return m_value.str();
+}
+
+bool EntityProperty::hasInternedValue() const
+{
+  return m_value.interned();
 }
 
 bool EntityProperty::hasKey(std::string_view key) const
 {
-  return kdl::cs::str_is_equal(m_key, key);
+  return kdl::cs::str_is_equal(m_key.str(), key);
 }
 
 bool EntityProperty::hasValue(const std::string_view value) const
 {
-  return kdl::cs::str_is_equal(m_value, value);
+  return kdl::cs::str_is_equal(m_value.str(), value);
 }
 
 bool EntityProperty::hasKeyAndValue(std::string_view key, std::string_view value) const
@@ -128,7 +190,7 @@ bool EntityProperty::hasKeyAndValue(std::string_view key, std::string_view value
 
 bool EntityProperty::hasPrefix(const std::string_view prefix) const
 {
-  return kdl::cs::str_is_prefix(m_key, prefix);
+  return kdl::cs::str_is_prefix(m_key.str(), prefix);
 }
 
 bool EntityProperty::hasPrefixAndValue(
@@ -139,7 +201,7 @@ bool EntityProperty::hasPrefixAndValue(
 
 bool EntityProperty::hasNumberedPrefix(const std::string_view prefix) const
 {
-  return isNumberedProperty(prefix, m_key);
+  return isNumberedProperty(prefix, m_key.str());
 }
 
 bool EntityProperty::hasNumberedPrefixAndValue(
@@ -150,12 +212,18 @@ bool EntityProperty::hasNumberedPrefixAndValue(
 
 void EntityProperty::setKey(std::string key)
 {
-  m_key = std::move(key);
+  m_key = kdl::interned_string{key};
+
+  const auto internValue = isInternedPropertyValue(m_key.str());
+  if (internValue != m_value.interned())
+  {
+    m_value = EntityPropertyValue{m_value.str(), internValue};
+  }
 }
 
 void EntityProperty::setValue(std::string value)
 {
-  m_value = std::move(value);
+  m_value = EntityPropertyValue{std::move(value), m_value.interned()};
 }
 
 bool isLayer(const std::string& classname, const std::vector<EntityProperty>& properties)
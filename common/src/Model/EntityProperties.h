@@ -21,10 +21,13 @@
 
 #include "EL/Expression.h"
 
+#include "kdl/interned_string.h"
 #include "kdl/reflection_decl.h"
 
+#include <iosfwd>
 #include <optional>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom
@@ -96,11 +99,40 @@ struct EntityPropertyConfig
 
 bool isNumberedProperty(std::string_view prefix, std::string_view key);
 
+/**
+ * Indicates whether the values of properties with the given key are likely to be shared
+ * by many entities, e.g. classnames and target names. Such values are interned.
+ */
+bool isInternedPropertyValue(std::string_view key);
+
+/**
+ * The value of an entity property. It is either interned or stored as a regular string,
+ * depending on the key of its property.
+ */
+class EntityPropertyValue
+{
+private:
+  std::variant<std::string, kdl::interned_string> m_value;
+
+public:
+  EntityPropertyValue();
+  EntityPropertyValue(std::string value, bool interned);
+
+  const std::string& str() const;
+  bool interned() const;
+
+  friend bool operator==(const EntityPropertyValue& lhs, const EntityPropertyValue& rhs);
+  friend bool operator!=(const EntityPropertyValue& lhs, const EntityPropertyValue& rhs);
+  friend bool operator<(const EntityPropertyValue& lhs, const EntityPropertyValue& rhs);
+  friend std::ostream& operator<<(std::ostream& lhs, const EntityPropertyValue& rhs);
+};
+
 class EntityProperty
 {
 private:
-  std::string m_key;
-  std::string m_value;
+  // keys are shared by many entities, so they are always interned
+  kdl::interned_string m_key;
+  EntityPropertyValue m_value;
 
 public:
   EntityProperty();
@@ -110,6 +142,7 @@ public:
 
   const std::string& key() const;
   const std::string& value() const;
+  bool hasInternedValue() const;
 
   bool hasKey(std::string_view key) const;
   bool hasValue(std::string_view value) const;
@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FilePositionIndex.h"
+
+#include "Model/Node.h"
+
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+
+namespace TrenchBroom::Model
+{
+
+FilePositionIndex::FilePositionIndex(const Node& root)
+{
+  addChildren(root);
+}
+
+std::vector<Node*> FilePositionIndex::findChildren(
+  const Node& parent, const std::vector<std::size_t>& lineNumbers) const
+{
+  const auto it = m_children.find(&parent);
+  if (it == m_children.end())
+  {
+    return {};
+  }
+
+  const auto& entries = it->second;
+  auto indices = std::vector<std::size_t>{};
+  for (const auto lineNumber : lineNumbers)
+  {
+    // the siblings usually don't overlap, but edited nodes may have stale positions, so
+    // walk back while an earlier entry may still reach the line
+    auto i = std::size_t(std::distance(
+      entries.begin(),
+      std::upper_bound(
+        entries.begin(),
+        entries.end(),
+        lineNumber,
+        [](const auto line, const auto& entry) { return line < entry.firstLine; })));
+    while (i > 0 && entries[i - 1].maxEndLine > lineNumber)
+    {
+      --i;
+      if (entries[i].endLine > lineNumber)
+      {
+        indices.push_back(i);
+      }
+    }
+  }
+
+  indices = kdl::vec_sort_and_remove_duplicates(std::move(indices));
+  return kdl::vec_transform(indices, [&](const auto i) { return entries[i].node; });
+}
+
+void FilePositionIndex::addChildren(const Node& parent)
+{
+  auto entries = std::vector<Entry>{};
+  for (auto* child : parent.children())
+  {
+    if (child->lineCount() > 0)
+    {
+      const auto firstLine = child->lineNumber();
+      const auto endLine = firstLine + child->lineCount();
+      entries.push_back(Entry{firstLine, endLine, endLine, child});
+    }
+    addChildren(*child);
+  }
+
+  if (!entries.empty())
+  {
+    std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.firstLine < rhs.firstLine;
+    });
+    for (std::size_t i = 1; i < entries.size(); ++i)
+    {
+      entries[i].maxEndLine = std::max(entries[i].endLine, entries[i - 1].maxEndLine);
+    }
+    m_children.emplace(&parent, std::move(entries));
+  }
+}
+
+} // namespace TrenchBroom::Model
@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom::Model
+{
+class Node;
+
+/**
+ * Maps the line ranges of the nodes in a map file to the nodes, so that the nodes
+ * containing a line can be found without visiting every node in the map.
+ *
+ * The index is built from the file positions of the nodes at the time of its creation.
+ * It must be rebuilt when nodes are added or removed or when the file positions change,
+ * e.g. when the map is saved.
+ */
+class FilePositionIndex
+{
+private:
+  struct Entry
+  {
+    std::size_t firstLine;
+    std::size_t endLine;
+    // the maximum end line of this entry and all entries before it
+    std::size_t maxEndLine;
+    Node* node;
+  };
+
+  // the children of each node, sorted by their first line
+  std::unordered_map<const Node*, std::vector<Entry>> m_children;
+
+public:
+  /**
+   * Indexes the file positions of the descendants of the given node.
+   */
+  explicit FilePositionIndex(const Node& root);
+
+  /**
+   * Returns the children of the given node whose file position contains any of the given
+   * lines, ordered by their file position.
+   */
+  std::vector<Node*> findChildren(
+    const Node& parent, const std::vector<std::size_t>& lineNumbers) const;
+
+private:
+  void addChildren(const Node& parent);
+};
+
+} // namespace TrenchBroom::Model
@@ -23,6 +23,7 @@
 #include "Error.h"
 #include "IO/ExportOptions.h"
 #include "Model/BrushFace.h"
+#include "Model/EntityProperties.h"
 #include "Model/GameFactory.h"
 #include "Model/WorldNode.h"
 
@@ -76,6 +77,11 @@ size_t Game::maxPropertyLength() const
   return doMaxPropertyLength();
 }
 
+EntityPropertyConfig Game::entityPropertyConfig() const
+{
+  return doEntityPropertyConfig();
+}
+
 const std::vector<SmartTag>& Game::smartTags() const
 {
   return doSmartTags();
@@ -111,6 +117,11 @@ Result<void> Game::writeMap(WorldNode& world, const std::filesystem::path& path)
   return doWriteMap(world, path);
 }
 
+void Game::writeMap(WorldNode& world, std::ostream& stream) const
+{
+  doWriteMap(world, stream);
+}
+
 Result<void> Game::exportMap(WorldNode& world, const IO::ExportOptions& options) const
 {
   return doExportMap(world, options);
@@ -151,6 +162,12 @@ void Game::loadTextureCollections(Assets::TextureManager& textureManager) const
   doLoadTextureCollections(textureManager);
 }
 
+std::optional<size_t> Game::reloadModifiedTextures(
+  Assets::TextureManager& textureManager, const std::filesystem::path& directory)
+{
+  return doReloadModifiedTextures(textureManager, directory);
+}
+
 const std::optional<std::string>& Game::wadProperty() const
 {
   return doGetWadProperty();
@@ -31,6 +31,7 @@
 #include "vm/forward.h"
 
 #include <filesystem>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <optional>
@@ -56,6 +57,7 @@ class BrushFace;
 class BrushFaceAttributes;
 struct CompilationConfig;
 class Entity;
+struct EntityPropertyConfig;
 struct FlagsConfig;
 class Node;
 class SmartTag;
@@ -80,6 +82,12 @@ public:
 
   size_t maxPropertyLength() const;
 
+  /**
+   * Returns the configuration for the entity properties of maps of this game. Unlike the
+   * other functions that load maps, this can be used to read maps on any thread.
+   */
+  EntityPropertyConfig entityPropertyConfig() const;
+
   const std::vector<SmartTag>& smartTags() const;
 
   enum class SoftMapBoundsType
@@ -114,6 +122,7 @@ public: // loading and writing map files
     const std::filesystem::path& path,
     Logger& logger) const;
   Result<void> writeMap(WorldNode& world, const std::filesystem::path& path) const;
+  void writeMap(WorldNode& world, std::ostream& stream) const;
   Result<void> exportMap(WorldNode& world, const IO::ExportOptions& options) const;
 
 public: // parsing and serializing objects
@@ -135,6 +144,8 @@ public: // parsing and serializing objects
 
 public: // texture collection handling
   void loadTextureCollections(Assets::TextureManager& textureManagerr) const;
+  std::optional<size_t> reloadModifiedTextures(
+    Assets::TextureManager& textureManager, const std::filesystem::path& directory);
 
   const std::optional<std::string>& wadProperty() const;
   void reloadWads(
@@ -176,6 +187,7 @@ private: // subclassing interface
 
   virtual const CompilationConfig& doCompilationConfig() = 0;
   virtual size_t doMaxPropertyLength() const = 0;
+  virtual EntityPropertyConfig doEntityPropertyConfig() const = 0;
   virtual std::optional<vm::bbox3> doSoftMapBounds() const = 0;
   virtual SoftMapBounds doExtractSoftMapBounds(const Entity& entity) const = 0;
 
@@ -190,6 +202,7 @@ private: // subclassing interface
     Logger& logger) const = 0;
   virtual Result<void> doWriteMap(
     WorldNode& world, const std::filesystem::path& path) const = 0;
+  virtual void doWriteMap(WorldNode& world, std::ostream& stream) const = 0;
   virtual Result<void> doExportMap(
     WorldNode& world, const IO::ExportOptions& options) const = 0;
 
@@ -211,6 +224,9 @@ private: // subclassing interface
     std::ostream& stream) const = 0;
 
   virtual void doLoadTextureCollections(Assets::TextureManager& textureManager) const = 0;
+  virtual std::optional<size_t> doReloadModifiedTextures(
+    Assets::TextureManager& textureManager,
+    const std::filesystem::path& directory) = 0;
   virtual const std::optional<std::string>& doGetWadProperty() const = 0;
   virtual void doReloadWads(
     const std::filesystem::path& documentPath,
@@ -93,6 +93,14 @@ kdl_reflect_impl(FaceAttribsConfig);
 
 kdl_reflect_impl(CompilationTool);
 
+kdl_reflect_impl(GameConfigHeader);
+
+std::filesystem::path GameConfigHeader::findConfigFile(
+  const std::filesystem::path& filePath) const
+{
+  return path.parent_path() / filePath;
+}
+
 kdl_reflect_impl(GameConfig);
 
 std::filesystem::path GameConfig::findInitialMap(const std::string& formatName) const
@@ -128,6 +128,23 @@ struct CompilationTool
   kdl_reflect_decl(CompilationTool, name, description);
 };
 
+/**
+ * The parts of a game configuration that are needed to list the game and to choose a map
+ * format. The full configuration is only parsed when the game is used.
+ */
+struct GameConfigHeader
+{
+  std::string name;
+  std::filesystem::path path;
+  std::filesystem::path icon;
+  bool experimental;
+  std::vector<MapFormatConfig> fileFormats;
+
+  kdl_reflect_decl(GameConfigHeader, name, path, icon, experimental, fileFormats);
+
+  std::filesystem::path findConfigFile(const std::filesystem::path& filePath) const;
+};
+
 struct GameConfig
 {
   std::string name;
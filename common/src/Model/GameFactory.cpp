@@ -74,6 +74,7 @@ void GameFactory::reset()
   m_configFs.reset();
 
   m_names.clear();
+  m_headers.clear();
   m_configs.clear();
   m_gamePaths.clear();
   m_defaultEngines.clear();
@@ -100,7 +101,7 @@ const std::vector<std::string>& GameFactory::gameList() const
 
 size_t GameFactory::gameCount() const
 {
-  return m_configs.size();
+  return m_headers.size();
 }
 
 std::shared_ptr<Game> GameFactory::createGame(const std::string& gameName, Logger& logger)
@@ -111,13 +112,14 @@ std::shared_ptr<Game> GameFactory::createGame(const std::string& gameName, Logge
 std::vector<std::string> GameFactory::fileFormats(const std::string& gameName) const
 {
   return kdl::vec_transform(
-    gameConfig(gameName).fileFormats, [](const auto& format) { return format.format; });
+    gameConfigHeader(gameName).fileFormats,
+    [](const auto& format) { return format.format; });
 }
 
 std::filesystem::path GameFactory::iconPath(const std::string& gameName) const
 {
-  const auto& config = gameConfig(gameName);
-  return config.findConfigFile(config.icon);
+  const auto& header = gameConfigHeader(gameName);
+  return header.findConfigFile(header.icon);
 }
 
 std::filesystem::path GameFactory::gamePath(const std::string& gameName) const
@@ -182,22 +184,22 @@ bool GameFactory::setCompilationToolPath(
 
 GameConfig& GameFactory::gameConfig(const std::string& name)
 {
-  const auto cIt = m_configs.find(name);
-  if (cIt == std::end(m_configs))
-  {
-    throw GameException{"Unknown game: " + name};
-  }
-  return cIt->second;
+  return loadedGameConfig(name);
 }
 
 const GameConfig& GameFactory::gameConfig(const std::string& name) const
 {
-  const auto cIt = m_configs.find(name);
-  if (cIt == std::end(m_configs))
+  return loadedGameConfig(name);
+}
+
+const GameConfigHeader& GameFactory::gameConfigHeader(const std::string& name) const
+{
+  const auto hIt = m_headers.find(name);
+  if (hIt == std::end(m_headers))
   {
     throw GameException{"Unknown game: " + name};
   }
-  return cIt->second;
+  return hIt->second;
 }
 
 namespace
@@ -233,7 +235,7 @@ Result<std::pair<std::string, MapFormat>> GameFactory::detectGame(
 {
   return IO::Disk::withInputStream(path, [&](auto& stream) {
     auto gameName = readInfoComment(stream, "Game");
-    if (m_configs.find(gameName) == std::end(m_configs))
+    if (m_headers.find(gameName) == std::end(m_headers))
     {
       gameName = "";
     }
@@ -283,7 +285,7 @@ Result<std::vector<std::string>> GameFactory::loadGameConfigs()
     .transform([&](auto configFiles) {
       auto errors = std::vector<std::string>{};
       kdl::vec_transform(configFiles, [&](const auto& configFilePath) {
-        return loadGameConfig(configFilePath).transform_error([&](auto e) {
+        return loadGameConfigHeader(configFilePath).transform_error([&](auto e) {
           errors.push_back(
             "Failed to load game configuration file '" + configFilePath.string()
             + "': " + e.msg);
@@ -293,7 +295,7 @@ Result<std::vector<std::string>> GameFactory::loadGameConfigs()
     });
 }
 
-Result<void> GameFactory::loadGameConfig(const std::filesystem::path& path)
+Result<void> GameFactory::loadGameConfigHeader(const std::filesystem::path& path)
 {
   return m_configFs->openFile(path)
     .join(m_configFs->makeAbsolute(path))
@@ -302,13 +304,10 @@ Result<void> GameFactory::loadGameConfig(const std::filesystem::path& path)
       auto parser = IO::GameConfigParser{reader.stringView(), absolutePath};
       try
       {
-        auto config = parser.parse();
+        auto header = parser.parseHeader();
 
-        loadCompilationConfig(config);
-        loadGameEngineConfig(config);
-
-        const auto configName = config.name;
-        m_configs.emplace(configName, std::move(config));
+        const auto configName = header.name;
+        m_headers.emplace(configName, std::move(header));
         kdl::wrap_set(m_names).insert(configName);
 
         const auto gamePathPrefPath =
@@ -330,7 +329,46 @@ Result<void> GameFactory::loadGameConfig(const std::filesystem::path& path)
     });
 }
 
-void GameFactory::loadCompilationConfig(GameConfig& gameConfig)
+GameConfig& GameFactory::loadedGameConfig(const std::string& name) const
+{
+  if (const auto cIt = m_configs.find(name); cIt != std::end(m_configs))
+  {
+    return cIt->second;
+  }
+
+  auto config = loadGameConfig(gameConfigHeader(name));
+  return m_configs.emplace(name, std::move(config)).first->second;
+}
+
+GameConfig GameFactory::loadGameConfig(const GameConfigHeader& header) const
+{
+  return IO::Disk::openFile(header.path)
+    .and_then([&](auto configFile) -> Result<GameConfig> {
+      auto reader = configFile->reader().buffer();
+      auto parser = IO::GameConfigParser{reader.stringView(), header.path};
+      try
+      {
+        auto config = parser.parse();
+
+        loadCompilationConfig(config);
+        loadGameEngineConfig(config);
+
+        return config;
+      }
+      catch (const ParserException& e)
+      {
+        return Error{e.what()};
+      }
+    })
+    .transform_error([&](auto e) -> GameConfig {
+      throw GameException{
+        "Failed to load game configuration file '" + header.path.string()
+        + "': " + e.msg};
+    })
+    .value();
+}
+
+void GameFactory::loadCompilationConfig(GameConfig& gameConfig) const
 {
   const auto path = std::filesystem::path{gameConfig.name} / "CompilationProfiles.cfg";
   try
@@ -360,7 +398,7 @@ void GameFactory::loadCompilationConfig(GameConfig& gameConfig)
   }
 }
 
-void GameFactory::loadGameEngineConfig(GameConfig& gameConfig)
+void GameFactory::loadGameEngineConfig(GameConfig& gameConfig) const
 {
   const auto path = std::filesystem::path{gameConfig.name} / "GameEngineProfiles.cfg";
   try
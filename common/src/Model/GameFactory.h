@@ -47,6 +47,7 @@ namespace TrenchBroom::Model
 struct CompilationConfig;
 class Game;
 struct GameConfig;
+struct GameConfigHeader;
 struct GameEngineConfig;
 
 struct GamePathConfig
@@ -58,6 +59,7 @@ struct GamePathConfig
 class GameFactory
 {
 private:
+  using HeaderMap = std::map<std::string, GameConfigHeader>;
   using ConfigMap = std::map<std::string, GameConfig>;
   using GamePathMap = std::map<std::string, Preference<std::filesystem::path>>;
 
@@ -65,7 +67,9 @@ private:
   std::unique_ptr<IO::WritableVirtualFileSystem> m_configFs;
 
   std::vector<std::string> m_names;
-  ConfigMap m_configs;
+  HeaderMap m_headers;
+  // game configurations are only loaded when they are first used
+  mutable ConfigMap m_configs;
   mutable GamePathMap m_gamePaths;
   mutable GamePathMap m_defaultEngines;
 
@@ -75,7 +79,9 @@ public:
   /**
    * Initializes the game factory, must be called once when the application starts.
    * Initialization comprises building a file system to find the builtin and user-provided
-   * game configurations and loading them.
+   * game configurations and loading their headers. The full game configurations, and
+   * their compilation and game engine profiles, are loaded when they are first
+   * requested.
    *
    * If the file system cannot be built, a Error is returned. Since this is a fatal
    * error, the caller should inform the user of the error and terminate the application.
@@ -137,9 +143,22 @@ public:
     const std::string& toolName,
     const std::filesystem::path& gamePath);
 
+  /**
+   * Returns the game configuration with the given name, loading it if necessary.
+   *
+   * @throws GameException if the game is unknown or its configuration cannot be loaded
+   */
   GameConfig& gameConfig(const std::string& gameName);
   const GameConfig& gameConfig(const std::string& gameName) const;
 
+  /**
+   * Returns the header of the game configuration with the given name without loading the
+   * full configuration.
+   *
+   * @throws GameException if the game is unknown
+   */
+  const GameConfigHeader& gameConfigHeader(const std::string& gameName) const;
+
   /**
    * Scans the map file at the given path to find game type and map format comments and
    * returns the name of the game and the map format.
@@ -163,9 +182,11 @@ private:
   GameFactory();
   Result<void> initializeFileSystem(const GamePathConfig& gamePathConfig);
   Result<std::vector<std::string>> loadGameConfigs();
-  Result<void> loadGameConfig(const std::filesystem::path& path);
-  void loadCompilationConfig(GameConfig& gameConfig);
-  void loadGameEngineConfig(GameConfig& gameConfig);
+  Result<void> loadGameConfigHeader(const std::filesystem::path& path);
+  GameConfig& loadedGameConfig(const std::string& gameName) const;
+  GameConfig loadGameConfig(const GameConfigHeader& header) const;
+  void loadCompilationConfig(GameConfig& gameConfig) const;
+  void loadGameEngineConfig(GameConfig& gameConfig) const;
 
   void writeCompilationConfig(
     GameConfig& gameConfig, CompilationConfig compilationConfig, Logger& logger);
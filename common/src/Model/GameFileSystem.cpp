@@ -26,6 +26,7 @@
 #include "IO/File.h"
 #include "IO/IdPakFileSystem.h"
 #include "IO/PathInfo.h"
+#include "IO/Quake3ShaderCache.h"
 #include "IO/Quake3ShaderFileSystem.h"
 #include "IO/SystemPaths.h"
 #include "IO/TraversalMode.h"
@@ -33,12 +34,18 @@
 #include "IO/ZipFileSystem.h"
 #include "Logger.h"
 #include "Model/GameConfig.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 
+#include "kdl/parallel.h"
 #include "kdl/result_fold.h"
 #include "kdl/string_compare.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <memory>
+#include <system_error>
+#include <tuple>
 
 namespace TrenchBroom::Model
 {
@@ -49,21 +56,56 @@ void GameFileSystem::initialize(
   const std::vector<std::filesystem::path>& additionalSearchPaths,
   Logger& logger)
 {
-  unmountAll();
+  // keep the mounted packages so that their directories need not be read again
+  for (auto& mountPoint : unmountAll())
+  {
+    if (const auto it = std::find_if(
+          m_packages.begin(),
+          m_packages.end(),
+          [&](const auto& package) { return package.mountPointId == mountPoint.id; });
+        it != m_packages.end())
+    {
+      m_packageCache[it->path] =
+        CachedPackage{it->stamp, std::move(mountPoint.mountedFileSystem)};
+    }
+  }
+  m_packages.clear();
+  m_diskFileSystems.clear();
   m_shaderFS = nullptr;
+  m_shaderMountPoint = std::nullopt;
 
   addDefaultAssetPaths(config, logger);
 
   if (!gamePath.empty() && IO::Disk::pathInfo(gamePath) == IO::PathInfo::Directory)
   {
     addGameFileSystems(config, gamePath, additionalSearchPaths, logger);
-    addShaderFileSystem(config, logger);
+    addShaderFileSystem(config, gamePath, logger);
   }
+
+  // packages that are no longer mounted are closed
+  m_packageCache.clear();
 }
 
 Result<void> GameFileSystem::reloadShaders()
 {
-  return m_shaderFS ? m_shaderFS->reload() : Result<void>{};
+  refresh();
+
+  if (!m_shaderFS)
+  {
+    return Result<void>{};
+  }
+
+  auto result = m_shaderFS->reload();
+  reindex(*m_shaderMountPoint);
+  return result;
+}
+
+void GameFileSystem::refresh()
+{
+  for (auto* diskFS : m_diskFileSystems)
+  {
+    diskFS->refresh();
+  }
 }
 
 void GameFileSystem::reloadWads(
@@ -119,7 +161,9 @@ void GameFileSystem::addGameFileSystems(
 void GameFileSystem::addFileSystemPath(const std::filesystem::path& path, Logger& logger)
 {
   logger.info() << "Adding file system path " << path;
-  mount("", std::make_unique<IO::DiskFileSystem>(path));
+  auto diskFS = std::make_unique<IO::CachedDiskFileSystem>(path);
+  m_diskFileSystems.push_back(diskFS.get());
+  mount("", std::move(diskFS));
 }
 
 namespace
@@ -153,6 +197,25 @@ Result<std::unique_ptr<IO::FileSystem>> createImageFileSystem(
   }
   return Error{"Unknown package format: " + packageFormat};
 }
+
+template <typename PackageStamp>
+std::optional<PackageStamp> getPackageStamp(const std::filesystem::path& path)
+{
+  auto error = std::error_code{};
+  const auto size = std::filesystem::file_size(path, error);
+  if (error)
+  {
+    return std::nullopt;
+  }
+
+  const auto writeTime = std::filesystem::last_write_time(path, error);
+  if (error)
+  {
+    return std::nullopt;
+  }
+
+  return PackageStamp{size, writeTime};
+}
 } // namespace
 
 void GameFileSystem::addFileSystemPackages(
@@ -173,17 +236,51 @@ void GameFileSystem::addFileSystemPackages(
         IO::TraversalMode::Flat,
         IO::makeExtensionPathMatcher(packageExtensions))
       .and_then([&](auto packagePaths) {
-        return kdl::fold_results(
-          kdl::vec_transform(std::move(packagePaths), [&](auto packagePath) {
-            return diskFS.makeAbsolute(packagePath)
-              .and_then([&](const auto& absPackagePath) {
-                return createImageFileSystem(packageFormat, absPackagePath);
-              })
-              .transform([&](auto fs) {
-                logger.info() << "Adding file system package " << packagePath;
-                mount("", std::move(fs));
-              });
-          }));
+        // packages that come later in alphabetical order take precedence
+        std::sort(
+          packagePaths.begin(),
+          packagePaths.end(),
+          [](const auto& lhs, const auto& rhs) {
+            return kdl::ci::str_compare(lhs.string(), rhs.string()) < 0;
+          });
+        return kdl::fold_results(kdl::vec_transform(
+          packagePaths, [&](const auto& path) { return diskFS.makeAbsolute(path); }));
+      })
+      .transform([&](auto absPackagePaths) {
+        auto packages = kdl::vec_transform(std::move(absPackagePaths), [&](auto path) {
+          auto stamp = getPackageStamp<PackageStamp>(path);
+          auto cachedFileSystem = takeCachedPackage(path, stamp);
+          return std::tuple{std::move(path), stamp, std::move(cachedFileSystem)};
+        });
+
+        // reading the package directories takes most of the time, so the packages are
+        // opened in parallel and mounted in order afterwards
+        auto openedPackages =
+          kdl::vec_parallel_transform(std::move(packages), [&](auto&& package) {
+            auto& [path, stamp, cachedFileSystem] = package;
+            auto fs = cachedFileSystem
+                        ? Result<std::unique_ptr<IO::FileSystem>>{std::move(
+                          cachedFileSystem)}
+                        : createImageFileSystem(packageFormat, path);
+            return std::tuple{std::move(path), stamp, std::move(fs)};
+          });
+
+        for (auto& [path, stamp, fs] : openedPackages)
+        {
+          std::move(fs)
+            .transform([&](auto packageFS) {
+              logger.info() << "Adding file system package " << path.filename();
+              const auto id = mount("", std::move(packageFS));
+              if (stamp)
+              {
+                m_packages.push_back(MountedPackage{id, path, *stamp});
+              }
+            })
+            .transform_error([&](auto e) {
+              logger.error() << "Could not add file system package " << path.filename()
+                             << ": " << e.msg;
+            });
+        }
       })
       .transform_error([&](auto e) {
         logger.error() << "Could not add file system packages: " << e.msg;
@@ -191,7 +288,26 @@ void GameFileSystem::addFileSystemPackages(
   }
 }
 
-void GameFileSystem::addShaderFileSystem(const GameConfig& config, Logger& logger)
+std::unique_ptr<IO::FileSystem> GameFileSystem::takeCachedPackage(
+  const std::filesystem::path& path, const std::optional<PackageStamp>& stamp)
+{
+  const auto it = m_packageCache.find(path);
+  if (it == m_packageCache.end())
+  {
+    return nullptr;
+  }
+
+  auto cachedPackage = std::move(it->second);
+  m_packageCache.erase(it);
+
+  return stamp && stamp->size == cachedPackage.stamp.size
+             && stamp->writeTime == cachedPackage.stamp.writeTime
+           ? std::move(cachedPackage.fileSystem)
+           : nullptr;
+}
+
+void GameFileSystem::addShaderFileSystem(
+  const GameConfig& config, const std::filesystem::path& gamePath, Logger& logger)
 {
   // To support Quake 3 shaders, we add a shader file system that loads the shaders
   // and makes them available as virtual files.
@@ -203,12 +319,21 @@ void GameFileSystem::addShaderFileSystem(const GameConfig& config, Logger& logge
     auto textureSearchPaths =
       std::vector<std::filesystem::path>{textureConfig.root, "models"};
 
-    auto shaderFs =
-      IO::createImageFileSystem<IO::Quake3ShaderFileSystem>(
-        *this, std::move(shaderSearchPath), std::move(textureSearchPaths), logger)
-        .value();
+    const auto cacheDirectory = IO::SystemPaths::userDataDirectory() / "ShaderCache";
+    auto cachePath =
+      pref(Preferences::UseShaderCache)
+        ? std::optional{IO::quake3ShaderCachePath(cacheDirectory, gamePath)}
+        : std::nullopt;
+
+    auto shaderFs = IO::createImageFileSystem<IO::Quake3ShaderFileSystem>(
+                      *this,
+                      std::move(shaderSearchPath),
+                      std::move(textureSearchPaths),
+                      logger,
+                      std::move(cachePath))
+                      .value();
     m_shaderFS = shaderFs.get();
-    mount(std::filesystem::path{}, std::move(shaderFs));
+    m_shaderMountPoint = mount(std::filesystem::path{}, std::move(shaderFs));
   }
 }
 
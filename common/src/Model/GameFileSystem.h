@@ -22,8 +22,11 @@
 #include "IO/VirtualFileSystem.h"
 #include "Result.h"
 
+#include <cstdint>
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom
@@ -33,6 +36,7 @@ class Logger;
 
 namespace TrenchBroom::IO
 {
+class CachedDiskFileSystem;
 class Quake3ShaderFileSystem;
 } // namespace TrenchBroom::IO
 
@@ -44,7 +48,34 @@ class GameFileSystem : public IO::VirtualFileSystem
 {
 private:
   IO::Quake3ShaderFileSystem* m_shaderFS = nullptr;
+  std::optional<IO::VirtualMountPointId> m_shaderMountPoint;
   std::vector<IO::VirtualMountPointId> m_wadMountPoints;
+  std::vector<IO::CachedDiskFileSystem*> m_diskFileSystems;
+
+  struct PackageStamp
+  {
+    std::uintmax_t size;
+    std::filesystem::file_time_type writeTime;
+  };
+
+  struct MountedPackage
+  {
+    IO::VirtualMountPointId mountPointId;
+    std::filesystem::path path;
+    PackageStamp stamp;
+  };
+
+  struct CachedPackage
+  {
+    PackageStamp stamp;
+    std::unique_ptr<IO::FileSystem> fileSystem;
+  };
+
+  std::vector<MountedPackage> m_packages;
+
+  // the packages that were mounted before the file system was initialized again, by
+  // absolute path; a package is reused if its size and modification time are unchanged
+  std::map<std::filesystem::path, CachedPackage> m_packageCache;
 
 public:
   void initialize(
@@ -53,6 +84,13 @@ public:
     const std::vector<std::filesystem::path>& additionalSearchPaths,
     Logger& logger);
   Result<void> reloadShaders();
+
+  /**
+   * Discards the cached contents of the game directories, so that files that were added
+   * or removed on disk are found.
+   */
+  void refresh();
+
   void reloadWads(
     const std::filesystem::path& rootPath,
     const std::vector<std::filesystem::path>& wadSearchPaths,
@@ -66,10 +104,13 @@ private:
     const std::filesystem::path& gamePath,
     const std::vector<std::filesystem::path>& additionalSearchPaths,
     Logger& logger);
-  void addShaderFileSystem(const GameConfig& config, Logger& logger);
+  void addShaderFileSystem(
+    const GameConfig& config, const std::filesystem::path& gamePath, Logger& logger);
   void addFileSystemPath(const std::filesystem::path& path, Logger& logger);
   void addFileSystemPackages(
     const GameConfig& config, const std::filesystem::path& searchPath, Logger& logger);
+  std::unique_ptr<IO::FileSystem> takeCachedPackage(
+    const std::filesystem::path& path, const std::optional<PackageStamp>& stamp);
 
   void mountWads(
     const std::filesystem::path& rootPath,
@@ -31,17 +31,21 @@
 #include "IO/AssimpParser.h"
 #include "IO/BrushFaceReader.h"
 #include "IO/Bsp29Parser.h"
+#include "IO/CacheIO.h"
 #include "IO/DefParser.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
 #include "IO/DkmParser.h"
 #include "IO/EntParser.h"
+#include "IO/EntityDefinitionCache.h"
 #include "IO/ExportOptions.h"
 #include "IO/FgdParser.h"
 #include "IO/File.h"
 #include "IO/GameConfigParser.h"
+#include "IO/Gzip.h"
 #include "IO/ImageSpriteParser.h"
 #include "IO/LoadTextureCollection.h"
+#include "IO/MapCache.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
 #include "IO/MdlParser.h"
@@ -50,6 +54,7 @@
 #include "IO/NodeWriter.h"
 #include "IO/ObjSerializer.h"
 #include "IO/PathInfo.h"
+#include "IO/ReaderException.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SprParser.h"
 #include "IO/SystemPaths.h"
@@ -64,6 +69,8 @@
 #include "Model/GameConfig.h"
 #include "Model/LayerNode.h"
 #include "Model/WorldNode.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 
 #include "kdl/overload.h"
 #include "kdl/path_utils.h"
@@ -75,7 +82,10 @@
 
 #include "vm/vec_io.h"
 
+#include <algorithm>
 #include <fstream>
+#include <iterator>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -147,6 +157,12 @@ size_t GameImpl::doMaxPropertyLength() const
   return m_config.maxPropertyLength;
 }
 
+EntityPropertyConfig GameImpl::doEntityPropertyConfig() const
+{
+  return {
+    m_config.entityConfig.scaleExpression, m_config.entityConfig.setDefaultProperties};
+}
+
 std::optional<vm::bbox3> GameImpl::doSoftMapBounds() const
 {
   return m_config.softMapBounds;
@@ -216,50 +232,132 @@ Result<std::unique_ptr<WorldNode>> GameImpl::doLoadMap(
   const vm::bbox3& worldBounds,
   const std::filesystem::path& path,
   Logger& logger) const
+{
+  // the map is tokenized directly over the mapped file, so it is never copied
+  return IO::Disk::mapFile(path).and_then(
+    [&](auto file) -> Result<std::unique_ptr<WorldNode>> {
+      const auto fileReader = file->reader().buffer();
+      const auto fileContents = fileReader.stringView();
+      if (IO::isGzipped(fileContents))
+      {
+        // compressed maps are decompressed into memory in one pass before parsing
+        return IO::gunzip(fileContents).transform([&](const auto& mapContents) {
+          return loadMap(format, worldBounds, path, mapContents, logger);
+        });
+      }
+      return loadMap(format, worldBounds, path, fileContents, logger);
+    });
+}
+
+std::unique_ptr<WorldNode> GameImpl::loadMap(
+  const MapFormat format,
+  const vm::bbox3& worldBounds,
+  const std::filesystem::path& path,
+  const std::string_view mapContents,
+  Logger& logger) const
 {
   auto parserStatus = IO::SimpleParserStatus{logger};
-  return IO::Disk::openFile(path).transform([&](auto file) {
-    auto fileReader = file->reader().buffer();
-    if (format == MapFormat::Unknown)
+  if (format == MapFormat::Unknown)
+  {
+    // Try all formats listed in the game config
+    const auto possibleFormats = kdl::vec_transform(
+      m_config.fileFormats,
+      [](const auto& config) { return Model::formatFromName(config.format); });
+
+    return IO::WorldReader::tryRead(
+      mapContents, possibleFormats, worldBounds, entityPropertyConfig(), parserStatus);
+  }
+
+  if (!pref(Preferences::UseMapCache))
+  {
+    auto worldReader = IO::WorldReader{mapContents, format, entityPropertyConfig()};
+    return worldReader.read(worldBounds, parserStatus);
+  }
+
+  const auto cachePath = IO::mapCachePath(path);
+  const auto cacheKey = IO::mapCacheKey(mapContents, format, worldBounds);
+  if (IO::Disk::pathInfo(cachePath) == IO::PathInfo::File)
+  {
+    if (
+      auto cachedWorld =
+        IO::Disk::mapFile(cachePath)
+          .and_then([&](auto cacheFile) {
+            return IO::readMapCache(
+              cacheFile->reader(), cacheKey, entityPropertyConfig());
+          })
+          .transform_error([&](auto e) {
+            logger.debug() << "Could not load map cache " << cachePath << ": " << e.msg;
+            return std::unique_ptr<WorldNode>{};
+          })
+          .value())
     {
-      // Try all formats listed in the game config
-      const auto possibleFormats = kdl::vec_transform(
-        m_config.fileFormats,
-        [](const auto& config) { return Model::formatFromName(config.format); });
-
-      return IO::WorldReader::tryRead(
-        fileReader.stringView(),
-        possibleFormats,
-        worldBounds,
-        entityPropertyConfig(),
-        parserStatus);
+      logger.info() << "Loaded map from cache " << cachePath;
+      return cachedWorld;
     }
+  }
 
-    auto worldReader =
-      IO::WorldReader{fileReader.stringView(), format, entityPropertyConfig()};
-    return worldReader.read(worldBounds, parserStatus);
-  });
+  auto worldReader = IO::WorldReader{mapContents, format, entityPropertyConfig()};
+  auto worldNode = worldReader.read(worldBounds, parserStatus);
+
+  IO::writeCacheFile(
+    cachePath, [&](auto& stream) { IO::writeMapCache(*worldNode, cacheKey, stream); })
+    .transform_error([&](auto e) {
+      logger.warn() << "Could not write map cache " << cachePath << ": " << e.msg;
+    });
+
+  return worldNode;
 }
 
-Result<void> GameImpl::doWriteMap(
-  WorldNode& world, const std::filesystem::path& path, const bool exporting) const
+void GameImpl::doWriteMap(
+  WorldNode& world, std::ostream& stream, const bool exporting) const
 {
-  return IO::Disk::withOutputStream(path, [&](auto& stream) {
-    const auto mapFormatName = formatName(world.mapFormat());
-    stream << "// Game: " << gameName() << "\n"
-           << "// Format: " << mapFormatName << "\n";
+  const auto mapFormatName = formatName(world.mapFormat());
+  stream << "// Game: " << gameName() << "\n"
+         << "// Format: " << mapFormatName << "\n";
 
-    auto writer = IO::NodeWriter{world, stream};
-    writer.setExporting(exporting);
-    writer.writeMap();
-  });
+  auto writer = IO::NodeWriter{world, stream};
+  writer.setExporting(exporting);
+  writer.writeMap();
 }
 
 Result<void> GameImpl::doWriteMap(
   WorldNode& world, const std::filesystem::path& path) const
 {
-  return doWriteMap(world, path, false);
+  if (IO::isGzipPath(path))
+  {
+    return IO::Disk::withOutputStream(
+      path, std::ios_base::out | std::ios_base::binary, [&](auto& stream) {
+        // the map is compressed on a background thread while it is being serialized
+        auto buffer = IO::GzipStreamBuffer{stream};
+        auto gzipStream = std::ostream{&buffer};
+        doWriteMap(world, gzipStream, false);
+        return buffer.finish();
+      });
+  }
+
+  return IO::Disk::withOutputStream(
+    path, [&](auto& stream) { doWriteMap(world, stream, false); });
+}
+
+void GameImpl::doWriteMap(WorldNode& world, std::ostream& stream) const
+{
+  doWriteMap(world, stream, false);
+}
+
+namespace
+{
+bool fileHasContents(const std::filesystem::path& path, const std::string& contents)
+{
+  return IO::Disk::pathInfo(path) == IO::PathInfo::File
+         && IO::Disk::withInputStream(path, [&](auto& stream) {
+              return std::equal(
+                contents.begin(),
+                contents.end(),
+                std::istreambuf_iterator<char>{stream},
+                std::istreambuf_iterator<char>{});
+            }).value_or(false);
 }
+} // namespace
 
 Result<void> GameImpl::doExportMap(
   WorldNode& world, const IO::ExportOptions& options) const
@@ -279,8 +377,20 @@ Result<void> GameImpl::doExportMap(
           });
         });
       },
-      [&](const IO::MapExportOptions& mapOptions) {
-        return doWriteMap(world, mapOptions.exportPath, true);
+      [&](const IO::MapExportOptions& mapOptions) -> Result<void> {
+        // Most of the map is usually unchanged since the last export, so the text of its
+        // nodes is reused. If the result is identical to the file that was exported
+        // before, the file is left alone.
+        auto stream = std::ostringstream{};
+        doWriteMap(world, stream, true);
+        const auto contents = stream.str();
+
+        if (fileHasContents(mapOptions.exportPath, contents))
+        {
+          return Result<void>{};
+        }
+        return IO::Disk::withOutputStream(
+          mapOptions.exportPath, [&](auto& fileStream) { fileStream << contents; });
       }),
     options);
 }
@@ -326,6 +436,14 @@ void GameImpl::doLoadTextureCollections(Assets::TextureManager& textureManager)
   textureManager.reload(m_fs, m_config.textureConfig);
 }
 
+std::optional<size_t> GameImpl::doReloadModifiedTextures(
+  Assets::TextureManager& textureManager, const std::filesystem::path& directory)
+{
+  // the directory contents must be read again to find added or removed files
+  m_fs.refresh();
+  return textureManager.reloadModifiedTextures(directory, m_fs, m_config.textureConfig);
+}
+
 const std::optional<std::string>& GameImpl::doGetWadProperty() const
 {
   return m_config.textureConfig.property;
@@ -409,18 +527,24 @@ std::filesystem::path GameImpl::doFindEntityDefinitionFile(
   return IO::Disk::resolvePath(searchPaths, path);
 }
 
-Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> GameImpl::
-  loadEntityDefinitions(IO::ParserStatus& status, const std::filesystem::path& path) const
+namespace
+{
+Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> parseEntityDefinitions(
+  IO::ParserStatus& status,
+  const std::filesystem::path& path,
+  const Color& defaultColor,
+  std::vector<std::filesystem::path>& includedFiles)
 {
   const auto extension = path.extension().string();
-  const auto& defaultColor = m_config.entityConfig.defaultColor;
 
   if (kdl::ci::str_is_equal(".fgd", extension))
   {
     return IO::Disk::openFile(path).transform([&](auto file) {
       auto reader = file->reader().buffer();
       auto parser = IO::FgdParser{reader.stringView(), defaultColor, path};
-      return parser.parseDefinitions(status);
+      auto definitions = parser.parseDefinitions(status);
+      includedFiles = parser.includedFiles();
+      return definitions;
     });
   }
   if (kdl::ci::str_is_equal(".def", extension))
@@ -442,9 +566,91 @@ Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> GameImpl::
 
   return Error{"Unknown entity definition format: '" + path.string() + "'"};
 }
+} // namespace
+
+Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> GameImpl::
+  loadEntityDefinitions(
+    IO::ParserStatus& status,
+    const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory) const
+{
+  const auto& defaultColor = m_config.entityConfig.defaultColor;
+  auto includedFiles = std::vector<std::filesystem::path>{};
+
+  if (!cacheDirectory || !path.is_absolute())
+  {
+    return parseEntityDefinitions(status, path, defaultColor, includedFiles);
+  }
+
+  // included files are resolved relative to the directory of the definition file
+  const auto fs = IO::DiskFileSystem{path.parent_path()};
+  const auto cachePath = IO::entityDefinitionCachePath(*cacheDirectory, path);
+  const auto cacheKey =
+    IO::entityDefinitionCacheKey(path.filename(), fs, defaultColor).value_or("");
+
+  if (!cacheKey.empty() && IO::Disk::pathInfo(cachePath) == IO::PathInfo::File)
+  {
+    if (
+      auto cachedDefinitions =
+        IO::Disk::mapFile(cachePath)
+          .and_then([&](auto cacheFile) {
+            return IO::readEntityDefinitionCache(cacheFile->reader(), cacheKey, fs);
+          })
+          .transform(
+            [](auto definitions) { return std::optional{std::move(definitions)}; })
+          .transform_error(
+            [&](auto e) -> std::optional<
+                          std::vector<std::unique_ptr<Assets::EntityDefinition>>> {
+              status.debug(
+                "Could not load entity definition cache " + cachePath.string() + ": "
+                + e.msg);
+              return std::nullopt;
+            })
+          .value())
+    {
+      status.debug("Loaded entity definitions from cache " + cachePath.string());
+      return std::move(*cachedDefinitions);
+    }
+  }
+
+  return parseEntityDefinitions(status, path, defaultColor, includedFiles)
+    .transform([&](auto definitions) {
+      if (!cacheKey.empty())
+      {
+        IO::writeCacheFile(
+          cachePath,
+          [&](auto& stream) {
+            return IO::writeEntityDefinitionCache(
+              definitions, includedFiles, cacheKey, fs, stream);
+          })
+          .transform_error([&](auto e) {
+            status.warn(
+              "Could not write entity definition cache " + cachePath.string() + ": "
+              + e.msg);
+          });
+      }
+      return definitions;
+    });
+}
+
+namespace
+{
+/**
+ * The model parsers throw these exceptions, and they are reported as a GameException to
+ * the callers of the entity model loader.
+ */
+GameException modelLoadException(const std::filesystem::path& path, const Exception& e)
+{
+  return GameException{
+    "Could not load model " + path.string() + ": " + std::string{e.what()}};
+}
+} // namespace
 
 std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(
-  const std::filesystem::path& path, Logger& logger) const
+  const std::filesystem::path& path,
+  const std::optional<std::filesystem::path>& cacheDirectory,
+  Assets::SkinCache* skinCache,
+  Logger& logger) const
 {
   using result_type = Result<std::unique_ptr<Assets::EntityModel>>;
 
@@ -465,7 +671,7 @@ std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(
         if (IO::Md2Parser::canParse(path, reader))
         {
           return loadTexturePalette().transform([&](auto palette) {
-            auto parser = IO::Md2Parser{modelName, reader, palette, m_fs};
+            auto parser = IO::Md2Parser{modelName, reader, palette, m_fs, skinCache};
             return parser.initializeModel(logger);
           });
         }
@@ -485,22 +691,22 @@ std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(
         }
         if (IO::Md3Parser::canParse(path, reader))
         {
-          auto parser = IO::Md3Parser{modelName, reader, m_fs};
+          auto parser = IO::Md3Parser{modelName, reader, m_fs, skinCache};
           return parser.initializeModel(logger);
         }
         if (IO::MdxParser::canParse(path, reader))
         {
-          auto parser = IO::MdxParser{modelName, reader, m_fs};
+          auto parser = IO::MdxParser{modelName, reader, m_fs, skinCache};
           return parser.initializeModel(logger);
         }
         if (IO::DkmParser::canParse(path, reader))
         {
-          auto parser = IO::DkmParser{modelName, reader, m_fs};
+          auto parser = IO::DkmParser{modelName, reader, m_fs, skinCache};
           return parser.initializeModel(logger);
         }
         if (IO::AseParser::canParse(path))
         {
-          auto parser = IO::AseParser{modelName, reader.stringView(), m_fs};
+          auto parser = IO::AseParser{modelName, reader.stringView(), m_fs, skinCache};
           return parser.initializeModel(logger);
         }
         if (IO::ImageSpriteParser::canParse(path))
@@ -510,7 +716,7 @@ std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(
         }
         if (IO::AssimpParser::canParse(path))
         {
-          auto parser = IO::AssimpParser{path, m_fs};
+          auto parser = IO::AssimpParser{path, m_fs, cacheDirectory};
           return parser.initializeModel(logger);
         }
         return Error{"Unknown model format: '" + path.string() + "'"};
@@ -522,8 +728,15 @@ std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(
   }
   catch (const ParserException& e)
   {
-    throw GameException{
-      "Could not load model " + path.string() + ": " + std::string{e.what()}};
+    throw modelLoadException(path, e);
+  }
+  catch (const AssetException& e)
+  {
+    throw modelLoadException(path, e);
+  }
+  catch (const IO::ReaderException& e)
+  {
+    throw modelLoadException(path, e);
   }
 }
 
@@ -617,8 +830,15 @@ void GameImpl::doLoadFrame(
   }
   catch (const ParserException& e)
   {
-    throw GameException{
-      "Could not load model " + path.string() + ": " + std::string{e.what()}};
+    throw modelLoadException(path, e);
+  }
+  catch (const AssetException& e)
+  {
+    throw modelLoadException(path, e);
+  }
+  catch (const IO::ReaderException& e)
+  {
+    throw modelLoadException(path, e);
   }
 }
 
@@ -687,12 +907,6 @@ const std::vector<CompilationTool>& GameImpl::doCompilationTools() const
   return m_config.compilationTools;
 }
 
-EntityPropertyConfig GameImpl::entityPropertyConfig() const
-{
-  return {
-    m_config.entityConfig.scaleExpression, m_config.entityConfig.setDefaultProperties};
-}
-
 void GameImpl::writeLongAttribute(
   EntityNodeBase& node,
   const std::string& baseName,
@@ -38,6 +38,7 @@ class Logger;
 namespace TrenchBroom::Assets
 {
 class Palette;
+class SkinCache;
 } // namespace TrenchBroom::Assets
 
 namespace TrenchBroom::Model
@@ -70,6 +71,7 @@ private:
   const CompilationConfig& doCompilationConfig() override;
 
   size_t doMaxPropertyLength() const override;
+  EntityPropertyConfig doEntityPropertyConfig() const override;
 
   std::optional<vm::bbox3> doSoftMapBounds() const override;
   SoftMapBounds doExtractSoftMapBounds(const Entity& entity) const override;
@@ -83,10 +85,16 @@ private:
     const vm::bbox3& worldBounds,
     const std::filesystem::path& path,
     Logger& logger) const override;
-  Result<void> doWriteMap(
-    WorldNode& world, const std::filesystem::path& path, bool exporting) const;
+  std::unique_ptr<WorldNode> loadMap(
+    MapFormat format,
+    const vm::bbox3& worldBounds,
+    const std::filesystem::path& path,
+    std::string_view mapContents,
+    Logger& logger) const;
+  void doWriteMap(WorldNode& world, std::ostream& stream, bool exporting) const;
   Result<void> doWriteMap(
     WorldNode& world, const std::filesystem::path& path) const override;
+  void doWriteMap(WorldNode& world, std::ostream& stream) const override;
   Result<void> doExportMap(
     WorldNode& world, const IO::ExportOptions& options) const override;
 
@@ -111,6 +119,9 @@ private:
     std::ostream& stream) const override;
 
   void doLoadTextureCollections(Assets::TextureManager& textureManager) const override;
+  std::optional<size_t> doReloadModifiedTextures(
+    Assets::TextureManager& textureManager,
+    const std::filesystem::path& directory) override;
 
   const std::optional<std::string>& doGetWadProperty() const override;
   void doReloadWads(
@@ -130,10 +141,15 @@ private:
     const std::vector<std::filesystem::path>& searchPaths) const override;
 
   Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> loadEntityDefinitions(
-    IO::ParserStatus& status, const std::filesystem::path& path) const override;
+    IO::ParserStatus& status,
+    const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory) const override;
 
   std::unique_ptr<Assets::EntityModel> doInitializeModel(
-    const std::filesystem::path& path, Logger& logger) const override;
+    const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory,
+    Assets::SkinCache* skinCache,
+    Logger& logger) const override;
   void doLoadFrame(
     const std::filesystem::path& path,
     size_t frameIndex,
@@ -152,8 +168,6 @@ private:
   const std::vector<CompilationTool>& doCompilationTools() const override;
 
 private:
-  EntityPropertyConfig entityPropertyConfig() const;
-
   void writeLongAttribute(
     EntityNodeBase& node,
     const std::string& baseName,
@@ -24,6 +24,7 @@
 #include "FloatType.h"
 #include "Model/Brush.h"
 #include "Model/BrushNode.h"
+#include "Model/ContentHasher.h"
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
 #include "Model/LayerNode.h"
@@ -67,6 +68,18 @@ Group GroupNode::setGroup(Group group)
 {
   using std::swap;
   swap(m_group, group);
+  invalidateContentHash();
+
+  // setting the group does not notify the ancestors of a change, so we must record it
+  for (auto* groupNode = containingGroup(); groupNode;
+       groupNode = groupNode->containingGroup())
+  {
+    if (!groupNode->m_hasStructuralChanges)
+    {
+      groupNode->m_changedDescendants.insert(this);
+    }
+  }
+
   return group;
 }
 
@@ -107,11 +120,13 @@ const std::optional<IdType>& GroupNode::persistentId() const
 void GroupNode::setPersistentId(const IdType persistentId)
 {
   m_persistentId = persistentId;
+  invalidateContentHash();
 }
 
 void GroupNode::resetPersistentId()
 {
   m_persistentId = std::nullopt;
+  invalidateContentHash();
 }
 
 bool GroupNode::hasPendingChanges() const
@@ -124,6 +139,22 @@ void GroupNode::setHasPendingChanges(const bool hasPendingChanges)
   m_hasPendingChanges = hasPendingChanges;
 }
 
+bool GroupNode::canUpdateLinkedGroupsIncrementally() const
+{
+  return !m_hasStructuralChanges && !m_changedDescendants.empty();
+}
+
+const std::unordered_set<Node*>& GroupNode::changedDescendants() const
+{
+  return m_changedDescendants;
+}
+
+void GroupNode::resetChangeTracking()
+{
+  m_changedDescendants.clear();
+  m_hasStructuralChanges = false;
+}
+
 void GroupNode::setEditState(const EditState editState)
 {
   m_editState = editState;
@@ -237,12 +268,33 @@ bool GroupNode::doShouldAddToSpacialIndex() const
 
 void GroupNode::doChildWasAdded(Node* /* node */)
 {
-  nodePhysicalBoundsDidChange();
+  nodePhysicalBoundsDidChange(cachedBounds());
 }
 
 void GroupNode::doChildWasRemoved(Node* /* node */)
 {
-  nodePhysicalBoundsDidChange();
+  nodePhysicalBoundsDidChange(cachedBounds());
+}
+
+void GroupNode::doDescendantWasAdded(Node* /* node */, const size_t /* depth */)
+{
+  m_hasStructuralChanges = true;
+  m_changedDescendants.clear();
+}
+
+void GroupNode::doDescendantWasRemoved(
+  Node* /* oldParent */, Node* /* node */, const size_t /* depth */)
+{
+  m_hasStructuralChanges = true;
+  m_changedDescendants.clear();
+}
+
+void GroupNode::doDescendantDidChange(Node* node)
+{
+  if (!m_hasStructuralChanges)
+  {
+    m_changedDescendants.insert(node);
+  }
 }
 
 void GroupNode::doNodePhysicalBoundsDidChange()
@@ -250,10 +302,28 @@ void GroupNode::doNodePhysicalBoundsDidChange()
   invalidateBounds();
 }
 
-void GroupNode::doChildPhysicalBoundsDidChange()
+void GroupNode::doChildPhysicalBoundsDidChange(
+  Node* node, const std::optional<NodeBounds>& oldChildBounds)
 {
-  invalidateBounds();
-  nodePhysicalBoundsDidChange();
+  const auto oldBounds = cachedBounds();
+  auto newBounds = oldBounds;
+  if (
+    newBounds && oldChildBounds
+    && updateChildBounds(*newBounds, *node, *oldChildBounds))
+  {
+    // only notify the parent if the union of the child bounds has changed
+    if (newBounds != oldBounds)
+    {
+      m_logicalBounds = newBounds->logicalBounds;
+      m_physicalBounds = newBounds->physicalBounds;
+      propagatePhysicalBoundsChange(oldBounds);
+    }
+  }
+  else
+  {
+    invalidateBounds();
+    propagatePhysicalBoundsChange(oldBounds);
+  }
 }
 
 bool GroupNode::doSelectable() const
@@ -261,6 +331,18 @@ bool GroupNode::doSelectable() const
   return true;
 }
 
+std::uint64_t GroupNode::doGetContentHash() const
+{
+  auto hasher = ContentHasher{};
+  hasher.add(m_group.name());
+  for (size_t i = 0; i < 4; ++i)
+  {
+    hasher.add(m_group.transformation()[i]);
+  }
+  hasher.add(m_persistentId).add(linkId());
+  return hasher.hash();
+}
+
 void GroupNode::doPick(const EditorContext&, const vm::ray3& /* ray */, PickResult&)
 {
   // For composite nodes (Groups, brush entities), pick rays don't hit the group
@@ -309,6 +391,17 @@ GroupNode* GroupNode::doGetContainingGroup()
   return findContainingGroup(this);
 }
 
+void GroupNode::doLinkIdDidChange()
+{
+  invalidateContentHash();
+}
+
+std::optional<NodeBounds> GroupNode::cachedBounds() const
+{
+  return m_boundsValid ? std::optional{NodeBounds{m_logicalBounds, m_physicalBounds}}
+                       : std::nullopt;
+}
+
 void GroupNode::invalidateBounds()
 {
   m_boundsValid = false;
@@ -32,6 +32,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -70,6 +71,14 @@ private:
 
   bool m_hasPendingChanges = false;
 
+  /**
+   * The descendants of this group whose contents changed since the change tracking was
+   * last reset. If descendants were added or removed, the changes cannot be tracked per
+   * node anymore and m_hasStructuralChanges is set instead.
+   */
+  std::unordered_set<Node*> m_changedDescendants;
+  bool m_hasStructuralChanges = false;
+
 public:
   explicit GroupNode(Group group);
 
@@ -89,6 +98,18 @@ public:
   bool hasPendingChanges() const;
   void setHasPendingChanges(bool hasPendingChanges);
 
+  /**
+   * Indicates whether the changes made to this group's descendants since the change
+   * tracking was last reset are known per node, i.e., whether no descendants were added
+   * or removed and at least one descendant changed.
+   *
+   * If this returns true, then the members of this group's link set can be updated
+   * incrementally from the nodes returned by changedDescendants().
+   */
+  bool canUpdateLinkedGroupsIncrementally() const;
+  const std::unordered_set<Node*>& changedDescendants() const;
+  void resetChangeTracking();
+
 private:
   void setEditState(EditState editState);
   void setAncestorEditState(EditState editState);
@@ -113,12 +134,18 @@ private: // implement methods inherited from Node
 
   void doChildWasAdded(Node* node) override;
   void doChildWasRemoved(Node* node) override;
+  void doDescendantWasAdded(Node* node, size_t depth) override;
+  void doDescendantWasRemoved(Node* oldParent, Node* node, size_t depth) override;
+  void doDescendantDidChange(Node* node) override;
 
   void doNodePhysicalBoundsDidChange() override;
-  void doChildPhysicalBoundsDidChange() override;
+  void doChildPhysicalBoundsDidChange(
+    Node* node, const std::optional<NodeBounds>& oldChildBounds) override;
 
   bool doSelectable() const override;
 
+  std::uint64_t doGetContentHash() const override;
+
   void doPick(
     const EditorContext& editorContext,
     const vm::ray3& ray,
@@ -132,8 +159,10 @@ private: // implement methods inherited from Object
   Node* doGetContainer() override;
   LayerNode* doGetContainingLayer() override;
   GroupNode* doGetContainingGroup() override;
+  void doLinkIdDidChange() override;
 
 private:
+  std::optional<NodeBounds> cachedBounds() const;
   void invalidateBounds();
   void validateBounds() const;
 
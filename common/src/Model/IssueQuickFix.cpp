@@ -22,9 +22,14 @@
 #include "Model/Issue.h"
 #include "Model/MapFacade.h"
 #include "Model/PushSelection.h"
+#include "Model/WorldNode.h"
 
+#include <algorithm>
 #include <cassert>
+#include <map>
+#include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom
@@ -53,6 +58,26 @@ IssueQuickFix::IssueQuickFix(
 {
 }
 
+IssueQuickFix::IssueQuickFix(
+  IssueType issueType, std::string description, MultiIssueFix fix)
+  : IssueQuickFix{
+    std::move(description),
+    [=](MapFacade& facade, const std::vector<const Issue*>& issues) {
+      auto issuesOfType = std::vector<const Issue*>{};
+      std::copy_if(
+        issues.begin(),
+        issues.end(),
+        std::back_inserter(issuesOfType),
+        [&](const auto* issue) { return issue->type() == issueType; });
+
+      if (!issuesOfType.empty())
+      {
+        fix(facade, issuesOfType);
+      }
+    }}
+{
+}
+
 IssueQuickFix::~IssueQuickFix() = default;
 
 const std::string& IssueQuickFix::description() const
@@ -75,20 +100,11 @@ IssueQuickFix makeDeleteNodesQuickFix()
 
 IssueQuickFix makeRemoveEntityPropertiesQuickFix(const IssueType type)
 {
-  return {type, "Delete Property", [](MapFacade& facade, const Issue& issue) {
-            const auto pushSelection = PushSelection{facade};
-
-            const auto& entityPropertyIssue =
-              static_cast<const EntityPropertyIssue&>(issue);
-
-            // If world node is affected, the selection will fail, but if nothing is
-            // selected, the removeProperty call will correctly affect worldspawn
-            // either way.
-
-            facade.deselectAll();
-            facade.selectNodes({&issue.node()});
-            facade.removeProperty(entityPropertyIssue.propertyKey());
-          }};
+  return makeTransformEntityPropertiesQuickFix(
+    type,
+    "Delete Property",
+    [](const auto&) { return std::string{}; },
+    [](const auto&) { return std::string{}; });
 }
 
 IssueQuickFix makeTransformEntityPropertiesQuickFix(
@@ -97,38 +113,74 @@ IssueQuickFix makeTransformEntityPropertiesQuickFix(
   std::function<std::string(const std::string&)> keyTransform,
   std::function<std::string(const std::string&)> valueTransform)
 {
-  return {type, std::move(description), [=](MapFacade& facade, const Issue& issue) {
-            const auto pushSelection = PushSelection{facade};
-
-            const auto& propIssue = static_cast<const EntityPropertyIssue&>(issue);
-            const auto& oldkey = propIssue.propertyKey();
-            const auto& oldValue = propIssue.propertyValue();
-            const auto newKey = keyTransform(oldkey);
-            const auto newValue = valueTransform(oldValue);
-
-            // If world node is affected, the selection will fail, but if nothing is
-            // selected, the removeProperty call will correctly affect worldspawn
-            // either way.
+  return {
+    type,
+    std::move(description),
+    [=](MapFacade& facade, const std::vector<const Issue*>& issues) {
+      const auto pushSelection = PushSelection{facade};
 
-            facade.deselectAll();
-            facade.selectNodes({&issue.node()});
+      // group the nodes by the change that fixes their issue
+      // old key, new key, and the new value if it differs from the old value
+      using Change = std::tuple<std::string, std::string, std::optional<std::string>>;
+      auto nodesByChange = std::map<Change, std::vector<Node*>>{};
+      for (const auto* issue : issues)
+      {
+        const auto& propIssue = static_cast<const EntityPropertyIssue&>(*issue);
+        const auto& oldKey = propIssue.propertyKey();
+        const auto& oldValue = propIssue.propertyValue();
+        const auto newKey = keyTransform(oldKey);
+        auto newValue = std::optional<std::string>{};
+        if (!newKey.empty())
+        {
+          if (auto value = valueTransform(oldValue); value != oldValue)
+          {
+            newValue = std::move(value);
+          }
+        }
+        nodesByChange[{oldKey, newKey, newValue}].push_back(&issue->node());
+      }
 
-            if (newKey.empty())
+      for (auto& [change, nodes] : nodesByChange)
+      {
+        const auto applyChange = [&, &change = change]() {
+          const auto& [oldKey, newKey, newValue] = change;
+          if (newKey.empty())
+          {
+            facade.removeProperty(oldKey);
+          }
+          else
+          {
+            if (newKey != oldKey)
             {
-              facade.removeProperty(propIssue.propertyKey());
+              facade.renameProperty(oldKey, newKey);
             }
-            else
+            if (newValue)
             {
-              if (newKey != oldkey)
-              {
-                facade.renameProperty(oldkey, newKey);
-              }
-              if (newValue != oldValue)
-              {
-                facade.setProperty(newKey, newValue);
-              }
+              facade.setProperty(newKey, *newValue);
             }
-          }};
+          }
+        };
+
+        facade.deselectAll();
+
+        // The world node cannot be selected, but if nothing is selected, the property
+        // is changed on worldspawn.
+        const auto worldIt = std::find_if(nodes.begin(), nodes.end(), [](auto* node) {
+          return dynamic_cast<WorldNode*>(node) != nullptr;
+        });
+        if (worldIt != nodes.end())
+        {
+          nodes.erase(worldIt);
+          applyChange();
+        }
+
+        if (!nodes.empty())
+        {
+          facade.selectNodes(nodes);
+          applyChange();
+        }
+      }
+    }};
 }
 } // namespace Model
 } // namespace TrenchBroom
@@ -43,7 +43,17 @@ private:
 
 public:
   IssueQuickFix(std::string description, MultiIssueFix fix);
+
+  /**
+   * Creates a quick fix that fixes the issues of the given type one at a time.
+   */
   IssueQuickFix(IssueType issueType, std::string description, SingleIssueFix fix);
+
+  /**
+   * Creates a quick fix that receives all issues of the given type at once, so that it
+   * can fix them with as few changes to the document as possible.
+   */
+  IssueQuickFix(IssueType issueType, std::string description, MultiIssueFix fix);
   virtual ~IssueQuickFix();
 
   const std::string& description() const;
@@ -55,6 +65,14 @@ IssueQuickFix makeDeleteNodesQuickFix();
 
 IssueQuickFix makeRemoveEntityPropertiesQuickFix(IssueType type);
 
+/**
+ * Creates a quick fix that replaces the key and the value of the property of each entity
+ * property issue of the given type with the results of the given transformations. If the
+ * transformed key is empty, the property is removed.
+ *
+ * Issues that require the same change are fixed together by selecting all of their nodes
+ * and changing the property once.
+ */
 IssueQuickFix makeTransformEntityPropertiesQuickFix(
   IssueType type,
   std::string description,
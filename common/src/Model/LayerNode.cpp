@@ -21,6 +21,7 @@
 
 #include "Ensure.h"
 #include "Model/BrushNode.h"
+#include "Model/ContentHasher.h"
 #include "Model/EntityNode.h"
 #include "Model/EntityProperties.h"
 #include "Model/GroupNode.h"
@@ -59,6 +60,7 @@ Layer LayerNode::setLayer(Layer layer)
 
   using std::swap;
   swap(m_layer, layer);
+  invalidateContentHash();
   return layer;
 }
 
@@ -82,6 +84,7 @@ const std::optional<IdType>& LayerNode::persistentId() const
 void LayerNode::setPersistentId(const IdType persistentId)
 {
   m_persistentId = persistentId;
+  invalidateContentHash();
 }
 
 const std::string& LayerNode::doGetName() const
@@ -155,6 +158,20 @@ bool LayerNode::doSelectable() const
   return false;
 }
 
+std::uint64_t LayerNode::doGetContentHash() const
+{
+  auto hasher = ContentHasher{};
+  hasher.add(m_layer.defaultLayer())
+    .add(m_layer.name())
+    .add(m_layer.hasSortIndex() ? std::optional{m_layer.sortIndex()} : std::nullopt)
+    .add(m_layer.color())
+    .add(m_layer.omitFromExport())
+    .add(m_persistentId)
+    .add(static_cast<int>(visibilityState()))
+    .add(static_cast<int>(lockState()));
+  return hasher.hash();
+}
+
 void LayerNode::doPick(const EditorContext&, const vm::ray3& /* ray */, PickResult&) {}
 
 void LayerNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result)
@@ -81,6 +81,8 @@ private: // implement Node interface
   void doNodePhysicalBoundsDidChange() override;
   bool doSelectable() const override;
 
+  std::uint64_t doGetContentHash() const override;
+
   void doPick(
     const EditorContext& editorContext,
     const vm::ray3& ray,
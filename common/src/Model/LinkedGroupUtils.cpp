@@ -19,6 +19,8 @@
 
 #include "LinkedGroupUtils.h"
 
+#include "Assets/AssetReference.h"
+#include "Assets/Texture.h"
 #include "Ensure.h"
 #include "Error.h"
 #include "Model/ModelUtils.h"
@@ -33,8 +35,10 @@
 #include "kdl/result_fold.h"
 #include "kdl/zip_iterator.h"
 
+#include <optional>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace TrenchBroom::Model
 {
@@ -201,6 +205,38 @@ FaceSelectionResult faceSelectionWithLinkedGroupConstraints(
 
 namespace
 {
+using CompactBrushMap = std::unordered_map<const Node*, Brush>;
+
+/**
+ * Returns compact copies of the brushes of the given brush nodes, indexed by their nodes.
+ *
+ * A transformed copy of a compact brush shares the topology of its geometry and only
+ * materializes the geometry when it is needed. The source brushes are therefore compacted
+ * once and then copied and transformed for each target group.
+ */
+template <typename N>
+CompactBrushMap makeCompactBrushes(const std::vector<N>& nodes)
+{
+  auto brushNodes = std::vector<const BrushNode*>{};
+  for (const auto* node : nodes)
+  {
+    if (const auto* brushNode = dynamic_cast<const BrushNode*>(node))
+    {
+      brushNodes.push_back(brushNode);
+    }
+  }
+
+  auto compactBrushes = kdl::vec_parallel_transform(
+    brushNodes, [](const auto* brushNode) { return brushNode->brush().compactCopy(); });
+
+  auto result = CompactBrushMap{};
+  for (size_t i = 0; i < brushNodes.size(); ++i)
+  {
+    result.emplace(brushNodes[i], std::move(compactBrushes[i]));
+  }
+  return result;
+}
+
 Result<std::unique_ptr<Node>> cloneAndTransformRecursive(
   const Node* nodeToClone,
   std::unordered_map<const Node*, NodeContents>& origNodeToTransformedContents,
@@ -268,7 +304,11 @@ Result<std::unique_ptr<Node>> cloneAndTransformRecursive(
  * Returns a vector of the cloned direct children of `node`.
  */
 Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
-  const Node& node, const vm::bbox3& worldBounds, const vm::mat4x4& transformation)
+  const Node& node,
+  const CompactBrushMap& compactBrushes,
+  const vm::bbox3& worldBounds,
+  const vm::mat4x4& transformation,
+  Assets::AssetUsageCountBatch<Assets::Texture>& textureUsageCounts)
 {
   auto nodesToClone = collectDescendants(std::vector{&node});
 
@@ -278,6 +318,7 @@ Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
   // `nodesToClone`
   auto transformResults =
     kdl::vec_parallel_transform(nodesToClone, [&](const Node* nodeToTransform) {
+      const auto activation = textureUsageCounts.activate();
       return nodeToTransform->accept(kdl::overload(
         [](const WorldNode*) -> TransformResult {
           ensure(false, "Linked group structure is valid");
@@ -296,7 +337,7 @@ Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
           return std::make_pair(nodeToTransform, NodeContents{std::move(entity)});
         },
         [&](const BrushNode* brushNode) -> TransformResult {
-          auto brush = brushNode->brush();
+          auto brush = compactBrushes.at(brushNode);
           return brush.transform(worldBounds, transformation, true)
             .and_then([&]() -> TransformResult {
               return std::make_pair(nodeToTransform, NodeContents{std::move(brush)});
@@ -396,25 +437,22 @@ void preserveGroupNames(
       [](const PatchNode*) {}));
 }
 
-void preserveEntityProperties(
-  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+bool hasProtectedProperties(const Entity& clonedEntity, const Entity& correspondingEntity)
 {
-  if (
-    clonedEntityNode.entity().protectedProperties().empty()
-    && correspondingEntityNode.entity().protectedProperties().empty())
-  {
-    return;
-  }
-
-  auto clonedEntity = clonedEntityNode.entity();
-  const auto& correspondingEntity = correspondingEntityNode.entity();
+  return !clonedEntity.protectedProperties().empty()
+         || !correspondingEntity.protectedProperties().empty();
+}
 
+void preserveEntityProperties(
+  Entity& clonedEntity,
+  const Entity& correspondingEntity,
+  const EntityPropertyConfig& entityPropertyConfig)
+{
   const auto allProtectedProperties = kdl::vec_sort_and_remove_duplicates(kdl::vec_concat(
     clonedEntity.protectedProperties(), correspondingEntity.protectedProperties()));
 
   clonedEntity.setProtectedProperties(correspondingEntity.protectedProperties());
 
-  const auto entityPropertyConfig = clonedEntityNode.entityPropertyConfig();
   for (const auto& propertyKey : allProtectedProperties)
   {
     // this can change the order of properties
@@ -424,7 +462,22 @@ void preserveEntityProperties(
       clonedEntity.addOrUpdateProperty(entityPropertyConfig, propertyKey, *propertyValue);
     }
   }
+}
+
+void preserveEntityProperties(
+  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+{
+  if (!hasProtectedProperties(
+        clonedEntityNode.entity(), correspondingEntityNode.entity()))
+  {
+    return;
+  }
 
+  auto clonedEntity = clonedEntityNode.entity();
+  preserveEntityProperties(
+    clonedEntity,
+    correspondingEntityNode.entity(),
+    clonedEntityNode.entityPropertyConfig());
   clonedEntityNode.setEntity(std::move(clonedEntity));
 }
 
@@ -463,6 +516,9 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   const std::vector<GroupNode*>& targetGroupNodes,
   const vm::bbox3& worldBounds)
 {
+  // the children of every target group are cloned in parallel
+  auto textureUsageCounts = Assets::AssetUsageCountBatch<Assets::Texture>{};
+
   const auto& sourceGroup = sourceGroupNode.group();
   const auto [success, invertedSourceTransformation] =
     vm::invert(sourceGroup.transformation());
@@ -474,11 +530,18 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   const auto _invertedSourceTransformation = invertedSourceTransformation;
   const auto targetGroupNodesToUpdate =
     kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
+  const auto compactBrushes =
+    makeCompactBrushes(collectDescendants(std::vector{&sourceGroupNode}));
   return kdl::fold_results(
     kdl::vec_transform(targetGroupNodesToUpdate, [&](auto* targetGroupNode) {
       const auto transformation =
         targetGroupNode->group().transformation() * _invertedSourceTransformation;
-      return cloneAndTransformChildren(sourceGroupNode, worldBounds, transformation)
+      return cloneAndTransformChildren(
+               sourceGroupNode,
+               compactBrushes,
+               worldBounds,
+               transformation,
+               textureUsageCounts)
         .transform([&](auto newChildren) {
           const auto linkIdToNodeMap = makeLinkIdToNodeMap(targetGroupNode->children());
           preserveGroupNames(newChildren, linkIdToNodeMap);
@@ -491,6 +554,241 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
 namespace
 {
 
+auto makeLinkIdToNodeMap(
+  const std::vector<Node*>& nodes, const std::unordered_set<std::string_view>& linkIds)
+{
+  auto result = std::unordered_map<std::string_view, Node*>{};
+
+  const auto addIfRequested = [&](auto* object, auto* node) {
+    if (const auto it = linkIds.find(object->linkId()); it != linkIds.end())
+    {
+      result[*it] = node;
+    }
+  };
+
+  Node::visitAll(
+    nodes,
+    kdl::overload(
+      [](auto&& thisLambda, WorldNode* worldNode) {
+        worldNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, LayerNode* layerNode) {
+        layerNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, GroupNode* groupNode) {
+        addIfRequested(groupNode, groupNode);
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, EntityNode* entityNode) {
+        addIfRequested(entityNode, entityNode);
+        entityNode->visitChildren(thisLambda);
+      },
+      [&](BrushNode* brushNode) { addIfRequested(brushNode, brushNode); },
+      [&](PatchNode* patchNode) { addIfRequested(patchNode, patchNode); }));
+  return result;
+}
+
+using TransformContentsResult = Result<std::optional<NodeContents>>;
+
+/**
+ * Transforms the contents of the given changed source node into the given target node.
+ *
+ * Returns std::nullopt if the target node is not of the same type as the source node.
+ */
+TransformContentsResult transformContents(
+  const Node& sourceNode,
+  const Node& targetNode,
+  const CompactBrushMap& compactBrushes,
+  const vm::bbox3& worldBounds,
+  const vm::mat4x4& transformation)
+{
+  return sourceNode.accept(kdl::overload(
+    [](const WorldNode*) -> TransformContentsResult {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const LayerNode*) -> TransformContentsResult {
+      ensure(false, "Linked group structure is valid");
+    },
+    [&](const GroupNode* sourceGroupNode) -> TransformContentsResult {
+      const auto* targetGroupNode = dynamic_cast<const GroupNode*>(&targetNode);
+      if (!targetGroupNode)
+      {
+        return std::nullopt;
+      }
+
+      auto group = sourceGroupNode->group();
+      group.transform(transformation);
+      group.setName(targetGroupNode->group().name());
+      return NodeContents{std::move(group)};
+    },
+    [&](const EntityNode* sourceEntityNode) -> TransformContentsResult {
+      const auto* targetEntityNode = dynamic_cast<const EntityNode*>(&targetNode);
+      if (!targetEntityNode)
+      {
+        return std::nullopt;
+      }
+
+      auto entity = sourceEntityNode->entity();
+      entity.transform(sourceEntityNode->entityPropertyConfig(), transformation);
+      if (hasProtectedProperties(entity, targetEntityNode->entity()))
+      {
+        preserveEntityProperties(
+          entity, targetEntityNode->entity(), targetEntityNode->entityPropertyConfig());
+      }
+
+      // the bounds of an entity with children are determined by its children
+      if (
+        !sourceEntityNode->hasChildren()
+        && !worldBounds.contains(EntityNode{entity}.logicalBounds()))
+      {
+        return Error{"Updating a linked node would exceed world bounds"};
+      }
+      return NodeContents{std::move(entity)};
+    },
+    [&](const BrushNode* sourceBrushNode) -> TransformContentsResult {
+      if (!dynamic_cast<const BrushNode*>(&targetNode))
+      {
+        return std::nullopt;
+      }
+
+      auto brush = compactBrushes.at(sourceBrushNode);
+      return brush.transform(worldBounds, transformation, true)
+        .and_then([&]() -> TransformContentsResult {
+          if (!worldBounds.contains(brush.bounds()))
+          {
+            return Error{"Updating a linked node would exceed world bounds"};
+          }
+          return NodeContents{std::move(brush)};
+        });
+    },
+    [&](const PatchNode* sourcePatchNode) -> TransformContentsResult {
+      if (!dynamic_cast<const PatchNode*>(&targetNode))
+      {
+        return std::nullopt;
+      }
+
+      auto patch = sourcePatchNode->patch();
+      patch.transform(transformation);
+      if (!worldBounds.contains(patch.bounds()))
+      {
+        return Error{"Updating a linked node would exceed world bounds"};
+      }
+      return NodeContents{std::move(patch)};
+    }));
+}
+
+std::string_view linkIdOf(const Node& node)
+{
+  return node.accept(kdl::overload(
+    [](const WorldNode*) { return std::string_view{}; },
+    [](const LayerNode*) { return std::string_view{}; },
+    [](const Object* object) { return std::string_view{object->linkId()}; }));
+}
+
+} // namespace
+
+Result<IncrementalUpdateLinkedGroupsResult> updateLinkedGroupsIncrementally(
+  const GroupNode& sourceGroupNode,
+  const std::vector<GroupNode*>& targetGroupNodes,
+  const vm::bbox3& worldBounds)
+{
+  assert(sourceGroupNode.canUpdateLinkedGroupsIncrementally());
+
+  // the changed nodes are cloned into every target group in parallel
+  auto textureUsageCounts = Assets::AssetUsageCountBatch<Assets::Texture>{};
+
+  const auto& sourceGroup = sourceGroupNode.group();
+  const auto [success, invertedSourceTransformation] =
+    vm::invert(sourceGroup.transformation());
+  if (!success)
+  {
+    return Error{"Group transformation is not invertible"};
+  }
+
+  const auto changedNodes = std::vector<const Node*>{
+    sourceGroupNode.changedDescendants().begin(),
+    sourceGroupNode.changedDescendants().end()};
+  auto changedLinkIds = std::unordered_set<std::string_view>{};
+  for (const auto* changedNode : changedNodes)
+  {
+    changedLinkIds.insert(linkIdOf(*changedNode));
+  }
+  const auto compactBrushes = makeCompactBrushes(changedNodes);
+
+  using TargetResult = Result<std::optional<std::vector<std::pair<Node*, NodeContents>>>>;
+
+  const auto _invertedSourceTransformation = invertedSourceTransformation;
+  const auto targetGroupNodesToUpdate =
+    kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
+  auto targetResults = kdl::vec_parallel_transform(
+    targetGroupNodesToUpdate, [&](auto* targetGroupNode) -> TargetResult {
+      const auto activation = textureUsageCounts.activate();
+      const auto transformation =
+        targetGroupNode->group().transformation() * _invertedSourceTransformation;
+      const auto linkIdToNodeMap =
+        makeLinkIdToNodeMap(targetGroupNode->children(), changedLinkIds);
+
+      auto targetNodes = std::vector<Node*>{};
+      targetNodes.reserve(changedNodes.size());
+      for (const auto* changedNode : changedNodes)
+      {
+        const auto it = linkIdToNodeMap.find(linkIdOf(*changedNode));
+        if (it == linkIdToNodeMap.end())
+        {
+          return std::nullopt;
+        }
+        targetNodes.push_back(it->second);
+      }
+
+      return kdl::fold_results(
+               kdl::vec_transform(
+                 kdl::make_zip_range(changedNodes, targetNodes),
+                 [&](const auto& changedAndTargetNode) {
+                   const auto& [changedNode, targetNode] = changedAndTargetNode;
+                   return transformContents(
+                     *changedNode,
+                     *targetNode,
+                     compactBrushes,
+                     worldBounds,
+                     transformation);
+                 }))
+        .transform([&](auto allContents) {
+          auto nodesToSwap = std::vector<std::pair<Node*, NodeContents>>{};
+          nodesToSwap.reserve(allContents.size());
+          for (size_t i = 0; i < allContents.size(); ++i)
+          {
+            if (!allContents[i])
+            {
+              return std::optional<std::vector<std::pair<Node*, NodeContents>>>{};
+            }
+            nodesToSwap.emplace_back(targetNodes[i], std::move(*allContents[i]));
+          }
+          return std::optional{std::move(nodesToSwap)};
+        });
+    });
+
+  return kdl::fold_results(std::move(targetResults))
+    .transform([&](auto targetNodesToSwap) {
+      auto result = IncrementalUpdateLinkedGroupsResult{};
+      for (size_t i = 0; i < targetNodesToSwap.size(); ++i)
+      {
+        if (auto& nodesToSwap = targetNodesToSwap[i])
+        {
+          result.nodesToSwap = kdl::vec_concat(
+            std::move(result.nodesToSwap), std::move(*nodesToSwap));
+        }
+        else
+        {
+          result.groupsToUpdateFully.push_back(targetGroupNodesToUpdate[i]);
+        }
+      }
+      return result;
+    });
+}
+
+namespace
+{
+
 template <typename N1, typename N2>
 Result<N1*> tryCast(N2& targetNode)
 {
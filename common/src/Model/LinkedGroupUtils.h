@@ -25,6 +25,7 @@
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
+#include "Model/NodeContents.h"
 #include "Model/NodeVisitor.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
@@ -137,6 +138,34 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   const std::vector<Model::GroupNode*>& targetGroupNodes,
   const vm::bbox3& worldBounds);
 
+struct IncrementalUpdateLinkedGroupsResult
+{
+  std::vector<std::pair<Node*, NodeContents>> nodesToSwap;
+  std::vector<GroupNode*> groupsToUpdateFully;
+};
+
+/**
+ * Updates the given target group nodes from the given source group node by transforming
+ * only the changed descendants of the source group node (see
+ * GroupNode::changedDescendants) into the target groups. The source group node must be
+ * able to update its linked groups incrementally.
+ *
+ * For each changed descendant, the node with the same link ID is looked up in each target
+ * group, and its new contents are computed by transforming the changed descendant's
+ * contents in the same way as updateLinkedGroups does. Group names and protected entity
+ * properties of the target nodes are preserved.
+ *
+ * If a target group does not contain a node of the same type with the link ID of a
+ * changed descendant, then it cannot be updated incrementally and is returned in
+ * groupsToUpdateFully instead.
+ *
+ * The operation fails under the same conditions as updateLinkedGroups.
+ */
+Result<IncrementalUpdateLinkedGroupsResult> updateLinkedGroupsIncrementally(
+  const GroupNode& sourceGroupNode,
+  const std::vector<GroupNode*>& targetGroupNodes,
+  const vm::bbox3& worldBounds);
+
 std::vector<Error> initializeLinkIds(const std::vector<Node*>& nodes);
 
 
@@ -24,8 +24,6 @@
 #include "Model/EntityNode.h"
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
-#include "Model/MapFacade.h"
-#include "Model/PushSelection.h"
 
 #include <string>
 #include <vector>
@@ -40,21 +38,11 @@ static const auto Type = freeIssueType();
 
 IssueQuickFix makeTruncatePropertyValueQuickFix(const size_t maxLength)
 {
-  return {Type, "Truncate Property Values", [=](MapFacade& facade, const Issue& issue) {
-            const auto pushSelection = PushSelection{facade};
-
-            const auto& propIssue = static_cast<const EntityPropertyIssue&>(issue);
-            const auto& propertyName = propIssue.propertyKey();
-            const auto& propertyValue = propIssue.propertyValue();
-
-            // If world node is affected, the selection will fail, but if nothing is
-            // selected, the removeProperty call will correctly affect worldspawn either
-            // way.
-
-            facade.deselectAll();
-            facade.selectNodes({&issue.node()});
-            facade.setProperty(propertyName, propertyValue.substr(0, maxLength));
-          }};
+  return makeTransformEntityPropertiesQuickFix(
+    Type,
+    "Truncate Property Values",
+    [](const auto& key) { return key; },
+    [=](const auto& value) { return value.substr(0, maxLength); });
 }
 } // namespace
 
@@ -25,10 +25,18 @@
 #include "Model/BrushFaceHandle.h"
 #include "Model/EditorContext.h"
 #include "Model/NodeQueries.h"
+#include "Model/Validator.h"
+#include "Model/WorldNode.h"
 #include "Polyhedron.h"
+#include "Profiler.h"
+#include "octree.h"
 
+#include "kdl/parallel.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom::Model
@@ -232,6 +240,78 @@ static std::vector<Node*> collectMatchingNodes(
   return result;
 }
 
+/**
+ * Collects the nodes that match the given predicate like the function above, but only
+ * tests the nodes whose bounds the node tree of the given world finds to intersect the
+ * bounds of any of the given brushes. The predicate is evaluated in parallel.
+ *
+ * A closed group is only tested if the node tree finds one of its members.
+ */
+template <typename P>
+static std::vector<Node*> collectMatchingNodes(
+  const WorldNode& worldNode, const std::vector<BrushNode*>& brushes, const P& predicate)
+{
+  auto candidates = std::vector<Node*>{};
+  auto visited = std::unordered_set<Node*>{};
+  const auto addCandidate = [&](auto* node) {
+    if (visited.insert(node).second)
+    {
+      candidates.push_back(node);
+    }
+  };
+
+  for (const auto* brush : brushes)
+  {
+    // accessing the faces expands compact brush geometry, which must not happen
+    // concurrently when the brushes are tested on multiple threads below
+    brush->brush().faces();
+
+    for (auto* node : worldNode.nodeTree().find_intersectors(brush->physicalBounds()))
+    {
+      if (auto* group = findOutermostClosedGroup(node))
+      {
+        addCandidate(group);
+        continue;
+      }
+
+      node->accept(kdl::overload(
+        [](WorldNode*) {},
+        [](LayerNode*) {},
+        [](GroupNode*) {},
+        [&](EntityNode* entity) {
+          if (!entity->hasChildren())
+          {
+            addCandidate(entity);
+          }
+        },
+        [&](BrushNode* brushNode) {
+          // if `brushNode` is one of the search query nodes, don't count it as matching
+          if (!kdl::vec_contains(brushes, brushNode))
+          {
+            addCandidate(brushNode);
+          }
+        },
+        [&](PatchNode* patch) { addCandidate(patch); }));
+    }
+  }
+
+  const auto matches = kdl::vec_parallel_transform(candidates, [&](const Node* node) {
+    return std::any_of(brushes.begin(), brushes.end(), [&](const auto* brush) {
+      return predicate(node, brush);
+    });
+  });
+
+  auto result = std::vector<Node*>{};
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    if (matches[i])
+    {
+      result.push_back(candidates[i]);
+    }
+  }
+  return result;
+}
+
 std::vector<Node*> collectTouchingNodes(
   const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes)
 {
@@ -248,6 +328,24 @@ std::vector<Node*> collectContainedNodes(
   });
 }
 
+std::vector<Node*> collectTouchingNodes(
+  const WorldNode& worldNode, const std::vector<BrushNode*>& brushes)
+{
+  return collectMatchingNodes(
+    worldNode, brushes, [](const auto* node, const auto* brush) {
+      return brush->intersects(node);
+    });
+}
+
+std::vector<Node*> collectContainedNodes(
+  const WorldNode& worldNode, const std::vector<BrushNode*>& brushes)
+{
+  return collectMatchingNodes(
+    worldNode, brushes, [](const auto* node, const auto* brush) {
+      return brush->contains(node);
+    });
+}
+
 std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes)
 {
   return collectNodesAndDescendants(
@@ -348,6 +446,168 @@ vm::bbox3 computePhysicalBounds(
   return builder.initialized() ? builder.bounds() : defaultBounds;
 }
 
+bool updateUnitedBounds(
+  vm::bbox3& bounds, const vm::bbox3& oldBounds, const vm::bbox3& newBounds)
+{
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (
+      (oldBounds.min[i] <= bounds.min[i] && newBounds.min[i] > oldBounds.min[i])
+      || (oldBounds.max[i] >= bounds.max[i] && newBounds.max[i] < oldBounds.max[i]))
+    {
+      return false;
+    }
+  }
+
+  bounds = vm::merge(bounds, newBounds);
+  return true;
+}
+
+bool updateChildBounds(
+  NodeBounds& bounds, const Node& child, const NodeBounds& oldChildBounds)
+{
+  auto newBounds = bounds;
+  if (
+    updateUnitedBounds(
+      newBounds.logicalBounds, oldChildBounds.logicalBounds, child.logicalBounds())
+    && updateUnitedBounds(
+      newBounds.physicalBounds, oldChildBounds.physicalBounds, child.physicalBounds()))
+  {
+    bounds = newBounds;
+    return true;
+  }
+  return false;
+}
+
+size_t estimateMemoryUsage(const std::vector<Node*>& nodes)
+{
+  auto result = size_t(0);
+  for (const auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [&](auto&& thisLambda, const WorldNode* world) {
+        result += sizeof(WorldNode) + world->entity().memoryUsage();
+        world->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const LayerNode* layer) {
+        result += sizeof(LayerNode);
+        layer->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const GroupNode* group) {
+        result += sizeof(GroupNode);
+        group->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const EntityNode* entity) {
+        result += sizeof(EntityNode) + entity->entity().memoryUsage();
+        entity->visitChildren(thisLambda);
+      },
+      [&](const BrushNode* brush) {
+        result += sizeof(BrushNode) + brush->brush().memoryUsage();
+      },
+      [&](const PatchNode* patch) {
+        result += sizeof(PatchNode) + patch->patch().memoryUsage();
+      }));
+  }
+  return result;
+}
+
+namespace
+{
+size_t nodeTypeIndex(const Node* node)
+{
+  return node->accept(kdl::overload(
+    [](const WorldNode*) { return size_t(0); },
+    [](const LayerNode*) { return size_t(1); },
+    [](const GroupNode*) { return size_t(2); },
+    [](const EntityNode*) { return size_t(3); },
+    [](const BrushNode*) { return size_t(4); },
+    [](const PatchNode*) { return size_t(5); }));
+}
+} // namespace
+
+std::vector<Node*> collectNodesWithInvalidIssues(const std::vector<Node*>& nodes)
+{
+  auto invalidNodes = std::vector<Node*>{};
+  for (auto* node : nodes)
+  {
+    const auto collectInvalidNode = [&](Node* n) {
+      if (!n->issuesValid())
+      {
+        invalidNodes.push_back(n);
+      }
+    };
+
+    node->accept(kdl::overload(
+      [&](auto&& thisLambda, WorldNode* world) {
+        collectInvalidNode(world);
+        world->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, LayerNode* layer) {
+        collectInvalidNode(layer);
+        layer->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, GroupNode* group) {
+        collectInvalidNode(group);
+        group->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, EntityNode* entity) {
+        collectInvalidNode(entity);
+        entity->visitChildren(thisLambda);
+      },
+      [&](BrushNode* brush) { collectInvalidNode(brush); },
+      [&](PatchNode* patch) { collectInvalidNode(patch); }));
+  }
+
+  return invalidNodes;
+}
+
+void validateIssues(
+  const std::vector<Node*>& nodes, const std::vector<const Validator*>& validators)
+{
+  validateNodeIssues(collectNodesWithInvalidIssues(nodes), validators);
+}
+
+void validateNodeIssues(
+  const std::vector<Node*>& nodes, const std::vector<const Validator*>& validators)
+{
+  const auto zone = ProfilerZone{"Model::validateNodeIssues"};
+
+  auto invalidNodes =
+    kdl::vec_filter(nodes, [](const auto* node) { return !node->issuesValid(); });
+
+  // group the nodes by type so that every batch runs the same validator code paths
+  std::stable_sort(
+    invalidNodes.begin(), invalidNodes.end(), [](const auto* lhs, const auto* rhs) {
+      return nodeTypeIndex(lhs) < nodeTypeIndex(rhs);
+    });
+
+  // each batch runs one validator after the other so that each validator can be timed
+  constexpr auto BatchSize = size_t(256);
+  const auto batchCount = (invalidNodes.size() + BatchSize - 1) / BatchSize;
+
+  kdl::parallel_for(batchCount, [&](const size_t batchIndex) {
+    const auto first = batchIndex * BatchSize;
+    const auto last = std::min(first + BatchSize, invalidNodes.size());
+    const auto batchZone = ProfilerZone{"Model::validateNodeIssues batch"};
+
+    for (const auto* validator : validators)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      for (auto i = first; i < last; ++i)
+      {
+        invalidNodes[i]->addIssues(*validator);
+      }
+      validator->addValidationStatistics(
+        std::chrono::steady_clock::now() - start, last - first);
+    }
+
+    for (auto i = first; i < last; ++i)
+    {
+      invalidNodes[i]->setIssuesValid();
+    }
+  });
+}
+
 std::vector<BrushNode*> filterBrushNodes(const std::vector<Node*>& nodes)
 {
   auto result = std::vector<BrushNode*>{};
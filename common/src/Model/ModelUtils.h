@@ -37,7 +37,10 @@ class GroupNode;
 class BrushNode;
 class EntityNode;
 class LayerNode;
+class WorldNode;
 class EditorContext;
+class Validator;
+struct NodeBounds;
 
 HitType::Type nodeHitType();
 
@@ -65,6 +68,16 @@ std::vector<Node*> collectTouchingNodes(
 std::vector<Node*> collectContainedNodes(
   const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
 
+/**
+ * Like the functions above, but only tests the nodes of the given world that the world's
+ * node tree finds near the given brushes, and tests them in parallel. Closed groups are
+ * found through their members. The order of the returned nodes is unspecified.
+ */
+std::vector<Node*> collectTouchingNodes(
+  const WorldNode& worldNode, const std::vector<BrushNode*>& brushes);
+std::vector<Node*> collectContainedNodes(
+  const WorldNode& worldNode, const std::vector<BrushNode*>& brushes);
+
 std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes);
 
 std::vector<Node*> collectSelectableNodes(
@@ -79,7 +92,58 @@ vm::bbox3 computeLogicalBounds(
 vm::bbox3 computePhysicalBounds(
   const std::vector<Node*>& nodes, const vm::bbox3& defaultBounds = vm::bbox3());
 
+/**
+ * Updates the given bounds, which are the union of a number of bounds, after one of the
+ * united bounds changed from the given old bounds to the given new bounds.
+ *
+ * The union can only be updated if it doesn't shrink. This is the case if the old bounds
+ * don't touch the boundary of the union, or if the new bounds reach at least as far.
+ * Returns false if the union might have shrunk, in which case it must be recomputed and
+ * the given bounds are left unchanged.
+ */
+bool updateUnitedBounds(
+  vm::bbox3& bounds, const vm::bbox3& oldBounds, const vm::bbox3& newBounds);
+
+/**
+ * Updates the given bounds of a node, which are the union of the bounds of its children,
+ * after the bounds of the given child changed from the given old bounds. Returns false
+ * if the bounds must be recomputed, see updateUnitedBounds.
+ */
+bool updateChildBounds(
+  NodeBounds& bounds, const Node& child, const NodeBounds& oldChildBounds);
+
 std::vector<BrushNode*> filterBrushNodes(const std::vector<Node*>& nodes);
 std::vector<EntityNode*> filterEntityNodes(const std::vector<Node*>& nodes);
 
+/**
+ * Returns an estimate of the memory used by the given nodes and their descendants in
+ * bytes.
+ */
+size_t estimateMemoryUsage(const std::vector<Node*>& nodes);
+
+/**
+ * Returns those of the given nodes and their descendants whose issues are invalid.
+ */
+std::vector<Node*> collectNodesWithInvalidIssues(const std::vector<Node*>& nodes);
+
+/**
+ * Validates the issues of those of the given nodes and their descendants whose issues
+ * are invalid. The nodes are validated in parallel, so this must not be called while the
+ * nodes are being modified.
+ *
+ * The nodes are grouped by type and split into batches. For each batch, the validators
+ * are run one after the other, and the time spent by each validator is added to its
+ * validation statistics.
+ */
+void validateIssues(
+  const std::vector<Node*>& nodes, const std::vector<const Validator*>& validators);
+
+/**
+ * Validates the issues of those of the given nodes whose issues are invalid, but not the
+ * issues of their descendants. Every node must occur at most once, otherwise it would be
+ * validated concurrently.
+ */
+void validateNodeIssues(
+  const std::vector<Node*>& nodes, const std::vector<const Validator*>& validators);
+
 } // namespace TrenchBroom::Model
@@ -21,6 +21,7 @@
 
 #include "Ensure.h"
 #include "Macros.h"
+#include "Model/ContentHasher.h"
 #include "Model/EntityProperties.h"
 #include "Model/Issue.h"
 #include "Model/Validator.h"
@@ -29,6 +30,7 @@
 #include "kdl/vector_utils.h"
 
 #include "vm/bbox.h"
+#include "vm/bbox_io.h"
 
 #include <cassert>
 #include <iterator>
@@ -41,6 +43,8 @@ namespace TrenchBroom::Model
 
 kdl_reflect_impl(NodePath);
 
+kdl_reflect_impl(NodeBounds);
+
 Node::Node() = default;
 
 Node::~Node()
@@ -357,6 +361,7 @@ void Node::childWillBeAdded(Node* node)
 
 void Node::childWasAdded(Node* node)
 {
+  invalidateTreeHash();
   doChildWasAdded(node);
   descendantWasAdded(node, 1);
 }
@@ -369,6 +374,7 @@ void Node::childWillBeRemoved(Node* node)
 
 void Node::childWasRemoved(Node* node)
 {
+  invalidateTreeHash();
   doChildWasRemoved(node);
   descendantWasRemoved(this, node, 1);
 }
@@ -487,6 +493,8 @@ void Node::nodeWillChange()
     m_parent->childWillChange(this);
   }
   invalidateIssues();
+  invalidateSerializedNode();
+  invalidateContentHash();
 }
 
 void Node::nodeDidChange()
@@ -496,6 +504,8 @@ void Node::nodeDidChange()
     m_parent->childDidChange(this);
   }
   invalidateIssues();
+  invalidateSerializedNode();
+  invalidateContentHash();
 }
 
 Node::NotifyNodeChange::NotifyNodeChange(Node& node)
@@ -511,20 +521,26 @@ Node::NotifyNodeChange::~NotifyNodeChange()
 
 Node::NotifyPhysicalBoundsChange::NotifyPhysicalBoundsChange(Node& node)
   : m_node{node}
+  , m_oldBounds{node.logicalBounds(), node.physicalBounds()}
 {
 }
 
 Node::NotifyPhysicalBoundsChange::~NotifyPhysicalBoundsChange()
 {
-  m_node.nodePhysicalBoundsDidChange();
+  m_node.nodePhysicalBoundsDidChange(m_oldBounds);
 }
 
-void Node::nodePhysicalBoundsDidChange()
+void Node::nodePhysicalBoundsDidChange(const std::optional<NodeBounds>& oldBounds)
 {
   doNodePhysicalBoundsDidChange();
+  propagatePhysicalBoundsChange(oldBounds);
+}
+
+void Node::propagatePhysicalBoundsChange(const std::optional<NodeBounds>& oldBounds)
+{
   if (m_parent)
   {
-    m_parent->childPhysicalBoundsDidChange(this);
+    m_parent->childPhysicalBoundsDidChange(this, oldBounds);
   }
 }
 
@@ -560,10 +576,10 @@ void Node::descendantDidChange(Node* node)
   invalidateIssues();
 }
 
-void Node::childPhysicalBoundsDidChange(Node* node)
+void Node::childPhysicalBoundsDidChange(
+  Node* node, const std::optional<NodeBounds>& oldChildBounds)
 {
-  nodePhysicalBoundsDidChange();
-  doChildPhysicalBoundsDidChange();
+  doChildPhysicalBoundsDidChange(node, oldChildBounds);
   descendantPhysicalBoundsDidChange(node, 1);
 }
 
@@ -735,6 +751,8 @@ bool Node::setVisibilityState(const VisibilityState visibility)
   if (visibility != m_visibilityState)
   {
     m_visibilityState = visibility;
+    // layers write their visibility to the map file
+    invalidateContentHash();
     return true;
   }
   return false;
@@ -778,6 +796,8 @@ bool Node::setLockState(const LockState lockState)
   if (lockState != m_lockState)
   {
     m_lockState = lockState;
+    // layers write their lock state to the map file
+    invalidateContentHash();
     return true;
   }
   return false;
@@ -793,6 +813,11 @@ void Node::setLockedByOtherSelection(const bool lockedByOtherSelection)
   m_lockedByOtherSelection = lockedByOtherSelection;
 }
 
+EditorContextCache& Node::editorContextCache() const
+{
+  return m_editorContextCache;
+}
+
 void Node::pick(
   const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult)
 {
@@ -809,6 +834,11 @@ size_t Node::lineNumber() const
   return m_lineNumber;
 }
 
+size_t Node::lineCount() const
+{
+  return m_lineCount;
+}
+
 void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) const
 {
   m_lineNumber = lineNumber;
@@ -820,6 +850,63 @@ bool Node::containsLine(const size_t lineNumber) const
   return lineNumber >= m_lineNumber && lineNumber < m_lineNumber + m_lineCount;
 }
 
+const SerializedNode* Node::serializedNode(const MapFormat format) const
+{
+  return m_serializedNode && m_serializedNode->format == format ? &*m_serializedNode
+                                                                : nullptr;
+}
+
+void Node::setSerializedNode(SerializedNode serializedNode) const
+{
+  m_serializedNode = std::move(serializedNode);
+}
+
+void Node::invalidateSerializedNode() const
+{
+  m_serializedNode = std::nullopt;
+}
+
+std::uint64_t Node::contentHash() const
+{
+  if (!m_contentHash)
+  {
+    m_contentHash = doGetContentHash();
+  }
+  return *m_contentHash;
+}
+
+std::uint64_t Node::treeHash() const
+{
+  if (!m_treeHash)
+  {
+    auto hasher = ContentHasher{};
+    hasher.add(contentHash());
+    hasher.add(std::uint64_t(m_children.size()));
+    for (const auto* child : m_children)
+    {
+      hasher.add(child->treeHash());
+    }
+    m_treeHash = hasher.hash();
+  }
+  return *m_treeHash;
+}
+
+void Node::invalidateContentHash() const
+{
+  m_contentHash = std::nullopt;
+  invalidateTreeHash();
+}
+
+void Node::invalidateTreeHash() const
+{
+  // if a node's tree hash is valid, then so are the tree hashes of its descendants, so we
+  // can stop at the first ancestor whose tree hash is already invalid
+  for (const auto* node = this; node && node->m_treeHash; node = node->m_parent)
+  {
+    node->m_treeHash = std::nullopt;
+  }
+}
+
 std::vector<const Issue*> Node::issues(const std::vector<const Validator*>& validators)
 {
   validateIssues(validators);
@@ -844,6 +931,11 @@ void Node::setIssueHidden(const IssueType type, const bool hidden)
   }
 }
 
+bool Node::issuesValid() const
+{
+  return m_issuesValid;
+}
+
 void Node::validateIssues(const std::vector<const Validator*>& validators)
 {
   if (!m_issuesValid)
@@ -856,6 +948,16 @@ void Node::validateIssues(const std::vector<const Validator*>& validators)
   }
 }
 
+void Node::addIssues(const Validator& validator)
+{
+  validator.validate(*this, m_issues);
+}
+
+void Node::setIssuesValid()
+{
+  m_issuesValid = true;
+}
+
 void Node::invalidateIssues() const
 {
   m_issues.clear();
@@ -895,6 +997,22 @@ void Node::removeFromIndex(
   doRemoveFromIndex(node, key, value);
 }
 
+void Node::updateValueInIndex(
+  EntityNodeBase* node, const std::string& oldValue, const std::string& newValue)
+{
+  doUpdateValueInIndex(node, oldValue, newValue);
+}
+
+void Node::addTextureToIndex(BrushNode* node, const Assets::Texture* texture)
+{
+  doAddTextureToIndex(node, texture);
+}
+
+void Node::removeTextureFromIndex(BrushNode* node, const Assets::Texture* texture)
+{
+  doRemoveTextureFromIndex(node, texture);
+}
+
 Node* Node::doCloneRecursively(
   const vm::bbox3& worldBounds, const SetLinkId setLinkIds) const
 {
@@ -925,7 +1043,11 @@ void Node::doAncestorWillChange() {}
 void Node::doAncestorDidChange() {}
 
 void Node::doNodePhysicalBoundsDidChange() {}
-void Node::doChildPhysicalBoundsDidChange() {}
+void Node::doChildPhysicalBoundsDidChange(
+  Node* /* node */, const std::optional<NodeBounds>& /* oldChildBounds */)
+{
+  nodePhysicalBoundsDidChange();
+}
 void Node::doDescendantPhysicalBoundsDidChange(Node* /* node */) {}
 
 void Node::doChildWillChange(Node* /* node */) {}
@@ -984,4 +1106,29 @@ void Node::doRemoveFromIndex(
   }
 }
 
+void Node::doUpdateValueInIndex(
+  EntityNodeBase* node, const std::string& oldValue, const std::string& newValue)
+{
+  if (m_parent)
+  {
+    m_parent->updateValueInIndex(node, oldValue, newValue);
+  }
+}
+
+void Node::doAddTextureToIndex(BrushNode* node, const Assets::Texture* texture)
+{
+  if (m_parent)
+  {
+    m_parent->addTextureToIndex(node, texture);
+  }
+}
+
+void Node::doRemoveTextureFromIndex(BrushNode* node, const Assets::Texture* texture)
+{
+  if (m_parent)
+  {
+    m_parent->removeTextureFromIndex(node, texture);
+  }
+}
+
 } // namespace TrenchBroom::Model
@@ -33,18 +33,27 @@
 #include "vm/util.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+namespace TrenchBroom::Assets
+{
+class Texture;
+}
+
 namespace TrenchBroom::Model
 {
 
+class BrushNode;
 class EditorContext;
 class EntityNodeBase;
 struct EntityPropertyConfig;
 class ConstNodeVisitor;
 class Issue;
+enum class MapFormat;
 class NodeVisitor;
 class PickResult;
 class Validator;
@@ -57,6 +66,38 @@ struct NodePath
   kdl_reflect_decl(NodePath, indices);
 };
 
+/**
+ * The text of a node as it was last written to a map file in the given format.
+ */
+struct SerializedNode
+{
+  MapFormat format;
+  std::string string;
+  size_t lineCount;
+};
+
+/**
+ * The state of a node as computed by an EditorContext, such as whether the node is
+ * visible. The state is valid as long as its generation matches the editor context's
+ * generation.
+ */
+struct EditorContextCache
+{
+  size_t generation = 0;
+  uint8_t flags = 0;
+};
+
+/**
+ * The logical and physical bounds of a node.
+ */
+struct NodeBounds
+{
+  vm::bbox3 logicalBounds;
+  vm::bbox3 physicalBounds;
+
+  kdl_reflect_decl(NodeBounds, logicalBounds, physicalBounds);
+};
+
 enum class SetLinkId
 {
   generate,
@@ -85,6 +126,12 @@ private:
   mutable bool m_issuesValid = false;
   IssueType m_hiddenIssues = 0;
 
+  mutable std::optional<SerializedNode> m_serializedNode;
+  mutable std::optional<std::uint64_t> m_contentHash;
+  mutable std::optional<std::uint64_t> m_treeHash;
+
+  mutable EditorContextCache m_editorContextCache;
+
 protected:
   Node();
 
@@ -276,12 +323,28 @@ protected: // notification for parents
   {
   private:
     Node& m_node;
+    NodeBounds m_oldBounds;
 
   public:
     explicit NotifyPhysicalBoundsChange(Node& node);
     ~NotifyPhysicalBoundsChange();
   };
-  void nodePhysicalBoundsDidChange();
+
+  /**
+   * Notifies this node and its ancestors that the bounds of this node changed.
+   *
+   * If the previous bounds of this node are given, the ancestors can update their bounds
+   * incrementally. Otherwise, they must recompute them.
+   */
+  void nodePhysicalBoundsDidChange(
+    const std::optional<NodeBounds>& oldBounds = std::nullopt);
+
+protected:
+  /**
+   * Notifies the ancestors of this node that its bounds changed, but doesn't notify this
+   * node itself. Used by nodes which have already updated their own bounds.
+   */
+  void propagatePhysicalBoundsChange(const std::optional<NodeBounds>& oldBounds);
 
 private:
   void childWillChange(Node* node);
@@ -289,7 +352,8 @@ private:
   void descendantWillChange(Node* node);
   void descendantDidChange(Node* node);
 
-  void childPhysicalBoundsDidChange(Node* node);
+  void childPhysicalBoundsDidChange(
+    Node* node, const std::optional<NodeBounds>& oldChildBounds);
   void descendantPhysicalBoundsDidChange(Node* node, size_t depth);
 
 public: // selection
@@ -350,15 +414,59 @@ public: // visibility, locking
   bool lockedByOtherSelection() const;
   void setLockedByOtherSelection(bool lockedByOtherSelection);
 
+  /**
+   * Returns the state that an editor context has cached for this node.
+   */
+  EditorContextCache& editorContextCache() const;
+
 public: // picking
   void pick(const EditorContext& editorContext, const vm::ray3& ray, PickResult& result);
   void findNodesContaining(const vm::vec3& point, std::vector<Node*>& result);
 
 public: // file position
   size_t lineNumber() const;
+  size_t lineCount() const;
   void setFilePosition(size_t lineNumber, size_t lineCount) const;
   bool containsLine(size_t lineNumber) const;
 
+public: // serialization cache
+  /**
+   * Returns the text of this node as it was last written to a map file in the given
+   * format, or null if the node was not written in that format or if it has changed
+   * since.
+   */
+  const SerializedNode* serializedNode(MapFormat format) const;
+  void setSerializedNode(SerializedNode serializedNode) const;
+  void invalidateSerializedNode() const;
+
+public: // content hash
+  /**
+   * Returns a hash of the contents of this node, not including its children. The hash
+   * covers everything that is written to a map file for this node, and it is stable
+   * across sessions and platforms.
+   *
+   * The hash is computed on demand and cached until this node changes.
+   */
+  std::uint64_t contentHash() const;
+
+  /**
+   * Returns a hash of the contents of this node and all of its descendants, in the order
+   * in which they are stored. The hash is cached until this node or one of its
+   * descendants changes, or until children are added or removed. Recomputing it only
+   * recomputes the hashes of the changed nodes and of their ancestors.
+   */
+  std::uint64_t treeHash() const;
+
+  /**
+   * Invalidates the content hash of this node and the tree hashes of it and its
+   * ancestors. Subclasses must call this if they change their contents without notifying
+   * the node change.
+   */
+  void invalidateContentHash() const;
+
+private:
+  void invalidateTreeHash() const;
+
 public: // issue management
   std::vector<const Issue*> issues(const std::vector<const Validator*>& validators);
 
@@ -368,9 +476,22 @@ public: // issue management
 public: // should only be called from this and from the world
   void invalidateIssues() const;
 
-private:
+  bool issuesValid() const;
+
+  /**
+   * Runs the given validators on this node if its issues are invalid. Only this node's
+   * issues are modified, so different nodes can be validated concurrently.
+   */
   void validateIssues(const std::vector<const Validator*>& validators);
 
+  /**
+   * Runs the given validator on this node and adds the issues it finds, but does not mark
+   * this node's issues as valid. Used to run the validators on batches of nodes, see
+   * Model::validateIssues.
+   */
+  void addIssues(const Validator& validator);
+  void setIssuesValid();
+
 public: // visitors
   /**
    * Visit this node with the given lambda and return the lambda's return value or nothing
@@ -512,6 +633,11 @@ protected: // index management
   void addToIndex(EntityNodeBase* node, const std::string& key, const std::string& value);
   void removeFromIndex(
     EntityNodeBase* node, const std::string& key, const std::string& value);
+  void updateValueInIndex(
+    EntityNodeBase* node, const std::string& oldValue, const std::string& newValue);
+
+  void addTextureToIndex(BrushNode* node, const Assets::Texture* texture);
+  void removeTextureFromIndex(BrushNode* node, const Assets::Texture* texture);
 
 private: // subclassing interface
   virtual const std::string& doGetName() const = 0;
@@ -546,7 +672,8 @@ private: // subclassing interface
   virtual void doAncestorDidChange();
 
   virtual void doNodePhysicalBoundsDidChange();
-  virtual void doChildPhysicalBoundsDidChange();
+  virtual void doChildPhysicalBoundsDidChange(
+    Node* node, const std::optional<NodeBounds>& oldChildBounds);
   virtual void doDescendantPhysicalBoundsDidChange(Node* node);
 
   virtual void doChildWillChange(Node* node);
@@ -556,6 +683,8 @@ private: // subclassing interface
 
   virtual bool doSelectable() const = 0;
 
+  virtual std::uint64_t doGetContentHash() const = 0;
+
   virtual void doPick(
     const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult) = 0;
   virtual void doFindNodesContaining(
@@ -579,6 +708,11 @@ private: // subclassing interface
     EntityNodeBase* node, const std::string& key, const std::string& value);
   virtual void doRemoveFromIndex(
     EntityNodeBase* node, const std::string& key, const std::string& value);
+  virtual void doUpdateValueInIndex(
+    EntityNodeBase* node, const std::string& oldValue, const std::string& newValue);
+
+  virtual void doAddTextureToIndex(BrushNode* node, const Assets::Texture* texture);
+  virtual void doRemoveTextureFromIndex(BrushNode* node, const Assets::Texture* texture);
 };
 
 } // namespace TrenchBroom::Model
@@ -32,6 +32,7 @@
 #include "kdl/reflection_impl.h"
 
 #include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -133,6 +134,11 @@ bool NodeCollection::hasOnlyPatches() const
   return !empty() && nodeCount() == patchCount();
 }
 
+bool NodeCollection::contains(const Node* node) const
+{
+  return m_index.count(node) > 0;
+}
+
 std::vector<Node*>::iterator NodeCollection::begin()
 {
   return std::begin(m_nodes);
@@ -194,8 +200,13 @@ void NodeCollection::addNodes(const std::vector<Node*>& nodes)
 void NodeCollection::addNode(Node* node)
 {
   ensure(node != nullptr, "node is null");
+  if (!m_index.insert(node).second)
+  {
+    return;
+  }
+
   node->accept(kdl::overload(
-    [](WorldNode*) {},
+    [&](WorldNode* world) { m_index.erase(world); },
     [&](LayerNode* layer) {
       m_nodes.push_back(layer);
       m_layers.push_back(layer);
@@ -218,86 +229,53 @@ void NodeCollection::addNode(Node* node)
     }));
 }
 
-static const auto doRemoveNodes = [](
-                                    auto& nodes,
-                                    auto& layers,
-                                    auto& groups,
-                                    auto& entities,
-                                    auto& brushes,
-                                    auto& patches,
-                                    auto cur,
-                                    auto end) {
-  auto nodeEnd = std::end(nodes);
-  auto layerEnd = std::end(layers);
-  auto groupEnd = std::end(groups);
-  auto entityEnd = std::end(entities);
-  auto brushEnd = std::end(brushes);
-  auto patchEnd = std::end(patches);
-
-  while (cur != end)
+namespace
+{
+template <typename T>
+void eraseIndexed(std::vector<T*>& nodes, const std::unordered_set<const Node*>& toRemove)
+{
+  nodes.erase(
+    std::remove_if(
+      std::begin(nodes),
+      std::end(nodes),
+      [&](const auto* node) { return toRemove.count(node) > 0; }),
+    std::end(nodes));
+}
+} // namespace
+
+void NodeCollection::removeNodes(const std::vector<Node*>& nodes)
+{
+  auto toRemove = std::unordered_set<const Node*>{};
+  for (const auto* node : nodes)
   {
-    (*cur)->accept(kdl::overload(
-      [](WorldNode*) {},
-      [&](LayerNode* layer) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, layer);
-        layerEnd = std::remove(std::begin(layers), layerEnd, layer);
-      },
-      [&](GroupNode* group) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, group);
-        groupEnd = std::remove(std::begin(groups), groupEnd, group);
-      },
-      [&](EntityNode* entity) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, entity);
-        entityEnd = std::remove(std::begin(entities), entityEnd, entity);
-      },
-      [&](BrushNode* brush) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, brush);
-        brushEnd = std::remove(std::begin(brushes), brushEnd, brush);
-      },
-      [&](PatchNode* patch) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, patch);
-        patchEnd = std::remove(std::begin(patches), patchEnd, patch);
-      }));
-    ++cur;
+    if (m_index.erase(node) > 0)
+    {
+      toRemove.insert(node);
+    }
   }
 
-  nodes.erase(nodeEnd, std::end(nodes));
-  layers.erase(layerEnd, std::end(layers));
-  groups.erase(groupEnd, std::end(groups));
-  entities.erase(entityEnd, std::end(entities));
-  brushes.erase(brushEnd, std::end(brushes));
-  patches.erase(patchEnd, std::end(patches));
-};
+  if (toRemove.empty())
+  {
+    return;
+  }
 
-void NodeCollection::removeNodes(const std::vector<Node*>& nodes)
-{
-  doRemoveNodes(
-    m_nodes,
-    m_layers,
-    m_groups,
-    m_entities,
-    m_brushes,
-    m_patches,
-    std::begin(nodes),
-    std::end(nodes));
+  eraseIndexed(m_nodes, toRemove);
+  eraseIndexed(m_layers, toRemove);
+  eraseIndexed(m_groups, toRemove);
+  eraseIndexed(m_entities, toRemove);
+  eraseIndexed(m_brushes, toRemove);
+  eraseIndexed(m_patches, toRemove);
 }
 
 void NodeCollection::removeNode(Node* node)
 {
   ensure(node != nullptr, "node is null");
-  doRemoveNodes(
-    m_nodes,
-    m_layers,
-    m_groups,
-    m_entities,
-    m_brushes,
-    m_patches,
-    &node,
-    std::next(&node));
+  removeNodes({node});
 }
 
 void NodeCollection::clear()
 {
+  m_index.clear();
   m_nodes.clear();
   m_layers.clear();
   m_groups.clear();
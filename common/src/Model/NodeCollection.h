@@ -22,6 +22,7 @@
 #include "kdl/reflection_decl.h"
 
 #include <cstddef>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -45,6 +46,10 @@ private:
   std::vector<BrushNode*> m_brushes;
   std::vector<PatchNode*> m_patches;
 
+  // index of the contained nodes for constant time lookup, the vectors above determine
+  // the iteration order
+  std::unordered_set<const Node*> m_index;
+
 public:
   kdl_reflect_decl(
     NodeCollection, m_nodes, m_layers, m_groups, m_entities, m_brushes, m_patches);
@@ -71,6 +76,8 @@ public:
   bool hasPatches() const;
   bool hasOnlyPatches() const;
 
+  bool contains(const Node* node) const;
+
   std::vector<Node*>::iterator begin();
   std::vector<Node*>::iterator end();
   std::vector<Node*>::const_iterator begin() const;
@@ -83,9 +90,18 @@ public:
   const std::vector<BrushNode*>& brushes() const;
   const std::vector<PatchNode*>& patches() const;
 
+  /**
+   * Adds the given nodes in order. Nodes that are already contained in this collection
+   * are ignored.
+   */
   void addNodes(const std::vector<Node*>& nodes);
   void addNode(Node* node);
 
+  /**
+   * Removes the given nodes while preserving the order of the remaining nodes. The cost
+   * is linear in the size of this collection plus the number of given nodes, independent
+   * of how many nodes are removed.
+   */
   void removeNodes(const std::vector<Node*>& nodes);
   void removeNode(Node* node);
 
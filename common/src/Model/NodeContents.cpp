@@ -55,5 +55,17 @@ std::variant<Layer, Group, Entity, Brush, BezierPatch>& NodeContents::get()
 {
   return m_contents;
 }
+
+size_t NodeContents::memoryUsage() const
+{
+  return std::visit(
+    kdl::overload(
+      [](const Layer&) { return sizeof(Layer); },
+      [](const Group&) { return sizeof(Group); },
+      [](const Entity& entity) { return entity.memoryUsage(); },
+      [](const Brush& brush) { return brush.memoryUsage(); },
+      [](const BezierPatch& patch) { return patch.memoryUsage(); }),
+    m_contents);
+}
 } // namespace Model
 } // namespace TrenchBroom
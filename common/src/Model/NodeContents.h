@@ -45,6 +45,11 @@ public:
 
   const std::variant<Layer, Group, Entity, Brush, BezierPatch>& get() const;
   std::variant<Layer, Group, Entity, Brush, BezierPatch>& get();
+
+  /**
+   * Returns an estimate of the memory used by the contents in bytes.
+   */
+  size_t memoryUsage() const;
 };
 } // namespace Model
 } // namespace TrenchBroom
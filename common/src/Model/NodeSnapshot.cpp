@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeSnapshot.h"
+
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/vector_utils.h"
+
+namespace TrenchBroom::Model
+{
+
+NodeSnapshot::NodeSnapshot(Contents contents, std::vector<NodeSnapshot> children)
+  : m_contents{std::move(contents)}
+  , m_children{std::move(children)}
+{
+}
+
+const NodeSnapshot::Contents& NodeSnapshot::contents() const
+{
+  return m_contents;
+}
+
+const std::vector<NodeSnapshot>& NodeSnapshot::children() const
+{
+  return m_children;
+}
+
+NodeSnapshot takeSnapshot(const Node& node)
+{
+  auto contents = node.accept(kdl::overload(
+    [](const WorldNode* worldNode) -> NodeSnapshot::Contents {
+      return NodeSnapshot::WorldContents{
+        worldNode->mapFormat(), worldNode->sharedEntity()};
+    },
+    [](const LayerNode* layerNode) -> NodeSnapshot::Contents {
+      return NodeSnapshot::LayerContents{layerNode->layer(), layerNode->persistentId()};
+    },
+    [](const GroupNode* groupNode) -> NodeSnapshot::Contents {
+      return NodeSnapshot::GroupContents{
+        groupNode->group(), groupNode->persistentId(), groupNode->linkId()};
+    },
+    [](const EntityNode* entityNode) -> NodeSnapshot::Contents {
+      return NodeSnapshot::EntityContents{entityNode->sharedEntity()};
+    },
+    [](const BrushNode* brushNode) -> NodeSnapshot::Contents {
+      return NodeSnapshot::BrushContents{brushNode->sharedBrush()};
+    },
+    [](const PatchNode* patchNode) -> NodeSnapshot::Contents {
+      return NodeSnapshot::PatchContents{patchNode->sharedPatch()};
+    }));
+
+  auto children = kdl::vec_transform(
+    node.children(), [](const auto* child) { return takeSnapshot(*child); });
+
+  return NodeSnapshot{std::move(contents), std::move(children)};
+}
+
+} // namespace TrenchBroom::Model
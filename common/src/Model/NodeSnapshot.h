@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Model/Group.h"
+#include "Model/IdType.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace TrenchBroom::Model
+{
+class BezierPatch;
+class Brush;
+class Entity;
+class Node;
+
+/**
+ * A read-only view of a node and its descendants at the time the snapshot was taken.
+ *
+ * Taking a snapshot does not copy any entities, brushes or patches. Instead, the snapshot
+ * shares them with the nodes, and a node copies its contents before it modifies them if
+ * they are still shared with a snapshot. Therefore, a snapshot can be read by worker
+ * threads while the nodes are being edited.
+ *
+ * Snapshots must be taken on the thread that modifies the nodes. The textures, entity
+ * definitions and models referenced by a snapshot are only valid until they are
+ * reloaded.
+ */
+class NodeSnapshot
+{
+public:
+  struct WorldContents
+  {
+    MapFormat mapFormat;
+    std::shared_ptr<const Entity> entity;
+  };
+
+  struct LayerContents
+  {
+    Layer layer;
+    std::optional<IdType> persistentId;
+  };
+
+  struct GroupContents
+  {
+    Group group;
+    std::optional<IdType> persistentId;
+    std::string linkId;
+  };
+
+  struct EntityContents
+  {
+    std::shared_ptr<const Entity> entity;
+  };
+
+  struct BrushContents
+  {
+    std::shared_ptr<const Brush> brush;
+  };
+
+  struct PatchContents
+  {
+    std::shared_ptr<const BezierPatch> patch;
+  };
+
+  using Contents = std::variant<
+    WorldContents,
+    LayerContents,
+    GroupContents,
+    EntityContents,
+    BrushContents,
+    PatchContents>;
+
+private:
+  Contents m_contents;
+  std::vector<NodeSnapshot> m_children;
+
+public:
+  NodeSnapshot(Contents contents, std::vector<NodeSnapshot> children);
+
+  const Contents& contents() const;
+  const std::vector<NodeSnapshot>& children() const;
+};
+
+/**
+ * Takes a snapshot of the given node and its descendants.
+ */
+NodeSnapshot takeSnapshot(const Node& node);
+
+} // namespace TrenchBroom::Model
@@ -40,6 +40,7 @@ const std::string& Object::linkId() const
 void Object::setLinkId(std::string linkId)
 {
   m_linkId = std::move(linkId);
+  doLinkIdDidChange();
 }
 
 void Object::cloneLinkId(const Object& original, const SetLinkId linkIdPolicy)
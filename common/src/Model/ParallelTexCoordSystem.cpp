@@ -94,7 +94,7 @@ ParallelTexCoordSystem::ParallelTexCoordSystem(
 {
 }
 
-std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParallelTexCoordSystem::
+std::tuple<ParallelTexCoordSystem, BrushFaceAttributes> ParallelTexCoordSystem::
   fromParaxial(
     const vm::vec3& point0,
     const vm::vec3& point1,
@@ -102,8 +102,7 @@ std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParallelTexCoor
     const BrushFaceAttributes& attribs)
 {
   const auto tempParaxial = ParaxialTexCoordSystem(point0, point1, point2, attribs);
-  return {
-    ParallelTexCoordSystem(tempParaxial.xAxis(), tempParaxial.yAxis()).clone(), attribs};
+  return {ParallelTexCoordSystem{tempParaxial.xAxis(), tempParaxial.yAxis()}, attribs};
 }
 
 std::unique_ptr<TexCoordSystem> ParallelTexCoordSystem::doClone() const
@@ -178,6 +177,15 @@ vm::vec2f ParallelTexCoordSystem::doGetTexCoords(
   return (computeTexCoords(point, attribs.scale()) + attribs.offset()) / textureSize;
 }
 
+void ParallelTexCoordSystem::doGetTexCoords(
+  const std::vector<vm::vec3>& points,
+  const BrushFaceAttributes& attribs,
+  const vm::vec2f& textureSize,
+  std::vector<vm::vec2f>& texCoords) const
+{
+  computeTexCoords(points, attribs, textureSize, texCoords);
+}
+
 /**
  * Rotates from `oldAngle` to `newAngle`. Both of these are in CCW degrees about
  * the texture normal (`getZAxis()`). The provided `normal` is ignored.
@@ -206,7 +214,7 @@ void ParallelTexCoordSystem::applyRotation(const vm::vec3& normal, const FloatTy
 void ParallelTexCoordSystem::doTransform(
   const vm::plane3& oldBoundary,
   const vm::plane3& newBoundary,
-  const vm::mat4x4& transformation,
+  const TexCoordSystemTransformation& transformation,
   BrushFaceAttributes& attribs,
   const vm::vec2f& textureSize,
   const bool lockTexture,
@@ -224,11 +232,9 @@ void ParallelTexCoordSystem::doTransform(
     return;
   }
 
-  const auto effectiveTransformation = transformation;
-
   // determine the rotation by which the texture coordinate system will be rotated about
   // its normal
-  const auto angleDelta = computeTextureAngle(oldBoundary, effectiveTransformation);
+  const auto angleDelta = computeTextureAngle(oldBoundary, transformation.rotationScale);
   const auto newAngle =
     vm::correct(vm::normalize_degrees(attribs.rotation() + angleDelta), 4);
   assert(!vm::is_nan(newAngle));
@@ -253,10 +259,8 @@ void ParallelTexCoordSystem::doTransform(
   //     uv = ? * transform * point
   //
   // The solution for ? is (worldToTexSpace * transform_inverse)
-  const auto [invertible, inverseTransform] = invert(effectiveTransformation);
-  assert(invertible);
-  unused(invertible);
-  const auto newWorldToTexSpace = worldToTexSpace * inverseTransform;
+  assert(transformation.invertible);
+  const auto newWorldToTexSpace = worldToTexSpace * transformation.inverseTransformation;
 
   // extract the new m_xAxis and m_yAxis from newWorldToTexSpace.
   // note, the matrix is in column major format.
@@ -270,7 +274,7 @@ void ParallelTexCoordSystem::doTransform(
 
   // determine the new texture coordinates of the transformed center of the face, sans
   // offsets
-  const auto newInvariant = effectiveTransformation * oldInvariant;
+  const auto newInvariant = transformation.transformation * oldInvariant;
   const auto newInvariantTexCoords = computeTexCoords(newInvariant, attribs.scale());
 
   // since the center should be invariant, the offsets are determined by the difference of
@@ -282,9 +286,8 @@ void ParallelTexCoordSystem::doTransform(
 }
 
 float ParallelTexCoordSystem::computeTextureAngle(
-  const vm::plane3& oldBoundary, const vm::mat4x4& transformation) const
+  const vm::plane3& oldBoundary, const vm::mat4x4& rotationScale) const
 {
-  const vm::mat4x4& rotationScale = vm::strip_translation(transformation);
   const vm::vec3& oldNormal = oldBoundary.normal;
   const vm::vec3 newNormal = vm::normalize(rotationScale * oldNormal);
 
@@ -455,8 +458,9 @@ std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParallelTexCoor
     const vm::vec3& point2,
     const BrushFaceAttributes& attribs) const
 {
-  return ParaxialTexCoordSystem::fromParallel(
+  auto [paraxial, newAttribs] = ParaxialTexCoordSystem::fromParallel(
     point0, point1, point2, attribs, m_xAxis, m_yAxis);
+  return {std::make_unique<ParaxialTexCoordSystem>(std::move(paraxial)), newAttribs};
 }
 } // namespace Model
 } // namespace TrenchBroom
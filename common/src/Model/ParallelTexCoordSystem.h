@@ -28,6 +28,7 @@
 
 #include <memory>
 #include <tuple>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -65,7 +66,7 @@ public:
     const BrushFaceAttributes& attribs);
   ParallelTexCoordSystem(const vm::vec3& xAxis, const vm::vec3& yAxis);
 
-  static std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> fromParaxial(
+  static std::tuple<ParallelTexCoordSystem, BrushFaceAttributes> fromParaxial(
     const vm::vec3& point0,
     const vm::vec3& point1,
     const vm::vec3& point2,
@@ -94,6 +95,11 @@ private:
     const vm::vec3& point,
     const BrushFaceAttributes& attribs,
     const vm::vec2f& textureSize) const override;
+  void doGetTexCoords(
+    const std::vector<vm::vec3>& points,
+    const BrushFaceAttributes& attribs,
+    const vm::vec2f& textureSize,
+    std::vector<vm::vec2f>& texCoords) const override;
 
   void doSetRotation(const vm::vec3& normal, float oldAngle, float newAngle) override;
   void applyRotation(const vm::vec3& normal, FloatType angle);
@@ -101,13 +107,13 @@ private:
   void doTransform(
     const vm::plane3& oldBoundary,
     const vm::plane3& newBoundary,
-    const vm::mat4x4& transformation,
+    const TexCoordSystemTransformation& transformation,
     BrushFaceAttributes& attribs,
     const vm::vec2f& textureSize,
     bool lockTexture,
     const vm::vec3& invariant) override;
   float computeTextureAngle(
-    const vm::plane3& oldBoundary, const vm::mat4x4& transformation) const;
+    const vm::plane3& oldBoundary, const vm::mat4x4& rotationScale) const;
 
   void doUpdateNormalWithProjection(
     const vm::vec3& newNormal, const BrushFaceAttributes& attribs) override;
@@ -133,7 +139,7 @@ private:
     const vm::vec3& point2,
     const BrushFaceAttributes& attribs) const override;
 
-  deleteCopyAndMove(ParallelTexCoordSystem);
+  defineCopyAndMove(ParallelTexCoordSystem);
 };
 } // namespace Model
 } // namespace TrenchBroom
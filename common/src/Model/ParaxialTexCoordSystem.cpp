@@ -187,6 +187,15 @@ vm::vec2f ParaxialTexCoordSystem::doGetTexCoords(
   return (computeTexCoords(point, attribs.scale()) + attribs.offset()) / textureSize;
 }
 
+void ParaxialTexCoordSystem::doGetTexCoords(
+  const std::vector<vm::vec3>& points,
+  const BrushFaceAttributes& attribs,
+  const vm::vec2f& textureSize,
+  std::vector<vm::vec2f>& texCoords) const
+{
+  computeTexCoords(points, attribs, textureSize, texCoords);
+}
+
 void ParaxialTexCoordSystem::doSetRotation(
   const vm::vec3& normal, const float /* oldAngle */, const float newAngle)
 {
@@ -198,13 +207,13 @@ void ParaxialTexCoordSystem::doSetRotation(
 void ParaxialTexCoordSystem::doTransform(
   const vm::plane3& oldBoundary,
   const vm::plane3& newBoundary,
-  const vm::mat4x4& transformation,
+  const TexCoordSystemTransformation& transformation,
   BrushFaceAttributes& attribs,
   const vm::vec2f& textureSize,
   bool lockTexture,
   const vm::vec3& oldInvariant)
 {
-  const vm::vec3 offset = transformation * vm::vec3::zero();
+  const vm::vec3& offset = transformation.translation;
   const vm::vec3& oldNormal = oldBoundary.normal;
   vm::vec3 newNormal = newBoundary.normal;
   assert(vm::is_unit(newNormal, vm::C::almost_zero()));
@@ -235,8 +244,10 @@ void ParaxialTexCoordSystem::doTransform(
     oldBoundary.project_point(m_yAxis * scale.y(), getZAxis()) - boundaryOffset;
 
   // transform the projected texture axes and compensate the translational component
-  const vm::vec3 transformedXAxis = transformation * oldXAxisOnBoundary - offset;
-  const vm::vec3 transformedYAxis = transformation * oldYAxisOnBoundary - offset;
+  const vm::vec3 transformedXAxis =
+    transformation.transformation * oldXAxisOnBoundary - offset;
+  const vm::vec3 transformedYAxis =
+    transformation.transformation * oldYAxisOnBoundary - offset;
 
   const bool preferX = textureSize.x() >= textureSize.y();
 
@@ -298,7 +309,7 @@ void ParaxialTexCoordSystem::doTransform(
     newScale[1] *= -1.0f;
 
   // compute the parameters of the transformed texture coordinate system
-  const vm::vec3 newInvariant = transformation * oldInvariant;
+  const vm::vec3 newInvariant = transformation.transformation * oldInvariant;
 
   // determine the new texture coordinates of the transformed center of the face, sans
   // offsets
@@ -360,7 +371,9 @@ std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoor
     const vm::vec3& point2,
     const BrushFaceAttributes& attribs) const
 {
-  return ParallelTexCoordSystem::fromParaxial(point0, point1, point2, attribs);
+  auto [parallel, newAttribs] =
+    ParallelTexCoordSystem::fromParaxial(point0, point1, point2, attribs);
+  return {std::make_unique<ParallelTexCoordSystem>(std::move(parallel)), newAttribs};
 }
 
 std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoordSystem::
@@ -779,7 +792,7 @@ static vm::mat4x4f valveTo4x4Matrix(
 }
 } // namespace FromParallel
 
-std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoordSystem::
+std::tuple<ParaxialTexCoordSystem, BrushFaceAttributes> ParaxialTexCoordSystem::
   fromParallel(
     const vm::vec3& point0,
     const vm::vec3& point1,
@@ -811,9 +824,7 @@ std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoor
     newAttribs.setRotation(0.0f);
   }
 
-  return {
-    std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, newAttribs),
-    newAttribs};
+  return {ParaxialTexCoordSystem{point0, point1, point2, newAttribs}, newAttribs};
 }
 } // namespace Model
 } // namespace TrenchBroom
@@ -26,6 +26,7 @@
 #include "vm/vec.h"
 
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -79,12 +80,17 @@ private:
     const vm::vec3& point,
     const BrushFaceAttributes& attribs,
     const vm::vec2f& textureSize) const override;
+  void doGetTexCoords(
+    const std::vector<vm::vec3>& points,
+    const BrushFaceAttributes& attribs,
+    const vm::vec2f& textureSize,
+    std::vector<vm::vec2f>& texCoords) const override;
 
   void doSetRotation(const vm::vec3& normal, float oldAngle, float newAngle) override;
   void doTransform(
     const vm::plane3& oldBoundary,
     const vm::plane3& newBoundary,
-    const vm::mat4x4& transformation,
+    const TexCoordSystemTransformation& transformation,
     BrushFaceAttributes& attribs,
     const vm::vec2f& textureSize,
     bool lockTexture,
@@ -121,7 +127,7 @@ private:
     size_t planeNormIndex) const;
 
 public:
-  static std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> fromParallel(
+  static std::tuple<ParaxialTexCoordSystem, BrushFaceAttributes> fromParallel(
     const vm::vec3& point0,
     const vm::vec3& point1,
     const vm::vec3& point2,
@@ -130,7 +136,7 @@ public:
     const vm::vec3& yAxis);
 
 private:
-  deleteCopyAndMove(ParaxialTexCoordSystem);
+  defineCopyAndMove(ParaxialTexCoordSystem);
 };
 } // namespace Model
 } // namespace TrenchBroom
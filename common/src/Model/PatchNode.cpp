@@ -21,6 +21,7 @@
 
 #include "Macros.h"
 #include "Model/BrushNode.h"
+#include "Model/ContentHasher.h"
 #include "Model/EditorContext.h"
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
@@ -41,6 +42,7 @@
 #include "vm/vec_io.h"
 
 #include <cassert>
+#include <iterator>
 #include <ostream>
 #include <string>
 
@@ -290,15 +292,36 @@ PatchGrid makePatchGrid(const BezierPatch& patch, const size_t subdivisionsPerSu
     boundsBuilder.add(position);
   }
 
+  // a row of quads spans two rows of points
+  auto quadRowBounds = std::vector<vm::bbox3>{};
+  quadRowBounds.reserve(gridPointRowCount - 1u);
+  for (size_t row = 0u; row < gridPointRowCount - 1u; ++row)
+  {
+    const auto rowBegin = std::next(points.begin(), long(row * gridPointColumnCount));
+    const auto rowEnd = std::next(rowBegin, long(2u * gridPointColumnCount));
+    quadRowBounds.push_back(
+      vm::bbox3::merge_all(rowBegin, rowEnd, [](const auto& p) { return p.position; }));
+  }
+
   return {
-    gridPointRowCount, gridPointColumnCount, std::move(points), boundsBuilder.bounds()};
+    gridPointRowCount,
+    gridPointColumnCount,
+    std::move(points),
+    boundsBuilder.bounds(),
+    std::move(quadRowBounds)};
 }
 
 const HitType::Type PatchNode::PatchHitType = HitType::freeType();
 
 PatchNode::PatchNode(BezierPatch patch)
-  : m_patch{std::move(patch)}
-  , m_grid{makePatchGrid(m_patch, DefaultSubdivisionsPerSurface)}
+  : m_patch{std::make_shared<BezierPatch>(std::move(patch))}
+  , m_grid{makePatchGrid(*m_patch, DefaultSubdivisionsPerSurface)}
+{
+}
+
+PatchNode::PatchNode(BezierPatch patch, PatchGrid grid)
+  : m_patch{std::make_shared<BezierPatch>(std::move(patch))}
+  , m_grid{std::move(grid)}
 {
 }
 
@@ -329,6 +352,11 @@ EntityNodeBase* PatchNode::entity()
 }
 
 const BezierPatch& PatchNode::patch() const
+{
+  return *m_patch;
+}
+
+std::shared_ptr<const BezierPatch> PatchNode::sharedPatch() const
 {
   return m_patch;
 }
@@ -338,14 +366,27 @@ BezierPatch PatchNode::setPatch(BezierPatch patch)
   const auto nodeChange = NotifyNodeChange{*this};
   const auto boundsChange = NotifyPhysicalBoundsChange{*this};
 
-  auto previousPatch = std::exchange(m_patch, std::move(patch));
-  m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
-  return previousPatch;
+  auto previousPatch =
+    std::exchange(m_patch, std::make_shared<BezierPatch>(std::move(patch)));
+
+  // the grid only depends on the control points, so e.g. changing the texture keeps it
+  if (
+    m_patch->pointRowCount() != previousPatch->pointRowCount()
+    || m_patch->pointColumnCount() != previousPatch->pointColumnCount()
+    || m_patch->controlPoints() != previousPatch->controlPoints())
+  {
+    m_grid = makePatchGrid(*m_patch, DefaultSubdivisionsPerSurface);
+  }
+  return previousPatch.use_count() == 1 ? std::move(*previousPatch) : *previousPatch;
 }
 
 void PatchNode::setTexture(Assets::Texture* texture)
 {
-  m_patch.setTexture(texture);
+  if (m_patch.use_count() > 1)
+  {
+    m_patch = std::make_shared<BezierPatch>(*m_patch);
+  }
+  m_patch->setTexture(texture);
 }
 
 const PatchGrid& PatchNode::grid() const
@@ -361,7 +402,7 @@ const std::string& PatchNode::doGetName() const
 
 const vm::bbox3& PatchNode::doGetLogicalBounds() const
 {
-  return m_patch.bounds();
+  return m_patch->bounds();
 }
 
 const vm::bbox3& PatchNode::doGetPhysicalBounds() const
@@ -388,7 +429,8 @@ FloatType PatchNode::doGetProjectedArea(const vm::axis::type axis) const
 
 Node* PatchNode::doClone(const vm::bbox3&, const SetLinkId setLinkIds) const
 {
-  auto result = std::make_unique<PatchNode>(m_patch);
+  // the clone has the same control points, so copy the grid instead of recomputing it
+  auto result = std::unique_ptr<PatchNode>{new PatchNode{*m_patch, m_grid}};
   result->cloneLinkId(*this, setLinkIds);
   return result.release();
 }
@@ -418,10 +460,29 @@ bool PatchNode::doSelectable() const
   return true;
 }
 
+std::uint64_t PatchNode::doGetContentHash() const
+{
+  auto hasher = ContentHasher{};
+  hasher.add(std::uint64_t(m_patch->pointRowCount()))
+    .add(std::uint64_t(m_patch->pointColumnCount()))
+    .add(m_patch->textureName());
+  for (const auto& point : m_patch->controlPoints())
+  {
+    hasher.add(point);
+  }
+  hasher.add(linkId());
+  return hasher.hash();
+}
+
 void PatchNode::doPick(
   const EditorContext& editorContext, const vm::ray3& pickRay, PickResult& pickResult)
 {
-  if (!editorContext.visible(this))
+  const auto mayHit = [&](const vm::bbox3& bounds) {
+    return bounds.contains(pickRay.origin)
+           || !vm::is_nan(vm::intersect_ray_bbox(pickRay, bounds));
+  };
+
+  if (!editorContext.visible(this) || !mayHit(m_grid.bounds))
   {
     return;
   }
@@ -438,6 +499,11 @@ void PatchNode::doPick(
 
   for (size_t row = 0u; row < m_grid.pointRowCount - 1u; ++row)
   {
+    if (!mayHit(m_grid.quadRowBounds[row]))
+    {
+      continue;
+    }
+
     for (size_t col = 0u; col < m_grid.pointColumnCount - 1u; ++col)
     {
       const auto v0 = m_grid.point(row, col).position;
@@ -480,6 +546,11 @@ GroupNode* PatchNode::doGetContainingGroup()
   return findContainingGroup(this);
 }
 
+void PatchNode::doLinkIdDidChange()
+{
+  invalidateContentHash();
+}
+
 void PatchNode::doAcceptTagVisitor(TagVisitor& visitor)
 {
   visitor.visit(*this);
@@ -29,6 +29,7 @@
 #include "vm/bbox.h"
 #include "vm/vec.h"
 
+#include <memory>
 #include <optional>
 
 namespace TrenchBroom
@@ -58,12 +59,18 @@ struct PatchGrid
   std::vector<Point> points;
   vm::bbox3 bounds;
 
+  /**
+   * The bounds of each row of quads, used to skip the rows that a pick ray misses.
+   */
+  std::vector<vm::bbox3> quadRowBounds;
+
   const Point& point(size_t row, size_t col) const;
 
   size_t quadRowCount() const;
   size_t quadColumnCount() const;
 
-  kdl_reflect_decl(PatchGrid, pointRowCount, pointColumnCount, points, bounds);
+  kdl_reflect_decl(
+    PatchGrid, pointRowCount, pointColumnCount, points, bounds, quadRowBounds);
 };
 
 // public for testing
@@ -81,16 +88,29 @@ public:
   static const HitType::Type PatchHitType;
 
 private:
-  BezierPatch m_patch;
+  // shared with snapshots and copied before it is modified if it is shared
+  std::shared_ptr<BezierPatch> m_patch;
   PatchGrid m_grid;
 
 public:
   explicit PatchNode(BezierPatch patch);
 
+private:
+  PatchNode(BezierPatch patch, PatchGrid grid);
+
+public:
+
   EntityNodeBase* entity();
   const EntityNodeBase* entity() const;
 
   const BezierPatch& patch() const;
+
+  /**
+   * Returns the patch of this node for sharing it with a snapshot. The shared patch is
+   * never modified by this node.
+   */
+  std::shared_ptr<const BezierPatch> sharedPatch() const;
+
   BezierPatch setPatch(BezierPatch patch);
 
   void setTexture(Assets::Texture* texture);
@@ -114,6 +134,8 @@ private: // implement Node interface
 
   bool doSelectable() const override;
 
+  std::uint64_t doGetContentHash() const override;
+
   void doPick(
     const EditorContext& editorContext,
     const vm::ray3& ray,
@@ -127,6 +149,7 @@ private: // implement Object interface
   Node* doGetContainer() override;
   LayerNode* doGetContainingLayer() override;
   GroupNode* doGetContainingGroup() override;
+  void doLinkIdDidChange() override;
 
 private: // implement Taggable interface
   void doAcceptTagVisitor(TagVisitor& visitor) override;
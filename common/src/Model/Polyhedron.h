@@ -30,6 +30,7 @@
 #include "vm/util.h"
 #include "vm/vec.h"
 
+#include <cstddef>
 #include <initializer_list>
 #include <limits>
 #include <optional>
@@ -113,6 +114,13 @@ private:
   explicit Polyhedron_Vertex(const vm::vec<T, 3>& position);
 
 public:
+  /**
+   * Allocates vertices from a pool, so that building and copying polyhedra does not
+   * require an allocation per component.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the position of this vertex.
    */
@@ -260,6 +268,12 @@ private:
   Polyhedron_Edge(HalfEdge* first, HalfEdge* second = nullptr);
 
 public:
+  /**
+   * Allocates edges from a pool, see Polyhedron_Vertex::operator new.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the origin of the first half edge.
    */
@@ -577,6 +591,12 @@ private:
   Polyhedron_HalfEdge(Vertex* origin);
 
 public:
+  /**
+   * Allocates half edges from a pool, see Polyhedron_Vertex::operator new.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the origin vertex of this half edge.
    */
@@ -803,6 +823,12 @@ private:
   explicit Polyhedron_Face(HalfEdgeList&& boundary, const vm::plane<T, 3>& plane);
 
 public:
+  /**
+   * Allocates faces from a pool, see Polyhedron_Vertex::operator new.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the circular list of half edges that make up the boundary of this face.
    */
@@ -1112,6 +1138,12 @@ public:
 private:
   static constexpr const auto MinEdgeLength = T(0.01);
 
+  /**
+   * If more than this many points are added at once, the convex hull is built using
+   * Quickhull instead of adding the points one by one.
+   */
+  static constexpr const size_t QuickhullThreshold = 64u;
+
 public:
   using Vertex = Polyhedron_Vertex<T, FP, VP>;
   using Edge = Polyhedron_Edge<T, FP, VP>;
@@ -1213,6 +1245,24 @@ public: // Constructors
    */
   explicit Polyhedron(std::vector<vm::vec<T, 3>> positions);
 
+  /**
+   * Constructs a polyhedron with the given vertices and faces without computing its
+   * geometry. Each face is given by its plane and by the indices of the origins of its
+   * boundary half edges, in the order of its boundary. The vertices and faces are added
+   * to the polyhedron in the given order.
+   *
+   * Returns an empty optional if the given faces do not form a closed polyhedron. The
+   * positions and planes are not checked for convexity or consistency.
+   *
+   * @param positions the vertex positions
+   * @param faceVertexIndices the vertex indices of each face's boundary
+   * @param facePlanes the planes of the faces
+   */
+  static std::optional<Polyhedron> fromFaces(
+    const std::vector<vm::vec<T, 3>>& positions,
+    const std::vector<std::vector<size_t>>& faceVertexIndices,
+    const std::vector<vm::plane<T, 3>>& facePlanes);
+
   /**
    * Copy constructor.
    */
@@ -1553,6 +1603,28 @@ public: // General purpose methods
     const std::vector<vm::vec<T, 3>>& positions,
     T maxDistance = std::numeric_limits<T>::max());
 
+  /**
+   * Moves the vertices at the given positions by the given delta, provided that this
+   * does not change the topology of this polyhedron. This is the case if every face
+   * remains planar and every vertex remains strictly below the plane of every face it
+   * does not belong to. The result is then the same as the convex hull of the moved
+   * vertices, but it is much cheaper to compute.
+   *
+   * If the topology would change, this polyhedron is not modified.
+   *
+   * Updates the bounds of this polyhedron afterwards.
+   *
+   * @param positions the positions of the vertices to move
+   * @param delta the delta by which to move the vertices
+   * @param epsilon the epsilon value to use when checking the vertices against the face
+   * planes
+   * @return true if the vertices were moved and false otherwise
+   */
+  bool moveVerticesKeepingTopology(
+    const std::vector<vm::vec<T, 3>>& positions,
+    const vm::vec<T, 3>& delta,
+    T epsilon = vm::constants<T>::point_status_epsilon());
+
 private:
   /**
    * Updates the bounds to the smallest bounding box that contains the positions of all
@@ -1694,14 +1766,39 @@ private: // Convex hull; adding and removing points
    * polyhedron is that the resulting polyhedron is the convex hull of the union of the
    * polyhedron's vertices and the given points.
    *
-   * Duplicates in the given vector are discarded. Furthermore, the remaining points are
-   * sorted in descending order of their distance from the center of their bounding box.
-   * Therefore, the result of calling this method is different from the result of
-   * repeatedly calling addPoint() for every point in the given vector.
+   * Duplicates in the given vector are discarded. If at most QuickhullThreshold points
+   * remain, they are added one by one in lexicographical order. Otherwise, the points
+   * are added using addPointsQuickhull(). Therefore, the result of calling this method
+   * may be different from the result of repeatedly calling addPoint() for every point in
+   * the given vector.
    *
    * @param points the points to add to this polyhedron
    */
   void addPoints(std::vector<vm::vec<T, 3>> points);
+
+  /**
+   * Adds the given points using Quickhull.
+   *
+   * The points are presorted in descending order of their distance from the center of
+   * their bounding box, and the extreme points along each axis are added first. Once
+   * this polyhedron is a convex volume, every remaining point is assigned to the first
+   * face that it is above, and points that are not above any face are discarded. Then the
+   * point that is furthest from its face is added repeatedly, and the points assigned to
+   * the faces that were removed or merged are reassigned to the faces around the new
+   * vertex. The per face point lists are recycled between iterations.
+   *
+   * Points which are inside of this polyhedron are discarded much earlier than when
+   * adding the points one by one, and adding a point only touches the faces that can
+   * see it. This avoids scanning all vertices and faces for every point, which makes a
+   * big difference for large point sets.
+   *
+   * If the polyhedron degenerates during construction, the remaining points are added
+   * one by one.
+   *
+   * @param points the points to add, must not contain duplicates
+   * @param planeEpsilon the plane epsilon to use for point status checks
+   */
+  void addPointsQuickhull(std::vector<vm::vec<T, 3>> points, T planeEpsilon);
   /**
    * Adds the given point to this polyhedron. The effect of adding the given point to a
    * polyhedron is that the resulting polyhedron is the convex hull of the union of the
@@ -1888,6 +1985,23 @@ private:
    */
   std::optional<Seam> createSeamForHorizon(const vm::vec<T, 3>& position, T planeEpsilon);
 
+  /**
+   * Creates a seam along the horizon of the given position, starting at the given face
+   * which must be visible from the given position.
+   *
+   * @param position the vertex position
+   * @param initialVisibleFace a face that is visible from the given position
+   * @param visitedFaces receives the faces that are visible from the given position
+   * @param planeEpsilon the plane epsilon to use for point status checks
+   * @return a seam that separates the faces that are visible from the given position from
+   * those that do not
+   */
+  Seam createSeamForHorizon(
+    const vm::vec<T, 3>& position,
+    Face* initialVisibleFace,
+    std::unordered_set<Face*>& visitedFaces,
+    T planeEpsilon);
+
   void visitFace(
     const vm::vec<T, 3>& position,
     HalfEdge* initialBoundaryEdge,
@@ -147,42 +147,25 @@ std::optional<typename Polyhedron<T, FP, VP>::ClipResult::FailureReason> Polyhed
   FP,
   VP>::checkIntersects(const vm::plane<T, 3>& plane) const
 {
-  std::size_t above = 0u;
-  std::size_t below = 0u;
-  std::size_t inside = 0u;
+  const auto status = plane.common_point_status(
+    m_vertices.begin(),
+    m_vertices.end(),
+    [](const Vertex* vertex) { return vertex->position(); },
+    vm::constants<T>::point_status_epsilon());
 
-  for (const Vertex* currentVertex : m_vertices)
+  if (!status)
   {
-    const vm::plane_status status = plane.point_status(
-      currentVertex->position(), vm::constants<T>::point_status_epsilon());
-    switch (status)
-    {
-    case vm::plane_status::above:
-      ++above;
-      break;
-    case vm::plane_status::below:
-      ++below;
-      break;
-    case vm::plane_status::inside:
-      ++inside;
-      break;
-      switchDefault();
-    }
+    return std::nullopt;
   }
 
-  assert(above + below + inside == m_vertices.size());
-
-  if (below + inside == m_vertices.size())
-  {
-    return ClipResult::FailureReason::Unchanged;
-  }
-  else if (above + inside == m_vertices.size())
+  switch (*status)
   {
+  case vm::plane_status::above:
     return ClipResult::FailureReason::Empty;
-  }
-  else
-  {
-    return std::nullopt;
+  case vm::plane_status::below:
+  case vm::plane_status::inside:
+    return ClipResult::FailureReason::Unchanged;
+    switchDefault();
   }
 }
 
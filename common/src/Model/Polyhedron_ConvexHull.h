@@ -30,7 +30,9 @@
 #include "vm/segment.h"
 #include "vm/util.h"
 
+#include <algorithm>
 #include <list>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -59,11 +61,245 @@ void Polyhedron<T, FP, VP>::addPoints(std::vector<vm::vec<T, 3>> points)
     points = kdl::vec_sort_and_remove_duplicates(std::move(points));
 
     const auto planeEpsilon = computePlaneEpsilon(points);
-    for (const auto& point : points)
+    if (points.size() > QuickhullThreshold)
     {
-      addPoint(point, planeEpsilon);
+      addPointsQuickhull(std::move(points), planeEpsilon);
+    }
+    else
+    {
+      for (const auto& point : points)
+      {
+        addPoint(point, planeEpsilon);
+      }
+    }
+  }
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron<T, FP, VP>::addPointsQuickhull(
+  std::vector<vm::vec<T, 3>> points, const T planeEpsilon)
+{
+  assert(checkInvariant());
+
+  // Presort the points so that the extreme points come first. Since the given points are
+  // sorted lexicographically, the stable sorts keep the result deterministic.
+  typename vm::bbox<T, 3>::builder builder;
+  builder.add(std::begin(points), std::end(points));
+  const auto center = builder.bounds().center();
+  std::stable_sort(
+    std::begin(points), std::end(points), [&](const auto& lhs, const auto& rhs) {
+      return vm::squared_distance(lhs, center) > vm::squared_distance(rhs, center);
+    });
+
+  auto extremePoints = std::vector<vm::vec<T, 3>>{};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const auto [min, max] = std::minmax_element(
+      std::begin(points), std::end(points), [&](const auto& lhs, const auto& rhs) {
+        return lhs[i] < rhs[i];
+      });
+    extremePoints.push_back(*min);
+    extremePoints.push_back(*max);
+  }
+  std::stable_partition(std::begin(points), std::end(points), [&](const auto& point) {
+    return std::find(std::begin(extremePoints), std::end(extremePoints), point)
+           != std::end(extremePoints);
+  });
+
+  // Add points one by one until this polyhedron is a convex volume.
+  auto it = std::begin(points);
+  while (it != std::end(points) && !polyhedron())
+  {
+    addPoint(*it++, planeEpsilon);
+  }
+
+  // Every remaining point is assigned to the first face that it is above. All other
+  // points are inside of this polyhedron or on its boundary and are dropped.
+  auto conflicts = std::unordered_map<Face*, std::vector<vm::vec<T, 3>>>{};
+  conflicts.reserve(2u * points.size());
+  auto pendingFaces = std::vector<Face*>{};
+  auto spareLists = std::vector<std::vector<vm::vec<T, 3>>>{};
+
+  const auto assignPoint = [&](const vm::vec<T, 3>& point, auto& faces) {
+    for (Face* face : faces)
+    {
+      if (face->plane().point_status(point, planeEpsilon) == vm::plane_status::above)
+      {
+        auto [conflict, inserted] = conflicts.try_emplace(face);
+        if (inserted)
+        {
+          if (!spareLists.empty())
+          {
+            conflict->second = std::move(spareLists.back());
+            spareLists.pop_back();
+          }
+          pendingFaces.push_back(face);
+        }
+        conflict->second.push_back(point);
+        return;
+      }
+    }
+  };
+
+  auto orphans = std::vector<vm::vec<T, 3>>{};
+  const auto releasePoints = [&](Face* face) {
+    if (const auto conflict = conflicts.find(face); conflict != std::end(conflicts))
+    {
+      auto& facePoints = conflict->second;
+      orphans.insert(std::end(orphans), std::begin(facePoints), std::end(facePoints));
+      facePoints.clear();
+      spareLists.push_back(std::move(facePoints));
+      conflicts.erase(conflict);
+    }
+  };
+
+  for (; it != std::end(points); ++it)
+  {
+    assignPoint(*it, m_faces);
+  }
+
+  auto visitedFaces = std::unordered_set<Face*>{};
+  const auto hasShortEdge = [&](const vm::vec<T, 3>& position) {
+    for (const Face* face : visitedFaces)
+    {
+      for (const HalfEdge* halfEdge : face->boundary())
+      {
+        if (vm::distance(position, halfEdge->origin()->position()) < MinEdgeLength)
+        {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+
+  auto candidateFaces = std::vector<Face*>{};
+  const auto addCandidateFace = [&](Face* face) {
+    if (
+      std::find(std::begin(candidateFaces), std::end(candidateFaces), face)
+      == std::end(candidateFaces))
+    {
+      candidateFaces.push_back(face);
+    }
+  };
+
+  auto degenerate = false;
+  for (size_t i = 0; i < pendingFaces.size() && !degenerate; ++i)
+  {
+    // If the face was removed, its address may have been reused by a new face. Then we
+    // just process the new face's points here.
+    Face* face = pendingFaces[i];
+    for (auto conflict = conflicts.find(face); conflict != std::end(conflicts);
+         conflict = conflicts.find(face))
+    {
+      auto& facePoints = conflict->second;
+      if (facePoints.empty())
+      {
+        releasePoints(face);
+        break;
+      }
+
+      auto furthest = std::begin(facePoints);
+      auto furthestDistance = face->plane().point_distance(*furthest);
+      for (auto cur = std::next(furthest); cur != std::end(facePoints); ++cur)
+      {
+        const auto distance = face->plane().point_distance(*cur);
+        if (distance > furthestDistance)
+        {
+          furthest = cur;
+          furthestDistance = distance;
+        }
+      }
+
+      const auto position = *furthest;
+      *furthest = facePoints.back();
+      facePoints.pop_back();
+
+      // see addFurtherPointToPolyhedron
+      visitedFaces.clear();
+      auto seam = createSeamForHorizon(position, face, visitedFaces, planeEpsilon);
+      if (seam.empty() || hasShortEdge(position) || !checkSeamForWeaving(seam, position))
+      {
+        continue;
+      }
+
+      auto cone = weaveCone(seam, position);
+      if (!cone)
+      {
+        continue;
+      }
+
+      // The points of all faces which are removed or which may be merged with the new
+      // faces must be reassigned. The visited faces are unordered, so we sort the points.
+      orphans.clear();
+      for (Face* visitedFace : visitedFaces)
+      {
+        releasePoints(visitedFace);
+      }
+      for (Edge* seamEdge : seam)
+      {
+        releasePoints(seamEdge->firstFace());
+      }
+      std::sort(std::begin(orphans), std::end(orphans));
+
+      auto* top = cone->vertices.front();
+      split(seam);
+      sealWithCone(std::move(*cone), seam);
+      if (mergeCoplanarIncidentFaces(top, planeEpsilon))
+      {
+        m_bounds = vm::merge(m_bounds, position);
+
+        // Every point that is still outside of this polyhedron is above one of the faces
+        // incident to the new vertex or one of their neighbours.
+        candidateFaces.clear();
+        auto* firstLeaving = top->leaving();
+        auto* leaving = firstLeaving;
+        do
+        {
+          addCandidateFace(leaving->face());
+          for (HalfEdge* halfEdge : leaving->face()->boundary())
+          {
+            addCandidateFace(halfEdge->twin()->face());
+          }
+          leaving = leaving->nextIncident();
+        } while (leaving != firstLeaving);
+
+        for (const auto& orphan : orphans)
+        {
+          assignPoint(orphan, candidateFaces);
+        }
+      }
+      else if (polyhedron())
+      {
+        // The new vertex was removed because all of its incident faces were coplanar.
+        for (const auto& orphan : orphans)
+        {
+          assignPoint(orphan, m_faces);
+        }
+      }
+      else
+      {
+        degenerate = true;
+        break;
+      }
+      orphans.clear();
+    }
+
+    if (degenerate)
+    {
+      // Add the remaining points one by one.
+      for (size_t j = i; j < pendingFaces.size(); ++j)
+      {
+        releasePoints(pendingFaces[j]);
+      }
+      for (const auto& orphan : orphans)
+      {
+        addPoint(orphan, planeEpsilon);
+      }
     }
   }
+
+  assert(checkInvariant());
 }
 
 template <typename T, typename FP, typename VP>
@@ -652,9 +888,22 @@ std::optional<typename Polyhedron<T, FP, VP>::Seam> Polyhedron<T, FP, VP>::
     return std::nullopt;
   }
 
+  std::unordered_set<Face*> visitedFaces;
+  return createSeamForHorizon(position, initialVisibleFace, visitedFaces, planeEpsilon);
+}
+
+template <typename T, typename FP, typename VP>
+typename Polyhedron<T, FP, VP>::Seam Polyhedron<T, FP, VP>::createSeamForHorizon(
+  const vm::vec<T, 3>& position,
+  Face* initialVisibleFace,
+  std::unordered_set<Face*>& visitedFaces,
+  const T planeEpsilon)
+{
+  assert(initialVisibleFace != nullptr);
+
   Seam seam;
 
-  std::unordered_set<Face*> visitedFaces{initialVisibleFace};
+  visitedFaces.insert(initialVisibleFace);
   visitFace(
     position, initialVisibleFace->boundary().front(), visitedFaces, seam, planeEpsilon);
 
@@ -22,12 +22,17 @@
 #include "Macros.h"
 #include "Polyhedron.h"
 
+#include "kdl/block_pool.h"
+
 #include "vm/distance.h"
 #include "vm/plane.h"
 #include "vm/scalar.h"
 #include "vm/segment.h"
 #include "vm/vec.h"
 
+#include <cassert>
+#include <cstddef>
+
 namespace TrenchBroom
 {
 namespace Model
@@ -50,6 +55,20 @@ const kdl::intrusive_circular_link<Polyhedron_Edge<T, FP, VP>>& Polyhedron_GetEd
   return edge->m_link;
 }
 
+template <typename T, typename FP, typename VP>
+void* Polyhedron_Edge<T, FP, VP>::operator new(const std::size_t size)
+{
+  assert(size == sizeof(Polyhedron_Edge));
+  unused(size);
+  return kdl::block_pool<sizeof(Polyhedron_Edge), alignof(Polyhedron_Edge)>::allocate();
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron_Edge<T, FP, VP>::operator delete(void* ptr) noexcept
+{
+  kdl::block_pool<sizeof(Polyhedron_Edge), alignof(Polyhedron_Edge)>::deallocate(ptr);
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron_Edge<T, FP, VP>::Polyhedron_Edge(HalfEdge* first, HalfEdge* second)
   : m_first(first)
@@ -22,6 +22,8 @@
 #include "Macros.h"
 #include "Polyhedron.h"
 
+#include "kdl/block_pool.h"
+
 #include "vm/constants.h"
 #include "vm/intersection.h"
 #include "vm/plane.h"
@@ -30,6 +32,9 @@
 #include "vm/util.h"
 #include "vm/vec.h"
 
+#include <cassert>
+#include <cstddef>
+
 #include <unordered_set>
 
 namespace TrenchBroom
@@ -54,6 +59,20 @@ const kdl::intrusive_circular_link<Polyhedron_Face<T, FP, VP>>& Polyhedron_GetFa
   return face->m_link;
 }
 
+template <typename T, typename FP, typename VP>
+void* Polyhedron_Face<T, FP, VP>::operator new(const std::size_t size)
+{
+  assert(size == sizeof(Polyhedron_Face));
+  unused(size);
+  return kdl::block_pool<sizeof(Polyhedron_Face), alignof(Polyhedron_Face)>::allocate();
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron_Face<T, FP, VP>::operator delete(void* ptr) noexcept
+{
+  kdl::block_pool<sizeof(Polyhedron_Face), alignof(Polyhedron_Face)>::deallocate(ptr);
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron_Face<T, FP, VP>::Polyhedron_Face(
   HalfEdgeList&& boundary, const vm::plane<T, 3>& plane)
@@ -19,8 +19,14 @@
 
 #pragma once
 
+#include "Macros.h"
 #include "Polyhedron.h"
 
+#include "kdl/block_pool.h"
+
+#include <cassert>
+#include <cstddef>
+
 namespace TrenchBroom
 {
 namespace Model
@@ -42,6 +48,22 @@ Polyhedron_GetHalfEdgeLink<T, FP, VP>::operator()(
   return halfEdge->m_link;
 }
 
+template <typename T, typename FP, typename VP>
+void* Polyhedron_HalfEdge<T, FP, VP>::operator new(const std::size_t size)
+{
+  assert(size == sizeof(Polyhedron_HalfEdge));
+  unused(size);
+  return kdl::block_pool<sizeof(Polyhedron_HalfEdge), alignof(Polyhedron_HalfEdge)>::
+    allocate();
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron_HalfEdge<T, FP, VP>::operator delete(void* ptr) noexcept
+{
+  kdl::block_pool<sizeof(Polyhedron_HalfEdge), alignof(Polyhedron_HalfEdge)>::deallocate(
+    ptr);
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron_HalfEdge<T, FP, VP>::Polyhedron_HalfEdge(Vertex* origin)
   : m_origin(origin)
@@ -31,9 +31,12 @@
 #include "vm/vec.h"
 #include "vm/vec_io.h"
 
+#include <algorithm>
+#include <optional>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -217,6 +220,116 @@ Polyhedron<T, FP, VP>::Polyhedron(std::vector<vm::vec<T, 3>> positions)
   addPoints(std::move(positions));
 }
 
+template <typename T, typename FP, typename VP>
+std::optional<Polyhedron<T, FP, VP>> Polyhedron<T, FP, VP>::fromFaces(
+  const std::vector<vm::vec<T, 3>>& positions,
+  const std::vector<std::vector<size_t>>& faceVertexIndices,
+  const std::vector<vm::plane<T, 3>>& facePlanes)
+{
+  const auto vertexCount = positions.size();
+  if (vertexCount < 4 || faceVertexIndices.size() != facePlanes.size())
+  {
+    return std::nullopt;
+  }
+
+  // a half edge from vertex i to vertex j is identified by i * vertexCount + j
+  const auto halfEdgeKey = [&](const size_t from, const size_t to) {
+    return from * vertexCount + to;
+  };
+
+  // check that every half edge occurs once and has an opposite, and that every vertex
+  // is used
+  auto halfEdgeKeys = std::vector<size_t>{};
+  auto vertexUsed = std::vector<bool>(vertexCount, false);
+  for (const auto& indices : faceVertexIndices)
+  {
+    if (indices.size() < 3)
+    {
+      return std::nullopt;
+    }
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      const auto from = indices[i];
+      const auto to = indices[(i + 1) % indices.size()];
+      if (from >= vertexCount || to >= vertexCount || from == to)
+      {
+        return std::nullopt;
+      }
+      halfEdgeKeys.push_back(halfEdgeKey(from, to));
+      vertexUsed[from] = true;
+    }
+  }
+
+  std::sort(std::begin(halfEdgeKeys), std::end(halfEdgeKeys));
+  if (
+    std::adjacent_find(std::begin(halfEdgeKeys), std::end(halfEdgeKeys))
+    != std::end(halfEdgeKeys))
+  {
+    return std::nullopt;
+  }
+  for (const auto key : halfEdgeKeys)
+  {
+    const auto from = key / vertexCount;
+    const auto to = key % vertexCount;
+    if (!std::binary_search(
+          std::begin(halfEdgeKeys), std::end(halfEdgeKeys), halfEdgeKey(to, from)))
+    {
+      return std::nullopt;
+    }
+  }
+  if (
+    std::find(std::begin(vertexUsed), std::end(vertexUsed), false)
+    != std::end(vertexUsed))
+  {
+    return std::nullopt;
+  }
+
+  auto result = Polyhedron{};
+
+  auto vertices = std::vector<Vertex*>{};
+  vertices.reserve(vertexCount);
+  for (const auto& position : positions)
+  {
+    auto* vertex = new Vertex{position};
+    result.m_vertices.push_back(vertex);
+    vertices.push_back(vertex);
+  }
+
+  // maps the key of each half edge that does not have an edge yet to the half edge
+  auto openHalfEdges = std::unordered_map<size_t, HalfEdge*>{};
+  for (size_t i = 0; i < faceVertexIndices.size(); ++i)
+  {
+    const auto& indices = faceVertexIndices[i];
+
+    auto boundary = HalfEdgeList{};
+    for (size_t j = 0; j < indices.size(); ++j)
+    {
+      const auto from = indices[j];
+      const auto to = indices[(j + 1) % indices.size()];
+
+      auto* halfEdge = new HalfEdge{vertices[from]};
+      boundary.push_back(halfEdge);
+
+      if (const auto it = openHalfEdges.find(halfEdgeKey(to, from));
+          it != std::end(openHalfEdges))
+      {
+        result.m_edges.push_back(new Edge{it->second, halfEdge});
+        openHalfEdges.erase(it);
+      }
+      else
+      {
+        openHalfEdges.emplace(halfEdgeKey(from, to), halfEdge);
+      }
+    }
+
+    result.m_faces.push_back(new Face{std::move(boundary), facePlanes[i]});
+  }
+  assert(openHalfEdges.empty());
+
+  result.updateBounds();
+  return result;
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron<T, FP, VP>::Polyhedron(const Polyhedron<T, FP, VP>& other)
 {
@@ -806,6 +919,94 @@ typename Polyhedron<T, FP, VP>::Face* Polyhedron<T, FP, VP>::findClosestFace(
   return closestFace;
 }
 
+template <typename T, typename FP, typename VP>
+bool Polyhedron<T, FP, VP>::moveVerticesKeepingTopology(
+  const std::vector<vm::vec<T, 3>>& positions,
+  const vm::vec<T, 3>& delta,
+  const T epsilon)
+{
+  if (!polyhedron())
+  {
+    return false;
+  }
+
+  auto movingVertices = std::unordered_set<const Vertex*>{};
+  for (const auto* vertex : m_vertices)
+  {
+    if (kdl::vec_contains(positions, vertex->position()))
+    {
+      movingVertices.insert(vertex);
+    }
+  }
+
+  const auto newPosition = [&](const Vertex* vertex) {
+    return movingVertices.count(vertex) > 0 ? vertex->position() + delta
+                                            : vertex->position();
+  };
+
+  auto newPlanes = std::vector<vm::plane<T, 3>>{};
+  newPlanes.reserve(m_faces.size());
+
+  auto faceVertices = std::vector<const Vertex*>{};
+  for (const auto* face : m_faces)
+  {
+    // use the first three consecutive vertices that are not colinear, oriented in the
+    // same way as the faces created when building a convex hull
+    auto newPlane = std::optional<vm::plane<T, 3>>{};
+    faceVertices.clear();
+    for (const auto* halfEdge : face->boundary())
+    {
+      faceVertices.push_back(halfEdge->origin());
+      if (!newPlane)
+      {
+        const auto [valid, plane] = vm::from_points(
+          newPosition(halfEdge->next()->origin()),
+          newPosition(halfEdge->origin()),
+          newPosition(halfEdge->previous()->origin()));
+        if (valid)
+        {
+          newPlane = plane;
+        }
+      }
+    }
+
+    if (!newPlane)
+    {
+      return false;
+    }
+
+    for (const auto* vertex : m_vertices)
+    {
+      const auto expectedStatus = kdl::vec_contains(faceVertices, vertex)
+                                    ? vm::plane_status::inside
+                                    : vm::plane_status::below;
+      if (newPlane->point_status(newPosition(vertex), epsilon) != expectedStatus)
+      {
+        return false;
+      }
+    }
+
+    newPlanes.push_back(*newPlane);
+  }
+
+  for (auto* vertex : m_vertices)
+  {
+    if (movingVertices.count(vertex) > 0)
+    {
+      vertex->setPosition(vertex->position() + delta);
+    }
+  }
+
+  auto newPlane = newPlanes.begin();
+  for (auto* face : m_faces)
+  {
+    face->setPlane(*newPlane++);
+  }
+
+  updateBounds();
+  return true;
+}
+
 template <typename T, typename FP, typename VP>
 void Polyhedron<T, FP, VP>::updateBounds()
 {
@@ -19,10 +19,15 @@
 
 #pragma once
 
+#include "Macros.h"
 #include "Polyhedron.h"
 
+#include "kdl/block_pool.h"
 #include "kdl/intrusive_circular_list.h"
 
+#include <cassert>
+#include <cstddef>
+
 namespace TrenchBroom
 {
 namespace Model
@@ -44,6 +49,21 @@ Polyhedron_GetVertexLink<T, FP, VP>::operator()(
   return vertex->m_link;
 }
 
+template <typename T, typename FP, typename VP>
+void* Polyhedron_Vertex<T, FP, VP>::operator new(const std::size_t size)
+{
+  assert(size == sizeof(Polyhedron_Vertex));
+  unused(size);
+  return kdl::block_pool<sizeof(Polyhedron_Vertex), alignof(Polyhedron_Vertex)>::
+    allocate();
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron_Vertex<T, FP, VP>::operator delete(void* ptr) noexcept
+{
+  kdl::block_pool<sizeof(Polyhedron_Vertex), alignof(Polyhedron_Vertex)>::deallocate(ptr);
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron_Vertex<T, FP, VP>::Polyhedron_Vertex(const vm::vec<T, 3>& position)
   : m_position(position)
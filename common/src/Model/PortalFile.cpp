@@ -22,7 +22,9 @@
 #include "Error.h"
 #include "IO/DiskIO.h"
 
+#include "kdl/parallel.h"
 #include "kdl/result.h"
+#include "kdl/result_fold.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
 
@@ -31,6 +33,7 @@
 #include "vm/vec.h"
 
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom::Model
 {
@@ -53,10 +56,70 @@ bool canLoadPortalFile(const std::filesystem::path& path)
     .value();
 }
 
-Result<PortalFile> loadPortalFile(std::istream& stream)
+namespace
+{
+
+constexpr auto LineSplitter = std::string_view{"() \n\t\r"};
+
+std::vector<std::string_view> splitPortalLine(const std::string_view line)
+{
+  auto components = std::vector<std::string_view>{};
+
+  auto first = line.find_first_not_of(LineSplitter);
+  while (first != std::string_view::npos)
+  {
+    const auto last = line.find_first_of(LineSplitter, first);
+    components.push_back(line.substr(first, last - first));
+    first = line.find_first_not_of(LineSplitter, last);
+  }
+
+  return components;
+}
+
+Result<vm::polygon3f> parsePortal(const std::string& line, const bool prt1ForQ3)
 {
-  static const auto lineSplitter = "() \n\t\r";
+  const auto components = splitPortalLine(line);
+  if (components.size() < 3)
+  {
+    return Error{"Error reading portal"};
+  }
+
+  const auto numPoints = kdl::str_to_size(components[0]);
+  if (!numPoints)
+  {
+    return Error{"Error reading portal"};
+  }
+
+  auto verts = std::vector<vm::vec3f>{};
+  verts.reserve(*numPoints);
 
+  auto ptr = prt1ForQ3 ? 4u : 3u;
+  for (size_t i = 0; i < *numPoints; ++i)
+  {
+    if (ptr + 2 >= components.size())
+    {
+      return Error{"Error reading portal"};
+    }
+
+    const auto x = kdl::str_to_float(components[ptr]);
+    const auto y = kdl::str_to_float(components[ptr + 1]);
+    const auto z = kdl::str_to_float(components[ptr + 2]);
+    if (!x || !y || !z)
+    {
+      return Error{"Error reading portal"};
+    }
+
+    verts.emplace_back(*x, *y, *z);
+    ptr += 3;
+  }
+
+  return vm::polygon3f{std::move(verts)};
+}
+
+} // namespace
+
+Result<PortalFile> loadPortalFile(std::istream& stream)
+{
   auto line = std::string{};
   auto numPortals = 0ul;
   auto prt1ForQ3 = false;
@@ -75,7 +138,7 @@ Result<PortalFile> loadPortalFile(std::istream& stream)
     // If this line contains a single value, it is Q3-style PRT1 (value is
     // number of solid faces -- will ignore). Otherwise is Q1/Q2 style and we
     // will rewind the stream to process this line accordingly.
-    const auto componentsCheck = kdl::str_split(line, lineSplitter);
+    const auto componentsCheck = splitPortalLine(line);
     if (componentsCheck.size() == 1)
     {
       prt1ForQ3 = true;
@@ -109,41 +172,26 @@ Result<PortalFile> loadPortalFile(std::istream& stream)
     return Error{"Error reading header"};
   }
 
-  // read portals
-  auto portals = std::vector<vm::polygon3f>{};
-  portals.reserve(numPortals);
+  // read the portal lines first, then parse them in parallel
+  auto lines = std::vector<std::string>{};
+  lines.reserve(numPortals);
 
   for (size_t i = 0; i < numPortals; ++i)
   {
     std::getline(stream, line);
-    const auto components = kdl::str_split(line, lineSplitter);
-
-    if (!stream.good() || components.size() < 3)
+    if (!stream.good())
     {
       return Error{"Error reading portal"};
     }
+    lines.push_back(std::move(line));
+  }
 
-    auto verts = std::vector<vm::vec3f>{};
-    auto ptr = prt1ForQ3 ? 4u : 3u;
-    const int numPoints = std::stoi(components.at(0));
-    for (int j = 0; j < numPoints; ++j)
-    {
-      if (ptr + 2 >= components.size())
-      {
-        return Error{"Error reading portal"};
-      }
-
-      verts.emplace_back(
-        std::stof(components.at(ptr)),
-        std::stof(components.at(ptr + 1)),
-        std::stof(components.at(ptr + 2)));
-      ptr += 3;
-    }
+  auto portals = kdl::vec_parallel_transform(
+    std::move(lines), [&](const auto& l) { return parsePortal(l, prt1ForQ3); });
 
-    portals.emplace_back(std::move(verts));
-  }
-  return PortalFile{std::move(portals)};
+  return kdl::fold_results(std::move(portals)).transform([](auto polygons) {
+    return PortalFile{std::move(polygons)};
+  });
 }
 
-
 } // namespace TrenchBroom::Model
@@ -173,6 +173,8 @@ bool operator<(const TagReference& lhs, const TagReference& rhs)
 Taggable::Taggable()
   : m_tagMask(0)
   , m_attributeMask(0)
+  , m_tagInputHashes{}
+  , m_validTagInputs(TagMatcherInput::None)
 {
 }
 
@@ -182,6 +184,8 @@ void swap(Taggable& lhs, Taggable& rhs) noexcept
   swap(lhs.m_tagMask, rhs.m_tagMask);
   swap(lhs.m_tags, rhs.m_tags);
   swap(lhs.m_attributeMask, rhs.m_attributeMask);
+  swap(lhs.m_tagInputHashes, rhs.m_tagInputHashes);
+  swap(lhs.m_validTagInputs, rhs.m_validTagInputs);
 }
 
 Taggable::~Taggable() = default;
@@ -254,9 +258,30 @@ void Taggable::clearTags()
 {
   m_tagMask = 0;
   m_tags.clear();
+  m_validTagInputs = TagMatcherInput::None;
   updateAttributeMask();
 }
 
+TagMatcherInput::Type Taggable::updateTagInputHashes(const TagMatcherInput::Type inputs)
+{
+  auto changedInputs = TagMatcherInput::Other;
+  for (size_t i = 0; i < TagMatcherInput::Count; ++i)
+  {
+    const auto input = TagMatcherInput::Type(1) << i;
+    if ((inputs & input) != 0)
+    {
+      const auto hash = doGetTagInputHash(input);
+      if ((m_validTagInputs & input) == 0 || m_tagInputHashes[i] != hash)
+      {
+        m_tagInputHashes[i] = hash;
+        m_validTagInputs |= input;
+        changedInputs |= input;
+      }
+    }
+  }
+  return changedInputs;
+}
+
 bool Taggable::hasAttribute(const TagAttribute& attribute) const
 {
   return (m_attributeMask & attribute.type()) != 0;
@@ -285,6 +310,11 @@ void Taggable::updateAttributeMask()
   }
 }
 
+size_t Taggable::doGetTagInputHash(const TagMatcherInput::Type /* input */) const
+{
+  return 0;
+}
+
 TagMatcherCallback::~TagMatcherCallback() = default;
 
 TagMatcher::~TagMatcher() = default;
@@ -307,6 +337,11 @@ bool TagMatcher::canDisable() const
   return false;
 }
 
+TagMatcherInput::Type TagMatcher::inputs() const
+{
+  return TagMatcherInput::All;
+}
+
 std::ostream& operator<<(std::ostream& str, const TagMatcher& matcher)
 {
   matcher.appendToStream(str);
@@ -346,6 +381,11 @@ bool SmartTag::matches(const Taggable& taggable) const
   return m_matcher->matches(taggable);
 }
 
+TagMatcherInput::Type SmartTag::inputs() const
+{
+  return m_matcher->inputs();
+}
+
 void SmartTag::update(Taggable& taggable) const
 {
   if (matches(taggable))
@@ -24,6 +24,7 @@
 
 #include "kdl/vector_set.h"
 
+#include <array>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -191,6 +192,13 @@ private:
   kdl::vector_set<TagReference> m_tags;
   TagAttribute::AttributeType m_attributeMask;
 
+  /**
+   * The fingerprints of the tag matcher inputs which the smart tags were last evaluated
+   * against, indexed by the bit index of the input.
+   */
+  std::array<size_t, TagMatcherInput::Count> m_tagInputHashes;
+  TagMatcherInput::Type m_validTagInputs;
+
 public:
   /**
    * Creates a new instance.
@@ -268,6 +276,16 @@ public:
    */
   virtual void clearTags();
 
+  /**
+   * Recomputes the fingerprints of the given tag matcher inputs and returns the inputs
+   * whose fingerprints have changed since they were last computed. The returned inputs
+   * always include TagMatcherInput::Other.
+   *
+   * @param inputs the inputs to update
+   * @return the inputs that have changed
+   */
+  TagMatcherInput::Type updateTagInputHashes(TagMatcherInput::Type inputs);
+
   /**
    * Indicates whether any of the tags associated with this object has the given tag
    * attribute.
@@ -297,6 +315,13 @@ private:
 private:
   virtual void doAcceptTagVisitor(TagVisitor& visitor) = 0;
   virtual void doAcceptTagVisitor(ConstTagVisitor& visitor) const = 0;
+
+  /**
+   * Returns a fingerprint of the given tag matcher input. The default implementation
+   * returns 0 for every input, which is appropriate for taggables that have no such
+   * input.
+   */
+  virtual size_t doGetTagInputHash(TagMatcherInput::Type input) const;
 };
 
 class MapFacade;
@@ -368,6 +393,13 @@ public:
    */
   virtual std::unique_ptr<TagMatcher> clone() const = 0;
 
+  /**
+   * Returns the inputs that this matcher evaluates. The matcher is only reevaluated
+   * against a taggable if one of these inputs has changed. The default implementation
+   * returns TagMatcherInput::All.
+   */
+  virtual TagMatcherInput::Type inputs() const;
+
   virtual void appendToStream(std::ostream& str) const = 0;
 };
 
@@ -408,6 +440,11 @@ public:
    */
   bool matches(const Taggable& taggable) const;
 
+  /**
+   * Returns the inputs that this tag's matcher evaluates.
+   */
+  TagMatcherInput::Type inputs() const;
+
   /**
    * Updates the given tag depending on whether or not the matcher matches against it.
    *
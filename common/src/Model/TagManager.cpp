@@ -110,18 +110,29 @@ void TagManager::registerSmartTags(const std::vector<SmartTag>& tags)
 
     it->setIndex(nextIndex);
   }
+
+  m_smartTagInputs = TagMatcherInput::None;
+  for (const auto& tag : m_smartTags)
+  {
+    m_smartTagInputs |= tag.inputs();
+  }
 }
 
 void TagManager::clearSmartTags()
 {
   m_smartTags.clear();
+  m_smartTagInputs = TagMatcherInput::None;
 }
 
 void TagManager::updateTags(Taggable& taggable) const
 {
+  const auto changedInputs = taggable.updateTagInputHashes(m_smartTagInputs);
   for (const auto& tag : m_smartTags)
   {
-    tag.update(taggable);
+    if ((tag.inputs() & changedInputs) != 0)
+    {
+      tag.update(taggable);
+    }
   }
 }
 
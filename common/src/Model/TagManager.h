@@ -44,6 +44,7 @@ private:
   };
 
   kdl::vector_set<SmartTag, TagCmp> m_smartTags;
+  TagMatcherInput::Type m_smartTagInputs = TagMatcherInput::None;
 
 public:
   /**
@@ -108,7 +109,8 @@ public:
   void clearSmartTags();
 
   /**
-   * Update the smart tags of the given taggable object.
+   * Update the smart tags of the given taggable object. Only the smart tags whose inputs
+   * have changed since the taggable was last updated are reevaluated.
    *
    * @param taggable the object to update
    */
@@ -154,6 +154,11 @@ bool TextureNameTagMatcher::matches(const Taggable& taggable) const
   return visitor.matches();
 }
 
+TagMatcherInput::Type TextureNameTagMatcher::inputs() const
+{
+  return TagMatcherInput::TextureName;
+}
+
 void TextureNameTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "TextureNameTagMatcher"
@@ -210,6 +215,11 @@ bool SurfaceParmTagMatcher::matches(const Taggable& taggable) const
   return visitor.matches();
 }
 
+TagMatcherInput::Type SurfaceParmTagMatcher::inputs() const
+{
+  return TagMatcherInput::Texture;
+}
+
 void SurfaceParmTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "SurfaceParmTagMatcher"
@@ -365,6 +375,11 @@ std::unique_ptr<TagMatcher> ContentFlagsTagMatcher::clone() const
   return std::make_unique<ContentFlagsTagMatcher>(m_flags);
 }
 
+TagMatcherInput::Type ContentFlagsTagMatcher::inputs() const
+{
+  return TagMatcherInput::ContentFlags;
+}
+
 SurfaceFlagsTagMatcher::SurfaceFlagsTagMatcher(const int i_flags)
   : FlagsTagMatcher(
     i_flags,
@@ -385,6 +400,11 @@ std::unique_ptr<TagMatcher> SurfaceFlagsTagMatcher::clone() const
   return std::make_unique<SurfaceFlagsTagMatcher>(m_flags);
 }
 
+TagMatcherInput::Type SurfaceFlagsTagMatcher::inputs() const
+{
+  return TagMatcherInput::SurfaceFlags;
+}
+
 EntityClassNameTagMatcher::EntityClassNameTagMatcher(
   const std::string& pattern, const std::string& texture)
   : m_pattern(pattern)
@@ -414,6 +434,11 @@ bool EntityClassNameTagMatcher::matches(const Taggable& taggable) const
   return visitor.matches();
 }
 
+TagMatcherInput::Type EntityClassNameTagMatcher::inputs() const
+{
+  return TagMatcherInput::Classname;
+}
+
 void EntityClassNameTagMatcher::enable(
   TagMatcherCallback& callback, MapFacade& facade) const
 {
@@ -104,6 +104,7 @@ public:
   explicit TextureNameTagMatcher(const std::string& pattern);
   std::unique_ptr<TagMatcher> clone() const override;
   bool matches(const Taggable& taggable) const override;
+  TagMatcherInput::Type inputs() const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
@@ -121,6 +122,7 @@ public:
   explicit SurfaceParmTagMatcher(const kdl::vector_set<std::string>& parameters);
   std::unique_ptr<TagMatcher> clone() const override;
   bool matches(const Taggable& taggable) const override;
+  TagMatcherInput::Type inputs() const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
@@ -163,6 +165,7 @@ class ContentFlagsTagMatcher : public FlagsTagMatcher
 public:
   explicit ContentFlagsTagMatcher(int flags);
   std::unique_ptr<TagMatcher> clone() const override;
+  TagMatcherInput::Type inputs() const override;
 };
 
 class SurfaceFlagsTagMatcher : public FlagsTagMatcher
@@ -170,6 +173,7 @@ class SurfaceFlagsTagMatcher : public FlagsTagMatcher
 public:
   explicit SurfaceFlagsTagMatcher(int flags);
   std::unique_ptr<TagMatcher> clone() const override;
+  TagMatcherInput::Type inputs() const override;
 };
 
 class EntityClassNameTagMatcher : public TagMatcher
@@ -187,6 +191,7 @@ public:
 
 public:
   bool matches(const Taggable& taggable) const override;
+  TagMatcherInput::Type inputs() const override;
   void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
   void disable(TagMatcherCallback& callback, MapFacade& facade) const override;
   bool canEnable() const override;
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace TrenchBroom
@@ -32,5 +33,34 @@ using Type = uint64_t;
 constexpr Type NoType = 0u;
 constexpr Type AnyType = ~NoType;
 } // namespace TagType
+
+/**
+ * The inputs that a tag matcher evaluates. Taggables can compute a fingerprint for each
+ * input so that smart tags are only reevaluated when one of their inputs has changed.
+ */
+namespace TagMatcherInput
+{
+using Type = uint32_t;
+
+constexpr Type None = 0u;
+constexpr Type TextureName = 1u << 0;
+constexpr Type Texture = 1u << 1;
+constexpr Type ContentFlags = 1u << 2;
+constexpr Type SurfaceFlags = 1u << 3;
+constexpr Type Classname = 1u << 4;
+
+/**
+ * The number of inputs for which taggables compute fingerprints.
+ */
+constexpr size_t Count = 5u;
+
+/**
+ * Any other input. Taggables never compute a fingerprint for this, so tag matchers that
+ * depend on it are always reevaluated.
+ */
+constexpr Type Other = 1u << Count;
+
+constexpr Type All = ~None;
+} // namespace TagMatcherInput
 } // namespace Model
 } // namespace TrenchBroom
@@ -30,6 +30,15 @@ namespace TrenchBroom
 {
 namespace Model
 {
+TexCoordSystemTransformation::TexCoordSystemTransformation(
+  const vm::mat4x4& transformation_)
+  : transformation{transformation_}
+  , rotationScale{vm::strip_translation(transformation_)}
+  , translation{transformation_ * vm::vec3::zero()}
+{
+  std::tie(invertible, inverseTransformation) = vm::invert(transformation_);
+}
+
 TexCoordSystemSnapshot::~TexCoordSystemSnapshot() = default;
 
 void TexCoordSystemSnapshot::restore(TexCoordSystem& coordSystem) const
@@ -108,6 +117,15 @@ vm::vec2f TexCoordSystem::getTexCoords(
   return doGetTexCoords(point, attribs, textureSize);
 }
 
+void TexCoordSystem::getTexCoords(
+  const std::vector<vm::vec3>& points,
+  const BrushFaceAttributes& attribs,
+  const vm::vec2f& textureSize,
+  std::vector<vm::vec2f>& texCoords) const
+{
+  doGetTexCoords(points, attribs, textureSize, texCoords);
+}
+
 void TexCoordSystem::setRotation(
   const vm::vec3& normal, const float oldAngle, const float newAngle)
 {
@@ -117,7 +135,7 @@ void TexCoordSystem::setRotation(
 void TexCoordSystem::transform(
   const vm::plane3& oldBoundary,
   const vm::plane3& newBoundary,
-  const vm::mat4x4& transformation,
+  const TexCoordSystemTransformation& transformation,
   BrushFaceAttributes& attribs,
   const vm::vec2f& textureSize,
   bool lockTexture,
@@ -328,6 +346,26 @@ vm::vec2f TexCoordSystem::computeTexCoords(
     dot(point, safeScaleAxis(getYAxis(), scale.y())));
 }
 
+void TexCoordSystem::computeTexCoords(
+  const std::vector<vm::vec3>& points,
+  const BrushFaceAttributes& attribs,
+  const vm::vec2f& textureSize,
+  std::vector<vm::vec2f>& texCoords) const
+{
+  const auto xAxis = safeScaleAxis(getXAxis(), attribs.scale().x());
+  const auto yAxis = safeScaleAxis(getYAxis(), attribs.scale().y());
+  const auto offset = attribs.offset();
+
+  // no virtual calls or branches in this loop so that the compiler can vectorize it
+  const auto first = texCoords.size();
+  texCoords.resize(first + points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    texCoords[first + i] =
+      (vm::vec2f(dot(points[i], xAxis), dot(points[i], yAxis)) + offset) / textureSize;
+  }
+}
+
 std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> TexCoordSystem::
   toParallel(
     const vm::vec3& point0,
@@ -23,10 +23,12 @@
 #include "Macros.h"
 #include "Model/BrushFaceAttributes.h"
 
+#include "vm/mat.h"
 #include "vm/vec.h"
 
 #include <memory>
 #include <tuple>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -58,6 +60,22 @@ enum class WrapStyle
   Rotation
 };
 
+/**
+ * A transformation of texture coordinate systems together with the values derived from
+ * it. If many faces are transformed with the same matrix, these values are computed once
+ * and shared instead of being recomputed for every face.
+ */
+struct TexCoordSystemTransformation
+{
+  vm::mat4x4 transformation;
+  vm::mat4x4 rotationScale;
+  bool invertible;
+  vm::mat4x4 inverseTransformation;
+  vm::vec3 translation;
+
+  explicit TexCoordSystemTransformation(const vm::mat4x4& transformation);
+};
+
 class TexCoordSystem
 {
 public:
@@ -87,11 +105,22 @@ public:
     const BrushFaceAttributes& attribs,
     const vm::vec2f& textureSize) const;
 
+  /**
+   * Computes the texture coordinates of the given points and appends them to the given
+   * vector. This is equivalent to calling getTexCoords for every point, but the scaled
+   * texture axes are computed only once.
+   */
+  void getTexCoords(
+    const std::vector<vm::vec3>& points,
+    const BrushFaceAttributes& attribs,
+    const vm::vec2f& textureSize,
+    std::vector<vm::vec2f>& texCoords) const;
+
   void setRotation(const vm::vec3& normal, float oldAngle, float newAngle);
   void transform(
     const vm::plane3& oldBoundary,
     const vm::plane3& newBoundary,
-    const vm::mat4x4& transformation,
+    const TexCoordSystemTransformation& transformation,
     BrushFaceAttributes& attribs,
     const vm::vec2f& textureSize,
     bool lockTexture,
@@ -152,12 +181,17 @@ private:
     const vm::vec3& point,
     const BrushFaceAttributes& attribs,
     const vm::vec2f& textureSize) const = 0;
+  virtual void doGetTexCoords(
+    const std::vector<vm::vec3>& points,
+    const BrushFaceAttributes& attribs,
+    const vm::vec2f& textureSize,
+    std::vector<vm::vec2f>& texCoords) const = 0;
 
   virtual void doSetRotation(const vm::vec3& normal, float oldAngle, float newAngle) = 0;
   virtual void doTransform(
     const vm::plane3& oldBoundary,
     const vm::plane3& newBoundary,
-    const vm::mat4x4& transformation,
+    const TexCoordSystemTransformation& transformation,
     BrushFaceAttributes& attribs,
     const vm::vec2f& textureSize,
     bool lockTexture,
@@ -187,6 +221,11 @@ private:
 
 protected:
   vm::vec2f computeTexCoords(const vm::vec3& point, const vm::vec2f& scale) const;
+  void computeTexCoords(
+    const std::vector<vm::vec3>& points,
+    const BrushFaceAttributes& attribs,
+    const vm::vec2f& textureSize,
+    std::vector<vm::vec2f>& texCoords) const;
 
   template <typename T>
   T safeScale(const T value) const
@@ -202,7 +241,11 @@ protected:
     return axis / safeScale(T1(factor));
   }
 
-  deleteCopyAndMove(TexCoordSystem);
+  // only the concrete coordinate systems can be copied to prevent slicing
+  TexCoordSystem(const TexCoordSystem& other) = default;
+  TexCoordSystem(TexCoordSystem&& other) noexcept = default;
+  TexCoordSystem& operator=(const TexCoordSystem& other) = default;
+  TexCoordSystem& operator=(TexCoordSystem&& other) = default;
 };
 } // namespace Model
 } // namespace TrenchBroom
@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureNodeIndex.h"
+
+#include "Ensure.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushNode.h"
+
+namespace TrenchBroom::Model
+{
+
+void TextureNodeIndex::addBrushNode(BrushNode* brushNode)
+{
+  for (const auto& face : brushNode->brush().faces())
+  {
+    addTexture(brushNode, face.texture());
+  }
+}
+
+void TextureNodeIndex::removeBrushNode(BrushNode* brushNode)
+{
+  for (const auto& face : brushNode->brush().faces())
+  {
+    removeTexture(brushNode, face.texture());
+  }
+}
+
+void TextureNodeIndex::addTexture(BrushNode* brushNode, const Assets::Texture* texture)
+{
+  if (texture)
+  {
+    ++m_brushNodes[texture][brushNode];
+  }
+}
+
+void TextureNodeIndex::removeTexture(
+  BrushNode* brushNode, const Assets::Texture* texture)
+{
+  if (texture)
+  {
+    auto textureIt = m_brushNodes.find(texture);
+    ensure(textureIt != m_brushNodes.end(), "texture is indexed");
+
+    auto& brushNodeCounts = textureIt->second;
+    auto brushNodeIt = brushNodeCounts.find(brushNode);
+    ensure(brushNodeIt != brushNodeCounts.end(), "brush node is indexed");
+
+    if (--brushNodeIt->second == 0u)
+    {
+      brushNodeCounts.erase(brushNodeIt);
+      if (brushNodeCounts.empty())
+      {
+        m_brushNodes.erase(textureIt);
+      }
+    }
+  }
+}
+
+std::vector<BrushNode*> TextureNodeIndex::findBrushNodes(
+  const Assets::Texture* texture) const
+{
+  auto result = std::vector<BrushNode*>{};
+  if (const auto it = m_brushNodes.find(texture); it != m_brushNodes.end())
+  {
+    result.reserve(it->second.size());
+    for (const auto& [brushNode, count] : it->second)
+    {
+      result.push_back(brushNode);
+    }
+  }
+  return result;
+}
+
+std::vector<BrushFaceHandle> TextureNodeIndex::findBrushFaces(
+  const Assets::Texture* texture) const
+{
+  auto result = std::vector<BrushFaceHandle>{};
+  if (const auto it = m_brushNodes.find(texture); it != m_brushNodes.end())
+  {
+    for (const auto& [brushNode, count] : it->second)
+    {
+      const auto& faces = brushNode->brush().faces();
+      for (size_t i = 0u; i < faces.size(); ++i)
+      {
+        if (faces[i].texture() == texture)
+        {
+          result.emplace_back(brushNode, i);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+bool TextureNodeIndex::contains(const Assets::Texture* texture) const
+{
+  return m_brushNodes.count(texture) > 0u;
+}
+
+} // namespace TrenchBroom::Model
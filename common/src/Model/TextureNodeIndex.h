@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom::Assets
+{
+class Texture;
+}
+
+namespace TrenchBroom::Model
+{
+class BrushFaceHandle;
+class BrushNode;
+
+/**
+ * Maps textures to the brush nodes that have at least one face with that texture. The
+ * world keeps the index up to date when brush nodes are added or removed and when the
+ * textures of their faces change, so that the faces using a texture can be found without
+ * visiting every brush in the map.
+ */
+class TextureNodeIndex
+{
+private:
+  // maps each brush node to the number of its faces that use the texture
+  using BrushNodeCounts = std::unordered_map<BrushNode*, std::size_t>;
+  std::unordered_map<const Assets::Texture*, BrushNodeCounts> m_brushNodes;
+
+public:
+  void addBrushNode(BrushNode* brushNode);
+  void removeBrushNode(BrushNode* brushNode);
+
+  void addTexture(BrushNode* brushNode, const Assets::Texture* texture);
+  void removeTexture(BrushNode* brushNode, const Assets::Texture* texture);
+
+  /**
+   * Returns the brush nodes which have at least one face with the given texture, in no
+   * particular order.
+   */
+  std::vector<BrushNode*> findBrushNodes(const Assets::Texture* texture) const;
+
+  /**
+   * Returns handles to the faces with the given texture, in no particular order.
+   */
+  std::vector<BrushFaceHandle> findBrushFaces(const Assets::Texture* texture) const;
+
+  /**
+   * Indicates whether any brush face uses the given texture.
+   */
+  bool contains(const Assets::Texture* texture) const;
+};
+
+} // namespace TrenchBroom::Model
@@ -64,6 +64,29 @@ void Validator::validate(Node& node, std::vector<std::unique_ptr<Issue>>& issues
     [&](PatchNode* patchNode) { doValidate(*patchNode, issues); }));
 }
 
+std::chrono::nanoseconds Validator::validationTime() const
+{
+  return std::chrono::nanoseconds{m_validationTime.load()};
+}
+
+size_t Validator::validatedNodeCount() const
+{
+  return m_validatedNodeCount.load();
+}
+
+void Validator::addValidationStatistics(
+  const std::chrono::nanoseconds time, const size_t nodeCount) const
+{
+  m_validationTime += time.count();
+  m_validatedNodeCount += nodeCount;
+}
+
+void Validator::resetValidationStatistics() const
+{
+  m_validationTime = 0;
+  m_validatedNodeCount = 0;
+}
+
 Validator::Validator(const IssueType type, const std::string& description)
   : m_type{type}
   , m_description{description}
@@ -22,6 +22,8 @@
 #include "Model/IssueQuickFix.h"
 #include "Model/IssueType.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -47,6 +49,9 @@ private:
   std::string m_description;
   std::vector<IssueQuickFix> m_quickFixes;
 
+  mutable std::atomic<std::chrono::nanoseconds::rep> m_validationTime{0};
+  mutable std::atomic<size_t> m_validatedNodeCount{0};
+
 public:
   virtual ~Validator();
 
@@ -56,6 +61,17 @@ public:
 
   void validate(Node& node, std::vector<std::unique_ptr<Issue>>& issues) const;
 
+  /**
+   * The total time this validator spent validating nodes in calls to
+   * Model::validateIssues, and the number of nodes it validated. These can be used to
+   * find out which validators are expensive.
+   */
+  std::chrono::nanoseconds validationTime() const;
+  size_t validatedNodeCount() const;
+
+  void addValidationStatistics(std::chrono::nanoseconds time, size_t nodeCount) const;
+  void resetValidationStatistics() const;
+
 protected:
   Validator(IssueType type, const std::string& description);
   void addQuickFix(IssueQuickFix quickFix);
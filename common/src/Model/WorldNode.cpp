@@ -22,12 +22,14 @@
 #include "Ensure.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
+#include "Model/ContentHasher.h"
 #include "Model/EntityNode.h"
 #include "Model/EntityNodeIndex.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
 #include "Model/PatchNode.h"
 #include "Model/TagVisitor.h"
+#include "Model/TextureNodeIndex.h"
 #include "Model/Validator.h"
 #include "Model/ValidatorRegistry.h"
 #include "octree.h"
@@ -40,6 +42,7 @@
 
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
@@ -52,6 +55,7 @@ WorldNode::WorldNode(
   , m_mapFormat{mapFormat}
   , m_defaultLayer{nullptr}
   , m_entityNodeIndex{std::make_unique<EntityNodeIndex>()}
+  , m_textureNodeIndex{std::make_unique<TextureNodeIndex>()}
   , m_validatorRegistry{std::make_unique<ValidatorRegistry>()}
   , m_nodeTree{std::make_unique<NodeTree>(256.0)}
   , m_updateNodeTree{true}
@@ -181,11 +185,80 @@ void WorldNode::createDefaultLayer()
   assert(m_defaultLayer->layer().sortIndex() == Layer::defaultLayerSortIndex());
 }
 
+const std::vector<Node*>& WorldNode::allDescendants() const
+{
+  return flattenedNodes().nodes;
+}
+
+const std::vector<GroupNode*>& WorldNode::allGroups() const
+{
+  return flattenedNodes().groups;
+}
+
+const std::vector<EntityNode*>& WorldNode::allEntities() const
+{
+  return flattenedNodes().entities;
+}
+
+const std::vector<BrushNode*>& WorldNode::allBrushes() const
+{
+  return flattenedNodes().brushes;
+}
+
+const std::vector<PatchNode*>& WorldNode::allPatches() const
+{
+  return flattenedNodes().patches;
+}
+
+const WorldNode::FlattenedNodes& WorldNode::flattenedNodes() const
+{
+  if (!m_flattenedNodes)
+  {
+    auto flattenedNodes = FlattenedNodes{};
+    flattenedNodes.nodes.reserve(descendantCount());
+
+    Node::visitAll(
+      children(),
+      kdl::overload(
+        [](WorldNode*) {},
+        [&](auto&& thisLambda, LayerNode* layer) {
+          flattenedNodes.nodes.push_back(layer);
+          layer->visitChildren(thisLambda);
+        },
+        [&](auto&& thisLambda, GroupNode* group) {
+          flattenedNodes.nodes.push_back(group);
+          flattenedNodes.groups.push_back(group);
+          group->visitChildren(thisLambda);
+        },
+        [&](auto&& thisLambda, EntityNode* entity) {
+          flattenedNodes.nodes.push_back(entity);
+          flattenedNodes.entities.push_back(entity);
+          entity->visitChildren(thisLambda);
+        },
+        [&](BrushNode* brush) {
+          flattenedNodes.nodes.push_back(brush);
+          flattenedNodes.brushes.push_back(brush);
+        },
+        [&](PatchNode* patch) {
+          flattenedNodes.nodes.push_back(patch);
+          flattenedNodes.patches.push_back(patch);
+        }));
+
+    m_flattenedNodes = std::move(flattenedNodes);
+  }
+  return *m_flattenedNodes;
+}
+
 const EntityNodeIndex& WorldNode::entityNodeIndex() const
 {
   return *m_entityNodeIndex;
 }
 
+const TextureNodeIndex& WorldNode::textureNodeIndex() const
+{
+  return *m_textureNodeIndex;
+}
+
 std::vector<const Validator*> WorldNode::registeredValidators() const
 {
   return m_validatorRegistry->registeredValidators();
@@ -220,11 +293,11 @@ void WorldNode::enableNodeTreeUpdates()
 
 void WorldNode::rebuildNodeTree()
 {
-  auto nodes = std::vector<Model::Node*>{};
+  auto entries = std::vector<std::pair<vm::bbox3, Model::Node*>>{};
   const auto addNode = [&](auto* node) {
     if (node->shouldAddToSpacialIndex())
     {
-      nodes.push_back(node);
+      entries.emplace_back(node->physicalBounds(), node);
     }
   };
 
@@ -248,11 +321,7 @@ void WorldNode::rebuildNodeTree()
     [&](BrushNode* brush) { addNode(brush); },
     [&](PatchNode* patch) { addNode(patch); }));
 
-  m_nodeTree->clear();
-  for (auto* node : nodes)
-  {
-    m_nodeTree->insert(node->physicalBounds(), node);
-  }
+  m_nodeTree->build(std::move(entries));
 }
 
 void WorldNode::invalidateAllIssues()
@@ -350,6 +419,8 @@ bool WorldNode::doShouldAddToSpacialIndex() const
 
 void WorldNode::doDescendantWasAdded(Node* node, const size_t /* depth */)
 {
+  m_flattenedNodes = std::nullopt;
+
   // NOTE: `node` is just the root of a subtree that is being connected to this World.
   // In some cases, (e.g. if `node` is a Group), `node` will not be added to the spatial
   // index, but some of its descendants may be. We need to recursively search the `node`
@@ -402,6 +473,8 @@ void WorldNode::doDescendantWasAdded(Node* node, const size_t /* depth */)
 
 void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
 {
+  m_flattenedNodes = std::nullopt;
+
   if (m_updateNodeTree)
   {
     const auto doRemove = [&](auto* nodeToRemove) {
@@ -427,6 +500,12 @@ void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
   }
 }
 
+void WorldNode::doDescendantWasRemoved(
+  Node* /* oldParent */, Node* /* node */, const size_t /* depth */)
+{
+  m_flattenedNodes = std::nullopt;
+}
+
 void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node)
 {
   if (m_updateNodeTree)
@@ -446,6 +525,14 @@ bool WorldNode::doSelectable() const
   return false;
 }
 
+std::uint64_t WorldNode::doGetContentHash() const
+{
+  auto hasher = ContentHasher{};
+  hasher.add(static_cast<int>(m_mapFormat));
+  addEntityToHash(hasher);
+  return hasher.hash();
+}
+
 void WorldNode::doPick(
   const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult)
 {
@@ -510,6 +597,23 @@ void WorldNode::doRemoveFromIndex(
   m_entityNodeIndex->removeProperty(node, key, value);
 }
 
+void WorldNode::doUpdateValueInIndex(
+  EntityNodeBase* node, const std::string& oldValue, const std::string& newValue)
+{
+  m_entityNodeIndex->updatePropertyValue(node, oldValue, newValue);
+}
+
+void WorldNode::doAddTextureToIndex(BrushNode* node, const Assets::Texture* texture)
+{
+  m_textureNodeIndex->addTexture(node, texture);
+}
+
+void WorldNode::doRemoveTextureFromIndex(
+  BrushNode* node, const Assets::Texture* texture)
+{
+  m_textureNodeIndex->removeTexture(node, texture);
+}
+
 void WorldNode::doPropertiesDidChange(const vm::bbox3& /* oldBounds */) {}
 
 vm::vec3 WorldNode::doGetLinkSourceAnchor() const
@@ -30,6 +30,7 @@
 #include "kdl/result_forward.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -40,20 +41,40 @@ class octree;
 
 namespace Model
 {
+class BrushNode;
+class EntityNode;
 class EntityNodeIndex;
+class GroupNode;
 class IssueQuickFix;
 enum class MapFormat;
+class PatchNode;
 class PickResult;
+class TextureNodeIndex;
 class Validator;
 class ValidatorRegistry;
 
 class WorldNode : public EntityNodeBase
 {
 private:
+  /**
+   * The descendants of a world in pre-order, and the descendants of each type in the
+   * same order.
+   */
+  struct FlattenedNodes
+  {
+    std::vector<Node*> nodes;
+    std::vector<GroupNode*> groups;
+    std::vector<EntityNode*> entities;
+    std::vector<BrushNode*> brushes;
+    std::vector<PatchNode*> patches;
+  };
+
+
   EntityPropertyConfig m_entityPropertyConfig;
   MapFormat m_mapFormat;
   LayerNode* m_defaultLayer;
   std::unique_ptr<EntityNodeIndex> m_entityNodeIndex;
+  std::unique_ptr<TextureNodeIndex> m_textureNodeIndex;
   std::unique_ptr<ValidatorRegistry> m_validatorRegistry;
 
   using NodeTree = octree<FloatType, Node*>;
@@ -62,6 +83,8 @@ private:
 
   IdType m_nextPersistentId = 1;
 
+  mutable std::optional<FlattenedNodes> m_flattenedNodes;
+
 public:
   WorldNode(
     EntityPropertyConfig entityPropertyConfig, Entity entity, MapFormat mapFormat);
@@ -128,8 +151,44 @@ public: // layer management
 private:
   void createDefaultLayer();
 
+public: // flattened node lists
+  /**
+   * Returns all descendants of this world in pre-order, i.e., in the order in which a
+   * recursive visitor would visit them. This world itself is not included.
+   *
+   * The flattened node lists are cached and rebuilt on demand after nodes were added to
+   * or removed from this world. The returned references are invalidated by such changes.
+   * Since the first call after such a change rebuilds the lists, these functions must
+   * not be called concurrently, but the returned lists can be processed in parallel.
+   */
+  const std::vector<Node*>& allDescendants() const;
+
+  /**
+   * Returns all group nodes of this world in pre-order.
+   */
+  const std::vector<GroupNode*>& allGroups() const;
+
+  /**
+   * Returns all entity nodes of this world in pre-order.
+   */
+  const std::vector<EntityNode*>& allEntities() const;
+
+  /**
+   * Returns all brush nodes of this world in pre-order.
+   */
+  const std::vector<BrushNode*>& allBrushes() const;
+
+  /**
+   * Returns all patch nodes of this world in pre-order.
+   */
+  const std::vector<PatchNode*>& allPatches() const;
+
+private:
+  const FlattenedNodes& flattenedNodes() const;
+
 public: // index
   const EntityNodeIndex& entityNodeIndex() const;
+  const TextureNodeIndex& textureNodeIndex() const;
 
 public: // validator registration
   std::vector<const Validator*> registeredValidators() const;
@@ -159,9 +218,12 @@ private: // implement Node interface
 
   void doDescendantWasAdded(Node* node, size_t depth) override;
   void doDescendantWillBeRemoved(Node* node, size_t depth) override;
+  void doDescendantWasRemoved(Node* oldParent, Node* node, size_t depth) override;
   void doDescendantPhysicalBoundsDidChange(Node* node) override;
 
   bool doSelectable() const override;
+
+  std::uint64_t doGetContentHash() const override;
   void doPick(
     const EditorContext& editorContext,
     const vm::ray3& ray,
@@ -182,6 +244,13 @@ private: // implement Node interface
     EntityNodeBase* node, const std::string& key, const std::string& value) override;
   void doRemoveFromIndex(
     EntityNodeBase* node, const std::string& key, const std::string& value) override;
+  void doUpdateValueInIndex(
+    EntityNodeBase* node,
+    const std::string& oldValue,
+    const std::string& newValue) override;
+  void doAddTextureToIndex(BrushNode* node, const Assets::Texture* texture) override;
+  void doRemoveTextureFromIndex(
+    BrushNode* node, const Assets::Texture* texture) override;
 
 private: // implement EntityNodeBase interface
   void doPropertiesDidChange(const vm::bbox3& oldBounds) override;
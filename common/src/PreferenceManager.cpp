@@ -37,6 +37,7 @@
 #include "IO/PathQt.h"
 #include "IO/SystemPaths.h"
 #include "Preferences.h"
+#include "StartupTimeline.h"
 #include "View/Actions.h"
 
 #include <string>
@@ -95,6 +96,8 @@ AppPreferenceManager::~AppPreferenceManager()
 
 void AppPreferenceManager::initialize()
 {
+  const auto phase = StartupTimeline::instance().phase("Load preferences");
+
   m_preferencesFilePath = preferenceFilePath();
 
   loadCacheFromDisk();
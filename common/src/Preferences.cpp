@@ -60,6 +60,14 @@ Preference<Color> PortalFileBorderColor(
 Preference<Color> PortalFileFillColor(
   "Renderer/Colors/Portal file fill", Color(1.0f, 0.4f, 0.4f, 0.2f));
 Preference<bool> ShowFPS("Renderer/Show FPS", false);
+Preference<bool> ProfileRenderPasses("Renderer/Profile render passes", false);
+Preference<bool> OcclusionCulling("Renderer/Occlusion culling", false);
+Preference<bool> SortRenderables("Renderer/Sort renderables", false);
+Preference<bool> ProgressiveBrushValidation(
+  "Renderer/Progressive brush validation", false);
+Preference<bool> SimplifyTinyBrushes2D(
+  "Renderer/Simplify tiny brushes in 2D views", true);
+Preference<bool> GpuPicking("Renderer/GPU picking", false);
 
 Preference<Color>& axisColor(vm::axis::type axis)
 {
@@ -186,11 +194,24 @@ Preference<Color> GridColor2D("Rendere/Grid/Color2D", Color(0.8f, 0.8f, 0.8f, 0.
 
 Preference<int> TextureMinFilter("Renderer/Texture mode min filter", 0x2700);
 Preference<int> TextureMagFilter("Renderer/Texture mode mag filter", 0x2600);
+Preference<bool> CompressTextures("Renderer/Compress textures", false);
+Preference<bool> LoadTexturesOnDemand("Renderer/Load textures on demand", false);
 Preference<bool> EnableMSAA("Renderer/Enable multisampling", true);
 
 Preference<bool> TextureLock("Editor/Texture lock", true);
 Preference<bool> UVLock("Editor/UV lock", false);
 
+Preference<bool> UseMapCache("Editor/Use map cache", false);
+Preference<bool> UseTextureCache("Editor/Use texture cache", false);
+Preference<bool> UseModelCache("Editor/Use model cache", false);
+Preference<bool> UseEntityDefinitionCache("Editor/Use entity definition cache", false);
+Preference<bool> UseShaderCache("Editor/Use shader cache", false);
+Preference<bool> UseFontCache("Editor/Use font cache", false);
+Preference<int> AutosaveDeltaCount("Editor/Autosave delta count", 0);
+Preference<int> UndoMemoryLimit("Editor/Undo memory limit", 0);
+Preference<int> EntityModelMemoryLimit("Editor/Entity model memory limit", 1024);
+Preference<int> StallReportThreshold("Editor/Stall report threshold", 0);
+
 Preference<std::filesystem::path>& RendererFontPath()
 {
   static Preference<std::filesystem::path> fontPath(
@@ -329,6 +350,12 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &PortalFileBorderColor,
     &PortalFileFillColor,
     &ShowFPS,
+    &ProfileRenderPasses,
+    &OcclusionCulling,
+    &SortRenderables,
+    &ProgressiveBrushValidation,
+    &SimplifyTinyBrushes2D,
+    &GpuPicking,
     &CompassBackgroundColor,
     &CompassBackgroundOutlineColor,
     &CompassAxisOutlineColor,
@@ -382,8 +409,20 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &GridColor2D,
     &TextureMinFilter,
     &TextureMagFilter,
+    &CompressTextures,
+    &LoadTexturesOnDemand,
     &TextureLock,
     &UVLock,
+    &UseMapCache,
+    &UseTextureCache,
+    &UseModelCache,
+    &UseEntityDefinitionCache,
+    &UseShaderCache,
+    &UseFontCache,
+    &AutosaveDeltaCount,
+    &UndoMemoryLimit,
+    &EntityModelMemoryLimit,
+    &StallReportThreshold,
     &RendererFontPath(),
     &RendererFontSize,
     &BrowserFontSize,
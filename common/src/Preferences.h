@@ -55,6 +55,33 @@ extern Preference<Color> PortalFileBorderColor;
 extern Preference<Color> PortalFileFillColor;
 extern Preference<bool> ShowFPS;
 
+/**
+ * Measures the GPU time of each render pass with timer queries and shows the averages in
+ * the FPS overlay. Requires ShowFPS to be displayed.
+ */
+extern Preference<bool> ProfileRenderPasses;
+extern Preference<bool> OcclusionCulling;
+
+/**
+ * Reorders the opaque renderables of each frame by shader, texture and render state to
+ * reduce the number of state changes.
+ */
+extern Preference<bool> SortRenderables;
+
+/**
+ * Limits the number of brushes whose render data are built per frame, so that the UI
+ * stays responsive after large changes such as loading a map or showing many hidden
+ * brushes. The remaining brushes appear over the following frames.
+ */
+extern Preference<bool> ProgressiveBrushValidation;
+extern Preference<bool> SimplifyTinyBrushes2D;
+
+/**
+ * Picks the brush under the mouse pointer in the 3D view by reading back an ID buffer
+ * instead of intersecting the pick ray with the brushes. Requires OpenGL 3.0.
+ */
+extern Preference<bool> GpuPicking;
+
 Preference<Color>& axisColor(vm::axis::type axis);
 
 extern Preference<Color> CompassBackgroundColor;
@@ -127,11 +154,25 @@ extern Preference<Color> GridColor2D;
 
 extern Preference<int> TextureMinFilter;
 extern Preference<int> TextureMagFilter;
+extern Preference<bool> CompressTextures;
+extern Preference<bool> LoadTexturesOnDemand;
 extern Preference<bool> EnableMSAA;
 
 extern Preference<bool> TextureLock;
 extern Preference<bool> UVLock;
 
+extern Preference<bool> UseMapCache;
+extern Preference<bool> UseTextureCache;
+extern Preference<bool> UseModelCache;
+extern Preference<bool> UseEntityDefinitionCache;
+extern Preference<bool> UseShaderCache;
+extern Preference<bool> UseFontCache;
+extern Preference<int> AutosaveDeltaCount;
+extern Preference<int> UndoMemoryLimit;
+extern Preference<int> EntityModelMemoryLimit;
+// in milliseconds, 0 disables the stall reports
+extern Preference<int> StallReportThreshold;
+
 Preference<std::filesystem::path>& RendererFontPath();
 extern Preference<int> RendererFontSize;
 
@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+namespace TrenchBroom
+{
+namespace
+{
+
+/**
+ * The zones recorded by one thread. Only the owning thread records zones, but the buffer
+ * is locked because the zones can be collected or cleared by any thread.
+ */
+class ThreadBuffer
+{
+private:
+  size_t m_threadIndex;
+  mutable std::mutex m_mutex;
+  std::vector<Profiler::Zone> m_zones;
+  // the total number of zones recorded since the buffer was last cleared
+  size_t m_count = 0;
+
+public:
+  explicit ThreadBuffer(const size_t threadIndex)
+    : m_threadIndex{threadIndex}
+  {
+  }
+
+  void record(
+    const char* name,
+    const Profiler::Clock::time_point start,
+    const Profiler::Clock::time_point end)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (m_zones.empty())
+    {
+      m_zones.resize(Profiler::BufferCapacity);
+    }
+    m_zones[m_count % Profiler::BufferCapacity] =
+      Profiler::Zone{name, m_threadIndex, start, end};
+    ++m_count;
+  }
+
+  void appendZones(std::vector<Profiler::Zone>& zones) const
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    const auto count = std::min(m_count, Profiler::BufferCapacity);
+    for (size_t i = m_count - count; i < m_count; ++i)
+    {
+      zones.push_back(m_zones[i % Profiler::BufferCapacity]);
+    }
+  }
+
+  void clear()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_count = 0;
+  }
+};
+
+std::mutex threadBuffersMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+
+ThreadBuffer& threadBuffer()
+{
+  // the buffers are kept after their threads have exited so that their zones can still
+  // be exported
+  thread_local const auto buffer = []() {
+    const auto lock = std::lock_guard{threadBuffersMutex};
+    const auto threadIndex = threadBuffers.size();
+    return threadBuffers.emplace_back(std::make_shared<ThreadBuffer>(threadIndex));
+  }();
+  return *buffer;
+}
+
+const auto origin = Profiler::Clock::now();
+
+double toUs(const Profiler::Clock::duration duration)
+{
+  return std::chrono::duration<double, std::micro>{duration}.count();
+}
+
+} // namespace
+
+std::atomic<bool> Profiler::m_enabled{false};
+
+void Profiler::setEnabled(const bool enabled)
+{
+  m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::vector<Profiler::Zone> Profiler::zones()
+{
+  auto result = std::vector<Zone>{};
+  {
+    const auto lock = std::lock_guard{threadBuffersMutex};
+    for (const auto& buffer : threadBuffers)
+    {
+      buffer->appendZones(result);
+    }
+  }
+
+  std::stable_sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.start < rhs.start;
+  });
+  return result;
+}
+
+void Profiler::clear()
+{
+  const auto lock = std::lock_guard{threadBuffersMutex};
+  for (const auto& buffer : threadBuffers)
+  {
+    buffer->clear();
+  }
+}
+
+std::string Profiler::chromeTrace()
+{
+  auto events = QJsonArray{};
+  events.append(QJsonObject{
+    {"name", "process_name"},
+    {"ph", "M"},
+    {"pid", 1},
+    {"args", QJsonObject{{"name", "TrenchBroom"}}},
+  });
+
+  for (const auto& zone : zones())
+  {
+    events.append(QJsonObject{
+      {"name", zone.name},
+      {"cat", "TrenchBroom"},
+      {"ph", "X"},
+      {"ts", toUs(zone.start - origin)},
+      {"dur", toUs(zone.end - zone.start)},
+      {"pid", 1},
+      {"tid", static_cast<int>(zone.threadIndex)},
+    });
+  }
+
+  const auto document = QJsonDocument{QJsonObject{
+    {"traceEvents", events},
+    {"displayTimeUnit", "ms"},
+  }};
+  return document.toJson(QJsonDocument::Compact).toStdString();
+}
+
+void Profiler::record(
+  const char* name, const Clock::time_point start, const Clock::time_point end)
+{
+  threadBuffer().record(name, start, end);
+}
+
+} // namespace TrenchBroom
@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+
+/**
+ * Collects the zones recorded by ProfilerZone instances placed in hot code paths.
+ *
+ * Every thread records its zones into its own ring buffer, which keeps the most recent
+ * BufferCapacity zones. The recorded zones can be exported in the Chrome trace event
+ * format, which can be viewed in chrome://tracing or Perfetto and imported into Tracy.
+ *
+ * The profiler is disabled by default. While it is disabled, a zone only costs a relaxed
+ * atomic load.
+ */
+class Profiler
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t BufferCapacity = 1u << 16;
+
+  struct Zone
+  {
+    // must have static storage duration
+    const char* name;
+    // the index of the thread in the order in which the threads first recorded a zone
+    size_t threadIndex;
+    Clock::time_point start;
+    Clock::time_point end;
+  };
+
+private:
+  static std::atomic<bool> m_enabled;
+
+public:
+  static bool enabled() { return m_enabled.load(std::memory_order_relaxed); }
+  static void setEnabled(bool enabled);
+
+  /**
+   * Returns the zones recorded by all threads, ordered by their start time.
+   */
+  static std::vector<Zone> zones();
+
+  /**
+   * Discards the zones recorded by all threads.
+   */
+  static void clear();
+
+  /**
+   * Returns the recorded zones as a JSON document in the Chrome trace event format.
+   */
+  static std::string chromeTrace();
+
+private:
+  friend class ProfilerZone;
+  static void record(const char* name, Clock::time_point start, Clock::time_point end);
+};
+
+/**
+ * Records the time from its creation to its destruction as a zone with the given name if
+ * the profiler is enabled. The name must have static storage duration, e.g. a string
+ * literal.
+ */
+class ProfilerZone
+{
+private:
+  const char* m_name;
+  Profiler::Clock::time_point m_start;
+
+public:
+  explicit ProfilerZone(const char* name)
+    : m_name{Profiler::enabled() ? name : nullptr}
+    , m_start{m_name ? Profiler::Clock::now() : Profiler::Clock::time_point{}}
+  {
+  }
+
+  ~ProfilerZone()
+  {
+    if (m_name)
+    {
+      Profiler::record(m_name, m_start, Profiler::Clock::now());
+    }
+  }
+
+  deleteCopyAndMove(ProfilerZone);
+};
+
+} // namespace TrenchBroom
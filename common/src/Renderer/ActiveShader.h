@@ -40,11 +40,19 @@ public:
   ActiveShader(ShaderManager& shaderManager, const ShaderConfig& shaderConfig);
   ~ActiveShader();
 
+  UniformHandle uniform(const std::string& name) const { return m_program.uniform(name); }
+
   template <class T>
   void set(const std::string& name, const T& value)
   {
     m_program.set(name, value);
   }
+
+  template <class T>
+  void set(const UniformHandle uniform, const T& value)
+  {
+    m_program.set(uniform, value);
+  }
 };
 } // namespace Renderer
 } // namespace TrenchBroom
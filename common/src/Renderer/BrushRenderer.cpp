@@ -27,12 +27,28 @@
 #include "Model/TagAttribute.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/BrushVertexStore.h"
+#include "Renderer/Camera.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderService.h"
 
+#include "kdl/parallel.h"
+
+#include "vm/bbox.h"
+#include "vm/plane.h"
+
+#include <algorithm>
 #include <cassert>
-#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <vector>
 
 namespace TrenchBroom
@@ -143,6 +159,8 @@ BrushRenderer::Filter::RenderSettings BrushRenderer::NoFilter::markFaces(
 
 BrushRenderer::BrushRenderer()
   : m_filter{std::make_unique<NoFilter>()}
+  , m_brushTree{256.0}
+  , m_cullToFrustum{false}
   , m_showEdges{false}
   , m_grayscale{false}
   , m_tint{false}
@@ -156,6 +174,7 @@ BrushRenderer::BrushRenderer()
 
 void BrushRenderer::invalidate()
 {
+  m_brushTree.clear();
   for (auto* brushNode : m_allBrushes)
   {
     // this will also invalidate already invalid brushes, which
@@ -192,19 +211,42 @@ bool BrushRenderer::valid() const
 
 void BrushRenderer::clear()
 {
+  if (m_vertexStore)
+  {
+    for (const auto& [brushNode, info] : m_brushInfo)
+    {
+      m_vertexStore->release(*brushNode, info.vertexHolderKey);
+    }
+    if (m_vertexStore->empty())
+    {
+      m_vertexStore->clear();
+    }
+  }
+  else
+  {
+    m_vertexStore = std::make_shared<BrushVertexStore>();
+  }
+
   m_brushInfo.clear();
   m_allBrushes.clear();
   m_invalidBrushes.clear();
+  m_brushTree.clear();
 
-  m_vertexArray = std::make_shared<BrushVertexArray>();
   m_edgeIndices = std::make_shared<BrushIndexArray>();
   m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
   m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
 
-  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
-  m_transparentFaceRenderer =
-    FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
-  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+  const auto& vertexArray = m_vertexStore->vertexArray();
+  m_opaqueFaceRenderer = FaceRenderer{vertexArray, m_opaqueFaces, m_faceColor};
+  m_transparentFaceRenderer = FaceRenderer{vertexArray, m_transparentFaces, m_faceColor};
+  m_edgeRenderer = IndexedEdgeRenderer{vertexArray, m_edgeIndices};
+}
+
+void BrushRenderer::setVertexStore(std::shared_ptr<BrushVertexStore> vertexStore)
+{
+  clear();
+  m_vertexStore = std::move(vertexStore);
+  clear();
 }
 
 void BrushRenderer::setFaceColor(const Color& faceColor)
@@ -274,6 +316,28 @@ void BrushRenderer::setShowHiddenBrushes(const bool showHiddenBrushes)
   }
 }
 
+void BrushRenderer::setCullToFrustum(const bool cullToFrustum)
+{
+  if (cullToFrustum != m_cullToFrustum)
+  {
+    m_cullToFrustum = cullToFrustum;
+    if (m_cullToFrustum)
+    {
+      auto entries = std::vector<std::pair<vm::bbox3, const Model::BrushNode*>>{};
+      entries.reserve(m_brushInfo.size());
+      for (const auto& [brushNode, info] : m_brushInfo)
+      {
+        entries.emplace_back(brushNode->logicalBounds(), brushNode);
+      }
+      m_brushTree.build(std::move(entries));
+    }
+    else
+    {
+      m_brushTree.clear();
+    }
+  }
+}
+
 void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   renderOpaque(renderContext, renderBatch);
@@ -286,16 +350,46 @@ void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& rend
   {
     if (!valid())
     {
-      validate();
+      validate(renderContext.maxValidatedBrushes().value_or(
+        std::numeric_limits<size_t>::max()));
+      renderContext.statistics().pendingBrushes += m_invalidBrushes.size();
     }
+
+    auto visibleBrushes = findVisibleBrushes(renderContext);
+    if (visibleBrushes)
+    {
+      const auto frustumVisibleBrushes = visibleBrushes->size();
+      const auto occludedBrushes = cullOccludedBrushes(renderContext, *visibleBrushes);
+      const auto simplifiedBounds = simplifyTinyBrushes(renderContext, *visibleBrushes);
+      const auto simplifiedBrushes =
+        frustumVisibleBrushes - occludedBrushes - visibleBrushes->size();
+
+      auto& statistics = renderContext.statistics();
+      statistics.visibleBrushes += visibleBrushes->size();
+      statistics.culledBrushes += m_brushInfo.size() - frustumVisibleBrushes;
+      statistics.occludedBrushes += occludedBrushes;
+      statistics.simplifiedBrushes += simplifiedBrushes;
+
+      renderSimplifiedBrushes(renderContext, renderBatch, simplifiedBounds);
+    }
+
     if (renderContext.showFaces())
     {
+      m_opaqueFaceRenderer.setIndexRanges(findFaceIndexRanges(visibleBrushes, false));
       renderOpaqueFaces(renderBatch);
     }
     if (renderContext.showEdges() || m_showEdges)
     {
+      m_edgeRenderer.setIndexRanges(findEdgeIndexRanges(visibleBrushes));
       renderEdges(renderBatch);
     }
+    if (visibleBrushes)
+    {
+      if (auto* occlusionCuller = renderContext.occlusionCuller())
+      {
+        occlusionCuller->queryVisibility(this, renderBatch);
+      }
+    }
   }
 }
 
@@ -304,17 +398,238 @@ void BrushRenderer::renderTransparent(
 {
   if (!m_allBrushes.empty())
   {
-    if (!valid())
+    // if the number of brushes validated per frame is limited, the opaque pass has
+    // already validated as many brushes as allowed
+    if (!valid() && !renderContext.maxValidatedBrushes())
     {
       validate();
     }
     if (renderContext.showFaces())
     {
+      auto visibleBrushes = findVisibleBrushes(renderContext);
+      if (visibleBrushes)
+      {
+        cullOccludedBrushes(renderContext, *visibleBrushes);
+        simplifyTinyBrushes(renderContext, *visibleBrushes);
+      }
+      m_transparentFaceRenderer.setIndexRanges(findFaceIndexRanges(visibleBrushes, true));
       renderTransparentFaces(renderBatch);
     }
   }
 }
 
+std::optional<std::vector<const Model::BrushNode*>> BrushRenderer::findVisibleBrushes(
+  const RenderContext& renderContext) const
+{
+  if (!m_cullToFrustum)
+  {
+    return std::nullopt;
+  }
+
+  vm::plane3f frustumPlanes[4];
+  renderContext.camera().frustumPlanes(
+    frustumPlanes[0], frustumPlanes[1], frustumPlanes[2], frustumPlanes[3]);
+
+  const auto isVisible = [&](const vm::bbox3& bounds) {
+    return intersectsFrustum(vm::bbox3f{bounds}, frustumPlanes);
+  };
+
+  auto visibleBrushes = std::vector<const Model::BrushNode*>{};
+  m_brushTree.find_if(isVisible, std::back_inserter(visibleBrushes));
+
+  // the tree only culls whole nodes, so test the bounds of the brushes, too
+  visibleBrushes.erase(
+    std::remove_if(
+      visibleBrushes.begin(),
+      visibleBrushes.end(),
+      [&](const auto* brushNode) { return !isVisible(brushNode->logicalBounds()); }),
+    visibleBrushes.end());
+
+  return visibleBrushes;
+}
+
+size_t BrushRenderer::cullOccludedBrushes(
+  const RenderContext& renderContext,
+  std::vector<const Model::BrushNode*>& visibleBrushes) const
+{
+  if (auto* occlusionCuller = renderContext.occlusionCuller())
+  {
+    return occlusionCuller->cull(this, renderContext.camera(), visibleBrushes);
+  }
+  return 0;
+}
+
+namespace
+{
+/**
+ * Brushes that cover fewer pixels than this in a 2D view are simplified.
+ */
+constexpr float TinyBrushPixels = 3.0f;
+
+/**
+ * The minimum size in pixels of the cells in which simplified brushes are aggregated.
+ */
+constexpr float SimplifiedCellPixels = 8.0f;
+} // namespace
+
+std::vector<vm::bbox3f> BrushRenderer::simplifyTinyBrushes(
+  const RenderContext& renderContext,
+  std::vector<const Model::BrushNode*>& visibleBrushes) const
+{
+  if (!renderContext.render2D() || !renderContext.simplifyTinyBrushes())
+  {
+    return {};
+  }
+
+  const auto& camera = renderContext.camera();
+  const auto zoom = camera.zoom();
+  const auto viewAxis = vm::find_abs_max_component(camera.direction());
+  const auto axis1 = (viewAxis + 1) % 3;
+  const auto axis2 = (viewAxis + 2) % 3;
+
+  // snap the cell size to a power of two so that the cells don't move while zooming
+  const auto cellSize = std::exp2(std::ceil(std::log2(SimplifiedCellPixels / zoom)));
+
+  auto cells = std::map<std::pair<int, int>, vm::bbox3f>{};
+  const auto isTiny = [&](const auto* brushNode) {
+    const auto bounds = vm::bbox3f{brushNode->logicalBounds()};
+    const auto size = bounds.size();
+    if (std::max(size[axis1], size[axis2]) * zoom >= TinyBrushPixels)
+    {
+      return false;
+    }
+
+    const auto center = bounds.center();
+    const auto cell = std::pair{
+      int(std::floor(center[axis1] / cellSize)),
+      int(std::floor(center[axis2] / cellSize))};
+    const auto [it, inserted] = cells.emplace(cell, bounds);
+    if (!inserted)
+    {
+      it->second = vm::merge(it->second, bounds);
+    }
+    return true;
+  };
+
+  visibleBrushes.erase(
+    std::remove_if(visibleBrushes.begin(), visibleBrushes.end(), isTiny),
+    visibleBrushes.end());
+
+  auto result = std::vector<vm::bbox3f>{};
+  result.reserve(cells.size());
+  for (const auto& [cell, bounds] : cells)
+  {
+    result.push_back(bounds);
+  }
+  return result;
+}
+
+void BrushRenderer::renderSimplifiedBrushes(
+  RenderContext& renderContext,
+  RenderBatch& renderBatch,
+  const std::vector<vm::bbox3f>& simplifiedBounds) const
+{
+  if (simplifiedBounds.empty())
+  {
+    return;
+  }
+
+  auto renderService = RenderService{renderContext, renderBatch};
+  if (renderContext.showEdges() || m_showEdges)
+  {
+    renderService.setForegroundColor(m_edgeColor);
+    for (const auto& bounds : simplifiedBounds)
+    {
+      renderService.renderBounds(bounds);
+    }
+  }
+  else if (renderContext.showFaces())
+  {
+    // fill the side of the bounds that faces the camera
+    const auto viewAxis = vm::find_abs_max_component(renderContext.camera().direction());
+    const auto axis1 = (viewAxis + 1) % 3;
+    const auto axis2 = (viewAxis + 2) % 3;
+
+    renderService.setForegroundColor(m_faceColor);
+    for (const auto& bounds : simplifiedBounds)
+    {
+      auto corner = bounds.min;
+      auto positions = std::vector<vm::vec3f>{};
+      positions.push_back(corner);
+      corner[axis1] = bounds.max[axis1];
+      positions.push_back(corner);
+      corner[axis2] = bounds.max[axis2];
+      positions.push_back(corner);
+      corner[axis1] = bounds.min[axis1];
+      positions.push_back(corner);
+      renderService.renderFilledPolygon(positions);
+    }
+  }
+}
+
+/**
+ * Rendering many small index ranges instead of whole index arrays only pays off if a
+ * large part of the brushes is culled.
+ */
+static bool shouldRenderIndexRanges(
+  const std::optional<std::vector<const Model::BrushNode*>>& visibleBrushes,
+  const size_t brushCount)
+{
+  return visibleBrushes && visibleBrushes->size() <= brushCount / 2;
+}
+
+std::shared_ptr<BrushRenderer::TextureToBrushIndexRangesMap> BrushRenderer::
+  findFaceIndexRanges(
+    const std::optional<std::vector<const Model::BrushNode*>>& visibleBrushes,
+    const bool transparent) const
+{
+  if (!shouldRenderIndexRanges(visibleBrushes, m_brushInfo.size()))
+  {
+    return nullptr;
+  }
+
+  auto result = std::unordered_map<const Assets::Texture*, BrushIndexRanges>{};
+  for (const auto* brushNode : *visibleBrushes)
+  {
+    const auto& info = m_brushInfo.at(brushNode);
+    const auto& keys =
+      transparent ? info.transparentFaceIndicesKeys : info.opaqueFaceIndicesKeys;
+    for (const auto& [texture, key] : keys)
+    {
+      result[texture].add(key->pos, key->size);
+    }
+  }
+
+  for (auto& [texture, indexRanges] : result)
+  {
+    indexRanges.compact();
+  }
+
+  return std::make_shared<TextureToBrushIndexRangesMap>(std::move(result));
+}
+
+std::shared_ptr<const BrushIndexRanges> BrushRenderer::findEdgeIndexRanges(
+  const std::optional<std::vector<const Model::BrushNode*>>& visibleBrushes) const
+{
+  if (!shouldRenderIndexRanges(visibleBrushes, m_brushInfo.size()))
+  {
+    return nullptr;
+  }
+
+  auto result = BrushIndexRanges{};
+  for (const auto* brushNode : *visibleBrushes)
+  {
+    const auto& info = m_brushInfo.at(brushNode);
+    if (info.edgeIndicesKey != nullptr)
+    {
+      result.add(info.edgeIndicesKey->pos, info.edgeIndicesKey->size);
+    }
+  }
+  result.compact();
+
+  return std::make_shared<const BrushIndexRanges>(std::move(result));
+}
+
 void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch)
 {
   m_opaqueFaceRenderer.setGrayscale(m_grayscale);
@@ -332,6 +647,22 @@ void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch)
   m_transparentFaceRenderer.render(renderBatch);
 }
 
+void BrushRenderer::renderPickIds(RenderBatch& renderBatch)
+{
+  if (m_allBrushes.empty())
+  {
+    return;
+  }
+
+  // the face renderers still hold the index ranges that were rendered in this frame
+  for (const auto* faceRenderer : {&m_opaqueFaceRenderer, &m_transparentFaceRenderer})
+  {
+    auto pickIdRenderer = std::make_unique<FaceRenderer>(*faceRenderer);
+    pickIdRenderer->setRenderPickIds(true);
+    renderBatch.addOneShot(pickIdRenderer.release());
+  }
+}
+
 void BrushRenderer::renderEdges(RenderBatch& renderBatch)
 {
   if (m_showOccludedEdges)
@@ -373,21 +704,111 @@ public:
   }
 };
 
-void BrushRenderer::validate()
+namespace
+{
+/**
+ * The size of the cubic chunks by which brushes are ordered before they are added to the
+ * VBO.
+ */
+constexpr FloatType ChunkSize = 256.0;
+
+uint64_t spreadBits(uint64_t x)
+{
+  x &= 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffff;
+  x = (x | x << 16) & 0x1f0000ff0000ff;
+  x = (x | x << 8) & 0x100f00f00f00f00f;
+  x = (x | x << 4) & 0x10c30c30c30c30c3;
+  x = (x | x << 2) & 0x1249249249249249;
+  return x;
+}
+
+/**
+ * Returns the Morton code of the chunk that contains the center of the given bounds.
+ * Sorting by this key keeps brushes that are close to each other close together.
+ */
+uint64_t chunkKey(const vm::bbox3& bounds)
+{
+  const auto center = bounds.center();
+  auto result = uint64_t{0};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const auto cell = int64_t(std::floor(center[i] / ChunkSize)) + (int64_t{1} << 20);
+    result |= spreadBits(uint64_t(std::clamp(cell, int64_t{0}, int64_t{0x1fffff}))) << i;
+  }
+  return result;
+}
+} // namespace
+
+void BrushRenderer::validate(const size_t maxBrushes)
 {
   assert(!valid());
 
-  for (auto* brushNode : m_invalidBrushes)
+  const auto zone = ProfilerZone{"BrushRenderer::validate"};
+
+  // Evaluate the filter once per brush. Brushes that are not rendered, e.g. because they
+  // are hidden, are skipped entirely so that their vertex caches are only built once they
+  // become visible.
+  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
+  auto brushesToValidate =
+    std::vector<std::tuple<uint64_t, const Model::BrushNode*, Filter::RenderSettings>>{};
+  for (auto it = m_invalidBrushes.begin();
+       it != m_invalidBrushes.end() && brushesToValidate.size() < maxBrushes;
+       it = m_invalidBrushes.erase(it))
   {
-    validateBrush(*brushNode);
+    const auto* brushNode = *it;
+    const auto settings = wrapper.markFaces(*brushNode);
+    const auto [facePolicy, edgePolicy] = settings;
+    if (
+      facePolicy != Filter::FaceRenderPolicy::RenderNone
+      || edgePolicy != Filter::EdgeRenderPolicy::RenderNone)
+    {
+      brushesToValidate.emplace_back(
+        chunkKey(brushNode->logicalBounds()), brushNode, settings);
+    }
+  }
+
+  // Add the brushes in spatial order so that the brushes in a chunk receive adjacent
+  // vertex and index ranges when they are appended to the arrays. Then the index ranges
+  // of the visible brushes can mostly be merged into one range per chunk.
+  std::sort(
+    brushesToValidate.begin(),
+    brushesToValidate.end(),
+    [](const auto& lhs, const auto& rhs) { return std::get<0>(lhs) < std::get<0>(rhs); });
+
+  // Building the vertex caches is independent for each brush, so do it in parallel. Only
+  // the writes into the shared vertex and index arrays below must happen on this thread.
+  kdl::parallel_for(brushesToValidate.size(), [&](const size_t i) {
+    const auto& brushNode = *std::get<1>(brushesToValidate[i]);
+    brushNode.brushRendererBrushCache().validateVertexCache(brushNode);
+  });
+
+  auto validatedBrushes = std::vector<std::pair<vm::bbox3, const Model::BrushNode*>>{};
+  for (const auto& [key, brushNode, settings] : brushesToValidate)
+  {
+    validateBrush(*brushNode, settings);
+    if (m_cullToFrustum)
+    {
+      validatedBrushes.emplace_back(brushNode->logicalBounds(), brushNode);
+    }
+  }
+
+  if (m_brushTree.empty())
+  {
+    m_brushTree.build(std::move(validatedBrushes));
+  }
+  else
+  {
+    for (const auto& [bounds, brushNode] : validatedBrushes)
+    {
+      m_brushTree.insert(bounds, brushNode);
+    }
   }
-  m_invalidBrushes.clear();
-  assert(valid());
 
-  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
-  m_transparentFaceRenderer =
-    FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
-  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+  const auto& vertexArray = m_vertexStore->vertexArray();
+  m_opaqueFaceRenderer = FaceRenderer{vertexArray, m_opaqueFaces, m_faceColor};
+  m_transparentFaceRenderer = FaceRenderer{vertexArray, m_transparentFaces, m_faceColor};
+  m_edgeRenderer = IndexedEdgeRenderer{vertexArray, m_edgeIndices};
 }
 
 static size_t triIndicesCountForPolygon(const size_t vertexCount)
@@ -503,38 +924,21 @@ bool BrushRenderer::shouldDrawFaceInTransparentPass(
   return false;
 }
 
-void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
+void BrushRenderer::validateBrush(
+  const Model::BrushNode& brushNode, const Filter::RenderSettings& settings)
 {
   assert(m_allBrushes.find(&brushNode) != std::end(m_allBrushes));
   assert(m_invalidBrushes.find(&brushNode) != std::end(m_invalidBrushes));
   assert(m_brushInfo.find(&brushNode) == std::end(m_brushInfo));
 
-  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
-
-  // evaluate filter. only evaluate the filter once per brush.
-  const auto settings = wrapper.markFaces(brushNode);
   const auto [facePolicy, edgePolicy] = settings;
 
-  if (
-    facePolicy == Filter::FaceRenderPolicy::RenderNone
-    && edgePolicy == Filter::EdgeRenderPolicy::RenderNone)
-  {
-    // NOTE: this skips inserting the brush into m_brushInfo
-    return;
-  }
-
   BrushInfo& info = m_brushInfo[&brushNode];
 
   // collect vertices
   auto& brushCache = brushNode.brushRendererBrushCache();
   brushCache.validateVertexCache(brushNode);
-  const auto& cachedVertices = brushCache.cachedVertices();
-  ensure(!cachedVertices.empty(), "Brush must have cached vertices");
-
-  assert(m_vertexArray != nullptr);
-  auto [vertBlock, dest] =
-    m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-  std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
+  auto* vertBlock = m_vertexStore->acquire(brushNode);
   info.vertexHolderKey = vertBlock;
 
   const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
@@ -699,15 +1103,20 @@ void BrushRenderer::removeBrushFromVbo(const Model::BrushNode& brushNode)
 
   if (it == std::end(m_brushInfo))
   {
-    // This means BrushRenderer::validateBrush skipped rendering the brush, so it was
+    // This means BrushRenderer::validate skipped rendering the brush, so it was
     // never uploaded to the VBO's
     return;
   }
 
   const BrushInfo& info = it->second;
 
+  if (m_cullToFrustum)
+  {
+    m_brushTree.remove(&brushNode);
+  }
+
   // update Vbo's
-  m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+  m_vertexStore->release(brushNode, info.vertexHolderKey);
   if (info.edgeIndicesKey != nullptr)
   {
     m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
@@ -20,13 +20,17 @@
 #pragma once
 
 #include "Color.h"
+#include "FloatType.h"
 #include "Macros.h"
 #include "Model/BrushGeometry.h"
 #include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
+#include "octree.h"
 
+#include <limits>
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
@@ -43,6 +47,8 @@ class EditorContext;
 
 namespace Renderer
 {
+class BrushVertexStore;
+
 class BrushRenderer
 {
 public:
@@ -147,7 +153,14 @@ private:
   std::unordered_set<const Model::BrushNode*> m_allBrushes;
   std::unordered_set<const Model::BrushNode*> m_invalidBrushes;
 
-  std::shared_ptr<BrushVertexArray> m_vertexArray;
+  /**
+   * Spatial index of the brushes that are stored in the VBO. Only maintained if frustum
+   * culling is enabled.
+   */
+  octree<FloatType, const Model::BrushNode*> m_brushTree;
+  bool m_cullToFrustum;
+
+  std::shared_ptr<BrushVertexStore> m_vertexStore;
   std::shared_ptr<BrushIndexArray> m_edgeIndices;
 
   using TextureToBrushIndicesMap =
@@ -176,6 +189,8 @@ public:
   template <typename FilterT>
   explicit BrushRenderer(const FilterT& filter)
     : m_filter{std::make_unique<FilterT>(filter)}
+    , m_brushTree{256.0}
+    , m_cullToFrustum{false}
     , m_showEdges{false}
     , m_grayscale{false}
     , m_tint{false}
@@ -212,6 +227,13 @@ public:
   void invalidateBrush(const Model::BrushNode* brush);
   bool valid() const;
 
+  /**
+   * Shares the given vertex store with other renderers. Brushes rendered by several
+   * renderers sharing a store have their vertices stored only once, so moving a brush
+   * between such renderers only updates its indices. Removes all brushes.
+   */
+  void setVertexStore(std::shared_ptr<BrushVertexStore> vertexStore);
+
   /**
    * Sets the color to render untextured faces with.
    */
@@ -279,26 +301,87 @@ public:
    */
   void setShowHiddenBrushes(bool showHiddenBrushes);
 
+  /**
+   * Specifies whether or not only the brushes which intersect the camera's view frustum
+   * should be rendered. Must not be enabled for brushes that are rendered with a model
+   * matrix because the brushes are culled using their untransformed bounds.
+   */
+  void setCullToFrustum(bool cullToFrustum);
+
 public: // rendering
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
 
+  /**
+   * Renders the faces that were rendered by the last calls to renderOpaque and
+   * renderTransparent with the pick ID shader. Must be called in the same frame, after
+   * the faces have been rendered.
+   *
+   * @see FaceRenderer::setRenderPickIds
+   */
+  void renderPickIds(RenderBatch& renderBatch);
+
 private:
+  /**
+   * Returns the brushes in the VBO which intersect the view frustum of the given render
+   * context's camera, or std::nullopt if frustum culling is disabled.
+   */
+  std::optional<std::vector<const Model::BrushNode*>> findVisibleBrushes(
+    const RenderContext& renderContext) const;
+
+  /**
+   * Removes the brushes hidden behind other geometry from the given visible brushes if
+   * the given render context has an occlusion culler. Returns the number of removed
+   * brushes.
+   */
+  size_t cullOccludedBrushes(
+    const RenderContext& renderContext,
+    std::vector<const Model::BrushNode*>& visibleBrushes) const;
+
+  /**
+   * In a zoomed out 2D view, removes the brushes that cover only a few pixels from the
+   * given visible brushes and aggregates them into the cells of a screen space grid.
+   * Returns the bounds of the removed brushes in each non-empty cell.
+   */
+  std::vector<vm::bbox3f> simplifyTinyBrushes(
+    const RenderContext& renderContext,
+    std::vector<const Model::BrushNode*>& visibleBrushes) const;
+  void renderSimplifiedBrushes(
+    RenderContext& renderContext,
+    RenderBatch& renderBatch,
+    const std::vector<vm::bbox3f>& simplifiedBounds) const;
+
+  using TextureToBrushIndexRangesMap = FaceRenderer::TextureToBrushIndexRangesMap;
+
+  std::shared_ptr<TextureToBrushIndexRangesMap> findFaceIndexRanges(
+    const std::optional<std::vector<const Model::BrushNode*>>& visibleBrushes,
+    bool transparent) const;
+  std::shared_ptr<const BrushIndexRanges> findEdgeIndexRanges(
+    const std::optional<std::vector<const Model::BrushNode*>>& visibleBrushes) const;
+
   void renderOpaqueFaces(RenderBatch& renderBatch);
   void renderTransparentFaces(RenderBatch& renderBatch);
   void renderEdges(RenderBatch& renderBatch);
 
 public:
   /**
+   * Adds up to the given number of invalid brushes to the VBO. The remaining brushes stay
+   * invalid and are not rendered until a later call validates them.
+   *
    * Only exposed for benchmarking.
    */
-  void validate();
+  void validate(size_t maxBrushes = std::numeric_limits<size_t>::max());
 
 private:
   bool shouldDrawFaceInTransparentPass(
     const Model::BrushNode& brushNode, const Model::BrushFace& face) const;
-  void validateBrush(const Model::BrushNode& brushNode);
+  /**
+   * Adds the given brush to the VBO using the given render settings, which must not skip
+   * both faces and edges.
+   */
+  void validateBrush(
+    const Model::BrushNode& brushNode, const Filter::RenderSettings& settings);
 
 public:
   /**
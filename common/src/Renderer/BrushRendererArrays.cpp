@@ -19,9 +19,13 @@
 
 #include "Renderer/BrushRendererArrays.h"
 
+#include "vm/scalar.h"
+
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <iterator>
+#include <limits>
 #include <stdexcept>
 
 namespace TrenchBroom
@@ -30,20 +34,63 @@ namespace TrenchBroom
 
 namespace Renderer
 {
+// BrushIndexRanges
+
+void BrushIndexRanges::add(const size_t offset, const size_t count)
+{
+  m_ranges.push_back({offset, count});
+}
+
+void BrushIndexRanges::compact()
+{
+  if (m_ranges.empty())
+  {
+    return;
+  }
+
+  std::sort(m_ranges.begin(), m_ranges.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.offset < rhs.offset;
+  });
+
+  auto last = m_ranges.begin();
+  for (auto it = std::next(m_ranges.begin()); it != m_ranges.end(); ++it)
+  {
+    if (last->offset + last->count == it->offset)
+    {
+      last->count += it->count;
+    }
+    else
+    {
+      *(++last) = *it;
+    }
+  }
+  m_ranges.erase(std::next(last), m_ranges.end());
+}
+
+bool BrushIndexRanges::empty() const
+{
+  return m_ranges.empty();
+}
+
+const std::vector<BrushIndexRanges::Range>& BrushIndexRanges::ranges() const
+{
+  return m_ranges;
+}
 
 // DirtyRangeTracker
 
+bool DirtyRangeTracker::Range::operator==(const Range& other) const
+{
+  return pos == other.pos && size == other.size;
+}
+
 DirtyRangeTracker::DirtyRangeTracker(const size_t initial_capacity)
-  : m_dirtyPos(0)
-  , m_dirtySize(0)
-  , m_capacity(initial_capacity)
+  : m_capacity(initial_capacity)
 {
 }
 
 DirtyRangeTracker::DirtyRangeTracker()
-  : m_dirtyPos(0)
-  , m_dirtySize(0)
-  , m_capacity(0)
+  : m_capacity(0)
 {
 }
 
@@ -72,16 +119,67 @@ void DirtyRangeTracker::markDirty(const size_t pos, const size_t size)
     throw std::invalid_argument("markDirty provided range out of bounds");
   }
 
-  const size_t newPos = std::min(pos, m_dirtyPos);
-  const size_t newEnd = std::max(pos + size, m_dirtyPos + m_dirtySize);
+  if (size == 0)
+  {
+    return;
+  }
 
-  m_dirtyPos = newPos;
-  m_dirtySize = newEnd - newPos;
+  // find the first range that ends at or after pos, it is the first candidate for merging
+  auto first = std::lower_bound(
+    m_ranges.begin(), m_ranges.end(), pos, [](const auto& range, const size_t p) {
+      return range.pos + range.size < p;
+    });
+
+  // merge all ranges that overlap or touch [pos, pos + size)
+  auto newPos = pos;
+  auto newEnd = pos + size;
+  auto last = first;
+  while (last != m_ranges.end() && last->pos <= newEnd)
+  {
+    newPos = std::min(newPos, last->pos);
+    newEnd = std::max(newEnd, last->pos + last->size);
+    ++last;
+  }
+
+  if (first == last)
+  {
+    m_ranges.insert(first, Range{newPos, newEnd - newPos});
+  }
+  else
+  {
+    *first = Range{newPos, newEnd - newPos};
+    m_ranges.erase(std::next(first), last);
+  }
+
+  if (m_ranges.size() > MaxRanges)
+  {
+    // merge the two neighbouring ranges with the smallest gap between them
+    auto bestGap = std::numeric_limits<size_t>::max();
+    auto best = m_ranges.begin();
+    for (auto it = m_ranges.begin(); std::next(it) != m_ranges.end(); ++it)
+    {
+      const auto gap = std::next(it)->pos - (it->pos + it->size);
+      if (gap < bestGap)
+      {
+        bestGap = gap;
+        best = it;
+      }
+    }
+
+    const auto next = std::next(best);
+    best->size = next->pos + next->size - best->pos;
+    m_ranges.erase(next);
+  }
 }
 
 bool DirtyRangeTracker::clean() const
 {
-  return m_dirtySize == 0;
+  return m_ranges.empty();
+}
+
+const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::ranges() const
+{
+  return m_ranges;
 }
 
 // IndexHolder
@@ -111,6 +209,28 @@ void IndexHolder::render(const PrimType primType, const size_t offset, size_t co
   glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
 }
 
+void IndexHolder::render(const PrimType primType, const BrushIndexRanges& ranges) const
+{
+  auto counts = std::vector<GLsizei>{};
+  auto offsets = std::vector<const GLvoid*>{};
+  counts.reserve(ranges.ranges().size());
+  offsets.reserve(ranges.ranges().size());
+
+  for (const auto& range : ranges.ranges())
+  {
+    counts.push_back(static_cast<GLsizei>(range.count));
+    offsets.push_back(
+      reinterpret_cast<GLvoid*>(m_vbo->offset() + sizeof(Index) * range.offset));
+  }
+
+  glAssert(glMultiDrawElements(
+    toGL(primType),
+    counts.data(),
+    glType<Index>(),
+    offsets.data(),
+    static_cast<GLsizei>(counts.size())));
+}
+
 std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index>& elements)
 {
   return std::make_shared<IndexHolder>(elements);
@@ -170,6 +290,13 @@ void BrushIndexArray::render(const PrimType primType) const
   m_indexHolder.render(primType, 0, m_indexHolder.size());
 }
 
+void BrushIndexArray::render(
+  const PrimType primType, const BrushIndexRanges& ranges) const
+{
+  assert(m_indexHolder.prepared());
+  m_indexHolder.render(primType, ranges);
+}
+
 bool BrushIndexArray::prepared() const
 {
   return m_indexHolder.prepared();
@@ -193,6 +320,14 @@ void BrushIndexArray::cleanupIndices()
 
 // BrushVertexArray
 
+vm::vec<GLbyte, 4> packNormal(const vm::vec3f& normal)
+{
+  const auto pack = [](const float f) {
+    return static_cast<GLbyte>(vm::round(vm::clamp(f, -1.0f, 1.0f) * 127.0f));
+  };
+  return {pack(normal.x()), pack(normal.y()), pack(normal.z()), 0};
+}
+
 BrushVertexArray::BrushVertexArray()
   : m_vertexHolder()
   , m_allocationTracker(0)
@@ -39,12 +39,31 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
-struct DirtyRangeTracker
+/**
+ * Tracks the modified regions of a buffer as a small set of disjoint ranges, so that
+ * editing a few brushes only uploads their elements and not everything in between.
+ *
+ * At most MaxRanges ranges are kept; beyond that, the two ranges with the smallest gap
+ * are merged, trading some redundant upload for a bounded number of buffer writes.
+ */
+class DirtyRangeTracker
 {
-  size_t m_dirtyPos;
-  size_t m_dirtySize;
+public:
+  struct Range
+  {
+    size_t pos;
+    size_t size;
+
+    bool operator==(const Range& other) const;
+  };
+
+  static constexpr size_t MaxRanges = 32;
+
+private:
+  std::vector<Range> m_ranges;
   size_t m_capacity;
 
+public:
   /**
    * New trackers are initially clean.
    */
@@ -58,6 +77,11 @@ struct DirtyRangeTracker
   size_t capacity() const;
   void markDirty(size_t pos, size_t size);
   bool clean() const;
+
+  /**
+   * The dirty ranges sorted by position. Ranges neither overlap nor touch.
+   */
+  const std::vector<Range>& ranges() const;
 };
 
 /**
@@ -66,8 +90,7 @@ struct DirtyRangeTracker
  * Non-copyable; meant to be held in a std::shared_ptr.
  * Able to be resized, and handles copying edits made in the local std::vector to the VBO.
  *
- * Currently uses a single range to track the modified region which might upload much more
- * than necessary; it might be worth mapping the VBO and editing it directly.
+ * Modified regions are tracked as a bounded set of ranges, see DirtyRangeTracker.
  */
 template <typename T>
 class VboHolder
@@ -208,13 +231,10 @@ public:
 
     // otherwise, it's an incremental update of the dirty ranges.
 
-    if (!m_dirtyRange.clean())
+    for (const auto& range : m_dirtyRange.ranges())
     {
-      const size_t pos = m_dirtyRange.m_dirtyPos;
-      const size_t size = m_dirtyRange.m_dirtySize;
-
-      const size_t bytesFromStart = pos * sizeof(T);
-      m_vbo->writeArray(bytesFromStart, m_snapshot.data() + pos, size);
+      const size_t bytesFromStart = range.pos * sizeof(T);
+      m_vbo->writeArray(bytesFromStart, m_snapshot.data() + range.pos, range.size);
     }
 
     m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
@@ -230,6 +250,34 @@ public:
   void unbindBlock() { m_vbo->unbind(); }
 };
 
+/**
+ * A set of ranges of elements in an index array. Used to render only parts of an index
+ * array, e.g. the indices of brushes which are visible.
+ */
+class BrushIndexRanges
+{
+public:
+  struct Range
+  {
+    size_t offset;
+    size_t count;
+  };
+
+private:
+  std::vector<Range> m_ranges;
+
+public:
+  void add(size_t offset, size_t count);
+
+  /**
+   * Sorts the ranges by their offsets and merges adjacent ranges.
+   */
+  void compact();
+
+  bool empty() const;
+  const std::vector<Range>& ranges() const;
+};
+
 class IndexHolder : public VboHolder<GLuint>
 {
 public:
@@ -242,6 +290,7 @@ public:
   explicit IndexHolder(std::vector<Index>& elements);
   void zeroRange(size_t offsetWithinBlock, size_t count);
   void render(PrimType primType, size_t offset, size_t count) const;
+  void render(PrimType primType, const BrushIndexRanges& ranges) const;
 
   static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
 };
@@ -284,6 +333,12 @@ public:
   void zeroElementsWithKey(AllocationTracker::Block* key);
 
   void render(const PrimType primType) const;
+
+  /**
+   * Renders only the given ranges of this array.
+   */
+  void render(const PrimType primType, const BrushIndexRanges& ranges) const;
+
   bool prepared() const;
   void prepare(VboManager& vboManager);
 
@@ -344,6 +399,13 @@ public:
   }
 };
 
+/**
+ * Packs the given unit normal into signed bytes for a BrushVertexArray. OpenGL maps the
+ * components back to [-1..1], so axis aligned normals survive exactly and others lose
+ * less than a percent of precision, which is plenty for shading and grid rendering.
+ */
+vm::vec<GLbyte, 4> packNormal(const vm::vec3f& normal);
+
 /**
  * Same as BrushIndexArray but for vertices instead of indices.
  * The only difference is deleteVerticesWithKey() doesn't need to zero out
@@ -352,7 +414,7 @@ public:
 class BrushVertexArray
 {
 private:
-  using Vertex = Renderer::GLVertexTypes::P3NT2::Vertex;
+  using Vertex = Renderer::GLVertexTypes::P3NBT2::Vertex;
 
   VertexHolder<Vertex> m_vertexHolder;
   AllocationTracker m_allocationTracker;
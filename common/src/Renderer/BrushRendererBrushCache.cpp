@@ -23,8 +23,11 @@
 #include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
 #include "Model/Polyhedron.h"
+#include "Renderer/BrushRendererArrays.h"
 
 #include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -53,6 +56,7 @@ BrushRendererBrushCache::CachedEdge::CachedEdge(
 
 BrushRendererBrushCache::BrushRendererBrushCache()
   : m_rendererCacheValid{false}
+  , m_generation{0}
 {
 }
 
@@ -80,31 +84,42 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
   m_cachedFacesSortedByTexture.clear();
   m_cachedFacesSortedByTexture.reserve(brush.faceCount());
 
+  // Maps each vertex to its index, relative to the brush's first vertex being 0. This is
+  // used below when building the edge cache. The vertex payloads cannot be used for this
+  // because the geometry may be shared with other brushes whose caches are validated
+  // concurrently.
+  auto vertexIndices = std::unordered_map<const Model::BrushVertex*, size_t>{};
+  vertexIndices.reserve(brush.vertexCount());
+
+  // reused for every face to compute the texture coordinates of its vertices in one go
+  auto facePositions = std::vector<vm::vec3>{};
+  auto faceTexCoords = std::vector<vm::vec2f>{};
+
   for (const auto& face : brush.faces())
   {
     const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
 
     // The boundary is in CCW order, but the renderer expects CW order:
     auto& boundary = face.geometry()->boundary();
+    facePositions.clear();
     for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it)
     {
-      auto* currentHalfEdge = *it;
-      auto* vertex = currentHalfEdge->origin();
+      auto* vertex = (*it)->origin();
 
-      // Set the vertex payload to the index, relative to the brush's first vertex being
-      // 0. This is used below when building the edge cache. NOTE: we'll overwrite the
-      // payload as we visit the same vertex several times while visiting different faces,
-      // this is fine.
-      const auto currentIndex = m_cachedVertices.size();
-      vertex->setPayload(static_cast<GLuint>(currentIndex));
+      // NOTE: we'll overwrite the index as we visit the same vertex several times while
+      // visiting different faces, this is fine.
+      vertexIndices[vertex] = indexOfFirstVertexRelativeToBrush + facePositions.size();
+      facePositions.push_back(vertex->position());
+    }
 
-      const auto& position = vertex->position();
-      m_cachedVertices.emplace_back(
-        vm::vec3f{position},
-        vm::vec3f{face.boundary().normal},
-        face.textureCoords(position));
+    faceTexCoords.clear();
+    face.textureCoords(facePositions, faceTexCoords);
 
-      currentHalfEdge = currentHalfEdge->previous();
+    const auto normal = packNormal(vm::vec3f{face.boundary().normal});
+    for (size_t i = 0; i < facePositions.size(); ++i)
+    {
+      m_cachedVertices.emplace_back(
+        vm::vec3f{facePositions[i]}, normal, faceTexCoords[i]);
     }
 
     // face cache
@@ -134,14 +149,16 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
     const auto& face1 = brush.face(*faceIndex1);
     const auto& face2 = brush.face(*faceIndex2);
 
-    const auto vertexIndex1RelativeToBrush = currentEdge->firstVertex()->payload();
-    const auto vertexIndex2RelativeToBrush = currentEdge->secondVertex()->payload();
+    const auto vertexIndex1RelativeToBrush = vertexIndices.at(currentEdge->firstVertex());
+    const auto vertexIndex2RelativeToBrush =
+      vertexIndices.at(currentEdge->secondVertex());
 
     m_cachedEdges.emplace_back(
       &face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush);
   }
 
   m_rendererCacheValid = true;
+  ++m_generation;
 }
 
 const std::vector<BrushRendererBrushCache::Vertex>& BrushRendererBrushCache::
@@ -164,5 +181,10 @@ const std::vector<BrushRendererBrushCache::CachedEdge>& BrushRendererBrushCache:
   assert(m_rendererCacheValid);
   return m_cachedEdges;
 }
+
+size_t BrushRendererBrushCache::generation() const
+{
+  return m_generation;
+}
 } // namespace Renderer
 } // namespace TrenchBroom
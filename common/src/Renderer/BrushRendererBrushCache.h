@@ -41,7 +41,7 @@ namespace Renderer
 class BrushRendererBrushCache
 {
 public:
-  using VertexSpec = Renderer::GLVertexTypes::P3NT2;
+  using VertexSpec = Renderer::GLVertexTypes::P3NBT2;
   using Vertex = VertexSpec::Vertex;
 
   struct CachedFace
@@ -74,6 +74,7 @@ private:
   std::vector<CachedEdge> m_cachedEdges;
   std::vector<CachedFace> m_cachedFacesSortedByTexture;
   bool m_rendererCacheValid;
+  size_t m_generation;
 
 public:
   BrushRendererBrushCache();
@@ -89,6 +90,9 @@ public:
    * VBO's when the brush itself hasn't changed, but we're moving it between VBO's for
    * different rendering styles (default/selected/locked), or need to re-evaluate the
    * BrushRenderer::Filter to exclude certain faces/edges.
+   *
+   * This does not modify the brush or its geometry, so the caches of different brushes
+   * can be validated concurrently.
    */
   void validateVertexCache(const Model::BrushNode& brushNode);
 
@@ -98,6 +102,12 @@ public:
   const std::vector<Vertex>& cachedVertices() const;
   const std::vector<CachedFace>& cachedFacesSortedByTexture() const;
   const std::vector<CachedEdge>& cachedEdges() const;
+
+  /**
+   * Returns a number that changes whenever the cache is rebuilt. Allows holders of copies
+   * of the cached vertices to detect whether their copies are stale.
+   */
+  size_t generation() const;
 };
 } // namespace Renderer
 } // namespace TrenchBroom
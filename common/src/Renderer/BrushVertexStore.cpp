@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushVertexStore.h"
+
+#include "Ensure.h"
+#include "Model/BrushNode.h"
+#include "Renderer/BrushRendererArrays.h"
+#include "Renderer/BrushRendererBrushCache.h"
+
+#include <cassert>
+#include <cstring>
+#include <iterator>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+BrushVertexStore::BrushVertexStore()
+  : m_vertexArray{std::make_shared<BrushVertexArray>()}
+{
+}
+
+const std::shared_ptr<BrushVertexArray>& BrushVertexStore::vertexArray() const
+{
+  return m_vertexArray;
+}
+
+AllocationTracker::Block* BrushVertexStore::acquire(const Model::BrushNode& brushNode)
+{
+  const auto& brushCache = brushNode.brushRendererBrushCache();
+
+  if (const auto it = m_currentBlocks.find(&brushNode); it != m_currentBlocks.end())
+  {
+    auto& entry = it->second;
+    if (entry.generation == brushCache.generation())
+    {
+      ++m_refCounts[entry.block];
+      return entry.block;
+    }
+  }
+
+  const auto& cachedVertices = brushCache.cachedVertices();
+  ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+
+  auto [block, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
+  std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
+
+  m_currentBlocks[&brushNode] = Entry{block, brushCache.generation()};
+  m_refCounts[block] = 1u;
+  m_blocksByPosition[block->pos] = {block, &brushNode};
+  return block;
+}
+
+void BrushVertexStore::release(
+  const Model::BrushNode& brushNode, AllocationTracker::Block* block)
+{
+  const auto it = m_refCounts.find(block);
+  ensure(it != m_refCounts.end(), "block must be acquired");
+
+  if (--it->second > 0u)
+  {
+    return;
+  }
+
+  m_refCounts.erase(it);
+  m_blocksByPosition.erase(block->pos);
+  m_vertexArray->deleteVerticesWithKey(block);
+
+  // the current block of the brush may already have been replaced by a newer one
+  if (const auto currentIt = m_currentBlocks.find(&brushNode);
+      currentIt != m_currentBlocks.end() && currentIt->second.block == block)
+  {
+    m_currentBlocks.erase(currentIt);
+  }
+}
+
+const Model::BrushNode* BrushVertexStore::findBrush(const size_t vertexIndex) const
+{
+  // find the last block that starts at or before the given index
+  auto it = m_blocksByPosition.upper_bound(vertexIndex);
+  if (it == m_blocksByPosition.begin())
+  {
+    return nullptr;
+  }
+
+  const auto& [block, brushNode] = std::prev(it)->second;
+  return vertexIndex < block->pos + block->size ? brushNode : nullptr;
+}
+
+bool BrushVertexStore::empty() const
+{
+  return m_refCounts.empty();
+}
+
+void BrushVertexStore::clear()
+{
+  assert(empty());
+  assert(m_currentBlocks.empty());
+  assert(m_blocksByPosition.empty());
+  m_vertexArray = std::make_shared<BrushVertexArray>();
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Renderer/AllocationTracker.h"
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class BrushNode;
+}
+
+namespace Renderer
+{
+class BrushVertexArray;
+
+/**
+ * Stores the vertices of brushes in a vertex array that can be shared by several
+ * BrushRenderers. Each brush's vertices are uploaded once and referenced by every
+ * renderer that renders it, so moving a brush between renderers, e.g. when it is
+ * selected or deselected, only rewrites the brush's indices.
+ *
+ * The vertices of a brush are reference counted. If a brush's vertex cache was rebuilt
+ * since its vertices were stored, the next acquisition stores the new vertices while the
+ * stale copy remains valid until all renderers have released it.
+ */
+class BrushVertexStore
+{
+private:
+  struct Entry
+  {
+    AllocationTracker::Block* block;
+    size_t generation;
+  };
+
+  std::shared_ptr<BrushVertexArray> m_vertexArray;
+  std::unordered_map<const Model::BrushNode*, Entry> m_currentBlocks;
+  std::unordered_map<AllocationTracker::Block*, size_t> m_refCounts;
+
+  /**
+   * Maps the position of every stored block to the block and the brush it belongs to.
+   */
+  std::map<size_t, std::pair<AllocationTracker::Block*, const Model::BrushNode*>>
+    m_blocksByPosition;
+
+public:
+  BrushVertexStore();
+
+  const std::shared_ptr<BrushVertexArray>& vertexArray() const;
+
+  /**
+   * Returns the block holding the current vertices of the given brush, storing them if
+   * necessary. The brush's vertex cache must be valid. Every call must be matched by a
+   * call to release().
+   */
+  AllocationTracker::Block* acquire(const Model::BrushNode& brushNode);
+
+  /**
+   * Releases a block returned by acquire(). The vertices are deleted when the last
+   * reference to them is released.
+   */
+  void release(const Model::BrushNode& brushNode, AllocationTracker::Block* block);
+
+  /**
+   * Returns the brush whose vertices contain the vertex with the given index in the
+   * vertex array, or null if the vertex does not belong to any brush.
+   */
+  const Model::BrushNode* findBrush(size_t vertexIndex) const;
+
+  /**
+   * Returns true if no vertices are stored.
+   */
+  bool empty() const;
+
+  /**
+   * Replaces the vertex array with a new empty one to free its memory. The store must be
+   * empty.
+   */
+  void clear();
+};
+} // namespace Renderer
+} // namespace TrenchBroom
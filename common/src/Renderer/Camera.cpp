@@ -21,8 +21,10 @@
 
 #include "Macros.h"
 
+#include "vm/bbox.h"
 #include "vm/distance.h"
 #include "vm/intersection.h"
+#include "vm/plane.h"
 #include "vm/ray.h"
 
 namespace TrenchBroom
@@ -207,6 +209,13 @@ void Camera::frustumPlanes(
   doComputeFrustumPlanes(top, right, bottom, left);
 }
 
+bool Camera::intersectsFrustum(const vm::bbox3f& bounds) const
+{
+  vm::plane3f planes[4];
+  frustumPlanes(planes[0], planes[1], planes[2], planes[3]);
+  return Renderer::intersectsFrustum(bounds, planes);
+}
+
 vm::ray3f Camera::viewRay() const
 {
   return vm::ray3f(m_position, m_direction);
@@ -534,5 +543,23 @@ bool Camera::isValidZoom(const float zoom) const
 {
   return zoom >= 0.02f && zoom <= 100.0f;
 }
+
+bool intersectsFrustum(const vm::bbox3f& bounds, const vm::plane3f (&planes)[4])
+{
+  for (const auto& plane : planes)
+  {
+    // the corner of the box that is farthest from the plane in the direction opposite to
+    // its normal, which points out of the frustum
+    const auto corner = vm::vec3f{
+      plane.normal.x() >= 0.0f ? bounds.min.x() : bounds.max.x(),
+      plane.normal.y() >= 0.0f ? bounds.min.y() : bounds.max.y(),
+      plane.normal.z() >= 0.0f ? bounds.min.z() : bounds.max.z()};
+    if (plane.point_distance(corner) > 0.0f)
+    {
+      return false;
+    }
+  }
+  return true;
+}
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -123,6 +123,12 @@ public:
     vm::plane3f& bottomPlane,
     vm::plane3f& leftPlane) const;
 
+  /**
+   * Returns whether the given bounds intersect the four side planes of the view frustum.
+   * Use the free function of the same name to test many bounds against the same planes.
+   */
+  bool intersectsFrustum(const vm::bbox3f& bounds) const;
+
   vm::ray3f viewRay() const;
   vm::ray3f pickRay(float x, float y) const;
   vm::ray3f pickRay(const vm::vec3f& point) const;
@@ -223,5 +229,11 @@ private:
   virtual bool isValidZoom(float zoom) const;
   virtual void doUpdateZoom() = 0;
 };
+
+/**
+ * Returns whether the given bounds intersect all of the given frustum planes, whose
+ * normals point out of the frustum.
+ */
+bool intersectsFrustum(const vm::bbox3f& bounds, const vm::plane3f (&planes)[4]);
 } // namespace Renderer
 } // namespace TrenchBroom
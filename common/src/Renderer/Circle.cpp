@@ -92,9 +92,9 @@ bool Circle::prepared() const
   return m_array.prepared();
 }
 
-void Circle::prepare(VboManager& vboManager)
+void Circle::prepare(VboManager& vboManager, const VboUsage usage)
 {
-  m_array.prepare(vboManager);
+  m_array.prepare(vboManager, usage);
 }
 
 void Circle::render()
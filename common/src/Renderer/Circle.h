@@ -53,7 +53,7 @@ public:
     float angleLength);
 
   bool prepared() const;
-  void prepare(VboManager& vboManager);
+  void prepare(VboManager& vboManager, VboUsage usage = VboUsage::StaticDraw);
   void render();
 
 private:
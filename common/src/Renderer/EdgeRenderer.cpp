@@ -30,6 +30,8 @@
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
 
+#include <functional>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -74,6 +76,20 @@ EdgeRenderer::RenderBase::RenderBase(const Params& params)
 
 EdgeRenderer::RenderBase::~RenderBase() = default;
 
+std::optional<RenderSortKey> EdgeRenderer::RenderBase::edgeSortKey() const
+{
+  // edges rendered on top or with translucent or per vertex colors depend on what was
+  // rendered before them
+  if (m_params.onTop || !m_params.useColor || m_params.color.a() < 1.0f)
+  {
+    return std::nullopt;
+  }
+
+  const auto state = std::hash<float>{}(m_params.width) * 31
+                     + std::hash<double>{}(m_params.offset);
+  return RenderSortKey{&Shaders::EdgeShader, nullptr, state};
+}
+
 void EdgeRenderer::RenderBase::renderEdges(RenderContext& renderContext)
 {
   if (m_params.offset != 0.0)
@@ -190,6 +206,11 @@ void DirectEdgeRenderer::Render::doPrepareVertices(VboManager& vboManager)
   m_vertexArray.prepare(vboManager);
 }
 
+std::optional<RenderSortKey> DirectEdgeRenderer::Render::sortKey() const
+{
+  return edgeSortKey();
+}
+
 void DirectEdgeRenderer::Render::doRender(RenderContext& renderContext)
 {
   if (m_vertexArray.vertexCount() > 0)
@@ -228,10 +249,12 @@ void DirectEdgeRenderer::doRender(
 IndexedEdgeRenderer::Render::Render(
   const EdgeRenderer::Params& params,
   std::shared_ptr<BrushVertexArray> vertexArray,
-  std::shared_ptr<BrushIndexArray> indexArray)
+  std::shared_ptr<BrushIndexArray> indexArray,
+  std::shared_ptr<const BrushIndexRanges> indexRanges)
   : RenderBase{params}
   , m_vertexArray{std::move(vertexArray)}
   , m_indexArray{std::move(indexArray)}
+  , m_indexRanges{std::move(indexRanges)}
 {
 }
 
@@ -241,9 +264,14 @@ void IndexedEdgeRenderer::Render::prepareVerticesAndIndices(VboManager& vboManag
   m_indexArray->prepare(vboManager);
 }
 
+std::optional<RenderSortKey> IndexedEdgeRenderer::Render::sortKey() const
+{
+  return edgeSortKey();
+}
+
 void IndexedEdgeRenderer::Render::doRender(RenderContext& renderContext)
 {
-  if (m_indexArray->hasValidIndices())
+  if (m_indexArray->hasValidIndices() && !(m_indexRanges && m_indexRanges->empty()))
   {
     renderEdges(renderContext);
   }
@@ -253,7 +281,14 @@ void IndexedEdgeRenderer::Render::doRenderVertices(RenderContext&)
 {
   m_vertexArray->setupVertices();
   m_indexArray->setupIndices();
-  m_indexArray->render(PrimType::Lines);
+  if (m_indexRanges)
+  {
+    m_indexArray->render(PrimType::Lines, *m_indexRanges);
+  }
+  else
+  {
+    m_indexArray->render(PrimType::Lines);
+  }
   m_vertexArray->cleanupVertices();
   m_indexArray->cleanupIndices();
 }
@@ -270,10 +305,16 @@ IndexedEdgeRenderer::IndexedEdgeRenderer(
 {
 }
 
+void IndexedEdgeRenderer::setIndexRanges(
+  std::shared_ptr<const BrushIndexRanges> indexRanges)
+{
+  m_indexRanges = std::move(indexRanges);
+}
+
 void IndexedEdgeRenderer::doRender(
   RenderBatch& renderBatch, const EdgeRenderer::Params& params)
 {
-  renderBatch.addOneShot(new Render{params, m_vertexArray, m_indexArray});
+  renderBatch.addOneShot(new Render{params, m_vertexArray, m_indexArray, m_indexRanges});
 }
 } // namespace Renderer
 } // namespace TrenchBroom
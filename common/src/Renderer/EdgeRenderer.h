@@ -25,12 +25,14 @@
 #include "Renderer/VertexArray.h"
 
 #include <memory>
+#include <optional>
 
 namespace TrenchBroom
 {
 namespace Renderer
 {
 class BrushIndexArray;
+class BrushIndexRanges;
 class BrushVertexArray;
 class RenderBatch;
 
@@ -66,6 +68,7 @@ public:
 
   protected:
     void renderEdges(RenderContext& renderContext);
+    std::optional<RenderSortKey> edgeSortKey() const;
 
   private:
     virtual void doRenderVertices(RenderContext& renderContext) = 0;
@@ -122,6 +125,8 @@ private:
   public:
     Render(const Params& params, VertexArray& vertexArray, IndexRangeMap& indexRanges);
 
+    std::optional<RenderSortKey> sortKey() const override;
+
   private:
     void doPrepareVertices(VboManager& vboManager) override;
     void doRender(RenderContext& renderContext) override;
@@ -149,12 +154,16 @@ private:
   private:
     std::shared_ptr<BrushVertexArray> m_vertexArray;
     std::shared_ptr<BrushIndexArray> m_indexArray;
+    std::shared_ptr<const BrushIndexRanges> m_indexRanges;
 
   public:
     Render(
       const Params& params,
       std::shared_ptr<BrushVertexArray> vertexArray,
-      std::shared_ptr<BrushIndexArray> indexArray);
+      std::shared_ptr<BrushIndexArray> indexArray,
+      std::shared_ptr<const BrushIndexRanges> indexRanges);
+
+    std::optional<RenderSortKey> sortKey() const override;
 
   private:
     void prepareVerticesAndIndices(VboManager& vboManager) override;
@@ -165,6 +174,7 @@ private:
 private:
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   std::shared_ptr<BrushIndexArray> m_indexArray;
+  std::shared_ptr<const BrushIndexRanges> m_indexRanges;
 
 public:
   IndexedEdgeRenderer();
@@ -172,6 +182,12 @@ public:
     std::shared_ptr<BrushVertexArray> vertexArray,
     std::shared_ptr<BrushIndexArray> indexArray);
 
+  /**
+   * Restricts rendering to the given index ranges. If the given ranges are null, all
+   * indices are rendered.
+   */
+  void setIndexRanges(std::shared_ptr<const BrushIndexRanges> indexRanges);
+
 private:
   void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
 };
@@ -36,10 +36,12 @@
 
 #include "kdl/memory_utils.h"
 #include "kdl/overload.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/intersection.h"
 
 #include <cstring>
+#include <functional>
 
 namespace TrenchBroom::Renderer
 {
@@ -130,8 +132,62 @@ std::vector<Vertex> createDecalBrushFace(
   });
 }
 
+template <typename T>
+void hashCombine(size_t& seed, const T& value)
+{
+  seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+template <typename T, size_t S>
+void hashCombine(size_t& seed, const vm::vec<T, S>& value)
+{
+  for (size_t i = 0; i < S; ++i)
+  {
+    hashCombine(seed, value[i]);
+  }
+}
+
+/**
+ * Hashes the properties of the brush's faces that determine the decal geometry: the face
+ * planes, which also determine the face polygons, and the texture alignment.
+ */
+size_t hashBrushFaces(const Model::BrushNode* brushNode)
+{
+  auto result = size_t(0);
+  for (const auto& face : brushNode->brush().faces())
+  {
+    const auto& boundary = face.boundary();
+    hashCombine(result, boundary.normal);
+    hashCombine(result, boundary.distance);
+
+    const auto& attributes = face.attributes();
+    hashCombine(result, attributes.xOffset());
+    hashCombine(result, attributes.yOffset());
+    hashCombine(result, attributes.xScale());
+    hashCombine(result, attributes.yScale());
+    hashCombine(result, attributes.rotation());
+
+    const auto& texCoordSystem = face.texCoordSystem();
+    hashCombine(result, texCoordSystem.xAxis());
+    hashCombine(result, texCoordSystem.yAxis());
+  }
+  return result;
+}
+
 } // namespace
 
+bool EntityDecalRenderer::DecalKey::operator==(const DecalKey& other) const
+{
+  return entityBounds == other.entityBounds && textureName == other.textureName
+         && texture == other.texture && textureWidth == other.textureWidth
+         && textureHeight == other.textureHeight && brushes == other.brushes;
+}
+
+bool EntityDecalRenderer::DecalKey::operator!=(const DecalKey& other) const
+{
+  return !(*this == other);
+}
+
 EntityDecalRenderer::EntityDecalRenderer(std::weak_ptr<View::MapDocument> document)
   : m_document{std::move(document)}
 {
@@ -210,7 +266,7 @@ void EntityDecalRenderer::removeEntity(const Model::EntityNode* entityNode)
   if (const auto it = m_entities.find(entityNode); it != std::end(m_entities))
   {
     // make sure the entity data is cleaned up
-    invalidateDecalData(it->second);
+    releaseDecalGeometry(it->second);
     m_entities.erase(it);
   }
 }
@@ -265,13 +321,14 @@ void EntityDecalRenderer::removeBrush(const Model::BrushNode* brushNode)
 
 void EntityDecalRenderer::invalidateDecalData(EntityDecalData& data) const
 {
-  // do nothing if the brush data is already marked as invalidated
-  if (!data.validated)
-  {
-    return;
-  }
-
+  // the geometry is kept until the entity is validated again, it can be reused if its
+  // key didn't change
   data.validated = false;
+}
+
+void EntityDecalRenderer::releaseDecalGeometry(EntityDecalData& data) const
+{
+  data.key = std::nullopt;
 
   // if the texture doesn't exist, do nothing
   // also do nothing if the VBO storage fields are null, but it shouldn't happen
@@ -327,7 +384,32 @@ void EntityDecalRenderer::validateDecalData(
     }
   }
 
-  data.texture = document->textureManager().texture(spec->textureName);
+  auto* texture = document->textureManager().texture(spec->textureName);
+
+  auto key = DecalKey{
+    entityBounds,
+    spec->textureName,
+    texture,
+    texture ? texture->width() : 0,
+    texture ? texture->height() : 0,
+    kdl::vec_transform(
+      data.brushes,
+      [](const auto* brushNode) {
+        return std::pair{brushNode, hashBrushFaces(brushNode)};
+      }),
+  };
+
+  if (data.key == key)
+  {
+    // nothing that the geometry depends on has changed, keep it
+    data.validated = true;
+    return;
+  }
+
+  releaseDecalGeometry(data);
+  data.key = std::move(key);
+
+  data.texture = texture;
   if (!data.texture)
   {
     // no decal texture was found, don't generate any geometry
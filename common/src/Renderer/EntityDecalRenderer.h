@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Color.h"
+#include "FloatType.h"
 #include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
@@ -27,8 +28,13 @@
 
 #include "kdl/vector_set.h"
 
+#include "vm/bbox.h"
+
 #include <memory>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom::Assets
@@ -55,6 +61,24 @@ namespace TrenchBroom::Renderer
 class EntityDecalRenderer
 {
 private:
+  /**
+   * Identifies the inputs from which the decal geometry of an entity was computed. If the
+   * key of an invalidated entity is unchanged, its geometry is reused.
+   */
+  struct DecalKey
+  {
+    vm::bbox3 entityBounds;
+    std::string textureName;
+    const Assets::Texture* texture = nullptr;
+    size_t textureWidth = 0;
+    size_t textureHeight = 0;
+    // the intersected brushes and the hashes of their faces
+    std::vector<std::pair<const Model::BrushNode*, size_t>> brushes;
+
+    bool operator==(const DecalKey& other) const;
+    bool operator!=(const DecalKey& other) const;
+  };
+
   struct EntityDecalData
   {
     std::vector<const Model::BrushNode*> brushes;
@@ -63,6 +87,9 @@ private:
      * and the decal geometry is stored in the VBO */
     bool validated = false;
 
+    // the key of the geometry that is stored in the VBO, if any
+    std::optional<DecalKey> key;
+
     Assets::Texture* texture = nullptr;
 
     AllocationTracker::Block* vertexHolderKey = nullptr;
@@ -114,6 +141,7 @@ private:
   void removeBrush(const Model::BrushNode* brushNode);
 
   void invalidateDecalData(EntityDecalData& data) const;
+  void releaseDecalGeometry(EntityDecalData& data) const;
 
   void validateDecalData(
     const Model::EntityNode* entityNode, EntityDecalData& data) const;
@@ -23,6 +23,8 @@
 #include "Model/EditorContext.h"
 #include "Model/EntityNode.h"
 #include "Model/EntityNodeBase.h"
+#include "Model/EntityNodeIndex.h"
+#include "Model/EntityProperties.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
 #include "Model/PatchNode.h"
@@ -33,6 +35,7 @@
 
 #include "kdl/memory_utils.h"
 #include "kdl/overload.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/vec.h"
 
@@ -68,52 +71,32 @@ void EntityLinkRenderer::setSelectedColor(const Color& selectedColor)
 namespace
 {
 
+bool anySelected(const Model::EntityNodeBase& source, const Model::EntityNodeBase& target)
+{
+  return source.selected() || source.descendantSelected() || target.selected()
+         || target.descendantSelected();
+}
+
 void addLink(
   const Model::EntityNodeBase& source,
   const Model::EntityNodeBase& target,
-  const Color& defaultColor,
-  const Color& selectedColor,
+  const Color& color,
   std::vector<LinkRenderer::LineVertex>& links)
 {
-  const auto anySelected = source.selected() || source.descendantSelected()
-                           || target.selected() || target.descendantSelected();
-  const auto& sourceColor = anySelected ? selectedColor : defaultColor;
-  const auto& targetColor = anySelected ? selectedColor : defaultColor;
-
-  links.emplace_back(vm::vec3f{source.linkSourceAnchor()}, sourceColor);
-  links.emplace_back(vm::vec3f{target.linkTargetAnchor()}, targetColor);
+  links.emplace_back(vm::vec3f{source.linkSourceAnchor()}, color);
+  links.emplace_back(vm::vec3f{target.linkTargetAnchor()}, color);
 }
 
-struct CollectAllLinksVisitor
+void addLink(
+  const Model::EntityNodeBase& source,
+  const Model::EntityNodeBase& target,
+  const Color& defaultColor,
+  const Color& selectedColor,
+  std::vector<LinkRenderer::LineVertex>& links)
 {
-  const Model::EditorContext& editorContext;
-  Color defaultColor;
-  Color selectedColor;
-
-  void visit(
-    const Model::EntityNodeBase& node, std::vector<LinkRenderer::LineVertex>& links)
-  {
-    if (editorContext.visible(&node))
-    {
-      addTargets(node, node.linkTargets(), links);
-      addTargets(node, node.killTargets(), links);
-    }
-  }
-
-  void addTargets(
-    const Model::EntityNodeBase& source,
-    const std::vector<Model::EntityNodeBase*>& targets,
-    std::vector<LinkRenderer::LineVertex>& links)
-  {
-    for (const Model::EntityNodeBase* target : targets)
-    {
-      if (editorContext.visible(target))
-      {
-        addLink(source, *target, defaultColor, selectedColor, links);
-      }
-    }
-  }
-};
+  addLink(
+    source, target, anySelected(source, target) ? selectedColor : defaultColor, links);
+}
 
 struct CollectTransitiveSelectedLinksVisitor
 {
@@ -241,29 +224,38 @@ auto collectSelectedLinks(const Model::NodeCollection& selectedNodes, Visitor vi
   return links;
 }
 
-auto getAllLinks(
-  View::MapDocument& document, const Color& defaultColor, const Color& selectedColor)
+/**
+ * Returns all links regardless of their visibility, since whether a node is visible also
+ * depends on whether it is selected.
+ */
+std::vector<EntityLinkRenderer::Link> getAllLinks(View::MapDocument& document)
 {
-  auto links = std::vector<LinkRenderer::LineVertex>{};
+  auto links = std::vector<EntityLinkRenderer::Link>{};
 
-  if (document.world())
+  if (const auto* world = document.world())
   {
-    auto visitor =
-      CollectAllLinksVisitor{document.editorContext(), defaultColor, selectedColor};
+    // only entities with a target or killtarget property can be link sources
+    const auto& index = world->entityNodeIndex();
+    const auto sources = kdl::vec_sort_and_remove_duplicates(kdl::vec_concat(
+      index.findEntityNodes(
+        Model::EntityNodeIndexQuery::numbered(Model::EntityPropertyKeys::Target)),
+      index.findEntityNodes(
+        Model::EntityNodeIndexQuery::numbered(Model::EntityPropertyKeys::Killtarget))));
 
-    document.world()->accept(kdl::overload(
-      [](auto&& thisLambda, const Model::WorldNode* worldNode) {
-        worldNode->visitChildren(thisLambda);
-      },
-      [](auto&& thisLambda, const Model::LayerNode* layerNode) {
-        layerNode->visitChildren(thisLambda);
-      },
-      [](auto&& thisLambda, const Model::GroupNode* groupNode) {
-        groupNode->visitChildren(thisLambda);
-      },
-      [&](const Model::EntityNode* entityNode) { visitor.visit(*entityNode, links); },
-      [](const Model::BrushNode*) {},
-      [](const Model::PatchNode*) {}));
+    for (const auto* source : sources)
+    {
+      if (source != world)
+      {
+        for (const auto* target : source->linkTargets())
+        {
+          links.push_back({source, target});
+        }
+        for (const auto* target : source->killTargets())
+        {
+          links.push_back({source, target});
+        }
+      }
+    }
   }
 
   return links;
@@ -285,14 +277,10 @@ auto getDirectSelectedLinks(
   return collectSelectedLinks(document.selectedNodes(), visitor);
 }
 
-auto getLinks(
+auto getSelectedLinks(
   View::MapDocument& document, const Color& defaultColor, const Color& selectedColor)
 {
   const auto entityLinkMode = pref(Preferences::EntityLinkMode);
-  if (entityLinkMode == Preferences::entityLinkModeAll())
-  {
-    return getAllLinks(document, defaultColor, selectedColor);
-  }
   if (entityLinkMode == Preferences::entityLinkModeTransitive())
   {
     return getTransitiveSelectedLinks(document, defaultColor, selectedColor);
@@ -308,7 +296,66 @@ auto getLinks(
 
 std::vector<LinkRenderer::LineVertex> EntityLinkRenderer::getLinks()
 {
-  return Renderer::getLinks(*kdl::mem_lock(m_document), m_defaultColor, m_selectedColor);
+  auto document = kdl::mem_lock(m_document);
+
+  m_showAllLinks = pref(Preferences::EntityLinkMode) == Preferences::entityLinkModeAll();
+  if (!m_showAllLinks)
+  {
+    m_allLinks.clear();
+    return getSelectedLinks(*document, m_defaultColor, m_selectedColor);
+  }
+
+  // Every link is added once in the default color and once in the selected color, so
+  // that selection changes only need to change which of them are rendered.
+  m_allLinks = getAllLinks(*document);
+
+  auto links = std::vector<LinkRenderer::LineVertex>{};
+  links.reserve(4 * m_allLinks.size());
+  for (const auto& link : m_allLinks)
+  {
+    addLink(*link.source, *link.target, m_defaultColor, links);
+  }
+  for (const auto& link : m_allLinks)
+  {
+    addLink(*link.source, *link.target, m_selectedColor, links);
+  }
+  return links;
+}
+
+bool EntityLinkRenderer::linksDependOnSelection()
+{
+  return !m_showAllLinks;
+}
+
+std::optional<std::vector<size_t>> EntityLinkRenderer::getVisibleLinks()
+{
+  if (!m_showAllLinks)
+  {
+    return std::nullopt;
+  }
+
+  auto document = kdl::mem_lock(m_document);
+  const auto& editorContext = document->editorContext();
+
+  auto defaultLinks = std::vector<size_t>{};
+  auto selectedLinks = std::vector<size_t>{};
+  for (size_t i = 0; i < m_allLinks.size(); ++i)
+  {
+    const auto& link = m_allLinks[i];
+    if (editorContext.visible(link.source) && editorContext.visible(link.target))
+    {
+      if (anySelected(*link.source, *link.target))
+      {
+        selectedLinks.push_back(m_allLinks.size() + i);
+      }
+      else
+      {
+        defaultLinks.push_back(i);
+      }
+    }
+  }
+
+  return kdl::vec_concat(std::move(defaultLinks), std::move(selectedLinks));
 }
 
 } // namespace TrenchBroom::Renderer
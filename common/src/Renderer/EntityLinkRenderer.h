@@ -24,8 +24,14 @@
 #include "Renderer/LinkRenderer.h"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
+namespace TrenchBroom::Model
+{
+class EntityNodeBase;
+}
+
 namespace TrenchBroom::View
 {
 class MapDocument; // FIXME: Renderer should not depend on View
@@ -36,8 +42,20 @@ namespace TrenchBroom::Renderer
 
 class EntityLinkRenderer : public LinkRenderer
 {
+public:
+  struct Link
+  {
+    const Model::EntityNodeBase* source;
+    const Model::EntityNodeBase* target;
+  };
+
+private:
   std::weak_ptr<View::MapDocument> m_document;
 
+  // if all links are shown, they are only generated again if the nodes change
+  bool m_showAllLinks = false;
+  std::vector<Link> m_allLinks;
+
   Color m_defaultColor = {0.5f, 1.0f, 0.5f, 1.0f};
   Color m_selectedColor = {1.0f, 0.0f, 0.0f, 1.0f};
 
@@ -49,6 +67,8 @@ public:
 
 private:
   std::vector<LinkRenderer::LineVertex> getLinks() override;
+  bool linksDependOnSelection() override;
+  std::optional<std::vector<size_t>> getVisibleLinks() override;
 
   deleteCopy(EntityLinkRenderer);
 };
@@ -72,15 +72,19 @@ void EntityModelRenderer::addEntity(const Model::EntityNode* entityNode)
     });
 
   auto* renderer = m_entityModelManager.renderer(modelSpec);
-  if (renderer != nullptr)
+  if (renderer != nullptr && m_entities.emplace(entityNode, renderer).second)
   {
-    m_entities.emplace(entityNode, renderer);
+    addToGroup(entityNode, renderer);
   }
 }
 
 void EntityModelRenderer::removeEntity(const Model::EntityNode* entityNode)
 {
-  m_entities.erase(entityNode);
+  if (const auto it = m_entities.find(entityNode); it != std::end(m_entities))
+  {
+    removeFromGroup(entityNode, it->second);
+    m_entities.erase(it);
+  }
 }
 
 void EntityModelRenderer::updateEntity(const Model::EntityNode* entityNode)
@@ -101,16 +105,20 @@ void EntityModelRenderer::updateEntity(const Model::EntityNode* entityNode)
   if (it == std::end(m_entities))
   {
     m_entities.emplace(entityNode, renderer);
+    addToGroup(entityNode, renderer);
   }
   else
   {
     if (renderer == nullptr)
     {
+      removeFromGroup(entityNode, it->second);
       m_entities.erase(it);
     }
     else if (it->second != renderer)
     {
+      removeFromGroup(entityNode, it->second);
       it->second = renderer;
+      addToGroup(entityNode, renderer);
     }
   }
 }
@@ -118,6 +126,7 @@ void EntityModelRenderer::updateEntity(const Model::EntityNode* entityNode)
 void EntityModelRenderer::clear()
 {
   m_entities.clear();
+  m_entitiesByRenderer.clear();
 }
 
 bool EntityModelRenderer::applyTinting() const
@@ -155,6 +164,26 @@ void EntityModelRenderer::render(RenderBatch& renderBatch)
   renderBatch.add(this);
 }
 
+void EntityModelRenderer::addToGroup(
+  const Model::EntityNode* entityNode, TexturedRenderer* renderer)
+{
+  m_entitiesByRenderer[renderer].insert(entityNode);
+}
+
+void EntityModelRenderer::removeFromGroup(
+  const Model::EntityNode* entityNode, TexturedRenderer* renderer)
+{
+  if (const auto it = m_entitiesByRenderer.find(renderer);
+      it != std::end(m_entitiesByRenderer))
+  {
+    it->second.erase(entityNode);
+    if (it->second.empty())
+    {
+      m_entitiesByRenderer.erase(it);
+    }
+  }
+}
+
 void EntityModelRenderer::doPrepareVertices(VboManager& vboManager)
 {
   m_entityModelManager.prepare(vboManager);
@@ -190,28 +219,43 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
   shader.set("CameraUp", renderContext.camera().up());
   shader.set("ViewMatrix", renderContext.camera().viewMatrix());
 
-  for (const auto& [entityNode, renderer] : m_entities)
+  // the shader computes the vertex positions from the model matrix uniform, so any model
+  // matrix that is currently applied must be folded into it
+  const auto& modelMatrix = renderContext.transformation().modelMatrix();
+  const auto orientationUniform = shader.uniform("Orientation");
+  const auto modelMatrixUniform = shader.uniform("ModelMatrix");
+
+  auto modelMatrices = std::vector<vm::mat4x4f>{};
+  for (const auto& [renderer, entityNodes] : m_entitiesByRenderer)
   {
-    if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
+    const Assets::EntityModelFrame* model = nullptr;
+
+    modelMatrices.clear();
+    for (const auto* entityNode : entityNodes)
     {
-      continue;
+      if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
+      {
+        continue;
+      }
+
+      if (const auto* entityModel = entityNode->entity().model())
+      {
+        // all entities in this group share the same model
+        model = entityModel;
+        modelMatrices.push_back(
+          modelMatrix * vm::mat4x4f{entityNode->entity().modelTransformation()});
+      }
     }
 
-    const auto* model = entityNode->entity().model();
-    if (!model)
+    if (modelMatrices.empty())
     {
       continue;
     }
 
-    shader.set("Orientation", static_cast<int>(model->orientation()));
-
-    const auto transformation = vm::mat4x4f{entityNode->entity().modelTransformation()};
-    const auto multMatrix =
-      MultiplyModelMatrix{renderContext.transformation(), transformation};
-
-    shader.set("ModelMatrix", transformation);
-
-    renderer->render();
+    shader.set(orientationUniform, static_cast<int>(model->orientation()));
+    renderer->renderInstances(modelMatrices.size(), [&](const size_t i) {
+      shader.set(modelMatrixUniform, modelMatrices[i]);
+    });
   }
 }
 } // namespace Renderer
@@ -23,6 +23,7 @@
 #include "Renderer/Renderable.h"
 
 #include <unordered_map>
+#include <unordered_set>
 
 namespace TrenchBroom
 {
@@ -55,6 +56,14 @@ private:
 
   std::unordered_map<const Model::EntityNode*, TexturedRenderer*> m_entities;
 
+  /**
+   * The entities grouped by the renderer of their model. All entities of a group are
+   * rendered together so that the model's vertices and textures are set up only once
+   * per group.
+   */
+  std::unordered_map<TexturedRenderer*, std::unordered_set<const Model::EntityNode*>>
+    m_entitiesByRenderer;
+
   bool m_applyTinting;
   Color m_tintColor;
 
@@ -110,6 +119,9 @@ public:
   void render(RenderBatch& renderBatch);
 
 private:
+  void addToGroup(const Model::EntityNode* entityNode, TexturedRenderer* renderer);
+  void removeFromGroup(const Model::EntityNode* entityNode, TexturedRenderer* renderer);
+
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
 };
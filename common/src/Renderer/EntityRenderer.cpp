@@ -42,12 +42,34 @@
 #include "vm/scalar.h"
 #include "vm/vec.h"
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace TrenchBroom
 {
 namespace Renderer
 {
+namespace
+{
+// the bounds of an entity have 12 edges and 6 faces, which are rendered as lines and
+// quads, respectively
+constexpr auto BoundsSlotSize = size_t(24);
+
+template <typename V>
+void writeBoundsSlot(
+  VertexHolder<V>& holder, const size_t slot, const std::vector<V>& vertices)
+{
+  assert(vertices.size() <= BoundsSlotSize);
+
+  // unused vertices are zeroed and form degenerate primitives
+  auto* dest = holder.getPointerToWriteElementsTo(slot * BoundsSlotSize, BoundsSlotSize);
+  std::copy(vertices.begin(), vertices.end(), dest);
+  std::fill(dest + vertices.size(), dest + BoundsSlotSize, V{});
+}
+
+} // namespace
+
 class EntityRenderer::EntityClassnameAnchor : public TextAnchor3D
 {
 private:
@@ -77,6 +99,9 @@ EntityRenderer::EntityRenderer(
   const Model::EditorContext& editorContext)
   : m_entityModelManager(entityModelManager)
   , m_editorContext(editorContext)
+  , m_pointEntityWireframeBounds(std::make_shared<VertexHolder<WireframeVertex>>())
+  , m_brushEntityWireframeBounds(std::make_shared<VertexHolder<WireframeVertex>>())
+  , m_solidBounds(std::make_shared<VertexHolder<SolidVertex>>())
   , m_modelRenderer(logger, m_entityModelManager, m_editorContext)
   , m_boundsValid(false)
   , m_showOverlays(true)
@@ -98,6 +123,11 @@ void EntityRenderer::invalidate()
 void EntityRenderer::clear()
 {
   m_entities.clear();
+  m_freeBoundsSlots.clear();
+  m_invalidBounds.clear();
+  m_pointEntityWireframeBounds = std::make_shared<VertexHolder<WireframeVertex>>();
+  m_brushEntityWireframeBounds = std::make_shared<VertexHolder<WireframeVertex>>();
+  m_solidBounds = std::make_shared<VertexHolder<SolidVertex>>();
   m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer();
   m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
   m_solidBoundsRenderer = TriangleRenderer();
@@ -106,15 +136,19 @@ void EntityRenderer::clear()
 
 void EntityRenderer::reloadModels()
 {
-  m_modelRenderer.updateEntities(std::begin(m_entities), std::end(m_entities));
+  for (const auto& [entity, slot] : m_entities)
+  {
+    m_modelRenderer.updateEntity(entity);
+  }
 }
 
 void EntityRenderer::addEntity(const Model::EntityNode* entity)
 {
-  if (m_entities.insert(entity).second)
+  if (m_entities.find(entity) == std::end(m_entities))
   {
+    m_entities.emplace(entity, allocateBoundsSlot());
+    m_invalidBounds.insert(entity);
     m_modelRenderer.addEntity(entity);
-    invalidateBounds();
   }
 }
 
@@ -122,16 +156,20 @@ void EntityRenderer::removeEntity(const Model::EntityNode* entity)
 {
   if (auto it = m_entities.find(entity); it != std::end(m_entities))
   {
+    freeBoundsSlot(it->second);
     m_entities.erase(it);
+    m_invalidBounds.erase(entity);
     m_modelRenderer.removeEntity(entity);
-    invalidateBounds();
   }
 }
 
 void EntityRenderer::invalidateEntity(const Model::EntityNode* entity)
 {
   m_modelRenderer.updateEntity(entity);
-  invalidateBounds();
+  if (m_entities.find(entity) != std::end(m_entities))
+  {
+    m_invalidBounds.insert(entity);
+  }
 }
 
 void EntityRenderer::setShowOverlays(const bool showOverlays)
@@ -166,12 +204,20 @@ void EntityRenderer::setTintColor(const Color& tintColor)
 
 void EntityRenderer::setOverrideBoundsColor(const bool overrideBoundsColor)
 {
-  m_overrideBoundsColor = overrideBoundsColor;
+  if (overrideBoundsColor != m_overrideBoundsColor)
+  {
+    m_overrideBoundsColor = overrideBoundsColor;
+    invalidateBounds();
+  }
 }
 
 void EntityRenderer::setBoundsColor(const Color& boundsColor)
 {
-  m_boundsColor = boundsColor;
+  if (boundsColor != m_boundsColor)
+  {
+    m_boundsColor = boundsColor;
+    invalidateBounds();
+  }
 }
 
 void EntityRenderer::setShowOccludedBounds(const bool showOccludedBounds)
@@ -212,8 +258,7 @@ void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBat
 
 void EntityRenderer::renderBounds(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  if (!m_boundsValid)
-    validateBounds();
+  validateBounds();
 
   if (renderContext.showPointEntityBounds())
   {
@@ -279,7 +324,7 @@ void EntityRenderer::renderClassnames(
     renderService.setForegroundColor(m_overlayTextColor);
     renderService.setBackgroundColor(m_overlayBackgroundColor);
 
-    for (const Model::EntityNode* entity : m_entities)
+    for (const auto& [entity, slot] : m_entities)
     {
       if (m_showHiddenEntities || m_editorContext.visible(entity))
       {
@@ -313,7 +358,7 @@ void EntityRenderer::renderAngles(RenderContext& renderContext, RenderBatch& ren
   renderService.setForegroundColor(m_angleColor);
 
   std::vector<vm::vec3f> vertices(3);
-  for (const auto* entityNode : m_entities)
+  for (const auto& [entityNode, slot] : m_entities)
   {
     if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
     {
@@ -415,124 +460,110 @@ struct EntityRenderer::BuildColoredWireframeBoundsVertices
   }
 };
 
-struct EntityRenderer::BuildWireframeBoundsVertices
-{
-  std::vector<GLVertexTypes::P3::Vertex>& vertices;
-
-  explicit BuildWireframeBoundsVertices(
-    std::vector<GLVertexTypes::P3::Vertex>& i_vertices)
-    : vertices(i_vertices)
-  {
-  }
-
-  void operator()(const vm::vec3& v1, const vm::vec3& v2)
-  {
-    vertices.emplace_back(vm::vec3f(v1));
-    vertices.emplace_back(vm::vec3f(v2));
-  }
-};
-
 void EntityRenderer::invalidateBounds()
 {
   m_boundsValid = false;
 }
 
+/**
+ * Rewrites the slots of all entities whose bounds were invalidated, or of all entities if
+ * the bounds were invalidated as a whole. Only the rewritten slots are uploaded when the
+ * bounds are rendered.
+ */
 void EntityRenderer::validateBounds()
 {
-  std::vector<GLVertexTypes::P3NC4::Vertex> solidVertices;
-  solidVertices.reserve(36 * m_entities.size());
-
-  if (m_overrideBoundsColor)
+  if (!m_boundsValid)
   {
-    using Vertex = GLVertexTypes::P3::Vertex;
-    std::vector<Vertex> pointEntityWireframeVertices;
-    std::vector<Vertex> brushEntityWireframeVertices;
-
-    pointEntityWireframeVertices.reserve(24 * m_entities.size());
-    brushEntityWireframeVertices.reserve(24 * m_entities.size());
-
-    BuildWireframeBoundsVertices pointEntityWireframeBoundsBuilder(
-      pointEntityWireframeVertices);
-    BuildWireframeBoundsVertices brushEntityWireframeBoundsBuilder(
-      brushEntityWireframeVertices);
-
-    for (const Model::EntityNode* entityNode : m_entities)
+    for (const auto& [entityNode, slot] : m_entities)
     {
-      if (m_editorContext.visible(entityNode))
-      {
-        const bool pointEntity = !entityNode->hasChildren();
-        if (pointEntity)
-        {
-          entityNode->logicalBounds().for_each_edge(pointEntityWireframeBoundsBuilder);
-        }
-        else
-        {
-          entityNode->logicalBounds().for_each_edge(brushEntityWireframeBoundsBuilder);
-        }
-
-        if (pointEntity && entityNode->entity().model() == nullptr)
-        {
-          BuildColoredSolidBoundsVertices solidBoundsBuilder(
-            solidVertices, boundsColor(entityNode));
-          entityNode->logicalBounds().for_each_face(solidBoundsBuilder);
-        }
-      }
+      writeBounds(entityNode, slot);
+    }
+    m_boundsValid = true;
+  }
+  else
+  {
+    for (const auto* entityNode : m_invalidBounds)
+    {
+      writeBounds(entityNode, m_entities.at(entityNode));
     }
+  }
+  m_invalidBounds.clear();
 
+  if (
+    !m_pointEntityWireframeBounds->prepared() || !m_brushEntityWireframeBounds->prepared()
+    || !m_solidBounds->prepared())
+  {
+    // the renderers capture the number of vertices, so they must be recreated
     m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines);
+      VertexArray::dynamic(m_pointEntityWireframeBounds), PrimType::Lines);
     m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines);
+      VertexArray::dynamic(m_brushEntityWireframeBounds), PrimType::Lines);
+    m_solidBoundsRenderer =
+      TriangleRenderer(VertexArray::dynamic(m_solidBounds), PrimType::Quads);
   }
-  else
+}
+
+size_t EntityRenderer::allocateBoundsSlot()
+{
+  if (m_freeBoundsSlots.empty())
   {
-    using Vertex = GLVertexTypes::P3C4::Vertex;
-    std::vector<Vertex> pointEntityWireframeVertices;
-    std::vector<Vertex> brushEntityWireframeVertices;
+    // grow geometrically to avoid reallocating the buffers for every added entity
+    const auto slotCount = m_solidBounds->size() / BoundsSlotSize;
+    const auto newSlotCount = std::max(size_t(16), 2 * slotCount);
 
-    pointEntityWireframeVertices.reserve(24 * m_entities.size());
-    brushEntityWireframeVertices.reserve(24 * m_entities.size());
+    m_pointEntityWireframeBounds->resize(newSlotCount * BoundsSlotSize);
+    m_brushEntityWireframeBounds->resize(newSlotCount * BoundsSlotSize);
+    m_solidBounds->resize(newSlotCount * BoundsSlotSize);
 
-    for (const Model::EntityNode* entityNode : m_entities)
+    for (auto slot = newSlotCount; slot > slotCount; --slot)
     {
-      if (m_editorContext.visible(entityNode))
-      {
-        const bool pointEntity = !entityNode->hasChildren();
+      m_freeBoundsSlots.push_back(slot - 1);
+    }
+  }
 
-        if (pointEntity && entityNode->entity().model() == nullptr)
-        {
-          BuildColoredSolidBoundsVertices solidBoundsBuilder(
-            solidVertices, boundsColor(entityNode));
-          entityNode->logicalBounds().for_each_face(solidBoundsBuilder);
-        }
-        else
-        {
-          BuildColoredWireframeBoundsVertices pointEntityWireframeBoundsBuilder(
-            pointEntityWireframeVertices, boundsColor(entityNode));
-          BuildColoredWireframeBoundsVertices brushEntityWireframeBoundsBuilder(
-            brushEntityWireframeVertices, boundsColor(entityNode));
-
-          if (pointEntity)
-          {
-            entityNode->logicalBounds().for_each_edge(pointEntityWireframeBoundsBuilder);
-          }
-          else
-          {
-            entityNode->logicalBounds().for_each_edge(brushEntityWireframeBoundsBuilder);
-          }
-        }
-      }
+  const auto slot = m_freeBoundsSlots.back();
+  m_freeBoundsSlots.pop_back();
+  return slot;
+}
+
+void EntityRenderer::freeBoundsSlot(const size_t slot)
+{
+  writeBoundsSlot(*m_pointEntityWireframeBounds, slot, {});
+  writeBoundsSlot(*m_brushEntityWireframeBounds, slot, {});
+  writeBoundsSlot(*m_solidBounds, slot, {});
+  m_freeBoundsSlots.push_back(slot);
+}
+
+void EntityRenderer::writeBounds(const Model::EntityNode* entityNode, const size_t slot)
+{
+  auto pointEntityWireframeVertices = std::vector<WireframeVertex>{};
+  auto brushEntityWireframeVertices = std::vector<WireframeVertex>{};
+  auto solidVertices = std::vector<SolidVertex>{};
+
+  if (m_editorContext.visible(entityNode))
+  {
+    const auto& color = boundsColor(entityNode);
+    const auto pointEntity = !entityNode->hasChildren();
+    const auto solid = pointEntity && entityNode->entity().model() == nullptr;
+
+    if (solid)
+    {
+      auto solidBoundsBuilder = BuildColoredSolidBoundsVertices{solidVertices, color};
+      entityNode->logicalBounds().for_each_face(solidBoundsBuilder);
     }
 
-    m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines);
-    m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines);
+    // if the bounds color is overridden, solid bounds also get a wireframe
+    if (!solid || m_overrideBoundsColor)
+    {
+      auto wireframeBoundsBuilder = BuildColoredWireframeBoundsVertices{
+        pointEntity ? pointEntityWireframeVertices : brushEntityWireframeVertices, color};
+      entityNode->logicalBounds().for_each_edge(wireframeBoundsBuilder);
+    }
   }
 
-  m_solidBoundsRenderer =
-    TriangleRenderer(VertexArray::move(std::move(solidVertices)), PrimType::Quads);
-  m_boundsValid = true;
+  writeBoundsSlot(*m_pointEntityWireframeBounds, slot, pointEntityWireframeVertices);
+  writeBoundsSlot(*m_brushEntityWireframeBounds, slot, brushEntityWireframeVertices);
+  writeBoundsSlot(*m_solidBounds, slot, solidVertices);
 }
 
 AttrString EntityRenderer::entityString(const Model::EntityNode* entityNode) const
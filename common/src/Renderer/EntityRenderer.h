@@ -20,15 +20,19 @@
 #pragma once
 
 #include "Color.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/EntityModelRenderer.h"
+#include "Renderer/GLVertexType.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/TriangleRenderer.h"
 
-#include "kdl/vector_set.h"
-
 #include "vm/forward.h"
 
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -49,15 +53,30 @@ class EntityNode;
 namespace Renderer
 {
 class AttrString;
-
 class EntityRenderer
 {
 private:
   class EntityClassnameAnchor;
 
+  using WireframeVertex = GLVertexTypes::P3C4::Vertex;
+  using SolidVertex = GLVertexTypes::P3NC4::Vertex;
+
   Assets::EntityModelManager& m_entityModelManager;
   const Model::EditorContext& m_editorContext;
-  kdl::vector_set<const Model::EntityNode*> m_entities;
+
+  /**
+   * Maps each entity to the slot which holds its bounds geometry in the bounds vertex
+   * holders. Every slot has room for the wireframe and solid bounds of one entity, and
+   * the slots of removed entities are zeroed so that they render nothing until they are
+   * reused.
+   */
+  std::unordered_map<const Model::EntityNode*, size_t> m_entities;
+  std::vector<size_t> m_freeBoundsSlots;
+  std::unordered_set<const Model::EntityNode*> m_invalidBounds;
+
+  std::shared_ptr<VertexHolder<WireframeVertex>> m_pointEntityWireframeBounds;
+  std::shared_ptr<VertexHolder<WireframeVertex>> m_brushEntityWireframeBounds;
+  std::shared_ptr<VertexHolder<SolidVertex>> m_solidBounds;
 
   DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
   DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
@@ -105,6 +124,28 @@ public:
    * Removes an entity. Calling with an unknown entity is allowed, but ignored.
    */
   void removeEntity(const Model::EntityNode* entity);
+
+  template <typename I>
+  void addEntities(I cur, I end)
+  {
+    m_entities.reserve(m_entities.size() + size_t(std::distance(cur, end)));
+    while (cur != end)
+    {
+      addEntity(*cur);
+      ++cur;
+    }
+  }
+
+  template <typename I>
+  void removeEntities(I cur, I end)
+  {
+    while (cur != end)
+    {
+      removeEntity(*cur);
+      ++cur;
+    }
+  }
+
   /**
    * Causes cached renderer data to be rebuilt for the given entity (on the next render()
    * call).
@@ -145,10 +186,12 @@ private:
 
   struct BuildColoredSolidBoundsVertices;
   struct BuildColoredWireframeBoundsVertices;
-  struct BuildWireframeBoundsVertices;
 
   void invalidateBounds();
   void validateBounds();
+  size_t allocateBoundsSlot();
+  void freeBoundsSlot(size_t slot);
+  void writeBounds(const Model::EntityNode* entityNode, size_t slot);
 
   AttrString entityString(const Model::EntityNode* entityNode) const;
   const Color& boundsColor(const Model::EntityNode* entityNode) const;
@@ -32,44 +32,106 @@
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
 
+#include <optional>
+#include <string>
+
 namespace TrenchBroom
 {
 namespace Renderer
 {
+/**
+ * Sets up the per-texture state for each of the many draw calls issued by a face
+ * renderer. To keep the driver overhead per draw call low, uniforms are only set if their
+ * values change, and textures which only need to be bound are not unbound until the next
+ * texture is bound over them or until finish is called.
+ */
 struct FaceRenderer::RenderFunc : public TextureRenderFunc
 {
   ActiveShader& shader;
   bool applyTexture;
   const Color& defaultColor;
 
+  UniformHandle gridColorUniform;
+  UniformHandle enableMaskedUniform;
+  UniformHandle applyTextureUniform;
+  UniformHandle colorUniform;
+
+  std::optional<bool> currentApplyTexture;
+  std::optional<Color> currentColor;
+  std::optional<vm::vec3f> currentGridColor;
+  std::optional<bool> currentEnableMasked;
+  bool textureBound;
+
   RenderFunc(
     ActiveShader& i_shader, const bool i_applyTexture, const Color& i_defaultColor)
     : shader(i_shader)
     , applyTexture(i_applyTexture)
     , defaultColor(i_defaultColor)
+    , gridColorUniform(shader.uniform("GridColor"))
+    , enableMaskedUniform(shader.uniform("EnableMasked"))
+    , applyTextureUniform(shader.uniform("ApplyTexture"))
+    , colorUniform(shader.uniform("Color"))
+    , textureBound(false)
   {
   }
 
+  template <typename T>
+  void setUniform(
+    const UniformHandle uniform, std::optional<T>& currentValue, const T& value)
+  {
+    if (currentValue != value)
+    {
+      shader.set(uniform, value);
+      currentValue = value;
+    }
+  }
+
   void before(const Assets::Texture* texture) override
   {
+    // set any per-texture uniforms
+    setUniform(gridColorUniform, currentGridColor, gridColorForTexture(texture));
+    setUniform(
+      enableMaskedUniform, currentEnableMasked, texture != nullptr && texture->masked());
+
     if (texture != nullptr)
     {
-      texture->activate();
-      shader.set("ApplyTexture", applyTexture);
-      shader.set("Color", texture->averageColor());
+      if (texture->isPrepared())
+      {
+        texture->activate();
+        textureBound = true;
+      }
+      else
+      {
+        finish();
+      }
+      // until a texture is uploaded, its faces are rendered in its average color
+      setUniform(
+        applyTextureUniform, currentApplyTexture, applyTexture && texture->isPrepared());
+      setUniform(colorUniform, currentColor, texture->averageColor());
     }
     else
     {
-      shader.set("ApplyTexture", false);
-      shader.set("Color", defaultColor);
+      finish();
+      setUniform(applyTextureUniform, currentApplyTexture, false);
+      setUniform(colorUniform, currentColor, defaultColor);
     }
   }
 
   void after(const Assets::Texture* texture) override
   {
-    if (texture != nullptr)
+    if (texture != nullptr && texture->changesRenderState())
     {
       texture->deactivate();
+      textureBound = false;
+    }
+  }
+
+  void finish()
+  {
+    if (textureBound)
+    {
+      glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+      textureBound = false;
     }
   }
 };
@@ -78,6 +140,7 @@ FaceRenderer::FaceRenderer()
   : m_grayscale(false)
   , m_tint(false)
   , m_alpha(1.0f)
+  , m_renderPickIds(false)
 {
 }
 
@@ -91,6 +154,7 @@ FaceRenderer::FaceRenderer(
   , m_grayscale(false)
   , m_tint(false)
   , m_alpha(1.0f)
+  , m_renderPickIds(false)
 {
 }
 
@@ -98,11 +162,13 @@ FaceRenderer::FaceRenderer(const FaceRenderer& other)
   : IndexedRenderable(other)
   , m_vertexArray(other.m_vertexArray)
   , m_indexArrayMap(other.m_indexArrayMap)
+  , m_indexRangesMap(other.m_indexRangesMap)
   , m_faceColor(other.m_faceColor)
   , m_grayscale(other.m_grayscale)
   , m_tint(other.m_tint)
   , m_tintColor(other.m_tintColor)
   , m_alpha(other.m_alpha)
+  , m_renderPickIds(other.m_renderPickIds)
 {
 }
 
@@ -118,11 +184,13 @@ void swap(FaceRenderer& left, FaceRenderer& right)
   using std::swap;
   swap(left.m_vertexArray, right.m_vertexArray);
   swap(left.m_indexArrayMap, right.m_indexArrayMap);
+  swap(left.m_indexRangesMap, right.m_indexRangesMap);
   swap(left.m_faceColor, right.m_faceColor);
   swap(left.m_grayscale, right.m_grayscale);
   swap(left.m_tint, right.m_tint);
   swap(left.m_tintColor, right.m_tintColor);
   swap(left.m_alpha, right.m_alpha);
+  swap(left.m_renderPickIds, right.m_renderPickIds);
 }
 
 void FaceRenderer::setGrayscale(const bool grayscale)
@@ -145,11 +213,35 @@ void FaceRenderer::setAlpha(const float alpha)
   m_alpha = alpha;
 }
 
+void FaceRenderer::setRenderPickIds(const bool renderPickIds)
+{
+  m_renderPickIds = renderPickIds;
+}
+
+void FaceRenderer::setIndexRanges(
+  std::shared_ptr<TextureToBrushIndexRangesMap> indexRangesMap)
+{
+  m_indexRangesMap = std::move(indexRangesMap);
+}
+
 void FaceRenderer::render(RenderBatch& renderBatch)
 {
   renderBatch.add(this);
 }
 
+std::optional<RenderSortKey> FaceRenderer::sortKey() const
+{
+  // translucent faces must be rendered after everything behind them
+  if (m_renderPickIds || m_alpha < 1.0f)
+  {
+    return std::nullopt;
+  }
+
+  const auto* texture =
+    m_indexArrayMap->size() == 1 ? m_indexArrayMap->begin()->first : nullptr;
+  return RenderSortKey{&Shaders::FaceShader, texture, 0};
+}
+
 void FaceRenderer::prepareVerticesAndIndices(VboManager& vboManager)
 {
   m_vertexArray->prepare(vboManager);
@@ -165,6 +257,12 @@ void FaceRenderer::doRender(RenderContext& context)
   if (m_indexArrayMap->empty())
     return;
 
+  if (m_renderPickIds)
+  {
+    renderPickIds(context);
+    return;
+  }
+
   if (m_vertexArray->setupVertices())
   {
     ShaderManager& shaderManager = context.shaderManager();
@@ -181,7 +279,6 @@ void FaceRenderer::doRender(RenderContext& context)
     shader.set("RenderGrid", context.showGrid());
     shader.set("GridSize", static_cast<float>(context.gridSize()));
     shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
-    shader.set("ApplyTexture", applyTexture);
     shader.set("Texture", 0);
     shader.set("ApplyTinting", m_tint);
     if (m_tint)
@@ -191,7 +288,6 @@ void FaceRenderer::doRender(RenderContext& context)
     shader.set("ShadeFaces", shadeFaces);
     shader.set("ShowFog", showFog);
     shader.set("Alpha", m_alpha);
-    shader.set("EnableMasked", false);
     shader.set("ShowSoftMapBounds", !context.softMapBounds().is_empty());
     shader.set("SoftMapBoundsMin", context.softMapBounds().min);
     shader.set("SoftMapBoundsMax", context.softMapBounds().max);
@@ -208,30 +304,61 @@ void FaceRenderer::doRender(RenderContext& context)
     {
       glAssert(glDepthMask(GL_FALSE));
     }
-    for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap)
+    renderIndexArrays(func);
+    func.finish();
+
+    if (m_alpha < 1.0f)
+    {
+      glAssert(glDepthMask(GL_TRUE));
+    }
+    m_vertexArray->cleanupVertices();
+  }
+}
+
+void FaceRenderer::renderPickIds(RenderContext& context)
+{
+  if (m_vertexArray->setupVertices())
+  {
+    // the pick IDs are derived from the vertex indices, so there is no per-texture state
+    ActiveShader shader(context.shaderManager(), Shaders::PickIdShader);
+    auto func = TextureRenderFunc{};
+    renderIndexArrays(func);
+    m_vertexArray->cleanupVertices();
+  }
+}
+
+void FaceRenderer::renderIndexArrays(TextureRenderFunc& func)
+{
+  for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap)
+  {
+    if (!brushIndexHolderPtr->hasValidIndices())
+    {
+      continue;
+    }
+
+    const BrushIndexRanges* indexRanges = nullptr;
+    if (m_indexRangesMap)
     {
-      if (!brushIndexHolderPtr->hasValidIndices())
+      const auto it = m_indexRangesMap->find(texture);
+      if (it == m_indexRangesMap->end() || it->second.empty())
       {
         continue;
       }
+      indexRanges = &it->second;
+    }
 
-      const bool enableMasked = texture != nullptr && texture->masked();
-
-      // set any per-texture uniforms
-      shader.set("GridColor", gridColorForTexture(texture));
-      shader.set("EnableMasked", enableMasked);
-
-      func.before(texture);
-      brushIndexHolderPtr->setupIndices();
-      brushIndexHolderPtr->render(PrimType::Triangles);
-      brushIndexHolderPtr->cleanupIndices();
-      func.after(texture);
+    func.before(texture);
+    brushIndexHolderPtr->setupIndices();
+    if (indexRanges)
+    {
+      brushIndexHolderPtr->render(PrimType::Triangles, *indexRanges);
     }
-    if (m_alpha < 1.0f)
+    else
     {
-      glAssert(glDepthMask(GL_TRUE));
+      brushIndexHolderPtr->render(PrimType::Triangles);
     }
-    m_vertexArray->cleanupVertices();
+    brushIndexHolderPtr->cleanupIndices();
+    func.after(texture);
   }
 }
 } // namespace Renderer
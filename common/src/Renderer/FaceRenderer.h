@@ -26,6 +26,7 @@
 #include "vm/vec.h"
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 namespace TrenchBroom
@@ -38,8 +39,10 @@ class Texture;
 namespace Renderer
 {
 class BrushIndexArray;
+class BrushIndexRanges;
 class BrushVertexArray;
 class RenderBatch;
+class TextureRenderFunc;
 
 class FaceRenderer : public IndexedRenderable
 {
@@ -49,13 +52,20 @@ private:
   using TextureToBrushIndicesMap =
     const std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
 
+public:
+  using TextureToBrushIndexRangesMap =
+    const std::unordered_map<const Assets::Texture*, BrushIndexRanges>;
+
+private:
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
+  std::shared_ptr<TextureToBrushIndexRangesMap> m_indexRangesMap;
   Color m_faceColor;
   bool m_grayscale;
   bool m_tint;
   Color m_tintColor;
   float m_alpha;
+  bool m_renderPickIds;
 
 public:
   FaceRenderer();
@@ -73,11 +83,31 @@ public:
   void setTintColor(const Color& color);
   void setAlpha(float alpha);
 
+  /**
+   * Specifies whether the faces are rendered with the pick ID shader instead of their
+   * textures, writing the index of each vertex plus one into an integer render target.
+   *
+   * @see PickIdBuffer
+   */
+  void setRenderPickIds(bool renderPickIds);
+
+  /**
+   * Restricts rendering to the given index ranges per texture. Textures which are not
+   * contained in the given map are not rendered at all. If the given map is null, all
+   * indices are rendered.
+   */
+  void setIndexRanges(std::shared_ptr<TextureToBrushIndexRangesMap> indexRangesMap);
+
   void render(RenderBatch& renderBatch);
 
+  std::optional<RenderSortKey> sortKey() const override;
+
 private:
   void prepareVerticesAndIndices(VboManager& vboManager) override;
   void doRender(RenderContext& context) override;
+
+  void renderPickIds(RenderContext& context);
+  void renderIndexArrays(TextureRenderFunc& func);
 };
 
 void swap(FaceRenderer& left, FaceRenderer& right);
@@ -19,6 +19,8 @@
 
 #include "FontGlyph.h"
 
+#include "kdl/reflection_impl.h"
+
 #include "vm/forward.h"
 #include "vm/vec.h"
 
@@ -26,6 +28,9 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
+
+kdl_reflect_impl(FontGlyph);
+
 FontGlyph::FontGlyph(
   const size_t x, const size_t y, const size_t w, const size_t h, const size_t a)
   : m_x(static_cast<float>(x))
@@ -77,6 +82,26 @@ void FontGlyph::appendVertices(
   }
 }
 
+size_t FontGlyph::x() const
+{
+  return static_cast<size_t>(m_x);
+}
+
+size_t FontGlyph::y() const
+{
+  return static_cast<size_t>(m_y);
+}
+
+size_t FontGlyph::width() const
+{
+  return static_cast<size_t>(m_w);
+}
+
+size_t FontGlyph::height() const
+{
+  return static_cast<size_t>(m_h);
+}
+
 int FontGlyph::advance() const
 {
   return m_a;
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "kdl/reflection_decl.h"
+
 #include "vm/forward.h"
 
 #include <vector>
@@ -36,6 +38,8 @@ private:
   float m_h;
   int m_a;
 
+  kdl_reflect_decl(FontGlyph, m_x, m_y, m_w, m_h, m_a);
+
 public:
   FontGlyph(size_t x, size_t y, size_t w, size_t h, size_t a);
 
@@ -45,6 +49,10 @@ public:
     int yOffset,
     size_t textureSize,
     bool clockwise) const;
+  size_t x() const;
+  size_t y() const;
+  size_t width() const;
+  size_t height() const;
   int advance() const;
 };
 } // namespace Renderer
@@ -22,6 +22,7 @@
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/FreeTypeFontFactory.h"
 #include "Renderer/TextureFont.h"
+#include "StartupTimeline.h"
 
 #include <string>
 
@@ -46,6 +47,8 @@ TextureFont& FontManager::font(const FontDescriptor& fontDescriptor)
   auto it = m_cache.lower_bound(fontDescriptor);
   if (it == std::end(m_cache) || it->first.compare(fontDescriptor) != 0)
   {
+    const auto phase = StartupTimeline::instance().phase(
+      "Load font " + fontDescriptor.name() + " " + std::to_string(fontDescriptor.size()));
     it = m_cache.insert(
       it, std::make_pair(fontDescriptor, m_factory->createFont(fontDescriptor)));
   }
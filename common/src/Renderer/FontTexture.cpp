@@ -47,6 +47,15 @@ FontTexture::FontTexture(
   std::memset(m_buffer, 0, m_size * m_size);
 }
 
+FontTexture::FontTexture(const size_t size, const char* buffer)
+  : m_size(size)
+  , m_buffer(nullptr)
+  , m_textureId(0)
+{
+  m_buffer = new char[m_size * m_size];
+  std::memcpy(m_buffer, buffer, m_size * m_size);
+}
+
 FontTexture::FontTexture(const FontTexture& other)
   : m_size(other.m_size)
   , m_buffer(nullptr)
@@ -82,6 +91,11 @@ size_t FontTexture::size() const
   return m_size;
 }
 
+const char* FontTexture::buffer() const
+{
+  return m_buffer;
+}
+
 void FontTexture::activate()
 {
   if (m_textureId == 0)
@@ -116,6 +130,21 @@ void FontTexture::deactivate()
   glAssert(glBindTexture(GL_TEXTURE_2D, 0));
 }
 
+bool operator==(const FontTexture& lhs, const FontTexture& rhs)
+{
+  if (lhs.m_size != rhs.m_size || (lhs.m_buffer == nullptr) != (rhs.m_buffer == nullptr))
+  {
+    return false;
+  }
+  return lhs.m_buffer == nullptr
+         || std::memcmp(lhs.m_buffer, rhs.m_buffer, lhs.m_size * lhs.m_size) == 0;
+}
+
+bool operator!=(const FontTexture& lhs, const FontTexture& rhs)
+{
+  return !(lhs == rhs);
+}
+
 size_t FontTexture::computeTextureSize(
   const size_t cellCount, const size_t cellSize, const size_t margin) const
 {
@@ -39,15 +39,31 @@ private:
 public:
   FontTexture();
   FontTexture(size_t cellCount, size_t cellSize, size_t margin);
+  /**
+   * Creates a texture of the given size with a copy of the given pixel data, which must
+   * contain size * size bytes.
+   */
+  FontTexture(size_t size, const char* buffer);
   FontTexture(const FontTexture& other);
   FontTexture& operator=(FontTexture other);
   ~FontTexture();
 
   size_t size() const;
 
+  /**
+   * Returns the pixel data of this texture, or null if it was already uploaded.
+   */
+  const char* buffer() const;
+
   void activate();
   void deactivate();
 
+  /**
+   * Compares the sizes and the pixel data of the given textures.
+   */
+  friend bool operator==(const FontTexture& lhs, const FontTexture& rhs);
+  friend bool operator!=(const FontTexture& lhs, const FontTexture& rhs);
+
 private:
   size_t computeTextureSize(size_t cellCount, size_t cellSize, size_t margin) const;
 };
@@ -21,11 +21,16 @@
 
 #include "Error.h"
 #include "Exceptions.h"
+#include "IO/CacheIO.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h" // IWYU pragma: keep
+#include "IO/FontCache.h"
+#include "IO/PathInfo.h"
 #include "IO/Reader.h"
 #include "IO/SystemPaths.h"
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/FontGlyph.h"
 #include "Renderer/FontGlyphBuilder.h"
@@ -147,8 +152,38 @@ std::unique_ptr<TextureFont> FreeTypeFontFactory::doCreateFont(
   const FontDescriptor& fontDescriptor)
 {
   auto [face, bufferedReader] = loadFont(*m_library, fontDescriptor);
+
+  if (!pref(Preferences::UseFontCache))
+  {
+    return buildFont(*face, fontDescriptor.minChar(), fontDescriptor.charCount());
+  }
+
+  const auto cacheDirectory = IO::SystemPaths::userDataDirectory() / "FontCache";
+  const auto cachePath = IO::fontCachePath(cacheDirectory, fontDescriptor);
+  const auto cacheKey = IO::fontCacheKey(bufferedReader.stringView(), fontDescriptor);
+  if (IO::Disk::pathInfo(cachePath) == IO::PathInfo::File)
+  {
+    if (
+      auto cachedFont =
+        IO::Disk::mapFile(cachePath)
+          .and_then([&](auto cacheFile) {
+            return IO::readFontCache(cacheFile->reader(), cacheKey);
+          })
+          .transform_error([](auto) { return std::unique_ptr<TextureFont>{}; })
+          .value())
+    {
+      return cachedFont;
+    }
+  }
+
   auto font = buildFont(*face, fontDescriptor.minChar(), fontDescriptor.charCount());
 
+  IO::writeCacheFile(
+    cachePath, [&](auto& stream) { IO::writeFontCache(*font, cacheKey, stream); })
+    .transform_error([](auto) {
+      // a font that cannot be cached is still usable
+    });
+
   // NOTE: bufferedReader is returned from loadFont() just to keep the buffer from
   // being deallocated until after we call FT_Done_Face
   unused(bufferedReader);
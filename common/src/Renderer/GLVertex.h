@@ -20,6 +20,7 @@
 #pragma once
 
 #include <cstddef>
+#include <ostream>
 #include <vector>
 
 namespace TrenchBroom
@@ -140,6 +141,38 @@ struct GLVertex<AttrType, AttrTypeRest...>
     }
     return result;
   }
+
+  friend bool operator==(
+    const GLVertex<AttrType, AttrTypeRest...>& lhs,
+    const GLVertex<AttrType, AttrTypeRest...>& rhs)
+  {
+    return lhs.attr == rhs.attr && lhs.rest == rhs.rest;
+  }
+
+  friend bool operator!=(
+    const GLVertex<AttrType, AttrTypeRest...>& lhs,
+    const GLVertex<AttrType, AttrTypeRest...>& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  /**
+   * Prints the attribute values of this vertex, separated by commas.
+   */
+  void printAttributes(std::ostream& str) const
+  {
+    str << attr << ", ";
+    rest.printAttributes(str);
+  }
+
+  friend std::ostream& operator<<(
+    std::ostream& lhs, const GLVertex<AttrType, AttrTypeRest...>& rhs)
+  {
+    lhs << "GLVertex{";
+    rhs.printAttributes(lhs);
+    lhs << "}";
+    return lhs;
+  }
 };
 
 /**
@@ -213,6 +246,29 @@ struct GLVertex<AttrType>
     }
     return result;
   }
+
+  friend bool operator==(const GLVertex<AttrType>& lhs, const GLVertex<AttrType>& rhs)
+  {
+    return lhs.attr == rhs.attr;
+  }
+
+  friend bool operator!=(const GLVertex<AttrType>& lhs, const GLVertex<AttrType>& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  /**
+   * Prints the attribute value of this vertex.
+   */
+  void printAttributes(std::ostream& str) const { str << attr; }
+
+  friend std::ostream& operator<<(std::ostream& lhs, const GLVertex<AttrType>& rhs)
+  {
+    lhs << "GLVertex{";
+    rhs.printAttributes(lhs);
+    lhs << "}";
+    return lhs;
+  }
 };
 
 /**
@@ -122,6 +122,10 @@ public:
 /**
  * Vertex normal attribute types.
  *
+ * Integer component types are normalized to [-1..1] by OpenGL. Packed normals may use
+ * four components, in which case the last component is only padding that keeps the
+ * following attributes aligned and is ignored.
+ *
  * @tparam D the vertex component type
  * @tparam S the number of components
  */
@@ -139,7 +143,7 @@ public:
     const size_t stride,
     const size_t offset)
   {
-    assert(S == 3);
+    static_assert(S == 3 || S == 4, "normals must have three or four components");
     glAssert(glEnableClientState(GL_NORMAL_ARRAY));
     glAssert(glNormalPointer(
       D, static_cast<GLsizei>(stride), reinterpret_cast<GLvoid*>(offset)));
@@ -238,6 +242,7 @@ namespace GLVertexAttributeTypes
 using P2 = GLVertexAttributePosition<GL_FLOAT, 2>;
 using P3 = GLVertexAttributePosition<GL_FLOAT, 3>;
 using N = GLVertexAttributeNormal<GL_FLOAT, 3>;
+using NB = GLVertexAttributeNormal<GL_BYTE, 4>;
 using T02 = GLVertexAttributeTexCoord0<GL_FLOAT, 2>;
 using C4 = GLVertexAttributeColor<GL_FLOAT, 4>;
 } // namespace GLVertexAttributeTypes
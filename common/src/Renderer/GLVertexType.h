@@ -198,6 +198,10 @@ using P3NT2 = GLVertexType<
   GLVertexAttributeTypes::P3,
   GLVertexAttributeTypes::N,
   GLVertexAttributeTypes::T02>;
+using P3NBT2 = GLVertexType<
+  GLVertexAttributeTypes::P3,
+  GLVertexAttributeTypes::NB,
+  GLVertexAttributeTypes::T02>;
 } // namespace GLVertexTypes
 } // namespace Renderer
 } // namespace TrenchBroom
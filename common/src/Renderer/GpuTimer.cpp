@@ -0,0 +1,212 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GpuTimer.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+GpuTimer::GpuTimer()
+  : m_supported{supported()}
+  , m_currentFrame{0}
+  , m_inFrame{false}
+{
+}
+
+GpuTimer::~GpuTimer()
+{
+  for (auto& frame : m_frames)
+  {
+    if (!frame.queries.empty())
+    {
+      glAssert(glDeleteQueries(
+        static_cast<GLsizei>(frame.queries.size()), frame.queries.data()));
+    }
+  }
+}
+
+bool GpuTimer::supported()
+{
+  return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
+
+void GpuTimer::beginFrame()
+{
+  if (!m_supported)
+  {
+    return;
+  }
+
+  m_currentFrame = (m_currentFrame + 1) % FramesInFlight;
+
+  auto& frame = m_frames[m_currentFrame];
+  collect(frame);
+  frame.names.clear();
+
+  m_inFrame = true;
+}
+
+void GpuTimer::mark(const std::string& name)
+{
+  if (m_inFrame)
+  {
+    issueQuery(m_frames[m_currentFrame], name);
+  }
+}
+
+void GpuTimer::endFrame()
+{
+  if (m_inFrame)
+  {
+    issueQuery(m_frames[m_currentFrame], "");
+    m_inFrame = false;
+  }
+}
+
+std::vector<GpuTimer::Timing> GpuTimer::timings() const
+{
+  auto result = std::vector<Timing>{};
+  result.reserve(m_sectionOrder.size());
+
+  for (const auto& name : m_sectionOrder)
+  {
+    const auto& samples = m_samples.at(name);
+    const auto last = samples.values[(samples.next + AverageWindow - 1) % AverageWindow];
+    const auto sum = std::accumulate(
+      samples.values.begin(),
+      std::next(samples.values.begin(), static_cast<std::ptrdiff_t>(samples.count)),
+      0.0);
+    result.push_back(
+      Timing{name, last, sum / static_cast<double>(samples.count), samples.count});
+  }
+
+  return result;
+}
+
+std::string GpuTimer::summary() const
+{
+  auto str = std::stringstream{};
+  str << std::fixed << std::setprecision(2) << "GPU:";
+
+  auto total = 0.0;
+  for (const auto& timing : timings())
+  {
+    str << " " << timing.name << " " << timing.averageMs << "ms";
+    total += timing.averageMs;
+  }
+  str << " Total " << total << "ms";
+
+  return str.str();
+}
+
+std::string GpuTimer::csv() const
+{
+  auto str = std::stringstream{};
+  str << std::fixed << std::setprecision(4) << "pass,last_ms,average_ms,samples\n";
+  for (const auto& timing : timings())
+  {
+    str << timing.name << "," << timing.lastMs << "," << timing.averageMs << ","
+        << timing.samples << "\n";
+  }
+  return str.str();
+}
+
+void GpuTimer::issueQuery(Frame& frame, const std::string& name)
+{
+  const auto index = frame.names.size();
+  if (index == frame.queries.size())
+  {
+    auto query = GLuint(0);
+    glAssert(glGenQueries(1, &query));
+    frame.queries.push_back(query);
+  }
+
+  glAssert(glQueryCounter(frame.queries[index], GL_TIMESTAMP));
+  frame.names.push_back(name);
+}
+
+void GpuTimer::collect(Frame& frame)
+{
+  const auto count = frame.names.size();
+  if (count < 2)
+  {
+    return;
+  }
+
+  // the queries complete in order, so if the last one is available, all of them are;
+  // otherwise, the frame's results are dropped rather than waiting for them
+  auto available = GLint(0);
+  glAssert(
+    glGetQueryObjectiv(frame.queries[count - 1], GL_QUERY_RESULT_AVAILABLE, &available));
+  if (available == 0)
+  {
+    return;
+  }
+
+  auto timestamps = std::vector<GLuint64>(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    glAssert(glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &timestamps[i]));
+  }
+
+  // sum up the sections with the same name, keeping the order of their first occurrence
+  auto names = std::vector<std::string>{};
+  auto totals = std::unordered_map<std::string, double>{};
+  for (size_t i = 0; i + 1 < count; ++i)
+  {
+    const auto& name = frame.names[i];
+    const auto ms = static_cast<double>(timestamps[i + 1] - timestamps[i]) / 1000000.0;
+    if (const auto [it, inserted] = totals.emplace(name, ms); !inserted)
+    {
+      it->second += ms;
+    }
+    else
+    {
+      names.push_back(name);
+    }
+  }
+
+  for (const auto& name : names)
+  {
+    addSample(name, totals[name]);
+  }
+}
+
+void GpuTimer::addSample(const std::string& name, const double ms)
+{
+  auto it = m_samples.find(name);
+  if (it == m_samples.end())
+  {
+    it = m_samples.emplace(name, Samples{}).first;
+    m_sectionOrder.push_back(name);
+  }
+
+  auto& samples = it->second;
+  samples.values[samples.next] = ms;
+  samples.next = (samples.next + 1) % AverageWindow;
+  samples.count = std::min(samples.count + 1, AverageWindow);
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "Renderer/GL.h"
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+/**
+ * Measures the GPU time spent in consecutive, named sections of a frame using timestamp
+ * queries. A section lasts from its marker until the next marker or the end of the
+ * frame. Sections with the same name are summed up per frame.
+ *
+ * Query results are read a few frames later so that reading them never stalls the
+ * pipeline. Requires ARB_timer_query; if it is not supported, the timer does nothing.
+ *
+ * Query objects are not shared between OpenGL contexts, so the timer must only be used
+ * while the context in which it was created is current.
+ */
+class GpuTimer
+{
+public:
+  struct Timing
+  {
+    std::string name;
+    double lastMs;
+    double averageMs;
+    size_t samples;
+  };
+
+  static constexpr size_t FramesInFlight = 3;
+  static constexpr size_t AverageWindow = 60;
+
+private:
+  struct Frame
+  {
+    std::vector<GLuint> queries;
+    std::vector<std::string> names;
+  };
+
+  struct Samples
+  {
+    std::array<double, AverageWindow> values{};
+    size_t count = 0;
+    size_t next = 0;
+  };
+
+  bool m_supported;
+  std::array<Frame, FramesInFlight> m_frames;
+  size_t m_currentFrame;
+  bool m_inFrame;
+
+  std::vector<std::string> m_sectionOrder;
+  std::unordered_map<std::string, Samples> m_samples;
+
+public:
+  GpuTimer();
+  ~GpuTimer();
+
+  deleteCopyAndMove(GpuTimer);
+
+  /**
+   * Returns whether the current context supports timer queries.
+   */
+  static bool supported();
+
+  /**
+   * Collects the results of the oldest frame in flight and starts a new frame.
+   */
+  void beginFrame();
+
+  /**
+   * Ends the current section and begins a new section with the given name. Does nothing
+   * unless a frame was begun.
+   */
+  void mark(const std::string& name);
+
+  /**
+   * Ends the current section and the frame.
+   */
+  void endFrame();
+
+  /**
+   * Returns the timings of all sections in the order in which they were first seen.
+   */
+  std::vector<Timing> timings() const;
+
+  /**
+   * Formats the average timings as a single line for display in an overlay.
+   */
+  std::string summary() const;
+
+  /**
+   * Formats the timings as CSV with a header row.
+   */
+  std::string csv() const;
+
+private:
+  void issueQuery(Frame& frame, const std::string& name);
+  void collect(Frame& frame);
+  void addSample(const std::string& name, double ms);
+};
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -36,13 +36,17 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
-GridRenderer::GridRenderer(const OrthographicCamera& camera, const vm::bbox3& worldBounds)
-  : m_vertexArray(VertexArray::move(vertices(camera, worldBounds)))
+GridRenderer::GridRenderer()
+  : m_vertexArray{VertexArray::move(std::vector<Vertex>{
+    Vertex{vm::vec2f{0.0f, 0.0f}},
+    Vertex{vm::vec2f{0.0f, 1.0f}},
+    Vertex{vm::vec2f{1.0f, 1.0f}},
+    Vertex{vm::vec2f{1.0f, 0.0f}},
+  })}
 {
 }
 
-std::vector<GridRenderer::Vertex> GridRenderer::vertices(
-  const OrthographicCamera& camera, const vm::bbox3& worldBounds)
+void GridRenderer::update(const OrthographicCamera& camera, const vm::bbox3& worldBounds)
 {
   const auto& viewport = camera.zoomedViewport();
   const auto w = float(viewport.width) / 2.0f;
@@ -52,26 +56,23 @@ std::vector<GridRenderer::Vertex> GridRenderer::vertices(
   switch (vm::find_abs_max_component(camera.direction()))
   {
   case vm::axis::x:
-    return {
-      Vertex(vm::vec3f(float(worldBounds.min.x()), p.y() - w, p.z() - h)),
-      Vertex(vm::vec3f(float(worldBounds.min.x()), p.y() - w, p.z() + h)),
-      Vertex(vm::vec3f(float(worldBounds.min.x()), p.y() + w, p.z() + h)),
-      Vertex(vm::vec3f(float(worldBounds.min.x()), p.y() + w, p.z() - h))};
+    m_origin = vm::vec3f{float(worldBounds.min.x()), p.y() - w, p.z() - h};
+    m_axisU = vm::vec3f{0.0f, 2.0f * w, 0.0f};
+    m_axisV = vm::vec3f{0.0f, 0.0f, 2.0f * h};
+    break;
   case vm::axis::y:
-    return {
-      Vertex(vm::vec3f(p.x() - w, float(worldBounds.max.y()), p.z() - h)),
-      Vertex(vm::vec3f(p.x() - w, float(worldBounds.max.y()), p.z() + h)),
-      Vertex(vm::vec3f(p.x() + w, float(worldBounds.max.y()), p.z() + h)),
-      Vertex(vm::vec3f(p.x() + w, float(worldBounds.max.y()), p.z() - h))};
+    m_origin = vm::vec3f{p.x() - w, float(worldBounds.max.y()), p.z() - h};
+    m_axisU = vm::vec3f{2.0f * w, 0.0f, 0.0f};
+    m_axisV = vm::vec3f{0.0f, 0.0f, 2.0f * h};
+    break;
   case vm::axis::z:
-    return {
-      Vertex(vm::vec3f(p.x() - w, p.y() - h, float(worldBounds.min.z()))),
-      Vertex(vm::vec3f(p.x() - w, p.y() + h, float(worldBounds.min.z()))),
-      Vertex(vm::vec3f(p.x() + w, p.y() + h, float(worldBounds.min.z()))),
-      Vertex(vm::vec3f(p.x() + w, p.y() - h, float(worldBounds.min.z())))};
+    m_origin = vm::vec3f{p.x() - w, p.y() - h, float(worldBounds.min.z())};
+    m_axisU = vm::vec3f{2.0f * w, 0.0f, 0.0f};
+    m_axisV = vm::vec3f{0.0f, 2.0f * h, 0.0f};
+    break;
   default:
     // Should not happen.
-    return {};
+    break;
   }
 }
 
@@ -93,6 +94,9 @@ void GridRenderer::doRender(RenderContext& renderContext)
     shader.set("GridAlpha", pref(Preferences::GridAlpha));
     shader.set("GridColor", pref(Preferences::GridColor2D));
     shader.set("CameraZoom", camera.zoom());
+    shader.set("GridOrigin", m_origin);
+    shader.set("GridAxisU", m_axisU);
+    shader.set("GridAxisV", m_axisV);
 
     m_vertexArray.render(PrimType::Quads);
   }
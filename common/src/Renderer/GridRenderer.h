@@ -24,7 +24,7 @@
 #include "Renderer/Renderable.h"
 #include "Renderer/VertexArray.h"
 
-#include <vector>
+#include "vm/vec.h"
 
 namespace TrenchBroom
 {
@@ -34,19 +34,32 @@ class OrthographicCamera;
 class RenderContext;
 class VboManager;
 
+/**
+ * Renders the grid of a 2D view. The grid lines are computed in the fragment shader, so
+ * the renderer only draws a single quad that covers the visible area. The quad's vertices
+ * are the corners of a unit square which the vertex shader maps onto the visible area, so
+ * the vertex buffer is uploaded once and reused when the camera changes.
+ */
 class GridRenderer : public DirectRenderable
 {
 private:
-  using Vertex = GLVertexTypes::P3::Vertex;
+  using Vertex = GLVertexTypes::P2::Vertex;
   VertexArray m_vertexArray;
 
+  vm::vec3f m_origin;
+  vm::vec3f m_axisU;
+  vm::vec3f m_axisV;
+
 public:
-  GridRenderer(const OrthographicCamera& camera, const vm::bbox3& worldBounds);
+  GridRenderer();
 
-private:
-  static std::vector<Vertex> vertices(
-    const OrthographicCamera& camera, const vm::bbox3& worldBounds);
+  /**
+   * Fits the quad to the visible area of the given camera and places it at the far side
+   * of the given world bounds.
+   */
+  void update(const OrthographicCamera& camera, const vm::bbox3& worldBounds);
 
+private:
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
 };
@@ -45,37 +45,64 @@ static vm::vec3f getLinkAnchorPosition(const Model::GroupNode& groupNode)
   return vm::vec3f(groupNode.logicalBounds().center());
 }
 
+static const Model::GroupNode* getLinkSourceGroupNode(View::MapDocument& document)
+{
+  const auto selectedGroupNodes = document.selectedNodes().groups();
+  return selectedGroupNodes.size() == 1 ? selectedGroupNodes.front()
+                                        : document.editorContext().currentGroup();
+}
+
 std::vector<LinkRenderer::LineVertex> GroupLinkRenderer::getLinks()
 {
   auto document = kdl::mem_lock(m_document);
   auto links = std::vector<LineVertex>{};
 
-  const auto selectedGroupNodes = document->selectedNodes().groups();
-
-  const auto& editorContext = document->editorContext();
-  const auto* groupNode = selectedGroupNodes.size() == 1 ? selectedGroupNodes.front()
-                                                         : editorContext.currentGroup();
+  m_groupNode = getLinkSourceGroupNode(*document);
+  m_linkedGroupNodes.clear();
 
-  if (groupNode)
+  if (m_groupNode)
   {
-    const auto& linkId = groupNode->linkId();
+    const auto& linkId = m_groupNode->linkId();
     const auto linkedGroupNodes =
       Model::collectGroupsWithLinkId({document->world()}, linkId);
 
     const auto linkColor = pref(Preferences::LinkedGroupColor);
-    const auto sourcePosition = getLinkAnchorPosition(*groupNode);
+    const auto sourcePosition = getLinkAnchorPosition(*m_groupNode);
     for (const auto* linkedGroupNode : linkedGroupNodes)
     {
-      if (linkedGroupNode != groupNode && editorContext.visible(linkedGroupNode))
+      // visibility is checked in getVisibleLinks since it depends on the selection
+      if (linkedGroupNode != m_groupNode)
       {
         const auto targetPosition = getLinkAnchorPosition(*linkedGroupNode);
         links.emplace_back(sourcePosition, linkColor);
         links.emplace_back(targetPosition, linkColor);
+        m_linkedGroupNodes.push_back(linkedGroupNode);
       }
     }
   }
 
   return links;
 }
+
+bool GroupLinkRenderer::linksDependOnSelection()
+{
+  return getLinkSourceGroupNode(*kdl::mem_lock(m_document)) != m_groupNode;
+}
+
+std::optional<std::vector<size_t>> GroupLinkRenderer::getVisibleLinks()
+{
+  auto document = kdl::mem_lock(m_document);
+  const auto& editorContext = document->editorContext();
+
+  auto visibleLinks = std::vector<size_t>{};
+  for (size_t i = 0; i < m_linkedGroupNodes.size(); ++i)
+  {
+    if (editorContext.visible(m_linkedGroupNodes[i]))
+    {
+      visibleLinks.push_back(i);
+    }
+  }
+  return visibleLinks;
+}
 } // namespace Renderer
 } // namespace TrenchBroom
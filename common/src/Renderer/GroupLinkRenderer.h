@@ -23,10 +23,16 @@
 #include "Renderer/LinkRenderer.h"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom
 {
+namespace Model
+{
+class GroupNode;
+}
+
 namespace View
 {
 class MapDocument; // FIXME: Renderer should not depend on View
@@ -38,11 +44,17 @@ class GroupLinkRenderer : public LinkRenderer
 {
   std::weak_ptr<View::MapDocument> m_document;
 
+  // the group whose links are shown, and the groups it is linked to
+  const Model::GroupNode* m_groupNode = nullptr;
+  std::vector<const Model::GroupNode*> m_linkedGroupNodes;
+
 public:
   GroupLinkRenderer(std::weak_ptr<View::MapDocument> document);
 
 private:
   std::vector<LinkRenderer::LineVertex> getLinks() override;
+  bool linksDependOnSelection() override;
+  std::optional<std::vector<size_t>> getVisibleLinks() override;
 
   deleteCopy(GroupLinkRenderer);
 };
@@ -55,11 +55,11 @@ bool IndexArray::prepared() const
   return m_prepared;
 }
 
-void IndexArray::prepare(VboManager& vboManager)
+void IndexArray::prepare(VboManager& vboManager, const VboUsage usage)
 {
   if (!prepared() && !empty())
   {
-    m_holder->prepare(vboManager);
+    m_holder->prepare(vboManager, usage);
   }
   m_prepared = true;
 }
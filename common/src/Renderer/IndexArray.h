@@ -54,7 +54,7 @@ private:
     virtual size_t indexCount() const = 0;
     virtual size_t sizeInBytes() const = 0;
 
-    virtual void prepare(VboManager& vboManager) = 0;
+    virtual void prepare(VboManager& vboManager, VboUsage usage) = 0;
     virtual void setup() = 0;
     virtual void cleanup() = 0;
 
@@ -81,12 +81,13 @@ private:
 
     size_t sizeInBytes() const override { return sizeof(Index) * m_indexCount; }
 
-    virtual void prepare(VboManager& vboManager) override
+    virtual void prepare(VboManager& vboManager, const VboUsage usage) override
     {
       if (m_indexCount > 0 && m_vbo == nullptr)
       {
         m_vboManager = &vboManager;
-        m_vbo = vboManager.allocateVbo(VboType::ElementArrayBuffer, sizeInBytes());
+        m_vbo =
+          vboManager.allocateVbo(VboType::ElementArrayBuffer, sizeInBytes(), usage);
         m_vbo->writeBuffer(0, doGetIndices());
       }
     }
@@ -125,7 +126,7 @@ private:
         toGL(primType),
         static_cast<GLsizei>(count),
         GL_UNSIGNED_INT,
-        reinterpret_cast<void*>(offset * 4u)));
+        reinterpret_cast<void*>(m_vbo->offset() + offset * 4u)));
     }
 
   private:
@@ -148,9 +149,9 @@ private:
     {
     }
 
-    void prepare(VboManager& vboManager)
+    void prepare(VboManager& vboManager, const VboUsage usage)
     {
-      Holder<Index>::prepare(vboManager);
+      Holder<Index>::prepare(vboManager, usage);
       kdl::vec_clear_to_zero(m_indices);
     }
 
@@ -270,8 +271,10 @@ public:
    *
    * @param vboManager the vertex buffer object to upload the contents of this index array
    * into
+   * @param usage the usage of the vertex buffer object, use stream usage if this index
+   * array is discarded after it was rendered once
    */
-  void prepare(VboManager& vboManager);
+  void prepare(VboManager& vboManager, VboUsage usage = VboUsage::StaticDraw);
 
   /**
    * Sets this index array up for rendering. If this index array is only rendered once,
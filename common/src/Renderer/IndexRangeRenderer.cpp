@@ -32,9 +32,9 @@ IndexRangeRenderer::IndexRangeRenderer(
 {
 }
 
-void IndexRangeRenderer::prepare(VboManager& vboManager)
+void IndexRangeRenderer::prepare(VboManager& vboManager, const VboUsage usage)
 {
-  m_vertexArray.prepare(vboManager);
+  m_vertexArray.prepare(vboManager, usage);
 }
 
 void IndexRangeRenderer::render()
@@ -46,7 +46,7 @@ public:
 
   IndexRangeRenderer(const VertexArray& vertexArray, const IndexRangeMap& indexArray);
 
-  void prepare(VboManager& vboManager);
+  void prepare(VboManager& vboManager, VboUsage usage = VboUsage::StaticDraw);
   void render();
 };
 } // namespace Renderer
@@ -42,15 +42,24 @@ void LinkRenderer::invalidate()
   m_valid = false;
 }
 
+void LinkRenderer::invalidateSelection()
+{
+  m_selectionValid = false;
+}
+
 void LinkRenderer::doPrepareVertices(VboManager& vboManager)
 {
-  if (!m_valid)
+  if (!m_valid || (!m_selectionValid && linksDependOnSelection()))
   {
     validate();
 
     m_lines.prepare(vboManager);
     m_arrows.prepare(vboManager);
   }
+  else if (!m_selectionValid)
+  {
+    validateVisibleLinks();
+  }
 }
 
 void LinkRenderer::doRender(RenderContext& renderContext)
@@ -69,11 +78,11 @@ void LinkRenderer::renderLines(RenderContext& renderContext)
 
   glAssert(glDisable(GL_DEPTH_TEST));
   shader.set("Alpha", 0.4f);
-  m_lines.render(PrimType::Lines);
+  m_lineRanges.render(m_lines);
 
   glAssert(glEnable(GL_DEPTH_TEST));
   shader.set("Alpha", 1.0f);
-  m_lines.render(PrimType::Lines);
+  m_lineRanges.render(m_lines);
 }
 
 void LinkRenderer::renderArrows(RenderContext& renderContext)
@@ -86,11 +95,11 @@ void LinkRenderer::renderArrows(RenderContext& renderContext)
 
   glAssert(glDisable(GL_DEPTH_TEST));
   shader.set("Alpha", 0.4f);
-  m_arrows.render(PrimType::Lines);
+  m_arrowRanges.render(m_arrows);
 
   glAssert(glEnable(GL_DEPTH_TEST));
   shader.set("Alpha", 1.0f);
-  m_arrows.render(PrimType::Lines);
+  m_arrowRanges.render(m_arrows);
 }
 
 static void addArrow(
@@ -107,12 +116,16 @@ static void addArrow(
 }
 
 static std::vector<LinkRenderer::ArrowVertex> getArrows(
-  const std::vector<LinkRenderer::LineVertex>& links)
+  const std::vector<LinkRenderer::LineVertex>& links, std::vector<size_t>& arrowOffsets)
 {
   assert((links.size() % 2) == 0);
   auto arrows = std::vector<LinkRenderer::ArrowVertex>{};
+  arrowOffsets.clear();
+  arrowOffsets.reserve(links.size() / 2 + 1);
   for (size_t i = 0; i < links.size(); i += 2)
   {
+    arrowOffsets.push_back(arrows.size());
+
     const auto& startVertex = links[i];
     const auto& endVertex = links[i + 1];
 
@@ -146,18 +159,67 @@ static std::vector<LinkRenderer::ArrowVertex> getArrows(
       addArrow(arrows, color, arrowPosition3, lineDir);
     }
   }
+  arrowOffsets.push_back(arrows.size());
   return arrows;
 }
 
 void LinkRenderer::validate()
 {
   auto links = getLinks();
-  auto arrows = getArrows(links);
+  auto arrows = getArrows(links, m_arrowOffsets);
 
   m_lines = VertexArray::move(std::move(links));
   m_arrows = VertexArray::move(std::move(arrows));
 
   m_valid = true;
+  validateVisibleLinks();
+}
+
+void LinkRenderer::validateVisibleLinks()
+{
+  const auto linkCount = m_arrowOffsets.size() - 1;
+  const auto visibleLinks = getVisibleLinks();
+  if (!visibleLinks)
+  {
+    m_lineRanges = IndexRangeMap{PrimType::Lines, 0, 2 * linkCount};
+    m_arrowRanges = IndexRangeMap{PrimType::Lines, 0, m_arrowOffsets.back()};
+  }
+  else
+  {
+    m_lineRanges = IndexRangeMap{};
+    m_arrowRanges = IndexRangeMap{};
+
+    // merge runs of consecutive links into one range
+    auto it = visibleLinks->begin();
+    while (it != visibleLinks->end())
+    {
+      const auto first = *it;
+      auto last = first + 1;
+      while (++it != visibleLinks->end() && *it == last)
+      {
+        ++last;
+      }
+
+      assert(last <= linkCount);
+      m_lineRanges.add(PrimType::Lines, 2 * first, 2 * (last - first));
+      m_arrowRanges.add(
+        PrimType::Lines,
+        m_arrowOffsets[first],
+        m_arrowOffsets[last] - m_arrowOffsets[first]);
+    }
+  }
+
+  m_selectionValid = true;
+}
+
+bool LinkRenderer::linksDependOnSelection()
+{
+  return true;
+}
+
+std::optional<std::vector<size_t>> LinkRenderer::getVisibleLinks()
+{
+  return std::nullopt;
 }
 
 } // namespace TrenchBroom::Renderer
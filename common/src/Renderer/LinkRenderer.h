@@ -21,9 +21,13 @@
 
 #include "Renderer/GLVertex.h"
 #include "Renderer/GLVertexType.h"
+#include "Renderer/IndexRangeMap.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/VertexArray.h"
 
+#include <optional>
+#include <vector>
+
 namespace TrenchBroom::Renderer
 {
 class RenderContext;
@@ -54,8 +58,15 @@ public:
 private:
   VertexArray m_lines;
   VertexArray m_arrows;
+  // the offsets of the arrow vertices of each link, followed by the number of arrow
+  // vertices
+  std::vector<size_t> m_arrowOffsets;
+
+  IndexRangeMap m_lineRanges;
+  IndexRangeMap m_arrowRanges;
 
   bool m_valid = false;
+  bool m_selectionValid = false;
 
 public:
   LinkRenderer();
@@ -63,6 +74,19 @@ public:
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
   void invalidate();
 
+  /**
+   * Invalidates this renderer after the selection changed. The links are only generated
+   * again if they depend on the selection. Otherwise, only the ranges of the links to
+   * render are updated, and the vertices which were already uploaded are kept.
+   */
+  void invalidateSelection();
+
+  /**
+   * Generates the vertices of the links. This is called when the renderer is prepared for
+   * rendering, but it does not need a GL context.
+   */
+  void validate();
+
 private:
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
@@ -70,10 +94,25 @@ private:
   void renderLines(RenderContext& renderContext);
   void renderArrows(RenderContext& renderContext);
 
-  void validate();
+  void validateVisibleLinks();
 
+  /**
+   * Returns the vertices of the links, two per link.
+   */
   virtual std::vector<LinkRenderer::LineVertex> getLinks() = 0;
 
+  /**
+   * Indicates whether the links returned by getLinks must be generated again after the
+   * selection changed.
+   */
+  virtual bool linksDependOnSelection();
+
+  /**
+   * Returns the sorted indices of the links returned by getLinks that should be rendered
+   * for the current selection, or nullopt if all links should be rendered.
+   */
+  virtual std::optional<std::vector<size_t>> getVisibleLinks();
+
   deleteCopy(LinkRenderer);
 };
 
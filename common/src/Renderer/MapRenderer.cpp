@@ -32,7 +32,9 @@
 #include "Model/WorldNode.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/BrushVertexStore.h"
 #include "Renderer/EntityDecalRenderer.h"
 #include "Renderer/EntityLinkRenderer.h"
 #include "Renderer/GroupLinkRenderer.h"
@@ -161,7 +163,15 @@ MapRenderer::MapRenderer(std::weak_ptr<View::MapDocument> document)
   , m_entityDecalRenderer{createEntityDecalRenderer(m_document)}
   , m_entityLinkRenderer{std::make_unique<EntityLinkRenderer>(m_document)}
   , m_groupLinkRenderer{std::make_unique<GroupLinkRenderer>(m_document)}
+  , m_brushVertexStore{std::make_shared<BrushVertexStore>()}
 {
+  // Brushes with selected faces are rendered by the default and the selection renderer,
+  // and selecting a brush moves it from one to the other. Sharing the vertices avoids
+  // uploading them again in these cases.
+  m_defaultRenderer->setBrushVertexStore(m_brushVertexStore);
+  m_selectionRenderer->setBrushVertexStore(m_brushVertexStore);
+  m_lockedRenderer->setBrushVertexStore(m_brushVertexStore);
+
   connectObservers();
   setupRenderers();
 }
@@ -237,6 +247,7 @@ void MapRenderer::restoreSelectionColors()
 
 void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::render"};
   commitPendingChanges();
   setupGL(renderBatch);
   renderDefaultOpaque(renderContext, renderBatch);
@@ -247,13 +258,35 @@ void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
   renderLockedTransparent(renderContext, renderBatch);
   renderSelectionTransparent(renderContext, renderBatch);
 
+  renderBatch.beginSection("Entity decals");
   renderEntityDecals(renderContext, renderBatch);
+  renderBatch.beginSection("Links");
   renderEntityLinks(renderContext, renderBatch);
   renderGroupLinks(renderContext, renderBatch);
 }
 
+void MapRenderer::renderPickIds(RenderContext& renderContext, RenderBatch& renderBatch)
+{
+  const auto zone = ProfilerZone{"MapRenderer::renderPickIds"};
+  setupGL(renderBatch);
+  m_defaultRenderer->renderPickIds(renderBatch);
+  m_lockedRenderer->renderPickIds(renderBatch);
+  if (!renderContext.hideSelection())
+  {
+    pushSelectionPreviewTransformation(renderBatch);
+    m_selectionRenderer->renderPickIds(renderBatch);
+    popSelectionPreviewTransformation(renderBatch);
+  }
+}
+
+const Model::BrushNode* MapRenderer::findBrushByPickId(const size_t pickId) const
+{
+  return pickId > 0 ? m_brushVertexStore->findBrush(pickId - 1u) : nullptr;
+}
+
 void MapRenderer::commitPendingChanges()
 {
+  const auto zone = ProfilerZone{"MapRenderer::commitPendingChanges"};
   auto document = kdl::mem_lock(m_document);
   document->commitPendingAssets();
 }
@@ -279,6 +312,7 @@ void MapRenderer::setupGL(RenderBatch& renderBatch)
 void MapRenderer::renderDefaultOpaque(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderDefaultOpaque"};
   m_defaultRenderer->setShowOverlays(renderContext.render3D());
   m_defaultRenderer->renderOpaque(renderContext, renderBatch);
 }
@@ -286,31 +320,84 @@ void MapRenderer::renderDefaultOpaque(
 void MapRenderer::renderDefaultTransparent(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderDefaultTransparent"};
   m_defaultRenderer->setShowOverlays(renderContext.render3D());
   m_defaultRenderer->renderTransparent(renderContext, renderBatch);
 }
 
+class PushModelMatrix : public Renderable
+{
+private:
+  vm::mat4x4f m_modelMatrix;
+
+public:
+  explicit PushModelMatrix(const vm::mat4x4f& modelMatrix)
+    : m_modelMatrix{modelMatrix}
+  {
+  }
+
+private:
+  void doRender(RenderContext& renderContext) override
+  {
+    renderContext.transformation().pushModelMatrix(m_modelMatrix);
+  }
+};
+
+class PopModelMatrix : public Renderable
+{
+private:
+  void doRender(RenderContext& renderContext) override
+  {
+    renderContext.transformation().popModelMatrix();
+  }
+};
+
 void MapRenderer::renderSelectionOpaque(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderSelectionOpaque"};
   if (!renderContext.hideSelection())
   {
+    pushSelectionPreviewTransformation(renderBatch);
     m_selectionRenderer->renderOpaque(renderContext, renderBatch);
+    popSelectionPreviewTransformation(renderBatch);
   }
 }
 
 void MapRenderer::renderSelectionTransparent(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderSelectionTransparent"};
   if (!renderContext.hideSelection())
   {
+    pushSelectionPreviewTransformation(renderBatch);
     m_selectionRenderer->renderTransparent(renderContext, renderBatch);
+    popSelectionPreviewTransformation(renderBatch);
+  }
+}
+
+void MapRenderer::pushSelectionPreviewTransformation(RenderBatch& renderBatch)
+{
+  auto document = kdl::mem_lock(m_document);
+  if (const auto& transformation = document->selectionPreviewTransformation())
+  {
+    renderBatch.addOneShot(new PushModelMatrix{vm::mat4x4f{*transformation}});
+  }
+}
+
+void MapRenderer::popSelectionPreviewTransformation(RenderBatch& renderBatch)
+{
+  auto document = kdl::mem_lock(m_document);
+  if (document->selectionPreviewTransformation())
+  {
+    renderBatch.addOneShot(new PopModelMatrix{});
   }
 }
 
 void MapRenderer::renderLockedOpaque(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderLockedOpaque"};
   m_lockedRenderer->setShowOverlays(renderContext.render3D());
   m_lockedRenderer->renderOpaque(renderContext, renderBatch);
 }
@@ -318,6 +405,7 @@ void MapRenderer::renderLockedOpaque(
 void MapRenderer::renderLockedTransparent(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderLockedTransparent"};
   m_lockedRenderer->setShowOverlays(renderContext.render3D());
   m_lockedRenderer->renderTransparent(renderContext, renderBatch);
 }
@@ -325,6 +413,7 @@ void MapRenderer::renderLockedTransparent(
 void MapRenderer::renderEntityDecals(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderEntityDecals"};
   // only render decals in the 3D view
   if (renderContext.render3D())
   {
@@ -335,11 +424,13 @@ void MapRenderer::renderEntityDecals(
 void MapRenderer::renderEntityLinks(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderEntityLinks"};
   m_entityLinkRenderer->render(renderContext, renderBatch);
 }
 
 void MapRenderer::renderGroupLinks(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  const auto zone = ProfilerZone{"MapRenderer::renderGroupLinks"};
   m_groupLinkRenderer->render(renderContext, renderBatch);
 }
 
@@ -363,6 +454,7 @@ void MapRenderer::setupDefaultRenderer(ObjectRenderer& renderer)
 
   renderer.setBrushFaceColor(pref(Preferences::FaceColor));
   renderer.setBrushEdgeColor(pref(Preferences::EdgeColor));
+  renderer.setCullToFrustum(true);
 }
 
 void MapRenderer::setupSelectionRenderer(ObjectRenderer& renderer)
@@ -409,6 +501,7 @@ void MapRenderer::setupLockedRenderer(ObjectRenderer& renderer)
 
   renderer.setBrushFaceColor(pref(Preferences::FaceColor));
   renderer.setBrushEdgeColor(pref(Preferences::LockedEdgeColor));
+  renderer.setCullToFrustum(true);
 }
 
 static bool selected(const Model::Node* node)
@@ -800,8 +893,8 @@ void MapRenderer::selectionDidChange(const View::Selection& selection)
     updateAndInvalidateNodeRecursive(node);
   }
 
-  invalidateEntityLinkRenderer();
-  invalidateGroupLinkRenderer();
+  m_entityLinkRenderer->invalidateSelection();
+  m_groupLinkRenderer->invalidateSelection();
 }
 
 void MapRenderer::textureCollectionsWillChange()
@@ -49,6 +49,7 @@ class Node;
 
 namespace Renderer
 {
+class BrushVertexStore;
 class EntityDecalRenderer;
 class EntityLinkRenderer;
 class GroupLinkRenderer;
@@ -67,6 +68,7 @@ private:
   std::unique_ptr<EntityDecalRenderer> m_entityDecalRenderer;
   std::unique_ptr<EntityLinkRenderer> m_entityLinkRenderer;
   std::unique_ptr<GroupLinkRenderer> m_groupLinkRenderer;
+  std::shared_ptr<BrushVertexStore> m_brushVertexStore;
 
   enum class Renderer
   {
@@ -104,6 +106,19 @@ public: // color config
 public: // rendering
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
+  /**
+   * Renders the brush faces that were rendered by the last call to render with the pick
+   * ID shader. Must be called in the same frame, after the map has been rendered, with a
+   * PickIdBuffer bound.
+   */
+  void renderPickIds(RenderContext& renderContext, RenderBatch& renderBatch);
+
+  /**
+   * Returns the brush that a pick ID read from a PickIdBuffer belongs to, or null if the
+   * ID does not belong to any brush.
+   */
+  const Model::BrushNode* findBrushByPickId(size_t pickId) const;
+
 private:
   void commitPendingChanges();
   void setupGL(RenderBatch& renderBatch);
@@ -111,6 +126,8 @@ private:
   void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderSelectionTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
+  void pushSelectionPreviewTransformation(RenderBatch& renderBatch);
+  void popSelectionPreviewTransformation(RenderBatch& renderBatch);
   void renderLockedOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderLockedTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderEntityDecals(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -20,6 +20,7 @@
 #include "ObjectRenderer.h"
 
 #include "Model/GroupNode.h"
+#include "Renderer/RenderBatch.h"
 
 #include "kdl/overload.h"
 
@@ -195,18 +196,39 @@ void ObjectRenderer::setShowHiddenObjects(const bool showHiddenObjects)
   m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
 }
 
+void ObjectRenderer::setCullToFrustum(const bool cullToFrustum)
+{
+  m_brushRenderer.setCullToFrustum(cullToFrustum);
+}
+
+void ObjectRenderer::setBrushVertexStore(
+  std::shared_ptr<BrushVertexStore> brushVertexStore)
+{
+  m_brushRenderer.setVertexStore(std::move(brushVertexStore));
+}
+
 void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  renderBatch.beginSection("Brushes (opaque)");
   m_brushRenderer.renderOpaque(renderContext, renderBatch);
+  renderBatch.beginSection("Patches");
   m_patchRenderer.render(renderContext, renderBatch);
+  renderBatch.beginSection("Entities");
   m_entityRenderer.render(renderContext, renderBatch);
+  renderBatch.beginSection("Groups");
   m_groupRenderer.render(renderContext, renderBatch);
 }
 
 void ObjectRenderer::renderTransparent(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  renderBatch.beginSection("Brushes (transparent)");
   m_brushRenderer.renderTransparent(renderContext, renderBatch);
 }
+
+void ObjectRenderer::renderPickIds(RenderBatch& renderBatch)
+{
+  m_brushRenderer.renderPickIds(renderBatch);
+}
 } // namespace Renderer
 } // namespace TrenchBroom
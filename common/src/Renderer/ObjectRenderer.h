@@ -25,6 +25,7 @@
 #include "Renderer/GroupRenderer.h"
 #include "Renderer/PatchRenderer.h"
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom
@@ -49,6 +50,7 @@ class PatchNode;
 
 namespace Renderer
 {
+class BrushVertexStore;
 class FontManager;
 class RenderBatch;
 
@@ -111,10 +113,31 @@ public: // configuration
 
   void setShowHiddenObjects(bool showHiddenObjects);
 
+  /**
+   * Specifies whether or not brushes outside of the camera's view frustum are culled.
+   *
+   * @see BrushRenderer::setCullToFrustum
+   */
+  void setCullToFrustum(bool cullToFrustum);
+
+  /**
+   * Shares brush vertices with other object renderers.
+   *
+   * @see BrushRenderer::setVertexStore
+   */
+  void setBrushVertexStore(std::shared_ptr<BrushVertexStore> brushVertexStore);
+
 public: // rendering
   void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
 
+  /**
+   * Only brushes are rendered into the pick ID buffer.
+   *
+   * @see BrushRenderer::renderPickIds
+   */
+  void renderPickIds(RenderBatch& renderBatch);
+
   deleteCopy(ObjectRenderer);
 };
 } // namespace Renderer
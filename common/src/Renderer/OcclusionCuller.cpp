@@ -0,0 +1,290 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OcclusionCuller.h"
+
+#include "Color.h"
+#include "Model/BrushNode.h"
+#include "Renderer/ActiveShader.h"
+#include "Renderer/Camera.h"
+#include "Renderer/GLVertexType.h"
+#include "Renderer/PrimType.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/Renderable.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/Shaders.h"
+#include "Renderer/VertexArray.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+/**
+ * The query boxes are slightly larger than the bounds of their brushes so that the
+ * brushes themselves cannot hide them.
+ */
+constexpr float QueryBoxPadding = 2.0f;
+
+constexpr GLsizei VerticesPerBox = 36;
+
+vm::vec3i cellOf(const vm::bbox3& bounds)
+{
+  const auto center = vm::vec3f{bounds.center()};
+  return vm::vec3i{
+    static_cast<int>(std::floor(center.x() / OcclusionCuller::CellSize)),
+    static_cast<int>(std::floor(center.y() / OcclusionCuller::CellSize)),
+    static_cast<int>(std::floor(center.z() / OcclusionCuller::CellSize))};
+}
+
+void addBox(const vm::bbox3f& bounds, std::vector<GLVertexTypes::P3::Vertex>& vertices)
+{
+  const auto& n = bounds.min;
+  const auto& x = bounds.max;
+  const vm::vec3f c[] = {
+    {n.x(), n.y(), n.z()},
+    {x.x(), n.y(), n.z()},
+    {x.x(), x.y(), n.z()},
+    {n.x(), x.y(), n.z()},
+    {n.x(), n.y(), x.z()},
+    {x.x(), n.y(), x.z()},
+    {x.x(), x.y(), x.z()},
+    {n.x(), x.y(), x.z()},
+  };
+
+  // two triangles per side
+  const size_t indices[] = {
+    0, 2, 1, 0, 3, 2, // bottom
+    4, 5, 6, 4, 6, 7, // top
+    0, 1, 5, 0, 5, 4, // front
+    2, 3, 7, 2, 7, 6, // back
+    0, 4, 7, 0, 7, 3, // left
+    1, 2, 6, 1, 6, 5, // right
+  };
+  for (const auto i : indices)
+  {
+    vertices.emplace_back(c[i]);
+  }
+}
+
+} // namespace
+
+class OcclusionCuller::QueryRenderable : public DirectRenderable
+{
+private:
+  std::vector<Cell*> m_cells;
+  VertexArray m_vertexArray;
+
+public:
+  QueryRenderable(
+    std::vector<Cell*> cells, std::vector<GLVertexTypes::P3::Vertex> vertices)
+    : m_cells{std::move(cells)}
+    , m_vertexArray{VertexArray::move(std::move(vertices))}
+  {
+  }
+
+private:
+  void doPrepareVertices(VboManager& vboManager) override
+  {
+    m_vertexArray.prepare(vboManager, VboUsage::StreamDraw);
+  }
+
+  void doRender(RenderContext& renderContext) override
+  {
+    glAssert(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+    glAssert(glDepthMask(GL_FALSE));
+    glAssert(glDisable(GL_CULL_FACE));
+
+    ActiveShader shader{renderContext.shaderManager(), Shaders::VaryingPUniformCShader};
+    shader.set("Color", Color{1.0f, 1.0f, 1.0f, 1.0f});
+
+    if (m_vertexArray.setup())
+    {
+      for (size_t i = 0; i < m_cells.size(); ++i)
+      {
+        glAssert(glBeginQuery(GL_SAMPLES_PASSED, m_cells[i]->query));
+        m_vertexArray.render(
+          PrimType::Triangles, static_cast<GLint>(i) * VerticesPerBox, VerticesPerBox);
+        glAssert(glEndQuery(GL_SAMPLES_PASSED));
+        m_cells[i]->pending = true;
+      }
+      m_vertexArray.cleanup();
+    }
+
+    glAssert(glEnable(GL_CULL_FACE));
+    glAssert(glDepthMask(GL_TRUE));
+    glAssert(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+  }
+};
+bool OcclusionCuller::CellKey::operator==(const CellKey& other) const
+{
+  return owner == other.owner && cell == other.cell;
+}
+
+size_t OcclusionCuller::CellKeyHash::operator()(const CellKey& key) const
+{
+  auto result = std::hash<const void*>{}(key.owner);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    result = result * 31 + std::hash<int>{}(key.cell[i]);
+  }
+  return result;
+}
+
+OcclusionCuller::OcclusionCuller()
+  : m_frame{0}
+{
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+  for (const auto& [key, cell] : m_cells)
+  {
+    if (cell.query != 0)
+    {
+      glAssert(glDeleteQueries(1, &cell.query));
+    }
+  }
+}
+
+void OcclusionCuller::beginFrame()
+{
+  ++m_frame;
+  m_queries.clear();
+
+  for (auto it = m_cells.begin(); it != m_cells.end();)
+  {
+    if (m_frame - it->second.lastUsedFrame > MaxUnusedFrames)
+    {
+      if (it->second.query != 0)
+      {
+        glAssert(glDeleteQueries(1, &it->second.query));
+      }
+      it = m_cells.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+size_t OcclusionCuller::cull(
+  const void* owner,
+  const Camera& camera,
+  std::vector<const Model::BrushNode*>& brushes)
+{
+  auto cellBounds = std::unordered_map<CellKey, vm::bbox3f, CellKeyHash>{};
+  for (const auto* brushNode : brushes)
+  {
+    const auto& bounds = brushNode->logicalBounds();
+    const auto key = CellKey{owner, cellOf(bounds)};
+    const auto [it, inserted] = cellBounds.emplace(key, vm::bbox3f{bounds});
+    if (!inserted)
+    {
+      it->second = vm::merge(it->second, vm::bbox3f{bounds});
+    }
+  }
+
+  auto& queries = m_queries[owner];
+  queries.clear();
+
+  for (auto& [key, bounds] : cellBounds)
+  {
+    bounds = bounds.expand(QueryBoxPadding);
+
+    auto& cell = m_cells[key];
+    cell.lastUsedFrame = m_frame;
+    readResult(cell);
+
+    if (bounds.contains(camera.position()))
+    {
+      // the query box would be clipped by the near plane
+      cell.occluded = false;
+    }
+    else if (!cell.pending)
+    {
+      if (cell.query == 0)
+      {
+        glAssert(glGenQueries(1, &cell.query));
+      }
+      queries.push_back({&cell, bounds});
+    }
+  }
+
+  const auto isOccluded = [&](const auto* brushNode) {
+    const auto it = m_cells.find(CellKey{owner, cellOf(brushNode->logicalBounds())});
+    return it != m_cells.end() && it->second.occluded;
+  };
+
+  const auto oldSize = brushes.size();
+  brushes.erase(
+    std::remove_if(brushes.begin(), brushes.end(), isOccluded), brushes.end());
+  return oldSize - brushes.size();
+}
+
+void OcclusionCuller::queryVisibility(const void* owner, RenderBatch& renderBatch)
+{
+  const auto it = m_queries.find(owner);
+  if (it == m_queries.end() || it->second.empty())
+  {
+    return;
+  }
+
+  auto cells = std::vector<Cell*>{};
+  auto vertices = std::vector<GLVertexTypes::P3::Vertex>{};
+  cells.reserve(it->second.size());
+  vertices.reserve(it->second.size() * size_t(VerticesPerBox));
+
+  for (const auto& [cell, bounds] : it->second)
+  {
+    cells.push_back(cell);
+    addBox(bounds, vertices);
+  }
+
+  renderBatch.addOneShot(new QueryRenderable{std::move(cells), std::move(vertices)});
+  m_queries.erase(it);
+}
+
+void OcclusionCuller::readResult(Cell& cell)
+{
+  if (!cell.pending)
+  {
+    return;
+  }
+
+  auto available = GLuint(0);
+  glAssert(glGetQueryObjectuiv(cell.query, GL_QUERY_RESULT_AVAILABLE, &available));
+  if (available)
+  {
+    auto samples = GLuint(0);
+    glAssert(glGetQueryObjectuiv(cell.query, GL_QUERY_RESULT, &samples));
+    cell.occluded = samples == 0;
+    cell.pending = false;
+  }
+}
+} // namespace Renderer
+} // namespace TrenchBroom
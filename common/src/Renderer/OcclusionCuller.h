@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "Renderer/GL.h"
+
+#include "vm/bbox.h"
+#include "vm/forward.h"
+#include "vm/vec.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class BrushNode;
+}
+
+namespace Renderer
+{
+class Camera;
+class RenderBatch;
+
+/**
+ * Culls brushes that are hidden behind other geometry. The brushes are grouped into the
+ * cells of a coarse grid, and the visibility of each cell is determined by an occlusion
+ * query against the bounds of its brushes. The queries are issued after the opaque
+ * brushes have been rendered and their results are used in a later frame, so culling
+ * never waits for the GPU.
+ *
+ * Cells containing the camera and cells without a query result are always visible. A
+ * cell that becomes visible again is therefore drawn at most one frame late, typically
+ * when the camera moves quickly around a corner.
+ *
+ * Query objects are not shared between OpenGL contexts, so every view needs its own
+ * culler.
+ */
+class OcclusionCuller
+{
+public:
+  static constexpr float CellSize = 512.0f;
+
+  /**
+   * Cells that have not been rendered for this many frames are forgotten.
+   */
+  static constexpr size_t MaxUnusedFrames = 120;
+
+private:
+  struct CellKey
+  {
+    const void* owner;
+    vm::vec3i cell;
+
+    bool operator==(const CellKey& other) const;
+  };
+
+  struct CellKeyHash
+  {
+    size_t operator()(const CellKey& key) const;
+  };
+
+  struct Cell
+  {
+    GLuint query = 0;
+    bool pending = false;
+    bool occluded = false;
+    size_t lastUsedFrame = 0;
+  };
+
+  struct CellQuery
+  {
+    Cell* cell;
+    vm::bbox3f bounds;
+  };
+
+  class QueryRenderable;
+
+  std::unordered_map<CellKey, Cell, CellKeyHash> m_cells;
+  std::unordered_map<const void*, std::vector<CellQuery>> m_queries;
+  size_t m_frame;
+
+public:
+  OcclusionCuller();
+  ~OcclusionCuller();
+
+  deleteCopyAndMove(OcclusionCuller);
+
+  /**
+   * Begins a new frame, deleting the queries of cells that have not been used recently.
+   */
+  void beginFrame();
+
+  /**
+   * Removes the brushes in cells that were found to be occluded from the given list.
+   * The cells of the given brushes are remembered for the next call to queryVisibility
+   * with the same owner.
+   *
+   * @param owner identifies the renderer whose brushes are culled
+   * @param camera the current camera
+   * @param brushes the brushes to cull
+   * @return the number of removed brushes
+   */
+  size_t cull(
+    const void* owner,
+    const Camera& camera,
+    std::vector<const Model::BrushNode*>& brushes);
+
+  /**
+   * Adds a renderable to the given batch that queries the visibility of the cells
+   * remembered by the last call to cull with the given owner. Must be called after the
+   * owner's opaque geometry has been added to the batch, and the batch must be rendered
+   * before the next frame begins.
+   */
+  void queryVisibility(const void* owner, RenderBatch& renderBatch);
+
+private:
+  void readResult(Cell& cell);
+};
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -19,34 +19,175 @@
 
 #include "PatchRenderer.h"
 
-#include "Assets/Texture.h"
+#include "FloatType.h"
 #include "Model/EditorContext.h"
 #include "Model/PatchNode.h"
-#include "PreferenceManager.h"
-#include "Preferences.h"
-#include "Renderer/ActiveShader.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/Camera.h"
 #include "Renderer/GLVertexType.h"
-#include "Renderer/IndexRangeMapBuilder.h"
-#include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
-#include "Renderer/RenderUtils.h"
-#include "Renderer/Shader.h"
-#include "Renderer/ShaderManager.h"
-#include "Renderer/Shaders.h"
-#include "Renderer/TexturedIndexArrayMapBuilder.h"
-#include "Renderer/TexturedIndexArrayRenderer.h"
-#include "Renderer/VertexArray.h"
-
-#include "kdl/vector_utils.h"
 
+#include "vm/bbox.h"
 #include "vm/forward.h"
 #include "vm/vec.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace TrenchBroom
 {
 namespace Renderer
 {
+PatchRenderer::Geometry::Geometry()
+  : vertexArray{std::make_shared<BrushVertexArray>()}
+  , faceIndices{std::make_shared<TextureToBrushIndicesMap>()}
+  , edgeIndices{std::make_shared<BrushIndexArray>()}
+  , faceRenderer{vertexArray, faceIndices, Color{}}
+  , edgeRenderer{vertexArray, edgeIndices}
+{
+}
+
+void PatchRenderer::Geometry::setFaceColor(const Color& faceColor)
+{
+  faceRenderer = FaceRenderer{vertexArray, faceIndices, faceColor};
+}
+
+void PatchRenderer::Geometry::removePatch(const Model::PatchNode* patchNode)
+{
+  invalidPatches.erase(patchNode);
+
+  if (auto it = patches.find(patchNode); it != patches.end())
+  {
+    auto& data = it->second;
+    if (data.vertexKey)
+    {
+      vertexArray->deleteVerticesWithKey(data.vertexKey);
+      edgeIndices->zeroElementsWithKey(data.edgeIndicesKey);
+
+      auto faceIndexHolder = faceIndices->at(data.texture);
+      faceIndexHolder->zeroElementsWithKey(data.faceIndicesKey);
+      if (!faceIndexHolder->hasValidIndices())
+      {
+        // there are no indices left to render for this texture
+        faceIndices->erase(data.texture);
+      }
+    }
+    patches.erase(it);
+  }
+}
+
+namespace
+{
+/**
+ * Returns the indices of the grid points on the border of a patch with the given number
+ * of quads, relative to the first vertex of the patch. The points are visited clockwise
+ * starting at the first point.
+ */
+std::vector<size_t> edgeLoopIndices(
+  const size_t quadRowCount, const size_t quadColumnCount)
+{
+  const auto pointsPerRow = quadColumnCount + 1u;
+  const auto index = [&](const size_t row, const size_t col) {
+    return row * pointsPerRow + col;
+  };
+
+  auto result = std::vector<size_t>{};
+  result.reserve(2u * (quadRowCount + quadColumnCount));
+
+  // for each side, collect the first vertex up to but not including the last vertex
+  for (size_t col = 0u; col < quadColumnCount; ++col)
+  {
+    result.push_back(index(0u, col));
+  }
+  for (size_t row = 0u; row < quadRowCount; ++row)
+  {
+    result.push_back(index(row, quadColumnCount));
+  }
+  for (size_t col = quadColumnCount; col > 0u; --col)
+  {
+    result.push_back(index(quadRowCount, col));
+  }
+  for (size_t row = quadRowCount; row > 0u; --row)
+  {
+    result.push_back(index(row, 0u));
+  }
+
+  return result;
+}
+} // namespace
+
+void PatchRenderer::Geometry::updatePatch(
+  const Model::PatchNode* patchNode, const size_t gridStep, const bool visible)
+{
+  removePatch(patchNode);
+
+  auto& data = patches[patchNode];
+  data.gridStep = gridStep;
+  if (!visible)
+  {
+    return;
+  }
+
+  const auto& grid = patchNode->grid();
+  const auto quadRowCount = grid.quadRowCount() / gridStep;
+  const auto quadColumnCount = grid.quadColumnCount() / gridStep;
+  const auto pointsPerRow = quadColumnCount + 1u;
+
+  auto [vertexKey, vertexDest] =
+    vertexArray->getPointerToInsertVerticesAt((quadRowCount + 1u) * pointsPerRow);
+  for (size_t row = 0u; row <= quadRowCount; ++row)
+  {
+    for (size_t col = 0u; col <= quadColumnCount; ++col)
+    {
+      const auto& p = grid.point(row * gridStep, col * gridStep);
+      *(vertexDest++) = GLVertexTypes::P3NBT2::Vertex{
+        vm::vec3f{p.position}, packNormal(vm::vec3f{p.normal}), vm::vec2f{p.texCoords}};
+    }
+  }
+
+  const auto vertexOffset = GLuint(vertexKey->pos);
+  data.vertexKey = vertexKey;
+  data.texture = patchNode->patch().texture();
+
+  auto& faceIndexHolder = (*faceIndices)[data.texture];
+  if (!faceIndexHolder)
+  {
+    faceIndexHolder = std::make_shared<BrushIndexArray>();
+  }
+
+  auto [faceIndicesKey, faceIndexDest] =
+    faceIndexHolder->getPointerToInsertElementsAt(6u * quadRowCount * quadColumnCount);
+  for (size_t row = 0u; row < quadRowCount; ++row)
+  {
+    for (size_t col = 0u; col < quadColumnCount; ++col)
+    {
+      const auto i0 = vertexOffset + GLuint(row * pointsPerRow + col);
+      const auto i1 = vertexOffset + GLuint(row * pointsPerRow + col + 1u);
+      const auto i2 = vertexOffset + GLuint((row + 1u) * pointsPerRow + col + 1u);
+      const auto i3 = vertexOffset + GLuint((row + 1u) * pointsPerRow + col);
+
+      *(faceIndexDest++) = i0;
+      *(faceIndexDest++) = i1;
+      *(faceIndexDest++) = i2;
+      *(faceIndexDest++) = i2;
+      *(faceIndexDest++) = i3;
+      *(faceIndexDest++) = i0;
+    }
+  }
+  data.faceIndicesKey = faceIndicesKey;
+
+  // the edges connect the vertices on the border of the patch
+  const auto edgeLoop = edgeLoopIndices(quadRowCount, quadColumnCount);
+  auto [edgeIndicesKey, edgeIndexDest] =
+    edgeIndices->getPointerToInsertElementsAt(2u * edgeLoop.size());
+  for (size_t i = 0u; i < edgeLoop.size(); ++i)
+  {
+    *(edgeIndexDest++) = vertexOffset + GLuint(edgeLoop[i]);
+    *(edgeIndexDest++) = vertexOffset + GLuint(edgeLoop[(i + 1u) % edgeLoop.size()]);
+  }
+  data.edgeIndicesKey = edgeIndicesKey;
+}
+
 PatchRenderer::PatchRenderer(const Model::EditorContext& editorContext)
   : m_editorContext{editorContext}
   , m_grayscale{false}
@@ -58,6 +199,8 @@ PatchRenderer::PatchRenderer(const Model::EditorContext& editorContext)
 void PatchRenderer::setDefaultColor(const Color& faceColor)
 {
   m_defaultColor = faceColor;
+  m_geometry.setFaceColor(m_defaultColor);
+  m_lodGeometry.setFaceColor(m_defaultColor);
 }
 
 void PatchRenderer::setGrayscale(const bool grayscale)
@@ -102,20 +245,26 @@ void PatchRenderer::setOccludedEdgeColor(const Color& occludedEdgeColor)
 
 void PatchRenderer::invalidate()
 {
-  m_valid = false;
+  for (const auto* patchNode : m_patchNodes)
+  {
+    invalidatePatch(patchNode);
+  }
 }
 
 void PatchRenderer::clear()
 {
   m_patchNodes.clear();
-  invalidate();
+  m_geometry = Geometry{};
+  m_lodGeometry = Geometry{};
+  m_geometry.setFaceColor(m_defaultColor);
+  m_lodGeometry.setFaceColor(m_defaultColor);
 }
 
 void PatchRenderer::addPatch(const Model::PatchNode* patchNode)
 {
   if (m_patchNodes.insert(patchNode).second)
   {
-    invalidate();
+    invalidatePatch(patchNode);
   }
 }
 
@@ -124,296 +273,117 @@ void PatchRenderer::removePatch(const Model::PatchNode* patchNode)
   if (auto it = m_patchNodes.find(patchNode); it != std::end(m_patchNodes))
   {
     m_patchNodes.erase(it);
-    invalidate();
+    m_geometry.removePatch(patchNode);
+    m_lodGeometry.removePatch(patchNode);
   }
 }
 
-void PatchRenderer::invalidatePatch(const Model::PatchNode*)
+void PatchRenderer::invalidatePatch(const Model::PatchNode* patchNode)
 {
-  invalidate();
+  if (m_patchNodes.count(patchNode) > 0u)
+  {
+    m_geometry.invalidPatches.insert(patchNode);
+    m_lodGeometry.invalidPatches.insert(patchNode);
+  }
 }
 
 void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  if (!m_valid)
+  if (renderContext.render3D())
+  {
+    validateLevelsOfDetail(renderContext.camera());
+  }
+  else
   {
     validate();
   }
 
+  auto& geometry = renderContext.render3D() ? m_lodGeometry : m_geometry;
   if (renderContext.showFaces())
   {
-    renderBatch.add(this);
+    geometry.faceRenderer.setGrayscale(m_grayscale);
+    geometry.faceRenderer.setTint(m_tint);
+    geometry.faceRenderer.setTintColor(m_tintColor);
+    geometry.faceRenderer.render(renderBatch);
   }
 
   if (renderContext.showEdges())
   {
     if (m_showOccludedEdges)
     {
-      m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+      geometry.edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
     }
-    m_edgeRenderer.render(renderBatch, m_edgeColor);
+    geometry.edgeRenderer.render(renderBatch, m_edgeColor);
   }
 }
 
-static TexturedIndexArrayRenderer buildMeshRenderer(
-  const std::vector<const Model::PatchNode*>& patchNodes,
-  const Model::EditorContext& editorContext)
+namespace
 {
-  size_t vertexCount = 0u;
-  auto indexArrayMapSize = TexturedIndexArrayMap::Size{};
-
-  for (const auto* patchNode : patchNodes)
-  {
-    if (editorContext.visible(patchNode))
-    {
-      vertexCount += patchNode->grid().pointRowCount * patchNode->grid().pointColumnCount;
-
-      const auto* texture = patchNode->patch().texture();
-      const auto quadCount =
-        patchNode->grid().quadRowCount() * patchNode->grid().quadColumnCount();
-      indexArrayMapSize.inc(texture, PrimType::Triangles, 6u * quadCount);
-    }
-  }
-
-  using Vertex = GLVertexTypes::P3NT2::Vertex;
-  auto vertices = std::vector<Vertex>{};
-  vertices.reserve(vertexCount);
-
-  auto indexArrayMapBuilder = TexturedIndexArrayMapBuilder{indexArrayMapSize};
-  using Index = TexturedIndexArrayMapBuilder::Index;
-
-  for (const auto* patchNode : patchNodes)
-  {
-    if (editorContext.visible(patchNode))
-    {
-      const auto vertexOffset = vertices.size();
-
-      const auto& grid = patchNode->grid();
-      auto gridVertices = kdl::vec_transform(grid.points, [](const auto& p) {
-        return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.texCoords}};
-      });
-      vertices = kdl::vec_concat(std::move(vertices), std::move(gridVertices));
-
-      const auto* texture = patchNode->patch().texture();
-
-      const auto pointsPerRow = grid.pointColumnCount;
-      for (size_t row = 0u; row < grid.quadRowCount(); ++row)
-      {
-        for (size_t col = 0u; col < grid.quadColumnCount(); ++col)
-        {
-          const auto i0 = vertexOffset + row * pointsPerRow + col;
-          const auto i1 = vertexOffset + row * pointsPerRow + col + 1u;
-          const auto i2 = vertexOffset + (row + 1u) * pointsPerRow + col + 1u;
-          const auto i3 = vertexOffset + (row + 1u) * pointsPerRow + col;
-
-          indexArrayMapBuilder.addTriangle(
-            texture,
-            static_cast<Index>(i0),
-            static_cast<Index>(i1),
-            static_cast<Index>(i2));
-          indexArrayMapBuilder.addTriangle(
-            texture,
-            static_cast<Index>(i2),
-            static_cast<Index>(i3),
-            static_cast<Index>(i0));
-        }
-      }
-    }
-  }
+/**
+ * Grid quads that are seen under a smaller angle (in radians) than this are merged with
+ * their neighbours when rendering a patch in the 3D view.
+ */
+constexpr auto MinQuadAngle = FloatType(0.02);
 
-  auto vertexArray = VertexArray::move(std::move(vertices));
-  auto indexArray = IndexArray::move(std::move(indexArrayMapBuilder.indices()));
-  return TexturedIndexArrayRenderer{
-    std::move(vertexArray),
-    std::move(indexArray),
-    std::move(indexArrayMapBuilder.ranges())};
-}
+/**
+ * The maximum number of grid quads along each side that are merged into one.
+ */
+constexpr auto MaxGridStep = size_t(4);
 
-static DirectEdgeRenderer buildEdgeRenderer(
-  const std::vector<const Model::PatchNode*>& patchNodes,
-  const Model::EditorContext& editorContext)
+/**
+ * Returns the number of grid points to advance per rendered quad along the rows and
+ * columns of the given patch's grid. This is a power of two that grows with the distance
+ * of the patch to the given camera position.
+ */
+size_t gridStep(const Model::PatchNode& patchNode, const vm::vec3& cameraPosition)
 {
-  size_t vertexCount = 0u;
-  auto indexRangeMapSize = IndexRangeMap::Size{};
-
-  for (const auto* patchNode : patchNodes)
+  const auto& grid = patchNode.grid();
+  const auto& bounds = grid.bounds;
+
+  const auto closestPoint = vm::max(bounds.min, vm::min(bounds.max, cameraPosition));
+  const auto distance = vm::distance(cameraPosition, closestPoint);
+
+  // estimate the size of a quad from the longest side of the patch bounds
+  const auto quadSize =
+    vm::get_max_component(bounds.size())
+    / static_cast<FloatType>(std::max(grid.quadRowCount(), grid.quadColumnCount()));
+
+  auto step = size_t(1);
+  while (
+    step < MaxGridStep && grid.quadRowCount() % (2u * step) == 0u
+    && grid.quadColumnCount() % (2u * step) == 0u
+    && quadSize * static_cast<FloatType>(2u * step) < distance * MinQuadAngle)
   {
-    if (editorContext.visible(patchNode))
-    {
-      vertexCount +=
-        (patchNode->grid().pointRowCount + patchNode->grid().pointColumnCount - 2u) * 2u;
-      indexRangeMapSize.inc(PrimType::LineLoop, vertexCount);
-    }
+    step *= 2u;
   }
-
-  auto indexRangeMapBuilder =
-    IndexRangeMapBuilder<GLVertexTypes::P3>{vertexCount, indexRangeMapSize};
-
-  for (const auto* patchNode : patchNodes)
-  {
-    if (editorContext.visible(patchNode))
-    {
-      const auto& grid = patchNode->grid();
-
-      auto edgeLoopVertices = std::vector<GLVertexTypes::P3::Vertex>{};
-      edgeLoopVertices.reserve((grid.pointRowCount + grid.pointColumnCount - 2u) * 2u);
-
-      // walk around the patch to collect the edge vertices
-      // for each side, collect the first vertex up to but not including the last vertex
-
-      const auto t = 0u;
-      const auto b = grid.pointRowCount - 1u;
-      const auto l = 0u;
-      const auto r = grid.pointColumnCount - 1u;
-
-      size_t row = t;
-      size_t col = l;
-
-      while (col < r)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col++).position});
-      }
-      assert(row == t && col == r);
-
-      while (row < b)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row++, col).position});
-      }
-      assert(row == b && col == r);
-
-      while (col > l)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col--).position});
-      }
-      assert(row == b && col == l);
-
-      while (row > t)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row--, col).position});
-      }
-      assert(row == t && col == l);
-
-      indexRangeMapBuilder.addLineLoop(edgeLoopVertices);
-    }
-  }
-
-  auto vertexArray = VertexArray::move(std::move(indexRangeMapBuilder.vertices()));
-  auto indexRangeMap = std::move(indexRangeMapBuilder.indices());
-  return DirectEdgeRenderer{std::move(vertexArray), std::move(indexRangeMap)};
+  return step;
 }
+} // namespace
 
 void PatchRenderer::validate()
 {
-  if (!m_valid)
+  for (const auto* patchNode : m_geometry.invalidPatches)
   {
-    m_patchMeshRenderer = buildMeshRenderer(m_patchNodes.get_data(), m_editorContext);
-    m_edgeRenderer = buildEdgeRenderer(m_patchNodes.get_data(), m_editorContext);
-
-    m_valid = true;
+    m_geometry.updatePatch(patchNode, 1u, m_editorContext.visible(patchNode));
   }
+  m_geometry.invalidPatches.clear();
 }
 
-void PatchRenderer::prepareVerticesAndIndices(VboManager& vboManager)
+void PatchRenderer::validateLevelsOfDetail(const Camera& camera)
 {
-  m_patchMeshRenderer.prepare(vboManager);
-}
-
-namespace
-{
-struct RenderFunc : public TextureRenderFunc
-{
-  ActiveShader& shader;
-  bool applyTexture;
-  const Color& defaultColor;
-
-  RenderFunc(
-    ActiveShader& i_shader, const bool i_applyTexture, const Color& i_defaultColor)
-    : shader{i_shader}
-    , applyTexture{i_applyTexture}
-    , defaultColor{i_defaultColor}
+  const auto cameraPosition = vm::vec3{camera.position()};
+  for (const auto* patchNode : m_patchNodes)
   {
-  }
-
-  void before(const Assets::Texture* texture) override
-  {
-    shader.set("GridColor", gridColorForTexture(texture));
-    if (texture != nullptr)
-    {
-      texture->activate();
-      shader.set("ApplyTexture", applyTexture);
-      shader.set("Color", texture->averageColor());
-    }
-    else
+    const auto step = gridStep(*patchNode, cameraPosition);
+    const auto it = m_lodGeometry.patches.find(patchNode);
+    if (
+      it == m_lodGeometry.patches.end() || it->second.gridStep != step
+      || m_lodGeometry.invalidPatches.count(patchNode) > 0u)
     {
-      shader.set("ApplyTexture", false);
-      shader.set("Color", defaultColor);
+      m_lodGeometry.updatePatch(patchNode, step, m_editorContext.visible(patchNode));
     }
   }
-
-  void after(const Assets::Texture* texture) override
-  {
-    if (texture != nullptr)
-    {
-      texture->deactivate();
-    }
-  }
-};
-} // namespace
-
-void PatchRenderer::doRender(RenderContext& context)
-{
-  auto& shaderManager = context.shaderManager();
-  auto shader = ActiveShader{shaderManager, Shaders::FaceShader};
-  auto& prefs = PreferenceManager::instance();
-
-  const bool applyTexture = context.showTextures();
-  const bool shadeFaces = context.shadeFaces();
-  const bool showFog = context.showFog();
-
-  glAssert(glEnable(GL_TEXTURE_2D));
-  glAssert(glActiveTexture(GL_TEXTURE0));
-  shader.set("Brightness", prefs.get(Preferences::Brightness));
-  shader.set("RenderGrid", context.showGrid());
-  shader.set("GridSize", static_cast<float>(context.gridSize()));
-  shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
-  shader.set("ApplyTexture", applyTexture);
-  shader.set("Texture", 0);
-  shader.set("ApplyTinting", m_tint);
-  if (m_tint)
-  {
-    shader.set("TintColor", m_tintColor);
-  }
-  shader.set("GrayScale", m_grayscale);
-  shader.set("CameraPosition", context.camera().position());
-  shader.set("ShadeFaces", shadeFaces);
-  shader.set("ShowFog", showFog);
-  shader.set("Alpha", 1.0);
-  shader.set("EnableMasked", false);
-  shader.set("ShowSoftMapBounds", !context.softMapBounds().is_empty());
-  shader.set("SoftMapBoundsMin", context.softMapBounds().min);
-  shader.set("SoftMapBoundsMax", context.softMapBounds().max);
-  shader.set(
-    "SoftMapBoundsColor",
-    vm::vec4f{
-      prefs.get(Preferences::SoftMapBoundsColor).r(),
-      prefs.get(Preferences::SoftMapBoundsColor).g(),
-      prefs.get(Preferences::SoftMapBoundsColor).b(),
-      0.1f});
-
-  auto func = RenderFunc{shader, applyTexture, m_defaultColor};
-  /*
-  if (m_alpha < 1.0f) {
-      glAssert(glDepthMask(GL_FALSE));
-  }
-  */
-
-  m_patchMeshRenderer.render(func);
-
-  /*
-  if (m_alpha < 1.0f) {
-      glAssert(glDepthMask(GL_TRUE));
-  }
-  */
+  m_lodGeometry.invalidPatches.clear();
 }
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -20,16 +20,23 @@
 #pragma once
 
 #include "Color.h"
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
-#include "Renderer/Renderable.h"
-#include "Renderer/TexturedIndexArrayRenderer.h"
+#include "Renderer/FaceRenderer.h"
 
 #include "kdl/vector_set.h"
 
-#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace TrenchBroom
 {
+namespace Assets
+{
+class Texture;
+}
+
 namespace Model
 {
 class EditorContext;
@@ -38,20 +45,71 @@ class PatchNode;
 
 namespace Renderer
 {
+class BrushIndexArray;
+class BrushVertexArray;
+class Camera;
 class RenderBatch;
 class RenderContext;
-class VboManager;
 
-class PatchRenderer : public IndexedRenderable
+class PatchRenderer
 {
 private:
+  /**
+   * The ranges of the shared arrays that hold the geometry of one patch.
+   */
+  struct PatchData
+  {
+    // the grid step that the geometry was built with
+    size_t gridStep = 0;
+    const Assets::Texture* texture = nullptr;
+    // null if the patch was hidden when its geometry was built
+    AllocationTracker::Block* vertexKey = nullptr;
+    AllocationTracker::Block* faceIndicesKey = nullptr;
+    AllocationTracker::Block* edgeIndicesKey = nullptr;
+  };
+
+  using TextureToBrushIndicesMap =
+    std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+
+  /**
+   * The geometry of all patches at one level of detail. Like in BrushRenderer, the
+   * vertices of all patches are sub-allocated from one vertex array and their indices
+   * from one index array per texture, so that updating a patch only rewrites its own
+   * ranges.
+   */
+  struct Geometry
+  {
+    std::shared_ptr<BrushVertexArray> vertexArray;
+    std::shared_ptr<TextureToBrushIndicesMap> faceIndices;
+    std::shared_ptr<BrushIndexArray> edgeIndices;
+
+    std::unordered_map<const Model::PatchNode*, PatchData> patches;
+    std::unordered_set<const Model::PatchNode*> invalidPatches;
+
+    FaceRenderer faceRenderer;
+    IndexedEdgeRenderer edgeRenderer;
+
+    Geometry();
+
+    void setFaceColor(const Color& faceColor);
+    void removePatch(const Model::PatchNode* patchNode);
+    void updatePatch(const Model::PatchNode* patchNode, size_t gridStep, bool visible);
+  };
+
   const Model::EditorContext& m_editorContext;
 
-  bool m_valid = true;
   kdl::vector_set<const Model::PatchNode*> m_patchNodes;
 
-  TexturedIndexArrayRenderer m_patchMeshRenderer;
-  DirectEdgeRenderer m_edgeRenderer;
+  /**
+   * The 2D views render the patches at full detail.
+   */
+  Geometry m_geometry;
+
+  /**
+   * The 3D view renders the patches with fewer quads the further they are from the
+   * camera. A patch is rebuilt when its grid step changes, see validateLevelsOfDetail().
+   */
+  Geometry m_lodGeometry;
 
   Color m_defaultColor;
   bool m_grayscale;
@@ -121,10 +179,7 @@ public:
 
 private:
   void validate();
-
-private: // implement IndexedRenderable interface
-  void prepareVerticesAndIndices(VboManager& vboManager) override;
-  void doRender(RenderContext& renderContext) override;
+  void validateLevelsOfDetail(const Camera& camera);
 };
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -0,0 +1,168 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PickIdBuffer.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+PickIdBuffer::PickIdBuffer()
+  : m_framebuffer{0}
+  , m_idBuffer{0}
+  , m_depthBuffer{0}
+  , m_width{0}
+  , m_height{0}
+  , m_previousFramebuffer{0}
+  , m_valid{false}
+{
+}
+
+PickIdBuffer::~PickIdBuffer()
+{
+  destroy();
+}
+
+bool PickIdBuffer::supported()
+{
+  return GLEW_VERSION_3_0;
+}
+
+bool PickIdBuffer::bind(const int width, const int height)
+{
+  m_valid = false;
+
+  glAssert(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer));
+  if (m_framebuffer == 0 || width != m_width || height != m_height)
+  {
+    destroy();
+    if (!create(width, height))
+    {
+      destroy();
+      return false;
+    }
+  }
+
+  glAssert(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer));
+  glAssert(glViewport(0, 0, m_width, m_height));
+
+  // blending does not apply to integer color buffers, but the depth mask affects clearing
+  const GLuint clearId[] = {0, 0, 0, 0};
+  glAssert(glClearBufferuiv(GL_COLOR, 0, clearId));
+  glAssert(glDepthMask(GL_TRUE));
+  glAssert(glClear(GL_DEPTH_BUFFER_BIT));
+  return true;
+}
+
+void PickIdBuffer::unbind()
+{
+  glAssert(
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(m_previousFramebuffer)));
+  m_valid = true;
+}
+
+void PickIdBuffer::invalidate()
+{
+  m_valid = false;
+}
+
+bool PickIdBuffer::valid() const
+{
+  return m_valid;
+}
+
+std::optional<GLuint> PickIdBuffer::readId(const int x, const int y) const
+{
+  if (!m_valid || x < 0 || y < 0 || x >= m_width || y >= m_height)
+  {
+    return std::nullopt;
+  }
+
+  auto previousFramebuffer = GLint(0);
+  glAssert(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousFramebuffer));
+  glAssert(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer));
+
+  auto id = GLuint(0);
+  glAssert(glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, &id));
+
+  glAssert(
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer)));
+  return id;
+}
+
+bool PickIdBuffer::create(const int width, const int height)
+{
+  if (width <= 0 || height <= 0)
+  {
+    return false;
+  }
+
+  glAssert(glGenRenderbuffers(1, &m_idBuffer));
+  glAssert(glBindRenderbuffer(GL_RENDERBUFFER, m_idBuffer));
+  glAssert(glRenderbufferStorage(GL_RENDERBUFFER, GL_R32UI, width, height));
+
+  glAssert(glGenRenderbuffers(1, &m_depthBuffer));
+  glAssert(glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer));
+  glAssert(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height));
+  glAssert(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+  glAssert(glGenFramebuffers(1, &m_framebuffer));
+  glAssert(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer));
+  glAssert(glFramebufferRenderbuffer(
+    GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_idBuffer));
+  glAssert(glFramebufferRenderbuffer(
+    GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer));
+
+  const auto status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+  glAssert(
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(m_previousFramebuffer)));
+
+  if (status != GL_FRAMEBUFFER_COMPLETE)
+  {
+    return false;
+  }
+
+  m_width = width;
+  m_height = height;
+  return true;
+}
+
+void PickIdBuffer::destroy()
+{
+  if (m_framebuffer != 0)
+  {
+    glAssert(glDeleteFramebuffers(1, &m_framebuffer));
+    m_framebuffer = 0;
+  }
+  if (m_idBuffer != 0)
+  {
+    glAssert(glDeleteRenderbuffers(1, &m_idBuffer));
+    m_idBuffer = 0;
+  }
+  if (m_depthBuffer != 0)
+  {
+    glAssert(glDeleteRenderbuffers(1, &m_depthBuffer));
+    m_depthBuffer = 0;
+  }
+  m_width = 0;
+  m_height = 0;
+  m_valid = false;
+}
+} // namespace Renderer
+} // namespace TrenchBroom
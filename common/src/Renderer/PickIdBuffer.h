@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "Renderer/GL.h"
+
+#include <optional>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+/**
+ * An offscreen framebuffer with an unsigned integer color target that stores an ID for
+ * every pixel, e.g. the ID of the frontmost primitive rendered at that pixel. Pixels that
+ * nothing was rendered to have the ID 0.
+ *
+ * The IDs are read back one pixel at a time, so looking up what is under the mouse
+ * cursor does not depend on the size of the scene.
+ *
+ * Framebuffer objects are not shared between OpenGL contexts, so the buffer must only be
+ * used while the context in which it was created is current.
+ */
+class PickIdBuffer
+{
+private:
+  GLuint m_framebuffer;
+  GLuint m_idBuffer;
+  GLuint m_depthBuffer;
+  int m_width;
+  int m_height;
+  GLint m_previousFramebuffer;
+  bool m_valid;
+
+public:
+  PickIdBuffer();
+  ~PickIdBuffer();
+
+  deleteCopyAndMove(PickIdBuffer);
+
+  /**
+   * Returns whether the current context supports integer render targets and the GLSL
+   * version required by the pick ID shader.
+   */
+  static bool supported();
+
+  /**
+   * Binds the buffer as the render target and clears it, resizing it to the given size
+   * in pixels if necessary. The previously bound framebuffer is restored by unbind.
+   *
+   * Returns false and leaves the current framebuffer bound if the buffer cannot be
+   * created, in which case unbind must not be called.
+   */
+  bool bind(int width, int height);
+
+  /**
+   * Restores the framebuffer that was bound when bind was called. The contents of the
+   * buffer are valid until invalidate is called.
+   */
+  void unbind();
+
+  /**
+   * Marks the contents of the buffer as outdated, e.g. because the camera has changed.
+   */
+  void invalidate();
+  bool valid() const;
+
+  /**
+   * Returns the ID of the pixel at the given position, with the origin at the bottom
+   * left corner, or std::nullopt if the buffer is not valid or the position is outside of
+   * the buffer.
+   */
+  std::optional<GLuint> readId(int x, int y) const;
+
+private:
+  bool create(int width, int height);
+  void destroy();
+};
+} // namespace Renderer
+} // namespace TrenchBroom
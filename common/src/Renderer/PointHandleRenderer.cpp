@@ -23,114 +23,98 @@
 #include "Preferences.h"
 #include "Renderer/ActiveShader.h"
 #include "Renderer/Camera.h"
+#include "Renderer/PrimType.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/VboManager.h"
 
-#include "vm/forward.h"
-#include "vm/mat_ext.h"
+#include "kdl/vector_utils.h"
+
 #include "vm/vec.h"
 
 namespace TrenchBroom
 {
 namespace Renderer
 {
-PointHandleRenderer::PointHandleRenderer()
-  : m_handle(pref(Preferences::HandleRadius), 16, true)
-  , m_highlight(2.0f * pref(Preferences::HandleRadius), 16, false)
+namespace
+{
+void addQuad(
+  std::vector<PointHandleRenderer::HandleVertex>& vertices,
+  const Color& color,
+  const vm::vec3f& position,
+  const float highlight)
 {
+  vertices.emplace_back(position, color, vm::vec3f{-1.0f, -1.0f, highlight});
+  vertices.emplace_back(position, color, vm::vec3f{+1.0f, -1.0f, highlight});
+  vertices.emplace_back(position, color, vm::vec3f{+1.0f, +1.0f, highlight});
+  vertices.emplace_back(position, color, vm::vec3f{-1.0f, +1.0f, highlight});
 }
+} // namespace
 
 void PointHandleRenderer::addPoint(const Color& color, const vm::vec3f& position)
 {
-  m_pointHandles[color].push_back(position);
+  addQuad(m_pointHandles, color, position, 0.0f);
 }
 
 void PointHandleRenderer::addHighlight(const Color& color, const vm::vec3f& position)
 {
-  m_highlights[color].push_back(position);
+  addQuad(m_highlights, color, position, 1.0f);
 }
 
 void PointHandleRenderer::doPrepareVertices(VboManager& vboManager)
 {
-  m_handle.prepare(vboManager);
-  m_highlight.prepare(vboManager);
+  m_vertexArray = VertexArray::move(
+    kdl::vec_concat(std::move(m_pointHandles), std::move(m_highlights)));
+  m_vertexArray.prepare(vboManager, VboUsage::StreamDraw);
 }
 
 void PointHandleRenderer::doRender(RenderContext& renderContext)
 {
-  const Camera& camera = renderContext.camera();
-  const Camera::Viewport& viewport = camera.viewport();
-  const vm::mat4x4f projection = vm::ortho_matrix(
-    0.0f,
-    1.0f,
-    static_cast<float>(viewport.x),
-    static_cast<float>(viewport.height),
-    static_cast<float>(viewport.width),
-    static_cast<float>(viewport.y));
-  const vm::mat4x4f view = vm::view_matrix(vm::vec3f::neg_z(), vm::vec3f::pos_y());
-  ReplaceTransformation ortho(renderContext.transformation(), projection, view);
-
-  if (renderContext.render3D())
+  if (!m_vertexArray.empty())
   {
-    // Un-occluded handles: use depth test, draw fully opaque
-    renderHandles(renderContext, m_pointHandles, m_handle, 1.0f);
-    renderHandles(renderContext, m_highlights, m_highlight, 1.0f);
-
-    // Occluded handles: don't use depth test, but draw translucent
-    glAssert(glDisable(GL_DEPTH_TEST));
-    renderHandles(renderContext, m_pointHandles, m_handle, 0.33f);
-    renderHandles(renderContext, m_highlights, m_highlight, 0.33f);
-    glAssert(glEnable(GL_DEPTH_TEST));
-  }
-  else
-  {
-    // In 2D views, render fully opaque without depth test
-    glAssert(glDisable(GL_DEPTH_TEST));
-    renderHandles(renderContext, m_pointHandles, m_handle, 1.0f);
-    renderHandles(renderContext, m_highlights, m_highlight, 1.0f);
-    glAssert(glEnable(GL_DEPTH_TEST));
-  }
-
-  clear();
-}
-
-void PointHandleRenderer::renderHandles(
-  RenderContext& renderContext, const HandleMap& map, Circle& circle, const float opacity)
-{
-  const Camera& camera = renderContext.camera();
-  ActiveShader shader(renderContext.shaderManager(), Shaders::HandleShader);
-
-  for (const auto& [color, positions] : map)
-  {
-    shader.set("Color", mixAlpha(color, opacity));
-
-    for (const vm::vec3f& position : positions)
+    const auto& camera = renderContext.camera();
+    const auto& viewport = camera.viewport();
+
+    auto shader =
+      ActiveShader{renderContext.shaderManager(), Shaders::HandleSpriteShader};
+    shader.set(
+      "ViewportSize",
+      vm::vec2f{static_cast<float>(viewport.width), static_cast<float>(viewport.height)});
+    shader.set("HandleRadius", pref(Preferences::HandleRadius));
+    shader.set("CameraPosition", camera.position());
+    shader.set("NudgeTowardsCamera", renderContext.render3D());
+
+    if (renderContext.render3D())
     {
-      vm::vec3f nudgeTowardsCamera;
-
-      // In 3D view, nudge towards camera by the handle radius, to prevent lines (brush
-      // edges, etc.) from clipping into the handle
-      if (renderContext.render3D())
-      {
-        nudgeTowardsCamera =
-          vm::normalize(camera.position() - position) * pref(Preferences::HandleRadius);
-      }
-
-      const vm::vec3f offset =
-        camera.project(position + nudgeTowardsCamera) * vm::vec3f(1.0f, 1.0f, -1.0f);
-      MultiplyModelMatrix translate(
-        renderContext.transformation(), vm::translation_matrix(offset));
-      circle.render();
+      // Un-occluded handles: use depth test, draw fully opaque
+      shader.set("Opacity", 1.0f);
+      m_vertexArray.render(PrimType::Quads);
+
+      // Occluded handles: don't use depth test, but draw translucent
+      glAssert(glDisable(GL_DEPTH_TEST));
+      shader.set("Opacity", 0.33f);
+      m_vertexArray.render(PrimType::Quads);
+      glAssert(glEnable(GL_DEPTH_TEST));
+    }
+    else
+    {
+      // In 2D views, render fully opaque without depth test
+      glAssert(glDisable(GL_DEPTH_TEST));
+      shader.set("Opacity", 1.0f);
+      m_vertexArray.render(PrimType::Quads);
+      glAssert(glEnable(GL_DEPTH_TEST));
     }
   }
+
+  clear();
 }
 
 void PointHandleRenderer::clear()
 {
   m_pointHandles.clear();
   m_highlights.clear();
+  m_vertexArray = VertexArray{};
 }
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -20,43 +20,57 @@
 #pragma once
 
 #include "Color.h"
-#include "Renderer/Circle.h"
+#include "Renderer/GLVertexType.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/VertexArray.h"
 
 #include "vm/forward.h"
 
-#include <map>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom
 {
 namespace Renderer
 {
-class ActiveShader;
 class RenderContext;
 class VboManager;
 
+/**
+ * Renders all point handles and their highlights with a single draw call. Every handle
+ * is a quad whose vertices share the handle's position and color. The quad is expanded
+ * to the handle's size in screen space by the shader, which also cuts out the disc of a
+ * handle or the ring of a highlight.
+ */
 class PointHandleRenderer : public DirectRenderable
 {
-private:
-  using HandleMap = std::map<Color, std::vector<vm::vec3f>>;
-
-  HandleMap m_pointHandles;
-  HandleMap m_highlights;
+public:
+  struct HandleOffsetName
+  {
+    static inline const auto name = std::string{"handleOffset"};
+  };
+
+  /**
+   * The position and the color of a handle, followed by the corner of the handle's quad
+   * in [-1..1] and 1 if the handle is a highlight.
+   */
+  using HandleVertex = GLVertexType<
+    GLVertexAttributeTypes::P3,
+    GLVertexAttributeTypes::C4,
+    GLVertexAttributeUser<HandleOffsetName, GL_FLOAT, 3, false>>::Vertex;
 
-  Circle m_handle;
-  Circle m_highlight;
+private:
+  std::vector<HandleVertex> m_pointHandles;
+  std::vector<HandleVertex> m_highlights;
+  VertexArray m_vertexArray;
 
 public:
-  PointHandleRenderer();
-
   void addPoint(const Color& color, const vm::vec3f& position);
   void addHighlight(const Color& color, const vm::vec3f& position);
 
 private:
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
-  void renderHandles(
-    RenderContext& renderContext, const HandleMap& map, Circle& circle, float opacity);
 
   void clear();
 };
@@ -0,0 +1,197 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PreviewAtlas.h"
+
+#include "kdl/reflection_impl.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace TrenchBroom::Renderer
+{
+namespace
+{
+// keeps linear filtering from blending neighbouring previews
+constexpr auto Padding = 1;
+} // namespace
+
+kdl_reflect_impl(PreviewAtlas::Slot);
+
+PreviewAtlas::PreviewAtlas(const int size)
+  : m_size{size}
+{
+  assert(m_size > 0);
+}
+
+PreviewAtlas::~PreviewAtlas()
+{
+  destroy();
+}
+
+bool PreviewAtlas::supported()
+{
+  return GLEW_VERSION_3_0;
+}
+
+int PreviewAtlas::size() const
+{
+  return m_size;
+}
+
+std::optional<PreviewAtlas::Slot> PreviewAtlas::allocate(
+  const int width, const int height)
+{
+  if (width <= 0 || height <= 0 || width > m_size || height > m_size)
+  {
+    return std::nullopt;
+  }
+
+  if (m_shelfX + width > m_size)
+  {
+    // start a new shelf above the current one
+    m_shelfY += m_shelfHeight;
+    m_shelfX = 0;
+    m_shelfHeight = 0;
+  }
+
+  if (m_shelfY + height > m_size)
+  {
+    return std::nullopt;
+  }
+
+  const auto slot = Slot{m_shelfX, m_shelfY, width, height};
+  m_shelfX += width + Padding;
+  m_shelfHeight = std::max(m_shelfHeight, height + Padding);
+  return slot;
+}
+
+void PreviewAtlas::clear()
+{
+  m_shelfX = 0;
+  m_shelfY = 0;
+  m_shelfHeight = 0;
+}
+
+bool PreviewAtlas::bind(const Slot& slot)
+{
+  glAssert(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer));
+  if (m_framebuffer == 0 && !create())
+  {
+    destroy();
+    return false;
+  }
+
+  glAssert(glGetIntegerv(GL_VIEWPORT, m_previousViewport));
+  glAssert(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer));
+  glAssert(glViewport(slot.x, slot.y, slot.width, slot.height));
+
+  auto previousClearColor = std::array<GLfloat, 4>{};
+  glAssert(glGetFloatv(GL_COLOR_CLEAR_VALUE, previousClearColor.data()));
+
+  // only clear the slot, the other slots still hold their previews
+  glAssert(glEnable(GL_SCISSOR_TEST));
+  glAssert(glScissor(slot.x, slot.y, slot.width, slot.height));
+  glAssert(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+  glAssert(glDepthMask(GL_TRUE));
+  glAssert(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+  glAssert(glDisable(GL_SCISSOR_TEST));
+  glAssert(glClearColor(
+    previousClearColor[0],
+    previousClearColor[1],
+    previousClearColor[2],
+    previousClearColor[3]));
+
+  return true;
+}
+
+void PreviewAtlas::unbind()
+{
+  glAssert(
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(m_previousFramebuffer)));
+  glAssert(glViewport(
+    m_previousViewport[0],
+    m_previousViewport[1],
+    m_previousViewport[2],
+    m_previousViewport[3]));
+}
+
+void PreviewAtlas::activate() const
+{
+  glAssert(glBindTexture(GL_TEXTURE_2D, m_texture));
+}
+
+void PreviewAtlas::deactivate() const
+{
+  glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+bool PreviewAtlas::create()
+{
+  glAssert(glGenTextures(1, &m_texture));
+  glAssert(glBindTexture(GL_TEXTURE_2D, m_texture));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+  glAssert(glTexImage2D(
+    GL_TEXTURE_2D, 0, GL_RGBA8, m_size, m_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+  glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+
+  glAssert(glGenRenderbuffers(1, &m_depthBuffer));
+  glAssert(glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer));
+  glAssert(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_size, m_size));
+  glAssert(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+  glAssert(glGenFramebuffers(1, &m_framebuffer));
+  glAssert(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer));
+  glAssert(glFramebufferTexture2D(
+    GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0));
+  glAssert(glFramebufferRenderbuffer(
+    GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer));
+
+  const auto status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+  glAssert(
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(m_previousFramebuffer)));
+
+  return status == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void PreviewAtlas::destroy()
+{
+  if (m_framebuffer != 0)
+  {
+    glAssert(glDeleteFramebuffers(1, &m_framebuffer));
+    m_framebuffer = 0;
+  }
+  if (m_texture != 0)
+  {
+    glAssert(glDeleteTextures(1, &m_texture));
+    m_texture = 0;
+  }
+  if (m_depthBuffer != 0)
+  {
+    glAssert(glDeleteRenderbuffers(1, &m_depthBuffer));
+    m_depthBuffer = 0;
+  }
+}
+
+} // namespace TrenchBroom::Renderer
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "Renderer/GL.h"
+
+#include "kdl/reflection_decl.h"
+
+#include <optional>
+
+namespace TrenchBroom::Renderer
+{
+
+/**
+ * A square offscreen texture which previews are rendered into once, so that they can be
+ * drawn as textured quads afterwards instead of being rendered again in every frame.
+ *
+ * The previews are packed into shelves, i.e. rows whose height is the height of the
+ * tallest preview in the row. Previews cannot be released individually. Once the atlas
+ * is full, it must be cleared and the previews that are still needed must be rendered
+ * again.
+ *
+ * Framebuffer objects are not shared between OpenGL contexts, so the atlas must only be
+ * used while the context in which it was created is current.
+ */
+class PreviewAtlas
+{
+public:
+  static constexpr int DefaultSize = 2048;
+
+  /**
+   * A rectangle in the atlas texture in pixels, with the origin at the bottom left
+   * corner.
+   */
+  struct Slot
+  {
+    int x;
+    int y;
+    int width;
+    int height;
+
+    kdl_reflect_decl(Slot, x, y, width, height);
+  };
+
+private:
+  int m_size;
+  int m_shelfX = 0;
+  int m_shelfY = 0;
+  int m_shelfHeight = 0;
+
+  GLuint m_framebuffer = 0;
+  GLuint m_texture = 0;
+  GLuint m_depthBuffer = 0;
+  GLint m_previousFramebuffer = 0;
+  GLint m_previousViewport[4] = {0, 0, 0, 0};
+
+public:
+  explicit PreviewAtlas(int size = DefaultSize);
+  ~PreviewAtlas();
+
+  deleteCopyAndMove(PreviewAtlas);
+
+  /**
+   * Returns whether the current context supports framebuffer objects.
+   */
+  static bool supported();
+
+  int size() const;
+
+  /**
+   * Reserves a slot of the given size in pixels. Returns std::nullopt if the atlas has
+   * no room left for a slot of that size.
+   */
+  std::optional<Slot> allocate(int width, int height);
+
+  /**
+   * Releases all slots. The contents of the previously allocated slots become undefined.
+   */
+  void clear();
+
+  /**
+   * Binds the atlas as the render target, clears the given slot and restricts the
+   * viewport to it. The previously bound framebuffer and viewport are restored by
+   * unbind.
+   *
+   * Returns false and leaves the current framebuffer bound if the atlas cannot be
+   * created, in which case unbind must not be called.
+   */
+  bool bind(const Slot& slot);
+  void unbind();
+
+  void activate() const;
+  void deactivate() const;
+
+private:
+  bool create();
+  void destroy();
+};
+
+} // namespace TrenchBroom::Renderer
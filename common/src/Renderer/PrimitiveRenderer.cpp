@@ -27,6 +27,7 @@
 #include "Renderer/RenderUtils.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
+#include "Renderer/VboManager.h"
 
 #include "vm/mat.h"
 #include "vm/mat_ext.h"
@@ -183,6 +184,16 @@ void PrimitiveRenderer::TriangleRenderAttributes::render(
   }
 }
 
+PrimitiveRenderer::PrimitiveRenderer()
+  : PrimitiveRenderer(VboUsage::StaticDraw)
+{
+}
+
+PrimitiveRenderer::PrimitiveRenderer(const VboUsage usage)
+  : m_usage(usage)
+{
+}
+
 void PrimitiveRenderer::renderLine(
   const Color& color,
   const float lineWidth,
@@ -318,15 +329,22 @@ void PrimitiveRenderer::renderCylinder(
   const float len = vm::length(vec);
   const vm::vec3f dir = vec / len;
 
-  const vm::mat4x4f translation = vm::translation_matrix(start);
-  const vm::mat4x4f rotation = vm::rotation_matrix(vm::vec3f::pos_z(), dir);
-  const vm::mat4x4f transform = translation * rotation;
+  // transform the cached unit circle directly instead of building a new cylinder
+  const vm::mat4x4f transform = vm::translation_matrix(start)
+                                * vm::rotation_matrix(vm::vec3f::pos_z(), dir)
+                                * vm::scaling_matrix(vm::vec3f(radius, radius, len));
 
-  const VertsAndNormals cylinder = cylinder3D(radius, len, segments);
-  const std::vector<vm::vec3f> vertices = transform * cylinder.vertices;
+  const auto& circle = unitCircle2D(segments);
+  auto vertices = std::vector<Vertex>{};
+  vertices.reserve(2 * circle.size());
+  for (const auto& position : circle)
+  {
+    vertices.emplace_back(transform * vm::vec3f(position, 1.0f));
+    vertices.emplace_back(transform * vm::vec3f(position, 0.0f));
+  }
 
   m_triangleMeshes[TriangleRenderAttributes(color, occlusionPolicy, cullingPolicy)]
-    .addTriangleStrip(Vertex::toList(vertices.size(), std::begin(vertices)));
+    .addTriangleStrip(vertices);
 }
 
 void PrimitiveRenderer::doPrepareVertices(VboManager& vboManager)
@@ -342,7 +360,7 @@ void PrimitiveRenderer::prepareLines(VboManager& vboManager)
     IndexRangeRenderer& renderer =
       m_lineMeshRenderers.insert(std::make_pair(attributes, IndexRangeRenderer(mesh)))
         .first->second;
-    renderer.prepare(vboManager);
+    renderer.prepare(vboManager, m_usage);
   }
 }
 
@@ -353,7 +371,7 @@ void PrimitiveRenderer::prepareTriangles(VboManager& vboManager)
     IndexRangeRenderer& renderer =
       m_triangleMeshRenderers.insert(std::make_pair(attributes, IndexRangeRenderer(mesh)))
         .first->second;
-    renderer.prepare(vboManager);
+    renderer.prepare(vboManager, m_usage);
   }
 }
 
@@ -34,6 +34,7 @@ class ActiveShader;
 template <typename VertexSpec>
 class IndexRangeMapBuilder;
 class IndexRangeRenderer;
+enum class VboUsage;
 
 enum class PrimitiveRendererOcclusionPolicy
 {
@@ -101,7 +102,17 @@ private:
   using TriangleMeshRendererMap = std::map<TriangleRenderAttributes, IndexRangeRenderer>;
   TriangleMeshRendererMap m_triangleMeshRenderers;
 
+  VboUsage m_usage;
+
 public:
+  PrimitiveRenderer();
+
+  /**
+   * Creates a primitive renderer that uploads its vertices into VBOs with the given
+   * usage. Use stream usage for renderers that are only rendered once.
+   */
+  explicit PrimitiveRenderer(VboUsage usage);
+
   void renderLine(
     const Color& color,
     float lineWidth,
@@ -20,11 +20,18 @@
 #include "RenderBatch.h"
 
 #include "Ensure.h"
+#include "Renderer/GpuTimer.h"
+#include "Renderer/RenderContext.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/ShaderManager.h"
 #include "Renderer/VboManager.h"
 
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <optional>
+#include <utility>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -41,6 +48,8 @@ public:
     ensure(m_wrappee != nullptr, "wrappee is null");
   }
 
+  std::optional<RenderSortKey> sortKey() const override { return m_wrappee->sortKey(); }
+
 private:
   void prepareVerticesAndIndices(VboManager& vboManager) override
   {
@@ -53,8 +62,27 @@ private:
   }
 };
 
+class RenderBatch::SectionMarker : public Renderable
+{
+private:
+  GpuTimer& m_gpuTimer;
+  std::string m_name;
+
+public:
+  SectionMarker(GpuTimer& gpuTimer, std::string name)
+    : m_gpuTimer{gpuTimer}
+    , m_name{std::move(name)}
+  {
+  }
+
+private:
+  void doRender(RenderContext&) override { m_gpuTimer.mark(m_name); }
+};
+
 RenderBatch::RenderBatch(VboManager& vboManager)
   : m_vboManager{vboManager}
+  , m_gpuTimer{nullptr}
+  , m_sortRenderables{false}
 {
 }
 
@@ -103,9 +131,35 @@ void RenderBatch::addOneShot(IndexedRenderable* renderable)
   m_oneshots.push_back(renderable);
 }
 
+void RenderBatch::setGpuTimer(GpuTimer* gpuTimer)
+{
+  m_gpuTimer = gpuTimer;
+}
+
+void RenderBatch::beginSection(std::string name)
+{
+  if (m_gpuTimer)
+  {
+    addOneShot(new SectionMarker{*m_gpuTimer, std::move(name)});
+  }
+}
+
+void RenderBatch::setSortRenderables(const bool sortRenderables)
+{
+  m_sortRenderables = sortRenderables;
+}
+
 void RenderBatch::render(RenderContext& renderContext)
 {
+  if (m_gpuTimer)
+  {
+    m_gpuTimer->mark("Prepare");
+  }
   prepareRenderables();
+  if (m_sortRenderables)
+  {
+    sortRenderables();
+  }
   renderRenderables(renderContext);
 }
 
@@ -127,12 +181,56 @@ void RenderBatch::prepareRenderables()
   }
 }
 
+void RenderBatch::sortRenderables()
+{
+  auto run = std::vector<std::pair<RenderSortKey, Renderable*>>{};
+  const auto sortRun = [&](const size_t end) {
+    // stable to keep the order of renderables with equal keys
+    std::stable_sort(run.begin(), run.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    for (size_t i = 0; i < run.size(); ++i)
+    {
+      m_batch[end - run.size() + i] = run[i].second;
+    }
+    run.clear();
+  };
+
+  for (size_t i = 0; i < m_batch.size(); ++i)
+  {
+    if (const auto key = m_batch[i]->sortKey())
+    {
+      run.emplace_back(*key, m_batch[i]);
+    }
+    else
+    {
+      sortRun(i);
+    }
+  }
+  sortRun(m_batch.size());
+}
+
 void RenderBatch::renderRenderables(RenderContext& renderContext)
 {
+  auto& statistics = renderContext.statistics();
+  auto& shaderManager = renderContext.shaderManager();
+  const auto programChanges = shaderManager.programChanges();
+
+  auto previousKey = std::optional<RenderSortKey>{};
   for (auto* renderable : m_batch)
   {
+    // renderables without a sort key always count as a state change
+    const auto key = renderable->sortKey();
+    if (!key || key != previousKey)
+    {
+      ++statistics.stateChanges;
+    }
+    previousKey = key;
+
     renderable->render(renderContext);
   }
+
+  statistics.programChanges += shaderManager.programChanges() - programChanges;
 }
 } // namespace Renderer
 } // namespace TrenchBroom
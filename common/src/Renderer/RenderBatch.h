@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 
 namespace TrenchBroom
@@ -27,6 +28,7 @@ namespace Renderer
 {
 class Renderable;
 class DirectRenderable;
+class GpuTimer;
 class IndexedRenderable;
 class RenderContext;
 class VboManager;
@@ -35,8 +37,10 @@ class RenderBatch
 {
 private:
   VboManager& m_vboManager;
+  GpuTimer* m_gpuTimer;
 
   class IndexedRenderableWrapper;
+  class SectionMarker;
 
   using RenderableList = std::vector<Renderable*>;
   using DirectRenderableList = std::vector<DirectRenderable*>;
@@ -48,6 +52,8 @@ private:
   RenderableList m_batch;
   RenderableList m_oneshots;
 
+  bool m_sortRenderables;
+
 public:
   explicit RenderBatch(VboManager& vboManager);
   ~RenderBatch();
@@ -64,12 +70,38 @@ public:
   void addOneShot(DirectRenderable* renderable);
   void addOneShot(IndexedRenderable* renderable);
 
+  /**
+   * Sets the timer that measures the GPU time of the sections of this batch, or nullptr
+   * to disable timing. The timer's frame must be managed by the caller.
+   */
+  void setGpuTimer(GpuTimer* gpuTimer);
+
+  /**
+   * Begins a new timed section with the given name. All renderables added after this
+   * are attributed to the section until the next section begins. The preparation of the
+   * renderables is timed as a separate section. Does nothing unless a timer is set.
+   */
+  void beginSection(std::string name);
+
+  /**
+   * Sets whether the renderables are sorted by their sort keys before rendering them to
+   * reduce the number of state changes. Only runs of consecutive renderables that have a
+   * sort key are reordered, so renderables without a sort key keep their position
+   * relative to all other renderables. Disabled by default.
+   */
+  void setSortRenderables(bool sortRenderables);
+
+  /**
+   * Renders all renderables and adds the number of state changes to the render context's
+   * statistics.
+   */
   void render(RenderContext& renderContext);
 
 private:
   void doAdd(Renderable* renderable);
 
   void prepareRenderables();
+  void sortRenderables();
 
   void renderRenderables(RenderContext& renderContext);
 };
@@ -46,12 +46,14 @@ RenderContext::RenderContext(
   , m_showBrushEntityBounds(true)
   , m_showPointEntityBounds(true)
   , m_showFog(false)
+  , m_simplifyTinyBrushes(false)
   , m_showGrid(true)
   , m_gridSize(4)
   , m_dpiScale(1.0)
   , m_hideSelection(false)
   , m_tintSelection(true)
   , m_showSelectionGuide(ShowSelectionGuide::Hide)
+  , m_occlusionCuller(nullptr)
 {
 }
 
@@ -195,6 +197,16 @@ void RenderContext::setShowFog(const bool showFog)
   m_showFog = showFog;
 }
 
+bool RenderContext::simplifyTinyBrushes() const
+{
+  return m_simplifyTinyBrushes;
+}
+
+void RenderContext::setSimplifyTinyBrushes(const bool simplifyTinyBrushes)
+{
+  m_simplifyTinyBrushes = simplifyTinyBrushes;
+}
+
 bool RenderContext::showGrid() const
 {
   return m_showGrid;
@@ -281,6 +293,37 @@ void RenderContext::setForceHideSelectionGuide()
   setShowSelectionGuide(ShowSelectionGuide::ForceHide);
 }
 
+OcclusionCuller* RenderContext::occlusionCuller() const
+{
+  return m_occlusionCuller;
+}
+
+void RenderContext::setOcclusionCuller(OcclusionCuller* occlusionCuller)
+{
+  m_occlusionCuller = occlusionCuller;
+}
+
+std::optional<size_t> RenderContext::maxValidatedBrushes() const
+{
+  return m_maxValidatedBrushes;
+}
+
+void RenderContext::setMaxValidatedBrushes(
+  const std::optional<size_t> maxValidatedBrushes)
+{
+  m_maxValidatedBrushes = maxValidatedBrushes;
+}
+
+RenderStatistics& RenderContext::statistics()
+{
+  return m_statistics;
+}
+
+const RenderStatistics& RenderContext::statistics() const
+{
+  return m_statistics;
+}
+
 void RenderContext::setShowSelectionGuide(const ShowSelectionGuide showSelectionGuide)
 {
   switch (showSelectionGuide)
@@ -24,12 +24,16 @@
 
 #include "vm/bbox.h"
 
+#include <cstddef>
+#include <optional>
+
 namespace TrenchBroom
 {
 namespace Renderer
 {
 class Camera;
 class FontManager;
+class OcclusionCuller;
 class ShaderManager;
 
 enum class RenderMode
@@ -38,6 +42,23 @@ enum class RenderMode
   Render2D
 };
 
+/**
+ * Statistics collected while building a frame, shown in the render debug info.
+ */
+struct RenderStatistics
+{
+  size_t visibleBrushes = 0;
+  size_t culledBrushes = 0;
+  size_t occludedBrushes = 0;
+  size_t simplifiedBrushes = 0;
+  // brushes which were not rendered because their render data were not built yet
+  size_t pendingBrushes = 0;
+  // how often a render batch switched to a different shader program
+  size_t programChanges = 0;
+  // how often the sort key changed between consecutive renderables of a render batch
+  size_t stateChanges = 0;
+};
+
 class RenderContext
 {
 private:
@@ -71,6 +92,7 @@ private:
   bool m_showPointEntityBounds;
 
   bool m_showFog;
+  bool m_simplifyTinyBrushes;
 
   bool m_showGrid;
   FloatType m_gridSize;
@@ -82,6 +104,11 @@ private:
   ShowSelectionGuide m_showSelectionGuide;
   vm::bbox3f m_sofMapBounds;
 
+  OcclusionCuller* m_occlusionCuller;
+  std::optional<size_t> m_maxValidatedBrushes;
+
+  RenderStatistics m_statistics;
+
 public:
   RenderContext(
     RenderMode renderMode,
@@ -130,6 +157,13 @@ public:
   bool showFog() const;
   void setShowFog(bool showFog);
 
+  /**
+   * Whether brushes that cover only a few pixels in a 2D view are drawn as aggregated
+   * outlines instead of in full detail.
+   */
+  bool simplifyTinyBrushes() const;
+  void setSimplifyTinyBrushes(bool simplifyTinyBrushes);
+
   bool showGrid() const;
   void setShowGrid(bool showGrid);
 
@@ -154,6 +188,24 @@ public:
   void setForceShowSelectionGuide();
   void setForceHideSelectionGuide();
 
+  /**
+   * Returns the occlusion culler of the rendering view, or null if occlusion culling is
+   * disabled.
+   */
+  OcclusionCuller* occlusionCuller() const;
+  void setOcclusionCuller(OcclusionCuller* occlusionCuller);
+
+  /**
+   * The number of brushes whose render data each brush renderer may build in this frame,
+   * or nothing if there is no limit. Brushes beyond the limit are rendered in a later
+   * frame, so that a frame after a large change does not block the UI for long.
+   */
+  std::optional<size_t> maxValidatedBrushes() const;
+  void setMaxValidatedBrushes(std::optional<size_t> maxValidatedBrushes);
+
+  RenderStatistics& statistics();
+  const RenderStatistics& statistics() const;
+
 private:
   void setShowSelectionGuide(ShowSelectionGuide showSelectionGuide);
 
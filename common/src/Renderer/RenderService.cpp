@@ -33,6 +33,7 @@
 #include "Renderer/RenderUtils.h"
 #include "Renderer/TextAnchor.h"
 #include "Renderer/TextRenderer.h"
+#include "Renderer/VboManager.h"
 
 #include "vm/forward.h"
 #include "vm/polygon.h"
@@ -79,7 +80,7 @@ RenderService::RenderService(RenderContext& renderContext, RenderBatch& renderBa
   , m_renderBatch(renderBatch)
   , m_textRenderer(std::make_unique<TextRenderer>(makeRenderServiceFont()))
   , m_pointHandleRenderer(std::make_unique<PointHandleRenderer>())
-  , m_primitiveRenderer(std::make_unique<PrimitiveRenderer>())
+  , m_primitiveRenderer(std::make_unique<PrimitiveRenderer>(VboUsage::StreamDraw))
   , m_foregroundColor(1.0f, 1.0f, 1.0f, 1.0f)
   , m_backgroundColor(0.0f, 0.0f, 0.0f, 1.0f)
   , m_lineWidth(1.0f)
@@ -27,7 +27,11 @@
 #include "vm/util.h"
 #include "vm/vec.h"
 
+#include "kdl/vector_utils.h"
+
+#include <cmath>
 #include <map>
+#include <mutex>
 
 namespace TrenchBroom
 {
@@ -35,6 +39,49 @@ namespace Renderer
 {
 static const double EdgeOffset = 0.0001;
 
+namespace
+{
+/**
+ * Calls the given function with the index, sine and cosine of segments + 1 evenly spaced
+ * angles, starting at the given start angle. Only the sine and cosine of the start angle
+ * and of the step are evaluated, the remaining angles are obtained by rotating.
+ */
+template <typename F>
+void forEachArcAngle(
+  const float startAngle, const float angleLength, const size_t segments, const F& f)
+{
+  const auto d = double(angleLength) / double(segments);
+  const auto sinD = std::sin(d);
+  const auto cosD = std::cos(d);
+
+  auto s = std::sin(double(startAngle));
+  auto c = std::cos(double(startAngle));
+  for (size_t i = 0; i <= segments; ++i)
+  {
+    f(i, float(s), float(c));
+
+    const auto nextS = s * cosD + c * sinD;
+    c = c * cosD - s * sinD;
+    s = nextS;
+  }
+}
+
+template <typename T, typename B>
+const T& cachedPrimitive(const size_t key, const B& build)
+{
+  static auto mutex = std::mutex{};
+  static auto cache = std::map<size_t, T>{};
+
+  const auto lock = std::lock_guard{mutex};
+  auto it = cache.find(key);
+  if (it == std::end(cache))
+  {
+    it = cache.emplace(key, build()).first;
+  }
+  return it->second;
+}
+} // namespace
+
 vm::vec3f gridColorForTexture(const Assets::Texture* texture)
 {
   if (texture == nullptr)
@@ -128,14 +175,9 @@ std::vector<vm::vec2f> circle2D(
 
   std::vector<vm::vec2f> vertices(segments + 1);
 
-  const float d = angleLength / static_cast<float>(segments);
-  float a = startAngle;
-  for (size_t i = 0; i <= segments; ++i)
-  {
-    vertices[i][0] = radius * std::sin(a);
-    vertices[i][1] = radius * std::cos(a);
-    a += d;
-  }
+  forEachArcAngle(startAngle, angleLength, segments, [&](const auto i, auto s, auto c) {
+    vertices[i] = vm::vec2f{radius * s, radius * c};
+  });
 
   return vertices;
 }
@@ -174,15 +216,11 @@ std::vector<vm::vec3f> circle2D(
     break;
   }
 
-  const float d = angleLength / static_cast<float>(segments);
-  float a = startAngle;
-  for (size_t i = 0; i <= segments; ++i)
-  {
-    vertices[i][x] = radius * std::cos(a);
-    vertices[i][y] = radius * std::sin(a);
+  forEachArcAngle(startAngle, angleLength, segments, [&](const auto i, auto s, auto c) {
+    vertices[i][x] = radius * c;
+    vertices[i][y] = radius * s;
     vertices[i][z] = 0.0f;
-    a += d;
-  }
+  });
 
   return vertices;
 }
@@ -401,14 +439,12 @@ size_t midPoint(
   }
   return it->second;
 }
-} // namespace SphereBuilder
 
-std::vector<vm::vec3f> sphere3D(const float radius, const size_t iterations)
-{
-  assert(radius > 0.0f);
-  assert(iterations > 0);
+std::vector<vm::vec3f> buildUnitSphere(size_t iterations);
 
-  using TriangleList = std::vector<SphereBuilder::Triangle>;
+std::vector<vm::vec3f> buildUnitSphere(const size_t iterations)
+{
+  using TriangleList = std::vector<Triangle>;
 
   std::vector<vm::vec3f> vertices;
   TriangleList triangles;
@@ -431,50 +467,50 @@ std::vector<vm::vec3f> sphere3D(const float radius, const size_t iterations)
   vertices.push_back(normalize(vm::vec3f(-t, 0.0f, 1.0f)));
 
   // 5 triangles around point 0
-  triangles.push_back(SphereBuilder::Triangle(0, 5, 11));
-  triangles.push_back(SphereBuilder::Triangle(0, 1, 5));
-  triangles.push_back(SphereBuilder::Triangle(0, 7, 1));
-  triangles.push_back(SphereBuilder::Triangle(0, 10, 7));
-  triangles.push_back(SphereBuilder::Triangle(0, 11, 10));
+  triangles.push_back(Triangle(0, 5, 11));
+  triangles.push_back(Triangle(0, 1, 5));
+  triangles.push_back(Triangle(0, 7, 1));
+  triangles.push_back(Triangle(0, 10, 7));
+  triangles.push_back(Triangle(0, 11, 10));
 
   // 5 adjacent faces
-  triangles.push_back(SphereBuilder::Triangle(4, 11, 5));
-  triangles.push_back(SphereBuilder::Triangle(9, 5, 1));
-  triangles.push_back(SphereBuilder::Triangle(8, 1, 7));
-  triangles.push_back(SphereBuilder::Triangle(6, 7, 10));
-  triangles.push_back(SphereBuilder::Triangle(2, 10, 11));
+  triangles.push_back(Triangle(4, 11, 5));
+  triangles.push_back(Triangle(9, 5, 1));
+  triangles.push_back(Triangle(8, 1, 7));
+  triangles.push_back(Triangle(6, 7, 10));
+  triangles.push_back(Triangle(2, 10, 11));
 
   // 5 faces around point 3
-  triangles.push_back(SphereBuilder::Triangle(3, 2, 4));
-  triangles.push_back(SphereBuilder::Triangle(3, 6, 2));
-  triangles.push_back(SphereBuilder::Triangle(3, 8, 6));
-  triangles.push_back(SphereBuilder::Triangle(3, 9, 8));
-  triangles.push_back(SphereBuilder::Triangle(3, 4, 9));
+  triangles.push_back(Triangle(3, 2, 4));
+  triangles.push_back(Triangle(3, 6, 2));
+  triangles.push_back(Triangle(3, 8, 6));
+  triangles.push_back(Triangle(3, 9, 8));
+  triangles.push_back(Triangle(3, 4, 9));
 
   // 5 adjacent faces
-  triangles.push_back(SphereBuilder::Triangle(11, 4, 2));
-  triangles.push_back(SphereBuilder::Triangle(10, 2, 6));
-  triangles.push_back(SphereBuilder::Triangle(7, 6, 8));
-  triangles.push_back(SphereBuilder::Triangle(1, 8, 9));
-  triangles.push_back(SphereBuilder::Triangle(5, 9, 4));
+  triangles.push_back(Triangle(11, 4, 2));
+  triangles.push_back(Triangle(10, 2, 6));
+  triangles.push_back(Triangle(7, 6, 8));
+  triangles.push_back(Triangle(1, 8, 9));
+  triangles.push_back(Triangle(5, 9, 4));
 
   // subdivide the icosahedron
-  SphereBuilder::MidPointCache cache;
+  MidPointCache cache;
   for (size_t i = 0; i < iterations; ++i)
   {
     TriangleList newTriangles;
-    for (SphereBuilder::Triangle& triangle : triangles)
+    for (Triangle& triangle : triangles)
     {
       const size_t index1 =
-        SphereBuilder::midPoint(vertices, cache, triangle[0], triangle[1]);
+        midPoint(vertices, cache, triangle[0], triangle[1]);
       const size_t index2 =
-        SphereBuilder::midPoint(vertices, cache, triangle[1], triangle[2]);
+        midPoint(vertices, cache, triangle[1], triangle[2]);
       const size_t index3 =
-        SphereBuilder::midPoint(vertices, cache, triangle[2], triangle[0]);
-      newTriangles.push_back(SphereBuilder::Triangle(triangle[0], index1, index3));
-      newTriangles.push_back(SphereBuilder::Triangle(triangle[1], index2, index1));
-      newTriangles.push_back(SphereBuilder::Triangle(triangle[2], index3, index2));
-      newTriangles.push_back(SphereBuilder::Triangle(index1, index2, index3));
+        midPoint(vertices, cache, triangle[2], triangle[0]);
+      newTriangles.push_back(Triangle(triangle[0], index1, index3));
+      newTriangles.push_back(Triangle(triangle[1], index2, index1));
+      newTriangles.push_back(Triangle(triangle[2], index3, index2));
+      newTriangles.push_back(Triangle(index1, index2, index3));
     }
     triangles = std::move(newTriangles);
   }
@@ -482,14 +518,46 @@ std::vector<vm::vec3f> sphere3D(const float radius, const size_t iterations)
   std::vector<vm::vec3f> allVertices;
   allVertices.reserve(3 * triangles.size());
 
-  for (SphereBuilder::Triangle& triangle : triangles)
+  for (Triangle& triangle : triangles)
   {
     for (size_t i = 0; i < 3; ++i)
-      allVertices.push_back(radius * vertices[triangle[i]]);
+      allVertices.push_back(vertices[triangle[i]]);
   }
 
   return allVertices;
 }
+} // namespace SphereBuilder
+
+const std::vector<vm::vec3f>& unitSphere3D(const size_t iterations)
+{
+  assert(iterations > 0);
+
+  return cachedPrimitive<std::vector<vm::vec3f>>(
+    iterations, [&]() { return SphereBuilder::buildUnitSphere(iterations); });
+}
+
+std::vector<vm::vec3f> sphere3D(const float radius, const size_t iterations)
+{
+  assert(radius > 0.0f);
+
+  return kdl::vec_transform(
+    unitSphere3D(iterations), [&](const auto& vertex) { return radius * vertex; });
+}
+
+const std::vector<vm::vec2f>& unitCircle2D(const size_t segments)
+{
+  assert(segments > 0);
+
+  return cachedPrimitive<std::vector<vm::vec2f>>(segments, [&]() {
+    auto vertices = std::vector<vm::vec2f>(segments + 1);
+    forEachArcAngle(0.0f, vm::Cf::two_pi(), segments, [&](const auto i, auto s, auto c) {
+      vertices[i] = vm::vec2f{s, c};
+    });
+    // close the circle exactly
+    vertices[segments] = vertices[0];
+    return vertices;
+  });
+}
 
 VertsAndNormals::VertsAndNormals(const size_t vertexCount)
   : vertices(vertexCount)
@@ -504,13 +572,11 @@ VertsAndNormals circle3D(const float radius, const size_t segments)
 
   VertsAndNormals result(segments);
 
-  float a = 0.0f;
-  const float d = 2.0f * vm::Cf::pi() / static_cast<float>(segments);
+  const auto& circle = unitCircle2D(segments);
   for (size_t i = 0; i < segments; i++)
   {
-    result.vertices[i] = vm::vec3f(radius * std::sin(a), radius * std::cos(a), 0.0f);
+    result.vertices[i] = vm::vec3f(radius * circle[i], 0.0f);
     result.normals[i] = vm::vec3f::pos_z();
-    a += d;
   }
   return result;
 }
@@ -523,18 +589,12 @@ VertsAndNormals cylinder3D(const float radius, const float length, const size_t
 
   VertsAndNormals result(2 * (segments + 1));
 
-  float a = 0.0f;
-  const float d = 2.0f * vm::Cf::pi() / static_cast<float>(segments);
+  const auto& circle = unitCircle2D(segments);
   for (size_t i = 0; i <= segments; ++i)
   {
-    const float s = std::sin(a);
-    const float c = std::cos(a);
-    const float x = radius * s;
-    const float y = radius * c;
-    result.vertices[2 * i + 0] = vm::vec3f(x, y, length);
-    result.vertices[2 * i + 1] = vm::vec3f(x, y, 0.0f);
-    result.normals[2 * i + 0] = result.normals[2 * i + 1] = vm::vec3f(s, c, 0.0f);
-    a += d;
+    result.vertices[2 * i + 0] = vm::vec3f(radius * circle[i], length);
+    result.vertices[2 * i + 1] = vm::vec3f(radius * circle[i], 0.0f);
+    result.normals[2 * i + 0] = result.normals[2 * i + 1] = vm::vec3f(circle[i], 0.0f);
   }
   return result;
 }
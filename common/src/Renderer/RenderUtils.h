@@ -87,6 +87,20 @@ struct VertsAndNormals
   explicit VertsAndNormals(size_t vertexCount);
 };
 
+/**
+ * Returns the vertices of a unit circle in the XY plane, starting at (0, 1) and going
+ * clockwise. The circle is divided into the given number of segments, and the last vertex
+ * repeats the first. The vertices are computed once per number of segments and cached.
+ */
+const std::vector<vm::vec2f>& unitCircle2D(size_t segments);
+
+/**
+ * Returns the triangles of a unit sphere that is built by subdividing an icosahedron the
+ * given number of times. The triangles are computed once per number of iterations and
+ * cached.
+ */
+const std::vector<vm::vec3f>& unitSphere3D(size_t iterations);
+
 std::vector<vm::vec3f> sphere3D(float radius, size_t iterations);
 VertsAndNormals circle3D(float radius, size_t segments);
 VertsAndNormals cylinder3D(float radius, float length, size_t segments);
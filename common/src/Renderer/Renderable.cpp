@@ -19,15 +19,46 @@
 
 #include "Renderable.h"
 
+#include <functional>
+
 namespace TrenchBroom
 {
 namespace Renderer
 {
+bool operator==(const RenderSortKey& lhs, const RenderSortKey& rhs)
+{
+  return lhs.shader == rhs.shader && lhs.texture == rhs.texture
+         && lhs.state == rhs.state;
+}
+
+bool operator!=(const RenderSortKey& lhs, const RenderSortKey& rhs)
+{
+  return !(lhs == rhs);
+}
+
+bool operator<(const RenderSortKey& lhs, const RenderSortKey& rhs)
+{
+  if (lhs.shader != rhs.shader)
+  {
+    return std::less<const ShaderConfig*>{}(lhs.shader, rhs.shader);
+  }
+  if (lhs.texture != rhs.texture)
+  {
+    return std::less<const Assets::Texture*>{}(lhs.texture, rhs.texture);
+  }
+  return lhs.state < rhs.state;
+}
+
 void Renderable::render(RenderContext& renderContext)
 {
   doRender(renderContext);
 }
 
+std::optional<RenderSortKey> Renderable::sortKey() const
+{
+  return std::nullopt;
+}
+
 void DirectRenderable::prepareVertices(VboManager& vboManager)
 {
   doPrepareVertices(vboManager);
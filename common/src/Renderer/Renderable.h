@@ -21,13 +21,40 @@
 
 #include "Macros.h"
 
+#include <cstddef>
+#include <optional>
+
 namespace TrenchBroom
 {
+namespace Assets
+{
+class Texture;
+}
+
 namespace Renderer
 {
 class RenderContext;
+class ShaderConfig;
 class VboManager;
 
+/**
+ * Describes the state that a renderable sets up when it is rendered. A render batch can
+ * use this to reorder its renderables so that consecutive renderables share as much state
+ * as possible.
+ */
+struct RenderSortKey
+{
+  const ShaderConfig* shader = nullptr;
+  // the texture if the renderable only uses one
+  const Assets::Texture* texture = nullptr;
+  // identifies any other state, renderables with equal values set up the same state
+  size_t state = 0;
+};
+
+bool operator==(const RenderSortKey& lhs, const RenderSortKey& rhs);
+bool operator!=(const RenderSortKey& lhs, const RenderSortKey& rhs);
+bool operator<(const RenderSortKey& lhs, const RenderSortKey& rhs);
+
 class Renderable
 {
 public:
@@ -36,6 +63,14 @@ public:
 
   void render(RenderContext& renderContext);
 
+  /**
+   * Returns the key by which this renderable may be reordered relative to other sortable
+   * renderables. Renderables whose results depend on what was rendered before them, e.g.
+   * because they blend, disable the depth test or render an overlay, must return nullopt
+   * so that they keep their position in the batch.
+   */
+  virtual std::optional<RenderSortKey> sortKey() const;
+
 private:
   virtual void doRender(RenderContext& renderContext) = 0;
 
@@ -21,7 +21,10 @@
 
 #include "Ensure.h"
 #include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/DiskIO.h"
 #include "IO/SystemPaths.h"
+#include "Model/ContentHasher.h"
 #include "Renderer/ShaderConfig.h"
 
 #include "kdl/result.h"
@@ -29,11 +32,103 @@
 #include "kdl/vector_utils.h"
 
 #include <cassert>
+#include <cstdint>
 #include <filesystem>
+#include <iterator>
 #include <string>
 
 namespace TrenchBroom::Renderer
 {
+namespace
+{
+
+struct ProgramCacheHeader
+{
+  std::uint32_t magic;
+  std::uint32_t format;
+  std::uint64_t key;
+};
+
+// "TBPB", change this if the layout of the cache files changes
+constexpr auto ProgramCacheMagic = std::uint32_t{0x42504254};
+
+std::filesystem::path shaderPath(const std::string& name)
+{
+  return IO::SystemPaths::findResourceFile(std::filesystem::path{"shader"} / name);
+}
+
+std::string glString(const GLenum name)
+{
+  const auto* str = reinterpret_cast<const char*>(glGetString(name));
+  return str ? str : "";
+}
+
+/**
+ * Returns a key that changes whenever the driver or the source of any of the given
+ * program's shaders changes.
+ */
+Result<std::uint64_t> programKey(const ShaderConfig& config)
+{
+  auto hasher = Model::ContentHasher{};
+  hasher.add(glString(GL_VENDOR)).add(glString(GL_RENDERER)).add(glString(GL_VERSION));
+
+  const auto shaderNames =
+    kdl::vec_concat(config.vertexShaders(), config.fragmentShaders());
+  return kdl::fold_results(kdl::vec_transform(
+                             shaderNames,
+                             [&](const auto& name) {
+                               return IO::Disk::withInputStream(
+                                 shaderPath(name), [&](auto& stream) {
+                                   hasher.add(name).add(std::string{
+                                     std::istreambuf_iterator<char>{stream}, {}});
+                                 });
+                             }))
+    .transform([&]() { return hasher.hash(); });
+}
+
+Result<ShaderProgramBinary> readProgramBinary(
+  const std::filesystem::path& path, const std::uint64_t key)
+{
+  return IO::Disk::withInputStream(
+    path,
+    std::ios::in | std::ios::binary,
+    [&](auto& stream) -> Result<ShaderProgramBinary> {
+      auto header = ProgramCacheHeader{};
+      stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+      if (!stream || header.magic != ProgramCacheMagic || header.key != key)
+      {
+        return Error{"Cached shader program '" + path.string() + "' is out of date"};
+      }
+
+      return ShaderProgramBinary{
+        GLenum(header.format),
+        std::vector<unsigned char>{std::istreambuf_iterator<char>{stream}, {}}};
+    });
+}
+
+Result<void> writeProgramBinary(
+  const std::filesystem::path& path,
+  const std::uint64_t key,
+  const ShaderProgramBinary& binary)
+{
+  return IO::writeCacheFile(path, [&](auto& stream) {
+    const auto header =
+      ProgramCacheHeader{ProgramCacheMagic, std::uint32_t(binary.format), key};
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(
+      reinterpret_cast<const char*>(binary.data.data()),
+      std::streamsize(binary.data.size()));
+  });
+}
+
+} // namespace
+
+ShaderManager::ShaderManager() = default;
+
+ShaderManager::ShaderManager(std::filesystem::path programCacheDirectory)
+  : m_programCacheDirectory{std::move(programCacheDirectory)}
+{
+}
 
 Result<void> ShaderManager::loadProgram(const ShaderConfig& config)
 {
@@ -46,6 +141,11 @@ Result<void> ShaderManager::loadProgram(const ShaderConfig& config)
   });
 }
 
+bool ShaderManager::hasProgram(const ShaderConfig& config) const
+{
+  return m_programs.find(config.name()) != std::end(m_programs);
+}
+
 ShaderProgram& ShaderManager::program(const ShaderConfig& config)
 {
   auto it = m_programs.find(config.name());
@@ -58,12 +158,60 @@ ShaderProgram* ShaderManager::currentProgram()
   return m_currentProgram;
 }
 
+size_t ShaderManager::programChanges() const
+{
+  return m_programChanges;
+}
+
 void ShaderManager::setCurrentProgram(ShaderProgram* program)
 {
   m_currentProgram = program;
+  if (program != nullptr && program != m_lastProgram)
+  {
+    m_lastProgram = program;
+    ++m_programChanges;
+  }
 }
 
 Result<ShaderProgram> ShaderManager::createProgram(const ShaderConfig& config)
+{
+  if (!m_programCacheDirectory || !shaderProgramBinariesSupported())
+  {
+    return compileProgram(config, false);
+  }
+
+  const auto cachePath = *m_programCacheDirectory / (config.name() + ".bin");
+  const auto key = programKey(config);
+  if (key.is_success())
+  {
+    auto cachedProgram =
+      readProgramBinary(cachePath, key.value()).and_then([&](const auto& binary) {
+        return createShaderProgram(config.name()).and_then([&](auto program) {
+          return program.loadBinary(binary).transform(
+            [&]() { return std::move(program); });
+        });
+      });
+    if (cachedProgram.is_success())
+    {
+      return cachedProgram;
+    }
+  }
+
+  return compileProgram(config, true).transform([&](auto program) {
+    if (key.is_success())
+    {
+      // the cache is only an optimization, so failing to update it is not an error
+      const auto writeResult = program.binary().and_then([&](const auto& binary) {
+        return writeProgramBinary(cachePath, key.value(), binary);
+      });
+      unused(writeResult);
+    }
+    return program;
+  });
+}
+
+Result<ShaderProgram> ShaderManager::compileProgram(
+  const ShaderConfig& config, const bool retrievable)
 {
   return createShaderProgram(config.name())
     .and_then([&](auto program) {
@@ -88,6 +236,10 @@ Result<ShaderProgram> ShaderManager::createProgram(const ShaderConfig& config)
         .transform([&]() { return std::move(program); });
     })
     .and_then([&](auto program) {
+      if (retrievable)
+      {
+        program.setBinaryRetrievable();
+      }
       return program.link().transform([&]() { return std::move(program); });
     });
 }
@@ -101,10 +253,7 @@ Result<std::reference_wrapper<Shader>> ShaderManager::loadShader(
     return std::ref(it->second);
   }
 
-  const auto shaderPath =
-    IO::SystemPaths::findResourceFile(std::filesystem::path{"shader"} / name);
-
-  return Renderer::loadShader(shaderPath, type).transform([&](auto shader) {
+  return Renderer::loadShader(shaderPath(name), type).transform([&](auto shader) {
     const auto [insertIt, inserted] = m_shaders.emplace(name, std::move(shader));
 
     assert(inserted);
@@ -24,6 +24,8 @@
 #include "Renderer/ShaderProgram.h"
 #include "Result.h"
 
+#include <filesystem>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -41,15 +43,36 @@ private:
   ShaderCache m_shaders;
   ShaderProgramCache m_programs;
   ShaderProgram* m_currentProgram{nullptr};
+  ShaderProgram* m_lastProgram{nullptr};
+  size_t m_programChanges{0};
+  std::optional<std::filesystem::path> m_programCacheDirectory;
 
 public:
+  ShaderManager();
+
+  /**
+   * Creates a shader manager that stores the binaries of linked programs in the given
+   * directory and loads them from there instead of compiling the programs again. The
+   * cached binaries are keyed by the driver and the shader sources, and a program is
+   * compiled from source if its binary cannot be loaded.
+   */
+  explicit ShaderManager(std::filesystem::path programCacheDirectory);
+
   Result<void> loadProgram(const ShaderConfig& config);
+  bool hasProgram(const ShaderConfig& config) const;
   ShaderProgram& program(const ShaderConfig& config);
   ShaderProgram* currentProgram();
 
+  /**
+   * Returns how often a program was activated that differs from the previously activated
+   * program. Deactivating a program does not count.
+   */
+  size_t programChanges() const;
+
 private:
   void setCurrentProgram(ShaderProgram* program);
   Result<ShaderProgram> createProgram(const ShaderConfig& config);
+  Result<ShaderProgram> compileProgram(const ShaderConfig& config, bool retrievable);
   Result<std::reference_wrapper<Shader>> loadShader(const std::string& name, GLenum type);
 };
 } // namespace TrenchBroom::Renderer
@@ -109,6 +109,49 @@ Result<void> ShaderProgram::link()
   return kdl::void_success;
 }
 
+void ShaderProgram::setBinaryRetrievable()
+{
+  assert(m_programId != 0);
+  glAssert(glProgramParameteri(m_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+}
+
+Result<void> ShaderProgram::loadBinary(const ShaderProgramBinary& binary)
+{
+  assert(m_programId != 0);
+  glAssert(glProgramBinary(
+    m_programId, binary.format, binary.data.data(), GLsizei(binary.data.size())));
+
+  auto linkStatus = GLint(0);
+  glAssert(glGetProgramiv(m_programId, GL_LINK_STATUS, &linkStatus));
+
+  if (linkStatus == 0)
+  {
+    return Error{"Could not load binary of shader program '" + m_name + "'"};
+  }
+
+  return kdl::void_success;
+}
+
+Result<ShaderProgramBinary> ShaderProgram::binary() const
+{
+  assert(m_programId != 0);
+
+  auto binaryLength = GLint(0);
+  glAssert(glGetProgramiv(m_programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength));
+
+  if (binaryLength <= 0)
+  {
+    return Error{"Could not get binary of shader program '" + m_name + "'"};
+  }
+
+  auto result = ShaderProgramBinary{0, std::vector<unsigned char>(size_t(binaryLength))};
+  glAssert(glGetProgramBinary(
+    m_programId, binaryLength, &binaryLength, &result.format, result.data.data()));
+  result.data.resize(size_t(binaryLength));
+
+  return result;
+}
+
 void ShaderProgram::activate(ShaderManager& shaderManager)
 {
   assert(m_programId != 0);
@@ -126,73 +169,78 @@ void ShaderProgram::deactivate(ShaderManager& shaderManager)
   shaderManager.setCurrentProgram(nullptr);
 }
 
-void ShaderProgram::set(const std::string& name, const bool value)
+void ShaderProgram::set(const UniformHandle uniform, const bool value)
 {
-  return set(name, int(value));
+  return set(uniform, int(value));
 }
 
-void ShaderProgram::set(const std::string& name, const int value)
+void ShaderProgram::set(const UniformHandle uniform, const int value)
 {
   assert(checkActive());
-  glAssert(glUniform1i(findUniformLocation(name), value));
+  glAssert(glUniform1i(uniform.location, value));
 }
 
-void ShaderProgram::set(const std::string& name, const size_t value)
+void ShaderProgram::set(const UniformHandle uniform, const size_t value)
 {
   assert(checkActive());
-  glAssert(glUniform1i(findUniformLocation(name), int(value)));
+  glAssert(glUniform1i(uniform.location, int(value)));
 }
 
-void ShaderProgram::set(const std::string& name, const float value)
+void ShaderProgram::set(const UniformHandle uniform, const float value)
 {
   assert(checkActive());
-  glAssert(glUniform1f(findUniformLocation(name), value));
+  glAssert(glUniform1f(uniform.location, value));
 }
 
-void ShaderProgram::set(const std::string& name, const double value)
+void ShaderProgram::set(const UniformHandle uniform, const double value)
 {
   assert(checkActive());
-  glAssert(glUniform1d(findUniformLocation(name), value));
+  glAssert(glUniform1d(uniform.location, value));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::vec2f& value)
+void ShaderProgram::set(const UniformHandle uniform, const vm::vec2f& value)
 {
   assert(checkActive());
-  glAssert(glUniform2f(findUniformLocation(name), value.x(), value.y()));
+  glAssert(glUniform2f(uniform.location, value.x(), value.y()));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::vec3f& value)
+void ShaderProgram::set(const UniformHandle uniform, const vm::vec3f& value)
 {
   assert(checkActive());
-  glAssert(glUniform3f(findUniformLocation(name), value.x(), value.y(), value.z()));
+  glAssert(glUniform3f(uniform.location, value.x(), value.y(), value.z()));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::vec4f& value)
+void ShaderProgram::set(const UniformHandle uniform, const vm::vec4f& value)
 {
   assert(checkActive());
   glAssert(
-    glUniform4f(findUniformLocation(name), value.x(), value.y(), value.z(), value.w()));
+    glUniform4f(uniform.location, value.x(), value.y(), value.z(), value.w()));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::mat2x2f& value)
+void ShaderProgram::set(const UniformHandle uniform, const vm::mat2x2f& value)
 {
   assert(checkActive());
   glAssert(glUniformMatrix2fv(
-    findUniformLocation(name), 1, false, reinterpret_cast<const float*>(value.v)));
+    uniform.location, 1, false, reinterpret_cast<const float*>(value.v)));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::mat3x3f& value)
+void ShaderProgram::set(const UniformHandle uniform, const vm::mat3x3f& value)
 {
   assert(checkActive());
   glAssert(glUniformMatrix3fv(
-    findUniformLocation(name), 1, false, reinterpret_cast<const float*>(value.v)));
+    uniform.location, 1, false, reinterpret_cast<const float*>(value.v)));
 }
 
-void ShaderProgram::set(const std::string& name, const vm::mat4x4f& value)
+void ShaderProgram::set(const UniformHandle uniform, const vm::mat4x4f& value)
 {
   assert(checkActive());
   glAssert(glUniformMatrix4fv(
-    findUniformLocation(name), 1, false, reinterpret_cast<const float*>(value.v)));
+    uniform.location, 1, false, reinterpret_cast<const float*>(value.v)));
+}
+
+UniformHandle ShaderProgram::uniform(const std::string& name) const
+{
+  return UniformHandle{findUniformLocation(name)};
 }
 
 GLint ShaderProgram::findAttributeLocation(const std::string& name) const
@@ -249,4 +297,17 @@ Result<ShaderProgram> createShaderProgram(std::string name)
   return ShaderProgram{std::move(name), programId};
 }
 
+bool shaderProgramBinariesSupported()
+{
+  if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+  {
+    return false;
+  }
+
+  // some drivers support the extension, but do not provide any binary formats
+  auto formatCount = GLint(0);
+  glAssert(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+  return formatCount > 0;
+}
+
 } // namespace TrenchBroom::Renderer
@@ -27,6 +27,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom::Renderer
 {
@@ -34,6 +35,25 @@ namespace TrenchBroom::Renderer
 class ShaderManager;
 class Shader;
 
+/**
+ * A linked program in the driver specific format returned by glGetProgramBinary.
+ */
+struct ShaderProgramBinary
+{
+  GLenum format;
+  std::vector<unsigned char> data;
+};
+
+/**
+ * The location of a uniform variable in a shader program. Renderers that set a uniform
+ * many times per frame, e.g. once per texture or per instance, should resolve its handle
+ * once and set it through the handle to avoid looking up the location by name each time.
+ */
+struct UniformHandle
+{
+  GLint location;
+};
+
 class ShaderProgram
 {
 private:
@@ -60,20 +80,42 @@ public:
   void attach(Shader& shader) const;
   Result<void> link();
 
+  /**
+   * Asks the driver to keep the binary of this program available. Must be called before
+   * linking the program for binary() to succeed.
+   */
+  void setBinaryRetrievable();
+
+  /**
+   * Loads a previously retrieved binary into this program instead of attaching shaders
+   * and linking them. Fails if the driver rejects the binary, e.g. because it was created
+   * by a different driver version.
+   */
+  Result<void> loadBinary(const ShaderProgramBinary& binary);
+  Result<ShaderProgramBinary> binary() const;
+
   void activate(ShaderManager& shaderManager);
   void deactivate(ShaderManager& shaderManager);
 
-  void set(const std::string& name, bool value);
-  void set(const std::string& name, int value);
-  void set(const std::string& name, size_t value);
-  void set(const std::string& name, float value);
-  void set(const std::string& name, double value);
-  void set(const std::string& name, const vm::vec2f& value);
-  void set(const std::string& name, const vm::vec3f& value);
-  void set(const std::string& name, const vm::vec4f& value);
-  void set(const std::string& name, const vm::mat2x2f& value);
-  void set(const std::string& name, const vm::mat3x3f& value);
-  void set(const std::string& name, const vm::mat4x4f& value);
+  UniformHandle uniform(const std::string& name) const;
+
+  template <typename T>
+  void set(const std::string& name, const T& value)
+  {
+    set(uniform(name), value);
+  }
+
+  void set(UniformHandle uniform, bool value);
+  void set(UniformHandle uniform, int value);
+  void set(UniformHandle uniform, size_t value);
+  void set(UniformHandle uniform, float value);
+  void set(UniformHandle uniform, double value);
+  void set(UniformHandle uniform, const vm::vec2f& value);
+  void set(UniformHandle uniform, const vm::vec3f& value);
+  void set(UniformHandle uniform, const vm::vec4f& value);
+  void set(UniformHandle uniform, const vm::mat2x2f& value);
+  void set(UniformHandle uniform, const vm::mat3x3f& value);
+  void set(UniformHandle uniform, const vm::mat4x4f& value);
 
   GLint findAttributeLocation(const std::string& name) const;
 
@@ -84,4 +126,9 @@ private:
 
 Result<ShaderProgram> createShaderProgram(std::string name);
 
+/**
+ * Returns whether the current context can retrieve and load program binaries.
+ */
+bool shaderProgramBinariesSupported();
+
 } // namespace TrenchBroom::Renderer
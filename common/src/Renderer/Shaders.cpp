@@ -96,6 +96,11 @@ const ShaderConfig ColoredHandleShader = ShaderConfig{
   {"ColoredHandle.vertsh"},
   {"Handle.fragsh"},
 };
+const ShaderConfig HandleSpriteShader = ShaderConfig{
+  "Handle Sprite",
+  {"HandleSprite.vertsh"},
+  {"HandleSprite.fragsh"},
+};
 const ShaderConfig CompassShader = ShaderConfig{
   "Compass",
   {"Compass.vertsh"},
@@ -126,6 +131,11 @@ const ShaderConfig TriangleShader = ShaderConfig{
   {"Triangle.vertsh"},
   {"Triangle.fragsh"},
 };
+const ShaderConfig PickIdShader = ShaderConfig{
+  "Pick ID",
+  {"PickId.vertsh"},
+  {"PickId.fragsh"},
+};
 const ShaderConfig UVViewShader = ShaderConfig{
   "UV View",
   {"UVView.vertsh"},
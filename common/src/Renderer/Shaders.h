@@ -37,11 +37,13 @@ extern const ShaderConfig TextureBrowserShader;
 extern const ShaderConfig TextureBrowserBorderShader;
 extern const ShaderConfig HandleShader;
 extern const ShaderConfig ColoredHandleShader;
+extern const ShaderConfig HandleSpriteShader;
 extern const ShaderConfig CompassShader;
 extern const ShaderConfig CompassOutlineShader;
 extern const ShaderConfig CompassBackgroundShader;
 extern const ShaderConfig LinkLineShader;
 extern const ShaderConfig LinkArrowShader;
 extern const ShaderConfig TriangleShader;
+extern const ShaderConfig PickIdShader;
 extern const ShaderConfig UVViewShader;
 } // namespace TrenchBroom::Renderer::Shaders
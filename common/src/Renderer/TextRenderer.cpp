@@ -46,18 +46,15 @@ const size_t TextRenderer::RectCornerSegments = 3;
 const float TextRenderer::RectCornerRadius = 3.0f;
 
 TextRenderer::Entry::Entry(
-  std::vector<vm::vec2f>& i_vertices,
-  const vm::vec2f& i_size,
+  std::shared_ptr<const TextureFont::StringGeometry> i_geometry,
   const vm::vec3f& i_offset,
   const Color& i_textColor,
   const Color& i_backgroundColor)
-  : size(i_size)
+  : geometry(std::move(i_geometry))
   , offset(i_offset)
   , textColor(i_textColor)
   , backgroundColor(i_backgroundColor)
 {
-  using std::swap;
-  swap(vertices, i_vertices);
 }
 
 TextRenderer::EntryCollection::EntryCollection()
@@ -106,49 +103,34 @@ void TextRenderer::renderString(
   const TextAnchor& position,
   const bool onTop)
 {
-
   const Camera& camera = renderContext.camera();
   const float distance = camera.perpendicularDistanceTo(position.position(camera));
-  if (distance <= 0.0f)
-    return;
-
-  if (!isVisible(renderContext, string, position, distance, onTop))
+  if (distance <= 0.0f || !isInRange(renderContext, distance, onTop))
     return;
 
+  // the geometry is cached by the font, so labels whose text doesn't change are only
+  // laid out once
   FontManager& fontManager = renderContext.fontManager();
   TextureFont& font = fontManager.font(m_fontDescriptor);
+  auto geometry = font.geometry(string);
 
-  std::vector<vm::vec2f> vertices = font.quads(string, true);
-  const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-  const vm::vec2f size = font.measure(string);
-  const vm::vec3f offset = position.offset(camera, size);
+  if (!isInViewport(renderContext, geometry->size, position))
+    return;
 
-  if (onTop)
-    addEntry(
-      m_entriesOnTop,
-      Entry(
-        vertices,
-        size,
-        offset,
-        Color(textColor, alphaFactor * textColor.a()),
-        Color(backgroundColor, alphaFactor * backgroundColor.a())));
-  else
-    addEntry(
-      m_entries,
-      Entry(
-        vertices,
-        size,
-        offset,
-        Color(textColor, alphaFactor * textColor.a()),
-        Color(backgroundColor, alphaFactor * backgroundColor.a())));
+  const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
+  const vm::vec3f offset = position.offset(camera, geometry->size);
+
+  addEntry(
+    onTop ? m_entriesOnTop : m_entries,
+    Entry(
+      std::move(geometry),
+      offset,
+      Color(textColor, alphaFactor * textColor.a()),
+      Color(backgroundColor, alphaFactor * backgroundColor.a())));
 }
 
-bool TextRenderer::isVisible(
-  RenderContext& renderContext,
-  const AttrString& string,
-  const TextAnchor& position,
-  const float distance,
-  const bool onTop) const
+bool TextRenderer::isInRange(
+  RenderContext& renderContext, const float distance, const bool onTop) const
 {
   if (!onTop)
   {
@@ -157,13 +139,18 @@ bool TextRenderer::isVisible(
     if (renderContext.render2D() && renderContext.camera().zoom() < m_minZoomFactor)
       return false;
   }
+  return true;
+}
 
+bool TextRenderer::isInViewport(
+  RenderContext& renderContext, const vm::vec2f& size, const TextAnchor& position) const
+{
   const Camera& camera = renderContext.camera();
   const Camera::Viewport& viewport = camera.viewport();
 
-  const vm::vec2f size = stringSize(renderContext, string);
-  const vm::vec2f offset = vm::vec2f(position.offset(camera, size)) - m_inset;
-  const vm::vec2f actualSize = size + 2.0f * m_inset;
+  const vm::vec2f roundedSize = round(size);
+  const vm::vec2f offset = vm::vec2f(position.offset(camera, roundedSize)) - m_inset;
+  const vm::vec2f actualSize = roundedSize + 2.0f * m_inset;
 
   return viewport.contains(offset.x(), offset.y(), actualSize.x(), actualSize.y());
 }
@@ -191,19 +178,11 @@ float TextRenderer::computeAlphaFactor(
   }
 }
 
-void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry)
+void TextRenderer::addEntry(EntryCollection& collection, Entry entry)
 {
-  collection.entries.push_back(entry);
-  collection.textVertexCount += entry.vertices.size();
+  collection.textVertexCount += entry.geometry->vertices.size();
   collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
-}
-
-vm::vec2f TextRenderer::stringSize(
-  RenderContext& renderContext, const AttrString& string) const
-{
-  FontManager& fontManager = renderContext.fontManager();
-  TextureFont& font = fontManager.font(m_fontDescriptor);
-  return round(font.measure(string));
+  collection.entries.push_back(std::move(entry));
 }
 
 void TextRenderer::doPrepareVertices(VboManager& vboManager)
@@ -229,8 +208,8 @@ void TextRenderer::prepare(
   collection.textArray = VertexArray::move(std::move(textVertices));
   collection.rectArray = VertexArray::move(std::move(rectVertices));
 
-  collection.textArray.prepare(vboManager);
-  collection.rectArray.prepare(vboManager);
+  collection.textArray.prepare(vboManager, VboUsage::StreamDraw);
+  collection.rectArray.prepare(vboManager, VboUsage::StreamDraw);
 }
 
 void TextRenderer::addEntry(
@@ -239,8 +218,8 @@ void TextRenderer::addEntry(
   std::vector<TextVertex>& textVertices,
   std::vector<RectVertex>& rectVertices)
 {
-  const std::vector<vm::vec2f>& stringVertices = entry.vertices;
-  const vm::vec2f& stringSize = entry.size;
+  const std::vector<vm::vec2f>& stringVertices = entry.geometry->vertices;
+  const vm::vec2f& stringSize = entry.geometry->size;
 
   const vm::vec3f& offset = entry.offset;
 
@@ -23,11 +23,13 @@
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/GLVertexType.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/TextureFont.h"
 #include "Renderer/VertexArray.h"
 
 #include "vm/forward.h"
 #include "vm/vec.h"
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom
@@ -49,15 +51,13 @@ private:
 
   struct Entry
   {
-    std::vector<vm::vec2f> vertices;
-    vm::vec2f size;
+    std::shared_ptr<const TextureFont::StringGeometry> geometry;
     vm::vec3f offset;
     Color textColor;
     Color backgroundColor;
 
     Entry(
-      std::vector<vm::vec2f>& i_vertices,
-      const vm::vec2f& i_size,
+      std::shared_ptr<const TextureFont::StringGeometry> i_geometry,
       const vm::vec3f& i_offset,
       const Color& i_textColor,
       const Color& i_backgroundColor);
@@ -117,17 +117,14 @@ private:
     const TextAnchor& position,
     bool onTop);
 
-  bool isVisible(
+  bool isInRange(RenderContext& renderContext, float distance, bool onTop) const;
+  bool isInViewport(
     RenderContext& renderContext,
-    const AttrString& string,
-    const TextAnchor& position,
-    float distance,
-    bool onTop) const;
+    const vm::vec2f& size,
+    const TextAnchor& position) const;
   float computeAlphaFactor(
     const RenderContext& renderContext, float distance, bool onTop) const;
-  void addEntry(EntryCollection& collection, const Entry& entry);
-
-  vm::vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
+  void addEntry(EntryCollection& collection, Entry entry);
 
 private:
   void doPrepareVertices(VboManager& vboManager) override;
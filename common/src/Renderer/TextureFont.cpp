@@ -34,6 +34,8 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
+const size_t TextureFont::MaxCachedGeometries = 8192;
+
 TextureFont::TextureFont(
   std::unique_ptr<FontTexture> texture,
   const std::vector<FontGlyph>& glyphs,
@@ -69,6 +71,26 @@ int TextureFont::lineHeight() const
   return m_lineHeight;
 }
 
+unsigned char TextureFont::firstChar() const
+{
+  return m_firstChar;
+}
+
+unsigned char TextureFont::charCount() const
+{
+  return m_charCount;
+}
+
+const FontTexture& TextureFont::texture() const
+{
+  return *m_texture;
+}
+
+const std::vector<FontGlyph>& TextureFont::glyphs() const
+{
+  return m_glyphs;
+}
+
 class MeasureString : public AttrString::LineFunc
 {
 private:
@@ -270,6 +292,25 @@ vm::vec2f TextureFont::measure(const std::string& string) const
   return result;
 }
 
+std::shared_ptr<const TextureFont::StringGeometry> TextureFont::geometry(
+  const AttrString& string)
+{
+  if (const auto it = m_geometryCache.find(string); it != m_geometryCache.end())
+  {
+    return it->second;
+  }
+
+  if (m_geometryCache.size() >= MaxCachedGeometries)
+  {
+    m_geometryCache.clear();
+  }
+
+  auto result = std::make_shared<const StringGeometry>(
+    StringGeometry{quads(string, true), measure(string)});
+  m_geometryCache.emplace(string, result);
+  return result;
+}
+
 void TextureFont::activate()
 {
   m_texture->activate();
@@ -279,5 +320,18 @@ void TextureFont::deactivate()
 {
   m_texture->deactivate();
 }
+
+bool operator==(const TextureFont& lhs, const TextureFont& rhs)
+{
+  return lhs.ascend() == rhs.ascend() && lhs.descend() == rhs.descend()
+         && lhs.lineHeight() == rhs.lineHeight() && lhs.firstChar() == rhs.firstChar()
+         && lhs.charCount() == rhs.charCount() && lhs.glyphs() == rhs.glyphs()
+         && lhs.texture() == rhs.texture();
+}
+
+bool operator!=(const TextureFont& lhs, const TextureFont& rhs)
+{
+  return !(lhs == rhs);
+}
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -20,10 +20,12 @@
 #pragma once
 
 #include "Macros.h"
+#include "Renderer/AttrString.h"
 
 #include "vm/forward.h"
 #include "vm/vec.h"
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,13 +34,24 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
-class AttrString;
 class FontGlyph;
 class FontTexture;
 
 class TextureFont
 {
+public:
+  /**
+   * The clockwise quads of a string and its size, as returned by quads and measure.
+   */
+  struct StringGeometry
+  {
+    std::vector<vm::vec2f> vertices;
+    vm::vec2f size;
+  };
+
 private:
+  static const size_t MaxCachedGeometries;
+
   std::unique_ptr<FontTexture> m_texture;
   std::vector<FontGlyph> m_glyphs;
   int m_ascend;
@@ -48,6 +61,8 @@ private:
   unsigned char m_firstChar;
   unsigned char m_charCount;
 
+  std::map<AttrString, std::shared_ptr<const StringGeometry>> m_geometryCache;
+
 public:
   TextureFont(
     std::unique_ptr<FontTexture> texture,
@@ -64,6 +79,11 @@ public:
   int ascend() const;
   int descend() const;
   int lineHeight() const;
+  unsigned char firstChar() const;
+  unsigned char charCount() const;
+
+  const FontTexture& texture() const;
+  const std::vector<FontGlyph>& glyphs() const;
 
   std::vector<vm::vec2f> quads(
     const AttrString& string,
@@ -77,8 +97,22 @@ public:
     const vm::vec2f& offset = vm::vec2f::zero()) const;
   vm::vec2f measure(const std::string& string) const;
 
+  /**
+   * Returns the geometry of the given string. The geometry is cached so that labels
+   * which are rendered in every frame don't have to be laid out again. The cache is
+   * cleared when it grows too large, so the returned pointer must be kept by the caller
+   * as long as the geometry is needed.
+   */
+  std::shared_ptr<const StringGeometry> geometry(const AttrString& string);
+
   void activate();
   void deactivate();
 };
+
+/**
+ * Compares the metrics, glyphs and texture of the given fonts.
+ */
+bool operator==(const TextureFont& lhs, const TextureFont& rhs);
+bool operator!=(const TextureFont& lhs, const TextureFont& rhs);
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -184,6 +184,22 @@ public:
    */
   void render(VertexArray& vertexArray, TextureRenderFunc& func);
 
+  /**
+   * Renders the primitives stored in this index range map once for each of the given
+   * number of instances. Each texture is only activated once, and the primitives of all
+   * instances are rendered while it is active. The given function is called with the
+   * index of an instance before its primitives are rendered and can be used to set up
+   * per-instance state such as uniforms.
+   *
+   * @param vertexArray the vertex array to render with
+   * @param instanceCount the number of instances to render
+   * @param setupInstance the function to set up an instance
+   */
+  void renderInstances(
+    VertexArray& vertexArray,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance);
+
   /**
    * Invokes the given function for each primitive stored in this map.
    *
@@ -73,6 +73,16 @@ void TexturedIndexRangeRenderer::render(TextureRenderFunc& func)
   }
 }
 
+void TexturedIndexRangeRenderer::renderInstances(
+  const size_t instanceCount, const std::function<void(size_t)>& setupInstance)
+{
+  if (m_vertexArray.setup())
+  {
+    m_indexRange.renderInstances(m_vertexArray, instanceCount, setupInstance);
+    m_vertexArray.cleanup();
+  }
+}
+
 MultiTexturedIndexRangeRenderer::MultiTexturedIndexRangeRenderer(
   std::vector<std::unique_ptr<TexturedIndexRangeRenderer>> renderers)
   : m_renderers(std::move(renderers))
@@ -116,5 +126,14 @@ void MultiTexturedIndexRangeRenderer::render(TextureRenderFunc& func)
     renderer->render(func);
   }
 }
+
+void MultiTexturedIndexRangeRenderer::renderInstances(
+  const size_t instanceCount, const std::function<void(size_t)>& setupInstance)
+{
+  for (auto& renderer : m_renderers)
+  {
+    renderer->renderInstances(instanceCount, setupInstance);
+  }
+}
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -22,6 +22,7 @@
 #include "Renderer/TexturedIndexRangeMap.h"
 #include "Renderer/VertexArray.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -47,6 +48,14 @@ public:
   virtual void prepare(VboManager& vboManager) = 0;
   virtual void render() = 0;
   virtual void render(TextureRenderFunc& func) = 0;
+
+  /**
+   * Renders the given number of instances, setting up the vertex array and activating
+   * each texture only once. The given function is called with the index of an instance
+   * before it is rendered.
+   */
+  virtual void renderInstances(
+    size_t instanceCount, const std::function<void(size_t)>& setupInstance) = 0;
 };
 
 class TexturedIndexRangeRenderer : public TexturedRenderer
@@ -70,6 +79,8 @@ public:
   void prepare(VboManager& vboManager) override;
   void render() override;
   void render(TextureRenderFunc& func) override;
+  void renderInstances(
+    size_t instanceCount, const std::function<void(size_t)>& setupInstance) override;
 };
 
 class MultiTexturedIndexRangeRenderer : public TexturedRenderer
@@ -87,6 +98,8 @@ public:
   void prepare(VboManager& vboManager) override;
   void render() override;
   void render(TextureRenderFunc& func) override;
+  void renderInstances(
+    size_t instanceCount, const std::function<void(size_t)>& setupInstance) override;
 };
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -29,7 +29,10 @@ namespace Renderer
 {
 Vbo::Vbo(GLenum type, const size_t capacity, const GLenum usage)
   : m_type(type)
+  , m_offset(0)
   , m_capacity(capacity)
+  , m_ownsBuffer(true)
+  , m_arenaBlock(nullptr)
 {
   assert(m_type == GL_ELEMENT_ARRAY_BUFFER || m_type == GL_ARRAY_BUFFER);
 
@@ -38,10 +41,33 @@ Vbo::Vbo(GLenum type, const size_t capacity, const GLenum usage)
   glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, usage));
 }
 
+Vbo::Vbo(
+  const GLenum type,
+  const GLuint bufferId,
+  const size_t offset,
+  const size_t capacity,
+  AllocationTracker::Block* arenaBlock)
+  : m_type(type)
+  , m_offset(offset)
+  , m_capacity(capacity)
+  , m_bufferId(bufferId)
+  , m_ownsBuffer(false)
+  , m_arenaBlock(arenaBlock)
+{
+  assert(m_type == GL_ELEMENT_ARRAY_BUFFER || m_type == GL_ARRAY_BUFFER);
+  assert(m_bufferId != 0);
+  assert(m_arenaBlock == nullptr || m_capacity <= m_arenaBlock->size);
+
+  glAssert(glBindBuffer(m_type, m_bufferId));
+}
+
 void Vbo::free()
 {
   assert(m_bufferId != 0);
-  glAssert(glDeleteBuffers(1, &m_bufferId));
+  if (m_ownsBuffer)
+  {
+    glAssert(glDeleteBuffers(1, &m_bufferId));
+  }
   m_bufferId = 0;
 }
 
@@ -52,7 +78,7 @@ Vbo::~Vbo()
 
 size_t Vbo::offset() const
 {
-  return 0;
+  return m_offset;
 }
 
 size_t Vbo::capacity() const
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/VboManager.h"
 
 #include <cassert>
@@ -30,7 +31,8 @@ namespace TrenchBroom
 namespace Renderer
 {
 /**
- * Wrapper around an OpenGL buffer
+ * Wrapper around an OpenGL buffer, or around a range of an OpenGL buffer that is shared
+ * with other VBOs, see VboManager.
  */
 class Vbo
 {
@@ -41,18 +43,37 @@ private:
    * e.g. GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
    */
   GLenum m_type;
+  size_t m_offset;
   size_t m_capacity;
   GLuint m_bufferId;
+  bool m_ownsBuffer;
+
+  /**
+   * The block of the shared arena buffer that this VBO occupies, or null if this VBO owns
+   * its buffer or is part of a streaming buffer.
+   */
+  AllocationTracker::Block* m_arenaBlock;
 
   /**
    * Immediately creates and binds to a buffer of the given type and capacity.
    * The contents are initially unspecified.
    */
   Vbo(GLenum type, size_t capacity, GLenum usage);
+
+  /**
+   * Creates a VBO with the given capacity that occupies a range of the given shared
+   * buffer, starting at the given offset. The contents are initially unspecified.
+   */
+  Vbo(
+    GLenum type,
+    GLuint bufferId,
+    size_t offset,
+    size_t capacity,
+    AllocationTracker::Block* arenaBlock);
   ~Vbo();
 
   /**
-   * Deletes the underlying OpenGL buffer with glDeleteBuffers.
+   * Deletes the underlying OpenGL buffer with glDeleteBuffers unless it is shared.
    * Must be called before the destructor.
    * Calling any other methods after free() is disallowed.
    */
@@ -60,7 +81,8 @@ private:
 
 public:
   /**
-   * Deprecated, always returns 0.
+   * Returns the byte offset of this VBO within its OpenGL buffer. This must be added to
+   * all offsets passed to OpenGL functions that source data from this VBO.
    */
   size_t offset() const;
   size_t capacity() const;
@@ -84,7 +106,7 @@ public:
    * Writes a C array to the VBO block.
    *
    * @tparam T        element type
-   * @param address   byte offset from the start of the block to write at
+   * @param address   byte offset from the start of the VBO to write at
    * @param array     elements to write
    * @param count     number of elements to write
    * @return          number of bytes written
@@ -99,7 +121,7 @@ public:
     static_assert(std::is_standard_layout<T>::value);
 
     const GLvoid* ptr = static_cast<const GLvoid*>(array);
-    const GLintptr offset = static_cast<GLintptr>(address);
+    const GLintptr offset = static_cast<GLintptr>(m_offset + address);
     const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
     glAssert(glBindBuffer(m_type, m_bufferId));
     glAssert(glBufferSubData(m_type, offset, sizei, ptr));
@@ -19,11 +19,13 @@
 
 #include "VboManager.h"
 
+#include "AllocationTracker.h"
 #include "GL.h"
 #include "Macros.h"
 #include "Vbo.h"
 
 #include <algorithm> // for std::max
+#include <cassert>
 
 namespace TrenchBroom
 {
@@ -52,10 +54,120 @@ static GLenum usageToOpenGL(const VboUsage usage)
     return GL_STATIC_DRAW;
   case VboUsage::DynamicDraw:
     return GL_DYNAMIC_DRAW;
+  case VboUsage::StreamDraw:
+    return GL_STREAM_DRAW;
     switchDefault();
   }
 }
 
+/**
+ * The capacity of each shared buffer in bytes.
+ */
+static const size_t ArenaCapacity = 4u * 1024u * 1024u;
+
+/**
+ * VBOs larger than this many bytes get their own buffer.
+ */
+static const size_t MaxArenaVboCapacity = 64u * 1024u;
+
+/**
+ * The minimum capacity of each streaming buffer in bytes.
+ */
+static const size_t StreamBufferCapacity = 1024u * 1024u;
+
+/**
+ * The capacity of VBOs allocated from a shared buffer is rounded up to a multiple of this
+ * so that every VBO starts at a properly aligned offset for any vertex attribute type.
+ */
+static const size_t ArenaVboAlignment = 16u;
+
+static size_t alignArenaVboCapacity(const size_t capacity)
+{
+  return (capacity + ArenaVboAlignment - 1u) / ArenaVboAlignment * ArenaVboAlignment;
+}
+
+static GLuint createBuffer(
+  const VboType type, const size_t capacity, const VboUsage usage)
+{
+  const auto glType = typeToOpenGL(type);
+  auto bufferId = GLuint(0);
+  glAssert(glGenBuffers(1, &bufferId));
+  glAssert(glBindBuffer(glType, bufferId));
+  glAssert(glBufferData(
+    glType, static_cast<GLsizeiptr>(capacity), nullptr, usageToOpenGL(usage)));
+  return bufferId;
+}
+
+/**
+ * A shared buffer that small VBOs are sub-allocated from.
+ *
+ * The buffer is not deleted when the arena is destroyed because the arenas that are left
+ * when the VBO manager is destroyed are destroyed without a current OpenGL context.
+ */
+struct VboManager::Arena
+{
+  VboType type;
+  VboUsage usage;
+  GLuint bufferId;
+  AllocationTracker tracker;
+
+  Arena(const VboType i_type, const VboUsage i_usage)
+    : type{i_type}
+    , usage{i_usage}
+    , bufferId{createBuffer(type, ArenaCapacity, usage)}
+    , tracker{ArenaCapacity}
+  {
+  }
+};
+
+/**
+ * A shared buffer that stream VBOs are allocated from one after another. The space of a
+ * VBO is not reclaimed when it is destroyed, but the entire buffer is reused once all of
+ * its VBOs have been destroyed. Like arena buffers, streaming buffers are not deleted
+ * when the VBO manager is destroyed.
+ */
+struct VboManager::StreamBuffer
+{
+  VboType type;
+  GLuint bufferId;
+  size_t capacity;
+  size_t size;
+  size_t vboCount;
+
+  StreamBuffer(const VboType i_type, const size_t i_capacity)
+    : type{i_type}
+    , bufferId{createBuffer(type, i_capacity, VboUsage::StreamDraw)}
+    , capacity{i_capacity}
+    , size{0}
+    , vboCount{0}
+  {
+  }
+
+  Vbo* allocate(const size_t vboCapacity)
+  {
+    const auto alignedCapacity = alignArenaVboCapacity(vboCapacity);
+    if (vboCount == 0 && size > 0)
+    {
+      // orphan the storage so that we don't have to wait until the GPU is done with it
+      const auto glType = typeToOpenGL(type);
+      glAssert(glBindBuffer(glType, bufferId));
+      glAssert(glBufferData(
+        glType, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW));
+      size = 0;
+    }
+
+    if (capacity - size < alignedCapacity)
+    {
+      return nullptr;
+    }
+
+    auto* result = new Vbo(typeToOpenGL(type), bufferId, size, vboCapacity, nullptr);
+    size += alignedCapacity;
+    ++vboCount;
+    return result;
+  }
+};
+
 // VboManager
 
 VboManager::VboManager(ShaderManager* shaderManager)
@@ -66,11 +178,25 @@ VboManager::VboManager(ShaderManager* shaderManager)
 {
 }
 
+VboManager::~VboManager() = default;
+
 Vbo* VboManager::allocateVbo(VboType type, const size_t capacity, const VboUsage usage)
 {
-  auto* result = new Vbo(typeToOpenGL(type), capacity, usageToOpenGL(usage));
+  Vbo* result = nullptr;
+  if (capacity > 0u && usage == VboUsage::StreamDraw)
+  {
+    result = allocateStreamVbo(type, capacity);
+  }
+  else if (capacity > 0u && capacity <= MaxArenaVboCapacity)
+  {
+    result = allocateArenaVbo(type, capacity, usage);
+  }
+  else
+  {
+    result = new Vbo(typeToOpenGL(type), capacity, usageToOpenGL(usage));
+  }
 
-  m_currentVboSize += capacity;
+  m_currentVboSize += result->capacity();
   m_currentVboCount++;
   m_peakVboCount = std::max(m_peakVboCount, m_currentVboCount);
 
@@ -82,10 +208,110 @@ void VboManager::destroyVbo(Vbo* vbo)
   m_currentVboSize -= vbo->capacity();
   m_currentVboCount--;
 
+  if (vbo->m_arenaBlock != nullptr)
+  {
+    releaseArenaVbo(vbo);
+  }
+  else if (!vbo->m_ownsBuffer)
+  {
+    releaseStreamVbo(vbo);
+  }
+
   vbo->free();
   delete vbo;
 }
 
+Vbo* VboManager::allocateArenaVbo(
+  const VboType type, const size_t capacity, const VboUsage usage)
+{
+  const auto alignedCapacity = alignArenaVboCapacity(capacity);
+
+  for (auto& arena : m_arenas)
+  {
+    if (arena->type == type && arena->usage == usage)
+    {
+      if (auto* block = arena->tracker.allocate(alignedCapacity))
+      {
+        return new Vbo(typeToOpenGL(type), arena->bufferId, block->pos, capacity, block);
+      }
+    }
+  }
+
+  auto& arena = m_arenas.emplace_back(std::make_unique<Arena>(type, usage));
+  auto* block = arena->tracker.allocate(alignedCapacity);
+  assert(block != nullptr);
+  return new Vbo(typeToOpenGL(type), arena->bufferId, block->pos, capacity, block);
+}
+
+void VboManager::releaseArenaVbo(Vbo* vbo)
+{
+  const auto it = std::find_if(m_arenas.begin(), m_arenas.end(), [&](const auto& arena) {
+    return arena->bufferId == vbo->m_bufferId;
+  });
+  assert(it != m_arenas.end());
+
+  auto& arena = **it;
+  arena.tracker.free(vbo->m_arenaBlock);
+
+  // release arenas that have become empty, but keep one of each kind around so that
+  // renderables which are created and destroyed every frame don't recreate it each time
+  if (!arena.tracker.hasAllocations())
+  {
+    const auto isSameKind = [&](const auto& other) {
+      return other->type == arena.type && other->usage == arena.usage;
+    };
+    if (std::count_if(m_arenas.begin(), m_arenas.end(), isSameKind) > 1)
+    {
+      glAssert(glDeleteBuffers(1, &arena.bufferId));
+      m_arenas.erase(it);
+    }
+  }
+}
+
+Vbo* VboManager::allocateStreamVbo(const VboType type, const size_t capacity)
+{
+  for (auto& streamBuffer : m_streamBuffers)
+  {
+    if (streamBuffer->type == type)
+    {
+      if (auto* vbo = streamBuffer->allocate(capacity))
+      {
+        return vbo;
+      }
+    }
+  }
+
+  // all streaming buffers are either full or still in use
+  const auto streamBufferCapacity =
+    std::max(StreamBufferCapacity, alignArenaVboCapacity(capacity));
+  auto& streamBuffer = m_streamBuffers.emplace_back(
+    std::make_unique<StreamBuffer>(type, streamBufferCapacity));
+  auto* vbo = streamBuffer->allocate(capacity);
+  assert(vbo != nullptr);
+  return vbo;
+}
+
+void VboManager::releaseStreamVbo(Vbo* vbo)
+{
+  const auto it = std::find_if(
+    m_streamBuffers.begin(), m_streamBuffers.end(), [&](const auto& streamBuffer) {
+      return streamBuffer->bufferId == vbo->m_bufferId;
+    });
+  assert(it != m_streamBuffers.end());
+
+  auto& streamBuffer = **it;
+  assert(streamBuffer.vboCount > 0);
+  --streamBuffer.vboCount;
+
+  // release oversized streaming buffers once they are unused, but keep those with the
+  // default capacity around for reuse
+  if (streamBuffer.vboCount == 0 && streamBuffer.capacity > StreamBufferCapacity)
+  {
+    glAssert(glDeleteBuffers(1, &streamBuffer.bufferId));
+    m_streamBuffers.erase(it);
+  }
+}
+
 size_t VboManager::peakVboCount() const
 {
   return m_peakVboCount;
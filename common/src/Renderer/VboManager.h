@@ -22,6 +22,8 @@
 #include "Renderer/GL.h"
 
 #include <cstddef> // for size_t
+#include <memory>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -39,22 +41,44 @@ enum class VboType
 enum class VboUsage
 {
   StaticDraw,
-  DynamicDraw
+  DynamicDraw,
+  /**
+   * For data that is written once and rendered only a few times before it is discarded,
+   * e.g. for renderables that are rebuilt every frame.
+   */
+  StreamDraw
 };
 
+/**
+ * Allocates VBOs for all renderers. Small VBOs are sub-allocated from large shared OpenGL
+ * buffers (arenas) so that renderers with many small vertex or index arrays don't create
+ * an OpenGL buffer for each of them. Larger VBOs get their own buffer.
+ *
+ * VBOs with stream usage are allocated consecutively from streaming buffers instead. A
+ * streaming buffer is reused once all of its VBOs have been destroyed, and its storage
+ * is orphaned before it is written again so that uploading new data does not have to
+ * wait for the GPU to finish rendering the old data.
+ */
 class VboManager
 {
 private:
+  struct Arena;
+  struct StreamBuffer;
+
   size_t m_peakVboCount;
   size_t m_currentVboCount;
   size_t m_currentVboSize;
   ShaderManager* m_shaderManager;
+  std::vector<std::unique_ptr<Arena>> m_arenas;
+  std::vector<std::unique_ptr<StreamBuffer>> m_streamBuffers;
 
 public:
   explicit VboManager(ShaderManager* shaderManager);
+  ~VboManager();
+
   /**
-   * Immediately creates and binds to an OpenGL buffer of the given type and capacity.
-   * The contents are initially unspecified. See Vbo class.
+   * Immediately creates and binds to an OpenGL buffer of the given type and capacity, or
+   * to a range of a shared buffer. The contents are initially unspecified. See Vbo class.
    */
   Vbo* allocateVbo(VboType type, size_t capacity, VboUsage usage = VboUsage::StaticDraw);
   void destroyVbo(Vbo* vbo);
@@ -64,6 +88,12 @@ public:
   size_t currentVboSize() const;
 
   ShaderManager& shaderManager();
+
+private:
+  Vbo* allocateArenaVbo(VboType type, size_t capacity, VboUsage usage);
+  void releaseArenaVbo(Vbo* vbo);
+  Vbo* allocateStreamVbo(VboType type, size_t capacity);
+  void releaseStreamVbo(Vbo* vbo);
 };
 } // namespace Renderer
 } // namespace TrenchBroom
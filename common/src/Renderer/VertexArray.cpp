@@ -55,11 +55,11 @@ bool VertexArray::prepared() const
   return m_prepared;
 }
 
-void VertexArray::prepare(VboManager& vboManager)
+void VertexArray::prepare(VboManager& vboManager, const VboUsage usage)
 {
   if (!prepared() && !empty())
   {
-    m_holder->prepare(vboManager);
+    m_holder->prepare(vboManager, usage);
   }
   m_prepared = true;
 }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Ensure.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/GL.h"
 #include "Renderer/GLVertex.h"
 #include "Renderer/GLVertexType.h"
@@ -58,7 +59,7 @@ private:
     virtual size_t vertexCount() const = 0;
     virtual size_t sizeInBytes() const = 0;
 
-    virtual void prepare(VboManager& vboManager) = 0;
+    virtual void prepare(VboManager& vboManager, VboUsage usage) = 0;
     virtual void setup() = 0;
     virtual void cleanup() = 0;
   };
@@ -76,13 +77,12 @@ private:
 
     size_t sizeInBytes() const override { return VertexSpec::Size * m_vertexCount; }
 
-    void prepare(VboManager& vboManager) override
+    void prepare(VboManager& vboManager, const VboUsage usage) override
     {
       if (m_vertexCount > 0 && m_vbo == nullptr)
       {
         m_vboManager = &vboManager;
-        m_vbo = vboManager.allocateVbo(VboType::ArrayBuffer, sizeInBytes());
-        ;
+        m_vbo = vboManager.allocateVbo(VboType::ArrayBuffer, sizeInBytes(), usage);
         m_vbo->writeBuffer(0, doGetVertices());
       }
     }
@@ -146,9 +146,9 @@ private:
     {
     }
 
-    void prepare(VboManager& vboManager) override
+    void prepare(VboManager& vboManager, const VboUsage usage) override
     {
-      Holder<VertexSpec>::prepare(vboManager);
+      Holder<VertexSpec>::prepare(vboManager, usage);
       kdl::vec_clear_to_zero(m_vertices);
     }
 
@@ -176,6 +176,32 @@ private:
     const VertexList& doGetVertices() const override { return m_vertices; }
   };
 
+  template <typename V>
+  class DynamicHolder : public BaseHolder
+  {
+  private:
+    std::shared_ptr<VertexHolder<V>> m_vertices;
+
+  public:
+    explicit DynamicHolder(std::shared_ptr<VertexHolder<V>> vertices)
+      : m_vertices(std::move(vertices))
+    {
+    }
+
+    size_t vertexCount() const override { return m_vertices->size(); }
+
+    size_t sizeInBytes() const override { return V::Type::Size * m_vertices->size(); }
+
+    void prepare(VboManager& vboManager, const VboUsage) override
+    {
+      m_vertices->prepare(vboManager);
+    }
+
+    void setup() override { m_vertices->setupVertices(); }
+
+    void cleanup() override { m_vertices->cleanupVertices(); }
+  };
+
 private:
   std::shared_ptr<BaseHolder> m_holder;
   bool m_prepared;
@@ -236,6 +262,23 @@ public:
       std::make_shared<ByRefHolder<typename GLVertex<Attrs...>::Type>>(vertices));
   }
 
+  /**
+   * Creates a new vertex array which renders the contents of the given vertex holder. The
+   * holder can be modified after the vertex array was created, and only its modified
+   * ranges are uploaded when a vertex array for it is prepared again. Since the number of
+   * vertices may change, vertex arrays should be recreated whenever the holder changes.
+   *
+   * @tparam Attrs the vertex attribute types
+   * @param vertices the vertex holder to render
+   * @return the vertex array
+   */
+  template <typename... Attrs>
+  static VertexArray dynamic(std::shared_ptr<VertexHolder<GLVertex<Attrs...>>> vertices)
+  {
+    return VertexArray(
+      std::make_shared<DynamicHolder<GLVertex<Attrs...>>>(std::move(vertices)));
+  }
+
   /**
    * Indicates whether this vertex array is empty.
    *
@@ -271,8 +314,10 @@ public:
    *
    * @param vboManager the vertex buffer object to upload the contents of this vertex
    * array into
+   * @param usage the usage of the vertex buffer object, use stream usage if this vertex
+   * array is discarded after it was rendered once
    */
-  void prepare(VboManager& vboManager);
+  void prepare(VboManager& vboManager, VboUsage usage = VboUsage::StaticDraw);
 
   /**
    * Sets this vertex array up for rendering. If this vertex array is only rendered once,
@@ -0,0 +1,162 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StallDetector.h"
+
+#include "Error.h"
+#include "IO/DiskIO.h"
+#include "TrenchBroomStackWalker.h"
+
+#include <QDateTime>
+
+#include "kdl/result.h"
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+
+namespace TrenchBroom
+{
+namespace
+{
+std::mutex currentCommandMutex;
+std::string currentCommandName;
+
+void setCurrentCommand(std::string command)
+{
+  const auto lock = std::lock_guard{currentCommandMutex};
+  currentCommandName = std::move(command);
+}
+} // namespace
+
+StallDetector::CommandScope::CommandScope(std::string command)
+  : m_previousCommand{currentCommand()}
+{
+  setCurrentCommand(std::move(command));
+}
+
+StallDetector::CommandScope::~CommandScope()
+{
+  setCurrentCommand(std::move(m_previousCommand));
+}
+
+StallDetector::StallDetector(
+  std::filesystem::path reportDirectory, const std::chrono::milliseconds threshold)
+  : m_reportDirectory{std::move(reportDirectory)}
+  , m_threshold{threshold}
+  , m_lastHeartbeat{Clock::now().time_since_epoch().count()}
+{
+  TrenchBroomStackWalker::registerMainThread();
+  m_watchdog = std::thread{[&]() { watch(); }};
+}
+
+StallDetector::~StallDetector()
+{
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_stopped = true;
+  }
+  m_condition.notify_one();
+  m_watchdog.join();
+}
+
+void StallDetector::heartbeat()
+{
+  m_lastHeartbeat = Clock::now().time_since_epoch().count();
+}
+
+std::chrono::milliseconds StallDetector::heartbeatInterval() const
+{
+  return std::max(
+    std::chrono::duration_cast<std::chrono::milliseconds>(m_threshold / 4),
+    std::chrono::milliseconds{1});
+}
+
+std::string StallDetector::currentCommand()
+{
+  const auto lock = std::lock_guard{currentCommandMutex};
+  return currentCommandName;
+}
+
+void StallDetector::watch()
+{
+  // the heartbeat that preceded the last reported stall
+  auto reportedHeartbeat = std::optional<Clock::rep>{};
+
+  auto lock = std::unique_lock{m_mutex};
+  while (!m_condition.wait_for(lock, heartbeatInterval(), [&]() { return m_stopped; }))
+  {
+    const auto lastHeartbeat = m_lastHeartbeat.load();
+    const auto stallDuration =
+      Clock::now() - Clock::time_point{Clock::duration{lastHeartbeat}};
+    if (stallDuration >= m_threshold && reportedHeartbeat != lastHeartbeat)
+    {
+      reportedHeartbeat = lastHeartbeat;
+
+      lock.unlock();
+      writeReport(stallDuration);
+      lock.lock();
+    }
+  }
+}
+
+void StallDetector::writeReport(const Clock::duration stallDuration)
+{
+  const auto time = QDateTime::currentDateTime();
+  const auto report = stallReport(
+    time,
+    std::chrono::duration_cast<std::chrono::milliseconds>(stallDuration),
+    currentCommand(),
+    TrenchBroomStackWalker::getMainThreadStackTrace());
+
+  // there is no way to report the error because the loggers can only be used on the main
+  // thread
+  IO::Disk::createDirectory(m_reportDirectory)
+    .and_then([&](auto) {
+      return IO::Disk::withOutputStream(
+        stallReportPath(m_reportDirectory, time),
+        [&](auto& stream) { stream << report; });
+    })
+    .transform_error([](auto) {});
+}
+
+std::filesystem::path stallReportPath(
+  const std::filesystem::path& reportDirectory, const QDateTime& time)
+{
+  return reportDirectory
+         / ("stall-" + time.toString("yyyyMMdd-hhmmss-zzz").toStdString() + ".txt");
+}
+
+std::string stallReport(
+  const QDateTime& time,
+  const std::chrono::milliseconds stallDuration,
+  const std::string& command,
+  const std::string& stackTrace)
+{
+  auto str = std::stringstream{};
+  str << "Stall detected at " << time.toString(Qt::ISODateWithMs).toStdString() << "\n"
+      << "The main thread has not processed any events for " << stallDuration.count()
+      << " ms\n"
+      << "Current command: " << (command.empty() ? "none" : command) << "\n\n"
+      << "Stack trace of the main thread:\n"
+      << (stackTrace.empty() ? "unavailable\n" : stackTrace);
+  return str.str();
+}
+
+} // namespace TrenchBroom
@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+class QDateTime;
+
+namespace TrenchBroom
+{
+
+/**
+ * Detects when the main thread stops processing events and writes a report for each
+ * stall to a directory.
+ *
+ * The main thread must call heartbeat() regularly from its event loop, e.g. with a timer
+ * that fires every heartbeatInterval(). A watchdog thread checks the time of the last
+ * heartbeat, and if it is longer ago than the threshold, it captures the stack trace of
+ * the main thread and writes it to a timestamped report together with the name of the
+ * command that is being executed. Each stall is only reported once, no matter how long
+ * it lasts.
+ */
+class StallDetector
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Records the name of the command that is being executed on the main thread until it
+   * is destroyed.
+   */
+  class CommandScope
+  {
+  private:
+    std::string m_previousCommand;
+
+  public:
+    explicit CommandScope(std::string command);
+    ~CommandScope();
+
+    deleteCopyAndMove(CommandScope);
+  };
+
+private:
+  std::filesystem::path m_reportDirectory;
+  Clock::duration m_threshold;
+  std::atomic<Clock::rep> m_lastHeartbeat;
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stopped = false;
+  std::thread m_watchdog;
+
+public:
+  /**
+   * Starts watching the main thread. Must be created on the main thread.
+   */
+  StallDetector(
+    std::filesystem::path reportDirectory, std::chrono::milliseconds threshold);
+  ~StallDetector();
+
+  deleteCopyAndMove(StallDetector);
+
+  /**
+   * Signals that the main thread is processing events. Must be called on the main thread.
+   */
+  void heartbeat();
+
+  /**
+   * The interval at which heartbeat() should be called.
+   */
+  std::chrono::milliseconds heartbeatInterval() const;
+
+  /**
+   * Returns the name of the command that is being executed on the main thread, or an
+   * empty string if no command is being executed.
+   */
+  static std::string currentCommand();
+
+private:
+  void watch();
+  void writeReport(Clock::duration stallDuration);
+};
+
+/**
+ * Returns the path of the report for a stall that was detected at the given time.
+ */
+std::filesystem::path stallReportPath(
+  const std::filesystem::path& reportDirectory, const QDateTime& time);
+
+/**
+ * Returns the contents of a stall report.
+ */
+std::string stallReport(
+  const QDateTime& time,
+  std::chrono::milliseconds stallDuration,
+  const std::string& command,
+  const std::string& stackTrace);
+
+} // namespace TrenchBroom
@@ -0,0 +1,194 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StartupTimeline.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+
+#include "Error.h"
+#include "IO/DiskIO.h"
+
+#include "kdl/result.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace TrenchBroom
+{
+namespace
+{
+
+double toMs(const StartupTimeline::Clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>{duration}.count();
+}
+
+double toUs(const StartupTimeline::Clock::duration duration)
+{
+  return std::chrono::duration<double, std::micro>{duration}.count();
+}
+
+} // namespace
+
+StartupTimeline::Scope::Scope(StartupTimeline* timeline, const size_t index)
+  : m_timeline{timeline}
+  , m_index{index}
+{
+}
+
+StartupTimeline::Scope::~Scope()
+{
+  if (m_timeline)
+  {
+    m_timeline->endPhase(m_index);
+  }
+}
+
+StartupTimeline& StartupTimeline::instance()
+{
+  static auto instance = StartupTimeline{};
+  return instance;
+}
+
+StartupTimeline::StartupTimeline()
+  : m_start{Clock::now()}
+{
+}
+
+StartupTimeline::Scope StartupTimeline::phase(std::string name)
+{
+  if (m_finished)
+  {
+    return Scope{nullptr, 0};
+  }
+
+  const auto index = m_phases.size();
+  m_phases.push_back(
+    Phase{std::move(name), m_openPhases.size(), Clock::now() - m_start, {}});
+  m_openPhases.push_back(index);
+  return Scope{this, index};
+}
+
+void StartupTimeline::setTracePath(std::filesystem::path tracePath)
+{
+  m_tracePath = std::move(tracePath);
+}
+
+bool StartupTimeline::finished() const
+{
+  return m_finished;
+}
+
+const std::vector<StartupTimeline::Phase>& StartupTimeline::phases() const
+{
+  return m_phases;
+}
+
+void StartupTimeline::finish()
+{
+  if (m_finished)
+  {
+    return;
+  }
+
+  // phases that are still open end with the startup
+  while (!m_openPhases.empty())
+  {
+    endPhase(m_openPhases.back());
+  }
+
+  m_end = Clock::now();
+  m_finished = true;
+
+  qInfo().noquote() << QString::fromStdString(summary());
+
+  if (!m_tracePath.empty())
+  {
+    IO::Disk::withOutputStream(
+      m_tracePath, [&](auto& stream) { stream << chromeTrace(); })
+      .transform_error([&](const auto& e) {
+        qWarning().noquote() << "Could not write startup trace:"
+                             << QString::fromStdString(e.msg);
+      });
+  }
+}
+
+std::string StartupTimeline::summary() const
+{
+  const auto end = m_finished ? m_end : Clock::now();
+
+  auto str = std::stringstream{};
+  str << std::fixed << std::setprecision(1);
+  str << "Startup took " << toMs(end - m_start) << "ms";
+  for (const auto& phase : m_phases)
+  {
+    str << "\n" << std::string((phase.depth + 1) * 2, ' ') << phase.name << ": "
+        << toMs(phase.duration) << "ms";
+  }
+  return str.str();
+}
+
+std::string StartupTimeline::chromeTrace() const
+{
+  auto events = QJsonArray{};
+  events.append(QJsonObject{
+    {"name", "process_name"},
+    {"ph", "M"},
+    {"pid", 1},
+    {"tid", 1},
+    {"args", QJsonObject{{"name", "TrenchBroom"}}},
+  });
+
+  for (const auto& phase : m_phases)
+  {
+    events.append(QJsonObject{
+      {"name", QString::fromStdString(phase.name)},
+      {"cat", "startup"},
+      {"ph", "X"},
+      {"ts", toUs(phase.start)},
+      {"dur", toUs(phase.duration)},
+      {"pid", 1},
+      {"tid", 1},
+    });
+  }
+
+  const auto document = QJsonDocument{QJsonObject{
+    {"traceEvents", events},
+    {"displayTimeUnit", "ms"},
+  }};
+  return document.toJson(QJsonDocument::Indented).toStdString();
+}
+
+void StartupTimeline::endPhase(const size_t index)
+{
+  if (m_finished || m_openPhases.empty() || m_openPhases.back() != index)
+  {
+    return;
+  }
+
+  auto& phase = m_phases[index];
+  phase.duration = Clock::now() - m_start - phase.start;
+  m_openPhases.pop_back();
+}
+
+} // namespace TrenchBroom
@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+
+/**
+ * Records the durations of the phases of the application startup, such as loading the
+ * game configurations or compiling the shaders.
+ *
+ * Phases are recorded with scopes returned by phase() and can be nested. Once startup has
+ * finished, a summary is logged and, if a trace path was set, the phases are written to a
+ * file in the Chrome trace event format, which can be viewed in chrome://tracing or
+ * Perfetto. Phases that begin after startup has finished are not recorded.
+ *
+ * The timeline must only be used from the main thread.
+ */
+class StartupTimeline
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Phase
+  {
+    std::string name;
+    size_t depth;
+    // relative to the start of the timeline
+    Clock::duration start;
+    Clock::duration duration;
+  };
+
+  /**
+   * Ends the phase it was created for when it is destroyed.
+   */
+  class Scope
+  {
+  private:
+    StartupTimeline* m_timeline;
+    size_t m_index;
+
+  public:
+    Scope(StartupTimeline* timeline, size_t index);
+    ~Scope();
+
+    deleteCopyAndMove(Scope);
+  };
+
+private:
+  Clock::time_point m_start;
+  Clock::time_point m_end;
+  std::vector<Phase> m_phases;
+  std::vector<size_t> m_openPhases;
+  bool m_finished = false;
+  std::filesystem::path m_tracePath;
+
+public:
+  static StartupTimeline& instance();
+
+  StartupTimeline();
+
+  /**
+   * Begins a phase with the given name that lasts until the returned scope is destroyed.
+   */
+  [[nodiscard]] Scope phase(std::string name);
+
+  /**
+   * Sets the path of the file to write the Chrome trace to when startup has finished.
+   */
+  void setTracePath(std::filesystem::path tracePath);
+
+  bool finished() const;
+  const std::vector<Phase>& phases() const;
+
+  /**
+   * Ends the recording, logs the summary and writes the trace file if a trace path was
+   * set. Only the first call has an effect.
+   */
+  void finish();
+
+  /**
+   * Returns a human readable summary of the recorded phases, with nested phases
+   * indented below their parents.
+   */
+  std::string summary() const;
+
+  /**
+   * Returns the recorded phases as a JSON document in the Chrome trace event format.
+   */
+  std::string chromeTrace() const;
+
+private:
+  void endPhase(size_t index);
+};
+
+} // namespace TrenchBroom
@@ -19,8 +19,10 @@
 
 #include "TrenchBroomApp.h"
 
+#include "BatchProcessor.h"
 #include "Error.h"
 #include "Exceptions.h"
+#include "FileLogger.h"
 #include "IO/DiskIO.h"
 #include "IO/PathInfo.h"
 #include "IO/PathQt.h"
@@ -30,9 +32,12 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Result.h"
+#include "StallDetector.h"
+#include "StartupTimeline.h"
 #include "TrenchBroomStackWalker.h"
 #include "View/AboutDialog.h"
 #include "View/Actions.h"
+#include "View/Autosaver.h"
 #include "View/CrashDialog.h"
 #include "View/FrameManager.h"
 #include "View/GLContextManager.h"
@@ -67,9 +72,11 @@
 #include "kdl/path_utils.h"
 #include "kdl/set_temp.h"
 #include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <chrono>
 #include <clocale>
 #include <csignal>
@@ -77,6 +84,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -144,14 +152,25 @@ TrenchBroomApp::TrenchBroomApp(int& argc, char** argv)
   setOrganizationName("");
   setOrganizationDomain("io.github.trenchbroom");
 
-  if (!initializeGameFactory())
+  // load the preferences before they are first used so that loading them is recorded as
+  // a separate startup phase
+  PreferenceManager::instance();
+
+  auto& startupTimeline = StartupTimeline::instance();
   {
-    QCoreApplication::exit(1);
-    return;
+    const auto phase = startupTimeline.phase("Load game configurations");
+    if (!initializeGameFactory())
+    {
+      QCoreApplication::exit(1);
+      return;
+    }
   }
 
-  loadStyleSheets();
-  loadStyle();
+  {
+    const auto phase = startupTimeline.phase("Load style");
+    loadStyleSheets();
+    loadStyle();
+  }
 
   // these must be initialized here and not earlier
   m_frameManager = std::make_unique<FrameManager>(useSDI());
@@ -177,6 +196,19 @@ TrenchBroomApp::TrenchBroomApp(int& argc, char** argv)
     &RecentDocuments::reload);
   m_recentDocumentsReloadTimer->start(1s);
 
+  if (const auto threshold = pref(Preferences::StallReportThreshold); threshold > 0)
+  {
+    m_stallDetector = std::make_unique<StallDetector>(
+      IO::SystemPaths::logFilePath().parent_path() / "StallReports",
+      std::chrono::milliseconds{threshold});
+
+    // the timer only fires while the event loop is running
+    auto* heartbeatTimer = new QTimer{this};
+    connect(
+      heartbeatTimer, &QTimer::timeout, this, [&]() { m_stallDetector->heartbeat(); });
+    heartbeatTimer->start(m_stallDetector->heartbeatInterval());
+  }
+
 #ifdef __APPLE__
   setQuitOnLastWindowClosed(false);
 
@@ -214,12 +246,131 @@ TrenchBroomApp::~TrenchBroomApp()
 
 void TrenchBroomApp::parseCommandLineAndShowFrame()
 {
+  const auto startupTraceOption = QCommandLineOption{
+    "startup-trace",
+    "Write the startup phases to <file> in the Chrome trace event format.",
+    "file"};
+
   auto parser = QCommandLineParser{};
   parser.addOption(QCommandLineOption("portable"));
+  parser.addOption(startupTraceOption);
   parser.process(*this);
+
+  if (parser.isSet(startupTraceOption))
+  {
+    StartupTimeline::instance().setTracePath(
+      IO::pathFromQString(parser.value(startupTraceOption)));
+  }
+
   openFilesOrWelcomeFrame(parser.positionalArguments());
 }
 
+int TrenchBroomApp::runBatch()
+{
+  const auto validateOption =
+    QCommandLineOption{"validate", "Report the issues found by the issue browser."};
+  const auto convertOption = QCommandLineOption{
+    "convert",
+    "Convert the maps to <format> and write them to the output directory.",
+    "format"};
+  const auto exportObjOption =
+    QCommandLineOption{"export-obj", "Export the maps as OBJ files."};
+  const auto outputDirOption = QCommandLineOption{
+    "output-dir", "Write the converted maps and exported files to <dir>.", "dir"};
+  const auto gameOption = QCommandLineOption{
+    "game", "Use <name> for maps that do not specify their game.", "name"};
+  const auto reportOption = QCommandLineOption{
+    "report", "Write the JSON report to <file> instead of stdout.", "file"};
+
+  auto parser = QCommandLineParser{};
+  parser.addHelpOption();
+  parser.addOption(QCommandLineOption("batch"));
+  parser.addOption(QCommandLineOption("portable"));
+  parser.addOption(validateOption);
+  parser.addOption(convertOption);
+  parser.addOption(exportObjOption);
+  parser.addOption(outputDirOption);
+  parser.addOption(gameOption);
+  parser.addOption(reportOption);
+  parser.addPositionalArgument("maps", "The map files to process.", "<map>...");
+  parser.process(*this);
+
+  auto options = BatchOptions{};
+  options.validate = parser.isSet(validateOption);
+  options.exportObj = parser.isSet(exportObjOption);
+  options.entityDefinitionCacheDirectory =
+    pref(Preferences::UseEntityDefinitionCache)
+      ? std::optional{IO::SystemPaths::userDataDirectory() / "EntityDefinitionCache"}
+      : std::nullopt;
+
+  if (parser.isSet(convertOption))
+  {
+    const auto format = Model::formatFromName(parser.value(convertOption).toStdString());
+    if (format == Model::MapFormat::Unknown)
+    {
+      qCritical() << "Unknown map format:" << parser.value(convertOption);
+      return 1;
+    }
+    options.targetFormat = format;
+  }
+
+  if (parser.isSet(outputDirOption))
+  {
+    options.outputDirectory = IO::pathFromQString(parser.value(outputDirOption));
+    if (!IO::Disk::createDirectory(options.outputDirectory)
+           .if_error([&](const auto& e) {
+             qCritical().noquote()
+               << "Could not create output directory:" << QString::fromStdString(e.msg);
+           })
+           .is_success())
+    {
+      return 1;
+    }
+  }
+
+  const auto paths =
+    kdl::vec_transform(parser.positionalArguments(), [](const auto& arg) {
+      return IO::pathFromQString(arg);
+    });
+  if (paths.empty())
+  {
+    qCritical() << "No maps given";
+    return 1;
+  }
+
+  const auto defaultGameName = parser.isSet(gameOption)
+                                 ? std::optional{parser.value(gameOption).toStdString()}
+                                 : std::nullopt;
+
+  auto& gameFactory = Model::GameFactory::instance();
+  const auto jobs =
+    createBatchJobs(gameFactory, paths, defaultGameName, FileLogger::instance());
+  const auto results = processMaps(jobs, options);
+  const auto report = batchReport(results);
+
+  if (parser.isSet(reportOption))
+  {
+    const auto reportPath = IO::pathFromQString(parser.value(reportOption));
+    if (!IO::Disk::withOutputStream(reportPath, [&](auto& stream) { stream << report; })
+           .if_error([&](const auto& e) {
+             qCritical().noquote()
+               << "Could not write report:" << QString::fromStdString(e.msg);
+           })
+           .is_success())
+    {
+      return 1;
+    }
+  }
+  else
+  {
+    std::cout << report;
+  }
+
+  const auto failed = std::any_of(
+    results.begin(), results.end(), [](const auto& r) { return !r.succeeded(); });
+  return failed ? 1 : 0;
+}
+
 FrameManager* TrenchBroomApp::frameManager()
 {
   return m_frameManager.get();
@@ -439,7 +590,7 @@ bool TrenchBroomApp::initializeGameFactory()
   };
   auto& gameFactory = Model::GameFactory::instance();
   return gameFactory.initialize(gamePathConfig)
-    .transform([](auto errors) {
+    .transform([&](auto errors) {
       if (!errors.empty())
       {
         const auto msg = fmt::format(
@@ -448,8 +599,15 @@ bool TrenchBroomApp::initializeGameFactory()
 {})",
           kdl::str_join(errors, "\n\n"));
 
-        QMessageBox::critical(
-          nullptr, "TrenchBroom", QString::fromStdString(msg), QMessageBox::Ok);
+        if (arguments().contains("--batch"))
+        {
+          qCritical() << QString::fromStdString(msg);
+        }
+        else
+        {
+          QMessageBox::critical(
+            nullptr, "TrenchBroom", QString::fromStdString(msg), QMessageBox::Ok);
+        }
       }
     })
     .if_error([](auto e) { qCritical() << QString::fromStdString(e.msg); })
@@ -502,7 +660,7 @@ void TrenchBroomApp::openDocument()
     nullptr,
     tr("Open Map"),
     fileDialogDefaultDirectory(FileDialogDir::Map),
-    "Map files (*.map);;Any files (*.*)");
+    "Map files (*.map *.map.gz);;Any files (*.*)");
 
   if (const auto path = IO::pathFromQString(pathStr); !path.empty())
   {
@@ -511,6 +669,54 @@ void TrenchBroomApp::openDocument()
   }
 }
 
+void TrenchBroomApp::restoreAutosave()
+{
+  const auto deltaPathStr = QFileDialog::getOpenFileName(
+    nullptr,
+    tr("Restore Autosave"),
+    fileDialogDefaultDirectory(FileDialogDir::Map),
+    "Delta backups (*.delta)");
+
+  const auto deltaPath = IO::pathFromQString(deltaPathStr);
+  if (deltaPath.empty())
+  {
+    return;
+  }
+
+  // the delta is named like "name.1.map.2.delta", it restores to "name.1.map"
+  const auto restoredPath =
+    kdl::path_remove_extension(deltaPath.parent_path() / deltaPath.stem());
+  const auto mapPathStr = QFileDialog::getSaveFileName(
+    nullptr,
+    tr("Save Restored Map"),
+    IO::pathAsQString(restoredPath.parent_path() / restoredPath.stem())
+      + ".restored.map",
+    "Map files (*.map)");
+
+  const auto mapPath = IO::pathFromQString(mapPathStr);
+  if (mapPath.empty())
+  {
+    return;
+  }
+
+  restoreDeltaBackup(deltaPath)
+    .and_then([&](const auto& mapText) {
+      return IO::Disk::withOutputStream(
+        mapPath, [&](auto& stream) { stream << mapText; });
+    })
+    .transform([&]() {
+      updateFileDialogDefaultDirectoryWithFilename(FileDialogDir::Map, mapPathStr);
+      openDocument(mapPath);
+    })
+    .transform_error([&](const auto& e) {
+      QMessageBox::critical(
+        nullptr,
+        "TrenchBroom",
+        QString::fromStdString("Could not restore autosave: " + e.msg),
+        QMessageBox::Ok);
+    });
+}
+
 void TrenchBroomApp::showManual()
 {
   const auto manualPath = IO::SystemPaths::findResourceFile("manual/index.html");
@@ -602,10 +808,13 @@ void TrenchBroomApp::openFilesOrWelcomeFrame(const QStringList& fileNames)
   const auto filesToOpen =
     useSDI() && !fileNames.empty() ? QStringList{fileNames.front()} : fileNames;
 
+  auto& startupTimeline = StartupTimeline::instance();
+
   auto anyDocumentOpened = false;
   for (const auto& fileName : filesToOpen)
   {
     const auto path = IO::pathFromQString(fileName);
+    const auto phase = startupTimeline.phase("Open " + path.filename().string());
     if (!path.empty() && openDocument(path))
     {
       anyDocumentOpened = true;
@@ -614,7 +823,13 @@ void TrenchBroomApp::openFilesOrWelcomeFrame(const QStringList& fileNames)
 
   if (!anyDocumentOpened)
   {
-    showWelcomeWindow();
+    {
+      const auto phase = startupTimeline.phase("Show welcome window");
+      showWelcomeWindow();
+    }
+
+    // the welcome window doesn't render anything with OpenGL, so startup has finished
+    startupTimeline.finish();
   }
 }
 
@@ -748,7 +963,8 @@ void reportCrashAndExit(const std::string& stacktrace, const std::string& reason
         mapPath = std::filesystem::path{};
       }
 
-      // Copy the log file
+      // Copy the log file once the pending messages have been written
+      FileLogger::instance().flush();
       if (!QFile::copy(
             IO::pathAsQString(IO::SystemPaths::logFilePath()),
             IO::pathAsQString(logPath)))
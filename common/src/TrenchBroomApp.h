@@ -35,6 +35,7 @@ class QTimer;
 namespace TrenchBroom
 {
 class Logger;
+class StallDetector;
 
 namespace View
 {
@@ -51,6 +52,7 @@ private:
   std::unique_ptr<RecentDocuments> m_recentDocuments;
   std::unique_ptr<WelcomeWindow> m_welcomeWindow;
   QTimer* m_recentDocumentsReloadTimer;
+  std::unique_ptr<StallDetector> m_stallDetector;
 
 public:
   static TrenchBroomApp& instance();
@@ -61,6 +63,12 @@ public:
 public:
   void parseCommandLineAndShowFrame();
 
+  /**
+   * Processes the maps given on the command line without showing any windows and returns
+   * the exit code of the application.
+   */
+  int runBatch();
+
   FrameManager* frameManager();
 
 private:
@@ -81,6 +89,7 @@ public:
 
   bool newDocument();
   void openDocument();
+  void restoreAutosave();
   void showManual();
   void showPreferences();
   void showAboutDialog();
@@ -25,13 +25,19 @@
 #endif
 #else
 #include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
 #endif
 
 #include "TrenchBroomStackWalker.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace TrenchBroom
@@ -92,20 +98,62 @@ std::string TrenchBroomStackWalker::getStackTraceFromContext(void* context)
 {
   return getStackTraceInternal(static_cast<CONTEXT*>(context));
 }
+
+static HANDLE s_mainThread = nullptr;
+
+void TrenchBroomStackWalker::registerMainThread()
+{
+  if (s_mainThread == nullptr)
+  {
+    // GetCurrentThread returns a pseudo handle that is only valid on the calling thread
+    DuplicateHandle(
+      GetCurrentProcess(),
+      GetCurrentThread(),
+      GetCurrentProcess(),
+      &s_mainThread,
+      0,
+      FALSE,
+      DUPLICATE_SAME_ACCESS);
+  }
+}
+
+std::string TrenchBroomStackWalker::getMainThreadStackTrace()
+{
+  if (s_mainThread == nullptr)
+  {
+    return "";
+  }
+
+  QMutexLocker lock(&s_stackWalkerMutex);
+
+  if (s_stackWalker == nullptr)
+  {
+    s_stackWalker = new TBStackWalker();
+  }
+  s_stackWalker->clear();
+  // suspends the main thread while its stack is walked
+  s_stackWalker->ShowCallstack(s_mainThread);
+  return s_stackWalker->asString();
+}
 #else
 // TODO: not sure what to use on mingw
 std::string TrenchBroomStackWalker::getStackTrace()
 {
   return "";
 }
+
+void TrenchBroomStackWalker::registerMainThread() {}
+
+std::string TrenchBroomStackWalker::getMainThreadStackTrace()
+{
+  return "";
+}
 #endif
 #else
-std::string TrenchBroomStackWalker::getStackTrace()
-{
-  const int MaxDepth = 256;
-  void* callstack[MaxDepth];
-  const int frames = backtrace(callstack, MaxDepth);
+static const int MaxDepth = 256;
 
+static std::string symbolizeStackTrace(void** callstack, const int frames)
+{
   // copy into a vector
   std::vector<void*> framesVec(callstack, callstack + frames);
   if (framesVec.empty())
@@ -120,5 +168,76 @@ std::string TrenchBroomStackWalker::getStackTrace()
   free(strs);
   return ss.str();
 }
+
+std::string TrenchBroomStackWalker::getStackTrace()
+{
+  void* callstack[MaxDepth];
+  const int frames = backtrace(callstack, MaxDepth);
+  return symbolizeStackTrace(callstack, frames);
+}
+
+// the main thread captures its stack in a signal handler when it is sent this signal
+static const int MainThreadStackSignal = SIGUSR2;
+
+static std::mutex s_mainThreadMutex;
+static std::atomic<bool> s_mainThreadRegistered = false;
+static pthread_t s_mainThread;
+static void* s_mainThreadCallstack[MaxDepth];
+static std::atomic<int> s_mainThreadFrames = -1;
+
+static void captureMainThreadStackTrace(int)
+{
+  s_mainThreadFrames = backtrace(s_mainThreadCallstack, MaxDepth);
+}
+
+void TrenchBroomStackWalker::registerMainThread()
+{
+  if (!s_mainThreadRegistered)
+  {
+    // the first call to backtrace may allocate memory, which is not allowed in a signal
+    // handler
+    void* callstack[1];
+    backtrace(callstack, 1);
+
+    struct sigaction action = {};
+    action.sa_handler = captureMainThreadStackTrace;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(MainThreadStackSignal, &action, nullptr);
+
+    s_mainThread = pthread_self();
+    s_mainThreadRegistered = true;
+  }
+}
+
+std::string TrenchBroomStackWalker::getMainThreadStackTrace()
+{
+  using namespace std::chrono_literals;
+
+  if (!s_mainThreadRegistered)
+  {
+    return "";
+  }
+
+  const auto lock = std::lock_guard{s_mainThreadMutex};
+  s_mainThreadFrames = -1;
+  if (pthread_kill(s_mainThread, MainThreadStackSignal) != 0)
+  {
+    return "";
+  }
+
+  // the signal is handled as soon as the main thread is scheduled
+  const auto timeout = std::chrono::steady_clock::now() + 1s;
+  while (s_mainThreadFrames < 0)
+  {
+    if (std::chrono::steady_clock::now() > timeout)
+    {
+      return "";
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+
+  return symbolizeStackTrace(s_mainThreadCallstack, s_mainThreadFrames);
+}
 #endif
 } // namespace TrenchBroom
@@ -30,5 +30,18 @@ public:
   static std::string getStackTraceFromContext(void* context);
 #endif
   static std::string getStackTrace();
+
+  /**
+   * Remembers the calling thread as the main thread so that its stack trace can be
+   * captured from other threads. Must be called on the main thread.
+   */
+  static void registerMainThread();
+
+  /**
+   * Returns the stack trace of the main thread, which must have been registered. Must not
+   * be called on the main thread. Returns an empty string if the stack trace could not
+   * be captured.
+   */
+  static std::string getMainThreadStackTrace();
 };
 } // namespace TrenchBroom
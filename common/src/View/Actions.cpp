@@ -27,6 +27,7 @@
 #include "Model/Tag.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "TrenchBroomApp.h"
 #include "View/Grid.h"
 #include "View/Inspector.h"
@@ -1057,6 +1058,18 @@ void ActionManager::createFileMenu()
     },
     [](ActionExecutionContext&) { return true; }));
   fileMenu.addMenu("Open Recent", MenuEntryType::Menu_RecentDocuments);
+  fileMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/File/Restore Autosave..."},
+    QObject::tr("Restore Autosave..."),
+    0,
+    [](ActionExecutionContext&) {
+      auto& app = TrenchBroomApp::instance();
+      app.restoreAutosave();
+    },
+    [](ActionExecutionContext&) { return true; },
+    std::filesystem::path{},
+    QObject::tr("Rebuilds a map from a delta autosave and the full autosave it was "
+                "made against, and opens it.")));
   fileMenu.addSeparator();
   fileMenu.addItem(createMenuAction(
     std::filesystem::path{"Menu/File/Save"},
@@ -1087,6 +1100,15 @@ void ActionManager::createFileMenu()
     std::filesystem::path{},
     QObject::tr("Exports the current map to a .map file. Layers marked Omit From Export "
                 "will be omitted.")));
+  exportMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/File/Export/Render Pass Timings..."},
+    QObject::tr("Render Pass Timings..."),
+    0,
+    [](ActionExecutionContext& context) { context.frame()->exportRenderPassTimings(); },
+    [](ActionExecutionContext& context) { return context.hasDocument(); },
+    std::filesystem::path{},
+    QObject::tr("Exports the GPU timings of the current view's render passes to a CSV "
+                "file.")));
 
   /* ========== File Menu (Associated Resources) ========== */
   fileMenu.addSeparator();
@@ -1979,6 +2001,25 @@ void ActionManager::createDebugMenu()
     0,
     [](ActionExecutionContext& context) { context.frame()->debugShowPalette(); },
     [](ActionExecutionContext& context) { return context.hasDocument(); }));
+  debugMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/Debug/Profile Hot Paths"},
+    QObject::tr("Profile Hot Paths"),
+    0,
+    [](ActionExecutionContext&) { Profiler::setEnabled(!Profiler::enabled()); },
+    [](ActionExecutionContext&) { return true; },
+    [](ActionExecutionContext&) { return Profiler::enabled(); }));
+  debugMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/Debug/Export Profiler Trace..."},
+    QObject::tr("Export Profiler Trace..."),
+    0,
+    [](ActionExecutionContext& context) { context.frame()->debugExportProfilerTrace(); },
+    [](ActionExecutionContext& context) { return context.hasDocument(); }));
+  debugMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/Debug/Show Memory Report..."},
+    QObject::tr("Show Memory Report..."),
+    0,
+    [](ActionExecutionContext& context) { context.frame()->debugShowMemoryReport(); },
+    [](ActionExecutionContext& context) { return context.hasDocument(); }));
 #endif
 }
 
@@ -22,6 +22,7 @@
 #include "Ensure.h"
 #include "Error.h"
 #include "Macros.h"
+#include "Model/ModelUtils.h"
 #include "Model/Node.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -104,6 +105,17 @@ std::unique_ptr<CommandResult> AddRemoveNodesCommand::doPerformUndo(
   return std::make_unique<CommandResult>(true);
 }
 
+size_t AddRemoveNodesCommand::doEstimateMemoryUsage() const
+{
+  // this command owns the nodes to add
+  auto result = UpdateLinkedGroupsCommandBase::doEstimateMemoryUsage();
+  for (const auto& [parent, children] : m_nodesToAdd)
+  {
+    result += Model::estimateMemoryUsage(children);
+  }
+  return result;
+}
+
 void AddRemoveNodesCommand::doAction(MapDocumentCommandFacade* document)
 {
   switch (m_action)
@@ -67,6 +67,8 @@ private:
   std::unique_ptr<CommandResult> doPerformUndo(
     MapDocumentCommandFacade* document) override;
 
+  size_t doEstimateMemoryUsage() const override;
+
   void doAction(MapDocumentCommandFacade* document);
   void undoAction(MapDocumentCommandFacade* document);
 
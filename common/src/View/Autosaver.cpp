@@ -19,12 +19,19 @@
 
 #include "Autosaver.h"
 
+#include "CollectingLogger.h"
 #include "Error.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
 #include "IO/FileSystem.h"
+#include "IO/MapDelta.h"
 #include "IO/PathInfo.h"
+#include "IO/Reader.h"
 #include "IO/TraversalMode.h"
+#include "Logger.h"
+#include "Model/Game.h"
+#include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
 #include "kdl/memory_utils.h"
@@ -36,8 +43,11 @@
 #include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
+#include <QString>
+
 #include <algorithm> // for std::sort
 #include <cassert>
+#include <sstream>
 
 namespace TrenchBroom::View
 {
@@ -57,20 +67,83 @@ IO::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename)
   };
 }
 
+IO::PathMatcher makeDeltaPathMatcher(std::filesystem::path mapBasename)
+{
+  return [backupPathMatcher = makeBackupPathMatcher(std::move(mapBasename))](
+           const std::filesystem::path& path, const IO::GetPathInfo& getPathInfo) {
+    const auto deltaName = path.stem();
+    const auto deltaExtension = deltaName.extension().string();
+    const auto deltaNum = deltaExtension.empty() ? "" : deltaExtension.substr(1);
+
+    // the backup that the delta was made against need not exist
+    const auto getBackupPathInfo = [](const auto&) { return IO::PathInfo::File; };
+
+    return getPathInfo(path) == IO::PathInfo::File
+           && kdl::ci::str_is_equal(path.extension().string(), ".delta")
+           && kdl::str_is_numeric(deltaNum)
+           && kdl::str_to_size(deltaNum).value_or(0u) > 0u
+           && backupPathMatcher(kdl::path_remove_extension(deltaName), getBackupPathInfo);
+  };
+}
+
+namespace
+{
+
+Result<std::string> readFile(const std::filesystem::path& path)
+{
+  return IO::Disk::mapFile(path).transform([](auto file) {
+    const auto reader = file->reader().buffer();
+    return std::string{reader.stringView()};
+  });
+}
+
+} // namespace
+
+Result<std::string> restoreDeltaBackup(const std::filesystem::path& deltaPath)
+{
+  const auto backupPath =
+    kdl::path_remove_extension(deltaPath.parent_path() / deltaPath.stem());
+  return readFile(backupPath).and_then([&](const auto backup) {
+    return readFile(deltaPath).and_then(
+      [&](const auto delta) { return IO::applyMapDelta(backup, delta); });
+  });
+}
+
 Autosaver::Autosaver(
   std::weak_ptr<MapDocument> document,
   const std::chrono::milliseconds saveInterval,
-  const size_t maxBackups)
+  const size_t maxBackups,
+  const size_t maxDeltas)
   : m_document{std::move(document)}
   , m_saveInterval{saveInterval}
   , m_maxBackups{maxBackups}
+  , m_maxDeltas{maxDeltas}
   , m_lastSaveTime{Clock::now()}
   , m_lastModificationCount{kdl::mem_lock(m_document)->modificationCount()}
 {
 }
 
+Autosaver::~Autosaver()
+{
+  if (m_pendingAutosave.valid())
+  {
+    m_pendingAutosave.wait();
+  }
+}
+
 void Autosaver::triggerAutosave(Logger& logger)
 {
+  using namespace std::chrono_literals;
+
+  if (m_pendingAutosave.valid())
+  {
+    if (m_pendingAutosave.wait_for(0s) != std::future_status::ready)
+    {
+      return;
+    }
+    reportAutosave(logger, m_pendingAutosave.get());
+  }
+
   if (!kdl::mem_expired(m_document))
   {
     auto document = kdl::mem_lock(m_document);
@@ -83,9 +156,16 @@ void Autosaver::triggerAutosave(Logger& logger)
   }
 }
 
-namespace
+void Autosaver::finishPendingAutosave(Logger& logger)
 {
+  if (m_pendingAutosave.valid())
+  {
+    reportAutosave(logger, m_pendingAutosave.get());
+  }
+}
 
+namespace
+{
 Result<IO::WritableDiskFileSystem> createBackupFileSystem(
   const std::filesystem::path& mapPath)
 {
@@ -150,37 +230,149 @@ Result<void> cleanBackups(
     }));
 }
 
-} // namespace
-
-void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
+/**
+ * Deletes the delta backups of the given map. They become useless when the backups are
+ * rotated because the names of the backups they were made against change.
+ */
+Result<void> deleteDeltas(
+  Logger& logger,
+  IO::WritableDiskFileSystem& fs,
+  const std::filesystem::path& mapBasename)
 {
-  const auto& mapPath = document->path();
-  assert(IO::Disk::pathInfo(mapPath) == IO::PathInfo::File);
+  return fs.find({}, IO::TraversalMode::Flat, makeDeltaPathMatcher(mapBasename))
+    .and_then([&](const auto deltaPaths) {
+      return kdl::fold_results(kdl::vec_transform(deltaPaths, [&](const auto& filename) {
+        return fs.deleteFile(filename).transform([&](const auto deleted) {
+          if (deleted)
+          {
+            logger.debug() << "Deleted autosave delta " << filename;
+          }
+        });
+      }));
+    });
+}
 
-  const auto mapFilename = mapPath.filename();
+/**
+ * Rotates the existing backups and writes the given map to a new backup file. Does not
+ * access the document, so it can run on a worker thread.
+ */
+Result<std::filesystem::path> writeBackup(
+  Logger& logger,
+  const std::filesystem::path& mapPath,
+  const std::string& mapString,
+  const size_t maxBackups)
+{
   const auto mapBasename = mapPath.stem();
 
-  createBackupFileSystem(mapPath)
+  return createBackupFileSystem(mapPath)
     .and_then([&](auto fs) {
-      return collectBackups(fs, mapBasename)
+      return deleteDeltas(logger, fs, mapBasename)
+        .and_then([&]() { return collectBackups(fs, mapBasename); })
         .and_then(
-          [&](auto backups) { return thinBackups(logger, fs, backups, m_maxBackups); })
+          [&](auto backups) { return thinBackups(logger, fs, backups, maxBackups); })
         .and_then([&](auto remainingBackups) {
           return cleanBackups(fs, remainingBackups, mapBasename).and_then([&]() {
-            assert(remainingBackups.size() < m_maxBackups);
+            assert(remainingBackups.size() < maxBackups);
             const auto backupNo = remainingBackups.size() + 1;
             return fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
           });
         });
     })
+    .and_then([&](auto backupFilePath) {
+      return IO::Disk::withOutputStream(backupFilePath, [&](auto& stream) {
+               stream << mapString;
+             })
+        .transform([&]() { return backupFilePath; });
+    });
+}
+
+/**
+ * Writes the difference between the given full backup and the given map to a delta
+ * backup next to the full backup. Does not access the document, so it can run on a
+ * worker thread.
+ */
+Result<std::filesystem::path> writeDeltaBackup(
+  const std::filesystem::path& backupPath,
+  const std::string& mapString,
+  const size_t deltaNo)
+{
+  return readFile(backupPath).and_then([&](const auto backup) {
+    const auto deltaPath =
+      kdl::path_add_extension(backupPath, "." + kdl::str_to_string(deltaNo) + ".delta");
+    return IO::Disk::withOutputStream(deltaPath, [&](auto& stream) {
+             stream << IO::makeMapDelta(backup, mapString);
+           })
+      .transform([&]() { return deltaPath; });
+  });
+}
+
+} // namespace
+
+void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
+{
+  const auto& mapPath = document->path();
+  assert(IO::Disk::pathInfo(mapPath) == IO::PathInfo::File);
+
+  // Serializing the document is cheap because the text of unchanged brushes is reused
+  // from the last save. The document must not be accessed by the worker thread.
+  auto stream = std::stringstream{};
+  document->game()->writeMap(*document->world(), stream);
+
+  logger.debug() << "Writing autosave backup for " << mapPath;
+
+  const auto deltaBasePath = m_deltaCount < m_maxDeltas
+                               ? m_deltaBasePath
+                               : std::optional<std::filesystem::path>{};
+
+  m_pendingAutosave = std::async(
+    std::launch::async,
+    [mapPath,
+     mapString = stream.str(),
+     maxBackups = m_maxBackups,
+     deltaBasePath,
+     deltaNo = m_deltaCount + 1,
+     modificationCount = document->modificationCount()]() {
+      auto workerLogger = CollectingLogger{};
+      auto backupPath = deltaBasePath
+                          ? writeDeltaBackup(*deltaBasePath, mapString, deltaNo)
+                          : writeBackup(workerLogger, mapPath, mapString, maxBackups);
+      return AutosaveResult{
+        workerLogger.takeMessages(),
+        std::move(backupPath),
+        deltaBasePath.has_value(),
+        modificationCount};
+    });
+}
+
+void Autosaver::reportAutosave(Logger& logger, AutosaveResult result)
+{
+  for (const auto& [level, message] : result.messages)
+  {
+    logger.log(level, message);
+  }
+
+  std::move(result.backupPath)
     .transform([&](const auto& backupFilePath) {
       m_lastSaveTime = Clock::now();
-      m_lastModificationCount = document->modificationCount();
-      document->saveDocumentTo(backupFilePath);
+      m_lastModificationCount = result.modificationCount;
+
+      if (result.isDelta)
+      {
+        ++m_deltaCount;
+      }
+      else
+      {
+        m_deltaBasePath = m_maxDeltas > 0 ? std::optional{backupFilePath} : std::nullopt;
+        m_deltaCount = 0;
+      }
 
       logger.info() << "Created autosave backup at " << backupFilePath;
     })
-    .transform_error([&](auto e) { logger.error() << "Aborting autosave: " << e.msg; });
+    .transform_error([&](auto e) {
+      // the next autosave will write a full backup
+      m_deltaBasePath = std::nullopt;
+      logger.error() << "Aborting autosave: " << e.msg;
+    });
 }
 
 } // namespace TrenchBroom::View
@@ -19,16 +19,21 @@
 
 #pragma once
 
+#include "Error.h"
 #include "IO/PathMatcher.h"
+#include "Logger.h"
+#include "Result.h"
+
+#include "kdl/result.h"
 
 #include <chrono>
 #include <filesystem>
+#include <future>
 #include <memory>
-
-namespace TrenchBroom
-{
-class Logger;
-} // namespace TrenchBroom
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom::View
 {
@@ -36,6 +41,13 @@ class Command;
 class MapDocument;
 
 IO::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename);
+IO::PathMatcher makeDeltaPathMatcher(std::filesystem::path mapBasename);
+
+/**
+ * Rebuilds the contents of a map from the delta backup at the given path and the full
+ * backup that it was made against.
+ */
+Result<std::string> restoreDeltaBackup(const std::filesystem::path& deltaPath);
 
 class Autosaver
 {
@@ -55,6 +67,20 @@ private:
    */
   size_t m_maxBackups;
 
+  /**
+   * The number of delta backups to write after each full backup. A delta backup only
+   * stores the entities and brushes that differ from the last full backup. If this is
+   * zero, every backup is a full backup.
+   */
+  size_t m_maxDeltas;
+
+  /**
+   * The full backup that delta backups are made against, and the number of delta backups
+   * that have been written since it was created.
+   */
+  std::optional<std::filesystem::path> m_deltaBasePath;
+  size_t m_deltaCount = 0;
+
   /**
    * The time at which the last autosave has succeeded.
    */
@@ -65,15 +91,51 @@ private:
    */
   size_t m_lastModificationCount;
 
+  /**
+   * The result of an autosave that was written on a worker thread. The messages are
+   * collected by the worker thread and logged on the calling thread once the autosave has
+   * finished.
+   */
+  struct AutosaveResult
+  {
+    std::vector<std::pair<LogLevel, std::string>> messages;
+    Result<std::filesystem::path> backupPath;
+    bool isDelta;
+    size_t modificationCount;
+  };
+
+  /**
+   * The autosave that is currently being written, if any.
+   */
+  std::future<AutosaveResult> m_pendingAutosave;
+
 public:
   explicit Autosaver(
     std::weak_ptr<MapDocument> document,
     std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000),
-    size_t maxBackups = 50);
+    size_t maxBackups = 50,
+    size_t maxDeltas = 0);
+
+  /**
+   * Waits until the pending autosave, if any, has been written.
+   */
+  ~Autosaver();
 
+  /**
+   * Serializes the document if it should be autosaved, and writes the backup on a worker
+   * thread. If an autosave is still being written, no new autosave is started. The result
+   * of a finished autosave is reported to the given logger.
+   */
   void triggerAutosave(Logger& logger);
 
+  /**
+   * Waits until the pending autosave, if any, has been written and reports its result to
+   * the given logger.
+   */
+  void finishPendingAutosave(Logger& logger);
+
 private:
   void autosave(Logger& logger, std::shared_ptr<View::MapDocument> document);
+  void reportAutosave(Logger& logger, AutosaveResult result);
 };
 } // namespace TrenchBroom::View
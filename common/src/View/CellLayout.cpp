@@ -22,11 +22,36 @@
 #include "Ensure.h"
 #include "Macros.h"
 
+#include "kdl/vector_utils.h"
+
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <utility>
 
 namespace TrenchBroom::View
 {
+namespace
+{
+
+/**
+ * Returns the elements of the given vector that intersect the given vertical range. The
+ * elements must be sorted by their vertical position and must not overlap.
+ */
+template <typename T>
+auto visibleRange(const std::vector<T>& elements, const float y, const float height)
+{
+  const auto first = std::partition_point(
+    elements.begin(), elements.end(), [&](const auto& element) {
+      return element.bounds().bottom() < y;
+    });
+  const auto last = std::partition_point(first, elements.end(), [&](const auto& element) {
+    return element.bounds().top() <= y + height;
+  });
+  return kdl::range{first, last};
+}
+
+} // namespace
 
 float LayoutBounds::left() const
 {
@@ -239,6 +264,11 @@ bool LayoutRow::intersectsY(const float y, const float height) const
   return m_bounds.intersectsY(y, height);
 }
 
+std::vector<LayoutCell> LayoutRow::releaseCells()
+{
+  return std::exchange(m_cells, {});
+}
+
 bool LayoutRow::canAddItem(
   const float itemWidth,
   const float itemHeight,
@@ -447,41 +477,28 @@ const std::vector<LayoutRow>& LayoutGroup::rows() const
   return m_rows;
 }
 
-size_t LayoutGroup::indexOfRowAt(const float y) const
+kdl::range<std::vector<LayoutRow>::const_iterator> LayoutGroup::visibleRows(
+  const float y, const float height) const
 {
-  for (size_t i = 0; i < m_rows.size(); ++i)
-  {
-    const auto& row = m_rows[i];
-    const auto& rowBounds = row.bounds();
-    if (y < rowBounds.bottom())
-    {
-      return i;
-    }
-  }
+  return visibleRange(m_rows, y, height);
+}
 
-  return m_rows.size();
+size_t LayoutGroup::indexOfRowAt(const float y) const
+{
+  const auto it =
+    std::partition_point(m_rows.begin(), m_rows.end(), [&](const auto& row) {
+      return y >= row.bounds().bottom();
+    });
+  return size_t(std::distance(m_rows.begin(), it));
 }
 
 const LayoutCell* LayoutGroup::cellAt(const float x, const float y) const
 {
-  for (size_t i = 0; i < m_rows.size(); ++i)
+  const auto index = indexOfRowAt(y);
+  if (index < m_rows.size() && y >= m_rows[index].bounds().top())
   {
-    const auto& row = m_rows[i];
-    const auto& rowBounds = row.bounds();
-    if (y > rowBounds.bottom())
-    {
-      continue;
-    }
-    if (y < rowBounds.top())
-    {
-      return nullptr;
-    }
-    if (const auto* cell = row.cellAt(x, y))
-    {
-      return cell;
-    }
+    return m_rows[index].cellAt(x, y);
   }
-
   return nullptr;
 }
 
@@ -495,6 +512,17 @@ bool LayoutGroup::intersectsY(const float y, const float height) const
   return bounds().intersectsY(y, height);
 }
 
+std::vector<LayoutCell> LayoutGroup::releaseCells()
+{
+  auto result = std::vector<LayoutCell>{};
+  for (auto& row : m_rows)
+  {
+    result = kdl::vec_concat(std::move(result), row.releaseCells());
+  }
+  m_rows.clear();
+  return result;
+}
+
 void LayoutGroup::addItem(
   std::any item,
   std::string title,
@@ -802,25 +830,21 @@ const std::vector<LayoutGroup>& CellLayout::groups()
   return m_groups;
 }
 
-const LayoutCell* CellLayout::cellAt(const float x, const float y)
+kdl::range<std::vector<LayoutGroup>::const_iterator> CellLayout::visibleGroups(
+  const float y, const float height)
 {
   if (!m_valid)
   {
     validate();
   }
 
-  for (size_t i = 0; i < m_groups.size(); ++i)
+  return visibleRange(m_groups, y, height);
+}
+
+const LayoutCell* CellLayout::cellAt(const float x, const float y)
+{
+  for (const auto& group : visibleGroups(y, 0.0f))
   {
-    const auto& group = m_groups[i];
-    const auto groupBounds = group.bounds();
-    if (y > groupBounds.bottom())
-    {
-      continue;
-    }
-    if (y < groupBounds.top())
-    {
-      return nullptr;
-    }
     if (const auto* cell = group.cellAt(x, y))
     {
       return cell;
@@ -920,32 +944,26 @@ void CellLayout::validate()
 
   m_height = 2.0f * m_outerMargin;
   m_valid = true;
-  if (!m_groups.empty())
-  {
-    auto copy = m_groups;
-    m_groups.clear();
 
-    for (auto& group : copy)
+  // the items are moved into the new layout, so their payloads are not copied
+  auto groups = std::exchange(m_groups, {});
+  for (auto& group : groups)
+  {
+    addGroup(group.title(), group.titleBounds().height);
+    for (auto& cell : group.releaseCells())
     {
-      addGroup(group.title(), group.titleBounds().height);
-      for (const auto& row : group.rows())
-      {
-        for (const auto& cell : row.cells())
-        {
-          const auto& itemBounds = cell.itemBounds();
-          const auto& titleBounds = cell.titleBounds();
-          const auto scale = cell.scale();
-          const auto itemWidth = itemBounds.width / scale;
-          const auto itemHeight = itemBounds.height / scale;
-          addItem(
-            cell.item(),
-            cell.title(),
-            itemWidth,
-            itemHeight,
-            titleBounds.width,
-            titleBounds.height);
-        }
-      }
+      const auto& itemBounds = cell.itemBounds();
+      const auto& titleBounds = cell.titleBounds();
+      const auto scale = cell.scale();
+      const auto itemWidth = itemBounds.width / scale;
+      const auto itemHeight = itemBounds.height / scale;
+      addItem(
+        std::move(cell.item()),
+        cell.title(),
+        itemWidth,
+        itemHeight,
+        titleBounds.width,
+        titleBounds.height);
     }
   }
 }
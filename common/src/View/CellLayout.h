@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "kdl/range.h"
+
 #include "vm/forward.h"
 #include "vm/vec.h"
 
@@ -148,6 +150,11 @@ public:
 
   bool intersectsY(float y, float height) const;
 
+  /**
+   * Moves the cells out of this row, leaving it empty.
+   */
+  std::vector<LayoutCell> releaseCells();
+
   bool canAddItem(
     float itemWidth, float itemHeight, float titleWidth, float titleHeight) const;
   void addItem(
@@ -219,12 +226,24 @@ public:
   LayoutBounds bounds() const;
 
   const std::vector<LayoutRow>& rows() const;
+
+  /**
+   * Returns the rows that intersect the given vertical range.
+   */
+  kdl::range<std::vector<LayoutRow>::const_iterator> visibleRows(
+    float y, float height) const;
+
   size_t indexOfRowAt(float y) const;
   const LayoutCell* cellAt(float x, float y) const;
 
   bool hitTest(float x, float y) const;
   bool intersectsY(float y, float height) const;
 
+  /**
+   * Moves the cells out of this group, leaving it empty.
+   */
+  std::vector<LayoutCell> releaseCells();
+
   void addItem(
     std::any item,
     std::string title,
@@ -295,6 +314,14 @@ public:
   void setWidth(float width);
 
   const std::vector<LayoutGroup>& groups();
+
+  /**
+   * Returns the groups that intersect the given vertical range. Renderers should only
+   * visit these groups and their visible rows.
+   */
+  kdl::range<std::vector<LayoutGroup>::const_iterator> visibleGroups(
+    float y, float height);
+
   const LayoutCell* cellAt(float x, float y);
 
   void addGroup(std::string title, float titleHeight);
@@ -408,9 +408,9 @@ void CellView::renderTitleBackgrounds(float y, float height)
   using Vertex = Renderer::GLVertexTypes::P2::Vertex;
   auto vertices = std::vector<Vertex>{};
 
-  for (const auto& group : m_layout.groups())
+  for (const auto& group : m_layout.visibleGroups(y, height))
   {
-    if (group.intersectsY(y, height) && !group.title().empty())
+    if (!group.title().empty())
     {
       const auto titleBounds = m_layout.titleBoundsForVisibleRect(group, y, height);
       vertices.emplace_back(
@@ -450,66 +450,58 @@ auto collectStringVertices(
   const auto subTextColor = std::vector<Color>{pref(Preferences::BrowserSubTextColor)};
 
   auto stringVertices = std::map<Renderer::FontDescriptor, std::vector<TextVertex>>{};
-  for (const auto& group : layout.groups())
+  for (const auto& group : layout.visibleGroups(y, height))
   {
-    if (group.intersectsY(y, height))
+    const auto& groupTitle = group.title();
+    if (!groupTitle.empty())
     {
-      const auto& groupTitle = group.title();
-      if (!groupTitle.empty())
+      const auto titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
+      const auto offset = vm::vec2f(
+        titleBounds.left() + 2.0f,
+        height - (titleBounds.top() - y) - titleBounds.height);
+
+      auto& font = fontManager.font(defaultFont);
+      const auto quads = font.quads(groupTitle, false, offset);
+      const auto titleVertices = TextVertex::toList(
+        quads.size() / 2,
+        kdl::skip_iterator{std::begin(quads), std::end(quads), 0, 2},
+        kdl::skip_iterator{std::begin(quads), std::end(quads), 1, 2},
+        kdl::skip_iterator{std::begin(textColor), std::end(textColor), 0, 0});
+      auto& vertices = stringVertices[defaultFont];
+      vertices.insert(
+        std::end(vertices), std::begin(titleVertices), std::end(titleVertices));
+    }
+
+    for (const auto& row : group.visibleRows(y, height))
+    {
+      for (const auto& cell : row.cells())
       {
-        const auto titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
-        const auto offset = vm::vec2f(
-          titleBounds.left() + 2.0f,
-          height - (titleBounds.top() - y) - titleBounds.height);
-
-        auto& font = fontManager.font(defaultFont);
-        const auto quads = font.quads(groupTitle, false, offset);
-        const auto titleVertices = TextVertex::toList(
-          quads.size() / 2,
-          kdl::skip_iterator{std::begin(quads), std::end(quads), 0, 2},
-          kdl::skip_iterator{std::begin(quads), std::end(quads), 1, 2},
+        const auto& cellTitle = cell.title();
+        const auto textureNameBounds = cell.titleBounds();
+        const auto textureNameFont = fontManager.selectFontSize(
+          defaultFont, cellTitle, textureNameBounds.width, 6);
+        const auto& font = fontManager.font(textureNameFont);
+        const auto textureNameSize = font.measure(cellTitle);
+
+        const auto textureNameX =
+          textureNameBounds.left()
+          + std::max((textureNameBounds.width - textureNameSize.x()) / 2.0f, 0.0f);
+
+        // y is relative to top, but OpenGL coords are relative to bottom, so invert
+        const auto renderOffset =
+          vm::vec2f{textureNameX, y + height - textureNameBounds.bottom()};
+
+        const auto cellTitleQuads = font.quads(cellTitle, false, renderOffset);
+
+        const auto textureNameVertices = TextVertex::toList(
+          cellTitleQuads.size() / 2,
+          kdl::skip_iterator{std::begin(cellTitleQuads), std::end(cellTitleQuads), 0, 2},
+          kdl::skip_iterator{std::begin(cellTitleQuads), std::end(cellTitleQuads), 1, 2},
           kdl::skip_iterator{std::begin(textColor), std::end(textColor), 0, 0});
-        auto& vertices = stringVertices[defaultFont];
-        vertices.insert(
-          std::end(vertices), std::begin(titleVertices), std::end(titleVertices));
-      }
 
-      for (const auto& row : group.rows())
-      {
-        if (row.intersectsY(y, height))
-        {
-          for (const auto& cell : row.cells())
-          {
-            const auto& cellTitle = cell.title();
-            const auto textureNameBounds = cell.titleBounds();
-            const auto textureNameFont = fontManager.selectFontSize(
-              defaultFont, cellTitle, textureNameBounds.width, 6);
-            const auto& font = fontManager.font(textureNameFont);
-            const auto textureNameSize = font.measure(cellTitle);
-
-            const auto textureNameX =
-              textureNameBounds.left()
-              + std::max((textureNameBounds.width - textureNameSize.x()) / 2.0f, 0.0f);
-
-            // y is relative to top, but OpenGL coords are relative to bottom, so invert
-            const auto renderOffset =
-              vm::vec2f{textureNameX, y + height - textureNameBounds.bottom()};
-
-            const auto cellTitleQuads = font.quads(cellTitle, false, renderOffset);
-
-            const auto textureNameVertices = TextVertex::toList(
-              cellTitleQuads.size() / 2,
-              kdl::skip_iterator{
-                std::begin(cellTitleQuads), std::end(cellTitleQuads), 0, 2},
-              kdl::skip_iterator{
-                std::begin(cellTitleQuads), std::end(cellTitleQuads), 1, 2},
-              kdl::skip_iterator{std::begin(textColor), std::end(textColor), 0, 0});
-
-            auto& allTextureNameVertices = stringVertices[textureNameFont];
-            allTextureNameVertices =
-              kdl::vec_concat(std::move(allTextureNameVertices), textureNameVertices);
-          }
-        }
+        auto& allTextureNameVertices = stringVertices[textureNameFont];
+        allTextureNameVertices =
+          kdl::vec_concat(std::move(allTextureNameVertices), textureNameVertices);
       }
     }
   }
@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ChangeJournal.h"
+
+#include "Macros.h"
+
+#include "kdl/reflection_impl.h"
+
+#include <cassert>
+#include <iterator>
+#include <ostream>
+
+namespace TrenchBroom::View
+{
+
+std::ostream& operator<<(std::ostream& str, const ChangeType type)
+{
+  switch (type)
+  {
+  case ChangeType::NodesWereAdded:
+    str << "NodesWereAdded";
+    break;
+  case ChangeType::NodesWereRemoved:
+    str << "NodesWereRemoved";
+    break;
+  case ChangeType::NodesDidChange:
+    str << "NodesDidChange";
+    break;
+  case ChangeType::SelectionDidChange:
+    str << "SelectionDidChange";
+    break;
+  case ChangeType::NodeVisibilityDidChange:
+    str << "NodeVisibilityDidChange";
+    break;
+  case ChangeType::DocumentWasReset:
+    str << "DocumentWasReset";
+    break;
+    switchDefault();
+  }
+  return str;
+}
+
+kdl_reflect_impl(ChangeJournalEntry);
+
+ChangeJournal::ChangeJournal(const std::size_t capacity)
+  : m_capacity{capacity}
+{
+  assert(m_capacity > 0);
+}
+
+std::uint64_t ChangeJournal::lastSequenceNumber() const
+{
+  return m_lastSequenceNumber;
+}
+
+void ChangeJournal::record(const ChangeType type, std::vector<Model::Node*> nodes)
+{
+  if (type == ChangeType::DocumentWasReset)
+  {
+    m_entries.clear();
+  }
+  else if (nodes.empty())
+  {
+    return;
+  }
+
+  if (m_entries.size() == m_capacity)
+  {
+    m_entries.pop_front();
+  }
+  m_entries.push_back(ChangeJournalEntry{++m_lastSequenceNumber, type, std::move(nodes)});
+}
+
+std::optional<std::vector<ChangeJournalEntry>> ChangeJournal::changesSince(
+  const std::uint64_t sequenceNumber) const
+{
+  if (sequenceNumber >= m_lastSequenceNumber)
+  {
+    return std::vector<ChangeJournalEntry>{};
+  }
+
+  if (m_entries.empty() || m_entries.front().sequenceNumber > sequenceNumber + 1)
+  {
+    return std::nullopt;
+  }
+
+  const auto first = std::next(
+    m_entries.begin(), long(sequenceNumber + 1 - m_entries.front().sequenceNumber));
+  return std::vector<ChangeJournalEntry>{first, m_entries.end()};
+}
+
+} // namespace TrenchBroom::View
@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "kdl/reflection_decl.h"
+
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+namespace TrenchBroom::Model
+{
+class Node;
+}
+
+namespace TrenchBroom::View
+{
+
+enum class ChangeType
+{
+  NodesWereAdded,
+  NodesWereRemoved,
+  NodesDidChange,
+  SelectionDidChange,
+  NodeVisibilityDidChange,
+  /**
+   * The document was cleared, loaded or newed. Consumers must rebuild their state from
+   * the world.
+   */
+  DocumentWasReset,
+};
+
+std::ostream& operator<<(std::ostream& str, ChangeType type);
+
+struct ChangeJournalEntry
+{
+  std::uint64_t sequenceNumber;
+  ChangeType type;
+
+  /**
+   * The affected nodes. Removed nodes may have been deleted by the time the entry is
+   * consumed, so they must only be used to look up state that consumers keep for them.
+   */
+  std::vector<Model::Node*> nodes;
+
+  kdl_reflect_decl(ChangeJournalEntry, sequenceNumber, type, nodes);
+};
+
+/**
+ * An ordered record of the changes made to a document. Each entry is assigned a sequence
+ * number, starting at 1, so that consumers such as caches and indices can remember the
+ * last sequence number they have seen and update incrementally by consuming only the
+ * changes since then.
+ *
+ * Only the most recent entries are kept. If a consumer falls behind further than that,
+ * it must rebuild its state from the world.
+ */
+class ChangeJournal
+{
+public:
+  static constexpr std::size_t DefaultCapacity = 4096;
+
+private:
+  std::size_t m_capacity;
+  std::deque<ChangeJournalEntry> m_entries;
+  std::uint64_t m_lastSequenceNumber = 0;
+
+public:
+  explicit ChangeJournal(std::size_t capacity = DefaultCapacity);
+
+  /**
+   * Returns the sequence number of the most recently recorded entry, or 0 if no entry
+   * was recorded yet.
+   */
+  std::uint64_t lastSequenceNumber() const;
+
+  /**
+   * Records a change of the given type to the given nodes. Changes to no nodes are not
+   * recorded, except for resets, which also discard all previous entries.
+   */
+  void record(ChangeType type, std::vector<Model::Node*> nodes);
+
+  /**
+   * Returns the entries recorded after the entry with the given sequence number, in the
+   * order in which they were recorded. Returns nullopt if some of these entries were
+   * already discarded, in which case the caller must rebuild its state from the world.
+   */
+  std::optional<std::vector<ChangeJournalEntry>> changesSince(
+    std::uint64_t sequenceNumber) const;
+};
+
+} // namespace TrenchBroom::View
@@ -22,11 +22,13 @@
 #include "Error.h"
 #include "FloatType.h"
 #include "Macros.h"
+#include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
 #include "Model/Hit.h"
 #include "Model/HitFilter.h"
+#include "Model/MapFormat.h"
 #include "Model/PickResult.h"
 #include "Model/Polyhedron.h"
 #include "Model/WorldNode.h"
@@ -41,8 +43,11 @@
 #include "kdl/map_utils.h"
 #include "kdl/memory_utils.h"
 #include "kdl/overload.h"
+#include "kdl/parallel.h"
+#include "kdl/result.h"
 #include "kdl/set_temp.h"
 #include "kdl/string_utils.h"
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/ray.h"
@@ -53,6 +58,9 @@
 #include <fmt/ostream.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <optional>
 
 namespace TrenchBroom::View
@@ -486,6 +494,73 @@ public:
 
 } // namespace
 
+namespace
+{
+
+void setFaceAttributes(
+  const std::vector<Model::BrushFace>& faces, Model::BrushFace& toSet)
+{
+  ensure(!faces.empty(), "no faces");
+
+  auto faceIt = std::begin(faces);
+  auto faceEnd = std::end(faces);
+  auto bestMatch = faceIt++;
+
+  while (faceIt != faceEnd)
+  {
+    const auto& face = *faceIt;
+
+    const auto bestDiff = bestMatch->boundary().normal - toSet.boundary().normal;
+    const auto curDiff = face.boundary().normal - toSet.boundary().normal;
+    if (vm::squared_length(curDiff) < vm::squared_length(bestDiff))
+    {
+      bestMatch = faceIt;
+    }
+
+    ++faceIt;
+  }
+
+  toSet.setAttributes(*bestMatch);
+}
+
+Result<Model::Brush> clipBrush(
+  Model::Brush brush,
+  const vm::vec3& p1,
+  const vm::vec3& p2,
+  const vm::vec3& p3,
+  const std::string& textureName,
+  const Model::MapFormat mapFormat,
+  const vm::bbox3& worldBounds)
+{
+  const auto attributes = Model::BrushFaceAttributes{textureName};
+  return Model::BrushFace::create(p1, p2, p3, attributes, mapFormat)
+    .and_then([&](Model::BrushFace&& clipFace) {
+      setFaceAttributes(brush.faces(), clipFace);
+      return brush.clip(worldBounds, std::move(clipFace));
+    })
+    .transform([&]() { return std::move(brush); });
+}
+
+struct ClippedBrush
+{
+  Result<Model::Brush> front;
+  Result<Model::Brush> back;
+};
+
+} // namespace
+
+/**
+ * A clip that is computed by the worker threads of the default thread pool. The clip is
+ * cancelled by setting the shared flag, which the workers check before clipping each
+ * brush.
+ */
+struct ClipTool::PendingClip
+{
+  std::vector<Model::Node*> parents;
+  std::shared_ptr<std::atomic<bool>> cancelled;
+  std::future<std::vector<ClippedBrush>> result;
+};
+
 ClipTool::ClipTool(std::weak_ptr<MapDocument> document)
   : Tool{false}
   , m_document{std::move(document)}
@@ -496,6 +571,7 @@ ClipTool::ClipTool(std::weak_ptr<MapDocument> document)
 
 ClipTool::~ClipTool()
 {
+  cancelPendingClip();
   kdl::map_clear_and_delete(m_frontBrushes);
   kdl::map_clear_and_delete(m_backBrushes);
 }
@@ -521,7 +597,11 @@ void ClipTool::toggleSide()
       m_clipSide = ClipSide::Front;
       break;
     }
-    update();
+
+    // the clipped brushes do not depend on the side to keep
+    clearRenderers();
+    updateRenderers();
+    refreshViews();
   }
 }
 
@@ -539,6 +619,12 @@ void ClipTool::render(
   Renderer::RenderBatch& renderBatch,
   const Model::PickResult& pickResult)
 {
+  if (m_pendingClip && !processPendingClip(false))
+  {
+    // keep rendering the previous result until the pending clip is done
+    refreshViews();
+  }
+
   renderBrushes(renderContext, renderBatch);
   renderStrategy(renderContext, renderBatch, pickResult);
 }
@@ -606,6 +692,8 @@ void ClipTool::performClip()
 {
   if (!m_dragging && canClip())
   {
+    processPendingClip(true);
+
     const auto ignoreNotifications = kdl::set_temp{m_ignoreNotifications};
 
     auto document = kdl::mem_lock(m_document);
@@ -787,11 +875,21 @@ void ClipTool::resetStrategy()
 
 void ClipTool::update()
 {
-  clearRenderers();
-  clearBrushes();
+  cancelPendingClip();
 
-  updateBrushes();
-  updateRenderers();
+  if (canClip())
+  {
+    // the renderers show the current brushes until the clip is done
+    startPendingClip();
+  }
+  else
+  {
+    clearRenderers();
+    clearBrushes();
+
+    updateBrushes();
+    updateRenderers();
+  }
 
   refreshViews();
 }
@@ -805,75 +903,111 @@ void ClipTool::clearBrushes()
 void ClipTool::updateBrushes()
 {
   auto document = kdl::mem_lock(m_document);
+  for (auto* brushNode : document->selectedNodes().brushes())
+  {
+    auto* parent = brushNode->parent();
+    m_frontBrushes[parent].push_back(new Model::BrushNode{brushNode->brush()});
+  }
+}
 
+void ClipTool::startPendingClip()
+{
+  auto document = kdl::mem_lock(m_document);
   const auto& brushNodes = document->selectedNodes().brushes();
-  const auto& worldBounds = document->worldBounds();
-
-  const auto clip =
-    [&](auto* node, const auto& p1, const auto& p2, const auto& p3, auto& brushMap) {
-      auto brush = node->brush();
-      Model::BrushFace::create(
-        p1,
-        p2,
-        p3,
-        Model::BrushFaceAttributes(document->currentTextureName()),
-        document->world()->mapFormat())
-        .and_then([&](Model::BrushFace&& clipFace) {
-          setFaceAttributes(brush.faces(), clipFace);
-          return brush.clip(worldBounds, std::move(clipFace));
-        })
-        .transform([&]() {
-          brushMap[node->parent()].push_back(new Model::BrushNode(std::move(brush)));
-        })
-        .transform_error(
-          [&](auto e) { document->error() << "Could not clip brush: " << e.msg; });
-    };
 
-  if (canClip())
-  {
-    const auto points = m_strategy->getPoints();
-    ensure(points.size() == 3, "invalid number of points");
+  const auto points = m_strategy->getPoints();
+  ensure(points.size() == 3, "invalid number of points");
+
+  auto pendingClip = std::make_unique<PendingClip>();
+  pendingClip->parents = kdl::vec_transform(
+    brushNodes, [](const auto* brushNode) { return brushNode->parent(); });
+  pendingClip->cancelled = std::make_shared<std::atomic<bool>>(false);
+
+  auto promise = std::make_shared<std::promise<std::vector<ClippedBrush>>>();
+  pendingClip->result = promise->get_future();
+
+  // the brushes are copied because the document may change while they are being clipped
+  auto brushes = kdl::vec_transform(
+    brushNodes, [](const auto* brushNode) { return brushNode->brush(); });
+
+  kdl::default_thread_pool().submit(
+    [brushes = std::move(brushes),
+     points,
+     textureName = document->currentTextureName(),
+     mapFormat = document->world()->mapFormat(),
+     worldBounds = document->worldBounds(),
+     cancelled = pendingClip->cancelled,
+     promise]() mutable {
+      promise->set_value(
+        kdl::vec_parallel_transform(std::move(brushes), [&](Model::Brush&& brush) {
+          if (*cancelled)
+          {
+            return ClippedBrush{Error{"Clip was cancelled"}, Error{"Clip was cancelled"}};
+          }
+
+          auto front = clipBrush(
+            brush, points[0], points[1], points[2], textureName, mapFormat, worldBounds);
+          auto back = clipBrush(
+            std::move(brush),
+            points[0],
+            points[2],
+            points[1],
+            textureName,
+            mapFormat,
+            worldBounds);
+          return ClippedBrush{std::move(front), std::move(back)};
+        }));
+    });
+
+  m_pendingClip = std::move(pendingClip);
+}
 
-    for (auto* brushNode : brushNodes)
-    {
-      clip(brushNode, points[0], points[1], points[2], m_frontBrushes);
-      clip(brushNode, points[0], points[2], points[1], m_backBrushes);
-    }
-  }
-  else
+void ClipTool::cancelPendingClip()
+{
+  if (m_pendingClip)
   {
-    for (auto* brushNode : brushNodes)
-    {
-      auto* parent = brushNode->parent();
-      m_frontBrushes[parent].push_back(new Model::BrushNode{brushNode->brush()});
-    }
+    *m_pendingClip->cancelled = true;
+    m_pendingClip.reset();
   }
 }
 
-void ClipTool::setFaceAttributes(
-  const std::vector<Model::BrushFace>& faces, Model::BrushFace& toSet) const
+bool ClipTool::processPendingClip(const bool wait)
 {
-  ensure(!faces.empty(), "no faces");
-
-  auto faceIt = std::begin(faces);
-  auto faceEnd = std::end(faces);
-  auto bestMatch = faceIt++;
+  using namespace std::chrono_literals;
 
-  while (faceIt != faceEnd)
+  if (
+    !m_pendingClip
+    || (!wait && m_pendingClip->result.wait_for(0s) != std::future_status::ready))
   {
-    const auto& face = *faceIt;
+    return false;
+  }
 
-    const auto bestDiff = bestMatch->boundary().normal - toSet.boundary().normal;
-    const auto curDiff = face.boundary().normal - toSet.boundary().normal;
-    if (vm::squared_length(curDiff) < vm::squared_length(bestDiff))
-    {
-      bestMatch = faceIt;
-    }
+  const auto pendingClip = std::move(m_pendingClip);
+  auto clippedBrushes = pendingClip->result.get();
 
-    ++faceIt;
+  clearRenderers();
+  clearBrushes();
+
+  auto document = kdl::mem_lock(m_document);
+  const auto addBrush =
+    [&](Model::Node* parent, Result<Model::Brush>&& brush, auto& brushMap) {
+      std::move(brush)
+        .transform([&](Model::Brush&& clippedBrush) {
+          brushMap[parent].push_back(new Model::BrushNode{std::move(clippedBrush)});
+        })
+        .transform_error(
+          [&](auto e) { document->error() << "Could not clip brush: " << e.msg; });
+    };
+
+  for (size_t i = 0; i < clippedBrushes.size(); ++i)
+  {
+    auto* parent = pendingClip->parents[i];
+    addBrush(parent, std::move(clippedBrushes[i].front), m_frontBrushes);
+    addBrush(parent, std::move(clippedBrushes[i].back), m_backBrushes);
   }
 
-  toSet.setAttributes(*bestMatch);
+  updateRenderers();
+  return true;
 }
 
 void ClipTool::clearRenderers()
@@ -957,6 +1091,7 @@ bool ClipTool::doDeactivate()
 {
   m_notifierConnection.disconnect();
 
+  cancelPendingClip();
   m_strategy.reset();
   clearRenderers();
   clearBrushes();
@@ -31,7 +31,6 @@
 
 namespace TrenchBroom::Model
 {
-class BrushFace;
 class BrushFaceHandle;
 class Node;
 class PickResult;
@@ -75,6 +74,9 @@ private:
   std::map<Model::Node*, std::vector<Model::Node*>> m_frontBrushes;
   std::map<Model::Node*, std::vector<Model::Node*>> m_backBrushes;
 
+  struct PendingClip;
+  std::unique_ptr<PendingClip> m_pendingClip;
+
   std::unique_ptr<Renderer::BrushRenderer> m_remainingBrushRenderer;
   std::unique_ptr<Renderer::BrushRenderer> m_clippedBrushRenderer;
 
@@ -149,8 +151,9 @@ private:
   void clearBrushes();
   void updateBrushes();
 
-  void setFaceAttributes(
-    const std::vector<Model::BrushFace>& faces, Model::BrushFace& toSet) const;
+  void startPendingClip();
+  void cancelPendingClip();
+  bool processPendingClip(bool wait);
 
   void clearRenderers();
   void updateRenderers();
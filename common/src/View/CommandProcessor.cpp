@@ -23,6 +23,8 @@
 
 #include "Exceptions.h"
 #include "Notifier.h"
+#include "Profiler.h"
+#include "StallDetector.h"
 #include "View/Command.h"
 #include "View/TransactionScope.h"
 #include "View/UndoableCommand.h"
@@ -157,12 +159,25 @@ private:
 
     return false;
   }
+
+  size_t doEstimateMemoryUsage() const override
+  {
+    auto result = UndoableCommand::doEstimateMemoryUsage();
+    for (const auto& command : m_commands)
+    {
+      result += command->updateMemoryUsage();
+    }
+    return result;
+  }
 };
 
 CommandProcessor::CommandProcessor(
   MapDocumentCommandFacade* document, const std::chrono::milliseconds collationInterval)
   : m_document{document}
   , m_collationInterval{collationInterval}
+  , m_memoryLimit{0u}
+  , m_undoMemoryUsage{0u}
+  , m_redoMemoryUsage{0u}
   , m_lastCommandTimestamp{std::chrono::time_point<std::chrono::system_clock>{}}
 {
 }
@@ -179,6 +194,25 @@ bool CommandProcessor::canRedo() const
   return m_transactionStack.empty() && !m_redoStack.empty();
 }
 
+size_t CommandProcessor::memoryUsage() const
+{
+  return m_undoMemoryUsage + m_redoMemoryUsage;
+}
+
+size_t CommandProcessor::memoryLimit() const
+{
+  return m_memoryLimit;
+}
+
+void CommandProcessor::setMemoryLimit(const size_t memoryLimit)
+{
+  m_memoryLimit = memoryLimit;
+  if (m_transactionStack.empty())
+  {
+    evictCommands();
+  }
+}
+
 const std::string& CommandProcessor::undoCommandName() const
 {
   if (!canUndo())
@@ -251,6 +285,8 @@ std::unique_ptr<CommandResult> CommandProcessor::execute(std::unique_ptr<Command
   {
     m_undoStack.clear();
     m_redoStack.clear();
+    m_undoMemoryUsage = 0u;
+    m_redoMemoryUsage = 0u;
   }
   return result;
 }
@@ -313,6 +349,8 @@ void CommandProcessor::clear()
 
   m_undoStack.clear();
   m_redoStack.clear();
+  m_undoMemoryUsage = 0u;
+  m_redoMemoryUsage = 0u;
   m_lastCommandTimestamp = std::chrono::time_point<std::chrono::system_clock>();
 }
 
@@ -325,13 +363,16 @@ CommandProcessor::SubmitAndStoreResult CommandProcessor::executeAndStoreCommand(
     return SubmitAndStoreResult(std::move(commandResult), false);
   }
 
-  const auto commandStored = storeCommand(std::move(command), collate);
   m_redoStack.clear();
+  m_redoMemoryUsage = 0u;
+  const auto commandStored = storeCommand(std::move(command), collate);
   return SubmitAndStoreResult(std::move(commandResult), commandStored);
 }
 
 std::unique_ptr<CommandResult> CommandProcessor::executeCommand(Command& command)
 {
+  const auto zone = ProfilerZone{"CommandProcessor::executeCommand"};
+  const auto stallScope = StallDetector::CommandScope{command.name()};
   notifyCommandIfNotType<TransactionCommand>(commandDoNotifier, command);
   auto result = command.performDo(m_document);
   if (result->success())
@@ -351,6 +392,8 @@ std::unique_ptr<CommandResult> CommandProcessor::executeCommand(Command& command
 
 std::unique_ptr<CommandResult> CommandProcessor::undoCommand(UndoableCommand& command)
 {
+  const auto zone = ProfilerZone{"CommandProcessor::undoCommand"};
+  const auto stallScope = StallDetector::CommandScope{"Undo " + command.name()};
   notifyCommandIfNotType<TransactionCommand>(commandUndoNotifier, command);
   auto result = command.performUndo(m_document);
   if (result->success())
@@ -445,11 +488,15 @@ bool CommandProcessor::pushToUndoStack(
     auto& lastCommand = m_undoStack.back();
     if (lastCommand->collateWith(*command))
     {
+      m_undoMemoryUsage -= lastCommand->memoryUsage();
+      m_undoMemoryUsage += lastCommand->updateMemoryUsage();
       return false;
     }
   }
 
+  m_undoMemoryUsage += command->updateMemoryUsage();
   m_undoStack.push_back(std::move(command));
+  evictCommands();
   return true;
 }
 
@@ -458,7 +505,32 @@ std::unique_ptr<UndoableCommand> CommandProcessor::popFromUndoStack()
   assert(m_transactionStack.empty());
   assert(!m_undoStack.empty());
 
-  return kdl::vec_pop_back(m_undoStack);
+  auto command = kdl::vec_pop_back(m_undoStack);
+  m_undoMemoryUsage -= command->memoryUsage();
+  return command;
+}
+
+void CommandProcessor::evictCommands()
+{
+  assert(m_transactionStack.empty());
+
+  if (m_memoryLimit == 0u || memoryUsage() <= m_memoryLimit)
+  {
+    return;
+  }
+
+  // always keep the most recent command so that it can be undone
+  auto count = size_t(0);
+  auto usage = memoryUsage();
+  while (count + 1u < m_undoStack.size() && usage > m_memoryLimit)
+  {
+    usage -= m_undoStack[count]->memoryUsage();
+    ++count;
+  }
+
+  m_undoMemoryUsage = usage - m_redoMemoryUsage;
+  m_undoStack.erase(
+    std::begin(m_undoStack), std::next(std::begin(m_undoStack), long(count)));
 }
 
 bool CommandProcessor::collatable(
@@ -471,6 +543,7 @@ bool CommandProcessor::collatable(
 void CommandProcessor::pushToRedoStack(std::unique_ptr<UndoableCommand> command)
 {
   assert(m_transactionStack.empty());
+  m_redoMemoryUsage += command->updateMemoryUsage();
   m_redoStack.push_back(std::move(command));
 }
 
@@ -479,7 +552,9 @@ std::unique_ptr<UndoableCommand> CommandProcessor::popFromRedoStack()
   assert(m_transactionStack.empty());
   assert(!m_redoStack.empty());
 
-  return kdl::vec_pop_back(m_redoStack);
+  auto command = kdl::vec_pop_back(m_redoStack);
+  m_redoMemoryUsage -= command->memoryUsage();
+  return command;
 }
 } // namespace View
 } // namespace TrenchBroom
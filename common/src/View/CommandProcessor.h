@@ -79,6 +79,22 @@ private:
    */
   std::vector<std::unique_ptr<UndoableCommand>> m_redoStack;
 
+  /**
+   * The maximum number of bytes that the undo and redo stacks may occupy, or 0 if there
+   * is no limit.
+   */
+  size_t m_memoryLimit;
+
+  /**
+   * The estimated number of bytes occupied by the commands on the undo stack.
+   */
+  size_t m_undoMemoryUsage;
+
+  /**
+   * The estimated number of bytes occupied by the commands on the redo stack.
+   */
+  size_t m_redoMemoryUsage;
+
   /**
    * The time stamp of when the last command was executed.
    */
@@ -156,6 +172,25 @@ public:
    */
   bool canRedo() const;
 
+  /**
+   * Returns the estimated number of bytes occupied by the commands on the undo and redo
+   * stacks.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the maximum number of bytes that the undo and redo stacks may occupy, or 0 if
+   * there is no limit.
+   */
+  size_t memoryLimit() const;
+
+  /**
+   * Sets the maximum number of bytes that the undo and redo stacks may occupy. If the
+   * limit is exceeded, the oldest commands are removed from the undo stack. A limit of 0
+   * means that the stacks are not limited.
+   */
+  void setMemoryLimit(size_t memoryLimit);
+
   /**
    * Returns the name of the command that will be undone when calling `undo`.
    *
@@ -374,6 +409,15 @@ private:
    */
   std::unique_ptr<UndoableCommand> popFromUndoStack();
 
+  /**
+   * Removes the oldest commands from the undo stack until the estimated memory usage of
+   * the undo and redo stacks no longer exceeds the memory limit. The most recently
+   * executed command is never removed.
+   *
+   * Precondition: no transaction is currently executing
+   */
+  void evictCommands();
+
   bool collatable(bool collate, std::chrono::system_clock::time_point timestamp) const;
 
   /**
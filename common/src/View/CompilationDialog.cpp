@@ -71,6 +71,7 @@ void CompilationDialog::createGui()
   auto* outputPanel = new TitledPanel{"Output"};
   m_output = new QTextEdit{};
   m_output->setReadOnly(true);
+  m_output->setUndoRedoEnabled(false);
   m_output->setFont(Fonts::fixedWidthFont());
 
   auto* outputLayout = new QVBoxLayout{};
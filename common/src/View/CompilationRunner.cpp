@@ -49,13 +49,78 @@
 
 namespace TrenchBroom::View
 {
+CompilationTaskOutput::CompilationTaskOutput(CompilationContext& context)
+  : m_context{context}
+{
+}
+
+void CompilationTaskOutput::setLabel(QString label)
+{
+  m_label = std::move(label);
+}
+
+void CompilationTaskOutput::flush()
+{
+  if (!m_pendingLine.isEmpty())
+  {
+    writePendingLine();
+  }
+}
+
+void CompilationTaskOutput::appendLabelled(const QString& string)
+{
+  for (const auto c : string)
+  {
+    if (c == '\n' && m_pendingCarriageReturn)
+    {
+      // CRLF
+      m_pendingCarriageReturn = false;
+      continue;
+    }
+
+    m_pendingCarriageReturn = c == '\r';
+    if (c == '\n' || c == '\r')
+    {
+      // A carriage return is treated like a line break because the line it would return
+      // to may have been written by another task in the meantime.
+      writePendingLine();
+    }
+    else
+    {
+      m_pendingLine.append(c);
+    }
+  }
+}
+
+void CompilationTaskOutput::writePendingLine()
+{
+  if (m_pendingLine.isEmpty())
+  {
+    m_context << "\n";
+  }
+  else
+  {
+    m_context << m_label + m_pendingLine + "\n";
+    m_pendingLine.clear();
+  }
+}
+
 CompilationTaskRunner::CompilationTaskRunner(CompilationContext& context)
   : m_context{context}
+  , m_output{context}
 {
+  // connected first so that the output is complete when other receivers are notified
+  connect(this, &CompilationTaskRunner::error, this, [&]() { m_output.flush(); });
+  connect(this, &CompilationTaskRunner::end, this, [&]() { m_output.flush(); });
 }
 
 CompilationTaskRunner::~CompilationTaskRunner() = default;
 
+void CompilationTaskRunner::setLabel(QString label)
+{
+  m_output.setLabel(std::move(label));
+}
+
 void CompilationTaskRunner::execute()
 {
   doExecute();
@@ -64,6 +129,7 @@ void CompilationTaskRunner::execute()
 void CompilationTaskRunner::terminate()
 {
   doTerminate();
+  m_output.flush();
 }
 
 std::string CompilationTaskRunner::interpolate(const std::string& spec)
@@ -74,8 +140,8 @@ std::string CompilationTaskRunner::interpolate(const std::string& spec)
   }
   catch (const Exception& e)
   {
-    m_context << "#### Could not interpolate expression '" << QString::fromStdString(spec)
-              << "': " << e.what() << "\n";
+    m_output << "#### Could not interpolate expression '" << QString::fromStdString(spec)
+             << "': " << e.what() << "\n";
     throw;
   }
 }
@@ -94,7 +160,7 @@ void CompilationExportMapTaskRunner::doExecute()
   emit start();
 
   const auto targetPath = std::filesystem::path{interpolate(m_task.targetSpec)};
-  m_context << "#### Exporting map file '" << IO::pathAsQString(targetPath) << "'\n";
+  m_output << "#### Exporting map file '" << IO::pathAsQString(targetPath) << "'\n";
 
   if (!m_context.test())
   {
@@ -106,8 +172,8 @@ void CompilationExportMapTaskRunner::doExecute()
       })
       .transform([&]() { emit end(); })
       .transform_error([&](auto e) {
-        m_context << "#### Could not export map file '" << IO::pathAsQString(targetPath)
-                  << "': " << QString::fromStdString(e.msg) << "\n";
+        m_output << "#### Could not export map file '" << IO::pathAsQString(targetPath)
+                 << "': " << QString::fromStdString(e.msg) << "\n";
         emit error();
       });
   }
@@ -145,9 +211,9 @@ void CompilationCopyFilesTaskRunner::doExecute()
       const auto pathStrsToCopy = kdl::vec_transform(
         pathsToCopy, [](const auto& path) { return "'" + path.string() + "'"; });
 
-      m_context << "#### Copying to '" << IO::pathAsQString(targetPath)
-                << "/': " << QString::fromStdString(kdl::str_join(pathStrsToCopy, ", "))
-                << "\n";
+      m_output << "#### Copying to '" << IO::pathAsQString(targetPath)
+               << "/': " << QString::fromStdString(kdl::str_join(pathStrsToCopy, ", "))
+               << "\n";
       if (!m_context.test())
       {
         return IO::Disk::createDirectory(targetPath).and_then([&](auto) {
@@ -161,9 +227,9 @@ void CompilationCopyFilesTaskRunner::doExecute()
     })
     .transform([&]() { emit end(); })
     .transform_error([&](auto e) {
-      m_context << "#### Could not copy '" << IO::pathAsQString(sourcePath) << "' to '"
-                << IO::pathAsQString(targetPath) << "': " << QString::fromStdString(e.msg)
-                << "\n";
+      m_output << "#### Could not copy '" << IO::pathAsQString(sourcePath) << "' to '"
+               << IO::pathAsQString(targetPath) << "': " << QString::fromStdString(e.msg)
+               << "\n";
       emit error();
     });
 }
@@ -186,17 +252,17 @@ void CompilationRenameFileTaskRunner::doExecute()
   const auto sourcePath = std::filesystem::path{interpolate(m_task.sourceSpec)};
   const auto targetPath = std::filesystem::path{interpolate(m_task.targetSpec)};
 
-  m_context << "#### Renaming '" << IO::pathAsQString(sourcePath) << "' to '"
-            << IO::pathAsQString(targetPath) << "'\n";
+  m_output << "#### Renaming '" << IO::pathAsQString(sourcePath) << "' to '"
+           << IO::pathAsQString(targetPath) << "'\n";
   if (!m_context.test())
   {
     IO::Disk::createDirectory(targetPath.parent_path())
       .and_then([&](auto) { return IO::Disk::moveFile(sourcePath, targetPath); })
       .transform([&]() { emit end(); })
       .transform_error([&](auto e) {
-        m_context << "#### Could not rename '" << IO::pathAsQString(sourcePath)
-                  << "' to '" << IO::pathAsQString(targetPath)
-                  << "': " << QString::fromStdString(e.msg) << "\n";
+        m_output << "#### Could not rename '" << IO::pathAsQString(sourcePath)
+                 << "' to '" << IO::pathAsQString(targetPath)
+                 << "': " << QString::fromStdString(e.msg) << "\n";
         emit error();
       });
   }
@@ -231,8 +297,8 @@ void CompilationDeleteFilesTaskRunner::doExecute()
     .transform([&](const auto& pathsToDelete) {
       const auto pathStrsToDelete = kdl::vec_transform(
         pathsToDelete, [](const auto& path) { return "'" + path.string() + "'"; });
-      m_context << "#### Deleting: "
-                << QString::fromStdString(kdl::str_join(pathStrsToDelete, ", ")) << "\n";
+      m_output << "#### Deleting: "
+               << QString::fromStdString(kdl::str_join(pathStrsToDelete, ", ")) << "\n";
 
       if (!m_context.test())
       {
@@ -242,8 +308,8 @@ void CompilationDeleteFilesTaskRunner::doExecute()
     })
     .transform([&](auto) { emit end(); })
     .transform_error([&](auto e) {
-      m_context << "#### Could not delete '" << IO::pathAsQString(targetPath)
-                << "': " << QString::fromStdString(e.msg) << "\n";
+      m_output << "#### Could not delete '" << IO::pathAsQString(targetPath)
+               << "': " << QString::fromStdString(e.msg) << "\n";
       emit error();
     });
 }
@@ -279,7 +345,7 @@ void CompilationRunToolTaskRunner::doTerminate()
       this,
       &CompilationRunToolTaskRunner::processFinished);
     m_process->kill();
-    m_context << "\n\n#### Terminated\n";
+    m_output << "\n\n#### Terminated\n";
   }
 }
 
@@ -293,7 +359,7 @@ void CompilationRunToolTaskRunner::startProcess()
     const auto workDir = m_context.variableValue(CompilationVariableNames::WORK_DIR_PATH);
     const auto cmd = this->cmd();
 
-    m_context << "#### Executing '" << QString::fromStdString(cmd) << "'\n";
+    m_output << "#### Executing '" << QString::fromStdString(cmd) << "'\n";
 
     if (!m_context.test())
     {
@@ -359,9 +425,9 @@ std::string CompilationRunToolTaskRunner::cmd()
 void CompilationRunToolTaskRunner::processErrorOccurred(
   const QProcess::ProcessError processError)
 {
-  m_context << "#### Error '"
-            << QMetaEnum::fromType<QProcess::ProcessError>().valueToKey(processError)
-            << "' occurred when communicating with process\n\n";
+  m_output << "#### Error '"
+           << QMetaEnum::fromType<QProcess::ProcessError>().valueToKey(processError)
+           << "' occurred when communicating with process\n\n";
   emit error();
 }
 
@@ -371,7 +437,7 @@ void CompilationRunToolTaskRunner::processFinished(
   switch (exitStatus)
   {
   case QProcess::NormalExit:
-    m_context << "#### Finished with exit code " << exitCode << "\n\n";
+    m_output << "#### Finished with exit code " << exitCode << "\n\n";
     if (exitCode == 0 || !m_task.treatNonZeroResultCodeAsError)
     {
       emit end();
@@ -382,7 +448,7 @@ void CompilationRunToolTaskRunner::processFinished(
     }
     break;
   case QProcess::CrashExit:
-    m_context << "#### Crashed with exit code " << exitCode << "\n\n";
+    m_output << "#### Crashed with exit code " << exitCode << "\n\n";
     emit error();
     break;
   }
@@ -393,7 +459,7 @@ void CompilationRunToolTaskRunner::processReadyReadStandardError()
   if (m_process != nullptr)
   {
     const QByteArray bytes = m_process->readAllStandardError();
-    m_context << QString::fromLocal8Bit(bytes);
+    m_output << QString::fromLocal8Bit(bytes);
   }
 }
 
@@ -402,7 +468,7 @@ void CompilationRunToolTaskRunner::processReadyReadStandardOutput()
   if (m_process != nullptr)
   {
     const QByteArray bytes = m_process->readAllStandardOutput();
-    m_context << QString::fromLocal8Bit(bytes);
+    m_output << QString::fromLocal8Bit(bytes);
   }
 }
 
@@ -410,58 +476,81 @@ CompilationRunner::CompilationRunner(
   CompilationContext context, const Model::CompilationProfile& profile, QObject* parent)
   : QObject{parent}
   , m_context{std::move(context)}
-  , m_taskRunners{createTaskRunners(m_context, profile)}
-  , m_currentTask{std::end(m_taskRunners)}
+  , m_taskRunnerGroups{createTaskRunnerGroups(m_context, profile)}
+  , m_currentGroup{std::end(m_taskRunnerGroups)}
 {
 }
 
 CompilationRunner::~CompilationRunner() = default;
 
-CompilationRunner::TaskRunnerList CompilationRunner::createTaskRunners(
+CompilationRunner::TaskRunnerGroupList CompilationRunner::createTaskRunnerGroups(
   CompilationContext& context, const Model::CompilationProfile& profile)
 {
-  auto result = TaskRunnerList{};
-  for (const auto& task : profile.tasks)
+  auto result = TaskRunnerGroupList{};
+  for (size_t i = 0; i < profile.tasks.size(); ++i)
   {
+    const auto& task = profile.tasks[i];
+    auto taskRunner = std::unique_ptr<CompilationTaskRunner>{};
     std::visit(
       kdl::overload(
         [&](const Model::CompilationExportMap& exportMap) {
           if (exportMap.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationExportMapTaskRunner>(context, exportMap));
+            taskRunner =
+              std::make_unique<CompilationExportMapTaskRunner>(context, exportMap);
           }
         },
         [&](const Model::CompilationCopyFiles& copyFiles) {
           if (copyFiles.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationCopyFilesTaskRunner>(context, copyFiles));
+            taskRunner =
+              std::make_unique<CompilationCopyFilesTaskRunner>(context, copyFiles);
           }
         },
         [&](const Model::CompilationRenameFile& renameFile) {
           if (renameFile.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationRenameFileTaskRunner>(context, renameFile));
+            taskRunner =
+              std::make_unique<CompilationRenameFileTaskRunner>(context, renameFile);
           }
         },
         [&](const Model::CompilationDeleteFiles& deleteFiles) {
           if (deleteFiles.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationDeleteFilesTaskRunner>(context, deleteFiles));
+            taskRunner =
+              std::make_unique<CompilationDeleteFilesTaskRunner>(context, deleteFiles);
           }
         },
         [&](const Model::CompilationRunTool& runTool) {
           if (runTool.enabled)
           {
-            result.push_back(
-              std::make_unique<CompilationRunToolTaskRunner>(context, runTool));
+            taskRunner = std::make_unique<CompilationRunToolTaskRunner>(context, runTool);
           }
         }),
       task);
+
+    if (taskRunner)
+    {
+      taskRunner->setLabel(QString{"[%1] "}.arg(i + 1));
+      const auto concurrent =
+        std::visit([](const auto& t) { return t.concurrent; }, task);
+      if (!concurrent || result.empty())
+      {
+        result.emplace_back();
+      }
+      result.back().push_back(std::move(taskRunner));
+    }
+  }
+
+  // the output of tasks which do not run concurrently with others is not labelled
+  for (auto& group : result)
+  {
+    if (group.size() == 1)
+    {
+      group.front()->setLabel(QString{});
+    }
   }
+
   return result;
 }
 
@@ -469,12 +558,11 @@ void CompilationRunner::execute()
 {
   assert(!running());
 
-  m_currentTask = std::begin(m_taskRunners);
-  if (m_currentTask == std::end(m_taskRunners))
+  m_currentGroup = std::begin(m_taskRunnerGroups);
+  if (m_currentGroup == std::end(m_taskRunnerGroups))
   {
     return;
   }
-  bindEvents(*m_currentTask->get());
 
   emit compilationStarted();
 
@@ -488,28 +576,64 @@ void CompilationRunner::execute()
   {
     m_context << "#### Using working directory '" << workDir << "'\n";
   }
-  m_currentTask->get()->execute();
+  executeCurrentGroup();
 }
 
 void CompilationRunner::terminate()
 {
   assert(running());
-  unbindEvents(*m_currentTask->get());
-  m_currentTask->get()->terminate();
-  m_currentTask = std::end(m_taskRunners);
+  terminateRunningTasks();
+  m_currentGroup = std::end(m_taskRunnerGroups);
 
   emit compilationEnded();
 }
 
 bool CompilationRunner::running() const
 {
-  return m_currentTask != std::end(m_taskRunners);
+  return m_currentGroup != std::end(m_taskRunnerGroups);
 }
 
-void CompilationRunner::bindEvents(CompilationTaskRunner& runner) const
+void CompilationRunner::executeCurrentGroup()
 {
-  connect(&runner, &CompilationTaskRunner::error, this, &CompilationRunner::taskError);
-  connect(&runner, &CompilationTaskRunner::end, this, &CompilationRunner::taskEnd);
+  const auto currentGroup = m_currentGroup;
+  m_runningTasks = kdl::vec_transform(
+    *currentGroup, [](const auto& taskRunner) { return taskRunner.get(); });
+
+  for (auto* taskRunner : m_runningTasks)
+  {
+    bindEvents(*taskRunner);
+  }
+
+  for (auto& taskRunner : *currentGroup)
+  {
+    // tasks may end or fail while they are being executed, which either ends the
+    // compilation or, if this was the last task of the group, starts the next group
+    if (m_currentGroup != currentGroup)
+    {
+      break;
+    }
+    taskRunner->execute();
+  }
+}
+
+void CompilationRunner::terminateRunningTasks()
+{
+  for (auto* taskRunner : m_runningTasks)
+  {
+    unbindEvents(*taskRunner);
+    taskRunner->terminate();
+  }
+  m_runningTasks.clear();
+}
+
+void CompilationRunner::bindEvents(CompilationTaskRunner& runner)
+{
+  connect(&runner, &CompilationTaskRunner::error, this, [this, runner = &runner]() {
+    taskError(*runner);
+  });
+  connect(&runner, &CompilationTaskRunner::end, this, [this, runner = &runner]() {
+    taskEnd(*runner);
+  });
 }
 
 void CompilationRunner::unbindEvents(CompilationTaskRunner& runner) const
@@ -517,30 +641,37 @@ void CompilationRunner::unbindEvents(CompilationTaskRunner& runner) const
   runner.disconnect(this);
 }
 
-void CompilationRunner::taskError()
+void CompilationRunner::taskError(CompilationTaskRunner& runner)
 {
   if (running())
   {
-    unbindEvents(*m_currentTask->get());
-    m_currentTask = std::end(m_taskRunners);
+    unbindEvents(runner);
+    m_runningTasks = kdl::vec_erase(std::move(m_runningTasks), &runner);
+
+    // stop the tasks which are still running concurrently
+    terminateRunningTasks();
+    m_currentGroup = std::end(m_taskRunnerGroups);
     emit compilationEnded();
   }
 }
 
-void CompilationRunner::taskEnd()
+void CompilationRunner::taskEnd(CompilationTaskRunner& runner)
 {
   if (running())
   {
-    unbindEvents(*m_currentTask->get());
-    ++m_currentTask;
-    if (m_currentTask != std::end(m_taskRunners))
-    {
-      bindEvents(*m_currentTask->get());
-      m_currentTask->get()->execute();
-    }
-    else
+    unbindEvents(runner);
+    m_runningTasks = kdl::vec_erase(std::move(m_runningTasks), &runner);
+    if (m_runningTasks.empty())
     {
-      emit compilationEnded();
+      ++m_currentGroup;
+      if (m_currentGroup != std::end(m_taskRunnerGroups))
+      {
+        executeCurrentGroup();
+      }
+      else
+      {
+        emit compilationEnded();
+      }
     }
   }
 }
@@ -21,6 +21,8 @@
 
 #include <QObject>
 #include <QProcess> // for QProcess::ProcessError
+#include <QString>
+#include <QTextStream>
 
 #include "Macros.h"
 #include "Model/CompilationTask.h"
@@ -39,11 +41,58 @@ namespace TrenchBroom::View
 {
 class CompilationContext;
 
+/**
+ * Writes the output of a task to the compilation context.
+ *
+ * If a label is set, the output is written line by line and every line is prefixed with
+ * the label, so that the output of tasks which run concurrently can be told apart.
+ */
+class CompilationTaskOutput
+{
+private:
+  CompilationContext& m_context;
+  QString m_label;
+  QString m_pendingLine;
+  bool m_pendingCarriageReturn{false};
+
+public:
+  explicit CompilationTaskOutput(CompilationContext& context);
+
+  void setLabel(QString label);
+
+  /**
+   * Writes any incomplete line that is still pending.
+   */
+  void flush();
+
+  template <typename T>
+  CompilationTaskOutput& operator<<(const T& t)
+  {
+    if (m_label.isEmpty())
+    {
+      m_context << t;
+    }
+    else
+    {
+      QString string;
+      QTextStream stream(&string);
+      stream << t;
+      appendLabelled(string);
+    }
+    return *this;
+  }
+
+private:
+  void appendLabelled(const QString& string);
+  void writePendingLine();
+};
+
 class CompilationTaskRunner : public QObject
 {
   Q_OBJECT
 protected:
   CompilationContext& m_context;
+  CompilationTaskOutput m_output;
 
 protected:
   explicit CompilationTaskRunner(CompilationContext& context);
@@ -51,6 +100,8 @@ protected:
 public:
   ~CompilationTaskRunner() override;
 
+  void setLabel(QString label);
+
   void execute();
   void terminate();
 signals:
@@ -174,10 +225,12 @@ class CompilationRunner : public QObject
   Q_OBJECT
 private:
   using TaskRunnerList = std::vector<std::unique_ptr<CompilationTaskRunner>>;
+  using TaskRunnerGroupList = std::vector<TaskRunnerList>;
 
   CompilationContext m_context;
-  TaskRunnerList m_taskRunners;
-  TaskRunnerList::iterator m_currentTask;
+  TaskRunnerGroupList m_taskRunnerGroups;
+  TaskRunnerGroupList::iterator m_currentGroup;
+  std::vector<CompilationTaskRunner*> m_runningTasks;
 
 public:
   CompilationRunner(
@@ -187,7 +240,12 @@ public:
   ~CompilationRunner() override;
 
 private:
-  static TaskRunnerList createTaskRunners(
+  /**
+   * Creates the runners for the enabled tasks of the given profile. Tasks which run
+   * concurrently are put into the same group, and the groups are executed one after
+   * another.
+   */
+  static TaskRunnerGroupList createTaskRunnerGroups(
     CompilationContext& context, const Model::CompilationProfile& profile);
 
 public:
@@ -196,11 +254,14 @@ public:
   bool running() const;
 
 private:
-  void bindEvents(CompilationTaskRunner& runner) const;
+  void executeCurrentGroup();
+  void terminateRunningTasks();
+
+  void bindEvents(CompilationTaskRunner& runner);
   void unbindEvents(CompilationTaskRunner& runner) const;
-private slots:
-  void taskError();
-  void taskEnd();
+
+  void taskError(CompilationTaskRunner& runner);
+  void taskEnd(CompilationTaskRunner& runner);
 signals:
   void compilationStarted();
   void compilationEnded();
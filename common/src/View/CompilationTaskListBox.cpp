@@ -76,6 +76,12 @@ CompilationTaskEditorBase::CompilationTaskEditorBase(
   m_enabledCheckbox->setToolTip(
     tr("Whether to include this task when running the compile profile"));
 
+  // subclasses add this to their layouts
+  m_concurrentCheckbox = new QCheckBox{tr("Run concurrently with previous task")};
+  m_concurrentCheckbox->setToolTip(
+    tr("Start this task together with the previous task instead of waiting for it to "
+       "finish"));
+
   m_taskLayout = new QHBoxLayout{};
   m_taskLayout->setContentsMargins(0, 0, 0, 0);
   m_taskLayout->addSpacing(LayoutConstants::NarrowHMargin);
@@ -87,6 +93,9 @@ CompilationTaskEditorBase::CompilationTaskEditorBase(
   connect(m_enabledCheckbox, &QCheckBox::clicked, this, [&](const bool checked) {
     std::visit([&](auto& t) { t.enabled = checked; }, m_task);
   });
+  connect(m_concurrentCheckbox, &QCheckBox::clicked, this, [&](const bool checked) {
+    std::visit([&](auto& t) { t.concurrent = checked; }, m_task);
+  });
 }
 
 void CompilationTaskEditorBase::setupCompleter(MultiCompletionLineEdit* lineEdit)
@@ -107,7 +116,12 @@ void CompilationTaskEditorBase::addMainLayout(QLayout* layout)
 
 void CompilationTaskEditorBase::updateItem()
 {
-  std::visit([&](const auto& t) { m_enabledCheckbox->setChecked(t.enabled); }, m_task);
+  std::visit(
+    [&](const auto& t) {
+      m_enabledCheckbox->setChecked(t.enabled);
+      m_concurrentCheckbox->setChecked(t.concurrent);
+    },
+    m_task);
 }
 
 void CompilationTaskEditorBase::updateCompleter(QCompleter* completer)
@@ -154,6 +168,7 @@ CompilationExportMapTaskEditor::CompilationExportMapTaskEditor(
 Variables are allowed.)");
   setupCompleter(m_targetEditor);
   formLayout->addRow("File Path", m_targetEditor);
+  formLayout->addRow("", m_concurrentCheckbox);
 
   connect(
     m_targetEditor,
@@ -222,6 +237,7 @@ Existing files are overwritten without prompt.
 Variables are allowed.)");
   setupCompleter(m_targetEditor);
   formLayout->addRow("Target Directory Path", m_targetEditor);
+  formLayout->addRow("", m_concurrentCheckbox);
 
   connect(
     m_sourceEditor,
@@ -307,6 +323,7 @@ Existing files are overwritten without prompt.
 Variables are allowed.)");
   setupCompleter(m_targetEditor);
   formLayout->addRow("Target File Path", m_targetEditor);
+  formLayout->addRow("", m_concurrentCheckbox);
 
   connect(
     m_sourceEditor,
@@ -381,6 +398,7 @@ Use wildcards (*,?) in the filename to specify more than one file.
 Variables are allowed.)");
   setupCompleter(m_targetEditor);
   formLayout->addRow("File Path", m_targetEditor);
+  formLayout->addRow("", m_concurrentCheckbox);
 
   connect(
     m_targetEditor,
@@ -466,6 +484,7 @@ Variables are allowed.)");
   m_treatNonZeroResultCodeAsError->setToolTip(
     tr("Stop compilation if the tool returns a nonzero error code"));
   formLayout->addRow("", m_treatNonZeroResultCodeAsError);
+  formLayout->addRow("", m_concurrentCheckbox);
 
   connect(
     m_toolEditor,
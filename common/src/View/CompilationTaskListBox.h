@@ -52,6 +52,7 @@ protected:
   Model::CompilationProfile& m_profile;
   Model::CompilationTask& m_task;
   QCheckBox* m_enabledCheckbox = nullptr;
+  QCheckBox* m_concurrentCheckbox = nullptr;
   QHBoxLayout* m_taskLayout = nullptr;
 
   std::vector<QCompleter*> m_completers;
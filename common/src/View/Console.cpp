@@ -22,11 +22,13 @@
 #include <QDebug>
 #include <QScrollBar>
 #include <QTextEdit>
+#include <QTimer>
 #include <QVBoxLayout>
 
 #include "FileLogger.h"
 #include "View/ViewConstants.h"
 
+#include <algorithm>
 #include <string>
 
 namespace TrenchBroom
@@ -40,6 +42,10 @@ Console::Console(QWidget* parent)
   m_textView->setReadOnly(true);
   m_textView->setWordWrapMode(QTextOption::NoWrap);
 
+  m_updateTimer = new QTimer{this};
+  m_updateTimer->setSingleShot(true);
+  connect(m_updateTimer, &QTimer::timeout, this, [&]() { showPendingMessages(); });
+
   QVBoxLayout* sizer = new QVBoxLayout();
   sizer->setContentsMargins(0, 0, 0, 0);
   sizer->addWidget(m_textView);
@@ -55,10 +61,60 @@ void Console::doLog(const LogLevel level, const QString& message)
 {
   if (!message.isEmpty())
   {
-    logToDebugOut(level, message);
-    logToConsole(level, message);
     FileLogger::instance().log(level, message);
+
+    if (const auto it = m_pendingMessageIndices.find(message);
+        it != m_pendingMessageIndices.end())
+    {
+      auto& pendingMessage = m_pendingMessages[*it];
+      pendingMessage.level = std::max(pendingMessage.level, level);
+      ++pendingMessage.count;
+    }
+    else if (m_pendingMessages.size() < MaxMessagesPerUpdate)
+    {
+      m_pendingMessageIndices.insert(message, m_pendingMessages.size());
+      m_pendingMessages.push_back(PendingMessage{level, message, 1});
+    }
+    else
+    {
+      ++m_omittedMessageCount;
+    }
+
+    if (!m_updateTimer->isActive())
+    {
+      m_updateTimer->start(0);
+    }
+  }
+}
+
+void Console::showPendingMessages()
+{
+  QTextCursor cursor(m_textView->document());
+  cursor.movePosition(QTextCursor::MoveOperation::End);
+  cursor.beginEditBlock();
+
+  for (const auto& [level, message, count] : m_pendingMessages)
+  {
+    const auto text =
+      count > 1 ? tr("%1 (repeated %2 times)").arg(message).arg(count) : message;
+    logToDebugOut(level, text);
+    logToConsole(cursor, level, text);
   }
+
+  if (m_omittedMessageCount > 0)
+  {
+    const auto text =
+      tr("%1 more messages were omitted, see the log file").arg(m_omittedMessageCount);
+    logToDebugOut(LogLevel::Warn, text);
+    logToConsole(cursor, LogLevel::Warn, text);
+  }
+
+  cursor.endEditBlock();
+  m_textView->moveCursor(QTextCursor::MoveOperation::End);
+
+  m_pendingMessages.clear();
+  m_pendingMessageIndices.clear();
+  m_omittedMessageCount = 0;
 }
 
 void Console::logToDebugOut(const LogLevel /* level */, const QString& message)
@@ -66,7 +122,8 @@ void Console::logToDebugOut(const LogLevel /* level */, const QString& message)
   qDebug("%s", message.toStdString().c_str());
 }
 
-void Console::logToConsole(const LogLevel level, const QString& message)
+void Console::logToConsole(
+  QTextCursor& cursor, const LogLevel level, const QString& message)
 {
   // NOTE: QPalette::Text is the correct color role for contrast against QPalette::Base
   // which is the background of text entry widgets
@@ -89,12 +146,8 @@ void Console::logToConsole(const LogLevel level, const QString& message)
   }
   format.setFont(Fonts::fixedWidthFont());
 
-  QTextCursor cursor(m_textView->document());
-  cursor.movePosition(QTextCursor::MoveOperation::End);
   cursor.insertText(message, format);
   cursor.insertText("\n");
-
-  m_textView->moveCursor(QTextCursor::MoveOperation::End);
 }
 } // namespace View
 } // namespace TrenchBroom
@@ -19,23 +19,49 @@
 
 #pragma once
 
+#include <QHash>
+#include <QString>
+
 #include "Logger.h"
 #include "View/TabBook.h"
 
 #include <string>
+#include <vector>
 
+class QTextCursor;
 class QTextEdit;
-class QString;
+class QTimer;
 class QWidget;
 
 namespace TrenchBroom
 {
 namespace View
 {
+/**
+ * Shows the log messages and forwards them to the log file.
+ *
+ * The messages are shown in bulk when control returns to the event loop. Identical
+ * messages that are logged in between are shown once with a repeat count, and at most
+ * MaxMessagesPerUpdate messages are shown at a time. The log file receives every message.
+ */
 class Console : public TabBookPage, public Logger
 {
 private:
+  static constexpr size_t MaxMessagesPerUpdate = 1000;
+
+  struct PendingMessage
+  {
+    LogLevel level;
+    QString message;
+    size_t count;
+  };
+
   QTextEdit* m_textView;
+  QTimer* m_updateTimer;
+  std::vector<PendingMessage> m_pendingMessages;
+  // the index of each pending message in m_pendingMessages
+  QHash<QString, size_t> m_pendingMessageIndices;
+  size_t m_omittedMessageCount{0};
 
 public:
   explicit Console(QWidget* parent = nullptr);
@@ -43,8 +69,9 @@ public:
 private:
   void doLog(LogLevel level, const std::string& message) override;
   void doLog(LogLevel level, const QString& message) override;
+  void showPendingMessages();
   void logToDebugOut(LogLevel level, const QString& message);
-  void logToConsole(LogLevel level, const QString& message);
+  void logToConsole(QTextCursor& cursor, LogLevel level, const QString& message);
 };
 } // namespace View
 } // namespace TrenchBroom
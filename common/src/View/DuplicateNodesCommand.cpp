@@ -20,6 +20,7 @@
 #include "DuplicateNodesCommand.h"
 
 #include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
 #include "Model/Node.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -123,6 +124,20 @@ std::unique_ptr<CommandResult> DuplicateNodesCommand::doPerformUndo(
  *
  * Applies when duplicating a brush inside a brush entity.
  */
+size_t DuplicateNodesCommand::doEstimateMemoryUsage() const
+{
+  auto result = UndoableCommand::doEstimateMemoryUsage();
+  if (state() == CommandState::Default)
+  {
+    // this command owns the added nodes
+    for (const auto& [parent, children] : m_addedNodes)
+    {
+      result += Model::estimateMemoryUsage(children);
+    }
+  }
+  return result;
+}
+
 bool DuplicateNodesCommand::shouldCloneParentWhenCloningNode(
   const Model::Node* node) const
 {
@@ -57,6 +57,8 @@ private:
   std::unique_ptr<CommandResult> doPerformUndo(
     MapDocumentCommandFacade* document) override;
 
+  size_t doEstimateMemoryUsage() const override;
+
   bool shouldCloneParentWhenCloningNode(const Model::Node* node) const;
 
   deleteCopyAndMove(DuplicateNodesCommand);
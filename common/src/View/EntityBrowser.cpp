@@ -73,6 +73,14 @@ void EntityBrowser::reload()
   }
 }
 
+void EntityBrowser::invalidatePreviews()
+{
+  if (m_view != nullptr)
+  {
+    m_view->invalidatePreviews();
+  }
+}
+
 void EntityBrowser::createGui(GLContextManager& contextManager)
 {
   m_scrollBar = new QScrollBar(Qt::Vertical);
@@ -160,8 +168,10 @@ void EntityBrowser::connectObservers()
     document->modsDidChangeNotifier.connect(this, &EntityBrowser::modsDidChange);
   m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(
     this, &EntityBrowser::entityDefinitionsDidChange);
-  m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &EntityBrowser::nodesDidChange);
+  m_notifierConnection += document->entityModelsWereLoadedNotifier.connect(
+    this, &EntityBrowser::entityModelsWereLoaded);
+  m_notifierConnection += document->batchedNodesDidChangeNotifier.connect(
+    this, &EntityBrowser::nodesDidChange);
 
   PreferenceManager& prefs = PreferenceManager::instance();
   m_notifierConnection +=
@@ -170,16 +180,19 @@ void EntityBrowser::connectObservers()
 
 void EntityBrowser::documentWasNewed(MapDocument*)
 {
+  invalidatePreviews();
   reload();
 }
 
 void EntityBrowser::documentWasLoaded(MapDocument*)
 {
+  invalidatePreviews();
   reload();
 }
 
 void EntityBrowser::modsDidChange()
 {
+  invalidatePreviews();
   reload();
 }
 
@@ -191,6 +204,13 @@ void EntityBrowser::nodesDidChange(const std::vector<Model::Node*>&)
 
 void EntityBrowser::entityDefinitionsDidChange()
 {
+  invalidatePreviews();
+  reload();
+}
+
+void EntityBrowser::entityModelsWereLoaded()
+{
+  invalidatePreviews();
   reload();
 }
 
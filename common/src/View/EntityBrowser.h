@@ -68,6 +68,7 @@ public:
   void reload();
 
 private:
+  void invalidatePreviews();
   void createGui(GLContextManager& contextManager);
 
   void connectObservers();
@@ -78,6 +79,7 @@ private:
   void modsDidChange();
   void nodesDidChange(const std::vector<Model::Node*>& nodes);
   void entityDefinitionsDidChange();
+  void entityModelsWereLoaded();
   void preferenceDidChange(const std::filesystem::path& path);
 };
 } // namespace View
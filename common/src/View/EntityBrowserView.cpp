@@ -46,8 +46,6 @@
 
 #include "kdl/overload.h"
 #include "kdl/skip_iterator.h"
-#include "kdl/string_compare.h"
-#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/forward.h"
@@ -56,6 +54,7 @@
 #include "vm/quat.h"
 #include "vm/vec.h"
 
+#include <cmath>
 #include <map>
 #include <string>
 #include <vector>
@@ -131,6 +130,12 @@ void EntityBrowserView::setFilterText(const std::string& filterText)
   }
 }
 
+void EntityBrowserView::invalidatePreviews()
+{
+  m_previews.clear();
+  m_previewAtlas.clear();
+}
+
 void EntityBrowserView::doInitLayout(Layout& layout)
 {
   layout.setOuterMargin(5.0f);
@@ -149,6 +154,7 @@ void EntityBrowserView::doReloadLayout(Layout& layout)
   assert(fontSize > 0);
 
   const auto font = Renderer::FontDescriptor{fontPath, static_cast<size_t>(fontSize)};
+  const auto matchingDefinitions = findMatchingDefinitions();
 
   if (m_group)
   {
@@ -162,7 +168,7 @@ void EntityBrowserView::doReloadLayout(Layout& layout)
         const auto displayName = group.displayName();
         layout.addGroup(displayName, static_cast<float>(fontSize) + 2.0f);
 
-        addEntitiesToLayout(layout, definitions, font);
+        addEntitiesToLayout(layout, definitions, matchingDefinitions, font);
       }
     }
   }
@@ -170,7 +176,7 @@ void EntityBrowserView::doReloadLayout(Layout& layout)
   {
     const auto& definitions = m_entityDefinitionManager.definitions(
       Assets::EntityDefinitionType::PointEntity, m_sortOrder);
-    addEntitiesToLayout(layout, definitions, font);
+    addEntitiesToLayout(layout, definitions, matchingDefinitions, font);
   }
 }
 
@@ -186,39 +192,41 @@ QString EntityBrowserView::dndData(const Cell& cell)
   return prefix + name;
 }
 
+std::optional<EntityBrowserView::DefinitionSet> EntityBrowserView::
+  findMatchingDefinitions() const
+{
+  if (m_filterText.empty())
+  {
+    return std::nullopt;
+  }
+
+  const auto definitions = m_entityDefinitionManager.findDefinitions(m_filterText);
+  return DefinitionSet{definitions.begin(), definitions.end()};
+}
+
 void EntityBrowserView::addEntitiesToLayout(
   Layout& layout,
   const std::vector<Assets::EntityDefinition*>& definitions,
+  const std::optional<DefinitionSet>& matchingDefinitions,
   const Renderer::FontDescriptor& font)
 {
   for (const auto* definition : definitions)
   {
-    const auto* pointEntityDefinition =
-      static_cast<const Assets::PointEntityDefinition*>(definition);
-    addEntityToLayout(layout, pointEntityDefinition, font);
+    if (!matchingDefinitions || matchingDefinitions->count(definition) > 0)
+    {
+      const auto* pointEntityDefinition =
+        static_cast<const Assets::PointEntityDefinition*>(definition);
+      addEntityToLayout(layout, pointEntityDefinition, font);
+    }
   }
 }
 
-namespace
-{
-bool matchesFilterText(
-  const Assets::PointEntityDefinition& definition, const std::string& filterText)
-{
-  return filterText.empty()
-         || kdl::all_of(kdl::str_split(filterText, " "), [&](const auto& pattern) {
-              return kdl::ci::str_contains(definition.name(), pattern);
-            });
-}
-} // namespace
-
 void EntityBrowserView::addEntityToLayout(
   Layout& layout,
   const Assets::PointEntityDefinition* definition,
   const Renderer::FontDescriptor& font)
 {
-  if (
-    (!m_hideUnused || definition->usageCount() > 0)
-    && matchesFilterText(*definition, m_filterText))
+  if (!m_hideUnused || definition->usageCount() > 0)
   {
 
     const auto maxCellWidth = layout.maxCellWidth();
@@ -281,7 +289,10 @@ void EntityBrowserView::addEntityToLayout(
   }
 }
 
-void EntityBrowserView::doClear() {}
+void EntityBrowserView::doClear()
+{
+  invalidatePreviews();
+}
 
 void EntityBrowserView::doRender(Layout& layout, const float y, const float height)
 {
@@ -315,30 +326,24 @@ void EntityBrowserView::renderBounds(Layout& layout, const float y, const float
   using BoundsVertex = Renderer::GLVertexTypes::P3C4::Vertex;
   auto vertices = std::vector<BoundsVertex>{};
 
-  for (const auto& group : layout.groups())
+  for (const auto& group : layout.visibleGroups(y, height))
   {
-    if (group.intersectsY(y, height))
+    for (const auto& row : group.visibleRows(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& cell : row.cells())
       {
-        if (row.intersectsY(y, height))
+        const auto* definition = cellData(cell).entityDefinition;
+        auto* modelRenderer = cellData(cell).modelRenderer;
+
+        if (modelRenderer == nullptr)
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto* definition = cellData(cell).entityDefinition;
-            auto* modelRenderer = cellData(cell).modelRenderer;
-
-            if (modelRenderer == nullptr)
-            {
-              const auto itemTrans = itemTransformation(cell, y, height, false);
-              const auto& color = definition->color();
-              vm::bbox3f{definition->bounds()}.for_each_edge(
-                [&](const vm::vec3f& v1, const vm::vec3f& v2) {
-                  vertices.emplace_back(itemTrans * v1, color);
-                  vertices.emplace_back(itemTrans * v2, color);
-                });
-            }
-          }
+          const auto itemTrans = itemTransformation(cell, y, height, false);
+          const auto& color = definition->color();
+          vm::bbox3f{definition->bounds()}.for_each_edge(
+            [&](const vm::vec3f& v1, const vm::vec3f& v2) {
+              vertices.emplace_back(itemTrans * v1, color);
+              vertices.emplace_back(itemTrans * v2, color);
+            });
         }
       }
     }
@@ -358,14 +363,49 @@ void EntityBrowserView::renderModels(
   const float height,
   Renderer::Transformation& transformation)
 {
-  glAssert(glFrontFace(GL_CW));
-
   m_entityModelManager.prepare(vboManager());
 
+  auto cells = std::vector<const Cell*>{};
+  for (const auto& group : layout.visibleGroups(y, height))
+  {
+    for (const auto& row : group.visibleRows(y, height))
+    {
+      for (const auto& cell : row.cells())
+      {
+        if (cellData(cell).modelRenderer != nullptr)
+        {
+          cells.push_back(&cell);
+        }
+      }
+    }
+  }
+
+  if (updatePreviews(cells, transformation))
+  {
+    renderPreviews(cells, y, height, transformation);
+    return;
+  }
+
+  // render the models directly if the preview atlas is not available
+  glAssert(glFrontFace(GL_CW));
+
   auto shader =
     Renderer::ActiveShader{shaderManager(), Renderer::Shaders::EntityModelShader};
-  shader.set("ApplyTinting", false);
+  setupModelShader(shader, transformation);
   shader.set("Brightness", pref(Preferences::Brightness));
+
+  for (const auto* cell : cells)
+  {
+    const auto itemTrans = itemTransformation(*cell, y, height, true);
+    renderModel(*cell, itemTrans, shader, transformation);
+  }
+}
+
+void EntityBrowserView::setupModelShader(
+  Renderer::ActiveShader& shader, const Renderer::Transformation& transformation)
+{
+  shader.set("ApplyTinting", false);
+  shader.set("Brightness", 1.0f);
   shader.set("GrayScale", false);
 
   shader.set("CameraPosition", CameraPosition);
@@ -373,44 +413,197 @@ void EntityBrowserView::renderModels(
   shader.set("CameraRight", vm::cross(CameraDirection, CameraUp));
   shader.set("CameraUp", CameraUp);
   shader.set("ViewMatrix", transformation.viewMatrix());
+}
 
-  for (const auto& group : layout.groups())
+void EntityBrowserView::renderModel(
+  const Cell& cell,
+  const vm::mat4x4f& itemTrans,
+  Renderer::ActiveShader& shader,
+  Renderer::Transformation& transformation)
+{
+  shader.set("Orientation", static_cast<int>(cellData(cell).modelOrientation));
+  shader.set("ModelMatrix", itemTrans);
+
+  const auto multMatrix = Renderer::MultiplyModelMatrix{transformation, itemTrans};
+  cellData(cell).modelRenderer->render();
+}
+
+bool EntityBrowserView::isPreviewValid(const Cell& cell) const
+{
+  const auto& cellData = this->cellData(cell);
+  const auto it = m_previews.find(cellData.entityDefinition);
+  if (it == m_previews.end())
   {
-    if (group.intersectsY(y, height))
+    return false;
+  }
+
+  const auto& preview = it->second;
+  const auto size = previewSize(cell);
+  return preview.modelRenderer == cellData.modelRenderer
+         && preview.modelScale == cellData.modelScale
+         && preview.slot.width == size.x() && preview.slot.height == size.y();
+}
+
+vm::vec2i EntityBrowserView::previewSize(const Cell& cell) const
+{
+  // the previews are rendered at the resolution of the screen
+  const auto r = float(devicePixelRatioF());
+  const auto& bounds = cell.itemBounds();
+  return vm::vec2i{int(std::ceil(bounds.width * r)), int(std::ceil(bounds.height * r))};
+}
+
+bool EntityBrowserView::allocatePreviews(const std::vector<const Cell*>& cells)
+{
+  for (const auto* cell : cells)
+  {
+    const auto size = previewSize(*cell);
+    const auto slot = m_previewAtlas.allocate(size.x(), size.y());
+    if (!slot)
     {
-      for (const auto& row : group.rows())
-      {
-        if (row.intersectsY(y, height))
-        {
-          for (const auto& cell : row.cells())
-          {
-            if (auto* modelRenderer = cellData(cell).modelRenderer)
-            {
-              shader.set(
-                "Orientation", static_cast<int>(cellData(cell).modelOrientation));
-
-              const auto itemTrans = itemTransformation(cell, y, height, true);
-              shader.set("ModelMatrix", itemTrans);
-
-              const auto multMatrix =
-                Renderer::MultiplyModelMatrix{transformation, itemTrans};
-              modelRenderer->render();
-            }
-          }
-        }
-      }
+      return false;
     }
+
+    const auto& cellData = this->cellData(*cell);
+    m_previews[cellData.entityDefinition] =
+      Preview{cellData.modelRenderer, cellData.modelScale, *slot};
+  }
+  return true;
+}
+
+bool EntityBrowserView::updatePreviews(
+  const std::vector<const Cell*>& cells, Renderer::Transformation& transformation)
+{
+  if (!Renderer::PreviewAtlas::supported())
+  {
+    return false;
+  }
+
+  auto missingCells =
+    kdl::vec_filter(cells, [&](const auto* cell) { return !isPreviewValid(*cell); });
+  if (missingCells.empty())
+  {
+    return true;
+  }
+
+  if (!allocatePreviews(missingCells))
+  {
+    // the atlas is full, so start over with only the visible cells
+    invalidatePreviews();
+    missingCells = cells;
+    if (!allocatePreviews(missingCells))
+    {
+      invalidatePreviews();
+      return false;
+    }
+  }
+
+  glAssert(glFrontFace(GL_CW));
+
+  // the brightness is applied when the previews are drawn
+  auto shader =
+    Renderer::ActiveShader{shaderManager(), Renderer::Shaders::EntityModelShader};
+  setupModelShader(shader, transformation);
+
+  const auto r = float(devicePixelRatioF());
+  const auto view = transformation.viewMatrix();
+  for (const auto* cell : missingCells)
+  {
+    const auto& slot = m_previews[cellData(*cell).entityDefinition].slot;
+    if (!m_previewAtlas.bind(slot))
+    {
+      invalidatePreviews();
+      return false;
+    }
+
+    // the slot is measured in pixels, but the cells are measured in points
+    const auto projection = vm::ortho_matrix(
+      -1024.0f, 1024.0f, 0.0f, float(slot.height) / r, float(slot.width) / r, 0.0f);
+    auto replaceTransformation =
+      Renderer::ReplaceTransformation{transformation, projection, view};
+
+    renderModel(
+      *cell, itemTransformation(*cell, vm::vec3f{0, 0, 0}, true), shader, transformation);
+    m_previewAtlas.unbind();
+  }
+
+  return true;
+}
+
+void EntityBrowserView::renderPreviews(
+  const std::vector<const Cell*>& cells,
+  const float y,
+  const float height,
+  Renderer::Transformation& transformation)
+{
+  using PreviewVertex = Renderer::GLVertexTypes::P2T2::Vertex;
+
+  const auto r = float(devicePixelRatioF());
+  const auto atlasSize = float(m_previewAtlas.size());
+
+  auto vertices = std::vector<PreviewVertex>{};
+  vertices.reserve(4 * cells.size());
+
+  for (const auto* cell : cells)
+  {
+    const auto& slot = m_previews.at(cellData(*cell).entityDefinition).slot;
+
+    // the models are rendered into the bottom left corner of their slots
+    const auto left = cell->itemBounds().left();
+    const auto bottom = height - (cell->itemBounds().bottom() - y);
+    const auto right = left + float(slot.width) / r;
+    const auto top = bottom + float(slot.height) / r;
+
+    const auto s0 = float(slot.x) / atlasSize;
+    const auto t0 = float(slot.y) / atlasSize;
+    const auto s1 = float(slot.x + slot.width) / atlasSize;
+    const auto t1 = float(slot.y + slot.height) / atlasSize;
+
+    vertices.emplace_back(vm::vec2f{left, top}, vm::vec2f{s0, t1});
+    vertices.emplace_back(vm::vec2f{left, bottom}, vm::vec2f{s0, t0});
+    vertices.emplace_back(vm::vec2f{right, bottom}, vm::vec2f{s1, t0});
+    vertices.emplace_back(vm::vec2f{right, top}, vm::vec2f{s1, t1});
   }
+
+  const auto viewLeft = float(0);
+  const auto viewTop = float(size().height());
+  const auto viewRight = float(size().width());
+  const auto viewBottom = float(0);
+
+  auto replaceTransformation = Renderer::ReplaceTransformation{
+    transformation,
+    vm::ortho_matrix(-1.0f, 1.0f, viewLeft, viewTop, viewRight, viewBottom),
+    vm::view_matrix(vm::vec3f::neg_z(), vm::vec3f::pos_y())
+      * vm::translation_matrix(vm::vec3f{0.0f, 0.0f, 0.1f})};
+
+  auto shader =
+    Renderer::ActiveShader{shaderManager(), Renderer::Shaders::TextureBrowserShader};
+  shader.set("ApplyTinting", false);
+  shader.set("Texture", 0);
+  shader.set("Brightness", pref(Preferences::Brightness));
+  shader.set("GrayScale", false);
+
+  auto vertexArray = Renderer::VertexArray::move(std::move(vertices));
+
+  m_previewAtlas.activate();
+  vertexArray.prepare(vboManager());
+  vertexArray.render(Renderer::PrimType::Quads);
+  m_previewAtlas.deactivate();
 }
 
 vm::mat4x4f EntityBrowserView::itemTransformation(
   const Cell& cell, const float y, const float height, const bool applyModelScale) const
+{
+  const auto offset =
+    vm::vec3f{0.0f, cell.itemBounds().left(), height - (cell.itemBounds().bottom() - y)};
+  return itemTransformation(cell, offset, applyModelScale);
+}
+
+vm::mat4x4f EntityBrowserView::itemTransformation(
+  const Cell& cell, const vm::vec3f& offset, const bool applyModelScale) const
 {
   const auto& cellData = this->cellData(cell);
   const auto* definition = cellData.entityDefinition;
 
-  const auto offset =
-    vm::vec3f{0.0f, cell.itemBounds().left(), height - (cell.itemBounds().bottom() - y)};
   const auto scaling = cell.scale();
   const auto& rotatedBounds = cellData.bounds;
   const auto modelScale = applyModelScale ? cellData.modelScale : vm::vec3f{1, 1, 1};
@@ -23,6 +23,7 @@
 #include "NotifierConnection.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/GLVertexType.h"
+#include "Renderer/PreviewAtlas.h"
 #include "View/CellView.h"
 
 #include "vm/bbox.h"
@@ -31,6 +32,8 @@
 
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -50,6 +53,7 @@ class PointEntityDefinition;
 
 namespace TrenchBroom::Renderer
 {
+class ActiveShader;
 class FontDescriptor;
 class TexturedRenderer;
 class Transformation;
@@ -80,6 +84,18 @@ private:
   using TextVertex = Renderer::GLVertexTypes::P2T2C4::Vertex;
   using StringMap = std::map<Renderer::FontDescriptor, std::vector<TextVertex>>;
 
+  /**
+   * A model rendered into the preview atlas. It is rendered again if the cell's renderer,
+   * model scale or size in pixels changes.
+   */
+  struct Preview
+  {
+    const EntityRenderer* modelRenderer;
+    vm::vec3f modelScale;
+    Renderer::PreviewAtlas::Slot slot;
+  };
+  using PreviewMap = std::unordered_map<const Assets::PointEntityDefinition*, Preview>;
+
   static constexpr auto CameraPosition = vm::vec3f{256.0f, 0.0f, 0.0f};
   static constexpr auto CameraDirection = vm::vec3f::neg_x();
   static constexpr auto CameraUp = vm::vec3f::pos_z();
@@ -95,6 +111,9 @@ private:
   Assets::EntityDefinitionSortOrder m_sortOrder;
   std::string m_filterText;
 
+  Renderer::PreviewAtlas m_previewAtlas;
+  PreviewMap m_previews;
+
   NotifierConnection m_notifierConnection;
 
 public:
@@ -115,6 +134,13 @@ public:
   void setHideUnused(bool hideUnused);
   void setFilterText(const std::string& filterText);
 
+  /**
+   * Discards the rendered model previews. Must be called when the entity definitions or
+   * the entity models are reloaded, since the previews are looked up by definition and
+   * renderer.
+   */
+  void invalidatePreviews();
+
 private:
   void doInitLayout(Layout& layout) override;
   void doReloadLayout(Layout& layout) override;
@@ -122,9 +148,18 @@ private:
   bool dndEnabled() override;
   QString dndData(const Cell& cell) override;
 
+  using DefinitionSet = std::unordered_set<const Assets::EntityDefinition*>;
+
+  /**
+   * Returns the definitions whose names match the filter text, or nothing if the filter
+   * text is empty.
+   */
+  std::optional<DefinitionSet> findMatchingDefinitions() const;
+
   void addEntitiesToLayout(
     Layout& layout,
     const std::vector<Assets::EntityDefinition*>& definitions,
+    const std::optional<DefinitionSet>& matchingDefinitions,
     const Renderer::FontDescriptor& font);
   void addEntityToLayout(
     Layout& layout,
@@ -141,9 +176,29 @@ private:
   class MeshFunc;
   void renderModels(
     Layout& layout, float y, float height, Renderer::Transformation& transformation);
+  void setupModelShader(
+    Renderer::ActiveShader& shader, const Renderer::Transformation& transformation);
+  void renderModel(
+    const Cell& cell,
+    const vm::mat4x4f& itemTrans,
+    Renderer::ActiveShader& shader,
+    Renderer::Transformation& transformation);
+
+  bool isPreviewValid(const Cell& cell) const;
+  vm::vec2i previewSize(const Cell& cell) const;
+  bool allocatePreviews(const std::vector<const Cell*>& cells);
+  bool updatePreviews(
+    const std::vector<const Cell*>& cells, Renderer::Transformation& transformation);
+  void renderPreviews(
+    const std::vector<const Cell*>& cells,
+    float y,
+    float height,
+    Renderer::Transformation& transformation);
 
   vm::mat4x4f itemTransformation(
     const Cell& cell, float y, float height, bool applyModelScale) const;
+  vm::mat4x4f itemTransformation(
+    const Cell& cell, const vm::vec3f& offset, bool applyModelScale) const;
 
   QString tooltip(const Cell& cell) override;
 
@@ -391,6 +391,10 @@ void EntityPropertyGrid::connectObservers()
     this, &EntityPropertyGrid::documentWasLoaded);
   m_notifierConnection +=
     document->nodesDidChangeNotifier.connect(this, &EntityPropertyGrid::nodesDidChange);
+  m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(
+    this, &EntityPropertyGrid::entityDefinitionsOrModsDidChange);
+  m_notifierConnection += document->modsDidChangeNotifier.connect(
+    this, &EntityPropertyGrid::entityDefinitionsOrModsDidChange);
   m_notifierConnection += document->selectionWillChangeNotifier.connect(
     this, &EntityPropertyGrid::selectionWillChange);
   m_notifierConnection += document->selectionDidChangeNotifier.connect(
@@ -399,16 +403,25 @@ void EntityPropertyGrid::connectObservers()
 
 void EntityPropertyGrid::documentWasNewed(MapDocument*)
 {
+  m_model->invalidateNodes();
   updateControls();
 }
 
 void EntityPropertyGrid::documentWasLoaded(MapDocument*)
 {
+  m_model->invalidateNodes();
   updateControls();
 }
 
-void EntityPropertyGrid::nodesDidChange(const std::vector<Model::Node*>&)
+void EntityPropertyGrid::nodesDidChange(const std::vector<Model::Node*>& nodes)
 {
+  m_model->nodesDidChange(nodes);
+  updateControls();
+}
+
+void EntityPropertyGrid::entityDefinitionsOrModsDidChange()
+{
+  m_model->invalidateNodes();
   updateControls();
 }
 
@@ -425,21 +438,27 @@ void EntityPropertyGrid::updateControls()
   // where worldspawn is selected. If we call this directly, it'll cause the table to be
   // rebuilt based on that intermediate state. Everything is fine except you lose the
   // selected row in the table, unless it's a key name that exists in worldspawn. To avoid
-  // that problem, make a delayed call to update the table.
-  QTimer::singleShot(0, this, [&]() {
-    m_model->updateFromMapDocument();
-
-    if (m_table->selectionModel()->selectedIndexes().empty())
-    {
-      restoreSelection();
-    }
-    ensureSelectionVisible();
+  // that problem, make a delayed call to update the table. Multiple notifications that
+  // arrive before the table is updated are handled by a single update.
+  if (!m_updatePending)
+  {
+    m_updatePending = true;
+    QTimer::singleShot(0, this, [&]() {
+      m_updatePending = false;
+      m_model->updateFromMapDocument();
+
+      if (m_table->selectionModel()->selectedIndexes().empty())
+      {
+        restoreSelection();
+      }
+      ensureSelectionVisible();
 
-    const auto shouldShowProtectedProperties = m_model->shouldShowProtectedProperties();
-    m_table->setColumnHidden(
-      EntityPropertyModel::ColumnProtected, !shouldShowProtectedProperties);
-    m_addProtectedPropertyButton->setHidden(!shouldShowProtectedProperties);
-  });
+      const auto shouldShowProtectedProperties = m_model->shouldShowProtectedProperties();
+      m_table->setColumnHidden(
+        EntityPropertyModel::ColumnProtected, !shouldShowProtectedProperties);
+      m_addProtectedPropertyButton->setHidden(!shouldShowProtectedProperties);
+    });
+  }
   updateControlsEnabled();
 }
 
@@ -73,6 +73,7 @@ private:
   QToolButton* m_setDefaultPropertiesButton;
   QCheckBox* m_showDefaultPropertiesCheckBox;
   std::vector<PropertyGridSelection> m_selectionBackup;
+  bool m_updatePending = false;
 
   NotifierConnection m_notifierConnection;
 
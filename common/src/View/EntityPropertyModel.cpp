@@ -32,13 +32,17 @@
 #include "Assets/PropertyDefinition.h"
 #include "IO/ResourceUtils.h"
 #include "Macros.h"
+#include "Model/BrushNode.h"
 #include "Model/Entity.h"
+#include "Model/EntityNode.h"
 #include "Model/EntityNodeBase.h"
 #include "Model/EntityNodeIndex.h"
 #include "Model/EntityProperties.h"
 #include "Model/Group.h"
 #include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
 #include "Model/ModelUtils.h"
+#include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 #include "View/QtUtils.h"
@@ -46,15 +50,19 @@
 
 #include "kdl/map_utils.h"
 #include "kdl/memory_utils.h"
+#include "kdl/overload.h"
 #include "kdl/reflection_impl.h"
 #include "kdl/string_utils.h"
 #include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -65,6 +73,35 @@ namespace TrenchBroom
 namespace View
 {
 // helper functions
+static bool isWorldspawnPropertyKeyMutable(const std::string& key)
+{
+  return !(
+    key == Model::EntityPropertyKeys::Classname
+    || key == Model::EntityPropertyKeys::Mods
+    || key == Model::EntityPropertyKeys::EntityDefinitions
+    || key == Model::EntityPropertyKeys::Wad
+    || key == Model::EntityPropertyKeys::EnabledTextureCollections
+    || key == Model::EntityPropertyKeys::SoftMapBounds
+    || key == Model::EntityPropertyKeys::LayerColor
+    || key == Model::EntityPropertyKeys::LayerLocked
+    || key == Model::EntityPropertyKeys::LayerHidden
+    || key == Model::EntityPropertyKeys::LayerOmitFromExport);
+}
+
+static bool isWorldspawnPropertyValueMutable(const std::string& key)
+{
+  return !(
+    key == Model::EntityPropertyKeys::Classname
+    || key == Model::EntityPropertyKeys::Mods
+    || key == Model::EntityPropertyKeys::EntityDefinitions
+    || key == Model::EntityPropertyKeys::Wad
+    || key == Model::EntityPropertyKeys::SoftMapBounds
+    || key == Model::EntityPropertyKeys::LayerColor
+    || key == Model::EntityPropertyKeys::LayerLocked
+    || key == Model::EntityPropertyKeys::LayerHidden
+    || key == Model::EntityPropertyKeys::LayerOmitFromExport);
+}
+
 static bool isPropertyKeyMutable(const Model::Entity& entity, const std::string& key)
 {
   assert(!Model::isGroup(entity.classname(), entity.properties()));
@@ -72,17 +109,7 @@ static bool isPropertyKeyMutable(const Model::Entity& entity, const std::string&
 
   if (Model::isWorldspawn(entity.classname()))
   {
-    return !(
-      key == Model::EntityPropertyKeys::Classname
-      || key == Model::EntityPropertyKeys::Mods
-      || key == Model::EntityPropertyKeys::EntityDefinitions
-      || key == Model::EntityPropertyKeys::Wad
-      || key == Model::EntityPropertyKeys::EnabledTextureCollections
-      || key == Model::EntityPropertyKeys::SoftMapBounds
-      || key == Model::EntityPropertyKeys::LayerColor
-      || key == Model::EntityPropertyKeys::LayerLocked
-      || key == Model::EntityPropertyKeys::LayerHidden
-      || key == Model::EntityPropertyKeys::LayerOmitFromExport);
+    return isWorldspawnPropertyKeyMutable(key);
   }
 
   return true;
@@ -95,16 +122,7 @@ static bool isPropertyValueMutable(const Model::Entity& entity, const std::strin
 
   if (Model::isWorldspawn(entity.classname()))
   {
-    return !(
-      key == Model::EntityPropertyKeys::Classname
-      || key == Model::EntityPropertyKeys::Mods
-      || key == Model::EntityPropertyKeys::EntityDefinitions
-      || key == Model::EntityPropertyKeys::Wad
-      || key == Model::EntityPropertyKeys::SoftMapBounds
-      || key == Model::EntityPropertyKeys::LayerColor
-      || key == Model::EntityPropertyKeys::LayerLocked
-      || key == Model::EntityPropertyKeys::LayerHidden
-      || key == Model::EntityPropertyKeys::LayerOmitFromExport);
+    return isWorldspawnPropertyValueMutable(key);
   }
 
   return true;
@@ -117,19 +135,22 @@ static bool isPropertyProtectable(
          && key != Model::EntityPropertyKeys::Origin;
 }
 
+static bool isProtectedBy(
+  const std::vector<std::string>& protectedProperties, const std::string& key)
+{
+  return kdl::any_of(protectedProperties, [&](const auto& protectedKey) {
+    return Model::isNumberedProperty(protectedKey, key);
+  });
+}
+
 static PropertyProtection isPropertyProtected(
   const Model::EntityNodeBase& entityNode, const std::string& key)
 {
   if (isPropertyProtectable(entityNode, key))
   {
-    for (const auto& protectedKey : entityNode.entity().protectedProperties())
-    {
-      if (Model::isNumberedProperty(protectedKey, key))
-      {
-        return PropertyProtection::Protected;
-      }
-    }
-    return PropertyProtection::NotProtected;
+    return isProtectedBy(entityNode.entity().protectedProperties(), key)
+             ? PropertyProtection::Protected
+             : PropertyProtection::NotProtected;
   }
   return PropertyProtection::NotProtectable;
 }
@@ -205,6 +226,24 @@ PropertyRow::PropertyRow(std::string key, const Model::EntityNodeBase* node)
   }
 }
 
+PropertyRow::PropertyRow(
+  std::string key,
+  std::string value,
+  const ValueType valueType,
+  const bool keyMutable,
+  const bool valueMutable,
+  const PropertyProtection protection,
+  std::string tooltip)
+  : m_key{std::move(key)}
+  , m_value{std::move(value)}
+  , m_valueType{valueType}
+  , m_keyMutable{keyMutable}
+  , m_valueMutable{valueMutable}
+  , m_protected{protection}
+  , m_tooltip{std::move(tooltip)}
+{
+}
+
 void PropertyRow::merge(const Model::EntityNodeBase* other)
 {
   const auto* otherValue = other->entity().property(m_key);
@@ -227,6 +266,7 @@ void PropertyRow::merge(const Model::EntityNodeBase* other)
     else if (*otherValue != m_value)
     {
       m_valueType = ValueType::MultipleValues;
+      m_value.clear();
     }
   }
   else if (m_valueType == ValueType::SingleValueAndUnset)
@@ -234,6 +274,7 @@ void PropertyRow::merge(const Model::EntityNodeBase* other)
     if (otherValue && *otherValue != m_value)
     {
       m_valueType = ValueType::MultipleValues;
+      m_value.clear();
     }
   }
 
@@ -391,6 +432,270 @@ std::string PropertyRow::newPropertyKeyForEntityNodes(
 
 kdl_reflect_impl(PropertyRow);
 
+// EntityPropertySummary
+
+EntityPropertySummary::EntityPropertySummary() = default;
+
+EntityPropertySummary::~EntityPropertySummary() = default;
+
+void EntityPropertySummary::setNodes(const std::vector<Model::EntityNodeBase*>& nodes)
+{
+  const auto nodeSet = std::set<const Model::EntityNodeBase*>{nodes.begin(), nodes.end()};
+
+  auto removedNodes = std::vector<const Model::EntityNodeBase*>{};
+  for (const auto& [node, info] : m_nodes)
+  {
+    if (nodeSet.count(node) == 0)
+    {
+      removedNodes.push_back(node);
+    }
+  }
+
+  for (const auto* node : removedNodes)
+  {
+    removeNode(node);
+  }
+
+  for (const auto* node : nodeSet)
+  {
+    if (auto it = m_nodes.find(node); it != m_nodes.end())
+    {
+      // the node may have been moved into or out of a group since it was added
+      auto& info = it->second;
+      const auto grouped = Model::findContainingGroup(node) != nullptr;
+      if (grouped != info.grouped)
+      {
+        m_groupedCount = grouped ? m_groupedCount + 1 : m_groupedCount - 1;
+        info.grouped = grouped;
+      }
+    }
+    else
+    {
+      addNode(node);
+    }
+  }
+}
+
+void EntityPropertySummary::updateNodes(const std::vector<Model::EntityNodeBase*>& nodes)
+{
+  for (const auto* node : nodes)
+  {
+    if (m_nodes.count(node) > 0)
+    {
+      removeNode(node);
+      addNode(node);
+    }
+  }
+}
+
+void EntityPropertySummary::clear()
+{
+  m_nodes.clear();
+  m_valueCounts.clear();
+  m_protectedKeyCounts.clear();
+  m_definitions.clear();
+  m_worldspawnCount = 0;
+  m_groupedCount = 0;
+  m_protectingNodes.clear();
+}
+
+std::map<std::string, PropertyRow> EntityPropertySummary::rows(
+  const bool showDefaultRows, const bool showPreservedProperties) const
+{
+  auto result = std::map<std::string, PropertyRow>{};
+  const auto addRow = [&](const std::string& key) {
+    if (result.count(key) == 0)
+    {
+      result.emplace(key, row(key));
+    }
+  };
+
+  for (const auto& [key, valueCounts] : m_valueCounts)
+  {
+    addRow(key);
+  }
+
+  if (showDefaultRows)
+  {
+    for (const auto& [definition, definitionInfo] : m_definitions)
+    {
+      for (const auto& key : definitionInfo.keys)
+      {
+        addRow(key);
+      }
+    }
+  }
+
+  if (showPreservedProperties)
+  {
+    for (const auto& [key, count] : m_protectedKeyCounts)
+    {
+      addRow(key);
+    }
+  }
+
+  return result;
+}
+
+void EntityPropertySummary::addNode(const Model::EntityNodeBase* node)
+{
+  const auto& entity = node->entity();
+  auto info = NodeInfo{
+    entity.properties(),
+    entity.protectedProperties(),
+    entity.definition(),
+    Model::isWorldspawn(entity.classname()),
+    Model::findContainingGroup(node) != nullptr};
+
+  for (const auto& property : info.properties)
+  {
+    ++m_valueCounts[property.key()][property.value()];
+  }
+
+  for (const auto& key : info.protectedProperties)
+  {
+    ++m_protectedKeyCounts[key];
+  }
+
+  if (info.definition)
+  {
+    auto& definitionInfo = m_definitions[info.definition];
+    if (definitionInfo.count++ == 0)
+    {
+      definitionInfo.keys = kdl::vec_transform(
+        info.definition->propertyDefinitions(),
+        [](const auto& propertyDefinition) { return propertyDefinition->key(); });
+    }
+  }
+
+  if (info.worldspawn)
+  {
+    ++m_worldspawnCount;
+  }
+  if (info.grouped)
+  {
+    ++m_groupedCount;
+  }
+  if (!info.protectedProperties.empty())
+  {
+    m_protectingNodes.insert(node);
+  }
+
+  m_nodes.emplace(node, std::move(info));
+}
+
+void EntityPropertySummary::removeNode(const Model::EntityNodeBase* node)
+{
+  // the node itself must not be accessed, it may have changed or been destroyed
+  const auto it = m_nodes.find(node);
+  assert(it != m_nodes.end());
+
+  const auto& info = it->second;
+  for (const auto& property : info.properties)
+  {
+    auto valueCountsIt = m_valueCounts.find(property.key());
+    auto& valueCounts = valueCountsIt->second;
+    if (--valueCounts[property.value()] == 0)
+    {
+      valueCounts.erase(property.value());
+      if (valueCounts.empty())
+      {
+        m_valueCounts.erase(valueCountsIt);
+      }
+    }
+  }
+
+  for (const auto& key : info.protectedProperties)
+  {
+    if (--m_protectedKeyCounts[key] == 0)
+    {
+      m_protectedKeyCounts.erase(key);
+    }
+  }
+
+  if (info.definition)
+  {
+    if (--m_definitions[info.definition].count == 0)
+    {
+      m_definitions.erase(info.definition);
+    }
+  }
+
+  if (info.worldspawn)
+  {
+    --m_worldspawnCount;
+  }
+  if (info.grouped)
+  {
+    --m_groupedCount;
+  }
+  m_protectingNodes.erase(node);
+
+  m_nodes.erase(it);
+}
+
+PropertyRow EntityPropertySummary::row(const std::string& key) const
+{
+  assert(!m_nodes.empty());
+
+  // like PropertyRow::rowForEntityNodes, take the definition from the first node
+  const auto* firstNode = m_nodes.begin()->first;
+  const auto* definition = Model::propertyDefinition(firstNode, key);
+
+  auto value = std::string{};
+  auto valueType = ValueType::Unset;
+  if (const auto it = m_valueCounts.find(key); it != m_valueCounts.end())
+  {
+    const auto& valueCounts = it->second;
+    if (valueCounts.size() > 1)
+    {
+      valueType = ValueType::MultipleValues;
+    }
+    else
+    {
+      const auto& [singleValue, count] = *valueCounts.begin();
+      value = singleValue;
+      valueType =
+        count == m_nodes.size() ? ValueType::SingleValue : ValueType::SingleValueAndUnset;
+    }
+  }
+  else if (definition != nullptr)
+  {
+    value = Assets::PropertyDefinition::defaultValue(*definition);
+  }
+
+  const auto keyMutable = m_worldspawnCount == 0 || isWorldspawnPropertyKeyMutable(key);
+  const auto valueMutable =
+    m_worldspawnCount == 0 || isWorldspawnPropertyValueMutable(key);
+
+  auto protection = PropertyProtection::NotProtectable;
+  if (m_groupedCount == m_nodes.size() && key != Model::EntityPropertyKeys::Origin)
+  {
+    const auto protectedCount = static_cast<size_t>(std::count_if(
+      m_protectingNodes.begin(), m_protectingNodes.end(), [&](const auto* node) {
+        return isProtectedBy(m_nodes.at(node).protectedProperties, key);
+      }));
+    protection = protectedCount == 0              ? PropertyProtection::NotProtected
+                 : protectedCount == m_nodes.size() ? PropertyProtection::Protected
+                                                    : PropertyProtection::Mixed;
+  }
+
+  auto tooltip = definition != nullptr ? definition->shortDescription() : "";
+  if (tooltip.empty())
+  {
+    tooltip = "No description found";
+  }
+
+  return PropertyRow{
+    key,
+    std::move(value),
+    valueType,
+    keyMutable,
+    valueMutable,
+    protection,
+    std::move(tooltip)};
+}
+
 // EntityPropertyModel
 
 EntityPropertyModel::EntityPropertyModel(
@@ -523,26 +828,30 @@ void EntityPropertyModel::setRows(const std::map<std::string, PropertyRow>& newR
     return;
   }
 
-  // Handle edited rows
+  // Handle edited rows, notifying Qt once for the range of edited rows
 
   MODEL_LOG(
     qDebug() << "EntityPropertyModel::setRows: " << diff.updated.size()
              << " common keys");
-  for (const auto& key : diff.updated)
+  if (!diff.updated.empty())
   {
-    const auto& oldRow = oldRowMap.at(key);
-    const auto& newRow = newRowMap.at(key);
-    const auto oldIndex = kdl::vec_index_of(m_rows, oldRow);
+    auto firstUpdatedRow = m_rows.size();
+    auto lastUpdatedRow = size_t(0);
+    for (const auto& key : diff.updated)
+    {
+      const auto oldIndex = static_cast<size_t>(rowForPropertyKey(key));
 
-    MODEL_LOG(
-      qDebug() << "   updating row " << *oldIndex << "(" << QString::fromStdString(key)
-               << ")");
+      MODEL_LOG(
+        qDebug() << "   updating row " << oldIndex << "(" << QString::fromStdString(key)
+                 << ")");
 
-    m_rows.at(*oldIndex) = newRow;
+      m_rows.at(oldIndex) = newRowMap.at(key);
+      firstUpdatedRow = std::min(firstUpdatedRow, oldIndex);
+      lastUpdatedRow = std::max(lastUpdatedRow, oldIndex);
+    }
 
-    // Notify Qt
-    const auto topLeft = index(static_cast<int>(*oldIndex), 0);
-    const auto bottomRight = index(static_cast<int>(*oldIndex), NumColumns - 1);
+    const auto topLeft = index(static_cast<int>(firstUpdatedRow), 0);
+    const auto bottomRight = index(static_cast<int>(lastUpdatedRow), NumColumns - 1);
     emit dataChanged(topLeft, bottomRight);
   }
 
@@ -566,26 +875,59 @@ void EntityPropertyModel::setRows(const std::map<std::string, PropertyRow>& newR
     endInsertRows();
   }
 
-  // Deletions
+  // Deletions, removing consecutive rows together
   if (!diff.removed.empty())
   {
     MODEL_LOG(
       qDebug() << "EntityPropertyModel::setRows: deleting " << diff.removed.size()
                << " rows");
 
-    for (const auto& key : diff.removed)
+    auto removedIndices = kdl::vec_transform(diff.removed, [&](const auto& key) {
+      const auto index = rowForPropertyKey(key);
+      assert(index != -1);
+      return index;
+    });
+    std::sort(removedIndices.begin(), removedIndices.end(), std::greater<int>{});
+
+    auto it = removedIndices.begin();
+    while (it != removedIndices.end())
     {
-      const auto& row = oldRowMap.at(key);
-      const auto index = kdl::vec_index_of(m_rows, row);
-      assert(index);
+      const auto last = *it;
+      auto first = last;
+      while (++it != removedIndices.end() && *it == first - 1)
+      {
+        first = *it;
+      }
 
-      beginRemoveRows(QModelIndex{}, static_cast<int>(*index), static_cast<int>(*index));
-      m_rows.erase(std::next(m_rows.begin(), static_cast<int>(*index)));
+      beginRemoveRows(QModelIndex{}, first, last);
+      m_rows.erase(std::next(m_rows.begin(), first), std::next(m_rows.begin(), last + 1));
       endRemoveRows();
     }
   }
 }
 
+void EntityPropertyModel::nodesDidChange(const std::vector<Model::Node*>& nodes)
+{
+  auto entityNodes = std::vector<Model::EntityNodeBase*>{};
+  for (auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [&](Model::WorldNode* world) { entityNodes.push_back(world); },
+      [](Model::LayerNode*) {},
+      [](Model::GroupNode*) {},
+      [&](Model::EntityNode* entity) { entityNodes.push_back(entity); },
+      [](Model::BrushNode*) {},
+      [](Model::PatchNode*) {}));
+  }
+
+  m_summary.updateNodes(entityNodes);
+}
+
+void EntityPropertyModel::invalidateNodes()
+{
+  m_summary.clear();
+}
+
 const PropertyRow* EntityPropertyModel::dataForModelIndex(const QModelIndex& index) const
 {
   if (!index.isValid())
@@ -737,10 +1079,9 @@ void EntityPropertyModel::updateFromMapDocument()
   auto document = kdl::mem_lock(m_document);
 
   const auto entityNodes = document->allSelectedEntityNodes();
-  const auto rowsMap =
-    PropertyRow::rowsForEntityNodes(entityNodes, m_showDefaultRows, true);
+  m_summary.setNodes(entityNodes);
 
-  setRows(rowsMap);
+  setRows(m_summary.rows(m_showDefaultRows, true));
   m_shouldShowProtectedProperties = computeShouldShowProtectedProperties(entityNodes);
 }
 
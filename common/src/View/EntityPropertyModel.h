@@ -21,21 +21,30 @@
 
 #include <QAbstractTableModel>
 
+#include "Model/EntityProperties.h"
+
 #include "kdl/reflection_decl.h"
 
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <tuple>
 #include <vector>
 
 namespace TrenchBroom
 {
+namespace Assets
+{
+class EntityDefinition;
+}
+
 namespace Model
 {
 class EntityNodeBase;
-}
+class Node;
+} // namespace Model
 
 namespace View
 {
@@ -92,6 +101,14 @@ private:
 public:
   PropertyRow();
   PropertyRow(std::string key, const Model::EntityNodeBase* node);
+  PropertyRow(
+    std::string key,
+    std::string value,
+    ValueType valueType,
+    bool keyMutable,
+    bool valueMutable,
+    PropertyProtection protection,
+    std::string tooltip);
 
   void merge(const Model::EntityNodeBase* other);
 
@@ -132,6 +149,77 @@ public:
     m_tooltip);
 };
 
+/**
+ * Maintains the property rows of a set of entity nodes incrementally.
+ *
+ * Merging the properties of every node for every key is too slow when thousands of
+ * entities are selected. Instead, the summary counts the values of every key and the
+ * other information about the nodes that the rows depend on. Adding, removing or updating
+ * a node only visits that node's own properties, and the rows are then derived from the
+ * counts.
+ *
+ * The summary yields the same rows as PropertyRow::rowsForEntityNodes.
+ */
+class EntityPropertySummary
+{
+private:
+  struct NodeInfo
+  {
+    std::vector<Model::EntityProperty> properties;
+    std::vector<std::string> protectedProperties;
+    const Assets::EntityDefinition* definition;
+    bool worldspawn;
+    bool grouped;
+  };
+
+  struct DefinitionInfo
+  {
+    size_t count;
+    std::vector<std::string> keys;
+  };
+
+  // ordered like the nodes returned by MapDocument::allSelectedEntityNodes
+  std::map<const Model::EntityNodeBase*, NodeInfo> m_nodes;
+  std::map<std::string, std::map<std::string, size_t>> m_valueCounts;
+  std::map<std::string, size_t> m_protectedKeyCounts;
+  // the definitions are only used as keys, they are never dereferenced
+  std::map<const Assets::EntityDefinition*, DefinitionInfo> m_definitions;
+  size_t m_worldspawnCount = 0;
+  size_t m_groupedCount = 0;
+  // the nodes that have protected properties
+  std::set<const Model::EntityNodeBase*> m_protectingNodes;
+
+public:
+  EntityPropertySummary();
+  ~EntityPropertySummary();
+
+  /**
+   * Adds the given nodes that are not contained in this summary and removes the nodes
+   * contained in this summary that are not given.
+   */
+  void setNodes(const std::vector<Model::EntityNodeBase*>& nodes);
+
+  /**
+   * Updates those of the given nodes that are contained in this summary, e.g. because
+   * their properties changed.
+   */
+  void updateNodes(const std::vector<Model::EntityNodeBase*>& nodes);
+
+  /**
+   * Removes all nodes. This must be called when nodes contained in this summary might
+   * have been destroyed, or when the entity definitions have changed.
+   */
+  void clear();
+
+  std::map<std::string, PropertyRow> rows(
+    bool showDefaultRows, bool showPreservedProperties) const;
+
+private:
+  void addNode(const Model::EntityNodeBase* node);
+  void removeNode(const Model::EntityNodeBase* node);
+  PropertyRow row(const std::string& key) const;
+};
+
 /**
  * Model for the QTableView.
  *
@@ -161,6 +249,7 @@ public:
 
 private:
   std::vector<PropertyRow> m_rows;
+  EntityPropertySummary m_summary;
   bool m_showDefaultRows;
   bool m_shouldShowProtectedProperties;
   std::weak_ptr<MapDocument> m_document;
@@ -175,6 +264,18 @@ public:
 
   void setRows(const std::map<std::string, PropertyRow>& newRows);
 
+  /**
+   * Updates the cached properties of the given nodes if they are selected. The rows are
+   * only updated by the next call to updateFromMapDocument.
+   */
+  void nodesDidChange(const std::vector<Model::Node*>& nodes);
+
+  /**
+   * Discards the cached properties of all nodes, e.g. because the document or the entity
+   * definitions were replaced.
+   */
+  void invalidateNodes();
+
   const PropertyRow* dataForModelIndex(const QModelIndex& index) const;
   int rowForPropertyKey(const std::string& propertyKey) const;
 
@@ -33,8 +33,10 @@
 #include "Model/Game.h"
 #include "Model/GameConfig.h"
 #include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
 #include "Model/WorldNode.h"
 #include "View/BorderLine.h"
+#include "View/FaceAttribsSummary.h"
 #include "View/FlagsPopupEditor.h"
 #include "View/Grid.h"
 #include "View/MapDocument.h"
@@ -43,7 +45,6 @@
 #include "View/SpinControl.h"
 #include "View/UVEditor.h"
 #include "View/ViewConstants.h"
-#include "View/ViewUtils.h"
 
 #include "kdl/memory_utils.h"
 #include "kdl/string_format.h"
@@ -582,31 +583,38 @@ void FaceAttribsEditor::connectObservers()
 
 void FaceAttribsEditor::documentWasNewed(MapDocument*)
 {
+  m_faceAttribsSummaryCache.invalidate();
   updateControls();
 }
 
 void FaceAttribsEditor::documentWasLoaded(MapDocument*)
 {
+  m_faceAttribsSummaryCache.invalidate();
   updateControls();
 }
 
-void FaceAttribsEditor::nodesDidChange(const std::vector<Model::Node*>&)
+void FaceAttribsEditor::nodesDidChange(const std::vector<Model::Node*>& nodes)
 {
+  m_faceAttribsSummaryCache.brushesDidChange(Model::filterBrushNodes(nodes));
   updateControlsDelayed();
 }
 
-void FaceAttribsEditor::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&)
+void FaceAttribsEditor::brushFacesDidChange(
+  const std::vector<Model::BrushFaceHandle>& faces)
 {
+  m_faceAttribsSummaryCache.brushesDidChange(Model::toNodes(faces));
   updateControlsDelayed();
 }
 
 void FaceAttribsEditor::selectionDidChange(const Selection&)
 {
+  m_faceAttribsSummaryCache.invalidate();
   updateControlsDelayed();
 }
 
 void FaceAttribsEditor::textureCollectionsDidChange()
 {
+  m_faceAttribsSummaryCache.invalidate();
   updateControls();
 }
 
@@ -675,61 +683,14 @@ void FaceAttribsEditor::updateControls()
     hideColorAttribEditor();
   }
 
-  const auto faceHandles = kdl::mem_lock(m_document)->allSelectedBrushFaces();
-  if (!faceHandles.empty())
-  {
-    auto textureMulti = false;
-    auto xOffsetMulti = false;
-    auto yOffsetMulti = false;
-    auto rotationMulti = false;
-    auto xScaleMulti = false;
-    auto yScaleMulti = false;
-    auto surfaceValueMulti = false;
-    auto colorValueMulti = false;
-
-    const auto& firstFace = faceHandles[0].face();
-    const auto& textureName = firstFace.attributes().textureName();
-    const auto xOffset = firstFace.attributes().xOffset();
-    const auto yOffset = firstFace.attributes().yOffset();
-    const auto rotation = firstFace.attributes().rotation();
-    const auto xScale = firstFace.attributes().xScale();
-    const auto yScale = firstFace.attributes().yScale();
-    auto setSurfaceFlags = firstFace.resolvedSurfaceFlags();
-    auto setSurfaceContents = firstFace.resolvedSurfaceContents();
-    auto mixedSurfaceFlags = 0;
-    auto mixedSurfaceContents = 0;
-    const auto surfaceValue = firstFace.resolvedSurfaceValue();
-    const auto colorValue = firstFace.attributes().color();
-    auto hasSurfaceValue = firstFace.attributes().surfaceValue().has_value();
-    auto hasSurfaceFlags = firstFace.attributes().surfaceFlags().has_value();
-    auto hasSurfaceContents = firstFace.attributes().surfaceContents().has_value();
-    auto hasColorValue = firstFace.attributes().hasColor();
-
-    for (size_t i = 1; i < faceHandles.size(); i++)
-    {
-      const auto& face = faceHandles[i].face();
-      textureMulti |= (textureName != face.attributes().textureName());
-      xOffsetMulti |= (xOffset != face.attributes().xOffset());
-      yOffsetMulti |= (yOffset != face.attributes().yOffset());
-      rotationMulti |= (rotation != face.attributes().rotation());
-      xScaleMulti |= (xScale != face.attributes().xScale());
-      yScaleMulti |= (yScale != face.attributes().yScale());
-      surfaceValueMulti |= (surfaceValue != face.resolvedSurfaceValue());
-      colorValueMulti |= (colorValue != face.attributes().color());
-      hasSurfaceValue |= face.attributes().surfaceValue().has_value();
-      hasSurfaceFlags |= face.attributes().surfaceFlags().has_value();
-      hasSurfaceContents |= face.attributes().surfaceContents().has_value();
-      hasColorValue |= face.attributes().hasColor();
-
-      combineFlags(
-        sizeof(int) * 8, face.resolvedSurfaceFlags(), setSurfaceFlags, mixedSurfaceFlags);
-      combineFlags(
-        sizeof(int) * 8,
-        face.resolvedSurfaceContents(),
-        setSurfaceContents,
-        mixedSurfaceContents);
-    }
+  if (!m_faceAttribsSummaryCache.valid())
+  {
+    m_faceAttribsSummaryCache.setFaces(
+      kdl::mem_lock(m_document)->allSelectedBrushFaces());
+  }
 
+  if (const auto summary = m_faceAttribsSummaryCache.summary())
+  {
     m_xOffsetEditor->setEnabled(true);
     m_yOffsetEditor->setEnabled(true);
     m_rotationEditor->setEnabled(true);
@@ -740,7 +701,7 @@ void FaceAttribsEditor::updateControls()
     m_contentFlagsEditor->setEnabled(true);
     m_colorEditor->setEnabled(true);
 
-    if (textureMulti)
+    if (summary->textureMulti)
     {
       m_textureName->setText("multi");
       m_textureName->setEnabled(false);
@@ -749,7 +710,7 @@ void FaceAttribsEditor::updateControls()
     }
     else
     {
-      if (textureName == Model::BrushFaceAttributes::NoTextureName)
+      if (summary->textureName == Model::BrushFaceAttributes::NoTextureName)
       {
         m_textureName->setText("none");
         m_textureName->setEnabled(false);
@@ -758,9 +719,9 @@ void FaceAttribsEditor::updateControls()
       }
       else
       {
-        if (const auto* texture = firstFace.texture())
+        if (const auto* texture = summary->texture)
         {
-          m_textureName->setText(QString::fromStdString(textureName));
+          m_textureName->setText(QString::fromStdString(summary->textureName));
           m_textureSize->setText(
             QStringLiteral("%1 * %2").arg(texture->width()).arg(texture->height()));
           m_textureName->setEnabled(true);
@@ -768,21 +729,24 @@ void FaceAttribsEditor::updateControls()
         }
         else
         {
-          m_textureName->setText(QString::fromStdString(textureName) + " (not found)");
+          m_textureName->setText(
+            QString::fromStdString(summary->textureName) + " (not found)");
           m_textureName->setEnabled(false);
           m_textureSize->setEnabled(false);
         }
       }
     }
-    setValueOrMulti(m_xOffsetEditor, xOffsetMulti, double(xOffset));
-    setValueOrMulti(m_yOffsetEditor, yOffsetMulti, double(yOffset));
-    setValueOrMulti(m_rotationEditor, rotationMulti, double(rotation));
-    setValueOrMulti(m_xScaleEditor, xScaleMulti, double(xScale));
-    setValueOrMulti(m_yScaleEditor, yScaleMulti, double(yScale));
-    setValueOrMulti(m_surfaceValueEditor, surfaceValueMulti, double(surfaceValue));
-    if (hasColorValue)
+    setValueOrMulti(m_xOffsetEditor, summary->xOffsetMulti, double(summary->xOffset));
+    setValueOrMulti(m_yOffsetEditor, summary->yOffsetMulti, double(summary->yOffset));
+    setValueOrMulti(
+      m_rotationEditor, summary->rotationMulti, double(summary->rotation));
+    setValueOrMulti(m_xScaleEditor, summary->xScaleMulti, double(summary->xScale));
+    setValueOrMulti(m_yScaleEditor, summary->yScaleMulti, double(summary->yScale));
+    setValueOrMulti(
+      m_surfaceValueEditor, summary->surfaceValueMulti, double(summary->surfaceValue));
+    if (summary->hasColor)
     {
-      if (colorValueMulti)
+      if (summary->colorMulti)
       {
         m_colorEditor->setPlaceholderText("multi");
         m_colorEditor->setText("");
@@ -790,7 +754,8 @@ void FaceAttribsEditor::updateControls()
       else
       {
         m_colorEditor->setPlaceholderText("");
-        m_colorEditor->setText(QString::fromStdString(kdl::str_to_string(*colorValue)));
+        m_colorEditor->setText(
+          QString::fromStdString(kdl::str_to_string(*summary->color)));
       }
     }
     else
@@ -798,13 +763,15 @@ void FaceAttribsEditor::updateControls()
       m_colorEditor->setPlaceholderText("");
       m_colorEditor->setText("");
     }
-    m_surfaceFlagsEditor->setFlagValue(setSurfaceFlags, mixedSurfaceFlags);
-    m_contentFlagsEditor->setFlagValue(setSurfaceContents, mixedSurfaceContents);
-
-    m_surfaceValueUnsetButton->setEnabled(hasSurfaceValue);
-    m_surfaceFlagsUnsetButton->setEnabled(hasSurfaceFlags);
-    m_contentFlagsUnsetButton->setEnabled(hasSurfaceContents);
-    m_colorUnsetButton->setEnabled(hasColorValue);
+    m_surfaceFlagsEditor->setFlagValue(
+      summary->setSurfaceFlags, summary->mixedSurfaceFlags);
+    m_contentFlagsEditor->setFlagValue(
+      summary->setSurfaceContents, summary->mixedSurfaceContents);
+
+    m_surfaceValueUnsetButton->setEnabled(summary->hasSurfaceValue);
+    m_surfaceFlagsUnsetButton->setEnabled(summary->hasSurfaceFlags);
+    m_contentFlagsUnsetButton->setEnabled(summary->hasSurfaceContents);
+    m_colorUnsetButton->setEnabled(summary->hasColor);
   }
   else
   {
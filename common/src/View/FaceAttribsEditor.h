@@ -22,6 +22,7 @@
 #include <QWidget>
 
 #include "NotifierConnection.h"
+#include "View/FaceAttribsSummary.h"
 
 #include <memory>
 #include <vector>
@@ -83,6 +84,7 @@ private:
   QAbstractButton* m_colorUnsetButton{nullptr};
 
   SignalDelayer* m_updateControlsSignalDelayer{nullptr};
+  FaceAttribsSummaryCache m_faceAttribsSummaryCache;
 
   NotifierConnection m_notifierConnection;
 
@@ -0,0 +1,208 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FaceAttribsSummary.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushNode.h"
+
+#include "kdl/parallel.h"
+#include "kdl/reflection_impl.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/vec_io.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom::View
+{
+namespace
+{
+
+void mergeFlags(
+  int& setFlags, int& mixedFlags, const int otherSetFlags, const int otherMixedFlags)
+{
+  const auto allSet = setFlags & otherSetFlags;
+  const auto anySet = setFlags | mixedFlags | otherSetFlags | otherMixedFlags;
+  setFlags = allSet;
+  mixedFlags = anySet & ~allSet;
+}
+
+} // namespace
+
+FaceAttribsSummary FaceAttribsSummary::forFace(const Model::BrushFace& face)
+{
+  const auto& attributes = face.attributes();
+
+  auto result = FaceAttribsSummary{};
+  result.textureName = attributes.textureName();
+  result.texture = face.texture();
+  result.xOffset = attributes.xOffset();
+  result.yOffset = attributes.yOffset();
+  result.rotation = attributes.rotation();
+  result.xScale = attributes.xScale();
+  result.yScale = attributes.yScale();
+  result.surfaceValue = face.resolvedSurfaceValue();
+  result.color = attributes.color();
+  result.hasSurfaceValue = attributes.surfaceValue().has_value();
+  result.hasSurfaceFlags = attributes.surfaceFlags().has_value();
+  result.hasSurfaceContents = attributes.surfaceContents().has_value();
+  result.hasColor = attributes.hasColor();
+  result.setSurfaceFlags = face.resolvedSurfaceFlags();
+  result.setSurfaceContents = face.resolvedSurfaceContents();
+  return result;
+}
+
+void FaceAttribsSummary::merge(const FaceAttribsSummary& other)
+{
+  textureMulti |= other.textureMulti || textureName != other.textureName;
+  xOffsetMulti |= other.xOffsetMulti || xOffset != other.xOffset;
+  yOffsetMulti |= other.yOffsetMulti || yOffset != other.yOffset;
+  rotationMulti |= other.rotationMulti || rotation != other.rotation;
+  xScaleMulti |= other.xScaleMulti || xScale != other.xScale;
+  yScaleMulti |= other.yScaleMulti || yScale != other.yScale;
+  surfaceValueMulti |= other.surfaceValueMulti || surfaceValue != other.surfaceValue;
+  colorMulti |= other.colorMulti || color != other.color;
+
+  hasSurfaceValue |= other.hasSurfaceValue;
+  hasSurfaceFlags |= other.hasSurfaceFlags;
+  hasSurfaceContents |= other.hasSurfaceContents;
+  hasColor |= other.hasColor;
+
+  mergeFlags(
+    setSurfaceFlags, mixedSurfaceFlags, other.setSurfaceFlags, other.mixedSurfaceFlags);
+  mergeFlags(
+    setSurfaceContents,
+    mixedSurfaceContents,
+    other.setSurfaceContents,
+    other.mixedSurfaceContents);
+}
+
+kdl_reflect_impl(FaceAttribsSummary);
+
+bool FaceAttribsSummaryCache::valid() const
+{
+  return m_faceHandles.has_value();
+}
+
+void FaceAttribsSummaryCache::setFaces(std::vector<Model::BrushFaceHandle> faceHandles)
+{
+  const auto chunkCount = (faceHandles.size() + ChunkSize - 1) / ChunkSize;
+
+  m_brushes.clear();
+  for (size_t i = 0; i < faceHandles.size(); ++i)
+  {
+    const auto* brushNode = faceHandles[i].node();
+    auto& brushInfo = m_brushes
+                        .try_emplace(
+                          brushNode, BrushInfo{brushNode->brush().faceCount(), {}})
+                        .first->second;
+
+    const auto chunkIndex = i / ChunkSize;
+    if (brushInfo.chunkIndices.empty() || brushInfo.chunkIndices.back() != chunkIndex)
+    {
+      brushInfo.chunkIndices.push_back(chunkIndex);
+    }
+  }
+
+  m_faceHandles = std::move(faceHandles);
+  m_chunkSummaries = std::vector<FaceAttribsSummary>(chunkCount);
+  m_invalidChunkIndices.clear();
+  for (size_t i = 0; i < chunkCount; ++i)
+  {
+    m_invalidChunkIndices.push_back(i);
+  }
+}
+
+void FaceAttribsSummaryCache::brushesDidChange(
+  const std::vector<Model::BrushNode*>& brushNodes)
+{
+  if (!valid())
+  {
+    return;
+  }
+
+  for (const auto* brushNode : brushNodes)
+  {
+    if (const auto iBrush = m_brushes.find(brushNode); iBrush != m_brushes.end())
+    {
+      const auto& brushInfo = iBrush->second;
+      if (brushInfo.faceCount != brushNode->brush().faceCount())
+      {
+        invalidate();
+        return;
+      }
+
+      m_invalidChunkIndices = kdl::vec_concat(
+        std::move(m_invalidChunkIndices), brushInfo.chunkIndices);
+    }
+  }
+}
+
+void FaceAttribsSummaryCache::invalidate()
+{
+  m_faceHandles = std::nullopt;
+  m_brushes.clear();
+  m_chunkSummaries.clear();
+  m_invalidChunkIndices.clear();
+}
+
+std::optional<FaceAttribsSummary> FaceAttribsSummaryCache::summary()
+{
+  assert(valid());
+
+  updateInvalidChunks();
+  if (m_chunkSummaries.empty())
+  {
+    return std::nullopt;
+  }
+
+  auto result = m_chunkSummaries.front();
+  for (size_t i = 1; i < m_chunkSummaries.size(); ++i)
+  {
+    result.merge(m_chunkSummaries[i]);
+  }
+  return result;
+}
+
+void FaceAttribsSummaryCache::updateInvalidChunks()
+{
+  const auto& faceHandles = *m_faceHandles;
+  const auto chunkIndices =
+    kdl::vec_sort_and_remove_duplicates(std::move(m_invalidChunkIndices));
+  m_invalidChunkIndices.clear();
+
+  kdl::parallel_for(chunkIndices.size(), [&](const size_t i) {
+    const auto chunkIndex = chunkIndices[i];
+    const auto first = chunkIndex * ChunkSize;
+    const auto last = std::min(first + ChunkSize, faceHandles.size());
+
+    auto chunkSummary = FaceAttribsSummary::forFace(faceHandles[first].face());
+    for (auto j = first + 1; j < last; ++j)
+    {
+      chunkSummary.merge(FaceAttribsSummary::forFace(faceHandles[j].face()));
+    }
+    m_chunkSummaries[chunkIndex] = std::move(chunkSummary);
+  });
+}
+
+} // namespace TrenchBroom::View
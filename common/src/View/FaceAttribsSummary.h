@@ -0,0 +1,171 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Color.h"
+#include "Model/BrushFaceHandle.h"
+
+#include "kdl/reflection_decl.h"
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom::Assets
+{
+class Texture;
+}
+
+namespace TrenchBroom::Model
+{
+class BrushFace;
+class BrushNode;
+} // namespace TrenchBroom::Model
+
+namespace TrenchBroom::View
+{
+
+/**
+ * The combined attributes of a set of brush faces as shown by the face attribs editor.
+ *
+ * The values are taken from the first face, and the multi flags indicate whether any
+ * other face has a different value. Summaries can be merged in any grouping as long as
+ * the order of the faces is preserved.
+ */
+struct FaceAttribsSummary
+{
+  std::string textureName;
+  const Assets::Texture* texture = nullptr;
+  float xOffset = 0.0f;
+  float yOffset = 0.0f;
+  float rotation = 0.0f;
+  float xScale = 0.0f;
+  float yScale = 0.0f;
+  float surfaceValue = 0.0f;
+  std::optional<Color> color;
+
+  bool textureMulti = false;
+  bool xOffsetMulti = false;
+  bool yOffsetMulti = false;
+  bool rotationMulti = false;
+  bool xScaleMulti = false;
+  bool yScaleMulti = false;
+  bool surfaceValueMulti = false;
+  bool colorMulti = false;
+
+  bool hasSurfaceValue = false;
+  bool hasSurfaceFlags = false;
+  bool hasSurfaceContents = false;
+  bool hasColor = false;
+
+  int setSurfaceFlags = 0;
+  int mixedSurfaceFlags = 0;
+  int setSurfaceContents = 0;
+  int mixedSurfaceContents = 0;
+
+  static FaceAttribsSummary forFace(const Model::BrushFace& face);
+
+  /**
+   * Merges the given summary of the faces that follow the faces of this summary.
+   */
+  void merge(const FaceAttribsSummary& other);
+
+  kdl_reflect_decl(
+    FaceAttribsSummary,
+    textureName,
+    texture,
+    xOffset,
+    yOffset,
+    rotation,
+    xScale,
+    yScale,
+    surfaceValue,
+    color,
+    textureMulti,
+    xOffsetMulti,
+    yOffsetMulti,
+    rotationMulti,
+    xScaleMulti,
+    yScaleMulti,
+    surfaceValueMulti,
+    colorMulti,
+    hasSurfaceValue,
+    hasSurfaceFlags,
+    hasSurfaceContents,
+    hasColor,
+    setSurfaceFlags,
+    mixedSurfaceFlags,
+    setSurfaceContents,
+    mixedSurfaceContents);
+};
+
+/**
+ * Caches the summary of the selected brush faces.
+ *
+ * The faces are split into chunks of consecutive faces, and the chunks are summarized in
+ * parallel. When some brushes change, only the chunks containing their faces are
+ * summarized again, and the chunk summaries are merged into the summary of all faces.
+ */
+class FaceAttribsSummaryCache
+{
+private:
+  struct BrushInfo
+  {
+    size_t faceCount;
+    std::vector<size_t> chunkIndices;
+  };
+
+  std::optional<std::vector<Model::BrushFaceHandle>> m_faceHandles;
+  std::unordered_map<const Model::BrushNode*, BrushInfo> m_brushes;
+  std::vector<FaceAttribsSummary> m_chunkSummaries;
+  std::vector<size_t> m_invalidChunkIndices;
+
+public:
+  static constexpr size_t ChunkSize = 1024;
+
+  /**
+   * Indicates whether the faces have been set since the cache was last invalidated.
+   */
+  bool valid() const;
+
+  void setFaces(std::vector<Model::BrushFaceHandle> faceHandles);
+
+  /**
+   * Marks the chunks containing faces of the given brushes for updating. If the number
+   * of faces of any of these brushes has changed, the cache is invalidated because the
+   * face handles might not be valid anymore.
+   */
+  void brushesDidChange(const std::vector<Model::BrushNode*>& brushNodes);
+
+  void invalidate();
+
+  /**
+   * Returns the summary of all faces, or an empty optional if there are no faces.
+   *
+   * Expects that the cache is valid.
+   */
+  std::optional<FaceAttribsSummary> summary();
+
+private:
+  void updateInvalidChunks();
+};
+
+} // namespace TrenchBroom::View
@@ -21,13 +21,17 @@
 
 #include "Error.h"
 #include "Exceptions.h"
+#include "IO/SystemPaths.h"
+#include "Macros.h"
 #include "Renderer/FontManager.h"
 #include "Renderer/GL.h"
+#include "Renderer/PickIdBuffer.h"
 #include "Renderer/Shader.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/ShaderProgram.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/Vbo.h"
+#include "StartupTimeline.h"
 
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
@@ -46,7 +50,8 @@ std::string GLContextManager::GLVersion = "unknown";
 
 GLContextManager::GLContextManager()
   : m_initialized(false)
-  , m_shaderManager(std::make_unique<Renderer::ShaderManager>())
+  , m_shaderManager(std::make_unique<Renderer::ShaderManager>(
+      IO::SystemPaths::userDataDirectory() / "shader-cache"))
   , m_vboManager(std::make_unique<Renderer::VboManager>(m_shaderManager.get()))
   , m_fontManager(std::make_unique<Renderer::FontManager>())
 {
@@ -79,12 +84,16 @@ bool GLContextManager::initialize()
   {
     m_initialized = true;
 
+    auto& startupTimeline = StartupTimeline::instance();
+    const auto initializePhase = startupTimeline.phase("Initialize OpenGL");
+
     initializeGlew();
 
     GLVendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
     GLRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
     GLVersion = reinterpret_cast<const char*>(glGetString(GL_VERSION));
 
+    const auto shadersPhase = startupTimeline.phase("Compile shaders");
     kdl::fold_results(kdl::vec_transform(
                         std::vector<Renderer::ShaderConfig>{
                           Grid2DShader,
@@ -114,6 +123,14 @@ bool GLContextManager::initialize()
                         }))
       .transform_error([&](const auto& e) { throw RenderException{e.msg}; });
 
+    // picking with the ID buffer is optional, so the map views check whether the pick ID
+    // shader was loaded instead of failing here
+    if (Renderer::PickIdBuffer::supported())
+    {
+      const auto pickIdShaderResult = m_shaderManager->loadProgram(PickIdShader);
+      unused(pickIdShaderResult);
+    }
+
     return true;
   }
   return false;
@@ -102,7 +102,7 @@ GameListBox::Info GameListBox::makeGameInfo(const std::string& gameName) const
   {
     iconPath = std::filesystem::path{"DefaultGameIcon.svg"};
   }
-  const auto experimental = gameFactory.gameConfig(gameName).experimental;
+  const auto experimental = gameFactory.gameConfigHeader(gameName).experimental;
 
   return Info{
     gameName,
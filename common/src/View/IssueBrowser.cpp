@@ -89,8 +89,8 @@ void IssueBrowser::connectObservers()
     document->nodesWereAddedNotifier.connect(this, &IssueBrowser::nodesWereAdded);
   m_notifierConnection +=
     document->nodesWereRemovedNotifier.connect(this, &IssueBrowser::nodesWereRemoved);
-  m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &IssueBrowser::nodesDidChange);
+  m_notifierConnection += document->batchedNodesDidChangeNotifier.connect(
+    this, &IssueBrowser::nodesDidChange);
   m_notifierConnection += document->brushFacesDidChangeNotifier.connect(
     this, &IssueBrowser::brushFacesDidChange);
 }
@@ -108,22 +108,22 @@ void IssueBrowser::documentWasSaved(MapDocument*)
 
 void IssueBrowser::nodesWereAdded(const std::vector<Model::Node*>&)
 {
-  m_view->reload();
+  m_view->nodesDidChange();
 }
 
-void IssueBrowser::nodesWereRemoved(const std::vector<Model::Node*>&)
+void IssueBrowser::nodesWereRemoved(const std::vector<Model::Node*>& nodes)
 {
-  m_view->reload();
+  m_view->nodesWereRemoved(nodes);
 }
 
 void IssueBrowser::nodesDidChange(const std::vector<Model::Node*>&)
 {
-  m_view->reload();
+  m_view->nodesDidChange();
 }
 
 void IssueBrowser::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&)
 {
-  m_view->reload();
+  m_view->nodesDidChange();
 }
 
 void IssueBrowser::issueIgnoreChanged(Model::Issue*)
@@ -32,16 +32,17 @@
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
 #include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
-#include "View/QtUtils.h"
 
 #include "kdl/memory_utils.h"
-#include "kdl/overload.h"
 #include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -54,6 +55,7 @@ IssueBrowserView::IssueBrowserView(std::weak_ptr<MapDocument> document, QWidget*
   , m_hiddenIssueTypes{0}
   , m_showHiddenIssues{false}
   , m_valid{false}
+  , m_hasInvalidIssues{false}
 {
   createGui();
   bindEvents();
@@ -71,7 +73,11 @@ void IssueBrowserView::createGui()
   m_tableView->horizontalHeader()->setSectionsClickable(false);
   m_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
 
-  autoResizeRows(m_tableView);
+  // rows have a fixed height so that the table only has to lay out the visible rows
+  m_tableView->setWordWrap(false);
+  m_tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  m_tableView->verticalHeader()->setDefaultSectionSize(
+    m_tableView->fontMetrics().lineSpacing() + 2);
 
   auto* layout = new QHBoxLayout{};
   layout->setContentsMargins(0, 0, 0, 0);
@@ -109,6 +115,31 @@ void IssueBrowserView::deselectAll()
   m_tableView->clearSelection();
 }
 
+void IssueBrowserView::nodesWereRemoved(const std::vector<Model::Node*>& nodes)
+{
+  auto removedNodes = std::unordered_set<const Model::Node*>{};
+  for (auto* node : nodes)
+  {
+    node->accept([&](auto&& thisLambda, Model::Node* n) {
+      removedNodes.insert(n);
+      n->visitChildren(thisLambda);
+    });
+  }
+
+  m_tableModel->removeIssues(removedNodes);
+  nodesDidChange();
+}
+
+void IssueBrowserView::nodesDidChange()
+{
+  // the issues of invalid nodes have been destroyed, so their rows must be removed
+  // before the table is painted again
+  m_tableModel->removeInvalidIssues();
+  m_hasInvalidIssues = true;
+
+  QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
+}
+
 /**
  * Updates the MapDocument selection to match the table view
  */
@@ -137,44 +168,49 @@ void IssueBrowserView::updateIssues()
   {
     const auto validators = document->world()->registeredValidators();
 
-    auto issues = std::vector<const Model::Issue*>{};
-    const auto collectIssues = [&](auto* node) {
-      for (auto* issue : node->issues(validators))
+    // validate all invalid nodes in parallel before collecting their issues
+    Model::validateIssues({document->world()}, validators);
+
+    auto nodes = document->world()->allDescendants();
+    nodes.push_back(document->world());
+    m_tableModel->setIssues(filterIssues(nodes, validators));
+  }
+}
+
+void IssueBrowserView::updateInvalidIssues()
+{
+  auto document = kdl::mem_lock(m_document);
+  if (document->world() != nullptr)
+  {
+    const auto validators = document->world()->registeredValidators();
+
+    // only the invalid nodes are validated again, the rows of all other nodes are kept
+    m_tableModel->removeInvalidIssues();
+    const auto invalidNodes = Model::collectNodesWithInvalidIssues({document->world()});
+    Model::validateNodeIssues(invalidNodes, validators);
+
+    m_tableModel->addIssues(filterIssues(invalidNodes, validators));
+  }
+}
+
+std::vector<const Model::Issue*> IssueBrowserView::filterIssues(
+  const std::vector<Model::Node*>& nodes,
+  const std::vector<const Model::Validator*>& validators) const
+{
+  auto issues = std::vector<const Model::Issue*>{};
+  for (auto* node : nodes)
+  {
+    for (const auto* issue : node->issues(validators))
+    {
+      if (
+        m_showHiddenIssues
+        || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0))
       {
-        if (
-          m_showHiddenIssues
-          || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0))
-        {
-          issues.push_back(issue);
-        }
+        issues.push_back(issue);
       }
-    };
-
-    document->world()->accept(kdl::overload(
-      [&](auto&& thisLambda, Model::WorldNode* world) {
-        collectIssues(world);
-        world->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, Model::LayerNode* layer) {
-        collectIssues(layer);
-        layer->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, Model::GroupNode* group) {
-        collectIssues(group);
-        group->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, Model::EntityNode* entity) {
-        collectIssues(entity);
-        entity->visitChildren(thisLambda);
-      },
-      [&](Model::BrushNode* brush) { collectIssues(brush); },
-      [&](Model::PatchNode* patch) { collectIssues(patch); }));
-
-    issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) {
-      return lhs->seqId() > rhs->seqId();
-    });
-    m_tableModel->setIssues(std::move(issues));
+    }
   }
+  return issues;
 }
 
 void IssueBrowserView::applyQuickFix(const Model::IssueQuickFix& quickFix)
@@ -202,7 +238,7 @@ std::vector<const Model::Issue*> IssueBrowserView::collectIssues(
     if (index.isValid())
     {
       const auto row = static_cast<size_t>(index.row());
-      result.insert(m_tableModel->issues().at(row));
+      result.insert(m_tableModel->issue(row));
     }
   }
   return result.release_data();
@@ -223,7 +259,7 @@ std::vector<const Model::IssueQuickFix*> IssueBrowserView::collectQuickFixes(
     {
       continue;
     }
-    const auto* issue = m_tableModel->issues().at(static_cast<size_t>(index.row()));
+    const auto* issue = m_tableModel->issue(static_cast<size_t>(index.row()));
     issueTypes &= issue->type();
   }
 
@@ -245,12 +281,21 @@ Model::IssueType IssueBrowserView::issueTypeMask() const
 void IssueBrowserView::setIssueVisibility(const bool show)
 {
   auto document = kdl::mem_lock(m_document);
-  for (const auto* issue : collectIssues(getSelection()))
+  const auto issues = collectIssues(getSelection());
+  for (const auto* issue : issues)
   {
     document->setIssueHidden(*issue, !show);
   }
 
-  invalidate();
+  if (m_showHiddenIssues)
+  {
+    m_tableModel->issuesDidChange(issues);
+  }
+  else
+  {
+    m_tableModel->removeIssues(
+      kdl::vec_filter(issues, [](const auto* issue) { return issue->hidden(); }));
+  }
 }
 
 QList<QModelIndex> IssueBrowserView::getSelection() const
@@ -327,6 +372,7 @@ void IssueBrowserView::hideIssues()
 void IssueBrowserView::invalidate()
 {
   m_valid = false;
+  m_hasInvalidIssues = false;
   m_tableModel->setIssues({});
 
   QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
@@ -339,6 +385,11 @@ void IssueBrowserView::validate()
     updateIssues();
     m_valid = true;
   }
+  else if (m_hasInvalidIssues)
+  {
+    updateInvalidIssues();
+  }
+  m_hasInvalidIssues = false;
 }
 
 // IssueBrowserModel
@@ -348,21 +399,176 @@ IssueBrowserModel::IssueBrowserModel(QObject* parent)
 {
 }
 
+namespace
+{
+// more runs of rows are updated with a single model reset
+constexpr auto MaxIncrementalRuns = size_t(64);
+
+bool compareSeqIds(const Model::Issue* lhs, const Model::Issue* rhs)
+{
+  return lhs->seqId() > rhs->seqId();
+}
+} // namespace
+
+template <typename P>
+void IssueBrowserModel::removeRowsIf(const P& predicate)
+{
+  // collect the runs of consecutive rows to remove as half open intervals
+  auto runs = std::vector<std::pair<size_t, size_t>>{};
+  for (size_t i = 0; i < m_rows.size(); ++i)
+  {
+    if (predicate(m_rows[i]))
+    {
+      if (!runs.empty() && runs.back().second == i)
+      {
+        ++runs.back().second;
+      }
+      else
+      {
+        runs.emplace_back(i, i + 1);
+      }
+    }
+  }
+
+  if (runs.empty())
+  {
+    return;
+  }
+
+  if (runs.size() > MaxIncrementalRuns)
+  {
+    beginResetModel();
+    m_rows = kdl::vec_erase_if(std::move(m_rows), predicate);
+    endResetModel();
+    return;
+  }
+
+  // remove back to front so that the indices of the remaining runs stay valid
+  for (auto it = runs.rbegin(); it != runs.rend(); ++it)
+  {
+    beginRemoveRows(
+      QModelIndex{}, static_cast<int>(it->first), static_cast<int>(it->second) - 1);
+    m_rows.erase(
+      std::next(m_rows.begin(), static_cast<std::ptrdiff_t>(it->first)),
+      std::next(m_rows.begin(), static_cast<std::ptrdiff_t>(it->second)));
+    endRemoveRows();
+  }
+}
+
 void IssueBrowserModel::setIssues(std::vector<const Model::Issue*> issues)
 {
+  std::sort(issues.begin(), issues.end(), compareSeqIds);
+
   beginResetModel();
-  m_issues = std::move(issues);
+  m_rows = kdl::vec_transform(issues, [](const auto* issue) {
+    return Row{&issue->node(), issue};
+  });
   endResetModel();
 }
 
-const std::vector<const Model::Issue*>& IssueBrowserModel::issues()
+void IssueBrowserModel::addIssues(std::vector<const Model::Issue*> issues)
+{
+  if (issues.empty())
+  {
+    return;
+  }
+
+  const auto compareRows = [](const auto& lhs, const auto& rhs) {
+    return compareSeqIds(lhs.issue, rhs.issue);
+  };
+
+  std::sort(issues.begin(), issues.end(), compareSeqIds);
+  auto rows = kdl::vec_transform(issues, [](const auto* issue) {
+    return Row{&issue->node(), issue};
+  });
+
+  // the new rows that are inserted before the same existing row form a run
+  auto runs = std::vector<std::pair<size_t, size_t>>{};
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    const auto it = std::lower_bound(m_rows.begin(), m_rows.end(), rows[i], compareRows);
+    const auto position = static_cast<size_t>(std::distance(m_rows.begin(), it));
+    if (runs.empty() || runs.back().first != position)
+    {
+      runs.emplace_back(position, i);
+    }
+  }
+
+  if (runs.size() > MaxIncrementalRuns)
+  {
+    auto mergedRows = std::vector<Row>{};
+    mergedRows.reserve(m_rows.size() + rows.size());
+    std::merge(
+      m_rows.begin(),
+      m_rows.end(),
+      rows.begin(),
+      rows.end(),
+      std::back_inserter(mergedRows),
+      compareRows);
+
+    beginResetModel();
+    m_rows = std::move(mergedRows);
+    endResetModel();
+    return;
+  }
+
+  // insert back to front so that the positions of the remaining runs stay valid
+  auto last = rows.size();
+  for (auto it = runs.rbegin(); it != runs.rend(); ++it)
+  {
+    const auto [position, first] = *it;
+    beginInsertRows(
+      QModelIndex{},
+      static_cast<int>(position),
+      static_cast<int>(position + last - first) - 1);
+    m_rows.insert(
+      std::next(m_rows.begin(), static_cast<std::ptrdiff_t>(position)),
+      std::next(rows.begin(), static_cast<std::ptrdiff_t>(first)),
+      std::next(rows.begin(), static_cast<std::ptrdiff_t>(last)));
+    endInsertRows();
+    last = first;
+  }
+}
+
+void IssueBrowserModel::removeIssues(const std::unordered_set<const Model::Node*>& nodes)
+{
+  removeRowsIf([&](const auto& row) { return nodes.count(row.node) > 0; });
+}
+
+void IssueBrowserModel::removeIssues(const std::vector<const Model::Issue*>& issues)
+{
+  const auto issueSet =
+    std::unordered_set<const Model::Issue*>{issues.begin(), issues.end()};
+  removeRowsIf([&](const auto& row) { return issueSet.count(row.issue) > 0; });
+}
+
+void IssueBrowserModel::removeInvalidIssues()
+{
+  removeRowsIf([](const auto& row) { return !row.node->issuesValid(); });
+}
+
+void IssueBrowserModel::issuesDidChange(const std::vector<const Model::Issue*>& issues)
+{
+  const auto issueSet =
+    std::unordered_set<const Model::Issue*>{issues.begin(), issues.end()};
+  for (size_t i = 0; i < m_rows.size(); ++i)
+  {
+    if (issueSet.count(m_rows[i].issue) > 0)
+    {
+      const auto row = static_cast<int>(i);
+      emit dataChanged(index(row, 0), index(row, 1));
+    }
+  }
+}
+
+const Model::Issue* IssueBrowserModel::issue(const size_t row) const
 {
-  return m_issues;
+  return m_rows.at(row).issue;
 }
 
 int IssueBrowserModel::rowCount(const QModelIndex& parent) const
 {
-  return parent.isValid() ? 0 : static_cast<int>(m_issues.size());
+  return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
 }
 
 int IssueBrowserModel::columnCount(const QModelIndex& parent) const
@@ -374,13 +580,13 @@ QVariant IssueBrowserModel::data(const QModelIndex& index, const int role) const
 {
   if (
     !index.isValid() || index.row() < 0
-    || index.row() >= static_cast<int>(m_issues.size()) || index.column() < 0
+    || index.row() >= static_cast<int>(m_rows.size()) || index.column() < 0
     || index.column() >= 2)
   {
     return QVariant{};
   }
 
-  const auto* issue = m_issues.at(static_cast<size_t>(index.row()));
+  const auto* issue = m_rows.at(static_cast<size_t>(index.row())).issue;
 
   if (role == Qt::DisplayRole)
   {
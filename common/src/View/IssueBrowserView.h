@@ -25,6 +25,7 @@
 #include "Model/IssueType.h"
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 class QWidget;
@@ -36,6 +37,8 @@ namespace Model
 {
 class Issue;
 class IssueQuickFix;
+class Node;
+class Validator;
 } // namespace Model
 
 namespace View
@@ -53,6 +56,7 @@ private:
   bool m_showHiddenIssues;
 
   bool m_valid;
+  bool m_hasInvalidIssues;
 
   QTableView* m_tableView;
   IssueBrowserModel* m_tableModel;
@@ -71,8 +75,24 @@ public:
   void reload();
   void deselectAll();
 
+  /**
+   * Removes the rows of the issues of the given nodes and their descendants.
+   */
+  void nodesWereRemoved(const std::vector<Model::Node*>& nodes);
+
+  /**
+   * Removes the rows of the issues that were invalidated by a change to the map. The
+   * invalid nodes are validated again and their new issues are added once control
+   * returns to the event loop.
+   */
+  void nodesDidChange();
+
 private:
   void updateIssues();
+  void updateInvalidIssues();
+  std::vector<const Model::Issue*> filterIssues(
+    const std::vector<Model::Node*>& nodes,
+    const std::vector<const Model::Validator*>& validators) const;
 
   std::vector<const Model::Issue*> collectIssues(const QList<QModelIndex>& indices) const;
   std::vector<const Model::IssueQuickFix*> collectQuickFixes(
@@ -98,20 +118,42 @@ public slots:
 };
 
 /**
- * Trivial QAbstractTableModel subclass, when the issues list changes,
- * it just refreshes the entire list with beginResetModel()/endResetModel().
+ * Table model of the issues sorted by descending sequence id, i.e. newest issues first.
+ *
+ * Issues are added and removed in contiguous runs of rows so that the view only has to
+ * update the affected rows. If an update touches too many runs, the model is reset
+ * instead.
+ *
+ * Every row also stores the node of its issue, because the issues of a node are destroyed
+ * when the node is invalidated, and their rows must be removed without accessing them.
  */
 class IssueBrowserModel : public QAbstractTableModel
 {
   Q_OBJECT
 private:
-  std::vector<const Model::Issue*> m_issues;
+  struct Row
+  {
+    const Model::Node* node;
+    const Model::Issue* issue;
+  };
+
+  std::vector<Row> m_rows;
 
 public:
   explicit IssueBrowserModel(QObject* parent);
 
   void setIssues(std::vector<const Model::Issue*> issues);
-  const std::vector<const Model::Issue*>& issues();
+  void addIssues(std::vector<const Model::Issue*> issues);
+  void removeIssues(const std::unordered_set<const Model::Node*>& nodes);
+  void removeIssues(const std::vector<const Model::Issue*>& issues);
+  void removeInvalidIssues();
+  void issuesDidChange(const std::vector<const Model::Issue*>& issues);
+
+  const Model::Issue* issue(size_t row) const;
+
+private:
+  template <typename P>
+  void removeRowsIf(const P& predicate);
 
 public: // QAbstractTableModel overrides
   int rowCount(const QModelIndex& parent) const override;
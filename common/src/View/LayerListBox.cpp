@@ -28,6 +28,7 @@
 #include <QtGlobal>
 
 #include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 #include "View/QtUtils.h"
@@ -35,6 +36,8 @@
 
 #include "kdl/memory_utils.h"
 
+#include <unordered_set>
+
 namespace TrenchBroom
 {
 namespace View
@@ -212,8 +215,8 @@ void LayerListBox::connectObservers()
     document->nodesWereAddedNotifier.connect(this, &LayerListBox::nodesDidChange);
   m_notifierConnection +=
     document->nodesWereRemovedNotifier.connect(this, &LayerListBox::nodesDidChange);
-  m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &LayerListBox::nodesDidChange);
+  m_notifierConnection += document->batchedNodesDidChangeNotifier.connect(
+    this, &LayerListBox::nodesDidChange);
   m_notifierConnection += document->nodeVisibilityDidChangeNotifier.connect(
     this, &LayerListBox::nodesDidChange);
   m_notifierConnection +=
@@ -225,11 +228,38 @@ void LayerListBox::documentDidChange(MapDocument*)
   reload();
 }
 
-void LayerListBox::nodesDidChange(const std::vector<Model::Node*>&)
+void LayerListBox::nodesDidChange(const std::vector<Model::Node*>& nodes)
 {
-  const auto documentLayers = kdl::mem_lock(m_document)->world()->allLayersUserSorted();
+  auto document = kdl::mem_lock(m_document);
+  const auto* world = document->world();
 
-  if (layers() != documentLayers)
+  auto changedLayers = std::unordered_set<const Model::Node*>{};
+  auto layersChanged = false;
+  for (auto* node : nodes)
+  {
+    if (node == world)
+    {
+      // a layer was added or removed
+      layersChanged = true;
+    }
+    else if (node->parent() == world)
+    {
+      // a layer was modified
+      changedLayers.insert(node);
+      layersChanged = true;
+    }
+    else if (changedLayers.size() < size_t(count()))
+    {
+      if (const auto* layerNode = Model::findContainingLayer(node))
+      {
+        changedLayers.insert(layerNode);
+        // a removed layer has no parent
+        layersChanged |= layerNode == node;
+      }
+    }
+  }
+
+  if (layersChanged && layers() != world->allLayersUserSorted())
   {
     // A layer was added or removed or modified, so we need to clear and repopulate the
     // list
@@ -238,7 +268,15 @@ void LayerListBox::nodesDidChange(const std::vector<Model::Node*>&)
     setSelectedLayer(previouslySelectedLayer);
     return;
   }
-  updateItems();
+
+  // only update the rows of the layers that contain changed nodes
+  for (int i = 0; i < count(); ++i)
+  {
+    if (changedLayers.count(layerForRow(i)) > 0)
+    {
+      renderer(i)->updateItem();
+    }
+  }
 }
 
 void LayerListBox::currentLayerDidChange(const Model::LayerNode*)
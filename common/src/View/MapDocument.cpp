@@ -19,6 +19,7 @@
 
 #include "View/MapDocument.h"
 
+#include "Assets/AssetReference.h"
 #include "Assets/AssetUtils.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/EntityDefinitionFileSpec.h"
@@ -27,15 +28,22 @@
 #include "Assets/EntityModelManager.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureManager.h"
+#include "CollectingLogger.h"
 #include "EL/ELExceptions.h"
 #include "Error.h"
 #include "Exceptions.h"
+#include "IO/BinaryNodeSerializer.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
 #include "IO/ExportOptions.h"
+#include "IO/File.h"
 #include "IO/GameConfigParser.h"
+#include "IO/Gzip.h"
+#include "IO/NodeReader.h"
+#include "IO/NodeWriter.h"
 #include "IO/PathInfo.h"
 #include "IO/SimpleParserStatus.h"
+#include "IO/StandardMapParser.h"
 #include "IO/SystemPaths.h"
 #include "Model/BezierPatch.h"
 #include "Model/Brush.h"
@@ -44,67 +52,58 @@
 #include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
+#include "Model/DefaultValidators.h"
 #include "Model/EditorContext.h"
-#include "Model/EmptyBrushEntityValidator.h"
-#include "Model/EmptyGroupValidator.h"
-#include "Model/EmptyPropertyKeyValidator.h"
-#include "Model/EmptyPropertyValueValidator.h"
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
 #include "Model/EntityProperties.h"
+#include "Model/FilePositionIndex.h"
 #include "Model/Game.h"
 #include "Model/GameFactory.h"
 #include "Model/GroupNode.h"
-#include "Model/InvalidTextureScaleValidator.h"
 #include "Model/LayerNode.h"
-#include "Model/LinkSourceValidator.h"
-#include "Model/LinkTargetValidator.h"
 #include "Model/LinkedGroupUtils.h"
 #include "Model/LockState.h"
-#include "Model/LongPropertyKeyValidator.h"
-#include "Model/LongPropertyValueValidator.h"
-#include "Model/MissingClassnameValidator.h"
-#include "Model/MissingDefinitionValidator.h"
-#include "Model/MissingModValidator.h"
-#include "Model/MixedBrushContentsValidator.h"
 #include "Model/ModelUtils.h"
 #include "Model/Node.h"
 #include "Model/NodeContents.h"
 #include "Model/NodeQueries.h"
-#include "Model/NonIntegerVerticesValidator.h"
 #include "Model/PatchNode.h"
-#include "Model/PointEntityWithBrushesValidator.h"
 #include "Model/Polyhedron.h"
 #include "Model/Polyhedron3.h"
-#include "Model/PropertyKeyWithDoubleQuotationMarksValidator.h"
-#include "Model/PropertyValueWithDoubleQuotationMarksValidator.h"
-#include "Model/SoftMapBoundsValidator.h"
 #include "Model/TagManager.h"
+#include "Model/TexCoordSystem.h"
+#include "Model/TextureNodeIndex.h"
 #include "Model/VisibilityState.h"
-#include "Model/WorldBoundsValidator.h"
 #include "Model/WorldNode.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Uuid.h"
 #include "View/Actions.h"
 #include "View/AddRemoveNodesCommand.h"
 #include "View/BrushVertexCommands.h"
+#include "View/ChangeJournal.h"
 #include "View/CurrentGroupCommand.h"
 #include "View/Grid.h"
 #include "View/MapTextEncoding.h"
 #include "View/PasteType.h"
 #include "View/ReparentNodesCommand.h"
 #include "View/RepeatStack.h"
+#include "View/Selection.h"
 #include "View/SelectionCommand.h"
 #include "View/SetCurrentLayerCommand.h"
 #include "View/SetLinkIdsCommand.h"
 #include "View/SetLockStateCommand.h"
 #include "View/SetVisibilityCommand.h"
+#include "View/SwapBrushFaceAttributesCommand.h"
 #include "View/SwapNodeContentsCommand.h"
+#include "View/TaskScheduler.h"
 #include "View/TransactionScope.h"
 #include "View/UpdateLinkedGroupsCommand.h"
 #include "View/UpdateLinkedGroupsHelper.h"
 #include "View/ViewEffectsService.h"
+#include "octree.h"
 
 #include "kdl/collection_utils.h"
 #include "kdl/grouped_range.h"
@@ -126,12 +125,18 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib> // for std::abs
+#include <future>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom::View
@@ -303,12 +308,40 @@ bool applyAndSwap(
   return false;
 }
 
+/**
+ * Applies the given lambda to a copy of each of the given brushes in parallel and returns
+ * pairs of the modified copies and the lambda's results, in the order of the given brush
+ * nodes.
+ *
+ * The lambda L needs to accept a brush:
+ * - R operator()(Model::Brush&);
+ *
+ * Since the lambda runs on multiple threads, it must not access any shared mutable state,
+ * such as the logger or the preferences. Any errors it returns must be logged by the
+ * caller afterwards.
+ */
+template <typename L>
+auto applyToBrushesInParallel(const std::vector<Model::BrushNode*>& brushNodes, L lambda)
+{
+  using R = decltype(lambda(std::declval<Model::Brush&>()));
+
+  // every face is copied, so the texture usage counts are only updated once at the end
+  auto textureUsageCounts = Assets::AssetUsageCountBatch<Assets::Texture>{};
+  return kdl::vec_parallel_transform(brushNodes, [&](const Model::BrushNode* brushNode) {
+    const auto activation = textureUsageCounts.activate();
+    auto brush = brushNode->brush();
+    auto result = lambda(brush);
+    return std::pair<Model::Brush, R>{std::move(brush), std::move(result)};
+  });
+}
+
 /**
  * Applies the given lambda to a copy of each of the given faces.
  *
  * Specifically, each brush node of the given faces has its contents copied and the lambda
- * applied to the copied faces. If the lambda succeeds for each face, the node contents
- * are subsequently swapped.
+ * applied to the copied faces. If the lambda succeeds for each face, the attributes of
+ * the changed faces are subsequently swapped. The lambda must only change the texturing
+ * state of the faces, that is, their attributes and texture coordinate systems.
  *
  * The lambda L needs to accept brush faces:
  * - bool operator()(Model::BrushFace&);
@@ -352,18 +385,29 @@ bool applyAndSwap(
 
   if (success)
   {
-    auto newNodes = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
-    newNodes.reserve(brushes.size());
+    auto faceIndices = std::unordered_map<Model::BrushNode*, std::vector<size_t>>{};
+    for (const auto& faceHandle : faces)
+    {
+      faceIndices[faceHandle.node()].push_back(faceHandle.faceIndex());
+    }
+
+    auto newFaces = BrushFaceAttributesStates{};
+    newFaces.reserve(brushes.size());
 
     for (auto& [brushNode, brush] : brushes)
     {
-      newNodes.emplace_back(brushNode, Model::NodeContents(std::move(brush)));
+      auto faceStates = std::vector<BrushFaceAttributesState>{};
+      for (const auto faceIndex :
+           kdl::vec_sort_and_remove_duplicates(std::move(faceIndices[brushNode])))
+      {
+        const auto& face = brush.face(faceIndex);
+        faceStates.push_back(BrushFaceAttributesState{
+          faceIndex, face.attributes(), face.takeTexCoordSystemSnapshot()});
+      }
+      newFaces.emplace_back(brushNode, std::move(faceStates));
     }
 
-    auto changedLinkedGroups = collectContainingGroups(
-      kdl::vec_transform(newNodes, [](const auto& p) { return p.first; }));
-    document.swapNodeContents(
-      commandName, std::move(newNodes), std::move(changedLinkedGroups));
+    success = document.swapBrushFaceAttributes(commandName, std::move(newFaces));
   }
 
   return success;
@@ -393,7 +437,13 @@ MapDocument::MapDocument()
   , m_selectionBoundsValid(true)
   , m_viewEffectsService(nullptr)
   , m_repeatStack(std::make_unique<RepeatStack>())
+  , m_changeJournal(std::make_unique<ChangeJournal>())
+  , m_taskScheduler(std::make_unique<TaskScheduler>(*this))
 {
+  m_textureManager->setCompressTextures(pref(Preferences::CompressTextures));
+  m_textureManager->setLoadTexturesOnDemand(pref(Preferences::LoadTexturesOnDemand));
+  updateTextureCacheDirectory();
+  updateModelCacheDirectory();
   connectObservers();
 }
 
@@ -612,14 +662,20 @@ Result<void> MapDocument::loadDocument(
   doClearCommandProcessor();
   clearDocument();
 
-  return loadWorld(mapFormat, worldBounds, game, path).transform([&]() {
-    loadAssets();
-    registerValidators();
-    registerSmartTags();
-    createTagActions();
+  // the entity definitions are loaded while the map is being parsed and joined before
+  // they are bound to the entities
+  prefetchEntityDefinitions(game, path);
 
-    documentWasLoadedNotifier(this);
-  });
+  return loadWorld(mapFormat, worldBounds, game, path)
+    .transform([&]() {
+      loadAssets();
+      registerValidators();
+      registerSmartTags();
+      createTagActions();
+
+      documentWasLoadedNotifier(this);
+    })
+    .if_error([&](const auto&) { m_pendingEntityDefinitions.reset(); });
 }
 
 void MapDocument::saveDocument()
@@ -660,7 +716,9 @@ void MapDocument::clearDocument()
   {
     documentWillBeClearedNotifier(this);
 
+    m_taskScheduler->cancelAll();
     m_editorContext->reset();
+    m_texturePreview.reset();
     clearSelection();
     unloadAssets();
     clearTagActions();
@@ -692,6 +750,16 @@ std::string MapDocument::serializeSelectedBrushFaces()
   return stream.str();
 }
 
+std::string MapDocument::serializeSelectedNodesBinary()
+{
+  std::stringstream stream;
+  auto writer = IO::NodeWriter{
+    *m_world,
+    std::make_unique<IO::BinaryNodeSerializer>(m_world->mapFormat(), stream)};
+  writer.writeNodes(m_selectedNodes.nodes());
+  return stream.str();
+}
+
 PasteType MapDocument::paste(const std::string& str)
 {
   // Try parsing as entities, then as brushes, in all compatible formats
@@ -723,6 +791,22 @@ PasteType MapDocument::paste(const std::string& str)
   return PasteType::Failed;
 }
 
+PasteType MapDocument::pasteBinary(const std::string& data)
+{
+  auto parserStatus = IO::SimpleParserStatus{logger()};
+  const auto nodes = IO::NodeReader::readBinary(
+    data,
+    m_world->mapFormat(),
+    m_worldBounds,
+    m_world->entityPropertyConfig(),
+    parserStatus);
+  if (!nodes.empty() && pasteNodes(nodes))
+  {
+    return PasteType::Node;
+  }
+  return PasteType::Failed;
+}
+
 namespace
 {
 
@@ -1210,6 +1294,24 @@ const std::string& MapDocument::currentTextureName() const
   return m_currentTextureName;
 }
 
+const std::optional<vm::mat4x4>& MapDocument::selectionPreviewTransformation() const
+{
+  return m_selectionPreviewTransformation;
+}
+
+void MapDocument::setSelectionPreviewTransformation(
+  std::optional<vm::mat4x4> transformation)
+{
+  m_selectionPreviewTransformation = std::move(transformation);
+}
+
+vm::bbox3 MapDocument::selectionPreviewBounds() const
+{
+  return m_selectionPreviewTransformation
+           ? selectionBounds().transform(*m_selectionPreviewTransformation)
+           : selectionBounds();
+}
+
 void MapDocument::setCurrentTextureName(const std::string& currentTextureName)
 {
   if (m_currentTextureName != currentTextureName)
@@ -1256,8 +1358,7 @@ void MapDocument::selectSiblings()
 void MapDocument::selectTouching(const bool del)
 {
   const auto nodes = kdl::vec_filter(
-    Model::collectTouchingNodes(
-      std::vector<Model::Node*>{m_world.get()}, m_selectedNodes.brushes()),
+    Model::collectTouchingNodes(*m_world, m_selectedNodes.brushes()),
     [&](Model::Node* node) { return m_editorContext->selectable(node); });
 
   auto transaction = Transaction{*this, "Select Touching"};
@@ -1276,8 +1377,7 @@ void MapDocument::selectTouching(const bool del)
 void MapDocument::selectInside(const bool del)
 {
   const auto nodes = kdl::vec_filter(
-    Model::collectContainedNodes(
-      std::vector<Model::Node*>{m_world.get()}, m_selectedNodes.brushes()),
+    Model::collectContainedNodes(*m_world, m_selectedNodes.brushes()),
     [&](Model::Node* node) { return m_editorContext->selectable(node); });
 
   auto transaction = Transaction{*this, "Select Inside"};
@@ -1339,12 +1439,19 @@ void MapDocument::selectNodesWithFilePosition(const std::vector<size_t>& positio
     });
   };
 
+  // only visit the children whose file position contains one of the given lines
+  const auto& index = filePositionIndex();
+  const auto visitChildrenWithFilePosition = [&](const auto& lambda, Model::Node* node) {
+    Model::Node::visitAll(index.findChildren(*node, positions), lambda);
+  };
+
   m_world->accept(kdl::overload(
     [&](auto&& thisLambda, Model::WorldNode* worldNode) {
+      // the default layer has no file position of its own
       worldNode->visitChildren(thisLambda);
     },
     [&](auto&& thisLambda, Model::LayerNode* layerNode) {
-      layerNode->visitChildren(thisLambda);
+      visitChildrenWithFilePosition(thisLambda, layerNode);
     },
     [&](auto&& thisLambda, Model::GroupNode* groupNode) {
       if (hasFilePosition(groupNode))
@@ -1355,7 +1462,7 @@ void MapDocument::selectNodesWithFilePosition(const std::vector<size_t>& positio
         }
         else
         {
-          groupNode->visitChildren(thisLambda);
+          visitChildrenWithFilePosition(thisLambda, groupNode);
         }
       }
     },
@@ -1369,7 +1476,7 @@ void MapDocument::selectNodesWithFilePosition(const std::vector<size_t>& positio
         else
         {
           const auto previousCount = nodesToSelect.size();
-          entityNode->visitChildren(thisLambda);
+          visitChildrenWithFilePosition(thisLambda, entityNode);
           if (previousCount == nodesToSelect.size())
           {
             // no child was selected, select all children
@@ -1424,9 +1531,9 @@ void MapDocument::convertToFaceSelection()
 void MapDocument::selectFacesWithTexture(const Assets::Texture* texture)
 {
   const auto faces = kdl::vec_filter(
-    Model::collectSelectableBrushFaces(
-      std::vector<Model::Node*>{m_world.get()}, *m_editorContext),
-    [&](const auto& faceHandle) { return faceHandle.face().texture() == texture; });
+    m_world->textureNodeIndex().findBrushFaces(texture), [&](const auto& faceHandle) {
+      return m_editorContext->selectable(faceHandle.node(), faceHandle.face());
+    });
 
   auto transaction = Transaction{*this, "Select Faces with Texture"};
   deselectAll();
@@ -1479,7 +1586,7 @@ void MapDocument::selectTall(const vm::axis::type cameraAxis)
 
       const auto nodesToSelect = kdl::vec_filter(
         Model::collectContainedNodes(
-          {world()},
+          *world(),
           kdl::vec_transform(tallBrushes, [](const auto& b) { return b.get(); })),
         [&](const auto* node) { return editorContext().selectable(node); });
       selectNodes(nodesToSelect);
@@ -1525,6 +1632,45 @@ void MapDocument::invalidateSelectionBounds()
   m_selectionBoundsValid = false;
 }
 
+void MapDocument::addToSelectionBounds(const std::vector<Model::Node*>& nodes)
+{
+  if (m_selectionBoundsValid && !nodes.empty())
+  {
+    const auto bounds = computeLogicalBounds(nodes);
+    const auto hadSelection = m_selectedNodes.nodes().size() > nodes.size();
+    m_selectionBounds = hadSelection ? vm::merge(m_selectionBounds, bounds) : bounds;
+  }
+}
+
+void MapDocument::updateSelectionBounds(
+  const std::vector<Model::Node*>& nodes, const std::vector<vm::bbox3>& oldBounds)
+{
+  assert(nodes.size() == oldBounds.size());
+
+  for (size_t i = 0; i < nodes.size() && m_selectionBoundsValid; ++i)
+  {
+    if (!Model::updateUnitedBounds(
+          m_selectionBounds, oldBounds[i], nodes[i]->logicalBounds()))
+    {
+      invalidateSelectionBounds();
+    }
+  }
+}
+
+const Model::FilePositionIndex& MapDocument::filePositionIndex() const
+{
+  if (!m_filePositionIndex)
+  {
+    m_filePositionIndex = std::make_unique<Model::FilePositionIndex>(*m_world);
+  }
+  return *m_filePositionIndex;
+}
+
+void MapDocument::invalidateFilePositionIndex()
+{
+  m_filePositionIndex.reset();
+}
+
 void MapDocument::validateSelectionBounds() const
 {
   m_selectionBounds = computeLogicalBounds(m_selectedNodes.nodes());
@@ -1819,16 +1965,29 @@ void MapDocument::duplicateObjects()
   auto nodesToSelect = std::vector<Model::Node*>{};
   auto newParentMap = std::map<Model::Node*, Model::Node*>{};
 
-  for (auto* original : selectedNodes().nodes())
-  {
-    auto* suggestedParent = parentForNodes({original});
-
+  const auto& originals = selectedNodes().nodes();
+  const auto setLinkIds = kdl::vec_transform(originals, [&](const auto* original) {
     const auto isLinkedGroup =
       dynamic_cast<const Model::GroupNode*>(original) != nullptr
       && Model::collectLinkedNodes({m_world.get()}, *original).size() > 1;
-    const auto setLinkIds =
-      isLinkedGroup ? Model::SetLinkId::keep : Model::SetLinkId::generate;
-    auto* clone = original->cloneRecursively(m_worldBounds, setLinkIds);
+    return isLinkedGroup ? Model::SetLinkId::keep : Model::SetLinkId::generate;
+  });
+
+  // cloning copies every brush and patch of the selection, so do it in parallel
+  auto clones = std::vector<Model::Node*>(originals.size(), nullptr);
+  {
+    auto textureUsageCounts = Assets::AssetUsageCountBatch<Assets::Texture>{};
+    kdl::parallel_for(originals.size(), [&](const size_t i) {
+      const auto activation = textureUsageCounts.activate();
+      clones[i] = originals[i]->cloneRecursively(m_worldBounds, setLinkIds[i]);
+    });
+  }
+
+  for (size_t i = 0; i < originals.size(); ++i)
+  {
+    auto* original = originals[i];
+    auto* clone = clones[i];
+    auto* suggestedParent = parentForNodes({original});
 
     if (shouldCloneParentWhenCloningNode(original))
     {
@@ -1845,7 +2004,7 @@ void MapDocument::duplicateObjects()
       else
       {
         // parent was not cloned yet
-        newParent = parent->clone(m_worldBounds, setLinkIds);
+        newParent = parent->clone(m_worldBounds, setLinkIds[i]);
         newParentMap.insert({parent, newParent});
         nodesToAdd[suggestedParent].push_back(newParent);
       }
@@ -2833,6 +2992,31 @@ bool MapDocument::swapNodeContents(
     commandName, std::move(nodesToSwap), std::move(changedLinkedGroups));
 }
 
+bool MapDocument::swapBrushFaceAttributes(
+  const std::string& commandName, BrushFaceAttributesStates faces)
+{
+  auto changedLinkedGroups = collectContainingGroups(kdl::vec_transform(
+    faces, [](const auto& p) { return p.first; }));
+
+  if (!checkLinkedGroupsToUpdate(changedLinkedGroups))
+  {
+    return false;
+  }
+
+  auto transaction = Transaction{*this};
+  const auto result = executeAndStore(
+    std::make_unique<SwapBrushFaceAttributesCommand>(commandName, std::move(faces)));
+
+  if (!result->success())
+  {
+    transaction.cancel();
+    return false;
+  }
+
+  setHasPendingChanges(changedLinkedGroups, true);
+  return transaction.commit();
+}
+
 bool MapDocument::transformObjects(
   const std::string& commandName, const vm::mat4x4& transformation)
 {
@@ -2886,42 +3070,53 @@ bool MapDocument::transformObjects(
   using TransformResult = Result<std::pair<Model::Node*, Model::NodeContents>>;
 
   const bool lockTexturesPref = pref(Preferences::TextureLock);
-  auto transformResults = kdl::vec_parallel_transform(
-    nodesToTransform, [&](Model::Node* node) -> TransformResult {
-      return node->accept(kdl::overload(
-        [&](Model::WorldNode*) -> TransformResult {
-          ensure(false, "Unexpected world node");
-        },
-        [&](Model::LayerNode*) -> TransformResult {
-          ensure(false, "Unexpected layer node");
-        },
-        [&](Model::GroupNode* groupNode) -> TransformResult {
-          auto group = groupNode->group();
-          group.transform(transformation);
-          return std::make_pair(groupNode, Model::NodeContents{std::move(group)});
-        },
-        [&](Model::EntityNode* entityNode) -> TransformResult {
-          auto entity = entityNode->entity();
-          entity.transform(m_world->entityPropertyConfig(), transformation);
-          return std::make_pair(entityNode, Model::NodeContents{std::move(entity)});
-        },
-        [&](Model::BrushNode* brushNode) -> TransformResult {
-          const bool lockTextures =
-            lockTexturesPref
-            || Model::collectLinkedNodes({m_world.get()}, *brushNode).size() > 1;
-
-          auto brush = brushNode->brush();
-          return brush.transform(m_worldBounds, transformation, lockTextures)
-            .and_then([&]() -> TransformResult {
-              return std::make_pair(brushNode, Model::NodeContents{std::move(brush)});
-            });
-        },
-        [&](Model::PatchNode* patchNode) -> TransformResult {
-          auto patch = patchNode->patch();
-          patch.transform(transformation);
-          return std::make_pair(patchNode, Model::NodeContents{std::move(patch)});
-        }));
-    });
+
+  // invert the transformation once for all brush faces rather than once per face
+  const auto texCoordSystemTransformation =
+    Model::TexCoordSystemTransformation{transformation};
+
+  auto transformResults = [&]() {
+    // every brush is copied, so the texture usage counts are only updated once at the end
+    auto textureUsageCounts = Assets::AssetUsageCountBatch<Assets::Texture>{};
+    return kdl::vec_parallel_transform(
+      nodesToTransform, [&](Model::Node* node) -> TransformResult {
+        const auto activation = textureUsageCounts.activate();
+        return node->accept(kdl::overload(
+          [&](Model::WorldNode*) -> TransformResult {
+            ensure(false, "Unexpected world node");
+          },
+          [&](Model::LayerNode*) -> TransformResult {
+            ensure(false, "Unexpected layer node");
+          },
+          [&](Model::GroupNode* groupNode) -> TransformResult {
+            auto group = groupNode->group();
+            group.transform(transformation);
+            return std::make_pair(groupNode, Model::NodeContents{std::move(group)});
+          },
+          [&](Model::EntityNode* entityNode) -> TransformResult {
+            auto entity = entityNode->entity();
+            entity.transform(m_world->entityPropertyConfig(), transformation);
+            return std::make_pair(entityNode, Model::NodeContents{std::move(entity)});
+          },
+          [&](Model::BrushNode* brushNode) -> TransformResult {
+            const bool lockTextures =
+              lockTexturesPref
+              || Model::collectLinkedNodes({m_world.get()}, *brushNode).size() > 1;
+
+            auto brush = brushNode->brush();
+            return brush
+              .transform(m_worldBounds, texCoordSystemTransformation, lockTextures)
+              .and_then([&]() -> TransformResult {
+                return std::make_pair(brushNode, Model::NodeContents{std::move(brush)});
+              });
+          },
+          [&](Model::PatchNode* patchNode) -> TransformResult {
+            auto patch = patchNode->patch();
+            patch.transform(transformation);
+            return std::make_pair(patchNode, Model::NodeContents{std::move(patch)});
+          }));
+      });
+  }();
 
   return kdl::fold_results(std::move(transformResults))
     .and_then([&](auto nodesToUpdate) -> Result<bool> {
@@ -3092,6 +3287,100 @@ bool MapDocument::csgConvexMerge()
     .is_success();
 }
 
+namespace
+{
+/**
+ * A brush to subtract from, together with the brushes that intersect it and are
+ * subtracted from it.
+ */
+struct Minuend
+{
+  Model::BrushNode* node;
+  std::vector<const Model::Brush*> subtrahends;
+};
+
+/**
+ * Finds the selectable brushes that intersect any of the given subtrahends. Candidates
+ * are taken from the world's node tree, so only brushes near a subtrahend are tested.
+ *
+ * The intersection test expands the geometry of every minuend and every subtrahend that
+ * it returns, so the brushes can be subtracted on multiple threads afterwards.
+ */
+std::vector<Minuend> findMinuends(
+  const Model::WorldNode& world,
+  const Model::EditorContext& editorContext,
+  const std::vector<Model::BrushNode*>& subtrahendNodes)
+{
+  auto result = std::vector<Minuend>{};
+  auto minuendIndices = std::unordered_map<const Model::BrushNode*, size_t>{};
+
+  for (const auto* subtrahendNode : subtrahendNodes)
+  {
+    const auto& subtrahend = subtrahendNode->brush();
+    for (auto* candidate : world.nodeTree().find_intersectors(subtrahend.bounds()))
+    {
+      candidate->accept(kdl::overload(
+        [](Model::WorldNode*) {},
+        [](Model::LayerNode*) {},
+        [](Model::GroupNode*) {},
+        [](Model::EntityNode*) {},
+        [&](Model::BrushNode* minuendNode) {
+          if (
+            !kdl::vec_contains(subtrahendNodes, minuendNode)
+            && editorContext.selectable(minuendNode)
+            && minuendNode->brush().intersects(subtrahend))
+          {
+            const auto [it, inserted] =
+              minuendIndices.emplace(minuendNode, result.size());
+            if (inserted)
+            {
+              result.push_back(Minuend{minuendNode, {}});
+            }
+            result[it->second].subtrahends.push_back(&subtrahend);
+          }
+        },
+        [](Model::PatchNode*) {}));
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Intersects adjacent pairs of the given brushes in parallel until only one brush is
+ * left. The faces of the result are in the same order as if the brushes had been
+ * intersected one after another.
+ */
+Result<Model::Brush> intersectBrushes(
+  std::vector<Model::Brush> brushes, const vm::bbox3& worldBounds)
+{
+  assert(!brushes.empty());
+  if (brushes.size() == 1u)
+  {
+    return std::move(brushes.front());
+  }
+
+  auto pairIndices = std::vector<size_t>(brushes.size() / 2u);
+  std::iota(pairIndices.begin(), pairIndices.end(), size_t(0));
+
+  return kdl::fold_results(
+           kdl::vec_parallel_transform(
+             std::move(pairIndices),
+             [&](const size_t i) {
+               return brushes[2u * i].intersect(worldBounds, brushes[2u * i + 1u]);
+             }))
+    .and_then([&]() {
+      auto intersections = std::vector<Model::Brush>{};
+      intersections.reserve((brushes.size() + 1u) / 2u);
+      for (size_t i = 0u; i < brushes.size(); i += 2u)
+      {
+        intersections.push_back(std::move(brushes[i]));
+      }
+      return intersectBrushes(std::move(intersections), worldBounds);
+    });
+}
+} // namespace
+
 bool MapDocument::csgSubtract()
 {
   const auto subtrahendNodes = std::vector<Model::BrushNode*>{selectedNodes().brushes()};
@@ -3101,43 +3390,46 @@ bool MapDocument::csgSubtract()
   }
 
   auto transaction = Transaction{*this, "CSG Subtract"};
-  // Select touching, but don't delete the subtrahends yet
-  selectTouching(false);
 
-  const auto minuendNodes = std::vector<Model::BrushNode*>{selectedNodes().brushes()};
-  const auto subtrahends = kdl::vec_transform(
-    subtrahendNodes, [](const auto* subtrahendNode) { return &subtrahendNode->brush(); });
+  const auto mapFormat = m_world->mapFormat();
+  const auto& textureName = currentTextureName();
+
+  // The minuends don't depend on each other, so they are subtracted in parallel. The
+  // resulting nodes are created and added afterwards.
+  auto subtractionResults = kdl::vec_parallel_transform(
+    findMinuends(*m_world, *m_editorContext, subtrahendNodes), [&](Minuend&& minuend) {
+      auto currentSubtractionResults = minuend.node->brush().subtract(
+        mapFormat, m_worldBounds, textureName, minuend.subtrahends);
+
+      return kdl::fold_results(kdl::vec_filter(
+                                 std::move(currentSubtractionResults),
+                                 [](const auto& r) { return r.is_success(); }))
+        .transform([&](auto currentBrushes) {
+          return std::make_pair(minuend.node, std::move(currentBrushes));
+        });
+    });
 
-  auto toAdd = std::map<Model::Node*, std::vector<Model::Node*>>{};
-  auto toRemove =
-    std::vector<Model::Node*>{std::begin(subtrahendNodes), std::end(subtrahendNodes)};
+  return kdl::fold_results(std::move(subtractionResults))
+    .transform([&](auto minuendResults) {
+      auto toAdd = std::map<Model::Node*, std::vector<Model::Node*>>{};
+      auto toRemove =
+        std::vector<Model::Node*>{std::begin(subtrahendNodes), std::end(subtrahendNodes)};
+
+      for (auto& [minuendNode, currentBrushes] : minuendResults)
+      {
+        if (!currentBrushes.empty())
+        {
+          auto resultNodes = kdl::vec_transform(
+            std::move(currentBrushes),
+            [&](auto b) { return new Model::BrushNode{std::move(b)}; });
+          auto& toAddForParent = toAdd[minuendNode->parent()];
+          toAddForParent =
+            kdl::vec_concat(std::move(toAddForParent), std::move(resultNodes));
+        }
+
+        toRemove.push_back(minuendNode);
+      }
 
-  return kdl::fold_results(
-           kdl::vec_transform(
-             minuendNodes,
-             [&](auto* minuendNode) {
-               const auto& minuend = minuendNode->brush();
-               auto currentSubtractionResults = minuend.subtract(
-                 m_world->mapFormat(), m_worldBounds, currentTextureName(), subtrahends);
-
-               return kdl::fold_results(kdl::vec_filter(
-                                          std::move(currentSubtractionResults),
-                                          [](const auto r) { return r.is_success(); }))
-                 .transform([&](auto currentBrushes) {
-                   if (!currentBrushes.empty())
-                   {
-                     auto resultNodes = kdl::vec_transform(
-                       std::move(currentBrushes),
-                       [&](auto b) { return new Model::BrushNode{std::move(b)}; });
-                     auto& toAddForParent = toAdd[minuendNode->parent()];
-                     toAddForParent =
-                       kdl::vec_concat(std::move(toAddForParent), std::move(resultNodes));
-                   }
-
-                   toRemove.push_back(minuendNode);
-                 });
-             }))
-    .transform([&]() {
       deselectAll();
       const auto added = addNodes(toAdd);
       removeNodes(toRemove);
@@ -3161,29 +3453,21 @@ bool MapDocument::csgIntersect()
     return false;
   }
 
-  auto intersection = brushes.front()->brush();
-
-  bool valid = true;
-  for (auto it = std::next(std::begin(brushes)), end = std::end(brushes);
-       it != end && valid;
-       ++it)
-  {
-    auto* brushNode = *it;
-    const auto& brush = brushNode->brush();
-    valid =
-      intersection.intersect(m_worldBounds, brush)
-        .if_error([&](auto e) { error() << "Could not intersect brushes: " << e.msg; })
-        .is_success();
-  }
+  auto brushesToIntersect =
+    kdl::vec_transform(brushes, [](const auto* brushNode) { return brushNode->brush(); });
+  auto intersection =
+    intersectBrushes(std::move(brushesToIntersect), m_worldBounds).if_error([&](auto e) {
+      error() << "Could not intersect brushes: " << e.msg;
+    });
 
   const auto toRemove = std::vector<Model::Node*>{std::begin(brushes), std::end(brushes)};
 
   auto transaction = Transaction{*this, "CSG Intersect"};
   deselectNodes(toRemove);
 
-  if (valid)
+  if (intersection.is_success())
   {
-    auto* intersectionNode = new Model::BrushNode{std::move(intersection)};
+    auto* intersectionNode = new Model::BrushNode{std::move(intersection).value()};
     if (addNodes({{parentForNodes(toRemove), {intersectionNode}}}).empty())
     {
       transaction.cancel();
@@ -3208,39 +3492,46 @@ bool MapDocument::csgHollow()
     return false;
   }
 
-  bool didHollowAnything = false;
-  auto toAdd = std::map<Model::Node*, std::vector<Model::Node*>>{};
-  auto toRemove = std::vector<Model::Node*>{};
+  const auto mapFormat = m_world->mapFormat();
+  const auto& textureName = currentTextureName();
+  const auto delta = -FloatType(m_grid->actualSize());
 
-  for (auto* brushNode : brushNodes)
-  {
+  // The brushes are hollowed in parallel, and any errors are logged afterwards.
+  auto hollowResults = kdl::vec_parallel_transform(brushNodes, [&](auto* brushNode) {
     const auto& originalBrush = brushNode->brush();
 
     auto shrunkenBrush = originalBrush;
-    shrunkenBrush.expand(m_worldBounds, -FloatType(m_grid->actualSize()), true)
+    return shrunkenBrush.expand(m_worldBounds, delta, true)
       .and_then([&]() {
-        didHollowAnything = true;
-
         return kdl::fold_results(originalBrush.subtract(
-                                   m_world->mapFormat(),
-                                   m_worldBounds,
-                                   currentTextureName(),
-                                   shrunkenBrush))
-          .transform([&](auto fragments) {
-            auto fragmentNodes = kdl::vec_transform(std::move(fragments), [](auto&& b) {
-              return new Model::BrushNode{std::forward<decltype(b)>(b)};
-            });
-
-            auto& toAddForParent = toAdd[brushNode->parent()];
-            toAddForParent = kdl::vec_concat(std::move(toAddForParent), fragmentNodes);
-            toRemove.push_back(brushNode);
-          });
+          mapFormat, m_worldBounds, textureName, shrunkenBrush));
+      })
+      .transform([&](auto fragments) {
+        return std::make_pair(brushNode, std::move(fragments));
+      });
+  });
+
+  auto toAdd = std::map<Model::Node*, std::vector<Model::Node*>>{};
+  auto toRemove = std::vector<Model::Node*>{};
+
+  for (auto& hollowResult : hollowResults)
+  {
+    std::move(hollowResult)
+      .transform([&](auto brushNodeAndFragments) {
+        auto& [brushNode, fragments] = brushNodeAndFragments;
+        auto fragmentNodes = kdl::vec_transform(std::move(fragments), [](auto&& b) {
+          return new Model::BrushNode{std::forward<decltype(b)>(b)};
+        });
+
+        auto& toAddForParent = toAdd[brushNode->parent()];
+        toAddForParent = kdl::vec_concat(std::move(toAddForParent), fragmentNodes);
+        toRemove.push_back(brushNode);
       })
       .transform_error(
         [&](const auto& e) { error() << "Could not hollow brush: " << e; });
   }
 
-  if (!didHollowAnything)
+  if (toRemove.empty())
   {
     return false;
   }
@@ -3573,34 +3864,46 @@ void MapDocument::setDefaultProperties(const Model::SetDefaultPropertyMode mode)
 bool MapDocument::extrudeBrushes(
   const std::vector<vm::polygon3>& faces, const vm::vec3& delta)
 {
-  const auto nodes = m_selectedNodes.nodes();
-  return applyAndSwap(
-    *this,
-    "Resize Brushes",
-    nodes,
-    collectContainingGroups(nodes),
-    kdl::overload(
-      [](Model::Layer&) { return true; },
-      [](Model::Group&) { return true; },
-      [](Model::Entity&) { return true; },
-      [&](Model::Brush& brush) {
-        const auto faceIndex = brush.findFace(faces);
-        if (!faceIndex)
-        {
-          // we allow resizing only some of the brushes
-          return true;
-        }
+  const auto brushNodes = m_selectedNodes.brushes();
+  const auto lockTextures = pref(Preferences::TextureLock);
 
-        return brush
-          .moveBoundary(m_worldBounds, *faceIndex, delta, pref(Preferences::TextureLock))
-          .transform([&]() { return m_worldBounds.contains(brush.bounds()); })
-          .transform_error([&](auto e) {
-            error() << "Could not resize brush: " << e.msg;
-            return false;
-          })
-          .value();
-      },
-      [](Model::BezierPatch&) { return true; }));
+  // The brushes are resized in parallel, and any errors are logged afterwards.
+  auto resizeResults =
+    applyToBrushesInParallel(brushNodes, [&](Model::Brush& brush) -> Result<bool> {
+      const auto faceIndex = brush.findFace(faces);
+      if (!faceIndex)
+      {
+        // we allow resizing only some of the brushes
+        return true;
+      }
+
+      return brush.moveBoundary(m_worldBounds, *faceIndex, delta, lockTextures)
+        .transform([&]() { return m_worldBounds.contains(brush.bounds()); });
+    });
+
+  auto success = true;
+  auto nodesToUpdate = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+  nodesToUpdate.reserve(brushNodes.size());
+
+  for (size_t i = 0; i < brushNodes.size(); ++i)
+  {
+    auto& [brush, resized] = resizeResults[i];
+    success = std::move(resized)
+                .transform_error([&](auto e) {
+                  error() << "Could not resize brush: " << e.msg;
+                  return false;
+                })
+                .value()
+              && success;
+    nodesToUpdate.emplace_back(brushNodes[i], Model::NodeContents{std::move(brush)});
+  }
+
+  return success
+         && (nodesToUpdate.empty()
+             || swapNodeContents(
+               "Resize Brushes",
+               std::move(nodesToUpdate),
+               collectContainingGroups(brushNodes)));
 }
 
 bool MapDocument::setFaceAttributes(const Model::BrushFaceAttributes& attributes)
@@ -3689,52 +3992,210 @@ bool MapDocument::flipTextures(
     });
 }
 
-bool MapDocument::snapVertices(const FloatType snapTo)
+/**
+ * The state of an interactive texturing change, see startTexturePreview.
+ */
+struct MapDocument::TexturePreview
 {
-  size_t succeededBrushCount = 0;
-  size_t failedBrushCount = 0;
+  struct OriginalBrush
+  {
+    Model::Brush brush;
+    std::vector<size_t> changedFaceIndices;
+  };
 
-  const auto allSelectedBrushes = allSelectedBrushNodes();
-  const bool applyAndSwapSuccess = applyAndSwap(
-    *this,
-    "Snap Brush Vertices",
-    allSelectedBrushes,
-    collectContainingGroups(allSelectedBrushes),
-    kdl::overload(
-      [](Model::Layer&) { return true; },
-      [](Model::Group&) { return true; },
-      [](Model::Entity&) { return true; },
-      [&](Model::Brush& originalBrush) {
-        if (originalBrush.canSnapVertices(m_worldBounds, snapTo))
-        {
-          originalBrush.snapVertices(m_worldBounds, snapTo, pref(Preferences::UVLock))
-            .transform([&]() { succeededBrushCount += 1; })
-            .transform_error([&](auto e) {
-              error() << "Could not snap vertices: " << e.msg;
-              failedBrushCount += 1;
-            });
-        }
-        else
-        {
-          failedBrushCount += 1;
-        }
-        return true;
-      },
-      [](Model::BezierPatch&) { return true; }));
+  // the brushes changed by the preview as they were before the preview started
+  std::unordered_map<Model::BrushNode*, OriginalBrush> originalBrushes;
+};
 
-  if (!applyAndSwapSuccess)
-  {
-    return false;
-  }
-  if (succeededBrushCount > 0)
-  {
-    info(kdl::str_to_string(
-      "Snapped vertices of ",
-      succeededBrushCount,
-      " ",
-      kdl::str_plural(succeededBrushCount, "brush", "brushes")));
-  }
-  if (failedBrushCount > 0)
+void MapDocument::startTexturePreview()
+{
+  assert(!m_texturePreview);
+  m_texturePreview = std::make_unique<TexturePreview>();
+}
+
+bool MapDocument::isTexturePreviewActive() const
+{
+  return m_texturePreview != nullptr;
+}
+
+bool MapDocument::previewFaceAttributes(
+  const Model::ChangeBrushFaceAttributesRequest& request)
+{
+  return previewTextureChange(
+    allSelectedBrushFaces(), [&](Model::BrushFace& face) { request.evaluate(face); });
+}
+
+bool MapDocument::previewShearTextures(const vm::vec2f& factors)
+{
+  return previewTextureChange(
+    m_selectedBrushFaces, [&](Model::BrushFace& face) { face.shearTexture(factors); });
+}
+
+bool MapDocument::commitTexturePreview(const std::string& commandName)
+{
+  if (!m_texturePreview)
+  {
+    return false;
+  }
+
+  auto newFaces = BrushFaceAttributesStates{};
+  newFaces.reserve(m_texturePreview->originalBrushes.size());
+  for (const auto& [brushNode, originalBrush] : m_texturePreview->originalBrushes)
+  {
+    const auto& brush = brushNode->brush();
+    auto faceStates =
+      kdl::vec_transform(originalBrush.changedFaceIndices, [&](const auto faceIndex) {
+        const auto& face = brush.face(faceIndex);
+        return BrushFaceAttributesState{
+          faceIndex, face.attributes(), face.takeTexCoordSystemSnapshot()};
+      });
+    newFaces.emplace_back(brushNode, std::move(faceStates));
+  }
+
+  // the command applies the changes to the original brushes again so that it can undo
+  // them
+  const auto changedFaces = restoreTexturePreviewBrushes();
+  if (newFaces.empty())
+  {
+    return true;
+  }
+
+  if (!swapBrushFaceAttributes(commandName, std::move(newFaces)))
+  {
+    brushFacesDidChangeNotifier(changedFaces);
+    return false;
+  }
+  return true;
+}
+
+void MapDocument::cancelTexturePreview()
+{
+  if (m_texturePreview)
+  {
+    brushFacesDidChangeNotifier(restoreTexturePreviewBrushes());
+  }
+}
+
+bool MapDocument::previewTextureChange(
+  const std::vector<Model::BrushFaceHandle>& faces,
+  const std::function<void(Model::BrushFace&)>& change)
+{
+  if (!m_texturePreview)
+  {
+    return false;
+  }
+
+  auto faceIndices = std::unordered_map<Model::BrushNode*, std::vector<size_t>>{};
+  for (const auto& faceHandle : faces)
+  {
+    faceIndices[faceHandle.node()].push_back(faceHandle.faceIndex());
+  }
+
+  for (auto& [brushNode, indices] : faceIndices)
+  {
+    auto brush = brushNode->brush();
+    for (const auto faceIndex : indices)
+    {
+      change(brush.face(faceIndex));
+    }
+
+    auto originalBrush = brushNode->setBrush(std::move(brush));
+    auto& changedFaceIndices =
+      m_texturePreview->originalBrushes
+        .try_emplace(
+          brushNode, TexturePreview::OriginalBrush{std::move(originalBrush), {}})
+        .first->second.changedFaceIndices;
+    changedFaceIndices = kdl::vec_sort_and_remove_duplicates(
+      kdl::vec_concat(std::move(changedFaceIndices), indices));
+  }
+
+  brushFacesDidChangeNotifier(faces);
+  return true;
+}
+
+std::vector<Model::BrushFaceHandle> MapDocument::restoreTexturePreviewBrushes()
+{
+  const auto texturePreview = std::move(m_texturePreview);
+
+  auto changedFaces = std::vector<Model::BrushFaceHandle>{};
+  for (auto& [brushNode, originalBrush] : texturePreview->originalBrushes)
+  {
+    brushNode->setBrush(std::move(originalBrush.brush));
+    for (const auto faceIndex : originalBrush.changedFaceIndices)
+    {
+      changedFaces.emplace_back(brushNode, faceIndex);
+    }
+  }
+  return changedFaces;
+}
+
+bool MapDocument::snapVertices(const FloatType snapTo)
+{
+  const auto allSelectedBrushes = allSelectedBrushNodes();
+  if (allSelectedBrushes.empty())
+  {
+    return true;
+  }
+
+  const auto uvLock = pref(Preferences::UVLock);
+
+  // The brushes are snapped in parallel, and any errors are logged afterwards. The result
+  // of each brush indicates whether its vertices could be snapped.
+  auto snapResults = applyToBrushesInParallel(
+    allSelectedBrushes, [&](Model::Brush& brush) -> Result<bool> {
+      if (!brush.canSnapVertices(m_worldBounds, snapTo))
+      {
+        return false;
+      }
+      return brush.snapVertices(m_worldBounds, snapTo, uvLock).transform([]() {
+        return true;
+      });
+    });
+
+  size_t succeededBrushCount = 0;
+  size_t failedBrushCount = 0;
+
+  auto nodesToUpdate = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+  nodesToUpdate.reserve(allSelectedBrushes.size());
+
+  for (size_t i = 0; i < allSelectedBrushes.size(); ++i)
+  {
+    auto& [brush, snapped] = snapResults[i];
+    std::move(snapped)
+      .transform([&](const bool success) {
+        if (success)
+        {
+          succeededBrushCount += 1;
+        }
+        else
+        {
+          failedBrushCount += 1;
+        }
+      })
+      .transform_error([&](auto e) {
+        error() << "Could not snap vertices: " << e.msg;
+        failedBrushCount += 1;
+      });
+    nodesToUpdate.emplace_back(
+      allSelectedBrushes[i], Model::NodeContents{std::move(brush)});
+  }
+
+  if (!swapNodeContents(
+        "Snap Brush Vertices",
+        std::move(nodesToUpdate),
+        collectContainingGroups(allSelectedBrushes)))
+  {
+    return false;
+  }
+  if (succeededBrushCount > 0)
+  {
+    info(kdl::str_to_string(
+      "Snapped vertices of ",
+      succeededBrushCount,
+      " ",
+      kdl::str_plural(succeededBrushCount, "brush", "brushes")));
+  }
+  if (failedBrushCount > 0)
   {
     info(kdl::str_to_string(
       "Failed to snap vertices of ",
@@ -3764,13 +4225,15 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
           return true;
         }
 
-        if (!brush.canMoveVertices(m_worldBounds, verticesToMove, delta))
+        // a move that is not possible is not an error, the move is just rejected
+        auto move = brush.prepareMoveVertices(m_worldBounds, verticesToMove, delta);
+        if (move.is_error())
         {
           return false;
         }
 
         return brush
-          .moveVertices(m_worldBounds, verticesToMove, delta, pref(Preferences::UVLock))
+          .applyVertexMove(m_worldBounds, move.value(), pref(Preferences::UVLock))
           .transform([&]() {
             auto newPositions = brush.findClosestVertexPositions(verticesToMove + delta);
             newVertexPositions =
@@ -3843,13 +4306,14 @@ bool MapDocument::moveEdges(
           return true;
         }
 
-        if (!brush.canMoveEdges(m_worldBounds, edgesToMove, delta))
+        auto move = brush.prepareMoveEdges(m_worldBounds, edgesToMove, delta);
+        if (move.is_error())
         {
           return false;
         }
 
         return brush
-          .moveEdges(m_worldBounds, edgesToMove, delta, pref(Preferences::UVLock))
+          .applyVertexMove(m_worldBounds, move.value(), pref(Preferences::UVLock))
           .transform([&]() {
             auto newPositions = brush.findClosestEdgePositions(kdl::vec_transform(
               edgesToMove, [&](const auto& edge) { return edge.translate(delta); }));
@@ -3909,13 +4373,14 @@ bool MapDocument::moveFaces(
           return true;
         }
 
-        if (!brush.canMoveFaces(m_worldBounds, facesToMove, delta))
+        auto move = brush.prepareMoveFaces(m_worldBounds, facesToMove, delta);
+        if (move.is_error())
         {
           return false;
         }
 
         return brush
-          .moveFaces(m_worldBounds, facesToMove, delta, pref(Preferences::UVLock))
+          .applyVertexMove(m_worldBounds, move.value(), pref(Preferences::UVLock))
           .transform([&]() {
             auto newPositions = brush.findClosestFacePositions(kdl::vec_transform(
               facesToMove, [&](const auto& face) { return face.translate(delta); }));
@@ -4140,10 +4605,17 @@ const std::string& MapDocument::redoCommandName() const
   return doGetRedoCommandName();
 }
 
+size_t MapDocument::undoMemoryUsage() const
+{
+  return doGetUndoMemoryUsage();
+}
+
 void MapDocument::undoCommand()
 {
+  beginNodeChangeBatch();
   doUndoCommand();
   updateLinkedGroups();
+  endNodeChangeBatch();
 
   // Undo/redo in the repeat system is not supported for now, so just clear the repeat
   // stack
@@ -4152,8 +4624,10 @@ void MapDocument::undoCommand()
 
 void MapDocument::redoCommand()
 {
+  beginNodeChangeBatch();
   doRedoCommand();
   updateLinkedGroups();
+  endNodeChangeBatch();
 
   // Undo/redo in the repeat system is not supported for now, so just clear the repeat
   // stack
@@ -4178,6 +4652,7 @@ void MapDocument::clearRepeatableCommands()
 void MapDocument::startTransaction(std::string name, const TransactionScope scope)
 {
   debug("Starting transaction '" + name + "'");
+  beginNodeChangeBatch();
   doStartTransaction(std::move(name), scope);
   m_repeatStack->startTransaction();
 }
@@ -4201,6 +4676,7 @@ bool MapDocument::commitTransaction()
 
   doCommitTransaction();
   m_repeatStack->commitTransaction();
+  endNodeChangeBatch();
   return true;
 }
 
@@ -4211,17 +4687,24 @@ void MapDocument::cancelTransaction()
   m_repeatStack->rollbackTransaction();
   doCommitTransaction();
   m_repeatStack->commitTransaction();
+  endNodeChangeBatch();
 }
 
 std::unique_ptr<CommandResult> MapDocument::execute(std::unique_ptr<Command>&& command)
 {
-  return doExecute(std::move(command));
+  beginNodeChangeBatch();
+  auto result = doExecute(std::move(command));
+  endNodeChangeBatch();
+  return result;
 }
 
 std::unique_ptr<CommandResult> MapDocument::executeAndStore(
   std::unique_ptr<UndoableCommand>&& command)
 {
-  return doExecuteAndStore(std::move(command));
+  beginNodeChangeBatch();
+  auto result = doExecuteAndStore(std::move(command));
+  endNodeChangeBatch();
+  return result;
 }
 
 void MapDocument::commitPendingAssets()
@@ -4231,6 +4714,7 @@ void MapDocument::commitPendingAssets()
 
 void MapDocument::pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const
 {
+  const auto zone = ProfilerZone{"MapDocument::pick"};
   if (m_world)
   {
     m_world->pick(*m_editorContext, pickRay, pickResult);
@@ -4339,6 +4823,35 @@ void MapDocument::reloadTextureCollections()
   initializeAllNodeTags(this);
 }
 
+void MapDocument::reloadModifiedTextures(
+  const std::vector<std::filesystem::path>& directories)
+{
+  auto count = size_t{0};
+  for (const auto& directory : directories)
+  {
+    const auto reloaded = m_game->reloadModifiedTextures(*m_textureManager, directory);
+    if (reloaded)
+    {
+      count += *reloaded;
+    }
+    else
+    {
+      reloadTextureCollections();
+      return;
+    }
+  }
+
+  if (count > 0)
+  {
+    // the textures were replaced in place, but their sizes may have changed
+    const auto nodes = std::vector<Model::Node*>{m_world.get()};
+    NotifyBeforeAndAfter notifyNodes(
+      nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
+    NotifyBeforeAndAfter notifyTextureCollections(
+      textureCollectionsWillChangeNotifier, textureCollectionsDidChangeNotifier);
+  }
+}
+
 void MapDocument::reloadEntityDefinitions()
 {
   const auto nodes = std::vector<Model::Node*>{m_world.get()};
@@ -4415,6 +4928,91 @@ void MapDocument::setEnabledTextureCollections(
   transaction.finish(success);
 }
 
+namespace
+{
+std::optional<std::filesystem::path> entityDefinitionCacheDirectory()
+{
+  return pref(Preferences::UseEntityDefinitionCache)
+           ? std::optional{IO::SystemPaths::userDataDirectory() / "EntityDefinitionCache"}
+           : std::nullopt;
+}
+
+std::vector<std::filesystem::path> externalSearchPathsForDocument(
+  const std::filesystem::path& documentPath, const Model::Game& game)
+{
+  std::vector<std::filesystem::path> searchPaths;
+  if (!documentPath.empty() && documentPath.is_absolute())
+  {
+    searchPaths.push_back(documentPath.parent_path());
+  }
+
+  const std::filesystem::path gamePath = game.gamePath();
+  if (!gamePath.empty())
+  {
+    searchPaths.push_back(gamePath);
+  }
+
+  searchPaths.push_back(IO::SystemPaths::appDirectory());
+  return searchPaths;
+}
+} // namespace
+
+struct MapDocument::PendingEntityDefinitions
+{
+  struct LoadedDefinitions
+  {
+    std::filesystem::path path;
+    Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> definitions;
+    std::vector<CollectingLogger::Message> messages;
+  };
+
+  // empty if the map file could not be prescanned
+  std::future<std::optional<LoadedDefinitions>> loadedDefinitions;
+};
+
+void MapDocument::prefetchEntityDefinitions(
+  std::shared_ptr<Model::Game> game, const std::filesystem::path& path)
+{
+  // the preferences and the game's search paths can only be read on the main thread
+  auto searchPaths = externalSearchPathsForDocument(path, *game);
+  auto cacheDirectory = entityDefinitionCacheDirectory();
+
+  m_pendingEntityDefinitions = std::make_unique<PendingEntityDefinitions>();
+  m_pendingEntityDefinitions->loadedDefinitions = std::async(
+    std::launch::async,
+    [game = std::move(game),
+     path,
+     searchPaths = std::move(searchPaths),
+     cacheDirectory = std::move(cacheDirectory)]() {
+      using LoadedDefinitions = PendingEntityDefinitions::LoadedDefinitions;
+
+      return IO::Disk::mapFile(path)
+        .transform([&](auto file) -> std::optional<LoadedDefinitions> {
+          const auto reader = file->reader().buffer();
+          const auto contents = reader.stringView();
+          if (IO::isGzipped(contents))
+          {
+            // not worth decompressing the map twice
+            return std::nullopt;
+          }
+
+          // the entity definition file is determined by the worldspawn properties
+          const auto worldspawn = Model::Entity{
+            game->entityPropertyConfig(), IO::readWorldspawnProperties(contents)};
+          const auto spec = game->extractEntityDefinitionFile(worldspawn);
+          auto definitionPath = game->findEntityDefinitionFile(spec, searchPaths);
+
+          auto logger = CollectingLogger{};
+          auto status = IO::SimpleParserStatus{logger};
+          auto definitions =
+            game->loadEntityDefinitions(status, definitionPath, cacheDirectory);
+          return LoadedDefinitions{
+            std::move(definitionPath), std::move(definitions), logger.takeMessages()};
+        })
+        .value_or(std::nullopt);
+    });
+}
+
 void MapDocument::loadAssets()
 {
   loadEntityDefinitions();
@@ -4431,14 +5029,53 @@ void MapDocument::unloadAssets()
   unloadTextures();
 }
 
+std::optional<Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>>>
+MapDocument::takePendingEntityDefinitions(const std::filesystem::path& path)
+{
+  if (!m_pendingEntityDefinitions)
+  {
+    return std::nullopt;
+  }
+
+  auto pendingEntityDefinitions = std::exchange(m_pendingEntityDefinitions, nullptr);
+  try
+  {
+    auto loadedDefinitions = pendingEntityDefinitions->loadedDefinitions.get();
+    if (!loadedDefinitions || loadedDefinitions->path != path)
+    {
+      // the prescanned worldspawn refers to a different file than the parsed one
+      return std::nullopt;
+    }
+
+    for (const auto& [level, message] : loadedDefinitions->messages)
+    {
+      log(level, message);
+    }
+    return std::move(loadedDefinitions->definitions);
+  }
+  catch (const std::exception&)
+  {
+    // load the definitions again so that the error is reported as usual
+    return std::nullopt;
+  }
+}
+
 void MapDocument::loadEntityDefinitions()
 {
   const auto spec = entityDefinitionFile();
   const auto path = m_game->findEntityDefinitionFile(spec, externalSearchPaths());
   auto status = IO::SimpleParserStatus{logger()};
 
-  m_entityDefinitionManager->loadDefinitions(path, *m_game, status)
-    .transform([&]() {
+  auto definitions = takePendingEntityDefinitions(path);
+  if (!definitions)
+  {
+    definitions =
+      m_game->loadEntityDefinitions(status, path, entityDefinitionCacheDirectory());
+  }
+
+  std::move(*definitions)
+    .transform([&](auto entityDefinitions) {
+      m_entityDefinitionManager->setDefinitions(std::move(entityDefinitions));
       info("Loaded entity definition file " + path.filename().string());
       createEntityDefinitionActions();
     })
@@ -4478,6 +5115,8 @@ void MapDocument::unloadEntityModels()
 void MapDocument::reloadTextures()
 {
   unloadTextures();
+  // shaders are used by entity models that are still being loaded
+  m_entityModelManager->waitForPendingModels();
   m_game->reloadShaders().transform_error(
     [&](auto e) { error() << "Failed to reload shaders: " << e.msg; });
   loadTextures();
@@ -4508,7 +5147,48 @@ void MapDocument::unloadTextures()
   m_textureManager->clear();
 }
 
-static auto makeSetTexturesVisitor(Assets::TextureManager& manager)
+/**
+ * Sets the textures of the faces of the given brushes and of the given patches, resolving
+ * all texture names with a single lookup.
+ */
+static void resolveAndSetTextures(
+  const Assets::TextureManager& manager,
+  const std::vector<Model::BrushNode*>& brushNodes,
+  const std::vector<Model::PatchNode*>& patchNodes,
+  const bool parallel)
+{
+  auto names = std::vector<std::string_view>{};
+  names.reserve(brushNodes.size() * 6 + patchNodes.size());
+  for (const auto* brushNode : brushNodes)
+  {
+    for (const auto& face : brushNode->brush().faces())
+    {
+      names.push_back(face.attributes().textureName());
+    }
+  }
+  for (const auto* patchNode : patchNodes)
+  {
+    names.push_back(patchNode->patch().textureName());
+  }
+
+  const auto textures = manager.resolveTextures(names, parallel);
+
+  auto it = textures.begin();
+  for (auto* brushNode : brushNodes)
+  {
+    for (size_t i = 0u; i < brushNode->brush().faceCount(); ++i)
+    {
+      brushNode->setFaceTexture(i, *it++);
+    }
+  }
+  for (auto* patchNode : patchNodes)
+  {
+    patchNode->setTexture(*it++);
+  }
+}
+
+static auto makeCollectTexturedNodesVisitor(
+  std::vector<Model::BrushNode*>& brushNodes, std::vector<Model::PatchNode*>& patchNodes)
 {
   return kdl::overload(
     [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
@@ -4517,19 +5197,8 @@ static auto makeSetTexturesVisitor(Assets::TextureManager& manager)
     [](auto&& thisLambda, Model::EntityNode* entity) {
       entity->visitChildren(thisLambda);
     },
-    [&](Model::BrushNode* brushNode) {
-      const Model::Brush& brush = brushNode->brush();
-      for (size_t i = 0u; i < brush.faceCount(); ++i)
-      {
-        const Model::BrushFace& face = brush.face(i);
-        Assets::Texture* texture = manager.texture(face.attributes().textureName());
-        brushNode->setFaceTexture(i, texture);
-      }
-    },
-    [&](Model::PatchNode* patchNode) {
-      auto* texture = manager.texture(patchNode->patch().textureName());
-      patchNode->setTexture(texture);
-    });
+    [&](Model::BrushNode* brushNode) { brushNodes.push_back(brushNode); },
+    [&](Model::PatchNode* patchNode) { patchNodes.push_back(patchNode); });
 }
 
 static auto makeUnsetTexturesVisitor()
@@ -4553,13 +5222,19 @@ static auto makeUnsetTexturesVisitor()
 
 void MapDocument::setTextures()
 {
-  m_world->accept(makeSetTexturesVisitor(*m_textureManager));
+  // this resolves the texture names of every face in the map
+  resolveAndSetTextures(
+    *m_textureManager, m_world->allBrushes(), m_world->allPatches(), true);
   textureUsageCountsDidChangeNotifier();
 }
 
 void MapDocument::setTextures(const std::vector<Model::Node*>& nodes)
 {
-  Model::Node::visitAll(nodes, makeSetTexturesVisitor(*m_textureManager));
+  auto brushNodes = std::vector<Model::BrushNode*>{};
+  auto patchNodes = std::vector<Model::PatchNode*>{};
+  Model::Node::visitAll(nodes, makeCollectTexturedNodesVisitor(brushNodes, patchNodes));
+
+  resolveAndSetTextures(*m_textureManager, brushNodes, patchNodes, false);
   textureUsageCountsDidChangeNotifier();
 }
 
@@ -4587,22 +5262,24 @@ void MapDocument::unsetTextures(const std::vector<Model::Node*>& nodes)
   textureUsageCountsDidChangeNotifier();
 }
 
-static auto makeSetEntityDefinitionsVisitor(Assets::EntityDefinitionManager& manager)
+static auto makeCollectEntityDefinitionsVisitor(
+  const Assets::EntityDefinitionManager& manager,
+  std::vector<std::tuple<Model::EntityNodeBase*, Assets::EntityDefinition*>>&
+    nodesAndDefinitions)
 {
   // this helper lambda must be captured by value
-  const auto setEntityDefinition = [&](auto* node) {
-    auto* definition = manager.definition(node);
-    node->setDefinition(definition);
+  const auto collectEntityDefinition = [&](auto* node) {
+    nodesAndDefinitions.emplace_back(node, manager.definition(node));
   };
 
   return kdl::overload(
     [=](auto&& thisLambda, Model::WorldNode* world) {
-      setEntityDefinition(world);
+      collectEntityDefinition(world);
       world->visitChildren(thisLambda);
     },
     [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
     [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
-    [=](Model::EntityNode* entity) { setEntityDefinition(entity); },
+    [=](Model::EntityNode* entity) { collectEntityDefinition(entity); },
     [](Model::BrushNode*) {},
     [](Model::PatchNode*) {});
 }
@@ -4623,13 +5300,21 @@ static auto makeUnsetEntityDefinitionsVisitor()
 
 void MapDocument::setEntityDefinitions()
 {
-  m_world->accept(makeSetEntityDefinitionsVisitor(*m_entityDefinitionManager));
+  auto nodesAndDefinitions =
+    std::vector<std::tuple<Model::EntityNodeBase*, Assets::EntityDefinition*>>{};
+  m_world->accept(
+    makeCollectEntityDefinitionsVisitor(*m_entityDefinitionManager, nodesAndDefinitions));
+  Model::EntityNodeBase::setDefinitions(nodesAndDefinitions);
 }
 
 void MapDocument::setEntityDefinitions(const std::vector<Model::Node*>& nodes)
 {
+  auto nodesAndDefinitions =
+    std::vector<std::tuple<Model::EntityNodeBase*, Assets::EntityDefinition*>>{};
   Model::Node::visitAll(
-    nodes, makeSetEntityDefinitionsVisitor(*m_entityDefinitionManager));
+    nodes,
+    makeCollectEntityDefinitionsVisitor(*m_entityDefinitionManager, nodesAndDefinitions));
+  Model::EntityNodeBase::setDefinitions(nodesAndDefinitions);
 }
 
 void MapDocument::unsetEntityDefinitions()
@@ -4707,22 +5392,84 @@ void MapDocument::unsetEntityModels(const std::vector<Model::Node*>& nodes)
   Model::Node::visitAll(nodes, makeUnsetEntityModelsVisitor());
 }
 
-std::vector<std::filesystem::path> MapDocument::externalSearchPaths() const
+void MapDocument::processLoadedEntityModels()
 {
-  std::vector<std::filesystem::path> searchPaths;
-  if (!m_path.empty() && m_path.is_absolute())
+  const auto loadedPaths =
+    kdl::vector_set<std::filesystem::path>{m_entityModelManager->processLoadedModels()};
+  if (loadedPaths.empty())
   {
-    searchPaths.push_back(m_path.parent_path());
+    return;
   }
 
-  const std::filesystem::path gamePath = m_game->gamePath();
-  if (!gamePath.empty())
+  // any errors in the model specifications were already logged when the models were
+  // requested
+  auto nullLogger = NullLogger{};
+  auto nodes = std::vector<Model::Node*>{};
+  m_world->accept(kdl::overload(
+    [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
+    [&](Model::EntityNode* entityNode) {
+      if (entityNode->entity().model() == nullptr)
+      {
+        const auto modelSpec = Assets::safeGetModelSpecification(
+          nullLogger, entityNode->entity().classname(), [&]() {
+            return entityNode->entity().modelSpecification();
+          });
+        if (loadedPaths.count(modelSpec.path) > 0)
+        {
+          nodes.push_back(entityNode);
+        }
+      }
+    },
+    [](Model::BrushNode*) {},
+    [](Model::PatchNode*) {}));
+
+  if (!nodes.empty())
   {
-    searchPaths.push_back(gamePath);
+    NotifyBeforeAndAfter notifyNodes(
+      nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
+    setEntityModels(nodes);
   }
 
-  searchPaths.push_back(IO::SystemPaths::appDirectory());
-  return searchPaths;
+  evictEntityModels();
+  entityModelsWereLoadedNotifier();
+}
+
+void MapDocument::evictEntityModels()
+{
+  const auto memoryLimitMB =
+    size_t(std::max(0, pref(Preferences::EntityModelMemoryLimit)));
+  if (memoryLimitMB == 0)
+  {
+    return;
+  }
+
+  // the entities keep pointers to the frames of their models, and the entity renderers
+  // keep pointers to the renderers of these models
+  auto nullLogger = NullLogger{};
+  auto retainedPaths = kdl::vector_set<std::filesystem::path>{};
+  m_world->accept(kdl::overload(
+    [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
+    [&](Model::EntityNode* entityNode) {
+      const auto modelSpec = Assets::safeGetModelSpecification(
+        nullLogger, entityNode->entity().classname(), [&]() {
+          return entityNode->entity().modelSpecification();
+        });
+      retainedPaths.insert(modelSpec.path);
+    },
+    [](Model::BrushNode*) {},
+    [](Model::PatchNode*) {}));
+
+  // the entity browser rebuilds its layout when it is notified about the loaded models
+  m_entityModelManager->evictModels(memoryLimitMB * 1024u * 1024u, retainedPaths);
+}
+
+std::vector<std::filesystem::path> MapDocument::externalSearchPaths() const
+{
+  return externalSearchPathsForDocument(m_path, *m_game);
 }
 
 void MapDocument::updateGameSearchPaths()
@@ -4817,31 +5564,7 @@ void MapDocument::registerValidators()
   ensure(m_world, "world is null");
   ensure(m_game.get() != nullptr, "game is null");
 
-  m_world->registerValidator(std::make_unique<Model::MissingClassnameValidator>());
-  m_world->registerValidator(std::make_unique<Model::MissingDefinitionValidator>());
-  m_world->registerValidator(std::make_unique<Model::MissingModValidator>(m_game));
-  m_world->registerValidator(std::make_unique<Model::EmptyGroupValidator>());
-  m_world->registerValidator(std::make_unique<Model::EmptyBrushEntityValidator>());
-  m_world->registerValidator(std::make_unique<Model::PointEntityWithBrushesValidator>());
-  m_world->registerValidator(std::make_unique<Model::LinkSourceValidator>());
-  m_world->registerValidator(std::make_unique<Model::LinkTargetValidator>());
-  m_world->registerValidator(std::make_unique<Model::NonIntegerVerticesValidator>());
-  m_world->registerValidator(std::make_unique<Model::MixedBrushContentsValidator>());
-  m_world->registerValidator(
-    std::make_unique<Model::WorldBoundsValidator>(worldBounds()));
-  m_world->registerValidator(
-    std::make_unique<Model::SoftMapBoundsValidator>(m_game, *m_world));
-  m_world->registerValidator(std::make_unique<Model::EmptyPropertyKeyValidator>());
-  m_world->registerValidator(std::make_unique<Model::EmptyPropertyValueValidator>());
-  m_world->registerValidator(
-    std::make_unique<Model::LongPropertyKeyValidator>(m_game->maxPropertyLength()));
-  m_world->registerValidator(
-    std::make_unique<Model::LongPropertyValueValidator>(m_game->maxPropertyLength()));
-  m_world->registerValidator(
-    std::make_unique<Model::PropertyKeyWithDoubleQuotationMarksValidator>());
-  m_world->registerValidator(
-    std::make_unique<Model::PropertyValueWithDoubleQuotationMarksValidator>());
-  m_world->registerValidator(std::make_unique<Model::InvalidTextureScaleValidator>());
+  Model::registerDefaultValidators(*m_world, m_game, worldBounds());
 }
 
 void MapDocument::registerSmartTags()
@@ -4927,7 +5650,12 @@ void MapDocument::initializeAllNodeTags(MapDocument* document)
 {
   assert(document == this);
   unused(document);
-  m_world->accept(makeInitializeNodeTagsVisitor(*m_tagManager));
+
+  m_world->initializeTags(*m_tagManager);
+  for (auto* node : m_world->allDescendants())
+  {
+    node->initializeTags(*m_tagManager);
+  }
 }
 
 void MapDocument::initializeNodeTags(const std::vector<Model::Node*>& nodes)
@@ -4959,15 +5687,10 @@ void MapDocument::updateFaceTags(const std::vector<Model::BrushFaceHandle>& face
 
 void MapDocument::updateAllFaceTags()
 {
-  m_world->accept(kdl::overload(
-    [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
-    [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
-    [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
-    [](auto&& thisLambda, Model::EntityNode* entity) {
-      entity->visitChildren(thisLambda);
-    },
-    [&](Model::BrushNode* brush) { brush->initializeTags(*m_tagManager); },
-    [](Model::PatchNode*) {}));
+  for (auto* brushNode : m_world->allBrushes())
+  {
+    brushNode->initializeTags(*m_tagManager);
+  }
 }
 
 bool MapDocument::persistent() const
@@ -5004,6 +5727,16 @@ size_t MapDocument::modificationCount() const
   return m_modificationCount;
 }
 
+const ChangeJournal& MapDocument::changeJournal() const
+{
+  return *m_changeJournal;
+}
+
+TaskScheduler& MapDocument::taskScheduler()
+{
+  return *m_taskScheduler;
+}
+
 void MapDocument::setLastSaveModificationCount()
 {
   m_lastSaveModificationCount = m_modificationCount;
@@ -5063,6 +5796,77 @@ void MapDocument::connectObservers()
     modsDidChangeNotifier.connect(this, &MapDocument::updateAllFaceTags);
   m_notifierConnection +=
     textureCollectionsDidChangeNotifier.connect(this, &MapDocument::updateAllFaceTags);
+
+  // node change batching
+  m_notifierConnection +=
+    nodesDidChangeNotifier.connect(this, &MapDocument::batchNodesDidChange);
+  m_notifierConnection +=
+    nodesWereRemovedNotifier.connect(this, &MapDocument::unbatchRemovedNodes);
+  m_notifierConnection += documentWillBeClearedNotifier.connect(
+    [this](MapDocument*) { clearBatchedNodeChanges(); });
+
+  // change journal
+  const auto recordChange = [this](const ChangeType type) {
+    return [this, type](const std::vector<Model::Node*>& nodes) {
+      m_changeJournal->record(type, nodes);
+    };
+  };
+  const auto recordReset = [this](MapDocument*) {
+    m_changeJournal->record(ChangeType::DocumentWasReset, {});
+  };
+  m_notifierConnection +=
+    nodesWereAddedNotifier.connect(recordChange(ChangeType::NodesWereAdded));
+  m_notifierConnection +=
+    nodesWereRemovedNotifier.connect(recordChange(ChangeType::NodesWereRemoved));
+  m_notifierConnection +=
+    nodesDidChangeNotifier.connect(recordChange(ChangeType::NodesDidChange));
+  m_notifierConnection += nodeVisibilityDidChangeNotifier.connect(
+    recordChange(ChangeType::NodeVisibilityDidChange));
+  m_notifierConnection +=
+    selectionDidChangeNotifier.connect(this, &MapDocument::recordSelectionChange);
+  m_notifierConnection += documentWasClearedNotifier.connect(recordReset);
+  m_notifierConnection += documentWasNewedNotifier.connect(recordReset);
+  m_notifierConnection += documentWasLoadedNotifier.connect(recordReset);
+
+  // the file position index refers to nodes and their positions in the saved file
+  const auto invalidateFilePositionIndex = [this](const auto&...) {
+    this->invalidateFilePositionIndex();
+  };
+  m_notifierConnection += documentWasClearedNotifier.connect(invalidateFilePositionIndex);
+  m_notifierConnection += documentWasNewedNotifier.connect(invalidateFilePositionIndex);
+  m_notifierConnection += documentWasLoadedNotifier.connect(invalidateFilePositionIndex);
+  m_notifierConnection += documentWasSavedNotifier.connect(invalidateFilePositionIndex);
+  m_notifierConnection += nodesWereAddedNotifier.connect(invalidateFilePositionIndex);
+  m_notifierConnection += nodesWereRemovedNotifier.connect(invalidateFilePositionIndex);
+
+  // the editor context caches whether nodes are visible, editable and selectable
+  const auto invalidateEditorContextCache = [this](const auto&...) {
+    m_editorContext->invalidateCachedState();
+  };
+  m_notifierConnection +=
+    documentWasClearedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += documentWasNewedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += documentWasLoadedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += nodesWereAddedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += nodesWereRemovedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += nodesDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    nodeVisibilityDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    nodeLockingDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += groupWasOpenedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += groupWasClosedNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    selectionDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    brushFacesDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    entityDefinitionsDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection += modsDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    textureCollectionsDidChangeNotifier.connect(invalidateEditorContextCache);
+  m_notifierConnection +=
+    prefs.preferenceDidChangeNotifier.connect(invalidateEditorContextCache);
 }
 
 void MapDocument::textureCollectionsWillChange()
@@ -5109,9 +5913,8 @@ void MapDocument::preferenceDidChange(const std::filesystem::path& path)
   {
     const Model::GameFactory& gameFactory = Model::GameFactory::instance();
     const std::filesystem::path newGamePath = gameFactory.gamePath(m_game->gameName());
-    m_game->setGamePath(newGamePath, logger());
-
     clearEntityModels();
+    m_game->setGamePath(newGamePath, logger());
     setEntityModels();
 
     reloadTextures();
@@ -5126,6 +5929,43 @@ void MapDocument::preferenceDidChange(const std::filesystem::path& path)
     m_textureManager->setTextureMode(
       pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
   }
+  else if (path == Preferences::CompressTextures.path())
+  {
+    // textures that are already uploaded must be reloaded to change their format
+    m_textureManager->setCompressTextures(pref(Preferences::CompressTextures));
+    reloadTextures();
+    setTextures();
+  }
+  else if (path == Preferences::LoadTexturesOnDemand.path())
+  {
+    m_textureManager->setLoadTexturesOnDemand(pref(Preferences::LoadTexturesOnDemand));
+    reloadTextures();
+    setTextures();
+  }
+  else if (path == Preferences::UseTextureCache.path())
+  {
+    updateTextureCacheDirectory();
+  }
+  else if (path == Preferences::UseModelCache.path())
+  {
+    updateModelCacheDirectory();
+  }
+}
+
+void MapDocument::updateTextureCacheDirectory()
+{
+  m_textureManager->setTextureCacheDirectory(
+    pref(Preferences::UseTextureCache)
+      ? std::optional{IO::SystemPaths::userDataDirectory() / "TextureCache"}
+      : std::nullopt);
+}
+
+void MapDocument::updateModelCacheDirectory()
+{
+  m_entityModelManager->setModelCacheDirectory(
+    pref(Preferences::UseModelCache)
+      ? std::optional{IO::SystemPaths::userDataDirectory() / "ModelCache"}
+      : std::nullopt);
 }
 
 void MapDocument::commandDone(Command& command)
@@ -5148,6 +5988,89 @@ void MapDocument::transactionUndone(const std::string& name)
   debug() << "Transaction '" << name << "' undone";
 }
 
+void MapDocument::beginNodeChangeBatch()
+{
+  ++m_nodeChangeBatchDepth;
+}
+
+void MapDocument::endNodeChangeBatch()
+{
+  assert(m_nodeChangeBatchDepth > 0);
+  if (--m_nodeChangeBatchDepth > 0 || m_batchedChangedNodes.empty())
+  {
+    return;
+  }
+
+  // removed nodes were only erased from the set, and nodes that were removed and added
+  // again may occur more than once in the vector
+  auto changedNodes = std::vector<Model::Node*>{};
+  changedNodes.reserve(m_batchedChangedNodeSet.size());
+  for (auto* node : m_batchedChangedNodes)
+  {
+    if (m_batchedChangedNodeSet.erase(node) > 0)
+    {
+      changedNodes.push_back(node);
+    }
+  }
+  clearBatchedNodeChanges();
+
+  if (!changedNodes.empty())
+  {
+    batchedNodesDidChangeNotifier(changedNodes);
+  }
+}
+
+void MapDocument::batchNodesDidChange(const std::vector<Model::Node*>& nodes)
+{
+  beginNodeChangeBatch();
+  for (auto* node : nodes)
+  {
+    if (m_batchedChangedNodeSet.insert(node).second)
+    {
+      m_batchedChangedNodes.push_back(node);
+    }
+  }
+  endNodeChangeBatch();
+}
+
+static void eraseNodesRecursively(
+  std::unordered_set<Model::Node*>& nodeSet, const std::vector<Model::Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    nodeSet.erase(node);
+    eraseNodesRecursively(nodeSet, node->children());
+  }
+}
+
+void MapDocument::unbatchRemovedNodes(const std::vector<Model::Node*>& nodes)
+{
+  if (!m_batchedChangedNodeSet.empty())
+  {
+    eraseNodesRecursively(m_batchedChangedNodeSet, nodes);
+  }
+}
+
+void MapDocument::clearBatchedNodeChanges()
+{
+  m_batchedChangedNodes.clear();
+  m_batchedChangedNodeSet.clear();
+}
+
+void MapDocument::recordSelectionChange(const Selection& selection)
+{
+  const auto getNode = [](const auto& faceHandle) -> Model::Node* {
+    return faceHandle.node();
+  };
+  auto nodes = kdl::vec_concat(
+    selection.selectedNodes(),
+    selection.deselectedNodes(),
+    kdl::vec_transform(selection.selectedBrushFaces(), getNode),
+    kdl::vec_transform(selection.deselectedBrushFaces(), getNode));
+  nodes = kdl::vec_sort_and_remove_duplicates(std::move(nodes));
+  m_changeJournal->record(ChangeType::SelectionDidChange, std::move(nodes));
+}
+
 Transaction::Transaction(std::weak_ptr<MapDocument> document, std::string name)
   : Transaction{kdl::mem_lock(document), std::move(name)}
 {
@@ -33,13 +33,16 @@
 
 #include "vm/bbox.h"
 #include "vm/forward.h"
+#include "vm/mat.h"
 #include "vm/util.h"
 
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -66,6 +69,7 @@ class BrushFaceHandle;
 class BrushFaceAttributes;
 class EditorContext;
 class Entity;
+class FilePositionIndex;
 class Game;
 class Issue;
 enum class MapFormat;
@@ -82,12 +86,15 @@ enum class WrapStyle;
 namespace TrenchBroom::View
 {
 class Action;
+class ChangeJournal;
+struct BrushFaceAttributesState;
 class Command;
 class CommandResult;
 class Grid;
 enum class PasteType;
 class RepeatStack;
 class Selection;
+class TaskScheduler;
 class UndoableCommand;
 class ViewEffectsService;
 enum class MapTextEncoding;
@@ -131,6 +138,10 @@ protected:
   ActionList m_tagActions;
   ActionList m_entityDefinitionActions;
 
+  // entity definitions that are loaded while the map is being parsed
+  struct PendingEntityDefinitions;
+  std::unique_ptr<PendingEntityDefinitions> m_pendingEntityDefinitions;
+
   std::filesystem::path m_path;
   size_t m_lastSaveModificationCount;
   size_t m_modificationCount;
@@ -143,6 +154,10 @@ protected:
   vm::bbox3 m_lastSelectionBounds;
   mutable vm::bbox3 m_selectionBounds;
   mutable bool m_selectionBoundsValid;
+  std::optional<vm::mat4x4> m_selectionPreviewTransformation;
+
+  struct TexturePreview;
+  std::unique_ptr<TexturePreview> m_texturePreview;
 
   ViewEffectsService* m_viewEffectsService;
 
@@ -155,6 +170,21 @@ protected:
    */
   std::unique_ptr<RepeatStack> m_repeatStack;
 
+  /*
+   * Changed nodes are collected here while a transaction, a command, or an undo / redo
+   * is being executed, and are passed to batchedNodesDidChangeNotifier once the
+   * outermost of these completes.
+   */
+  size_t m_nodeChangeBatchDepth = 0;
+  std::vector<Model::Node*> m_batchedChangedNodes;
+  std::unordered_set<Model::Node*> m_batchedChangedNodeSet;
+
+  std::unique_ptr<ChangeJournal> m_changeJournal;
+  std::unique_ptr<TaskScheduler> m_taskScheduler;
+
+  // built on demand and discarded when nodes are added or removed or the map is saved
+  mutable std::unique_ptr<Model::FilePositionIndex> m_filePositionIndex;
+
 public: // notification
   Notifier<Command&> commandDoNotifier;
   Notifier<Command&> commandDoneNotifier;
@@ -185,6 +215,17 @@ public: // notification
   Notifier<const std::vector<Model::Node*>&> nodesWillChangeNotifier;
   Notifier<const std::vector<Model::Node*>&> nodesDidChangeNotifier;
 
+  /**
+   * Like nodesDidChangeNotifier, but notified only once when the outermost transaction,
+   * command, undo or redo completes, passing every changed node exactly once. Nodes that
+   * were removed from the document in the meantime are omitted.
+   *
+   * Observers that rebuild expensive state and need not reflect intermediate states (e.g.
+   * while a tool drag is in progress) should connect to this notifier instead of
+   * nodesDidChangeNotifier.
+   */
+  Notifier<const std::vector<Model::Node*>&> batchedNodesDidChangeNotifier;
+
   Notifier<const std::vector<Model::Node*>&> nodeVisibilityDidChangeNotifier;
   Notifier<const std::vector<Model::Node*>&> nodeLockingDidChangeNotifier;
 
@@ -201,6 +242,8 @@ public: // notification
   Notifier<> entityDefinitionsWillChangeNotifier;
   Notifier<> entityDefinitionsDidChangeNotifier;
 
+  Notifier<> entityModelsWereLoadedNotifier;
+
   Notifier<> modsWillChangeNotifier;
   Notifier<> modsDidChangeNotifier;
 
@@ -319,8 +362,19 @@ public: // text encoding
 public: // copy and paste
   std::string serializeSelectedNodes();
   std::string serializeSelectedBrushFaces();
+  /**
+   * Serializes the selected nodes in the binary node format, which is faster to write and
+   * read than the map file format and preserves all numbers exactly. Intended for copying
+   * nodes between TrenchBroom instances.
+   */
+  std::string serializeSelectedNodesBinary();
 
   PasteType paste(const std::string& str);
+  /**
+   * Pastes nodes from data in the binary node format. Returns PasteType::Failed if the
+   * data is malformed or was written for a different map format.
+   */
+  PasteType pasteBinary(const std::string& data);
 
 private:
   bool pasteNodes(const std::vector<Model::Node*>& nodes);
@@ -393,6 +447,19 @@ public: // selection
   const std::string& currentTextureName() const override;
   void setCurrentTextureName(const std::string& currentTextureName);
 
+  /**
+   * Returns the transformation that the renderers apply to the selected objects, or
+   * nullopt if there is none. Tools set it to preview an operation on the selection
+   * while dragging, and apply the operation to the document when the drag ends.
+   */
+  const std::optional<vm::mat4x4>& selectionPreviewTransformation() const;
+  void setSelectionPreviewTransformation(std::optional<vm::mat4x4> transformation);
+
+  /**
+   * Returns the selection bounds transformed by the selection preview transformation.
+   */
+  vm::bbox3 selectionPreviewBounds() const;
+
   void selectAllNodes() override;
   void selectSiblings() override;
   void selectTouching(bool del) override;
@@ -413,10 +480,27 @@ protected:
   void updateLastSelectionBounds();
   void invalidateSelectionBounds();
 
+  /**
+   * Adds the bounds of the given nodes, which have just been selected, to the selection
+   * bounds.
+   */
+  void addToSelectionBounds(const std::vector<Model::Node*>& nodes);
+
+  /**
+   * Updates the selection bounds after the bounds of the given selected nodes changed
+   * from the given old bounds. The selection bounds are only recomputed if they might
+   * have shrunk.
+   */
+  void updateSelectionBounds(
+    const std::vector<Model::Node*>& nodes, const std::vector<vm::bbox3>& oldBounds);
+
 private:
   void validateSelectionBounds() const;
   void clearSelection();
 
+  const Model::FilePositionIndex& filePositionIndex() const;
+  void invalidateFilePositionIndex();
+
 public: // adding, removing, reparenting, and duplicating nodes, declared in MapFacade
         // interface
   std::vector<Model::Node*> addNodes(
@@ -556,6 +640,10 @@ public: // modifying objects, declared in MapFacade interface
   bool swapNodeContents(
     const std::string& commandName,
     std::vector<std::pair<Model::Node*, Model::NodeContents>> nodesToSwap);
+  bool swapBrushFaceAttributes(
+    const std::string& commandName,
+    std::vector<std::pair<Model::BrushNode*, std::vector<BrushFaceAttributesState>>>
+      faces);
   bool transformObjects(const std::string& commandName, const vm::mat4x4& transformation);
 
   bool translateObjects(const vm::vec3& delta) override;
@@ -620,6 +708,33 @@ public:
     const vm::vec3f& cameraRight,
     vm::direction cameraRelativeFlipDirection);
 
+public: // interactive texturing
+  /**
+   * Starts an interactive change of the texturing of the selected faces, e.g. while the
+   * user drags in the UV editor. Until the change is committed or cancelled, the preview
+   * functions below change the faces directly. They do not create undoable commands and
+   * only notify brushFacesDidChangeNotifier, so only the changed faces are updated.
+   */
+  void startTexturePreview();
+  bool isTexturePreviewActive() const;
+  bool previewFaceAttributes(const Model::ChangeBrushFaceAttributesRequest& request);
+  bool previewShearTextures(const vm::vec2f& factors);
+  /**
+   * Ends the interactive change and records it as a single undoable command with the
+   * given name.
+   */
+  bool commitTexturePreview(const std::string& commandName);
+  /**
+   * Ends the interactive change and restores the faces to their original state.
+   */
+  void cancelTexturePreview();
+
+private:
+  bool previewTextureChange(
+    const std::vector<Model::BrushFaceHandle>& faces,
+    const std::function<void(Model::BrushFace&)>& change);
+  std::vector<Model::BrushFaceHandle> restoreTexturePreviewBrushes();
+
 public: // modifying vertices, declared in MapFacade interface
   bool snapVertices(FloatType snapTo) override;
 
@@ -641,6 +756,7 @@ public: // command processing
   bool canRedoCommand() const;
   const std::string& undoCommandName() const;
   const std::string& redoCommandName() const;
+  size_t undoMemoryUsage() const;
   void undoCommand();
   void redoCommand();
   bool canRepeatCommands() const;
@@ -665,6 +781,7 @@ private: // subclassing interface for command processing
   virtual bool doCanRedoCommand() const = 0;
   virtual const std::string& doGetUndoCommandName() const = 0;
   virtual const std::string& doGetRedoCommandName() const = 0;
+  virtual size_t doGetUndoMemoryUsage() const = 0;
   virtual void doUndoCommand() = 0;
   virtual void doRedoCommand() = 0;
 
@@ -706,6 +823,13 @@ public: // asset management
     std::vector<std::unique_ptr<Assets::EntityDefinition>> definitions);
 
   void reloadTextureCollections();
+
+  /**
+   * Reloads the textures in the given directories whose files were modified. If files
+   * were added or removed, all texture collections are reloaded.
+   */
+  void reloadModifiedTextures(const std::vector<std::filesystem::path>& directories);
+
   void reloadEntityDefinitions();
 
   std::vector<std::filesystem::path> enabledTextureCollections() const;
@@ -718,6 +842,10 @@ private:
   void loadAssets();
   void unloadAssets();
 
+  void prefetchEntityDefinitions(
+    std::shared_ptr<Model::Game> game, const std::filesystem::path& path);
+  std::optional<Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>>>
+  takePendingEntityDefinitions(const std::filesystem::path& path);
   void loadEntityDefinitions();
   void unloadEntityDefinitions();
 
@@ -748,6 +876,18 @@ protected:
   void unsetEntityModels();
   void unsetEntityModels(const std::vector<Model::Node*>& nodes);
 
+public:
+  /**
+   * Takes over the entity models that have finished loading in the background and sets
+   * them for the entities that were waiting for them. Afterwards, models that are not
+   * used by any entity are evicted if the entity models exceed their memory limit. Must
+   * be called periodically on the main thread.
+   */
+  void processLoadedEntityModels();
+
+private:
+  void evictEntityModels();
+
 protected: // search paths and mods
   std::vector<std::filesystem::path> externalSearchPaths() const;
   void updateGameSearchPaths();
@@ -799,6 +939,18 @@ public: // modification count
   bool modified() const;
   size_t modificationCount() const;
 
+  /**
+   * Returns the journal of the changes made to this document. Consumers that maintain
+   * state derived from the world can use it to update incrementally.
+   */
+  const ChangeJournal& changeJournal() const;
+
+  /**
+   * Returns the scheduler for background tasks whose results are applied to this
+   * document.
+   */
+  TaskScheduler& taskScheduler();
+
 private:
   void setLastSaveModificationCount();
   void clearModificationCount();
@@ -812,10 +964,22 @@ private: // observers
   void modsWillChange();
   void modsDidChange();
   void preferenceDidChange(const std::filesystem::path& path);
+  void updateTextureCacheDirectory();
+  void updateModelCacheDirectory();
   void commandDone(Command& command);
   void commandUndone(UndoableCommand& command);
   void transactionDone(const std::string& name);
   void transactionUndone(const std::string& name);
+
+private: // node change batching
+  void beginNodeChangeBatch();
+  void endNodeChangeBatch();
+  void batchNodesDidChange(const std::vector<Model::Node*>& nodes);
+  void unbatchRemovedNodes(const std::vector<Model::Node*>& nodes);
+  void clearBatchedNodeChanges();
+
+private: // change journal
+  void recordSelectionChange(const Selection& selection);
 };
 
 class Transaction
@@ -56,6 +56,8 @@
 #include "vm/polygon.h"
 #include "vm/segment.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <string>
@@ -74,6 +76,7 @@ std::shared_ptr<MapDocument> MapDocumentCommandFacade::newMapDocument()
 MapDocumentCommandFacade::MapDocumentCommandFacade()
   : m_commandProcessor(std::make_unique<CommandProcessor>(this))
 {
+  updateUndoMemoryLimit();
   connectObservers();
 }
 
@@ -104,12 +107,12 @@ void MapDocumentCommandFacade::performSelect(const std::vector<Model::Node*>& no
   }
 
   m_selectedNodes.addNodes(selected);
+  addToSelectionBounds(selected);
 
   Selection selection;
   selection.addSelectedNodes(selected);
 
   selectionDidChangeNotifier(selection);
-  invalidateSelectionBounds();
 }
 
 void MapDocumentCommandFacade::performSelect(
@@ -418,6 +421,12 @@ void MapDocumentCommandFacade::performSwapNodeContents(
   NotifyBeforeAndAfter notifyDescendants(
     nodesWillChangeNotifier, nodesDidChangeNotifier, descendants);
 
+  // the bounds of the selected nodes among the changed nodes and their ancestors
+  const auto changedSelectedNodes = kdl::vec_filter(
+    kdl::vec_concat(nodes, parents), [](const auto* node) { return node->selected(); });
+  const auto oldSelectedBounds = kdl::vec_transform(
+    changedSelectedNodes, [](const auto* node) { return node->logicalBounds(); });
+
   const auto [notifyWadsChange, notifyEntityDefinitionsChange, notifyModsChange] =
     notifySpecialWorldProperties(*game(), nodesToSwap);
   NotifyBeforeAndAfter notifyWads(
@@ -473,106 +482,106 @@ void MapDocumentCommandFacade::performSwapNodeContents(
     setTextures(nodes);
   }
 
-  invalidateSelectionBounds();
+  updateSelectionBounds(changedSelectedNodes, oldSelectedBounds);
 }
 
-std::map<Model::Node*, Model::VisibilityState> MapDocumentCommandFacade::
-  setVisibilityState(
-    const std::vector<Model::Node*>& nodes, const Model::VisibilityState visibilityState)
+NodeStateRuns<Model::VisibilityState> MapDocumentCommandFacade::setVisibilityState(
+  const std::vector<Model::Node*>& nodes, const Model::VisibilityState visibilityState)
 {
-  std::map<Model::Node*, Model::VisibilityState> result;
+  auto oldStates = NodeStateRuns<Model::VisibilityState>{};
 
-  std::vector<Model::Node*> changedNodes;
+  auto changedNodes = std::vector<Model::Node*>{};
   changedNodes.reserve(nodes.size());
 
-  for (Model::Node* node : nodes)
+  for (auto* node : nodes)
   {
-    const Model::VisibilityState oldState = node->visibilityState();
+    oldStates.push_back(node->visibilityState());
     if (node->setVisibilityState(visibilityState))
     {
       changedNodes.push_back(node);
-      result[node] = oldState;
     }
   }
 
   nodeVisibilityDidChangeNotifier(changedNodes);
-  return result;
+  return oldStates;
 }
 
-std::map<Model::Node*, Model::VisibilityState> MapDocumentCommandFacade::
-  setVisibilityEnsured(const std::vector<Model::Node*>& nodes)
+NodeStateRuns<Model::VisibilityState> MapDocumentCommandFacade::setVisibilityEnsured(
+  const std::vector<Model::Node*>& nodes)
 {
-  std::map<Model::Node*, Model::VisibilityState> result;
+  auto oldStates = NodeStateRuns<Model::VisibilityState>{};
 
-  std::vector<Model::Node*> changedNodes;
+  auto changedNodes = std::vector<Model::Node*>{};
   changedNodes.reserve(nodes.size());
 
-  for (Model::Node* node : nodes)
+  for (auto* node : nodes)
   {
-    const Model::VisibilityState oldState = node->visibilityState();
+    oldStates.push_back(node->visibilityState());
     if (node->ensureVisible())
     {
       changedNodes.push_back(node);
-      result[node] = oldState;
     }
   }
 
   nodeVisibilityDidChangeNotifier(changedNodes);
-  return result;
+  return oldStates;
 }
 
 void MapDocumentCommandFacade::restoreVisibilityState(
-  const std::map<Model::Node*, Model::VisibilityState>& nodes)
+  const std::vector<Model::Node*>& nodes,
+  const NodeStateRuns<Model::VisibilityState>& oldStates)
 {
-  std::vector<Model::Node*> changedNodes;
+  auto changedNodes = std::vector<Model::Node*>{};
   changedNodes.reserve(nodes.size());
 
-  for (const auto& [node, state] : nodes)
-  {
-    if (node->setVisibilityState(state))
+  // restore in reverse order so that a node that occurs more than once gets its first
+  // recorded state
+  oldStates.visitReversed([&](const auto i, const auto state) {
+    if (nodes[i]->setVisibilityState(state))
     {
-      changedNodes.push_back(node);
+      changedNodes.push_back(nodes[i]);
     }
-  }
+  });
 
   nodeVisibilityDidChangeNotifier(changedNodes);
 }
 
-std::map<Model::Node*, Model::LockState> MapDocumentCommandFacade::setLockState(
+NodeStateRuns<Model::LockState> MapDocumentCommandFacade::setLockState(
   const std::vector<Model::Node*>& nodes, const Model::LockState lockState)
 {
-  std::map<Model::Node*, Model::LockState> result;
+  auto oldStates = NodeStateRuns<Model::LockState>{};
 
-  std::vector<Model::Node*> changedNodes;
+  auto changedNodes = std::vector<Model::Node*>{};
   changedNodes.reserve(nodes.size());
 
-  for (Model::Node* node : nodes)
+  for (auto* node : nodes)
   {
-    const Model::LockState oldState = node->lockState();
+    oldStates.push_back(node->lockState());
     if (node->setLockState(lockState))
     {
       changedNodes.push_back(node);
-      result[node] = oldState;
     }
   }
 
   nodeLockingDidChangeNotifier(changedNodes);
-  return result;
+  return oldStates;
 }
 
 void MapDocumentCommandFacade::restoreLockState(
-  const std::map<Model::Node*, Model::LockState>& nodes)
+  const std::vector<Model::Node*>& nodes,
+  const NodeStateRuns<Model::LockState>& oldStates)
 {
-  std::vector<Model::Node*> changedNodes;
+  auto changedNodes = std::vector<Model::Node*>{};
   changedNodes.reserve(nodes.size());
 
-  for (const auto& [node, state] : nodes)
-  {
-    if (node->setLockState(state))
+  // restore in reverse order so that a node that occurs more than once gets its first
+  // recorded state
+  oldStates.visitReversed([&](const auto i, const auto state) {
+    if (nodes[i]->setLockState(state))
     {
-      changedNodes.push_back(node);
+      changedNodes.push_back(nodes[i]);
     }
-  }
+  });
 
   nodeLockingDidChangeNotifier(changedNodes);
 }
@@ -631,6 +640,21 @@ void MapDocumentCommandFacade::connectObservers()
     m_commandProcessor->transactionDoneNotifier.connect(transactionDoneNotifier);
   m_notifierConnection +=
     m_commandProcessor->transactionUndoneNotifier.connect(transactionUndoneNotifier);
+
+  auto& prefs = PreferenceManager::instance();
+  m_notifierConnection += prefs.preferenceDidChangeNotifier.connect(
+    [&](const std::filesystem::path& path) {
+      if (path == Preferences::UndoMemoryLimit.path())
+      {
+        updateUndoMemoryLimit();
+      }
+    });
+}
+
+void MapDocumentCommandFacade::updateUndoMemoryLimit()
+{
+  const auto memoryLimitMB = size_t(std::max(0, pref(Preferences::UndoMemoryLimit)));
+  m_commandProcessor->setMemoryLimit(memoryLimitMB * 1024u * 1024u);
 }
 
 bool MapDocumentCommandFacade::isCurrentDocumentStateObservable() const
@@ -658,6 +682,11 @@ const std::string& MapDocumentCommandFacade::doGetRedoCommandName() const
   return m_commandProcessor->redoCommandName();
 }
 
+size_t MapDocumentCommandFacade::doGetUndoMemoryUsage() const
+{
+  return m_commandProcessor->memoryUsage();
+}
+
 void MapDocumentCommandFacade::doUndoCommand()
 {
   m_commandProcessor->undo();
@@ -23,6 +23,7 @@
 #include "Model/NodeContents.h"
 #include "NotifierConnection.h"
 #include "View/MapDocument.h"
+#include "View/NodeStateRuns.h"
 
 #include "vm/forward.h"
 
@@ -91,15 +92,20 @@ public: // swapping node contents
     std::vector<std::pair<Model::Node*, Model::NodeContents>>& nodesToSwap);
 
 public: // Node Visibility
-  std::map<Model::Node*, Model::VisibilityState> setVisibilityState(
+  // These functions return the old states of the given nodes, which can be passed to the
+  // corresponding restore function together with the same nodes.
+  NodeStateRuns<Model::VisibilityState> setVisibilityState(
     const std::vector<Model::Node*>& nodes, Model::VisibilityState visibilityState);
-  std::map<Model::Node*, Model::VisibilityState> setVisibilityEnsured(
+  NodeStateRuns<Model::VisibilityState> setVisibilityEnsured(
     const std::vector<Model::Node*>& nodes);
   void restoreVisibilityState(
-    const std::map<Model::Node*, Model::VisibilityState>& nodes);
-  std::map<Model::Node*, Model::LockState> setLockState(
+    const std::vector<Model::Node*>& nodes,
+    const NodeStateRuns<Model::VisibilityState>& oldStates);
+  NodeStateRuns<Model::LockState> setLockState(
     const std::vector<Model::Node*>& nodes, Model::LockState lockState);
-  void restoreLockState(const std::map<Model::Node*, Model::LockState>& nodes);
+  void restoreLockState(
+    const std::vector<Model::Node*>& nodes,
+    const NodeStateRuns<Model::LockState>& oldStates);
 
 public: // layers
   using MapDocument::performSetCurrentLayer;
@@ -117,6 +123,7 @@ public: // modification count
 
 private: // notification
   void connectObservers();
+  void updateUndoMemoryLimit();
   void documentWasNewed(MapDocument* document);
   void documentWasLoaded(MapDocument* document);
 
@@ -127,6 +134,7 @@ private: // implement MapDocument interface
   bool doCanRedoCommand() const override;
   const std::string& doGetUndoCommandName() const override;
   const std::string& doGetRedoCommandName() const override;
+  size_t doGetUndoMemoryUsage() const override;
   void doUndoCommand() override;
   void doRedoCommand() override;
 
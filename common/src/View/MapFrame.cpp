@@ -24,6 +24,7 @@
 #include <QClipboard>
 #include <QComboBox>
 #include <QFileDialog>
+#include <QFileSystemWatcher>
 #include <QInputDialog>
 #include <QLabel>
 #include <QMessageBox>
@@ -32,16 +33,19 @@
 #include <QStatusBar>
 #include <QString>
 #include <QStringList>
+#include <QHeaderView>
 #include <QTableWidget>
 #include <QTimer>
 #include <QToolBar>
 #include <QVBoxLayout>
 #include <QtGlobal>
 
+#include "Assets/TextureManager.h"
 #include "Console.h"
 #include "Error.h"
 #include "Exceptions.h"
 #include "FileLogger.h"
+#include "IO/DiskIO.h"
 #include "IO/ExportOptions.h"
 #include "IO/PathQt.h"
 #include "Model/BrushNode.h"
@@ -60,6 +64,7 @@
 #include "Model/WorldNode.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "TrenchBroomApp.h"
 #include "View/Actions.h"
 #include "View/Autosaver.h"
@@ -82,6 +87,7 @@
 #include "View/MapView2D.h"
 #include "View/MapViewBase.h"
 #include "View/MapViewToolBox.h"
+#include "View/MemoryReport.h"
 #include "View/ObjExportDialog.h"
 #include "View/PasteType.h"
 #include "View/QtUtils.h"
@@ -90,16 +96,19 @@
 #include "View/SignalDelayer.h"
 #include "View/Splitter.h"
 #include "View/SwitchableMapViewContainer.h"
+#include "View/TaskScheduler.h"
 #include "View/VertexTool.h"
 #include "View/ViewUtils.h"
 
 #include "kdl/overload.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/vec.h"
 #include "vm/vec_io.h"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <iterator>
@@ -116,8 +125,16 @@ MapFrame::MapFrame(FrameManager* frameManager, std::shared_ptr<MapDocument> docu
   , m_frameManager(frameManager)
   , m_document(std::move(document))
   , m_lastInputTime(std::chrono::system_clock::now())
-  , m_autosaver(std::make_unique<Autosaver>(m_document))
+  , m_autosaver(std::make_unique<Autosaver>(
+      m_document,
+      std::chrono::milliseconds(10 * 60 * 1000),
+      50,
+      size_t(std::max(0, pref(Preferences::AutosaveDeltaCount)))))
   , m_autosaveTimer(nullptr)
+  , m_entityModelTimer(nullptr)
+  , m_taskTimer(nullptr)
+  , m_textureDirectoryWatcher(nullptr)
+  , m_textureReloadTimer(nullptr)
   , m_toolBar(nullptr)
   , m_hSplitter(nullptr)
   , m_vSplitter(nullptr)
@@ -129,6 +146,9 @@ MapFrame::MapFrame(FrameManager* frameManager, std::shared_ptr<MapDocument> docu
   , m_inspector(nullptr)
   , m_gridChoice(nullptr)
   , m_statusBarLabel(nullptr)
+  , m_undoMemoryLabel(nullptr)
+  , m_taskLabel(nullptr)
+  , m_cancelTasksButton(nullptr)
   , m_compilationDialog(nullptr)
   , m_recentDocumentsMenu(nullptr)
   , m_undoAction(nullptr)
@@ -161,6 +181,20 @@ MapFrame::MapFrame(FrameManager* frameManager, std::shared_ptr<MapDocument> docu
   m_autosaveTimer = new QTimer(this);
   m_autosaveTimer->start(1000);
 
+  // entity models are loaded in the background and must be picked up on the main thread
+  m_entityModelTimer = new QTimer(this);
+  m_entityModelTimer->start(100);
+
+  // the results of background tasks must be applied on the main thread
+  m_taskTimer = new QTimer(this);
+  m_taskTimer->start(100);
+
+  // a texture file is usually written in several steps, so wait for them to settle
+  m_textureDirectoryWatcher = new QFileSystemWatcher(this);
+  m_textureReloadTimer = new QTimer(this);
+  m_textureReloadTimer->setSingleShot(true);
+  m_textureReloadTimer->setInterval(500);
+
   connectObservers();
   bindEvents();
 
@@ -200,7 +234,9 @@ MapFrame::~MapFrame()
 
   // let's trigger a final autosave before releasing the document
   NullLogger logger;
+  m_autosaver->finishPendingAutosave(logger);
   m_autosaver->triggerAutosave(logger);
+  m_autosaver->finishPendingAutosave(logger);
 
   m_document->setViewEffectsService(nullptr);
   m_document.reset();
@@ -338,6 +374,11 @@ void MapFrame::updateUndoRedoActions()
       m_redoAction->setEnabled(false);
     }
   }
+  if (m_undoMemoryLabel != nullptr)
+  {
+    const auto usageMB = double(document->undoMemoryUsage()) / (1024.0 * 1024.0);
+    m_undoMemoryLabel->setText(tr("Undo: %1 MB").arg(usageMB, 0, 'f', 1));
+  }
 }
 
 void MapFrame::addRecentDocumentsMenu()
@@ -494,6 +535,21 @@ void MapFrame::createStatusBar()
 {
   m_statusBarLabel = new QLabel();
   statusBar()->addWidget(m_statusBarLabel);
+
+  m_undoMemoryLabel = new QLabel();
+  m_undoMemoryLabel->setToolTip(
+    tr("Estimated memory used by the undo history. If an undo memory limit is set "
+       "and exceeded, the oldest undo steps are discarded."));
+  statusBar()->addPermanentWidget(m_undoMemoryLabel);
+
+  m_taskLabel = new QLabel();
+  m_taskLabel->setVisible(false);
+  statusBar()->addPermanentWidget(m_taskLabel);
+
+  m_cancelTasksButton = new QPushButton(tr("Cancel"));
+  m_cancelTasksButton->setToolTip(tr("Cancel the running background tasks"));
+  m_cancelTasksButton->setVisible(false);
+  statusBar()->addPermanentWidget(m_cancelTasksButton);
 }
 
 template <typename T>
@@ -773,6 +829,31 @@ void MapFrame::updateStatusBarDelayed()
   m_updateStatusBarSignalDelayer->queueSignal();
 }
 
+void MapFrame::updateTaskStatus()
+{
+  const auto tasks = m_document->taskScheduler().tasks();
+  if (tasks.empty())
+  {
+    m_taskLabel->setVisible(false);
+    m_cancelTasksButton->setVisible(false);
+    return;
+  }
+
+  const auto& task = tasks.front();
+  const auto percent = int(task.progress * 100.0f);
+  const auto text =
+    tasks.size() == 1
+      ? tr("%1: %2%").arg(QString::fromStdString(task.name)).arg(percent)
+      : tr("%1: %2% (%3 more)")
+          .arg(QString::fromStdString(task.name))
+          .arg(percent)
+          .arg(tasks.size() - 1);
+
+  m_taskLabel->setText(text);
+  m_taskLabel->setVisible(true);
+  m_cancelTasksButton->setVisible(true);
+}
+
 void MapFrame::connectObservers()
 {
   PreferenceManager& prefs = PreferenceManager::instance();
@@ -789,6 +870,8 @@ void MapFrame::connectObservers()
     m_document->documentWasSavedNotifier.connect(this, &MapFrame::documentDidChange);
   m_notifierConnection += m_document->documentModificationStateDidChangeNotifier.connect(
     this, &MapFrame::documentModificationStateDidChange);
+  m_notifierConnection += m_document->textureCollectionsDidChangeNotifier.connect(
+    this, &MapFrame::textureCollectionsDidChange);
   m_notifierConnection +=
     m_document->transactionDoneNotifier.connect(this, &MapFrame::transactionDone);
   m_notifierConnection +=
@@ -847,6 +930,20 @@ void MapFrame::documentModificationStateDidChange()
   updateTitleDelayed();
 }
 
+void MapFrame::textureCollectionsDidChange()
+{
+  if (const auto directories = m_textureDirectoryWatcher->directories();
+      !directories.isEmpty())
+  {
+    m_textureDirectoryWatcher->removePaths(directories);
+  }
+
+  for (const auto& directory : m_document->textureManager().textureDirectories())
+  {
+    m_textureDirectoryWatcher->addPath(IO::pathAsQString(directory));
+  }
+}
+
 void MapFrame::transactionDone(const std::string& /* name */)
 {
   QTimer::singleShot(0, this, [this]() {
@@ -947,6 +1044,31 @@ void MapFrame::portalFileDidChange()
 void MapFrame::bindEvents()
 {
   connect(m_autosaveTimer, &QTimer::timeout, this, &MapFrame::triggerAutosave);
+  connect(m_entityModelTimer, &QTimer::timeout, this, [this]() {
+    m_document->processLoadedEntityModels();
+  });
+  connect(m_taskTimer, &QTimer::timeout, this, [this]() {
+    m_document->taskScheduler().processFinishedTasks();
+    updateTaskStatus();
+  });
+  connect(
+    m_textureDirectoryWatcher,
+    &QFileSystemWatcher::directoryChanged,
+    this,
+    [this](const QString& directory) {
+      m_modifiedTextureDirectories.push_back(IO::pathFromQString(directory));
+      m_textureReloadTimer->start();
+    });
+  connect(m_textureReloadTimer, &QTimer::timeout, this, [this]() {
+    const auto directories =
+      kdl::vec_sort_and_remove_duplicates(std::move(m_modifiedTextureDirectories));
+    m_modifiedTextureDirectories.clear();
+    m_document->reloadModifiedTextures(directories);
+  });
+  connect(m_cancelTasksButton, &QPushButton::clicked, this, [this]() {
+    m_document->taskScheduler().cancelAll();
+    updateTaskStatus();
+  });
   connect(qApp, &QApplication::focusChanged, this, &MapFrame::focusChange);
   connect(
     m_gridChoice,
@@ -1057,7 +1179,10 @@ bool MapFrame::saveDocumentAs()
     const auto fileName = originalPath.filename();
 
     const QString newFileName = QFileDialog::getSaveFileName(
-      this, tr("Save map file"), IO::pathAsQString(originalPath), "Map files (*.map)");
+      this,
+      tr("Save map file"),
+      IO::pathAsQString(originalPath),
+      "Map files (*.map *.map.gz)");
     if (newFileName.isEmpty())
     {
       return false;
@@ -1154,6 +1279,35 @@ bool MapFrame::exportDocument(const IO::ExportOptions& options)
     .value();
 }
 
+void MapFrame::exportRenderPassTimings()
+{
+  const auto csv = currentMapViewBase()->renderPassTimingsCsv();
+  if (csv.empty())
+  {
+    QMessageBox::information(
+      this,
+      "",
+      tr("No render pass timings are available. Enable the \"Renderer/Profile render "
+         "passes\" preference to measure them. This requires timer query support."));
+    return;
+  }
+
+  const auto fileName = QFileDialog::getSaveFileName(
+    this, tr("Export Render Pass Timings"), "", "CSV files (*.csv)");
+  if (fileName.isEmpty())
+  {
+    return;
+  }
+
+  const auto path = IO::pathFromQString(fileName);
+  IO::Disk::withOutputStream(path, [&](auto& stream) { stream << csv; })
+    .transform([&]() { logger().info() << "Exported render pass timings to " << path; })
+    .transform_error([&](auto e) {
+      logger().error() << "Could not export render pass timings: " + e.msg;
+      QMessageBox::critical(this, "", QString::fromStdString(e.msg));
+    });
+}
+
 /**
  * Returns whether the window should close.
  */
@@ -1382,21 +1536,36 @@ void MapFrame::copySelection()
   }
 }
 
+namespace
+{
+/**
+ * Copied nodes are additionally stored in the binary node format, which only TrenchBroom
+ * understands. Other applications use the text.
+ */
+const auto BinaryNodesMimeType = QString{"application/x-trenchbroom-nodes"};
+} // namespace
+
 void MapFrame::copyToClipboard()
 {
   QClipboard* clipboard = QApplication::clipboard();
+  auto* mimeData = new QMimeData{};
 
   std::string str;
   if (m_document->hasSelectedNodes())
   {
     str = m_document->serializeSelectedNodes();
+
+    const auto data = m_document->serializeSelectedNodesBinary();
+    mimeData->setData(
+      BinaryNodesMimeType, QByteArray{data.data(), static_cast<int>(data.size())});
   }
   else if (m_document->hasSelectedBrushFaces())
   {
     str = m_document->serializeSelectedBrushFaces();
   }
 
-  clipboard->setText(mapStringToUnicode(m_document->encoding(), str));
+  mimeData->setText(mapStringToUnicode(m_document->encoding(), str));
+  clipboard->setMimeData(mimeData);
 }
 
 bool MapFrame::canCutSelection() const
@@ -1463,6 +1632,20 @@ void MapFrame::pasteAtOriginalPosition()
 PasteType MapFrame::paste()
 {
   auto* clipboard = QApplication::clipboard();
+
+  if (const auto* mimeData = clipboard->mimeData();
+      mimeData != nullptr && mimeData->hasFormat(BinaryNodesMimeType))
+  {
+    const auto data = mimeData->data(BinaryNodesMimeType);
+    const auto pasteType =
+      m_document->pasteBinary(std::string{data.constData(), size_t(data.size())});
+    if (pasteType != PasteType::Failed)
+    {
+      return pasteType;
+    }
+    // e.g. the nodes were copied from a map with a different format, try the text
+  }
+
   const auto qtext = clipboard->text();
 
   if (qtext.isEmpty())
@@ -1492,7 +1675,8 @@ bool MapFrame::canPaste() const
 
   const auto* clipboard = QApplication::clipboard();
   const auto* mimeData = clipboard->mimeData();
-  return mimeData != nullptr && mimeData->hasText();
+  return mimeData != nullptr
+         && (mimeData->hasText() || mimeData->hasFormat(BinaryNodesMimeType));
 }
 
 void MapFrame::duplicateSelection()
@@ -2360,6 +2544,44 @@ void MapFrame::debugShowPalette()
   showModelessDialog(window);
 }
 
+void MapFrame::debugExportProfilerTrace()
+{
+  if (Profiler::zones().empty())
+  {
+    QMessageBox::information(
+      this,
+      "",
+      tr("No profiler zones have been recorded. Enable Debug > Profile Hot Paths to "
+         "record them."));
+    return;
+  }
+
+  const auto fileName = QFileDialog::getSaveFileName(
+    this, tr("Export Profiler Trace"), "", "Chrome trace files (*.json)");
+  if (fileName.isEmpty())
+  {
+    return;
+  }
+
+  const auto path = IO::pathFromQString(fileName);
+  const auto trace = Profiler::chromeTrace();
+  IO::Disk::withOutputStream(path, [&](auto& stream) { stream << trace; })
+    .transform([&]() { logger().info() << "Exported profiler trace to " << path; })
+    .transform_error([&](auto e) {
+      logger().error() << "Could not export profiler trace: " + e.msg;
+      QMessageBox::critical(this, "", QString::fromStdString(e.msg));
+    });
+}
+
+void MapFrame::debugShowMemoryReport()
+{
+  const auto report = createMemoryReport(*m_document, m_contextManager->vboManager());
+  logger().info() << report;
+
+  auto* window = new DebugMemoryReportWindow{report, this};
+  showModelessDialog(window);
+}
+
 void MapFrame::focusChange(QWidget* /* oldFocus */, QWidget* newFocus)
 {
   if (auto* newMapView = dynamic_cast<MapViewBase*>(newFocus))
@@ -2618,5 +2840,44 @@ DebugPaletteWindow::DebugPaletteWindow(QWidget* parent)
 }
 
 DebugPaletteWindow::~DebugPaletteWindow() = default;
+
+DebugMemoryReportWindow::DebugMemoryReportWindow(
+  const MemoryReport& report, QWidget* parent)
+  : QDialog{parent}
+{
+  setWindowTitle(tr("Memory Report"));
+
+  const auto entries = report.entries();
+
+  auto* table = new QTableWidget{static_cast<int>(entries.size() + 1), 2};
+  table->setHorizontalHeaderLabels({tr("Subsystem"), tr("Memory (MB)")});
+  table->verticalHeader()->hide();
+  table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+  const auto setRow = [&](const int row, const QString& subsystem, const size_t bytes) {
+    const auto megabytes = double(bytes) / (1024.0 * 1024.0);
+    auto* bytesItem = new QTableWidgetItem{QString::number(megabytes, 'f', 1)};
+    bytesItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+
+    table->setItem(row, 0, new QTableWidgetItem{subsystem});
+    table->setItem(row, 1, bytesItem);
+  };
+
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    const auto& [subsystem, bytes] = entries[i];
+    setRow(static_cast<int>(i), QString::fromStdString(subsystem), bytes);
+  }
+  setRow(static_cast<int>(entries.size()), tr("Total"), report.total());
+  table->resizeColumnsToContents();
+
+  auto* layout = new QVBoxLayout{};
+  layout->setContentsMargins(0, 0, 0, 0);
+  layout->setSpacing(0);
+  layout->addWidget(table);
+  setLayout(layout);
+}
+
+DebugMemoryReportWindow::~DebugMemoryReportWindow() = default;
 } // namespace View
 } // namespace TrenchBroom
@@ -34,6 +34,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 class QAction;
 class QComboBox;
@@ -41,7 +42,9 @@ class QDialog;
 class QDropEvent;
 class QMenuBar;
 class QLabel;
+class QPushButton;
 class QSplitter;
+class QFileSystemWatcher;
 class QTimer;
 class QToolBar;
 
@@ -73,6 +76,7 @@ class Inspector;
 enum class InspectorPage;
 class MapDocument;
 class MapViewBase;
+struct MemoryReport;
 class ObjExportDialog;
 enum class PasteType;
 class SignalDelayer;
@@ -89,6 +93,14 @@ private:
   std::chrono::time_point<std::chrono::system_clock> m_lastInputTime;
   std::unique_ptr<Autosaver> m_autosaver;
   QTimer* m_autosaveTimer;
+  QTimer* m_entityModelTimer;
+  QTimer* m_taskTimer;
+
+  // texture files are reloaded shortly after their directory changes, see
+  // MapDocument::reloadModifiedTextures
+  QFileSystemWatcher* m_textureDirectoryWatcher;
+  QTimer* m_textureReloadTimer;
+  std::vector<std::filesystem::path> m_modifiedTextureDirectories;
 
   QToolBar* m_toolBar;
 
@@ -108,6 +120,9 @@ private:
 
   QComboBox* m_gridChoice;
   QLabel* m_statusBarLabel;
+  QLabel* m_undoMemoryLabel;
+  QLabel* m_taskLabel;
+  QPushButton* m_cancelTasksButton;
 
   QPointer<QDialog> m_compilationDialog;
   QPointer<ObjExportDialog> m_objExportDialog;
@@ -163,6 +178,7 @@ private: // status bar
   void createStatusBar();
   void updateStatusBar();
   void updateStatusBarDelayed();
+  void updateTaskStatus();
 
 private: // gui creation
   void createGui();
@@ -173,6 +189,7 @@ private: // notification handlers
   void documentWasCleared(View::MapDocument* document);
   void documentDidChange(View::MapDocument* document);
   void documentModificationStateDidChange();
+  void textureCollectionsDidChange();
 
   void transactionDone(const std::string&);
   void transactionUndone(const std::string&);
@@ -206,6 +223,7 @@ public:
   bool exportDocumentAsObj();
   bool exportDocumentAsMap();
   bool exportDocument(const IO::ExportOptions& options);
+  void exportRenderPassTimings();
 
 private:
   bool confirmOrDiscardChanges();
@@ -401,6 +419,8 @@ public:
   void debugThrowExceptionDuringCommand();
   void debugSetWindowSize();
   void debugShowPalette();
+  void debugExportProfilerTrace();
+  void debugShowMemoryReport();
 
   void focusChange(QWidget* oldFocus, QWidget* newFocus);
 
@@ -432,5 +452,13 @@ public:
   DebugPaletteWindow(QWidget* parent = nullptr);
   virtual ~DebugPaletteWindow();
 };
+
+class DebugMemoryReportWindow : public QDialog
+{
+  Q_OBJECT
+public:
+  explicit DebugMemoryReportWindow(const MemoryReport& report, QWidget* parent = nullptr);
+  ~DebugMemoryReportWindow() override;
+};
 } // namespace View
 } // namespace TrenchBroom
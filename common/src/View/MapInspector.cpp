@@ -341,8 +341,8 @@ void MapPropertiesEditor::connectObservers()
     this, &MapPropertiesEditor::documentWasNewed);
   m_notifierConnection += document->documentWasLoadedNotifier.connect(
     this, &MapPropertiesEditor::documentWasLoaded);
-  m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &MapPropertiesEditor::nodesDidChange);
+  m_notifierConnection += document->batchedNodesDidChangeNotifier.connect(
+    this, &MapPropertiesEditor::nodesDidChange);
 }
 
 void MapPropertiesEditor::documentWasNewed(MapDocument*)
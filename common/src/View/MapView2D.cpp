@@ -83,6 +83,7 @@ MapView2D::MapView2D(
   Logger* logger)
   : MapViewBase(logger, document, toolBox, renderer, contextManager)
   , m_camera(std::make_unique<Renderer::OrthographicCamera>())
+  , m_gridRenderer(std::make_unique<Renderer::GridRenderer>())
 {
   connectObservers();
   initializeCamera(viewPlane);
@@ -105,6 +106,8 @@ MapView2D::MapView2D(
   mapViewBaseVirtualInit();
 }
 
+MapView2D::~MapView2D() = default;
+
 void MapView2D::initializeCamera(const ViewPlane viewPlane)
 {
   auto document = kdl::mem_lock(m_document);
@@ -409,7 +412,8 @@ Renderer::Camera& MapView2D::doGetCamera()
 void MapView2D::doRenderGrid(Renderer::RenderContext&, Renderer::RenderBatch& renderBatch)
 {
   auto document = kdl::mem_lock(m_document);
-  renderBatch.addOneShot(new Renderer::GridRenderer(*m_camera, document->worldBounds()));
+  m_gridRenderer->update(*m_camera, document->worldBounds());
+  renderBatch.add(m_gridRenderer.get());
 }
 
 void MapView2D::doRenderMap(
@@ -422,7 +426,7 @@ void MapView2D::doRenderMap(
   auto document = kdl::mem_lock(m_document);
   if (renderContext.showSelectionGuide() && document->hasSelectedNodes())
   {
-    const vm::bbox3& bounds = document->selectionBounds();
+    const auto bounds = document->selectionPreviewBounds();
     Renderer::SelectionBoundsRenderer boundsRenderer(bounds);
     boundsRenderer.render(renderContext, renderBatch);
   }
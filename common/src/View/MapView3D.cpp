@@ -34,15 +34,19 @@
 #include "Model/PatchNode.h"
 #include "Model/PickResult.h"
 #include "Model/PointTrace.h"
+#include "Model/WorldNode.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Renderer/BoundsGuideRenderer.h"
 #include "Renderer/Compass3D.h"
 #include "Renderer/MapRenderer.h"
 #include "Renderer/PerspectiveCamera.h"
+#include "Renderer/PickIdBuffer.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/SelectionBoundsRenderer.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/Shaders.h"
 #include "View/CameraAnimation.h"
 #include "View/CameraTool3D.h"
 #include "View/ClipToolController.h"
@@ -68,8 +72,11 @@
 #include "View/VertexTool.h"
 #include "View/VertexToolController.h"
 
+#include "kdl/overload.h"
 #include "kdl/set_temp.h"
 
+#include "octree.h"
+
 #include "vm/util.h"
 
 #include <memory>
@@ -142,6 +149,11 @@ void MapView3D::connectObservers()
 
 void MapView3D::cameraDidChange(const Renderer::Camera* /* camera */)
 {
+  if (m_pickIdBuffer)
+  {
+    m_pickIdBuffer->invalidate();
+  }
+
   if (!m_ignoreCameraChangeEvents)
   {
     // Don't refresh if the camera was changed in doPreRender!
@@ -225,6 +237,54 @@ Model::PickResult MapView3D::doPick(const vm::ray3& pickRay) const
   return pickResult;
 }
 
+std::optional<Model::PickResult> MapView3D::doPickHover(
+  const float x, const float y, const vm::ray3& pickRay)
+{
+  if (!m_pickIdBuffer || !m_pickIdBuffer->valid())
+  {
+    return std::nullopt;
+  }
+
+  makeCurrent();
+  const auto r = devicePixelRatioF();
+  const auto& viewport = m_camera->viewport();
+  const auto pixelX = static_cast<int>(x * r);
+  const auto pixelY = static_cast<int>(viewport.height * r) - 1 - static_cast<int>(y * r);
+  const auto pickId = m_pickIdBuffer->readId(pixelX, pixelY);
+  if (!pickId)
+  {
+    return std::nullopt;
+  }
+
+  // The ID buffer only contains the frontmost brush, which is picked exactly to obtain
+  // the hit point. All other nodes are much cheaper to pick and are picked as usual.
+  const auto* hoveredBrush = m_renderer.findBrushByPickId(*pickId);
+
+  auto document = kdl::mem_lock(m_document);
+  const auto& editorContext = document->editorContext();
+  auto pickResult = Model::PickResult::byDistance();
+  for (auto* node : document->world()->nodeTree().find_intersectors(pickRay))
+  {
+    node->accept(kdl::overload(
+      [](Model::WorldNode*) {},
+      [](Model::LayerNode*) {},
+      [](Model::GroupNode*) {},
+      [&](Model::EntityNode* entityNode) {
+        entityNode->pick(editorContext, pickRay, pickResult);
+      },
+      [&](Model::BrushNode* brushNode) {
+        if (brushNode == hoveredBrush)
+        {
+          brushNode->pick(editorContext, pickRay, pickResult);
+        }
+      },
+      [&](Model::PatchNode* patchNode) {
+        patchNode->pick(editorContext, pickRay, pickResult);
+      }));
+  }
+  return pickResult;
+}
+
 void MapView3D::doUpdateViewport(
   const int x, const int y, const int width, const int height)
 {
@@ -569,7 +629,7 @@ void MapView3D::doRenderMap(
   auto document = kdl::mem_lock(m_document);
   if (renderContext.showSelectionGuide() && document->hasSelectedNodes())
   {
-    const vm::bbox3& bounds = document->selectionBounds();
+    const auto bounds = document->selectionPreviewBounds();
     Renderer::SelectionBoundsRenderer boundsRenderer(bounds);
     boundsRenderer.render(renderContext, renderBatch);
 
@@ -594,6 +654,34 @@ void MapView3D::doRenderSoftWorldBounds(Renderer::RenderContext&, Renderer::Rend
   // the bounds rect itself is only rendered in MapView2D, it just clutters the 3D view
 }
 
+void MapView3D::doRenderPickIds(
+  Renderer::MapRenderer& renderer, Renderer::RenderContext& renderContext)
+{
+  if (
+    !pref(Preferences::GpuPicking) || !renderContext.showFaces()
+    || !shaderManager().hasProgram(Renderer::Shaders::PickIdShader))
+  {
+    m_pickIdBuffer.reset();
+    return;
+  }
+
+  if (!m_pickIdBuffer)
+  {
+    m_pickIdBuffer = std::make_unique<Renderer::PickIdBuffer>();
+  }
+
+  const auto r = devicePixelRatioF();
+  const auto& viewport = m_camera->viewport();
+  if (m_pickIdBuffer->bind(
+        static_cast<int>(viewport.width * r), static_cast<int>(viewport.height * r)))
+  {
+    auto renderBatch = Renderer::RenderBatch{vboManager()};
+    renderer.renderPickIds(renderContext, renderBatch);
+    renderBatch.render(renderContext);
+    m_pickIdBuffer->unbind();
+  }
+}
+
 bool MapView3D::doBeforePopupMenu()
 {
   m_flyModeHelper->resetKeys();
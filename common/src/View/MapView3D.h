@@ -26,6 +26,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <vector>
 
 class QKeyEvent;
@@ -37,7 +38,8 @@ class Logger;
 namespace Renderer
 {
 class PerspectiveCamera;
-}
+class PickIdBuffer;
+} // namespace Renderer
 
 namespace View
 {
@@ -49,6 +51,7 @@ class MapView3D : public MapViewBase
 private:
   std::unique_ptr<Renderer::PerspectiveCamera> m_camera;
   std::unique_ptr<FlyModeHelper> m_flyModeHelper;
+  std::unique_ptr<Renderer::PickIdBuffer> m_pickIdBuffer;
   bool m_ignoreCameraChangeEvents;
 
   NotifierConnection m_notifierConnection;
@@ -90,6 +93,8 @@ private: // other events
 private: // implement ToolBoxConnector interface
   PickRequest doGetPickRequest(float x, float y) const override;
   Model::PickResult doPick(const vm::ray3& pickRay) const override;
+  std::optional<Model::PickResult> doPickHover(
+    float x, float y, const vm::ray3& pickRay) override;
 
 private: // implement RenderView interface
   void doUpdateViewport(int x, int y, int width, int height) override;
@@ -140,6 +145,8 @@ private: // implement MapViewBase interface
     Renderer::RenderBatch& renderBatch) override;
   void doRenderSoftWorldBounds(
     Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) override;
+  void doRenderPickIds(
+    Renderer::MapRenderer& renderer, Renderer::RenderContext& renderContext) override;
 
   bool doBeforePopupMenu() override;
 
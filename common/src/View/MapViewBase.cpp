@@ -29,6 +29,7 @@
 #include "Assets/EntityDefinition.h"
 #include "Assets/EntityDefinitionGroup.h"
 #include "Assets/EntityDefinitionManager.h"
+#include "Assets/TextureManager.h"
 #include "FloatType.h"
 #include "Logger.h"
 #include "Model/BezierPatch.h"
@@ -54,7 +55,9 @@
 #include "Renderer/Compass.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/FontManager.h"
+#include "Renderer/GpuTimer.h"
 #include "Renderer/MapRenderer.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/PrimitiveRenderer.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
@@ -81,7 +84,9 @@
 #include "vm/polygon.h"
 #include "vm/util.h"
 
+#include <optional>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
@@ -90,6 +95,13 @@ namespace View
 {
 const int MapViewBase::DefaultCameraAnimationDuration = 250;
 
+namespace
+{
+// the number of brushes each brush renderer validates per frame if progressive brush
+// validation is enabled
+constexpr auto MaxValidatedBrushesPerFrame = size_t(20000);
+} // namespace
+
 MapViewBase::MapViewBase(
   Logger* logger,
   std::weak_ptr<MapDocument> document,
@@ -106,6 +118,8 @@ MapViewBase::MapViewBase(
   , m_portalFileRenderer{nullptr}
   , m_isCurrent{false}
   , m_updateActionStatesSignalDelayer{new SignalDelayer{this}}
+  , m_fullDamage{false}
+  , m_nodesChangedSinceCommand{false}
 {
   setToolBox(toolBox);
   bindEvents();
@@ -141,6 +155,11 @@ Renderer::Camera& MapViewBase::camera()
   return doGetCamera();
 }
 
+std::string MapViewBase::renderPassTimingsCsv() const
+{
+  return m_gpuTimer ? m_gpuTimer->csv() : std::string{};
+}
+
 void MapViewBase::bindEvents()
 {
   connect(
@@ -155,8 +174,12 @@ void MapViewBase::connectObservers()
   auto document = kdl::mem_lock(m_document);
   m_notifierConnection +=
     document->nodesWereAddedNotifier.connect(this, &MapViewBase::nodesDidChange);
+  m_notifierConnection +=
+    document->nodesWillBeRemovedNotifier.connect(this, &MapViewBase::nodesWillChange);
   m_notifierConnection +=
     document->nodesWereRemovedNotifier.connect(this, &MapViewBase::nodesDidChange);
+  m_notifierConnection +=
+    document->nodesWillChangeNotifier.connect(this, &MapViewBase::nodesWillChange);
   m_notifierConnection +=
     document->nodesDidChangeNotifier.connect(this, &MapViewBase::nodesDidChange);
   m_notifierConnection +=
@@ -206,6 +229,54 @@ void MapViewBase::connectObservers()
     prefs.preferenceDidChangeNotifier.connect(this, &MapViewBase::preferenceDidChange);
 }
 
+namespace
+{
+bool affectsSelection(const Model::Node& node)
+{
+  // changes to selected nodes may affect selection guides and tool handles
+  if (node.selected() || node.parentSelected() || node.descendantSelected())
+  {
+    return true;
+  }
+  const auto* brushNode = dynamic_cast<const Model::BrushNode*>(&node);
+  return brushNode && brushNode->hasSelectedFaces();
+}
+} // namespace
+
+void MapViewBase::addDamage(const std::vector<Model::Node*>& nodes)
+{
+  m_nodesChangedSinceCommand = true;
+  for (const auto* node : nodes)
+  {
+    if (affectsSelection(*node))
+    {
+      m_fullDamage = true;
+    }
+    else
+    {
+      m_damagedBounds = m_damagedBounds
+                          ? vm::merge(*m_damagedBounds, node->physicalBounds())
+                          : node->physicalBounds();
+    }
+  }
+}
+
+/**
+ * Updates the view if the damage collected since the last call affects it. Qt coalesces
+ * all updates requested within one event loop iteration into a single repaint.
+ */
+void MapViewBase::updateIfDamaged()
+{
+  if (
+    m_fullDamage
+    || (m_damagedBounds && camera().intersectsFrustum(vm::bbox3f{*m_damagedBounds})))
+  {
+    update();
+  }
+  m_fullDamage = false;
+  m_damagedBounds = std::nullopt;
+}
+
 /**
  * Full re-initialization of QActions and picking state.
  */
@@ -216,10 +287,17 @@ void MapViewBase::createActionsAndUpdatePicking()
   updatePickResult();
 }
 
-void MapViewBase::nodesDidChange(const std::vector<Model::Node*>&)
+void MapViewBase::nodesWillChange(const std::vector<Model::Node*>& nodes)
 {
-  updatePickResult();
-  update();
+  // the nodes may move out of the visible region
+  addDamage(nodes);
+}
+
+void MapViewBase::nodesDidChange(const std::vector<Model::Node*>& nodes)
+{
+  invalidatePickResult();
+  addDamage(nodes);
+  updateIfDamaged();
 }
 
 void MapViewBase::toolChanged(Tool&)
@@ -232,20 +310,29 @@ void MapViewBase::toolChanged(Tool&)
 void MapViewBase::commandDone(Command&)
 {
   updateActionStatesDelayed();
-  updatePickResult();
-  update();
+  invalidatePickResult();
+  if (!std::exchange(m_nodesChangedSinceCommand, false))
+  {
+    update();
+  }
 }
 
 void MapViewBase::commandUndone(UndoableCommand&)
 {
   updateActionStatesDelayed();
-  updatePickResult();
-  update();
+  invalidatePickResult();
+  if (!std::exchange(m_nodesChangedSinceCommand, false))
+  {
+    update();
+  }
 }
 
 void MapViewBase::selectionDidChange(const Selection&)
 {
   updateActionStatesDelayed();
+  m_nodesChangedSinceCommand = true;
+  m_fullDamage = true;
+  updateIfDamaged();
 }
 
 void MapViewBase::textureCollectionsDidChange()
@@ -1029,6 +1116,11 @@ void MapViewBase::doRender()
   renderContext.setShowBrushEntityBounds(pref(Preferences::ShowBrushEntityBounds));
   renderContext.setShowPointEntityBounds(pref(Preferences::ShowPointEntityBounds));
   renderContext.setShowFog(pref(Preferences::ShowFog));
+  renderContext.setSimplifyTinyBrushes(pref(Preferences::SimplifyTinyBrushes2D));
+  renderContext.setMaxValidatedBrushes(
+    pref(Preferences::ProgressiveBrushValidation)
+      ? std::optional{MaxValidatedBrushesPerFrame}
+      : std::nullopt);
   renderContext.setShowGrid(grid.visible());
   renderContext.setGridSize(grid.actualSize());
   renderContext.setDpiScale(static_cast<float>(window()->devicePixelRatioF()));
@@ -1040,21 +1132,88 @@ void MapViewBase::doRender()
   setupGL(renderContext);
   setRenderOptions(renderContext);
 
+  if (!pref(Preferences::ProfileRenderPasses))
+  {
+    m_gpuTimer.reset();
+  }
+  else if (!m_gpuTimer && Renderer::GpuTimer::supported())
+  {
+    m_gpuTimer = std::make_unique<Renderer::GpuTimer>();
+  }
+
+  if (!pref(Preferences::OcclusionCulling) || !renderContext.render3D())
+  {
+    m_occlusionCuller.reset();
+  }
+  else if (!m_occlusionCuller)
+  {
+    m_occlusionCuller = std::make_unique<Renderer::OcclusionCuller>();
+  }
+
+  if (m_occlusionCuller)
+  {
+    m_occlusionCuller->beginFrame();
+    renderContext.setOcclusionCuller(m_occlusionCuller.get());
+  }
+
   auto renderBatch = Renderer::RenderBatch{vboManager()};
+  renderBatch.setSortRenderables(pref(Preferences::SortRenderables));
+  if (m_gpuTimer)
+  {
+    m_gpuTimer->beginFrame();
+    renderBatch.setGpuTimer(m_gpuTimer.get());
+  }
 
+  renderBatch.beginSection("Grid");
   doRenderGrid(renderContext, renderBatch);
+  renderBatch.beginSection("Map");
   doRenderMap(m_renderer, renderContext, renderBatch);
+  renderBatch.beginSection("Tools");
   doRenderTools(m_toolBox, renderContext, renderBatch);
+  renderBatch.beginSection("Extras");
   doRenderExtras(renderContext, renderBatch);
 
+  renderBatch.beginSection("Overlays");
   renderCoordinateSystem(renderContext, renderBatch);
   renderSoftMapBounds(renderContext, renderBatch);
   renderPointFile(renderContext, renderBatch);
   renderPortalFile(renderContext, renderBatch);
+  renderBatch.beginSection("Compass");
   renderCompass(renderBatch);
+  renderBatch.beginSection("FPS");
   renderFPS(renderContext, renderBatch);
 
   renderBatch.render(renderContext);
+
+  if (m_gpuTimer)
+  {
+    m_gpuTimer->endFrame();
+  }
+
+  doRenderPickIds(m_renderer, renderContext);
+
+  if (
+    document->textureManager().hasPendingUploads()
+    || renderContext.statistics().pendingBrushes > 0)
+  {
+    // keep rendering until all textures are uploaded and all brushes are validated
+    update();
+  }
+
+  const auto& statistics = renderContext.statistics();
+  m_brushStatistics =
+    statistics.visibleBrushes + statistics.culledBrushes > 0
+      ? " Brushes: " + std::to_string(statistics.visibleBrushes) + " visible, "
+          + std::to_string(statistics.culledBrushes) + " culled"
+          + (m_occlusionCuller
+               ? ", " + std::to_string(statistics.occludedBrushes) + " occluded"
+               : "")
+          + (statistics.simplifiedBrushes > 0
+               ? ", " + std::to_string(statistics.simplifiedBrushes) + " simplified"
+               : "")
+      : "";
+  m_brushStatistics += " State changes: " + std::to_string(statistics.stateChanges)
+                       + ", " + std::to_string(statistics.programChanges) + " shaders";
 }
 
 void MapViewBase::setupGL(Renderer::RenderContext& context)
@@ -1136,17 +1295,21 @@ void MapViewBase::validatePortalFileRenderer(Renderer::RenderContext&)
   auto* portalFile = document->portalFile();
   if (portalFile != nullptr)
   {
+    const auto& fillColor = pref(Preferences::PortalFileFillColor);
+    const auto& borderColor = pref(Preferences::PortalFileBorderColor);
+    const auto lineWidth = 4.0f;
+
+    // all portals share the same render attributes, so they end up in one vertex buffer
     for (const auto& poly : portalFile->portals())
     {
       m_portalFileRenderer->renderFilledPolygon(
-        pref(Preferences::PortalFileFillColor),
+        fillColor,
         Renderer::PrimitiveRendererOcclusionPolicy::Hide,
         Renderer::PrimitiveRendererCullingPolicy::ShowBackfaces,
         poly.vertices());
 
-      const auto lineWidth = 4.0f;
       m_portalFileRenderer->renderPolygon(
-        pref(Preferences::PortalFileBorderColor),
+        borderColor,
         lineWidth,
         Renderer::PrimitiveRendererOcclusionPolicy::Hide,
         poly.vertices());
@@ -1168,7 +1331,9 @@ void MapViewBase::renderFPS(
   if (pref(Preferences::ShowFPS))
   {
     auto renderService = Renderer::RenderService{renderContext, renderBatch};
-    renderService.renderHeadsUp(m_currentFPS);
+    renderService.renderHeadsUp(
+      m_currentFPS + m_brushStatistics
+      + (m_gpuTimer ? " " + m_gpuTimer->summary() : std::string{}));
   }
 }
 
@@ -1731,6 +1896,8 @@ void MapViewBase::doPreRender() {}
 
 void MapViewBase::doRenderExtras(Renderer::RenderContext&, Renderer::RenderBatch&) {}
 
+void MapViewBase::doRenderPickIds(Renderer::MapRenderer&, Renderer::RenderContext&) {}
+
 bool MapViewBase::doBeforePopupMenu()
 {
   return true;
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "FloatType.h"
 #include "NotifierConnection.h"
 #include "View/ActionContext.h"
 #include "View/CameraLinkHelper.h"
@@ -26,8 +27,12 @@
 #include "View/RenderView.h"
 #include "View/ToolBoxConnector.h"
 
+#include "vm/bbox.h"
+
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -60,6 +65,8 @@ namespace Renderer
 {
 class Camera;
 class Compass;
+class GpuTimer;
+class OcclusionCuller;
 class MapRenderer;
 class PrimitiveRenderer;
 class RenderBatch;
@@ -94,12 +101,30 @@ protected:
   MapViewToolBox& m_toolBox;
 
   std::unique_ptr<AnimationManager> m_animationManager;
+  Renderer::MapRenderer& m_renderer;
 
 private:
-  Renderer::MapRenderer& m_renderer;
   std::unique_ptr<Renderer::Compass> m_compass;
   std::unique_ptr<Renderer::PrimitiveRenderer> m_portalFileRenderer;
 
+  /**
+   * The brush culling statistics of the most recently rendered frame, shown alongside
+   * the FPS counter. These are only known after the render batch has been rendered.
+   */
+  std::string m_brushStatistics;
+
+  /**
+   * Measures the GPU time of the render passes while the ProfileRenderPasses preference
+   * is enabled and the context supports timer queries.
+   */
+  std::unique_ptr<Renderer::GpuTimer> m_gpuTimer;
+
+  /**
+   * Culls brushes hidden behind other geometry while the OcclusionCulling preference is
+   * enabled. Only used in the 3D view.
+   */
+  std::unique_ptr<Renderer::OcclusionCuller> m_occlusionCuller;
+
   /**
    * Tracks whether this map view has most recently gotten the focus. This is tracked and
    * updated by a MapViewActivationTracker instance.
@@ -108,6 +133,25 @@ private:
 
   SignalDelayer* m_updateActionStatesSignalDelayer;
 
+  /**
+   * The bounds of the unselected nodes that changed since the view was last updated. A
+   * change to unselected nodes only causes the view to be updated if these bounds
+   * intersect its visible region.
+   */
+  std::optional<vm::bbox3> m_damagedBounds;
+
+  /**
+   * Set if a node change requires the view to be updated wherever the changed nodes are,
+   * e.g. because selected nodes changed and the selection guides extend beyond them.
+   */
+  bool m_fullDamage;
+
+  /**
+   * Set if any nodes changed since the last command was done or undone. Commands that do
+   * not change any nodes always cause the view to be updated.
+   */
+  bool m_nodesChangedSinceCommand;
+
   NotifierConnection m_notifierConnection;
 
 private: // shortcuts
@@ -144,12 +188,19 @@ public:
 
   Renderer::Camera& camera();
 
+  /**
+   * Returns the GPU timings of the render passes of this view as CSV, or an empty string
+   * if the render passes are not being profiled.
+   */
+  std::string renderPassTimingsCsv() const;
+
 private:
   void bindEvents();
   void connectObservers();
 
   void createActionsAndUpdatePicking();
 
+  void nodesWillChange(const std::vector<Model::Node*>& nodes);
   void nodesDidChange(const std::vector<Model::Node*>& nodes);
   void toolChanged(Tool& tool);
   void commandDone(Command& command);
@@ -165,6 +216,9 @@ private:
   void preferenceDidChange(const std::filesystem::path& path);
   void documentDidChange(MapDocument* document);
 
+  void addDamage(const std::vector<Model::Node*>& nodes);
+  void updateIfDamaged();
+
 private: // shortcut setup
   void createActions();
   void updateActionBindings();
@@ -389,6 +443,8 @@ private: // subclassing interface
     Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
   virtual void doRenderSoftWorldBounds(
     Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) = 0;
+  virtual void doRenderPickIds(
+    Renderer::MapRenderer& renderer, Renderer::RenderContext& renderContext);
 
   virtual bool doBeforePopupMenu();
   virtual void doAfterPopupMenu();
@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryReport.h"
+
+#include "Assets/EntityModelManager.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureManager.h"
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+#include "Renderer/VboManager.h"
+#include "View/MapDocument.h"
+#include "octree.h"
+
+#include "kdl/overload.h"
+
+#include <iomanip>
+#include <ostream>
+
+namespace TrenchBroom
+{
+namespace View
+{
+
+std::vector<std::pair<std::string, size_t>> MemoryReport::entries() const
+{
+  return {
+    {"Brush geometry", brushGeometry},
+    {"Face attributes", faceAttributes},
+    {"Entity properties", entityProperties},
+    {"Nodes and patches", nodes},
+    {"Node tree", nodeTree},
+    {"Undo stack", undoStack},
+    {"Texture buffers", textureBuffers},
+    {"Texture video memory", textureVideoMemory},
+    {"Vertex buffers", vertexBuffers},
+    {"Entity models", entityModels},
+  };
+}
+
+size_t MemoryReport::total() const
+{
+  auto result = size_t(0);
+  for (const auto& [subsystem, bytes] : entries())
+  {
+    result += bytes;
+  }
+  return result;
+}
+
+std::ostream& operator<<(std::ostream& str, const MemoryReport& report)
+{
+  const auto toMB = [](const size_t bytes) { return double(bytes) / (1024.0 * 1024.0); };
+
+  const auto flags = str.flags();
+  const auto precision = str.precision();
+
+  str << std::fixed << std::setprecision(1);
+  str << "Memory usage: " << toMB(report.total()) << " MB";
+  for (const auto& [subsystem, bytes] : report.entries())
+  {
+    str << "\n  " << subsystem << ": " << toMB(bytes) << " MB";
+  }
+
+  str.flags(flags);
+  str.precision(precision);
+  return str;
+}
+
+MemoryReport createMemoryReport(
+  MapDocument& document, const Renderer::VboManager& vboManager)
+{
+  auto report = MemoryReport{};
+
+  if (const auto* world = document.world())
+  {
+    world->accept(kdl::overload(
+      [&](auto&& thisLambda, const Model::WorldNode* worldNode) {
+        report.nodes += sizeof(Model::WorldNode);
+        report.entityProperties += worldNode->entity().memoryUsage();
+        worldNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const Model::LayerNode* layerNode) {
+        report.nodes += sizeof(Model::LayerNode);
+        layerNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const Model::GroupNode* groupNode) {
+        report.nodes += sizeof(Model::GroupNode);
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const Model::EntityNode* entityNode) {
+        report.nodes += sizeof(Model::EntityNode);
+        report.entityProperties += entityNode->entity().memoryUsage();
+        entityNode->visitChildren(thisLambda);
+      },
+      [&](const Model::BrushNode* brushNode) {
+        const auto& brush = brushNode->brush();
+        report.nodes += sizeof(Model::BrushNode) + sizeof(Model::Brush);
+        report.brushGeometry += brush.geometryMemoryUsage();
+        report.faceAttributes += brush.faceMemoryUsage();
+      },
+      [&](const Model::PatchNode* patchNode) {
+        report.nodes += sizeof(Model::PatchNode) + patchNode->patch().memoryUsage();
+      }));
+
+    report.nodeTree = world->nodeTree().memory_usage();
+  }
+
+  report.undoStack = document.undoMemoryUsage();
+
+  for (const auto* texture : document.textureManager().textures())
+  {
+    report.textureBuffers += texture->cpuMemoryUsage();
+    report.textureVideoMemory += texture->videoMemoryUsage();
+  }
+
+  report.vertexBuffers = vboManager.currentVboSize();
+  report.entityModels = document.entityModelManager().memoryUsage();
+
+  return report;
+}
+
+} // namespace View
+} // namespace TrenchBroom
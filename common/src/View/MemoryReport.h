@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+class VboManager;
+}
+
+namespace View
+{
+class MapDocument;
+
+/**
+ * Attributes the memory used by a document to the subsystems that use it. Most of the
+ * numbers are estimates that are computed from the sizes and capacities of the involved
+ * containers, so they don't include the allocator overhead.
+ */
+struct MemoryReport
+{
+  // the polyhedra of the brushes, or their compact geometry if they are not in use
+  size_t brushGeometry = 0;
+  // the brush faces including their attributes
+  size_t faceAttributes = 0;
+  // the entities including their properties
+  size_t entityProperties = 0;
+  // the nodes themselves and the patches
+  size_t nodes = 0;
+  // the octree of the world node
+  size_t nodeTree = 0;
+  // the commands on the undo and redo stacks
+  size_t undoStack = 0;
+  // the pixel data of the textures that have not been uploaded yet
+  size_t textureBuffers = 0;
+  // the video memory of the uploaded textures and their thumbnails
+  size_t textureVideoMemory = 0;
+  // the vertex and index buffers
+  size_t vertexBuffers = 0;
+  // the loaded entity models including their skins
+  size_t entityModels = 0;
+
+  /**
+   * Returns the subsystems and the number of bytes they use, in the order in which they
+   * should be shown.
+   */
+  std::vector<std::pair<std::string, size_t>> entries() const;
+
+  size_t total() const;
+};
+
+std::ostream& operator<<(std::ostream& str, const MemoryReport& report);
+
+MemoryReport createMemoryReport(
+  MapDocument& document, const Renderer::VboManager& vboManager);
+
+} // namespace View
+} // namespace TrenchBroom
@@ -30,8 +30,10 @@
 #include "kdl/memory_utils.h"
 
 #include "vm/bbox.h"
+#include "vm/mat_ext.h"
 
 #include <cassert>
+#include <optional>
 
 namespace TrenchBroom
 {
@@ -41,6 +43,7 @@ MoveObjectsTool::MoveObjectsTool(std::weak_ptr<MapDocument> document)
   : Tool(true)
   , m_document(document)
   , m_duplicateObjects(false)
+  , m_delta(vm::vec3::zero())
 {
 }
 
@@ -62,6 +65,7 @@ bool MoveObjectsTool::startMove(const InputState& inputState)
     duplicateObjects(inputState) ? "Duplicate Objects" : "Move Objects",
     TransactionScope::LongRunning);
   m_duplicateObjects = duplicateObjects(inputState);
+  m_delta = vm::vec3::zero();
   return true;
 }
 
@@ -71,7 +75,7 @@ MoveObjectsTool::MoveResult MoveObjectsTool::move(
   auto document = kdl::mem_lock(m_document);
   const auto& worldBounds = document->worldBounds();
   const auto bounds = document->selectionBounds();
-  if (!worldBounds.contains(bounds.translate(delta)))
+  if (!worldBounds.contains(bounds.translate(m_delta + delta)))
   {
     return MR_Deny;
   }
@@ -82,25 +86,31 @@ MoveObjectsTool::MoveResult MoveObjectsTool::move(
     document->duplicateObjects();
   }
 
-  if (!document->translateObjects(delta))
-  {
-    return MR_Deny;
-  }
-  else
-  {
-    return MR_Continue;
-  }
+  m_delta = m_delta + delta;
+  document->setSelectionPreviewTransformation(vm::translation_matrix(m_delta));
+  refreshViews();
+  return MR_Continue;
 }
 
 void MoveObjectsTool::endMove(const InputState&)
 {
   auto document = kdl::mem_lock(m_document);
-  document->commitTransaction();
+  document->setSelectionPreviewTransformation(std::nullopt);
+
+  if (m_delta == vm::vec3::zero() || document->translateObjects(m_delta))
+  {
+    document->commitTransaction();
+  }
+  else
+  {
+    document->cancelTransaction();
+  }
 }
 
 void MoveObjectsTool::cancelMove()
 {
   auto document = kdl::mem_lock(m_document);
+  document->setSelectionPreviewTransformation(std::nullopt);
   document->cancelTransaction();
 }
 
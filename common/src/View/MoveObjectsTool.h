@@ -22,6 +22,8 @@
 #include "FloatType.h"
 #include "View/Tool.h"
 
+#include "vm/vec.h"
+
 #include <memory>
 
 namespace TrenchBroom
@@ -46,6 +48,12 @@ private:
   std::weak_ptr<MapDocument> m_document;
   bool m_duplicateObjects;
 
+  /**
+   * The accumulated delta of the current move. The selected objects are only rendered at
+   * their moved position during the move, and the delta is applied when the move ends.
+   */
+  vm::vec3 m_delta;
+
 public:
   explicit MoveObjectsTool(std::weak_ptr<MapDocument> document);
 
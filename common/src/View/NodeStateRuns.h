@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom::View
+{
+
+/**
+ * Stores one state for each node of a list of nodes as runs of equal states. Commands
+ * which change the visibility or lock state of many nodes use this to remember the old
+ * states compactly, since neighbouring nodes usually share the same state.
+ */
+template <typename State>
+class NodeStateRuns
+{
+private:
+  std::vector<std::pair<State, std::size_t>> m_runs;
+
+public:
+  /**
+   * Appends the state of the next node.
+   */
+  void push_back(const State state)
+  {
+    if (!m_runs.empty() && m_runs.back().first == state)
+    {
+      ++m_runs.back().second;
+    }
+    else
+    {
+      m_runs.emplace_back(state, 1u);
+    }
+  }
+
+  /**
+   * Calls the given function with the index of each node and its state, starting with
+   * the last node.
+   */
+  template <typename F>
+  void visitReversed(const F& f) const
+  {
+    auto index = std::size_t{0};
+    for (const auto& run : m_runs)
+    {
+      index += run.second;
+    }
+
+    for (auto it = m_runs.rbegin(); it != m_runs.rend(); ++it)
+    {
+      for (std::size_t i = 0; i < it->second; ++i)
+      {
+        f(--index, it->first);
+      }
+    }
+  }
+};
+
+} // namespace TrenchBroom::View
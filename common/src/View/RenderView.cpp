@@ -27,6 +27,7 @@
 #include "Renderer/Vbo.h"
 #include "Renderer/VboManager.h"
 #include "Renderer/VertexArray.h"
+#include "StartupTimeline.h"
 #include "TrenchBroomApp.h"
 #include "View/GLContextManager.h"
 #include "View/InputEvent.h"
@@ -192,6 +193,9 @@ void RenderView::paintGL()
 
   render();
 
+  // startup has finished once the first view has been rendered
+  StartupTimeline::instance().finish();
+
   // Update stats
   m_framesRendered++;
   if (m_timeSinceLastFrame.isValid())
@@ -27,8 +27,8 @@
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceHandle.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
-#include "Model/NodeQueries.h"
 #include "Model/PushSelection.h"
+#include "Model/TextureNodeIndex.h"
 #include "Model/WorldNode.h" // IWYU pragma: keep
 #include "View/BorderLine.h"
 #include "View/MapDocument.h"
@@ -114,10 +114,10 @@ std::vector<Model::BrushFaceHandle> ReplaceTextureDialog::getApplicableFaces() c
   ensure(subject != nullptr, "subject is null");
 
   auto document = kdl::mem_lock(m_document);
-  auto faces = document->allSelectedBrushFaces();
+  const auto faces = document->allSelectedBrushFaces();
   if (faces.empty())
   {
-    faces = Model::collectBrushFaces({document->world()});
+    return document->world()->textureNodeIndex().findBrushFaces(subject);
   }
 
   return kdl::vec_filter(
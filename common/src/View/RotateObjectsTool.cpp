@@ -29,6 +29,8 @@
 #include "kdl/memory_utils.h"
 #include "kdl/vector_utils.h"
 
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
 #include "vm/scalar.h"
 
 namespace TrenchBroom
@@ -115,19 +117,34 @@ void RotateObjectsTool::beginRotation()
 {
   auto document = kdl::mem_lock(m_document);
   document->startTransaction("Rotate Objects", TransactionScope::LongRunning);
+  m_rotation = std::nullopt;
 }
 
 void RotateObjectsTool::commitRotation()
 {
   auto document = kdl::mem_lock(m_document);
-  document->commitTransaction();
-  updateRecentlyUsedCenters(rotationCenter());
+  document->setSelectionPreviewTransformation(std::nullopt);
+
+  if (
+    !m_rotation
+    || document->rotateObjects(m_rotation->center, m_rotation->axis, m_rotation->angle))
+  {
+    document->commitTransaction();
+    updateRecentlyUsedCenters(rotationCenter());
+  }
+  else
+  {
+    document->cancelTransaction();
+  }
+  m_rotation = std::nullopt;
 }
 
 void RotateObjectsTool::cancelRotation()
 {
   auto document = kdl::mem_lock(m_document);
+  document->setSelectionPreviewTransformation(std::nullopt);
   document->cancelTransaction();
+  m_rotation = std::nullopt;
 }
 
 FloatType RotateObjectsTool::snapRotationAngle(const FloatType angle) const
@@ -140,8 +157,11 @@ void RotateObjectsTool::applyRotation(
   const vm::vec3& center, const vm::vec3& axis, const FloatType angle)
 {
   auto document = kdl::mem_lock(m_document);
-  document->rollbackTransaction();
-  document->rotateObjects(center, axis, angle);
+  m_rotation = Rotation{center, axis, angle};
+  document->setSelectionPreviewTransformation(
+    vm::translation_matrix(center) * vm::rotation_matrix(axis, angle)
+    * vm::translation_matrix(-center));
+  refreshViews();
 }
 
 Model::Hit RotateObjectsTool::pick2D(
@@ -24,8 +24,10 @@
 #include "View/Tool.h"
 
 #include "vm/forward.h"
+#include "vm/vec.h"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom
@@ -46,12 +48,25 @@ class RotateObjectsToolPage;
 class RotateObjectsTool : public Tool
 {
 private:
+  struct Rotation
+  {
+    vm::vec3 center;
+    vm::vec3 axis;
+    FloatType angle;
+  };
+
   std::weak_ptr<MapDocument> m_document;
   RotateObjectsToolPage* m_toolPage;
   RotateObjectsHandle m_handle;
   double m_angle;
   std::vector<vm::vec3> m_recentlyUsedCenters;
 
+  /**
+   * The rotation that is previewed while dragging. It is applied to the document when the
+   * rotation is committed.
+   */
+  std::optional<Rotation> m_rotation;
+
 public:
   explicit RotateObjectsTool(std::weak_ptr<MapDocument> document);
 
@@ -106,7 +106,7 @@ std::unique_ptr<CommandResult> SetLockStateCommand::doPerformDo(
 std::unique_ptr<CommandResult> SetLockStateCommand::doPerformUndo(
   MapDocumentCommandFacade* document)
 {
-  document->restoreLockState(m_oldLockState);
+  document->restoreLockState(m_nodes, m_oldLockState);
   return std::make_unique<CommandResult>(true);
 }
 } // namespace View
@@ -20,9 +20,9 @@
 #pragma once
 
 #include "Macros.h"
+#include "View/NodeStateRuns.h"
 #include "View/UndoableCommand.h"
 
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,7 +42,7 @@ class SetLockStateCommand : public UndoableCommand
 private:
   std::vector<Model::Node*> m_nodes;
   Model::LockState m_lockState;
-  std::map<Model::Node*, Model::LockState> m_oldLockState;
+  NodeStateRuns<Model::LockState> m_oldLockState;
 
 public:
   static std::unique_ptr<SetLockStateCommand> lock(
@@ -102,7 +102,7 @@ std::unique_ptr<CommandResult> SetVisibilityCommand::doPerformDo(
 std::unique_ptr<CommandResult> SetVisibilityCommand::doPerformUndo(
   MapDocumentCommandFacade* document)
 {
-  document->restoreVisibilityState(m_oldState);
+  document->restoreVisibilityState(m_nodes, m_oldState);
   return std::make_unique<CommandResult>(true);
 }
 } // namespace View
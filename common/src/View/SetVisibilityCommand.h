@@ -20,9 +20,9 @@
 #pragma once
 
 #include "Macros.h"
+#include "View/NodeStateRuns.h"
 #include "View/UndoableCommand.h"
 
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,7 +50,7 @@ private:
 
   std::vector<Model::Node*> m_nodes;
   Action m_action;
-  std::map<Model::Node*, Model::VisibilityState> m_oldState;
+  NodeStateRuns<Model::VisibilityState> m_oldState;
 
 public:
   static std::unique_ptr<SetVisibilityCommand> show(std::vector<Model::Node*> nodes);
@@ -0,0 +1,139 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "SwapBrushFaceAttributesCommand.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/NodeContents.h"
+#include "Model/TexCoordSystem.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include "kdl/vector_utils.h"
+
+#include "vm/vec.h"
+
+namespace TrenchBroom
+{
+namespace View
+{
+SwapBrushFaceAttributesCommand::SwapBrushFaceAttributesCommand(
+  const std::string& name, BrushFaceAttributesStates faces)
+  : UpdateLinkedGroupsCommandBase(name, true)
+  , m_faces(std::move(faces))
+{
+}
+
+SwapBrushFaceAttributesCommand::~SwapBrushFaceAttributesCommand() = default;
+
+/**
+ * Applies the given face states to copies of their brushes and swaps the copies into the
+ * brush nodes. Afterwards, the given face states hold the previous state of the faces.
+ */
+static void swapBrushFaceAttributes(
+  MapDocumentCommandFacade* document, BrushFaceAttributesStates& faces)
+{
+  auto nodesToSwap = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+  nodesToSwap.reserve(faces.size());
+
+  for (auto& [brushNode, faceStates] : faces)
+  {
+    auto brush = brushNode->brush();
+    for (auto& faceState : faceStates)
+    {
+      auto& face = brush.face(faceState.faceIndex);
+      auto attributes = face.attributes();
+      auto texCoordSystemSnapshot = face.takeTexCoordSystemSnapshot();
+
+      face.setAttributes(faceState.attributes);
+      if (faceState.texCoordSystemSnapshot)
+      {
+        face.restoreTexCoordSystemSnapshot(*faceState.texCoordSystemSnapshot);
+      }
+
+      faceState.attributes = std::move(attributes);
+      faceState.texCoordSystemSnapshot = std::move(texCoordSystemSnapshot);
+    }
+    nodesToSwap.emplace_back(brushNode, Model::NodeContents{std::move(brush)});
+  }
+
+  document->performSwapNodeContents(nodesToSwap);
+}
+
+std::unique_ptr<CommandResult> SwapBrushFaceAttributesCommand::doPerformDo(
+  MapDocumentCommandFacade* document)
+{
+  swapBrushFaceAttributes(document, m_faces);
+  return std::make_unique<CommandResult>(true);
+}
+
+std::unique_ptr<CommandResult> SwapBrushFaceAttributesCommand::doPerformUndo(
+  MapDocumentCommandFacade* document)
+{
+  swapBrushFaceAttributes(document, m_faces);
+  return std::make_unique<CommandResult>(true);
+}
+
+static std::vector<std::pair<Model::BrushNode*, size_t>> collectFaces(
+  const BrushFaceAttributesStates& faces)
+{
+  auto result = std::vector<std::pair<Model::BrushNode*, size_t>>{};
+  for (const auto& [brushNode, faceStates] : faces)
+  {
+    for (const auto& faceState : faceStates)
+    {
+      result.emplace_back(brushNode, faceState.faceIndex);
+    }
+  }
+  return kdl::vec_sort(std::move(result));
+}
+
+bool SwapBrushFaceAttributesCommand::doCollateWith(UndoableCommand& command)
+{
+  if (auto* other = dynamic_cast<SwapBrushFaceAttributesCommand*>(&command))
+  {
+    // we keep our own face states since they were recorded before the other command
+    return collectFaces(m_faces) == collectFaces(other->m_faces);
+  }
+
+  return false;
+}
+
+size_t SwapBrushFaceAttributesCommand::doEstimateMemoryUsage() const
+{
+  auto result = UpdateLinkedGroupsCommandBase::doEstimateMemoryUsage();
+  for (const auto& [brushNode, faceStates] : m_faces)
+  {
+    result +=
+      sizeof(brushNode) + faceStates.capacity() * sizeof(BrushFaceAttributesState);
+    for (const auto& faceState : faceStates)
+    {
+      result += faceState.attributes.textureName().capacity();
+      if (faceState.texCoordSystemSnapshot)
+      {
+        result += sizeof(Model::TexCoordSystemSnapshot) + 2u * sizeof(vm::vec3);
+      }
+    }
+  }
+  return result;
+}
+} // namespace View
+} // namespace TrenchBroom
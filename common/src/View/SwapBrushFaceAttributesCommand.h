@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Macros.h"
+#include "Model/BrushFaceAttributes.h"
+#include "View/UpdateLinkedGroupsCommandBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class BrushNode;
+class TexCoordSystemSnapshot;
+} // namespace Model
+
+namespace View
+{
+/**
+ * The texturing state of a single brush face, i.e., its attributes and the state of its
+ * texture coordinate system.
+ */
+struct BrushFaceAttributesState
+{
+  size_t faceIndex;
+  Model::BrushFaceAttributes attributes;
+  std::unique_ptr<Model::TexCoordSystemSnapshot> texCoordSystemSnapshot;
+};
+
+using BrushFaceAttributesStates =
+  std::vector<std::pair<Model::BrushNode*, std::vector<BrushFaceAttributesState>>>;
+
+/**
+ * Swaps the texturing state of brush faces.
+ *
+ * Unlike SwapNodeContentsCommand, this command does not store entire brushes, but only
+ * the state of the changed faces, which makes it considerably smaller for bulk texturing
+ * edits.
+ */
+class SwapBrushFaceAttributesCommand : public UpdateLinkedGroupsCommandBase
+{
+private:
+  BrushFaceAttributesStates m_faces;
+
+public:
+  SwapBrushFaceAttributesCommand(
+    const std::string& name, BrushFaceAttributesStates faces);
+  ~SwapBrushFaceAttributesCommand();
+
+  std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade* document) override;
+  std::unique_ptr<CommandResult> doPerformUndo(
+    MapDocumentCommandFacade* document) override;
+
+  bool doCollateWith(UndoableCommand& command) override;
+
+  size_t doEstimateMemoryUsage() const override;
+
+  deleteCopyAndMove(SwapBrushFaceAttributesCommand);
+};
+} // namespace View
+} // namespace TrenchBroom
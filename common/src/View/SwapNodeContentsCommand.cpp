@@ -41,10 +41,27 @@ SwapNodeContentsCommand::SwapNodeContentsCommand(
 
 SwapNodeContentsCommand::~SwapNodeContentsCommand() = default;
 
+/**
+ * After a swap, the given contents are only kept for undo or redo, so their brush
+ * geometry is compacted until it is swapped back in.
+ */
+static void compactBrushGeometry(
+  std::vector<std::pair<Model::Node*, Model::NodeContents>>& nodes)
+{
+  for (auto& pair : nodes)
+  {
+    if (auto* brush = std::get_if<Model::Brush>(&pair.second.get()))
+    {
+      brush->compactGeometry();
+    }
+  }
+}
+
 std::unique_ptr<CommandResult> SwapNodeContentsCommand::doPerformDo(
   MapDocumentCommandFacade* document)
 {
   document->performSwapNodeContents(m_nodes);
+  compactBrushGeometry(m_nodes);
   return std::make_unique<CommandResult>(true);
 }
 
@@ -52,6 +69,7 @@ std::unique_ptr<CommandResult> SwapNodeContentsCommand::doPerformUndo(
   MapDocumentCommandFacade* document)
 {
   document->performSwapNodeContents(m_nodes);
+  compactBrushGeometry(m_nodes);
   return std::make_unique<CommandResult>(true);
 }
 
@@ -72,5 +90,15 @@ bool SwapNodeContentsCommand::doCollateWith(UndoableCommand& command)
 
   return false;
 }
+
+size_t SwapNodeContentsCommand::doEstimateMemoryUsage() const
+{
+  auto result = UpdateLinkedGroupsCommandBase::doEstimateMemoryUsage();
+  for (const auto& pair : m_nodes)
+  {
+    result += pair.second.memoryUsage();
+  }
+  return result;
+}
 } // namespace View
 } // namespace TrenchBroom
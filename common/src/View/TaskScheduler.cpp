@@ -0,0 +1,198 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TaskScheduler.h"
+
+#include "View/MapDocument.h"
+
+#include "kdl/thread_pool.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace TrenchBroom::View
+{
+
+bool TaskContext::cancelled() const
+{
+  return m_cancelled.load(std::memory_order_relaxed);
+}
+
+void TaskContext::cancel()
+{
+  m_cancelled.store(true, std::memory_order_relaxed);
+}
+
+float TaskContext::progress() const
+{
+  return m_progress.load(std::memory_order_relaxed);
+}
+
+void TaskContext::setProgress(const float progress)
+{
+  m_progress.store(std::clamp(progress, 0.0f, 1.0f), std::memory_order_relaxed);
+}
+
+TaskScheduler::TaskScheduler(MapDocument& document)
+  : m_document{document}
+{
+}
+
+TaskScheduler::~TaskScheduler()
+{
+  cancelAll();
+}
+
+bool TaskScheduler::hasTasks() const
+{
+  return !m_tasks.empty();
+}
+
+std::vector<TaskInfo> TaskScheduler::tasks() const
+{
+  return kdl::vec_transform(m_tasks, [](const auto& task) {
+    return TaskInfo{task.id, task.name, task.context->progress()};
+  });
+}
+
+void TaskScheduler::cancel(const size_t id)
+{
+  const auto it = std::find_if(
+    m_tasks.begin(), m_tasks.end(), [&](const auto& task) { return task.id == id; });
+  if (it != m_tasks.end())
+  {
+    it->context->cancel();
+    m_tasks.erase(it);
+  }
+}
+
+void TaskScheduler::cancelAll()
+{
+  for (auto& task : m_tasks)
+  {
+    task.context->cancel();
+  }
+  m_tasks.clear();
+}
+
+size_t TaskScheduler::processFinishedTasks(const bool wait)
+{
+  using namespace std::chrono_literals;
+
+  // the finished tasks are removed first because applying them may submit new tasks
+  auto finishedTasks = std::vector<Task>{};
+  auto it = m_tasks.begin();
+  while (it != m_tasks.end())
+  {
+    if (wait || it->result.wait_for(0s) == std::future_status::ready)
+    {
+      finishedTasks.push_back(std::move(*it));
+      it = m_tasks.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  auto count = size_t(0);
+  for (auto& task : finishedTasks)
+  {
+    if (applyTask(task))
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+
+size_t TaskScheduler::submitTask(std::string name, WorkFunction work)
+{
+  const auto id = m_nextId++;
+  auto context = std::make_shared<TaskContext>();
+  auto promise = std::make_shared<std::promise<ApplyFunction>>();
+  auto result = promise->get_future();
+
+  // the work function must not access the document, so it does not matter if the
+  // document is destroyed while the work function is running
+  kdl::default_thread_pool().submit(
+    [work = std::move(work), context, promise = std::move(promise)]() mutable {
+      try
+      {
+        promise->set_value(work(*context));
+      }
+      catch (...)
+      {
+        promise->set_exception(std::current_exception());
+      }
+    });
+
+  m_tasks.push_back(Task{
+    id,
+    std::move(name),
+    m_document.modificationCount(),
+    std::move(context),
+    std::move(result),
+  });
+  return id;
+}
+
+bool TaskScheduler::applyTask(Task& task)
+{
+  auto apply = ApplyFunction{};
+  try
+  {
+    apply = task.result.get();
+  }
+  catch (const std::exception& e)
+  {
+    m_document.error() << "Task '" << task.name << "' failed: " << e.what();
+    return false;
+  }
+
+  if (task.context->cancelled())
+  {
+    return false;
+  }
+
+  if (task.modificationCount != m_document.modificationCount())
+  {
+    m_document.warn() << "Discarding result of task '" << task.name
+                      << "' because the document was modified while it was running";
+    return false;
+  }
+
+  auto transaction = Transaction{m_document, task.name};
+  try
+  {
+    apply(m_document);
+  }
+  catch (const std::exception& e)
+  {
+    transaction.cancel();
+    m_document.error() << "Could not apply result of task '" << task.name
+                       << "': " << e.what();
+    return false;
+  }
+  return transaction.commit();
+}
+
+} // namespace TrenchBroom::View
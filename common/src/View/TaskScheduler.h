@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom::View
+{
+class MapDocument;
+
+/**
+ * Passed to the work function of a task. The work function should check whether the task
+ * was cancelled regularly and stop early if it was, and it may report its progress.
+ */
+class TaskContext
+{
+private:
+  std::atomic<bool> m_cancelled{false};
+  std::atomic<float> m_progress{0.0f};
+
+public:
+  bool cancelled() const;
+  void cancel();
+
+  /**
+   * Returns the progress of the task as a value between 0 and 1.
+   */
+  float progress() const;
+  void setProgress(float progress);
+};
+
+struct TaskInfo
+{
+  size_t id;
+  std::string name;
+  float progress;
+};
+
+/**
+ * Runs tasks on the worker threads of the default thread pool and applies their results
+ * to the document on the main thread.
+ *
+ * A task consists of a work function and an apply function. The work function runs on a
+ * worker thread and must only use the data it has captured, i.e. a snapshot of the
+ * document state taken when the task was submitted, and never the document itself. Its
+ * result is passed to the apply function, which runs on the main thread within a single
+ * transaction named after the task, so that the task can be undone in one step.
+ *
+ * If the document was modified while a task was running, its result was computed from an
+ * outdated snapshot and is discarded.
+ *
+ * Finished tasks are only applied when processFinishedTasks is called, which the map
+ * frame does periodically from the Qt event loop.
+ */
+class TaskScheduler
+{
+public:
+  using ApplyFunction = std::function<void(MapDocument&)>;
+  using WorkFunction = std::function<ApplyFunction(TaskContext&)>;
+
+private:
+  struct Task
+  {
+    size_t id;
+    std::string name;
+    size_t modificationCount;
+    std::shared_ptr<TaskContext> context;
+    std::future<ApplyFunction> result;
+  };
+
+  MapDocument& m_document;
+  size_t m_nextId = 1;
+  std::vector<Task> m_tasks;
+
+public:
+  explicit TaskScheduler(MapDocument& document);
+  ~TaskScheduler();
+
+  deleteCopyAndMove(TaskScheduler);
+
+  /**
+   * Submits a task with the given name and returns its ID.
+   *
+   * The work function is called with a TaskContext& on a worker thread and returns the
+   * result, which is then passed to the apply function together with the document on the
+   * main thread.
+   */
+  template <typename W, typename A>
+  size_t submit(std::string name, W work, A apply)
+  {
+    return submitTask(
+      std::move(name),
+      [work = std::move(work),
+       apply = std::make_shared<A>(std::move(apply))](TaskContext& context) mutable {
+        auto result = std::make_shared<decltype(work(context))>(work(context));
+        return ApplyFunction{[apply = std::move(apply), result = std::move(result)](
+                               MapDocument& document) {
+          (*apply)(document, std::move(*result));
+        }};
+      });
+  }
+
+  bool hasTasks() const;
+  std::vector<TaskInfo> tasks() const;
+
+  /**
+   * Cancels the task with the given ID. Its result will not be applied.
+   */
+  void cancel(size_t id);
+  void cancelAll();
+
+  /**
+   * Applies the results of the finished tasks to the document in the order in which the
+   * tasks were submitted. If wait is true, waits for all running tasks to finish first.
+   *
+   * Returns the number of tasks that were applied.
+   */
+  size_t processFinishedTasks(bool wait = false);
+
+private:
+  size_t submitTask(std::string name, WorkFunction work);
+  bool applyTask(Task& task);
+};
+
+} // namespace TrenchBroom::View
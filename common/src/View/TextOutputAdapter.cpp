@@ -22,7 +22,9 @@
 #include <QByteArray>
 #include <QScrollBar>
 #include <QString>
+#include <QTextCursor>
 #include <QTextEdit>
+#include <QTimer>
 
 #include "Ensure.h"
 
@@ -32,22 +34,18 @@ namespace TrenchBroom
 {
 namespace View
 {
-TextOutputAdapter::TextOutputAdapter(QTextEdit* textEdit)
+struct TextOutputAdapter::State
 {
-  ensure(textEdit != nullptr, "textEdit is null");
-  m_textEdit = textEdit;
-
-  // Create our own private cursor, separate from the UI cursor
-  // so user selections don't interfere with our text insertions
-  m_insertionCursor = QTextCursor(m_textEdit->document());
-  m_insertionCursor.movePosition(QTextCursor::End);
-}
+  QTextEdit* textEdit;
+  QTextCursor insertionCursor;
+  QString pendingOutput;
+  bool flushScheduled = false;
+};
 
-void TextOutputAdapter::appendString(const QString& string)
+namespace
+{
+void insertString(QTextCursor& insertionCursor, const QString& string)
 {
-  QScrollBar* scrollBar = m_textEdit->verticalScrollBar();
-  const bool wasAtBottom = (scrollBar->value() >= scrollBar->maximum());
-
   const int size = string.size();
   for (int i = 0; i < size; ++i)
   {
@@ -62,14 +60,14 @@ void TextOutputAdapter::appendString(const QString& string)
     // Handle LF
     if (c == '\n')
     {
-      m_insertionCursor.movePosition(QTextCursor::End);
-      m_insertionCursor.insertBlock();
+      insertionCursor.movePosition(QTextCursor::End);
+      insertionCursor.insertBlock();
       continue;
     }
     // Handle CR, next character not LF
     if (c == '\r')
     {
-      m_insertionCursor.movePosition(QTextCursor::StartOfLine);
+      insertionCursor.movePosition(QTextCursor::StartOfLine);
       continue;
     }
 
@@ -87,21 +85,72 @@ void TextOutputAdapter::appendString(const QString& string)
     }
     const int insertionSize = lastToInsert - i + 1;
     const QString substring = string.mid(i, insertionSize);
-    if (!m_insertionCursor.atEnd())
+    if (!insertionCursor.atEnd())
     {
       // This means a CR was previously used. We need to select
       // the same number of characters as we're inserting, so the
       // text is overwritten.
-      m_insertionCursor.movePosition(
+      insertionCursor.movePosition(
         QTextCursor::NextCharacter, QTextCursor::KeepAnchor, insertionSize);
     }
-    m_insertionCursor.insertText(substring);
+    insertionCursor.insertText(substring);
     i = lastToInsert;
   }
+}
+} // namespace
+
+void TextOutputAdapter::flushState(State& state)
+{
+  state.flushScheduled = false;
+  if (state.pendingOutput.isEmpty())
+  {
+    return;
+  }
+
+  auto string = std::move(state.pendingOutput);
+  state.pendingOutput.clear();
+
+  QScrollBar* scrollBar = state.textEdit->verticalScrollBar();
+  const bool wasAtBottom = (scrollBar->value() >= scrollBar->maximum());
+
+  // insert the entire batch as one edit so that the document layout is updated once
+  state.insertionCursor.beginEditBlock();
+  insertString(state.insertionCursor, string);
+  state.insertionCursor.endEditBlock();
 
   if (wasAtBottom)
   {
-    m_textEdit->verticalScrollBar()->setValue(m_textEdit->verticalScrollBar()->maximum());
+    scrollBar->setValue(scrollBar->maximum());
+  }
+}
+
+TextOutputAdapter::TextOutputAdapter(QTextEdit* textEdit)
+{
+  ensure(textEdit != nullptr, "textEdit is null");
+
+  // Create our own private cursor, separate from the UI cursor
+  // so user selections don't interfere with our text insertions
+  auto insertionCursor = QTextCursor(textEdit->document());
+  insertionCursor.movePosition(QTextCursor::End);
+
+  m_state = std::make_shared<State>(State{textEdit, std::move(insertionCursor), {}});
+}
+
+void TextOutputAdapter::flush()
+{
+  flushState(*m_state);
+}
+
+void TextOutputAdapter::appendString(const QString& string)
+{
+  m_state->pendingOutput.append(string);
+  if (!m_state->flushScheduled)
+  {
+    m_state->flushScheduled = true;
+    // the timer is cancelled if the text widget is destroyed, and it keeps the state
+    // alive even if this adapter is destroyed
+    QTimer::singleShot(
+      FlushInterval, m_state->textEdit, [state = m_state]() { flushState(*state); });
   }
 }
 } // namespace View
@@ -20,9 +20,11 @@
 #pragma once
 
 #include <QString>
-#include <QTextCursor>
 #include <QTextStream>
 
+#include <chrono>
+#include <memory>
+
 class QTextEdit;
 
 namespace TrenchBroom
@@ -34,16 +36,28 @@ namespace View
  *
  * - Interprets CR and LF control characters.
  * - Scroll bar follows output, unless it's manually raised.
+ * - Output is buffered and appended to the text widget at a fixed rate, so that tools
+ *   which print many lines do not keep the UI thread busy with updating the widget.
+ *
+ * Copies of an adapter share their buffer.
  */
 class TextOutputAdapter
 {
+public:
+  static constexpr auto FlushInterval = std::chrono::milliseconds{50};
+
 private:
-  QTextEdit* m_textEdit;
-  QTextCursor m_insertionCursor;
+  struct State;
+  std::shared_ptr<State> m_state;
 
 public:
   explicit TextOutputAdapter(QTextEdit* textEdit);
 
+  /**
+   * Appends any buffered output to the text widget immediately.
+   */
+  void flush();
+
   /**
    * Appends the given value to the text widget.
    * Objects are formatted using QTextStream.
@@ -59,6 +73,7 @@ public:
   }
 
 private:
+  static void flushState(State& state);
   void appendString(const QString& string);
 };
 } // namespace View
@@ -190,8 +190,8 @@ void TextureBrowser::connectObservers()
     document->nodesWereAddedNotifier.connect(this, &TextureBrowser::nodesWereAdded);
   m_notifierConnection +=
     document->nodesWereRemovedNotifier.connect(this, &TextureBrowser::nodesWereRemoved);
-  m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &TextureBrowser::nodesDidChange);
+  m_notifierConnection += document->batchedNodesDidChangeNotifier.connect(
+    this, &TextureBrowser::nodesDidChange);
   m_notifierConnection += document->brushFacesDidChangeNotifier.connect(
     this, &TextureBrowser::brushFacesDidChange);
   m_notifierConnection += document->textureCollectionsDidChangeNotifier.connect(
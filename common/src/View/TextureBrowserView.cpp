@@ -41,7 +41,6 @@
 #include "kdl/memory_utils.h"
 #include "kdl/skip_iterator.h"
 #include "kdl/string_compare.h"
-#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/mat.h"
@@ -160,17 +159,19 @@ void TextureBrowserView::doReloadLayout(Layout& layout)
 
   const auto font = Renderer::FontDescriptor{fontPath, size_t(fontSize)};
 
+  const auto matchingTextures = findMatchingTextures();
+
   if (m_group)
   {
     for (const auto* collection : getCollections())
     {
       layout.addGroup(collection->path().u8string(), float(fontSize) + 2.0f);
-      addTexturesToLayout(layout, getTextures(*collection), font);
+      addTexturesToLayout(layout, getTextures(*collection, matchingTextures), font);
     }
   }
   else
   {
-    addTexturesToLayout(layout, getTextures(), font);
+    addTexturesToLayout(layout, getTextures(matchingTextures), font);
   }
 }
 
@@ -223,13 +224,16 @@ std::vector<const Assets::TextureCollection*> TextureBrowserView::getCollections
 }
 
 std::vector<const Assets::Texture*> TextureBrowserView::getTextures(
-  const Assets::TextureCollection& collection) const
+  const Assets::TextureCollection& collection,
+  const std::optional<TextureSet>& matchingTextures) const
 {
   return sortTextures(filterTextures(
-    kdl::vec_transform(collection.textures(), [](const auto& t) { return &t; })));
+    kdl::vec_transform(collection.textures(), [](const auto& t) { return &t; }),
+    matchingTextures));
 }
 
-std::vector<const Assets::Texture*> TextureBrowserView::getTextures() const
+std::vector<const Assets::Texture*> TextureBrowserView::getTextures(
+  const std::optional<TextureSet>& matchingTextures) const
 {
   auto document = kdl::mem_lock(m_document);
   auto textures = std::vector<const Assets::Texture*>{};
@@ -243,11 +247,25 @@ std::vector<const Assets::Texture*> TextureBrowserView::getTextures() const
       }
     }
   }
-  return sortTextures(filterTextures(textures));
+  return sortTextures(filterTextures(textures, matchingTextures));
+}
+
+std::optional<TextureBrowserView::TextureSet> TextureBrowserView::
+  findMatchingTextures() const
+{
+  if (m_filterText.empty())
+  {
+    return std::nullopt;
+  }
+
+  auto document = kdl::mem_lock(m_document);
+  const auto textures = document->textureManager().findTextures(m_filterText);
+  return TextureSet{textures.begin(), textures.end()};
 }
 
 std::vector<const Assets::Texture*> TextureBrowserView::filterTextures(
-  std::vector<const Assets::Texture*> textures) const
+  std::vector<const Assets::Texture*> textures,
+  const std::optional<TextureSet>& matchingTextures) const
 {
   if (m_hideUnused)
   {
@@ -255,12 +273,10 @@ std::vector<const Assets::Texture*> TextureBrowserView::filterTextures(
       return texture->usageCount() == 0;
     });
   }
-  if (!m_filterText.empty())
+  if (matchingTextures)
   {
     textures = kdl::vec_erase_if(std::move(textures), [&](const auto* texture) {
-      return !kdl::all_of(kdl::str_split(m_filterText, " "), [&](const auto& pattern) {
-        return kdl::ci::str_contains(texture->name(), pattern);
-      });
+      return matchingTextures->count(texture) == 0;
     });
   }
   return textures;
@@ -306,6 +322,11 @@ void TextureBrowserView::doRender(Layout& layout, const float y, const float hei
 
   renderBounds(layout, y, height);
   renderTextures(layout, y, height);
+
+  if (document->textureManager().hasPendingUploads())
+  {
+    update();
+  }
 }
 
 bool TextureBrowserView::doShouldRenderFocusIndicator() const
@@ -323,32 +344,32 @@ void TextureBrowserView::renderBounds(Layout& layout, const float y, const float
   using BoundsVertex = Renderer::GLVertexTypes::P2C4::Vertex;
   auto vertices = std::vector<BoundsVertex>{};
 
-  for (const auto& group : layout.groups())
+  for (const auto& group : layout.visibleGroups(y, height))
   {
-    if (group.intersectsY(y, height))
+    for (const auto& row : group.visibleRows(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& cell : row.cells())
       {
-        if (row.intersectsY(y, height))
+        const auto& bounds = cell.itemBounds();
+        const auto& texture = cellData(cell);
+        if (!texture.isPrepared() && !texture.isThumbnailPrepared())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& bounds = cell.itemBounds();
-            const auto& texture = cellData(cell);
-            const auto& color = textureColor(texture);
-            vertices.emplace_back(
-              vm::vec2f{bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)}, color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)},
-              color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)},
-              color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)},
-              color);
-          }
+          // the texture will be shown once it or its thumbnail has been uploaded
+          texture.requestThumbnail();
+          continue;
         }
+        const auto& color = textureColor(texture);
+        vertices.emplace_back(
+          vm::vec2f{bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)}, color);
+        vertices.emplace_back(
+          vm::vec2f{bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)},
+          color);
+        vertices.emplace_back(
+          vm::vec2f{bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)},
+          color);
+        vertices.emplace_back(
+          vm::vec2f{bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)},
+          color);
       }
     }
   }
@@ -384,34 +405,42 @@ void TextureBrowserView::renderTextures(Layout& layout, const float y, const flo
   shader.set("Texture", 0);
   shader.set("Brightness", pref(Preferences::Brightness));
 
-  for (const auto& group : layout.groups())
+  for (const auto& group : layout.visibleGroups(y, height))
   {
-    if (group.intersectsY(y, height))
+    for (const auto& row : group.visibleRows(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& cell : row.cells())
       {
-        if (row.intersectsY(y, height))
+        const auto& bounds = cell.itemBounds();
+        const auto& texture = cellData(cell);
+
+        auto vertexArray = Renderer::VertexArray::move(std::vector<TextureVertex>{
+          TextureVertex{{bounds.left(), height - (bounds.top() - y)}, {0, 0}},
+          TextureVertex{{bounds.left(), height - (bounds.bottom() - y)}, {0, 1}},
+          TextureVertex{{bounds.right(), height - (bounds.bottom() - y)}, {1, 1}},
+          TextureVertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
+        });
+
+        shader.set("GrayScale", texture.overridden());
+        if (texture.isPrepared())
+        {
+          texture.activate();
+        }
+        else
+        {
+          texture.activateThumbnail();
+        }
+
+        vertexArray.prepare(vboManager());
+        vertexArray.render(Renderer::PrimType::Quads);
+
+        if (texture.isPrepared())
+        {
+          texture.deactivate();
+        }
+        else
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& bounds = cell.itemBounds();
-            const auto& texture = cellData(cell);
-
-            auto vertexArray = Renderer::VertexArray::move(std::vector<TextureVertex>{
-              TextureVertex{{bounds.left(), height - (bounds.top() - y)}, {0, 0}},
-              TextureVertex{{bounds.left(), height - (bounds.bottom() - y)}, {0, 1}},
-              TextureVertex{{bounds.right(), height - (bounds.bottom() - y)}, {1, 1}},
-              TextureVertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
-            });
-
-            shader.set("GrayScale", texture.overridden());
-            texture.activate();
-
-            vertexArray.prepare(vboManager());
-            vertexArray.render(Renderer::PrimType::Quads);
-
-            texture.deactivate();
-          }
+          texture.deactivateThumbnail();
         }
       }
     }
@@ -26,7 +26,9 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 class QScrollBar;
@@ -94,13 +96,24 @@ private:
   void addTextureToLayout(
     Layout& layout, const Assets::Texture* texture, const Renderer::FontDescriptor& font);
 
+  using TextureSet = std::unordered_set<const Assets::Texture*>;
+
   std::vector<const Assets::TextureCollection*> getCollections() const;
   std::vector<const Assets::Texture*> getTextures(
-    const Assets::TextureCollection& collection) const;
-  std::vector<const Assets::Texture*> getTextures() const;
+    const Assets::TextureCollection& collection,
+    const std::optional<TextureSet>& matchingTextures) const;
+  std::vector<const Assets::Texture*> getTextures(
+    const std::optional<TextureSet>& matchingTextures) const;
+
+  /**
+   * Returns the textures whose names match the filter text, or nothing if the filter text
+   * is empty.
+   */
+  std::optional<TextureSet> findMatchingTextures() const;
 
   std::vector<const Assets::Texture*> filterTextures(
-    std::vector<const Assets::Texture*> textures) const;
+    std::vector<const Assets::Texture*> textures,
+    const std::optional<TextureSet>& matchingTextures) const;
   std::vector<const Assets::Texture*> sortTextures(
     std::vector<const Assets::Texture*> textures) const;
 
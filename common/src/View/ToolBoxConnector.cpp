@@ -28,6 +28,8 @@
 #include "View/ToolChain.h"
 #include "View/ToolController.h"
 
+#include "kdl/set_temp.h"
+
 #include <string>
 
 namespace TrenchBroom
@@ -40,6 +42,9 @@ ToolBoxConnector::ToolBoxConnector()
   , m_lastMouseX(0.0f)
   , m_lastMouseY(0.0f)
   , m_ignoreNextDrag(false)
+  , m_approximatePickResult(false)
+  , m_processingEvent(false)
+  , m_pickResultStale(false)
 {
 }
 
@@ -64,11 +69,45 @@ void ToolBoxConnector::updatePickResult()
 
   m_inputState.setPickRequest(
     doGetPickRequest(m_inputState.mouseX(), m_inputState.mouseY()));
+  m_approximatePickResult = false;
+  m_pickResultStale = false;
   Model::PickResult pickResult = doPick(m_inputState.pickRay());
   m_toolBox->pick(m_toolChain, m_inputState, pickResult);
   m_inputState.setPickResult(std::move(pickResult));
 }
 
+void ToolBoxConnector::updateHoverPickResult()
+{
+  ensure(m_toolBox != nullptr, "toolBox is null");
+
+  m_inputState.setPickRequest(
+    doGetPickRequest(m_inputState.mouseX(), m_inputState.mouseY()));
+  if (auto hoverPickResult = doPickHover(
+        m_inputState.mouseX(), m_inputState.mouseY(), m_inputState.pickRay()))
+  {
+    m_toolBox->pick(m_toolChain, m_inputState, *hoverPickResult);
+    m_inputState.setPickResult(std::move(*hoverPickResult));
+    m_approximatePickResult = true;
+    m_pickResultStale = false;
+  }
+  else
+  {
+    updatePickResult();
+  }
+}
+
+void ToolBoxConnector::invalidatePickResult()
+{
+  if (m_processingEvent)
+  {
+    m_pickResultStale = true;
+  }
+  else
+  {
+    updatePickResult();
+  }
+}
+
 void ToolBoxConnector::setToolBox(ToolBox& toolBox)
 {
   assert(m_toolBox == nullptr);
@@ -220,6 +259,20 @@ void ToolBoxConnector::processEvent(const KeyEvent&)
 }
 
 void ToolBoxConnector::processEvent(const MouseEvent& event)
+{
+  {
+    const auto processingEvent = kdl::set_temp{m_processingEvent};
+    processMouseEvent(event);
+  }
+
+  if (m_pickResultStale)
+  {
+    updatePickResult();
+  }
+  m_inputState.setAnyToolDragging(m_toolBox->dragging());
+}
+
+void ToolBoxConnector::processMouseEvent(const MouseEvent& event)
 {
   switch (event.type)
   {
@@ -252,7 +305,6 @@ void ToolBoxConnector::processEvent(const MouseEvent& event)
     break;
     switchDefault();
   }
-  m_inputState.setAnyToolDragging(m_toolBox->dragging());
 }
 
 void ToolBoxConnector::processEvent(const CancelEvent&)
@@ -263,6 +315,11 @@ void ToolBoxConnector::processEvent(const CancelEvent&)
 void ToolBoxConnector::processMouseButtonDown(const MouseEvent& event)
 {
   updateModifierKeys();
+  if (m_approximatePickResult)
+  {
+    // the tools must not act on a hover pick result
+    updatePickResult();
+  }
   m_inputState.mouseDown(mouseButton(event));
   m_toolBox->mouseDown(m_toolChain, m_inputState);
 
@@ -305,7 +362,14 @@ void ToolBoxConnector::processMouseDoubleClick(const MouseEvent& event)
 void ToolBoxConnector::processMouseMotion(const MouseEvent& event)
 {
   mouseMoved(event.posX, event.posY);
-  updatePickResult();
+  if (m_inputState.mouseButtons() == MouseButtons::MBNone && !m_toolBox->dragging())
+  {
+    updateHoverPickResult();
+  }
+  else
+  {
+    updatePickResult();
+  }
   m_toolBox->mouseMove(m_toolChain, m_inputState);
 }
 
@@ -398,6 +462,12 @@ bool ToolBoxConnector::cancelDrag()
   }
 }
 
+std::optional<Model::PickResult> ToolBoxConnector::doPickHover(
+  const float, const float, const vm::ray3&)
+{
+  return std::nullopt;
+}
+
 void ToolBoxConnector::doShowPopupMenu() {}
 } // namespace View
 } // namespace TrenchBroom
@@ -24,6 +24,7 @@
 #include "View/InputState.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace TrenchBroom
@@ -58,6 +59,9 @@ private:
   float m_lastMouseX;
   float m_lastMouseY;
   bool m_ignoreNextDrag;
+  bool m_approximatePickResult;
+  bool m_processingEvent;
+  bool m_pickResultStale;
 
 public:
   ToolBoxConnector();
@@ -69,6 +73,23 @@ public:
 
   void updatePickResult();
 
+  /**
+   * Notifies this connector that the pick result may be out of date, e.g. because the
+   * document changed. While a mouse event is being processed, the tools may change the
+   * document several times, so the pick result is only recomputed once after the event
+   * has been processed unless it is updated in the meantime. Otherwise, the pick result
+   * is updated immediately.
+   */
+  void invalidatePickResult();
+
+private:
+  /**
+   * Updates the pick result while the mouse is hovering over the view. Uses the cheaper
+   * but possibly less complete pick result of doPickHover if there is one; it is
+   * replaced with an exact pick result when a mouse button goes down.
+   */
+  void updateHoverPickResult();
+
 protected:
   void setToolBox(ToolBox& toolBox);
   void addTool(std::unique_ptr<ToolController> tool);
@@ -104,6 +125,7 @@ public: // implement InputEventProcessor interface
   void processEvent(const CancelEvent& event) override;
 
 private:
+  void processMouseEvent(const MouseEvent& event);
   void processMouseButtonDown(const MouseEvent& event);
   void processMouseButtonUp(const MouseEvent& event);
   void processMouseClick(const MouseEvent& event);
@@ -123,6 +145,8 @@ public:
 private:
   virtual PickRequest doGetPickRequest(float x, float y) const = 0;
   virtual Model::PickResult doPick(const vm::ray3& pickRay) const = 0;
+  virtual std::optional<Model::PickResult> doPickHover(
+    float x, float y, const vm::ray3& pickRay);
   virtual void doShowPopupMenu();
 
   deleteCopyAndMove(ToolBoxConnector);
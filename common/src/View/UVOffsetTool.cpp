@@ -27,7 +27,6 @@
 #include "View/DragTracker.h"
 #include "View/InputState.h"
 #include "View/MapDocument.h"
-#include "View/TransactionScope.h"
 #include "View/UVView.h"
 
 #include "kdl/memory_utils.h"
@@ -115,7 +114,7 @@ public:
     , m_helper{helper}
     , m_lastPoint{computeHitPoint(m_helper, inputState.pickRay())}
   {
-    m_document.startTransaction("Move Texture", TransactionScope::LongRunning);
+    m_document.startTexturePreview();
   }
 
   bool drag(const InputState& inputState)
@@ -137,15 +136,15 @@ public:
     auto request = Model::ChangeBrushFaceAttributesRequest{};
     request.setOffset(corrected);
 
-    m_document.setFaceAttributes(request);
+    m_document.previewFaceAttributes(request);
 
     m_lastPoint = m_lastPoint + snapped;
     return true;
   }
 
-  void end(const InputState&) { m_document.commitTransaction(); }
+  void end(const InputState&) { m_document.commitTexturePreview("Move Texture"); }
 
-  void cancel() { m_document.cancelTransaction(); }
+  void cancel() { m_document.cancelTexturePreview(); }
 };
 } // namespace
 
@@ -40,7 +40,6 @@
 #include "View/DragTracker.h"
 #include "View/InputState.h"
 #include "View/MapDocument.h"
-#include "View/TransactionScope.h"
 #include "View/UVViewHelper.h"
 
 #include "kdl/memory_utils.h"
@@ -257,7 +256,7 @@ public:
     , m_helper{helper}
     , m_initialAngle{initialAngle}
   {
-    document.startTransaction("Rotate Texture", TransactionScope::LongRunning);
+    document.startTexturePreview();
   }
 
   bool drag(const InputState& inputState) override
@@ -285,7 +284,7 @@ public:
 
     auto request = Model::ChangeBrushFaceAttributesRequest{};
     request.setRotation(snappedAngle);
-    m_document.setFaceAttributes(request);
+    m_document.previewFaceAttributes(request);
 
     // Correct the offsets.
     const auto toFaceNew =
@@ -299,14 +298,17 @@ public:
 
     request.clear();
     request.setOffset(newOffset);
-    m_document.setFaceAttributes(request);
+    m_document.previewFaceAttributes(request);
 
     return true;
   }
 
-  void end(const InputState&) override { m_document.commitTransaction(); }
+  void end(const InputState&) override
+  {
+    m_document.commitTexturePreview("Rotate Texture");
+  }
 
-  void cancel() override { m_document.cancelTransaction(); }
+  void cancel() override { m_document.cancelTexturePreview(); }
 
   void render(
     const InputState&,
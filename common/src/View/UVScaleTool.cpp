@@ -35,7 +35,6 @@
 #include "View/DragTracker.h"
 #include "View/InputState.h"
 #include "View/MapDocument.h"
-#include "View/TransactionScope.h"
 #include "View/UVOriginTool.h"
 #include "View/UVViewHelper.h"
 
@@ -219,7 +218,7 @@ public:
     , m_selector{selector}
     , m_lastHitPoint{initialHitPoint}
   {
-    document.startTransaction("Scale Texture", TransactionScope::LongRunning);
+    document.startTexturePreview();
   }
 
   bool drag(const InputState& inputState) override
@@ -254,14 +253,14 @@ public:
 
     auto request = Model::ChangeBrushFaceAttributesRequest{};
     request.setScale(newScale);
-    m_document.setFaceAttributes(request);
+    m_document.previewFaceAttributes(request);
 
     const auto newOriginInTexCoords = vm::correct(m_helper.originInTexCoords(), 4, 0.0f);
     const auto originDelta = originHandlePosTexCoords - newOriginInTexCoords;
 
     request.clear();
     request.addOffset(originDelta);
-    m_document.setFaceAttributes(request);
+    m_document.previewFaceAttributes(request);
 
     m_lastHitPoint =
       m_lastHitPoint
@@ -269,9 +268,12 @@ public:
     return true;
   }
 
-  void end(const InputState&) override { m_document.commitTransaction(); }
+  void end(const InputState&) override
+  {
+    m_document.commitTexturePreview("Scale Texture");
+  }
 
-  void cancel() override { m_document.cancelTransaction(); }
+  void cancel() override { m_document.cancelTexturePreview(); }
 
   void render(
     const InputState&,
@@ -27,7 +27,6 @@
 #include "View/DragTracker.h"
 #include "View/InputState.h"
 #include "View/MapDocument.h"
-#include "View/TransactionScope.h"
 #include "View/UVViewHelper.h"
 
 #include "kdl/memory_utils.h"
@@ -114,7 +113,7 @@ public:
     , m_initialHit{initialHit}
     , m_lastHit{initialHit}
   {
-    m_document.startTransaction("Shear Texture", TransactionScope::LongRunning);
+    m_document.startTexturePreview();
   }
 
   bool drag(const InputState& inputState) override
@@ -133,7 +132,7 @@ public:
       const auto factors = vm::vec2f{-delta.y() / m_initialHit.x(), 0.0f};
       if (!vm::is_zero(factors, vm::Cf::almost_zero()))
       {
-        m_document.shearTextures(factors);
+        m_document.previewShearTextures(factors);
       }
     }
     else if (m_selector[1])
@@ -141,7 +140,7 @@ public:
       const auto factors = vm::vec2f{0.0f, -delta.x() / m_initialHit.y()};
       if (!vm::is_zero(factors, vm::Cf::almost_zero()))
       {
-        m_document.shearTextures(factors);
+        m_document.previewShearTextures(factors);
       }
     }
 
@@ -153,15 +152,18 @@ public:
 
     auto request = Model::ChangeBrushFaceAttributesRequest{};
     request.setOffset(newOffset);
-    m_document.setFaceAttributes(request);
+    m_document.previewFaceAttributes(request);
 
     m_lastHit = currentHit;
     return true;
   }
 
-  void end(const InputState&) override { m_document.commitTransaction(); }
+  void end(const InputState&) override
+  {
+    m_document.commitTexturePreview("Shear Texture");
+  }
 
-  void cancel() override { m_document.cancelTransaction(); }
+  void cancel() override { m_document.cancelTexturePreview(); }
 };
 } // namespace
 
@@ -31,6 +31,7 @@ namespace View
 UndoableCommand::UndoableCommand(std::string name, const bool updateModificationCount)
   : Command{std::move(name)}
   , m_modificationCount{updateModificationCount ? 1u : 0u}
+  , m_memoryUsage{0u}
 {
 }
 
@@ -75,11 +76,27 @@ bool UndoableCommand::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UndoableCommand::memoryUsage() const
+{
+  return m_memoryUsage;
+}
+
+size_t UndoableCommand::updateMemoryUsage()
+{
+  m_memoryUsage = doEstimateMemoryUsage();
+  return m_memoryUsage;
+}
+
 bool UndoableCommand::doCollateWith(UndoableCommand&)
 {
   return false;
 }
 
+size_t UndoableCommand::doEstimateMemoryUsage() const
+{
+  return sizeof(UndoableCommand);
+}
+
 void UndoableCommand::setModificationCount(MapDocumentCommandFacade* document)
 {
   if (document && m_modificationCount)
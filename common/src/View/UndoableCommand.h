@@ -35,6 +35,7 @@ class UndoableCommand : public Command
 {
 private:
   size_t m_modificationCount;
+  size_t m_memoryUsage;
 
 protected:
   UndoableCommand(std::string name, bool updateModificationCount);
@@ -47,12 +48,31 @@ public:
 
   virtual bool collateWith(UndoableCommand& command);
 
+  /**
+   * Returns the memory usage of this command in bytes, as estimated by the most recent
+   * call to updateMemoryUsage.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Estimates the memory used by this command and returns the estimate. The estimate
+   * depends on the state of the command, so it must be updated after the command was
+   * executed, undone or collated.
+   */
+  size_t updateMemoryUsage();
+
 protected:
   virtual std::unique_ptr<CommandResult> doPerformUndo(
     MapDocumentCommandFacade* document) = 0;
 
   virtual bool doCollateWith(UndoableCommand& command);
 
+  /**
+   * Estimates the memory used by the data this command keeps for undo or redo. The
+   * default implementation returns the size of this class.
+   */
+  virtual size_t doEstimateMemoryUsage() const;
+
   void setModificationCount(MapDocumentCommandFacade* document);
   void resetModificationCount(MapDocumentCommandFacade* document);
 
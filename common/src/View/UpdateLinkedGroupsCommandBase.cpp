@@ -107,5 +107,11 @@ bool UpdateLinkedGroupsCommandBase::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UpdateLinkedGroupsCommandBase::doEstimateMemoryUsage() const
+{
+  return UndoableCommand::doEstimateMemoryUsage()
+         + m_updateLinkedGroupsHelper.estimateMemoryUsage();
+}
+
 } // namespace View
 } // namespace TrenchBroom
@@ -51,6 +51,9 @@ public:
 
   bool collateWith(UndoableCommand& command) override;
 
+protected:
+  size_t doEstimateMemoryUsage() const override;
+
 private:
   deleteCopyAndMove(UpdateLinkedGroupsCommandBase);
 };
@@ -32,6 +32,8 @@
 #include "kdl/result_fold.h"
 #include "kdl/vector_utils.h"
 
+#include "vm/bbox.h"
+
 #include <algorithm>
 #include <cassert>
 #include <map>
@@ -71,12 +73,12 @@ Result<void> UpdateLinkedGroupsHelper::applyLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
   return computeLinkedGroupUpdates(document).transform(
-    [&]() { doApplyOrUndoLinkedGroupUpdates(document); });
+    [&]() { doApplyLinkedGroupUpdates(document); });
 }
 
 void UpdateLinkedGroupsHelper::undoLinkedGroupUpdates(MapDocumentCommandFacade& document)
 {
-  doApplyOrUndoLinkedGroupUpdates(document);
+  doUndoLinkedGroupUpdates(document);
 }
 
 void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
@@ -93,9 +95,27 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
   // is not an update for a linked group node that was updated by this helper, then we
   // will add p_o to our updates and remove it from the other helper's updates to prevent
   // the replaced node to be deleted with the other helper.
+  //
+  // Swapped contents are handled in the same way: we keep our own original contents of a
+  // node and take over the other helper's original contents of nodes that we did not
+  // swap. Nodes swapped by the other helper within a group whose children we replaced
+  // are discarded since undoing our replacement restores their group's original
+  // children anyway.
+
+  auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state).childrenToReplace;
+  auto& theirLinkedGroupUpdates =
+    std::get<LinkedGroupUpdates>(other.m_state).childrenToReplace;
+
+  const auto collectNodes = [](const auto& updates) {
+    auto result = std::unordered_set<Model::Node*>{};
+    for (const auto& [node, _] : updates)
+    {
+      result.insert(node);
+    }
+    return result;
+  };
 
-  auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state);
-  auto& theirLinkedGroupUpdates = std::get<LinkedGroupUpdates>(other.m_state);
+  const auto myReplacedGroupNodes = collectNodes(myLinkedGroupUpdates);
 
   for (auto& [theirGroupNodeToUpdate, theirOldChildren] : theirLinkedGroupUpdates)
   {
@@ -111,6 +131,49 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
         theirGroupNodeToUpdate, std::move(theirOldChildren));
     }
   }
+
+  auto& mySwappedContents = std::get<LinkedGroupUpdates>(m_state).contentsToSwap;
+  auto& theirSwappedContents =
+    std::get<LinkedGroupUpdates>(other.m_state).contentsToSwap;
+
+  const auto mySwappedNodes = collectNodes(mySwappedContents);
+
+  const auto isInReplacedGroup = [&](const Model::Node* node) {
+    for (const auto* ancestor = node->parent(); ancestor; ancestor = ancestor->parent())
+    {
+      if (myReplacedGroupNodes.count(const_cast<Model::Node*>(ancestor)) > 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (auto& [theirSwappedNode, theirOldContents] : theirSwappedContents)
+  {
+    if (
+      mySwappedNodes.count(theirSwappedNode) == 0 && !isInReplacedGroup(theirSwappedNode))
+    {
+      mySwappedContents.emplace_back(theirSwappedNode, std::move(theirOldContents));
+    }
+  }
+}
+
+size_t UpdateLinkedGroupsHelper::estimateMemoryUsage() const
+{
+  return std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups&) { return size_t(0); },
+      [](const LinkedGroupUpdates& linkedGroupUpdates) {
+        auto result = size_t(0);
+        for (const auto& update : linkedGroupUpdates.childrenToReplace)
+        {
+          result += Model::estimateMemoryUsage(kdl::vec_transform(
+            update.second, [](const auto& child) { return child.get(); }));
+        }
+        return result;
+      }),
+    m_state);
 }
 
 Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
@@ -128,6 +191,59 @@ Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
     m_state);
 }
 
+namespace
+{
+
+Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> computeLinkSetUpdates(
+  const Model::GroupNode& groupNode,
+  const std::vector<Model::GroupNode*>& groupNodesToUpdate,
+  const vm::bbox3& worldBounds)
+{
+  if (!groupNode.canUpdateLinkedGroupsIncrementally())
+  {
+    return Model::updateLinkedGroups(groupNode, groupNodesToUpdate, worldBounds)
+      .transform([](auto childrenToReplace) {
+        return UpdateLinkedGroupsHelper::LinkedGroupUpdates{
+          std::move(childrenToReplace), {}};
+      });
+  }
+
+  return Model::updateLinkedGroupsIncrementally(
+           groupNode, groupNodesToUpdate, worldBounds)
+    .and_then([&](auto incrementalResult) {
+      return Model::updateLinkedGroups(
+               groupNode, incrementalResult.groupsToUpdateFully, worldBounds)
+        .transform([&](auto childrenToReplace) {
+          return UpdateLinkedGroupsHelper::LinkedGroupUpdates{
+            std::move(childrenToReplace), std::move(incrementalResult.nodesToSwap)};
+        });
+    });
+}
+
+/**
+ * Removes all but the last contents for each node so that the swaps can be undone.
+ */
+std::vector<std::pair<Model::Node*, Model::NodeContents>> removeDuplicateSwaps(
+  std::vector<std::pair<Model::Node*, Model::NodeContents>> contentsToSwap)
+{
+  auto result = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+  result.reserve(contentsToSwap.size());
+
+  auto visited = std::unordered_set<Model::Node*>{};
+  for (auto it = contentsToSwap.rbegin(); it != contentsToSwap.rend(); ++it)
+  {
+    if (visited.insert(it->first).second)
+    {
+      result.push_back(std::move(*it));
+    }
+  }
+
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
 Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
   computeLinkedGroupUpdates(
     const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document)
@@ -146,22 +262,65 @@ Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
                  Model::collectGroupsWithLinkId({document.world()}, groupNode->linkId()),
                  groupNode);
 
-               return Model::updateLinkedGroups(
-                 *groupNode, groupNodesToUpdate, worldBounds);
+               return computeLinkSetUpdates(*groupNode, groupNodesToUpdate, worldBounds);
              }))
-    .and_then([&](auto nestedUpdateLists) -> Result<LinkedGroupUpdates> {
-      return kdl::vec_flatten(std::move(nestedUpdateLists));
+    .transform([&](auto updateLists) {
+      auto result = LinkedGroupUpdates{};
+      for (auto& updates : updateLists)
+      {
+        result.childrenToReplace = kdl::vec_concat(
+          std::move(result.childrenToReplace), std::move(updates.childrenToReplace));
+        result.contentsToSwap = kdl::vec_concat(
+          std::move(result.contentsToSwap), std::move(updates.contentsToSwap));
+      }
+      result.contentsToSwap = removeDuplicateSwaps(std::move(result.contentsToSwap));
+
+      // the link sets of the changed groups are in sync once the updates are applied
+      for (auto* groupNode : changedLinkedGroups)
+      {
+        groupNode->resetChangeTracking();
+      }
+
+      return result;
     });
 }
 
-void UpdateLinkedGroupsHelper::doApplyOrUndoLinkedGroupUpdates(
+void UpdateLinkedGroupsHelper::doApplyLinkedGroupUpdates(
+  MapDocumentCommandFacade& document)
+{
+  std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups&) {},
+      [&](LinkedGroupUpdates&& linkedGroupUpdates) {
+        // swap first because swapped nodes may be contained in groups whose children are
+        // replaced
+        if (!linkedGroupUpdates.contentsToSwap.empty())
+        {
+          document.performSwapNodeContents(linkedGroupUpdates.contentsToSwap);
+        }
+        m_state = LinkedGroupUpdates{
+          document.performReplaceChildren(
+            std::move(linkedGroupUpdates.childrenToReplace)),
+          std::move(linkedGroupUpdates.contentsToSwap)};
+      }),
+    std::move(m_state));
+}
+
+void UpdateLinkedGroupsHelper::doUndoLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
   std::visit(
     kdl::overload(
       [](const ChangedLinkedGroups&) {},
       [&](LinkedGroupUpdates&& linkedGroupUpdates) {
-        m_state = document.performReplaceChildren(std::move(linkedGroupUpdates));
+        auto childrenToReplace = document.performReplaceChildren(
+          std::move(linkedGroupUpdates.childrenToReplace));
+        if (!linkedGroupUpdates.contentsToSwap.empty())
+        {
+          document.performSwapNodeContents(linkedGroupUpdates.contentsToSwap);
+        }
+        m_state = LinkedGroupUpdates{
+          std::move(childrenToReplace), std::move(linkedGroupUpdates.contentsToSwap)};
       }),
     std::move(m_state));
 }
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Model/NodeContents.h"
 #include "Result.h"
 
 #include <memory>
@@ -49,17 +50,25 @@ bool checkLinkedGroupsToUpdate(const std::vector<Model::GroupNode*>& changedLink
  *
  * The class is initialized with a vector of group nodes whose changes should be
  * propagated to the members of their respective link sets. When applyLinkedGroupUpdates
- * is first called, a replacement node is created for each linked group that needs to be
- * updated, and these linked groups are replaced with their replacements. Calling
- * applyLinkedGroupUpdates replaces the replacement nodes with their original
- * corresponding groups again, effectively undoing the change.
+ * is first called, the updates are computed and applied. If only the contents of some
+ * descendants of a changed group were modified, then only the contents of the
+ * corresponding nodes in the linked groups are swapped. Otherwise, new children are
+ * created for each linked group that needs to be updated, and the children of these
+ * linked groups are replaced with their replacements. Calling undoLinkedGroupUpdates
+ * swaps back the original contents and children, effectively undoing the change.
  */
 class UpdateLinkedGroupsHelper
 {
+public:
+  struct LinkedGroupUpdates
+  {
+    std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>
+      childrenToReplace;
+    std::vector<std::pair<Model::Node*, Model::NodeContents>> contentsToSwap;
+  };
+
 private:
   using ChangedLinkedGroups = std::vector<Model::GroupNode*>;
-  using LinkedGroupUpdates =
-    std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>;
   std::variant<ChangedLinkedGroups, LinkedGroupUpdates> m_state;
 
 public:
@@ -70,11 +79,17 @@ public:
   void undoLinkedGroupUpdates(MapDocumentCommandFacade& document);
   void collateWith(UpdateLinkedGroupsHelper& other);
 
+  /**
+   * Returns an estimate of the memory used by the group children kept for undo or redo.
+   */
+  size_t estimateMemoryUsage() const;
+
 private:
   Result<void> computeLinkedGroupUpdates(MapDocumentCommandFacade& document);
   static Result<LinkedGroupUpdates> computeLinkedGroupUpdates(
     const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document);
 
-  void doApplyOrUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doApplyLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
 };
 } // namespace TrenchBroom::View
@@ -25,6 +25,7 @@
 #include "Preferences.h"
 #include "View/Grid.h"
 
+#include "vm/bbox.h"
 #include "vm/distance.h"
 #include "vm/intersection.h"
 #include "vm/plane.h"
@@ -45,17 +46,16 @@ void VertexHandleManager::pick(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
-    const auto distance = camera.pickPointHandle(
-      pickRay, position, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
+    const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
     if (!vm::is_nan(distance))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, distance);
       const auto error = vm::squared_distance(pickRay, position).distance;
       pickResult.addHit(Model::Hit(HandleHitType, distance, hitPoint, position, error));
     }
-  }
+  });
 }
 
 void VertexHandleManager::addHandles(const Model::BrushNode* brushNode)
@@ -81,6 +81,11 @@ Model::HitType::Type VertexHandleManager::hitType() const
   return HandleHitType;
 }
 
+vm::bbox3 VertexHandleManager::handleBounds(const Handle& handle) const
+{
+  return vm::bbox3{handle, handle};
+}
+
 bool VertexHandleManager::isIncident(
   const Handle& handle, const Model::BrushNode* brushNode) const
 {
@@ -96,16 +101,16 @@ void EdgeHandleManager::pickGridHandle(
   const Grid& grid,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
-    const FloatType edgeDist = camera.pickLineSegmentHandle(
-      pickRay, position, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
+    const FloatType edgeDist =
+      camera.pickLineSegmentHandle(pickRay, position, handleRadius);
     if (!vm::is_nan(edgeDist))
     {
       const vm::vec3 pointHandle =
         grid.snap(vm::point_at_distance(pickRay, edgeDist), position);
-      const FloatType pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+      const FloatType pointDist =
+        camera.pickPointHandle(pickRay, pointHandle, handleRadius);
       if (!vm::is_nan(pointDist))
       {
         const vm::vec3 hitPoint = vm::point_at_distance(pickRay, pointDist);
@@ -113,7 +118,7 @@ void EdgeHandleManager::pickGridHandle(
           Model::Hit(HandleHitType, pointDist, hitPoint, HitType(position, pointHandle)));
       }
     }
-  }
+  });
 }
 
 void EdgeHandleManager::pickCenterHandle(
@@ -121,18 +126,18 @@ void EdgeHandleManager::pickCenterHandle(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     const vm::vec3 pointHandle = position.center();
 
-    const FloatType pointDist = camera.pickPointHandle(
-      pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+    const FloatType pointDist =
+      camera.pickPointHandle(pickRay, pointHandle, handleRadius);
     if (!vm::is_nan(pointDist))
     {
       const vm::vec3 hitPoint = vm::point_at_distance(pickRay, pointDist);
       pickResult.addHit(Model::Hit(HandleHitType, pointDist, hitPoint, position));
     }
-  }
+  });
 }
 
 void EdgeHandleManager::addHandles(const Model::BrushNode* brushNode)
@@ -159,6 +164,12 @@ Model::HitType::Type EdgeHandleManager::hitType() const
   return HandleHitType;
 }
 
+vm::bbox3 EdgeHandleManager::handleBounds(const Handle& handle) const
+{
+  return vm::bbox3{
+    vm::min(handle.start(), handle.end()), vm::max(handle.start(), handle.end())};
+}
+
 bool EdgeHandleManager::isIncident(
   const Handle& handle, const Model::BrushNode* brushNode) const
 {
@@ -174,12 +185,13 @@ void FaceHandleManager::pickGridHandle(
   const Grid& grid,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  // the pick ray must intersect a face handle, so it must also intersect its bounds
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     const auto [valid, plane] = vm::from_points(std::begin(position), std::end(position));
     if (!valid)
     {
-      continue;
+      return;
     }
 
     const auto distance =
@@ -188,8 +200,7 @@ void FaceHandleManager::pickGridHandle(
     {
       const auto pointHandle = grid.snap(vm::point_at_distance(pickRay, distance), plane);
 
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+      const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
       if (!vm::is_nan(pointDist))
       {
         const auto hitPoint = vm::point_at_distance(pickRay, pointDist);
@@ -197,7 +208,7 @@ void FaceHandleManager::pickGridHandle(
           Model::Hit(HandleHitType, pointDist, hitPoint, HitType(position, pointHandle)));
       }
     }
-  }
+  });
 }
 
 void FaceHandleManager::pickCenterHandle(
@@ -205,18 +216,17 @@ void FaceHandleManager::pickCenterHandle(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     const auto pointHandle = position.center();
 
-    const auto pointDist = camera.pickPointHandle(
-      pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+    const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
     if (!vm::is_nan(pointDist))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, pointDist);
       pickResult.addHit(Model::Hit(HandleHitType, pointDist, hitPoint, position));
     }
-  }
+  });
 }
 
 void FaceHandleManager::addHandles(const Model::BrushNode* brushNode)
@@ -242,6 +252,11 @@ Model::HitType::Type FaceHandleManager::hitType() const
   return HandleHitType;
 }
 
+vm::bbox3 FaceHandleManager::handleBounds(const Handle& handle) const
+{
+  return vm::bbox3::merge_all(std::begin(handle), std::end(handle));
+}
+
 bool FaceHandleManager::isIncident(
   const Handle& handle, const Model::BrushNode* brushNode) const
 {
@@ -25,11 +25,16 @@
 #include "Model/HitType.h"
 #include "Model/PickResult.h"
 #include "Renderer/Camera.h"
+#include "octree.h"
 
 #include "kdl/vector_set.h"
 
+#include "vm/bbox.h"
+#include "vm/intersection.h"
 #include "vm/segment.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <map>
 #include <vector>
@@ -172,12 +177,20 @@ protected:
 
   using HandleMap = std::map<H, HandleInfo>;
   using HandleEntry = typename HandleMap::value_type;
+  using HandleTree = octree<FloatType, HandleEntry*>;
 
   /**
    * Maps a handle position to its info.
    */
   HandleMap m_handles;
 
+  /**
+   * Indexes the entries of m_handles by the bounds of their handles, so that picking and
+   * finding handles at the same position does not have to test every handle. The entries
+   * of a std::map are stable, so the tree can refer to them directly.
+   */
+  HandleTree m_handleTree;
+
   /**
    * The total number of selected handles, not counting duplicates.
    */
@@ -185,7 +198,8 @@ protected:
 
 public:
   VertexHandleManagerBaseT()
-    : m_selectedHandleCount(0)
+    : m_handleTree(64.0)
+    , m_selectedHandleCount(0)
   {
   }
 
@@ -324,8 +338,15 @@ public:
    */
   void add(const Handle& handle)
   {
-    m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo
-                             // means its default constructor is called
+    // unknown value gets value constructed, which for HandleInfo means its default
+    // constructor is called
+    auto [it, inserted] = m_handles.try_emplace(handle);
+    it->second.inc();
+
+    if (inserted)
+    {
+      m_handleTree.insert(handleBounds(handle), &*it);
+    }
   }
 
   /**
@@ -346,6 +367,7 @@ public:
       if (info.count == 0)
       {
         deselect(info);
+        m_handleTree.remove(&*it);
         m_handles.erase(it);
       }
       return true;
@@ -359,6 +381,7 @@ public:
    */
   void clear()
   {
+    m_handleTree.clear();
     m_handles.clear();
     m_selectedHandleCount = 0;
   }
@@ -466,11 +489,15 @@ private:
   void forEachCloseHandle(const H& otherHandle, F fun)
   {
     static const auto epsilon = 0.001 * 0.001;
-    for (auto& [handle, info] : m_handles)
+
+    auto candidates = std::vector<HandleEntry*>{};
+    m_handleTree.find_intersectors(
+      handleBounds(otherHandle).expand(epsilon), std::back_inserter(candidates));
+    for (auto* entry : candidates)
     {
-      if (compare(otherHandle, handle, epsilon) == 0)
+      if (compare(otherHandle, entry->first, epsilon) == 0)
       {
-        fun(info);
+        fun(entry->second);
       }
     }
   }
@@ -530,6 +557,51 @@ public:
     }
   }
 
+protected:
+  /**
+   * Calls the given function for every handle that the given pick ray may hit, i.e., for
+   * every handle whose bounds come closer to the pick ray than the pick radius of the
+   * handles. This is a superset of the handles hit by Camera::pickPointHandle with the
+   * given handle radius for any point within the bounds of a handle.
+   *
+   * @tparam F the type of the function to call, which must accept a handle
+   * @param pickRay the picking ray
+   * @param camera the camera
+   * @param handleRadius the handle radius
+   * @param fun the function to call
+   */
+  template <typename F>
+  void forEachPickableHandle(
+    const vm::ray3& pickRay,
+    const Renderer::Camera& camera,
+    const FloatType handleRadius,
+    const F& fun) const
+  {
+    auto candidates = std::vector<HandleEntry*>{};
+    m_handleTree.find_if(
+      [&](const vm::bbox3& bounds) {
+        // the pick radius grows linearly with the distance to the camera, so its maximum
+        // within the bounds is attained at one of their corners
+        auto maxScaling = FloatType(0);
+        bounds.for_each_vertex([&](const vm::vec3& corner) {
+          maxScaling = std::max(
+            maxScaling,
+            static_cast<FloatType>(
+              std::abs(camera.perspectiveScalingFactor(vm::vec3f{corner}))));
+        });
+
+        const auto pickBounds = bounds.expand(FloatType(2) * handleRadius * maxScaling);
+        return pickBounds.contains(pickRay.origin)
+               || !vm::is_nan(vm::intersect_ray_bbox(pickRay, pickBounds));
+      },
+      std::back_inserter(candidates));
+
+    for (const auto* entry : candidates)
+    {
+      fun(entry->first);
+    }
+  }
+
 public:
   /**
    * Finds and returns all brushes in the given range which are incident to the given
@@ -566,12 +638,16 @@ public:
   std::vector<Model::BrushNode*> findIncidentBrushes(
     I1 hBegin, I1 hEnd, I2 bBegin, I2 bEnd) const
   {
-    kdl::vector_set<Model::BrushNode*> result;
-    auto out = std::inserter(result, std::end(result));
+    // collect first so that the brushes are inserted into the set in one pass
+    auto brushes = std::vector<Model::BrushNode*>{};
+    auto out = std::back_inserter(brushes);
     for (auto hCur = hBegin; hCur != hEnd; ++hCur)
     {
       findIncidentBrushes(*hCur, bBegin, bEnd, out);
     }
+
+    kdl::vector_set<Model::BrushNode*> result;
+    result.insert(std::begin(brushes), std::end(brushes));
     return result.release_data();
   }
 
@@ -598,6 +674,14 @@ public:
   }
 
 private:
+  /**
+   * Returns the bounding box of the given handle.
+   *
+   * @param handle the handle
+   * @return the bounding box of the given handle
+   */
+  virtual vm::bbox3 handleBounds(const Handle& handle) const = 0;
+
   /**
    * Checks whether the given brush is incident to the given handle.
    *
@@ -642,6 +726,7 @@ public:
   Model::HitType::Type hitType() const override;
 
 private:
+  vm::bbox3 handleBounds(const Handle& handle) const override;
   bool isIncident(const Handle& handle, const Model::BrushNode* brushNode) const override;
 };
 
@@ -700,6 +785,7 @@ public:
   Model::HitType::Type hitType() const override;
 
 private:
+  vm::bbox3 handleBounds(const Handle& handle) const override;
   bool isIncident(const Handle& handle, const Model::BrushNode* brushNode) const override;
 };
 
@@ -758,6 +844,7 @@ public:
   Model::HitType::Type hitType() const override;
 
 private:
+  vm::bbox3 handleBounds(const Handle& handle) const override;
   bool isIncident(const Handle& handle, const Model::BrushNode* brushNode) const override;
 };
 } // namespace View
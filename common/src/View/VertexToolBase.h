@@ -152,8 +152,9 @@ public:
   std::vector<Model::BrushNode*> findIncidentBrushes(const M& manager, I cur, I end) const
   {
     const std::vector<Model::BrushNode*>& brushes = selectedBrushes();
-    kdl::vector_set<Model::BrushNode*> result;
-    auto out = std::inserter(result, std::end(result));
+    // collect first so that the brushes are inserted into the set in one pass
+    auto incidentBrushes = std::vector<Model::BrushNode*>{};
+    auto out = std::back_inserter(incidentBrushes);
 
     while (cur != end)
     {
@@ -162,6 +163,8 @@ public:
       ++cur;
     }
 
+    kdl::vector_set<Model::BrushNode*> result;
+    result.insert(std::begin(incidentBrushes), std::end(incidentBrushes));
     return result.release_data();
   }
 
@@ -23,6 +23,7 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QLabel>
+#include <QSpinBox>
 #include <QtGlobal>
 
 #include "PreferenceManager.h"
@@ -158,6 +159,15 @@ QWidget* ViewPreferencePane::createViewPreferences()
     m_textureModeCombo->addItem(QString::fromStdString(textureMode.name));
   }
 
+  m_compressTextures = new QCheckBox{};
+  m_compressTextures->setToolTip(
+    "Compress textures when loading them to reduce the video memory they use.");
+
+  m_loadTexturesOnDemand = new QCheckBox{};
+  m_loadTexturesOnDemand->setToolTip(
+    "Only load textures from wad files once they are used by the map or shown in the "
+    "texture browser.");
+
   m_enableMsaa = new QCheckBox{};
   m_enableMsaa->setToolTip("Enable multisampling");
 
@@ -180,6 +190,14 @@ QWidget* ViewPreferencePane::createViewPreferences()
                                      "28", "32", "36", "40", "48", "56", "64", "72"});
   m_rendererFontSizeCombo->setValidator(new QIntValidator{1, 96});
 
+  m_autosaveDeltaCountSpinBox = new QSpinBox{};
+  m_autosaveDeltaCountSpinBox->setRange(0, 100);
+  m_autosaveDeltaCountSpinBox->setToolTip(
+    "The number of delta autosaves to write after each full autosave. A delta autosave "
+    "only stores what changed since the last full autosave and can be restored with "
+    "File > Restore Autosave. If this is zero, every autosave is a full autosave. "
+    "Takes effect for maps opened afterwards.");
+
   auto* layout = new FormWithSectionsLayout{};
   layout->setContentsMargins(0, LayoutConstants::MediumVMargin, 0, 0);
   layout->setVerticalSpacing(2);
@@ -196,6 +214,8 @@ QWidget* ViewPreferencePane::createViewPreferences()
   layout->addRow("FOV", m_fovSlider);
   layout->addRow("Show axes", m_showAxes);
   layout->addRow("Texture mode", m_textureModeCombo);
+  layout->addRow("Compress textures", m_compressTextures);
+  layout->addRow("Load textures on demand", m_loadTexturesOnDemand);
   layout->addRow("Enable multisampling", m_enableMsaa);
 
   layout->addSection("Texture Browser");
@@ -204,6 +224,9 @@ QWidget* ViewPreferencePane::createViewPreferences()
   layout->addSection("Fonts");
   layout->addRow("Renderer Font Size", m_rendererFontSizeCombo);
 
+  layout->addSection("Autosave");
+  layout->addRow("Delta autosaves", m_autosaveDeltaCountSpinBox);
+
   viewBox->setMinimumWidth(400);
   viewBox->setLayout(layout);
 
@@ -238,6 +261,16 @@ void ViewPreferencePane::bindEvents()
     m_showAxes, &QCheckBox::stateChanged, this, &ViewPreferencePane::showAxesChanged);
   connect(
     m_enableMsaa, &QCheckBox::stateChanged, this, &ViewPreferencePane::enableMsaaChanged);
+  connect(
+    m_compressTextures,
+    &QCheckBox::stateChanged,
+    this,
+    &ViewPreferencePane::compressTexturesChanged);
+  connect(
+    m_loadTexturesOnDemand,
+    &QCheckBox::stateChanged,
+    this,
+    &ViewPreferencePane::loadTexturesOnDemandChanged);
   connect(
     m_themeCombo,
     QOverload<int>::of(&QComboBox::activated),
@@ -258,6 +291,11 @@ void ViewPreferencePane::bindEvents()
     &QComboBox::currentTextChanged,
     this,
     &ViewPreferencePane::rendererFontSizeChanged);
+  connect(
+    m_autosaveDeltaCountSpinBox,
+    QOverload<int>::of(&QSpinBox::valueChanged),
+    this,
+    &ViewPreferencePane::autosaveDeltaCountChanged);
 }
 
 bool ViewPreferencePane::doCanResetToDefaults()
@@ -277,9 +315,12 @@ void ViewPreferencePane::doResetToDefaults()
   prefs.resetToDefault(Preferences::EnableMSAA);
   prefs.resetToDefault(Preferences::TextureMinFilter);
   prefs.resetToDefault(Preferences::TextureMagFilter);
+  prefs.resetToDefault(Preferences::CompressTextures);
+  prefs.resetToDefault(Preferences::LoadTexturesOnDemand);
   prefs.resetToDefault(Preferences::Theme);
   prefs.resetToDefault(Preferences::TextureBrowserIconSize);
   prefs.resetToDefault(Preferences::RendererFontSize);
+  prefs.resetToDefault(Preferences::AutosaveDeltaCount);
 }
 
 void ViewPreferencePane::doUpdateControls()
@@ -293,10 +334,13 @@ void ViewPreferencePane::doUpdateControls()
   const auto textureModeIndex = findTextureMode(
     pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
   m_textureModeCombo->setCurrentIndex(int(textureModeIndex));
+  m_compressTextures->setChecked(pref(Preferences::CompressTextures));
+  m_loadTexturesOnDemand->setChecked(pref(Preferences::LoadTexturesOnDemand));
 
   m_showAxes->setChecked(pref(Preferences::ShowAxes));
   m_enableMsaa->setChecked(pref(Preferences::EnableMSAA));
   m_themeCombo->setCurrentIndex(findThemeIndex(pref(Preferences::Theme)));
+  m_autosaveDeltaCountSpinBox->setValue(pref(Preferences::AutosaveDeltaCount));
 
   const auto textureBrowserIconSize = pref(Preferences::TextureBrowserIconSize);
   if (textureBrowserIconSize == 0.25f)
@@ -409,6 +453,20 @@ void ViewPreferencePane::enableMsaaChanged(const int state)
   prefs.set(Preferences::EnableMSAA, value);
 }
 
+void ViewPreferencePane::compressTexturesChanged(const int state)
+{
+  const auto value = state == Qt::Checked;
+  auto& prefs = PreferenceManager::instance();
+  prefs.set(Preferences::CompressTextures, value);
+}
+
+void ViewPreferencePane::loadTexturesOnDemandChanged(const int state)
+{
+  const auto value = state == Qt::Checked;
+  auto& prefs = PreferenceManager::instance();
+  prefs.set(Preferences::LoadTexturesOnDemand, value);
+}
+
 void ViewPreferencePane::textureModeChanged(const int value)
 {
   const auto index = static_cast<size_t>(value);
@@ -467,4 +525,10 @@ void ViewPreferencePane::rendererFontSizeChanged(const QString& str)
     prefs.set(Preferences::RendererFontSize, value);
   }
 }
+
+void ViewPreferencePane::autosaveDeltaCountChanged(const int value)
+{
+  auto& prefs = PreferenceManager::instance();
+  prefs.set(Preferences::AutosaveDeltaCount, value);
+}
 } // namespace TrenchBroom::View
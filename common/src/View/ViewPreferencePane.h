@@ -23,6 +23,7 @@
 
 class QCheckBox;
 class QComboBox;
+class QSpinBox;
 
 namespace TrenchBroom::View
 {
@@ -39,10 +40,13 @@ private:
   SliderWithLabel* m_fovSlider = nullptr;
   QCheckBox* m_showAxes = nullptr;
   QComboBox* m_textureModeCombo = nullptr;
+  QCheckBox* m_compressTextures = nullptr;
+  QCheckBox* m_loadTexturesOnDemand = nullptr;
   QCheckBox* m_enableMsaa = nullptr;
   QComboBox* m_themeCombo = nullptr;
   QComboBox* m_textureBrowserIconSizeCombo = nullptr;
   QComboBox* m_rendererFontSizeCombo = nullptr;
+  QSpinBox* m_autosaveDeltaCountSpinBox = nullptr;
 
 public:
   explicit ViewPreferencePane(QWidget* parent = nullptr);
@@ -68,9 +72,12 @@ private slots:
   void fovChanged(int value);
   void showAxesChanged(int state);
   void enableMsaaChanged(int state);
+  void compressTexturesChanged(int state);
+  void loadTexturesOnDemandChanged(int state);
   void textureModeChanged(int index);
   void themeChanged(int index);
   void textureBrowserIconSizeChanged(int index);
   void rendererFontSizeChanged(const QString& text);
+  void autosaveDeltaCountChanged(int value);
 };
 } // namespace TrenchBroom::View
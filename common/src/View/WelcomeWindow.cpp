@@ -140,7 +140,7 @@ void WelcomeWindow::openOtherDocument()
     nullptr,
     tr("Open Map"),
     fileDialogDefaultDirectory(FileDialogDir::Map),
-    "Map files (*.map);;Any files (*.*)");
+    "Map files (*.map *.map.gz);;Any files (*.*)");
   const auto path = IO::pathFromQString(pathStr);
 
   if (!path.empty())
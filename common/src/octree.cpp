@@ -86,14 +86,24 @@ std::optional<size_t> get_quadrant(const node_address& outer, const node_address
   }
 
   const auto half = outer.max() / 2 + outer.min() / 2;
-  const auto sum_of_signs = vm::sign(inner.min() - half) + vm::sign(inner.max() - half);
-  if (sum_of_signs.x() == 0 || sum_of_signs.y() == 0 || sum_of_signs.z() == 0)
+  const auto inner_min = inner.min();
+  const auto inner_max = inner.max();
+
+  auto quadrant = size_t(0);
+  for (size_t i = 0; i < 3; ++i)
   {
-    return std::nullopt;
+    if (inner_min[i] < half[i] && inner_max[i] > half[i])
+    {
+      // inner straddles the center of outer
+      return std::nullopt;
+    }
+    if (inner_max[i] > half[i])
+    {
+      quadrant |= size_t(1) << i;
+    }
   }
 
-  return (inner.max().x() <= half.x() ? 0 : 1) | (inner.max().y() <= half.y() ? 0 : 2)
-         | (inner.max().z() <= half.z() ? 0 : 4);
+  return quadrant;
 }
 
 node_address get_child(const node_address& a, const size_t quadrant)
@@ -25,6 +25,7 @@
 #include "kdl/overload.h"
 #include "kdl/reflection_decl.h"
 #include "kdl/reflection_impl.h"
+#include "kdl/struct_io.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/bbox.h"
@@ -34,11 +35,15 @@
 #include "vm/scalar.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <iterator>
 #include <optional>
 #include <ostream>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -192,212 +197,387 @@ public:
   };
 
 private:
-  static detail::node_address& get_address(node& node)
+  /**
+   * The nodes of this tree are stored in a single flat vector and refer to their children
+   * by index. The eight children of an inner node are stored consecutively.
+   */
+  struct flat_node
   {
-    return std::visit([](auto& x) -> detail::node_address& { return x.address; }, node);
-  }
+    detail::node_address address;
 
-  static const detail::node_address& get_address(const node& node_)
-  {
-    return const_cast<const detail::node_address&>(get_address(const_cast<node&>(node_)));
-  }
+    // the index of the first child in m_nodes, or 0 if this is a leaf node
+    uint32_t children;
+
+    std::vector<U> data;
+  };
+
+  // the root node is at index 0 if this tree is not empty
+  std::vector<flat_node> m_nodes;
+
+  // the indices of unused blocks of eight nodes in m_nodes
+  std::vector<uint32_t> m_free_blocks;
+
+  T m_min_size;
+  std::unordered_map<U, detail::node_address> m_node_address_for_data;
 
-  static std::vector<U>& get_data(node& node)
+  bool is_leaf_node(const uint32_t index) const { return m_nodes[index].children == 0; }
+
+  bool is_non_empty_node(const uint32_t index) const
   {
-    return std::visit([](auto& x) -> std::vector<U>& { return x.data; }, node);
+    return !is_leaf_node(index) || !m_nodes[index].data.empty();
   }
 
-  static const std::vector<U>& get_data(const node& node_)
+  /**
+   * Returns the index of a block of eight empty leaf nodes for the quadrants of the
+   * given address. Note that this may invalidate any references into m_nodes, so the
+   * address is taken by value.
+   */
+  uint32_t allocate_children(const detail::node_address address)
   {
-    return const_cast<const std::vector<U>&>(get_data(const_cast<node&>(node_)));
+    if (!m_free_blocks.empty())
+    {
+      const auto children = m_free_blocks.back();
+      m_free_blocks.pop_back();
+
+      for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
+      {
+        auto& child = m_nodes[children + quadrant];
+        child.address = get_child(address, quadrant);
+        child.children = 0;
+        child.data.clear();
+      }
+      return children;
+    }
+
+    const auto children = uint32_t(m_nodes.size());
+    for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
+    {
+      m_nodes.push_back(flat_node{get_child(address, quadrant), 0, {}});
+    }
+    return children;
   }
 
-  static bool is_inner_node(const node& node)
+  void free_children(const uint32_t children)
   {
-    return std::visit(
-      kdl::overload(
-        [](const inner_node&) { return true; }, [](const leaf_node&) { return false; }),
-      node);
+    for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
+    {
+      auto& child = m_nodes[children + quadrant];
+      child.children = 0;
+      child.data.clear();
+    }
+    m_free_blocks.push_back(children);
   }
 
-  static bool is_leaf_node(const node& node) { return !is_inner_node(node); }
-
-  static bool is_empty(const node& node)
+  void update_root_address(const detail::node_address& address)
   {
-    return std::visit(
-      kdl::overload(
-        [](const inner_node& i) {
-          return i.data.empty()
-                 && std::all_of(
-                   i.children.begin(), i.children.end(), [](const auto& child) {
-                     return is_leaf_node(child) && is_empty(child);
-                   });
-        },
-        [](const leaf_node& l) { return l.data.empty(); }),
-      node);
+    assert(is_root(address));
+    assert(address.contains(m_nodes[0].address));
+    m_nodes[0].address = address;
+
+    for (const auto& d : m_nodes[0].data)
+    {
+      m_node_address_for_data.insert_or_assign(d, address);
+    }
   }
 
-  template <typename Predicate, typename Visitor>
-  static void visit_node_if(
-    const node& node, const Visitor& visitor, const Predicate& predicate)
+  void insert_into_node(uint32_t index, const detail::node_address& address, U data)
   {
-    if (predicate(node))
+    while (true)
     {
-      visitor(node);
-      std::visit(
-        kdl::overload(
-          [&](const inner_node& inner_node) {
-            for (const auto& child : inner_node.children)
-            {
-              visit_node_if(child, visitor, predicate);
-            }
-          },
-          [&](const leaf_node&) {}),
-        node);
+      if (!m_nodes[index].address.contains(address))
+      {
+        const auto container_address = get_container(m_nodes[index].address, address);
+        const auto container_quadrant =
+          get_quadrant(container_address, m_nodes[index].address);
+        assert(container_quadrant.has_value());
+
+        const auto children = allocate_children(container_address);
+        m_nodes[children + uint32_t(*container_quadrant)] = std::move(m_nodes[index]);
+        m_nodes[index] = flat_node{container_address, children, {}};
+      }
+
+      assert(m_nodes[index].address.contains(address));
+      const auto quadrant = get_quadrant(m_nodes[index].address, address);
+      if (!quadrant)
+      {
+        m_nodes[index].data.push_back(std::move(data));
+        return;
+      }
+
+      if (is_leaf_node(index))
+      {
+        if (m_nodes[index].data.empty())
+        {
+          m_nodes[index].address = address;
+          m_nodes[index].data.push_back(std::move(data));
+          return;
+        }
+
+        // turn the leaf into an inner node and insert again
+        const auto children = allocate_children(m_nodes[index].address);
+        m_nodes[index].children = children;
+      }
+      else
+      {
+        index = m_nodes[index].children + uint32_t(*quadrant);
+      }
     }
   }
 
-  static void update_root_address(
-    node& root,
-    const detail::node_address& address,
-    std::unordered_map<U, detail::node_address>& node_address_for_data)
+  void remove_from_node(
+    const uint32_t index, const detail::node_address& address, const U& data)
   {
-    assert(is_root(address));
-    assert(address.contains(get_address(root)));
-    get_address(root) = address;
+    auto& node_ = m_nodes[index];
+    if (!is_leaf_node(index))
+    {
+      if (const auto quadrant = get_quadrant(node_.address, address))
+      {
+        remove_from_node(node_.children + uint32_t(*quadrant), address, data);
+      }
+      else
+      {
+        const auto i_data = std::find(node_.data.begin(), node_.data.end(), data);
+        assert(i_data != node_.data.end());
+        node_.data.erase(i_data);
+      }
+
+      if (!is_root(node_.address))
+      {
+        auto num_non_empty_children = 0u;
+        auto non_empty_child = uint32_t(0);
+        for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
+        {
+          if (is_non_empty_node(node_.children + quadrant))
+          {
+            ++num_non_empty_children;
+            non_empty_child = node_.children + quadrant;
+          }
+        }
 
-    for (const auto& d : get_data(root))
+        if (num_non_empty_children == 0)
+        {
+          free_children(node_.children);
+          node_.children = 0;
+        }
+        else if (num_non_empty_children == 1 && node_.data.empty())
+        {
+          const auto children = node_.children;
+          node_ = std::move(m_nodes[non_empty_child]);
+          free_children(children);
+        }
+      }
+    }
+    else
     {
-      node_address_for_data.insert_or_assign(d, address);
+      const auto i_data = std::find(node_.data.begin(), node_.data.end(), data);
+      assert(i_data != node_.data.end());
+      node_.data.erase(i_data);
     }
   }
 
-  static void insert_into_node(node& node, const detail::node_address& address, U data)
+  using build_entry = std::pair<detail::node_address, U>;
+  using build_iterator = typename std::vector<build_entry>::iterator;
+
+  /**
+   * Scratch buffers that are reused while building the tree to avoid allocations.
+   */
+  struct build_buffers
   {
-    if (!get_address(node).contains(address))
+    std::vector<uint8_t> keys;
+    std::vector<build_entry> sorted;
+  };
+
+  void build_node(
+    const uint32_t index,
+    const build_iterator begin,
+    const build_iterator end,
+    build_buffers& buffers)
+  {
+    assert(begin != end);
+
+    if (std::next(begin) == end)
     {
-      const auto container_address = get_container(get_address(node), address);
-      const auto container_quadrant = get_quadrant(container_address, get_address(node));
-      assert(container_quadrant.has_value());
+      m_nodes[index].address = begin->first;
+      m_nodes[index].data.push_back(std::move(begin->second));
+      return;
+    }
 
-      auto container_node = inner_node{container_address, {}};
-      container_node.children[*container_quadrant] = std::move(node);
-      node = std::move(container_node);
+    auto bounds = vm::bbox<int, 3>{begin->first.min(), begin->first.max()};
+    for (auto it = std::next(begin); it != end; ++it)
+    {
+      bounds = vm::merge(bounds, vm::bbox<int, 3>{it->first.min(), it->first.max()});
     }
 
-    assert(get_address(node).contains(address));
-    if (const auto quadrant = get_quadrant(get_address(node), address))
+    auto address = begin->first;
+    while (!vm::bbox<int, 3>{address.min(), address.max()}.contains(bounds))
     {
-      std::visit(
-        kdl::overload(
-          [&](inner_node& i) {
-            insert_into_node(i.children[*quadrant], address, std::move(data));
-          },
-          [&](leaf_node& l) {
-            if (l.data.empty())
-            {
-              l.address = address;
-              l.data.push_back(std::move(data));
-            }
-            else
-            {
-              node = inner_node{l.address, std::move(l.data)};
-              insert_into_node(node, address, std::move(data));
-            }
-          }),
-        node);
+      address = get_parent(address);
     }
-    else
+
+    build_node(index, address, begin, end, buffers);
+  }
+
+  void build_node(
+    const uint32_t index,
+    const detail::node_address& address,
+    const build_iterator begin,
+    const build_iterator end,
+    build_buffers& buffers)
+  {
+    const auto ranges = sort_by_quadrant(address, begin, end, buffers);
+
+    auto data = std::vector<U>{};
+    data.reserve(size_t(std::distance(ranges[0], ranges[1])));
+    std::transform(ranges[0], ranges[1], std::back_inserter(data), [](auto& entry) {
+      return std::move(entry.second);
+    });
+
+    m_nodes[index].address = address;
+    m_nodes[index].data = std::move(data);
+
+    if (ranges[1] != end)
     {
-      get_data(node).push_back(std::move(data));
+      const auto children = allocate_children(address);
+      m_nodes[index].children = children;
+
+      for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
+      {
+        if (ranges[quadrant + 1] != ranges[quadrant + 2])
+        {
+          build_node(
+            children + quadrant, ranges[quadrant + 1], ranges[quadrant + 2], buffers);
+        }
+      }
     }
   }
 
-  void remove_from_node(node& node, const detail::node_address& address, const U& data)
+  /**
+   * Stably reorders the given entries such that the entries which belong to the node
+   * with the given address come first, followed by the entries of each of its
+   * quadrants. Returns the boundaries of the resulting ranges.
+   */
+  static std::array<build_iterator, 10> sort_by_quadrant(
+    const detail::node_address& address,
+    const build_iterator begin,
+    const build_iterator end,
+    build_buffers& buffers)
+  {
+    auto& keys = buffers.keys;
+    keys.clear();
+    std::transform(begin, end, std::back_inserter(keys), [&](const auto& entry) {
+      const auto quadrant = get_quadrant(address, entry.first);
+      return uint8_t(quadrant ? *quadrant + 1 : 0);
+    });
+
+    auto& sorted = buffers.sorted;
+    sorted.clear();
+
+    auto result = std::array<build_iterator, 10>{};
+    for (uint8_t key = 0; key < 9; ++key)
+    {
+      result[key] = std::next(begin, std::ptrdiff_t(sorted.size()));
+      for (size_t i = 0; i < keys.size(); ++i)
+      {
+        if (keys[i] == key)
+        {
+          sorted.push_back(std::move(*std::next(begin, std::ptrdiff_t(i))));
+        }
+      }
+    }
+    result[9] = end;
+
+    std::move(sorted.begin(), sorted.end(), begin);
+    return result;
+  }
+
+  void set_node(const uint32_t index, node node_)
   {
     std::visit(
       kdl::overload(
-        [&](inner_node& i) {
-          if (const auto quadrant = get_quadrant(i.address, address))
+        [&](leaf_node& l) {
+          for (const auto& data : l.data)
           {
-            remove_from_node(i.children[*quadrant], address, data);
+            m_node_address_for_data.emplace(data, l.address);
           }
-          else
+          m_nodes[index] = flat_node{l.address, 0, std::move(l.data)};
+        },
+        [&](inner_node& i) {
+          assert(i.children.size() == 8);
+          for (const auto& data : i.data)
           {
-            const auto i_data = std::find(i.data.begin(), i.data.end(), data);
-            assert(i_data != i.data.end());
-            i.data.erase(i_data);
+            m_node_address_for_data.emplace(data, i.address);
           }
 
-          if (!is_root(i.address))
+          const auto children = allocate_children(i.address);
+          m_nodes[index] = flat_node{i.address, children, std::move(i.data)};
+          for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
           {
-            const auto is_non_empty_child = [](const auto& c) {
-              return is_inner_node(c) || !get_data(c).empty();
-            };
-            const auto num_non_empty_children =
-              std::count_if(i.children.begin(), i.children.end(), is_non_empty_child);
-            if (num_non_empty_children == 0)
-            {
-              node = leaf_node{i.address, std::move(i.data)};
-            }
-            else if (num_non_empty_children == 1 && i.data.empty())
-            {
-              const auto i_non_empty_child =
-                std::find_if(i.children.begin(), i.children.end(), is_non_empty_child);
-              assert(i_non_empty_child != i.children.end());
-
-              auto child = std::move(*i_non_empty_child);
-              node = std::move(child);
-            }
+            set_node(children + quadrant, std::move(i.children[quadrant]));
           }
-        },
-        [&](leaf_node& l) {
-          const auto i_data = std::find(l.data.begin(), l.data.end(), data);
-          assert(i_data != l.data.end());
-          l.data.erase(i_data);
         }),
-      node);
+      node_);
   }
 
-private:
-  std::optional<node> m_root;
-  T m_min_size;
-  std::unordered_map<U, detail::node_address> m_node_address_for_data;
-
-public:
-  explicit octree(const T min_size)
-    : m_min_size{min_size}
+  node get_node(const uint32_t index) const
   {
+    const auto& node_ = m_nodes[index];
+    if (is_leaf_node(index))
+    {
+      return leaf_node{node_.address, node_.data};
+    }
+
+    auto children = std::vector<node>{};
+    children.reserve(8);
+    for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
+    {
+      children.push_back(get_node(node_.children + quadrant));
+    }
+    return inner_node{node_.address, node_.data, std::move(children)};
   }
 
-  octree(const T min_size, node root)
-    : m_root{std::move(root)}
-    , m_min_size{min_size}
+  template <typename Predicate, typename Visitor>
+  void visit_node_if(
+    const uint32_t index, const Visitor& visitor, const Predicate& predicate) const
   {
-    auto visitor = kdl::overload(
-      [&](auto&& self, const inner_node& node) -> void {
-        for (const auto& data : node.data)
-        {
-          m_node_address_for_data.emplace(data, node.address);
-        }
-        for (const auto& child : node.children)
-        {
-          std::visit([&](const auto& c) { self(self, c); }, child);
-        }
-      },
-      [&](auto&&, const leaf_node& node) -> void {
-        for (const auto& data : node.data)
+    const auto& node_ = m_nodes[index];
+    if (predicate(node_.address))
+    {
+      visitor(node_.data);
+      if (!is_leaf_node(index))
+      {
+        for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
         {
-          m_node_address_for_data.emplace(data, node.address);
+          visit_node_if(node_.children + quadrant, visitor, predicate);
         }
-      });
+      }
+    }
+  }
 
-    if (m_root)
+  template <typename Predicate, typename O>
+  void find_data_if(const Predicate& predicate, O out) const
+  {
+    if (!empty())
     {
-      std::visit([&](const auto& node) { visitor(visitor, node); }, *m_root);
+      visit_node_if(
+        0,
+        [&](const auto& data) { std::copy(data.begin(), data.end(), out); },
+        predicate);
     }
   }
 
+public:
+  explicit octree(const T min_size)
+    : m_min_size{min_size}
+  {
+  }
+
+  octree(const T min_size, node root)
+    : m_min_size{min_size}
+  {
+    m_nodes.push_back(flat_node{detail::node_address{0, 0, 0, 0}, 0, {}});
+    set_node(0, std::move(root));
+  }
+
   /**
    * Indicates whether a node with the given data exists in this tree.
    *
@@ -418,34 +598,95 @@ public:
     const auto address = detail::get_container(bounds, m_min_size);
     if (is_root(address))
     {
-      if (!m_root)
+      if (empty())
       {
-        m_root = leaf_node{address, {}};
+        m_nodes.push_back(flat_node{address, 0, {}});
       }
-      else if (!get_address(*m_root).contains(address))
+      else if (!m_nodes[0].address.contains(address))
       {
-        update_root_address(*m_root, address, m_node_address_for_data);
+        update_root_address(address);
       }
 
-      get_data(*m_root).push_back(std::move(data));
-      m_node_address_for_data.emplace(data, get_address(*m_root));
+      m_node_address_for_data.emplace(data, m_nodes[0].address);
+      m_nodes[0].data.push_back(std::move(data));
     }
     else
     {
-      if (!m_root)
+      if (empty())
       {
-        m_root = inner_node{get_root(address), {}};
+        const auto root_address = get_root(address);
+        m_nodes.push_back(flat_node{root_address, 0, {}});
+        m_nodes[0].children = allocate_children(root_address);
       }
-      else if (!get_address(*m_root).contains(address))
+      else if (!m_nodes[0].address.contains(address))
       {
-        update_root_address(*m_root, get_root(address), m_node_address_for_data);
+        update_root_address(get_root(address));
       }
 
-      insert_into_node(*m_root, address, std::move(data));
       m_node_address_for_data.emplace(data, address);
+      insert_into_node(0, address, std::move(data));
     }
   }
 
+  /**
+   * Replaces the contents of this tree with the given data items.
+   *
+   * The tree is built top down by partitioning the items among the octants of their
+   * smallest common container, which is much faster than inserting the items one by
+   * one. The resulting tree does not contain any unnecessary inner nodes.
+   *
+   * @param entries the bounds and data of the items to add
+   *
+   * @throws NodeTreeException if any of the given bounds are invalid or if any data item
+   * occurs more than once
+   */
+  void build(std::vector<std::pair<vm::bbox<T, 3>, U>> entries)
+  {
+    clear();
+    if (entries.empty())
+    {
+      return;
+    }
+
+    m_node_address_for_data.reserve(entries.size());
+
+    auto addresses = std::vector<build_entry>{};
+    addresses.reserve(entries.size());
+
+    auto root_address = std::optional<detail::node_address>{};
+    for (auto& [bounds, data] : entries)
+    {
+      check(bounds);
+
+      const auto address = detail::get_container(bounds, m_min_size);
+      const auto container = is_root(address) ? address : get_root(address);
+      if (!root_address || container.size > root_address->size)
+      {
+        root_address = container;
+      }
+
+      addresses.emplace_back(address, std::move(data));
+    }
+
+    for (const auto& [address, data] : addresses)
+    {
+      // items at root addresses are stored in the root node, regardless of their size
+      if (!m_node_address_for_data
+             .emplace(data, is_root(address) ? *root_address : address)
+             .second)
+      {
+        clear();
+        throw NodeTreeException("Data already in tree");
+      }
+    }
+
+    auto buffers = build_buffers{};
+    buffers.keys.reserve(addresses.size());
+    buffers.sorted.reserve(addresses.size());
+
+    m_nodes.push_back(flat_node{*root_address, 0, {}});
+    build_node(0, *root_address, addresses.begin(), addresses.end(), buffers);
+  }
 
   /**
    * Removes the node with the given data from this tree.
@@ -461,12 +702,12 @@ public:
       return false;
     }
 
-    remove_from_node(*m_root, i_address->second, data);
-    m_node_address_for_data.erase(data);
+    remove_from_node(0, i_address->second, data);
+    m_node_address_for_data.erase(i_address);
 
     if (m_node_address_for_data.empty())
     {
-      m_root = std::nullopt;
+      clear();
     }
 
     return true;
@@ -497,7 +738,8 @@ public:
   void clear()
   {
     m_node_address_for_data.clear();
-    m_root = std::nullopt;
+    m_nodes.clear();
+    m_free_blocks.clear();
   }
 
   /**
@@ -505,7 +747,38 @@ public:
    *
    * @return true if this tree is empty and false otherwise
    */
-  bool empty() const { return m_root == std::nullopt; }
+  bool empty() const { return m_nodes.empty(); }
+
+  /**
+   * Returns an estimate of the memory used by this tree in bytes. The memory used by the
+   * hash map is estimated by assuming one bucket pointer per bucket and a heap allocated
+   * node with a next pointer per entry.
+   */
+  size_t memory_usage() const
+  {
+    auto result = sizeof(octree) + m_nodes.capacity() * sizeof(flat_node)
+                  + m_free_blocks.capacity() * sizeof(uint32_t);
+    for (const auto& node_ : m_nodes)
+    {
+      result += node_.data.capacity() * sizeof(U);
+    }
+
+    using entry = typename decltype(m_node_address_for_data)::value_type;
+    result += m_node_address_for_data.bucket_count() * sizeof(void*)
+              + m_node_address_for_data.size() * (sizeof(entry) + sizeof(void*));
+    return result;
+  }
+
+  /**
+   * Returns the root node of this tree and all of its descendants. This is expensive and
+   * intended for testing and debugging only.
+   *
+   * @return the root node or std::nullopt if this tree is empty
+   */
+  std::optional<node> root() const
+  {
+    return !empty() ? std::optional<node>{get_node(0)} : std::nullopt;
+  }
 
   /**
    * Finds every data item in this tree whose bounding box intersects with the given ray
@@ -532,20 +805,13 @@ public:
   template <typename O>
   void find_intersectors(const vm::ray<T, 3>& ray, O out) const
   {
-    if (m_root)
-    {
-      visit_node_if(
-        *m_root,
-        [&](const auto& node) {
-          const auto& data = get_data(node);
-          std::copy(data.begin(), data.end(), out);
-        },
-        [&](const auto& node) {
-          const auto bounds = get_address(node).to_bounds(m_min_size);
-          return bounds.contains(ray.origin)
-                 || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
-        });
-    }
+    find_data_if(
+      [&](const auto& address) {
+        const auto bounds = address.to_bounds(m_min_size);
+        return bounds.contains(ray.origin)
+               || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
+      },
+      out);
   }
 
   /**
@@ -573,19 +839,11 @@ public:
   template <typename O>
   void find_intersectors(const vm::bbox<T, 3>& bbox, O out) const
   {
-    if (m_root)
-    {
-      visit_node_if(
-        *m_root,
-        [&](const auto& node) {
-          const auto& data = get_data(node);
-          std::copy(data.begin(), data.end(), out);
-        },
-        [&](const auto& node) {
-          const auto bounds = get_address(node).to_bounds(m_min_size);
-          return bbox.intersects(bounds);
-        });
-    }
+    find_data_if(
+      [&](const auto& address) {
+        return bbox.intersects(address.to_bounds(m_min_size));
+      },
+      out);
   }
 
   /**
@@ -613,21 +871,49 @@ public:
   template <typename O>
   void find_containers(const vm::vec<T, 3>& point, O out) const
   {
-    if (m_root)
-    {
-      visit_node_if(
-        *m_root,
-        [&](const auto& node) {
-          const auto& data = get_data(node);
-          std::copy(data.begin(), data.end(), out);
-        },
-        [&](const auto& node) {
-          return get_address(node).to_bounds(m_min_size).contains(point);
-        });
-    }
+    find_data_if(
+      [&](const auto& address) {
+        return address.to_bounds(m_min_size).contains(point);
+      },
+      out);
   }
 
-  kdl_reflect_inline(octree, m_root, m_min_size, m_node_address_for_data);
+  /**
+   * Finds every data item in this tree which is stored in a node whose bounds satisfy
+   * the given predicate and appends it to the given output iterator. The children of a
+   * node are only visited if the predicate accepts the bounds of that node, so this is
+   * only useful for predicates which also accept every box containing an accepted box,
+   * such as intersection tests.
+   *
+   * @tparam P the predicate type, must accept a vm::bbox<T, 3>
+   * @tparam O the output iterator type
+   * @param predicate the predicate to test the node bounds with
+   * @param out the output iterator to append to
+   */
+  template <typename P, typename O>
+  void find_if(const P& predicate, O out) const
+  {
+    find_data_if(
+      [&](const auto& address) { return predicate(address.to_bounds(m_min_size)); },
+      out);
+  }
+
+  friend bool operator==(const octree& lhs, const octree& rhs)
+  {
+    return lhs.m_min_size == rhs.m_min_size
+           && lhs.m_node_address_for_data == rhs.m_node_address_for_data
+           && lhs.root() == rhs.root();
+  }
+
+  friend bool operator!=(const octree& lhs, const octree& rhs) { return !(lhs == rhs); }
+
+  friend std::ostream& operator<<(std::ostream& str, const octree& tree)
+  {
+    kdl::struct_stream{str} << "octree"
+                            << "m_root" << tree.root() << "m_min_size" << tree.m_min_size
+                            << "m_node_address_for_data" << tree.m_node_address_for_data;
+    return str;
+  }
 
 private:
   void check(const vm::bbox<T, 3>& bounds) const
@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/AssetReference.h"
+#include "Assets/Texture.h"
+
+#include "kdl/parallel.h"
+
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Assets
+{
+
+TEST_CASE("AssetReferenceTest.usageCount")
+{
+  auto texture = Texture{"texture", 16, 16};
+
+  {
+    auto reference = AssetReference{&texture};
+    CHECK(texture.usageCount() == 1u);
+
+    auto copy = reference;
+    CHECK(texture.usageCount() == 2u);
+
+    auto moved = std::move(copy);
+    CHECK(texture.usageCount() == 2u);
+  }
+
+  CHECK(texture.usageCount() == 0u);
+}
+
+TEST_CASE("AssetReferenceTest.usageCountBatch")
+{
+  auto texture1 = Texture{"texture1", 16, 16};
+  auto texture2 = Texture{"texture2", 16, 16};
+
+  auto reference = std::optional<AssetReference<Texture>>{AssetReference{&texture1}};
+  REQUIRE(texture1.usageCount() == 1u);
+
+  auto references = std::vector<AssetReference<Texture>>(1000);
+  {
+    auto batch = AssetUsageCountBatch<Texture>{};
+
+    kdl::parallel_for(references.size(), [&](const size_t i) {
+      const auto activation = batch.activate();
+      references[i] = AssetReference{i % 2 == 0 ? &texture1 : &texture2};
+    });
+    reference.reset();
+
+    {
+      // nested batches have no effect
+      const auto nestedBatch = AssetUsageCountBatch<Texture>{};
+      references.pop_back();
+    }
+
+    // the usage counts are only changed once the batch is destroyed
+    CHECK(texture1.usageCount() == 1u);
+    CHECK(texture2.usageCount() == 0u);
+  }
+
+  CHECK(texture1.usageCount() == 500u);
+  CHECK(texture2.usageCount() == 499u);
+
+  references.clear();
+  CHECK(texture1.usageCount() == 0u);
+  CHECK(texture2.usageCount() == 0u);
+}
+
+TEST_CASE("AssetReferenceTest.usageCountBatchIgnoresOtherThreads")
+{
+  auto texture1 = Texture{"texture1", 16, 16};
+  auto texture2 = Texture{"texture2", 16, 16};
+
+  auto otherReference = std::optional<AssetReference<Texture>>{};
+  {
+    const auto batch = AssetUsageCountBatch<Texture>{};
+    auto reference = AssetReference{&texture1};
+
+    // a thread that does not take part in the batch changes the usage count immediately
+    std::thread{[&]() { otherReference = AssetReference{&texture2}; }}.join();
+
+    CHECK(texture1.usageCount() == 0u);
+    CHECK(texture2.usageCount() == 1u);
+
+    std::thread{[&]() { otherReference.reset(); }}.join();
+    CHECK(texture2.usageCount() == 0u);
+  }
+
+  CHECK(texture1.usageCount() == 0u);
+  CHECK(texture2.usageCount() == 0u);
+}
+
+} // namespace TrenchBroom::Assets
@@ -18,13 +18,19 @@
  */
 
 #include "Assets/Palette.h"
+#include "Assets/TextureBuffer.h"
+#include "Color.h"
 #include "Error.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
 #include "Result.h"
 
 #include "kdl/result.h"
 
+#include <cstring>
+
 #include "Catch2.h"
 
 namespace TrenchBroom::Assets
@@ -215,4 +221,52 @@ TEST_CASE("loadPalette")
 
   CHECK(loadPalette(*file, filePath) == expectedPalette);
 }
+
+TEST_CASE("Palette.indexedToRgba")
+{
+  // black, red and green; index 255 is not part of the palette
+  const auto paletteData =
+    std::vector<unsigned char>{0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00};
+  const auto palette = makePalette(paletteData, PaletteColorFormat::Rgb).value();
+
+  const auto indices = std::vector<char>{1, 1, 1, 1, 2, 2, 0, char(255)};
+  auto reader = IO::Reader::from(indices.data(), indices.data() + indices.size());
+
+  auto buffer = TextureBuffer{4 * indices.size()};
+  auto averageColor = Color{};
+
+  SECTION("opaque")
+  {
+    CHECK_FALSE(palette.indexedToRgba(
+      reader, indices.size(), buffer, PaletteTransparency::Opaque, averageColor));
+
+    const auto expected = std::vector<unsigned char>{
+      0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF,
+      0xFF, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF,
+      0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    };
+    CHECK(std::memcmp(buffer.data(), expected.data(), expected.size()) == 0);
+    CHECK(averageColor == Color{0.5f, 0.25f, 0.0f, 1.0f});
+    CHECK(reader.position() == indices.size());
+  }
+
+  SECTION("index 255 transparent")
+  {
+    CHECK(palette.indexedToRgba(
+      reader,
+      indices.size(),
+      buffer,
+      PaletteTransparency::Index255Transparent,
+      averageColor));
+  }
+
+  SECTION("too few indices")
+  {
+    buffer = TextureBuffer{4 * (indices.size() + 1)};
+    CHECK_THROWS_AS(
+      palette.indexedToRgba(
+        reader, indices.size() + 1, buffer, PaletteTransparency::Opaque, averageColor),
+      IO::ReaderException);
+  }
+}
 } // namespace TrenchBroom::Assets
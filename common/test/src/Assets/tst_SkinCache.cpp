@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Assets/EntityModel.h"
+#include "Assets/SkinCache.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "Color.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Assets
+{
+namespace
+{
+Texture makeSkin(const std::string& name)
+{
+  return Texture{
+    name, 1, 1, Color::zero(), TextureBuffer{4}, GL_RGBA, TextureType::Opaque};
+}
+} // namespace
+
+TEST_CASE("SkinCache")
+{
+  auto skinCache = SkinCache{};
+  auto loadCount = 0;
+  const auto loadSkin = [&](const std::string& name) {
+    return [&, name]() {
+      ++loadCount;
+      return makeSkin(name);
+    };
+  };
+
+  SECTION("Loads a skin only once")
+  {
+    const auto skin1 = skinCache.skin("skins/skin.tga", loadSkin("skin"));
+    const auto skin2 = skinCache.skin("skins/skin.tga", loadSkin("skin"));
+
+    CHECK(loadCount == 1);
+    CHECK(skin1 == skin2);
+    CHECK(skin1->textureCount() == 1);
+    CHECK(skin1->textureByIndex(0)->name() == "skin");
+    CHECK(skinCache.skinCount() == 1);
+  }
+
+  SECTION("Loads different skins for different paths")
+  {
+    const auto skin1 = skinCache.skin("skins/skin1.tga", loadSkin("skin1"));
+    const auto skin2 = skinCache.skin("skins/skin2.tga", loadSkin("skin2"));
+
+    CHECK(loadCount == 2);
+    CHECK(skin1 != skin2);
+    CHECK(skinCache.skinCount() == 2);
+  }
+
+  SECTION("Purge releases unused skins")
+  {
+    auto skin1 = skinCache.skin("skins/skin1.tga", loadSkin("skin1"));
+    auto skin2 = skinCache.skin("skins/skin2.tga", loadSkin("skin2"));
+
+    CHECK(skinCache.purge() == 0);
+
+    skin1.reset();
+    CHECK(skinCache.purge() == 1);
+    CHECK(skinCache.skinCount() == 1);
+
+    CHECK(skinCache.skin("skins/skin2.tga", loadSkin("skin2")) == skin2);
+    CHECK(loadCount == 2);
+
+    skinCache.skin("skins/skin1.tga", loadSkin("skin1"));
+    CHECK(loadCount == 3);
+  }
+
+  SECTION("Clear releases all skins")
+  {
+    const auto skin = skinCache.skin("skins/skin.tga", loadSkin("skin"));
+    skinCache.clear();
+
+    CHECK(skinCache.skinCount() == 0);
+    CHECK(skin->textureByIndex(0)->name() == "skin");
+
+    CHECK(skinCache.skin("skins/skin.tga", loadSkin("skin")) != skin);
+    CHECK(loadCount == 2);
+  }
+}
+
+TEST_CASE("EntityModelSurface.sharedSkins")
+{
+  auto skinCache = SkinCache{};
+  const auto skin1 = skinCache.skin("skins/skin1.tga", [] { return makeSkin("skin1"); });
+  const auto skin2 = skinCache.skin("skins/skin2.tga", [] { return makeSkin("skin2"); });
+
+  auto surface1 = EntityModelSurface{"surface 1", 1};
+  surface1.setSkins({skin1, skin2});
+
+  auto surface2 = EntityModelSurface{"surface 2", 1};
+  surface2.setSkins({skin2});
+
+  CHECK(surface1.skinCount() == 2);
+  CHECK(surface1.skin(0) == skin1->textureByIndex(0));
+  CHECK(surface1.skin(1) == skin2->textureByIndex(0));
+  CHECK(surface1.skin(2) == nullptr);
+  CHECK(surface1.skin("skin2") == surface2.skin(0));
+  CHECK(surface1.skin("skin3") == nullptr);
+}
+
+} // namespace TrenchBroom::Assets
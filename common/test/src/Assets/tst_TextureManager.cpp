@@ -0,0 +1,184 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/TestEnvironment.h"
+#include "Logger.h"
+#include "Model/GameConfig.h"
+
+#include "kdl/vector_utils.h"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Assets
+{
+namespace
+{
+TextureCollection makeTextureCollection(const std::vector<std::string>& names)
+{
+  return TextureCollection{kdl::vec_transform(
+    names, [](const auto& name) { return Texture{name, 1, 1}; })};
+}
+
+std::string textureName(const Texture* texture)
+{
+  return texture ? texture->name() : "null";
+}
+} // namespace
+
+TEST_CASE("TextureManager")
+{
+  auto logger = NullLogger{};
+  auto textureManager = TextureManager{0, 0, logger};
+
+  auto collections = std::vector<TextureCollection>{};
+  collections.push_back(makeTextureCollection({"Base", "other", "some/path"}));
+  collections.push_back(makeTextureCollection({"BASE"}));
+  textureManager.setTextureCollections(std::move(collections));
+
+  SECTION("Looks up textures ignoring case")
+  {
+    CHECK(textureManager.texture("base") != nullptr);
+    CHECK(textureManager.texture("base")->name() == "BASE");
+    CHECK(textureManager.texture("Other") != nullptr);
+    CHECK(textureManager.texture("other")->name() == "other");
+    CHECK(textureManager.texture("SOME/PATH") != nullptr);
+    CHECK(textureManager.texture("missing") == nullptr);
+    CHECK(textureManager.texture("") == nullptr);
+  }
+
+  SECTION("Later collections override textures with the same name")
+  {
+    const auto& baseTexture = textureManager.collections()[0].textures()[0];
+    CHECK(baseTexture.name() == "Base");
+    CHECK(baseTexture.overridden());
+    CHECK_FALSE(textureManager.texture("base")->overridden());
+  }
+
+  SECTION("Textures are sorted by name ignoring case")
+  {
+    CHECK(
+      kdl::vec_transform(
+        textureManager.textures(), [](const auto* texture) { return texture->name(); })
+      == std::vector<std::string>{"BASE", "other", "some/path"});
+  }
+
+  SECTION("Finds textures by filter text")
+  {
+    CHECK(
+      kdl::vec_transform(textureManager.findTextures("BAS"), textureName)
+      == std::vector<std::string>{"Base", "BASE"});
+    CHECK(
+      kdl::vec_transform(textureManager.findTextures("o pa"), textureName)
+      == std::vector<std::string>{"some/path"});
+    CHECK(textureManager.findTextures("missing").empty());
+    CHECK(textureManager.findTextures("").size() == 4);
+  }
+
+  SECTION("Resolves many texture names at once")
+  {
+    const auto parallel = GENERATE(false, true);
+
+    auto textureNames = std::vector<std::string_view>{};
+    auto expectedNames = std::vector<std::string>{};
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      textureNames.push_back(i % 3 == 0 ? "base" : i % 3 == 1 ? "OTHER" : "missing");
+      expectedNames.push_back(i % 3 == 0 ? "BASE" : i % 3 == 1 ? "other" : "null");
+    }
+
+    const auto textures = textureManager.resolveTextures(textureNames, parallel);
+    CHECK(kdl::vec_transform(textures, textureName) == expectedNames);
+  }
+}
+
+TEST_CASE("TextureManager.reloadModifiedTextures")
+{
+  const auto imageDir = std::filesystem::current_path() / "fixture/test/IO/Image";
+
+  auto env = IO::TestEnvironment{};
+  env.createDirectory("textures/base");
+  std::filesystem::copy_file(imageDir / "5x5.png", env.dir() / "textures/base/a.png");
+  std::filesystem::copy_file(imageDir / "5x5.png", env.dir() / "textures/base/b.png");
+
+  auto fs = IO::DiskFileSystem{env.dir()};
+  const auto textureConfig = Model::TextureConfig{"textures", {".png"}, "", {}, "", {}};
+  const auto directory = env.dir() / "textures/base";
+
+  auto logger = NullLogger{};
+  auto textureManager = TextureManager{0, 0, logger};
+  textureManager.reload(fs, textureConfig);
+
+  const auto textureDirectories = textureManager.textureDirectories();
+  CHECK(kdl::vec_contains(textureDirectories, directory));
+
+  const auto* texture = textureManager.texture("base/a");
+  REQUIRE(texture != nullptr);
+  REQUIRE(texture->width() == 5);
+
+  SECTION("Does nothing if no files were modified")
+  {
+    CHECK(textureManager.reloadModifiedTextures(directory, fs, textureConfig) == 0);
+    CHECK(textureManager.texture("base/a") == texture);
+  }
+
+  SECTION("Replaces modified textures in place")
+  {
+    const auto path = directory / "a.png";
+    const auto writeTime = std::filesystem::last_write_time(path);
+    std::filesystem::copy_file(
+      imageDir / "alphaMaskTest.png",
+      path,
+      std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::last_write_time(path, writeTime + std::chrono::hours{1});
+
+    CHECK(textureManager.reloadModifiedTextures(directory, fs, textureConfig) == 1);
+    CHECK(textureManager.texture("base/a") == texture);
+    CHECK(texture->width() == 25);
+    CHECK(texture->height() == 10);
+    CHECK(textureManager.texture("base/b")->width() == 5);
+  }
+
+  SECTION("Requires a full reload if files were added")
+  {
+    std::filesystem::copy_file(imageDir / "5x5.png", directory / "c.png");
+    CHECK(
+      textureManager.reloadModifiedTextures(directory, fs, textureConfig)
+      == std::nullopt);
+  }
+
+  SECTION("Requires a full reload if files were removed")
+  {
+    std::filesystem::remove(directory / "b.png");
+    CHECK(
+      textureManager.reloadModifiedTextures(directory, fs, textureConfig)
+      == std::nullopt);
+  }
+}
+
+} // namespace TrenchBroom::Assets
@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureThumbnail.h"
+#include "Color.h"
+
+#include <cstring>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Assets
+{
+namespace
+{
+
+Texture makeMipTexture(const size_t width, const size_t height, const size_t mipLevels)
+{
+  auto buffers = TextureBufferList{};
+  setMipBufferSize(buffers, mipLevels, width, height, GL_RGBA);
+  for (size_t level = 0; level < buffers.size(); ++level)
+  {
+    std::memset(buffers[level].data(), int(level), buffers[level].size());
+  }
+
+  return Texture{
+    "texture",
+    width,
+    height,
+    Color{},
+    std::move(buffers),
+    GL_RGBA,
+    TextureType::Opaque};
+}
+
+} // namespace
+
+TEST_CASE("makeTextureThumbnail")
+{
+  SECTION("Uses the smallest mip level that is large enough")
+  {
+    const auto texture = makeMipTexture(512, 256, 4);
+    const auto thumbnail = makeTextureThumbnail(texture);
+
+    REQUIRE(thumbnail);
+    CHECK(thumbnail->width == 128);
+    CHECK(thumbnail->height == 64);
+    CHECK(thumbnail->format == GLenum(GL_RGBA));
+    CHECK(thumbnail->type == TextureType::Opaque);
+    REQUIRE(thumbnail->buffer.size() == 128 * 64 * 4);
+    CHECK(thumbnail->buffer.data()[0] == 2);
+  }
+
+  SECTION("Uses the first mip level of small textures")
+  {
+    const auto texture = makeMipTexture(64, 32, 4);
+    const auto thumbnail = makeTextureThumbnail(texture);
+
+    REQUIRE(thumbnail);
+    CHECK(thumbnail->width == 64);
+    CHECK(thumbnail->height == 32);
+    CHECK(thumbnail->buffer.data()[0] == 0);
+  }
+
+  SECTION("Uses the last mip level if all mip levels are large")
+  {
+    const auto texture = makeMipTexture(1024, 1024, 2);
+    const auto thumbnail = makeTextureThumbnail(texture);
+
+    REQUIRE(thumbnail);
+    CHECK(thumbnail->width == 512);
+    CHECK(thumbnail->height == 512);
+    CHECK(thumbnail->buffer.data()[0] == 1);
+  }
+
+  SECTION("Returns nothing for textures without pixel data")
+  {
+    const auto texture = Texture{"texture", 64, 64};
+    CHECK_FALSE(makeTextureThumbnail(texture));
+  }
+}
+
+} // namespace TrenchBroom::Assets
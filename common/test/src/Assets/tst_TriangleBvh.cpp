@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/TriangleBvh.h"
+
+#include "vm/approx.h"
+#include "vm/forward.h"
+#include "vm/intersection.h"
+#include "vm/ray.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+
+#include <random>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Assets
+{
+
+namespace
+{
+float intersectBruteForce(const vm::ray3f& ray, const std::vector<vm::vec3f>& triangles)
+{
+  auto result = vm::nan<float>();
+  for (size_t i = 0; i < triangles.size(); i += 3)
+  {
+    result = vm::safe_min(
+      result,
+      vm::intersect_ray_triangle(ray, triangles[i], triangles[i + 1], triangles[i + 2]));
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("TriangleBvh.intersect")
+{
+  SECTION("Empty")
+  {
+    const auto bvh = TriangleBvh{{}};
+    CHECK(vm::is_nan(bvh.intersect(vm::ray3f{vm::vec3f::zero(), vm::vec3f::pos_x()})));
+  }
+
+  SECTION("Single triangle")
+  {
+    const auto bvh = TriangleBvh{{
+      {0, -16, -16},
+      {0, 16, -16},
+      {0, 0, 16},
+    }};
+
+    CHECK(
+      bvh.intersect(vm::ray3f{vm::vec3f{-32, 0, 0}, vm::vec3f::pos_x()})
+      == vm::approx{32.0f});
+    // the triangle is hit from both sides
+    CHECK(
+      bvh.intersect(vm::ray3f{vm::vec3f{32, 0, 0}, vm::vec3f::neg_x()})
+      == vm::approx{32.0f});
+    CHECK(vm::is_nan(bvh.intersect(vm::ray3f{vm::vec3f{32, 0, 0}, vm::vec3f::pos_x()})));
+    CHECK(vm::is_nan(bvh.intersect(vm::ray3f{vm::vec3f{-32, 0, 0}, vm::vec3f::pos_y()})));
+    CHECK(
+      vm::is_nan(bvh.intersect(vm::ray3f{vm::vec3f{-32, 32, 0}, vm::vec3f::pos_x()})));
+  }
+
+  SECTION("Returns the closest hit of many triangles")
+  {
+    auto random = std::mt19937{42};
+    auto coord = std::uniform_real_distribution<float>{-128.0f, 128.0f};
+    auto offset = std::uniform_real_distribution<float>{-16.0f, 16.0f};
+
+    auto triangles = std::vector<vm::vec3f>{};
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      const auto center = vm::vec3f{coord(random), coord(random), coord(random)};
+      for (size_t j = 0; j < 3; ++j)
+      {
+        triangles.push_back(
+          center + vm::vec3f{offset(random), offset(random), offset(random)});
+      }
+    }
+
+    const auto bvh = TriangleBvh{triangles};
+
+    auto hits = size_t(0);
+    for (size_t i = 0; i < 500; ++i)
+    {
+      const auto origin = vm::vec3f{coord(random), coord(random), coord(random)};
+      const auto target = vm::vec3f{coord(random), coord(random), coord(random)};
+      const auto ray = vm::ray3f{origin, vm::normalize(target - origin)};
+
+      const auto expected = intersectBruteForce(ray, triangles);
+      const auto actual = bvh.intersect(ray);
+      if (vm::is_nan(expected))
+      {
+        CHECK(vm::is_nan(actual));
+      }
+      else
+      {
+        CHECK(actual == vm::approx{expected});
+        ++hits;
+      }
+    }
+
+    CHECK(hits > 0);
+  }
+}
+
+} // namespace TrenchBroom::Assets
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/TrigramIndex.h"
+
+#include "kdl/collection_utils.h"
+#include "kdl/string_compare.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Assets
+{
+
+TEST_CASE("TrigramIndex")
+{
+  const auto names = std::vector<std::string_view>{
+    "base/floor01",
+    "base/FLOOR_02",
+    "metal/crate",
+    "metal/crate_side",
+    "sky1",
+    "aaaa",
+  };
+  const auto index = TrigramIndex{names};
+  REQUIRE(index.size() == names.size());
+
+  using T = std::tuple<std::string, std::vector<size_t>>;
+  const auto [filterText, expectedIndices] = GENERATE(values<T>({
+    {"", {0, 1, 2, 3, 4, 5}},
+    {"   ", {0, 1, 2, 3, 4, 5}},
+    {"floor", {0, 1}},
+    {"FLOOR", {0, 1}},
+    {"r_", {1}},
+    {"a", {0, 1, 2, 3, 5}},
+    {"y", {4}},
+    {"crate side", {3}},
+    {"side crate", {3}},
+    {"metal base", {}},
+    {"aaaa", {5}},
+    {"aaaaa", {}},
+    {"flo01", {}},
+    {"missing", {}},
+  }));
+
+  CAPTURE(filterText);
+  CHECK(index.find(filterText) == expectedIndices);
+}
+
+TEST_CASE("TrigramIndex.matchesSubstringSearch")
+{
+  auto names = std::vector<std::string>{};
+  for (size_t i = 0; i < 500; ++i)
+  {
+    names.push_back(
+      (i % 3 == 0 ? "base/" : i % 3 == 1 ? "Metal/" : "sky/") + std::to_string(i * 7)
+      + (i % 2 == 0 ? "_Wall" : "_floor"));
+  }
+
+  const auto index = TrigramIndex{
+    kdl::vec_transform(names, [](const auto& name) { return std::string_view{name}; })};
+
+  const auto filterText = GENERATE("1", "77", "metal 4", "wall 3", "e/2", "SKY/1 flo");
+
+  auto expectedIndices = std::vector<size_t>{};
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    if (kdl::all_of(kdl::str_split(filterText, " "), [&](const auto& pattern) {
+          return kdl::ci::str_contains(names[i], pattern);
+        }))
+    {
+      expectedIndices.push_back(i);
+    }
+  }
+
+  CAPTURE(filterText);
+  CHECK(index.find(filterText) == expectedIndices);
+}
+
+} // namespace TrenchBroom::Assets
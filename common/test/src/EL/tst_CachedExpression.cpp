@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EL/CachedExpression.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+#include "IO/ELParser.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::EL
+{
+
+namespace
+{
+class CountingVariableStore : public VariableTable
+{
+private:
+  size_t& m_lookupCount;
+
+public:
+  CountingVariableStore(MapType variables, size_t& lookupCount)
+    : VariableTable{std::move(variables)}
+    , m_lookupCount{lookupCount}
+  {
+  }
+
+  Value value(const std::string& name) const override
+  {
+    ++m_lookupCount;
+    return VariableTable::value(name);
+  }
+};
+} // namespace
+
+TEST_CASE("CachedExpressionTest.variables")
+{
+  const auto expression =
+    CachedExpression{IO::ELParser::parseStrict("{{ spawnflags == '1' -> x, y }}")};
+  CHECK(expression.variables() == std::vector<std::string>{"spawnflags", "x", "y"});
+}
+
+TEST_CASE("CachedExpressionTest.evaluate")
+{
+  const auto expression =
+    CachedExpression{IO::ELParser::parseStrict("{{ spawnflags == '1' -> a + b, a }}")};
+
+  auto lookupCount = size_t(0);
+
+  SECTION("Looks up only the referenced variables")
+  {
+    const auto store = CountingVariableStore{
+      {{"spawnflags", Value{"1"}},
+       {"a", Value{"x"}},
+       {"b", Value{"y"}},
+       {"c", Value{"z"}}},
+      lookupCount};
+    CHECK(expression.evaluate(store) == Value{"xy"});
+    CHECK(lookupCount == 3);
+  }
+
+  SECTION("Caches results by the values of the referenced variables")
+  {
+    CHECK(
+      expression.evaluate(VariableTable{
+        {{"spawnflags", Value{"1"}}, {"a", Value{"x"}}, {"b", Value{"y"}}}})
+      == Value{"xy"});
+    CHECK(expression.cachedResultCount() == 1);
+
+    CHECK(
+      expression.evaluate(VariableTable{
+        {{"spawnflags", Value{"1"}}, {"a", Value{"x"}}, {"b", Value{"y"}}}})
+      == Value{"xy"});
+    CHECK(expression.cachedResultCount() == 1);
+
+    CHECK(
+      expression.evaluate(VariableTable{
+        {{"spawnflags", Value{"0"}}, {"a", Value{"x"}}, {"b", Value{"y"}}}})
+      == Value{"x"});
+    CHECK(expression.cachedResultCount() == 2);
+  }
+
+  SECTION("Does not cache results for non-string values")
+  {
+    CHECK(
+      expression.evaluate(VariableTable{
+        {{"spawnflags", Value{"0"}}, {"a", Value{1}}, {"b", Value{2}}}})
+      == Value{1});
+    CHECK(
+      expression.evaluate(VariableTable{
+        {{"spawnflags", Value{"0"}}, {"a", Value{"1"}}, {"b", Value{"2"}}}})
+      == Value{"1"});
+    CHECK(expression.cachedResultCount() == 1);
+  }
+
+}
+
+TEST_CASE("CachedExpressionTest.discardsFullCache")
+{
+  const auto expression = CachedExpression{IO::ELParser::parseStrict("a")};
+
+  for (size_t i = 0; i < CachedExpression::MaxCachedResults; ++i)
+  {
+    expression.evaluate(VariableTable{{{"a", Value{std::to_string(i)}}}});
+  }
+  CHECK(expression.cachedResultCount() == CachedExpression::MaxCachedResults);
+
+  expression.evaluate(VariableTable{{{"a", Value{"x"}}}});
+  CHECK(expression.cachedResultCount() == 1);
+}
+
+} // namespace TrenchBroom::EL
@@ -43,6 +43,28 @@ TEST_CASE("ELTest.constructValues")
   CHECK(Value().type() == ValueType::Null);
 }
 
+TEST_CASE("ELTest.copyValues")
+{
+  const auto shortString = std::string{"short"};
+  const auto longString = std::string{"a string that is too long to be stored inline"};
+
+  const auto shortValue = Value{shortString};
+  const auto longValue = Value{longString};
+  const auto arrayValue = Value{ArrayType{shortValue, longValue}};
+
+  const auto shortCopy = shortValue;
+  const auto longCopy = longValue;
+  const auto arrayCopy = arrayValue;
+
+  CHECK(shortCopy.stringValue() == shortString);
+  CHECK(longCopy.stringValue() == longString);
+  CHECK(shortCopy == shortValue);
+  CHECK(longCopy == longValue);
+  CHECK(longCopy != shortValue);
+  CHECK(arrayCopy == arrayValue);
+  CHECK(arrayCopy.arrayValue() == ArrayType{Value{shortString}, Value{longString}});
+}
+
 TEST_CASE("ELTest.typeConversions")
 {
   CHECK(Value(true).convertTo(ValueType::Boolean) == Value(true));
@@ -746,5 +746,26 @@ TEST_CASE("ExpressionTest.testOptimize")
 
   CHECK(IO::ELParser::parseStrict(expression).optimize() == expectedExpression);
 }
+
+TEST_CASE("ExpressionTest.testVariables")
+{
+  using T = std::tuple<std::string, std::vector<std::string>>;
+
+  // clang-format off
+  const auto
+  [expression,                          expectedVariables] = GENERATE(values<T>({
+  {"1 + 2",                             {}},
+  {"x",                                 {"x"}},
+  {"x + y * x",                         {"x", "y"}},
+  {"[a, -b, {k: c}]",                   {"a", "b", "c"}},
+  {"{{ spawnflags == 1 -> m1, m2 }}",   {"m1", "m2", "spawnflags"}},
+  {"a[b]",                              {"a", "b"}},
+  }));
+  // clang-format on
+
+  CAPTURE(expression);
+
+  CHECK(IO::ELParser::parseStrict(expression).variables() == expectedVariables);
+}
 } // namespace EL
 } // namespace TrenchBroom
@@ -0,0 +1,137 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IO/AssimpModelCache.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+const auto ImportFlags = 0x1234u;
+
+AssimpModelData makeModelData()
+{
+  auto texels = std::vector<unsigned char>(2 * 2 * 4, 0x7F);
+
+  auto frame = AssimpFrameData{
+    vm::bbox3f{vm::vec3f{0, 0, 0}, vm::vec3f{1, 1, 0}},
+    {
+      {1,
+       {
+         Assets::EntityModelVertex{vm::vec3f{0, 0, 0}, vm::vec2f{0, 0}},
+         Assets::EntityModelVertex{vm::vec3f{1, 0, 0}, vm::vec2f{1, 0}},
+         Assets::EntityModelVertex{vm::vec3f{1, 1, 0}, vm::vec2f{1, 1}},
+       }},
+    }};
+
+  return AssimpModelData{
+    {
+      {"mesh1", {{AssimpSkinData::Source::Fallback, "material", 0, 0, {}}}},
+      {"mesh2",
+       {
+         {AssimpSkinData::Source::File, "textures/skin.png", 0, 0, {}},
+         {AssimpSkinData::Source::Embedded, "*0", 2, 2, texels},
+       }},
+    },
+    {std::move(frame), std::nullopt},
+    {"model.mtl"}};
+}
+
+std::string writeCache(
+  const AssimpModelData& modelData, const std::string& key, const FileSystem& fs)
+{
+  auto str = std::stringstream{};
+  REQUIRE(writeAssimpModelCache(modelData, key, fs, str).is_success());
+  return str.str();
+}
+
+auto readCache(const std::string& cache, const std::string& key, const FileSystem& fs)
+{
+  return readAssimpModelCache(
+    Reader::from(cache.data(), cache.data() + cache.size()), key, fs);
+}
+} // namespace
+
+TEST_CASE("AssimpModelCache")
+{
+  auto env = TestEnvironment{[](auto& e) {
+    e.createFile("model.obj", "v 0 0 0");
+    e.createFile("model.mtl", "newmtl material");
+  }};
+  auto fs = DiskFileSystem{env.dir()};
+
+  const auto key = assimpModelCacheKey("model.obj", fs, ImportFlags).value();
+  const auto modelData = makeModelData();
+  const auto cache = writeCache(modelData, key, fs);
+
+  SECTION("Reading the cache restores the model data")
+  {
+    CHECK(readCache(cache, key, fs).value() == modelData);
+  }
+
+  SECTION("The cache is not read if the model file has changed")
+  {
+    env.createFile("model.obj", "v 1 1 1");
+    const auto newKey = assimpModelCacheKey("model.obj", fs, ImportFlags).value();
+    CHECK(newKey != key);
+    CHECK(readCache(cache, newKey, fs).is_error());
+  }
+
+  SECTION("The cache is not read if the import settings have changed")
+  {
+    const auto newKey = assimpModelCacheKey("model.obj", fs, ImportFlags + 1).value();
+    CHECK(newKey != key);
+    CHECK(readCache(cache, newKey, fs).is_error());
+  }
+
+  SECTION("The cache is not read if a dependency has changed")
+  {
+    env.createFile("model.mtl", "newmtl other_material");
+    CHECK(readCache(cache, key, fs).is_error());
+  }
+
+  SECTION("The cache is not read if a dependency is missing")
+  {
+    std::filesystem::remove(env.dir() / "model.mtl");
+    CHECK(readCache(cache, key, fs).is_error());
+  }
+
+  SECTION("A truncated cache is not read")
+  {
+    CHECK(readCache(cache.substr(0, cache.size() - 1), key, fs).is_error());
+  }
+}
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "IO/CacheIO.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+
+#include "kdl/result.h"
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+std::string writeCache(const std::string_view magic, const uint32_t version)
+{
+  auto stream = std::stringstream{};
+  auto writer = CacheWriter{stream};
+  writer.writeHeader(magic, version);
+  writer.writeString("key");
+  writer.writeSize(7);
+  return stream.str();
+}
+
+Result<void> readHeader(const std::string& cache, const std::string_view key)
+{
+  auto reader = Reader::from(cache.data(), cache.data() + cache.size());
+  return readCacheHeader(reader, "TEST", 1, key, "test cache");
+}
+} // namespace
+
+TEST_CASE("readCacheHeader")
+{
+  CHECK(readHeader(writeCache("TEST", 1), "key") == Result<void>{});
+  CHECK(
+    readHeader(writeCache("ABCD", 1), "key")
+    == Result<void>{Error{"Not a valid test cache"}});
+  CHECK(
+    readHeader(writeCache("TEST", 2), "key")
+    == Result<void>{Error{"Unsupported test cache version"}});
+  CHECK(
+    readHeader(writeCache("TEST", 1), "other key")
+    == Result<void>{Error{"Outdated test cache"}});
+  CHECK(readHeader("TE", "key").is_error());
+
+  SECTION("The reader is positioned after the header")
+  {
+    const auto cache = writeCache("TEST", 1);
+    auto reader = Reader::from(cache.data(), cache.data() + cache.size());
+    REQUIRE(readCacheHeader(reader, "TEST", 1, "key", "test cache").is_success());
+    CHECK(readSize(reader) == 7u);
+  }
+}
+
+TEST_CASE("writeCacheFile")
+{
+  auto env = TestEnvironment{};
+  const auto cachePath = env.dir() / "cache" / "test.cache";
+
+  SECTION("Creates the cache directory")
+  {
+    CHECK(
+      writeCacheFile(cachePath, [](auto& stream) { stream << "contents"; })
+      == Result<void>{});
+    CHECK(env.loadFile("cache/test.cache") == "contents");
+    CHECK(
+      env.directoryContents("cache")
+      == std::vector<std::filesystem::path>{"cache/test.cache"});
+  }
+
+  SECTION("Replaces an existing cache")
+  {
+    env.createDirectory("cache");
+    env.createFile("cache/test.cache", "old contents");
+
+    CHECK(
+      writeCacheFile(cachePath, [](auto& stream) { stream << "new contents"; })
+      == Result<void>{});
+    CHECK(env.loadFile("cache/test.cache") == "new contents");
+    CHECK(
+      env.directoryContents("cache")
+      == std::vector<std::filesystem::path>{"cache/test.cache"});
+  }
+
+  SECTION("Keeps an existing cache if writing fails")
+  {
+    env.createDirectory("cache");
+    env.createFile("cache/test.cache", "old contents");
+
+    CHECK(
+      writeCacheFile(
+        cachePath,
+        [](auto& stream) -> Result<void> {
+          stream << "partial contents";
+          return Error{"failure"};
+        })
+      == Result<void>{Error{"failure"}});
+    CHECK(env.loadFile("cache/test.cache") == "old contents");
+    CHECK(
+      env.directoryContents("cache")
+      == std::vector<std::filesystem::path>{"cache/test.cache"});
+  }
+}
+
+} // namespace TrenchBroom::IO
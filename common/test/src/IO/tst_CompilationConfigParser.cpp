@@ -431,6 +431,53 @@ TEST_CASE("CompilationConfigParserTest.parseOneProfileWithNameAndFourTasks")
     }});
 }
 
+TEST_CASE("CompilationConfigParserTest.parseConcurrentTasks")
+{
+  const auto config = R"(
+{
+  'version': 1,
+  'profiles': [{
+    'name': 'A profile',
+    'workdir': '',
+    'tasks': [{
+      'type':'export',
+      'target': 'first.map'
+    },
+    {
+      'type':'export',
+      'target': 'second.map',
+      'concurrent': true
+    },
+    {
+      'type':'tool',
+      'tool': 'tyrbsp.exe',
+      'parameters': 'first.map',
+      'concurrent': false
+    },
+    {
+      'type':'tool',
+      'tool': 'tyrbsp.exe',
+      'parameters': 'second.map',
+      'concurrent': true
+    }]
+  }]
+})";
+
+  auto parser = CompilationConfigParser{config};
+  CHECK(
+    parser.parse()
+    == Model::CompilationConfig{{
+      {"A profile",
+       "",
+       {
+         Model::CompilationExportMap{true, "first.map", false},
+         Model::CompilationExportMap{true, "second.map", true},
+         Model::CompilationRunTool{true, "tyrbsp.exe", "first.map", false, false},
+         Model::CompilationRunTool{true, "tyrbsp.exe", "second.map", false, true},
+       }},
+    }});
+}
+
 TEST_CASE("CompilationConfigParserTest.parseUnescapedBackslashes")
 {
   // https://github.com/TrenchBroom/TrenchBroom/issues/1437
@@ -221,6 +221,87 @@ TEST_CASE("DiskFileSystemTest")
   }
 }
 
+TEST_CASE("CachedDiskFileSystemTest")
+{
+  auto env = makeTestEnvironment();
+
+  auto fs = CachedDiskFileSystem{env.dir()};
+  const auto diskFS = DiskFileSystem{env.dir()};
+
+  SECTION("pathInfo")
+  {
+    for (const auto& path : {
+           "..",
+           ".",
+           "anotherDir",
+           "anotherDir/./subDirTest/..",
+           "ANOTHerDir",
+           "test.txt",
+           "./test.txt",
+           "anotherDir/./subDirTest/../subDirTest/test2.map",
+           "ANOtherDir/test3.MAP",
+           "anotherDir/whatever.txt",
+           "test.txt/whatever.txt",
+         })
+    {
+      CAPTURE(path);
+      CHECK(fs.pathInfo(path) == diskFS.pathInfo(path));
+    }
+  }
+
+  SECTION("find")
+  {
+    CHECK(fs.find("..", TraversalMode::Flat) == diskFS.find("..", TraversalMode::Flat));
+    CHECK_THAT(
+      fs.find(".", TraversalMode::Flat),
+      MatchesPathsResult({
+        "anotherDir",
+        "dir1",
+        "dir2",
+        "test.txt",
+        "test2.map",
+      }));
+    CHECK_THAT(
+      fs.find("ANOTHERDIR", TraversalMode::Flat),
+      MatchesPathsResult({
+        "anotherDir/subDirTest",
+        "anotherDir/test3.map",
+      }));
+    CHECK_THAT(
+      fs.find(".", TraversalMode::Recursive),
+      MatchesPathsResult({
+        "anotherDir",
+        "anotherDir/subDirTest",
+        "anotherDir/subDirTest/test2.map",
+        "anotherDir/test3.map",
+        "dir1",
+        "dir2",
+        "test.txt",
+        "test2.map",
+      }));
+  }
+
+  SECTION("openFile")
+  {
+    const auto file = fs.openFile("ANOTHERDIR/test3.map").value();
+    CHECK(file->reader().readString(file->size()) == "//yet another test file\n{}");
+  }
+
+  SECTION("refresh")
+  {
+    REQUIRE(fs.pathInfo("dir1/test.txt") == PathInfo::Unknown);
+
+    env.createFile("dir1/test.txt", "some content");
+    CHECK(fs.pathInfo("dir1/test.txt") == PathInfo::Unknown);
+    CHECK_THAT(fs.find("dir1", TraversalMode::Flat), MatchesPathsResult({}));
+
+    fs.refresh();
+    CHECK(fs.pathInfo("dir1/test.txt") == PathInfo::File);
+    CHECK_THAT(
+      fs.find("dir1", TraversalMode::Flat), MatchesPathsResult({"dir1/test.txt"}));
+  }
+}
+
 TEST_CASE("WritableDiskFileSystemTest")
 {
   SECTION("createWritableDiskFileSystem")
@@ -225,6 +225,26 @@ TEST_CASE("DiskIO")
     CHECK(file.is_success());
   }
 
+  SECTION("mapFile")
+  {
+    CHECK(
+      Disk::mapFile(env.dir() / "does_not_exist.txt")
+      == Result<std::shared_ptr<MappedFile>>{Error{
+        "Failed to open '" + (env.dir() / "does_not_exist.txt").string()
+        + "': path does not denote a file"}});
+
+    auto file = Disk::mapFile(env.dir() / "test.txt");
+    REQUIRE(file.is_success());
+    CHECK(file.value()->size() == 12);
+    CHECK(file.value()->reader().buffer().stringView() == "some content");
+
+    // buffering a mapped file does not copy its contents
+    CHECK(file.value()->reader().buffer().begin() == file.value()->begin());
+
+    file = Disk::mapFile(env.dir() / "anotherDir/subDirTest/test2.map");
+    CHECK(file.is_success());
+  }
+
   SECTION("withStream")
   {
     SECTION("withInputStream")
@@ -0,0 +1,281 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/DecalDefinition.h"
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "Assets/PropertyDefinition.h"
+#include "Color.h"
+#include "EL/Expression.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/ELParser.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/FgdParser.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+const auto DefaultColor = Color{0.5f, 0.5f, 0.5f, 1.0f};
+
+const auto BaseFgd = R"(
+@BaseClass = Targetable
+[
+  targetname(target_source) : "Name"
+  spawnflags(flags) =
+  [
+    1 : "Deaf" : 0
+    2 : "Silent" : 1 : "Makes no sound"
+  ]
+]
+)";
+
+const auto MainFgd = R"(
+@include "base.fgd"
+
+@PointClass base(Targetable) color(255 0 0) size(-16 -16 -24, 16 16 32)
+  model({{ spawnflags & 1 -> ":progs/a.mdl", { "path": ":progs/b.mdl", "skin": 1 } }})
+  = item_health : "Health"
+[
+  count(integer) : "Count" : 25
+  speed(float) : "Speed" : "1.5"
+  style(choices) : "Style" : 0 =
+  [
+    0 : "Normal"
+    1 : "Rotten"
+  ]
+  message(string) : "Message"
+  other(somethingelse) : "Unknown"
+]
+
+@SolidClass base(Targetable) = func_door : "Door" []
+)";
+
+using EntityDefinitionList = std::vector<std::unique_ptr<Assets::EntityDefinition>>;
+
+std::string writeCache(
+  const EntityDefinitionList& definitions,
+  const std::vector<std::filesystem::path>& dependencies,
+  const std::string& key,
+  const FileSystem& fs)
+{
+  auto str = std::stringstream{};
+  REQUIRE(writeEntityDefinitionCache(definitions, dependencies, key, fs, str)
+            .is_success());
+  return str.str();
+}
+
+auto readCache(const std::string& cache, const std::string& key, const FileSystem& fs)
+{
+  return readEntityDefinitionCache(
+    Reader::from(cache.data(), cache.data() + cache.size()), key, fs);
+}
+
+EntityDefinitionList parseDefinitions(
+  const std::filesystem::path& path, std::vector<std::filesystem::path>& includedFiles)
+{
+  auto status = TestParserStatus{};
+  auto parser = FgdParser{MainFgd, DefaultColor, path};
+  auto definitions = parser.parseDefinitions(status);
+  includedFiles = parser.includedFiles();
+  return definitions;
+}
+
+template <typename T>
+const T& propertyDefinition(
+  const Assets::EntityDefinition& definition, const std::string& key)
+{
+  const auto* result = dynamic_cast<const T*>(definition.propertyDefinition(key));
+  REQUIRE(result != nullptr);
+  return *result;
+}
+} // namespace
+
+TEST_CASE("EntityDefinitionCache")
+{
+  auto env = TestEnvironment{[](auto& e) {
+    e.createFile("main.fgd", MainFgd);
+    e.createFile("base.fgd", BaseFgd);
+  }};
+  auto fs = DiskFileSystem{env.dir()};
+
+  auto includedFiles = std::vector<std::filesystem::path>{};
+  const auto definitions = parseDefinitions(env.dir() / "main.fgd", includedFiles);
+  REQUIRE(definitions.size() == 2);
+  REQUIRE(includedFiles == std::vector<std::filesystem::path>{"base.fgd"});
+
+  const auto key = entityDefinitionCacheKey("main.fgd", fs, DefaultColor).value();
+  const auto cache = writeCache(definitions, includedFiles, key, fs);
+
+  SECTION("Reading the cache restores the entity definitions")
+  {
+    const auto cachedDefinitions = readCache(cache, key, fs).value();
+    REQUIRE(cachedDefinitions.size() == 2);
+
+    const auto& pointDefinition =
+      dynamic_cast<const Assets::PointEntityDefinition&>(*cachedDefinitions[0]);
+    const auto& originalPointDefinition =
+      dynamic_cast<const Assets::PointEntityDefinition&>(*definitions[0]);
+    CHECK(pointDefinition.name() == "item_health");
+    CHECK(pointDefinition.description() == "Health");
+    CHECK(pointDefinition.color() == Color{1.0f, 0.0f, 0.0f, 1.0f});
+    CHECK(pointDefinition.bounds() == originalPointDefinition.bounds());
+    CHECK(
+      pointDefinition.modelDefinition() == originalPointDefinition.modelDefinition());
+    CHECK(
+      pointDefinition.decalDefinition() == originalPointDefinition.decalDefinition());
+
+    // the locations are kept for error messages
+    const auto& modelExpression = pointDefinition.modelDefinition().expression();
+    const auto& originalModelExpression =
+      originalPointDefinition.modelDefinition().expression();
+    CHECK(modelExpression.line() == originalModelExpression.line());
+    CHECK(modelExpression.column() == originalModelExpression.column());
+
+    CHECK(
+      pointDefinition.propertyDefinitions().size()
+      == originalPointDefinition.propertyDefinitions().size());
+    for (const auto& originalPropertyDefinition : definitions[0]->propertyDefinitions())
+    {
+      const auto* propertyDefinition =
+        pointDefinition.propertyDefinition(originalPropertyDefinition->key());
+      REQUIRE(propertyDefinition != nullptr);
+      CHECK(propertyDefinition->equals(originalPropertyDefinition.get()));
+      CHECK(
+        propertyDefinition->shortDescription()
+        == originalPropertyDefinition->shortDescription());
+      CHECK(
+        Assets::PropertyDefinition::defaultValue(*propertyDefinition)
+        == Assets::PropertyDefinition::defaultValue(*originalPropertyDefinition));
+    }
+
+    CHECK(
+      propertyDefinition<Assets::IntegerPropertyDefinition>(pointDefinition, "count")
+        .defaultValue()
+      == 25);
+    CHECK(
+      propertyDefinition<Assets::FloatPropertyDefinition>(pointDefinition, "speed")
+        .defaultValue()
+      == 1.5f);
+    CHECK(
+      propertyDefinition<Assets::ChoicePropertyDefinition>(pointDefinition, "style")
+        .options()
+      == Assets::ChoicePropertyOption::List{{"0", "Normal"}, {"1", "Rotten"}});
+    CHECK_FALSE(
+      propertyDefinition<Assets::StringPropertyDefinition>(pointDefinition, "message")
+        .hasDefaultValue());
+    CHECK(
+      propertyDefinition<Assets::UnknownPropertyDefinition>(pointDefinition, "other")
+        .shortDescription()
+      == "Unknown");
+
+    const auto& spawnflags =
+      propertyDefinition<Assets::FlagsPropertyDefinition>(pointDefinition, "spawnflags");
+    CHECK(
+      spawnflags.options()
+      == Assets::FlagsPropertyOption::List{
+        {1, "Deaf", "", false},
+        {2, "Silent", "Makes no sound", true},
+      });
+
+    const auto& brushDefinition = *cachedDefinitions[1];
+    CHECK(brushDefinition.type() == Assets::EntityDefinitionType::BrushEntity);
+    CHECK(brushDefinition.name() == "func_door");
+    CHECK(brushDefinition.color() == DefaultColor);
+
+    // inherited property definitions are still shared
+    CHECK(
+      brushDefinition.propertyDefinition("targetname")
+      == pointDefinition.propertyDefinition("targetname"));
+  }
+
+  SECTION("An undefined model expression is restored")
+  {
+    auto pointDefinitions = EntityDefinitionList{};
+    pointDefinitions.push_back(std::make_unique<Assets::PointEntityDefinition>(
+      "info_null",
+      DefaultColor,
+      vm::bbox3{8.0},
+      "",
+      std::vector<std::shared_ptr<Assets::PropertyDefinition>>{},
+      Assets::ModelDefinition{},
+      Assets::DecalDefinition{}));
+
+    const auto cachedDefinitions =
+      readCache(writeCache(pointDefinitions, {}, key, fs), key, fs).value();
+    REQUIRE(cachedDefinitions.size() == 1);
+
+    const auto& pointDefinition =
+      dynamic_cast<const Assets::PointEntityDefinition&>(*cachedDefinitions[0]);
+    CHECK(pointDefinition.modelDefinition() == Assets::ModelDefinition{});
+  }
+
+  SECTION("The cache is not read if the definition file has changed")
+  {
+    env.createFile("main.fgd", "");
+    const auto newKey = entityDefinitionCacheKey("main.fgd", fs, DefaultColor).value();
+    CHECK(newKey != key);
+    CHECK(readCache(cache, newKey, fs).is_error());
+  }
+
+  SECTION("The cache is not read if the default color has changed")
+  {
+    const auto newKey =
+      entityDefinitionCacheKey("main.fgd", fs, Color{1.0f, 1.0f, 1.0f, 1.0f}).value();
+    CHECK(newKey != key);
+    CHECK(readCache(cache, newKey, fs).is_error());
+  }
+
+  SECTION("The cache is not read if an included file has changed")
+  {
+    env.createFile("base.fgd", "");
+    CHECK(readCache(cache, key, fs).is_error());
+  }
+
+  SECTION("The cache is not read if an included file is missing")
+  {
+    std::filesystem::remove(env.dir() / "base.fgd");
+    CHECK(readCache(cache, key, fs).is_error());
+  }
+
+  SECTION("A truncated cache is not read")
+  {
+    CHECK(readCache(cache.substr(0, cache.size() - 1), key, fs).is_error());
+  }
+}
+
+} // namespace TrenchBroom::IO
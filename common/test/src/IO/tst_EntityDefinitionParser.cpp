@@ -1117,5 +1117,153 @@ TEST_CASE("resolveInheritance")
     CHECK(status.countStatus(LogLevel::Warn) == 0u);
     CHECK(status.countStatus(LogLevel::Error) == 0u);
   }
+
+  SECTION("missingSuperClass")
+  {
+    const auto input = std::vector<EntityDefinitionClassInfo>{
+      {EntityDefinitionClassType::BaseClass,
+       0,
+       0,
+       "base",
+       "base",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"missing"}},
+      {EntityDefinitionClassType::PointClass,
+       0,
+       0,
+       "point1",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"base"}},
+      {EntityDefinitionClassType::PointClass,
+       0,
+       0,
+       "point2",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"base"}},
+    };
+    const auto expected = std::vector<EntityDefinitionClassInfo>{
+      {EntityDefinitionClassType::PointClass,
+       0,
+       0,
+       "point1",
+       "base",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"base"}},
+      {EntityDefinitionClassType::PointClass,
+       0,
+       0,
+       "point2",
+       "base",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"base"}},
+    };
+
+    // the error is reported for every class that inherits from the base class
+    auto status = TestParserStatus{};
+    CHECK_THAT(resolveInheritance(status, input), Catch::UnorderedEquals(expected));
+    CHECK(status.countStatus(LogLevel::Warn) == 0u);
+    CHECK(status.countStatus(LogLevel::Error) == 2u);
+  }
+
+  SECTION("cyclicInheritance")
+  {
+    const auto input = std::vector<EntityDefinitionClassInfo>{
+      {EntityDefinitionClassType::BaseClass,
+       0,
+       0,
+       "base1",
+       "base1",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"base2"}},
+      {EntityDefinitionClassType::BaseClass,
+       0,
+       0,
+       "base2",
+       std::nullopt,
+       Color{1, 2, 3},
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"base1"}},
+      {EntityDefinitionClassType::PointClass,
+       0,
+       0,
+       "point",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"base1"}},
+      {EntityDefinitionClassType::BrushClass,
+       0,
+       0,
+       "brush",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {}},
+    };
+    const auto expected = std::vector<EntityDefinitionClassInfo>{
+      {EntityDefinitionClassType::PointClass,
+       0,
+       0,
+       "point",
+       "base1",
+       Color{1, 2, 3},
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {"base1"}},
+      {EntityDefinitionClassType::BrushClass,
+       0,
+       0,
+       "brush",
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       std::nullopt,
+       {},
+       {}},
+    };
+
+    auto status = TestParserStatus{};
+    CHECK_THAT(resolveInheritance(status, input), Catch::UnorderedEquals(expected));
+    CHECK(status.countStatus(LogLevel::Warn) == 0u);
+    CHECK(status.countStatus(LogLevel::Error) == 1u);
+  }
 }
 } // namespace TrenchBroom::IO
@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "IO/FontCache.h"
+#include "IO/Reader.h"
+#include "Renderer/FontDescriptor.h"
+#include "Renderer/FontGlyph.h"
+#include "Renderer/FontGlyphBuilder.h"
+#include "Renderer/FontTexture.h"
+#include "Renderer/TextureFont.h"
+
+#include "kdl/result.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+std::unique_ptr<Renderer::TextureFont> makeFont()
+{
+  const auto firstChar = static_cast<unsigned char>('a');
+  const auto charCount = static_cast<unsigned char>(3);
+
+  auto texture = std::make_unique<Renderer::FontTexture>(charCount, 8, 3);
+  auto glyphBuilder = Renderer::FontGlyphBuilder{6, 8, 3, *texture};
+
+  auto glyphs = std::vector<Renderer::FontGlyph>{};
+  for (size_t i = 0; i < charCount; ++i)
+  {
+    const auto bitmap = std::string(4 * 5, char('0' + i));
+    glyphs.push_back(glyphBuilder.createGlyph(1, 5, 4, 5, 5 + i, bitmap.data(), 4));
+  }
+
+  return std::make_unique<Renderer::TextureFont>(
+    std::move(texture), glyphs, 6, 2, 9, firstChar, charCount);
+}
+
+std::string writeCache(const Renderer::TextureFont& font, const std::string& key)
+{
+  auto str = std::stringstream{};
+  writeFontCache(font, key, str);
+  return str.str();
+}
+
+auto readCache(const std::string& cache, const std::string& key)
+{
+  return readFontCache(Reader::from(cache.data(), cache.data() + cache.size()), key);
+}
+} // namespace
+
+TEST_CASE("FontCache")
+{
+  SECTION("fontCacheKey")
+  {
+    const auto font = Renderer::FontDescriptor{"fonts/font.ttf", 12};
+    const auto key = fontCacheKey("font data", font);
+    CHECK(fontCacheKey("font data", font) == key);
+
+    CHECK(fontCacheKey("other font data", font) != key);
+    CHECK(
+      fontCacheKey("font data", Renderer::FontDescriptor{"fonts/font.ttf", 13}) != key);
+    CHECK(
+      fontCacheKey("font data", Renderer::FontDescriptor{"fonts/font.ttf", 12, 'a', 'z'})
+      != key);
+  }
+
+  SECTION("fontCachePath")
+  {
+    const auto font = Renderer::FontDescriptor{"fonts/font.ttf", 12};
+    CHECK(fontCachePath("cache", font) == fontCachePath("cache", font));
+    CHECK(
+      fontCachePath("cache", font)
+      != fontCachePath("cache", Renderer::FontDescriptor{"fonts/font.ttf", 13}));
+  }
+
+  SECTION("roundTrip")
+  {
+    const auto font = makeFont();
+    const auto key = std::string{"some key"};
+    const auto cache = writeCache(*font, key);
+
+    SECTION("Cached font matches rasterized font")
+    {
+      const auto cachedFont = readCache(cache, key).value();
+      CHECK(*cachedFont == *font);
+    }
+
+    SECTION("Key mismatch")
+    {
+      CHECK(readCache(cache, "some other key").is_error());
+    }
+
+    SECTION("Truncated cache")
+    {
+      for (const auto size : {size_t(0), size_t(3), cache.size() / 2, cache.size() - 1})
+      {
+        CAPTURE(size);
+        CHECK(readCache(cache.substr(0, size), key).is_error());
+      }
+    }
+  }
+}
+
+} // namespace TrenchBroom::IO
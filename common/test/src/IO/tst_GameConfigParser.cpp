@@ -70,6 +70,38 @@ TEST_CASE("GameConfigParserTest.parseEmptyConfig")
   CHECK_THROWS_AS(parser.parse(), ParserException);
 }
 
+TEST_CASE("GameConfigParserTest.parseHeader")
+{
+  const std::string config(R"(
+{
+    "version": 7,
+    "name": "Quake",
+    "icon": "Icon.png",
+    "experimental": true,
+    "fileformats": [
+        { "format": "Standard" },
+        { "format": "Valve", "initialmap": "initial_valve.map" }
+    ],
+    "filesystem": {},
+    "textures": {},
+    "entities": {}
+}
+)");
+
+  CHECK(
+    GameConfigParser(config, "/games/Quake/GameConfig.cfg").parseHeader()
+    == Model::GameConfigHeader{
+      "Quake",
+      "/games/Quake/GameConfig.cfg",
+      "Icon.png",
+      true,
+      {
+        {"Standard", {}},
+        {"Valve", "initial_valve.map"},
+      },
+    });
+}
+
 TEST_CASE("GameConfigParserTest.parseQuakeConfig")
 {
   const std::string config(R"(
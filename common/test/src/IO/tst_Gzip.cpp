@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "IO/Gzip.h"
+
+#include "kdl/result.h"
+
+#include <sstream>
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+std::string gzip(const std::string& str)
+{
+  auto stream = std::stringstream{};
+  {
+    auto buffer = GzipStreamBuffer{stream};
+    auto gzipStream = std::ostream{&buffer};
+    gzipStream << str;
+    REQUIRE(buffer.finish().is_success());
+  }
+  return stream.str();
+}
+} // namespace
+
+TEST_CASE("Gzip.isGzipPath")
+{
+  CHECK(isGzipPath("maps/test.map.gz"));
+  CHECK(isGzipPath("maps/test.map.GZ"));
+  CHECK_FALSE(isGzipPath("maps/test.map"));
+  CHECK_FALSE(isGzipPath("maps/gz"));
+}
+
+TEST_CASE("Gzip.roundTrip")
+{
+  const auto str = GENERATE(
+    std::string{},
+    std::string{"{\n\"classname\" \"worldspawn\"\n}\n"},
+    // spans several chunks
+    [] {
+      auto result = std::string{};
+      for (size_t i = 0; i < 200000; ++i)
+      {
+        result += "( " + std::to_string(i) + " -64 16 ) ( 64 -64 16 ) ( 64 -64 -16 )\n";
+      }
+      return result;
+    }());
+
+  const auto compressed = gzip(str);
+  CHECK(isGzipped(compressed));
+  CHECK(gunzip(compressed) == Result<std::string>{str});
+}
+
+TEST_CASE("Gzip.gunzip")
+{
+  SECTION("Skips optional header fields")
+  {
+    // gzip -c of "test\n" with the original file name "test"
+    const auto compressed = std::string{
+      "\x1f\x8b\x08\x08\x00\x00\x00\x00\x00\x03test\x00+I-.\xe1\x02\x00\xc6\x35\xb9\x3b"
+      "\x05\x00\x00\x00",
+      30};
+    CHECK(gunzip(compressed) == Result<std::string>{"test\n"});
+  }
+
+  SECTION("Rejects invalid data")
+  {
+    const auto compressed = gzip("some map contents");
+    CHECK_FALSE(isGzipped("some map contents"));
+    CHECK(gunzip("some map contents").is_error());
+
+    // truncated
+    CHECK(gunzip(compressed.substr(0, compressed.size() / 2)).is_error());
+
+    // checksum mismatch
+    auto corrupted = compressed;
+    corrupted[corrupted.size() - 5] ^= 1;
+    CHECK(gunzip(corrupted).is_error());
+  }
+}
+
+} // namespace TrenchBroom::IO
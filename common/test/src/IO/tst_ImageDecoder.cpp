@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/File.h"
+#include "IO/ImageDecoder.h"
+#include "IO/Reader.h"
+
+#include "kdl/result.h"
+
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+template <typename F>
+auto decode(const std::string& name, const F& decoder)
+{
+  auto diskFS =
+    DiskFileSystem{std::filesystem::current_path() / "fixture/test/IO/Image/"};
+
+  const auto file = diskFS.openFile(name).value();
+  auto reader = file->reader().buffer();
+  const auto* begin = reinterpret_cast<const uint8_t*>(reader.begin());
+  return decoder(begin, reader.size());
+}
+
+auto decodePng(const std::string& name)
+{
+  return decode(name, IO::decodePng);
+}
+
+auto decodeTga(const std::string& name)
+{
+  return decode(name, IO::decodeTga);
+}
+
+std::array<int, 4> pixel(const DecodedImage& image, const size_t x, const size_t y)
+{
+  const auto* p = image.buffer.data() + (y * image.width + x) * 4;
+  return {p[0], p[1], p[2], p[3]};
+}
+} // namespace
+
+TEST_CASE("ImageDecoder.decodePng")
+{
+  SECTION("Decodes true color images")
+  {
+    const auto image = decodePng("pngContentsTest.png");
+    REQUIRE(image);
+    CHECK(image->width == 64);
+    CHECK(image->height == 64);
+    CHECK(image->buffer.size() == 64 * 64 * 4);
+    CHECK_FALSE(image->masked);
+
+    CHECK(pixel(*image, 0, 0) == std::array{255, 0, 0, 255});
+    CHECK(pixel(*image, 1, 0) == std::array{161, 161, 161, 255});
+    CHECK(pixel(*image, 63, 63) == std::array{0, 255, 0, 255});
+  }
+
+  SECTION("Reverses all filter types")
+  {
+    const auto image = decodePng("filterTest.png");
+    REQUIRE(image);
+    CHECK_FALSE(image->masked);
+
+    for (size_t y = 0; y < 5; ++y)
+    {
+      for (size_t x = 0; x < 5; ++x)
+      {
+        const auto expected =
+          std::array{int(x * 50), int(y * 50), int(255 - x * 10 - y * 10), 255};
+        CHECK(pixel(*image, x, y) == expected);
+      }
+    }
+  }
+
+  SECTION("Decodes alpha")
+  {
+    const auto image = decodePng("alphaMaskTest.png");
+    REQUIRE(image);
+    CHECK(image->masked);
+    CHECK(pixel(*image, 0, 0) == std::array{0, 255, 0, 255});
+    CHECK(pixel(*image, 1, 0)[3] == 0);
+  }
+
+  SECTION("Decodes palette images with transparency")
+  {
+    const auto image = decodePng("paletteTransparencyTest.png");
+    REQUIRE(image);
+    CHECK(image->width == 4);
+    CHECK(image->height == 2);
+    CHECK(image->masked);
+
+    CHECK(pixel(*image, 0, 0) == std::array{255, 0, 0, 255});
+    CHECK(pixel(*image, 1, 0) == std::array{0, 255, 0, 255});
+    CHECK(pixel(*image, 2, 0) == std::array{0, 0, 255, 255});
+    CHECK(pixel(*image, 3, 0) == std::array{255, 255, 255, 0});
+    CHECK(pixel(*image, 0, 1) == std::array{255, 255, 255, 0});
+    CHECK(pixel(*image, 3, 1) == std::array{255, 0, 0, 255});
+  }
+
+  SECTION("Leaves unsupported or malformed images to FreeImage")
+  {
+    CHECK_FALSE(decodePng("16bitGrayscale.png"));
+    CHECK_FALSE(decodePng("corruptPngTest.png"));
+    CHECK_FALSE(decodePng("jpgContentsTest.jpg"));
+  }
+}
+
+TEST_CASE("ImageDecoder.decodeTga")
+{
+  SECTION("Decodes uncompressed images stored bottom to top")
+  {
+    const auto image = decodeTga("uncompressedTest.tga");
+    REQUIRE(image);
+    CHECK(image->width == 3);
+    CHECK(image->height == 2);
+    CHECK_FALSE(image->masked);
+
+    CHECK(pixel(*image, 0, 0) == std::array{255, 0, 0, 255});
+    CHECK(pixel(*image, 2, 0) == std::array{0, 0, 255, 255});
+    CHECK(pixel(*image, 0, 1) == std::array{10, 20, 30, 255});
+    CHECK(pixel(*image, 2, 1) == std::array{70, 80, 90, 255});
+  }
+
+  SECTION("Decodes run length encoded images stored top to bottom")
+  {
+    const auto image = decodeTga("rleTest.tga");
+    REQUIRE(image);
+    CHECK(image->width == 4);
+    CHECK(image->height == 2);
+    CHECK(image->masked);
+
+    CHECK(pixel(*image, 0, 0) == std::array{255, 0, 0, 255});
+    CHECK(pixel(*image, 3, 0) == std::array{255, 0, 0, 255});
+    CHECK(pixel(*image, 1, 1) == std::array{255, 0, 0, 255});
+    CHECK(pixel(*image, 2, 1) == std::array{0, 255, 0, 128});
+    CHECK(pixel(*image, 3, 1) == std::array{0, 0, 255, 0});
+  }
+
+  SECTION("Rejects other formats")
+  {
+    CHECK_FALSE(decodeTga("jpgContentsTest.jpg"));
+    CHECK_FALSE(decodeTga("5x5.png"));
+  }
+}
+
+TEST_CASE("ImageDecoder.decodeImage")
+{
+  CHECK(decode("5x5.png", IO::decodeImage));
+  CHECK(decode("uncompressedTest.tga", IO::decodeImage));
+  CHECK_FALSE(decode("jpgContentsTest.jpg", IO::decodeImage));
+}
+
+} // namespace TrenchBroom::IO
@@ -35,6 +35,7 @@
 #include "kdl/result.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <string>
 
@@ -216,6 +217,48 @@ TEST_CASE("loadTextureCollection")
         },
       });
   }
+
+  SECTION("loading textures on demand")
+  {
+    const auto textureConfig = Model::TextureConfig{
+      "textures",
+      {".D"},
+      "fixture/test/palette.lmp",
+      "wad",
+      "",
+      {"*-jam", "coffin2", "czg_*"},
+    };
+
+    CHECK(
+      makeInfo(loadTextureCollection(
+        "textures/cr8_czg.wad", fs, textureConfig, std::nullopt, true, logger))
+      == makeInfo(
+        loadTextureCollection("textures/cr8_czg.wad", fs, textureConfig, logger)));
+
+    auto textureCollection =
+      loadTextureCollection(
+        "textures/cr8_czg.wad", fs, textureConfig, std::nullopt, true, logger)
+        .value();
+
+    auto& textures = textureCollection.textures();
+    CHECK(std::none_of(textures.begin(), textures.end(), [](const auto& texture) {
+      return texture.loaded();
+    }));
+
+    auto& texture = textures.front();
+    CHECK(texture.buffersIfUnprepared().empty());
+    CHECK(texture.relativePath() == "textures/cr8_czg.wad/cr8_czg_1.D");
+    CHECK_FALSE(texture.requested());
+
+    texture.request();
+    CHECK(texture.requested());
+
+    texture.load();
+    CHECK(texture.loaded());
+    CHECK(texture.buffersIfUnprepared().size() == 4);
+    CHECK(texture.width() == 64);
+    CHECK(texture.height() == 64);
+  }
 }
 
 } // namespace TrenchBroom::IO
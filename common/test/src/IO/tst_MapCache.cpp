@@ -0,0 +1,205 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "IO/MapCache.h"
+#include "IO/NodeWriter.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "TestUtils.h"
+
+#include "kdl/result.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+std::string writeWorld(const Model::WorldNode& worldNode)
+{
+  auto str = std::stringstream{};
+  auto writer = NodeWriter{worldNode, str};
+  writer.writeMap();
+  return str.str();
+}
+
+std::string writeCache(const Model::WorldNode& worldNode, const std::string& key)
+{
+  auto str = std::stringstream{};
+  writeMapCache(worldNode, key, str);
+  return str.str();
+}
+
+auto readCache(const std::string& cache, const std::string& key)
+{
+  return readMapCache(
+    Reader::from(cache.data(), cache.data() + cache.size()), key, {});
+}
+} // namespace
+
+TEST_CASE("MapCache.mapCacheKey")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto key = mapCacheKey("{}", Model::MapFormat::Standard, worldBounds);
+
+  CHECK(mapCacheKey("{}", Model::MapFormat::Standard, worldBounds) == key);
+  CHECK(mapCacheKey("{ }", Model::MapFormat::Standard, worldBounds) != key);
+  CHECK(mapCacheKey("{}", Model::MapFormat::Valve, worldBounds) != key);
+  CHECK(mapCacheKey("{}", Model::MapFormat::Standard, vm::bbox3{4096.0}) != key);
+
+  CHECK(
+    mapCachePath("/some/path/map.map")
+    == std::filesystem::path{"/some/path/map.map.tbcache"});
+}
+
+TEST_CASE("MapCache.roundTrip")
+{
+  using T = std::tuple<std::string, Model::MapFormat>;
+
+  // clang-format off
+  const auto [data, mapFormat] = GENERATE(values<T>({
+{R"(// entity 0
+{
+"classname" "worldspawn"
+"message" "hello"
+"_tb_layer_color" "0.5 0.25 1"
+"_tb_layer_locked" "1"
+// brush 0
+{
+( -16 -16 -16 ) ( -16 -15 -16 ) ( -16 -16 -15 ) tex1 [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -16 -16 -16 ) ( -16 -16 -15 ) ( -15 -16 -16 ) tex2 [ 1 0 0 8 ] [ 0 0 -1 0 ] 0 1 1
+( -16 -16 -16 ) ( -15 -16 -16 ) ( -16 -15 -16 ) tex3 [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 16 16 16 ) ( 16 17 16 ) ( 17 16 16 ) tex4 [ 1 0 0 0 ] [ 0 -1 0 0 ] 45 0.5 2
+( 16 16 16 ) ( 17 16 16 ) ( 16 16 17 ) tex5 [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 16 16 16 ) ( 16 16 17 ) ( 16 17 16 ) tex6 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+// entity 1
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "7"
+"_tb_layer_sort_index" "2"
+"_tb_layer_hidden" "1"
+"_tb_layer_omit_from_export" "1"
+}
+// entity 2
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Group"
+"_tb_id" "8"
+"_tb_layer" "7"
+"_tb_linked_group_id" "link"
+"_tb_transformation" "1 0 0 32 0 1 0 0 0 0 1 0 0 0 0 1"
+// brush 0
+{
+( 0 0 0 ) ( 0 1 0 ) ( 0 0 1 ) tex1 [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 0 0 0 ) ( 0 0 1 ) ( 1 0 0 ) tex1 [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) tex1 [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 0 64 ) ( 0 64 64 ) ( 0 0 64 ) tex1 [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+}
+}
+// entity 3
+{
+"classname" "light"
+"origin" "0 0 0"
+"_tb_group" "8"
+"_tb_protected_properties" "origin"
+}
+// entity 4
+{
+"classname" "info_player_start"
+"origin" "32 32 32"
+}
+)", Model::MapFormat::Valve},
+{R"(// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -16 -16 -16 ) ( -16 -15 -16 ) ( -16 -16 -15 ) tex1 0 0 0 1 1 1 2 3.5
+( -16 -16 -16 ) ( -16 -16 -15 ) ( -15 -16 -16 ) tex2 0 0 0 1 1 0 0 0
+( -16 -16 -16 ) ( -15 -16 -16 ) ( -16 -15 -16 ) tex3 0 0 0 1 1 0 0 0
+( 16 16 16 ) ( 16 17 16 ) ( 17 16 16 ) tex4 8 4 30 0.5 2 0 0 0
+( 16 16 16 ) ( 17 16 16 ) ( 16 16 17 ) tex5 0 0 0 1 1 0 0 0
+( 16 16 16 ) ( 16 16 17 ) ( 16 17 16 ) tex6 0 0 0 1 1 0 0 0
+}
+// brush 1
+{
+patchDef2
+{
+common/caulk
+( 3 3 0 0 0 )
+(
+( (-64 -64 4 0   0 ) (-64 0 4 0   -0.25 ) (-64 64 4 0   -0.5 ) )
+( (  0 -64 4 0.2 0 ) (  0 0 4 0.2 -0.25 ) (  0 64 4 0.2 -0.5 ) )
+( ( 64 -64 4 0.4 0 ) ( 64 0 4 0.4 -0.25 ) ( 64 64 4 0.4 -0.5 ) )
+)
+}
+}
+}
+)", Model::MapFormat::Quake3},
+  }));
+  // clang-format on
+
+  CAPTURE(data, mapFormat);
+
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto status = TestParserStatus{};
+  auto reader = WorldReader{data, mapFormat, {}};
+  const auto world = reader.read(worldBounds, status);
+
+  const auto key = mapCacheKey(data, mapFormat, worldBounds);
+  const auto cache = writeCache(*world, key);
+
+  SECTION("Cached world matches parsed world")
+  {
+    const auto cachedWorld = readCache(cache, key).value();
+    CHECK(writeWorld(*cachedWorld) == writeWorld(*world));
+    Model::checkNodesMatch(*cachedWorld, *world);
+  }
+
+  SECTION("Key mismatch")
+  {
+    CHECK(readCache(cache, "some other key").is_error());
+  }
+
+  SECTION("Truncated cache")
+  {
+    for (const auto size : {size_t(0), size_t(3), cache.size() / 2, cache.size() - 1})
+    {
+      CAPTURE(size);
+      CHECK(readCache(cache.substr(0, size), key).is_error());
+    }
+  }
+}
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,164 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "IO/MapDelta.h"
+
+#include "kdl/result.h"
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+const auto Brush0 = std::string{R"(// brush 0
+{
+( -16 -16 -16 ) ( -16 -15 -16 ) ( -16 -16 -15 ) tex1 0 0 0 1 1
+( -16 -16 -16 ) ( -16 -16 -15 ) ( -15 -16 -16 ) tex1 0 0 0 1 1
+( -16 -16 -16 ) ( -15 -16 -16 ) ( -16 -15 -16 ) tex1 0 0 0 1 1
+( 16 16 16 ) ( 16 17 16 ) ( 17 16 16 ) tex1 0 0 0 1 1
+( 16 16 16 ) ( 17 16 16 ) ( 16 16 17 ) tex1 0 0 0 1 1
+( 16 16 16 ) ( 16 16 17 ) ( 16 17 16 ) tex1 0 0 0 1 1
+}
+)"};
+
+const auto Brush1 = std::string{R"(// brush 1
+{
+( 0 0 0 ) ( 0 1 0 ) ( 0 0 1 ) tex2 0 0 0 1 1
+( 0 0 0 ) ( 0 0 1 ) ( 1 0 0 ) tex2 0 0 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) tex2 0 0 0 1 1
+( 64 64 64 ) ( 64 65 64 ) ( 65 64 64 ) tex2 0 0 0 1 1
+( 64 64 64 ) ( 65 64 64 ) ( 64 64 65 ) tex2 0 0 0 1 1
+( 64 64 64 ) ( 64 64 65 ) ( 64 65 64 ) tex2 0 0 0 1 1
+}
+)"};
+
+const auto Brush1Moved = std::string{R"(// brush 1
+{
+( 8 0 0 ) ( 8 1 0 ) ( 8 0 1 ) tex2 0 0 0 1 1
+( 8 0 0 ) ( 8 0 1 ) ( 9 0 0 ) tex2 0 0 0 1 1
+( 8 0 0 ) ( 9 0 0 ) ( 8 1 0 ) tex2 0 0 0 1 1
+( 72 64 64 ) ( 72 65 64 ) ( 73 64 64 ) tex2 0 0 0 1 1
+( 72 64 64 ) ( 73 64 64 ) ( 72 64 65 ) tex2 0 0 0 1 1
+( 72 64 64 ) ( 72 64 65 ) ( 72 65 64 ) tex2 0 0 0 1 1
+}
+)"};
+
+std::string makeMap(const std::string& brushes)
+{
+  return R"(// entity 0
+{
+"classname" "worldspawn"
+)" + brushes
+         + R"(}
+// entity 1
+{
+"classname" "info_player_start"
+"origin" "32 32 32"
+}
+)";
+}
+
+std::string renumberBrush(const std::string& brush, const size_t index)
+{
+  return "// brush " + std::to_string(index) + brush.substr(brush.find('\n'));
+}
+} // namespace
+
+TEST_CASE("MapDelta.roundTrip")
+{
+  const auto base = makeMap(Brush0 + Brush1);
+
+  SECTION("Unchanged map")
+  {
+    const auto delta = makeMapDelta(base, base);
+    CHECK(delta.size() < 64);
+    CHECK(applyMapDelta(base, delta) == Result<std::string>{base});
+  }
+
+  SECTION("Changed brush")
+  {
+    const auto map = makeMap(Brush0 + Brush1Moved);
+    const auto delta = makeMapDelta(base, map);
+    CHECK(delta.size() < Brush0.size() + Brush1Moved.size());
+    CHECK(applyMapDelta(base, delta) == Result<std::string>{map});
+  }
+
+  SECTION("Added brush")
+  {
+    const auto map = makeMap(Brush0 + Brush1 + renumberBrush(Brush1Moved, 2));
+    const auto delta = makeMapDelta(base, map);
+    CHECK(delta.size() < Brush0.size() + Brush1Moved.size());
+    CHECK(applyMapDelta(base, delta) == Result<std::string>{map});
+  }
+
+  SECTION("Removed brush")
+  {
+    // the remaining brush is renumbered, but its body is still copied from the base
+    const auto map = makeMap(renumberBrush(Brush1, 0));
+    const auto delta = makeMapDelta(base, map);
+    CHECK(delta.size() < Brush1.size());
+    CHECK(applyMapDelta(base, delta) == Result<std::string>{map});
+  }
+
+  SECTION("Unrelated map")
+  {
+    const auto map = std::string{"{\n\"classname\" \"worldspawn\"\n}\n"};
+    const auto delta = makeMapDelta(base, map);
+    CHECK(applyMapDelta(base, delta) == Result<std::string>{map});
+  }
+}
+
+TEST_CASE("MapDelta.errors")
+{
+  const auto base = makeMap(Brush0 + Brush1);
+  const auto map = makeMap(Brush0 + Brush1Moved);
+  const auto delta = makeMapDelta(base, map);
+
+  SECTION("Base mismatch")
+  {
+    CHECK(applyMapDelta(makeMap(Brush0), delta).is_error());
+    CHECK(applyMapDelta(makeMap(Brush1 + Brush0), delta).is_error());
+  }
+
+  SECTION("Truncated delta")
+  {
+    for (const auto size : {size_t(0), size_t(8), delta.size() / 2, delta.size() - 1})
+    {
+      CAPTURE(size);
+      CHECK(applyMapDelta(base, delta.substr(0, size)).is_error());
+    }
+  }
+
+  SECTION("Malformed delta")
+  {
+    const auto header = delta.substr(0, delta.find('\n') + 1);
+    CHECK(applyMapDelta(base, header + "x 1 2\n").is_error());
+    CHECK(applyMapDelta(base, header + "c 0\n").is_error());
+    CHECK(applyMapDelta(base, header + "c 0 999999\n").is_error());
+    CHECK(applyMapDelta(base, header + "i 999999\n").is_error());
+    CHECK(applyMapDelta(base, "TBDELTA 2" + header.substr(9)).is_error());
+  }
+}
+
+} // namespace TrenchBroom::IO
@@ -17,15 +17,31 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Error.h"
 #include "FloatType.h"
+#include "IO/BinaryNodeSerializer.h"
 #include "IO/NodeReader.h"
+#include "IO/NodeWriter.h"
 #include "IO/TestParserStatus.h"
+#include "Model/BrushBuilder.h"
 #include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
 #include "Model/EntityProperties.h"
 #include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
 #include "Model/ParaxialTexCoordSystem.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/bbox.h"
+#include "vm/mat_ext.h"
+#include "vm/vec.h"
+
+#include <memory>
+#include <sstream>
 
 #include "Catch2.h"
 
@@ -146,5 +162,71 @@ TEST_CASE("NodeReaderTest.readScientificNotation")
   auto nodes = IO::NodeReader::read(data, MapFormat::Valve, worldBounds, {}, status);
   CHECK(nodes.size() == 1);
 }
+
+TEST_CASE("NodeReaderTest.readBinary")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto map = WorldNode{{}, {}, MapFormat::Valve};
+  auto builder = BrushBuilder{map.mapFormat(), worldBounds};
+
+  // rotated brushes have face points which cannot be written to text exactly
+  auto brush = builder.createCube(64.0, "some").value();
+  const auto rotation = vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(30.0));
+  REQUIRE(brush.transform(worldBounds, rotation, true).is_success());
+
+  auto* brushNode = new BrushNode{brush};
+  auto* entityNode = new EntityNode{Entity{{}, {{"classname", "func_detail"}}}};
+  entityNode->addChild(brushNode);
+  map.defaultLayer()->addChild(entityNode);
+
+  auto str = std::stringstream{};
+  auto writer = IO::NodeWriter{
+    map, std::make_unique<IO::BinaryNodeSerializer>(map.mapFormat(), str)};
+  writer.writeNodes({entityNode});
+  const auto data = str.str();
+
+  auto status = IO::TestParserStatus{};
+
+  SECTION("Read nodes")
+  {
+    auto nodes =
+      IO::NodeReader::readBinary(data, MapFormat::Valve, worldBounds, {}, status);
+    REQUIRE(nodes.size() == 1);
+
+    const auto* readEntityNode = dynamic_cast<const EntityNode*>(nodes.front());
+    REQUIRE(readEntityNode != nullptr);
+    CHECK(readEntityNode->entity().classname() == "func_detail");
+    REQUIRE(readEntityNode->childCount() == 1u);
+
+    const auto* readBrushNode =
+      dynamic_cast<const BrushNode*>(readEntityNode->children().front());
+    REQUIRE(readBrushNode != nullptr);
+    const auto& readBrush = readBrushNode->brush();
+    CHECK(readBrush == brush);
+    for (size_t i = 0; i < brush.faceCount(); ++i)
+    {
+      CHECK(readBrush.face(i).textureXAxis() == brush.face(i).textureXAxis());
+      CHECK(readBrush.face(i).textureYAxis() == brush.face(i).textureYAxis());
+    }
+
+    kdl::vec_clear_and_delete(nodes);
+  }
+
+  SECTION("Reject data written in a different map format")
+  {
+    CHECK(IO::NodeReader::readBinary(data, MapFormat::Standard, worldBounds, {}, status)
+            .empty());
+  }
+
+  SECTION("Reject malformed data")
+  {
+    CHECK(IO::NodeReader::readBinary(
+            data.substr(0, data.size() / 2), MapFormat::Valve, worldBounds, {}, status)
+            .empty());
+    CHECK(IO::NodeReader::readBinary("{}", MapFormat::Valve, worldBounds, {}, status)
+            .empty());
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -306,6 +306,49 @@ TEST_CASE("NodeWriterTest.writeWorldspawnWithBrushInDefaultLayer")
   CHECK(actual == expected);
 }
 
+TEST_CASE("NodeWriterTest.reuseSerializedBrushes")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto map = Model::WorldNode{{}, {}, Model::MapFormat::Standard};
+
+  auto builder = Model::BrushBuilder{map.mapFormat(), worldBounds};
+  auto* brushNode = new Model::BrushNode{builder.createCube(64.0, "none").value()};
+  map.defaultLayer()->addChild(brushNode);
+
+  const auto writeMap = [&]() {
+    auto str = std::stringstream{};
+    auto writer = NodeWriter{map, str};
+    writer.writeMap();
+    return str.str();
+  };
+
+  const auto expected = writeMap();
+  REQUIRE(brushNode->serializedNode(Model::MapFormat::Standard) != nullptr);
+  CHECK(brushNode->serializedNode(Model::MapFormat::Valve) == nullptr);
+
+  // replace the cached text to check that it is reused
+  brushNode->setSerializedNode({Model::MapFormat::Standard, "cached\n", 1});
+  CHECK(
+    writeMap()
+    == R"(// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+cached
+}
+}
+)");
+  CHECK(brushNode->lineNumber() == 5);
+  CHECK(brushNode->lineCount() == 3);
+
+  // changing the brush invalidates the cached text
+  brushNode->setBrush(builder.createCube(64.0, "none").value());
+  CHECK(brushNode->serializedNode(Model::MapFormat::Standard) == nullptr);
+  CHECK(writeMap() == expected);
+}
+
 TEST_CASE("NodeWriterTest.writeWorldspawnWithBrushInCustomLayer")
 {
   const auto worldBounds = vm::bbox3{8192.0};
@@ -390,6 +390,53 @@ f  71/1/71  80/1/80  81/1/81  72/1/72
 )");
 }
 
+TEST_CASE("ObjSerializer.writeManyBrushes")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto map = Model::WorldNode{{}, {}, Model::MapFormat::Quake3};
+
+  // one more brush than fits into a chunk
+  auto builder = Model::BrushBuilder{map.mapFormat(), worldBounds};
+  for (size_t i = 0; i < ObjSerializer::NodesPerChunk + 1u; ++i)
+  {
+    map.defaultLayer()->addChild(
+      new Model::BrushNode{builder.createCube(64.0, "some_texture").value()});
+  }
+
+  auto objStream = std::ostringstream{};
+  auto mtlStream = std::ostringstream{};
+  const auto mtlFilename = "some_file_name.mtl";
+  const auto objOptions =
+    ObjExportOptions{"/some/export/path.obj", ObjMtlPathMode::RelativeToGamePath};
+
+  auto writer = NodeWriter{
+    map, std::make_unique<ObjSerializer>(objStream, mtlStream, mtlFilename, objOptions)};
+  writer.writeMap();
+
+  const auto obj = objStream.str();
+
+  // the brushes are written in two chunks, each with their own vertex lists
+  const auto firstChunk = obj.find("# vertices\n");
+  const auto secondChunk = obj.find("# vertices\n", firstChunk + 1u);
+  REQUIRE(firstChunk != std::string::npos);
+  REQUIRE(secondChunk != std::string::npos);
+  CHECK(obj.find("# vertices\n", secondChunk + 1u) == std::string::npos);
+
+  // the indices of the second chunk continue where the first chunk left off
+  const auto lastBrush = fmt::format("o entity0_brush{}\n", ObjSerializer::NodesPerChunk);
+  CHECK(obj.find(lastBrush) > secondChunk);
+  CHECK_THAT(
+    obj.substr(obj.find(lastBrush)),
+    Catch::Matchers::StartsWith(lastBrush + R"(usemtl some_texture
+f  513/5/7  514/6/7  515/7/7  516/8/7
+)"));
+
+  CHECK(mtlStream.str() == R"(newmtl some_texture
+
+)");
+}
+
 TEST_CASE("ObjSerializer.writeRelativeMaterialPath")
 {
   const auto worldBounds = vm::bbox3{8192.0};
@@ -20,12 +20,18 @@
 #include "Assets/Quake3Shader.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Quake3ShaderCache.h"
 #include "IO/Quake3ShaderFileSystem.h"
+#include "IO/TestEnvironment.h"
 #include "IO/TraversalMode.h"
 #include "IO/VirtualFileSystem.h"
 #include "Logger.h"
 
+#include "kdl/result.h"
+
 #include <filesystem>
+#include <fstream>
 #include <memory>
 
 #include "CatchUtils/Matchers.h"
@@ -115,5 +121,97 @@ TEST_CASE("Quake3ShaderFileSystemTest.testSkipMalformedFiles")
       texturePrefix / "test/test2",
     }));
 }
+
+TEST_CASE("Quake3ShaderFileSystemTest.cache")
+{
+  auto logger = NullLogger{};
+
+  auto env = TestEnvironment{[](auto& e) {
+    e.createDirectory("scripts");
+    e.createFile(
+      "scripts/a.shader",
+      R"(textures/test/a
+{
+  surfaceparm nodraw
+  {
+    map textures/test/a.tga
+    blendfunc add
+  }
+})");
+    e.createFile("scripts/b.shader", "textures/test/b\n{\n}\n");
+  }};
+
+  const auto cachePath = env.dir() / "cache" / "shaders.tbsc";
+
+  const auto loadShader = [&](const std::filesystem::path& shaderPath) {
+    auto diskFS = DiskFileSystem{env.dir()};
+    auto shaderFS = createImageFileSystem<Quake3ShaderFileSystem>(
+                      diskFS,
+                      "scripts",
+                      std::vector<std::filesystem::path>{},
+                      logger,
+                      cachePath)
+                      .value();
+    return shaderFS->openFile(shaderPath)
+      .transform([](auto file) {
+        return std::dynamic_pointer_cast<ObjectFile<Assets::Quake3Shader>>(file)
+          ->object();
+      })
+      .value();
+  };
+
+  const auto readCache = [&]() {
+    return Disk::mapFile(cachePath)
+      .and_then([](auto file) { return readQuake3ShaderCache(file->reader()); })
+      .value();
+  };
+
+  const auto writeCache = [&](const Quake3ShaderCache& cache) {
+    auto stream = std::ofstream{cachePath, std::ios::out | std::ios::binary};
+    writeQuake3ShaderCache(cache, stream);
+  };
+
+  const auto shader = loadShader("textures/test/a");
+  CHECK(shader.surfaceParms == std::set<std::string>{"nodraw"});
+
+  auto cache = readCache();
+  REQUIRE(cache.size() == 2);
+  REQUIRE(cache.count("scripts/a.shader") == 1);
+  REQUIRE(cache.count("scripts/b.shader") == 1);
+  CHECK(cache["scripts/a.shader"].shaders == std::vector<Assets::Quake3Shader>{shader});
+
+  SECTION("Unchanged scripts are read from the cache")
+  {
+    cache["scripts/a.shader"].shaders.front().surfaceParms = {"cached"};
+    writeCache(cache);
+
+    CHECK(loadShader("textures/test/a").surfaceParms == std::set<std::string>{"cached"});
+  }
+
+  SECTION("Changed scripts are parsed again")
+  {
+    cache["scripts/a.shader"].shaders.front().surfaceParms = {"cached"};
+    writeCache(cache);
+
+    env.createFile("scripts/a.shader", "textures/test/a\n{\n  surfaceparm trans\n}\n");
+    CHECK(loadShader("textures/test/a").surfaceParms == std::set<std::string>{"trans"});
+    CHECK(readCache().at("scripts/a.shader").shaders.front().surfaceParms
+          == std::set<std::string>{"trans"});
+  }
+
+  SECTION("Malformed scripts are not cached")
+  {
+    env.createFile("scripts/c.shader", "textures/test/c\n{\n}}\n");
+    loadShader("textures/test/a");
+    CHECK(readCache().count("scripts/c.shader") == 0);
+  }
+
+  SECTION("Removed scripts are removed from the cache")
+  {
+    std::filesystem::remove(env.dir() / "scripts/b.shader");
+    loadShader("textures/test/a");
+    CHECK(readCache().count("scripts/b.shader") == 0);
+  }
+}
 } // namespace IO
 } // namespace TrenchBroom
@@ -0,0 +1,182 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/LoadTextureCollection.h"
+#include "IO/PathInfo.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+#include "IO/VirtualFileSystem.h"
+#include "IO/WadFileSystem.h"
+#include "Logger.h"
+#include "Model/GameConfig.h"
+#include "TestUtils.h"
+
+#include "kdl/result.h"
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+/**
+ * Checks that the given collections contain the same textures, including their pixel
+ * data, which is not compared by the relational operators of Texture.
+ */
+void checkTexturesMatch(
+  const Assets::TextureCollection& actual, const Assets::TextureCollection& expected)
+{
+  CHECK(actual == expected);
+
+  const auto& actualTextures = actual.textures();
+  const auto& expectedTextures = expected.textures();
+  REQUIRE(actualTextures.size() == expectedTextures.size());
+  for (size_t i = 0; i < expectedTextures.size(); ++i)
+  {
+    CAPTURE(expectedTextures[i].name());
+    CHECK(
+      actualTextures[i].buffersIfUnprepared()
+      == expectedTextures[i].buffersIfUnprepared());
+  }
+}
+
+std::string writeCache(
+  const Assets::TextureCollection& textureCollection, const std::string& key)
+{
+  auto str = std::stringstream{};
+  writeTextureCache(textureCollection, key, str);
+  return str.str();
+}
+
+auto readCache(const std::string& cache, const std::string& key)
+{
+  return readTextureCache(Reader::from(cache.data(), cache.data() + cache.size()), key);
+}
+} // namespace
+
+TEST_CASE("TextureCache")
+{
+  auto fs = VirtualFileSystem{};
+  fs.mount("", std::make_unique<DiskFileSystem>(std::filesystem::current_path()));
+
+  const auto wadPath =
+    std::filesystem::current_path() / "fixture/test/IO/Wad/cr8_czg.wad";
+  fs.mount("textures" / wadPath.filename(), openFS<WadFileSystem>(wadPath));
+
+  const auto textureConfig = Model::TextureConfig{
+    "textures",
+    {".D"},
+    "fixture/test/palette.lmp",
+    "wad",
+    "",
+    {},
+  };
+
+  const auto collectionPath = std::filesystem::path{"textures/cr8_czg.wad"};
+  const auto texturePaths = std::vector<std::filesystem::path>{
+    "textures/cr8_czg.wad/cr8_czg_1.D",
+    "textures/cr8_czg.wad/cr8_czg_2.D",
+  };
+
+  auto logger = NullLogger{};
+
+  SECTION("textureCacheKey")
+  {
+    const auto key =
+      textureCacheKey(collectionPath, texturePaths, fs, textureConfig).value();
+    CHECK(textureCacheKey(collectionPath, texturePaths, fs, textureConfig) == key);
+
+    CHECK(
+      textureCacheKey(collectionPath, {texturePaths[0]}, fs, textureConfig) != key);
+    CHECK(textureCacheKey(collectionPath, {}, fs, textureConfig) != key);
+
+    auto otherTextureConfig = textureConfig;
+    otherTextureConfig.palette = "fixture/test/missing.lmp";
+    CHECK(
+      textureCacheKey(collectionPath, texturePaths, fs, otherTextureConfig) != key);
+
+    CHECK(textureCacheKey(
+            collectionPath, {"textures/cr8_czg.wad/missing.D"}, fs, textureConfig)
+            .is_error());
+  }
+
+  SECTION("roundTrip")
+  {
+    const auto textureCollection =
+      loadTextureCollection(collectionPath, fs, textureConfig, logger).value();
+    const auto key = std::string{"some key"};
+    const auto cache = writeCache(textureCollection, key);
+
+    SECTION("Cached textures match decoded textures")
+    {
+      const auto cachedCollection = readCache(cache, key).value();
+      checkTexturesMatch(cachedCollection, textureCollection);
+    }
+
+    SECTION("Key mismatch")
+    {
+      CHECK(readCache(cache, "some other key").is_error());
+    }
+
+    SECTION("Truncated cache")
+    {
+      for (const auto size : {size_t(0), size_t(3), cache.size() / 2, cache.size() - 1})
+      {
+        CAPTURE(size);
+        CHECK(readCache(cache.substr(0, size), key).is_error());
+      }
+    }
+  }
+
+  SECTION("loadTextureCollection")
+  {
+    auto env = TestEnvironment{};
+    const auto cacheDirectory = env.dir() / "cache";
+    const auto decodedCollection =
+      loadTextureCollection(collectionPath, fs, textureConfig, logger).value();
+
+    const auto uncachedCollection =
+      loadTextureCollection(
+        collectionPath, fs, textureConfig, cacheDirectory, false, logger)
+        .value();
+    checkTexturesMatch(uncachedCollection, decodedCollection);
+
+    const auto cachePath = textureCachePath(cacheDirectory, collectionPath);
+    REQUIRE(Disk::pathInfo(cachePath) == PathInfo::File);
+
+    const auto cachedCollection =
+      loadTextureCollection(
+        collectionPath, fs, textureConfig, cacheDirectory, false, logger)
+        .value();
+    checkTexturesMatch(cachedCollection, decodedCollection);
+  }
+}
+
+} // namespace TrenchBroom::IO
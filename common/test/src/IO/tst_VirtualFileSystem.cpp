@@ -19,6 +19,7 @@
 
 #include "Error.h"
 #include "IO/File.h"
+#include "IO/ImageFileSystem.h"
 #include "IO/TestFileSystem.h"
 #include "IO/TraversalMode.h"
 #include "IO/VirtualFileSystem.h"
@@ -28,12 +29,50 @@
 #include "kdl/result.h"
 #include "kdl/result_io.h"
 
+#include <tuple>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom
 {
 namespace IO
 {
+namespace
+{
+using TestImageFiles =
+  std::vector<std::tuple<std::filesystem::path, std::shared_ptr<File>>>;
+
+class TestImageFileSystem : public ImageFileSystem<File>
+{
+private:
+  TestImageFiles m_files;
+
+public:
+  explicit TestImageFileSystem(TestImageFiles files)
+    : ImageFileSystem{makeObjectFile(0)}
+    , m_files{std::move(files)}
+  {
+  }
+
+  void setFiles(TestImageFiles files) { m_files = std::move(files); }
+
+private:
+  Result<void> doReadDirectory() override
+  {
+    for (const auto& [path, file] : m_files)
+    {
+      addFile(path, [file = file]() { return Result<std::shared_ptr<File>>{file}; });
+    }
+    return kdl::void_success;
+  }
+};
+
+std::unique_ptr<TestImageFileSystem> makeImageFS(TestImageFiles files)
+{
+  return createImageFileSystem<TestImageFileSystem>(std::move(files)).value();
+}
+} // namespace
 
 TEST_CASE("VirtualFileSystem")
 {
@@ -519,5 +558,116 @@ TEST_CASE("VirtualFileSystem")
   }
 }
 
+TEST_CASE("VirtualFileSystem.indexedFileSystems")
+{
+  auto vfs = VirtualFileSystem{};
+
+  auto disk_foo_a = makeObjectFile(1);
+  auto disk_foo_c = makeObjectFile(2);
+  auto image1_foo_a = makeObjectFile(3);
+  auto image1_foo_b = makeObjectFile(4);
+  auto image2_foo_b = makeObjectFile(5);
+  auto image2_bar = makeObjectFile(6);
+  auto top_foo_b = makeObjectFile(7);
+
+  vfs.mount(
+    "",
+    std::make_unique<TestFileSystem>(Entry{DirectoryEntry{
+      "",
+      {
+        DirectoryEntry{
+          "foo",
+          {
+            FileEntry{"a", disk_foo_a}, // overridden by image1_foo_a
+            FileEntry{"c", disk_foo_c},
+          }},
+      }}}));
+  const auto image1Id =
+    vfs.mount("", makeImageFS({{"foo/a", image1_foo_a}, {"foo/b", image1_foo_b}}));
+  const auto image2Id = vfs.mount(
+    "nested/image", makeImageFS({{"foo/b", image2_foo_b}, {"bar", image2_bar}}));
+
+  SECTION("lookups are case insensitive")
+  {
+    CHECK(vfs.pathInfo("FOO/A") == PathInfo::File);
+    CHECK(vfs.openFile("Foo/B") == Result<std::shared_ptr<File>>{image1_foo_b});
+    CHECK(
+      vfs.openFile("NESTED/Image/foo/b") == Result<std::shared_ptr<File>>{image2_foo_b});
+  }
+
+  SECTION("indexed file systems override earlier file systems")
+  {
+    CHECK(vfs.openFile("foo/a") == Result<std::shared_ptr<File>>{image1_foo_a});
+    CHECK(vfs.openFile("foo/c") == Result<std::shared_ptr<File>>{disk_foo_c});
+    CHECK(vfs.pathInfo("foo") == PathInfo::Directory);
+    CHECK(vfs.pathInfo("nested") == PathInfo::Directory);
+    CHECK(vfs.pathInfo("nested/image") == PathInfo::Directory);
+    CHECK(vfs.pathInfo("nested/image/bar") == PathInfo::File);
+    CHECK(vfs.pathInfo("nested/image/baz") == PathInfo::Unknown);
+  }
+
+  SECTION("later file systems override indexed file systems")
+  {
+    vfs.mount(
+      "",
+      std::make_unique<TestFileSystem>(Entry{DirectoryEntry{
+        "",
+        {
+          DirectoryEntry{
+            "foo",
+            {
+              FileEntry{"b", top_foo_b},
+            }},
+        }}}));
+
+    CHECK(vfs.openFile("foo/a") == Result<std::shared_ptr<File>>{image1_foo_a});
+    CHECK(vfs.openFile("foo/b") == Result<std::shared_ptr<File>>{top_foo_b});
+  }
+
+  SECTION("unmounting an indexed file system")
+  {
+    const auto image3Id = vfs.mount("", makeImageFS({{"foo/b", image2_foo_b}}));
+    CHECK(vfs.openFile("foo/b") == Result<std::shared_ptr<File>>{image2_foo_b});
+
+    REQUIRE(vfs.unmount(image3Id));
+    CHECK(vfs.openFile("foo/b") == Result<std::shared_ptr<File>>{image1_foo_b});
+
+    REQUIRE(vfs.unmount(image1Id));
+    CHECK(vfs.openFile("foo/a") == Result<std::shared_ptr<File>>{disk_foo_a});
+    CHECK(vfs.pathInfo("foo/b") == PathInfo::Unknown);
+
+    REQUIRE(vfs.unmount(image2Id));
+    CHECK(vfs.pathInfo("nested") == PathInfo::Unknown);
+    CHECK(vfs.pathInfo("nested/image/bar") == PathInfo::Unknown);
+  }
+
+  SECTION("unmounting all file systems returns them for reuse")
+  {
+    auto mountPoints = vfs.unmountAll();
+    REQUIRE(mountPoints.size() == 3u);
+    CHECK(mountPoints[1].id == image1Id);
+    CHECK(mountPoints[2].id == image2Id);
+    CHECK(vfs.pathInfo("foo/a") == PathInfo::Unknown);
+
+    vfs.mount("", std::move(mountPoints[1].mountedFileSystem));
+    CHECK(vfs.openFile("foo/b") == Result<std::shared_ptr<File>>{image1_foo_b});
+  }
+
+  SECTION("reindexing a file system after its contents changed")
+  {
+    auto image = makeImageFS({{"baz", image2_bar}});
+    auto& imageRef = *image;
+    const auto imageId = vfs.mount("", std::move(image));
+    REQUIRE(vfs.pathInfo("baz") == PathInfo::File);
+
+    imageRef.setFiles({{"foo/c", image2_foo_b}});
+    REQUIRE(imageRef.reload().is_success());
+    vfs.reindex(imageId);
+
+    CHECK(vfs.pathInfo("baz") == PathInfo::Unknown);
+    CHECK(vfs.openFile("foo/c") == Result<std::shared_ptr<File>>{image2_foo_b});
+  }
+}
+
 } // namespace IO
 } // namespace TrenchBroom
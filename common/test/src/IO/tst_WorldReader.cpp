@@ -19,6 +19,7 @@
 
 #include "IO/DiskIO.h"
 #include "IO/File.h"
+#include "IO/StandardMapParser.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
 #include "Model/BezierPatch.h"
@@ -26,6 +27,7 @@
 #include "Model/BrushFaceAttributes.h"
 #include "Model/BrushNode.h"
 #include "Model/Entity.h"
+#include "Model/EntityProperties.h"
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
@@ -41,7 +43,9 @@
 #include <fmt/format.h>
 
 #include <filesystem>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "CatchUtils/Matchers.h"
 
@@ -266,6 +270,258 @@ TEST_CASE("WorldReader.parseMapWithWorldspawnAndOneBrush")
     != nullptr);
 }
 
+TEST_CASE("WorldReader.parseMapWithManyBrushes")
+{
+  // enough brushes to fill several batches in the brush geometry pipeline
+  const auto brushCount = size_t(1000);
+  const auto invalidBrushIndex = size_t(500);
+
+  auto data = std::string{"{\n\"classname\" \"worldspawn\"\n"};
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto x0 = double(i) * 128.0;
+    const auto x1 = x0 + 64.0;
+    data += "{\n";
+    data += fmt::format(
+      "( {0} 0 -16 ) ( {0} 0 0 ) ( {1} 0 -16 ) tex{2} 0 0 0 1 1\n"
+      "( {0} 0 -16 ) ( {0} 64 -16 ) ( {0} 0 0 ) tex{2} 0 0 0 1 1\n"
+      "( {0} 0 -16 ) ( {1} 0 -16 ) ( {0} 64 -16 ) tex{2} 0 0 0 1 1\n",
+      x0,
+      x1,
+      i);
+    // the invalid brush is missing half of its faces
+    if (i != invalidBrushIndex)
+    {
+      data += fmt::format(
+        "( {1} 64 0 ) ( {0} 64 0 ) ( {1} 64 -16 ) tex{2} 0 0 0 1 1\n"
+        "( {1} 64 0 ) ( {1} 64 -16 ) ( {1} 0 0 ) tex{2} 0 0 0 1 1\n"
+        "( {1} 64 0 ) ( {1} 0 0 ) ( {0} 64 0 ) tex{2} 0 0 0 1 1\n",
+        x0,
+        x1,
+        i);
+    }
+    data += "}\n";
+  }
+  data += "}\n";
+
+  const auto worldBounds = vm::bbox3{8192.0 * 32.0};
+
+  auto status = TestParserStatus{};
+  auto reader = WorldReader{data, Model::MapFormat::Standard, {}};
+
+  auto world = reader.read(worldBounds, status);
+
+  CHECK(status.countStatus(LogLevel::Error) == 1u);
+
+  CHECK(world->childCount() == 1u);
+  auto* defaultLayer = world->children().front();
+  REQUIRE(defaultLayer->childCount() == brushCount - 1u);
+
+  // the brushes are added in file order
+  auto lastLineNumber = size_t(0);
+  for (size_t i = 0; i < defaultLayer->childCount(); ++i)
+  {
+    const auto expectedIndex = i < invalidBrushIndex ? i : i + 1;
+    auto* brushNode = dynamic_cast<Model::BrushNode*>(defaultLayer->children()[i]);
+    REQUIRE(brushNode != nullptr);
+    CHECK(brushNode->brush().faceCount() == 6u);
+    CHECK(
+      brushNode->brush().face(0).attributes().textureName()
+      == "tex" + std::to_string(expectedIndex));
+    CHECK(brushNode->lineNumber() > lastLineNumber);
+    lastLineNumber = brushNode->lineNumber();
+  }
+}
+
+namespace
+{
+std::string makeBrush(const size_t index, const std::string& textureName)
+{
+  const auto x0 = double(index) * 128.0;
+  const auto x1 = x0 + 64.0;
+  return fmt::format(
+    R"(// brush {2}
+{{
+( {0} 0 -16 ) ( {0} 0 0 ) ( {1} 0 -16 ) {3} 0 0 0 1 1
+( {0} 0 -16 ) ( {0} 64 -16 ) ( {0} 0 0 ) {3} 0 0 0 1 1
+( {0} 0 -16 ) ( {1} 0 -16 ) ( {0} 64 -16 ) {3} 0 0 0 1 1
+( {1} 64 0 ) ( {0} 64 0 ) ( {1} 64 -16 ) {3} 0 0 0 1 1
+( {1} 64 0 ) ( {1} 64 -16 ) ( {1} 0 0 ) {3} 0 0 0 1 1
+( {1} 64 0 ) ( {1} 0 0 ) ( {0} 64 0 ) {3} 0 0 0 1 1
+}}
+)",
+    x0,
+    x1,
+    index,
+    textureName);
+}
+} // namespace
+
+TEST_CASE("WorldReader.parseMapInChunks")
+{
+  auto brushIndex = size_t(0);
+  auto data = std::string{R"(// entity 0
+{
+"classname" "worldspawn"
+"message" "a { and a } in a quoted string"
+)"};
+  for (size_t i = 0; i < 100; ++i, ++brushIndex)
+  {
+    data += makeBrush(brushIndex, i % 7 == 0 ? "{water" : "tex" + std::to_string(i));
+  }
+  data += "}\n";
+
+  for (size_t i = 0; i < 20; ++i)
+  {
+    data += fmt::format(
+      R"(// entity {0}
+{{
+"classname" "light"
+"origin" "{0} 0 0"
+}}
+)",
+      i + 1);
+  }
+
+  data += R"(// entity 21
+{
+"classname" "func_door"
+; a Heretic2 style comment containing a }
+)";
+  for (size_t i = 0; i < 20; ++i, ++brushIndex)
+  {
+    data += makeBrush(brushIndex, "door");
+  }
+  data += R"(// a comment after the last brush {
+}
+// entity 22
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "1"
+}
+// entity 23
+{
+"classname" "func_wall"
+"_tb_layer" "1"
+)";
+  data += makeBrush(brushIndex++, "wall");
+  data += "}\n";
+
+  SECTION("valid map")
+  {
+  }
+
+  SECTION("map with invalid brush")
+  {
+    data += R"(// entity 24
+{
+"classname" "func_wall"
+{
+( 0 0 -16 ) ( 0 0 0 ) ( 64 0 -16 ) tex 0 0 0 1 1
+( 0 0 -16 ) ( 0 64 -16 ) ( 0 0 0 ) tex 0 0 0 1 1
+( 0 0 -16 ) ( 64 0 -16 ) ( 0 64 -16 ) tex 0 0 0 1 1
+}
+}
+)";
+  }
+
+  SECTION("map with duplicate entity property")
+  {
+    data += R"(// entity 24
+{
+"classname" "light"
+"classname" "info_null"
+}
+)";
+  }
+
+  const auto worldBounds = vm::bbox3{8192.0 * 32.0};
+
+  auto sequentialStatus = TestParserStatus{};
+  auto sequentialReader = WorldReader{data, Model::MapFormat::Standard, {}};
+  const auto sequentialWorld = sequentialReader.read(
+    worldBounds, sequentialStatus, std::numeric_limits<size_t>::max());
+
+  for (const auto chunkSize : {size_t(256), size_t(1024), size_t(4096)})
+  {
+    CAPTURE(chunkSize);
+
+    auto status = TestParserStatus{};
+    auto reader = WorldReader{data, Model::MapFormat::Standard, {}};
+    const auto world = reader.read(worldBounds, status, chunkSize);
+
+    Model::checkNodesMatch(*world, *sequentialWorld);
+    for (const auto level : {LogLevel::Warn, LogLevel::Error})
+    {
+      CHECK(status.messages(level) == sequentialStatus.messages(level));
+    }
+  }
+}
+
+TEST_CASE("WorldReader.parseFacePointsWithUnusualFormatting")
+{
+  const auto expected = R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex1 1 2 3 4 5
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}
+})";
+
+  // same brush, but the face points are formatted such that they cannot be scanned
+  // directly and must be parsed by the tokenizer
+  const auto unusual = R"(
+{
+"classname" "worldspawn"
+{
+(-0 -0 -16)(0.0 0.0 0.0)(6.4e1 -0 -16) tex1 1 2 3 4 5
+( -0 -0
+-16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) // comment
+( 64.0000000000000000001 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( +64 +64 -.0 ) ( -0 64. -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+	( 64 64 -0 )	( 64 64 -16 )	( 64 -0 -0 )	tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}
+})";
+
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto status = TestParserStatus{};
+  auto expectedReader = WorldReader{expected, Model::MapFormat::Standard, {}};
+  auto expectedWorld = expectedReader.read(worldBounds, status);
+
+  auto unusualReader = WorldReader{unusual, Model::MapFormat::Standard, {}};
+  auto unusualWorld = unusualReader.read(worldBounds, status);
+
+  CHECK(status.countStatus(LogLevel::Error) == 0u);
+
+  const auto* expectedBrushNode = dynamic_cast<Model::BrushNode*>(
+    expectedWorld->defaultLayer()->children().front());
+  const auto* unusualBrushNode =
+    dynamic_cast<Model::BrushNode*>(unusualWorld->defaultLayer()->children().front());
+  REQUIRE(expectedBrushNode != nullptr);
+  REQUIRE(unusualBrushNode != nullptr);
+
+  const auto& expectedFaces = expectedBrushNode->brush().faces();
+  const auto& unusualFaces = unusualBrushNode->brush().faces();
+  REQUIRE(unusualFaces.size() == expectedFaces.size());
+  for (size_t i = 0; i < expectedFaces.size(); ++i)
+  {
+    CHECK(unusualFaces[i].points() == expectedFaces[i].points());
+    CHECK(
+      unusualFaces[i].attributes().textureName()
+      == expectedFaces[i].attributes().textureName());
+  }
+}
+
 TEST_CASE("WorldReader.parseMapAndCheckFaceFlags")
 {
   const auto data = R"(
@@ -411,6 +667,35 @@ TEST_CASE("WorldReader.parseValveBrush")
   checkBrushTexCoordSystem(brush, true);
 }
 
+TEST_CASE("WorldReader.convertStandardToValve")
+{
+  const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex1 1 2 3 4 5
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}
+})";
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto status = TestParserStatus{};
+  auto reader =
+    WorldReader{data, Model::MapFormat::Standard, Model::MapFormat::Valve, {}};
+
+  auto world = reader.read(worldBounds, status);
+  CHECK(world->mapFormat() == Model::MapFormat::Valve);
+
+  auto* defaultLayer = world->children().front();
+  REQUIRE(defaultLayer->childCount() == 1u);
+  auto* brush = static_cast<Model::BrushNode*>(defaultLayer->children().front());
+  checkBrushTexCoordSystem(brush, true);
+}
+
 TEST_CASE("WorldReader.parseQuake2Brush")
 {
   const auto data = R"(
@@ -1966,4 +2251,129 @@ TEST_CASE("WorldReader.parseUnknownFormatEmptyMap")
   CHECK(world->mapFormat() == Model::MapFormat::Standard);
 }
 
+TEST_CASE("WorldReader.detectFormat")
+{
+  using namespace Model;
+
+  const auto allFormats = std::vector<MapFormat>{
+    MapFormat::Standard,
+    MapFormat::Quake2,
+    MapFormat::Quake2_Valve,
+    MapFormat::Valve,
+    MapFormat::Hexen2,
+    MapFormat::Daikatana,
+    MapFormat::Quake3_Legacy,
+    MapFormat::Quake3_Valve,
+    MapFormat::Quake3,
+  };
+
+  const auto brush = [](const std::string& face) {
+    return R"(// Game: Quake
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) )"
+           + face + R"(
+}
+}
+)";
+  };
+
+  using T = std::tuple<std::string, std::vector<MapFormat>, MapFormat>;
+
+  // clang-format off
+  const auto
+  [str,                                                          candidates,  expectedFormat] = GENERATE_COPY(values<T>({
+  {brush("__TB_empty 0 0 0 1 1"),                                allFormats,  MapFormat::Standard},
+  {brush("\"some texture\" 0 0 0 1 1"),                          allFormats,  MapFormat::Standard},
+  {brush("__TB_empty 0 0 0 1 1 0"),                              allFormats,  MapFormat::Hexen2},
+  {brush("e1u1/floor 0 0 0 1 1 0 0 0"),                          allFormats,  MapFormat::Quake2},
+  {brush("e1u1/floor 0 0 0 1 1 0 0 0 255 255 255"),              allFormats,  MapFormat::Daikatana},
+  {brush("__TB_empty [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1"),           allFormats,  MapFormat::Quake2_Valve},
+  {brush("__TB_empty [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1 0 0 0"),     allFormats,  MapFormat::Quake2_Valve},
+  {brush("__TB_empty [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1"),           {MapFormat::Standard, MapFormat::Valve},
+                                                                              MapFormat::Valve},
+  {brush("__TB_empty 0 0 0 1 1"),                                {MapFormat::Quake2, MapFormat::Standard},
+                                                                              MapFormat::Quake2},
+  {brush("__TB_empty 0 0 0 1 1 0"),                              {MapFormat::Standard, MapFormat::Valve},
+                                                                              MapFormat::Unknown},
+  {R"({
+"classname" "worldspawn"
+}
+)",                                                                           allFormats,  MapFormat::Unknown},
+  {R"({
+"classname" "worldspawn"
+{
+brushDef
+{
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) ( ( 1 0 0 ) ( 0 1 0 ) ) tex 0 0 0
+}
+}
+}
+)",                                                                           allFormats,  MapFormat::Quake3},
+  {R"({
+"classname" "worldspawn"
+{
+patchDef2
+{
+common/caulk
+( 3 3 0 0 0 )
+(
+( ( 0 0 0 0 0 ) ( 0 0 0 0 0 ) ( 0 0 0 0 0 ) )
+)
+}
+}
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex 0 0 0 1 1
+}
+}
+)",                                                                           allFormats,  MapFormat::Quake3_Legacy},
+  }));
+  // clang-format on
+
+  CAPTURE(str, candidates);
+
+  CHECK(WorldReader::detectFormat(str, candidates) == expectedFormat);
+}
+
+TEST_CASE("WorldReader.readWorldspawnProperties")
+{
+  using namespace Model;
+
+  // clang-format off
+  const auto [str, expectedProperties] = GENERATE(values<std::tuple<std::string, std::vector<EntityProperty>>>({
+  {R"()",                                                   {}},
+  {R"(// Game: Quake
+// Format: Standard
+// entity 0
+{
+"classname" "worldspawn"
+// comment
+"_tb_def" "external:/defs/test.fgd"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex 0 0 0 1 1
+}
+"ignored" "value"
+}
+)",                                                         {
+                                                              {"classname", "worldspawn"},
+                                                              {"_tb_def", "external:/defs/test.fgd"},
+                                                            }},
+  {R"({ "classname" "worldspawn" "wad" "a.wad;b.wad" })",   {
+                                                              {"classname", "worldspawn"},
+                                                              {"wad", "a.wad;b.wad"},
+                                                            }},
+  {R"({ "classname" })",                                    {}},
+  {R"({ "classname" ( 0 0 0 ) })",                          {}},
+  {R"("classname" "worldspawn")",                           {}},
+  }));
+  // clang-format on
+
+  CAPTURE(str);
+
+  CHECK(readWorldspawnProperties(str) == expectedProperties);
+}
+
 } // namespace TrenchBroom::IO
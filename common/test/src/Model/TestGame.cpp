@@ -124,6 +124,11 @@ size_t TestGame::doMaxPropertyLength() const
   return 1024;
 }
 
+EntityPropertyConfig TestGame::doEntityPropertyConfig() const
+{
+  return {};
+}
+
 const std::vector<SmartTag>& TestGame::doSmartTags() const
 {
   return m_smartTags;
@@ -154,10 +159,14 @@ Result<std::unique_ptr<WorldNode>> TestGame::doLoadMap(
 Result<void> TestGame::doWriteMap(
   WorldNode& world, const std::filesystem::path& path) const
 {
-  return IO::Disk::withOutputStream(path, [&](auto& stream) {
-    IO::NodeWriter writer(world, stream);
-    writer.writeMap();
-  });
+  return IO::Disk::withOutputStream(
+    path, [&](auto& stream) { doWriteMap(world, stream); });
+}
+
+void TestGame::doWriteMap(WorldNode& world, std::ostream& stream) const
+{
+  IO::NodeWriter writer(world, stream);
+  writer.writeMap();
 }
 
 Result<void> TestGame::doExportMap(
@@ -201,18 +210,27 @@ void TestGame::doWriteBrushFacesToStream(
   writer.writeBrushFaces(faces);
 }
 
+namespace
+{
+const auto TestTextureConfig = Model::TextureConfig{
+  "textures",
+  {".D"},
+  "fixture/test/palette.lmp",
+  "wad",
+  "",
+  {},
+};
+} // namespace
+
 void TestGame::doLoadTextureCollections(Assets::TextureManager& textureManager) const
 {
-  const Model::TextureConfig textureConfig{
-    "textures",
-    {".D"},
-    "fixture/test/palette.lmp",
-    "wad",
-    "",
-    {},
-  };
+  textureManager.reload(*m_fs, TestTextureConfig);
+}
 
-  textureManager.reload(*m_fs, textureConfig);
+std::optional<size_t> TestGame::doReloadModifiedTextures(
+  Assets::TextureManager& textureManager, const std::filesystem::path& directory)
+{
+  return textureManager.reloadModifiedTextures(directory, *m_fs, TestTextureConfig);
 }
 
 const std::optional<std::string>& TestGame::doGetWadProperty() const
@@ -305,14 +323,19 @@ const std::vector<CompilationTool>& TestGame::doCompilationTools() const
 
 Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> TestGame::
   loadEntityDefinitions(
-    IO::ParserStatus& /* status */, const std::filesystem::path& /* path */) const
+    IO::ParserStatus& /* status */,
+    const std::filesystem::path& /* path */,
+    const std::optional<std::filesystem::path>& /* cacheDirectory */) const
 {
   return Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>>{
     std::vector<std::unique_ptr<Assets::EntityDefinition>>{}};
 }
 
 std::unique_ptr<Assets::EntityModel> TestGame::doInitializeModel(
-  const std::filesystem::path& /* path */, Logger& /* logger */) const
+  const std::filesystem::path& /* path */,
+  const std::optional<std::filesystem::path>& /* cacheDirectory */,
+  Assets::SkinCache* /* skinCache */,
+  Logger& /* logger */) const
 {
   return nullptr;
 }
@@ -26,6 +26,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -73,6 +74,7 @@ private:
 
   const CompilationConfig& doCompilationConfig() override;
   size_t doMaxPropertyLength() const override;
+  EntityPropertyConfig doEntityPropertyConfig() const override;
 
   const std::vector<SmartTag>& doSmartTags() const override;
 
@@ -85,6 +87,7 @@ private:
     Logger& logger) const override;
   Result<void> doWriteMap(
     WorldNode& world, const std::filesystem::path& path) const override;
+  void doWriteMap(WorldNode& world, std::ostream& stream) const override;
   Result<void> doExportMap(
     WorldNode& world, const IO::ExportOptions& options) const override;
 
@@ -108,6 +111,9 @@ private:
     std::ostream& stream) const override;
 
   void doLoadTextureCollections(Assets::TextureManager& textureManager) const override;
+  std::optional<size_t> doReloadModifiedTextures(
+    Assets::TextureManager& textureManager,
+    const std::filesystem::path& directory) override;
 
   const std::optional<std::string>& doGetWadProperty() const override;
   void doReloadWads(
@@ -135,10 +141,15 @@ private:
   const std::vector<CompilationTool>& doCompilationTools() const override;
 
   Result<std::vector<std::unique_ptr<Assets::EntityDefinition>>> loadEntityDefinitions(
-    IO::ParserStatus& status, const std::filesystem::path& path) const override;
+    IO::ParserStatus& status,
+    const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory) const override;
 
   std::unique_ptr<Assets::EntityModel> doInitializeModel(
-    const std::filesystem::path& path, Logger& logger) const override;
+    const std::filesystem::path& path,
+    const std::optional<std::filesystem::path>& cacheDirectory,
+    Assets::SkinCache* skinCache,
+    Logger& logger) const override;
   void doLoadFrame(
     const std::filesystem::path& path,
     size_t frameIndex,
@@ -31,6 +31,7 @@
 #include "Model/BrushNode.h"
 #include "Model/Entity.h"
 #include "Model/Polyhedron.h"
+#include "Model/TexCoordSystem.h"
 #include "TestUtils.h"
 
 #include "kdl/intrusive_circular_list.h"
@@ -123,6 +124,245 @@ TEST_CASE("BrushTest.constructBrushWithRedundantFaces")
           .is_error());
 }
 
+TEST_CASE("BrushTest.compactGeometry")
+{
+  const vm::bbox3 worldBounds(4096.0);
+  const BrushBuilder builder(MapFormat::Standard, worldBounds);
+
+  const auto original = builder.createCube(64.0, "texture").value();
+  auto brush = builder.createCube(64.0, "texture").value();
+
+  brush.compactGeometry();
+  CHECK(brush.hasCompactGeometry());
+
+  // these are answered without rebuilding the geometry
+  CHECK(brush.bounds() == original.bounds());
+  CHECK(brush.vertexCount() == original.vertexCount());
+  CHECK(brush.faceCount() == original.faceCount());
+  CHECK(brush.hasCompactGeometry());
+
+  SECTION("Copying keeps the compact geometry")
+  {
+    auto copy = brush;
+    CHECK(copy.hasCompactGeometry());
+    CHECK(copy == original);
+  }
+
+  SECTION("Accessing the faces rebuilds the geometry")
+  {
+    CHECK(brush.faces() == original.faces());
+    CHECK_FALSE(brush.hasCompactGeometry());
+    CHECK(brush.fullySpecified());
+    CHECK(brush.edgeCount() == original.edgeCount());
+    for (const auto& face : original.faces())
+    {
+      CHECK(brush.hasFace(face.polygon()));
+    }
+  }
+
+  SECTION("Vertex operations rebuild the geometry")
+  {
+    const auto vertex = vm::vec3(32.0, 32.0, 32.0);
+    REQUIRE(brush.canMoveVertices(worldBounds, {vertex}, vm::vec3(16.0, 16.0, 16.0)));
+    CHECK(brush.moveVertices(worldBounds, {vertex}, vm::vec3(16.0, 16.0, 16.0))
+            .is_success());
+    CHECK_FALSE(brush.hasCompactGeometry());
+    CHECK(brush.hasVertex(vm::vec3(48.0, 48.0, 48.0)));
+  }
+}
+
+TEST_CASE("BrushTest.copySharesGeometry")
+{
+  const vm::bbox3 worldBounds(4096.0);
+  const BrushBuilder builder(MapFormat::Standard, worldBounds);
+
+  const auto original = builder.createCube(64.0, "texture").value();
+
+  auto copy = original;
+  CHECK(copy.sharesGeometryWith(original));
+
+  SECTION("Copied faces are linked to the shared geometry")
+  {
+    REQUIRE(copy.faceCount() == original.faceCount());
+    for (size_t i = 0; i < copy.faceCount(); ++i)
+    {
+      const auto& face = copy.face(i);
+      REQUIRE(face.geometry() != nullptr);
+      CHECK(face.geometry() == original.face(i).geometry());
+      CHECK(face.vertexCount() == 4u);
+      CHECK(face.vertices().size() == 4u);
+      CHECK(face.vertexPositions() == original.face(i).vertexPositions());
+    }
+  }
+
+  SECTION("Changing face attributes keeps the geometry shared")
+  {
+    for (auto& face : copy.faces())
+    {
+      auto attributes = face.attributes();
+      attributes.setTextureName("other");
+      face.setAttributes(attributes);
+    }
+
+    CHECK(copy.sharesGeometryWith(original));
+    CHECK(copy.faces() != original.faces());
+    CHECK(original.face(0).attributes().textureName() == "texture");
+    CHECK(copy.fullySpecified());
+  }
+
+  SECTION("Changing the geometry unshares it")
+  {
+    REQUIRE(
+      copy.transform(worldBounds, vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)), false)
+        .is_success());
+
+    CHECK_FALSE(copy.sharesGeometryWith(original));
+    CHECK(original.bounds() == vm::bbox3(32.0));
+    CHECK(copy.bounds() == vm::bbox3(32.0).translate(vm::vec3(16.0, 0.0, 0.0)));
+  }
+
+  SECTION("Shared geometry is not compacted")
+  {
+    copy.compactGeometry();
+    CHECK_FALSE(copy.hasCompactGeometry());
+  }
+}
+
+TEST_CASE("BrushTest.compactCopy")
+{
+  const vm::bbox3 worldBounds(4096.0);
+  const BrushBuilder builder(MapFormat::Standard, worldBounds);
+
+  const auto original = builder.createCube(64.0, "texture").value();
+
+  auto copy = original.compactCopy();
+  CHECK(copy.hasCompactGeometry());
+  CHECK_FALSE(copy.sharesGeometryWith(original));
+  CHECK_FALSE(original.hasCompactGeometry());
+  CHECK(copy == original);
+
+  SECTION("Transforming a compact brush keeps its geometry compact")
+  {
+    const auto transformation = GENERATE(values<vm::mat4x4>({
+      vm::translation_matrix(vm::vec3{16, 8, -4}),
+      vm::rotation_matrix(0.0, 0.0, vm::to_radians(90.0)),
+      vm::mirror_matrix<FloatType>(vm::axis::x),
+    }));
+
+    auto expected = original;
+    REQUIRE(expected.transform(worldBounds, transformation, true).is_success());
+
+    auto transformed = copy;
+    REQUIRE(transformed.transform(worldBounds, transformation, true).is_success());
+    CHECK(transformed.hasCompactGeometry());
+    CHECK(transformed.bounds() == expected.bounds());
+
+    CHECK(transformed.faces() == expected.faces());
+    CHECK(transformed.fullySpecified());
+    for (const auto& face : expected.faces())
+    {
+      CHECK(transformed.hasFace(face.polygon()));
+    }
+  }
+}
+
+TEST_CASE("BrushTest.transformAxisAligned")
+{
+  const vm::bbox3 worldBounds(4096.0);
+  const BrushBuilder builder(MapFormat::Standard, worldBounds);
+
+  const auto original =
+    builder.createCuboid(vm::bbox3{{0, 0, 0}, {64, 32, 16}}, "texture").value();
+
+  const auto transformation = GENERATE(values<vm::mat4x4>({
+    vm::translation_matrix(vm::vec3{16, 8, -4}),
+    vm::translation_matrix(vm::vec3{0.5, 0, 0}),
+    vm::rotation_matrix(0.0, 0.0, vm::to_radians(90.0)),
+    vm::translation_matrix(vm::vec3{8, 0, 0})
+      * vm::rotation_matrix(vm::to_radians(180.0), 0.0, 0.0),
+    vm::mirror_matrix<FloatType>(vm::axis::x),
+    vm::mirror_matrix<FloatType>(vm::axis::z)
+      * vm::rotation_matrix(0.0, vm::to_radians(-90.0), 0.0),
+  }));
+
+  CAPTURE(transformation);
+
+  auto expectedFaces = original.faces();
+  for (auto& face : expectedFaces)
+  {
+    REQUIRE(face.transform(transformation, false).is_success());
+  }
+  const auto expected = Brush::create(worldBounds, std::move(expectedFaces)).value();
+
+  auto brush = original;
+  REQUIRE(brush.transform(worldBounds, transformation, false).is_success());
+
+  CHECK(brush.bounds() == expected.bounds());
+  CHECK_THAT(brush.vertexPositions(), Catch::UnorderedEquals(expected.vertexPositions()));
+  REQUIRE(brush.faceCount() == expected.faceCount());
+
+  for (const auto& face : brush.faces())
+  {
+    REQUIRE(face.geometry() != nullptr);
+
+    const auto expectedFaceIndex = expected.findFace(face.boundary());
+    REQUIRE(expectedFaceIndex);
+
+    const auto& expectedFace = expected.face(*expectedFaceIndex);
+    CHECK_THAT(
+      face.vertexPositions(), Catch::UnorderedEquals(expectedFace.vertexPositions()));
+
+    // the face geometry has the same orientation as the rebuilt geometry
+    const auto orientation = [](const auto& f) {
+      const auto vertices = f.vertexPositions();
+      const auto normal = vm::cross(vertices[1] - vertices[0], vertices[2] - vertices[0]);
+      return vm::dot(normal, f.normal()) > 0.0;
+    };
+    CHECK(orientation(face) == orientation(expectedFace));
+  }
+}
+
+TEST_CASE("BrushTest.transformWithSharedTexCoordSystemTransformation")
+{
+  const vm::bbox3 worldBounds(4096.0);
+
+  const auto mapFormat = GENERATE(MapFormat::Standard, MapFormat::Valve);
+  const auto lockTextures = GENERATE(false, true);
+  const BrushBuilder builder(mapFormat, worldBounds);
+
+  const auto original =
+    builder.createCuboid(vm::bbox3{{0, 0, 0}, {64, 32, 16}}, "texture").value();
+
+  const auto transformation = GENERATE(values<vm::mat4x4>({
+    vm::translation_matrix(vm::vec3{16, 8, -4}),
+    vm::rotation_matrix(0.0, 0.0, vm::to_radians(90.0)),
+    vm::translation_matrix(vm::vec3{8, 0, 0})
+      * vm::rotation_matrix(vm::to_radians(15.0), vm::to_radians(30.0), 0.0),
+    vm::scaling_matrix(vm::vec3{2, 1, 0.5}),
+  }));
+
+  CAPTURE(mapFormat, lockTextures, transformation);
+
+  auto expected = original;
+  REQUIRE(expected.transform(worldBounds, transformation, lockTextures).is_success());
+
+  const auto texCoordSystemTransformation = TexCoordSystemTransformation{transformation};
+  auto brush = original;
+  REQUIRE(
+    brush.transform(worldBounds, texCoordSystemTransformation, lockTextures)
+      .is_success());
+
+  REQUIRE(brush.faceCount() == expected.faceCount());
+  for (size_t i = 0; i < brush.faceCount(); ++i)
+  {
+    const auto& face = brush.face(i);
+    const auto& expectedFace = expected.face(i);
+    CHECK(face.boundary() == expectedFace.boundary());
+    CHECK(face.attributes() == expectedFace.attributes());
+    CHECK(face.texCoordSystem() == expectedFace.texCoordSystem());
+  }
+}
+
 TEST_CASE("BrushTest.clip")
 {
   const vm::bbox3 worldBounds(4096.0);
@@ -1294,6 +1534,44 @@ TEST_CASE("BrushTest.moveVerticesPastWorldBounds")
     brush.canMoveVertices(worldBounds, allVertexPositions, vm::vec3(8192, 0, 0)));
 }
 
+TEST_CASE("BrushTest.prepareMoveVertices")
+{
+  const vm::bbox3 worldBounds(4096.0);
+  const BrushBuilder builder(MapFormat::Standard, worldBounds);
+
+  const Brush cube = builder.createCube(64.0, "texture").value();
+
+  SECTION("Prepared move is applied without changes")
+  {
+    // moving all but one vertex inverts the move internally
+    const auto vertexPositions = kdl::vec_erase(
+      cube.vertexPositions(), vm::vec3(-32.0, -32.0, -32.0));
+    const auto delta = vm::vec3(16.0, 16.0, 16.0);
+
+    auto move = cube.prepareMoveVertices(worldBounds, vertexPositions, delta);
+    REQUIRE(move.is_success());
+    CHECK(move.value().vertexPositions == vertexPositions);
+    CHECK(move.value().delta == delta);
+
+    auto preparedBrush = cube;
+    REQUIRE(preparedBrush.applyVertexMove(worldBounds, move.value()).is_success());
+
+    auto movedBrush = cube;
+    REQUIRE(movedBrush.moveVertices(worldBounds, vertexPositions, delta).is_success());
+
+    CHECK_THAT(
+      preparedBrush.vertexPositions(),
+      Catch::UnorderedEquals(movedBrush.vertexPositions()));
+  }
+
+  SECTION("Impossible move returns an error")
+  {
+    const auto move =
+      cube.prepareMoveVertices(worldBounds, cube.vertexPositions(), vm::vec3(8192, 0, 0));
+    CHECK(move.is_error());
+  }
+}
+
 static void assertCanMoveVertices(
   Brush brush, const std::vector<vm::vec3> vertexPositions, const vm::vec3 delta)
 {
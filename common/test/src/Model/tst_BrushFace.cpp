@@ -63,8 +63,7 @@ TEST_CASE("BrushFaceTest.constructWithValidPoints")
 
   const BrushFaceAttributes attribs("");
   BrushFace face =
-    BrushFace::create(
-      p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs))
+    BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem{p0, p1, p2, attribs})
       .value();
   CHECK(face.points()[0] == vm::approx(p0));
   CHECK(face.points()[1] == vm::approx(p1));
@@ -81,8 +80,7 @@ TEST_CASE("BrushFaceTest.constructWithColinearPoints")
 
   const BrushFaceAttributes attribs("");
   CHECK_FALSE(
-    BrushFace::create(
-      p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs))
+    BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem{p0, p1, p2, attribs})
       .is_success());
 }
 
@@ -100,13 +98,9 @@ TEST_CASE("BrushFaceTest.textureUsageCount")
   BrushFaceAttributes attribs("");
   {
     // test constructor
-    BrushFace face = BrushFace::create(
-                       p0,
-                       p1,
-                       p2,
-                       attribs,
-                       std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs))
-                       .value();
+    BrushFace face =
+      BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem{p0, p1, p2, attribs})
+        .value();
     CHECK(texture.usageCount() == 0u);
 
     // test setTexture
@@ -1208,5 +1208,49 @@ TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testGroupedNodes")
     CHECK(context.selectable(entityNode) == selectable);
   }
 }
+
+TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.cachedState")
+{
+  auto [groupNode, brushNode] = createGroupedBrush();
+
+  CHECK(context.visible(groupNode));
+  CHECK(context.visible(brushNode));
+  CHECK(context.editable(brushNode));
+  CHECK(context.selectable(groupNode));
+  CHECK_FALSE(context.selectable(brushNode));
+
+  brushNode->setVisibilityState(VisibilityState::Hidden);
+  brushNode->setLockState(LockState::Locked);
+
+  SECTION("State is cached until it is invalidated")
+  {
+    CHECK(context.visible(groupNode));
+    CHECK(context.visible(brushNode));
+    CHECK(context.editable(brushNode));
+
+    context.invalidateCachedState();
+
+    CHECK_FALSE(context.visible(groupNode));
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.editable(brushNode));
+  }
+
+  SECTION("Changing the editor context invalidates the cached state")
+  {
+    context.pushGroup(groupNode);
+
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.editable(brushNode));
+    CHECK_FALSE(context.selectable(brushNode));
+  }
+
+  SECTION("Cached state is not shared between editor contexts")
+  {
+    auto otherContext = EditorContext{};
+    CHECK_FALSE(otherContext.visible(groupNode));
+    CHECK_FALSE(otherContext.visible(brushNode));
+    CHECK_FALSE(otherContext.editable(brushNode));
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
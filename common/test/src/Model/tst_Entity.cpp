@@ -729,4 +729,39 @@ TEST_CASE("EntityTest")
     }
   }
 }
+
+TEST_CASE("EntityPropertyTest")
+{
+  SECTION("Interns values of classname and target properties")
+  {
+    const auto p1 = EntityProperty{EntityPropertyKeys::Classname, "light"};
+    const auto p2 = EntityProperty{EntityPropertyKeys::Classname, "light"};
+    const auto p3 = EntityProperty{EntityPropertyKeys::Origin, "1 2 3"};
+
+    CHECK(p1.hasInternedValue());
+    CHECK(&p1.value() == &p2.value());
+    CHECK(p1 == p2);
+
+    CHECK_FALSE(p3.hasInternedValue());
+    CHECK(p3.value() == "1 2 3");
+  }
+
+  SECTION("setKey interns or releases the value")
+  {
+    auto property = EntityProperty{EntityPropertyKeys::Origin, "some_name"};
+    REQUIRE_FALSE(property.hasInternedValue());
+
+    property.setKey(EntityPropertyKeys::Targetname);
+    CHECK(property.hasInternedValue());
+    CHECK(property.value() == "some_name");
+
+    property.setValue("other_name");
+    CHECK(property.hasInternedValue());
+    CHECK(property.value() == "other_name");
+
+    property.setKey("message");
+    CHECK_FALSE(property.hasInternedValue());
+    CHECK(property.value() == "other_name");
+  }
+}
 } // namespace TrenchBroom::Model
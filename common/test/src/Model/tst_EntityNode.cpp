@@ -148,6 +148,58 @@ TEST_CASE("EntityNodeTest.area")
   CHECK(entityNode.projectedArea(vm::axis::z) == 2.0);
 }
 
+TEST_CASE("EntityNodeTest.setDefinitions")
+{
+  auto definition1 = Assets::PointEntityDefinition(
+    "some_name",
+    Color(),
+    vm::bbox3(vm::vec3::zero(), vm::vec3(1.0, 2.0, 3.0)),
+    "",
+    {},
+    {},
+    {});
+  auto definition2 = Assets::PointEntityDefinition(
+    "other_name",
+    Color(),
+    vm::bbox3(vm::vec3::zero(), vm::vec3(4.0, 5.0, 6.0)),
+    "",
+    {},
+    {},
+    {});
+
+  auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
+  auto* entityNode1 = new EntityNode{Entity{}};
+  auto* entityNode2 = new EntityNode{Entity{}};
+  auto* groupNode = new GroupNode{Group{"group"}};
+  groupNode->addChild(entityNode2);
+  worldNode.defaultLayer()->addChildren({entityNode1, groupNode});
+
+  entityNode1->setDefinition(&definition1);
+
+  EntityNodeBase::setDefinitions({
+    {entityNode1, &definition1},
+    {entityNode2, &definition2},
+  });
+
+  CHECK(entityNode1->entity().definition() == &definition1);
+  CHECK(entityNode2->entity().definition() == &definition2);
+  CHECK(definition1.usageCount() == 1u);
+  CHECK(definition2.usageCount() == 1u);
+  CHECK(entityNode2->logicalBounds() == definition2.bounds());
+  CHECK(groupNode->logicalBounds() == definition2.bounds());
+
+  EntityNodeBase::setDefinitions({
+    {entityNode1, nullptr},
+    {entityNode2, &definition1},
+  });
+
+  CHECK(entityNode1->entity().definition() == nullptr);
+  CHECK(entityNode2->entity().definition() == &definition1);
+  CHECK(definition1.usageCount() == 1u);
+  CHECK(definition2.usageCount() == 0u);
+  CHECK(groupNode->logicalBounds() == definition1.bounds());
+}
+
 static const std::string TestClassname = "something";
 
 class EntityNodeTest
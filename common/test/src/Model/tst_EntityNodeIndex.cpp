@@ -156,6 +156,45 @@ TEST_CASE("EntityNodeIndexTest.removeProperty")
   delete entity2;
 }
 
+TEST_CASE("EntityNodeIndexTest.updatePropertyValue")
+{
+  EntityNodeIndex index;
+
+  EntityNode* entity1 = new EntityNode({}, {{"_color", "1 0 0"}});
+  EntityNode* entity2 = new EntityNode({}, {{"_color", "1 0 0"}});
+
+  index.addEntityNode(entity1);
+  index.addEntityNode(entity2);
+
+  // updates are applied in bulk when the index is queried
+  entity1->setEntity(Entity({}, {{"_color", "0 1 0"}}));
+  index.updatePropertyValue(entity1, "1 0 0", "0 1 0");
+  index.updatePropertyValue(entity2, "1 0 0", "0 1 0");
+  entity2->setEntity(Entity({}, {{"_color", "0 0 1"}}));
+  index.updatePropertyValue(entity2, "0 1 0", "0 0 1");
+
+  CHECK(findExactExact(index, "_color", "1 0 0").empty());
+  CHECK(
+    findExactExact(index, "_color", "0 1 0") == std::vector<EntityNodeBase*>{entity1});
+  CHECK(
+    findExactExact(index, "_color", "0 0 1") == std::vector<EntityNodeBase*>{entity2});
+  CHECK_THAT(
+    index.findEntityNodes(EntityNodeIndexQuery::exact("_color")),
+    Catch::UnorderedEquals(std::vector<EntityNodeBase*>{entity1, entity2}));
+
+  index.removeProperty(entity1, "_color", "0 1 0");
+  index.addProperty(entity1, "_color", "0 1 0");
+  index.removeEntityNode(entity2);
+
+  CHECK(
+    findExactExact(index, "_color", "0 1 0") == std::vector<EntityNodeBase*>{entity1});
+  CHECK(findExactExact(index, "_color", "0 0 1").empty());
+  CHECK(index.allKeys() == std::vector<std::string>{"_color"});
+
+  delete entity1;
+  delete entity2;
+}
+
 TEST_CASE("EntityNodeIndexTest.addNumberedEntityProperty")
 {
   EntityNodeIndex index;
@@ -223,5 +262,30 @@ TEST_CASE("EntityNodeIndexTest.allValuesForKeys")
     index.allValuesForKeys(EntityNodeIndexQuery::exact("test")),
     Catch::UnorderedEquals(std::vector<std::string>{"somevalue", "somevalue2"}));
 }
+
+TEST_CASE("EntityNodeIndexTest.findEntityNodesWithKey")
+{
+  EntityNodeIndex index;
+
+  EntityNode* entity1 = new EntityNode({}, {{"target", "a"}});
+  EntityNode* entity2 = new EntityNode({}, {{"target2", "b"}, {"other", "c"}});
+  EntityNode* entity3 = new EntityNode({}, {{"other", "a"}});
+
+  index.addEntityNode(entity1);
+  index.addEntityNode(entity2);
+  index.addEntityNode(entity3);
+
+  CHECK_THAT(
+    index.findEntityNodes(EntityNodeIndexQuery::numbered("target")),
+    Catch::UnorderedEquals(std::vector<EntityNodeBase*>{entity1, entity2}));
+  CHECK_THAT(
+    index.findEntityNodes(EntityNodeIndexQuery::exact("other")),
+    Catch::UnorderedEquals(std::vector<EntityNodeBase*>{entity2, entity3}));
+  CHECK(index.findEntityNodes(EntityNodeIndexQuery::exact("missing")).empty());
+
+  delete entity1;
+  delete entity2;
+  delete entity3;
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Error.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/FilePositionIndex.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/result.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Model
+{
+
+TEST_CASE("FilePositionIndex.findChildren")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+  const auto createBrushNode = [&](const size_t lineNumber, const size_t lineCount) {
+    auto* brushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+    brushNode->setFilePosition(lineNumber, lineCount);
+    return brushNode;
+  };
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* layerNode = worldNode.defaultLayer();
+
+  auto* brushNode1 = createBrushNode(2, 5);
+  auto* brushNode2 = createBrushNode(7, 5);
+  auto* entityNode = new EntityNode{Entity{}};
+  entityNode->setFilePosition(12, 15);
+  auto* entityBrushNode1 = createBrushNode(14, 5);
+  auto* entityBrushNode2 = createBrushNode(19, 5);
+  // a new node that has never been saved
+  auto* newBrushNode = createBrushNode(0, 0);
+
+  entityNode->addChildren({entityBrushNode2, entityBrushNode1});
+  layerNode->addChildren({entityNode, newBrushNode, brushNode2, brushNode1});
+
+  const auto index = FilePositionIndex{worldNode};
+
+  using Nodes = std::vector<Node*>;
+  CHECK(index.findChildren(*layerNode, {}) == Nodes{});
+  CHECK(index.findChildren(*layerNode, {0}) == Nodes{});
+  CHECK(index.findChildren(*layerNode, {1}) == Nodes{});
+  CHECK(index.findChildren(*layerNode, {2}) == Nodes{brushNode1});
+  CHECK(index.findChildren(*layerNode, {6}) == Nodes{brushNode1});
+  CHECK(index.findChildren(*layerNode, {7}) == Nodes{brushNode2});
+  CHECK(index.findChildren(*layerNode, {20}) == Nodes{entityNode});
+  CHECK(index.findChildren(*layerNode, {27}) == Nodes{});
+  CHECK(index.findChildren(*layerNode, {20, 3, 4}) == Nodes{brushNode1, entityNode});
+
+  CHECK(index.findChildren(*entityNode, {13}) == Nodes{});
+  CHECK(index.findChildren(*entityNode, {20}) == Nodes{entityBrushNode2});
+  CHECK(
+    index.findChildren(*entityNode, {14, 23})
+    == Nodes{entityBrushNode1, entityBrushNode2});
+
+  CHECK(index.findChildren(*brushNode1, {2}) == Nodes{});
+
+  SECTION("Overlapping file positions")
+  {
+    // edited nodes may have stale file positions
+    auto* overlappingBrushNode = createBrushNode(1, 10);
+    layerNode->addChild(overlappingBrushNode);
+
+    const auto overlappingIndex = FilePositionIndex{worldNode};
+    CHECK(
+      overlappingIndex.findChildren(*layerNode, {8})
+      == Nodes{overlappingBrushNode, brushNode2});
+    CHECK(overlappingIndex.findChildren(*layerNode, {11}) == Nodes{brushNode2});
+  }
+}
+
+} // namespace TrenchBroom::Model
@@ -21,11 +21,14 @@
 #include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskIO.h"
+#include "IO/ExportOptions.h"
 #include "IO/GameConfigParser.h"
+#include "IO/TestEnvironment.h"
 #include "Logger.h"
 #include "Model/EntityNode.h"
 #include "Model/GameConfig.h"
 #include "Model/GameImpl.h"
+#include "Model/LayerNode.h"
 #include "Model/WorldNode.h"
 #include "TestUtils.h"
 
@@ -83,6 +86,60 @@ TEST_CASE("GameTest.newMap")
   }
 }
 
+TEST_CASE("GameTest.exportMap")
+{
+  auto logger = NullLogger();
+
+  const auto configPath =
+    std::filesystem::current_path() / "fixture/games/Quake/GameConfig.cfg";
+  const auto configStr = IO::readTextFile(configPath);
+  auto configParser = IO::GameConfigParser{configStr, configPath};
+  auto config = configParser.parse();
+
+  const auto gamePath = std::filesystem::current_path() / "fixture/test/Model/Game/Quake";
+  auto game = GameImpl{config, gamePath, logger};
+
+  auto world = game.newMap(MapFormat::Valve, vm::bbox3{8192.0}, logger).value();
+
+  auto testEnvironment = IO::TestEnvironment{};
+  const auto exportPath = testEnvironment.dir() / "exported.map";
+  const auto options = IO::MapExportOptions{exportPath};
+
+  REQUIRE(game.exportMap(*world, options).is_success());
+  const auto exported = testEnvironment.loadFile("exported.map");
+  CHECK(!exported.empty());
+
+  // backdate the file so that we can tell whether it was written again
+  const auto oldWriteTime =
+    std::filesystem::last_write_time(exportPath) - std::chrono::hours{1};
+  std::filesystem::last_write_time(exportPath, oldWriteTime);
+
+  SECTION("Unchanged map is not written again")
+  {
+    REQUIRE(game.exportMap(*world, options).is_success());
+    CHECK(std::filesystem::last_write_time(exportPath) == oldWriteTime);
+    CHECK(testEnvironment.loadFile("exported.map") == exported);
+  }
+
+  SECTION("Changed map is written again")
+  {
+    world->defaultLayer()->addChild(new EntityNode{Entity{{}, {{"classname", "light"}}}});
+
+    REQUIRE(game.exportMap(*world, options).is_success());
+    CHECK(std::filesystem::last_write_time(exportPath) != oldWriteTime);
+    CHECK(testEnvironment.loadFile("exported.map") != exported);
+  }
+
+  SECTION("Modified file is written again")
+  {
+    testEnvironment.createFile("exported.map", "// modified");
+    std::filesystem::last_write_time(exportPath, oldWriteTime);
+
+    REQUIRE(game.exportMap(*world, options).is_success());
+    CHECK(testEnvironment.loadFile("exported.map") == exported);
+  }
+}
+
 TEST_CASE("GameTest.loadCorruptPackages")
 {
   // https://github.com/TrenchBroom/TrenchBroom/issues/2496
@@ -41,6 +41,7 @@
 #include "vm/mat_io.h"
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include "Catch2.h"
@@ -170,4 +171,94 @@ TEST_CASE("GroupNode.canRemoveChild")
   CHECK(groupNode.canRemoveChild(&patchNode));
 }
 
+TEST_CASE("GroupNode.updateBounds")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+  const auto createBrush = [&](const vm::bbox3d& bounds) {
+    return builder.createCuboid(bounds, "texture").value();
+  };
+
+  auto outerGroupNode = GroupNode{Group{"outer"}};
+  auto* innerGroupNode = new GroupNode{Group{"inner"}};
+  auto* innerBrushNode = new BrushNode{createBrush({{0, 0, 0}, {64, 64, 64}})};
+  auto* outerBrushNode = new BrushNode{createBrush({{32, 32, 32}, {128, 128, 128}})};
+
+  innerGroupNode->addChild(innerBrushNode);
+  outerGroupNode.addChildren({innerGroupNode, outerBrushNode});
+
+  REQUIRE(innerGroupNode->logicalBounds() == vm::bbox3d{{0, 0, 0}, {64, 64, 64}});
+  REQUIRE(outerGroupNode.logicalBounds() == vm::bbox3d{{0, 0, 0}, {128, 128, 128}});
+
+  SECTION("Growing a child grows its ancestors")
+  {
+    innerBrushNode->setBrush(createBrush({{-32, 0, 0}, {64, 64, 64}}));
+    CHECK(innerGroupNode->logicalBounds() == vm::bbox3d{{-32, 0, 0}, {64, 64, 64}});
+    CHECK(outerGroupNode.logicalBounds() == vm::bbox3d{{-32, 0, 0}, {128, 128, 128}});
+  }
+
+  SECTION("Changing a child within its ancestor's bounds")
+  {
+    innerBrushNode->setBrush(createBrush({{0, 0, 0}, {32, 32, 32}}));
+    CHECK(innerGroupNode->logicalBounds() == vm::bbox3d{{0, 0, 0}, {32, 32, 32}});
+    CHECK(outerGroupNode.logicalBounds() == vm::bbox3d{{0, 0, 0}, {128, 128, 128}});
+  }
+
+  SECTION("Shrinking a child shrinks its ancestors")
+  {
+    innerBrushNode->setBrush(createBrush({{16, 16, 16}, {64, 64, 64}}));
+    CHECK(innerGroupNode->logicalBounds() == vm::bbox3d{{16, 16, 16}, {64, 64, 64}});
+    CHECK(outerGroupNode.logicalBounds() == vm::bbox3d{{16, 16, 16}, {128, 128, 128}});
+
+    outerBrushNode->setBrush(createBrush({{32, 32, 32}, {96, 96, 96}}));
+    CHECK(outerGroupNode.logicalBounds() == vm::bbox3d{{16, 16, 16}, {96, 96, 96}});
+  }
+}
+
+TEST_CASE("GroupNode.changeTracking")
+{
+  auto groupNode = GroupNode{Group{"group"}};
+  auto* nestedGroupNode = new GroupNode{Group{"nested"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  groupNode.addChildren({nestedGroupNode, entityNode});
+
+  // adding children is a structural change
+  CHECK_FALSE(groupNode.canUpdateLinkedGroupsIncrementally());
+  CHECK(groupNode.changedDescendants().empty());
+
+  groupNode.resetChangeTracking();
+  CHECK_FALSE(groupNode.canUpdateLinkedGroupsIncrementally());
+
+  SECTION("Changing a descendant")
+  {
+    entityNode->setEntity(Entity{{}, {{"some_key", "some_value"}}});
+    CHECK(groupNode.canUpdateLinkedGroupsIncrementally());
+    CHECK(groupNode.changedDescendants() == std::unordered_set<Node*>{entityNode});
+  }
+
+  SECTION("Changing a nested group")
+  {
+    nestedGroupNode->setGroup(Group{"new name"});
+    CHECK(groupNode.canUpdateLinkedGroupsIncrementally());
+    CHECK(groupNode.changedDescendants() == std::unordered_set<Node*>{nestedGroupNode});
+  }
+
+  SECTION("Adding a descendant after changing a descendant")
+  {
+    entityNode->setEntity(Entity{{}, {{"some_key", "some_value"}}});
+    nestedGroupNode->addChild(new EntityNode{Entity{}});
+    CHECK_FALSE(groupNode.canUpdateLinkedGroupsIncrementally());
+    CHECK(groupNode.changedDescendants().empty());
+  }
+
+  SECTION("Removing a descendant")
+  {
+    groupNode.removeChild(entityNode);
+    auto removedEntityNode = std::unique_ptr<EntityNode>{entityNode};
+    CHECK_FALSE(groupNode.canUpdateLinkedGroupsIncrementally());
+  }
+}
+
 } // namespace TrenchBroom::Model
@@ -161,6 +161,68 @@ TEST_CASE("GroupNode.updateLinkedGroups")
   }
 }
 
+TEST_CASE("GroupNode.updateLinkedGroupsIncrementally")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto groupNode = GroupNode{Group{"name"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* otherEntityNode = new EntityNode{Entity{}};
+  groupNode.addChildren({entityNode, otherEntityNode});
+
+  auto groupNodeClone = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds, SetLinkId::keep))};
+  transformNode(*groupNodeClone, vm::translation_matrix(vm::vec3{0, 2, 0}), worldBounds);
+
+  auto* clonedEntityNode = static_cast<EntityNode*>(groupNodeClone->children().front());
+  REQUIRE(clonedEntityNode->entity().origin() == vm::vec3{0, 2, 0});
+
+  groupNode.resetChangeTracking();
+  REQUIRE_FALSE(groupNode.canUpdateLinkedGroupsIncrementally());
+
+  transformNode(*entityNode, vm::translation_matrix(vm::vec3{0, 0, 3}), worldBounds);
+  REQUIRE(groupNode.canUpdateLinkedGroupsIncrementally());
+
+  SECTION("Only changed nodes are updated")
+  {
+    updateLinkedGroupsIncrementally(groupNode, {groupNodeClone.get()}, worldBounds)
+      .transform([&](const IncrementalUpdateLinkedGroupsResult& r) {
+        CHECK(r.groupsToUpdateFully.empty());
+        REQUIRE(r.nodesToSwap.size() == 1u);
+
+        const auto& [nodeToUpdate, newContents] = r.nodesToSwap.front();
+        CHECK(nodeToUpdate == clonedEntityNode);
+        CHECK(std::get<Entity>(newContents.get()).origin() == vm::vec3{0, 2, 3});
+      })
+      .transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Target groups without corresponding nodes are updated fully")
+  {
+    setLinkId(*clonedEntityNode, "some other link ID");
+
+    updateLinkedGroupsIncrementally(groupNode, {groupNodeClone.get()}, worldBounds)
+      .transform([&](const IncrementalUpdateLinkedGroupsResult& r) {
+        CHECK(r.nodesToSwap.empty());
+        CHECK(r.groupsToUpdateFully == std::vector<GroupNode*>{groupNodeClone.get()});
+      })
+      .transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Exceeding world bounds is an error")
+  {
+    transformNode(
+      *groupNodeClone, vm::translation_matrix(vm::vec3{8192 - 8, 0, 0}), worldBounds);
+    transformNode(*entityNode, vm::translation_matrix(vm::vec3{1, 0, 0}), worldBounds);
+
+    updateLinkedGroupsIncrementally(groupNode, {groupNodeClone.get()}, worldBounds)
+      .transform([](auto) { FAIL(); })
+      .transform_error([](auto e) {
+        CHECK(e == Error{"Updating a linked node would exceed world bounds"});
+      });
+  }
+}
+
 TEST_CASE("GroupNode.updateNestedLinkedGroups")
 {
   const auto worldBounds = vm::bbox3{8192.0};
@@ -28,10 +28,12 @@
 #include "Model/EntityNode.h"
 #include "Model/Group.h"
 #include "Model/GroupNode.h"
+#include "Model/Issue.h"
 #include "Model/Layer.h"
 #include "Model/LayerNode.h"
 #include "Model/LockState.h"
 #include "Model/MapFormat.h"
+#include "Model/MissingClassnameValidator.h"
 #include "Model/ModelUtils.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
@@ -340,6 +342,90 @@ TEST_CASE("ModelUtils.collectContainedNodes")
       std::vector<Node*>{&groupNode, &entityNode, &brushNode, &patchNode}));
 }
 
+TEST_CASE("ModelUtils.collectTouchingAndContainedNodesInWorld")
+{
+  using Catch::Matchers::UnorderedEquals;
+
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+
+  auto* groupNode = new GroupNode{Group{"group"}};
+  auto* groupedBrushNode = new BrushNode{
+    builder.createCuboid(vm::bbox3d{{-64, -64, -64}, {-32, -32, -32}}, "texture")
+      .value()};
+  auto* brushEntityNode = new EntityNode{Entity{}};
+  auto* entityBrushNode = new BrushNode{
+    builder.createCuboid(vm::bbox3d{{32, 32, 32}, {64, 64, 64}}, "texture").value()};
+  auto* brushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+  auto* distantBrushNode = new BrushNode{
+    builder.createCuboid(vm::bbox3d{{1024, 0, 0}, {1088, 64, 64}}, "texture").value()};
+  auto* queryNode = new BrushNode{builder.createCube(160.0, "texture").value()};
+  auto* smallQueryNode = new BrushNode{builder.createCube(16.0, "texture").value()};
+
+  groupNode->addChild(groupedBrushNode);
+  brushEntityNode->addChild(entityBrushNode);
+
+  auto* layerNode = worldNode.defaultLayer();
+  layerNode->addChild(groupNode);
+  layerNode->addChild(brushEntityNode);
+  layerNode->addChild(brushNode);
+  layerNode->addChild(distantBrushNode);
+  layerNode->addChild(queryNode);
+  layerNode->addChild(smallQueryNode);
+
+  SECTION("Group is closed")
+  {
+    CHECK_THAT(
+      collectTouchingNodes(worldNode, {queryNode}),
+      UnorderedEquals(std::vector<Node*>{
+        groupNode, entityBrushNode, brushNode, smallQueryNode}));
+    CHECK_THAT(
+      collectContainedNodes(worldNode, {queryNode}),
+      UnorderedEquals(std::vector<Node*>{
+        groupNode, entityBrushNode, brushNode, smallQueryNode}));
+
+    CHECK_THAT(
+      collectTouchingNodes(worldNode, {smallQueryNode}),
+      UnorderedEquals(std::vector<Node*>{brushNode, queryNode}));
+    CHECK_THAT(
+      collectContainedNodes(worldNode, {smallQueryNode}),
+      UnorderedEquals(std::vector<Node*>{}));
+
+    CHECK_THAT(
+      collectTouchingNodes(worldNode, {queryNode, smallQueryNode}),
+      UnorderedEquals(std::vector<Node*>{groupNode, entityBrushNode, brushNode}));
+  }
+
+  SECTION("Group is open")
+  {
+    groupNode->open();
+
+    CHECK_THAT(
+      collectTouchingNodes(worldNode, {queryNode}),
+      UnorderedEquals(std::vector<Node*>{
+        groupedBrushNode, entityBrushNode, brushNode, smallQueryNode}));
+    CHECK_THAT(
+      collectContainedNodes(worldNode, {queryNode}),
+      UnorderedEquals(std::vector<Node*>{
+        groupedBrushNode, entityBrushNode, brushNode, smallQueryNode}));
+  }
+
+  // the results match those of searching all nodes of the world
+  for (const auto& queryNodes : std::vector<std::vector<BrushNode*>>{
+         {queryNode}, {smallQueryNode}, {queryNode, smallQueryNode}})
+  {
+    CHECK_THAT(
+      collectTouchingNodes(worldNode, queryNodes),
+      UnorderedEquals(collectTouchingNodes(std::vector<Node*>{&worldNode}, queryNodes)));
+    CHECK_THAT(
+      collectContainedNodes(worldNode, queryNodes),
+      UnorderedEquals(collectContainedNodes(std::vector<Node*>{&worldNode}, queryNodes)));
+  }
+}
+
 TEST_CASE("ModelUtils.collectSelectedNodes")
 {
   constexpr auto worldBounds = vm::bbox3d{8192.0};
@@ -649,4 +735,62 @@ TEST_CASE("ModelUtils.filterNodes")
   }
 }
 
+TEST_CASE("ModelUtils.validateIssues")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+
+  auto* layerNode = new LayerNode{Layer{"layer"}};
+  auto* groupNode = new GroupNode{Group{"group"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* brushNode = new BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "texture").value()};
+
+  groupNode->addChildren({entityNode, brushNode});
+  layerNode->addChild(groupNode);
+  worldNode.addChild(layerNode);
+
+  const auto validator = MissingClassnameValidator{};
+  const auto validators = std::vector<const Validator*>{&validator};
+
+  REQUIRE_FALSE(entityNode->issuesValid());
+
+  validateIssues({&worldNode}, validators);
+
+  CHECK(worldNode.issuesValid());
+  CHECK(layerNode->issuesValid());
+  CHECK(groupNode->issuesValid());
+  CHECK(entityNode->issuesValid());
+  CHECK(brushNode->issuesValid());
+
+  CHECK(entityNode->issues(validators).size() == 1u);
+  CHECK(brushNode->issues(validators).empty());
+
+  CHECK(validator.validatedNodeCount() == 6u);
+
+  SECTION("Only invalid nodes are validated again")
+  {
+    entityNode->invalidateIssues();
+    CHECK(collectNodesWithInvalidIssues({&worldNode}) == std::vector<Node*>{entityNode});
+
+    validateIssues({&worldNode}, validators);
+
+    CHECK(validator.validatedNodeCount() == 7u);
+    CHECK(entityNode->issues(validators).size() == 1u);
+  }
+
+  SECTION("Validating single nodes does not validate their descendants")
+  {
+    groupNode->invalidateIssues();
+    entityNode->invalidateIssues();
+    validateNodeIssues({groupNode, brushNode}, validators);
+
+    CHECK(groupNode->issuesValid());
+    CHECK_FALSE(entityNode->issuesValid());
+    CHECK(validator.validatedNodeCount() == 7u);
+  }
+}
+
 } // namespace TrenchBroom::Model
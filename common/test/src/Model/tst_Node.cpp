@@ -175,6 +175,8 @@ private: // implement Node interface
 
   bool doSelectable() const override { return false; }
 
+  std::uint64_t doGetContentHash() const override { return 0; }
+
   void doAncestorWillChange() override { popCall<DoAncestorWillChange>(); }
 
   void doAncestorDidChange() override { popCall<DoAncestorDidChange>(); }
@@ -238,6 +240,8 @@ private: // implement Node interface
 
   bool doSelectable() const override { return true; }
 
+  std::uint64_t doGetContentHash() const override { return 0; }
+
   void doParentWillChange() override {}
   void doParentDidChange() override {}
   void doAncestorWillChange() override {}
@@ -824,6 +828,85 @@ TEST_CASE("Nodepath.resolvePath")
   CHECK(child1_1_1.resolvePath(NodePath{{}}) == &child1_1_1);
 }
 
+TEST_CASE("NodeTest.contentHash")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto world = WorldNode{{}, {}, MapFormat::Standard};
+  auto builder = BrushBuilder{world.mapFormat(), worldBounds};
+
+  auto* entityNode = new EntityNode{Entity{{}, {{"classname", "func_door"}}}};
+  auto* brushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+  entityNode->addChild(brushNode);
+  world.defaultLayer()->addChild(entityNode);
+
+  const auto brushHash = brushNode->contentHash();
+  const auto entityHash = entityNode->contentHash();
+  const auto entityTreeHash = entityNode->treeHash();
+  const auto worldHash = world.treeHash();
+
+  SECTION("Hashes are cached until the node changes")
+  {
+    CHECK(brushNode->contentHash() == brushHash);
+    CHECK(entityNode->contentHash() == entityHash);
+    CHECK(world.treeHash() == worldHash);
+  }
+
+  SECTION("Nodes with equal contents have equal hashes")
+  {
+    auto otherBrushNode = BrushNode{builder.createCube(64.0, "texture").value()};
+    CHECK(otherBrushNode.contentHash() != brushHash);
+
+    otherBrushNode.setLinkId(brushNode->linkId());
+    CHECK(otherBrushNode.contentHash() == brushHash);
+  }
+
+  SECTION("Changing a brush")
+  {
+    auto brush = brushNode->brush();
+    REQUIRE(brush
+              .transform(
+                worldBounds, vm::translation_matrix(vm::vec3{16.0, 0.0, 0.0}), false)
+              .is_success());
+    brushNode->setBrush(std::move(brush));
+
+    CHECK(brushNode->contentHash() != brushHash);
+    CHECK(entityNode->contentHash() == entityHash);
+    CHECK(entityNode->treeHash() != entityTreeHash);
+    CHECK(world.treeHash() != worldHash);
+  }
+
+  SECTION("Changing an entity")
+  {
+    auto entity = entityNode->entity();
+    entity.addOrUpdateProperty({}, "target", "some_target");
+    entityNode->setEntity(std::move(entity));
+
+    CHECK(entityNode->contentHash() != entityHash);
+    CHECK(brushNode->contentHash() == brushHash);
+    CHECK(world.treeHash() != worldHash);
+  }
+
+  SECTION("Adding and removing a node")
+  {
+    auto otherEntityNode = std::make_unique<EntityNode>(Entity{});
+    world.defaultLayer()->addChild(otherEntityNode.get());
+    CHECK(world.treeHash() != worldHash);
+
+    world.defaultLayer()->removeChild(otherEntityNode.get());
+    CHECK(world.treeHash() == worldHash);
+  }
+
+  SECTION("Hiding a layer")
+  {
+    world.defaultLayer()->setVisibilityState(VisibilityState::Hidden);
+    CHECK(world.treeHash() != worldHash);
+
+    world.defaultLayer()->setVisibilityState(VisibilityState::Inherited);
+    CHECK(world.treeHash() == worldHash);
+  }
+}
+
 TEST_CASE("NodeTest.entityPropertyConfig")
 {
   class RootNode : public TestNode
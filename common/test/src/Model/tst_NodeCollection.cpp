@@ -476,6 +476,64 @@ TEST_CASE("NodeCollection.removeNode")
   }
 }
 
+TEST_CASE("NodeCollection.removeNodes")
+{
+  auto entityNode1 = EntityNode{Entity{}};
+  auto entityNode2 = EntityNode{Entity{}};
+  auto entityNode3 = EntityNode{Entity{}};
+  auto entityNode4 = EntityNode{Entity{}};
+  auto notContained = EntityNode{Entity{}};
+
+  auto nodeCollection = NodeCollection{};
+  nodeCollection.addNodes({&entityNode1, &entityNode2, &entityNode3, &entityNode4});
+
+  nodeCollection.removeNodes({&entityNode3, &notContained, &entityNode1, &entityNode3});
+  CHECK(nodeCollection.nodes() == std::vector<Node*>{&entityNode2, &entityNode4});
+  CHECK(
+    nodeCollection.entities() == std::vector<EntityNode*>{&entityNode2, &entityNode4});
+  CHECK_FALSE(nodeCollection.contains(&entityNode1));
+  CHECK(nodeCollection.contains(&entityNode2));
+  CHECK_FALSE(nodeCollection.contains(&entityNode3));
+  CHECK(nodeCollection.contains(&entityNode4));
+
+  nodeCollection.addNode(&entityNode1);
+  CHECK(
+    nodeCollection.nodes()
+    == std::vector<Node*>{&entityNode2, &entityNode4, &entityNode1});
+}
+
+TEST_CASE("NodeCollection.contains")
+{
+  auto entityNode = EntityNode{Entity{}};
+  auto groupNode = GroupNode{Group{"group"}};
+
+  auto nodeCollection = NodeCollection{};
+  CHECK_FALSE(nodeCollection.contains(&entityNode));
+
+  nodeCollection.addNode(&entityNode);
+  CHECK(nodeCollection.contains(&entityNode));
+  CHECK_FALSE(nodeCollection.contains(&groupNode));
+
+  SECTION("adding a node twice has no effect")
+  {
+    nodeCollection.addNodes({&groupNode, &entityNode});
+    CHECK(nodeCollection.nodes() == std::vector<Node*>{&entityNode, &groupNode});
+    CHECK(nodeCollection.entities() == std::vector<EntityNode*>{&entityNode});
+  }
+
+  SECTION("removing a node")
+  {
+    nodeCollection.removeNode(&entityNode);
+    CHECK_FALSE(nodeCollection.contains(&entityNode));
+  }
+
+  SECTION("clearing")
+  {
+    nodeCollection.clear();
+    CHECK_FALSE(nodeCollection.contains(&entityNode));
+  }
+}
+
 TEST_CASE("NodeCollection.clear")
 {
   const auto mapFormat = MapFormat::Quake3;
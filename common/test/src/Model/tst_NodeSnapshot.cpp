@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/NodeSnapshot.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+
+#include <variant>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Model
+{
+
+TEST_CASE("NodeSnapshotTest.takeSnapshot")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto world = WorldNode{{}, {}, MapFormat::Standard};
+  auto builder = BrushBuilder{world.mapFormat(), worldBounds};
+
+  auto* entityNode = new EntityNode{Entity{{}, {{"classname", "func_door"}}}};
+  auto* brushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+  auto* patchNode = new PatchNode{BezierPatch{
+    3,
+    3,
+    {{0, 0, 0}, {1, 0, 1}, {2, 0, 0}, {0, 1, 1}, {1, 1, 2}, {2, 1, 1}, {0, 2, 0},
+     {1, 2, 1}, {2, 2, 0}},
+    "texture"}};
+  entityNode->addChild(brushNode);
+  world.defaultLayer()->addChild(entityNode);
+  world.defaultLayer()->addChild(patchNode);
+
+  const auto snapshot = takeSnapshot(world);
+
+  const auto& worldContents = std::get<NodeSnapshot::WorldContents>(snapshot.contents());
+  CHECK(worldContents.mapFormat == MapFormat::Standard);
+  CHECK(worldContents.entity.get() == &world.entity());
+
+  REQUIRE(snapshot.children().size() == 1u);
+  const auto& layerSnapshot = snapshot.children().front();
+  CHECK(
+    std::get<NodeSnapshot::LayerContents>(layerSnapshot.contents()).layer
+    == world.defaultLayer()->layer());
+
+  REQUIRE(layerSnapshot.children().size() == 2u);
+  const auto& entitySnapshot = layerSnapshot.children()[0];
+  const auto& patchSnapshot = layerSnapshot.children()[1];
+
+  const auto snapshotEntity =
+    std::get<NodeSnapshot::EntityContents>(entitySnapshot.contents()).entity;
+  const auto snapshotPatch =
+    std::get<NodeSnapshot::PatchContents>(patchSnapshot.contents()).patch;
+
+  REQUIRE(entitySnapshot.children().size() == 1u);
+  const auto snapshotBrush =
+    std::get<NodeSnapshot::BrushContents>(entitySnapshot.children().front().contents())
+      .brush;
+
+  SECTION("Snapshots share the contents of the nodes")
+  {
+    CHECK(snapshotEntity.get() == &entityNode->entity());
+    CHECK(snapshotBrush.get() == &brushNode->brush());
+    CHECK(snapshotPatch.get() == &patchNode->patch());
+  }
+
+  SECTION("Changing an entity does not change the snapshot")
+  {
+    auto entity = entityNode->entity();
+    entity.addOrUpdateProperty({}, "target", "some_target");
+    entityNode->setEntity(std::move(entity));
+
+    CHECK(entityNode->entity().hasProperty("target"));
+    CHECK_FALSE(snapshotEntity->hasProperty("target"));
+  }
+
+  SECTION("Changing a brush does not change the snapshot")
+  {
+    const auto originalBrush = *snapshotBrush;
+
+    brushNode->selectFace(0u);
+    CHECK(snapshotBrush.get() != &brushNode->brush());
+    CHECK(brushNode->brush().face(0u).selected());
+    CHECK_FALSE(snapshotBrush->face(0u).selected());
+
+    brushNode->setBrush(builder.createCube(32.0, "texture").value());
+    CHECK(*snapshotBrush == originalBrush);
+    CHECK(brushNode->brush() != originalBrush);
+  }
+
+  SECTION("Changing a patch does not change the snapshot")
+  {
+    patchNode->setTexture(nullptr);
+    CHECK(snapshotPatch.get() != &patchNode->patch());
+  }
+}
+
+TEST_CASE("NodeSnapshotTest.releaseSnapshot")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto brushNode = BrushNode{builder.createCube(64.0, "texture").value()};
+  const auto* brush = &brushNode.brush();
+
+  {
+    const auto snapshot = takeSnapshot(brushNode);
+    CHECK(
+      std::get<NodeSnapshot::BrushContents>(snapshot.contents()).brush.get() == brush);
+  }
+
+  // the brush is no longer shared, so it is modified in place
+  brushNode.selectFace(0u);
+  CHECK(&brushNode.brush() == brush);
+  CHECK(brushNode.brush().face(0u).selected());
+}
+
+} // namespace TrenchBroom::Model
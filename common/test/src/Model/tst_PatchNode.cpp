@@ -26,11 +26,15 @@
 #include "kdl/vector_utils.h"
 
 #include "vm/approx.h"
+#include "vm/bbox.h"
+#include "vm/mat_ext.h"
 #include "vm/ray.h"
 #include "vm/ray_io.h"
 #include "vm/vec.h"
 #include "vm/vec_io.h"
 
+#include <memory>
+
 #include "Catch2.h"
 
 namespace vm
@@ -167,6 +171,49 @@ TEST_CASE("PatchNode.makePatchGrid")
     == kdl::vec_transform(expectedPoints, [](const auto& p) { return vm::approx{p}; }));
 }
 
+TEST_CASE("PatchNode.grid")
+{
+  using P = BezierPatch::Point;
+
+  // clang-format off
+  const auto patch = BezierPatch{3, 3, {
+    P{0.0, 2.0, 0.0}, P{1.0, 2.0, 1.0}, P{2.0, 2.0, 0.0},
+    P{0.0, 1.0, 1.0}, P{1.0, 1.0, 2.0}, P{2.0, 1.0, 1.0},
+    P{0.0, 0.0, 0.0}, P{1.0, 0.0, 1.0}, P{2.0, 0.0, 0.0},
+  }, "texture"};
+  // clang-format on
+
+  auto patchNode = PatchNode{patch};
+  const auto originalGrid = patchNode.grid();
+
+  SECTION("Clone has the same grid")
+  {
+    const auto worldBounds = vm::bbox3{8192.0};
+    auto clone =
+      std::unique_ptr<Node>{patchNode.clone(worldBounds, SetLinkId::generate)};
+    const auto* patchClone = dynamic_cast<const PatchNode*>(clone.get());
+    REQUIRE(patchClone != nullptr);
+    CHECK(patchClone->grid() == originalGrid);
+  }
+
+  SECTION("Changing the texture keeps the grid")
+  {
+    auto newPatch = patch;
+    newPatch.setTextureName("other");
+    patchNode.setPatch(std::move(newPatch));
+    CHECK(patchNode.grid() == originalGrid);
+  }
+
+  SECTION("Changing the control points updates the grid")
+  {
+    auto newPatch = patch;
+    newPatch.transform(vm::translation_matrix(vm::vec3{0, 0, 8}));
+    patchNode.setPatch(std::move(newPatch));
+    CHECK(patchNode.grid() == makePatchGrid(patchNode.patch(), 3u));
+    CHECK(patchNode.grid().bounds == originalGrid.bounds.translate(vm::vec3{0, 0, 8}));
+  }
+}
+
 TEST_CASE("PatchNode.pickFlatPatch")
 {
   using P = BezierPatch::Point;
@@ -212,5 +259,55 @@ TEST_CASE("PatchNode.pickFlatPatch")
     CHECK(pickResult.size() == 0u);
   }
 }
+
+TEST_CASE("PatchNode.pickCylinderPatch")
+{
+  using P = BezierPatch::Point;
+
+  // clang-format off
+  auto patchNode = PatchNode{BezierPatch{9, 3, {
+    P{-1.0,  0.0,  1.0}, P{-1.0,  0.0,  0.0}, P{-1.0,  0.0, -1.0},
+    P{-1.0,  1.0,  1.0}, P{-1.0,  1.0,  0.0}, P{-1.0,  1.0, -1.0},
+    P{ 0.0,  1.0,  1.0}, P{ 0.0,  1.0,  0.0}, P{ 0.0,  1.0, -1.0},
+    P{ 1.0,  1.0,  1.0}, P{ 1.0,  1.0,  0.0}, P{ 1.0,  1.0, -1.0},
+    P{ 1.0,  0.0,  1.0}, P{ 1.0,  0.0,  0.0}, P{ 1.0,  0.0, -1.0},
+    P{ 1.0, -1.0,  1.0}, P{ 1.0, -1.0,  0.0}, P{ 1.0, -1.0, -1.0},
+    P{ 0.0, -1.0,  1.0}, P{ 0.0, -1.0,  0.0}, P{ 0.0, -1.0, -1.0},
+    P{-1.0, -1.0,  1.0}, P{-1.0, -1.0,  0.0}, P{-1.0, -1.0, -1.0},
+    P{-1.0,  0.0,  1.0}, P{-1.0,  0.0,  0.0}, P{-1.0,  0.0, -1.0},
+  }, "texture"}};
+  // clang-format on
+
+  using T = std::tuple<vm::ray3, std::optional<vm::vec3>>;
+
+  // clang-format off
+  const auto 
+  [pickRay,                                            expectedHitPoint     ] = GENERATE(values<T>({
+  {vm::ray3{vm::vec3{0, 0,  0  }, vm::vec3::pos_y()}, vm::vec3{0,  1, 0  }},
+  {vm::ray3{vm::vec3{0, 0,  0.5}, vm::vec3::neg_y()}, vm::vec3{0, -1, 0.5}},
+  {vm::ray3{vm::vec3{0, 0,  3  }, vm::vec3::neg_z()}, std::nullopt        },
+  {vm::ray3{vm::vec3{0, -3, 2  }, vm::vec3::pos_y()}, std::nullopt        },
+  {vm::ray3{vm::vec3{0, -3, 0  }, vm::vec3::neg_y()}, std::nullopt        },
+  }));
+  // clang-format on
+
+  CAPTURE(pickRay);
+
+  const auto editorContext = EditorContext{};
+  auto pickResult = PickResult{};
+  patchNode.pick(editorContext, pickRay, pickResult);
+
+  if (expectedHitPoint.has_value())
+  {
+    CHECK(pickResult.size() == 1u);
+
+    const auto hit = pickResult.all().front();
+    CHECK(hit.hitPoint() == vm::approx{*expectedHitPoint});
+  }
+  else
+  {
+    CHECK(pickResult.size() == 0u);
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
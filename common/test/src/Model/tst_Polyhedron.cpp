@@ -28,6 +28,7 @@
 #include "vm/vec.h"
 #include "vm/vec_io.h"
 
+#include <cmath>
 #include <iterator>
 #include <set>
 #include <tuple>
@@ -465,6 +466,167 @@ TEST_CASE("PolyhedronTest.constructCube")
   CHECK(p.hasFace({p2, p6, p8, p4}));
 }
 
+TEST_CASE("PolyhedronTest.constructFromManyPoints")
+{
+  SECTION("Grid points")
+  {
+    std::vector<vm::vec3d> points;
+    for (size_t x = 0; x < 5; ++x)
+    {
+      for (size_t y = 0; y < 5; ++y)
+      {
+        for (size_t z = 0; z < 5; ++z)
+        {
+          points.emplace_back(double(x) * 4.0, double(y) * 4.0, double(z) * 4.0);
+        }
+      }
+    }
+
+    const Polyhedron3d p(points);
+
+    CHECK(p.closed());
+    CHECK(hasVertices(
+      p,
+      {vm::vec3d(0, 0, 0),
+       vm::vec3d(0, 0, 16),
+       vm::vec3d(0, 16, 0),
+       vm::vec3d(0, 16, 16),
+       vm::vec3d(16, 0, 0),
+       vm::vec3d(16, 0, 16),
+       vm::vec3d(16, 16, 0),
+       vm::vec3d(16, 16, 16)}));
+    CHECK(p.faceCount() == 6u);
+  }
+
+  SECTION("Coplanar points")
+  {
+    std::vector<vm::vec3d> points;
+    for (size_t x = 0; x < 10; ++x)
+    {
+      for (size_t y = 0; y < 10; ++y)
+      {
+        points.emplace_back(double(x) * 4.0, double(y) * 4.0, 0.0);
+      }
+    }
+
+    const Polyhedron3d p(points);
+
+    CHECK(p.polygon());
+    CHECK(hasVertices(
+      p,
+      {vm::vec3d(0, 0, 0),
+       vm::vec3d(0, 36, 0),
+       vm::vec3d(36, 0, 0),
+       vm::vec3d(36, 36, 0)}));
+  }
+
+  SECTION("Points on a sphere")
+  {
+    std::vector<vm::vec3d> points;
+    for (size_t i = 0; i < 16; ++i)
+    {
+      const auto polar = vm::C::pi() * double(i + 1) / 17.0;
+      for (size_t j = 0; j < 16; ++j)
+      {
+        const auto azimuth = vm::C::two_pi() * double(j) / 16.0;
+        points.push_back(
+          vm::vec3d(
+            std::sin(polar) * std::cos(azimuth),
+            std::sin(polar) * std::sin(azimuth),
+            std::cos(polar))
+          * 64.0);
+      }
+    }
+
+    const Polyhedron3d p(points);
+
+    CHECK(p.closed());
+    CHECK(p.vertexCount() == points.size());
+    for (const auto& point : points)
+    {
+      CHECK(p.hasVertex(point, 0.0));
+    }
+  }
+}
+
+TEST_CASE("PolyhedronTest.fromFaces")
+{
+  const vm::vec3d p1(-8.0, -8.0, -8.0);
+  const vm::vec3d p2(-8.0, -8.0, +8.0);
+  const vm::vec3d p3(-8.0, +8.0, -8.0);
+  const vm::vec3d p4(-8.0, +8.0, +8.0);
+  const vm::vec3d p5(+8.0, -8.0, -8.0);
+  const vm::vec3d p6(+8.0, -8.0, +8.0);
+  const vm::vec3d p7(+8.0, +8.0, -8.0);
+  const vm::vec3d p8(+8.0, +8.0, +8.0);
+
+  const auto positions = std::vector<vm::vec3d>{p1, p2, p3, p4, p5, p6, p7, p8};
+  const auto facePlanes = std::vector<vm::plane3d>{
+    {8.0, vm::vec3d::neg_y()},
+    {8.0, vm::vec3d::neg_x()},
+    {8.0, vm::vec3d::pos_y()},
+    {8.0, vm::vec3d::pos_x()},
+    {8.0, vm::vec3d::neg_z()},
+    {8.0, vm::vec3d::pos_z()},
+  };
+
+  SECTION("Valid faces")
+  {
+    const auto faceVertexIndices = std::vector<std::vector<size_t>>{
+      {0, 4, 5, 1},
+      {2, 0, 1, 3},
+      {6, 2, 3, 7},
+      {4, 6, 7, 5},
+      {2, 6, 4, 0},
+      {1, 5, 7, 3},
+    };
+
+    const auto p = Polyhedron3d::fromFaces(positions, faceVertexIndices, facePlanes);
+    REQUIRE(p.has_value());
+
+    CHECK(p->closed());
+    CHECK(hasVertices(*p, positions));
+    CHECK(p->edgeCount() == 12u);
+    CHECK(p->hasFace({p1, p5, p6, p2}));
+    CHECK(p->hasFace({p3, p1, p2, p4}));
+    CHECK(p->hasFace({p7, p3, p4, p8}));
+    CHECK(p->hasFace({p5, p7, p8, p6}));
+    CHECK(p->hasFace({p3, p7, p5, p1}));
+    CHECK(p->hasFace({p2, p6, p8, p4}));
+    CHECK(p->bounds() == vm::bbox3d{8.0});
+  }
+
+  SECTION("Open faces")
+  {
+    const auto faceVertexIndices = std::vector<std::vector<size_t>>{
+      {0, 4, 5, 1},
+      {2, 0, 1, 3},
+      {6, 2, 3, 7},
+      {4, 6, 7, 5},
+      {2, 6, 4, 0},
+      {1, 5, 3, 7},
+    };
+
+    CHECK(
+      Polyhedron3d::fromFaces(positions, faceVertexIndices, facePlanes) == std::nullopt);
+  }
+
+  SECTION("Invalid vertex index")
+  {
+    const auto faceVertexIndices = std::vector<std::vector<size_t>>{
+      {0, 4, 5, 1},
+      {2, 0, 1, 3},
+      {6, 2, 3, 7},
+      {4, 6, 7, 5},
+      {2, 6, 4, 0},
+      {1, 5, 7, 8},
+    };
+
+    CHECK(
+      Polyhedron3d::fromFaces(positions, faceVertexIndices, facePlanes) == std::nullopt);
+  }
+}
+
 TEST_CASE("PolyhedronTest.copy")
 {
   const vm::vec3d p1(0.0, 0.0, 8.0);
@@ -507,6 +669,80 @@ TEST_CASE("PolyhedronTest.swap")
   CHECK(rhs.bounds() == original.bounds());
 }
 
+TEST_CASE("PolyhedronTest.moveVerticesKeepingTopology")
+{
+  const auto p1 = vm::vec3d{-8.0, -8.0, -8.0};
+  const auto p2 = vm::vec3d{-8.0, -8.0, +8.0};
+  const auto p3 = vm::vec3d{-8.0, +8.0, -8.0};
+  const auto p4 = vm::vec3d{-8.0, +8.0, +8.0};
+  const auto p5 = vm::vec3d{+8.0, -8.0, -8.0};
+  const auto p6 = vm::vec3d{+8.0, -8.0, +8.0};
+  const auto p7 = vm::vec3d{+8.0, +8.0, -8.0};
+  const auto p8 = vm::vec3d{+8.0, +8.0, +8.0};
+
+  const auto cube = Polyhedron3d{p1, p2, p3, p4, p5, p6, p7, p8};
+  const auto topFace = std::vector<vm::vec3d>{p2, p4, p6, p8};
+
+  SECTION("Moving a face along its normal keeps the topology")
+  {
+    const auto delta = vm::vec3d{0, 0, 8};
+
+    auto polyhedron = cube;
+    CHECK(polyhedron.moveVerticesKeepingTopology(topFace, delta));
+    CHECK(
+      polyhedron
+      == Polyhedron3d{p1, p2 + delta, p3, p4 + delta, p5, p6 + delta, p7, p8 + delta});
+    CHECK(polyhedron.bounds() == vm::bbox3d{{-8, -8, -8}, {8, 8, 16}});
+
+    const auto* face = polyhedron.findFaceByPositions(
+      {p2 + delta, p6 + delta, p8 + delta, p4 + delta});
+    REQUIRE(face != nullptr);
+    CHECK(face->plane() == vm::plane3d{16.0, vm::vec3d::pos_z()});
+  }
+
+  SECTION("Moving a face sideways keeps the topology")
+  {
+    const auto delta = vm::vec3d{4, 0, 0};
+
+    auto polyhedron = cube;
+    CHECK(polyhedron.moveVerticesKeepingTopology(topFace, delta));
+    CHECK(
+      polyhedron
+      == Polyhedron3d{p1, p2 + delta, p3, p4 + delta, p5, p6 + delta, p7, p8 + delta});
+  }
+
+  SECTION("Moving a single vertex makes its incident faces non-planar")
+  {
+    auto polyhedron = cube;
+    CHECK_FALSE(polyhedron.moveVerticesKeepingTopology({p8}, vm::vec3d{0, 0, 8}));
+    CHECK(polyhedron == cube);
+  }
+
+  SECTION("Moving a face onto the opposite face collapses the polyhedron")
+  {
+    auto polyhedron = cube;
+    CHECK_FALSE(polyhedron.moveVerticesKeepingTopology(topFace, vm::vec3d{0, 0, -16}));
+    CHECK(polyhedron == cube);
+  }
+
+  SECTION("Moving a face through the opposite face inverts the polyhedron")
+  {
+    auto polyhedron = cube;
+    CHECK_FALSE(polyhedron.moveVerticesKeepingTopology(topFace, vm::vec3d{0, 0, -24}));
+    CHECK(polyhedron == cube);
+  }
+
+  SECTION("Making two adjacent faces coplanar merges them")
+  {
+    // moving the top right edge down to the bottom makes the right face coplanar with
+    // the bottom face
+    auto polyhedron = cube;
+    CHECK_FALSE(
+      polyhedron.moveVerticesKeepingTopology({p6, p8}, vm::vec3d{0, 0, -16}));
+    CHECK(polyhedron == cube);
+  }
+}
+
 TEST_CASE("PolyhedronTest.clipCubeWithHorizontalPlane")
 {
   const vm::vec3d p1(-64.0, -64.0, -64.0);
@@ -25,6 +25,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <sstream>
 
 #include "Catch2.h"
 
@@ -40,6 +41,16 @@ TEST_CASE("PortalFileTest.parseInvalidPRT1")
         }).is_error());
 }
 
+TEST_CASE("PortalFileTest.parseInvalidCoordinates")
+{
+  auto stream = std::istringstream{R"(PRT1
+2
+1
+3 0 1 (0 0 0 ) (0 x 0 ) (0 0 1 )
+)"};
+  CHECK(Model::loadPortalFile(stream).is_error());
+}
+
 static const std::vector<vm::polygon3f> ExpectedPortals{
   {{-96, -32, 80}, {-96, 160, 80}, {0, 160, 80}, {0, -32, 80}},
   {{208, -64, 80}, {64, -64, 80}, {64, 160, 80}, {208, 160, 80}},
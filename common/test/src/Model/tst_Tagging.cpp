@@ -20,15 +20,19 @@
 #include "Error.h"
 #include "Exceptions.h"
 #include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
 #include "Model/LayerNode.h"
 #include "Model/MapFormat.h"
 #include "Model/Tag.h"
 #include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
 #include "Model/WorldNode.h"
 
 #include "kdl/result.h"
 
+#include <memory>
+
 #include "Catch2.h"
 
 namespace TrenchBroom
@@ -67,5 +71,88 @@ TEST_CASE("TaggingTest.testTagBrush")
   CHECK_FALSE(brushNode->hasTag(tag1));
   CHECK_FALSE(brushNode->hasTag(tag2));
 }
+
+namespace
+{
+class CountingTagMatcher : public TagMatcher
+{
+private:
+  TagMatcherInput::Type m_inputs;
+  size_t& m_count;
+
+public:
+  CountingTagMatcher(const TagMatcherInput::Type inputs, size_t& count)
+    : m_inputs{inputs}
+    , m_count{count}
+  {
+  }
+
+  bool matches(const Taggable&) const override
+  {
+    ++m_count;
+    return false;
+  }
+
+  TagMatcherInput::Type inputs() const override { return m_inputs; }
+
+  std::unique_ptr<TagMatcher> clone() const override
+  {
+    return std::make_unique<CountingTagMatcher>(m_inputs, m_count);
+  }
+
+  void appendToStream(std::ostream&) const override {}
+};
+} // namespace
+
+TEST_CASE("TaggingTest.updateTagsOnlyReevaluatesChangedInputs")
+{
+  const vm::bbox3 worldBounds{4096.0};
+
+  BrushBuilder builder{MapFormat::Standard, worldBounds};
+  auto brush = builder.createCube(64.0, "some_texture").value();
+  auto& face = brush.face(0);
+
+  auto textureNameCount = size_t(0);
+  auto otherCount = size_t(0);
+
+  TagManager tagManager;
+  tagManager.registerSmartTags({
+    SmartTag{"texture", {}, std::make_unique<TextureNameTagMatcher>("other_texture")},
+    SmartTag{
+      "texture_name_count",
+      {},
+      std::make_unique<CountingTagMatcher>(
+        TagMatcherInput::TextureName, textureNameCount)},
+    SmartTag{
+      "other_count",
+      {},
+      std::make_unique<CountingTagMatcher>(TagMatcherInput::Other, otherCount)},
+  });
+
+  const auto& textureTag = tagManager.smartTag("texture");
+
+  face.initializeTags(tagManager);
+  CHECK_FALSE(face.hasTag(textureTag));
+  CHECK(textureNameCount == 1u);
+  CHECK(otherCount == 1u);
+
+  face.updateTags(tagManager);
+  CHECK(textureNameCount == 1u);
+  CHECK(otherCount == 2u);
+
+  auto attributes = face.attributes();
+  attributes.setTextureName("other_texture");
+  face.setAttributes(attributes);
+
+  face.updateTags(tagManager);
+  CHECK(face.hasTag(textureTag));
+  CHECK(textureNameCount == 2u);
+  CHECK(otherCount == 3u);
+
+  face.initializeTags(tagManager);
+  CHECK(face.hasTag(textureTag));
+  CHECK(textureNameCount == 3u);
+  CHECK(otherCount == 4u);
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -25,6 +25,8 @@
 
 #include "vm/vec.h"
 
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom
@@ -57,5 +59,34 @@ TEST_CASE("TexCoordSystemTest.testSnapshotTypeSafety")
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
+
+TEST_CASE("TexCoordSystemTest.getTexCoordsOfMultiplePoints")
+{
+  auto attribs = BrushFaceAttributes{""};
+  attribs.setOffset(vm::vec2f{3.0f, -5.0f});
+  attribs.setScale(vm::vec2f{0.5f, 2.0f});
+  attribs.setRotation(30.0f);
+
+  const auto textureSize = vm::vec2f{64.0f, 32.0f};
+  const auto points = std::vector<vm::vec3>{
+    {0.0, 0.0, 0.0}, {16.0, -8.0, 32.0}, {-100.5, 7.25, 3.0}, {1024.0, 512.0, -64.0}};
+
+  const auto checkTexCoords = [&](const TexCoordSystem& texCoordSystem) {
+    auto texCoords = std::vector<vm::vec2f>{vm::vec2f{1.0f, 2.0f}};
+    texCoordSystem.getTexCoords(points, attribs, textureSize, texCoords);
+
+    REQUIRE(texCoords.size() == points.size() + 1u);
+    CHECK(texCoords.front() == vm::vec2f{1.0f, 2.0f});
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      CHECK(
+        texCoords[i + 1u]
+        == texCoordSystem.getTexCoords(points[i], attribs, textureSize));
+    }
+  };
+
+  checkTexCoords(ParaxialTexCoordSystem{vm::normalize(vm::vec3{1, 2, 3}), attribs});
+  checkTexCoords(ParallelTexCoordSystem{vm::vec3::pos_y(), vm::vec3::pos_x()});
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Assets/Texture.h"
+#include "Error.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/TextureNodeIndex.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/result.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Model
+{
+
+TEST_CASE("TextureNodeIndex")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  // the textures must outlive the brushes that reference them
+  auto texture1 = Assets::Texture{"texture1", 64, 64};
+  auto texture2 = Assets::Texture{"texture2", 64, 64};
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  const auto& index = worldNode.textureNodeIndex();
+
+  auto* brushNode = new BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "texture").value()};
+  for (size_t i = 0u; i < brushNode->brush().faceCount(); ++i)
+  {
+    brushNode->setFaceTexture(i, &texture1);
+  }
+
+  REQUIRE_FALSE(index.contains(&texture1));
+
+  SECTION("Adding a brush node indexes its textures")
+  {
+    worldNode.defaultLayer()->addChild(brushNode);
+
+    CHECK(index.contains(&texture1));
+    CHECK(index.findBrushNodes(&texture1) == std::vector<BrushNode*>{brushNode});
+    CHECK(index.findBrushFaces(&texture1).size() == brushNode->brush().faceCount());
+    CHECK_FALSE(index.contains(&texture2));
+  }
+
+  SECTION("Removing a brush node removes its textures")
+  {
+    worldNode.defaultLayer()->addChild(brushNode);
+    worldNode.defaultLayer()->removeChild(brushNode);
+
+    CHECK_FALSE(index.contains(&texture1));
+    delete brushNode;
+  }
+
+  SECTION("Changing the texture of a face updates the index")
+  {
+    worldNode.defaultLayer()->addChild(brushNode);
+    brushNode->setFaceTexture(0u, &texture2);
+
+    CHECK(index.findBrushFaces(&texture1).size() == brushNode->brush().faceCount() - 1u);
+    CHECK(
+      index.findBrushFaces(&texture2) == std::vector<BrushFaceHandle>{{brushNode, 0u}});
+  }
+
+  SECTION("Setting the brush updates the index")
+  {
+    worldNode.defaultLayer()->addChild(brushNode);
+    brushNode->setBrush(
+      BrushBuilder{mapFormat, worldBounds}.createCube(32.0, "texture").value());
+
+    CHECK_FALSE(index.contains(&texture1));
+  }
+}
+
+} // namespace TrenchBroom::Model
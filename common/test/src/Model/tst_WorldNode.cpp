@@ -40,6 +40,9 @@
 #include "vm/mat_ext.h"
 #include "vm/mat_io.h"
 
+#include <memory>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom
@@ -101,6 +104,84 @@ TEST_CASE("WorldNodeTest.canRemoveChild")
   CHECK_FALSE(worldNode.canRemoveChild(&patchNode));
 }
 
+TEST_CASE("WorldNodeTest.flattenedNodes")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* defaultLayerNode = worldNode.defaultLayer();
+  auto* layerNode = new LayerNode{Layer{"layer"}};
+  auto* groupNode = new GroupNode{Group{"group"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* brushNode = new BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "texture").value()};
+  auto* otherBrushNode = new BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(32.0, "texture").value()};
+
+  // clang-format off
+  auto* patchNode = new PatchNode{BezierPatch{3, 3, {
+    {0, 0, 0}, {1, 0, 1}, {2, 0, 0},
+    {0, 1, 1}, {1, 1, 2}, {2, 1, 1},
+    {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, "texture"}};
+  // clang-format on
+
+  CHECK(worldNode.allDescendants() == std::vector<Node*>{defaultLayerNode});
+  CHECK(worldNode.allBrushes().empty());
+
+  entityNode->addChild(brushNode);
+  groupNode->addChildren({entityNode, patchNode});
+  defaultLayerNode->addChildren({groupNode, otherBrushNode});
+  worldNode.addChild(layerNode);
+
+  CHECK(
+    worldNode.allDescendants()
+    == std::vector<Node*>{
+      defaultLayerNode,
+      groupNode,
+      entityNode,
+      brushNode,
+      patchNode,
+      otherBrushNode,
+      layerNode});
+  CHECK(worldNode.allGroups() == std::vector<GroupNode*>{groupNode});
+  CHECK(worldNode.allEntities() == std::vector<EntityNode*>{entityNode});
+  CHECK(worldNode.allBrushes() == std::vector<BrushNode*>{brushNode, otherBrushNode});
+  CHECK(worldNode.allPatches() == std::vector<PatchNode*>{patchNode});
+
+  SECTION("Removing a subtree updates the flattened nodes")
+  {
+    defaultLayerNode->removeChild(groupNode);
+    auto removedGroupNode = std::unique_ptr<GroupNode>{groupNode};
+
+    CHECK(
+      worldNode.allDescendants()
+      == std::vector<Node*>{defaultLayerNode, otherBrushNode, layerNode});
+    CHECK(worldNode.allGroups().empty());
+    CHECK(worldNode.allEntities().empty());
+    CHECK(worldNode.allBrushes() == std::vector<BrushNode*>{otherBrushNode});
+    CHECK(worldNode.allPatches().empty());
+  }
+
+  SECTION("Reparenting a node updates the flattened nodes")
+  {
+    defaultLayerNode->removeChild(otherBrushNode);
+    layerNode->addChild(otherBrushNode);
+
+    CHECK(
+      worldNode.allDescendants()
+      == std::vector<Node*>{
+        defaultLayerNode,
+        groupNode,
+        entityNode,
+        brushNode,
+        patchNode,
+        layerNode,
+        otherBrushNode});
+    CHECK(worldNode.allBrushes() == std::vector<BrushNode*>{brushNode, otherBrushNode});
+  }
+}
+
 TEST_CASE("WorldNodeTest.nodeTreeUpdates")
 {
   constexpr auto worldBounds = vm::bbox3d{8192.0};
@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2018 Eric Wasylishen
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Renderer/BrushRendererArrays.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+using Range = DirtyRangeTracker::Range;
+
+TEST_CASE("DirtyRangeTrackerTest.constructor")
+{
+  auto t = DirtyRangeTracker{100};
+  CHECK(t.capacity() == 100u);
+  CHECK(t.clean());
+  CHECK(t.ranges().empty());
+}
+
+TEST_CASE("DirtyRangeTrackerTest.markDirty")
+{
+  auto t = DirtyRangeTracker{100};
+
+  SECTION("marking an empty range keeps the tracker clean")
+  {
+    t.markDirty(50, 0);
+    CHECK(t.clean());
+  }
+
+  SECTION("disjoint ranges are kept apart")
+  {
+    t.markDirty(90, 5);
+    t.markDirty(10, 5);
+    CHECK(t.ranges() == std::vector<Range>{{10, 5}, {90, 5}});
+  }
+
+  SECTION("touching ranges are merged")
+  {
+    t.markDirty(10, 5);
+    t.markDirty(15, 5);
+    t.markDirty(5, 5);
+    CHECK(t.ranges() == std::vector<Range>{{5, 15}});
+  }
+
+  SECTION("a range spanning several ranges merges them")
+  {
+    t.markDirty(10, 5);
+    t.markDirty(30, 5);
+    t.markDirty(50, 5);
+    t.markDirty(70, 5);
+    t.markDirty(12, 40);
+    CHECK(t.ranges() == std::vector<Range>{{10, 45}, {70, 5}});
+  }
+
+  SECTION("a range inside another range is absorbed")
+  {
+    t.markDirty(10, 20);
+    t.markDirty(15, 5);
+    CHECK(t.ranges() == std::vector<Range>{{10, 20}});
+  }
+
+  SECTION("out of bounds ranges throw")
+  {
+    CHECK_THROWS_AS(t.markDirty(95, 10), std::invalid_argument);
+  }
+}
+
+TEST_CASE("DirtyRangeTrackerTest.maxRanges")
+{
+  const auto count = DirtyRangeTracker::MaxRanges + 1;
+  auto t = DirtyRangeTracker{count * 10};
+
+  // all gaps are 9 elements wide except for the gap before the last range
+  for (size_t i = 0; i < count - 1; ++i)
+  {
+    t.markDirty(i * 10, 1);
+  }
+  t.markDirty((count - 1) * 10 - 5, 1);
+
+  CHECK(t.ranges().size() == DirtyRangeTracker::MaxRanges);
+  CHECK(t.ranges().back() == Range{(count - 2) * 10, 6});
+}
+
+TEST_CASE("DirtyRangeTrackerTest.expand")
+{
+  auto t = DirtyRangeTracker{10};
+  t.markDirty(0, 2);
+  t.expand(20);
+  CHECK(t.capacity() == 20u);
+  CHECK(t.ranges() == std::vector<Range>{{0, 2}, {10, 10}});
+
+  CHECK_THROWS_AS(t.expand(20), std::invalid_argument);
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Renderer/PreviewAtlas.h"
+
+#include <optional>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Renderer
+{
+
+using Slot = PreviewAtlas::Slot;
+
+TEST_CASE("PreviewAtlas.allocate")
+{
+  auto atlas = PreviewAtlas{100};
+
+  SECTION("Packs slots into shelves")
+  {
+    CHECK(atlas.allocate(40, 20) == Slot{0, 0, 40, 20});
+    CHECK(atlas.allocate(40, 30) == Slot{41, 0, 40, 30});
+
+    // does not fit into the first shelf anymore
+    CHECK(atlas.allocate(40, 10) == Slot{0, 31, 40, 10});
+    CHECK(atlas.allocate(50, 10) == Slot{41, 31, 50, 10});
+  }
+
+  SECTION("Returns nothing once the atlas is full")
+  {
+    CHECK(atlas.allocate(100, 60) == Slot{0, 0, 100, 60});
+    CHECK(atlas.allocate(100, 40) == std::nullopt);
+    CHECK(atlas.allocate(100, 39) == Slot{0, 61, 100, 39});
+    CHECK(atlas.allocate(1, 1) == std::nullopt);
+  }
+
+  SECTION("Returns nothing for invalid sizes")
+  {
+    CHECK(atlas.allocate(0, 10) == std::nullopt);
+    CHECK(atlas.allocate(10, -1) == std::nullopt);
+    CHECK(atlas.allocate(101, 10) == std::nullopt);
+  }
+
+  SECTION("Clearing releases all slots")
+  {
+    atlas.allocate(100, 100);
+    CHECK(atlas.allocate(10, 10) == std::nullopt);
+
+    atlas.clear();
+    CHECK(atlas.allocate(10, 10) == Slot{0, 0, 10, 10});
+  }
+}
+
+} // namespace TrenchBroom::Renderer
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Renderer/RenderUtils.h"
+
+#include "vm/constants.h"
+#include "vm/vec.h"
+
+#include <cmath>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Renderer
+{
+
+TEST_CASE("RenderUtils.circle2D")
+{
+  const auto startAngle = GENERATE(0.0f, 0.3f, -2.0f);
+  const auto angleLength = GENERATE(0.5f, vm::Cf::pi(), vm::Cf::two_pi());
+  const auto segments = size_t(48);
+
+  const auto vertices2D = circle2D(3.0f, startAngle, angleLength, segments);
+  const auto vertices3D = circle2D(3.0f, vm::axis::z, startAngle, angleLength, segments);
+  REQUIRE(vertices2D.size() == segments + 1);
+  REQUIRE(vertices3D.size() == segments + 1);
+
+  for (size_t i = 0; i <= segments; ++i)
+  {
+    const auto a = startAngle + angleLength * float(i) / float(segments);
+    CHECK(vm::is_equal(
+      vertices2D[i], vm::vec2f{3.0f * std::sin(a), 3.0f * std::cos(a)}, 0.0001f));
+    CHECK(vm::is_equal(
+      vertices3D[i], vm::vec3f{3.0f * std::cos(a), 3.0f * std::sin(a), 0.0f}, 0.0001f));
+  }
+}
+
+TEST_CASE("RenderUtils.unitCircle2D")
+{
+  const auto& circle = unitCircle2D(16);
+  REQUIRE(circle.size() == 17);
+  CHECK(&unitCircle2D(16) == &circle);
+  CHECK(vm::is_equal(circle.front(), vm::vec2f{0, 1}, vm::Cf::almost_zero()));
+  CHECK(circle.back() == circle.front());
+  CHECK(vm::is_equal(circle[4], vm::vec2f{1, 0}, vm::Cf::almost_zero()));
+
+  const auto cylinder = cylinder3D(2.0f, 5.0f, 16);
+  CHECK(vm::is_equal(cylinder.vertices[8], vm::vec3f{2, 0, 5}, vm::Cf::almost_zero()));
+  CHECK(vm::is_equal(cylinder.vertices[9], vm::vec3f{2, 0, 0}, vm::Cf::almost_zero()));
+}
+
+TEST_CASE("RenderUtils.sphere3D")
+{
+  const auto& unitSphere = unitSphere3D(2);
+  CHECK(&unitSphere3D(2) == &unitSphere);
+  CHECK(unitSphere.size() == 3 * 20 * 16);
+
+  const auto sphere = sphere3D(4.0f, 2);
+  REQUIRE(sphere.size() == unitSphere.size());
+  for (size_t i = 0; i < sphere.size(); ++i)
+  {
+    CHECK(vm::is_equal(sphere[i], 4.0f * unitSphere[i], vm::Cf::almost_zero()));
+  }
+}
+
+} // namespace TrenchBroom::Renderer
@@ -75,5 +75,30 @@ TEST_CASE("VertexTest.memoryLayoutVertexList")
   REQUIRE(actual.size() == expected.size());
   REQUIRE(std::memcmp(expected.data(), actual.data(), sizeof(TestVertex) * 3) == 0);
 }
+
+struct TestPackedNormalVertex
+{
+  vm::vec3f pos;
+  vm::vec<GLbyte, 4> normal;
+  vm::vec2f uv;
+};
+
+TEST_CASE("VertexTest.memoryLayoutPackedNormal")
+{
+  using Vertex = GLVertexTypes::P3NBT2::Vertex;
+
+  const auto pos = vm::vec3f(1.0f, 2.0f, 3.0f);
+  const auto normal = vm::vec<GLbyte, 4>(0, 127, -127, 0);
+  const auto uv = vm::vec2f(4.0f, 5.0f);
+
+  const auto expected = TestPackedNormalVertex{pos, normal, uv};
+  const auto actual = Vertex(pos, normal, uv);
+
+  // the attribute offsets are computed from the attribute sizes, so there must be no
+  // padding between the attributes
+  REQUIRE(sizeof(Vertex) == sizeof(TestPackedNormalVertex));
+  REQUIRE(sizeof(Vertex) == 24u);
+  REQUIRE(std::memcmp(&expected, &actual, sizeof(expected)) == 0);
+}
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -30,6 +30,7 @@
 #include "Model/EntityNode.h"
 #include "Model/GameImpl.h"
 #include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
 #include "Model/ParallelTexCoordSystem.h"
 #include "Model/ParaxialTexCoordSystem.h"
 #include "Model/PatchNode.h"
@@ -40,6 +41,7 @@
 
 #include "kdl/result.h"
 #include "kdl/string_compare.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/polygon.h"
 #include "vm/scalar.h"
@@ -188,7 +190,7 @@ BrushFace createParaxial(
            point1,
            point2,
            attributes,
-           std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, attributes))
+           ParaxialTexCoordSystem{point0, point1, point2, attributes})
     .value();
 }
 
@@ -382,6 +384,63 @@ void checkBrushTexCoordSystem(
   checkFaceTexCoordSystem(faces[5], expectParallel);
 }
 
+namespace
+{
+template <typename T>
+const T& requireNodeType(const Node& node)
+{
+  const auto* typedNode = dynamic_cast<const T*>(&node);
+  REQUIRE(typedNode != nullptr);
+  return *typedNode;
+}
+
+std::vector<size_t> faceLineNumbers(const Brush& brush)
+{
+  return kdl::vec_transform(
+    brush.faces(), [](const auto& face) { return face.lineNumber(); });
+}
+} // namespace
+
+void checkNodesMatch(const Node& actual, const Node& expected)
+{
+  CHECK(actual.lineNumber() == expected.lineNumber());
+  CHECK(actual.lineCount() == expected.lineCount());
+  CHECK(actual.visibilityState() == expected.visibilityState());
+  CHECK(actual.lockState() == expected.lockState());
+
+  expected.accept(kdl::overload(
+    [&](const WorldNode* worldNode) {
+      const auto& actualWorldNode = requireNodeType<WorldNode>(actual);
+      CHECK(actualWorldNode.mapFormat() == worldNode->mapFormat());
+      CHECK(actualWorldNode.entity() == worldNode->entity());
+    },
+    [&](const LayerNode* layerNode) {
+      CHECK(requireNodeType<LayerNode>(actual).layer() == layerNode->layer());
+    },
+    [&](const GroupNode* groupNode) {
+      CHECK(requireNodeType<GroupNode>(actual).group() == groupNode->group());
+    },
+    [&](const EntityNode* entityNode) {
+      CHECK(requireNodeType<EntityNode>(actual).entity() == entityNode->entity());
+    },
+    [&](const BrushNode* brushNode) {
+      const auto& actualBrush = requireNodeType<BrushNode>(actual).brush();
+      const auto& expectedBrush = brushNode->brush();
+      CHECK(actualBrush == expectedBrush);
+      CHECK(actualBrush.vertexPositions() == expectedBrush.vertexPositions());
+      CHECK(faceLineNumbers(actualBrush) == faceLineNumbers(expectedBrush));
+    },
+    [&](const PatchNode* patchNode) {
+      CHECK(requireNodeType<PatchNode>(actual).patch() == patchNode->patch());
+    }));
+
+  REQUIRE(actual.childCount() == expected.childCount());
+  for (size_t i = 0; i < expected.childCount(); ++i)
+  {
+    checkNodesMatch(*actual.children()[i], *expected.children()[i]);
+  }
+}
+
 void setLinkId(Node& node, std::string linkId)
 {
   node.accept(kdl::overload(
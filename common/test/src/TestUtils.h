@@ -145,6 +145,12 @@ const Model::BrushFace* findFaceByPoints(
 void checkFaceTexCoordSystem(const Model::BrushFace& face, bool expectParallel);
 void checkBrushTexCoordSystem(const Model::BrushNode* brushNode, bool expectParallel);
 
+/**
+ * Checks that the given node trees have the same structure, contents and file positions.
+ * Unlike the relational operators of the nodes, this also compares the brush geometry.
+ */
+void checkNodesMatch(const Node& actual, const Node& expected);
+
 void setLinkId(Node& node, std::string linkId);
 
 } // namespace Model
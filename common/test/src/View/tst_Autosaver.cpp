@@ -24,7 +24,9 @@
 #include "Logger.h"
 #include "Model/BrushNode.h"
 #include "Model/EntityNode.h"
+#include "Model/Game.h"
 #include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
 #include "TestUtils.h"
 #include "View/Autosaver.h"
 #include "View/MapDocumentTest.h"
@@ -35,6 +37,7 @@
 
 #include <chrono>
 #include <filesystem>
+#include <sstream>
 #include <thread>
 
 #include "Catch2.h"
@@ -81,6 +84,29 @@ TEST_CASE("AutosaverTest.makeBackupPathMatcher")
   CHECK_FALSE(matcher("test.2-crash.map", getPathInfo));
 }
 
+TEST_CASE("AutosaverTest.makeDeltaPathMatcher")
+{
+  auto env = IO::TestEnvironment{};
+  env.createFile("test.1.map.1.delta", "some content");
+  env.createFile("test.1.map.12.delta", "some content");
+  env.createFile("test.1.map.delta", "some content");
+  env.createFile("test.map.1.delta", "some content");
+  env.createFile("other.1.map.1.delta", "some content");
+  env.createDirectory("test.2.map.1.delta");
+
+  auto fs = IO::DiskFileSystem{env.dir()};
+
+  const auto matcher = makeDeltaPathMatcher("test");
+  const auto getPathInfo = [&](const auto& p) { return fs.pathInfo(p); };
+
+  CHECK(matcher("test.1.map.1.delta", getPathInfo));
+  CHECK(matcher("test.1.map.12.delta", getPathInfo));
+  CHECK_FALSE(matcher("test.1.map.delta", getPathInfo));
+  CHECK_FALSE(matcher("test.map.1.delta", getPathInfo));
+  CHECK_FALSE(matcher("other.1.map.1.delta", getPathInfo));
+  CHECK_FALSE(matcher("test.2.map.1.delta", getPathInfo));
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInterval")
 {
   using namespace std::chrono_literals;
@@ -137,6 +163,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAfterSaveInterv
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -160,6 +187,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -175,6 +203,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
   CHECK(env.fileExists("autosave/test.2.map"));
 }
 
@@ -219,6 +248,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     const auto allPaths = kdl::vec_push_back(initialPaths, "autosave/test.3.map");
 
@@ -243,6 +273,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     CHECK(env.directoryContents("autosave") == allPaths);
     CHECK(
@@ -304,6 +335,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     const auto allPaths = std::vector<std::filesystem::path>{
       "autosave/test.1.map",
@@ -329,6 +361,72 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
   }
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverWritesDeltas")
+{
+  using namespace std::chrono_literals;
+
+  constexpr auto maxBackups = 3u;
+  constexpr auto maxDeltas = 2u;
+
+  auto env = IO::TestEnvironment{};
+  auto logger = NullLogger{};
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  auto autosaver = Autosaver{document, 0s, maxBackups, maxDeltas};
+
+  const auto modifyAndAutosave = [&]() {
+    document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
+    autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
+  };
+
+  const auto serializeDocument = [&]() {
+    auto stream = std::stringstream{};
+    document->game()->writeMap(*document->world(), stream);
+    return stream.str();
+  };
+
+  modifyAndAutosave();
+  CHECK(
+    env.directoryContents("autosave")
+    == std::vector<std::filesystem::path>{"autosave/test.1.map"});
+
+  modifyAndAutosave();
+  CHECK(
+    env.directoryContents("autosave")
+    == std::vector<std::filesystem::path>{
+      "autosave/test.1.map",
+      "autosave/test.1.map.1.delta",
+    });
+  CHECK(
+    restoreDeltaBackup(env.dir() / "autosave/test.1.map.1.delta")
+    == Result<std::string>{serializeDocument()});
+
+  modifyAndAutosave();
+  CHECK(
+    env.directoryContents("autosave")
+    == std::vector<std::filesystem::path>{
+      "autosave/test.1.map",
+      "autosave/test.1.map.1.delta",
+      "autosave/test.1.map.2.delta",
+    });
+  CHECK(
+    restoreDeltaBackup(env.dir() / "autosave/test.1.map.2.delta")
+    == Result<std::string>{serializeDocument()});
+
+  // a new full backup replaces the deltas
+  modifyAndAutosave();
+  CHECK(
+    env.directoryContents("autosave")
+    == std::vector<std::filesystem::path>{
+      "autosave/test.1.map",
+      "autosave/test.2.map",
+    });
+  CHECK(env.loadFile("autosave/test.2.map") == serializeDocument());
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesPresent")
 {
   // https://github.com/TrenchBroom/TrenchBroom/issues/2544
@@ -351,6 +449,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesP
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.2.map"));
 }
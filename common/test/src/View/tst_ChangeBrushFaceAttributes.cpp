@@ -126,6 +126,103 @@ TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.undoRedo")
   }
 }
 
+TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.undoRotation")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+  const auto originalBrush = brushNode->brush();
+
+  const size_t faceIndex = 0u;
+  document->selectBrushFaces({{brushNode, faceIndex}});
+
+  auto rotate = Model::ChangeBrushFaceAttributesRequest{};
+  rotate.addRotation(30.0);
+  document->setFaceAttributes(rotate);
+
+  const auto& rotatedFace = brushNode->brush().face(faceIndex);
+  REQUIRE(rotatedFace.attributes().rotation() == 30.0f);
+  REQUIRE(rotatedFace.textureXAxis() != originalBrush.face(faceIndex).textureXAxis());
+
+  document->undoCommand();
+  CHECK(brushNode->brush() == originalBrush);
+  CHECK(
+    brushNode->brush().face(faceIndex).textureXAxis()
+    == originalBrush.face(faceIndex).textureXAxis());
+  CHECK(
+    brushNode->brush().face(faceIndex).textureYAxis()
+    == originalBrush.face(faceIndex).textureYAxis());
+
+  document->redoCommand();
+  CHECK(brushNode->brush().face(faceIndex).attributes().rotation() == 30.0f);
+  for (size_t i = 1u; i < brushNode->brush().faceCount(); ++i)
+  {
+    CHECK(brushNode->brush().face(i).attributes() == originalBrush.face(i).attributes());
+  }
+}
+
+TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.texturePreview")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+  const size_t faceIndex = 0u;
+  document->selectBrushFaces({{brushNode, faceIndex}});
+
+  const auto originalBrush = brushNode->brush();
+  const auto undoCommandName = document->undoCommandName();
+
+  document->startTexturePreview();
+  REQUIRE(document->isTexturePreviewActive());
+
+  auto rotate = Model::ChangeBrushFaceAttributesRequest{};
+  rotate.addRotation(10.0);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    CHECK(document->previewFaceAttributes(rotate));
+  }
+  CHECK(document->previewShearTextures({0.5f, 0.0f}));
+
+  const auto& face = brushNode->brush().face(faceIndex);
+  CHECK(face.attributes().rotation() == 30.0f);
+
+  // no commands are created while previewing
+  CHECK(document->undoCommandName() == undoCommandName);
+
+  SECTION("Commit")
+  {
+    CHECK(document->commitTexturePreview("Rotate Texture"));
+    CHECK_FALSE(document->isTexturePreviewActive());
+    CHECK(brushNode->brush().face(faceIndex).attributes().rotation() == 30.0f);
+    CHECK(document->undoCommandName() == "Rotate Texture");
+
+    const auto previewedBrush = brushNode->brush();
+
+    document->undoCommand();
+    CHECK(brushNode->brush() == originalBrush);
+    CHECK(
+      brushNode->brush().face(faceIndex).textureXAxis()
+      == originalBrush.face(faceIndex).textureXAxis());
+
+    document->redoCommand();
+    CHECK(brushNode->brush() == previewedBrush);
+    CHECK(
+      brushNode->brush().face(faceIndex).textureXAxis()
+      == previewedBrush.face(faceIndex).textureXAxis());
+  }
+
+  SECTION("Cancel")
+  {
+    document->cancelTexturePreview();
+    CHECK_FALSE(document->isTexturePreviewActive());
+    CHECK(brushNode->brush() == originalBrush);
+    CHECK(
+      brushNode->brush().face(faceIndex).textureXAxis()
+      == originalBrush.face(faceIndex).textureXAxis());
+    CHECK(document->undoCommandName() == undoCommandName);
+  }
+}
+
 TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.setAll")
 {
   auto* brushNode = createBrushNode();
@@ -0,0 +1,142 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapDocumentTest.h"
+#include "Model/EntityNode.h"
+#include "View/ChangeJournal.h"
+
+#include "kdl/vector_utils.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::View
+{
+
+TEST_CASE("ChangeJournal.changesSince")
+{
+  auto node1 = Model::EntityNode{Model::Entity{}};
+  auto node2 = Model::EntityNode{Model::Entity{}};
+
+  auto journal = ChangeJournal{3};
+  CHECK(journal.lastSequenceNumber() == 0u);
+  CHECK(journal.changesSince(0u) == std::vector<ChangeJournalEntry>{});
+
+  journal.record(ChangeType::NodesWereAdded, {&node1, &node2});
+  journal.record(ChangeType::NodesDidChange, {&node1});
+
+  SECTION("Returns the changes after the given sequence number")
+  {
+    CHECK(journal.lastSequenceNumber() == 2u);
+    CHECK(
+      journal.changesSince(0u)
+      == std::vector<ChangeJournalEntry>{
+        {1u, ChangeType::NodesWereAdded, {&node1, &node2}},
+        {2u, ChangeType::NodesDidChange, {&node1}},
+      });
+    CHECK(
+      journal.changesSince(1u)
+      == std::vector<ChangeJournalEntry>{
+        {2u, ChangeType::NodesDidChange, {&node1}},
+      });
+    CHECK(journal.changesSince(2u) == std::vector<ChangeJournalEntry>{});
+  }
+
+  SECTION("Changes to no nodes are not recorded")
+  {
+    journal.record(ChangeType::NodesDidChange, {});
+    CHECK(journal.lastSequenceNumber() == 2u);
+  }
+
+  SECTION("Discards the oldest entries when the capacity is exceeded")
+  {
+    journal.record(ChangeType::NodesDidChange, {&node2});
+    journal.record(ChangeType::NodesWereRemoved, {&node1});
+
+    CHECK(journal.changesSince(0u) == std::nullopt);
+    CHECK(
+      journal.changesSince(1u)
+      == std::vector<ChangeJournalEntry>{
+        {2u, ChangeType::NodesDidChange, {&node1}},
+        {3u, ChangeType::NodesDidChange, {&node2}},
+        {4u, ChangeType::NodesWereRemoved, {&node1}},
+      });
+  }
+
+  SECTION("Resets discard all previous entries")
+  {
+    journal.record(ChangeType::DocumentWasReset, {});
+
+    CHECK(journal.changesSince(1u) == std::nullopt);
+    CHECK(
+      journal.changesSince(2u)
+      == std::vector<ChangeJournalEntry>{
+        {3u, ChangeType::DocumentWasReset, {}},
+      });
+  }
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "ChangeJournal.recordDocumentChanges")
+{
+  const auto& journal = document->changeJournal();
+  const auto sequenceNumber = journal.lastSequenceNumber();
+
+  const auto changeTypes = [&]() {
+    return kdl::vec_transform(
+      journal.changesSince(sequenceNumber).value(),
+      [](const auto& entry) { return entry.type; });
+  };
+
+  auto* entityNode = new Model::EntityNode{Model::Entity{}};
+  document->addNodes({{document->parentForNodes(), {entityNode}}});
+
+  SECTION("Adding nodes")
+  {
+    CHECK(
+      journal.changesSince(sequenceNumber).value()
+      == std::vector<ChangeJournalEntry>{
+        {sequenceNumber + 1u, ChangeType::NodesWereAdded, {entityNode}},
+      });
+  }
+
+  SECTION("Changing nodes and the selection")
+  {
+    document->selectNodes({entityNode});
+    document->setProperty("target", "some_target");
+
+    const auto types = changeTypes();
+    CHECK(kdl::vec_contains(types, ChangeType::SelectionDidChange));
+    CHECK(types.back() == ChangeType::NodesDidChange);
+  }
+
+  SECTION("Hiding nodes")
+  {
+    document->hide({entityNode});
+    CHECK(kdl::vec_contains(changeTypes(), ChangeType::NodeVisibilityDidChange));
+  }
+
+  SECTION("Removing nodes")
+  {
+    document->removeNodes({entityNode});
+    CHECK(changeTypes().back() == ChangeType::NodesWereRemoved);
+  }
+}
+
+} // namespace TrenchBroom::View
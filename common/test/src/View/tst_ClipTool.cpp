@@ -89,6 +89,40 @@ TEST_CASE_METHOD(ValveMapDocumentTest, "ClipToolTest")
     CHECK(clippedBrushNode2->linkId() != originalLinkId);
     CHECK(clippedBrushNode1->linkId() != clippedBrushNode2->linkId());
   }
+
+  SECTION("Clipping uses the latest clip points")
+  {
+    auto* brushNode = createBrushNode();
+    document->addNodes({{document->parentForNodes(), {brushNode}}});
+    document->selectNodes({brushNode});
+
+    const auto* defaultLayer = document->world()->defaultLayer();
+
+    auto tool = ClipTool{document};
+    REQUIRE(tool.activate());
+
+    tool.addPoint(vm::vec3{0, 16, 16}, {});
+    tool.addPoint(vm::vec3{0, -16, 16}, {});
+    tool.addPoint(vm::vec3{0, -16, -16}, {});
+    REQUIRE(tool.canClip());
+
+    // replaces the clip that is still being computed
+    REQUIRE(tool.reset());
+    tool.addPoint(vm::vec3{8, 16, 16}, {});
+    tool.addPoint(vm::vec3{8, -16, 16}, {});
+    tool.addPoint(vm::vec3{8, -16, -16}, {});
+    REQUIRE(tool.canClip());
+
+    tool.performClip();
+
+    REQUIRE(defaultLayer->childCount() == 1);
+    const auto* clippedBrushNode =
+      dynamic_cast<const Model::BrushNode*>(defaultLayer->children().front());
+    REQUIRE(clippedBrushNode);
+
+    const auto& bounds = clippedBrushNode->logicalBounds();
+    CHECK((bounds.min.x() == 8.0 || bounds.max.x() == 8.0));
+  }
 }
 
 } // namespace TrenchBroom::View
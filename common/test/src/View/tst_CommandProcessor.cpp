@@ -242,6 +242,31 @@ public:
   }
 };
 
+class SizedCommand : public UndoableCommand
+{
+private:
+  size_t m_size;
+
+public:
+  SizedCommand(std::string name, const size_t size)
+    : UndoableCommand{std::move(name), false}
+    , m_size{size}
+  {
+  }
+
+  std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade*) override
+  {
+    return std::make_unique<CommandResult>(true);
+  }
+
+  std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade*) override
+  {
+    return std::make_unique<CommandResult>(true);
+  }
+
+  size_t doEstimateMemoryUsage() const override { return m_size; }
+};
+
 TEST_CASE("CommandProcessorTest.doAndUndoSuccessfulCommand")
 {
   /*
@@ -818,5 +843,89 @@ TEST_CASE("CommandProcessorTest.collateTransactions")
 
   commandProcessor.undo();
 }
+
+TEST_CASE("CommandProcessorTest.memoryUsage")
+{
+  auto commandProcessor = CommandProcessor{nullptr};
+  CHECK(commandProcessor.memoryUsage() == 0u);
+
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd1", 100u));
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd2", 200u));
+  CHECK(commandProcessor.memoryUsage() == 300u);
+
+  // moving a command to the redo stack does not change the memory usage
+  commandProcessor.undo();
+  CHECK(commandProcessor.memoryUsage() == 300u);
+
+  // executing a new command clears the redo stack
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd3", 50u));
+  CHECK(commandProcessor.memoryUsage() == 150u);
+
+  SECTION("Transactions are accounted for when they are committed")
+  {
+    commandProcessor.startTransaction("transaction", TransactionScope::Oneshot);
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd4", 20u));
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd5", 30u));
+    CHECK(commandProcessor.memoryUsage() == 150u);
+
+    commandProcessor.commitTransaction();
+    CHECK(commandProcessor.memoryUsage() > 200u);
+
+    commandProcessor.undo();
+    CHECK(commandProcessor.memoryUsage() > 200u);
+  }
+
+  SECTION("Clearing resets the memory usage")
+  {
+    commandProcessor.clear();
+    CHECK(commandProcessor.memoryUsage() == 0u);
+  }
+}
+
+TEST_CASE("CommandProcessorTest.memoryLimit")
+{
+  auto commandProcessor = CommandProcessor{nullptr};
+  commandProcessor.setMemoryLimit(250u);
+
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd1", 100u));
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd2", 100u));
+  CHECK(commandProcessor.memoryUsage() == 200u);
+
+  // the oldest command is evicted
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd3", 100u));
+  CHECK(commandProcessor.memoryUsage() == 200u);
+
+  commandProcessor.undo();
+  commandProcessor.undo();
+  CHECK_FALSE(commandProcessor.canUndo());
+  CHECK(commandProcessor.redoCommandName() == "cmd2");
+
+  SECTION("The most recent command is never evicted")
+  {
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd4", 1000u));
+    CHECK(commandProcessor.memoryUsage() == 1000u);
+    CHECK(commandProcessor.canUndo());
+    CHECK(commandProcessor.undoCommandName() == "cmd4");
+  }
+
+  SECTION("Lowering the limit evicts commands")
+  {
+    commandProcessor.redo();
+    commandProcessor.redo();
+    CHECK(commandProcessor.memoryUsage() == 200u);
+
+    commandProcessor.setMemoryLimit(150u);
+    CHECK(commandProcessor.memoryUsage() == 100u);
+    CHECK(commandProcessor.undoCommandName() == "cmd3");
+  }
+
+  SECTION("A limit of 0 means no limit")
+  {
+    commandProcessor.setMemoryLimit(0u);
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd4", 1000u));
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd5", 1000u));
+    CHECK(commandProcessor.memoryUsage() == 2000u);
+  }
+}
 } // namespace View
 } // namespace TrenchBroom
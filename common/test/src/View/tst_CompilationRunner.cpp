@@ -348,6 +348,53 @@ TEST_CASE_METHOD(MapDocumentTest, "CompilationRunner.stopAfterFirstError")
   CHECK_FALSE(testEnvironment.fileExists(should_not_exist));
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "CompilationRunner.runConcurrentTasks")
+{
+  auto variables = EL::NullVariableStore{};
+  auto output = QTextEdit{};
+  auto outputAdapter = TextOutputAdapter{&output};
+
+  auto testEnvironment = IO::TestEnvironment{};
+
+  auto compilationProfile = Model::CompilationProfile{
+    "name",
+    testEnvironment.dir().string(),
+    {
+      Model::CompilationRunTool{true, RETURN_EXITCODE_PATH, "--exit 0", true},
+      Model::CompilationRunTool{true, RETURN_EXITCODE_PATH, "--exit 0", true, true},
+      Model::CompilationRunTool{true, RETURN_EXITCODE_PATH, "--exit 0", true},
+    }};
+
+  auto runner = CompilationRunner{
+    CompilationContext{document, variables, outputAdapter, false}, compilationProfile};
+
+  auto compilationEndedSpy = QSignalSpy{&runner, SIGNAL(compilationEnded())};
+  REQUIRE(compilationEndedSpy.isValid());
+
+  runner.execute();
+  REQUIRE(runner.running());
+
+  const auto endTime = std::chrono::system_clock::now() + 5000ms;
+  while (runner.running() && std::chrono::system_clock::now() < endTime)
+  {
+    TrenchBroomApp::instance().processEvents();
+    std::this_thread::sleep_for(10ms);
+  }
+
+  REQUIRE(!runner.running());
+  REQUIRE(compilationEndedSpy.count() == 1);
+
+  // the output of the first two tasks is labelled, the output of the last one isn't
+  outputAdapter.flush();
+  const auto text = output.toPlainText();
+  CHECK(text.contains("[1] #### Executing"));
+  CHECK(text.contains("[1] #### Finished with exit code 0"));
+  CHECK(text.contains("[2] #### Executing"));
+  CHECK(text.contains("[2] #### Finished with exit code 0"));
+  CHECK_FALSE(text.contains("[3]"));
+  CHECK(text.count("#### Finished with exit code 0") == 3);
+}
+
 TEST_CASE("CompilationRunner.interpolateToolsVariables")
 {
   auto [document, game, gameConfig] = View::loadMapDocument(
@@ -29,6 +29,7 @@
 #include "TestUtils.h"
 
 #include "kdl/result.h"
+#include "kdl/vector_utils.h"
 
 #include <filesystem>
 
@@ -240,6 +241,45 @@ TEST_CASE_METHOD(MapDocumentTest, "CsgTest.csgSubtractMultipleBrushes")
   CHECK(remainder2->logicalBounds() == expectedBBox2);
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "CsgTest.csgSubtractOnlyTouchesIntersectingBrushes")
+{
+  const Model::BrushBuilder builder(
+    document->world()->mapFormat(), document->worldBounds());
+
+  auto* entity = new Model::EntityNode{Model::Entity{}};
+  document->addNodes({{document->parentForNodes(), {entity}}});
+
+  auto* minuend = new Model::BrushNode(
+    builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture")
+      .value());
+  auto* distantBrush = new Model::BrushNode(
+    builder
+      .createCuboid(vm::bbox3(vm::vec3(512, 512, 0), vm::vec3(576, 576, 64)), "texture")
+      .value());
+  auto* subtrahend = new Model::BrushNode(
+    builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(32, 64, 64)), "texture")
+      .value());
+
+  document->addNodes({{entity, {minuend, distantBrush, subtrahend}}});
+  CHECK(entity->children().size() == 3u);
+
+  document->selectNodes({subtrahend});
+  CHECK(document->csgSubtract());
+  CHECK(entity->children().size() == 2u);
+
+  // the distant brush is neither removed nor replaced
+  CHECK(kdl::vec_contains(entity->children(), distantBrush));
+  CHECK(
+    distantBrush->logicalBounds()
+    == vm::bbox3(vm::vec3(512, 512, 0), vm::vec3(576, 576, 64)));
+
+  const auto selectedBrushes = document->selectedNodes().brushes();
+  REQUIRE(selectedBrushes.size() == 1u);
+  CHECK(
+    selectedBrushes.front()->logicalBounds()
+    == vm::bbox3(vm::vec3(32, 0, 0), vm::vec3(64, 64, 64)));
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "CsgTest.csgSubtractAndUndoRestoresSelection")
 {
   const Model::BrushBuilder builder(
@@ -267,6 +307,54 @@ TEST_CASE_METHOD(MapDocumentTest, "CsgTest.csgSubtractAndUndoRestoresSelection")
     Catch::Equals(std::vector<Model::BrushNode*>{subtrahend1}));
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "CsgTest.csgIntersectMultipleBrushes")
+{
+  const Model::BrushBuilder builder(
+    document->world()->mapFormat(), document->worldBounds());
+
+  auto brushNodes = std::vector<Model::BrushNode*>{};
+  for (size_t i = 0; i < 5; ++i)
+  {
+    const auto offset = double(i) * 8.0;
+    brushNodes.push_back(new Model::BrushNode(
+      builder
+        .createCuboid(
+          vm::bbox3(vm::vec3(offset, 0, 0), vm::vec3(offset + 64, 64, 64)), "texture")
+        .value()));
+  }
+
+  const auto nodes = kdl::vec_static_cast<Model::Node*>(brushNodes);
+  document->addNodes({{document->parentForNodes(), nodes}});
+  document->selectNodes(nodes);
+
+  SECTION("The brushes intersect")
+  {
+    CHECK(document->csgIntersect());
+    CHECK(document->currentLayer()->childCount() == 1u);
+
+    const auto selectedBrushes = document->selectedNodes().brushes();
+    REQUIRE(selectedBrushes.size() == 1u);
+    CHECK(
+      selectedBrushes.front()->logicalBounds()
+      == vm::bbox3(vm::vec3(32, 0, 0), vm::vec3(64, 64, 64)));
+  }
+
+  SECTION("The brushes don't intersect")
+  {
+    auto* disjointBrushNode = new Model::BrushNode(
+      builder
+        .createCuboid(vm::bbox3(vm::vec3(256, 0, 0), vm::vec3(320, 64, 64)), "texture")
+        .value());
+    document->addNodes({{document->parentForNodes(), {disjointBrushNode}}});
+    document->selectNodes({disjointBrushNode});
+
+    // the brushes are removed, but no intersection is added
+    CHECK(document->csgIntersect());
+    CHECK(document->currentLayer()->childCount() == 0u);
+    CHECK(document->selectedNodes().empty());
+  }
+}
+
 // Test for https://github.com/TrenchBroom/TrenchBroom/issues/3755
 TEST_CASE("CsgTest.csgSubtractFailure")
 {
@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityDefinition.h"
+#include "Assets/PropertyDefinition.h"
+#include "Color.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "View/EntityPropertyModel.h"
+
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::View
+{
+namespace
+{
+
+void checkRows(
+  const EntityPropertySummary& summary, std::vector<Model::EntityNodeBase*> nodes)
+{
+  nodes = kdl::vec_sort_and_remove_duplicates(std::move(nodes));
+  CHECK(summary.rows(true, true) == PropertyRow::rowsForEntityNodes(nodes, true, true));
+  CHECK(
+    summary.rows(false, false) == PropertyRow::rowsForEntityNodes(nodes, false, false));
+}
+
+} // namespace
+
+TEST_CASE("EntityPropertySummary")
+{
+  auto definition = Assets::PointEntityDefinition{
+    "light",
+    Color{},
+    vm::bbox3{8.0},
+    "",
+    {std::make_shared<Assets::StringPropertyDefinition>(
+      "style", "Light style", "", false, "0")},
+    {},
+    {}};
+
+  auto lightNode1 = Model::EntityNode{Model::Entity{
+    {}, {{"classname", "light"}, {"origin", "0 0 0"}, {"light", "300"}}}};
+  auto lightNode2 =
+    Model::EntityNode{Model::Entity{{}, {{"classname", "light"}, {"origin", "8 0 0"}}}};
+  auto otherNode = Model::EntityNode{Model::Entity{
+    {}, {{"classname", "info_null"}, {"origin", "8 0 0"}, {"target", "t1"}}}};
+
+  lightNode1.setDefinition(&definition);
+  lightNode2.setDefinition(&definition);
+
+  auto summary = EntityPropertySummary{};
+
+  SECTION("Adding nodes")
+  {
+    summary.setNodes({&lightNode1});
+    checkRows(summary, {&lightNode1});
+
+    summary.setNodes({&lightNode1, &lightNode2, &otherNode});
+    checkRows(summary, {&lightNode1, &lightNode2, &otherNode});
+  }
+
+  SECTION("Removing nodes")
+  {
+    summary.setNodes({&lightNode1, &lightNode2, &otherNode});
+
+    summary.setNodes({&lightNode2, &otherNode});
+    checkRows(summary, {&lightNode2, &otherNode});
+
+    summary.setNodes({});
+    CHECK(summary.rows(true, true).empty());
+  }
+
+  SECTION("Updating nodes")
+  {
+    summary.setNodes({&lightNode1, &lightNode2});
+
+    lightNode2.setEntity(Model::Entity{
+      {}, {{"classname", "light"}, {"origin", "0 0 0"}, {"style", "2"}}});
+    summary.updateNodes({&lightNode2, &otherNode});
+    checkRows(summary, {&lightNode1, &lightNode2});
+  }
+
+  SECTION("Worldspawn")
+  {
+    auto worldNode = Model::WorldNode{{}, {}, Model::MapFormat::Standard};
+    summary.setNodes({&worldNode});
+    checkRows(summary, {&worldNode});
+  }
+
+  SECTION("Protected properties")
+  {
+    auto groupNode = Model::GroupNode{Model::Group{"group"}};
+
+    auto protectedEntity = Model::Entity{
+      {}, {{"classname", "info_null"}, {"target", "t1"}, {"target2", "t2"}}};
+    protectedEntity.setProtectedProperties({"target"});
+
+    auto* protectingNode = new Model::EntityNode{std::move(protectedEntity)};
+    auto* groupedNode = new Model::EntityNode{
+      Model::Entity{{}, {{"classname", "info_null"}, {"target", "t1"}}}};
+    groupNode.addChildren({protectingNode, groupedNode});
+
+    summary.setNodes({protectingNode});
+    checkRows(summary, {protectingNode});
+
+    summary.setNodes({protectingNode, groupedNode});
+    checkRows(summary, {protectingNode, groupedNode});
+
+    summary.setNodes({protectingNode, groupedNode, &otherNode});
+    checkRows(summary, {protectingNode, groupedNode, &otherNode});
+  }
+}
+
+} // namespace TrenchBroom::View
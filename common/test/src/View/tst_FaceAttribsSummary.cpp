@@ -0,0 +1,174 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "View/FaceAttribsSummary.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::View
+{
+namespace
+{
+
+std::optional<FaceAttribsSummary> summarize(
+  const std::vector<Model::BrushFaceHandle>& faceHandles)
+{
+  if (faceHandles.empty())
+  {
+    return std::nullopt;
+  }
+
+  auto result = FaceAttribsSummary::forFace(faceHandles.front().face());
+  for (size_t i = 1; i < faceHandles.size(); ++i)
+  {
+    result.merge(FaceAttribsSummary::forFace(faceHandles[i].face()));
+  }
+  return result;
+}
+
+void setFaceAttributes(
+  Model::BrushNode& brushNode,
+  const size_t faceIndex,
+  const std::function<void(Model::BrushFaceAttributes&)>& change)
+{
+  auto brush = brushNode.brush();
+  auto attributes = brush.face(faceIndex).attributes();
+  change(attributes);
+  brush.face(faceIndex).setAttributes(attributes);
+  brushNode.setBrush(std::move(brush));
+}
+
+} // namespace
+
+TEST_CASE("FaceAttribsSummary.merge")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  auto builder = Model::BrushBuilder{Model::MapFormat::Quake2, worldBounds};
+  auto brushNode = Model::BrushNode{builder.createCube(64.0, "texture").value()};
+
+  setFaceAttributes(
+    brushNode, 0, [](auto& attributes) { attributes.setSurfaceFlags(0b011); });
+  setFaceAttributes(
+    brushNode, 1, [](auto& attributes) { attributes.setSurfaceFlags(0b110); });
+  setFaceAttributes(brushNode, 1, [](auto& attributes) { attributes.setXOffset(8.0f); });
+
+  auto summary = FaceAttribsSummary::forFace(brushNode.brush().face(0));
+  CHECK(summary.setSurfaceFlags == 0b011);
+  CHECK(summary.mixedSurfaceFlags == 0);
+  CHECK_FALSE(summary.xOffsetMulti);
+
+  summary.merge(FaceAttribsSummary::forFace(brushNode.brush().face(1)));
+  CHECK(summary.setSurfaceFlags == 0b010);
+  CHECK(summary.mixedSurfaceFlags == 0b101);
+  CHECK(summary.xOffset == 0.0f);
+  CHECK(summary.xOffsetMulti);
+  CHECK(summary.hasSurfaceFlags);
+  CHECK_FALSE(summary.textureMulti);
+  CHECK_FALSE(summary.hasColor);
+}
+
+TEST_CASE("FaceAttribsSummaryCache")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  auto builder = Model::BrushBuilder{Model::MapFormat::Quake2, worldBounds};
+
+  auto brushNodes = std::vector<std::unique_ptr<Model::BrushNode>>{};
+  auto faceHandles = std::vector<Model::BrushFaceHandle>{};
+  for (size_t i = 0; i < 2 * FaceAttribsSummaryCache::ChunkSize / 6 + 10; ++i)
+  {
+    auto& brushNode = *brushNodes.emplace_back(std::make_unique<Model::BrushNode>(
+      builder.createCube(64.0, "texture").value()));
+    faceHandles = kdl::vec_concat(std::move(faceHandles), Model::toHandles(&brushNode));
+  }
+  REQUIRE(faceHandles.size() > 2 * FaceAttribsSummaryCache::ChunkSize);
+
+  auto cache = FaceAttribsSummaryCache{};
+  CHECK_FALSE(cache.valid());
+
+  cache.setFaces(faceHandles);
+  CHECK(cache.valid());
+  CHECK(cache.summary() == summarize(faceHandles));
+  CHECK_FALSE(cache.summary()->xOffsetMulti);
+
+  SECTION("Updates changed brushes")
+  {
+    auto& brushNode = *brushNodes.back();
+    setFaceAttributes(
+      brushNode, 2, [](auto& attributes) { attributes.setXOffset(16.0f); });
+
+    cache.brushesDidChange({&brushNode});
+    CHECK(cache.valid());
+    CHECK(cache.summary() == summarize(faceHandles));
+    CHECK(cache.summary()->xOffsetMulti);
+
+    setFaceAttributes(
+      brushNode, 2, [](auto& attributes) { attributes.setXOffset(0.0f); });
+
+    cache.brushesDidChange({&brushNode});
+    CHECK(cache.summary() == summarize(faceHandles));
+    CHECK_FALSE(cache.summary()->xOffsetMulti);
+  }
+
+  SECTION("Ignores brushes without summarized faces")
+  {
+    auto otherBrushNode = Model::BrushNode{builder.createCube(64.0, "other").value()};
+    cache.brushesDidChange({&otherBrushNode});
+    CHECK(cache.valid());
+    CHECK(cache.summary() == summarize(faceHandles));
+  }
+
+  SECTION("Invalidates if the number of faces changes")
+  {
+    auto& brushNode = *brushNodes.front();
+    brushNode.setBrush(
+      builder.createBrush(
+        std::vector<vm::vec3>{{0, 0, 0}, {64, 0, 0}, {0, 64, 0}, {0, 0, 64}}, "texture")
+        .value());
+
+    cache.brushesDidChange({&brushNode});
+    CHECK_FALSE(cache.valid());
+  }
+
+  SECTION("Summarizes no faces")
+  {
+    cache.setFaces({});
+    CHECK(cache.valid());
+    CHECK(cache.summary() == std::nullopt);
+  }
+}
+
+} // namespace TrenchBroom::View
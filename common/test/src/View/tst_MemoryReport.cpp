@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapDocumentTest.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Renderer/VboManager.h"
+#include "View/MemoryReport.h"
+
+#include <sstream>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace View
+{
+
+TEST_CASE_METHOD(MapDocumentTest, "MemoryReport.createMemoryReport")
+{
+  auto vboManager = Renderer::VboManager{nullptr};
+
+  const auto before = createMemoryReport(*document, vboManager);
+
+  auto* brushNode = createBrushNode();
+  auto* entityNode =
+    new Model::EntityNode{Model::Entity{{}, {{"some_key", "some_value"}}}};
+  document->addNodes({{document->parentForNodes(), {brushNode, entityNode}}});
+
+  const auto after = createMemoryReport(*document, vboManager);
+
+  CHECK(after.brushGeometry > before.brushGeometry);
+  CHECK(after.faceAttributes > before.faceAttributes);
+  CHECK(after.entityProperties > before.entityProperties);
+  CHECK(after.nodes > before.nodes);
+  CHECK(after.nodeTree > before.nodeTree);
+  CHECK(after.undoStack > before.undoStack);
+  CHECK(after.vertexBuffers == 0u);
+
+  auto total = size_t(0);
+  for (const auto& [subsystem, bytes] : after.entries())
+  {
+    total += bytes;
+  }
+  CHECK(after.total() == total);
+
+  auto str = std::stringstream{};
+  str << after;
+  CHECK(str.str().find("\n  Brush geometry: ") != std::string::npos);
+}
+
+} // namespace View
+} // namespace TrenchBroom
@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapDocumentTest.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
+#include "View/InputState.h"
+#include "View/MoveObjectsTool.h"
+
+#include "vm/bbox.h"
+#include "vm/bbox_io.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/mat_io.h"
+#include "vm/vec.h"
+
+#include <optional>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::View
+{
+
+TEST_CASE_METHOD(MapDocumentTest, "MoveObjectsTool")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+  document->selectNodes({brushNode});
+
+  const auto* defaultLayer = document->world()->defaultLayer();
+  const auto originalBounds = brushNode->logicalBounds();
+
+  auto tool = MoveObjectsTool{document};
+
+  SECTION("Dragging only updates the preview transformation")
+  {
+    REQUIRE(tool.startMove(InputState{}));
+    CHECK(tool.move(InputState{}, vm::vec3{16, 0, 0}) == MoveObjectsTool::MR_Continue);
+    CHECK(tool.move(InputState{}, vm::vec3{0, 16, 0}) == MoveObjectsTool::MR_Continue);
+
+    CHECK(
+      document->selectionPreviewTransformation()
+      == std::optional{vm::translation_matrix(vm::vec3{16, 16, 0})});
+    CHECK(
+      document->selectionPreviewBounds()
+      == originalBounds.translate(vm::vec3{16, 16, 0}));
+    CHECK(brushNode->logicalBounds() == originalBounds);
+
+    tool.cancelMove();
+  }
+
+  SECTION("Ending the drag commits the accumulated move")
+  {
+    REQUIRE(tool.startMove(InputState{}));
+    tool.move(InputState{}, vm::vec3{16, 0, 0});
+    tool.move(InputState{}, vm::vec3{0, 16, 0});
+    tool.endMove(InputState{});
+
+    CHECK(document->selectionPreviewTransformation() == std::nullopt);
+    CHECK(brushNode->logicalBounds() == originalBounds.translate(vm::vec3{16, 16, 0}));
+    CHECK(document->undoCommandName() == "Move Objects");
+
+    document->undoCommand();
+    CHECK(brushNode->logicalBounds() == originalBounds);
+  }
+
+  SECTION("Ending a drag without moving does not change the objects")
+  {
+    REQUIRE(tool.startMove(InputState{}));
+    tool.endMove(InputState{});
+
+    CHECK(document->selectionPreviewTransformation() == std::nullopt);
+    CHECK(brushNode->logicalBounds() == originalBounds);
+  }
+
+  SECTION("Moves that leave the world bounds are denied")
+  {
+    REQUIRE(tool.startMove(InputState{}));
+    CHECK(
+      tool.move(InputState{}, vm::vec3{document->worldBounds().max.x(), 0, 0})
+      == MoveObjectsTool::MR_Deny);
+    CHECK(document->selectionPreviewTransformation() == std::nullopt);
+
+    tool.endMove(InputState{});
+    CHECK(brushNode->logicalBounds() == originalBounds);
+  }
+
+  SECTION("Cancelling the drag discards the move")
+  {
+    REQUIRE(tool.startMove(InputState{}));
+    tool.move(InputState{}, vm::vec3{16, 0, 0});
+    tool.cancelMove();
+
+    CHECK(document->selectionPreviewTransformation() == std::nullopt);
+    CHECK(brushNode->logicalBounds() == originalBounds);
+    CHECK(defaultLayer->childCount() == 1u);
+  }
+
+  SECTION("Duplicating objects")
+  {
+    auto inputState = InputState{};
+    inputState.setModifierKeys(ModifierKeys::MKCtrlCmd);
+
+    REQUIRE(tool.startMove(inputState));
+    tool.move(inputState, vm::vec3{16, 0, 0});
+    REQUIRE(defaultLayer->childCount() == 2u);
+
+    SECTION("Ending the drag moves the duplicates")
+    {
+      tool.endMove(inputState);
+
+      CHECK(document->undoCommandName() == "Duplicate Objects");
+      CHECK(brushNode->logicalBounds() == originalBounds);
+
+      const auto* duplicateNode =
+        dynamic_cast<const Model::BrushNode*>(defaultLayer->children().back());
+      REQUIRE(duplicateNode != nullptr);
+      CHECK(
+        duplicateNode->logicalBounds() == originalBounds.translate(vm::vec3{16, 0, 0}));
+    }
+
+    SECTION("Cancelling the drag removes the duplicates")
+    {
+      tool.cancelMove();
+
+      CHECK(document->selectionPreviewTransformation() == std::nullopt);
+      CHECK(defaultLayer->childCount() == 1u);
+      CHECK(brushNode->logicalBounds() == originalBounds);
+    }
+  }
+}
+
+} // namespace TrenchBroom::View
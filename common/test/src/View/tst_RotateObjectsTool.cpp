@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapDocumentTest.h"
+#include "Model/BrushNode.h"
+#include "View/RotateObjectsTool.h"
+
+#include "vm/approx.h"
+#include "vm/bbox.h"
+#include "vm/bbox_io.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/mat_io.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+#include "vm/vec_io.h"
+
+#include <QStackedLayout>
+#include <QWidget>
+
+#include <optional>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::View
+{
+
+TEST_CASE_METHOD(MapDocumentTest, "RotateObjectsTool")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+  document->selectNodes({brushNode});
+
+  const auto originalBounds = brushNode->logicalBounds();
+
+  auto tool = RotateObjectsTool{document};
+
+  // the tool updates its page when the rotation center changes
+  auto widget = QWidget{};
+  tool.createPage(new QStackedLayout{&widget});
+  REQUIRE(tool.activate());
+
+  const auto center = vm::vec3{64, 0, 0};
+  const auto axis = vm::vec3::pos_z();
+  const auto angle = vm::to_radians(90.0);
+
+  // rotating the cube [-16, 16]^3 by 90 degrees about the z axis through the center
+  const auto rotatedBounds = vm::bbox3{vm::vec3{48, -80, -16}, vm::vec3{80, -48, 16}};
+
+  SECTION("Dragging only updates the preview transformation")
+  {
+    tool.beginRotation();
+    tool.applyRotation(center, axis, vm::to_radians(45.0));
+    tool.applyRotation(center, axis, angle);
+
+    const auto previewTransformation = document->selectionPreviewTransformation();
+    REQUIRE(previewTransformation != std::nullopt);
+    CHECK(
+      *previewTransformation
+      == vm::translation_matrix(center) * vm::rotation_matrix(axis, angle)
+           * vm::translation_matrix(-center));
+    CHECK(brushNode->logicalBounds() == originalBounds);
+
+    tool.cancelRotation();
+  }
+
+  SECTION("Committing the rotation applies the last rotation")
+  {
+    tool.beginRotation();
+    tool.applyRotation(center, axis, vm::to_radians(45.0));
+    tool.applyRotation(center, axis, angle);
+    tool.commitRotation();
+
+    CHECK(document->selectionPreviewTransformation() == std::nullopt);
+    CHECK(brushNode->logicalBounds().min == vm::approx{rotatedBounds.min});
+    CHECK(brushNode->logicalBounds().max == vm::approx{rotatedBounds.max});
+    CHECK(document->undoCommandName() == "Rotate Objects");
+
+    document->undoCommand();
+    CHECK(brushNode->logicalBounds() == originalBounds);
+  }
+
+  SECTION("Committing without a rotation does not change the objects")
+  {
+    tool.beginRotation();
+    tool.commitRotation();
+
+    CHECK(document->selectionPreviewTransformation() == std::nullopt);
+    CHECK(brushNode->logicalBounds() == originalBounds);
+  }
+
+  SECTION("Cancelling the rotation discards it")
+  {
+    tool.beginRotation();
+    tool.applyRotation(center, axis, angle);
+    tool.cancelRotation();
+
+    CHECK(document->selectionPreviewTransformation() == std::nullopt);
+    CHECK(brushNode->logicalBounds() == originalBounds);
+  }
+}
+
+} // namespace TrenchBroom::View
@@ -23,6 +23,7 @@
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/PatchNode.h"
+#include "Model/VisibilityState.h"
 
 #include "Catch2.h"
 
@@ -167,5 +168,32 @@ TEST_CASE_METHOD(MapDocumentTest, "SetVisibilityState.isolate")
     }
   }
 }
+TEST_CASE_METHOD(MapDocumentTest, "SetVisibilityState.undo")
+{
+  auto* brushNode = createBrushNode();
+  auto* entityNode = new Model::EntityNode{Model::Entity{}};
+  auto* patchNode = createPatchNode();
+  document->addNodes({{document->parentForNodes(), {brushNode, entityNode, patchNode}}});
+  document->deselectAll();
+
+  document->hide({entityNode});
+  document->show({patchNode});
+
+  REQUIRE(brushNode->visibilityState() == Model::VisibilityState::Inherited);
+  REQUIRE(entityNode->visibilityState() == Model::VisibilityState::Hidden);
+  REQUIRE(patchNode->visibilityState() == Model::VisibilityState::Shown);
+
+  // the patch node is passed twice
+  document->hide({brushNode, entityNode, patchNode, patchNode});
+  CHECK(brushNode->visibilityState() == Model::VisibilityState::Hidden);
+  CHECK(entityNode->visibilityState() == Model::VisibilityState::Hidden);
+  CHECK(patchNode->visibilityState() == Model::VisibilityState::Hidden);
+
+  document->undoCommand();
+  CHECK(brushNode->visibilityState() == Model::VisibilityState::Inherited);
+  CHECK(entityNode->visibilityState() == Model::VisibilityState::Hidden);
+  CHECK(patchNode->visibilityState() == Model::VisibilityState::Shown);
+}
+
 } // namespace View
 } // namespace TrenchBroom
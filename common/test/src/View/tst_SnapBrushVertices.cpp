@@ -17,12 +17,23 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Error.h"
+#include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/NodeCollection.h"
 #include "View/Grid.h"
 #include "View/MapDocument.h"
 #include "View/MapDocumentTest.h"
 
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/mat_ext.h"
+#include "vm/vec.h"
+
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom
@@ -56,5 +67,33 @@ TEST_CASE_METHOD(MapDocumentTest, "SnapBrushVerticesTest.snapVerticesCrash_2244"
   CHECK(document->selectedNodes().brushCount() == 1u);
   CHECK_NOTHROW(document->snapVertices(document->grid().actualSize()));
 }
+
+TEST_CASE_METHOD(MapDocumentTest, "SnapBrushVerticesTest.snapVerticesOfManyBrushes")
+{
+  auto brushNodes = std::vector<Model::BrushNode*>{};
+  for (size_t i = 0; i < 32; ++i)
+  {
+    const auto offset = vm::vec3{64.0 * double(i) + 0.25, 0.25, -0.25};
+    brushNodes.push_back(createBrushNode("texture", [&](Model::Brush& brush) {
+      const auto transformation = vm::translation_matrix(offset);
+      REQUIRE(
+        brush.transform(document->worldBounds(), transformation, false).is_success());
+    }));
+  }
+
+  const auto nodes = kdl::vec_static_cast<Model::Node*>(brushNodes);
+  document->addNodes({{document->parentForNodes(), nodes}});
+  document->selectNodes(nodes);
+
+  CHECK(document->snapVertices(1.0));
+
+  for (size_t i = 0; i < brushNodes.size(); ++i)
+  {
+    const auto center = vm::vec3{64.0 * double(i), 0.0, 0.0};
+    CHECK(
+      brushNodes[i]->logicalBounds()
+      == vm::bbox3{center - vm::vec3{16, 16, 16}, center + vm::vec3{16, 16, 16}});
+  }
+}
 } // namespace View
 } // namespace TrenchBroom
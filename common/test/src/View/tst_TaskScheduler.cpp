@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapDocumentTest.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
+#include "View/TaskScheduler.h"
+
+#include <future>
+#include <stdexcept>
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::View
+{
+
+TEST_CASE_METHOD(MapDocumentTest, "TaskScheduler")
+{
+  auto& scheduler = document->taskScheduler();
+  REQUIRE_FALSE(scheduler.hasTasks());
+
+  const auto addEntity = [](MapDocument& doc, std::string classname) {
+    auto* entityNode =
+      new Model::EntityNode{Model::Entity{{}, {{"classname", std::move(classname)}}}};
+    doc.addNodes({{doc.parentForNodes(), {entityNode}}});
+  };
+
+  SECTION("Applies the result as one undoable step")
+  {
+    const auto classname = std::string{"light"};
+    scheduler.submit(
+      "Add Entities",
+      [classname](TaskContext& context) {
+        context.setProgress(1.0f);
+        return classname;
+      },
+      [&](MapDocument& doc, std::string result) {
+        addEntity(doc, result);
+        addEntity(doc, result);
+      });
+
+    CHECK(scheduler.hasTasks());
+    CHECK(scheduler.processFinishedTasks(true) == 1u);
+    CHECK_FALSE(scheduler.hasTasks());
+
+    CHECK(document->world()->defaultLayer()->childCount() == 2u);
+    CHECK(document->undoCommandName() == "Add Entities");
+
+    document->undoCommand();
+    CHECK(document->world()->defaultLayer()->childCount() == 0u);
+  }
+
+  SECTION("Reports the running tasks")
+  {
+    auto started = std::promise<void>{};
+    auto proceed = std::promise<void>{};
+    auto proceedFuture = proceed.get_future().share();
+
+    const auto id = scheduler.submit(
+      "Wait",
+      [&, proceedFuture](TaskContext& context) {
+        context.setProgress(0.5f);
+        started.set_value();
+        proceedFuture.wait();
+        return 0;
+      },
+      [](MapDocument&, int) {});
+
+    started.get_future().wait();
+
+    const auto tasks = scheduler.tasks();
+    REQUIRE(tasks.size() == 1u);
+    CHECK(tasks.front().id == id);
+    CHECK(tasks.front().name == "Wait");
+    CHECK(tasks.front().progress == 0.5f);
+
+    proceed.set_value();
+    CHECK(scheduler.processFinishedTasks(true) == 1u);
+  }
+
+  SECTION("Cancelled tasks are not applied")
+  {
+    auto proceed = std::promise<void>{};
+    auto proceedFuture = proceed.get_future().share();
+    auto cancelled = std::promise<bool>{};
+
+    const auto id = scheduler.submit(
+      "Cancel",
+      [&, proceedFuture](TaskContext& context) {
+        proceedFuture.wait();
+        cancelled.set_value(context.cancelled());
+        return 0;
+      },
+      [&](MapDocument& doc, int) { addEntity(doc, "light"); });
+
+    scheduler.cancel(id);
+    CHECK_FALSE(scheduler.hasTasks());
+
+    proceed.set_value();
+    CHECK(cancelled.get_future().get());
+
+    CHECK(scheduler.processFinishedTasks(true) == 0u);
+    CHECK(document->world()->defaultLayer()->childCount() == 0u);
+  }
+
+  SECTION("Discards results that were computed from an outdated snapshot")
+  {
+    auto proceed = std::promise<void>{};
+    auto proceedFuture = proceed.get_future().share();
+
+    scheduler.submit(
+      "Outdated",
+      [proceedFuture](TaskContext&) {
+        proceedFuture.wait();
+        return 0;
+      },
+      [&](MapDocument& doc, int) { addEntity(doc, "light"); });
+
+    addEntity(*document, "info_player_start");
+    proceed.set_value();
+
+    CHECK(scheduler.processFinishedTasks(true) == 0u);
+    CHECK(document->world()->defaultLayer()->childCount() == 1u);
+  }
+
+  SECTION("Does not apply tasks that failed")
+  {
+    scheduler.submit(
+      "Fail",
+      [](TaskContext&) -> int { throw std::runtime_error{"failed"}; },
+      [&](MapDocument& doc, int) { addEntity(doc, "light"); });
+
+    CHECK(scheduler.processFinishedTasks(true) == 0u);
+    CHECK_FALSE(scheduler.hasTasks());
+    CHECK(document->world()->defaultLayer()->childCount() == 0u);
+  }
+}
+
+} // namespace TrenchBroom::View
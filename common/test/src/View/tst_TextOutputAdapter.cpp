@@ -32,24 +32,45 @@ TEST_CASE("TextOutputAdapterTest.test")
   QTextEdit textEdit;
   TextOutputAdapter adapter(&textEdit);
 
+  SECTION("output is buffered until flushed")
+  {
+    adapter << "abc";
+    CHECK(textEdit.toPlainText() == "");
+
+    adapter << "def";
+    adapter.flush();
+    CHECK(textEdit.toPlainText() == "abcdef");
+  }
+  SECTION("copies share the buffer")
+  {
+    auto copy = adapter;
+    adapter << "abc";
+    copy << "def";
+    copy.flush();
+    CHECK(textEdit.toPlainText() == "abcdef");
+  }
   SECTION("string literal")
   {
     adapter << "abc";
+    adapter.flush();
     CHECK(textEdit.toPlainText() == "abc");
   }
   SECTION("trailing CR LF")
   {
     adapter << "abc\r\n";
+    adapter.flush();
     CHECK(textEdit.toPlainText() == "abc\n");
   }
   SECTION("CR LF")
   {
     adapter << "abc\r\ndef";
+    adapter.flush();
     CHECK(textEdit.toPlainText() == "abc\ndef");
   }
   SECTION("two CR LF")
   {
     adapter << "abc\r\n\r\ndef";
+    adapter.flush();
     CHECK(textEdit.toPlainText() == "abc\n\ndef");
   }
 
@@ -57,21 +78,25 @@ TEST_CASE("TextOutputAdapterTest.test")
   SECTION("CR then CR LF mid line")
   {
     adapter << "abc\rA\r\nline 2";
+    adapter.flush();
     CHECK(textEdit.toPlainText() == "Abc\nline 2");
   }
   SECTION("several CR's")
   {
     adapter << "abc\rAB\ra\r\nline 2";
+    adapter.flush();
     CHECK(textEdit.toPlainText() == "aBc\nline 2");
   }
   SECTION("CR then CR LF")
   {
     adapter << "abc\rABC\r\nline 2";
+    adapter.flush();
     CHECK(textEdit.toPlainText() == "ABC\nline 2");
   }
   SECTION("CR then LF")
   {
     adapter << "abc\rABC\nline 2";
+    adapter.flush();
     CHECK(textEdit.toPlainText() == "ABC\nline 2");
   }
 }
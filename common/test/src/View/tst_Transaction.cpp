@@ -22,8 +22,13 @@
 #include "Model/EntityNode.h"
 #include "TestUtils.h"
 
+#include "kdl/vector_utils.h"
+
 #include "vm/mat_ext.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom::View
@@ -86,4 +91,82 @@ TEST_CASE_METHOD(MapDocumentTest, "Transaction")
   }
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "Transaction.batchedNodesDidChangeNotifier")
+{
+  auto* entityNode1 = new Model::EntityNode{Model::Entity{}};
+  auto* entityNode2 = new Model::EntityNode{Model::Entity{}};
+  document->addNodes({{document->parentForNodes(), {entityNode1, entityNode2}}});
+
+  auto notifications = std::vector<std::vector<Model::Node*>>{};
+  auto connection = document->batchedNodesDidChangeNotifier.connect(
+    [&](const auto& nodes) { notifications.push_back(nodes); });
+
+  SECTION("Notifies once per command outside of a transaction")
+  {
+    document->selectNodes({entityNode1});
+    notifications.clear();
+
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3{1, 0, 0}));
+
+    REQUIRE(notifications.size() == 1u);
+    CHECK(kdl::vec_contains(notifications.front(), entityNode1));
+  }
+
+  SECTION("Notifies once when the transaction is committed")
+  {
+    auto transaction = Transaction{document};
+
+    document->selectNodes({entityNode1});
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3{1, 0, 0}));
+    document->deselectAll();
+    document->selectNodes({entityNode2});
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3{1, 0, 0}));
+    document->selectNodes({entityNode1});
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3{1, 0, 0}));
+
+    CHECK(notifications.empty());
+
+    transaction.commit();
+
+    REQUIRE(notifications.size() == 1u);
+    const auto& changedNodes = notifications.front();
+    CHECK(kdl::vec_contains(changedNodes, entityNode1));
+    CHECK(kdl::vec_contains(changedNodes, entityNode2));
+    CHECK(std::count(changedNodes.begin(), changedNodes.end(), entityNode1) == 1);
+  }
+
+  SECTION("Omits nodes that were removed")
+  {
+    auto transaction = Transaction{document};
+
+    document->selectNodes({entityNode1, entityNode2});
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3{1, 0, 0}));
+    document->deselectAll();
+    document->removeNodes({entityNode2});
+
+    transaction.commit();
+
+    REQUIRE(notifications.size() == 1u);
+    CHECK(kdl::vec_contains(notifications.front(), entityNode1));
+    CHECK_FALSE(kdl::vec_contains(notifications.front(), entityNode2));
+  }
+
+  SECTION("Notifies once when undoing a transaction")
+  {
+    auto transaction = Transaction{document};
+
+    document->selectNodes({entityNode1});
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3{1, 0, 0}));
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3{1, 0, 0}));
+
+    transaction.commit();
+    notifications.clear();
+
+    document->undoCommand();
+
+    REQUIRE(notifications.size() == 1u);
+    CHECK(kdl::vec_contains(notifications.front(), entityNode1));
+  }
+}
+
 } // namespace TrenchBroom::View
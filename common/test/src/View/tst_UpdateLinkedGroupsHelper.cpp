@@ -229,6 +229,63 @@ TEST_CASE_METHOD(UpdateLinkedGroupsHelperTest, "applyLinkedGroupUpdates")
     == originalBrushBounds.translate(vm::vec3(32.0, 0.0, 0.0)));
 }
 
+TEST_CASE_METHOD(UpdateLinkedGroupsHelperTest, "applyLinkedGroupUpdatesIncrementally")
+{
+  auto* groupNode = new Model::GroupNode{Model::Group{"test"}};
+  setLinkId(*groupNode, "asdf");
+
+  auto* brushNode = createBrushNode();
+  groupNode->addChild(brushNode);
+
+  auto* linkedGroupNode = static_cast<Model::GroupNode*>(
+    groupNode->cloneRecursively(document->worldBounds(), Model::SetLinkId::keep));
+  auto* linkedBrushNode =
+    dynamic_cast<Model::BrushNode*>(linkedGroupNode->children().front());
+  REQUIRE(linkedBrushNode != nullptr);
+
+  transformNode(
+    *linkedGroupNode,
+    vm::translation_matrix(vm::vec3(32.0, 0.0, 0.0)),
+    document->worldBounds());
+
+  document->addNodes({{document->parentForNodes(), {groupNode, linkedGroupNode}}});
+
+  // the linked groups are in sync, so only subsequent changes need to be propagated
+  groupNode->resetChangeTracking();
+
+  const auto originalBrushBounds = brushNode->physicalBounds();
+
+  transformNode(
+    *brushNode,
+    vm::translation_matrix(vm::vec3(0.0, 16.0, 0.0)),
+    document->worldBounds());
+  REQUIRE(groupNode->canUpdateLinkedGroupsIncrementally());
+
+  auto helper = UpdateLinkedGroupsHelper{{groupNode}};
+  REQUIRE(
+    helper
+      .applyLinkedGroupUpdates(*static_cast<MapDocumentCommandFacade*>(document.get()))
+      .is_success());
+
+  // the linked brush node was updated in place
+  CHECK(groupNode->changedDescendants().empty());
+  CHECK_THAT(
+    linkedGroupNode->children(),
+    Catch::Equals(std::vector<Model::Node*>{linkedBrushNode}));
+  CHECK(
+    linkedBrushNode->physicalBounds()
+    == originalBrushBounds.translate(vm::vec3(32.0, 16.0, 0.0)));
+
+  helper.undoLinkedGroupUpdates(*static_cast<MapDocumentCommandFacade*>(document.get()));
+
+  CHECK_THAT(
+    linkedGroupNode->children(),
+    Catch::Equals(std::vector<Model::Node*>{linkedBrushNode}));
+  CHECK(
+    linkedBrushNode->physicalBounds()
+    == originalBrushBounds.translate(vm::vec3(32.0, 0.0, 0.0)));
+}
+
 static void setGroupName(Model::GroupNode& groupNode, const std::string& name)
 {
   auto group = groupNode.group();
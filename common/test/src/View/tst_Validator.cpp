@@ -104,5 +104,48 @@ TEST_CASE_METHOD(MapDocumentTest, "ValidatorTest.emptyProperty")
 
   kdl::vec_clear_and_delete(validators);
 }
+
+TEST_CASE_METHOD(MapDocumentTest, "ValidatorTest.quickFixMultipleIssues")
+{
+  auto* entityNode1 = document->createPointEntity(m_pointEntityDef, vm::vec3::zero());
+  auto* entityNode2 = document->createPointEntity(m_pointEntityDef, {32, 0, 0});
+  auto* entityNode3 = document->createPointEntity(m_pointEntityDef, {64, 0, 0});
+
+  document->deselectAll();
+  document->selectNodes({entityNode1, entityNode2});
+  document->setProperty("some_key", "");
+
+  document->deselectAll();
+  document->selectNodes({entityNode3});
+  document->setProperty("other_key", "");
+
+  // applies to worldspawn
+  document->deselectAll();
+  document->setProperty("some_key", "");
+
+  document->selectNodes({entityNode3});
+
+  const auto validator = Model::EmptyPropertyValueValidator{};
+  const auto validators = std::vector<const Model::Validator*>{&validator};
+
+  auto issues = kdl::vec_concat(
+    document->world()->issues(validators),
+    entityNode1->issues(validators),
+    entityNode2->issues(validators),
+    entityNode3->issues(validators));
+  REQUIRE(issues.size() == 4u);
+
+  const auto fixes = validator.quickFixes();
+  REQUIRE(fixes.size() == 1u);
+  fixes.front()->apply(*document, issues);
+
+  CHECK_FALSE(document->world()->entity().hasProperty("some_key"));
+  CHECK_FALSE(entityNode1->entity().hasProperty("some_key"));
+  CHECK_FALSE(entityNode2->entity().hasProperty("some_key"));
+  CHECK_FALSE(entityNode3->entity().hasProperty("other_key"));
+
+  // the selection is restored
+  CHECK(document->selectedNodes().nodes() == std::vector<Model::Node*>{entityNode3});
+}
 } // namespace View
 } // namespace TrenchBroom
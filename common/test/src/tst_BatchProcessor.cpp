@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BatchProcessor.h"
+#include "IO/TestEnvironment.h"
+#include "Model/TestGame.h"
+
+#include "kdl/string_compare.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+
+namespace
+{
+const auto MapData = R"({
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex1 1 2 3 4 5
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}
+}
+{
+"origin" "0 0 0"
+}
+)";
+} // namespace
+
+TEST_CASE("BatchProcessor")
+{
+  auto env = IO::TestEnvironment{[](auto& e) { e.createFile("test.map", MapData); }};
+
+  const auto mapPath = env.dir() / "test.map";
+  const auto job = BatchJob{
+    mapPath,
+    std::make_shared<Model::TestGame>(),
+    {Model::MapFormat::Standard},
+    {},
+    std::nullopt};
+
+  SECTION("Reports validation issues")
+  {
+    auto options = BatchOptions{};
+    options.validate = true;
+
+    const auto result = processMap(job, options);
+    CHECK(result.succeeded());
+    CHECK(result.gameName == "Test");
+    CHECK(result.format == Model::MapFormat::Standard);
+
+    REQUIRE(result.issues.size() == 1u);
+    CHECK(result.issues.front().type == "Missing entity classname");
+    CHECK(result.issues.front().lineNumber == 12u);
+    CHECK(result.outputPaths.empty());
+  }
+
+  SECTION("Converts maps to the output directory")
+  {
+    auto options = BatchOptions{};
+    options.targetFormat = Model::MapFormat::Valve;
+
+    SECTION("Requires an output directory")
+    {
+      const auto result = processMap(job, options);
+      CHECK_FALSE(result.succeeded());
+      CHECK(result.outputPaths.empty());
+    }
+
+    SECTION("Writes the converted map")
+    {
+      env.createDirectory("out");
+      options.outputDirectory = env.dir() / "out";
+
+      const auto result = processMap(job, options);
+      CHECK(result.succeeded());
+      CHECK(result.format == Model::MapFormat::Valve);
+      CHECK(
+        result.outputPaths
+        == std::vector<std::filesystem::path>{env.dir() / "out" / "test.map"});
+      CHECK(env.fileExists("out/test.map"));
+      CHECK(env.loadFile("test.map") == MapData);
+    }
+  }
+
+  SECTION("Reports errors for jobs without a game")
+  {
+    const auto invalidJob =
+      BatchJob{mapPath, nullptr, {}, {}, std::string{"Could not detect the game"}};
+
+    const auto result = processMap(invalidJob, BatchOptions{});
+    CHECK_FALSE(result.succeeded());
+    CHECK(result.errors == std::vector<std::string>{"Could not detect the game"});
+  }
+
+  SECTION("Reports the results in parallel and in order")
+  {
+    auto options = BatchOptions{};
+    options.validate = true;
+
+    const auto invalidJob =
+      BatchJob{mapPath, nullptr, {}, {}, std::string{"Could not detect the game"}};
+
+    const auto results = processMaps({job, invalidJob, job}, options);
+    REQUIRE(results.size() == 3u);
+    CHECK(results[0].succeeded());
+    CHECK_FALSE(results[1].succeeded());
+    CHECK(results[2].succeeded());
+
+    const auto report = batchReport(results);
+    CHECK(kdl::cs::str_is_prefix(report, "{"));
+    CHECK(report.find(R"("mapCount": 3)") != std::string::npos);
+    CHECK(report.find(R"("failedMapCount": 1)") != std::string::npos);
+    CHECK(report.find(R"("issueCount": 2)") != std::string::npos);
+    CHECK(report.find("Entity has no classname property") != std::string::npos);
+  }
+}
+
+} // namespace TrenchBroom
@@ -0,0 +1,110 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+
+#include "kdl/vector_utils.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+
+TEST_CASE("Profiler")
+{
+  Profiler::clear();
+
+  const auto zoneNames = []() {
+    return kdl::vec_transform(
+      Profiler::zones(), [](const auto& zone) { return std::string{zone.name}; });
+  };
+
+  SECTION("Ignores zones while disabled")
+  {
+    REQUIRE_FALSE(Profiler::enabled());
+    {
+      const auto zone = ProfilerZone{"disabled"};
+    }
+    CHECK(Profiler::zones().empty());
+  }
+
+  SECTION("Records zones while enabled")
+  {
+    Profiler::setEnabled(true);
+    {
+      const auto outer = ProfilerZone{"outer"};
+      {
+        const auto inner = ProfilerZone{"inner"};
+      }
+    }
+    Profiler::setEnabled(false);
+
+    CHECK(zoneNames() == std::vector<std::string>{"outer", "inner"});
+
+    const auto zones = Profiler::zones();
+    CHECK(zones[0].start <= zones[1].start);
+    CHECK(zones[1].end <= zones[0].end);
+    CHECK(zones[0].threadIndex == zones[1].threadIndex);
+
+    Profiler::clear();
+    CHECK(Profiler::zones().empty());
+  }
+
+  SECTION("Records zones of other threads")
+  {
+    Profiler::setEnabled(true);
+    {
+      const auto zone = ProfilerZone{"main"};
+    }
+    auto thread = std::thread{[]() { const auto zone = ProfilerZone{"thread"}; }};
+    thread.join();
+    Profiler::setEnabled(false);
+
+    const auto zones = Profiler::zones();
+    REQUIRE(zoneNames() == std::vector<std::string>{"main", "thread"});
+    CHECK(zones[0].threadIndex != zones[1].threadIndex);
+
+    Profiler::clear();
+  }
+
+  SECTION("Keeps the most recent zones")
+  {
+    Profiler::setEnabled(true);
+    for (size_t i = 0; i < Profiler::BufferCapacity; ++i)
+    {
+      const auto zone = ProfilerZone{"old"};
+    }
+    {
+      const auto zone = ProfilerZone{"new"};
+    }
+    Profiler::setEnabled(false);
+
+    const auto names = zoneNames();
+    CHECK(names.size() == Profiler::BufferCapacity);
+    CHECK(names.back() == "new");
+
+    Profiler::clear();
+  }
+}
+
+} // namespace TrenchBroom
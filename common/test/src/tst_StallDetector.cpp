@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/TestEnvironment.h"
+#include "StallDetector.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QTime>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+
+using namespace std::chrono_literals;
+
+TEST_CASE("StallDetector.commandScope")
+{
+  CHECK(StallDetector::currentCommand().empty());
+  {
+    const auto outer = StallDetector::CommandScope{"Transaction"};
+    CHECK(StallDetector::currentCommand() == "Transaction");
+    {
+      const auto inner = StallDetector::CommandScope{"Move Objects"};
+      CHECK(StallDetector::currentCommand() == "Move Objects");
+    }
+    CHECK(StallDetector::currentCommand() == "Transaction");
+  }
+  CHECK(StallDetector::currentCommand().empty());
+}
+
+TEST_CASE("StallDetector.stallReport")
+{
+  const auto time = QDateTime{QDate{2024, 3, 7}, QTime{14, 5, 9, 42}};
+
+  CHECK(
+    stallReportPath("reports", time)
+    == std::filesystem::path{"reports"} / "stall-20240307-140509-042.txt");
+
+  const auto report = stallReport(time, 312ms, "Move Objects", "frame 0\nframe 1\n");
+  CHECK(report.find("312 ms") != std::string::npos);
+  CHECK(report.find("Current command: Move Objects") != std::string::npos);
+  CHECK(report.find("frame 0\nframe 1\n") != std::string::npos);
+
+  CHECK(
+    stallReport(time, 312ms, "", "").find("Current command: none") != std::string::npos);
+}
+
+TEST_CASE("StallDetector.reportsStalls")
+{
+  auto env = IO::TestEnvironment{};
+  const auto reportDirectory = env.dir() / "StallReports";
+
+  SECTION("Does not report if the heartbeat is regular")
+  {
+    {
+      auto detector = StallDetector{reportDirectory, 1s};
+      for (size_t i = 0; i < 4; ++i)
+      {
+        detector.heartbeat();
+        std::this_thread::sleep_for(detector.heartbeatInterval());
+      }
+    }
+    CHECK_FALSE(env.directoryExists("StallReports"));
+  }
+
+  SECTION("Reports every stall once")
+  {
+    {
+      auto detector = StallDetector{reportDirectory, 20ms};
+      const auto command = StallDetector::CommandScope{"Stall"};
+      std::this_thread::sleep_for(200ms);
+    }
+
+    const auto reports = env.directoryContents("StallReports");
+    REQUIRE(reports.size() == 1u);
+    CHECK(
+      env.loadFile(reports.front()).find("Current command: Stall") != std::string::npos);
+  }
+}
+
+} // namespace TrenchBroom
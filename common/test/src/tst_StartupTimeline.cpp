@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StartupTimeline.h"
+
+#include "kdl/vector_utils.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+
+TEST_CASE("StartupTimeline")
+{
+  auto timeline = StartupTimeline{};
+
+  const auto phaseNames = [&]() {
+    return kdl::vec_transform(
+      timeline.phases(), [](const auto& phase) { return phase.name; });
+  };
+
+  SECTION("Records nested phases")
+  {
+    {
+      const auto outer = timeline.phase("outer");
+      {
+        const auto inner = timeline.phase("inner");
+      }
+    }
+    {
+      const auto other = timeline.phase("other");
+    }
+
+    CHECK(phaseNames() == std::vector<std::string>{"outer", "inner", "other"});
+
+    const auto& phases = timeline.phases();
+    CHECK(phases[0].depth == 0u);
+    CHECK(phases[1].depth == 1u);
+    CHECK(phases[2].depth == 0u);
+
+    CHECK(phases[1].start >= phases[0].start);
+    CHECK(
+      phases[1].start + phases[1].duration <= phases[0].start + phases[0].duration);
+    CHECK(phases[2].start >= phases[0].start + phases[0].duration);
+
+    CHECK(timeline.summary().find("\n  outer: ") != std::string::npos);
+    CHECK(timeline.summary().find("\n    inner: ") != std::string::npos);
+  }
+
+  SECTION("Ends open phases when finishing")
+  {
+    const auto phase = timeline.phase("open");
+
+    CHECK_FALSE(timeline.finished());
+    timeline.finish();
+    CHECK(timeline.finished());
+
+    const auto duration = timeline.phases().front().duration;
+    CHECK(duration > StartupTimeline::Clock::duration::zero());
+
+    timeline.finish();
+    CHECK(timeline.phases().front().duration == duration);
+  }
+
+  SECTION("Ignores phases after finishing")
+  {
+    {
+      const auto phase = timeline.phase("before");
+    }
+    timeline.finish();
+    {
+      const auto phase = timeline.phase("after");
+    }
+
+    CHECK(phaseNames() == std::vector<std::string>{"before"});
+  }
+}
+
+} // namespace TrenchBroom
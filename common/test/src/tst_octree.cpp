@@ -28,6 +28,11 @@
 
 #include "Catch2.h"
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
 namespace TrenchBroom
 {
 namespace detail
@@ -559,6 +564,162 @@ TEST_CASE("octree.insert_duplicate")
   CHECK_FALSE(tree.empty());
 }
 
+TEST_CASE("octree.build")
+{
+  auto tree = octree<double, int>{32.0};
+
+  SECTION("empty")
+  {
+    tree.insert(vm::bbox3d{{0, 0, 0}, {2, 1, 1}}, 1);
+    tree.build({});
+    CHECK(tree == octree<double, int>{32.0});
+  }
+
+  SECTION("root data only")
+  {
+    tree.build({
+      {{{-2, 0, 0}, {5, 3, 6}}, 1},
+      {{{-33, -32, -32}, {32, 32, 32}}, 2},
+    });
+    CHECK(tree == octree<double, int>{32.0, leaf_node{{-2, -2, -2, 2}, {1, 2}}});
+  }
+
+  SECTION("skips unnecessary inner nodes")
+  {
+    tree.build({
+      {{{1, 1, 1}, {2, 2, 2}}, 1},
+      {{{16, 16, 16}, {48, 48, 48}}, 3},
+      {{{-2, 0, 0}, {5, 3, 6}}, 4},
+      {{{3, 3, 3}, {4, 4, 4}}, 2},
+    });
+    CHECK(
+      tree
+      == octree<double, int>{
+        32.0,
+        inner_node{
+          {-4, -4, -4, 3},
+          {4},
+          kdl::vec_from(
+            node{leaf_node{{-4, -4, -4, 2}, {}}},
+            node{leaf_node{{0, -4, -4, 2}, {}}},
+            node{leaf_node{{-4, 0, -4, 2}, {}}},
+            node{leaf_node{{0, 0, -4, 2}, {}}},
+            node{leaf_node{{-4, -4, 0, 2}, {}}},
+            node{leaf_node{{0, -4, 0, 2}, {}}},
+            node{leaf_node{{-4, 0, 0, 2}, {}}},
+            node{inner_node{
+              {0, 0, 0, 1},
+              {3},
+              kdl::vec_from(
+                node{leaf_node{{0, 0, 0, 0}, {1, 2}}},
+                node{leaf_node{{1, 0, 0, 0}, {}}},
+                node{leaf_node{{0, 1, 0, 0}, {}}},
+                node{leaf_node{{1, 1, 0, 0}, {}}},
+                node{leaf_node{{0, 0, 1, 0}, {}}},
+                node{leaf_node{{1, 0, 1, 0}, {}}},
+                node{leaf_node{{0, 1, 1, 0}, {}}},
+                node{leaf_node{{1, 1, 1, 0}, {}}})}})}});
+
+    CHECK(tree.contains(1));
+    CHECK(tree.contains(2));
+    CHECK(tree.contains(3));
+    CHECK(tree.contains(4));
+
+    CHECK(tree.find_containers({40, 40, 40}) == std::vector<int>{4, 3});
+    CHECK(tree.find_containers({8, 8, 8}) == std::vector<int>{4, 3, 1, 2});
+
+    CHECK(tree.remove(1));
+    CHECK(tree.remove(4));
+    CHECK(tree.remove(3));
+    CHECK(tree.remove(2));
+    CHECK(tree.empty());
+  }
+
+  SECTION("finds the same items as incremental insertion")
+  {
+    auto entries = std::vector<std::pair<vm::bbox3d, int>>{};
+    auto incremental = octree<double, int>{32.0};
+    for (int i = 0; i < 64; ++i)
+    {
+      const auto min = vm::vec3d{
+        double((i * 37) % 512 - 256),
+        double((i * 53) % 384 - 192),
+        double((i * 71) % 256 - 128)};
+      const auto bounds = vm::bbox3d{min, min + vm::vec3d{double(1 + i % 7) * 9.0}};
+      entries.emplace_back(bounds, i);
+      incremental.insert(bounds, i);
+    }
+
+    tree.build(entries);
+
+    const auto sorted = [](auto v) {
+      std::sort(v.begin(), v.end());
+      return v;
+    };
+
+    for (const auto& [bounds, i] : entries)
+    {
+      CHECK(tree.contains(i));
+      CHECK(
+        sorted(tree.find_intersectors(bounds))
+        == sorted(incremental.find_intersectors(bounds)));
+      CHECK(
+        sorted(tree.find_containers(bounds.center()))
+        == sorted(incremental.find_containers(bounds.center())));
+
+      const auto ray = vm::ray3d{bounds.min, vm::normalize(vm::vec3d{1, 2, 3})};
+      CHECK(
+        sorted(tree.find_intersectors(ray))
+        == sorted(incremental.find_intersectors(ray)));
+    }
+
+    for (const auto& [bounds, i] : entries)
+    {
+      if (i % 2 == 0)
+      {
+        CHECK(tree.remove(i));
+        CHECK(incremental.remove(i));
+      }
+    }
+
+    for (const auto& [bounds, i] : entries)
+    {
+      CHECK(tree.contains(i) == (i % 2 != 0));
+      CHECK(
+        sorted(tree.find_intersectors(bounds))
+        == sorted(incremental.find_intersectors(bounds)));
+    }
+
+    for (const auto& [bounds, i] : entries)
+    {
+      if (i % 2 == 0)
+      {
+        tree.insert(bounds, i);
+      }
+      else
+      {
+        CHECK(tree.remove(i));
+      }
+    }
+
+    for (const auto& [bounds, i] : entries)
+    {
+      CHECK(tree.contains(i) == (i % 2 == 0));
+    }
+  }
+
+  SECTION("duplicate data")
+  {
+    CHECK_THROWS_AS(
+      tree.build({
+        {{{0, 0, 0}, {2, 1, 1}}, 1},
+        {{{4, 4, 4}, {8, 8, 8}}, 1},
+      }),
+      NodeTreeException);
+    CHECK(tree.empty());
+  }
+}
+
 TEST_CASE("octree.contains")
 {
   auto tree = octree<double, int>{32.0};
@@ -724,4 +885,59 @@ TEST_CASE("octree.find_containers")
     CHECK(tree.find_containers({64, 64, 64}) == std::vector<int>{1});
   }
 }
+
+TEST_CASE("octree.find_if")
+{
+  auto tree = octree<double, int>{32.0};
+
+  const auto find_if = [&](const vm::bbox3d& bounds) {
+    auto result = std::vector<int>{};
+    tree.find_if(
+      [&](const vm::bbox3d& node_bounds) { return node_bounds.intersects(bounds); },
+      std::back_inserter(result));
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+
+  SECTION("empty tree")
+  {
+    CHECK(find_if({{0, 0, 0}, {1, 1, 1}}).empty());
+  }
+
+  SECTION("multiple nodes")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+    tree.insert({{-16, -16, -16}, {16, 16, 16}}, 3);
+
+    // no node intersects the bounds except for the root node
+    CHECK(find_if({{-64, 32, 32}, {-48, 48, 48}}) == std::vector<int>{3});
+
+    // the leaf that contains data 1 intersects the bounds
+    CHECK(find_if({{48, 48, 48}, {56, 56, 56}}) == std::vector<int>{1, 3});
+
+    // every node intersects the bounds
+    CHECK(find_if({{-64, -64, -64}, {64, 64, 64}}) == std::vector<int>{1, 2, 3});
+
+    // a predicate that rejects the root node finds nothing
+    auto result = std::vector<int>{};
+    tree.find_if([](const vm::bbox3d&) { return false; }, std::back_inserter(result));
+    CHECK(result.empty());
+  }
+}
+
+TEST_CASE("octree.memory_usage")
+{
+  auto tree = octree<double, int>{32.0};
+  const auto emptyUsage = tree.memory_usage();
+  CHECK(emptyUsage >= sizeof(tree));
+
+  tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+  tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+  const auto usage = tree.memory_usage();
+  CHECK(usage > emptyUsage);
+
+  tree.clear();
+  CHECK(tree.memory_usage() < usage);
+}
 } // namespace TrenchBroom
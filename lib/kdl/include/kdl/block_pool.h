@@ -0,0 +1,290 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace kdl
+{
+
+/**
+ * A thread safe pool of memory blocks of a fixed size and alignment.
+ *
+ * Blocks are carved from chunks that hold BlocksPerChunk blocks each, so allocating many
+ * blocks only requires a few calls to the global allocator, and blocks that are allocated
+ * together are likely to be close to each other in memory. Chunks are never returned to
+ * the global allocator; deallocated blocks are reused instead.
+ *
+ * Every thread keeps a cache of free blocks, so allocating and deallocating blocks does
+ * not require synchronization unless the cache of the calling thread is empty or full. A
+ * block may be deallocated by another thread than the thread that allocated it. When a
+ * thread terminates, its cached blocks are returned to the pool.
+ *
+ * The pool is shared by all instances of the template with the same arguments. Typically
+ * it is used to implement class specific operator new and operator delete.
+ */
+template <
+  std::size_t BlockSize,
+  std::size_t BlockAlignment,
+  std::size_t BlocksPerChunk = 256>
+class block_pool
+{
+private:
+  struct free_block
+  {
+    free_block* next;
+  };
+
+  static constexpr auto block_alignment = std::max(BlockAlignment, alignof(free_block));
+  static constexpr auto block_size =
+    (std::max(BlockSize, sizeof(free_block)) + block_alignment - 1) / block_alignment
+    * block_alignment;
+
+  static_assert(BlocksPerChunk > 0, "chunks must contain at least one block");
+
+  /**
+   * A singly linked list of free blocks.
+   */
+  struct free_list
+  {
+    free_block* first = nullptr;
+    std::size_t size = 0;
+
+    void push(free_block* block)
+    {
+      block->next = first;
+      first = block;
+      ++size;
+    }
+
+    free_block* pop()
+    {
+      assert(first != nullptr);
+      auto* block = first;
+      first = block->next;
+      --size;
+      return block;
+    }
+
+    /**
+     * Moves up to count blocks from this list to the given list.
+     */
+    void move_to(free_list& other, const std::size_t count)
+    {
+      for (std::size_t i = 0; i < count && first != nullptr; ++i)
+      {
+        other.push(pop());
+      }
+    }
+  };
+
+  struct shared_pool
+  {
+    std::mutex mutex;
+    free_list blocks;
+  };
+
+  /**
+   * Trivially destructible, so it can still be accessed while the thread's other thread
+   * local objects are destroyed.
+   */
+  struct thread_cache
+  {
+    free_list blocks;
+    bool released = false;
+  };
+
+  /**
+   * Returns the blocks of the thread's cache to the shared pool when the thread
+   * terminates. Afterwards, the thread uses the shared pool directly.
+   */
+  struct thread_cache_guard
+  {
+    thread_cache& cache;
+
+    ~thread_cache_guard()
+    {
+      auto& pool = get_shared_pool();
+      auto lock = std::lock_guard{pool.mutex};
+      cache.blocks.move_to(pool.blocks, cache.blocks.size);
+      cache.released = true;
+    }
+  };
+
+  static shared_pool& get_shared_pool()
+  {
+    // never destroyed so that blocks can be deallocated during static destruction
+    static auto* pool = new shared_pool{};
+    return *pool;
+  }
+
+  static thread_cache& get_thread_cache()
+  {
+    static thread_local auto cache = thread_cache{};
+    static thread_local const auto guard = thread_cache_guard{cache};
+    return cache;
+  }
+
+  static void add_chunk(free_list& blocks)
+  {
+    auto* chunk = static_cast<std::byte*>(
+      ::operator new(block_size * BlocksPerChunk, std::align_val_t{block_alignment}));
+
+    // push the blocks in reverse order so that they are allocated in address order
+    for (std::size_t i = BlocksPerChunk; i > 0; --i)
+    {
+      blocks.push(reinterpret_cast<free_block*>(chunk + (i - 1) * block_size));
+    }
+  }
+
+public:
+  /**
+   * Returns a block of at least BlockSize bytes aligned to BlockAlignment.
+   *
+   * @throws std::bad_alloc if a new chunk is needed and cannot be allocated
+   */
+  static void* allocate()
+  {
+    auto& cache = get_thread_cache();
+    if (cache.blocks.size == 0)
+    {
+      auto& pool = get_shared_pool();
+      auto lock = std::lock_guard{pool.mutex};
+      if (cache.released)
+      {
+        if (pool.blocks.size == 0)
+        {
+          add_chunk(pool.blocks);
+        }
+        return pool.blocks.pop();
+      }
+
+      pool.blocks.move_to(cache.blocks, BlocksPerChunk);
+    }
+
+    if (cache.blocks.size == 0)
+    {
+      add_chunk(cache.blocks);
+    }
+    return cache.blocks.pop();
+  }
+
+  /**
+   * Returns the given block to the pool. The block must have been returned by allocate.
+   */
+  static void deallocate(void* ptr) noexcept
+  {
+    if (ptr == nullptr)
+    {
+      return;
+    }
+
+    auto& cache = get_thread_cache();
+    if (cache.released)
+    {
+      auto& pool = get_shared_pool();
+      auto lock = std::lock_guard{pool.mutex};
+      pool.blocks.push(static_cast<free_block*>(ptr));
+      return;
+    }
+
+    cache.blocks.push(static_cast<free_block*>(ptr));
+
+    // don't let threads that only deallocate hoard blocks
+    if (cache.blocks.size > 2 * BlocksPerChunk)
+    {
+      auto& pool = get_shared_pool();
+      auto lock = std::lock_guard{pool.mutex};
+      cache.blocks.move_to(pool.blocks, BlocksPerChunk);
+    }
+  }
+};
+
+/**
+ * A standard allocator that takes single objects from a block_pool. Requests for more
+ * than one object are passed on to std::allocator.
+ *
+ * This suits node based containers such as std::set or std::unordered_map, which
+ * allocate their nodes one by one. The allocator is stateless, so all instances compare
+ * equal and containers using it can be swapped and moved freely.
+ */
+template <typename T, std::size_t BlocksPerChunk = 256>
+class block_pool_allocator
+{
+public:
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  template <typename U>
+  struct rebind
+  {
+    using other = block_pool_allocator<U, BlocksPerChunk>;
+  };
+
+  block_pool_allocator() noexcept = default;
+
+  template <typename U>
+  block_pool_allocator(const block_pool_allocator<U, BlocksPerChunk>&) noexcept
+  {
+  }
+
+  T* allocate(const std::size_t n)
+  {
+    // T may be incomplete where the allocator is declared, so the pool is named here
+    using pool = block_pool<sizeof(T), alignof(T), BlocksPerChunk>;
+    return n == 1 ? static_cast<T*>(pool::allocate()) : std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* ptr, const std::size_t n) noexcept
+  {
+    using pool = block_pool<sizeof(T), alignof(T), BlocksPerChunk>;
+    if (n == 1)
+    {
+      pool::deallocate(ptr);
+    }
+    else
+    {
+      std::allocator<T>{}.deallocate(ptr, n);
+    }
+  }
+
+  template <typename U>
+  friend bool operator==(
+    const block_pool_allocator&, const block_pool_allocator<U, BlocksPerChunk>&) noexcept
+  {
+    return true;
+  }
+
+  template <typename U>
+  friend bool operator!=(
+    const block_pool_allocator&, const block_pool_allocator<U, BlocksPerChunk>&) noexcept
+  {
+    return false;
+  }
+};
+
+} // namespace kdl
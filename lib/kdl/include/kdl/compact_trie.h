@@ -20,12 +20,15 @@
 
 #pragma once
 
+#include "kdl/block_pool.h"
 #include "kdl/string_compare.h"
 #include "kdl/string_format.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <cassert>
 #include <exception>
+#include <functional>
 #include <set>
 #include <string>
 #include <string_view>
@@ -259,8 +262,14 @@ private:
     friend struct node_cmp;
     friend class match_state;
 
-    using value_container = std::unordered_map<V, std::size_t>;
-    using node_set = std::set<node, node_cmp>;
+    // nodes and values are allocated one at a time, so they are taken from a block pool
+    using value_container = std::unordered_map<
+      V,
+      std::size_t,
+      std::hash<V>,
+      std::equal_to<V>,
+      block_pool_allocator<std::pair<const V, std::size_t>>>;
+    using node_set = std::set<node, node_cmp, block_pool_allocator<node>>;
 
     /**
      * The partical key of this node.
@@ -289,16 +298,16 @@ private:
     }
 
     /**
-     * Inserts the given value into this node's subtree. If this node's key is empty, then
-     * it is the root node.
+     * Finds or creates the node for the given key in this node's subtree. If this node's
+     * key is empty, then it is the root node.
      *
      * Precondition: Unless this node is the root node, the given key must share a
      * non-empty prefix with this node's key.
      *
      * @param key the key to insert
-     * @param value the value to insert
+     * @return the node whose values are stored under the given key
      */
-    void insert(const std::string_view key, const V& value) const
+    const node& insert(const std::string_view key) const
     {
       /*
        Possible cases for insertion:
@@ -333,37 +342,37 @@ private:
           // prefix with the remainder of key and insert there
           const auto remainder = key.substr(mismatch);
           const auto& child = *m_children.insert(node(std::string(remainder))).first;
-          child.insert(remainder, value);
-        }
-        else
-        { // mismatch == m_key.size()
-          // case 2: key and m_key have a common prefix, split this node and insert again
-          split_node(mismatch);
-          insert(key, value);
+          return child.insert(remainder);
         }
+
+        // case 2: key and m_key have a common prefix, split this node and insert again
+        split_node(mismatch);
+        return insert(key);
       }
-      else if (mismatch == key.size())
+
+      // cases 3, 4: key is a prefix of m_key, or key == m_key
+      assert(mismatch == key.size());
+      if (mismatch < m_key.size())
       {
-        // cases 3, 4: key is a prefix of m_key, or key == m_key
-        if (mismatch < m_key.size())
-        {
-          // case 3: key is a prefix of m_key, split this node
-          split_node(mismatch);
-        }
-        insert_value(value);
+        // case 3: key is a prefix of m_key, split this node
+        split_node(mismatch);
       }
+      return *this;
     }
 
+    void insert_value(const V& value) const { m_values[value]++; }
+
     /**
-     * Removes the given value from this node's subtree.
+     * Removes the given values from this node's subtree.
      *
      * @param key the key to remove
-     * @param value the value to remove
-     * @return true if the given key and value were removed from this node's subtree
+     * @param first the first of the values to remove
+     * @param last the end of the values to remove
+     * @return the number of values that were removed from this node's subtree
      */
-    bool remove(const std::string_view key, const V& value) const
+    std::size_t remove(const std::string_view key, const V* first, const V* last) const
     {
-      bool result = false;
+      std::size_t result = 0u;
 
       const std::size_t mismatch = kdl::cs::str_mismatch(key, m_key);
       if (m_key.size() <= key.length() && mismatch == m_key.length())
@@ -376,7 +385,7 @@ private:
           const auto it = m_children.find(remainder);
           assert(it != std::end(m_children));
 
-          result = it->remove(remainder, value);
+          result = it->remove(remainder, first, last);
           if (!it->m_key.empty() && it->m_values.empty() && it->m_children.empty())
           {
             m_children.erase(it);
@@ -385,7 +394,10 @@ private:
         else
         {
           // m_key == key
-          result = remove_value(value);
+          for (auto value = first; value != last; ++value)
+          {
+            result += remove_value(*value) ? 1u : 0u;
+          }
         }
 
         if (!m_key.empty() && m_values.empty() && m_children.size() == 1u)
@@ -654,8 +666,6 @@ private:
     }
 
   private:
-    void insert_value(const V& value) const { m_values[value]++; }
-
     bool remove_value(const V& value) const
     {
       auto it = m_values.find(value);
@@ -810,7 +820,35 @@ public:
    * @param key the key to insert
    * @param value the value to insert
    */
-  void insert(const std::string_view key, const V& value) { m_root.insert(key, value); }
+  void insert(const std::string_view key, const V& value)
+  {
+    m_root.insert(key).insert_value(value);
+  }
+
+  /**
+   * Inserts all of the given values under their keys. This is faster than inserting the
+   * values one by one when many values share a key, e.g. when building a trie from
+   * scratch, because the entries are sorted by key and the trie is descended only once
+   * for every distinct key.
+   *
+   * @param entries the keys and values to insert
+   */
+  void insert_all(std::vector<std::pair<std::string_view, V>> entries)
+  {
+    std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+      const auto& key = it->first;
+      const auto& n = m_root.insert(key);
+      for (; it != entries.end() && it->first == key; ++it)
+      {
+        n.insert_value(it->second);
+      }
+    }
+  }
 
   /**
    * Removes the given value using the given key.
@@ -822,7 +860,35 @@ public:
    */
   bool remove(const std::string_view key, const V& value)
   {
-    return m_root.remove(key, value);
+    return m_root.remove(key, &value, &value + 1) > 0u;
+  }
+
+  /**
+   * Removes all of the given values using their keys. Like insert_all, this is faster
+   * than removing the values one by one when many values share a key.
+   *
+   * @param entries the keys and values to remove
+   * @return the number of values that were found and removed
+   */
+  std::size_t remove_all(std::vector<std::pair<std::string_view, V>> entries)
+  {
+    std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+
+    auto result = std::size_t(0);
+    auto values = std::vector<V>{};
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+      const auto key = it->first;
+      values.clear();
+      for (; it != entries.end() && it->first == key; ++it)
+      {
+        values.push_back(it->second);
+      }
+      result += m_root.remove(key, values.data(), values.data() + values.size());
+    }
+    return result;
   }
 
   /**
@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace kdl
+{
+
+/**
+ * An immutable string whose contents are stored in a global pool.
+ *
+ * All interned strings with equal contents refer to the same pooled string, so copying an
+ * interned string only copies a pointer, and two interned strings can be tested for
+ * equality by comparing their pointers. This saves memory and time if many objects store
+ * copies of a small set of strings, e.g. the texture names of brush faces.
+ *
+ * Pooled strings are never released. Interning a string is thread safe.
+ */
+class interned_string
+{
+private:
+  class pool
+  {
+  private:
+    std::shared_mutex m_mutex;
+    // a deque does not move its elements when growing, so the keys remain valid
+    std::deque<std::string> m_strings;
+    std::unordered_map<std::string_view, const std::string*> m_index;
+
+  public:
+    const std::string* intern(const std::string_view str)
+    {
+      {
+        const auto lock = std::shared_lock{m_mutex};
+        if (const auto it = m_index.find(str); it != m_index.end())
+        {
+          return it->second;
+        }
+      }
+
+      const auto lock = std::unique_lock{m_mutex};
+      // another thread might have interned the string in the meantime
+      if (const auto it = m_index.find(str); it != m_index.end())
+      {
+        return it->second;
+      }
+
+      const auto& pooled = m_strings.emplace_back(str);
+      m_index.emplace(pooled, &pooled);
+      return &pooled;
+    }
+
+  };
+
+  static pool& global_pool()
+  {
+    static auto instance = pool{};
+    return instance;
+  }
+
+  const std::string* m_str;
+
+public:
+  /**
+   * Creates an interned empty string.
+   */
+  interned_string()
+    : m_str{empty_string()}
+  {
+  }
+
+  /**
+   * Interns the given string.
+   */
+  explicit interned_string(const std::string_view str)
+    : m_str{global_pool().intern(str)}
+  {
+  }
+
+  const std::string& str() const { return *m_str; }
+
+  operator const std::string&() const { return *m_str; }
+
+  bool empty() const { return m_str->empty(); }
+
+  std::size_t size() const { return m_str->size(); }
+
+  friend bool operator==(const interned_string& lhs, const interned_string& rhs)
+  {
+    return lhs.m_str == rhs.m_str;
+  }
+
+  friend bool operator!=(const interned_string& lhs, const interned_string& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator<(const interned_string& lhs, const interned_string& rhs)
+  {
+    return lhs.m_str != rhs.m_str && *lhs.m_str < *rhs.m_str;
+  }
+
+  friend std::ostream& operator<<(std::ostream& lhs, const interned_string& rhs)
+  {
+    return lhs << *rhs.m_str;
+  }
+
+private:
+  static const std::string* empty_string()
+  {
+    static const auto* result = global_pool().intern("");
+    return result;
+  }
+};
+
+} // namespace kdl
+
+template <>
+struct std::hash<kdl::interned_string>
+{
+  std::size_t operator()(const kdl::interned_string& str) const noexcept
+  {
+    return std::hash<const std::string*>{}(&str.str());
+  }
+};
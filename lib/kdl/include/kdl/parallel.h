@@ -24,12 +24,15 @@
 
 #ifdef _WIN32
 #include <ppl.h>
+#else
+#include "kdl/thread_pool.h"
 #endif
 
-#include <atomic>
-#include <future> // for std::async
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
 #include <optional>
-#include <thread>
 #include <utility> // for std::declval
 #include <vector>
 
@@ -38,12 +41,14 @@ namespace kdl
 /**
  * Runs the given lambda `count` times, passing it indices `0` through `count - 1`.
  *
- * Lambda is executed in parallel, using the number of threads returned by
- * std::thread::hardware_concurrency().
+ * Lambda is executed in parallel. On Windows, the concurrency runtime is used, and on
+ * all other platforms, the indices are split into chunks which are processed by the
+ * worker threads of the process wide thread pool returned by default_thread_pool() and
+ * by the calling thread. Since the worker threads are only created once, the overhead
+ * per call is small, but the function should still not be used for tiny data sets.
  *
- * Because the threads are spawned with std::async(std::launch::async, ...) and no thread
- * pool is used, there is a relatively large overhead and this should only be used on
- * large/slow to process data sets.
+ * This function may be called from within the lambda passed to another invocation of
+ * parallel_for or vec_parallel_transform.
  *
  * @tparam L type of lambda
  * @param count the maximum value (exclusive) to pass to lambda
@@ -55,36 +60,7 @@ void parallel_for(const size_t count, L&& lambda)
 #ifdef _WIN32
   concurrency::parallel_for<size_t>(0, count, lambda);
 #else
-  size_t numThreads = static_cast<size_t>(std::thread::hardware_concurrency());
-  if (numThreads == 0)
-  {
-    numThreads = 1;
-  }
-
-  std::atomic<size_t> nextIndex(0);
-
-  std::vector<std::future<void>> threads;
-  threads.resize(numThreads);
-
-  for (size_t i = 0; i < numThreads; ++i)
-  {
-    threads[i] = std::async(std::launch::async, [&]() {
-      while (true)
-      {
-        const size_t ourIndex = std::atomic_fetch_add(&nextIndex, static_cast<size_t>(1));
-        if (ourIndex >= count)
-        {
-          break;
-        }
-        lambda(ourIndex);
-      }
-    });
-  }
-
-  for (size_t i = 0; i < numThreads; ++i)
-  {
-    threads[i].wait();
-  }
+  default_thread_pool().parallel_for(count, lambda);
 #endif
 }
 
@@ -92,12 +68,7 @@ void parallel_for(const size_t count, L&& lambda)
  * Applies the given lambda to each element of the input (passing elements as rvalue
  * references), and returns a vector of the resulting values, in their original order.
  *
- * The lambda is executed in parallel, using the number of threads returned by
- * std::thread::hardware_concurrency().
- *
- * Because the threads are spawned with std::async(std::launch::async, ...) and no thread
- * pool is used, there is a relatively large overhead and this should only be used on
- * large/slow to process data sets.
+ * The lambda is executed in parallel using parallel_for.
  *
  * @tparam T the type of the vector elements
  * @tparam L the type of the lambda to apply
@@ -119,4 +90,191 @@ auto vec_parallel_transform(std::vector<T> input, L&& transform)
 
   return vec_transform(std::move(result), [](ResultType&& x) { return std::move(*x); });
 }
+
+namespace detail
+{
+/**
+ * Returns the number of chunks into which the parallel algorithms below split a range of
+ * the given size. The number only depends on the size of the range and not on the number
+ * of threads, which makes the results deterministic.
+ */
+inline std::size_t parallel_chunk_count(const std::size_t count)
+{
+  constexpr auto min_chunk_size = std::size_t(1024);
+  constexpr auto max_chunk_count = std::size_t(64);
+  return std::clamp(count / min_chunk_size, std::size_t(1), max_chunk_count);
+}
+
+inline std::pair<std::size_t, std::size_t> parallel_chunk_bounds(
+  const std::size_t count, const std::size_t chunk_count, const std::size_t chunk)
+{
+  return {chunk * count / chunk_count, (chunk + 1) * count / chunk_count};
+}
+} // namespace detail
+
+/**
+ * Maps the indices `0` through `count - 1` using the given map lambda and combines the
+ * results and the given initial value using the given reduce lambda.
+ *
+ * The indices are split into consecutive chunks whose results are computed in parallel
+ * using parallel_for. The results of the chunks are then combined in order. Since the
+ * chunks only depend on `count`, the result is deterministic even if the reduce lambda is
+ * not associative, e.g. when summing up floating point values. The reduce lambda must be
+ * associative for the result to be equal to that of a serial reduction.
+ *
+ * @tparam T the type of the result
+ * @tparam M the type of the map lambda, must be of type `T(std::size_t)`
+ * @tparam R the type of the reduce lambda, must be of type `T(T, T)`
+ * @param count the number of indices
+ * @param init the initial value
+ * @param map the map lambda
+ * @param reduce the reduce lambda
+ * @return the result of the reduction, or `init` if `count` is 0
+ */
+template <class T, class M, class R>
+T parallel_reduce(const std::size_t count, T init, const M& map, const R& reduce)
+{
+  const auto chunk_count = detail::parallel_chunk_count(count);
+
+  auto chunk_results = std::vector<std::optional<T>>(chunk_count);
+  parallel_for(chunk_count, [&](const std::size_t chunk) {
+    const auto [first, last] = detail::parallel_chunk_bounds(count, chunk_count, chunk);
+    if (first < last)
+    {
+      T result = map(first);
+      for (auto i = first + 1; i < last; ++i)
+      {
+        result = reduce(std::move(result), map(i));
+      }
+      chunk_results[chunk] = std::move(result);
+    }
+  });
+
+  auto result = std::move(init);
+  for (auto& chunk_result : chunk_results)
+  {
+    if (chunk_result)
+    {
+      result = reduce(std::move(result), std::move(*chunk_result));
+    }
+  }
+  return result;
+}
+
+/**
+ * Sorts the given range using the given comparator.
+ *
+ * The range is split into consecutive chunks which are sorted in parallel, and then the
+ * sorted chunks are merged pairwise in parallel. The sort is stable, so the result is
+ * the same as that of std::stable_sort.
+ *
+ * @tparam I the type of the random access iterators
+ * @tparam C the type of the comparator
+ * @param first the beginning of the range to sort
+ * @param last the end of the range to sort
+ * @param comp the comparator
+ */
+template <class I, class C>
+void parallel_sort(I first, I last, const C& comp)
+{
+  const auto count = static_cast<std::size_t>(std::distance(first, last));
+  const auto chunk_count = detail::parallel_chunk_count(count);
+
+  // the beginning of every chunk and the end of the range
+  auto bounds = std::vector<I>{};
+  bounds.reserve(chunk_count + 1);
+  for (std::size_t chunk = 0; chunk < chunk_count; ++chunk)
+  {
+    const auto offset = detail::parallel_chunk_bounds(count, chunk_count, chunk).first;
+    bounds.push_back(std::next(first, static_cast<std::ptrdiff_t>(offset)));
+  }
+  bounds.push_back(last);
+
+  parallel_for(chunk_count, [&](const std::size_t chunk) {
+    std::stable_sort(bounds[chunk], bounds[chunk + 1], comp);
+  });
+
+  // merge adjacent pairs of sorted runs until only one run is left
+  while (bounds.size() > 2)
+  {
+    const auto run_count = bounds.size() - 1;
+    parallel_for(run_count / 2, [&](const std::size_t pair) {
+      std::inplace_merge(
+        bounds[2 * pair], bounds[2 * pair + 1], bounds[2 * pair + 2], comp);
+    });
+
+    auto merged_bounds = std::vector<I>{};
+    merged_bounds.reserve(run_count / 2 + 2);
+    for (std::size_t i = 0; i < bounds.size(); i += 2)
+    {
+      merged_bounds.push_back(bounds[i]);
+    }
+    if (run_count % 2 == 1)
+    {
+      merged_bounds.push_back(last);
+    }
+    bounds = std::move(merged_bounds);
+  }
+}
+
+/**
+ * Sorts the given range using operator<, see above.
+ */
+template <class I>
+void parallel_sort(I first, I last)
+{
+  parallel_sort(first, last, std::less<>{});
+}
+
+/**
+ * Reorders the given range such that all elements for which the given predicate returns
+ * true precede the elements for which it returns false, and returns an iterator to the
+ * first element of the second group.
+ *
+ * The predicate is evaluated in parallel using parallel_for, which pays off if it is
+ * expensive. The elements are then moved serially. The partition is stable, so the
+ * result is the same as that of std::stable_partition.
+ *
+ * @tparam I the type of the random access iterators
+ * @tparam P the type of the predicate
+ * @param first the beginning of the range to partition
+ * @param last the end of the range to partition
+ * @param pred the predicate
+ * @return an iterator to the first element of the second group
+ */
+template <class I, class P>
+I parallel_partition(I first, I last, const P& pred)
+{
+  const auto count = static_cast<std::size_t>(std::distance(first, last));
+
+  // std::vector<bool> cannot be written concurrently
+  auto matches = std::vector<char>(count);
+  parallel_for(count, [&](const std::size_t i) {
+    matches[i] = pred(*std::next(first, static_cast<std::ptrdiff_t>(i))) ? 1 : 0;
+  });
+
+  using value_type = typename std::iterator_traits<I>::value_type;
+  auto rest = std::vector<value_type>{};
+
+  auto out = first;
+  auto it = first;
+  for (std::size_t i = 0; i < count; ++i, ++it)
+  {
+    if (matches[i])
+    {
+      if (out != it)
+      {
+        *out = std::move(*it);
+      }
+      ++out;
+    }
+    else
+    {
+      rest.push_back(std::move(*it));
+    }
+  }
+
+  std::move(rest.begin(), rest.end(), out);
+  return out;
+}
 } // namespace kdl
@@ -22,8 +22,10 @@
 
 #include "kdl/collection_utils.h"
 
-#include <algorithm> // for std::sort, std::unique, std::lower_bound, std::upper_bound
+#include <algorithm> // for std::sort, std::unique, std::lower_bound, std::upper_bound,
+                     // std::inplace_merge
 #include <cassert>
+#include <cstddef>
 #include <functional> // for std::less
 #include <iterator>   // for std::distance
 #include <memory>     // for std::allocator
@@ -44,6 +46,23 @@ static void sort_unique(std::vector<T, Allocator>& vec, const Compare& cmp)
   std::sort(std::begin(vec), std::end(vec), cmp);
   vec.erase(std::unique(std::begin(vec), std::end(vec), eq), std::end(vec));
 }
+
+/**
+ * Merges the sorted and unique values of the given vector starting at the given offset
+ * into the sorted and unique values before it. Of any two equivalent values, the one
+ * that comes first is kept.
+ */
+template <typename T, typename Allocator, typename Compare>
+static void merge_unique(
+  std::vector<T, Allocator>& vec, const std::size_t offset, const Compare& cmp)
+{
+  auto eq = [&cmp](const auto& lhs, const auto& rhs) {
+    return !cmp(lhs, rhs) && !cmp(rhs, lhs);
+  };
+  const auto mid = std::next(std::begin(vec), static_cast<std::ptrdiff_t>(offset));
+  std::inplace_merge(std::begin(vec), mid, std::end(vec), cmp);
+  vec.erase(std::unique(std::begin(vec), std::end(vec), eq), std::end(vec));
+}
 } // namespace detail
 
 /**
@@ -666,6 +685,11 @@ public:
   /**
    * Inserts the values from the given range [first, last) into this set.
    *
+   * The values are appended to the underlying vector, sorted and then merged with the
+   * values of this set in one pass, so inserting k values into a set of size n takes
+   * O(n + k log k) instead of O(k * n) time. If the range contains equivalent values, or
+   * values equivalent to values of this set, the first of them is kept.
+   *
    * Postcondition: for each value in the given range, this set contains an equivalent
    value and its size has
    * increased by one if the by the number of unique values in the given range which were
@@ -678,11 +702,12 @@ public:
   template <typename I>
   void insert(I first, I last)
   {
-    while (first != last)
-    {
-      do_insert(*first);
-      ++first;
-    }
+    const auto offset = size();
+    m_data.insert(std::end(m_data), first, last);
+
+    const auto mid = std::next(std::begin(m_data), static_cast<difference_type>(offset));
+    std::stable_sort(mid, std::end(m_data), m_cmp);
+    detail::merge_unique(m_data, offset, m_cmp);
     assert(check_invariant());
   }
 
@@ -725,6 +750,31 @@ public:
     insert(values.size(), std::begin(values), std::end(values));
   }
 
+  /**
+   * Inserts copies of all values of the given set into this set. Since both sets are
+   * sorted, this takes linear time. Unlike std::set::merge, the given set is not
+   * modified.
+   *
+   * Postcondition: for each value in the given set, this set contains an equivalent value
+   *
+   * @tparam CC the type of the collection underlying the given set
+   * @param other the set whose values to insert
+   */
+  template <typename CC>
+  void merge(const const_set_adapter<CC, Compare>& other)
+  {
+    if (
+      static_cast<const void*>(&other.get_data()) == static_cast<const void*>(&m_data))
+    {
+      return;
+    }
+
+    const auto offset = size();
+    m_data.insert(std::end(m_data), std::begin(other), std::end(other));
+    detail::merge_unique(m_data, offset, m_cmp);
+    assert(check_invariant());
+  }
+
   /**
    * Inserts a new value constructed from the given arguments into this set. If this set
    * already contains a value that is equivalent to the newly constructed value, the
@@ -851,6 +901,51 @@ public:
     return size_before - size();
   }
 
+  /**
+   * Erases the values from this set which are equivalent to any of the values in the
+   * given range [first, last).
+   *
+   * The given values are sorted and then removed from this set in one pass, so erasing k
+   * values from a set of size n takes O(n + k log k) instead of O(k * n) time.
+   *
+   * Postcondition: the set does not contain any value equivalent to a value in the given
+   * range, and the size has decreased accordingly
+   *
+   * @tparam I the iterator type
+   * @param first the beginning of the range of values to erase
+   * @param last the end of the range of values to erase (past-the-end iterator)
+   * @return the number of erased values
+   */
+  template <typename I>
+  size_type erase_values(I first, I last)
+  {
+    auto keys = std::vector<value_type>(first, last);
+    std::sort(std::begin(keys), std::end(keys), m_cmp);
+
+    const auto size_before = size();
+    auto key = std::begin(keys);
+    auto out = begin();
+    for (auto it = begin(); it != end(); ++it)
+    {
+      while (key != std::end(keys) && m_cmp(*key, *it))
+      {
+        ++key;
+      }
+      if (key == std::end(keys) || m_cmp(*it, *key))
+      {
+        if (out != it)
+        {
+          *out = std::move(*it);
+        }
+        ++out;
+      }
+    }
+    m_data.erase(out, end());
+
+    assert(check_invariant());
+    return size_before - size();
+  }
+
   /**
    * Swaps this set with the given set. This function is only callable if the underlying
    * collection is stored by value;
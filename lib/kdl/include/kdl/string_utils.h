@@ -25,6 +25,7 @@
 #include <algorithm> // for std::search
 #include <cassert>
 #include <charconv>
+#include <cstdint>
 #include <iterator>
 #include <optional>
 #include <sstream>
@@ -493,4 +494,22 @@ inline std::optional<long double> str_to_long_double(std::string_view str)
            : std::nullopt;
 #endif
 }
+
+/**
+ * Computes a 64 bit FNV-1a hash of the given string. Unlike std::hash, the result does
+ * not depend on the platform or on the standard library, so it can be stored in files.
+ *
+ * @param str the string
+ * @return the hash value
+ */
+inline std::uint64_t str_hash(const std::string_view str)
+{
+  auto hash = std::uint64_t(14695981039346656037ull);
+  for (const auto c : str)
+  {
+    hash ^= std::uint64_t(static_cast<unsigned char>(c));
+    hash *= std::uint64_t(1099511628211ull);
+  }
+  return hash;
+}
 } // namespace kdl
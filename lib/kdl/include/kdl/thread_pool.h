@@ -0,0 +1,377 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace kdl
+{
+
+/**
+ * A pool of worker threads that execute submitted tasks.
+ *
+ * Every worker owns a task queue. A task submitted from a worker thread is added to that
+ * worker's queue, and a task submitted from any other thread is distributed among the
+ * worker queues in a round robin fashion. A worker takes tasks from the back of its own
+ * queue first, and when its own queue is empty, it steals tasks from the front of the
+ * other workers' queues.
+ *
+ * The worker threads are started when the pool is created and they are joined when the
+ * pool is destroyed. Tasks that are still pending when the pool is destroyed are executed
+ * before the workers terminate.
+ */
+class thread_pool
+{
+public:
+  using task = std::function<void()>;
+
+private:
+  struct task_queue
+  {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+  struct worker_info
+  {
+    const thread_pool* pool = nullptr;
+    std::size_t index = 0;
+  };
+
+  std::vector<std::unique_ptr<task_queue>> m_queues;
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake_condition;
+  std::atomic<std::ptrdiff_t> m_pending_tasks = 0;
+  std::atomic<std::size_t> m_next_queue = 0;
+  bool m_stop = false;
+
+public:
+  /**
+   * Creates a new thread pool with the given number of worker threads.
+   *
+   * @param thread_count the number of worker threads, at least one thread is created
+   */
+  explicit thread_pool(const std::size_t thread_count = default_thread_count())
+  {
+    const auto count = std::max(thread_count, std::size_t(1));
+
+    m_queues.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      m_queues.push_back(std::make_unique<task_queue>());
+    }
+
+    m_threads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      m_threads.emplace_back([this, i]() { run_worker(i); });
+    }
+  }
+
+  ~thread_pool()
+  {
+    {
+      auto lock = std::unique_lock{m_wake_mutex};
+      m_stop = true;
+    }
+    m_wake_condition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+      thread.join();
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool(thread_pool&&) = delete;
+
+  thread_pool& operator=(const thread_pool&) = delete;
+  thread_pool& operator=(thread_pool&&) = delete;
+
+  /**
+   * Returns the default number of worker threads. Since a thread that waits for the
+   * completion of a parallel_for call participates in the computation, this is one less
+   * than the number of hardware threads, but at least one.
+   */
+  static std::size_t default_thread_count()
+  {
+    const auto hardware_threads =
+      static_cast<std::size_t>(std::thread::hardware_concurrency());
+    return hardware_threads > 1 ? hardware_threads - 1 : std::size_t(1);
+  }
+
+  /**
+   * Returns the number of worker threads.
+   */
+  std::size_t size() const { return m_threads.size(); }
+
+  /**
+   * Indicates whether the calling thread is a worker thread of this pool.
+   */
+  bool is_worker_thread() const { return current_worker().pool == this; }
+
+  /**
+   * Submits the given task for execution by one of the worker threads.
+   *
+   * If this function is called from a worker thread, the task is added to that worker's
+   * own queue, and otherwise, it is added to the queues in a round robin fashion.
+   *
+   * The task must not throw any exceptions.
+   */
+  void submit(task t)
+  {
+    const auto& worker = current_worker();
+    const auto queue_index =
+      worker.pool == this ? worker.index : m_next_queue++ % m_queues.size();
+
+    {
+      auto& queue = *m_queues[queue_index];
+      auto lock = std::unique_lock{queue.mutex};
+      queue.tasks.push_back(std::move(t));
+    }
+
+    {
+      auto lock = std::unique_lock{m_wake_mutex};
+      ++m_pending_tasks;
+    }
+    m_wake_condition.notify_one();
+  }
+
+  /**
+   * Calls the given lambda `count` times, passing it indices `0` through `count - 1`.
+   *
+   * The index range is split into chunks of `chunk_size` indices, and the chunks are
+   * processed in parallel by the worker threads and the calling thread. If `chunk_size`
+   * is 0, a chunk size is chosen such that each thread processes about four chunks.
+   *
+   * This function returns once every index has been processed. It may be called from
+   * within a task or from within a lambda passed to parallel_for, i.e., nested
+   * invocations are supported. Since the calling thread processes chunks itself, a nested
+   * invocation makes progress even when all workers are busy.
+   *
+   * If the lambda throws an exception, no further chunks are started and the first
+   * exception thrown is rethrown by this function once all running chunks have finished.
+   *
+   * @tparam L type of lambda
+   * @param count the maximum value (exclusive) to pass to lambda
+   * @param lambda the lambda to run
+   * @param chunk_size the number of indices processed by a single task, or 0
+   */
+  template <class L>
+  void parallel_for(const std::size_t count, const L& lambda, std::size_t chunk_size = 0)
+  {
+    if (count == 0)
+    {
+      return;
+    }
+
+    if (chunk_size == 0)
+    {
+      chunk_size = std::max(count / ((size() + 1) * 4), std::size_t(1));
+    }
+
+    const auto chunk_count = (count + chunk_size - 1) / chunk_size;
+    if (chunk_count == 1)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        lambda(i);
+      }
+      return;
+    }
+
+    auto state = std::make_shared<parallel_for_state>(chunk_count);
+
+    // The worker tasks hold a reference to the lambda. This is safe because a task only
+    // accesses the lambda if it claims a chunk, and this function does not return before
+    // all chunks have been claimed and processed.
+    const auto process_chunks = [&lambda, count, chunk_size, chunk_count](
+                                  parallel_for_state& s) {
+      while (true)
+      {
+        const auto chunk = s.next_chunk++;
+        if (chunk >= chunk_count)
+        {
+          return;
+        }
+
+        if (!s.failed)
+        {
+          try
+          {
+            const auto first = chunk * chunk_size;
+            const auto last = std::min(first + chunk_size, count);
+            for (auto i = first; i < last; ++i)
+            {
+              lambda(i);
+            }
+          }
+          catch (...)
+          {
+            auto lock = std::unique_lock{s.mutex};
+            if (!s.exception)
+            {
+              s.exception = std::current_exception();
+              s.failed = true;
+            }
+          }
+        }
+
+        if (--s.remaining_chunks == 0)
+        {
+          auto lock = std::unique_lock{s.mutex};
+          s.done_condition.notify_all();
+        }
+      }
+    };
+
+    const auto task_count = std::min(size(), chunk_count - 1);
+    for (std::size_t i = 0; i < task_count; ++i)
+    {
+      submit([state, process_chunks]() { process_chunks(*state); });
+    }
+
+    process_chunks(*state);
+
+    {
+      auto lock = std::unique_lock{state->mutex};
+      state->done_condition.wait(lock, [&]() { return state->remaining_chunks == 0; });
+    }
+
+    if (state->exception)
+    {
+      std::rethrow_exception(state->exception);
+    }
+  }
+
+private:
+  struct parallel_for_state
+  {
+    std::atomic<std::size_t> next_chunk = 0;
+    std::atomic<std::size_t> remaining_chunks;
+    std::atomic<bool> failed = false;
+
+    std::mutex mutex;
+    std::condition_variable done_condition;
+    std::exception_ptr exception;
+
+    explicit parallel_for_state(const std::size_t chunk_count)
+      : remaining_chunks{chunk_count}
+    {
+    }
+  };
+
+  static worker_info& current_worker()
+  {
+    static thread_local auto info = worker_info{};
+    return info;
+  }
+
+  void run_worker(const std::size_t index)
+  {
+    current_worker() = worker_info{this, index};
+
+    while (true)
+    {
+      if (auto t = pop_task(index))
+      {
+        (*t)();
+        continue;
+      }
+
+      auto lock = std::unique_lock{m_wake_mutex};
+      m_wake_condition.wait(lock, [&]() { return m_stop || m_pending_tasks > 0; });
+      if (m_stop && m_pending_tasks <= 0)
+      {
+        return;
+      }
+    }
+  }
+
+  std::optional<task> pop_task(const std::size_t index)
+  {
+    // take the most recently added task from our own queue
+    if (auto t = take_task(*m_queues[index], false))
+    {
+      return t;
+    }
+
+    // steal the oldest task from another worker's queue
+    for (std::size_t i = 1; i < m_queues.size(); ++i)
+    {
+      if (auto t = take_task(*m_queues[(index + i) % m_queues.size()], true))
+      {
+        return t;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  std::optional<task> take_task(task_queue& queue, const bool front)
+  {
+    auto lock = std::unique_lock{queue.mutex};
+    if (queue.tasks.empty())
+    {
+      return std::nullopt;
+    }
+
+    auto t = std::optional<task>{};
+    if (front)
+    {
+      t = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    else
+    {
+      t = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+
+    --m_pending_tasks;
+    return t;
+  }
+};
+
+/**
+ * Returns the process wide thread pool that backs parallel_for and
+ * vec_parallel_transform. The pool is created on first use.
+ */
+inline thread_pool& default_thread_pool()
+{
+  static auto pool = thread_pool{};
+  return pool;
+}
+
+} // namespace kdl
@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+#include "kdl/block_pool.h"
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "catch2.h"
+
+namespace kdl
+{
+TEST_CASE("block_pool")
+{
+  using pool = block_pool<24, 8, 4>;
+
+  SECTION("allocate returns distinct aligned blocks")
+  {
+    auto blocks = std::vector<void*>{};
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+      blocks.push_back(pool::allocate());
+    }
+
+    CHECK(std::set<void*>{blocks.begin(), blocks.end()}.size() == blocks.size());
+    for (auto* block : blocks)
+    {
+      CHECK(reinterpret_cast<std::uintptr_t>(block) % 8u == 0u);
+    }
+
+    for (auto* block : blocks)
+    {
+      pool::deallocate(block);
+    }
+  }
+
+  SECTION("deallocated blocks are reused")
+  {
+    auto* block = pool::allocate();
+    pool::deallocate(block);
+    CHECK(pool::allocate() == block);
+    pool::deallocate(block);
+  }
+
+  SECTION("deallocate nullptr")
+  {
+    pool::deallocate(nullptr);
+  }
+
+  SECTION("blocks can be deallocated on another thread")
+  {
+    auto blocks = std::vector<void*>{};
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      blocks.push_back(pool::allocate());
+    }
+
+    std::thread{[&]() {
+      for (auto* block : blocks)
+      {
+        pool::deallocate(block);
+      }
+    }}.join();
+
+    // the blocks were returned to the shared pool when the thread terminated
+    auto reused = std::set<void*>{};
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      reused.insert(pool::allocate());
+    }
+    CHECK(reused == std::set<void*>{blocks.begin(), blocks.end()});
+
+    for (auto* block : reused)
+    {
+      pool::deallocate(block);
+    }
+  }
+}
+
+TEST_CASE("block_pool_allocator")
+{
+  using allocator = block_pool_allocator<std::uint64_t>;
+
+  SECTION("single objects are taken from the pool")
+  {
+    auto* ptr = allocator{}.allocate(1);
+    allocator{}.deallocate(ptr, 1);
+
+    auto* block = block_pool<sizeof(std::uint64_t), alignof(std::uint64_t)>::allocate();
+    CHECK(static_cast<void*>(ptr) == block);
+    block_pool<sizeof(std::uint64_t), alignof(std::uint64_t)>::deallocate(block);
+  }
+
+  SECTION("arrays are allocated")
+  {
+    auto* ptr = allocator{}.allocate(4);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+      ptr[i] = i;
+    }
+    allocator{}.deallocate(ptr, 4);
+  }
+
+  SECTION("all allocators are equal")
+  {
+    CHECK(allocator{} == allocator{});
+    CHECK(allocator{} == block_pool_allocator<char>{});
+    CHECK_FALSE(allocator{} != allocator{});
+  }
+
+  SECTION("node based containers")
+  {
+    auto set = std::set<int, std::less<int>, block_pool_allocator<int>>{};
+    for (int i = 0; i < 1000; ++i)
+    {
+      set.insert(i);
+    }
+    CHECK(set.size() == 1000u);
+
+    auto other = std::move(set);
+    CHECK(other.size() == 1000u);
+    CHECK(*other.begin() == 0);
+  }
+}
+} // namespace kdl
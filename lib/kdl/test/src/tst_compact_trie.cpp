@@ -76,6 +76,65 @@ TEST_CASE("compact_trie_test.insert")
   assertMatches(index, "*", {"value", "value", "value2", "value3", "value4", "value4"});
 }
 
+TEST_CASE("compact_trie_test.insert_all")
+{
+  test_index index;
+  index.insert("key", "value");
+
+  index.insert_all({
+    {"key22", "value2"},
+    {"test", "value4"},
+    {"key2", "value"},
+    {"k1", "value3"},
+    {"key22", "value5"},
+    {"key", "value"},
+  });
+
+  assertMatches(index, "key", {"value", "value"});
+  assertMatches(index, "key2", {"value"});
+  assertMatches(index, "key22", {"value2", "value5"});
+  assertMatches(index, "k*", {"value", "value", "value", "value2", "value5", "value3"});
+  assertMatches(index, "test", {"value4"});
+
+  CHECK(index.remove("key22", "value5"));
+  assertMatches(index, "key22", {"value2"});
+
+  index.insert_all({});
+  assertMatches(
+    index, "*", {"value", "value", "value", "value2", "value3", "value4"});
+}
+
+TEST_CASE("compact_trie_test.remove_all")
+{
+  test_index index;
+  index.insert_all({
+    {"key", "value"},
+    {"key", "value"},
+    {"key2", "value2"},
+    {"key22", "value2"},
+    {"key22", "value5"},
+    {"test", "value4"},
+  });
+
+  CHECK(
+    index.remove_all({
+      {"key22", "value5"},
+      {"key", "value"},
+      {"key22", "value2"},
+      {"test", "value"},
+    })
+    == 3u);
+
+  assertMatches(index, "key", {"value"});
+  assertMatches(index, "key2*", {"value2"});
+  assertMatches(index, "test", {"value4"});
+
+  CHECK(index.remove_all({}) == 0u);
+  CHECK(
+    index.remove_all({{"key", "value"}, {"key2", "value2"}, {"test", "value4"}}) == 3u);
+  assertMatches(index, "*", {});
+}
+
 TEST_CASE("compact_trie_test.remove")
 {
   test_index index;
@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+#include "kdl/interned_string.h"
+
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "catch2.h"
+
+namespace kdl
+{
+TEST_CASE("interned_string")
+{
+  SECTION("default constructor creates an empty string")
+  {
+    CHECK(interned_string{}.empty());
+    CHECK(interned_string{} == interned_string{""});
+  }
+
+  SECTION("equal strings share their contents")
+  {
+    const auto s1 = interned_string{"some_texture"};
+    const auto s2 = interned_string{std::string{"some_"} + "texture"};
+
+    CHECK(s1 == s2);
+    CHECK(&s1.str() == &s2.str());
+    CHECK(s1.str() == "some_texture");
+    CHECK(s1.size() == 12u);
+  }
+
+  SECTION("different strings")
+  {
+    const auto s1 = interned_string{"a"};
+    const auto s2 = interned_string{"b"};
+
+    CHECK(s1 != s2);
+    CHECK(s1 < s2);
+    CHECK_FALSE(s2 < s1);
+    CHECK_FALSE(s1 < s1);
+  }
+
+  SECTION("interned strings remain valid when the pool grows")
+  {
+    const auto s = interned_string{"first"};
+    const auto* str = &s.str();
+
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+      interned_string{"string_" + std::to_string(i)};
+    }
+
+    CHECK(&interned_string{"first"}.str() == str);
+    CHECK(*str == "first");
+  }
+
+  SECTION("hash")
+  {
+    const auto set = std::unordered_set<interned_string>{
+      interned_string{"a"}, interned_string{"b"}, interned_string{"a"}};
+    CHECK(set.size() == 2u);
+  }
+
+  SECTION("interning is thread safe")
+  {
+    auto results = std::vector<std::vector<const std::string*>>(4);
+    auto threads = std::vector<std::thread>{};
+    for (auto& result : results)
+    {
+      threads.emplace_back([&]() {
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+          result.push_back(&interned_string{"thread_" + std::to_string(i)}.str());
+        }
+      });
+    }
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    for (const auto& result : results)
+    {
+      CHECK(result == results.front());
+    }
+  }
+}
+} // namespace kdl
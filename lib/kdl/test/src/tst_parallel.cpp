@@ -22,11 +22,15 @@
 
 #include "kdl/parallel.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <memory>
+#include <numeric>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "catch2.h"
@@ -99,6 +103,21 @@ TEST_CASE("transform_many")
         }));
 }
 
+TEST_CASE("nested for")
+{
+  constexpr size_t Outer = 100;
+  constexpr size_t Inner = 100;
+
+  auto sums = std::vector<size_t>(Outer, 0);
+  kdl::parallel_for(Outer, [&](const size_t i) {
+    auto innerSum = std::atomic<size_t>{0};
+    kdl::parallel_for(Inner, [&](const size_t j) { innerSum += j; });
+    sums[i] = innerSum;
+  });
+
+  CHECK(sums == std::vector<size_t>(Outer, Inner * (Inner - 1) / 2));
+}
+
 TEST_CASE("overhead for small work batches")
 {
   constexpr size_t OuterLoop = 1'000;
@@ -140,4 +159,119 @@ TEST_CASE("overhead for small work batches")
 
   CHECK(static_cast<size_t>(counter) == OuterLoop * InnerLoop);
 }
+
+TEST_CASE("reduce")
+{
+  const auto sum = [](const size_t lhs, const size_t rhs) { return lhs + rhs; };
+  const auto identity = [](const size_t i) { return i; };
+
+  CHECK(kdl::parallel_reduce(0, size_t(7), identity, sum) == 7u);
+  CHECK(kdl::parallel_reduce(1, size_t(7), identity, sum) == 7u);
+  CHECK(kdl::parallel_reduce(100, size_t(0), identity, sum) == 4950u);
+  CHECK(kdl::parallel_reduce(100'000, size_t(0), identity, sum) == 4'999'950'000u);
+
+  // the order of the operands is preserved
+  const auto concat = [](std::string lhs, const std::string& rhs) {
+    return std::move(lhs) + rhs;
+  };
+  const auto digit = [](const size_t i) { return std::to_string(i % 10); };
+
+  auto expected = std::string{"x"};
+  for (size_t i = 0; i < 10'000; ++i)
+  {
+    expected += digit(i);
+  }
+  CHECK(kdl::parallel_reduce(10'000, std::string{"x"}, digit, concat) == expected);
+
+  // the result is deterministic even if the operation is not associative
+  const auto values = [](const size_t i) { return 1.0 / double(i + 1); };
+  const auto add = [](const double lhs, const double rhs) { return lhs + rhs; };
+  const auto result = kdl::parallel_reduce(100'000, 0.0, values, add);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    CHECK(kdl::parallel_reduce(100'000, 0.0, values, add) == result);
+  }
+}
+
+TEST_CASE("sort")
+{
+  SECTION("empty range")
+  {
+    auto v = std::vector<int>{};
+    kdl::parallel_sort(v.begin(), v.end());
+    CHECK(v.empty());
+  }
+
+  SECTION("small range")
+  {
+    auto v = std::vector<int>{3, 1, 2};
+    kdl::parallel_sort(v.begin(), v.end());
+    CHECK(v == std::vector<int>{1, 2, 3});
+  }
+
+  SECTION("large range")
+  {
+    for (const auto size : {size_t(2048), size_t(5000), size_t(100'000)})
+    {
+      auto v = std::vector<std::pair<size_t, size_t>>{};
+      for (size_t i = 0; i < size; ++i)
+      {
+        v.emplace_back((i * 7919) % 1000, i);
+      }
+
+      // compare only the first element to check that the sort is stable
+      const auto comp = [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+      };
+
+      auto expected = v;
+      std::stable_sort(expected.begin(), expected.end(), comp);
+
+      kdl::parallel_sort(v.begin(), v.end(), comp);
+      CHECK(v == expected);
+    }
+  }
+}
+
+TEST_CASE("partition")
+{
+  const auto isEven = [](const size_t i) { return i % 2 == 0; };
+
+  SECTION("empty range")
+  {
+    auto v = std::vector<size_t>{};
+    CHECK(kdl::parallel_partition(v.begin(), v.end(), isEven) == v.end());
+  }
+
+  SECTION("large range")
+  {
+    auto v = std::vector<size_t>(10'000);
+    std::iota(v.begin(), v.end(), size_t(0));
+
+    auto expected = v;
+    const auto expectedIt =
+      std::stable_partition(expected.begin(), expected.end(), isEven);
+
+    const auto it = kdl::parallel_partition(v.begin(), v.end(), isEven);
+    CHECK(std::distance(v.begin(), it) == std::distance(expected.begin(), expectedIt));
+    CHECK(v == expected);
+  }
+
+  SECTION("move only elements")
+  {
+    auto v = std::vector<std::unique_ptr<size_t>>{};
+    for (size_t i = 0; i < 10; ++i)
+    {
+      v.push_back(std::make_unique<size_t>(i));
+    }
+
+    const auto it = kdl::parallel_partition(
+      v.begin(), v.end(), [](const auto& p) { return *p >= 5; });
+    REQUIRE(std::distance(v.begin(), it) == 5);
+    for (size_t i = 0; i < 10; ++i)
+    {
+      CHECK(*v[i] == (i + 5) % 10);
+    }
+  }
+}
 } // namespace kdl
@@ -363,6 +363,49 @@ TEST_CASE("set_adapter_test.insert_with_range_and_count")
   CHECK_THAT(v, Catch::Equals(std::vector<int>{1, 2, 3, 4}));
 }
 
+TEST_CASE("set_adapter_test.insert_with_range_into_non_empty_set")
+{
+  auto v = std::vector<int>{2, 4, 6};
+  auto s = wrap_set(v);
+
+  const auto r = std::vector<int>{7, 4, 1, 5, 1, 2};
+  s.insert(std::begin(r), std::end(r));
+
+  CHECK_THAT(v, Catch::Equals(std::vector<int>{1, 2, 4, 5, 6, 7}));
+
+  s.insert(std::begin(r), std::begin(r));
+  CHECK_THAT(v, Catch::Equals(std::vector<int>{1, 2, 4, 5, 6, 7}));
+}
+
+TEST_CASE("set_adapter_test.insert_with_range_keeps_first_equivalent_value")
+{
+  using pair = std::pair<int, int>;
+  const auto cmp = [](const pair& lhs, const pair& rhs) { return lhs.first < rhs.first; };
+
+  auto v = std::vector<pair>{{1, 0}, {3, 0}};
+  auto s = wrap_set(v, cmp);
+
+  const auto r = std::vector<pair>{{3, 1}, {2, 1}, {2, 2}, {1, 1}};
+  s.insert(std::begin(r), std::end(r));
+
+  CHECK_THAT(v, Catch::Equals(std::vector<pair>{{1, 0}, {2, 1}, {3, 0}}));
+}
+
+TEST_CASE("set_adapter_test.merge")
+{
+  auto v = std::vector<int>{1, 3, 5};
+  auto s = wrap_set(v);
+
+  const auto o = std::vector<int>{2, 3, 4, 7};
+  s.merge(wrap_set(o));
+
+  CHECK_THAT(v, Catch::Equals(std::vector<int>{1, 2, 3, 4, 5, 7}));
+  CHECK_THAT(o, Catch::Equals(std::vector<int>{2, 3, 4, 7}));
+
+  s.merge(s);
+  CHECK_THAT(v, Catch::Equals(std::vector<int>{1, 2, 3, 4, 5, 7}));
+}
+
 TEST_CASE("set_adapter_test.emplace")
 {
   auto v = std::vector<int>();
@@ -467,6 +510,23 @@ TEST_CASE("set_adapter_test.erase_with_value")
   CHECK_THAT(v, Catch::Equals(std::vector<int>{}));
 }
 
+TEST_CASE("set_adapter_test.erase_values")
+{
+  auto v = std::vector<int>{1, 2, 3, 4, 5, 6};
+  auto s = wrap_set(v);
+
+  const auto r = std::vector<int>{6, 0, 2, 2, 4};
+  CHECK(s.erase_values(std::begin(r), std::end(r)) == 3u);
+  CHECK_THAT(v, Catch::Equals(std::vector<int>{1, 3, 5}));
+
+  CHECK(s.erase_values(std::begin(r), std::end(r)) == 0u);
+  CHECK_THAT(v, Catch::Equals(std::vector<int>{1, 3, 5}));
+
+  const auto all = std::vector<int>{5, 3, 1};
+  CHECK(s.erase_values(std::begin(all), std::end(all)) == 3u);
+  CHECK_THAT(v, Catch::Equals(std::vector<int>{}));
+}
+
 TEST_CASE("set_adapter_test.swap")
 {
   // swap only works if the underlying collection is stored by value
@@ -236,4 +236,12 @@ TEST_CASE("string_format_test.str_to_long_double")
   CHECK(str_to_long_double(" ") == std::nullopt);
   CHECK(str_to_long_double("") == std::nullopt);
 }
+
+TEST_CASE("string_utils_test.str_hash")
+{
+  CHECK(str_hash("") == 0xcbf29ce484222325ull);
+  CHECK(str_hash("a") == 0xaf63dc4c8601ec8cull);
+  CHECK(str_hash("foobar") == 0x85944171f73967e8ull);
+  CHECK(str_hash("foobar") != str_hash("foobaz"));
+}
 } // namespace kdl
@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/thread_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2.h"
+
+namespace kdl
+{
+TEST_CASE("thread_pool")
+{
+  SECTION("size")
+  {
+    CHECK(thread_pool{0}.size() == 1u);
+    CHECK(thread_pool{3}.size() == 3u);
+    CHECK(thread_pool::default_thread_count() >= 1u);
+  }
+
+  SECTION("submit")
+  {
+    auto counter = std::atomic<size_t>{0};
+    {
+      auto pool = thread_pool{4};
+      CHECK_FALSE(pool.is_worker_thread());
+
+      for (size_t i = 0; i < 1000; ++i)
+      {
+        pool.submit([&]() { ++counter; });
+      }
+    }
+    // the pool's destructor runs all pending tasks
+    CHECK(counter == 1000u);
+  }
+
+  SECTION("is_worker_thread")
+  {
+    auto pool = thread_pool{2};
+    auto isWorker = std::atomic<bool>{false};
+    auto done = std::atomic<bool>{false};
+    pool.submit([&]() {
+      isWorker = pool.is_worker_thread();
+      done = true;
+    });
+    while (!done)
+    {
+      std::this_thread::yield();
+    }
+    CHECK(isWorker);
+  }
+
+  SECTION("parallel_for")
+  {
+    auto pool = thread_pool{4};
+
+    SECTION("empty range")
+    {
+      auto ran = false;
+      pool.parallel_for(0, [&](size_t) { ran = true; });
+      CHECK_FALSE(ran);
+    }
+
+    SECTION("chunk sizes")
+    {
+      constexpr size_t TestSize = 1000;
+      const auto chunkSize = GENERATE(size_t(0), size_t(1), size_t(7), size_t(2000));
+
+      auto visits = std::vector<std::atomic<size_t>>(TestSize);
+      pool.parallel_for(TestSize, [&](const size_t i) { ++visits[i]; }, chunkSize);
+
+      for (size_t i = 0; i < TestSize; ++i)
+      {
+        CHECK(visits[i] == 1u);
+      }
+    }
+
+    SECTION("nested")
+    {
+      constexpr size_t Outer = 64;
+      constexpr size_t Inner = 256;
+
+      auto visits = std::vector<std::atomic<size_t>>(Outer * Inner);
+      pool.parallel_for(
+        Outer,
+        [&](const size_t i) {
+          pool.parallel_for(
+            Inner, [&](const size_t j) { ++visits[i * Inner + j]; }, 1);
+        },
+        1);
+
+      for (size_t i = 0; i < Outer * Inner; ++i)
+      {
+        CHECK(visits[i] == 1u);
+      }
+    }
+
+    SECTION("exceptions are rethrown")
+    {
+      CHECK_THROWS_AS(
+        pool.parallel_for(
+          100,
+          [](const size_t i) {
+            if (i == 42)
+            {
+              throw std::runtime_error{"42"};
+            }
+          },
+          1),
+        std::runtime_error);
+
+      // the pool is still usable afterwards
+      auto counter = std::atomic<size_t>{0};
+      pool.parallel_for(100, [&](size_t) { ++counter; }, 1);
+      CHECK(counter == 100u);
+    }
+  }
+}
+} // namespace kdl
@@ -164,6 +164,13 @@ TEST_CASE("vector_set_test.assignment_from_vector")
   assertVset(vset({7, 8, 9}) = std::vector<int>({2, 1, 3, 1, 2}), {1, 2, 3});
 }
 
+TEST_CASE("vector_set_test.merge")
+{
+  auto s = vset{1, 3, 5};
+  s.merge(vset{2, 3, 6});
+  CHECK(s == vset{1, 2, 3, 5, 6});
+}
+
 TEST_CASE("vector_set_test.deduction_guide_range")
 {
   std::vector<int> v({1, 2, 3});
@@ -29,6 +29,9 @@
 #include "vm/util.h"
 #include "vm/vec.h"
 
+#include <limits>
+#include <tuple>
+
 namespace vm
 {
 
@@ -460,6 +463,80 @@ constexpr T intersect_ray_bbox(const ray<T, S>& r, const bbox<T, S>& b)
   return distances[bestPlane];
 }
 
+/**
+ * Computes the point at which the given ray enters the convex polyhedron bounded by the
+ * given planes. The plane normals must point out of the polyhedron.
+ *
+ * Instead of testing the ray against the polygon of every face, the ray is clipped by
+ * every plane. It enters the polyhedron at its furthest intersection with a plane that
+ * faces it, and it leaves the polyhedron at its nearest intersection with a plane that
+ * faces away from it. This only takes one ray-plane intersection per plane, and the
+ * planes are no longer tested once the ray is known to miss the polyhedron.
+ *
+ * @tparam T the component type
+ * @tparam I the plane range iterator
+ * @tparam G a transformation function that transforms a range element to a plane<T,3>
+ * @param r the ray
+ * @param cur the plane range start iterator
+ * @param end the plane range end iterator
+ * @param get the transformation function
+ * @return the distance from the origin of the ray to the entry point and an iterator to
+ * the plane through which the ray enters the polyhedron, or NaN and the end iterator if
+ * the ray does not intersect the polyhedron or if its origin is inside of it
+ */
+template <typename T, typename I, typename G = identity>
+constexpr std::tuple<T, I> intersect_ray_convex_polyhedron(
+  const ray<T, 3>& r, I cur, const I end, const G& get = G())
+{
+  const auto miss = std::tuple<T, I>{nan<T>(), end};
+
+  auto entryDistance = -std::numeric_limits<T>::max();
+  auto exitDistance = std::numeric_limits<T>::max();
+  auto entry = end;
+
+  for (; cur != end; ++cur)
+  {
+    const plane<T, 3>& p = get(*cur);
+    const auto d = dot(r.direction, p.normal);
+    const auto originDistance = p.point_distance(r.origin);
+    if (is_zero(d, constants<T>::almost_zero()))
+    {
+      if (originDistance > T(0))
+      {
+        // the ray is parallel to the plane and outside of the polyhedron
+        return miss;
+      }
+      continue;
+    }
+
+    const auto distance = -originDistance / d;
+    if (d < T(0))
+    {
+      if (distance > entryDistance)
+      {
+        entryDistance = distance;
+        entry = cur;
+      }
+    }
+    else if (distance < exitDistance)
+    {
+      exitDistance = distance;
+    }
+
+    if (entryDistance > exitDistance)
+    {
+      return miss;
+    }
+  }
+
+  if (entry == end || entryDistance < -constants<T>::almost_zero())
+  {
+    return miss;
+  }
+
+  return {entryDistance, entry};
+}
+
 /**
  * Computes the point of intersection between the given ray and a sphere centered at the
  * given position and with the given radius.
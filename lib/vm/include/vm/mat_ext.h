@@ -33,6 +33,72 @@
 
 namespace vm
 {
+/**
+ * Checks whether the given matrix is affine, i.e., whether its last row is
+ * (0, ..., 0, 1). Multiplying a point by an affine matrix keeps its homogeneous
+ * coordinate at 1.
+ *
+ * @tparam T the component type
+ * @tparam S the number of rows and columns
+ * @param m the matrix to check
+ * @return true if the given matrix is affine and false otherwise
+ */
+template <typename T, std::size_t S>
+constexpr bool is_affine(const mat<T, S, S>& m)
+{
+  for (std::size_t c = 0u; c < S - 1u; ++c)
+  {
+    if (m[c][S - 1u] != static_cast<T>(0.0))
+    {
+      return false;
+    }
+  }
+  return m[S - 1u][S - 1u] == static_cast<T>(1.0);
+}
+
+/**
+ * Transforms the points in the given range by the given matrix in place.
+ *
+ * If the matrix is affine, the points are transformed without computing their homogeneous
+ * coordinates and without the perspective division. The products are summed in the same
+ * order as when multiplying every point by the matrix, so the results are the same.
+ *
+ * @tparam T the component type
+ * @tparam S the number of rows and columns of the matrix
+ * @tparam I the iterator type, its value type must be vec<T, S - 1>
+ * @param m the transformation matrix
+ * @param cur the start of the range of points
+ * @param end the end of the range of points
+ */
+template <typename T, std::size_t S, typename I>
+constexpr void transform_points(const mat<T, S, S>& m, I cur, I end)
+{
+  if (!is_affine(m))
+  {
+    for (; cur != end; ++cur)
+    {
+      *cur = m * *cur;
+    }
+    return;
+  }
+
+  for (; cur != end; ++cur)
+  {
+    auto& point = *cur;
+    auto result = vec<T, S - 1u>{};
+    for (std::size_t r = 0u; r < S - 1u; ++r)
+    {
+      auto sum = static_cast<T>(0.0);
+      for (std::size_t c = 0u; c < S - 1u; ++c)
+      {
+        sum += m[c][r] * point[c];
+      }
+      result[r] = sum + m[S - 1u][r];
+    }
+    point = result;
+  }
+}
+
 /**
  * Multiplies the given list of vectors with the given matrix.
  *
@@ -93,13 +159,22 @@ template <typename T, std::size_t R, std::size_t C>
 std::vector<vec<T, C - 1>> operator*(
   const mat<T, R, C>& lhs, const std::vector<vec<T, C - 1>>& rhs)
 {
-  std::vector<vec<T, C - 1>> result;
-  result.reserve(rhs.size());
-  for (const auto& v : rhs)
+  if constexpr (R == C)
   {
-    result.push_back(lhs * v);
+    auto result = rhs;
+    transform_points(lhs, result.begin(), result.end());
+    return result;
+  }
+  else
+  {
+    std::vector<vec<T, C - 1>> result;
+    result.reserve(rhs.size());
+    for (const auto& v : rhs)
+    {
+      result.push_back(lhs * v);
+    }
+    return result;
   }
-  return result;
 }
 
 /**
@@ -117,12 +192,21 @@ template <typename T, std::size_t N, std::size_t R, std::size_t C>
 constexpr std::array<vec<T, C - 1>, N> operator*(
   const mat<T, R, C>& lhs, const std::array<vec<T, C - 1>, N>& rhs)
 {
-  std::array<vec<T, C - 1>, N> result{};
-  for (std::size_t i = 0u; i < N; ++i)
+  if constexpr (R == C)
   {
-    result[i] = lhs * rhs[i];
+    auto result = rhs;
+    transform_points(lhs, result.begin(), result.end());
+    return result;
+  }
+  else
+  {
+    std::array<vec<T, C - 1>, N> result{};
+    for (std::size_t i = 0u; i < N; ++i)
+    {
+      result[i] = lhs * rhs[i];
+    }
+    return result;
   }
-  return result;
 }
 
 /**
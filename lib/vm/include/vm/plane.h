@@ -27,6 +27,7 @@
 #include "vm/util.h"
 #include "vm/vec.h"
 
+#include <optional>
 #include <tuple>
 #include <type_traits>
 
@@ -187,6 +188,50 @@ public:
     }
   }
 
+  /**
+   * Determines the relative position of the given points to this plane.
+   *
+   * Returns plane_status::above or plane_status::below if all points that are not inside
+   * this plane are above or below it, respectively, and plane_status::inside if all
+   * points are inside this plane. Returns std::nullopt if there are points on both sides
+   * of this plane. In that case, the remaining points are not checked.
+   *
+   * @tparam I the range iterator type
+   * @tparam G the type of the function that maps the range elements to points
+   * @param cur the start of the range
+   * @param end the end of the range
+   * @param get maps the range elements to points
+   * @param epsilon an epsilon value (the maximum absolute distance up to which a point
+   * will be considered to be inside)
+   * @return the common status of the given points, or std::nullopt if the points are on
+   * both sides of this plane
+   */
+  template <typename I, typename G = identity>
+  constexpr std::optional<plane_status> common_point_status(
+    I cur,
+    I end,
+    const G& get = G(),
+    const T epsilon = constants<T>::point_status_epsilon()) const
+  {
+    auto result = plane_status::inside;
+    for (; cur != end; ++cur)
+    {
+      const auto status = point_status(get(*cur), epsilon);
+      if (status != plane_status::inside)
+      {
+        if (result == plane_status::inside)
+        {
+          result = status;
+        }
+        else if (result != status)
+        {
+          return std::nullopt;
+        }
+      }
+    }
+    return result;
+  }
+
   /**
    * Flips this plane by negating its normal.
    *
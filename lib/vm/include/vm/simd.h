@@ -0,0 +1,80 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+ Copyright 2015-2019 Eric Wasylishen
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+#pragma once
+
+#include <cstddef>
+
+// SIMD implementations of hot operations are only used if the target supports them, and
+// they can be disabled by defining VM_DISABLE_SIMD. They are only used at runtime; during
+// constant evaluation, the generic implementations are used.
+#if !defined(VM_DISABLE_SIMD)                                                            \
+  && (defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VM_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+#endif
+
+#if defined(VM_SIMD_SSE2)
+#define VM_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+namespace vm
+{
+namespace simd
+{
+#if defined(VM_SIMD_SSE2)
+/**
+ * Computes the product of a 4x4 matrix and a 4d vector. The matrix elements are given in
+ * column major order.
+ *
+ * The result is accumulated from the columns scaled by the vector components, in the
+ * same order as the generic implementation, so both produce the same results.
+ */
+inline void multiply_mat4_vec4(const float* matrix, const float* vector, float* result)
+{
+  auto sum = _mm_setzero_ps();
+  for (std::size_t c = 0; c < 4; ++c)
+  {
+    const auto column = _mm_loadu_ps(matrix + 4 * c);
+    sum = _mm_add_ps(sum, _mm_mul_ps(column, _mm_set1_ps(vector[c])));
+  }
+  _mm_storeu_ps(result, sum);
+}
+
+inline void multiply_mat4_vec4(const double* matrix, const double* vector, double* result)
+{
+  auto lo = _mm_setzero_pd();
+  auto hi = _mm_setzero_pd();
+  for (std::size_t c = 0; c < 4; ++c)
+  {
+    const auto factor = _mm_set1_pd(vector[c]);
+    lo = _mm_add_pd(lo, _mm_mul_pd(_mm_loadu_pd(matrix + 4 * c), factor));
+    hi = _mm_add_pd(hi, _mm_mul_pd(_mm_loadu_pd(matrix + 4 * c + 2), factor));
+  }
+  _mm_storeu_pd(result, lo);
+  _mm_storeu_pd(result + 2, hi);
+}
+#endif
+} // namespace simd
+} // namespace vm
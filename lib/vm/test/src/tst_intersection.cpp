@@ -26,11 +26,14 @@
 #include "vm/forward.h"
 #include "vm/intersection.h"
 #include "vm/quat.h"
+#include "vm/ray_io.h"
 #include "vm/vec.h"
 #include "vm/vec_ext.h"
 #include "vm/vec_io.h"
 
 #include <array>
+#include <cmath>
+#include <tuple>
 
 #define CATCH_CONFIG_ENABLE_ALL_STRINGMAKERS 1
 #include <catch2/catch.hpp>
@@ -299,6 +302,73 @@ TEST_CASE("intersection.intersect_ray_bbox")
   CHECK(intersect_ray_bbox(ray3f(origin, dir), bounds) == approx(length(diff)));
 }
 
+TEST_CASE("intersection.intersect_ray_convex_polyhedron")
+{
+  // a cube from -1 to 1 on every axis
+  const auto planes = std::array<plane3d, 6>{
+    plane3d(1.0, vec3d::pos_x()),
+    plane3d(1.0, vec3d::neg_x()),
+    plane3d(1.0, vec3d::pos_y()),
+    plane3d(1.0, vec3d::neg_y()),
+    plane3d(1.0, vec3d::pos_z()),
+    plane3d(1.0, vec3d::neg_z())};
+
+  const auto intersect = [&](const ray3d& r) {
+    const auto [distance, it] =
+      intersect_ray_convex_polyhedron(r, std::begin(planes), std::end(planes));
+    return std::make_tuple(distance, std::distance(std::begin(planes), it));
+  };
+
+  using T = std::tuple<ray3d, double, std::ptrdiff_t>;
+
+  // clang-format off
+  const auto
+  [r,                                                  expectedDistance, expectedIndex] = GENERATE(values<T>({
+  {ray3d(vec3d(0, 0, 3), vec3d::neg_z()),              2.0,              4},
+  {ray3d(vec3d(3, 0.5, 0.5), vec3d::neg_x()),          2.0,              0},
+  {ray3d(vec3d(0, -3, 0), vec3d::pos_y()),             2.0,              3},
+  {ray3d(vec3d(-2, -2, -2), normalize(vec3d(1, 1, 1))), std::sqrt(3.0),   1},
+  {ray3d(vec3d(0, 0, 1), vec3d::neg_z()),              0.0,              4},
+  }));
+  // clang-format on
+
+  CAPTURE(r);
+
+  const auto [distance, index] = intersect(r);
+  CHECK(distance == approx(expectedDistance));
+  CHECK(index == expectedIndex);
+
+  // misses the cube
+  CHECK(is_nan(std::get<0>(intersect(ray3d(vec3d(0, 0, 3), vec3d::pos_z())))));
+  CHECK(is_nan(std::get<0>(intersect(ray3d(vec3d(2, 0, 3), vec3d::neg_z())))));
+  CHECK(is_nan(std::get<0>(intersect(ray3d(vec3d(3, 3, 0), vec3d::neg_x())))));
+  CHECK(is_nan(
+    std::get<0>(intersect(ray3d(vec3d(-3, 0, 3), normalize(vec3d(1, 0, 1)))))));
+  CHECK(std::get<1>(intersect(ray3d(vec3d(0, 0, 3), vec3d::pos_z()))) == 6);
+
+  // starts inside of the cube
+  CHECK(is_nan(std::get<0>(intersect(ray3d(vec3d::zero(), vec3d::neg_z())))));
+
+  // the results match the intersection with the face polygons
+  const auto top = std::array<vec3d, 4>{
+    vec3d(-1, -1, 1), vec3d(1, -1, 1), vec3d(1, 1, 1), vec3d(-1, 1, 1)};
+  for (const auto& origin :
+       {vec3d(0.5, 0.5, 3), vec3d(0.99, -0.99, 2), vec3d(1.5, 0, 2), vec3d(0, -4, 5)})
+  {
+    const auto ray = ray3d(origin, vec3d::neg_z());
+    CAPTURE(ray);
+
+    const auto expected =
+      intersect_ray_polygon(ray, planes[4], std::begin(top), std::end(top));
+    const auto actual = std::get<0>(intersect(ray));
+    CHECK(is_nan(actual) == is_nan(expected));
+    if (!is_nan(expected))
+    {
+      CHECK(actual == approx(expected));
+    }
+  }
+}
+
 TEST_CASE("intersection.intersect_ray_sphere")
 {
   const ray3f ray(vec3f::zero(), vec3f::pos_z());
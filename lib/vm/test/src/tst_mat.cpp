@@ -434,6 +434,25 @@ TEST_CASE("mat.operator_multiply_vector_right")
     == to_cartesian_coords(exp));
 }
 
+TEST_CASE("mat.operator_multiply_vector_right_runtime")
+{
+  // the SIMD implementation used at runtime must match the constexpr implementation
+  constexpr auto m = mat4x4d(
+    0.1, -2.5, 3.75, 4.0, 5.5, 6.25, -7.0, 8.125, 9.0, 10.5, 11.0, -12.0, 13.0, 14.5,
+    15.0, 16.0);
+  constexpr auto v = vec4d(1.5, -2.25, 3.125, 1.0);
+  constexpr auto exp = m * v;
+
+  auto runtimeM = m;
+  auto runtimeV = v;
+  CHECK(runtimeM * runtimeV == exp);
+
+  const auto mf = mat4x4f(m);
+  const auto vf = vec4f(v);
+  constexpr auto expf = mat4x4f(m) * vec4f(v);
+  CHECK(mf * vf == expf);
+}
+
 TEST_CASE("mat.operator_multiply_vector_left")
 {
   constexpr auto v = vec4d(1, 2, 3, 1);
@@ -110,6 +110,42 @@ TEST_CASE("mat_ext.operator_multiply_array_right_lower_dimension")
   CER_CHECK(o[2] == approx(r[2]));
 }
 
+TEST_CASE("mat_ext.is_affine")
+{
+  CER_CHECK(is_affine(mat4x4d::identity()));
+  CER_CHECK(
+    is_affine(translation_matrix(vec3d(1, 2, 3)) * scaling_matrix(vec3d(2, 2, 2))));
+  CER_CHECK_FALSE(
+    is_affine(mat4x4d(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16)));
+  CER_CHECK_FALSE(is_affine(perspective_matrix(90.0, 1.0, 100.0, 640, 480)));
+}
+
+TEST_CASE("mat_ext.transform_points")
+{
+  const auto points = std::vector<vec3d>{
+    vec3d(1.0, 2.0, 3.0),
+    vec3d(2.0, 3.0, 4.0),
+    vec3d(3.0 / 23.0, 2.0 / 23.0, 7.0 / 23.0)};
+
+  const auto affine = translation_matrix(vec3d(1.0, -2.0, 3.5))
+                      * rotation_matrix(to_radians(15.0), to_radians(20.0), 0.0)
+                      * scaling_matrix(vec3d(0.5, 2.0, 3.0));
+  const auto projective =
+    mat4x4d(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+
+  for (const auto& m : {affine, projective})
+  {
+    auto transformed = points;
+    transform_points(m, transformed.begin(), transformed.end());
+
+    // the results are the same as multiplying every point
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      CHECK(transformed[i] == m * points[i]);
+    }
+  }
+}
+
 TEST_CASE("mat_ext.operator_multiply_vectors_left")
 {
   const auto v =
@@ -34,6 +34,7 @@
 
 #include <array>
 #include <sstream>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -145,6 +146,34 @@ TEST_CASE("plane.point_status")
   CER_CHECK(p.point_status(vec3f(0.0f, 0.0f, 10.0f)) == plane_status::inside);
 }
 
+TEST_CASE("plane.common_point_status")
+{
+  constexpr auto p = plane3f(10.0f, vec3f::pos_z());
+
+  constexpr auto above = vec3f(0.0f, 0.0f, 11.0f);
+  constexpr auto below = vec3f(0.0f, 0.0f, 9.0f);
+  constexpr auto inside = vec3f(0.0f, 0.0f, 10.0f);
+
+  const auto commonStatus = [&](const std::vector<vec3f>& points) {
+    return p.common_point_status(points.begin(), points.end());
+  };
+
+  CHECK(commonStatus({}) == plane_status::inside);
+  CHECK(commonStatus({inside, inside}) == plane_status::inside);
+  CHECK(commonStatus({above, inside, above}) == plane_status::above);
+  CHECK(commonStatus({inside, below}) == plane_status::below);
+  CHECK(commonStatus({above, inside, below}) == std::nullopt);
+
+  // with a projection
+  const auto heights = std::vector<float>{11.0f, 10.0f};
+  CHECK(
+    p.common_point_status(
+      heights.begin(),
+      heights.end(),
+      [](const float z) { return vec3f(0.0f, 0.0f, z); })
+    == plane_status::above);
+}
+
 TEST_CASE("plane.flip")
 {
   constexpr auto p = plane3f(10.0f, vec3f::pos_z());